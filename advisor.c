@@ -0,0 +1,371 @@
+/**
+ * @file advisor.c
+ * Find the design patterns which are slow on the target: semi-transparent overlays, opa scales on large subtrees,
+ * wide shadows, large gradients, stacked opaque widgets and large anti-aliased text.
+ * The widgets of the open screen are checked on the UI thread in the background, `ADVISOR_SLICE` of them in a run of
+ * a low priority task, and only after the screen's content hash changed. The drawing operations a pattern adds are
+ * estimated from its geometry and style in the counters of `lv_prof`, the cost model of `--frametime` turns them into
+ * the time they take on the target. The Layer View shows the costliest finding of every widget after its ID.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "advisor.h"
+#include "frametime.h"
+#include "projdiff.h"
+#include "projjob.h"
+#include "dataset.h"
+#include "custom_widget.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    advisor_finding_t * items;
+    uint32_t cnt;
+    uint32_t cap;
+}finding_list_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void advisor_task(lv_task_t * task);
+static void pass_start(doc_id_t scr, uint64_t hash);
+static void pass_finish(void);
+static bool collect_cb(doc_id_t id, void * user_data);
+static void node_analyse(uint32_t idx);
+static bool body_drawn(lv_obj_t * obj, const lv_style_t * style);
+static uint32_t visible_px(lv_obj_t * obj);
+static void finding_add(doc_id_t node, advisor_kind_t kind, const uint32_t * draw);
+static bool list_push(finding_list_t * list, const advisor_finding_t * f);
+static int finding_cmp(const void * a, const void * b);
+static const char * note_cb(doc_id_t node);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static frametime_model_t model;
+
+//The pass in progress: the nodes of the open screen, analysed from `pass_next` on
+static bool pass_busy;
+static uint64_t pass_hash;
+static doc_id_t * pass_nodes;
+static uint32_t pass_cnt;
+static uint32_t pass_cap;
+static uint32_t pass_next;
+static lv_area_t scr_area;
+static uint32_t scr_px;
+static finding_list_t pending;
+
+//The result of the last finished pass, the costliest first
+static finding_list_t found;
+static bool found_valid;
+static uint64_t found_hash;
+
+static const char * kind_names[ADVISOR_KIND_NUM] =
+{
+    "overlay", "opa scale", "shadow", "gradient", "overdraw", "large AA text",
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Start checking the open screen with a cost model of `frametime_model_save`. Call it after the GUI is created.
+bool advisor_init(const char * model_path)
+{
+    if(!frametime_model_load(model_path, &model)) return false;
+
+    lv_task_create(advisor_task, ADVISOR_PERIOD, LV_TASK_PRIO_LOWEST, NULL);
+    layerview_set_note_cb(note_cb);
+    return true;
+}
+
+//The findings of the open screen's last check, the costliest first. Valid until the next check finishes.
+uint32_t advisor_get_findings(const advisor_finding_t ** findings)
+{
+    *findings = found.items;
+    return found.cnt;
+}
+
+//The costliest finding of a widget or NULL
+const advisor_finding_t * advisor_get(doc_id_t node)
+{
+    uint32_t i;
+    for(i = 0; i < found.cnt; i++)
+    {
+        if(found.items[i].node == node) return &found.items[i];
+    }
+    return NULL;
+}
+
+const char * advisor_kind_name(advisor_kind_t kind)
+{
+    return kind < ADVISOR_KIND_NUM ? kind_names[kind] : "";
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Start a pass if the screen changed since the last one, else continue the pass with the next slice
+static void advisor_task(lv_task_t * task)
+{
+    (void)task;
+    if(projjob_is_busy()) return;       //E.g. a project is being loaded
+
+    doc_id_t scr = doc_get_screen();
+    if(scr == DOC_NONE) return;
+    uint64_t hash = projdiff_doc_hash(scr);
+    if(pass_busy == false)
+    {
+        if(found_valid && hash == found_hash) return;
+        pass_start(scr, hash);
+    }else if(hash != pass_hash)
+    {
+        pass_start(scr, hash);          //Changed meanwhile, the nodes may be gone
+    }
+
+    uint32_t end = pass_next + ADVISOR_SLICE;
+    for(; pass_next < end && pass_next < pass_cnt; pass_next++) node_analyse(pass_next);
+    if(pass_next == pass_cnt) pass_finish();
+}
+
+static void pass_start(doc_id_t scr, uint64_t hash)
+{
+    pass_busy = true;
+    pass_hash = hash;
+    pass_cnt = 0;
+    pass_next = 0;
+    pending.cnt = 0;
+    lv_obj_get_coords(doc_get(scr)->obj, &scr_area);
+    scr_px = lv_area_get_size(&scr_area);
+    doc_traverse(scr, collect_cb, NULL, NULL);
+}
+
+//Publish the findings and print the worst ones if they are not the same as before
+static void pass_finish(void)
+{
+    pass_busy = false;
+    qsort(pending.items, pending.cnt, sizeof(advisor_finding_t), finding_cmp);
+
+    bool same = found_valid && pending.cnt == found.cnt;
+    uint32_t i;
+    for(i = 0; same && i < pending.cnt && i < ADVISOR_TOP; i++)
+    {
+        if(pending.items[i].node != found.items[i].node || pending.items[i].kind != found.items[i].kind) same = false;
+    }
+
+    finding_list_t tmp = found;
+    found = pending;
+    pending = tmp;
+    found_valid = true;
+    found_hash = pass_hash;
+    layerview_refr_request();
+
+    if(same) return;
+    doc_node_t * scr = doc_get(doc_get_screen());
+    widget_info_t * info = widget_get_info(scr->obj);
+    if(found.cnt == 0)
+    {
+        printf("Advisor: %s has no slow patterns on %s\n", info->id, model.name);
+        return;
+    }
+    printf("Advisor: the costliest patterns of %s on %s\n", info->id, model.name);
+    for(i = 0; i < found.cnt && i < ADVISOR_TOP; i++)
+    {
+        const advisor_finding_t * f = &found.items[i];
+        info = widget_get_info(doc_get(f->node)->obj);
+        printf("    %-20s %-14s %8.2f ms\n", info->id[0] != '\0' ? info->id : "(no ID)", kind_names[f->kind],
+               f->us / 1000.0);
+    }
+}
+
+//Add the node to the pass, skip the hidden subtrees: they are not drawn
+static bool collect_cb(doc_id_t id, void * user_data)
+{
+    (void)user_data;
+    doc_node_t * n = doc_get(id);
+    if(n->obj == NULL || lv_obj_get_hidden(n->obj)) return false;
+
+    if(pass_cnt >= pass_cap)
+    {
+        uint32_t cap = pass_cap > 0 ? pass_cap * 2 : 256;
+        doc_id_t * nodes = realloc(pass_nodes, cap * sizeof(doc_id_t));
+        if(nodes == NULL) return false;
+        pass_nodes = nodes;
+        pass_cap = cap;
+    }
+    pass_nodes[pass_cnt++] = id;
+    return true;
+}
+
+//Check the patterns on the widget of `pass_nodes[idx]` and estimate the drawing operations they add
+static void node_analyse(uint32_t idx)
+{
+    doc_id_t id = pass_nodes[idx];
+    doc_node_t * n = doc_get(id);
+    lv_obj_t * obj = n->obj;
+    uint32_t px = visible_px(obj);
+    if(px == 0) return;
+
+    const lv_style_t * style = lv_obj_get_style(obj);
+    bool body = body_drawn(obj, style);
+    lv_opa_t opa = (uint32_t)style->body.opa * lv_obj_get_opa_scale(obj) >> 8;
+    uint32_t draw[LV_PROF_DRAW_NUM];
+
+    //Blended on everything below it
+    if(body && opa < LV_OPA_MAX && px * 100 >= scr_px * ADVISOR_OVERLAY_PCT)
+    {
+        memset(draw, 0, sizeof(draw));
+        draw[LV_PROF_DRAW_BLEND] = px;
+        finding_add(id, ADVISOR_OVERLAY, draw);
+    }
+
+    //Every pixel of the subtree is blended instead of filled or copied
+    if(obj->opa_scale_en && obj->opa_scale < LV_OPA_MAX && n->first_child != DOC_NONE)
+    {
+        uint32_t cnt = 0;
+        uint32_t sub_px = 0;
+        uint32_t i;
+        for(i = idx + 1; i < pass_cnt && doc_is_descendant(pass_nodes[i], id); i++)     //In pre-order
+        {
+            cnt++;
+            sub_px += visible_px(doc_get(pass_nodes[i])->obj);
+        }
+        if(cnt >= ADVISOR_OPA_SCALE_MIN)
+        {
+            memset(draw, 0, sizeof(draw));
+            draw[LV_PROF_DRAW_BLEND] = sub_px;
+            finding_add(id, ADVISOR_OPA_SCALE, draw);
+        }
+    }
+
+    //The shadow's whole area is drawn through a mask
+    lv_coord_t sw = style->body.shadow.width;
+    if(body && sw > ADVISOR_SHADOW_MAX)
+    {
+        uint32_t w = lv_obj_get_width(obj);
+        uint32_t h = lv_obj_get_height(obj);
+        memset(draw, 0, sizeof(draw));
+        draw[LV_PROF_DRAW_SHADOW] = (w + 2 * sw) * (h + 2 * sw) - w * h;
+        finding_add(id, ADVISOR_SHADOW, draw);
+    }
+
+    //Filled line by line with an other color
+    if(body && opa > LV_OPA_MIN && style->body.main_color.full != style->body.grad_color.full &&
+       px * 100 >= scr_px * ADVISOR_GRAD_PCT)
+    {
+        memset(draw, 0, sizeof(draw));
+        draw[opa >= LV_OPA_MAX ? LV_PROF_DRAW_FILL : LV_PROF_DRAW_BLEND] = px;
+        finding_add(id, ADVISOR_GRADIENT, draw);
+    }
+
+    //The opaque ancestors are filled under it in vain
+    if(body && opa >= LV_OPA_MAX)
+    {
+        uint32_t layers = 0;
+        doc_id_t par;
+        for(par = n->parent; par != DOC_ROOT && par != DOC_NONE; par = doc_get(par)->parent)
+        {
+            lv_obj_t * par_obj = doc_get(par)->obj;
+            const lv_style_t * par_style = lv_obj_get_style(par_obj);
+            if(body_drawn(par_obj, par_style) && par_style->body.opa >= LV_OPA_MAX) layers++;
+        }
+        if(layers > ADVISOR_LAYERS_MAX)
+        {
+            memset(draw, 0, sizeof(draw));
+            draw[LV_PROF_DRAW_FILL] = px * layers;
+            finding_add(id, ADVISOR_LAYERS, draw);
+        }
+    }
+
+    //Every pixel of a letter's box is on the mask, more with more bits per pixel
+    widget_info_t * info = widget_get_info(obj);
+    const lv_font_t * font = style->text.font;
+    if(info->type == WIDGET_TYPE_LABEL && font != NULL && lv_font_get_line_height(font) > ADVISOR_FONT_PX)
+    {
+        lv_font_glyph_dsc_t g;
+        const char * text = lv_label_get_text(obj);
+        if(text != NULL && lv_font_get_glyph_dsc(font, &g, 'A', '\0') && g.bpp > 1)
+        {
+            uint32_t letters = lv_txt_get_encoded_length(text);
+            memset(draw, 0, sizeof(draw));
+            draw[LV_PROF_DRAW_GLYPH] = letters;
+            draw[LV_PROF_DRAW_GLYPH_PX] = letters * g.box_w * g.box_h;
+            if(letters > 0) finding_add(id, ADVISOR_BIG_TEXT, draw);
+        }
+    }
+}
+
+//Does the widget draw its background with `style`?
+static bool body_drawn(lv_obj_t * obj, const lv_style_t * style)
+{
+    if(style->body.opa <= LV_OPA_MIN) return false;
+    widget_info_t * info = widget_get_info(obj);
+    if(info != NULL && info->type == WIDGET_TYPE_LABEL) return lv_label_get_body_draw(obj);
+    return true;
+}
+
+//Pixels of the widget on the screen
+static uint32_t visible_px(lv_obj_t * obj)
+{
+    lv_area_t a;
+    if(!lv_area_intersect(&a, &obj->coords, &scr_area)) return 0;
+    return lv_area_get_size(&a);
+}
+
+static void finding_add(doc_id_t node, advisor_kind_t kind, const uint32_t * draw)
+{
+    advisor_finding_t f;
+    f.node = node;
+    f.kind = kind;
+    f.us = frametime_predict(&model, draw, 0, 0);
+    list_push(&pending, &f);
+}
+
+static bool list_push(finding_list_t * list, const advisor_finding_t * f)
+{
+    if(list->cnt >= list->cap)
+    {
+        uint32_t cap = list->cap > 0 ? list->cap * 2 : 32;
+        advisor_finding_t * items = realloc(list->items, cap * sizeof(advisor_finding_t));
+        if(items == NULL) return false;
+        list->items = items;
+        list->cap = cap;
+    }
+    list->items[list->cnt++] = *f;
+    return true;
+}
+
+//By the estimated time, the largest first
+static int finding_cmp(const void * a, const void * b)
+{
+    double ua = ((const advisor_finding_t *)a)->us;
+    double ub = ((const advisor_finding_t *)b)->us;
+    return (ua < ub) - (ua > ub);
+}
+
+//The costliest finding of a node in the Layer View, e.g. "shadow 0.84 ms"
+static const char * note_cb(doc_id_t node)
+{
+    static char note[32];
+    const advisor_finding_t * f = advisor_get(node);
+    if(f == NULL) return NULL;
+    snprintf(note, sizeof(note), "%s %.2f ms", kind_names[f->kind], f->us / 1000.0);
+    return note;
+}
@@ -0,0 +1,80 @@
+/**
+ * @file advisor.h
+ *
+ */
+
+#ifndef _ADVISOR_H_
+#define _ADVISOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ADVISOR_PERIOD          300     //[ms] between two runs of the analysis
+#define ADVISOR_SLICE           64      //Widgets analysed in a run, the others in the next runs
+#define ADVISOR_TOP             5       //Worst offenders printed per screen
+#define ADVISOR_OVERLAY_PCT     50      //[%] of the screen a semi-transparent widget covers to be an overlay
+#define ADVISOR_OPA_SCALE_MIN   8       //Widgets in a subtree with an opa scale to flag it
+#define ADVISOR_SHADOW_MAX      (LV_DPI / 8)    //Wider shadows are flagged
+#define ADVISOR_GRAD_PCT        25      //[%] of the screen a gradient covers to be flagged
+#define ADVISOR_LAYERS_MAX      3       //More opaque widgets under an opaque widget are flagged
+#define ADVISOR_FONT_PX         28      //Anti-aliased text with a higher line is flagged
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    ADVISOR_OVERLAY,            //A semi-transparent widget over most of the screen
+    ADVISOR_OPA_SCALE,          //An opa scale on a large subtree: all of it is blended
+    ADVISOR_SHADOW,             //A wide shadow
+    ADVISOR_GRADIENT,           //A gradient on a large area
+    ADVISOR_LAYERS,             //Opaque widgets stacked on each other, all of them are filled
+    ADVISOR_BIG_TEXT,           //Anti-aliased text with a large font
+    ADVISOR_KIND_NUM
+}advisor_kind_t;
+
+typedef struct
+{
+    doc_id_t node;
+    advisor_kind_t kind;
+    double us;                  //[us] of drawing the pattern on the target, estimated with the cost model
+}advisor_finding_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool advisor_init(const char * model_path);
+uint32_t advisor_get_findings(const advisor_finding_t ** findings);
+const advisor_finding_t * advisor_get(doc_id_t node);
+const char * advisor_kind_name(advisor_kind_t kind);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
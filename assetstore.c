@@ -0,0 +1,243 @@
+/**
+ * @file assetstore.c
+ * Converted assets (images in the target's colour format, font subsets) shared by every project on the machine.
+ * An asset is stored under the hash of its source and of the parameters of the conversion, so the same icon
+ * used by many projects is converted once. The files are written into a temporary file and renamed, a reader
+ * (another designer too) sees either the whole asset or none of it. They are read by mapping them.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "assetstore.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FNV64_PRIME     1099511628211ull
+#define FILE_MAGIC      0x5341474C      //"LGAS"
+#define FILE_VERSION    1
+#define KIND_MAX        16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t size;              //Of the asset after the header
+    uint32_t reserved;
+}file_header_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const char * dir_get(void);
+static bool dir_make(const char * dir);
+static bool path_get(char * path, uint64_t key, const char * kind);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+//Used by the code generation's worker and the UI thread
+static pthread_mutex_t store_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char store_dir[ASSETSTORE_PATH_MAX];
+static bool dir_ready;          //`store_dir` exists
+static assetstore_stat_t store_stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Use another directory instead of the one of the user (e.g. one shared by a team). Call it before the first asset.
+void assetstore_set_dir(const char * dir)
+{
+    pthread_mutex_lock(&store_mutex);
+    snprintf(store_dir, sizeof(store_dir), "%s", dir);
+    dir_ready = false;
+    pthread_mutex_unlock(&store_mutex);
+}
+
+const char * assetstore_get_dir(void)
+{
+    pthread_mutex_lock(&store_mutex);
+    const char * dir = dir_get();
+    pthread_mutex_unlock(&store_mutex);
+    return dir;
+}
+
+//FNV-1a, 64 bit to keep the names of the stored files unique. Start with ASSETSTORE_HASH_INIT.
+uint64_t assetstore_hash(uint64_t hash, const void * data, size_t len)
+{
+    const uint8_t * d = data;
+    size_t i;
+    for(i = 0; i < len; i++)
+    {
+        hash ^= d[i];
+        hash *= FNV64_PRIME;
+    }
+    return hash;
+}
+
+//Map the asset of a key. `kind` names the type of the asset (e.g. "img"), it's the extension of the file.
+//false: it isn't stored yet, or its file is damaged
+bool assetstore_get(uint64_t key, const char * kind, assetstore_blob_t * blob)
+{
+    memset(blob, 0, sizeof(assetstore_blob_t));
+
+    char path[ASSETSTORE_PATH_MAX];
+    bool res = false;
+    int fd = path_get(path, key, kind) ? open(path, O_RDONLY) : -1;
+    if(fd >= 0)
+    {
+        struct stat st;
+        if(fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(file_header_t))
+        {
+            void * map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(map != MAP_FAILED)
+            {
+                const file_header_t * h = map;
+                if(h->magic == FILE_MAGIC && h->version == FILE_VERSION && h->key == key &&
+                   (off_t)(sizeof(file_header_t) + h->size) == st.st_size)
+                {
+                    blob->data = (const uint8_t *)map + sizeof(file_header_t);
+                    blob->size = h->size;
+                    blob->map = map;
+                    blob->map_size = st.st_size;
+                    res = true;
+                }else
+                {
+                    munmap(map, st.st_size);
+                }
+            }
+        }
+        close(fd);      //The mapping stays valid
+    }
+
+    pthread_mutex_lock(&store_mutex);
+    if(res) store_stat.hit_cnt++;
+    else store_stat.miss_cnt++;
+    pthread_mutex_unlock(&store_mutex);
+    return res;
+}
+
+//Store an asset, `head` and `data` are written after each other. Failing isn't an error, it's converted again then.
+bool assetstore_put(uint64_t key, const char * kind, const void * head, uint32_t head_size,
+                    const void * data, uint32_t size)
+{
+    char path[ASSETSTORE_PATH_MAX];
+    char tmp_path[ASSETSTORE_PATH_MAX + 16];
+    if(!path_get(path, key, kind)) return false;
+
+    //Unique in the directory, other designers may write the same asset now
+    pthread_mutex_lock(&store_mutex);
+    snprintf(tmp_path, sizeof(tmp_path), "%s/.tmp.XXXXXX", dir_get());
+    pthread_mutex_unlock(&store_mutex);
+    int fd = mkstemp(tmp_path);
+    if(fd < 0) return false;
+    fchmod(fd, 0644);
+
+    FILE * fp = fdopen(fd, "wb");
+    if(fp == NULL)
+    {
+        close(fd);
+        remove(tmp_path);
+        return false;
+    }
+
+    file_header_t h = {.magic = FILE_MAGIC, .version = FILE_VERSION, .key = key, .size = head_size + size};
+    bool res = fwrite(&h, sizeof(h), 1, fp) == 1 &&
+               (head_size == 0 || fwrite(head, 1, head_size, fp) == head_size) &&
+               (size == 0 || fwrite(data, 1, size, fp) == size);
+    if(fclose(fp) != 0) res = false;
+    if(res && rename(tmp_path, path) != 0) res = false;
+    if(!res) remove(tmp_path);
+
+    if(res)
+    {
+        pthread_mutex_lock(&store_mutex);
+        store_stat.put_cnt++;
+        pthread_mutex_unlock(&store_mutex);
+    }
+    return res;
+}
+
+void assetstore_release(assetstore_blob_t * blob)
+{
+    if(blob->map != NULL) munmap(blob->map, blob->map_size);
+    memset(blob, 0, sizeof(assetstore_blob_t));
+}
+
+void assetstore_get_stat(assetstore_stat_t * stat)
+{
+    pthread_mutex_lock(&store_mutex);
+    *stat = store_stat;
+    pthread_mutex_unlock(&store_mutex);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//$LV_GUI_ASSET_STORE, $XDG_CACHE_HOME/lv_gui_designer/assets or ~/.cache/lv_gui_designer/assets.
+//Needs `store_mutex`.
+static const char * dir_get(void)
+{
+    if(store_dir[0] == '\0')
+    {
+        const char * env = getenv(ASSETSTORE_DIR_ENV);
+        const char * xdg = getenv("XDG_CACHE_HOME");
+        const char * home = getenv("HOME");
+        if(env != NULL && env[0] != '\0') snprintf(store_dir, sizeof(store_dir), "%s", env);
+        else if(xdg != NULL && xdg[0] == '/') snprintf(store_dir, sizeof(store_dir), "%s/%s", xdg, ASSETSTORE_DIR_NAME);
+        else if(home != NULL && home[0] != '\0')
+        {
+            snprintf(store_dir, sizeof(store_dir), "%s/.cache/%s", home, ASSETSTORE_DIR_NAME);
+        }
+        else snprintf(store_dir, sizeof(store_dir), "%s", ASSETSTORE_DIR_LOCAL);
+    }
+    if(!dir_ready) dir_ready = dir_make(store_dir);
+    return store_dir;
+}
+
+//Create a directory with its parents
+static bool dir_make(const char * dir)
+{
+    char path[ASSETSTORE_PATH_MAX];
+    snprintf(path, sizeof(path), "%s", dir);
+    char * p;
+    for(p = path + 1; *p != '\0'; p++)
+    {
+        if(*p != '/') continue;
+        *p = '\0';
+        if(mkdir(path, 0755) != 0 && errno != EEXIST) return false;
+        *p = '/';
+    }
+    return mkdir(path, 0755) == 0 || errno == EEXIST;
+}
+
+static bool path_get(char * path, uint64_t key, const char * kind)
+{
+    if(strlen(kind) >= KIND_MAX || strchr(kind, '/') != NULL) return false;
+
+    pthread_mutex_lock(&store_mutex);
+    int len = snprintf(path, ASSETSTORE_PATH_MAX, "%s/%016llx.%s", dir_get(), (unsigned long long)key, kind);
+    pthread_mutex_unlock(&store_mutex);
+    return len > 0 && len < ASSETSTORE_PATH_MAX;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file assetstore.h
+ *
+ */
+
+#ifndef _ASSETSTORE_H_
+#define _ASSETSTORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ASSETSTORE_DIR_ENV      "LV_GUI_ASSET_STORE"        //Overrides the directory of the store
+#define ASSETSTORE_DIR_NAME     "lv_gui_designer/assets"    //In $XDG_CACHE_HOME or ~/.cache
+#define ASSETSTORE_DIR_LOCAL    "asset_store"               //Without a home directory
+#define ASSETSTORE_PATH_MAX     512
+#define ASSETSTORE_HASH_INIT    14695981039346656037ull     //FNV-1a offset basis of `assetstore_hash`
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//A stored asset mapped into the memory, valid till `assetstore_release`
+typedef struct
+{
+    const uint8_t * data;
+    uint32_t size;
+    void * map;                 //The whole file with the store's header
+    size_t map_size;
+}assetstore_blob_t;
+
+typedef struct
+{
+    uint32_t hit_cnt;
+    uint32_t miss_cnt;
+    uint32_t put_cnt;
+}assetstore_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void assetstore_set_dir(const char * dir);
+const char * assetstore_get_dir(void);
+uint64_t assetstore_hash(uint64_t hash, const void * data, size_t len);
+bool assetstore_get(uint64_t key, const char * kind, assetstore_blob_t * blob);
+bool assetstore_put(uint64_t key, const char * kind, const void * head, uint32_t head_size,
+                    const void * data, uint32_t size);
+void assetstore_release(assetstore_blob_t * blob);
+void assetstore_get_stat(assetstore_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
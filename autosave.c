@@ -0,0 +1,416 @@
+/**
+ * @autosave .c
+ * Journaled autosave. Edits only mark their document node dirty, a low priority task appends the
+ * dirty subtrees to the journal. Journal records (one per line):
+ *   S <uid> <parent uid>                   a subtree follows, it replaces the old one
+ *   N <uid> <parent uid> <type> <x> <y> <w> <h>   a node of the subtree, in preorder
+ *   E                                      end of the subtree, records without it are dropped
+ *   D <uid>                                the subtree was deleted
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "autosave.h"
+#include "searchidx.h"
+#include "footprint.h"
+#include "doctree.h"
+#include "dataset.h"
+#include "widgetreg.h"
+#include "xmlstream.h"
+#include "screens.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define RECOVER_LINE_MAX    128
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t parent;
+    uint16_t type;
+    bool alive;
+    lv_coord_t x, y, w, h;
+}recover_node_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void autosave_task(lv_task_t * task);
+static bool ancestor_is_dirty(doc_id_t id);
+static uint32_t subtree_write(FILE * fp, doc_id_t root);
+static bool node_write_cb(doc_id_t id, void * user_data);
+static void snap_write(FILE * fp, const projsnap_t * snap);
+static void dirty_forget(doc_id_t id);
+static uint32_t node_parent_uid(doc_id_t id);
+
+static bool recover_grow(recover_node_t ** nodes, uint32_t * cap, uint32_t uid);
+static void recover_kill(recover_node_t * nodes, uint32_t cnt, uint32_t root);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static FILE * journal = NULL;
+static lv_task_t * autosave_task_p = NULL;
+static doc_id_t dirty_queue[AUTOSAVE_QUEUE_MAX];
+static uint32_t dirty_cnt = 0;
+static uint32_t deleted_queue[AUTOSAVE_QUEUE_MAX];
+static uint32_t deleted_cnt = 0;
+static bool full_rewrite = false;       //The queue overflowed, the next flush compacts
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void autosave_init(void)
+{
+    if(autosave_task_p != NULL) return;
+
+    autosave_task_p = lv_task_create(autosave_task, AUTOSAVE_PERIOD, LV_TASK_PRIO_LOWEST, NULL);
+
+    //Start from a snapshot of the current tree. Its `fsync` waits for the disk, so it's written by the
+    //first run of the task instead of delaying the first frame. The edits till then are in it too.
+    full_rewrite = true;
+}
+
+//Called on every edit, so it's cheap: just flag the node and remember it
+void autosave_mark(doc_id_t id)
+{
+    doc_hash_invalidate(id);        //Every edit comes here, the autosave's or not
+    searchidx_mark(id);
+    footprint_mark();
+    doc_node_t * n = doc_get(id);
+    if(autosave_task_p == NULL || n == NULL || id == DOC_ROOT) return;
+
+    if(n->dirty) return;
+    n->dirty = 1;
+
+    if(dirty_cnt < AUTOSAVE_QUEUE_MAX) dirty_queue[dirty_cnt++] = id;
+    else full_rewrite = true;
+}
+
+//Call it before the node is removed from the document
+void autosave_mark_deleted(doc_id_t id)
+{
+    doc_node_t * n = doc_get(id);
+    if(autosave_task_p == NULL || n == NULL || id == DOC_ROOT) return;
+
+    dirty_forget(id);
+    autosave_forget(n->uid);
+}
+
+//Call it before a subtree leaves the document but not the project (a stored screen). It's journaled
+//now and the journal keeps it.
+void autosave_mark_stored(doc_id_t id)
+{
+    doc_node_t * n = doc_get(id);
+    if(autosave_task_p == NULL || n == NULL || id == DOC_ROOT) return;
+
+    dirty_forget(id);
+    if(journal != NULL)
+    {
+        subtree_write(journal, id);
+        fflush(journal);
+    }else
+    {
+        full_rewrite = true;
+    }
+}
+
+//Drop a journaled subtree which isn't in the document, e.g. the old version of a stored screen opened again
+void autosave_forget(uint32_t uid)
+{
+    if(autosave_task_p == NULL) return;
+
+    if(deleted_cnt < AUTOSAVE_QUEUE_MAX) deleted_queue[deleted_cnt++] = uid;
+    else full_rewrite = true;
+}
+
+//Replace the journal with one snapshot of every screen, the stored ones too
+void autosave_compact(void)
+{
+    doc_node_t * root = doc_get(DOC_ROOT);
+    if(root == NULL || root->first_child == DOC_NONE) return;
+
+    char tmp_path[sizeof(AUTOSAVE_FILE) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", AUTOSAVE_FILE);
+    FILE * fp = fopen(tmp_path, "w");
+    if(fp == NULL) return;
+
+    doc_id_t id;
+    for(id = root->first_child; id != DOC_NONE; id = doc_get(id)->next) subtree_write(fp, id);
+    uint32_t i;
+    for(i = 0; i < screens_get_cnt(); i++)
+    {
+        const projsnap_t * stored = screens_get_stored(i);
+        if(stored != NULL) snap_write(fp, stored);
+    }
+    bool res = fflush(fp) == 0 && fsync(fileno(fp)) == 0;
+    if(fclose(fp) != 0) res = false;
+    if(!res || rename(tmp_path, AUTOSAVE_FILE) != 0)
+    {
+        remove(tmp_path);
+        return;     //Keep the old journal and the queue, try again with the next flush
+    }
+
+    if(journal != NULL) fclose(journal);
+    journal = fopen(AUTOSAVE_FILE, "a");
+
+    dirty_cnt = 0;
+    deleted_cnt = 0;
+    full_rewrite = false;
+}
+
+//Replay a journal and write the resulting project as XML
+bool autosave_recover(const char * journal_path, const char * xml_path)
+{
+    FILE * fp = fopen(journal_path, "r");
+    if(fp == NULL) return false;
+
+    recover_node_t * nodes = NULL;
+    uint32_t cap = 0;
+    uint32_t * pending = NULL;      //uids of the subtree being read
+    uint32_t pending_cnt = 0, pending_cap = 0;
+    uint32_t sub_root = 0;
+    bool in_subtree = false;
+    bool res = true;
+
+    char line[RECOVER_LINE_MAX];
+    while(res && fgets(line, sizeof(line), fp) != NULL)
+    {
+        unsigned uid, par, type;
+        int x, y, w, h;
+        if(line[0] == 'S' && sscanf(line, "S %u %u", &uid, &par) == 2)
+        {
+            sub_root = uid;
+            pending_cnt = 0;
+            in_subtree = true;
+        }else if(line[0] == 'N' && in_subtree && sscanf(line, "N %u %u %u %d %d %d %d", &uid, &par, &type, &x, &y, &w, &h) == 7)
+        {
+            if(uid == 0 || !recover_grow(&nodes, &cap, uid)) { res = false; break; }
+            if(pending_cnt == pending_cap)
+            {
+                uint32_t new_cap = pending_cap ? pending_cap * 2 : 64;
+                uint32_t * new_buf = realloc(pending, new_cap * sizeof(uint32_t));
+                if(new_buf == NULL) { res = false; break; }
+                pending = new_buf;
+                pending_cap = new_cap;
+            }
+            pending[pending_cnt++] = uid;
+            recover_node_t * n = &nodes[uid];
+            n->parent = par;
+            n->type = type;
+            n->x = x;
+            n->y = y;
+            n->w = w;
+            n->h = h;
+        }else if(line[0] == 'E' && in_subtree)
+        {
+            if(sub_root < cap) recover_kill(nodes, cap, sub_root);     //The old version of the subtree
+            uint32_t i;
+            for(i = 0; i < pending_cnt; i++) nodes[pending[i]].alive = true;
+            in_subtree = false;
+        }else if(line[0] == 'D' && sscanf(line, "D %u", &uid) == 1)
+        {
+            if(uid < cap) recover_kill(nodes, cap, uid);
+        }
+    }
+    fclose(fp);
+    free(pending);      //A subtree without 'E' was cut by a crash, ignore it
+
+    if(!res || cap == 0)
+    {
+        free(nodes);
+        return false;
+    }
+
+    //Link the children in uid (creation) order, then write them in preorder
+    uint32_t * first_child = calloc(cap, sizeof(uint32_t));
+    uint32_t * next = calloc(cap, sizeof(uint32_t));
+    uint32_t * stack = malloc(cap * sizeof(uint32_t));
+    xmlstream_t xs;
+    if(first_child == NULL || next == NULL || stack == NULL || !xmlstream_open(&xs, xml_path))
+    {
+        free(first_child);
+        free(next);
+        free(stack);
+        free(nodes);
+        return false;
+    }
+
+    uint32_t top_first = 0;
+    uint32_t uid;
+    for(uid = cap - 1; uid > 0; uid--)
+    {
+        if(!nodes[uid].alive) continue;
+        uint32_t par = nodes[uid].parent;
+        if(par != 0 && par < cap && nodes[par].alive)
+        {
+            next[uid] = first_child[par];
+            first_child[par] = uid;
+        }else if(par == 0)
+        {
+            next[uid] = top_first;
+            top_first = uid;
+        }
+    }
+
+    uint32_t depth = 0;
+    uint32_t cur = top_first;
+    while(cur != 0 || depth != 0)
+    {
+        if(cur == 0)        //No more siblings, go back to the parent
+        {
+            xmlstream_end(&xs);
+            cur = next[stack[--depth]];
+            continue;
+        }
+        const widget_desc_t * desc = widgetreg_get(nodes[cur].type);
+        xmlstream_begin(&xs, desc ? desc->tag : widget_get_type_name(WIDGET_TYPE_OBJ));
+        xmlstream_attr_int(&xs, "x", nodes[cur].x);
+        xmlstream_attr_int(&xs, "y", nodes[cur].y);
+        xmlstream_attr_int(&xs, "w", nodes[cur].w);
+        xmlstream_attr_int(&xs, "h", nodes[cur].h);
+        stack[depth++] = cur;
+        cur = first_child[cur];
+    }
+
+    res = xmlstream_close(&xs);
+    free(first_child);
+    free(next);
+    free(stack);
+    free(nodes);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void autosave_task(lv_task_t * task)
+{
+    (void)task;
+    if(full_rewrite)
+    {
+        autosave_compact();
+        return;
+    }
+    if(journal == NULL || (dirty_cnt == 0 && deleted_cnt == 0)) return;
+
+    uint32_t i;
+    for(i = 0; i < deleted_cnt; i++) fprintf(journal, "D %u\n", (unsigned)deleted_queue[i]);
+    deleted_cnt = 0;
+
+    int32_t budget = AUTOSAVE_NODE_BUDGET;
+    for(i = 0; i < dirty_cnt && budget > 0; i++)
+    {
+        doc_id_t id = dirty_queue[i];
+        if(!doc_get(id)->dirty) continue;           //Already written with an ancestor
+        if(ancestor_is_dirty(id)) continue;         //The ancestor is queued and will write it
+        budget -= subtree_write(journal, id);
+    }
+    memmove(dirty_queue, &dirty_queue[i], (dirty_cnt - i) * sizeof(doc_id_t));
+    dirty_cnt -= i;
+
+    fflush(journal);
+    if(ftell(journal) > AUTOSAVE_COMPACT_SIZE) autosave_compact();
+}
+
+static bool ancestor_is_dirty(doc_id_t id)
+{
+    doc_id_t par = doc_get(id)->parent;
+    while(par != DOC_ROOT)
+    {
+        doc_node_t * n = doc_get(par);
+        if(n->dirty) return true;
+        par = n->parent;
+    }
+    return false;
+}
+
+static uint32_t node_parent_uid(doc_id_t id)
+{
+    doc_id_t par = doc_get(id)->parent;
+    if(par == DOC_ROOT) return 0;
+    return doc_get(par)->uid;
+}
+
+//Write a subtree as one record and clear its dirty flags. Returns the number of written nodes.
+static uint32_t subtree_write(FILE * fp, doc_id_t root)
+{
+    lv_obj_layout_flush();      //The containers' sizes are refreshed only before the next frame
+    fprintf(fp, "S %u %u\n", (unsigned)doc_get(root)->uid, (unsigned)node_parent_uid(root));
+    uint32_t cnt = doc_traverse(root, node_write_cb, NULL, fp);
+    fputs("E\n", fp);
+    return cnt;
+}
+
+static bool node_write_cb(doc_id_t id, void * user_data)
+{
+    FILE * fp = user_data;
+    doc_node_t * n = doc_get(id);
+    widget_info_t * info = widget_get_info(n->obj);
+    fprintf(fp, "N %u %u %u %d %d %d %d\n", (unsigned)n->uid, (unsigned)node_parent_uid(id), (unsigned)info->type,
+            (int)lv_obj_get_x(n->obj), (int)lv_obj_get_y(n->obj),
+            (int)lv_obj_get_width(n->obj), (int)lv_obj_get_height(n->obj));
+    n->dirty = 0;
+    return true;
+}
+
+static bool recover_grow(recover_node_t ** nodes, uint32_t * cap, uint32_t uid)
+{
+    if(uid < *cap) return true;
+
+    uint32_t new_cap = *cap ? *cap : 64;
+    while(new_cap <= uid) new_cap *= 2;
+    recover_node_t * new_buf = realloc(*nodes, new_cap * sizeof(recover_node_t));
+    if(new_buf == NULL) return false;
+    memset(&new_buf[*cap], 0, (new_cap - *cap) * sizeof(recover_node_t));
+    *nodes = new_buf;
+    *cap = new_cap;
+    return true;
+}
+
+static void recover_kill(recover_node_t * nodes, uint32_t cnt, uint32_t root)    //Offline, so O(n * depth) is fine
+{
+    uint32_t uid;
+    for(uid = 1; uid < cnt; uid++)
+    {
+        if(!nodes[uid].alive) continue;
+        uint32_t a = uid;
+        uint32_t hops = 0;
+        while(a != 0 && a != root && a < cnt && hops++ < cnt) a = nodes[a].parent;
+        if(a == root) nodes[uid].alive = false;
+    }
+}
+
+//A stored screen as one record, the same way as subtree_write() wrote it
+static void snap_write(FILE * fp, const projsnap_t * snap)
+{
+    fprintf(fp, "S %u 0\n", (unsigned)snap->nodes[0].uid);
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        uint32_t par_uid = n->parent != PROJSNAP_NO_PARENT ? snap->nodes[n->parent].uid : 0;
+        fprintf(fp, "N %u %u %u %d %d %d %d\n", (unsigned)n->uid, (unsigned)par_uid, (unsigned)n->type,
+                (int)n->x, (int)n->y, (int)n->w, (int)n->h);
+    }
+    fputs("E\n", fp);
+}
+
+//Forget the queued subtrees which are in the subtree of `id`
+static void dirty_forget(doc_id_t id)
+{
+    uint32_t i, j;
+    for(i = 0, j = 0; i < dirty_cnt; i++)
+    {
+        if(!doc_is_descendant(dirty_queue[i], id)) dirty_queue[j++] = dirty_queue[i];
+    }
+    dirty_cnt = j;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file autosave.h
+ *
+ */
+
+#ifndef _AUTOSAVE_H_
+#define _AUTOSAVE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define AUTOSAVE_FILE           "lgd.journal"
+#define AUTOSAVE_PERIOD         2000            //[ms] between two flushes of the dirty subtrees
+#define AUTOSAVE_QUEUE_MAX      64              //Dirty subtrees to remember, more edits rewrite everything
+#define AUTOSAVE_NODE_BUDGET    2048            //Nodes written by one flush, the rest waits for the next one
+#define AUTOSAVE_COMPACT_SIZE   (1024 * 1024)   //Rewrite the journal from scratch above this size
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void autosave_init(void);
+void autosave_mark(doc_id_t id);
+void autosave_mark_deleted(doc_id_t id);
+void autosave_mark_stored(doc_id_t id);
+void autosave_forget(uint32_t uid);
+void autosave_compact(void);
+bool autosave_recover(const char * journal_path, const char * xml_path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,227 @@
+/**
+ * @file bake.c
+ * Bake static subtrees into images: the designer draws a subtree that never changes (e.g. a decorated panel with
+ * its labels) as the TFT Simulator shows it, converts it into the colours of the target, and the generated code
+ * shows it as one const image instead of creating, styling and drawing its widgets.
+ * The image is lossless: an indexed format if its colours fit into a palette and it's smaller so, else true colour.
+ * It has what's under the subtree (the parent's background) and its shadow too, so it's right only while those
+ * don't change either. The designer's draw times of the subtree and of the image are measured for the report.
+ * Only the widgets of the open screen can be drawn, the subtrees of the stored screens are generated as widgets.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "bake.h"
+#include "widgetid.h"
+#include "headless.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool id_listed(const char * id);
+static bool subtree_bake(projsnap_bake_t * b, const projsnap_t * snap, uint32_t i);
+static uint32_t draw_time_get(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static char * bake_ids = NULL;          //Comma separated IDs of the roots, NULL: none
+static uint32_t bake_cnt = 0;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+//Set the roots of the subtrees to bake as comma separated IDs. NULL or "": none
+bool bake_set(const char * ids)
+{
+    free(bake_ids);
+    bake_ids = NULL;
+    bake_cnt = 0;
+    if(ids == NULL || ids[0] == '\0') return true;
+
+    bake_ids = strdup(ids);
+    if(bake_ids == NULL) return false;
+    const char * c;
+    for(c = ids, bake_cnt = 1; *c != '\0'; c++)
+    {
+        if(*c == ',') bake_cnt++;
+    }
+    return true;
+}
+
+uint32_t bake_get_count(void)
+{
+    return bake_cnt;
+}
+
+//Draw the listed subtrees of the project's snapshot into its `bakes`. Call it on the UI thread right after taking
+//the snapshot, while the widgets are as it has them. A listed subtree in a baked one is in its image already.
+void bake_capture(projsnap_t * snap)
+{
+    if(bake_cnt == 0 || snap->cnt == 0) return;
+    snap->bakes = calloc(bake_cnt, sizeof(projsnap_bake_t));
+    if(snap->bakes == NULL) return;
+
+    uint32_t i;
+    for(i = 0; i < snap->cnt && snap->bake_cnt < bake_cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        if(n->depth == 0 || !id_listed(n->id)) continue;
+        if(!subtree_bake(&snap->bakes[snap->bake_cnt], snap, i)) continue;
+        snap->bake_cnt++;
+
+        uint32_t end;
+        for(end = i + 1; end < snap->cnt && snap->nodes[end].depth > n->depth; end++);
+        i = end - 1;
+    }
+
+    if(snap->bake_cnt == 0)
+    {
+        free(snap->bakes);
+        snap->bakes = NULL;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool id_listed(const char * id)
+{
+    size_t len = strlen(id);
+    const char * c = bake_ids;
+    while(*c != '\0')
+    {
+        size_t tok = strcspn(c, ",");
+        if(tok == len && !strncmp(c, id, len)) return true;
+        c += tok;
+        if(*c == ',') c++;
+    }
+    return false;
+}
+
+//Draw a subtree as it's shown and convert it. False if it can't be, it's generated as widgets then.
+static bool subtree_bake(projsnap_bake_t * b, const projsnap_t * snap, uint32_t i)
+{
+    const char * id = snap->nodes[i].id;
+    lv_obj_t * obj = widgetid_find(id);
+    if(obj == NULL)
+    {
+        printf("Bake %s: its screen isn't open, it's generated as widgets\n", id);
+        return false;
+    }
+
+    //With its shadow, without what the ancestors clip
+    lv_area_t area;
+    lv_obj_get_coords(obj, &area);
+    area.x1 -= obj->ext_draw_pad;
+    area.y1 -= obj->ext_draw_pad;
+    area.x2 += obj->ext_draw_pad;
+    area.y2 += obj->ext_draw_pad;
+    lv_obj_t * par;
+    for(par = lv_obj_get_parent(obj); par != NULL; par = lv_obj_get_parent(par))
+    {
+        if(!lv_area_intersect(&area, &area, &par->coords))
+        {
+            printf("Bake %s: it's not visible, it's generated as widgets\n", id);
+            return false;
+        }
+    }
+    uint32_t w = lv_area_get_width(&area);
+    uint32_t h = lv_area_get_height(&area);
+    if(w > IMGASSET_SIZE_MAX || h > IMGASSET_SIZE_MAX)
+    {
+        printf("Bake %s: %ux%u is too large for an image, it's generated as widgets\n", id, w, h);
+        return false;
+    }
+
+    lv_color_t * buf = malloc(w * h * sizeof(lv_color_t));
+    lv_color32_t * px = malloc(w * h * sizeof(lv_color32_t));
+    if(buf == NULL || px == NULL)
+    {
+        free(buf);
+        free(px);
+        return false;
+    }
+    b->draw_us = draw_time_get(obj, buf, &area);
+
+    //In the colours of the target, the designer draws the image in them too
+    uint8_t depth = imgasset_get_target().depth;
+    uint32_t k;
+    for(k = 0; k < w * h; k++)
+    {
+        px[k].full = lv_color_to32(buf[k]);
+        headless_color_to_depth(&px[k], depth);
+        buf[k] = lv_color_make(px[k].ch.red, px[k].ch.green, px[k].ch.blue);
+    }
+    if(!imgasset_convert_px(px, w, h, &b->img))
+    {
+        printf("Bake %s: can't convert it, it's generated as widgets\n", id);
+        free(buf);
+        free(px);
+        return false;
+    }
+    b->node = i;
+    b->x = lv_obj_get_x(obj) + area.x1 - obj->coords.x1;
+    b->y = lv_obj_get_y(obj) + area.y1 - obj->coords.y1;
+
+    //The same with the image on the top layer instead of the subtree. An indexed one is drawn from its data,
+    //a true colour one (of an other depth) from the designer's colours.
+    lv_img_dsc_t dsc;
+    dsc.header = b->img.header;
+    if(dsc.header.cf == LV_IMG_CF_TRUE_COLOR)
+    {
+        dsc.data = (const uint8_t *)buf;
+        dsc.data_size = w * h * sizeof(lv_color_t);
+    }else
+    {
+        dsc.data = b->img.data;
+        dsc.data_size = b->img.data_size;
+    }
+    lv_obj_t * img = lv_img_create(lv_disp_get_layer_top(NULL), NULL);
+    if(img != NULL)
+    {
+        lv_img_set_src(img, &dsc);
+        lv_obj_set_pos(img, area.x1, area.y1);
+        //Not `lv_obj_set_hidden`: the layout of the parent mustn't change
+        obj->hidden = 1;
+        lv_obj_outdate_clip(obj);
+        b->img_draw_us = draw_time_get(img, (lv_color_t *)px, &area);
+        obj->hidden = 0;
+        lv_obj_outdate_clip(obj);
+        lv_obj_del(img);
+        lv_img_cache_invalidate_src(&dsc);
+    }
+    free(buf);
+    free(px);
+    return true;
+}
+
+//[us] of drawing the screen up to `obj` on `area` into `buf`, averaged over BAKE_RUNS
+static uint32_t draw_time_get(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area)
+{
+    lv_refr_snapshot(obj, buf, area);       //Warm up the caches (e.g. of the images) as the refreshes did
+    uint64_t t_start = SDL_GetPerformanceCounter();
+    uint32_t r;
+    for(r = 0; r < BAKE_RUNS; r++) lv_refr_snapshot(obj, buf, area);
+    uint64_t t = SDL_GetPerformanceCounter() - t_start;
+    return (uint32_t)(t * 1000000 / SDL_GetPerformanceFrequency() / BAKE_RUNS);
+}
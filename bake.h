@@ -0,0 +1,54 @@
+/**
+ * @file bake.h
+ *
+ */
+
+#ifndef _BAKE_H_
+#define _BAKE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "projjob.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BAKE_RUNS               8       //Draws of a subtree averaged for the draw times
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool bake_set(const char * ids);
+uint32_t bake_get_count(void);
+void bake_capture(projsnap_t * snap);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,968 @@
+/**
+ * @file bench.c
+ * Measure the drawing with a fixed set of scenes on an in-memory display.
+ * Every scene is redrawn on the whole screen `frames` times with `lv_refr_now` and nothing else runs in between
+ * (no tasks, no animations, no input), so two runs on the same machine draw exactly the same pixels.
+ * The flushing only releases the buffer, the measured time is the drawing of LittlevGL.
+ * With a model path the drawing operations of every scene are counted by `lv_prof` in a few more frames and the
+ * costs of the operations on this machine are fitted to the times (`frametime.c`).
+ * The pixel kernels are timed alone too: the SIMD blending and filling of `lv_draw_simd.c` against the plain C loops
+ * of `lv_draw_basic.c` on a display buffer of pixels, and their results are compared. The eased animation paths are
+ * timed from their tables (`LV_ANIM_PATH_LUT`) against computing them in every step, with the largest difference.
+ * If the working directory has a generated `lv_gui.py`, its import is measured too with the `micropython`
+ * (`$MICROPYTHON`) of the lv_micropython port, from the source and from mpy-cross (`$MPY_CROSS`) bytecode.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <SDL2/SDL.h>
+#include "bench.h"
+#include "loadproj.h"
+#include "frametime.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_IMG_SIZE      64          //Width and height of the test images
+#define BENCH_GRID_GAP      10
+#define BENCH_POLYGON_CNT   8           //Corners of the polygons
+#define BENCH_PY_MODULE     "lv_gui.py"
+#define BENCH_PY_RUNS       10          //Imports measured, each in a new interpreter
+#define BENCH_PY_CMD_MAX    512
+#define BENCH_MODEL_FRAMES  10          //Frames counted by `lv_prof` for the model
+#define BENCH_KERNEL_RUNS   200         //Measured calls of a kernel, on `LV_HOR_RES_MAX * BENCH_BUF_LINES` pixels
+#define BENCH_KERNEL_OPA    LV_OPA_50
+#define BENCH_PATH_RANGE    1000        //The measured animations go from 0 to this in this many ms
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    bool (*create)(lv_obj_t * scr);     //Create the scene on `scr`. false: it can't be drawn (e.g. disabled in lv_conf.h)
+}bench_scene_t;
+
+typedef struct
+{
+    const char * name;
+    bool skipped;
+    double median;                      //[ms] per frame
+    double p99;                         //[ms] per frame
+    double mpx;                         //Drawn Mpx/s with the median frame time
+    bool sampled;                       //`sample` is measured
+    frametime_sample_t sample;
+}bench_res_t;
+
+typedef struct
+{
+    const char * name;
+    bool skipped;                       //The optimized version isn't compiled in (e.g. `LV_USE_SIMD 0`)
+    bool same;                          //Both versions give the same result
+    int32_t diff_max;                   //Largest difference of a result of an approximating version, -1: exact
+    double ref_ns;                      //[ns] per item (pixel) of the plain C version, median
+    double opt_ns;                      //[ns] per item of the optimized version, median
+}bench_kernel_res_t;
+
+typedef struct
+{
+    bool skipped;                       //No `lv_gui.py` or no MicroPython with the `lvgl` module
+    double src_ms;                      //Median import time of the source
+    double mpy_ms;                      //The same of the bytecode, as it's frozen. < 0: no mpy-cross
+}bench_py_res_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void bench_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void scene_measure(lv_disp_t * disp, const bench_scene_t * scene, uint32_t frames, double * times, bench_res_t * res,
+                          bool sample);
+static bool model_write(const char * path, const bench_res_t * res, uint32_t cnt);
+static int time_cmp(const void * a, const void * b);
+static bool json_write(const char * path, const bench_res_t * res, uint32_t cnt, uint32_t frames,
+                       const bench_kernel_res_t * kernels, uint32_t kernel_cnt, const bench_py_res_t * py);
+static uint32_t kernels_measure(bench_kernel_res_t * res);
+#if LV_USE_SIMD
+static void kernel_blend_measure(bench_kernel_res_t * res, lv_color_t * dest, lv_color_t * src, uint32_t px);
+static void kernel_fill_measure(bench_kernel_res_t * res, lv_color_t * dest, lv_color_t * src, uint32_t px);
+static void kernel_pattern(lv_color_t * buf, uint32_t px, uint32_t seed);
+#endif
+#if LV_USE_ANIMATION && LV_ANIM_PATH_LUT
+static void kernel_path_measure(bench_kernel_res_t * res, const char * name, lv_anim_path_cb_t path);
+#endif
+static double kernel_time_median(double * times, uint32_t items);
+static void py_import_measure(bench_py_res_t * res);
+static double py_import_time(const char * dir);
+static void grid_place(lv_obj_t * obj, uint32_t id, lv_coord_t w, lv_coord_t h);
+static uint32_t grid_cnt(lv_coord_t w, lv_coord_t h);
+static bool rect_flat_create(lv_obj_t * scr);
+static bool rect_shadow_create(lv_obj_t * scr);
+#if LV_FONT_ROBOTO_12
+static bool text_12_create(lv_obj_t * scr);
+#endif
+#if LV_FONT_ROBOTO_16
+static bool text_16_create(lv_obj_t * scr);
+#endif
+#if LV_FONT_ROBOTO_22
+static bool text_22_create(lv_obj_t * scr);
+#endif
+#if LV_FONT_ROBOTO_28
+static bool text_28_create(lv_obj_t * scr);
+#endif
+static bool text_create(lv_obj_t * scr, const lv_font_t * font);
+static bool img_true_color_create(lv_obj_t * scr);
+static bool img_chroma_create(lv_obj_t * scr);
+static bool img_alpha_create(lv_obj_t * scr);
+static bool img_indexed_create(lv_obj_t * scr);
+static bool img_create(lv_obj_t * scr, lv_img_cf_t cf);
+static bool img_tiled_create(lv_obj_t * scr);
+static void img_dsc_build(lv_img_cf_t cf);
+static bool arc_create(lv_obj_t * scr);
+static bool line_create(lv_obj_t * scr);
+static bool polygon_create(lv_obj_t * scr);
+static bool polygon_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode);
+static bool opa_group_create(lv_obj_t * scr);
+static bool project_create(lv_obj_t * scr);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const bench_scene_t scenes[] =
+{
+    {"rect_flat", rect_flat_create},
+    {"rect_radius_shadow", rect_shadow_create},
+#if LV_FONT_ROBOTO_12
+    {"text_roboto_12", text_12_create},
+#endif
+#if LV_FONT_ROBOTO_16
+    {"text_roboto_16", text_16_create},
+#endif
+#if LV_FONT_ROBOTO_22
+    {"text_roboto_22", text_22_create},
+#endif
+#if LV_FONT_ROBOTO_28
+    {"text_roboto_28", text_28_create},
+#endif
+    {"img_true_color", img_true_color_create},
+    {"img_chroma", img_chroma_create},
+    {"img_alpha", img_alpha_create},
+    {"img_indexed", img_indexed_create},
+    {"img_tiled", img_tiled_create},
+    {"arc", arc_create},
+    {"line", line_create},
+    {"polygon", polygon_create},
+    {"opa_group", opa_group_create},
+    {"project", project_create},
+};
+
+#define BENCH_SCENE_CNT     (sizeof(scenes) / sizeof(scenes[0]))
+#define BENCH_KERNEL_MAX    8
+
+static volatile int32_t kernel_sink;    //The results of the measured calls go here, so they aren't left out
+
+static const char * bench_text =
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore et dolore "
+    "magna aliqua. Ut enim ad minim veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea commodo "
+    "consequat. Duis aute irure dolor in reprehenderit in voluptate velit esse cillum dolore eu fugiat nulla pariatur. "
+    "Excepteur sint occaecat cupidatat non proident, sunt in culpa qui officia deserunt mollit anim id est laborum. "
+    "0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz.\n";
+
+static lv_style_t scene_style;
+static lv_style_t scene_style2;
+static lv_img_dsc_t scene_img;
+static uint8_t scene_img_data[BENCH_IMG_SIZE * BENCH_IMG_SIZE * LV_IMG_PX_SIZE_ALPHA_BYTE];
+static lv_point_t scene_points[16];
+static char * scene_text;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Draw every scene on an in-memory display of `LV_HOR_RES_MAX` x `LV_VER_RES_MAX`, print the times and write them
+//into `json_path` too if it's not NULL, the fitted frame time model into `model_path` if it's not NULL.
+//Call it after `lv_init` instead of creating the GUI.
+bool bench_run(uint32_t frames, const char * json_path, const char * model_path)
+{
+    if(frames == 0) frames = 1;
+
+    uint32_t buf_px = (uint32_t)LV_HOR_RES_MAX * BENCH_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    double * times = malloc(frames * sizeof(double));
+    bench_res_t * res = calloc(BENCH_SCENE_CNT, sizeof(bench_res_t));
+    if(buf == NULL || times == NULL || res == NULL)
+    {
+        printf("Benchmark failed, out of memory\n");
+        free(buf);
+        free(times);
+        free(res);
+        return false;
+    }
+
+    lv_disp_buf_t disp_buf;
+    lv_disp_buf_init(&disp_buf, buf, NULL, buf_px);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = LV_HOR_RES_MAX;
+    disp_drv.ver_res = LV_VER_RES_MAX;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = bench_flush;
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    printf("%d x %d, %u frames per scene\n", LV_HOR_RES_MAX, LV_VER_RES_MAX, frames);
+    printf("%-20s %10s %10s %10s\n", "scene", "median ms", "p99 ms", "Mpx/s");
+
+    uint32_t i;
+    for(i = 0; i < BENCH_SCENE_CNT; i++)
+    {
+        scene_measure(disp, &scenes[i], frames, times, &res[i], model_path != NULL);
+        if(res[i].skipped) printf("%-20s %10s\n", res[i].name, "skipped");
+        else printf("%-20s %10.3f %10.3f %10.1f\n", res[i].name, res[i].median, res[i].p99, res[i].mpx);
+    }
+
+    bench_kernel_res_t kernels[BENCH_KERNEL_MAX];
+    uint32_t kernel_cnt = kernels_measure(kernels);
+    printf("%-20s %10s %10s %10s\n", "kernel", "plain ns", "opt ns", "speedup");
+    for(i = 0; i < kernel_cnt; i++)
+    {
+        const bench_kernel_res_t * k = &kernels[i];
+        if(k->skipped) printf("%-20s %10.3f %10s\n", k->name, k->ref_ns, "skipped");
+        else if(k->diff_max >= 0) printf("%-20s %10.3f %10.3f %9.2fx max diff %d\n", k->name, k->ref_ns, k->opt_ns,
+                                         k->opt_ns > 0 ? k->ref_ns / k->opt_ns : 0, k->diff_max);
+        else printf("%-20s %10.3f %10.3f %9.2fx%s\n", k->name, k->ref_ns, k->opt_ns,
+                    k->opt_ns > 0 ? k->ref_ns / k->opt_ns : 0, k->same ? "" : " DIFFERENT RESULT");
+    }
+
+    bench_py_res_t py;
+    py_import_measure(&py);
+    if(py.skipped) printf("%-20s %10s\n", "py_import", "skipped");
+    else if(py.mpy_ms < 0) printf("%-20s %10.3f ms from the source (no mpy-cross)\n", "py_import", py.src_ms);
+    else printf("%-20s %10.3f ms from the source, %.3f ms from bytecode\n", "py_import", py.src_ms, py.mpy_ms);
+
+    bool ok = true;
+    if(json_path != NULL) ok = json_write(json_path, res, BENCH_SCENE_CNT, frames, kernels, kernel_cnt, &py);
+    for(i = 0; i < kernel_cnt; i++)
+    {
+        if(!kernels[i].skipped && !kernels[i].same) ok = false;
+    }
+    if(model_path != NULL && !model_write(model_path, res, BENCH_SCENE_CNT)) ok = false;
+
+    //Nothing may point to the buffer
+    lv_obj_del(lv_disp_get_scr_act(disp));
+    lv_obj_del(lv_disp_get_layer_top(disp));
+    lv_obj_del(lv_disp_get_layer_sys(disp));
+    lv_disp_remove(disp);
+    free(scene_text);
+    scene_text = NULL;
+    free(buf);
+    free(times);
+    free(res);
+    return ok;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void bench_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+//Create a scene on the cleaned screen and redraw it `frames` times, then count its drawing operations if `sample`
+static void scene_measure(lv_disp_t * disp, const bench_scene_t * scene, uint32_t frames, double * times, bench_res_t * res,
+                          bool sample)
+{
+    lv_obj_t * scr = lv_disp_get_scr_act(disp);
+    lv_obj_clean(scr);
+    lv_obj_set_style(scr, &lv_style_scr);
+
+    res->name = scene->name;
+    res->skipped = !scene->create(scr);
+    if(res->skipped) return;
+
+    uint32_t f;
+    for(f = 0; f < BENCH_WARMUP_FRAMES; f++)
+    {
+        lv_obj_invalidate(scr);
+        lv_refr_now(disp);
+    }
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    for(f = 0; f < frames; f++)
+    {
+        lv_obj_invalidate(scr);
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        lv_refr_now(disp);
+        times[f] = (double)(SDL_GetPerformanceCounter() - t_start) * 1000.0 / freq;
+    }
+
+    qsort(times, frames, sizeof(double), time_cmp);
+    res->median = times[frames / 2];
+    res->p99 = times[(frames * 99 + 99) / 100 - 1];
+    double px = (double)LV_HOR_RES_MAX * LV_VER_RES_MAX;
+    res->mpx = res->median > 0 ? px / (res->median * 1000.0) : 0;
+
+    //Not in the measured frames, the counting takes some time too
+    if(sample)
+    {
+        bool prof_en = lv_prof_get_en();
+        lv_prof_clean();
+        lv_prof_set_en(true);
+        for(f = 0; f < BENCH_MODEL_FRAMES; f++)
+        {
+            lv_obj_invalidate(scr);
+            lv_refr_now(disp);
+        }
+        lv_prof_set_en(prof_en);
+        res->sampled = frametime_sample_from_prof(&res->sample);
+        lv_prof_clean();
+    }
+}
+
+//Fit the costs of the drawing operations to the scenes and write them as the model of this machine
+static bool model_write(const char * path, const bench_res_t * res, uint32_t cnt)
+{
+    frametime_sample_t * samples = malloc(cnt * sizeof(frametime_sample_t));
+    if(samples == NULL) return false;
+
+    uint32_t sample_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(res[i].sampled) samples[sample_cnt++] = res[i].sample;
+    }
+
+    frametime_model_t model;
+    memset(&model, 0, sizeof(model));
+    if(gethostname(model.name, sizeof(model.name) - 1) != 0 || model.name[0] == '\0') strcpy(model.name, "bench");
+    frametime_fit(samples, sample_cnt, &model);
+    free(samples);
+
+    //How well the model explains the scenes
+    printf("%-20s %10s %10s\n", "model of", "drawn ms", "model ms");
+    for(i = 0; i < cnt; i++)
+    {
+        if(!res[i].sampled) continue;
+        uint32_t draw[LV_PROF_DRAW_NUM];
+        uint8_t d;
+        for(d = 0; d < LV_PROF_DRAW_NUM; d++) draw[d] = (uint32_t)res[i].sample.draw[d];
+        printf("%-20s %10.3f %10.3f\n", res[i].name, res[i].sample.draw_us / 1000.0,
+               frametime_predict(&model, draw, (uint32_t)res[i].sample.calls, 0) / 1000.0);
+    }
+    return frametime_model_save(path, &model);
+}
+
+static int time_cmp(const void * a, const void * b)
+{
+    double ta = *(const double *)a;
+    double tb = *(const double *)b;
+    return (ta > tb) - (ta < tb);
+}
+
+//{"hres": ..., "vres": ..., "frames": ..., "scenes": [{"name": ..., "median_ms": ..., "p99_ms": ..., "mpx_s": ...}, ...],
+// "kernels": [{"name": ..., "plain_ns": ..., "opt_ns": ..., "max_diff": ...}, ...],
+// "py_import": {"source_ms": ..., "mpy_ms": ...}}, without `opt_ns` and `py_import` if they were skipped,
+// `max_diff` only for the approximating versions
+static bool json_write(const char * path, const bench_res_t * res, uint32_t cnt, uint32_t frames,
+                       const bench_kernel_res_t * kernels, uint32_t kernel_cnt, const bench_py_res_t * py)
+{
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "{\"hres\": %d, \"vres\": %d, \"frames\": %u, \"scenes\": [", LV_HOR_RES_MAX, LV_VER_RES_MAX, frames);
+    bool first = true;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(res[i].skipped) continue;
+        fprintf(fp, "%s\n  {\"name\": \"%s\", \"median_ms\": %.4f, \"p99_ms\": %.4f, \"mpx_s\": %.2f}",
+                first ? "" : ",", res[i].name, res[i].median, res[i].p99, res[i].mpx);
+        first = false;
+    }
+    fprintf(fp, "\n],\n\"kernels\": [");
+    for(i = 0; i < kernel_cnt; i++)
+    {
+        fprintf(fp, "%s\n  {\"name\": \"%s\", \"plain_ns\": %.4f", i == 0 ? "" : ",", kernels[i].name, kernels[i].ref_ns);
+        if(!kernels[i].skipped) fprintf(fp, ", \"opt_ns\": %.4f", kernels[i].opt_ns);
+        if(!kernels[i].skipped && kernels[i].diff_max >= 0) fprintf(fp, ", \"max_diff\": %d", kernels[i].diff_max);
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "\n]");
+    if(!py->skipped)
+    {
+        fprintf(fp, ",\n\"py_import\": {\"source_ms\": %.4f", py->src_ms);
+        if(py->mpy_ms >= 0) fprintf(fp, ", \"mpy_ms\": %.4f", py->mpy_ms);
+        fprintf(fp, "}");
+    }
+    fprintf(fp, "}\n");
+
+    bool ok = !ferror(fp);
+    if(fclose(fp) != 0) ok = false;
+    if(!ok) printf("Can't write %s\n", path);
+    return ok;
+}
+
+//Time the optimized pixel kernels and animation paths against the plain versions. Returns the number of results in `res`.
+static uint32_t kernels_measure(bench_kernel_res_t * res)
+{
+    uint32_t cnt = 0;
+#if LV_USE_SIMD
+    uint32_t px = (uint32_t)LV_HOR_RES_MAX * BENCH_BUF_LINES;
+    lv_color_t * dest = malloc(px * sizeof(lv_color_t));
+    lv_color_t * src = malloc(px * sizeof(lv_color_t));
+    if(dest != NULL && src != NULL)
+    {
+        printf("SIMD: %s\n", lv_draw_simd_get_name());
+        kernel_blend_measure(&res[cnt++], dest, src, px);
+        kernel_fill_measure(&res[cnt++], dest, src, px);
+    }
+    free(dest);
+    free(src);
+#endif
+
+#if LV_USE_ANIMATION && LV_ANIM_PATH_LUT
+    kernel_path_measure(&res[cnt++], "anim_ease_in", lv_anim_path_ease_in);
+    kernel_path_measure(&res[cnt++], "anim_ease_out", lv_anim_path_ease_out);
+    kernel_path_measure(&res[cnt++], "anim_ease_in_out", lv_anim_path_ease_in_out);
+    kernel_path_measure(&res[cnt++], "anim_overshoot", lv_anim_path_overshoot);
+    kernel_path_measure(&res[cnt++], "anim_bounce", lv_anim_path_bounce);
+#endif
+    (void)res;
+    return cnt;
+}
+
+#if LV_USE_SIMD
+//`lv_draw_simd_blend` with the rest blended by `lv_color_mix` as `sw_mem_blend` does, against `lv_color_mix` alone
+static void kernel_blend_measure(bench_kernel_res_t * res, lv_color_t * dest, lv_color_t * src, uint32_t px)
+{
+    res->name = "blend_opa_50";
+    res->same = false;
+    res->diff_max = -1;
+    res->opt_ns = 0;
+    res->skipped = strcmp(lv_draw_simd_get_name(), "none") == 0;
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double times[BENCH_KERNEL_RUNS];
+    kernel_pattern(src, px, 1);
+    uint32_t r;
+    uint32_t i;
+
+    //A checksum of one call to compare the versions, `src` is the input
+    kernel_pattern(dest, px, 2);
+    for(i = 0; i < px; i++) dest[i] = lv_color_mix(src[i], dest[i], BENCH_KERNEL_OPA);
+    uint64_t ref_sum = 0;
+    for(i = 0; i < px; i++) ref_sum = ref_sum * 31 + dest[i].full;
+
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        for(i = 0; i < px; i++) dest[i] = lv_color_mix(src[i], dest[i], BENCH_KERNEL_OPA);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+    }
+    res->ref_ns = kernel_time_median(times, px);
+    if(res->skipped) return;
+
+    kernel_pattern(dest, px, 2);
+    i = lv_draw_simd_blend(dest, src, px, BENCH_KERNEL_OPA);
+    for(; i < px; i++) dest[i] = lv_color_mix(src[i], dest[i], BENCH_KERNEL_OPA);
+    uint64_t opt_sum = 0;
+    for(i = 0; i < px; i++) opt_sum = opt_sum * 31 + dest[i].full;
+    res->same = opt_sum == ref_sum;
+
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        i = lv_draw_simd_blend(dest, src, px, BENCH_KERNEL_OPA);
+        for(; i < px; i++) dest[i] = lv_color_mix(src[i], dest[i], BENCH_KERNEL_OPA);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+    }
+    res->opt_ns = kernel_time_median(times, px);
+}
+
+//`lv_draw_simd_fill` with the rest mixed by `lv_color_mix` as `sw_color_mix_row` does, against `lv_color_mix` alone
+static void kernel_fill_measure(bench_kernel_res_t * res, lv_color_t * dest, lv_color_t * src, uint32_t px)
+{
+    res->name = "fill_opa_50";
+    res->same = false;
+    res->diff_max = -1;
+    res->opt_ns = 0;
+    res->skipped = strcmp(lv_draw_simd_get_name(), "none") == 0;
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double times[BENCH_KERNEL_RUNS];
+    lv_color_t color = LV_COLOR_MAKE(0x20, 0x90, 0xE0);
+    uint32_t r;
+    uint32_t i;
+
+    kernel_pattern(dest, px, 3);
+    for(i = 0; i < px; i++) dest[i] = lv_color_mix(color, dest[i], BENCH_KERNEL_OPA);
+    memcpy(src, dest, px * sizeof(lv_color_t));
+
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        for(i = 0; i < px; i++) dest[i] = lv_color_mix(color, dest[i], BENCH_KERNEL_OPA);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+    }
+    res->ref_ns = kernel_time_median(times, px);
+    if(res->skipped) return;
+
+    kernel_pattern(dest, px, 3);
+    i = lv_draw_simd_fill(dest, px, color, BENCH_KERNEL_OPA);
+    for(; i < px; i++) dest[i] = lv_color_mix(color, dest[i], BENCH_KERNEL_OPA);
+    res->same = memcmp(src, dest, px * sizeof(lv_color_t)) == 0;
+
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        i = lv_draw_simd_fill(dest, px, color, BENCH_KERNEL_OPA);
+        for(; i < px; i++) dest[i] = lv_color_mix(color, dest[i], BENCH_KERNEL_OPA);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+    }
+    res->opt_ns = kernel_time_median(times, px);
+}
+
+//Pixels of every color, different with every `seed`
+static void kernel_pattern(lv_color_t * buf, uint32_t px, uint32_t seed)
+{
+    uint32_t x = seed * 2654435761U;
+    uint32_t i;
+    for(i = 0; i < px; i++)
+    {
+        x = x * 1103515245U + 12345U;
+        buf[i] = LV_COLOR_MAKE((x >> 24) & 0xFF, (x >> 16) & 0xFF, (x >> 8) & 0xFF);
+    }
+}
+#endif
+
+#if LV_USE_ANIMATION && LV_ANIM_PATH_LUT
+//Every value of an animation computed in every step, then interpolated from the path's table as the animations do
+static void kernel_path_measure(bench_kernel_res_t * res, const char * name, lv_anim_path_cb_t path)
+{
+    res->name = name;
+    res->skipped = false;
+    res->same = true;
+    res->diff_max = 0;
+
+    lv_anim_t a;
+    lv_anim_init(&a);
+    a.start = 0;
+    a.end = BENCH_PATH_RANGE;
+    a.time = BENCH_PATH_RANGE;
+
+    double freq = (double)SDL_GetPerformanceFrequency();
+    double times[BENCH_KERNEL_RUNS];
+    lv_anim_value_t ref[BENCH_PATH_RANGE + 1];
+    uint32_t r;
+    int32_t sum;
+
+    lv_anim_path_set_lut(false);
+    for(a.act_time = 0; a.act_time <= a.time; a.act_time++) ref[a.act_time] = path(&a);
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        sum = 0;
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        for(a.act_time = 0; a.act_time <= a.time; a.act_time++) sum += path(&a);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+        kernel_sink = sum;
+    }
+    res->ref_ns = kernel_time_median(times, BENCH_PATH_RANGE + 1);
+
+    lv_anim_path_set_lut(true);
+    for(a.act_time = 0; a.act_time <= a.time; a.act_time++)
+    {
+        int32_t diff = path(&a) - ref[a.act_time];
+        diff = LV_MATH_ABS(diff);
+        if(diff > res->diff_max) res->diff_max = diff;
+    }
+    for(r = 0; r < BENCH_KERNEL_RUNS; r++)
+    {
+        sum = 0;
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        for(a.act_time = 0; a.act_time <= a.time; a.act_time++) sum += path(&a);
+        times[r] = (double)(SDL_GetPerformanceCounter() - t_start) * 1e9 / freq;
+        kernel_sink = sum;
+    }
+    res->opt_ns = kernel_time_median(times, BENCH_PATH_RANGE + 1);
+}
+#endif
+
+//Median [ns] of `BENCH_KERNEL_RUNS` times per item
+static double kernel_time_median(double * times, uint32_t items)
+{
+    qsort(times, BENCH_KERNEL_RUNS, sizeof(double), time_cmp);
+    return times[BENCH_KERNEL_RUNS / 2] / items;
+}
+
+//Import `lv_gui.py` from the source, then compiled to bytecode as the firmware would have it frozen
+static void py_import_measure(bench_py_res_t * res)
+{
+    res->skipped = true;
+    res->mpy_ms = -1;
+    if(access(BENCH_PY_MODULE, R_OK) != 0) return;
+    res->src_ms = py_import_time(".");
+    if(res->src_ms < 0) return;
+    res->skipped = false;
+
+    char dir[] = "/tmp/lv_gui_mpy_XXXXXX";
+    if(mkdtemp(dir) == NULL) return;
+    const char * mpy_cross = getenv("MPY_CROSS");
+    char cmd[BENCH_PY_CMD_MAX];
+    snprintf(cmd, sizeof(cmd), "%s -o %s/lv_gui.mpy %s >/dev/null 2>&1",
+             mpy_cross != NULL ? mpy_cross : "mpy-cross", dir, BENCH_PY_MODULE);
+    if(system(cmd) == 0) res->mpy_ms = py_import_time(dir);
+
+    snprintf(cmd, sizeof(cmd), "%s/lv_gui.mpy", dir);
+    remove(cmd);
+    rmdir(dir);
+}
+
+//Median [ms] of importing `lv_gui` from `dir` in new interpreters, without importing `lvgl`. -1: it failed.
+static double py_import_time(const char * dir)
+{
+    const char * mp = getenv("MICROPYTHON");
+    char cmd[BENCH_PY_CMD_MAX];
+    snprintf(cmd, sizeof(cmd), "%s -c \"import sys; sys.path.insert(0, '%s'); import lvgl, time; "
+             "t = time.ticks_us(); import lv_gui; print(time.ticks_diff(time.ticks_us(), t))\" 2>/dev/null",
+             mp != NULL ? mp : "micropython", dir);
+
+    double times[BENCH_PY_RUNS];
+    uint32_t r;
+    for(r = 0; r < BENCH_PY_RUNS; r++)
+    {
+        FILE * p = popen(cmd, "r");
+        if(p == NULL) return -1;
+        long us = -1;
+        if(fscanf(p, "%ld", &us) != 1) us = -1;
+        if(pclose(p) != 0 || us < 0) return -1;
+        times[r] = us / 1000.0;
+    }
+    qsort(times, BENCH_PY_RUNS, sizeof(double), time_cmp);
+    return times[BENCH_PY_RUNS / 2];
+}
+
+//Put the `id`th cell of a `w` x `h` grid covering the screen
+static void grid_place(lv_obj_t * obj, uint32_t id, lv_coord_t w, lv_coord_t h)
+{
+    uint32_t col_cnt = LV_HOR_RES_MAX / (w + BENCH_GRID_GAP);
+    lv_obj_set_size(obj, w, h);
+    lv_obj_set_pos(obj, BENCH_GRID_GAP + (id % col_cnt) * (w + BENCH_GRID_GAP),
+                   BENCH_GRID_GAP + (id / col_cnt) * (h + BENCH_GRID_GAP));
+}
+
+static uint32_t grid_cnt(lv_coord_t w, lv_coord_t h)
+{
+    return (LV_HOR_RES_MAX / (w + BENCH_GRID_GAP)) * (LV_VER_RES_MAX / (h + BENCH_GRID_GAP));
+}
+
+static bool rect_flat_create(lv_obj_t * scr)
+{
+    lv_style_copy(&scene_style, &lv_style_plain_color);
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(140, 100); i++)
+    {
+        lv_obj_t * obj = lv_obj_create(scr, NULL);
+        lv_obj_set_style(obj, &scene_style);
+        grid_place(obj, i, 140, 100);
+    }
+    return true;
+}
+
+static bool rect_shadow_create(lv_obj_t * scr)
+{
+    lv_style_copy(&scene_style, &lv_style_pretty_color);
+    scene_style.body.radius = 12;
+    scene_style.body.border.width = 2;
+    scene_style.body.shadow.width = 12;
+    scene_style.body.shadow.color = LV_COLOR_GRAY;
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(140, 100); i++)
+    {
+        lv_obj_t * obj = lv_obj_create(scr, NULL);
+        lv_obj_set_style(obj, &scene_style);
+        grid_place(obj, i, 140, 100);
+    }
+    return true;
+}
+
+#if LV_FONT_ROBOTO_12
+static bool text_12_create(lv_obj_t * scr)
+{
+    return text_create(scr, &lv_font_roboto_12);
+}
+#endif
+
+#if LV_FONT_ROBOTO_16
+static bool text_16_create(lv_obj_t * scr)
+{
+    return text_create(scr, &lv_font_roboto_16);
+}
+#endif
+
+#if LV_FONT_ROBOTO_22
+static bool text_22_create(lv_obj_t * scr)
+{
+    return text_create(scr, &lv_font_roboto_22);
+}
+#endif
+
+#if LV_FONT_ROBOTO_28
+static bool text_28_create(lv_obj_t * scr)
+{
+    return text_create(scr, &lv_font_roboto_28);
+}
+#endif
+
+//Fill the screen with wrapped text
+static bool text_create(lv_obj_t * scr, const lv_font_t * font)
+{
+    //Enough lines for the smallest font, the larger ones are clipped by the screen
+    if(scene_text == NULL)
+    {
+        size_t len = strlen(bench_text);
+        uint32_t cnt = LV_VER_RES_MAX / 12;
+        scene_text = malloc(len * cnt + 1);
+        if(scene_text == NULL) return false;
+        uint32_t i;
+        for(i = 0; i < cnt; i++) memcpy(&scene_text[i * len], bench_text, len);
+        scene_text[len * cnt] = '\0';
+    }
+
+    lv_style_copy(&scene_style, &lv_style_plain);
+    scene_style.text.font = font;
+
+    lv_obj_t * label = lv_label_create(scr, NULL);
+    lv_label_set_style(label, LV_LABEL_STYLE_MAIN, &scene_style);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_BREAK);
+    lv_obj_set_width(label, LV_HOR_RES_MAX - 2 * BENCH_GRID_GAP);
+    lv_label_set_static_text(label, scene_text);
+    lv_obj_set_pos(label, BENCH_GRID_GAP, BENCH_GRID_GAP);
+    return true;
+}
+
+static bool img_true_color_create(lv_obj_t * scr)
+{
+    return img_create(scr, LV_IMG_CF_TRUE_COLOR);
+}
+
+static bool img_chroma_create(lv_obj_t * scr)
+{
+    return img_create(scr, LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED);
+}
+
+static bool img_alpha_create(lv_obj_t * scr)
+{
+    return img_create(scr, LV_IMG_CF_TRUE_COLOR_ALPHA);
+}
+
+static bool img_indexed_create(lv_obj_t * scr)
+{
+    return img_create(scr, LV_IMG_CF_INDEXED_4BIT);
+}
+
+//Tile the screen with a gradient image of `cf`
+static bool img_create(lv_obj_t * scr, lv_img_cf_t cf)
+{
+    img_dsc_build(cf);
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(BENCH_IMG_SIZE, BENCH_IMG_SIZE); i++)
+    {
+        lv_obj_t * img = lv_img_create(scr, NULL);
+        lv_img_set_src(img, &scene_img);
+        grid_place(img, i, BENCH_IMG_SIZE, BENCH_IMG_SIZE);
+    }
+    return true;
+}
+
+//Fill the screen with one tiled indexed image, it's decoded row by row
+static bool img_tiled_create(lv_obj_t * scr)
+{
+    img_dsc_build(LV_IMG_CF_INDEXED_4BIT);
+
+    lv_obj_t * img = lv_img_create(scr, NULL);
+    lv_img_set_src(img, &scene_img);
+    lv_img_set_tiled(img, true);
+    lv_obj_set_size(img, lv_obj_get_width(scr), lv_obj_get_height(scr));
+    return true;
+}
+
+//A gradient image of `cf` in `scene_img`. The chroma keyed one has transparent squares, the alpha one fades out.
+static void img_dsc_build(lv_img_cf_t cf)
+{
+    memset(&scene_img, 0, sizeof(scene_img));
+    memset(scene_img_data, 0, sizeof(scene_img_data));
+    scene_img.header.cf = cf;
+    scene_img.header.w = BENCH_IMG_SIZE;
+    scene_img.header.h = BENCH_IMG_SIZE;
+    scene_img.data = scene_img_data;
+    scene_img.data_size = (lv_img_color_format_get_px_size(cf) * BENCH_IMG_SIZE * BENCH_IMG_SIZE) / 8;
+
+    if(cf == LV_IMG_CF_INDEXED_4BIT)
+    {
+        scene_img.data_size += 16 * sizeof(lv_color32_t);
+        uint8_t i;
+        for(i = 0; i < 16; i++) lv_img_buf_set_palette(&scene_img, i, LV_COLOR_MAKE(i * 16, 255 - i * 16, 128));
+    }
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < BENCH_IMG_SIZE; y++)
+    {
+        for(x = 0; x < BENCH_IMG_SIZE; x++)
+        {
+            lv_color_t c = LV_COLOR_MAKE(x * 4, y * 4, 128);
+            if(cf == LV_IMG_CF_INDEXED_4BIT) c.full = ((x + y) / 8) & 0xF;
+            else if(cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && ((x / 8) + (y / 8)) % 2) c = LV_COLOR_TRANSP;
+            lv_img_buf_set_px_color(&scene_img, x, y, c);
+            if(cf == LV_IMG_CF_TRUE_COLOR_ALPHA) lv_img_buf_set_px_alpha(&scene_img, x, y, x * 4);
+        }
+    }
+}
+
+static bool arc_create(lv_obj_t * scr)
+{
+#if LV_USE_ARC
+    lv_style_copy(&scene_style, &lv_style_plain_color);
+    scene_style.line.width = 8;
+    scene_style.line.color = LV_COLOR_BLUE;
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(100, 100); i++)
+    {
+        lv_obj_t * arc = lv_arc_create(scr, NULL);
+        lv_arc_set_style(arc, LV_ARC_STYLE_MAIN, &scene_style);
+        lv_arc_set_angles(arc, 30 + (i * 20) % 90, 330);
+        grid_place(arc, i, 100, 100);
+    }
+    return true;
+#else
+    (void)scr;
+    return false;
+#endif
+}
+
+static bool line_create(lv_obj_t * scr)
+{
+#if LV_USE_LINE
+    lv_style_copy(&scene_style, &lv_style_plain_color);
+    scene_style.line.width = 3;
+    scene_style.line.color = LV_COLOR_RED;
+
+    //A zigzag with steep and flat segments
+    uint16_t p;
+    for(p = 0; p < 16; p++)
+    {
+        scene_points[p].x = p * 9;
+        scene_points[p].y = (p % 2) ? 90 : (p % 4) * 15;
+    }
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(140, 100); i++)
+    {
+        lv_obj_t * line = lv_line_create(scr, NULL);
+        lv_line_set_style(line, LV_LINE_STYLE_MAIN, &scene_style);
+        lv_line_set_points(line, scene_points, 16);
+        lv_line_set_auto_size(line, false);
+        grid_place(line, i, 140, 100);
+    }
+    return true;
+#else
+    (void)scr;
+    return false;
+#endif
+}
+
+static bool polygon_create(lv_obj_t * scr)
+{
+    lv_style_copy(&scene_style, &lv_style_plain_color);
+    scene_style.body.main_color = LV_COLOR_GREEN;
+    scene_style.body.grad_color = LV_COLOR_GREEN;
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(100, 100); i++)
+    {
+        lv_obj_t * obj = lv_obj_create(scr, NULL);
+        lv_obj_set_style(obj, &scene_style);
+        lv_obj_set_design_cb(obj, polygon_design);
+        grid_place(obj, i, 100, 100);
+    }
+    return true;
+}
+
+//Draw a regular polygon into the object instead of a rectangle
+static bool polygon_design(lv_obj_t * obj, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    if(mode == LV_DESIGN_COVER_CHK) return false;
+    if(mode != LV_DESIGN_DRAW_MAIN) return true;
+
+    //The corners of an octagon, clockwise from the top
+    static const int8_t corners[BENCH_POLYGON_CNT][2] = {{0, -50}, {35, -35}, {50, 0}, {35, 35},
+                                                           {0, 50}, {-35, 35}, {-50, 0}, {-35, -35}};
+
+    lv_coord_t cx = obj->coords.x1 + lv_obj_get_width(obj) / 2;
+    lv_coord_t cy = obj->coords.y1 + lv_obj_get_height(obj) / 2;
+    lv_point_t points[BENCH_POLYGON_CNT];
+    uint32_t i;
+    for(i = 0; i < BENCH_POLYGON_CNT; i++)
+    {
+        points[i].x = cx + corners[i][0];
+        points[i].y = cy + corners[i][1];
+    }
+    lv_draw_polygon(points, BENCH_POLYGON_CNT, mask, lv_obj_get_style(obj), lv_obj_get_opa_scale(obj));
+    return true;
+}
+
+//Half transparent containers with a button and a label in every one
+static bool opa_group_create(lv_obj_t * scr)
+{
+    lv_style_copy(&scene_style, &lv_style_pretty);
+    lv_style_copy(&scene_style2, &lv_style_btn_rel);
+
+    uint32_t i;
+    for(i = 0; i < grid_cnt(200, 160); i++)
+    {
+        lv_obj_t * cont = lv_obj_create(scr, NULL);
+        lv_obj_set_style(cont, &scene_style);
+        lv_obj_set_opa_scale_enable(cont, true);
+        lv_obj_set_opa_scale(cont, LV_OPA_50);
+        grid_place(cont, i, 200, 160);
+
+        lv_obj_t * btn = lv_btn_create(cont, NULL);
+        lv_btn_set_style(btn, LV_BTN_STYLE_REL, &scene_style2);
+        lv_obj_set_size(btn, 160, 50);
+        lv_obj_align(btn, NULL, LV_ALIGN_IN_TOP_MID, 0, 15);
+        lv_obj_t * label = lv_label_create(btn, NULL);
+        lv_label_set_text(label, "Button");
+
+        label = lv_label_create(cont, NULL);
+        lv_label_set_text(label, "Opacity scaled\ngroup of widgets");
+        lv_obj_align(label, NULL, LV_ALIGN_IN_BOTTOM_MID, 0, -15);
+    }
+    return true;
+}
+
+//The screens of the project in the working directory as they are loaded by the headless rendering
+static bool project_create(lv_obj_t * scr)
+{
+    load_project(scr);
+
+    lv_obj_t * root = lv_obj_get_child_back(scr, NULL);
+    if(root == NULL) return false;
+    lv_obj_set_pos(root, 0, 0);
+    return true;
+}
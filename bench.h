@@ -0,0 +1,53 @@
+/**
+ * @file bench.h
+ *
+ */
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BENCH_BUF_LINES         40      //The display buffer is this many lines of the screen, as in the headless rendering
+#define BENCH_FRAMES_DEF        100     //Measured frames of a scene
+#define BENCH_WARMUP_FRAMES     5       //Not measured frames before them (to fill the caches)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool bench_run(uint32_t frames, const char * json_path, const char * model_path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,563 @@
+/**
+ * @binproj .c
+ * Binary project format. The file is memory-mapped and turned into widgets directly,
+ * without a DOM and without parsing numbers.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <mxml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "binproj.h"
+#include "dataset.h"
+#include "widgetreg.h"
+#include "xmlstream.h"
+#include "screens.h"
+#include "toolbox.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BUILDER_INIT_CAPACITY   64
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const uint8_t * data;
+    size_t size;
+    const binproj_header_t * header;
+    const binproj_node_t * nodes;
+    const binproj_attr_t * attrs;
+    const char * str;
+}binproj_map_t;
+
+typedef struct
+{
+    binproj_node_t * nodes;
+    uint32_t node_cnt, node_cap;
+    binproj_attr_t * attrs;
+    uint32_t attr_cnt, attr_cap;
+    char * pool;
+    uint32_t pool_size, pool_cap;
+    uint32_t * intern;          //Open addressing table of pool offset + 1, 0: empty slot
+    uint32_t intern_cnt, intern_cap;
+    uint32_t * stack;           //Index of the parent node of the elements being parsed
+    uint32_t depth, stack_cap;
+    bool error;
+}binproj_builder_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool binproj_map(const char * path, binproj_map_t * map);
+static void binproj_unmap(binproj_map_t * map);
+static bool binproj_validate(binproj_map_t * map);
+
+static void xml2bin_sax_cb(mxml_node_t * node, mxml_sax_event_t event, void * data);
+//The value of a text attribute of a node, NULL if it has none
+static const char * binproj_attr_find(const binproj_map_t * map, const binproj_node_t * node, const char * name)
+{
+    uint32_t a;
+    for(a = node->attr_first; a < node->attr_first + node->attr_cnt; a++)
+    {
+        const binproj_attr_t * attr = &map->attrs[a];
+        if(attr->kind == BINPROJ_ATTR_STR && !strcmp(map->str + attr->name, name)) return map->str + attr->value;
+    }
+    return NULL;
+}
+
+static bool builder_grow(void ** buf, uint32_t * cap, uint32_t need, size_t item_size);
+static uint32_t builder_intern(binproj_builder_t * b, const char * str);
+static bool builder_push(binproj_builder_t * b, uint32_t node_id);
+static bool builder_write(binproj_builder_t * b, const char * path, uint64_t key);
+static void builder_free(binproj_builder_t * b);
+static uint32_t str_hash(const char * str);
+static uint64_t key_hash(uint64_t h, const void * data, size_t size);
+static uint64_t fd_source_key(int fd);
+static const char * binproj_attr_find(const binproj_map_t * map, const binproj_node_t * node, const char * name);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+//Create the widgets of a binary project on `par`. Returns the number of created widgets, -1 on error
+int32_t binproj_load(lv_obj_t * par, const char * path)
+{
+    binproj_map_t map;
+    if(!binproj_map(path, &map)) return -1;
+
+    uint32_t node_cnt = map.header->node_cnt;
+    lv_obj_t ** objs = malloc((node_cnt ? node_cnt : 1) * sizeof(lv_obj_t *));
+    if(objs == NULL)
+    {
+        binproj_unmap(&map);
+        return -1;
+    }
+
+    int32_t created = 0;
+    uint32_t screen_first = 0;      //The nodes before it are in the screens already complete, maybe stored
+    uint32_t i;
+    for(i = 0; i < node_cnt; i++)
+    {
+        const binproj_node_t * node = &map.nodes[i];
+        if(node->parent == BINPROJ_NO_PARENT && node->type == BINPROJ_TYPE_SCREEN)
+        {
+            lv_obj_t * win = screens_load_screen(binproj_attr_find(&map, node, "id"));
+            objs[i] = win != NULL ? win : par;
+            screen_first = i;
+            continue;
+        }
+        lv_obj_t * node_par = node->parent == BINPROJ_NO_PARENT ? par : objs[node->parent];
+        if(node->parent != BINPROJ_NO_PARENT && node->parent < screen_first) node_par = NULL;
+        const widget_desc_t * desc = widgetreg_get(node->type);
+        if(desc == NULL || node_par == NULL)
+        {
+            objs[i] = node_par;     //Unknown type: its children go to the parent. NULL: its parent is stored
+            continue;
+        }
+
+        lv_obj_t * obj = desc->create_cb(node_par, NULL);
+        widget_set_info(obj, desc->type);
+        widget_info_t * par_info = widget_get_info(node_par);
+        toolbox_adopt(obj, par_info != NULL ? par_info->node : DOC_NONE);
+        objs[i] = obj;
+        created++;
+
+        uint32_t a;
+        for(a = node->attr_first; a < node->attr_first + node->attr_cnt; a++)
+        {
+            const binproj_attr_t * attr = &map.attrs[a];
+            const widget_attr_desc_t * attr_desc = widgetreg_find_attr(desc, map.str + attr->name);
+            if(attr_desc == NULL) continue;
+
+            if(attr->kind == BINPROJ_ATTR_INT && attr_desc->set_int_cb != NULL)
+            {
+                attr_desc->set_int_cb(obj, attr->value);
+            }else if(attr->kind == BINPROJ_ATTR_STR)
+            {
+                widgetreg_attr_apply(attr_desc, obj, map.str + attr->value);
+            }
+        }
+    }
+
+    free(objs);
+    binproj_unmap(&map);
+    return created;
+}
+
+//Doesn't touch the widgets, can run on any thread
+bool binproj_from_xml(const char * xml_path, const char * bin_path)
+{
+    //Hash and parse the same file, even if lgd.xml is replaced meanwhile
+    int fd = open(xml_path, O_RDONLY);
+    if(fd < 0) return false;
+    uint64_t key = fd_source_key(fd);
+    FILE * fp = lseek(fd, 0, SEEK_SET) == 0 ? fdopen(fd, "r") : NULL;
+    if(fp == NULL)
+    {
+        close(fd);
+        return false;
+    }
+
+    binproj_builder_t b;
+    memset(&b, 0, sizeof(b));
+    builder_intern(&b, "");         //Offset 0 is always the empty string
+
+    mxmlSAXLoadFile(NULL, fp, MXML_OPAQUE_CALLBACK, xml2bin_sax_cb, &b);
+    fclose(fp);
+
+    bool res = !b.error && builder_write(&b, bin_path, key);
+    builder_free(&b);
+    return res;
+}
+
+bool binproj_to_xml(const char * bin_path, const char * xml_path)
+{
+    binproj_map_t map;
+    if(!binproj_map(bin_path, &map)) return false;
+
+    uint32_t node_cnt = map.header->node_cnt;
+    uint32_t * open_nodes = malloc((node_cnt ? node_cnt : 1) * sizeof(uint32_t));   //Ancestors of the current node
+    xmlstream_t xs;
+    if(open_nodes == NULL || !xmlstream_open(&xs, xml_path))
+    {
+        free(open_nodes);
+        binproj_unmap(&map);
+        return false;
+    }
+
+    uint32_t depth = 0;
+    uint32_t i;
+    for(i = 0; i < node_cnt; i++)
+    {
+        const binproj_node_t * node = &map.nodes[i];
+        while(depth && open_nodes[depth - 1] != node->parent)     //Close the elements of the previous subtree
+        {
+            xmlstream_end(&xs);
+            depth--;
+        }
+
+        const widget_desc_t * desc = widgetreg_get(node->type);
+        if(node->type == BINPROJ_TYPE_SCREEN) xmlstream_begin(&xs, SCREENS_TAG);
+        else xmlstream_begin(&xs, desc ? desc->tag : widget_get_type_name(WIDGET_TYPE_OBJ));
+        open_nodes[depth++] = i;
+
+        uint32_t a;
+        for(a = node->attr_first; a < node->attr_first + node->attr_cnt; a++)
+        {
+            const binproj_attr_t * attr = &map.attrs[a];
+            if(attr->kind == BINPROJ_ATTR_INT) xmlstream_attr_int(&xs, map.str + attr->name, attr->value);
+            else xmlstream_attr(&xs, map.str + attr->name, map.str + attr->value);
+        }
+    }
+
+    bool res = xmlstream_close(&xs);    //Ends the open elements too
+    free(open_nodes);
+    binproj_unmap(&map);
+    return res;
+}
+
+/**
+ * The key of an XML project: a hash of its content and of what the designer makes of it (the widget
+ * registry and BINPROJ_KEY_SALT). A binary file compiled with the same key creates the same widgets.
+ * @return the key, 0 if the file can't be read
+ */
+uint64_t binproj_source_key(const char * xml_path)
+{
+    int fd = open(xml_path, O_RDONLY);
+    if(fd < 0) return 0;
+    uint64_t key = fd_source_key(fd);
+    close(fd);
+    return key;
+}
+
+//The key of the XML a binary project was compiled from, 0 if it's unknown or the file can't be read
+uint64_t binproj_get_source_key(const char * bin_path)
+{
+    FILE * fp = fopen(bin_path, "rb");
+    if(fp == NULL) return 0;
+
+    binproj_header_t h;
+    memset(&h, 0, sizeof(h));
+    size_t n = fread(&h, 1, sizeof(h), fp);
+    fclose(fp);
+
+    if(n < BINPROJ_HEADER_MIN_SIZE || h.magic != BINPROJ_MAGIC || h.version != BINPROJ_VERSION) return 0;
+    if(n < sizeof(h) || h.header_size < sizeof(h)) return 0;
+    return h.src_key;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static bool binproj_map(const char * path, binproj_map_t * map)
+{
+    memset(map, 0, sizeof(binproj_map_t));
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0) return false;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t)BINPROJ_HEADER_MIN_SIZE)
+    {
+        close(fd);
+        return false;
+    }
+
+    void * data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);      //The mapping stays valid
+    if(data == MAP_FAILED) return false;
+
+    map->data = data;
+    map->size = st.st_size;
+    if(!binproj_validate(map))
+    {
+        printf("Invalid binary project: %s\n", path);
+        binproj_unmap(map);
+        return false;
+    }
+    return true;
+}
+
+static void binproj_unmap(binproj_map_t * map)
+{
+    if(map->data != NULL) munmap((void *)map->data, map->size);
+    memset(map, 0, sizeof(binproj_map_t));
+}
+
+//Check every offset and index once, so the loaders can use them without checks
+static bool binproj_validate(binproj_map_t * map)
+{
+    const binproj_header_t * h = (const binproj_header_t *)map->data;
+    if(h->magic != BINPROJ_MAGIC || h->version != BINPROJ_VERSION) return false;
+    if(h->header_size < BINPROJ_HEADER_MIN_SIZE || h->header_size > map->size) return false;
+
+    uint64_t node_end = (uint64_t)h->node_ofs + (uint64_t)h->node_cnt * sizeof(binproj_node_t);
+    uint64_t attr_end = (uint64_t)h->attr_ofs + (uint64_t)h->attr_cnt * sizeof(binproj_attr_t);
+    uint64_t str_end = (uint64_t)h->str_ofs + h->str_size;
+    if(node_end > map->size || attr_end > map->size || str_end > map->size) return false;
+    if((h->node_ofs & 3) || (h->attr_ofs & 3)) return false;
+    if(h->str_size == 0 || map->data[h->str_ofs + h->str_size - 1] != '\0') return false;
+
+    map->header = h;
+    map->nodes = (const binproj_node_t *)(map->data + h->node_ofs);
+    map->attrs = (const binproj_attr_t *)(map->data + h->attr_ofs);
+    map->str = (const char *)(map->data + h->str_ofs);
+
+    uint32_t i;
+    for(i = 0; i < h->node_cnt; i++)
+    {
+        const binproj_node_t * node = &map->nodes[i];
+        if(node->parent != BINPROJ_NO_PARENT && node->parent >= i) return false;
+        if((uint64_t)node->attr_first + node->attr_cnt > h->attr_cnt) return false;
+    }
+    for(i = 0; i < h->attr_cnt; i++)
+    {
+        const binproj_attr_t * attr = &map->attrs[i];
+        if(attr->name >= h->str_size) return false;
+        if(attr->kind == BINPROJ_ATTR_STR && (attr->value < 0 || (uint32_t)attr->value >= h->str_size)) return false;
+        if(attr->kind != BINPROJ_ATTR_STR && attr->kind != BINPROJ_ATTR_INT) return false;
+    }
+    return true;
+}
+
+static void xml2bin_sax_cb(mxml_node_t * node, mxml_sax_event_t event, void * data)
+{
+    binproj_builder_t * b = data;
+    if(b->error) return;
+
+    uint32_t par_id = b->depth ? b->stack[b->depth - 1] : BINPROJ_NO_PARENT;
+    if(event == MXML_SAX_ELEMENT_OPEN)
+    {
+        const widget_desc_t * desc = widgetreg_find_tag(mxmlGetElement(node));
+        bool screen = par_id == BINPROJ_NO_PARENT && !strcasecmp(mxmlGetElement(node), SCREENS_TAG);
+        if(desc == NULL && !screen)
+        {
+            if(!builder_push(b, par_id)) b->error = true;   //Unknown tag: keep the nesting
+            return;
+        }
+
+        if(!builder_grow((void **)&b->nodes, &b->node_cap, b->node_cnt + 1, sizeof(binproj_node_t)))
+        {
+            b->error = true;
+            return;
+        }
+        uint32_t node_id = b->node_cnt++;
+        binproj_node_t * bnode = &b->nodes[node_id];
+        bnode->parent = par_id;
+        bnode->type = screen ? BINPROJ_TYPE_SCREEN : desc->type;
+        bnode->attr_first = b->attr_cnt;
+        bnode->attr_cnt = 0;
+
+        int i, count;
+        for(i = 0, count = mxmlElementGetAttrCount(node); i < count; i++)
+        {
+            const char * name, * value;
+            value = mxmlElementGetAttrByIndex(node, i, &name);
+            if(!builder_grow((void **)&b->attrs, &b->attr_cap, b->attr_cnt + 1, sizeof(binproj_attr_t)))
+            {
+                b->error = true;
+                return;
+            }
+
+            binproj_attr_t * attr = &b->attrs[b->attr_cnt];
+            memset(attr, 0, sizeof(binproj_attr_t));
+            attr->name = builder_intern(b, name);
+
+            const widget_attr_desc_t * attr_desc = desc != NULL ? widgetreg_find_attr(desc, name) : NULL;
+            int32_t v;
+            if(attr_desc != NULL && attr_desc->set_int_cb != NULL && widgetreg_parse_int(value, &v))
+            {
+                attr->kind = BINPROJ_ATTR_INT;
+                attr->value = v;
+            }else
+            {
+                attr->kind = BINPROJ_ATTR_STR;      //Unknown attributes are kept as text
+                attr->value = builder_intern(b, value);
+            }
+            b->attr_cnt++;
+            b->nodes[node_id].attr_cnt++;
+        }
+
+        if(!builder_push(b, node_id)) b->error = true;
+    }else if(event == MXML_SAX_ELEMENT_CLOSE)
+    {
+        if(b->depth) b->depth--;
+    }
+}
+
+static bool builder_grow(void ** buf, uint32_t * cap, uint32_t need, size_t item_size)
+{
+    if(need <= *cap) return true;
+
+    uint32_t new_cap = *cap ? *cap : BUILDER_INIT_CAPACITY;
+    while(new_cap < need) new_cap *= 2;
+    void * new_buf = realloc(*buf, new_cap * item_size);
+    if(new_buf == NULL) return false;
+    *buf = new_buf;
+    *cap = new_cap;
+    return true;
+}
+
+//Add a string to the pool only once. Returns its offset.
+static uint32_t builder_intern(binproj_builder_t * b, const char * str)
+{
+    if(b->error) return 0;
+
+    if((b->intern_cnt + 1) * 2 > b->intern_cap)     //Keep the load factor under 0.5
+    {
+        uint32_t new_cap = b->intern_cap ? b->intern_cap * 2 : BUILDER_INIT_CAPACITY;
+        uint32_t * new_tab = calloc(new_cap, sizeof(uint32_t));
+        if(new_tab == NULL)
+        {
+            b->error = true;
+            return 0;
+        }
+        uint32_t i;
+        for(i = 0; i < b->intern_cap; i++)      //Rehash
+        {
+            if(b->intern[i] == 0) continue;
+            uint32_t j = str_hash(b->pool + b->intern[i] - 1) & (new_cap - 1);
+            while(new_tab[j] != 0) j = (j + 1) & (new_cap - 1);
+            new_tab[j] = b->intern[i];
+        }
+        free(b->intern);
+        b->intern = new_tab;
+        b->intern_cap = new_cap;
+    }
+
+    uint32_t i = str_hash(str) & (b->intern_cap - 1);
+    while(b->intern[i] != 0)
+    {
+        if(!strcmp(b->pool + b->intern[i] - 1, str)) return b->intern[i] - 1;
+        i = (i + 1) & (b->intern_cap - 1);
+    }
+
+    uint32_t len = strlen(str) + 1;
+    if(!builder_grow((void **)&b->pool, &b->pool_cap, b->pool_size + len, 1))
+    {
+        b->error = true;
+        return 0;
+    }
+    uint32_t ofs = b->pool_size;
+    memcpy(b->pool + ofs, str, len);
+    b->pool_size += len;
+    b->intern[i] = ofs + 1;
+    b->intern_cnt++;
+    return ofs;
+}
+
+static bool builder_push(binproj_builder_t * b, uint32_t node_id)
+{
+    if(!builder_grow((void **)&b->stack, &b->stack_cap, b->depth + 1, sizeof(uint32_t))) return false;
+    b->stack[b->depth++] = node_id;
+    return true;
+}
+
+static bool builder_write(binproj_builder_t * b, const char * path, uint64_t key)
+{
+    binproj_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic = BINPROJ_MAGIC;
+    h.version = BINPROJ_VERSION;
+    h.header_size = sizeof(binproj_header_t);
+    h.node_cnt = b->node_cnt;
+    h.attr_cnt = b->attr_cnt;
+    h.str_size = b->pool_size;
+    h.node_ofs = sizeof(binproj_header_t);
+    h.attr_ofs = h.node_ofs + b->node_cnt * sizeof(binproj_node_t);
+    h.str_ofs = h.attr_ofs + b->attr_cnt * sizeof(binproj_attr_t);
+    h.src_key = key;
+
+    FILE * fp = fopen(path, "wb");
+    if(fp == NULL) return false;
+
+    bool res = fwrite(&h, sizeof(h), 1, fp) == 1;
+    if(res && b->node_cnt) res = fwrite(b->nodes, sizeof(binproj_node_t), b->node_cnt, fp) == b->node_cnt;
+    if(res && b->attr_cnt) res = fwrite(b->attrs, sizeof(binproj_attr_t), b->attr_cnt, fp) == b->attr_cnt;
+    if(res) res = fwrite(b->pool, 1, b->pool_size, fp) == b->pool_size;
+    if(fclose(fp) != 0) res = false;
+    return res;
+}
+
+static void builder_free(binproj_builder_t * b)
+{
+    free(b->nodes);
+    free(b->attrs);
+    free(b->pool);
+    free(b->intern);
+    free(b->stack);
+    memset(b, 0, sizeof(binproj_builder_t));
+}
+
+//The key of an opened XML file, see binproj_source_key()
+static uint64_t fd_source_key(int fd)
+{
+    struct stat st;
+    if(fstat(fd, &st) != 0) return 0;
+
+    uint64_t h = 14695981039346656037ull;
+    if(st.st_size > 0)
+    {
+        void * data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(data == MAP_FAILED) return 0;
+        h = key_hash(h, data, st.st_size);
+        munmap(data, st.st_size);
+    }
+
+    uint32_t v[2] = {BINPROJ_VERSION, BINPROJ_KEY_SALT};
+    h = key_hash(h, v, sizeof(v));
+    widget_type_t t;
+    for(t = 0; t < WIDGET_TYPE_NUM; t++)        //The binary files store the types by number and the attributes by name
+    {
+        const widget_desc_t * desc = widgetreg_get(t);
+        if(desc == NULL) continue;
+        h = key_hash(h, &t, sizeof(t));
+        h = key_hash(h, desc->tag, strlen(desc->tag) + 1);
+        const widget_attr_desc_t * a;
+        for(a = desc->attrs; a != NULL && a->name != NULL; a++) h = key_hash(h, a->name, strlen(a->name) + 1);
+    }
+
+    return h != 0 ? h : 1;
+}
+
+static uint64_t key_hash(uint64_t h, const void * data, size_t size)     //FNV-1a, 64 bit
+{
+    const uint8_t * d = data;
+    size_t i;
+    for(i = 0; i < size; i++)
+    {
+        h ^= d[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+static uint32_t str_hash(const char * str)     //FNV-1a
+{
+    uint32_t h = 2166136261u;
+    while(*str)
+    {
+        h ^= (uint8_t)*str++;
+        h *= 16777619u;
+    }
+    return h;
+}
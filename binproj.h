@@ -0,0 +1,100 @@
+/**
+ * @file binproj.h
+ *
+ */
+
+#ifndef _BINPROJ_H_
+#define _BINPROJ_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BINPROJ_FILE        "lgd.lgb"
+#define BINPROJ_MAGIC       0x4244474CUL    //"LGDB" in a little endian file
+#define BINPROJ_VERSION     1
+#define BINPROJ_NO_PARENT   0xFFFFFFFFUL
+#define BINPROJ_TYPE_SCREEN 0xFFFF          //A top level node starting a screen, older readers skip it like an unknown type
+#define BINPROJ_KEY_SALT    1               //Increase if the same XML is compiled differently, it outdates the compiled files
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/* File layout, all fields are little endian and 4 byte aligned:
+ * header | node table | attribute table | string pool
+ * Nodes are stored in document order, so a node's parent always comes before it. */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       //sizeof(binproj_header_t), lets newer readers skip added fields
+    uint32_t node_cnt;
+    uint32_t attr_cnt;
+    uint32_t str_size;          //Size of the string pool in bytes, the pool ends with '\0'
+    uint32_t node_ofs;          //Offsets from the beginning of the file
+    uint32_t attr_ofs;
+    uint32_t str_ofs;
+    uint64_t src_key;           //binproj_source_key() of the XML it was compiled from, 0: unknown. Not in older files
+}binproj_header_t;
+
+#define BINPROJ_HEADER_MIN_SIZE offsetof(binproj_header_t, src_key)     //The header of the first files
+
+typedef struct
+{
+    uint32_t parent;            //Index of the parent node or BINPROJ_NO_PARENT for top level nodes
+    uint16_t type;              //widget_type_t or BINPROJ_TYPE_SCREEN
+    uint16_t attr_cnt;
+    uint32_t attr_first;        //Index of the node's first attribute in the attribute table
+}binproj_node_t;
+
+enum
+{
+    BINPROJ_ATTR_INT = 0,       //`value` is the number itself
+    BINPROJ_ATTR_STR = 1,       //`value` is an offset in the string pool
+};
+
+typedef struct
+{
+    uint32_t name;              //Offset in the string pool
+    uint16_t kind;
+    uint16_t reserved;
+    int32_t value;
+}binproj_attr_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+int32_t binproj_load(lv_obj_t * par, const char * path);
+bool binproj_from_xml(const char * xml_path, const char * bin_path);
+bool binproj_to_xml(const char * bin_path, const char * xml_path);
+uint64_t binproj_source_key(const char * xml_path);
+uint64_t binproj_get_source_key(const char * bin_path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
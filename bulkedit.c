@@ -0,0 +1,285 @@
+/**
+ * @file bulkedit.c
+ * Edits of every selected widget at once. An edit is one transaction: the widgets are changed in one
+ * lv_obj batch, so the layouts run and the areas are redrawn once, and it's one undo step however many
+ * widgets it changed.
+ * Moving, deleting and reparenting take only the outermost selected widgets, a selected child goes with its
+ * selected parent. The screens are never moved, deleted or reparented.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include "bulkedit.h"
+#include "dataset.h"
+#include "custom_widget.h"
+#include "autosave.h"
+#include "undo.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    doc_id_t node;
+    lv_coord_t x, y;        //Where it was when it was collected
+}bulkedit_item_t;
+
+typedef struct
+{
+    bool top_only;          //Skip the descendants of the selected widgets and the screens
+    bool oom;
+}collect_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t sel_collect(bool top_only);
+static bool collect_cb(doc_id_t id, void * user_data);
+static void txn_begin(void);
+static void txn_end(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static bulkedit_item_t * items = NULL;  //The selected widgets of the running edit, in document order
+static uint32_t item_cnt = 0;
+static uint32_t item_cap = 0;
+
+//These move with the dragged `drag_obj`
+static uint32_t drag_cnt = 0;
+static lv_obj_t * drag_obj = NULL;
+static lv_coord_t drag_x, drag_y;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Move the selected widgets by (dx;dy). Returns how many were moved.
+uint32_t bulkedit_move(lv_coord_t dx, lv_coord_t dy)
+{
+    uint32_t cnt = sel_collect(true);
+    if(cnt == 0 || (dx == 0 && dy == 0)) return 0;
+
+    txn_begin();
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        lv_obj_t * obj = doc_get(items[i].node)->obj;
+        undo_edit_begin(items[i].node);
+        lv_obj_set_pos(obj, items[i].x + dx, items[i].y + dy);
+        undo_edit_end(items[i].node);
+        autosave_mark(items[i].node);
+    }
+    txn_end();
+    return cnt;
+}
+
+//Set a property of every selected widget, as the Setting does for one. false if it couldn't be set on some of them.
+bool bulkedit_set(prop_t prop, int32_t value)
+{
+    uint32_t cnt = sel_collect(false);
+    if(cnt == 0 || prop == PROP_ID) return false;
+
+    txn_begin();
+    uint32_t done = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(propbind_set(doc_get(items[i].node)->obj, prop, value)) done++;
+    }
+    txn_end();
+    return done == cnt;
+}
+
+//Edit the style of every selected widget the same way. Returns how many were changed.
+uint32_t bulkedit_restyle(stylepool_edit_cb_t cb, void * user_data)
+{
+    uint32_t cnt = sel_collect(false);
+    if(cnt == 0) return 0;
+
+    txn_begin();
+    uint32_t done = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        undo_edit_begin(items[i].node);
+        bool res = stylepool_edit(doc_get(items[i].node)->obj, cb, user_data);
+        undo_edit_end(items[i].node);
+        if(res)
+        {
+            autosave_mark(items[i].node);
+            done++;
+        }
+    }
+    txn_end();
+    return done;
+}
+
+//Delete the selected widgets with their children. Returns how many subtrees were deleted.
+uint32_t bulkedit_delete(void)
+{
+    uint32_t cnt = sel_collect(true);
+    if(cnt == 0) return 0;
+
+    txn_begin();
+    uint32_t i;
+    for(i = 0; i < cnt; i++) layerview_del(items[i].node);     //Not in an other's subtree, so it's still there
+    txn_end();
+    layerview_refr_request();
+    return cnt;
+}
+
+//Move the selected widgets under `par` as its last children, in their order. `par` itself and its ancestors stay.
+uint32_t bulkedit_reparent(doc_id_t par)
+{
+    uint32_t cnt = sel_collect(true);
+    if(cnt == 0 || doc_get(par) == NULL) return 0;
+
+    txn_begin();
+    uint32_t done = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(doc_is_descendant(par, items[i].node)) continue;
+        if(layerview_move(items[i].node, par, DOC_NONE)) done++;
+    }
+    txn_end();
+    return done;
+}
+
+//A widget is started to be dragged. If it's selected, the other selected widgets will move with it.
+void bulkedit_drag_begin(lv_obj_t * obj)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return;
+    undo_edit_begin(info->node);
+    drag_cnt = 0;
+    if(!layerview_is_sel(info->node) || layerview_get_sel_cnt() < 2) return;
+
+    //Its ancestors would move it twice
+    uint32_t cnt = sel_collect(true);
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(!doc_is_descendant(info->node, items[i].node)) items[drag_cnt++] = items[i];
+    }
+    drag_obj = obj;
+    drag_x = lv_obj_get_x(obj);
+    drag_y = lv_obj_get_y(obj);
+}
+
+//The dragged widget moved, move the others by the same
+void bulkedit_drag(lv_obj_t * obj)
+{
+    if(drag_cnt == 0 || obj != drag_obj) return;
+    lv_coord_t dx = lv_obj_get_x(obj) - drag_x;
+    lv_coord_t dy = lv_obj_get_y(obj) - drag_y;
+
+    lv_obj_batch_begin();
+    uint32_t i;
+    for(i = 0; i < drag_cnt; i++)
+    {
+        doc_node_t * n = doc_get(items[i].node);
+        if(n != NULL) lv_obj_set_pos(n->obj, items[i].x + dx, items[i].y + dy);
+    }
+    lv_obj_batch_commit();
+}
+
+//Record the drag started by bulkedit_drag_begin() with the widgets moved along as one step
+void bulkedit_drag_end(lv_obj_t * obj)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return;
+    if(drag_cnt == 0 || obj != drag_obj)
+    {
+        undo_edit_end(info->node);
+        return;
+    }
+
+    bulkedit_drag(obj);
+    undo_group_begin();
+    undo_edit_end(info->node);
+    uint32_t i;
+    for(i = 0; i < drag_cnt; i++)
+    {
+        undo_record_move(items[i].node, items[i].x, items[i].y);
+        autosave_mark(items[i].node);
+    }
+    undo_group_end();
+    drag_cnt = 0;
+    drag_obj = NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Collect the selected widgets into `items`. Returns their count, 0 if out of memory.
+static uint32_t sel_collect(bool top_only)
+{
+    item_cnt = 0;
+    drag_cnt = 0;       //Share `items`
+    if(layerview_get_sel_cnt() == 0) return 0;
+
+    collect_ctx_t ctx;
+    ctx.top_only = top_only;
+    ctx.oom = false;
+    doc_traverse(DOC_ROOT, collect_cb, NULL, &ctx);
+    if(ctx.oom)
+    {
+        printf("Bulk edit: out of memory\n");
+        item_cnt = 0;
+    }
+    return item_cnt;
+}
+
+static bool collect_cb(doc_id_t id, void * user_data)
+{
+    collect_ctx_t * ctx = user_data;
+    doc_node_t * n = doc_get(id);
+    if(id == DOC_ROOT || !n->selected || ctx->oom) return !ctx->oom;
+    if(ctx->top_only && n->parent == DOC_ROOT) return true;
+
+    if(item_cnt == item_cap)
+    {
+        uint32_t cap = item_cap ? item_cap * 2 : 64;
+        bulkedit_item_t * p = realloc(items, cap * sizeof(bulkedit_item_t));
+        if(p == NULL)
+        {
+            ctx->oom = true;
+            return false;
+        }
+        items = p;
+        item_cap = cap;
+    }
+    items[item_cnt].node = id;
+    items[item_cnt].x = lv_obj_get_x(n->obj);
+    items[item_cnt].y = lv_obj_get_y(n->obj);
+    item_cnt++;
+    return !ctx->top_only;
+}
+
+static void txn_begin(void)
+{
+    lv_obj_batch_begin();
+    undo_group_begin();
+}
+
+static void txn_end(void)
+{
+    undo_group_end();
+    lv_obj_batch_commit();
+    propbind_changed(layerview_get_sel_obj(), PROP_ALL);   //The Setting shows the primary one as it is now
+}
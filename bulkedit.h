@@ -0,0 +1,60 @@
+/**
+ * @file bulkedit.h
+ *
+ */
+
+#ifndef _BULKEDIT_H_
+#define _BULKEDIT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+#include "propbind.h"
+#include "stylepool.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+uint32_t bulkedit_move(lv_coord_t dx, lv_coord_t dy);
+bool bulkedit_set(prop_t prop, int32_t value);
+uint32_t bulkedit_restyle(stylepool_edit_cb_t cb, void * user_data);
+uint32_t bulkedit_delete(void);
+uint32_t bulkedit_reparent(doc_id_t par);
+void bulkedit_drag_begin(lv_obj_t * obj);
+void bulkedit_drag(lv_obj_t * obj);
+void bulkedit_drag_end(lv_obj_t * obj);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
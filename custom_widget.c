@@ -1,7 +1,14 @@
 #include "custom_widget.h"
 #include "dataset.h"
 #include "setting.h"
+#include "autosave.h"
+#include "doctree.h"
+#include "undo.h"
+#include "propbind.h"
+#include "searchidx.h"
 #include <stdio.h>
+#include <stdlib.h>
+#include <SDL2/SDL.h>
 typedef struct 
 {
     lv_cont_ext_t cont;
@@ -13,10 +20,59 @@ typedef struct
 
 lv_obj_t * layerview_base = NULL;
 lv_obj_t * scr1 = NULL;
-lv_obj_t * sel_layer = NULL;
+static doc_id_t sel_node = DOC_NONE;     //The primary selected one, the Setting shows it
+static uint32_t sel_cnt = 0;            //Nodes with `selected`, sel_node among them
+
+//The Layer View is virtual: only the visible rows exist and they are recycled while scrolling
+static lv_obj_t * layer_rows[LAYERVIEW_ROW_MAX];
+static uint32_t layer_row_cnt = 0;
+static bool layer_refr_req = false;
+static lv_task_t * layer_refr_task = NULL;
+static lv_signal_cb_t ancestor_scrl_signal = NULL;
+static layerview_note_cb_t layer_note_cb = NULL;
+static layerview_cost_cb_t layer_cost_cb = NULL;
+static lv_obj_t * layer_sort_btn = NULL;
+static bool layer_sort_cost = false;    //List the widgets by their cost instead of the tree
+
+typedef struct
+{
+    doc_id_t node;
+    double cost;
+    uint32_t order;         //In the tree
+}layer_cost_t;
+
+static layer_cost_t * layer_sorted = NULL;
+static uint32_t layer_sorted_cnt = 0;
+static uint32_t layer_sorted_cap = 0;
+
+typedef struct
+{
+    uint32_t row;           //Index of the current row in the flattened tree
+    uint32_t first;         //First materialized row
+    uint32_t used;          //Bound row objects
+    int32_t depth;
+}layer_refr_t;
 
 
 static void update_sel_cb(lv_obj_t * obj, lv_event_t ev);
+static void toggle_cb(lv_obj_t * obj, lv_event_t ev);
+static lv_res_t layerview_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void * param);
+static void layerview_refr_task(lv_task_t * task);
+static void layerview_refr(void);
+static bool refr_enter_cb(doc_id_t id, void * user_data);
+static bool refr_leave_cb(doc_id_t id, void * user_data);
+static void row_bind(lv_obj_t * row, doc_id_t id, uint32_t row_i, int32_t depth, bool arrow);
+static void sorted_refr(layer_refr_t * r);
+static bool sorted_add_cb(doc_id_t id, void * user_data);
+static int cost_cmp(const void * a, const void * b);
+static void sort_cb(lv_obj_t * btn, lv_event_t ev);
+static lv_obj_t * layer_row_create(void);
+static void obj_order(lv_obj_t * obj, doc_id_t next);
+static bool shift_held(void);
+static void sel_add(doc_id_t node);
+static void sel_primary(doc_id_t node);
+static bool sel_clear_cb(doc_id_t id, void * user_data);
+static void area_sel_cb(lv_obj_t * child, void * user_data);
 
 
 lv_obj_t * tbox_create(lv_obj_t * par, char * title)
@@ -55,148 +111,571 @@ lv_obj_t * tbox_get_ta(lv_obj_t * tbox)
     return ext->ta;
 }
 
-lv_obj_t * layerview_init(lv_obj_t * win)  //This is only a layer
+lv_obj_t * layerview_init(lv_obj_t * win)  //This is only a panel, the tree is in doctree
 {
-    lv_obj_t * layer_base = lv_cont_create(win, NULL);
-    lv_cont_set_fit4(layer_base, LV_FIT_FLOOD, LV_FIT_FLOOD, LV_FIT_TIGHT, LV_FIT_TIGHT);
-    lv_cont_set_layout(layer_base, LV_LAYOUT_PRETTY);
+    doc_init();
+    searchidx_init();
 
-    lv_obj_t * title = lv_label_create(layer_base, NULL);
+    lv_obj_t * title = lv_label_create(win, NULL);
     lv_label_set_text(title, "[Layer View]");
 
-    layerview_base = layer_base;
-    return layer_base;
+    //Shown when there are costs to sort by
+    layer_sort_btn = lv_btn_create(win, NULL);
+    lv_btn_set_toggle(layer_sort_btn, true);
+    lv_btn_set_state(layer_sort_btn, layer_sort_cost ? LV_BTN_STATE_TGL_REL : LV_BTN_STATE_REL);
+    lv_btn_set_fit(layer_sort_btn, LV_FIT_TIGHT);
+    lv_obj_set_event_cb(layer_sort_btn, sort_cb);
+    lv_label_set_text(lv_label_create(layer_sort_btn, NULL), "By cost");
+    lv_obj_set_hidden(layer_sort_btn, layer_cost_cb == NULL);
+
+    lv_obj_t * page = lv_page_create(win, NULL);
+    lv_obj_set_size(page, lv_win_get_width(win), LAYERVIEW_HEIGHT);
+    lv_page_set_scrl_fit(page, LV_FIT_NONE);
+    lv_page_set_scrl_layout(page, LV_LAYOUT_OFF);
+    lv_page_set_scrl_width(page, lv_page_get_fit_width(page));
+    lv_page_set_sb_mode(page, LV_SB_MODE_AUTO);
+
+    lv_obj_t * scrl = lv_page_get_scrl(page);
+    if(ancestor_scrl_signal == NULL) ancestor_scrl_signal = lv_obj_get_signal_cb(scrl);
+    lv_obj_set_signal_cb(scrl, layerview_scrl_signal);
+
+    layerview_base = page;
+    layer_row_cnt = 0;
+    if(layer_refr_task == NULL)
+    {
+        layer_refr_task = lv_task_create(layerview_refr_task, LAYERVIEW_REFR_PERIOD, LV_TASK_PRIO_MID, NULL);
+    }
+    layerview_refr_request();
+    return page;
     //todo:Del Button
 
 }
 
-//Create a newlayer by a obj on Simulator, use obj's TYPE && ID to set title
-lv_obj_t * layerview_add(lv_obj_t * par_layer, lv_obj_t * obj)   
+//Add obj to the document as the last child of `par`. The row appears with the next refresh.
+doc_id_t layerview_add(doc_id_t par, lv_obj_t * obj)
 {
-    if(par_layer == NULL)
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL)
     {
-        return NULL;
+        return DOC_NONE;
     }
-    lv_obj_t * layer = lv_cont_create(par_layer, NULL);
-    lv_cont_set_fit4(layer, LV_FIT_FLOOD, LV_FIT_FLOOD, LV_FIT_TIGHT, LV_FIT_TIGHT);
-    lv_cont_set_layout(layer, LV_LAYOUT_COL_L);
+    doc_id_t node = doc_add(par, obj);
+    if(node == DOC_NONE)
+    {
+        return DOC_NONE;
+    }
+    info->node = node;
 
-    layerview_ext_t * ext = lv_obj_allocate_ext_attr(layer, sizeof(layerview_ext_t));
+    autosave_mark(node);
+    layerview_refr_request();
+    return node;
+}
+
+lv_obj_t * layerview_get_base(void)
+{
+    return layerview_base;
+}
 
-    ext->bind = obj;
-    ext->title = lv_label_create(layer, NULL);
-    ext->child = NULL;
-    ext->left = NULL;
-    ext->right = NULL;
+lv_obj_t * layerview_get_sel_obj(void)
+{
+    doc_node_t * n = doc_get(sel_node);
+    return n ? n->obj : NULL;
+}
 
-    widget_info_t * info = lv_obj_get_user_data(obj);
-    // lv_obj_set_click(ext->title, true);
-    // lv_obj_set_user_data(ext->title, obj);     //Bind label with obj by user_data
-    
-    lv_label_set_text(ext->title, widget_get_type_name(info->type));
+doc_id_t layerview_get_sel_node(void)
+{
+    return sel_node;
+}
 
-    layerview_ext_t * par_ext = lv_obj_get_ext_attr(par_layer);
-    if(par_ext->child == NULL)
+void layerview_set_collapsed(doc_id_t node, bool collapsed)    //Hide or show the rows of the children
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || n->collapsed == collapsed)
     {
-        par_ext->child = layer;
-    }else
+        return;
+    }
+    n->collapsed = collapsed;
+    layerview_refr_request();
+}
+
+void layerview_del(doc_id_t node)   //Delete a node and its children && the bind objs
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || n->parent == DOC_ROOT)     //Now we can't delete the screen(TFT Simulator)
     {
-        layerview_add_bro(layer, par_ext->child);
-    }    
+        return;
+    }
 
+    undo_record_delete(node);
+    autosave_mark_deleted(node);
+    layerview_unload(node);
+}
 
-    lv_obj_set_event_cb(layer, update_sel_cb);
+//Remove a node and its widgets from the document without recording a deletion, e.g. a screen which is stored
+void layerview_unload(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || node == DOC_ROOT)
+    {
+        return;
+    }
 
-    return layer;
+    if(doc_is_descendant(sel_node, node))
+    {
+        sel_node = DOC_NONE;
+    }
+    if(sel_cnt > 0) doc_traverse(node, sel_clear_cb, NULL, NULL);
+    lv_obj_del(n->obj);     //The widgets of the children are its children
+    doc_remove(node);
+    layerview_refr_request();
 }
 
-lv_obj_t * layerview_get_base(void)
+//Move a node with its widget under `par`, before its child `next` (DOC_NONE: last). false if it can't go there.
+bool layerview_move(doc_id_t node, doc_id_t par, doc_id_t next)
 {
-    return layerview_base;
+    doc_node_t * n = doc_get(node);
+    doc_node_t * p = doc_get(par);
+    if(n == NULL || p == NULL || n->parent == DOC_ROOT || p->obj == NULL || doc_is_descendant(par, node))
+    {
+        return false;
+    }
+    if(n->parent == par && (n->next == next || node == next))
+    {
+        return true;
+    }
+
+    doc_id_t old_par = n->parent;
+    doc_id_t old_next = n->next;
+    if(!doc_move(node, par, next))
+    {
+        return false;
+    }
+    if(old_par != par)
+    {
+        lv_obj_set_parent(n->obj, p->obj);
+    }
+    obj_order(n->obj, next);
+
+    undo_record_reparent(node, old_par, old_next);
+    autosave_mark(node);
+    layerview_refr_request();
+    return true;
 }
 
-lv_obj_t * layerview_get_sel_obj(void)
+void layerview_del_sel(void)    //Delete the selected node & bind obj
+{
+    layerview_del(sel_node);
+}
+
+void layerview_set_sel(doc_id_t node)   //Select only this node and show its attributes
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL) return;
+    layerview_clear_sel();
+    sel_add(node);
+    sel_primary(node);
+}
+
+//Select a node as clicking its row or its widget does: only it, or with Shift added to (or removed from) the others
+void layerview_click_sel(doc_id_t node)
+{
+    if(shift_held()) layerview_toggle_sel(node);
+    else layerview_set_sel(node);
+}
+
+//Add a node to the selection as the primary one, or remove it if it's selected
+void layerview_toggle_sel(doc_id_t node)
 {
-    if (sel_layer)
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || node == DOC_ROOT) return;
+    if(!n->selected)
     {
-        layerview_ext_t * ext = lv_obj_get_ext_attr(sel_layer);
-        return ext->bind;        
+        sel_add(node);
+        sel_primary(node);
+        return;
     }
-    return NULL;
+
+    n->selected = 0;
+    sel_cnt--;
+    if(node == sel_node) sel_primary(DOC_NONE);
+    else layerview_refr_request();
 }
 
-lv_obj_t * layerview_get_sel_layer(void)
+//Add a node to the selection, it's the primary one only if nothing was selected
+void layerview_add_sel(doc_id_t node)
 {
-    return sel_layer;
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || node == DOC_ROOT) return;
+    sel_add(node);
+    if(sel_node == DOC_NONE) sel_primary(node);
+    else layerview_refr_request();
 }
 
+void layerview_clear_sel(void)
+{
+    doc_node_t * n = doc_get(sel_node);
+    if(sel_cnt == 1 && n != NULL && n->selected)       //Don't walk the document for the usual single selection
+    {
+        n->selected = 0;
+        sel_cnt = 0;
+    }else if(sel_cnt > 0)
+    {
+        doc_traverse(DOC_ROOT, sel_clear_cb, NULL, NULL);
+    }
+    sel_primary(DOC_NONE);
+}
 
-void layerview_add_bro(lv_obj_t * left_layer, lv_obj_t * layer)
+/**
+ * Select the widgets of the open screen which are completely in an area, as a rubber band does.
+ * Replaces the selection, or with Shift adds to it. Uses the hit index of the screen if it has a lot of widgets.
+ * If nothing is selected, the screen is.
+ * @param area absolute coordinates
+ */
+void layerview_area_sel(const lv_area_t * area)
 {
-    layerview_ext_t * left_ext = lv_obj_get_ext_attr(left_layer);
-    if(left_ext->right == NULL)
+    doc_id_t scr = doc_get_screen();
+    doc_node_t * scr_n = doc_get(scr);
+    if(scr_n == NULL) return;
+    if(!shift_held()) layerview_clear_sel();
+
+    if(scr_n->first_child != DOC_NONE)
     {
-        layerview_ext_t * ext = lv_obj_get_ext_attr(layer);
-        ext->left = left_layer;
-        left_ext->right = layer;
-    }else
+        lv_obj_t * holder = lv_obj_get_parent(doc_get(scr_n->first_child)->obj);    //E.g. the scrollable of the window
+        if(!lv_hit_get_in_area(holder, area, area_sel_cb, NULL))
+        {
+            lv_hit_build(holder);           //Only if it has enough children for an index
+            if(!lv_hit_get_in_area(holder, area, area_sel_cb, NULL))
+            {
+                doc_id_t id;
+                for(id = scr_n->first_child; id != DOC_NONE; id = doc_get(id)->next)
+                {
+                    lv_area_t a;
+                    lv_hit_get_click_area(doc_get(id)->obj, &a);
+                    if(lv_area_is_in(&a, area)) area_sel_cb(doc_get(id)->obj, NULL);
+                }
+            }
+        }
+    }
+
+    if(sel_cnt == 0) layerview_set_sel(scr);
+    layerview_refr_request();
+}
+
+bool layerview_is_sel(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    return n != NULL && n->selected;
+}
+
+uint32_t layerview_get_sel_cnt(void)
+{
+    return sel_cnt;
+}
+
+void layerview_refr_request(void)  //Something shown in the rows changed, e.g. an ID
+{
+    layer_refr_req = true;
+    if(layer_refr_task != NULL) lv_task_resume(layer_refr_task);     //It's paused while there is nothing to do
+}
+
+void layerview_set_note_cb(layerview_note_cb_t cb)     //Call `layerview_refr_request` when the notes change
+{
+    layer_note_cb = cb;
+    layerview_refr_request();
+}
+
+void layerview_set_cost_cb(layerview_cost_cb_t cb)     //Call `layerview_refr_request` when the costs change
+{
+    layer_cost_cb = cb;
+    if(layer_sort_btn != NULL) lv_obj_set_hidden(layer_sort_btn, cb == NULL);
+    layerview_refr_request();
+}
+
+void layerview_set_sort_cost(bool en)      //List the open screen's widgets by their cost, the costliest first
+{
+    layer_sort_cost = en;
+    if(layer_sort_btn != NULL) lv_btn_set_state(layer_sort_btn, en ? LV_BTN_STATE_TGL_REL : LV_BTN_STATE_REL);
+    layerview_refr_request();
+}
+
+static void update_sel_cb(lv_obj_t * row, lv_event_t ev)
+{
+    if(ev == LV_EVENT_CLICKED)
     {
-        layerview_add_bro(left_ext->right, layer);
+        layerview_ext_t * ext = lv_obj_get_ext_attr(row);
+        layerview_click_sel(ext->node);
     }
-    
+
 }
 
-void layerview_del(lv_obj_t * layer)   //Delete a layer and its child && move its brother layer
+static void toggle_cb(lv_obj_t * arrow, lv_event_t ev)
 {
-    if(layer == NULL)
+    if(ev == LV_EVENT_CLICKED)
     {
-        return;
+        layerview_ext_t * ext = lv_obj_get_ext_attr(lv_obj_get_parent(arrow));
+        doc_node_t * n = doc_get(ext->node);
+        if(n == NULL) return;
+        layerview_set_collapsed(ext->node, !n->collapsed);
     }
-    lv_obj_t * par_layer = lv_obj_get_parent(layer);
+}
+
+static lv_res_t layerview_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void * param)
+{
+    lv_res_t res = ancestor_scrl_signal(scrl, sign, param);
+    if(res != LV_RES_OK) return res;
 
-    if(par_layer == layerview_base)     //Now we can't delete the screen(TFT Simulator)
+    if(sign == LV_SIGNAL_CORD_CHG)      //Scrolled (or resized), other rows became visible
     {
-        return;
+        layerview_refr_request();
     }
+    return res;
+}
 
-    layerview_ext_t * par_ext = lv_obj_get_ext_attr(par_layer);
-    layerview_ext_t * ext = lv_obj_get_ext_attr(layer);
-    if(layer == par_ext->child)
+static void layerview_refr_task(lv_task_t * task)
+{
+    if(layer_refr_req)
     {
-        par_ext->child = ext->right;
-        
-        if(ext->right != NULL)
-        {
-            layerview_ext_t * right_ext = lv_obj_get_ext_attr(ext->right);
-            right_ext->left = NULL;            
-        }
+        layer_refr_req = false;
+        layerview_refr();
+    }
+    //Don't wake up the task handler until the next request
+    if(layer_refr_req == false) lv_task_pause(task);
+}
+
+//Bind the row objects to the visible nodes. Costs O(nodes) plain array reads and O(rows) object updates.
+static void layerview_refr(void)
+{
+    if(layerview_base == NULL) return;
+
+    lv_obj_t * scrl = lv_page_get_scrl(layerview_base);
+    lv_coord_t ofs = -lv_obj_get_y(scrl);
+    if(ofs < 0) ofs = 0;
+
+    uint32_t need = lv_obj_get_height(layerview_base) / LAYERVIEW_ROW_HEIGHT + 2;
+    if(need > LAYERVIEW_ROW_MAX) need = LAYERVIEW_ROW_MAX;
+    while(layer_row_cnt < need)
+    {
+        lv_obj_t * row = layer_row_create();
+        if(row == NULL) break;
+        layer_rows[layer_row_cnt++] = row;
+    }
+
+    layer_refr_t r;
+    r.row = 0;
+    r.first = ofs / LAYERVIEW_ROW_HEIGHT;
+    r.used = 0;
+    r.depth = 0;        //Only the open screen is shown, on level 0
+    if(layer_sort_cost && layer_cost_cb != NULL) sorted_refr(&r);
+    else doc_traverse(doc_get_screen(), refr_enter_cb, refr_leave_cb, &r);
+
+    uint32_t i;
+    for(i = r.used; i < layer_row_cnt; i++)
+    {
+        layerview_ext_t * ext = lv_obj_get_ext_attr(layer_rows[i]);
+        ext->node = DOC_NONE;
+        lv_obj_set_hidden(layer_rows[i], true);
+    }
+
+    //A lower scrollable would make the page scroll back and signal again, so keep it at least as high as the page
+    lv_coord_t h = r.row * LAYERVIEW_ROW_HEIGHT;
+    if(h < lv_page_get_fit_height(layerview_base)) h = lv_page_get_fit_height(layerview_base);
+    lv_page_set_scrl_height(layerview_base, h);
+
+    lv_coord_t new_ofs = -lv_obj_get_y(scrl);     //Our own changes need an other refresh only if the page scrolled back
+    if(new_ofs < 0) new_ofs = 0;
+    layer_refr_req = new_ofs != ofs;
+}
+
+static bool refr_enter_cb(doc_id_t id, void * user_data)
+{
+    layer_refr_t * r = user_data;
+    if(id == DOC_ROOT)
+    {
+        r->depth++;
+        return true;
+    }
+
+    doc_node_t * n = doc_get(id);
+    if(r->row >= r->first && r->used < layer_row_cnt) row_bind(layer_rows[r->used++], id, r->row, r->depth, true);
+    r->row++;
+    r->depth++;
+
+    return !n->collapsed;
+}
+
+static bool refr_leave_cb(doc_id_t id, void * user_data)
+{
+    (void)id;
+    layer_refr_t * r = user_data;
+    r->depth--;
+    return true;
+}
+
+//Show a node on a row object. `row_i`: the index of the row in the list, `arrow`: with the collapse arrow.
+static void row_bind(lv_obj_t * row, doc_id_t id, uint32_t row_i, int32_t depth, bool arrow)
+{
+    doc_node_t * n = doc_get(id);
+    layerview_ext_t * ext = lv_obj_get_ext_attr(row);
+    ext->node = id;
+
+    const char * arrow_txt = "";
+    if(arrow && n->first_child != DOC_NONE) arrow_txt = n->collapsed ? LV_SYMBOL_RIGHT : LV_SYMBOL_DOWN;
+    lv_label_set_static_text(ext->arrow, arrow_txt);
+    widget_info_t * info = widget_get_info(n->obj);
+    const char * note = layer_note_cb != NULL ? layer_note_cb(id) : NULL;
+    if(note == NULL) lv_label_set_text(ext->title, info->id);
+    else
+    {
+        char title[64];
+        snprintf(title, sizeof(title), "%s  " LV_SYMBOL_WARNING " %s", info->id, note);
+        lv_label_set_text(ext->title, title);
+    }
+
+    char badge[32];
+    if(layer_cost_cb != NULL && layer_cost_cb(id, badge, sizeof(badge)) >= 0)
+    {
+        lv_label_set_text(ext->badge, badge);
+        lv_obj_align(ext->badge, NULL, LV_ALIGN_IN_RIGHT_MID, -LAYERVIEW_INDENT / 2, 0);
+        lv_obj_set_hidden(ext->badge, false);
     }else
     {
-        layerview_ext_t * left_ext = lv_obj_get_ext_attr(ext->left);
-        left_ext->right = ext->right;
-        if(ext->right != NULL)
-        {
-            layerview_ext_t * right_ext = lv_obj_get_ext_attr(ext->right);
-            right_ext->left = ext->left;
-        }
+        lv_obj_set_hidden(ext->badge, true);
     }
-    lv_obj_del(ext->bind);
-    lv_obj_del(layer);
+
+    lv_obj_set_x(ext->arrow, depth * LAYERVIEW_INDENT);
+    lv_obj_set_x(ext->title, depth * LAYERVIEW_INDENT + LAYERVIEW_INDENT);
+    lv_obj_set_y(row, row_i * LAYERVIEW_ROW_HEIGHT);
+    const lv_style_t * style = &lv_style_transp_fit;
+    if(id == sel_node) style = &lv_style_plain_color;
+    else if(n->selected) style = &lv_style_pretty_color;
+    lv_cont_set_style(row, LV_CONT_STYLE_MAIN, style);
+    lv_obj_set_hidden(row, false);
 }
 
-void layerview_del_sel(void)    //Delete the selected layer & bind obj
+//Bind the rows to the widgets of the open screen sorted by their cost. Costs O(nodes log nodes).
+static void sorted_refr(layer_refr_t * r)
 {
-    layerview_del(sel_layer);
-    sel_layer = NULL;
+    layer_sorted_cnt = 0;
+    doc_traverse(doc_get_screen(), sorted_add_cb, NULL, NULL);
+    qsort(layer_sorted, layer_sorted_cnt, sizeof(layer_cost_t), cost_cmp);
+
+    uint32_t i;
+    for(i = r->first; i < layer_sorted_cnt && r->used < layer_row_cnt; i++)
+    {
+        row_bind(layer_rows[r->used++], layer_sorted[i].node, i, 0, false);
+    }
+    r->row = layer_sorted_cnt;
 }
 
-static void update_sel_cb(lv_obj_t * layer, lv_event_t ev)
+static bool sorted_add_cb(doc_id_t id, void * user_data)
 {
-    if(ev == LV_EVENT_CLICKED)
+    (void)user_data;
+    if(layer_sorted_cnt >= layer_sorted_cap)
+    {
+        uint32_t cap = layer_sorted_cap > 0 ? layer_sorted_cap * 2 : DOC_INIT_CAPACITY;
+        layer_cost_t * sorted = realloc(layer_sorted, cap * sizeof(layer_cost_t));
+        if(sorted == NULL) return false;
+        layer_sorted = sorted;
+        layer_sorted_cap = cap;
+    }
+    layer_sorted[layer_sorted_cnt].node = id;
+    layer_sorted[layer_sorted_cnt].cost = layer_cost_cb(id, NULL, 0);
+    layer_sorted[layer_sorted_cnt].order = layer_sorted_cnt;
+    layer_sorted_cnt++;
+    return true;
+}
+
+//The costliest first, the unknown ones last, equal ones in the order of the tree
+static int cost_cmp(const void * a, const void * b)
+{
+    const layer_cost_t * ca = a;
+    const layer_cost_t * cb = b;
+    if(ca->cost != cb->cost) return (ca->cost < cb->cost) - (ca->cost > cb->cost);
+    return (ca->order > cb->order) - (ca->order < cb->order);
+}
+
+static void sort_cb(lv_obj_t * btn, lv_event_t ev)
+{
+    if(ev != LV_EVENT_VALUE_CHANGED) return;
+    lv_btn_state_t state = lv_btn_get_state(btn);
+    layerview_set_sort_cost(state == LV_BTN_STATE_TGL_REL || state == LV_BTN_STATE_TGL_PR);
+}
+
+//The widgets are drawn in the order of their nodes, so the last child is on the top
+static void obj_order(lv_obj_t * obj, doc_id_t next)
+{
+    doc_node_t * next_n = next != DOC_NONE ? doc_get(next) : NULL;     //DOC_NONE is the root's ID too
+    if(next_n == NULL)
     {
-        sel_layer = layer;
-        layerview_ext_t * ext = lv_obj_get_ext_attr(layer);
-        lb_selected_mod(ext->bind);
+        lv_obj_move_foreground(obj);
+        return;
     }
 
-}
\ No newline at end of file
+    lv_obj_move_below(obj, next_n->obj);
+}
+
+static bool shift_held(void)
+{
+    return (SDL_GetModState() & KMOD_SHIFT) != 0;
+}
+
+static void sel_add(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || n->selected) return;
+    n->selected = 1;
+    sel_cnt++;
+}
+
+static void sel_primary(doc_id_t node)
+{
+    sel_node = node;
+    propbind_watch(node);
+    layerview_refr_request();
+}
+
+static bool sel_clear_cb(doc_id_t id, void * user_data)
+{
+    (void)user_data;
+    doc_node_t * n = doc_get(id);
+    if(n->selected)
+    {
+        n->selected = 0;
+        sel_cnt--;
+    }
+    return sel_cnt > 0;     //Nothing more to clear below
+}
+
+static void area_sel_cb(lv_obj_t * child, void * user_data)
+{
+    (void)user_data;
+    widget_info_t * info = widget_get_info(child);
+    if(info == NULL) return;
+    sel_add(info->node);
+    if(sel_node == DOC_NONE) sel_primary(info->node);
+}
+
+static lv_obj_t * layer_row_create(void)
+{
+    lv_obj_t * row = lv_cont_create(layerview_base, NULL);     //Goes to the scrollable of the page
+    if(row == NULL) return NULL;
+    lv_cont_set_layout(row, LV_LAYOUT_OFF);
+    lv_obj_set_size(row, lv_page_get_fit_width(layerview_base), LAYERVIEW_ROW_HEIGHT);
+    lv_page_glue_obj(row, true);
+
+    layerview_ext_t * ext = lv_obj_allocate_ext_attr(row, sizeof(layerview_ext_t));
+    ext->node = DOC_NONE;
+    ext->arrow = lv_label_create(row, NULL);
+    lv_obj_set_click(ext->arrow, true);
+    lv_page_glue_obj(ext->arrow, true);
+    lv_obj_set_event_cb(ext->arrow, toggle_cb);
+    lv_obj_align(ext->arrow, NULL, LV_ALIGN_IN_LEFT_MID, 0, 0);
+    ext->title = lv_label_create(row, NULL);
+    lv_obj_align(ext->title, NULL, LV_ALIGN_IN_LEFT_MID, LAYERVIEW_INDENT, 0);
+    ext->badge = lv_label_create(row, NULL);
+    lv_obj_set_hidden(ext->badge, true);
+
+    lv_obj_set_event_cb(row, update_sel_cb);
+    lv_obj_set_hidden(row, true);
+    return row;
+}
@@ -22,11 +22,18 @@ extern "C" {
 #include "./lv_ex_conf.h"
 #endif
 
+#include "doctree.h"
+
 
 
 /*********************
  *      DEFINES
  *********************/
+#define LAYERVIEW_HEIGHT        (LV_DPI * 2)
+#define LAYERVIEW_ROW_HEIGHT    (LV_DPI / 4)
+#define LAYERVIEW_INDENT        (LV_DPI / 6)
+#define LAYERVIEW_ROW_MAX       64      //Row objects to recycle, more are never visible at once
+#define LAYERVIEW_REFR_PERIOD   30      //[ms] between checks for a needed refresh
 
 /**********************
  *      TYPEDEFS
@@ -34,12 +41,18 @@ extern "C" {
 typedef struct 
 {
     lv_cont_ext_t cont;
+    lv_obj_t * arrow;       //Collapse/expand
     lv_obj_t * title;
-    lv_obj_t * bind;
-    lv_obj_t * left, * right;     //Brother LayerView
-    lv_obj_t * child;       //Child LayerView
+    lv_obj_t * badge;       //The cost of the node, on the right
+    doc_id_t node;          //The node shown by this row now, DOC_NONE: unused row
 }layerview_ext_t;
 
+//A short note shown after the ID of a node in the Layer View (e.g. a warning), NULL: none
+typedef const char * (*layerview_note_cb_t)(doc_id_t node);
+
+//The cost of a node (e.g. its draw time) to sort by, and its text in `badge` if not NULL. < 0: unknown
+typedef double (*layerview_cost_cb_t)(doc_id_t node, char * badge, uint32_t badge_size);
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -49,12 +62,27 @@ lv_obj_t * tbox_create(lv_obj_t * par, char * title);
 lv_obj_t * tbox_get_ta(lv_obj_t * tbox);
 
 lv_obj_t * layerview_init(lv_obj_t * win);
-lv_obj_t * layerview_add(lv_obj_t * par, lv_obj_t * obj);
-void layerview_add_bro(lv_obj_t * left_layer, lv_obj_t * layer);
+doc_id_t layerview_add(doc_id_t par, lv_obj_t * obj);
 lv_obj_t * layerview_get_sel_obj(void);
-lv_obj_t * layerview_get_sel_layer(void);
+doc_id_t layerview_get_sel_node(void);
+void layerview_set_sel(doc_id_t node);
+void layerview_click_sel(doc_id_t node);
+void layerview_toggle_sel(doc_id_t node);
+void layerview_add_sel(doc_id_t node);
+void layerview_clear_sel(void);
+void layerview_area_sel(const lv_area_t * area);
+bool layerview_is_sel(doc_id_t node);
+uint32_t layerview_get_sel_cnt(void);
+void layerview_set_collapsed(doc_id_t node, bool collapsed);
+void layerview_del(doc_id_t node);
+void layerview_unload(doc_id_t node);
+bool layerview_move(doc_id_t node, doc_id_t par, doc_id_t next);
 void layerview_del_sel(void);
+void layerview_refr_request(void);
 lv_obj_t * layerview_get_base(void);
+void layerview_set_note_cb(layerview_note_cb_t cb);
+void layerview_set_cost_cb(layerview_cost_cb_t cb);
+void layerview_set_sort_cost(bool en);
 /**********************
  *      MACROS
  **********************/
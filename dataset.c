@@ -6,12 +6,19 @@
 /*********************
  *      INCLUDES
  *********************/
-#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
 #include "dataset.h"
+#include "widgetid.h"
+#include "stylepool.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define INFO_INDEX_BITS     20
+#define INFO_INDEX_MASK     ((1u << INFO_INDEX_BITS) - 1)
+#define INFO_GEN_MASK       ((1u << (32 - INFO_INDEX_BITS)) - 1)
+#define INFO_INDEX_NONE     INFO_INDEX_MASK
 
 
 /**********************
@@ -28,7 +35,7 @@ typedef struct _widget_deque_t_
     struct _widget_deque_t_ * next, * prev;
 }widget_deque_t;
 
-const char * widget_type_name[10] =     //This array binds with WIDGET_TYPE_X
+const char * widget_type_name[WIDGET_TYPE_NUM] =     //This array binds with WIDGET_TYPE_X
 {
     "obj",
     "label",
@@ -37,10 +44,24 @@ const char * widget_type_name[10] =     //This array binds with WIDGET_TYPE_X
     "ddlist",
     "bar",
     "led",
-    "guage",
-    "slider"
+    "gauge",
+    "slider",
+    "roller",
+    "arc",
+    "cont",
+    "img"
 };
 
+typedef struct
+{
+    widget_info_t info;         //Keep it first, the slot is found from the info
+    lv_obj_t * obj;             //The owner, a copied user_data isn't a valid handle
+    lv_signal_cb_t ancestor_signal;
+    uint32_t next_free;
+    uint16_t gen;               //Incremented on every free, so stale handles don't match
+    uint8_t used;
+}widget_info_slot_t;
+
 typedef struct _widget_tree_node_t_
 {
     lv_obj_t * widget;
@@ -53,6 +74,9 @@ typedef struct _widget_tree_node_t_
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static widget_info_slot_t * info_slot_get(uint32_t index);
+static widget_info_slot_t * info_slot_alloc(uint32_t * index);
+static lv_res_t widget_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
 
 
 /**********************
@@ -62,6 +86,11 @@ typedef struct _widget_tree_node_t_
 // static widget_deque_t * wdeque_head = NULL;
 // static widget_deque_t * wdeque_tail = NULL;
 // static widget_deque_t * wdeque_traverse_sign = NULL;
+static widget_info_slot_t ** info_slabs = NULL;     //Slabs are never moved, so info pointers stay valid
+static uint32_t info_slab_cnt = 0;
+static uint32_t info_end = 0;                       //Slots above it were never used
+static uint32_t info_free = INFO_INDEX_NONE;
+static uint32_t info_cnt = 0;
 /**********************
  *      MACROS
  **********************/
@@ -161,18 +190,127 @@ const char * widget_get_type_name(widget_type_t type)
     return widget_type_name[type];
 }
 
-void widget_set_info(lv_obj_t * obj, widget_type_t t)
+//The info is freed automatically when the widget is deleted
+widget_handle_t widget_set_info(lv_obj_t * obj, widget_type_t t)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL)
+    {
+        uint32_t index;
+        widget_info_slot_t * slot = info_slot_alloc(&index);
+        if(slot == NULL)
+        {
+            lv_obj_set_user_data(obj, NULL);
+            return WIDGET_HANDLE_NONE;
+        }
+        slot->obj = obj;
+        slot->info.id[0] = '\0';
+        slot->ancestor_signal = lv_obj_get_signal_cb(obj);
+        lv_obj_set_signal_cb(obj, widget_signal);
+        lv_obj_set_user_data(obj, (void *)(uintptr_t)(((uint32_t)slot->gen << INFO_INDEX_BITS) | index));
+        info = &slot->info;
+        info->type = t;
+        info->node = DOC_NONE;
+        memset(&info->attr, 0, sizeof(info->attr));
+        widgetid_assign(obj);
+        stylepool_retain(obj->style_p);     //A copied widget shares the style of the original
+        return widget_get_handle(obj);
+    }
+
+    info->type = t;     //A new type keeps the ID
+    info->node = DOC_NONE;
+    memset(&info->attr, 0, sizeof(info->attr));
+    return widget_get_handle(obj);
+}
+
+widget_handle_t widget_get_handle(const lv_obj_t * obj)
 {
-    widget_info_t * info = (widget_info_t *)malloc(sizeof(widget_info_t));
-    info->type = t;
-    strncpy(info->id, widget_get_type_name(t), 15);
-    lv_obj_set_user_data(obj, info);
+    widget_handle_t h = (widget_handle_t)(uintptr_t)lv_obj_get_user_data((lv_obj_t *)obj);
+    widget_info_slot_t * slot = info_slot_get(h & INFO_INDEX_MASK);
+    if(slot == NULL || !slot->used || slot->gen != (h >> INFO_INDEX_BITS) || slot->obj != obj) return WIDGET_HANDLE_NONE;
+    return h;
 }
 
+//O(1), NULL if the handle is stale
+widget_info_t * widget_info_from_handle(widget_handle_t h)
+{
+    widget_info_slot_t * slot = info_slot_get(h & INFO_INDEX_MASK);
+    if(slot == NULL || !slot->used || slot->gen != (h >> INFO_INDEX_BITS)) return NULL;
+    return &slot->info;
+}
 
+widget_info_t * widget_get_info(const lv_obj_t * obj)
+{
+    if(obj == NULL) return NULL;
+    return widget_info_from_handle(widget_get_handle(obj));
+}
+
+uint32_t widget_info_get_count(void)
+{
+    return info_cnt;
+}
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+static widget_info_slot_t * info_slot_get(uint32_t index)
+{
+    if(index >= info_end) return NULL;
+    return &info_slabs[index / WIDGET_INFO_SLAB_SIZE][index % WIDGET_INFO_SLAB_SIZE];
+}
+
+static widget_info_slot_t * info_slot_alloc(uint32_t * index)
+{
+    widget_info_slot_t * slot;
+    if(info_free != INFO_INDEX_NONE)
+    {
+        *index = info_free;
+        slot = info_slot_get(info_free);
+        info_free = slot->next_free;
+    }else
+    {
+        if(info_end == INFO_INDEX_NONE) return NULL;
+        if(info_end == info_slab_cnt * WIDGET_INFO_SLAB_SIZE)
+        {
+            widget_info_slot_t ** new_slabs = realloc(info_slabs, (info_slab_cnt + 1) * sizeof(widget_info_slot_t *));
+            if(new_slabs == NULL) return NULL;
+            info_slabs = new_slabs;
+            info_slabs[info_slab_cnt] = calloc(WIDGET_INFO_SLAB_SIZE, sizeof(widget_info_slot_t));
+            if(info_slabs[info_slab_cnt] == NULL) return NULL;
+            info_slab_cnt++;
+        }
+        *index = info_end++;
+        slot = info_slot_get(*index);
+        slot->gen = 1;
+    }
+
+    slot->used = 1;
+    info_cnt++;
+    return slot;
+}
+
+static lv_res_t widget_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
+{
+    widget_handle_t h = widget_get_handle(obj);
+    widget_info_slot_t * slot = info_slot_get(h & INFO_INDEX_MASK);
+    if(h == WIDGET_HANDLE_NONE || slot == NULL) return LV_RES_INV;     //Can't happen, the signal cb is set with the info
+
+    lv_res_t res = slot->ancestor_signal(obj, sign, param);
+    if(sign == LV_SIGNAL_CLEANUP)       //lv_obj_del() sends it to the children too
+    {
+        widgetid_remove(obj);
+        stylepool_release(obj->style_p);
+        uint32_t index = h & INFO_INDEX_MASK;
+        slot->used = 0;
+        slot->obj = NULL;
+        slot->gen = (slot->gen + 1) & INFO_GEN_MASK;
+        if(slot->gen == 0) slot->gen = 1;       //0 would make the handle of slot 0 WIDGET_HANDLE_NONE
+        slot->next_free = info_free;
+        info_free = index;
+        info_cnt--;
+        lv_obj_set_user_data(obj, NULL);
+    }
+    return res;
+}
 
 
@@ -24,10 +24,13 @@ extern "C" {
 
 // #if USE_LV_
 #include <stdbool.h>
+#include "doctree.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define WIDGET_INFO_SLAB_SIZE   256     //widget_info_t-s allocated together
+#define WIDGET_HANDLE_NONE      0
 
 /**********************
  *      TYPEDEFS
@@ -43,6 +46,11 @@ typedef enum
     WIDGET_TYPE_LED      = 6,
     WIDGET_TYPE_GAUGE    = 7,
     WIDGET_TYPE_SLIDER   = 8,
+    WIDGET_TYPE_ROLLER   = 9,
+    WIDGET_TYPE_ARC      = 10,
+    WIDGET_TYPE_CONT     = 11,
+    WIDGET_TYPE_IMG      = 12,     //Only the generated code has it, a baked subtree
+    WIDGET_TYPE_NUM,                //Number of widget types, keep it last
 }widget_type_t;
 
 typedef struct
@@ -58,13 +66,15 @@ typedef struct _widget_info_t_
 {
     char id[16];
     widget_type_t type;
-    // lv_obj_t * layer;
+    doc_id_t node;              //Its node in the document, DOC_NONE until it's added
     // lv_obj_t * align_to;
     // lv_align_t alian_type;
     obj_attr_table_t attr;
 
 }widget_info_t;
 
+typedef uint32_t widget_handle_t;       //Slot index and generation of a widget_info_t
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -77,7 +87,11 @@ typedef struct _widget_info_t_
 // lv_obj_t * wdeque_traverse(bool reset);
 
 const char * widget_get_type_name(widget_type_t type);
-void widget_set_info(lv_obj_t * obj, widget_type_t t);
+widget_handle_t widget_set_info(lv_obj_t * obj, widget_type_t t);
+widget_handle_t widget_get_handle(const lv_obj_t * obj);
+widget_info_t * widget_info_from_handle(widget_handle_t h);
+widget_info_t * widget_get_info(const lv_obj_t * obj);
+uint32_t widget_info_get_count(void);
 /**********************
  *      MACROS
  **********************/
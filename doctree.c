@@ -0,0 +1,300 @@
+/**
+ * @doctree .c
+ * The designer's document: every widget of the project is a node of one contiguous array.
+ * Nodes are linked by indices (first/last child, next/prev sibling), so appending and unlinking
+ * are O(1) and the traversals are iterative. The Layer View only displays this tree.
+ * Every node keeps a Merkle hash of its subtree: a change clears the hashes of the node and its ancestors,
+ * and only those are computed again, so equal subtrees of two versions are found without visiting them.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HASH_INIT       0xcbf29ce484222325ULL      //FNV-1a, 64 bit
+#define HASH_PRIME      0x100000001b3ULL
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void node_unlink(doc_id_t id);
+static bool node_free_cb(doc_id_t id, void * user_data);
+static bool hash_enter_cb(doc_id_t id, void * user_data);
+static bool hash_leave_cb(doc_id_t id, void * user_data);
+static uint64_t hash_mix(uint64_t h, uint64_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static doc_node_t * nodes = NULL;
+static uint32_t node_cap = 0;
+static uint32_t node_end = 0;           //Nodes above it were never used
+static uint32_t node_cnt = 0;           //Used nodes without the root
+static doc_id_t free_head = DOC_NONE;
+static uint32_t uid_cnt = 0;
+static doc_watch_cb_t watch_add_cb = NULL;
+static doc_watch_cb_t watch_remove_cb = NULL;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void doc_init(void)
+{
+    if(nodes != NULL) return;
+
+    nodes = calloc(DOC_INIT_CAPACITY, sizeof(doc_node_t));
+    if(nodes == NULL) return;
+    node_cap = DOC_INIT_CAPACITY;
+    nodes[DOC_ROOT].used = 1;
+    node_end = 1;
+}
+
+//Append a node as the last child of `parent`. Returns DOC_NONE if out of memory.
+doc_id_t doc_add(doc_id_t parent, lv_obj_t * obj)
+{
+    if(nodes == NULL) doc_init();
+    if(nodes == NULL || parent >= node_end || !nodes[parent].used) return DOC_NONE;
+
+    doc_id_t id;
+    if(free_head != DOC_NONE)
+    {
+        id = free_head;
+        free_head = nodes[id].next;
+    }else
+    {
+        if(node_end == node_cap)
+        {
+            doc_node_t * new_nodes = realloc(nodes, node_cap * 2 * sizeof(doc_node_t));
+            if(new_nodes == NULL) return DOC_NONE;
+            nodes = new_nodes;
+            node_cap *= 2;
+        }
+        id = node_end++;
+    }
+
+    doc_node_t * n = &nodes[id];
+    memset(n, 0, sizeof(doc_node_t));
+    n->obj = obj;
+    n->parent = parent;
+    n->uid = ++uid_cnt;
+    n->used = 1;
+
+    doc_node_t * par = &nodes[parent];
+    n->prev = par->last_child;
+    if(par->last_child != DOC_NONE) nodes[par->last_child].next = id;
+    else par->first_child = id;
+    par->last_child = id;
+
+    node_cnt++;
+    doc_hash_invalidate(parent);
+    if(watch_add_cb) watch_add_cb(id);
+    return id;
+}
+
+//Unlink a node and free it with all of its descendants. It doesn't touch the widgets.
+void doc_remove(doc_id_t id)
+{
+    if(id == DOC_ROOT || id >= node_end || !nodes[id].used) return;
+
+    doc_hash_invalidate(nodes[id].parent);
+    node_unlink(id);
+    doc_traverse(id, NULL, node_free_cb, NULL);
+}
+
+/**
+ * Move a node with its descendants under `parent`, before its child `next`. O(1), the subtree isn't visited.
+ * @param next a child of `parent`, DOC_NONE: make it the last child
+ * @return false if a node is invalid or `parent` is in the moved subtree
+ */
+bool doc_move(doc_id_t id, doc_id_t parent, doc_id_t next)
+{
+    if(id == DOC_ROOT || doc_get(id) == NULL || doc_get(parent) == NULL || doc_is_descendant(parent, id)) return false;
+    if(next == id) return true;
+    if(next != DOC_NONE && (doc_get(next) == NULL || nodes[next].parent != parent)) return false;
+
+    doc_hash_invalidate(nodes[id].parent);
+    doc_hash_invalidate(parent);
+    node_unlink(id);
+    doc_node_t * n = &nodes[id];
+    doc_node_t * par = &nodes[parent];
+    n->parent = parent;
+    n->next = next;
+    n->prev = next != DOC_NONE ? nodes[next].prev : par->last_child;
+    if(n->prev != DOC_NONE) nodes[n->prev].next = id;
+    else par->first_child = id;
+    if(next != DOC_NONE) nodes[next].prev = id;
+    else par->last_child = id;
+    return true;
+}
+
+//The pointer is valid only until the next doc_add()
+doc_node_t * doc_get(doc_id_t id)
+{
+    if(nodes == NULL || id >= node_end || !nodes[id].used) return NULL;
+    return &nodes[id];
+}
+
+doc_id_t doc_get_screen(void)       //The first screen (TFT Simulator)
+{
+    if(nodes == NULL) return DOC_NONE;
+    return nodes[DOC_ROOT].first_child;
+}
+
+uint32_t doc_get_count(void)
+{
+    return node_cnt;
+}
+
+bool doc_is_descendant(doc_id_t id, doc_id_t ancestor)     //A node is its own descendant too
+{
+    if(nodes == NULL || id >= node_end) return false;
+    while(id != DOC_ROOT)
+    {
+        if(id == ancestor) return true;
+        id = nodes[id].parent;
+    }
+    return ancestor == DOC_ROOT;
+}
+
+/**
+ * Visit a subtree in preorder without recursion. `leave_cb` is called after the children.
+ * The node's links are read before `leave_cb`, so it may free the node, but it mustn't add nodes.
+ * @return number of visited nodes
+ */
+uint32_t doc_traverse(doc_id_t root, doc_visit_cb_t enter_cb, doc_visit_cb_t leave_cb, void * user_data)
+{
+    if(nodes == NULL || root >= node_end || !nodes[root].used) return 0;
+
+    uint32_t cnt = 0;
+    doc_id_t id = root;
+    while(1)
+    {
+        cnt++;
+        bool descend = enter_cb ? enter_cb(id, user_data) : true;
+        if(descend && nodes[id].first_child != DOC_NONE)
+        {
+            id = nodes[id].first_child;
+            continue;
+        }
+
+        while(1)    //Leave the node and the ancestors which have no more children to visit
+        {
+            doc_id_t next = nodes[id].next;
+            doc_id_t parent = nodes[id].parent;
+            bool is_root = id == root;
+            if(leave_cb) leave_cb(id, user_data);
+            if(is_root) return cnt;
+            if(next != DOC_NONE)
+            {
+                id = next;
+                break;
+            }
+            id = parent;
+        }
+    }
+}
+
+//The content of a node changed, its hash and the hashes of its ancestors have to be computed again
+void doc_hash_invalidate(doc_id_t id)
+{
+    if(nodes == NULL || id >= node_end) return;
+    while(nodes[id].hash_valid)     //The ancestors of a node with an invalid hash are invalid already
+    {
+        nodes[id].hash_valid = 0;
+        if(id == DOC_ROOT) break;
+        id = nodes[id].parent;
+    }
+}
+
+/**
+ * Get the hash of a subtree. Only the subtrees changed since their hashes were computed are visited.
+ * @param id the root of the subtree, DOC_ROOT: every screen
+ * @param own_cb hashes the content of a node. Has to be the same on every call.
+ * @return the hash, 0 if the node is invalid
+ */
+uint64_t doc_hash_get(doc_id_t id, doc_hash_cb_t own_cb)
+{
+    if(doc_get(id) == NULL) return 0;
+    if(!nodes[id].hash_valid) doc_traverse(id, hash_enter_cb, hash_leave_cb, &own_cb);
+    return nodes[id].hash;
+}
+
+//Get notified of the added and the freed nodes, e.g. to index them. One watcher, NULL: none.
+void doc_set_watch_cb(doc_watch_cb_t add_cb, doc_watch_cb_t remove_cb)
+{
+    watch_add_cb = add_cb;
+    watch_remove_cb = remove_cb;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void node_unlink(doc_id_t id)
+{
+    doc_node_t * n = &nodes[id];
+    doc_node_t * par = &nodes[n->parent];
+    if(n->prev != DOC_NONE) nodes[n->prev].next = n->next;
+    else par->first_child = n->next;
+    if(n->next != DOC_NONE) nodes[n->next].prev = n->prev;
+    else par->last_child = n->prev;
+}
+
+static bool node_free_cb(doc_id_t id, void * user_data)
+{
+    (void)user_data;
+    if(watch_remove_cb) watch_remove_cb(id);
+    doc_node_t * n = &nodes[id];
+    n->used = 0;
+    n->obj = NULL;
+    n->next = free_head;
+    free_head = id;
+    node_cnt--;
+    return true;
+}
+
+static bool hash_enter_cb(doc_id_t id, void * user_data)
+{
+    (void)user_data;
+    return !nodes[id].hash_valid;     //The valid ones keep their hash
+}
+
+//The children are left before their parent, so their hashes are valid here
+static bool hash_leave_cb(doc_id_t id, void * user_data)
+{
+    doc_hash_cb_t own_cb = *(doc_hash_cb_t *)user_data;
+    doc_node_t * n = &nodes[id];
+    if(n->hash_valid) return true;
+
+    uint64_t h = hash_mix(HASH_INIT, id != DOC_ROOT ? own_cb(id) : 0);
+    doc_id_t c;
+    for(c = n->first_child; c != DOC_NONE; c = nodes[c].next) h = hash_mix(h, nodes[c].hash);
+    n->hash = h;
+    n->hash_valid = 1;
+    return true;
+}
+
+static uint64_t hash_mix(uint64_t h, uint64_t v)
+{
+    uint8_t i;
+    for(i = 0; i < 8; i++)
+    {
+        h ^= (v >> (i * 8)) & 0xFF;
+        h *= HASH_PRIME;
+    }
+    return h;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file doctree.h
+ *
+ */
+
+#ifndef _DOCTREE_H_
+#define _DOCTREE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DOC_ROOT            0       //Invisible root, the screens are its children
+#define DOC_NONE            0       //No node. The root is never linked, so it can share the value
+#define DOC_INIT_CAPACITY   256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef uint32_t doc_id_t;
+
+typedef struct
+{
+    lv_obj_t * obj;             //The widget on the Simulator
+    doc_id_t parent;
+    doc_id_t first_child, last_child;
+    doc_id_t next, prev;        //Siblings. `next` links the free list of unused nodes
+    uint32_t uid;               //Unique for the session, never reused
+    uint64_t hash;              //Of the content of the subtree, see doc_hash_get()
+    uint8_t used : 1;
+    uint8_t dirty : 1;          //Changed since the last autosave
+    uint8_t collapsed : 1;      //The Layer View hides the children
+    uint8_t selected : 1;       //In the multi-selection of the Layer View
+    uint8_t hash_valid : 1;     //Nothing changed in the subtree since `hash` was computed
+}doc_node_t;
+
+/**
+ * Called on every node of a traversal
+ * @param id the node
+ * @param user_data from doc_traverse()
+ * @return false to skip the children (only checked by `enter_cb`)
+ */
+typedef bool (*doc_visit_cb_t)(doc_id_t id, void * user_data);
+
+/**
+ * Hash the content of a node itself, without its children
+ * @param id the node
+ * @return the hash
+ */
+typedef uint64_t (*doc_hash_cb_t)(doc_id_t id);
+
+/**
+ * Called on a node added to the document, or on a node about to be freed
+ * @param id the node
+ */
+typedef void (*doc_watch_cb_t)(doc_id_t id);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void doc_init(void);
+doc_id_t doc_add(doc_id_t parent, lv_obj_t * obj);
+void doc_remove(doc_id_t id);
+bool doc_move(doc_id_t id, doc_id_t parent, doc_id_t next);
+doc_node_t * doc_get(doc_id_t id);
+doc_id_t doc_get_screen(void);
+uint32_t doc_get_count(void);
+bool doc_is_descendant(doc_id_t id, doc_id_t ancestor);
+uint32_t doc_traverse(doc_id_t root, doc_visit_cb_t enter_cb, doc_visit_cb_t leave_cb, void * user_data);
+void doc_hash_invalidate(doc_id_t id);
+uint64_t doc_hash_get(doc_id_t id, doc_hash_cb_t own_cb);
+void doc_set_watch_cb(doc_watch_cb_t add_cb, doc_watch_cb_t remove_cb);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,209 @@
+/**
+ * @file drawcost.c
+ * Measure the drawing of every widget of the project while the designer runs.
+ * `lv_refr` reports every `design_cb` call (main and post) to `lv_prof` with its time and drawing operations,
+ * they are added to the widget of the called object (itself or the nearest ancestor in the project, e.g. of a page's
+ * scrollable). The sums of a refresh go into rolling averages, so a widget shows what a redraw of it costs lately.
+ * The Layer View shows them as badges on the rows and can list the widgets by their draw time.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "drawcost.h"
+#include "dataset.h"
+#include "custom_widget.h"
+#include "./lvgl/src/lv_misc/lv_thread.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t uid;               //Of the node the costs are of, a reused node starts again
+    uint32_t stamp;             //The refresh `cur_...` are of
+    uint32_t cur_us;
+    uint32_t cur_px;
+    uint32_t cur_calls;
+    drawcost_t avg;
+    uint8_t cur_any : 1;
+    uint8_t avg_valid : 1;
+}node_cost_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void design_measure(lv_obj_t * obj, uint32_t time, const uint32_t * draw);
+static uint32_t refr_stamp(void);
+static node_cost_t * cost_get(doc_id_t node, uint32_t uid);
+static void cost_fold(node_cost_t * c);
+static void badge_task(lv_task_t * task);
+static double badge_cb(doc_id_t node, char * badge, uint32_t badge_size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static node_cost_t * costs;         //By node ID, guarded by `lv_thread_lock`
+static uint32_t cost_cap;
+static bool changed;                //A widget was drawn since the last update of the badges
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Start measuring the widgets and show their costs in the Layer View. Call it after the GUI is created.
+void drawcost_init(void)
+{
+    lv_prof_set_en(true);
+    lv_prof_set_design_cb(design_measure);
+    lv_task_create(badge_task, DRAWCOST_PERIOD, LV_TASK_PRIO_LOW, NULL);
+    layerview_set_cost_cb(badge_cb);
+}
+
+//The costs of a widget. false: it wasn't drawn yet.
+bool drawcost_get(doc_id_t node, drawcost_t * cost)
+{
+    doc_node_t * n = doc_get(node);
+    if(n == NULL || !n->used) return false;
+
+    bool res = false;
+    lv_thread_lock();
+    if(node < cost_cap && costs[node].uid == n->uid)
+    {
+        node_cost_t * c = &costs[node];
+        if(c->cur_any && c->stamp != refr_stamp()) cost_fold(c);     //Its refresh is over
+        if(c->avg_valid)
+        {
+            *cost = c->avg;
+            res = true;
+        }
+    }
+    lv_thread_unlock();
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//`design_cb` of `lv_prof`, runs on the drawing threads
+static void design_measure(lv_obj_t * obj, uint32_t time, const uint32_t * draw)
+{
+    widget_info_t * info = NULL;
+    for(; obj != NULL; obj = lv_obj_get_parent(obj))
+    {
+        info = widget_get_info(obj);
+        if(info != NULL) break;
+    }
+    if(info == NULL || info->node == DOC_NONE) return;     //Not of the project, e.g. the Layer View
+    doc_node_t * n = doc_get(info->node);
+    if(n == NULL || !n->used) return;
+
+    //The letters are counted by their pixels, the decoded image pixels by their copies
+    uint32_t px = 0;
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++)
+    {
+        if(d != LV_PROF_DRAW_GLYPH && d != LV_PROF_DRAW_IMG_DECODE) px += draw[d];
+    }
+
+    uint32_t stamp = refr_stamp();
+    lv_thread_lock();
+    node_cost_t * c = cost_get(info->node, n->uid);
+    if(c != NULL)
+    {
+        if(c->cur_any && c->stamp != stamp) cost_fold(c);
+        c->stamp = stamp;
+        c->cur_us += time;
+        c->cur_px += px;
+        c->cur_calls++;
+        c->cur_any = 1;
+        changed = true;
+    }
+    lv_thread_unlock();
+}
+
+//Changes after every refresh: the start of the last one `lv_prof` stored
+static uint32_t refr_stamp(void)
+{
+    uint16_t cnt = lv_prof_get_frame_cnt();
+    return cnt > 0 ? lv_prof_get_frame(cnt - 1)->start : 0;
+}
+
+//The costs of a node, cleared if it's a new one. NULL: out of memory. Needs `lv_thread_lock`.
+static node_cost_t * cost_get(doc_id_t node, uint32_t uid)
+{
+    if(node >= cost_cap)
+    {
+        uint32_t cap = cost_cap > 0 ? cost_cap : DOC_INIT_CAPACITY;
+        while(cap <= node) cap *= 2;
+        node_cost_t * c = realloc(costs, cap * sizeof(node_cost_t));
+        if(c == NULL) return NULL;
+        memset(&c[cost_cap], 0, (cap - cost_cap) * sizeof(node_cost_t));
+        costs = c;
+        cost_cap = cap;
+    }
+
+    node_cost_t * c = &costs[node];
+    if(c->uid != uid)
+    {
+        memset(c, 0, sizeof(node_cost_t));
+        c->uid = uid;
+    }
+    return c;
+}
+
+//Move the sums of a finished refresh into the rolling averages
+static void cost_fold(node_cost_t * c)
+{
+    if(c->avg_valid)
+    {
+        c->avg.us += (c->cur_us - c->avg.us) / DRAWCOST_AVG_DIV;
+        c->avg.px += (c->cur_px - c->avg.px) / DRAWCOST_AVG_DIV;
+        c->avg.calls += (c->cur_calls - c->avg.calls) / DRAWCOST_AVG_DIV;
+    }else
+    {
+        c->avg.us = c->cur_us;
+        c->avg.px = c->cur_px;
+        c->avg.calls = c->cur_calls;
+        c->avg_valid = 1;
+    }
+    c->cur_us = 0;
+    c->cur_px = 0;
+    c->cur_calls = 0;
+    c->cur_any = 0;
+}
+
+//Refresh the badges if a widget was drawn. Drawing the Layer View doesn't count, it's not in the project.
+static void badge_task(lv_task_t * task)
+{
+    (void)task;
+    if(!changed) return;
+    changed = false;
+    layerview_refr_request();
+}
+
+//The draw time of a widget and its badge, e.g. "0.42 ms 12k px 3 calls"
+static double badge_cb(doc_id_t node, char * badge, uint32_t badge_size)
+{
+    drawcost_t c;
+    if(!drawcost_get(node, &c)) return -1;
+    if(badge != NULL)
+    {
+        if(c.px >= 10000) snprintf(badge, badge_size, "%.2f ms %.0fk px %.0f calls", c.us / 1000, c.px / 1000, c.calls);
+        else snprintf(badge, badge_size, "%.2f ms %.0f px %.0f calls", c.us / 1000, c.px, c.calls);
+    }
+    return c.us;
+}
@@ -0,0 +1,61 @@
+/**
+ * @file drawcost.h
+ *
+ */
+
+#ifndef _DRAWCOST_H_
+#define _DRAWCOST_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define DRAWCOST_AVG_DIV        8       //A new refresh moves the rolling average by 1/DRAWCOST_AVG_DIV of the difference
+#define DRAWCOST_PERIOD         500     //[ms] between two updates of the badges in the Layer View
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//The rolling averages of the refreshes which drew a widget
+typedef struct
+{
+    float us;                   //[us] in its design functions (and in those of its internal children)
+    float px;                   //Pixels they drew
+    float calls;                //`design_cb` calls
+}drawcost_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void drawcost_init(void);
+bool drawcost_get(doc_id_t node, drawcost_t * cost);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
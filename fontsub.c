@@ -0,0 +1,785 @@
+/**
+ * @fontsub .c
+ * Font subsetting: the built-in fonts written again as `lv_font_fmt_txt` C sources with only the glyphs
+ * of the letters the project shows, and only the kerning between them.
+ * A subset has the name of the font it's cut from, so the target's styles and LV_FONT_DEFAULT keep
+ * pointing to it. The target disables the whole font in its lv_conf.h and declares the subset instead.
+ * A TrueType font of the designer (see ttfont.c) has no built-in font on the target, its subset is the only one.
+ * A written subset is kept in the asset store under the hash of the font, the letters and the compression.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "fontsub.h"
+#include "assetstore.h"
+#include "ttfont.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LETTERS_SIZE_MIN    64
+#define BYTES_PER_LINE      8
+#define LIST_PER_LINE       8
+#define RANGE_LENGTH_MAX    0xFFFF      //`range_length` and the offsets of `unicode_list` are 16 bit
+#define CMAP_NUM_MAX        1023        //`cmap_num` is 10 bit
+#define STORE_VERSION       1           //Change it with the written source, the stored subsets won't be used then
+#define STORE_KIND          "font"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const lv_font_t * font;
+    const char * name;          //Of the variable
+    const char * conf;          //Enables it in lv_conf.h
+}builtin_font_t;
+
+//A character map of the subset
+typedef struct
+{
+    uint32_t first;             //Index of its first letter
+    uint32_t cnt;               //Letters
+    bool sparse;                //`unicode_list` or a range of consecutive letters
+}sub_cmap_t;
+
+//A kerning pair of the subset, with the new glyph IDs
+typedef struct
+{
+    uint16_t left;
+    uint16_t right;
+    int8_t value;
+}sub_pair_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool font_write(FILE * fp, const fontsub_letters_t * set, bool compress, fontsub_report_t * report);
+static bool subset_write(FILE * fp, const lv_font_t * font, const fontsub_letters_t * set, const char * name,
+                         const char * conf, bool compress, fontsub_report_t * report);
+static uint64_t subset_key(const fontsub_letters_t * set, bool compress);
+static const builtin_font_t * builtin_find(const lv_font_t * font);
+static uint32_t glyph_cnt_get(const lv_font_fmt_txt_dsc_t * fdsc);
+static uint32_t bitmap_size_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid);
+static uint32_t bitmap_compress(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid, uint8_t * out);
+static void bits_write(uint8_t * out, uint32_t * bit_ofs, uint32_t value, uint8_t n);
+static uint32_t kern_size_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_cnt);
+static uint32_t cmaps_build(const uint32_t * letters, uint32_t cnt, uint32_t run_min, sub_cmap_t * cmaps);
+static uint32_t cmaps_write(FILE * fp, const uint32_t * letters, const sub_cmap_t * cmaps, uint32_t cmap_cnt);
+static uint32_t kern_classes_write(FILE * fp, const lv_font_fmt_txt_dsc_t * fdsc, const uint32_t * gids, uint32_t cnt);
+static uint32_t kern_pairs_write(FILE * fp, const lv_font_fmt_txt_dsc_t * fdsc, const uint32_t * gids, uint32_t cnt,
+                                 uint32_t glyph_cnt, bool * ok);
+static void list_write(FILE * fp, const char * decl, const int32_t * values, uint32_t cnt);
+static int pair_cmp(const void * a, const void * b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const builtin_font_t builtin_fonts[] = {
+#if LV_FONT_ROBOTO_12
+    {&lv_font_roboto_12, "lv_font_roboto_12", "LV_FONT_ROBOTO_12"},
+#endif
+#if LV_FONT_ROBOTO_16
+    {&lv_font_roboto_16, "lv_font_roboto_16", "LV_FONT_ROBOTO_16"},
+#endif
+#if LV_FONT_ROBOTO_22
+    {&lv_font_roboto_22, "lv_font_roboto_22", "LV_FONT_ROBOTO_22"},
+#endif
+#if LV_FONT_ROBOTO_28
+    {&lv_font_roboto_28, "lv_font_roboto_28", "LV_FONT_ROBOTO_28"},
+#endif
+#if LV_FONT_UNSCII_8
+    {&lv_font_unscii_8, "lv_font_unscii_8", "LV_FONT_UNSCII_8"},
+#endif
+    {NULL, NULL, NULL}
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//The variable of a built-in or a TrueType font, NULL for the others (e.g. loaded from a file)
+const char * fontsub_get_name(const lv_font_t * font)
+{
+    const builtin_font_t * bf = builtin_find(font);
+    return bf != NULL ? bf->name : ttfont_get_name(font);
+}
+
+//Its `LV_FONT_...` of lv_conf.h, NULL if it isn't built-in
+const char * fontsub_get_conf(const lv_font_t * font)
+{
+    const builtin_font_t * bf = builtin_find(font);
+    return bf != NULL ? bf->conf : NULL;
+}
+
+//A built-in font in the LittlevGL's format with uncompressed bitmaps or a TrueType font
+bool fontsub_is_supported(const lv_font_t * font)
+{
+    if(ttfont_is(font)) return true;
+    if(builtin_find(font) == NULL) return false;
+    if(font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt || font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt)
+    {
+        return false;
+    }
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    return fdsc->bitmap_format == LV_FONT_FMT_TXT_PLAIN;
+}
+
+//Add the letters of a UTF-8 text, the control characters (e.g. the line breaks of the options) aren't drawn
+bool fontsub_letters_add(fontsub_letters_t * set, const char * txt)
+{
+    uint32_t i = 0;
+    while(txt[i] != '\0')
+    {
+        uint32_t letter = lv_txt_encoded_next(txt, &i);
+        if(letter < 0x20 || letter == 0x7F) continue;
+
+        //Binary search for the place of the letter
+        uint32_t lo = 0;
+        uint32_t hi = set->cnt;
+        while(lo < hi)
+        {
+            uint32_t mid = (lo + hi) / 2;
+            if(set->letters[mid] < letter) lo = mid + 1;
+            else hi = mid;
+        }
+        if(lo < set->cnt && set->letters[lo] == letter) continue;
+
+        if(set->cnt == set->size)
+        {
+            uint32_t size = set->size == 0 ? LETTERS_SIZE_MIN : set->size * 2;
+            uint32_t * letters = realloc(set->letters, size * sizeof(uint32_t));
+            if(letters == NULL) return false;
+            set->letters = letters;
+            set->size = size;
+        }
+        memmove(&set->letters[lo + 1], &set->letters[lo], (set->cnt - lo) * sizeof(uint32_t));
+        set->letters[lo] = letter;
+        set->cnt++;
+    }
+    return true;
+}
+
+void fontsub_letters_free(fontsub_letters_t * set)
+{
+    free(set->letters);
+    set->letters = NULL;
+    set->cnt = 0;
+    set->size = 0;
+}
+
+//Bytes of the bitmaps and tables of a whole font in the flash, 0 if it's not supported or a TrueType font
+uint32_t fontsub_full_size(const lv_font_t * font)
+{
+    if(!fontsub_is_supported(font) || ttfont_is(font)) return 0;
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t glyph_cnt = glyph_cnt_get(fdsc);
+    uint32_t size = glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t) + kern_size_get(fdsc, glyph_cnt);
+    uint32_t i;
+    for(i = 1; i < glyph_cnt; i++) size += bitmap_size_get(fdsc, i);
+    for(i = 0; i < fdsc->cmap_num; i++)
+    {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        size += sizeof(lv_font_fmt_txt_cmap_t);
+        if(cm->unicode_list != NULL) size += cm->list_length * sizeof(uint16_t);
+        if(cm->glyph_id_ofs_list != NULL)
+        {
+            size += cm->list_length * (cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL ? 1 : 2);
+        }
+    }
+    return size;
+}
+
+/* Write the subset of `set->font` with the glyphs of `set->letters` as a C source.
+ * The glyphs get new IDs in the order of the letters, they are mapped by ranges of consecutive letters
+ * and lists of the others. The kerning classes are kept as they are, the pairs between the kept glyphs
+ * get the new IDs. With `compress` the bitmaps are prefix coded (`LV_FONT_FMT_TXT_COMPRESSED`).
+ * The same subset written earlier (by any project) is copied from the asset store. */
+bool fontsub_write(FILE * fp, const fontsub_letters_t * set, bool compress, fontsub_report_t * report)
+{
+    memset(report, 0, sizeof(fontsub_report_t));
+    if(!fontsub_is_supported(set->font)) return false;
+
+    uint64_t key = subset_key(set, compress);
+    assetstore_blob_t blob;
+    if(assetstore_get(key, STORE_KIND, &blob))
+    {
+        bool res = false;
+        if(blob.size >= sizeof(fontsub_report_t))
+        {
+            uint32_t len = blob.size - sizeof(fontsub_report_t);
+            memcpy(report, blob.data, sizeof(fontsub_report_t));
+            report->cached = true;
+            res = fwrite(blob.data + sizeof(fontsub_report_t), 1, len, fp) == len;
+        }
+        assetstore_release(&blob);
+        if(res) return true;
+        memset(report, 0, sizeof(fontsub_report_t));
+    }
+
+    //Written into the memory first to store it too
+    char * src = NULL;
+    size_t len = 0;
+    FILE * mem = open_memstream(&src, &len);
+    if(mem == NULL) return font_write(fp, set, compress, report);
+    bool res = font_write(mem, set, compress, report);
+    if(fclose(mem) != 0) res = false;
+    if(res) res = fwrite(src, 1, len, fp) == len;
+    if(res) assetstore_put(key, STORE_KIND, report, sizeof(fontsub_report_t), src, len);
+    free(src);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//The subset of a built-in font, or of the glyphs of a TrueType font rasterized for the letters
+static bool font_write(FILE * fp, const fontsub_letters_t * set, bool compress, fontsub_report_t * report)
+{
+    const builtin_font_t * bf = builtin_find(set->font);
+    if(bf != NULL) return subset_write(fp, set->font, set, bf->name, bf->conf, compress, report);
+
+    lv_font_t built;
+    if(!ttfont_build(set->font, set->letters, set->cnt, &built)) return false;
+    bool res = subset_write(fp, &built, set, ttfont_get_name(set->font), NULL, compress, report);
+    report->full_size = report->size;       //There is no whole font, only the glyphs drawn
+    ttfont_build_free(&built);
+    return res;
+}
+
+static bool subset_write(FILE * fp, const lv_font_t * font, const fontsub_letters_t * set, const char * name,
+                         const char * conf, bool compress, fontsub_report_t * report)
+{
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    uint32_t glyph_cnt = glyph_cnt_get(fdsc);
+
+    //The letters the font has and their glyphs in it
+    uint32_t * letters = malloc((set->cnt + 1) * sizeof(uint32_t));
+    uint32_t * gids = malloc((set->cnt + 1) * sizeof(uint32_t));
+    uint32_t * sizes = malloc((set->cnt + 1) * sizeof(uint32_t));
+    sub_cmap_t * cmaps = malloc((set->cnt + 1) * sizeof(sub_cmap_t));
+    if(letters == NULL || gids == NULL || sizes == NULL || cmaps == NULL)
+    {
+        free(letters);
+        free(gids);
+        free(sizes);
+        free(cmaps);
+        return false;
+    }
+
+    uint32_t cnt = 0;
+    uint32_t i;
+    for(i = 0; i < set->cnt; i++)
+    {
+        uint32_t gid = lv_font_fmt_txt_get_glyph_id(font, set->letters[i]);
+        if(gid == 0 || gid >= glyph_cnt) continue;
+        letters[cnt] = set->letters[i];
+        gids[cnt] = gid;
+        cnt++;
+    }
+
+    //Too many short ranges: list every letter then, one list covers 64k code points
+    uint32_t cmap_cnt = cmaps_build(letters, cnt, FONTSUB_RUN_MIN, cmaps);
+    if(cmap_cnt > CMAP_NUM_MAX) cmap_cnt = cmaps_build(letters, cnt, UINT32_MAX, cmaps);
+
+    report->glyphs = cnt;
+    report->full_size = fontsub_full_size(font);
+
+    //Keep the bitmaps plain if compressing doesn't make them smaller (e.g. with 1 bit-per-pixel)
+    uint8_t * packed = NULL;
+    if(compress)
+    {
+        uint32_t px_num_max = 0;
+        for(i = 0; i < cnt; i++)
+        {
+            const lv_font_fmt_txt_glyph_dsc_t * g = &fdsc->glyph_dsc[gids[i]];
+            if((uint32_t)g->box_w * g->box_h > px_num_max) px_num_max = (uint32_t)g->box_w * g->box_h;
+        }
+        packed = malloc((px_num_max * (fdsc->bpp + 2) + 7) / 8 + 1);
+        if(packed == NULL)
+        {
+            free(letters);
+            free(gids);
+            free(sizes);
+            free(cmaps);
+            return false;
+        }
+        uint32_t plain_size = 0;
+        uint32_t packed_size = 0;
+        for(i = 0; i < cnt; i++)
+        {
+            plain_size += bitmap_size_get(fdsc, gids[i]);
+            packed_size += bitmap_compress(fdsc, gids[i], packed);
+        }
+        if(packed_size >= plain_size) compress = false;
+    }
+
+    fprintf(fp, "#include \"lvgl.h\"\n\n"
+            "/*******************************************************************************\n"
+            " * Subset of %s with the %u glyphs drawn by the project\n"
+            " * Written by the designer, don't edit\n"
+            " ******************************************************************************/\n\n", name, cnt);
+    if(conf != NULL)
+    {
+        fprintf(fp, "#if %s\n"
+                "#error \"This file replaces %s: in lv_conf.h set %s to 0 "
+                "and add LV_FONT_DECLARE(%s) to LV_FONT_CUSTOM_DECLARE\"\n"
+                "#endif\n\n", conf, name, conf, name);
+    }
+    if(compress)
+    {
+        fputs("#if !LV_USE_FONT_COMPRESSED\n"
+              "#error \"The glyph bitmaps of this font are compressed: in lv_conf.h set LV_USE_FONT_COMPRESSED to 1\"\n"
+              "#endif\n\n", fp);
+    }
+
+    //Bitmaps, each glyph's starts on a byte boundary
+    fputs("/*-----------------\n *    BITMAPS\n *----------------*/\n\n"
+          "/*Store the image of the glyphs*/\n"
+          "static LV_ATTRIBUTE_LARGE_CONST const uint8_t gylph_bitmap[] = {\n", fp);
+    uint32_t bitmap_size = 0;
+    for(i = 0; i < cnt; i++)
+    {
+        const lv_font_fmt_txt_glyph_dsc_t * g = &fdsc->glyph_dsc[gids[i]];
+        const uint8_t * bitmap = &fdsc->glyph_bitmap[g->bitmap_index];
+        uint32_t size = bitmap_size_get(fdsc, gids[i]);
+        if(compress)
+        {
+            size = bitmap_compress(fdsc, gids[i], packed);
+            bitmap = packed;
+        }
+        sizes[i] = size;
+        fprintf(fp, "%s    /* U+%X */\n", i == 0 ? "" : "\n", letters[i]);
+        uint32_t k;
+        for(k = 0; k < size; k++)
+        {
+            fprintf(fp, "%s0x%x,%s", k % BYTES_PER_LINE == 0 ? "    " : "", bitmap[k],
+                    k % BYTES_PER_LINE == BYTES_PER_LINE - 1 || k == size - 1 ? "\n" : " ");
+        }
+        bitmap_size += size;
+    }
+    free(packed);
+    if(bitmap_size == 0) fputs("    0x0     /*Only empty glyphs, but the array can't be empty*/\n", fp);
+    fputs("};\n\n", fp);
+
+    fputs("/*---------------------\n *  GLYPH DESCRIPTION\n *--------------------*/\n\n"
+          "static const lv_font_fmt_txt_glyph_dsc_t glyph_dsc[] = {\n"
+          "    {.bitmap_index = 0, .adv_w = 0, .box_h = 0, .box_w = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */",
+          fp);
+    uint32_t bitmap_index = 0;
+    for(i = 0; i < cnt; i++)
+    {
+        const lv_font_fmt_txt_glyph_dsc_t * g = &fdsc->glyph_dsc[gids[i]];
+        fprintf(fp, ",\n    {.bitmap_index = %u, .adv_w = %u, .box_h = %u, .box_w = %u, .ofs_x = %d, .ofs_y = %d}",
+                bitmap_index, (unsigned)g->adv_w, g->box_h, g->box_w, g->ofs_x, (int8_t)g->ofs_y);
+        bitmap_index += sizes[i];
+    }
+    fputs("\n};\n\n", fp);
+
+    fputs("/*---------------------\n *  CHARACTER MAPPING\n *--------------------*/\n\n", fp);
+    uint32_t cmap_size = cmaps_write(fp, letters, cmaps, cmap_cnt);
+
+    const char * kern_dsc = "NULL";
+    uint32_t kern_size = 0;
+    bool ok = true;
+    if(fdsc->kern_dsc != NULL && cnt > 0)
+    {
+        fputs("/*-----------------\n *    KERNING\n *----------------*/\n\n", fp);
+        if(fdsc->kern_classes)
+        {
+            kern_size = kern_classes_write(fp, fdsc, gids, cnt);
+            kern_dsc = "&kern_classes";
+        }else
+        {
+            kern_size = kern_pairs_write(fp, fdsc, gids, cnt, glyph_cnt, &ok);
+            if(kern_size > 0) kern_dsc = "&kern_pairs";
+        }
+    }
+
+    fprintf(fp, "/*--------------------\n *  ALL CUSTOM DATA\n *--------------------*/\n\n"
+            "/*Store all the custom data of the font*/\n"
+            "static lv_font_fmt_txt_dsc_t font_dsc = {\n"
+            "    .glyph_bitmap = gylph_bitmap,\n"
+            "    .glyph_dsc = glyph_dsc,\n"
+            "    .cmaps = %s,\n"
+            "    .cmap_num = %u,\n"
+            "    .bpp = %u,\n\n"
+            "    .kern_scale = %u,\n"
+            "    .kern_dsc = %s,\n"
+            "    .kern_classes = %u,\n"
+            "    .bitmap_format = %s\n"
+            "};\n\n", cmap_cnt > 0 ? "cmaps" : "NULL", cmap_cnt, fdsc->bpp, fdsc->kern_scale, kern_dsc,
+            kern_size > 0 && fdsc->kern_classes ? 1 : 0,
+            compress ? "LV_FONT_FMT_TXT_COMPRESSED" : "LV_FONT_FMT_TXT_PLAIN");
+
+    fprintf(fp, "/*-----------------\n *  PUBLIC FONT\n *----------------*/\n\n"
+            "/*Initialize a public general font descriptor*/\n"
+            "lv_font_t %s = {\n"
+            "    .dsc = &font_dsc,          /*The custom font data. Will be accessed by `get_glyph_bitmap/dsc` */\n"
+            "    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,    /*Function pointer to get glyph's bitmap*/\n"
+            "    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,    /*Function pointer to get glyph's data*/\n"
+            "    .line_height = %u,          /*The maximum line height required by the font*/\n"
+            "    .base_line = %u,             /*Baseline measured from the bottom of the line*/\n"
+            "};\n", name, font->line_height, font->base_line);
+
+    report->size = bitmap_size + (cnt + 1) * sizeof(lv_font_fmt_txt_glyph_dsc_t) + cmap_size + kern_size;
+    free(letters);
+    free(gids);
+    free(sizes);
+    free(cmaps);
+    return ok;
+}
+
+//The font (its name, size and bits per pixel or its TrueType file), the letters, the compression and the version
+//of the writer
+static uint64_t subset_key(const fontsub_letters_t * set, bool compress)
+{
+    uint64_t key;
+    if(ttfont_is(set->font))
+    {
+        uint64_t font_key = ttfont_get_hash(set->font);
+        key = assetstore_hash(ASSETSTORE_HASH_INIT, &font_key, sizeof(font_key));
+    }else
+    {
+        const builtin_font_t * bf = builtin_find(set->font);
+        const lv_font_fmt_txt_dsc_t * fdsc = set->font->dsc;
+        uint32_t metrics[4] = {set->font->line_height, set->font->base_line, fdsc->bpp, glyph_cnt_get(fdsc)};
+        key = assetstore_hash(ASSETSTORE_HASH_INIT, bf->name, strlen(bf->name) + 1);
+        key = assetstore_hash(key, metrics, sizeof(metrics));
+    }
+    uint32_t params[2] = {compress, STORE_VERSION};
+    key = assetstore_hash(key, params, sizeof(params));
+    return assetstore_hash(key, set->letters, set->cnt * sizeof(uint32_t));
+}
+
+static const builtin_font_t * builtin_find(const lv_font_t * font)
+{
+    uint32_t i;
+    for(i = 0; builtin_fonts[i].font != NULL; i++)
+    {
+        if(builtin_fonts[i].font == font) return &builtin_fonts[i];
+    }
+    return NULL;
+}
+
+//The glyph IDs of a font are below this, found from its character maps
+static uint32_t glyph_cnt_get(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uint32_t max = 0;
+    uint32_t i;
+    for(i = 0; i < fdsc->cmap_num; i++)
+    {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        uint32_t last = 0;
+        uint32_t k;
+        switch(cm->type)
+        {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY:
+                if(cm->range_length > 0) last = cm->range_length - 1;
+                break;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                for(k = 0; k < cm->list_length; k++)
+                {
+                    uint8_t ofs = ((const uint8_t *)cm->glyph_id_ofs_list)[k];
+                    if(ofs > last) last = ofs;
+                }
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY:
+                if(cm->list_length > 0) last = cm->list_length - 1;
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+                for(k = 0; k < cm->list_length; k++)
+                {
+                    uint16_t ofs = ((const uint16_t *)cm->glyph_id_ofs_list)[k];
+                    if(ofs > last) last = ofs;
+                }
+                break;
+        }
+        if(cm->glyph_id_start + last > max) max = cm->glyph_id_start + last;
+    }
+    return max + 1;
+}
+
+static uint32_t bitmap_size_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid)
+{
+    const lv_font_fmt_txt_glyph_dsc_t * g = &fdsc->glyph_dsc[gid];
+    return ((uint32_t)g->box_w * g->box_h * fdsc->bpp + 7) / 8;
+}
+
+/* Prefix code the bitmap of a glyph as `lv_font_fmt_txt.h` describes at `LV_FONT_FMT_TXT_COMPRESSED`.
+ * `out` needs `(box_w * box_h * (bpp + 2) + 7) / 8` bytes. Returns the bytes written. */
+static uint32_t bitmap_compress(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t gid, uint8_t * out)
+{
+    const lv_font_fmt_txt_glyph_dsc_t * g = &fdsc->glyph_dsc[gid];
+    const uint8_t * bitmap = &fdsc->glyph_bitmap[g->bitmap_index];
+    uint32_t px_num = (uint32_t)g->box_w * g->box_h;
+    uint8_t bpp = fdsc->bpp;
+    uint8_t px_max = (1 << bpp) - 1;
+    uint32_t out_ofs = 0;
+    uint32_t i;
+    for(i = 0; i < px_num; i++)
+    {
+        uint32_t bit_ofs = i * bpp;
+        uint8_t v = (bitmap[bit_ofs >> 3] >> (8 - bpp - (bit_ofs & 0x7))) & px_max;
+        if(v == 0) bits_write(out, &out_ofs, 0x0, 1);
+        else if(v == px_max) bits_write(out, &out_ofs, 0x2, 2);
+        else
+        {
+            bits_write(out, &out_ofs, 0x3, 2);
+            bits_write(out, &out_ofs, v, bpp);
+        }
+    }
+    return (out_ofs + 7) / 8;
+}
+
+//Append the lower `n` bits of `value` to a bit stream, MSB first
+static void bits_write(uint8_t * out, uint32_t * bit_ofs, uint32_t value, uint8_t n)
+{
+    while(n > 0)
+    {
+        n--;
+        uint32_t o = *bit_ofs;
+        if((o & 0x7) == 0) out[o >> 3] = 0;
+        if((value >> n) & 0x1) out[o >> 3] |= 0x80 >> (o & 0x7);
+        (*bit_ofs)++;
+    }
+}
+
+static uint32_t kern_size_get(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_cnt)
+{
+    if(fdsc->kern_dsc == NULL) return 0;
+    if(fdsc->kern_classes)
+    {
+        const lv_font_fmt_txt_kern_classes_t * kc = fdsc->kern_dsc;
+        return glyph_cnt * 2 + kc->left_class_cnt * kc->right_class_cnt;
+    }
+    const lv_font_fmt_txt_kern_pair_t * kp = fdsc->kern_dsc;
+    return kp->pair_cnt * (kp->glyph_ids_size ? 5 : 3);
+}
+
+/* Group the letters into character maps: a range for `run_min` or more consecutive letters,
+ * lists for the others. Returns the number of maps. */
+static uint32_t cmaps_build(const uint32_t * letters, uint32_t cnt, uint32_t run_min, sub_cmap_t * cmaps)
+{
+    uint32_t cmap_cnt = 0;
+    uint32_t i = 0;
+    while(i < cnt)
+    {
+        uint32_t run;
+        for(run = 1; i + run < cnt && letters[i + run] == letters[i] + run && run < RANGE_LENGTH_MAX; run++);
+
+        if(run >= run_min)
+        {
+            cmaps[cmap_cnt].first = i;
+            cmaps[cmap_cnt].cnt = run;
+            cmaps[cmap_cnt].sparse = false;
+            cmap_cnt++;
+            i += run;
+            continue;
+        }
+
+        //Continue the list before, if the letter isn't too far from its start
+        sub_cmap_t * prev = cmap_cnt > 0 ? &cmaps[cmap_cnt - 1] : NULL;
+        if(prev == NULL || !prev->sparse || prev->first + prev->cnt != i ||
+           letters[i] - letters[prev->first] >= RANGE_LENGTH_MAX)
+        {
+            prev = &cmaps[cmap_cnt++];
+            prev->first = i;
+            prev->cnt = 0;
+            prev->sparse = true;
+        }
+        prev->cnt++;
+        i++;
+    }
+    return cmap_cnt;
+}
+
+//Returns the bytes of the maps and their lists
+static uint32_t cmaps_write(FILE * fp, const uint32_t * letters, const sub_cmap_t * cmaps, uint32_t cmap_cnt)
+{
+    uint32_t size = cmap_cnt * sizeof(lv_font_fmt_txt_cmap_t);
+    uint32_t c;
+    for(c = 0; c < cmap_cnt; c++)
+    {
+        if(!cmaps[c].sparse) continue;
+        fprintf(fp, "static uint16_t unicode_list_%u[] = {\n", c);
+        uint32_t k;
+        for(k = 0; k < cmaps[c].cnt; k++)
+        {
+            uint32_t ofs = letters[cmaps[c].first + k] - letters[cmaps[c].first];
+            fprintf(fp, "%s0x%x%s", k % LIST_PER_LINE == 0 ? "    " : "", ofs,
+                    k == cmaps[c].cnt - 1 ? "\n" : (k % LIST_PER_LINE == LIST_PER_LINE - 1 ? ",\n" : ", "));
+        }
+        fputs("};\n\n", fp);
+        size += cmaps[c].cnt * sizeof(uint16_t);
+    }
+
+    if(cmap_cnt == 0) return size;
+
+    fputs("/*Collect the unicode lists and glyph_id offsets*/\nstatic const lv_font_fmt_txt_cmap_t cmaps[] =\n{\n", fp);
+    for(c = 0; c < cmap_cnt; c++)
+    {
+        const sub_cmap_t * cm = &cmaps[c];
+        uint32_t start = letters[cm->first];
+        uint32_t length = letters[cm->first + cm->cnt - 1] - start + 1;
+        if(cm->sparse)
+        {
+            fprintf(fp, "    {\n        .range_start = %u, .range_length = %u, .type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY,\n"
+                    "        .glyph_id_start = %u, .unicode_list = unicode_list_%u, .glyph_id_ofs_list = NULL, "
+                    ".list_length = %u\n    }", start, length, cm->first + 1, c, cm->cnt);
+        }else
+        {
+            fprintf(fp, "    {\n        .range_start = %u, .range_length = %u, .type = LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY,\n"
+                    "        .glyph_id_start = %u, .unicode_list = NULL, .glyph_id_ofs_list = NULL, .list_length = 0\n"
+                    "    }", start, length, cm->first + 1);
+        }
+        fputs(c == cmap_cnt - 1 ? "\n" : ",\n", fp);
+    }
+    fputs("};\n\n", fp);
+    return size;
+}
+
+/* The classes of the kept glyphs. The table of the class pairs is kept whole,
+ * so every lookup gives the same value as in the whole font. Returns the bytes written. */
+static uint32_t kern_classes_write(FILE * fp, const lv_font_fmt_txt_dsc_t * fdsc, const uint32_t * gids, uint32_t cnt)
+{
+    const lv_font_fmt_txt_kern_classes_t * kc = fdsc->kern_dsc;
+    uint32_t values_cnt = (uint32_t)kc->left_class_cnt * kc->right_class_cnt;
+    uint32_t max = cnt + 1 > values_cnt ? cnt + 1 : values_cnt;
+    int32_t * values = malloc(max * sizeof(int32_t));
+    if(values == NULL) return 0;
+
+    uint32_t i;
+    values[0] = 0;
+    for(i = 0; i < cnt; i++) values[i + 1] = kc->left_class_mapping[gids[i]];
+    list_write(fp, "/*Map glyph_ids to kern left classes*/\nstatic uint8_t kern_left_class_mapping[]", values, cnt + 1);
+    for(i = 0; i < cnt; i++) values[i + 1] = kc->right_class_mapping[gids[i]];
+    list_write(fp, "/*Map glyph_ids to kern right classes*/\nstatic uint8_t kern_right_class_mapping[]", values, cnt + 1);
+    for(i = 0; i < values_cnt; i++) values[i] = (int8_t)kc->class_pair_values[i];
+    list_write(fp, "/*Kern values between classes*/\nstatic uint8_t kern_class_values[]", values, values_cnt);
+    free(values);
+
+    fprintf(fp, "/*Collect the kern class' data in one place*/\n"
+            "static lv_font_fmt_txt_kern_classes_t kern_classes =\n{\n"
+            "    .class_pair_values   = kern_class_values,\n"
+            "    .left_class_mapping  = kern_left_class_mapping,\n"
+            "    .right_class_mapping = kern_right_class_mapping,\n"
+            "    .left_class_cnt      = %u,\n"
+            "    .right_class_cnt     = %u,\n"
+            "};\n\n", kc->left_class_cnt, kc->right_class_cnt);
+    return (cnt + 1) * 2 + values_cnt;
+}
+
+/* The pairs whose both glyphs are kept, with the new IDs, ordered for the binary search.
+ * Returns the bytes written, 0 if there's no such pair. `ok` is cleared if out of memory. */
+static uint32_t kern_pairs_write(FILE * fp, const lv_font_fmt_txt_dsc_t * fdsc, const uint32_t * gids, uint32_t cnt,
+                                 uint32_t glyph_cnt, bool * ok)
+{
+    const lv_font_fmt_txt_kern_pair_t * kp = fdsc->kern_dsc;
+    if(kp->glyph_ids_size > 1 || kp->pair_cnt == 0) return 0;
+
+    //The new ID of the old glyphs, 0: not kept. A glyph kept for more letters gets the first one's kerning.
+    uint32_t * new_ids = calloc(glyph_cnt, sizeof(uint32_t));
+    sub_pair_t * pairs = malloc(kp->pair_cnt * sizeof(sub_pair_t));
+    if(new_ids == NULL || pairs == NULL)
+    {
+        free(new_ids);
+        free(pairs);
+        *ok = false;
+        return 0;
+    }
+
+    uint32_t i;
+    for(i = cnt; i > 0; i--) new_ids[gids[i - 1]] = i;
+
+    uint32_t pair_cnt = 0;
+    for(i = 0; i < kp->pair_cnt; i++)
+    {
+        uint32_t left;
+        uint32_t right;
+        if(kp->glyph_ids_size == 0)
+        {
+            left = ((const uint8_t *)kp->glyph_ids)[i * 2];
+            right = ((const uint8_t *)kp->glyph_ids)[i * 2 + 1];
+        }else
+        {
+            left = ((const uint16_t *)kp->glyph_ids)[i * 2];
+            right = ((const uint16_t *)kp->glyph_ids)[i * 2 + 1];
+        }
+        if(left >= glyph_cnt || right >= glyph_cnt || new_ids[left] == 0 || new_ids[right] == 0) continue;
+        pairs[pair_cnt].left = new_ids[left];
+        pairs[pair_cnt].right = new_ids[right];
+        pairs[pair_cnt].value = kp->values[i];
+        pair_cnt++;
+    }
+    free(new_ids);
+
+    if(pair_cnt == 0)
+    {
+        free(pairs);
+        return 0;
+    }
+    qsort(pairs, pair_cnt, sizeof(sub_pair_t), pair_cmp);
+
+    int32_t * values = malloc(pair_cnt * 2 * sizeof(int32_t));
+    if(values == NULL)
+    {
+        free(pairs);
+        *ok = false;
+        return 0;
+    }
+
+    bool wide = cnt + 1 > 0xFF;
+    for(i = 0; i < pair_cnt; i++)
+    {
+        values[i * 2] = pairs[i].left;
+        values[i * 2 + 1] = pairs[i].right;
+    }
+    list_write(fp, wide ? "/*Pair left and right glyphs for kerning*/\nstatic const uint16_t kern_pair_glyph_ids[]" :
+               "/*Pair left and right glyphs for kerning*/\nstatic const uint8_t kern_pair_glyph_ids[]",
+               values, pair_cnt * 2);
+    for(i = 0; i < pair_cnt; i++) values[i] = pairs[i].value;
+    list_write(fp, "/* Kerning between the respective left and right glyphs\n * 4.4 format which needs to scaled with "
+               "`kern_scale`*/\nstatic const int8_t kern_pair_values[]", values, pair_cnt);
+    free(values);
+    free(pairs);
+
+    fprintf(fp, "/*Collect the kern pair's data in one place*/\n"
+            "static const lv_font_fmt_txt_kern_pair_t kern_pairs =\n{\n"
+            "    .glyph_ids = kern_pair_glyph_ids,\n"
+            "    .values = kern_pair_values,\n"
+            "    .pair_cnt = %u,\n"
+            "    .glyph_ids_size = %u\n"
+            "};\n\n", pair_cnt, wide ? 1 : 0);
+    return pair_cnt * (wide ? 5 : 3);
+}
+
+//An array `decl` with its values, LIST_PER_LINE in a line
+static void list_write(FILE * fp, const char * decl, const int32_t * values, uint32_t cnt)
+{
+    fprintf(fp, "%s =\n{\n", decl);
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        fprintf(fp, "%s%d", i % LIST_PER_LINE == 0 ? "    " : " ", (int)values[i]);
+        if(i < cnt - 1) fputs(",", fp);
+        if(i % LIST_PER_LINE == LIST_PER_LINE - 1 || i == cnt - 1) fputs("\n", fp);
+    }
+    fputs("};\n\n", fp);
+}
+
+static int pair_cmp(const void * a, const void * b)
+{
+    const sub_pair_t * pa = a;
+    const sub_pair_t * pb = b;
+    if(pa->left != pb->left) return (int)pa->left - pb->left;
+    return (int)pa->right - pb->right;
+}
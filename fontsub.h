@@ -0,0 +1,73 @@
+/**
+ * @file fontsub.h
+ *
+ */
+
+#ifndef _FONTSUB_H_
+#define _FONTSUB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FONTSUB_RUN_MIN         8       //Consecutive letters get a range of their own, the others are listed
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//The letters drawn with a font
+typedef struct
+{
+    const lv_font_t * font;
+    uint32_t * letters;                 //Unicode, sorted and unique
+    uint32_t cnt;
+    uint32_t size;                      //Allocated in `letters`
+}fontsub_letters_t;
+
+typedef struct
+{
+    uint32_t glyphs;                    //In the subset, the letters the font doesn't have are left out
+    uint32_t size;                      //Bytes of the subset's bitmaps and tables
+    uint32_t full_size;                 //The same of the whole font
+    bool cached;                        //Copied from the asset store, not written now
+}fontsub_report_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+const char * fontsub_get_name(const lv_font_t * font);
+const char * fontsub_get_conf(const lv_font_t * font);
+bool fontsub_is_supported(const lv_font_t * font);
+bool fontsub_letters_add(fontsub_letters_t * set, const char * txt);
+void fontsub_letters_free(fontsub_letters_t * set);
+bool fontsub_write(FILE * fp, const fontsub_letters_t * set, bool compress, fontsub_report_t * report);
+uint32_t fontsub_full_size(const lv_font_t * font);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,291 @@
+/**
+ * @file footprint.c
+ * Estimate what the project takes on the target: `lv_mem` per screen, flash of the images and the fonts
+ * and the draw buffer, shown in a status bar while the project is edited.
+ * The `lv_mem` cost of a widget type is measured once with the designer's own allocator: `FOOTPRINT_CALIB_CNT`
+ * default widgets are created off the screen and the used bytes (headers and size classes included) averaged.
+ * Their texts are added by their length, and a screen gets `1/FOOTPRINT_FRAG_DIV` more for the fragmentation:
+ * the TLSF allocator needs a free block of the next size class for a request. The designer is built with the
+ * `lv_conf.h` of the target for a close estimate; on a 64 bit host the pointers make it a bit pessimistic.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "footprint.h"
+#include "widgetreg.h"
+#include "screens.h"
+#include "imgasset.h"
+#include "fontsub.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FOOTPRINT_FONT_MAX      16      //Different fonts counted in the flash
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void calibrate(void);
+static uint32_t mem_used(void);
+static int32_t text_cost(const projsnap_node_t * n);
+static uint32_t alloc_cost(uint32_t size);
+static uint32_t flash_img_get(void);
+static void status_task(lv_task_t * task);
+static void size_print(char * buf, size_t size, uint32_t bytes);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint32_t type_cost[WIDGET_TYPE_NUM];     //[bytes] of `lv_mem` of a default widget
+static bool calibrated = false;
+static uint32_t budget_ram = 0;                 //0: no budget
+static uint32_t budget_flash = 0;
+static bool dirty = true;
+static bool over_budget = false;                //Shown and warned about already
+static lv_obj_t * status_label = NULL;
+static lv_style_t status_style;
+static lv_style_t status_style_warn;
+
+//The images change rarely, their conversion is remembered by their count
+static uint32_t img_cnt = UINT32_MAX;
+static uint32_t img_size = 0;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//The `lv_mem` and the flash of the target in bytes, a warning is shown above them. 0: no budget.
+void footprint_set_budget(uint32_t ram, uint32_t flash)
+{
+    budget_ram = ram;
+    budget_flash = flash;
+    dirty = true;
+}
+
+//A status bar at the bottom of `par` showing the estimate, refreshed after the edits
+void footprint_status_create(lv_obj_t * par)
+{
+    if(status_label != NULL) return;
+
+    lv_style_copy(&status_style, &lv_style_plain);
+    status_style.body.main_color = LV_COLOR_SILVER;
+    status_style.body.grad_color = LV_COLOR_SILVER;
+    status_style.body.padding.left = 4;
+    status_style.body.padding.right = 4;
+    status_style.body.padding.top = 1;
+    status_style.body.padding.bottom = 1;
+    status_style.text.color = LV_COLOR_BLACK;
+    lv_style_copy(&status_style_warn, &status_style);
+    status_style_warn.body.main_color = LV_COLOR_RED;
+    status_style_warn.body.grad_color = LV_COLOR_RED;
+    status_style_warn.text.color = LV_COLOR_WHITE;
+
+    status_label = lv_label_create(par, NULL);
+    lv_label_set_style(status_label, LV_LABEL_STYLE_MAIN, &status_style);
+    lv_label_set_body_draw(status_label, true);
+    lv_label_set_text(status_label, "");
+    lv_obj_set_click(status_label, false);
+
+    dirty = true;
+    lv_task_create(status_task, FOOTPRINT_PERIOD, LV_TASK_PRIO_LOW, NULL);
+}
+
+//The project changed, estimate it again at the next refresh
+void footprint_mark(void)
+{
+    dirty = true;
+}
+
+//Estimate the whole project. Runs on the GUI thread, the first call measures the widget types.
+bool footprint_estimate(footprint_t * fp)
+{
+    memset(fp, 0, sizeof(footprint_t));
+    if(!calibrated) calibrate();
+
+    projsnap_t snap;
+    if(!screens_snap_take(&snap)) return false;
+
+    //The display's screen and layers are there anyway
+    uint32_t base = type_cost[WIDGET_TYPE_OBJ] * 3;
+    const lv_font_t * fonts[FOOTPRINT_FONT_MAX];
+    uint32_t font_cnt = 0;
+    uint32_t scr_idx = 0;
+    uint32_t first;
+    uint32_t end;
+    for(first = 0; first < snap.cnt; first = end)
+    {
+        int32_t ram = 0;
+        for(end = first + 1; end < snap.cnt && snap.nodes[end].depth > 0; end++)
+        {
+            const projsnap_node_t * n = &snap.nodes[end];
+            ram += type_cost[n->type] + text_cost(n);
+
+            uint32_t f;
+            for(f = 0; f < font_cnt && fonts[f] != n->font; f++);
+            if(n->font != NULL && f == font_cnt && font_cnt < FOOTPRINT_FONT_MAX) fonts[font_cnt++] = n->font;
+        }
+        fp->widgets += end - first - 1;
+        if(ram < 0) ram = 0;
+        fp->ram_all += ram;
+        if(scr_idx == 0 || (uint32_t)ram > fp->ram)
+        {
+            fp->ram = ram;
+            fp->ram_screen = scr_idx;
+        }
+        scr_idx++;
+    }
+    projsnap_free(&snap);
+
+    fp->ram_frag = (fp->ram + base) / FOOTPRINT_FRAG_DIV;
+    fp->ram += base + fp->ram_frag;
+    fp->ram_all += base + fp->ram_all / FOOTPRINT_FRAG_DIV;
+
+    uint32_t f;
+    for(f = 0; f < font_cnt; f++) fp->flash_font += fontsub_full_size(fonts[f]);
+    fp->flash_img = flash_img_get();
+
+    //1 bit colours are stored in bytes too
+    uint8_t depth = imgasset_get_target().depth;
+    uint32_t px_size = depth >= 8 ? depth / 8 : 1;
+    fp->draw_buf = (uint32_t)LV_HOR_RES_MAX * (LV_VER_RES_MAX / FOOTPRINT_BUF_DIV) * px_size;
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Measure the `lv_mem` of default widgets of every type, created off the screen so nothing is redrawn
+static void calibrate(void)
+{
+    calibrated = true;
+    lv_obj_t * par = lv_obj_create(lv_disp_get_layer_sys(NULL), NULL);
+    if(par == NULL) return;
+    lv_obj_set_pos(par, -LV_HOR_RES_MAX * 4, -LV_VER_RES_MAX * 4);
+    lv_obj_set_hidden(par, true);
+
+    widget_type_t type;
+    for(type = 0; type < WIDGET_TYPE_NUM; type++)
+    {
+        const widget_desc_t * desc = widgetreg_get(type);
+        if(desc == NULL) continue;
+        uint32_t before = mem_used();
+        uint32_t i;
+        for(i = 0; i < FOOTPRINT_CALIB_CNT; i++)
+        {
+            if(desc->create_cb(par, NULL) == NULL) break;
+        }
+        if(i > 0) type_cost[type] = (mem_used() - before) / i;
+        lv_obj_clean(par);
+    }
+    lv_obj_del(par);
+}
+
+//Bytes of `lv_mem` taken, with the headers of the entries
+static uint32_t mem_used(void)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    return mon.total_size - mon.free_size;
+}
+
+//The text of a widget beyond the default one measured with its type
+static int32_t text_cost(const projsnap_node_t * n)
+{
+    if(n->text == NULL) return 0;
+    const widget_attr_desc_t * attr = widgetreg_text_attr(n->type);
+    const char * def = attr != NULL && attr->def_text != NULL ? attr->def_text : "";
+    return (int32_t)alloc_cost(strlen(n->text) + 1) - (int32_t)alloc_cost(strlen(def) + 1);
+}
+
+//An allocation of `size` bytes with its header, aligned as `lv_mem` does
+static uint32_t alloc_cost(uint32_t size)
+{
+    uint32_t align = sizeof(void *);
+    return ((size + align - 1) & ~(align - 1)) + sizeof(void *);
+}
+
+//The images as they are converted for the target, from the conversion cache if they are there
+static uint32_t flash_img_get(void)
+{
+    uint32_t cnt = imgasset_get_count();
+    if(cnt == img_cnt) return img_size;
+
+    img_cnt = cnt;
+    img_size = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        imgasset_t asset;
+        imgasset_data_t data;
+        if(!imgasset_get(i, &asset) || !imgasset_convert(&asset, &data)) continue;
+        img_size += data.data_size + sizeof(lv_img_dsc_t);
+        imgasset_data_free(&data);
+    }
+    return img_size;
+}
+
+static void status_task(lv_task_t * task)
+{
+    (void)task;
+    if(!dirty || status_label == NULL) return;
+    dirty = false;
+
+    footprint_t fp;
+    if(!footprint_estimate(&fp)) return;
+
+    char ram[16];
+    char ram_all[16];
+    char flash[16];
+    char buf_size[16];
+    char ram_budget[24] = "";
+    char flash_budget[24] = "";
+    size_print(ram, sizeof(ram), fp.ram);
+    size_print(ram_all, sizeof(ram_all), fp.ram_all);
+    size_print(flash, sizeof(flash), fp.flash_img + fp.flash_font);
+    size_print(buf_size, sizeof(buf_size), fp.draw_buf);
+    if(budget_ram > 0)
+    {
+        strcpy(ram_budget, " / ");
+        size_print(ram_budget + 3, sizeof(ram_budget) - 3, budget_ram);
+    }
+    if(budget_flash > 0)
+    {
+        strcpy(flash_budget, " / ");
+        size_print(flash_budget + 3, sizeof(flash_budget) - 3, budget_flash);
+    }
+
+    bool over = (budget_ram > 0 && fp.ram > budget_ram) ||
+                (budget_flash > 0 && fp.flash_img + fp.flash_font > budget_flash);
+    char txt[192];
+    snprintf(txt, sizeof(txt), "%s%u widgets   RAM %s%s (screen %u, all %s)   Flash %s%s   Draw buffer %s",
+             over ? LV_SYMBOL_WARNING " " : "", fp.widgets, ram, ram_budget, fp.ram_screen, ram_all,
+             flash, flash_budget, buf_size);
+    if(strcmp(txt, lv_label_get_text(status_label))) lv_label_set_text(status_label, txt);
+    if(over != over_budget)
+    {
+        lv_label_set_style(status_label, LV_LABEL_STYLE_MAIN, over ? &status_style_warn : &status_style);
+        if(over) printf("Footprint: the project doesn't fit into the budget: %s\n", txt);
+        over_budget = over;
+    }
+    lv_obj_align(status_label, NULL, LV_ALIGN_IN_BOTTOM_LEFT, 0, 0);
+}
+
+static void size_print(char * buf, size_t size, uint32_t bytes)
+{
+    if(bytes < 1024) snprintf(buf, size, "%u B", bytes);
+    else snprintf(buf, size, "%u.%u kB", bytes / 1024, (bytes % 1024) * 10 / 1024);
+}
@@ -0,0 +1,68 @@
+/**
+ * @file footprint.h
+ *
+ */
+
+#ifndef _FOOTPRINT_H_
+#define _FOOTPRINT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FOOTPRINT_PERIOD        500     //[ms] the status bar is refreshed this often if the project changed
+#define FOOTPRINT_CALIB_CNT     16      //Widgets of a type created to measure one, so the slab chunks average out
+#define FOOTPRINT_FRAG_DIV      16      //The TLSF of `lv_mem` rounds a request up to its 1/16 size class
+#define FOOTPRINT_BUF_DIV       10      //The draw buffer is this part of the screen, as LittlevGL suggests
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t widgets;
+    uint32_t ram;               //[bytes] of `lv_mem` the largest screen needs with the allocator's overhead
+    uint32_t ram_screen;        //Index of that screen
+    uint32_t ram_frag;          //[bytes] of it kept for the fragmentation
+    uint32_t ram_all;           //[bytes] of `lv_mem` if every screen is kept alive
+    uint32_t flash_img;         //[bytes] of the images converted to the target
+    uint32_t flash_font;        //[bytes] of the used built-in fonts
+    uint32_t draw_buf;          //[bytes] of a draw buffer of the target's colour depth
+}footprint_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void footprint_set_budget(uint32_t ram, uint32_t flash);
+void footprint_status_create(lv_obj_t * par);
+void footprint_mark(void);
+bool footprint_estimate(footprint_t * fp);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,505 @@
+/**
+ * @file frametime.c
+ * Estimate the frame time of the project's screens on a target from the drawing operations counted by `lv_prof`.
+ * A model gives the cost of a `design_cb` call and of every `LV_PROF_DRAW_...` operation on the target.
+ * `--bench-model` fits one with the scenes of the bench on the machine running it (so the bench built for the
+ * target calibrates the target), the text file can be edited too.
+ * Every screen is redrawn without a window: the whole screen, then the area of every widget alone, as an
+ * animation of that widget would redraw it in every frame. The operations are counted for each widget, the
+ * costliest ones are listed. The prediction is of one drawing thread, as most targets have.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frametime.h"
+#include "loadproj.h"
+#include "dataset.h"
+#include "./lvgl/src/lv_misc/lv_thread.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FRAMETIME_LINE_MAX      128
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+//A widget of the measured screen with the drawing of its `design_cb` calls (and of its internal children)
+typedef struct
+{
+    lv_obj_t * obj;
+    const char * id;
+    uint32_t calls;
+    uint32_t draw[LV_PROF_DRAW_NUM];
+    double us;                          //Predicted time of the above
+}frametime_widget_t;
+
+typedef struct
+{
+    frametime_widget_t * widgets;
+    uint32_t cnt;
+    uint32_t * hash;                    //Index + 1 of the widget of an object, 0: empty slot
+    uint32_t hash_mask;
+    uint32_t calls;                     //Of the frame
+}frametime_screen_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void flush_ready(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void design_measure(lv_obj_t * obj, uint32_t time, const uint32_t * draw);
+static bool screen_collect(frametime_screen_t * s, lv_obj_t * scr);
+static uint32_t screen_count(lv_obj_t * obj);
+static void screen_add(frametime_screen_t * s, lv_obj_t * obj);
+static frametime_widget_t * screen_find(frametime_screen_t * s, lv_obj_t * obj);
+static uint32_t ptr_hash(const void * p);
+static const lv_prof_frame_t * refr_measure(lv_disp_t * disp, lv_obj_t * obj);
+static void screen_estimate(lv_disp_t * disp, lv_obj_t * scr, const char * name, const frametime_model_t * model,
+                            uint32_t top);
+static int widget_cmp(const void * a, const void * b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * draw_names[LV_PROF_DRAW_NUM] =
+{
+    "fill", "blend", "aa", "glyph", "glyph_px", "img_true", "img_chroma", "img_alpha", "img_decode", "shadow",
+};
+
+static frametime_screen_t * screen_act;     //Measured by `design_measure`
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Read a model written by `frametime_model_save`: `<key> <value>` lines, `#` comments, the missing costs are 0
+bool frametime_model_load(const char * path, frametime_model_t * model)
+{
+    memset(model, 0, sizeof(frametime_model_t));
+    FILE * fp = fopen(path, "r");
+    if(!fp)
+    {
+        printf("Can't open the model %s\n", path);
+        return false;
+    }
+
+    strcpy(model->name, "target");
+    char line[FRAMETIME_LINE_MAX];
+    uint32_t line_no = 0;
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        line_no++;
+        char key[FRAMETIME_NAME_MAX];
+        char val[FRAMETIME_NAME_MAX];
+        if(line[0] == '#' || sscanf(line, "%31s %31s", key, val) != 2) continue;
+
+        if(!strcmp(key, "name"))
+        {
+            strcpy(model->name, val);
+            continue;
+        }
+        double v = strtod(val, NULL);
+        if(!strcmp(key, "call_us")) model->call_us = v;
+        else if(!strcmp(key, "flush_px_ns")) model->flush_px_ns = v;
+        else
+        {
+            uint8_t d;
+            for(d = 0; d < LV_PROF_DRAW_NUM; d++)
+            {
+                size_t len = strlen(draw_names[d]);
+                if(!strncmp(key, draw_names[d], len) && !strcmp(key + len, "_ns")) break;
+            }
+            if(d < LV_PROF_DRAW_NUM) model->ns[d] = v;
+            else printf("%s:%u: unknown cost \"%s\"\n", path, line_no, key);
+        }
+    }
+    fclose(fp);
+    return true;
+}
+
+bool frametime_model_save(const char * path, const frametime_model_t * model)
+{
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "# Frame time model of lv_gui_designer (--frametime), the cost of the drawing operations\n");
+    fprintf(fp, "name %s\n", model->name);
+    fprintf(fp, "call_us %.4f\n", model->call_us);
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++) fprintf(fp, "%s_ns %.4f\n", draw_names[d], model->ns[d]);
+    fprintf(fp, "# Sending a pixel to the display (e.g. 16 bits on a 40 MHz SPI: 400), not measured by the bench\n");
+    fprintf(fp, "flush_px_ns %.4f\n", model->flush_px_ns);
+
+    bool ok = !ferror(fp);
+    if(fclose(fp) != 0) ok = false;
+    if(!ok) printf("Can't write %s\n", path);
+    return ok;
+}
+
+//The average of the frames stored by `lv_prof`. false: there are none.
+bool frametime_sample_from_prof(frametime_sample_t * sample)
+{
+    memset(sample, 0, sizeof(frametime_sample_t));
+    uint16_t cnt = lv_prof_get_frame_cnt();
+    if(cnt == 0) return false;
+
+    uint16_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        const lv_prof_frame_t * f = lv_prof_get_frame(i);
+        sample->draw_us += f->draw_time;
+        uint8_t t;
+        for(t = 0; t < f->type_cnt; t++) sample->calls += f->types[t].cnt;
+        uint8_t d;
+        for(d = 0; d < LV_PROF_DRAW_NUM; d++) sample->draw[d] += f->draw[d];
+    }
+
+    sample->draw_us /= cnt;
+    sample->calls /= cnt;
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++) sample->draw[d] /= cnt;
+    return true;
+}
+
+//Non-negative least squares of the relative errors by coordinate descent, so every sample counts the same.
+//The costs of the operations missing from all the samples stay 0.
+void frametime_fit(const frametime_sample_t * samples, uint32_t cnt, frametime_model_t * model)
+{
+    //x[0]: call_us, x[1 + d]: the cost of `d` in us
+    double x[1 + LV_PROF_DRAW_NUM];
+    memset(x, 0, sizeof(x));
+
+    uint32_t iter;
+    for(iter = 0; iter < FRAMETIME_FIT_ITER; iter++)
+    {
+        uint8_t k;
+        for(k = 0; k < 1 + LV_PROF_DRAW_NUM; k++)
+        {
+            double num = 0;
+            double den = 0;
+            uint32_t i;
+            for(i = 0; i < cnt; i++)
+            {
+                const frametime_sample_t * s = &samples[i];
+                if(s->draw_us <= 0) continue;
+                double w = 1.0 / (s->draw_us * s->draw_us);
+                double a_k = k == 0 ? s->calls : s->draw[k - 1];
+                if(a_k == 0) continue;
+                double pred = x[0] * s->calls;
+                uint8_t d;
+                for(d = 0; d < LV_PROF_DRAW_NUM; d++) pred += x[1 + d] * s->draw[d];
+                num += w * a_k * (s->draw_us - pred);
+                den += w * a_k * a_k;
+            }
+            if(den > 0)
+            {
+                x[k] += num / den;
+                if(x[k] < 0) x[k] = 0;
+            }
+        }
+    }
+
+    model->call_us = x[0];
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++) model->ns[d] = x[1 + d] * 1000.0;
+}
+
+//[us] of drawing the operations and sending `px` pixels
+double frametime_predict(const frametime_model_t * model, const uint32_t * draw, uint32_t calls, uint32_t px)
+{
+    double ns = model->flush_px_ns * px;
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++) ns += model->ns[d] * draw[d];
+    return model->call_us * calls + ns / 1000.0;
+}
+
+//Load the project on an in-memory display and print the predicted frame times of its screens.
+//Call it after `lv_init` instead of creating the GUI.
+bool frametime_run(const char * model_path, uint32_t top)
+{
+    frametime_model_t model;
+    if(!frametime_model_load(model_path, &model)) return false;
+
+    uint32_t buf_px = (uint32_t)LV_HOR_RES_MAX * FRAMETIME_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    if(buf == NULL)
+    {
+        printf("Frame time estimate failed, out of memory\n");
+        return false;
+    }
+
+    lv_disp_buf_t disp_buf;
+    lv_disp_buf_init(&disp_buf, buf, NULL, buf_px);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = LV_HOR_RES_MAX;
+    disp_drv.ver_res = LV_VER_RES_MAX;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = flush_ready;
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    bool prof_en = lv_prof_get_en();
+    lv_prof_set_en(true);
+    lv_prof_set_design_cb(design_measure);
+
+    bool res = false;
+    load_project(lv_disp_get_scr_act(disp));
+
+    //The top level widget is the designer's TFT Simulator, its children are the screens
+    lv_obj_t * root = lv_obj_get_child_back(lv_disp_get_scr_act(disp), NULL);
+    if(root == NULL)
+    {
+        printf("Nothing to estimate\n");
+    }else
+    {
+        lv_obj_set_pos(root, 0, 0);
+        printf("Frame times on %s, %d x %d, one drawing thread\n", model.name, LV_HOR_RES_MAX, LV_VER_RES_MAX);
+
+        lv_obj_t * scr;
+        uint32_t scr_i = 0;
+        for(scr = lv_obj_get_child_back(root, NULL); scr != NULL; scr = lv_obj_get_child_back(root, scr))
+        {
+            //Only this screen is shown, even if the project hides it
+            lv_obj_t * other;
+            for(other = lv_obj_get_child_back(root, NULL); other != NULL; other = lv_obj_get_child_back(root, other))
+            {
+                lv_obj_set_hidden(other, other != scr);
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "screen_%u", scr_i++);
+            screen_estimate(disp, scr, name, &model, top);
+        }
+        res = true;
+    }
+
+    lv_prof_set_design_cb(NULL);
+    lv_prof_set_en(prof_en);
+    lv_prof_clean();
+
+    //Nothing may point to the buffer on the stack
+    lv_obj_del(lv_disp_get_scr_act(disp));
+    lv_obj_del(lv_disp_get_layer_top(disp));
+    lv_obj_del(lv_disp_get_layer_sys(disp));
+    lv_disp_remove(disp);
+    free(buf);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void flush_ready(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+//`design_cb` of `lv_prof`, runs on the drawing threads
+static void design_measure(lv_obj_t * obj, uint32_t time, const uint32_t * draw)
+{
+    (void)time;
+    if(screen_act == NULL) return;
+
+    lv_thread_lock();
+    screen_act->calls++;
+    frametime_widget_t * w = screen_find(screen_act, obj);
+    if(w != NULL)
+    {
+        w->calls++;
+        uint8_t d;
+        for(d = 0; d < LV_PROF_DRAW_NUM; d++) w->draw[d] += draw[d];
+    }
+    lv_thread_unlock();
+}
+
+//The widgets of the project on `scr` (with itself) and a hash table to find them by their objects
+static bool screen_collect(frametime_screen_t * s, lv_obj_t * scr)
+{
+    memset(s, 0, sizeof(frametime_screen_t));
+    uint32_t cnt = screen_count(scr);
+    uint32_t size = 16;
+    while(size < cnt * 2) size *= 2;
+
+    s->widgets = calloc(cnt > 0 ? cnt : 1, sizeof(frametime_widget_t));
+    s->hash = calloc(size, sizeof(uint32_t));
+    if(s->widgets == NULL || s->hash == NULL)
+    {
+        free(s->widgets);
+        free(s->hash);
+        return false;
+    }
+    s->hash_mask = size - 1;
+    screen_add(s, scr);
+    return true;
+}
+
+static uint32_t screen_count(lv_obj_t * obj)
+{
+    uint32_t cnt = widget_get_info(obj) != NULL ? 1 : 0;
+    lv_obj_t * child;
+    for(child = lv_obj_get_child_back(obj, NULL); child != NULL; child = lv_obj_get_child_back(obj, child))
+    {
+        cnt += screen_count(child);
+    }
+    return cnt;
+}
+
+static void screen_add(frametime_screen_t * s, lv_obj_t * obj)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info != NULL)
+    {
+        frametime_widget_t * w = &s->widgets[s->cnt];
+        w->obj = obj;
+        w->id = info->id[0] != '\0' ? info->id : NULL;
+        uint32_t h = ptr_hash(obj) & s->hash_mask;
+        while(s->hash[h] != 0) h = (h + 1) & s->hash_mask;
+        s->hash[h] = ++s->cnt;
+    }
+
+    lv_obj_t * child;
+    for(child = lv_obj_get_child_back(obj, NULL); child != NULL; child = lv_obj_get_child_back(obj, child))
+    {
+        screen_add(s, child);
+    }
+}
+
+//The widget of an object: itself or the nearest ancestor in the project (e.g. of the scrollable of a page)
+static frametime_widget_t * screen_find(frametime_screen_t * s, lv_obj_t * obj)
+{
+    for(; obj != NULL; obj = lv_obj_get_parent(obj))
+    {
+        uint32_t h = ptr_hash(obj) & s->hash_mask;
+        while(s->hash[h] != 0)
+        {
+            frametime_widget_t * w = &s->widgets[s->hash[h] - 1];
+            if(w->obj == obj) return w;
+            h = (h + 1) & s->hash_mask;
+        }
+    }
+    return NULL;
+}
+
+static uint32_t ptr_hash(const void * p)
+{
+    uintptr_t v = (uintptr_t)p;
+    return (uint32_t)((v >> 4) ^ (v >> 20)) * 2654435761u;
+}
+
+//Redraw the area of `obj`, the new frame of `lv_prof` or NULL if nothing was drawn
+static const lv_prof_frame_t * refr_measure(lv_disp_t * disp, lv_obj_t * obj)
+{
+    lv_prof_clean();
+    screen_act->calls = 0;
+    lv_obj_invalidate(obj);
+    lv_refr_now(disp);
+    uint16_t cnt = lv_prof_get_frame_cnt();
+    return cnt > 0 ? lv_prof_get_frame(cnt - 1) : NULL;
+}
+
+static void screen_estimate(lv_disp_t * disp, lv_obj_t * scr, const char * name, const frametime_model_t * model,
+                            uint32_t top)
+{
+    frametime_screen_t s;
+    if(!screen_collect(&s, scr))
+    {
+        printf("%s: out of memory\n", name);
+        return;
+    }
+    widget_info_t * info = widget_get_info(scr);
+    if(info != NULL && info->id[0] != '\0') name = info->id;
+
+    //Once to fill the image and the glyph caches, then measured as the target redraws it in a screen load
+    screen_act = &s;
+    lv_obj_invalidate(scr);
+    lv_refr_now(disp);
+    uint32_t i;
+    for(i = 0; i < s.cnt; i++)
+    {
+        s.widgets[i].calls = 0;
+        memset(s.widgets[i].draw, 0, sizeof(s.widgets[i].draw));
+    }
+
+    const lv_prof_frame_t * f = refr_measure(disp, scr);
+    if(f == NULL)
+    {
+        printf("%s: not drawn (out of the screen)\n", name);
+        screen_act = NULL;
+        free(s.widgets);
+        free(s.hash);
+        return;
+    }
+    double full_us = frametime_predict(model, f->draw, s.calls, f->px_num);
+    printf("%s: full redraw %.2f ms (%u design calls, %u px)\n", name, full_us / 1000.0, s.calls, f->px_num);
+
+    for(i = 0; i < s.cnt; i++)
+    {
+        frametime_widget_t * w = &s.widgets[i];
+        w->us = frametime_predict(model, w->draw, w->calls, 0);
+    }
+
+    //The costliest ones. Sorted in a copy, the hash table points into `widgets`.
+    frametime_widget_t * sorted = malloc(s.cnt * sizeof(frametime_widget_t));
+    if(sorted != NULL && s.cnt > 0)
+    {
+        memcpy(sorted, s.widgets, s.cnt * sizeof(frametime_widget_t));
+        qsort(sorted, s.cnt, sizeof(frametime_widget_t), widget_cmp);
+        for(i = 0; i < s.cnt && i < top && sorted[i].us > 0; i++)
+        {
+            printf("    %-20s %8.2f ms %5.1f%%\n", sorted[i].id != NULL ? sorted[i].id : "(no ID)",
+                   sorted[i].us / 1000.0, full_us > 0 ? sorted[i].us * 100.0 / full_us : 0);
+        }
+    }
+    free(sorted);
+
+    //An animated widget redraws its area (with everything below and above it) in every frame
+    const char * anim_id = NULL;
+    double anim_us = -1;
+    uint32_t anim_px = 0;
+    for(i = 0; i < s.cnt; i++)
+    {
+        if(s.widgets[i].obj == scr) continue;
+        f = refr_measure(disp, s.widgets[i].obj);
+        if(f == NULL) continue;
+        double us = frametime_predict(model, f->draw, s.calls, f->px_num);
+        if(us > anim_us)
+        {
+            anim_us = us;
+            anim_id = s.widgets[i].id != NULL ? s.widgets[i].id : "(no ID)";
+            anim_px = f->px_num;
+        }
+    }
+    if(anim_id != NULL)
+    {
+        printf("    animating one widget: at most %.2f ms per frame (%s, %u px)\n", anim_us / 1000.0, anim_id, anim_px);
+    }
+
+    screen_act = NULL;
+    free(s.widgets);
+    free(s.hash);
+}
+
+//By the predicted time, the largest first
+static int widget_cmp(const void * a, const void * b)
+{
+    double ua = ((const frametime_widget_t *)a)->us;
+    double ub = ((const frametime_widget_t *)b)->us;
+    return (ua < ub) - (ua > ub);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file frametime.h
+ *
+ */
+
+#ifndef _FRAMETIME_H_
+#define _FRAMETIME_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FRAMETIME_NAME_MAX      32
+#define FRAMETIME_BUF_LINES     40      //The display buffer is this many lines of the screen, as in the bench
+#define FRAMETIME_TOP_DEF       5       //Costliest widgets listed per screen
+#define FRAMETIME_FIT_ITER      2000    //Rounds of the least squares fitting
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+//The cost of the drawing operations on a target
+typedef struct
+{
+    char name[FRAMETIME_NAME_MAX];
+    double call_us;                     //[us] of a `design_cb` call beside its drawing
+    double ns[LV_PROF_DRAW_NUM];        //[ns] of one of the `LV_PROF_DRAW_...` operations
+    double flush_px_ns;                 //[ns] of sending a pixel to the display, not measured by the bench
+}frametime_model_t;
+
+//One measured frame of the bench: the drawing operations and the time they took
+typedef struct
+{
+    double draw_us;                     //In the design functions, summed on all drawing threads
+    double calls;                       //`design_cb` calls
+    double draw[LV_PROF_DRAW_NUM];
+}frametime_sample_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool frametime_model_load(const char * path, frametime_model_t * model);
+bool frametime_model_save(const char * path, const frametime_model_t * model);
+bool frametime_sample_from_prof(frametime_sample_t * sample);
+void frametime_fit(const frametime_sample_t * samples, uint32_t cnt, frametime_model_t * model);
+double frametime_predict(const frametime_model_t * model, const uint32_t * draw, uint32_t calls, uint32_t px);
+bool frametime_run(const char * model_path, uint32_t top);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
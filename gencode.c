@@ -8,34 +8,335 @@
  *********************/
 #include "gencode.h"
 #include "dataset.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "projjob.h"
+#include "imgasset.h"
+#include "fontsub.h"
+#include "ttfont.h"
+#include "screens.h"
+#include "uiblob.h"
+#include "loadproj.h"
+#include "heapsim.h"
+#include "bake.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 /*********************
  *      DEFINES
  *********************/
 #define bool2str(x) x==0?"false":"true"
+#define STYLE_TEXT_MAX      1024    //An initializer of `lv_style_t`
+#define LV_GUI_STYLE_NONE   0xFFFF
+#define STYLE_NAME_MAX      40
+#define OUT_PATH_MAX        (PROJSNAP_ID_MAX + 32)
+#define OUT_DIR_MAX         256     //Longer output directories can't be used
+#define IMG_BYTES_PER_LINE  16
+#define PY_ROW_SCR          0xFFFFFFFF      //A screen has no row in the MicroPython table
+#define PY_FONT_MAX         8
+#define TPL_NODES_MIN       2       //Smaller subtrees are written expanded, a call wouldn't be shorter
+#define TPL_NONE            (-1)
+#define TPL_HASH_INIT       14695981039346656037ULL
+#define GEN_THREADS         4       //Screens rendered at the same time, the calling thread included
+#define HEAP_ROUNDS         3       //Times the simulated target switches through all the screens
+#define HEAP_DISP_OBJS      3       //The screen and the layers of the display are in `lv_mem` anyway
 
 /**********************
  *      TYPEDEFS
  **********************/
-extern const char * widget_type_name[];
 extern lv_obj_t * tft_win;
+//Mirrors `lv_gui_desc_t` of the table driven output, to report its size
+typedef struct
+{
+    uint16_t parent;
+    uint8_t type;
+    lv_coord_t x, y, w, h;
+}gencode_row_t;
+
+typedef struct
+{
+    uint16_t parent;
+    uint8_t type;
+    lv_coord_t x, y, w, h;
+    uint16_t style;
+}gencode_row_style_t;
+
+//The unique styles of a snapshot, the customized ones of the widgets then the ones of the flattened theme
+typedef struct
+{
+    uint32_t * hashes;
+    char ** texts;              //Initializers, the key of the deduplication
+    char (* names)[STYLE_NAME_MAX];     //Named by the hash, so a style keeps its name while others come and go
+    uint32_t cnt;
+    uint32_t node_cnt;          //The first ones, used by the widgets as their main style
+    uint32_t * node_style;      //Per node of the snapshot: index in `texts` or PROJSNAP_NO_STYLE
+    int32_t * style_idx;        //Scratch of the table writer: index in its `lv_gui_style_tbl` or -1
+    //Per used type: the index of the style of its `theme_styles` in the pool, PROJSNAP_NO_STYLE: not flattened
+    uint32_t theme_style[WIDGET_TYPE_NUM][WIDGETREG_THEME_MAX];
+    uint32_t scr_style;         //Of the screens, PROJSNAP_NO_STYLE: the theme isn't flattened
+    uint32_t theme_ram;         //[bytes] of the unique styles the theme's init builds
+}style_pool_t;
+
+//The converted images, in the order of the list
+typedef struct
+{
+    imgasset_t * assets;
+    imgasset_data_t * data;
+    uint32_t cnt;
+}img_pool_t;
+
+//The letters of the project per font, for the subsets
+typedef struct
+{
+    fontsub_letters_t * sets;
+    uint32_t cnt;
+}font_pool_t;
+
+typedef struct
+{
+    FILE * fp;                  //Writes into `buf`
+    char * buf;
+    size_t len;
+}gencode_out_t;
+
+//The screens of a multi-screen project, rendered into their own buffer by the generator threads
+typedef struct
+{
+    const projsnap_t * snap;
+    const style_pool_t * pool;
+    uint32_t * first;           //Per screen: its root, after the last one `snap->cnt`
+    gencode_out_t * outs;       //Per screen, NULL `fp`: it couldn't be rendered
+    uint32_t cnt;
+    uint32_t next;              //Atomic, the threads take the next screen until all are taken
+    uint32_t done;              //Atomic, nodes rendered
+}screen_pool_t;
+
+typedef struct
+{
+    uint64_t hash;
+    uint32_t node;
+}tpl_cand_t;
+
+//The repeated subtrees of a range of the snapshot, written once as a template builder and called per instance
+typedef struct
+{
+    uint32_t first;
+    uint32_t * end;             //Per node of the range: the end of its subtree
+    uint64_t * hash;            //Per node: of its subtree without its own position and ID
+    int32_t * tpl;              //Per node: index of the template it's an instance of, TPL_NONE: written expanded
+    uint32_t * rep;             //Per template: its first instance, the builder is written from it
+    uint32_t * cnt;             //Per template: its instances
+    uint32_t tpl_cnt;
+}tpl_set_t;
+
+//A file written by the generator, to find the unchanged ones without reading them
+typedef struct
+{
+    char path[OUT_PATH_MAX];
+    uint32_t hash;
+    off_t size;                 //-1: unknown
+    time_t mtime;
+    bool produced;              //By the current generation
+}out_cache_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static inline void code_header_write(FILE * lv_gui_h_fp);
+static bool generate(const projsnap_t * snap, const projsnap_t * proj, projsnap_step_cb_t step_cb);
+static bool bake_snap_build(projsnap_t * dst, const projsnap_t * snap);
+static void bake_report(const projsnap_t * proj);
+static inline void code_header_write(FILE * lv_gui_h_fp, const projsnap_t * snap, const img_pool_t * imgs,
+                                     gencode_mode_t mode);
+static bool conf_header_write(const projsnap_t * snap, const img_pool_t * imgs, const font_pool_t * fonts, bool flat);
+static void conf_mark(bool * used, const char * macros);
+static bool images_write(const img_pool_t * imgs, const projsnap_t * proj);
+static void image_write(FILE * fp, const char * name, const imgasset_data_t * d);
+static bool img_pool_build(img_pool_t * pool);
+static void img_pool_free(img_pool_t * pool);
+static bool fonts_write(const font_pool_t * fonts);
+static bool font_pool_build(font_pool_t * pool, const projsnap_t * snap);
+static void font_pool_free(font_pool_t * pool);
+static bool blobs_write(const projsnap_t * snap);
 
 
-static inline void code_source_write(FILE * lv_gui_c_fp);
-static inline void code_source_head_write(FILE * lv_gui_c_fp);
-static void code_source_body_write(FILE * lv_gui_c_fp);
+static bool sources_write(const projsnap_t * snap, style_pool_t * pool, gencode_mode_t mode, bool dry,
+                          uint32_t * size, projsnap_step_cb_t step_cb);
+static void code_source_body_write(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                   uint32_t first, uint32_t end, const char * fn, projsnap_step_cb_t step_cb);
+static void code_source_table_write(FILE * lv_gui_c_fp, const projsnap_t * snap, style_pool_t * pool,
+                                    uint32_t first, uint32_t end, const char * part, projsnap_step_cb_t step_cb);
+static void table_rows_write(FILE * lv_gui_c_fp, const projsnap_t * snap, uint32_t first, uint32_t from, uint32_t to,
+                             uint32_t end, const char * obj_name);
+static bool screens_sources_write(const projsnap_t * snap, const style_pool_t * pool, bool dry, uint32_t * size,
+                                  projsnap_step_cb_t step_cb);
+static void code_source_screen_write(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                     uint32_t first, uint32_t end, uint32_t idx, projsnap_step_cb_t step_cb);
+static bool screens_render(screen_pool_t * sp, const projsnap_t * snap, const style_pool_t * pool,
+                           projsnap_step_cb_t step_cb);
+static void * screen_worker(void * param);
+static void screen_render(screen_pool_t * sp, uint32_t idx);
 
-static void src_write_obj_create(lv_obj_t * obj, FILE * lv_gui_c_fp);
+static void src_write_obj_create(const projsnap_t * snap, uint32_t i, const char * scr, FILE * lv_gui_c_fp);
+static const char * src_par_name(const projsnap_t * snap, uint32_t i, const char * scr);
+static void src_write_obj_attr(const style_pool_t * pool, const projsnap_node_t * n, const char * name, const char * pos,
+                               const char * style, FILE * lv_gui_c_fp);
+static uint32_t src_write_obj_or_instance(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls,
+                                          uint32_t i, const char * scr, FILE * lv_gui_c_fp);
+static void src_write_range(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls, uint32_t first,
+                            uint32_t end, const char * scr, FILE * lv_gui_c_fp, projsnap_step_cb_t step_cb);
+static void src_write_lazy_builders(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls,
+                                    uint32_t first, uint32_t end, FILE * lv_gui_c_fp);
+static bool src_lazy_written(const projsnap_t * snap, const tpl_set_t * tpls, uint32_t i);
+static void src_write_set_lazy(FILE * lv_gui_c_fp, const projsnap_node_t * n, const char * name);
+static uint32_t lazy_end_get(const projsnap_t * snap, uint32_t i);
+static bool tpl_set_build(tpl_set_t * set, const projsnap_t * snap, const style_pool_t * pool, uint32_t first, uint32_t end);
+static void tpl_set_free(tpl_set_t * set);
+static uint64_t tpl_node_hash(const projsnap_t * snap, const style_pool_t * pool, uint32_t i);
+static uint64_t tpl_hash_add(uint64_t h, const void * data, size_t len);
+static int tpl_cand_cmp(const void * a, const void * b);
+static bool tpl_subtree_equal(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * set,
+                              uint32_t a, uint32_t b);
+static void tpl_write_builders(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                               const tpl_set_t * set);
+static uint32_t src_write_obj_props(const projsnap_node_t * n, const char * name, FILE * lv_gui_c_fp);
+static void src_write_setter(FILE * lv_gui_c_fp, const char * code, const char * name, int32_t value, const char * text,
+                             bool ident);
+static bool src_write_style_decl(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                 uint32_t first, uint32_t end);
+static bool src_write_img_decl(FILE * lv_gui_c_fp, const projsnap_t * snap, uint32_t first, uint32_t end);
+static void src_write_theme_fns(FILE * lv_gui_c_fp, const style_pool_t * pool, bool shared);
+static void src_write_scr_theme(FILE * lv_gui_c_fp, const style_pool_t * pool, const char * scr);
+static bool theme_has(const style_pool_t * pool, widget_type_t type);
+static void theme_fn_name(char * buf, size_t size, widget_type_t type);
+static gencode_mode_t mode_get(const projsnap_t * snap, gencode_mode_t mode);
+static bool py_source_write(const projsnap_t * snap, const style_pool_t * pool, uint32_t * size);
+static void py_write_styles(FILE * fp, const projsnap_t * snap, const style_pool_t * pool);
+static bool py_write_props(FILE * fp, const projsnap_t * snap, const uint32_t * row);
+static int32_t py_setter_idx(const widget_attr_desc_t *** setters, uint32_t * cnt, const widget_attr_desc_t * attr);
+static void py_write_prop(FILE * fp, uint32_t row, int32_t setter, int32_t value, const char * text);
+static void py_write_str(FILE * fp, const char * text);
+static void py_write_template(FILE * fp, const char * code);
+
+static bool style_pool_build(style_pool_t * pool, const projsnap_t * snap);
+static uint32_t style_pool_add(style_pool_t * pool, const char * buf);
+static bool style_pool_add_theme(style_pool_t * pool, const projsnap_t * snap, const lv_theme_t * th);
+static void style_pool_free(style_pool_t * pool);
+static void style_init_write(char * buf, const lv_style_t * style);
+static const char * style_font_name(const lv_font_t * font);
+static uint32_t hash_get(const char * data, size_t len);
+
+static bool out_begin(gencode_out_t * out);
+static bool out_end(gencode_out_t * out, const char * path, bool dry, uint32_t * size);
+static bool out_commit(const char * name, const char * buf, size_t len);
+static bool out_file_equal(const char * path, const char * buf, size_t len);
+static out_cache_t * out_cache_get(const char * path);
+static void out_cache_clean(void);
+static bool out_append(gencode_out_t * dst, gencode_out_t * src);
+static void out_discard(gencode_out_t * out);
+static const char * out_path_get(char * buf, const char * path);
+static void heap_simulate(const projsnap_t * snap, bool gen_order, gencode_heap_t * res);
+static void heap_screen_create(heapsim_t * sim, heapsim_widget_t * ws, const projsnap_t * snap, uint32_t first,
+                               uint32_t end, bool gen_order);
+static void heap_text_set(heapsim_t * sim, heapsim_widget_t * w, const projsnap_node_t * n, bool gen_order);
+static void heap_print(const char * name, const gencode_heap_t * heap, bool switches);
 /**********************
  *  STATIC VARIABLES
  **********************/
 const char gui_main_name[] = "lv_gui_main";
+static gencode_mode_t gen_mode = GENCODE_TABLE;
+static bool gen_split = false;
+static bool gen_font_subset = false;
+static const char * gen_font_chars = NULL;
+static bool gen_font_compress = false;
+static bool gen_blob = false;
+static bool gen_python = false;
+static bool gen_templates = true;
+static bool gen_lazy = false;
+static bool gen_lazy_release = false;
+static out_cache_t * out_cache = NULL;      //Used only by the generator, one runs at a time
+static uint32_t out_cache_cnt = 0;
+static gencode_report_t last_report;
+static const char * mode_names[] = {"straight-line", "table driven"};
+static int32_t gen_theme = -1;              //Index in `conf_themes`, -1: the built-in styles only
+static uint16_t gen_theme_hue = 0;
+static bool gen_theme_flat = true;          //Write the theme's styles as const data instead of initializing it
+static const char * gen_out_dir = NULL;     //NULL: the working directory
+static uint32_t gen_heap_size = HEAPSIM_SIZE_DEF;
+
+//Every widget of lv_conf.h, `lv_gui_conf.h` turns off the ones the project doesn't need
+static const char * conf_widgets[] = {
+    "LV_USE_ARC", "LV_USE_BAR", "LV_USE_BTN", "LV_USE_BTNM", "LV_USE_CALENDAR", "LV_USE_CANVAS", "LV_USE_CB",
+    "LV_USE_CHART", "LV_USE_CONT", "LV_USE_DDLIST", "LV_USE_GAUGE", "LV_USE_IMG", "LV_USE_IMGBTN", "LV_USE_KB",
+    "LV_USE_LABEL", "LV_USE_LED", "LV_USE_LINE", "LV_USE_LIST", "LV_USE_LMETER", "LV_USE_MBOX", "LV_USE_PAGE",
+    "LV_USE_PRELOAD", "LV_USE_ROLLER", "LV_USE_SLIDER", "LV_USE_SPINBOX", "LV_USE_SW", "LV_USE_TA", "LV_USE_TABLE",
+    "LV_USE_TABVIEW", "LV_USE_TILEVIEW", "LV_USE_WIN",
+};
+#define CONF_WIDGET_NUM     (sizeof(conf_widgets) / sizeof(conf_widgets[0]))
+
+static const char * conf_themes[][2] = {
+    {"templ", "TEMPL"}, {"default", "DEFAULT"}, {"alien", "ALIEN"}, {"night", "NIGHT"},
+    {"mono", "MONO"}, {"material", "MATERIAL"}, {"zen", "ZEN"}, {"nemo", "NEMO"},
+};
+#define CONF_THEME_NUM      (sizeof(conf_themes) / sizeof(conf_themes[0]))
+
+//In the order of `conf_themes`. NULL: not built into the designer, the target initializes it then.
+static lv_theme_t * (* const conf_theme_inits[])(uint16_t hue, lv_font_t * font) = {
+#if LV_USE_THEME_TEMPL
+    lv_theme_templ_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_DEFAULT
+    lv_theme_default_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_ALIEN
+    lv_theme_alien_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_NIGHT
+    lv_theme_night_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_MONO
+    lv_theme_mono_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_MATERIAL
+    lv_theme_material_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_ZEN
+    lv_theme_zen_init,
+#else
+    NULL,
+#endif
+#if LV_USE_THEME_NEMO
+    lv_theme_nemo_init,
+#else
+    NULL,
+#endif
+};
+
+static const char * conf_fonts[][2] = {
+    {"LV_FONT_ROBOTO_12", "lv_font_roboto_12"},
+    {"LV_FONT_ROBOTO_16", "lv_font_roboto_16"},
+    {"LV_FONT_ROBOTO_22", "lv_font_roboto_22"},
+    {"LV_FONT_ROBOTO_28", "lv_font_roboto_28"},
+    {"LV_FONT_UNSCII_8", "lv_font_unscii_8"},
+};
+#define CONF_FONT_NUM       (sizeof(conf_fonts) / sizeof(conf_fonts[0]))
 // const static char lv_obj_src_templ[][60] = {
 //     "lv_obj_create(%s, %s);\n",
 //     "lv_obj_set_x(%s, %s);\n",
@@ -58,77 +359,2703 @@ const char gui_main_name[] = "lv_gui_main";
  **********************/
 void code_generation(void)
 {
-    
-    FILE * lv_gui_h_fp = fopen("lv_gui.h", "w");
-    if (lv_gui_h_fp == NULL)
+    projsnap_t snap;
+    if(!screens_snap_take(&snap)) return;
+    bake_capture(&snap);
+    code_generation_snap(&snap, NULL);
+    projsnap_free(&snap);
+}
+
+//Doesn't touch the widgets, so it can run on any thread
+bool code_generation_snap(const projsnap_t * snap, projsnap_step_cb_t step_cb)
+{
+    if(snap->bake_cnt == 0) return generate(snap, snap, step_cb);
+
+    projsnap_t baked;
+    if(!bake_snap_build(&baked, snap)) return false;
+    bool res = generate(&baked, snap, step_cb);
+    projsnap_free(&baked);
+    return res;
+}
+
+//Generate the code of an XML project file without the widgets, lv_init() and a display, e.g. in a build
+bool code_generation_file(const char * xml_path)
+{
+    projsnap_t snap;
+    if(!load_project_snap(&snap, xml_path))
     {
-        fclose(lv_gui_h_fp);
-        return;
-    }    
-    code_header_write(lv_gui_h_fp);
-    fclose(lv_gui_h_fp);
-    
-    FILE * lv_gui_c_fp = fopen("lv_gui.c", "w");
-    if (lv_gui_c_fp == NULL)
-    {
-        fclose(lv_gui_c_fp);
-        return;
-    }    
-    code_source_write(lv_gui_c_fp);
-    fclose(lv_gui_c_fp);
-    
+        printf("Can't read the project %s\n", xml_path);
+        return false;
+    }
+    //A flattened theme is built from the built-in styles
+    lv_style_init();
+    if(bake_get_count() > 0) printf("Only the designer can draw the subtrees to bake, they are generated as widgets\n");
+    bool res = code_generation_snap(&snap, NULL);
+    projsnap_free(&snap);
+    return res;
+}
+
+void gencode_set_mode(gencode_mode_t mode)
+{
+    if(mode < _GENCODE_MODE_NUM) gen_mode = mode;
+}
+
+gencode_mode_t gencode_get_mode(void)
+{
+    return gen_mode;
+}
+
+//Write every screen (a top-level widget of the screen) into an own file, so a build recompiles only the changed ones
+void gencode_set_split(bool split)
+{
+    gen_split = split;
+}
+
+bool gencode_get_split(void)
+{
+    return gen_split;
+}
+
+//Write the used built-in fonts with only the glyphs of the project's texts, into `lv_gui_font_<font>.c`
+void gencode_set_font_subset(bool subset)
+{
+    gen_font_subset = subset;
+}
+
+bool gencode_get_font_subset(void)
+{
+    return gen_font_subset;
+}
+
+//Letters the subsets keep besides the project's texts, e.g. of texts set by the application. Not copied.
+void gencode_set_font_chars(const char * chars)
+{
+    gen_font_chars = chars;
+}
+
+//Compress the glyph bitmaps of the subsets, the target needs `LV_USE_FONT_COMPRESSED` then
+void gencode_set_font_compress(bool compress)
+{
+    gen_font_compress = compress;
+}
+
+//Export every screen as a binary blob too, `lv_gui.bin` or `lv_gui_screen_<n>.bin`, for updating the UI over the air
+void gencode_set_blob(bool blob)
+{
+    gen_blob = blob;
+}
+
+bool gencode_get_blob(void)
+{
+    return gen_blob;
+}
+
+//Write the generated files into `dir` instead of the working directory, NULL: the working directory.
+//The earlier generation's files of an other directory are left there.
+bool gencode_set_out_dir(const char * dir)
+{
+    if(dir != NULL && strlen(dir) >= OUT_DIR_MAX) return false;
+    gen_out_dir = dir;
+    out_cache_cnt = 0;
+    return true;
+}
+
+//Write the repeated subtrees of the straight-line code as a builder function called per instance
+void gencode_set_templates(bool templates)
+{
+    gen_templates = templates;
+}
+
+bool gencode_get_templates(void)
+{
+    return gen_templates;
+}
+
+//Create the children of a hidden widget only when the target shows it first (`lv_obj_set_lazy`). The target needs
+//`LV_USE_OBJ_LAZY` then, and the widgets of such a subtree are NULL in `lv_gui_obj` until it's shown.
+void gencode_set_lazy(bool lazy)
+{
+    gen_lazy = lazy;
+}
+
+bool gencode_get_lazy(void)
+{
+    return gen_lazy;
+}
+
+//Let the target delete the lazy children again when it hides them while its `lv_mem` is low. Their entries of
+//`lv_gui_obj` are left dangling until they are shown again, so the application mustn't keep them.
+void gencode_set_lazy_release(bool release)
+{
+    gen_lazy_release = release;
+}
+
+//Write the project as a MicroPython module too, `lv_gui.py`, made of tables to freeze into the firmware
+void gencode_set_python(bool python)
+{
+    gen_python = python;
+}
+
+bool gencode_get_python(void)
+{
+    return gen_python;
+}
+
+//Keep this theme in `lv_gui_conf.h` (e.g. "material"), the others are turned off. NULL: none, the built-in styles.
+//false: unknown theme.
+bool gencode_set_theme(const char * name)
+{
+    if(name == NULL)
+    {
+        gen_theme = -1;
+        return true;
+    }
+    uint32_t i;
+    for(i = 0; i < CONF_THEME_NUM; i++)
+    {
+        if(!strcmp(name, conf_themes[i][0]))
+        {
+            gen_theme = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char * gencode_get_theme(void)
+{
+    return gen_theme >= 0 ? conf_themes[gen_theme][0] : NULL;
+}
+
+//The hue the theme is initialized with [deg], see `lv_theme_..._init()`
+void gencode_set_theme_hue(uint16_t hue)
+{
+    gen_theme_hue = hue % 360;
+}
+
+/* Evaluate the theme at generation time: its styles used by the widgets are written as const data and set
+ * right after creating them, and `lv_gui_conf.h` turns every theme off. false: the target initializes the theme. */
+void gencode_set_theme_flat(bool flat)
+{
+    gen_theme_flat = flat;
+}
+
+bool gencode_get_theme_flat(void)
+{
+    return gen_theme_flat;
+}
+
+//The sizes of the last code generation
+//[bytes] of the target's `lv_mem` (`LV_MEM_SIZE`) in the simulation of the report
+void gencode_set_heap_size(uint32_t size)
+{
+    gen_heap_size = size;
+}
+
+const gencode_report_t * gencode_get_report(void)
+{
+    return &last_report;
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+//Generate the code of a project for the target: that of `snap`, which has an image widget in place of
+//a baked subtree. The UI blobs and the MicroPython module have the widgets of `proj`, the project as it is.
+static bool generate(const projsnap_t * snap, const projsnap_t * proj, projsnap_step_cb_t step_cb)
+{
+    gencode_mode_t mode = mode_get(snap, gen_mode);
+    style_pool_t pool;
+    if(!style_pool_build(&pool, snap)) return false;
+    img_pool_t imgs;
+    if(!img_pool_build(&imgs))
+    {
+        style_pool_free(&pool);
+        return false;
+    }
+    //The blobs and the MicroPython module show the baked texts with the subsets too
+    font_pool_t fonts;
+    if(!font_pool_build(&fonts, gen_blob || gen_python ? proj : snap))
+    {
+        img_pool_free(&imgs);
+        style_pool_free(&pool);
+        return false;
+    }
+
+    memset(&last_report, 0, sizeof(last_report));
+    last_report.widgets = snap->cnt - snap->screen_cnt;         //Without the screens
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(snap->nodes[i].depth > 0 && pool.node_style[i] != PROJSNAP_NO_STYLE) last_report.styled++;
+    }
+    last_report.styles = pool.node_cnt;
+    last_report.style_size = pool.node_cnt * sizeof(lv_style_t);
+    if(pool.scr_style != PROJSNAP_NO_STYLE)
+    {
+        last_report.theme_styles = pool.cnt - pool.node_cnt;
+        last_report.theme_size = last_report.theme_styles * sizeof(lv_style_t);
+        last_report.theme_ram_saved = pool.theme_ram;
+    }
+    last_report.ram_saved = last_report.styled * sizeof(lv_style_t);
+    last_report.calls = last_report.widgets * 3 + last_report.styled;
+    last_report.table_size = last_report.widgets *
+                             (pool.node_cnt > 0 ? sizeof(gencode_row_style_t) : sizeof(gencode_row_t));
+    last_report.images = imgs.cnt;
+    for(i = 0; i < imgs.cnt; i++)
+    {
+        if(imgs.data[i].cached) last_report.images_cached++;
+        last_report.image_size += imgs.data[i].data_size;
+    }
+    last_report.bakes = proj->bake_cnt;
+    last_report.bake_widgets = proj->cnt - snap->cnt + proj->bake_cnt;
+    for(i = 0; i < proj->bake_cnt; i++) last_report.bake_size += proj->bakes[i].img.data_size;
+
+    uint32_t lazy_until = 0;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        uint32_t lazy_end = lazy_end_get(snap, i);
+        if(lazy_end == 0) continue;
+        last_report.lazy++;
+        if(i < lazy_until) continue;
+        last_report.lazy_widgets += lazy_end - i - 1;
+        lazy_until = lazy_end;
+    }
+
+    last_report.heap_size = gen_heap_size;
+    heap_simulate(snap, true, &last_report.heap);
+    heap_simulate(snap, false, &last_report.heap_tree);
+
+    for(i = 0; i < out_cache_cnt; i++) out_cache[i].produced = false;
+
+    bool res = false;
+    gencode_out_t out;
+    if(out_begin(&out))
+    {
+        code_header_write(out.fp, snap, &imgs, mode);
+        res = out_end(&out, "lv_gui.h", false, NULL);
+    }
+    if(res) res = conf_header_write(snap, &imgs, &fonts, pool.scr_style != PROJSNAP_NO_STYLE);
+    if(res) res = images_write(&imgs, proj);
+    img_pool_free(&imgs);
+    if(res) res = fonts_write(&fonts);
+    font_pool_free(&fonts);
+    if(res) res = sources_write(snap, &pool, mode, false, &last_report.src_size[mode], step_cb);
+    if(res && gen_blob) res = blobs_write(proj);
+    if(res && gen_python && proj == snap) res = py_source_write(snap, &pool, &last_report.py_size);
+    if(res && gen_python && proj != snap)
+    {
+        style_pool_t py_pool;
+        res = style_pool_build(&py_pool, proj);
+        if(res)
+        {
+            res = py_source_write(proj, &py_pool, &last_report.py_size);
+            style_pool_free(&py_pool);
+        }
+    }
+
+    //Write the other kind too, but only to measure it
+    gencode_mode_t other = mode == GENCODE_TABLE ? GENCODE_CALLS : GENCODE_TABLE;
+    if(res && mode_get(snap, other) == other) sources_write(snap, &pool, other, true, &last_report.src_size[other], NULL);
+    style_pool_free(&pool);
+
+    //The same straight-line code without the templates, to show what they save
+    if(res && gen_templates && last_report.templates > 0)
+    {
+        gen_templates = false;
+        sources_write(snap, &pool, GENCODE_CALLS, true, &last_report.src_size_expanded, NULL);
+        gen_templates = true;
+    }
+
+    //Remove what an earlier generation wrote but this one didn't (e.g. the file of a deleted screen)
+    if(res) out_cache_clean();
+
+    printf("Code generation (%s%s): %u widgets\n", mode_names[mode], gen_split ? ", split" : "", last_report.widgets);
+    const char * src_name = gen_split ? "sources" : "lv_gui.c";
+    printf("  straight-line: %s %u bytes, %u calls\n",
+           src_name, last_report.src_size[GENCODE_CALLS], last_report.calls);
+    if(mode_get(snap, GENCODE_TABLE) == GENCODE_TABLE)
+    {
+        printf("  table driven:  %s %u bytes, %u bytes of const tables, one loop\n",
+               src_name, last_report.src_size[GENCODE_TABLE], last_report.table_size);
+    }
+    if(last_report.templates > 0)
+    {
+        printf("  templates: %u repeated subtrees written once for %u instances, straight-line %u bytes instead of %u\n",
+               last_report.templates, last_report.tpl_instances, last_report.src_size[GENCODE_CALLS],
+               last_report.src_size_expanded);
+    }
+    if(last_report.styled > 0)
+    {
+        printf("  styles: %u customized widgets share %u const styles (%u bytes in flash), %u bytes of RAM saved\n",
+               last_report.styled, last_report.styles, last_report.style_size, last_report.ram_saved);
+    }
+    if(last_report.images > 0)
+    {
+        imgasset_target_t target = imgasset_get_target();
+        printf("  images: %u in the format of %u bit%s colour (%u bytes in flash), %u of them from %s\n",
+               last_report.images, target.depth, target.swap ? " swapped" : "", last_report.image_size,
+               last_report.images_cached, assetstore_get_dir());
+    }
+    if(last_report.bakes > 0) bake_report(proj);
+    if(last_report.lazy > 0)
+    {
+        printf("  lazy: %u hidden subtrees, %u widgets created when they are shown first%s\n", last_report.lazy,
+               last_report.lazy_widgets, gen_lazy_release ? ", released when hidden with low memory" : "");
+    }
+    if(last_report.fonts > 0)
+    {
+        printf("  fonts: %u subset to %u glyphs (%u bytes in flash instead of %u), %u of them from %s\n",
+               last_report.fonts, last_report.font_glyphs, last_report.font_size, last_report.font_full_size,
+               last_report.fonts_cached, assetstore_get_dir());
+    }
+    if(gen_python)
+    {
+        printf("  python: lv_gui.py %u bytes, %u bytes of widget table, one loop\n",
+               last_report.py_size, last_report.py_table_size);
+    }
+    if(snap->screen_cnt > 1)
+    {
+        printf("  lv_mem: %u bytes of first fit heap, %u rounds through the %u screens\n",
+               last_report.heap_size, HEAP_ROUNDS, snap->screen_cnt);
+    }else
+    {
+        printf("  lv_mem: %u bytes of first fit heap\n", last_report.heap_size);
+    }
+    heap_print("generated: ", &last_report.heap, snap->screen_cnt > 1);
+    heap_print("tree order:", &last_report.heap_tree, snap->screen_cnt > 1);
+    if(last_report.theme_ram_saved > 0)
+    {
+        printf("  theme: %s hue %u flattened into %u const styles (%u bytes in flash), %u bytes of RAM styles and "
+               "the init left out\n", conf_themes[gen_theme][0], gen_theme_hue, last_report.theme_styles,
+               last_report.theme_size, last_report.theme_ram_saved);
+    }
+    const char * conf_theme = gen_theme >= 0 ? conf_themes[gen_theme][0] : "none";
+    if(last_report.theme_ram_saved > 0 && !gen_blob) conf_theme = "none";
+    printf("  lv_gui_conf.h: %u of %u widgets, %u fonts, theme %s, no animations and groups\n",
+           last_report.conf_widgets, (uint32_t)CONF_WIDGET_NUM, last_report.conf_fonts, conf_theme);
+    if(last_report.blobs > 0)
+    {
+        printf("  blobs: %u screen%s in %u bytes, created by runtime/lv_gui_blob.c without a rebuild\n",
+               last_report.blobs, last_report.blobs > 1 ? "s" : "", last_report.blob_size);
+    }
+    printf("  files: %u written, %u unchanged\n", last_report.files_written, last_report.files_unchanged);
+    return res;
+}
+
+//The project with every baked subtree replaced by one image widget showing `lv_gui_bake_<root ID>`, at the image's
+//position in the parent of the root. The texts and styles are copied, so it's freed as any snapshot.
+static bool bake_snap_build(projsnap_t * dst, const projsnap_t * snap)
+{
+    memset(dst, 0, sizeof(projsnap_t));
+    dst->nodes = malloc(snap->cnt * sizeof(projsnap_node_t));
+    uint32_t * map = malloc(snap->cnt * sizeof(uint32_t));     //Per node: its index in `dst` (of the kept ones)
+    if(snap->style_cnt > 0) dst->styles = malloc(snap->style_cnt * sizeof(lv_style_t));
+    if(dst->nodes == NULL || map == NULL || (snap->style_cnt > 0 && dst->styles == NULL))
+    {
+        free(map);
+        projsnap_free(dst);
+        return false;
+    }
+    if(snap->style_cnt > 0) memcpy(dst->styles, snap->styles, snap->style_cnt * sizeof(lv_style_t));
+    dst->style_cnt = snap->style_cnt;
+    dst->screen_cnt = snap->screen_cnt;
+
+    bool res = true;
+    uint32_t b = 0;
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * src = &snap->nodes[i];
+        projsnap_node_t * n = &dst->nodes[dst->cnt];
+        *n = *src;
+        map[i] = dst->cnt++;
+        if(n->parent != PROJSNAP_NO_PARENT) n->parent = map[n->parent];
+        if(b == snap->bake_cnt || snap->bakes[b].node != i)
+        {
+            if(n->text != NULL && (n->text = strdup(n->text)) == NULL) res = false;
+            continue;
+        }
+
+        const projsnap_bake_t * bake = &snap->bakes[b++];
+        char name[PROJSNAP_ID_MAX + 16];
+        snprintf(name, sizeof(name), "lv_gui_bake_%s", src->id);
+        n->type = WIDGET_TYPE_IMG;
+        n->x = bake->x;
+        n->y = bake->y;
+        n->w = bake->img.header.w;
+        n->h = bake->img.header.h;
+        n->style = PROJSNAP_NO_STYLE;
+        n->font = NULL;         //Its texts are pixels, they don't need the letters of a font
+        n->val_cnt = 0;
+        if((n->text = strdup(name)) == NULL) res = false;
+        for(; i + 1 < snap->cnt && snap->nodes[i + 1].depth > src->depth; i++);
+    }
+    free(map);
+    if(!res) projsnap_free(dst);
+    return res;
+}
+
+//A line per baked subtree. The flash of its widgets is estimated from their table rows and texts (the styles only
+//they use aside), that of the image is its data and descriptor.
+static void bake_report(const projsnap_t * proj)
+{
+    uint32_t b;
+    for(b = 0; b < proj->bake_cnt; b++)
+    {
+        const projsnap_bake_t * bake = &proj->bakes[b];
+        const projsnap_node_t * root = &proj->nodes[bake->node];
+        uint32_t flash = 0;
+        uint32_t end;
+        for(end = bake->node; end < proj->cnt && (end == bake->node || proj->nodes[end].depth > root->depth); end++)
+        {
+            flash += sizeof(gencode_row_style_t);
+            if(proj->nodes[end].text != NULL) flash += strlen(proj->nodes[end].text) + 1;
+        }
+        printf("  baked: %s, %u widgets as a %ux%u %s image: drawn in %u us instead of %u us on the designer, "
+               "%u bytes in flash instead of ~%u\n", root->id, end - bake->node, bake->img.header.w, bake->img.header.h,
+               imgasset_cf_get_name(bake->img.header.cf), bake->img_draw_us, bake->draw_us,
+               (uint32_t)(bake->img.data_size + sizeof(lv_img_dsc_t)), flash);
+    }
+}
+
+static inline void code_header_write(FILE * lv_gui_h_fp, const projsnap_t * snap, const img_pool_t * imgs,
+                                     gencode_mode_t mode)
+{
+    uint32_t i;
+    if(mode == GENCODE_CALLS && imgs->cnt == 0 && snap->screen_cnt <= 1)
+    {
+        fprintf(lv_gui_h_fp, "#ifndef _INTERFACE_H \n#define _INTERFACE_H \n\nvoid %s(void);\n\n\n#endif", gui_main_name);
+        return;
+    }
+
+    fputs("#ifndef _INTERFACE_H \n#define _INTERFACE_H \n\n#include \"lvgl.h\"\n\n", lv_gui_h_fp);
+    if(imgs->cnt > 0)
+    {
+        for(i = 0; i < imgs->cnt; i++) fprintf(lv_gui_h_fp, "LV_IMG_DECLARE(%s);\n", imgs->assets[i].name);
+        fputs("\n", lv_gui_h_fp);
+    }
+
+    //The widgets stay reachable by their IDs
+    if(mode == GENCODE_TABLE)
+    {
+        fputs("enum {\n", lv_gui_h_fp);
+        for(i = 1; i < snap->cnt; i++) fprintf(lv_gui_h_fp, "    LV_GUI_ID_%s,\n", snap->nodes[i].id);
+        fputs("};\n\nextern lv_obj_t * lv_gui_obj[];\n\n", lv_gui_h_fp);
+    }
+
+    //Create a screen when it's needed and delete it when it's not shown, only the created ones take memory
+    if(snap->screen_cnt > 1)
+    {
+        fprintf(lv_gui_h_fp, "#define LV_GUI_SCREEN_NUM %u\n\n", snap->screen_cnt);
+        uint32_t idx = 0;
+        for(i = 0; i < snap->cnt; i++)
+        {
+            if(snap->nodes[i].depth != 0) continue;
+            fprintf(lv_gui_h_fp, "lv_obj_t * screen_%u_create(void);     /*%s*/\n", idx, snap->nodes[i].id);
+            fprintf(lv_gui_h_fp, "void screen_%u_del(void);\n", idx);
+            idx++;
+        }
+        fputs("\n", lv_gui_h_fp);
+    }
+    fprintf(lv_gui_h_fp, "void %s(void);\n\n\n#endif", gui_main_name);
+}
+
+//`lv_gui_conf.h`: the lv_conf.h settings the project doesn't need turned off, to include at the end of lv_conf.h.
+//The widgets of the project (every type the designer knows with blobs: a new blob may have others), the
+//fonts of its texts (the subsets replace their built-in font), one theme and no live theme update.
+//The generated code uses neither animations nor groups. `flat`: the code sets the theme's styles, no theme is
+//needed then, unless the target creates blobs.
+static bool conf_header_write(const projsnap_t * snap, const img_pool_t * imgs, const font_pool_t * fonts, bool flat)
+{
+    bool used[CONF_WIDGET_NUM];
+    memset(used, 0, sizeof(used));
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const widget_desc_t * desc = widgetreg_get(snap->nodes[i].type);
+        if(desc != NULL) conf_mark(used, desc->code_conf);
+    }
+    widget_type_t type;
+    for(type = 0; type < WIDGET_TYPE_NUM && gen_blob; type++)
+    {
+        const widget_desc_t * desc = widgetreg_get(type);
+        if(desc != NULL) conf_mark(used, desc->code_conf);
+    }
+    //An image shows its symbols with a label
+    if(imgs->cnt > 0) conf_mark(used, "LV_USE_IMG LV_USE_LABEL");
+
+    //The default font is used by the built-in styles
+    bool font_used[CONF_FONT_NUM];
+    bool font_sub[CONF_FONT_NUM];
+    memset(font_used, 0, sizeof(font_used));
+    memset(font_sub, 0, sizeof(font_sub));
+    for(i = 0; i <= snap->cnt; i++)
+    {
+        const char * conf = fontsub_get_conf(i < snap->cnt ? snap->nodes[i].font : LV_FONT_DEFAULT);
+        uint32_t f;
+        for(f = 0; f < CONF_FONT_NUM && conf != NULL; f++)
+        {
+            if(!strcmp(conf, conf_fonts[f][0])) font_used[f] = true;
+        }
+    }
+    for(i = 0; i < fonts->cnt; i++)
+    {
+        const char * conf = fontsub_get_conf(fonts->sets[i].font);
+        uint32_t f;
+        for(f = 0; f < CONF_FONT_NUM && conf != NULL; f++)
+        {
+            if(!strcmp(conf, conf_fonts[f][0])) font_sub[f] = true;
+        }
+    }
+
+    gencode_out_t out;
+    if(!out_begin(&out)) return false;
+    FILE * fp = out.fp;
+    fputs("/**\n * @file lv_gui_conf.h\n"
+          " * What the project needs from lv_conf.h, the rest is turned off. Include it at the end of lv_conf.h.\n"
+          " * Written by the designer, don't edit\n */\n\n"
+          "#ifndef LV_GUI_CONF_H\n#define LV_GUI_CONF_H\n\n", fp);
+
+    fputs("/*Widgets, with their dependencies*/\n", fp);
+    for(i = 0; i < CONF_WIDGET_NUM; i++)
+    {
+        fprintf(fp, "#undef %s\n#define %s %d\n", conf_widgets[i], conf_widgets[i], used[i] ? 1 : 0);
+        if(used[i]) last_report.conf_widgets++;
+    }
+
+    fputs("\n/*Fonts, a subset replaces its built-in font*/\n", fp);
+    bool declare = false;
+    for(i = 0; i < CONF_FONT_NUM; i++)
+    {
+        fprintf(fp, "#undef %s\n#define %s %d\n", conf_fonts[i][0], conf_fonts[i][0], font_used[i] && !font_sub[i] ? 1 : 0);
+        if(font_used[i]) last_report.conf_fonts++;
+        if(font_sub[i]) declare = true;
+    }
+    for(i = 0; i < fonts->cnt; i++)
+    {
+        if(ttfont_is(fonts->sets[i].font)) declare = true;
+    }
+    if(declare)
+    {
+        fputs("#undef LV_FONT_CUSTOM_DECLARE\n#define LV_FONT_CUSTOM_DECLARE", fp);
+        for(i = 0; i < CONF_FONT_NUM; i++)
+        {
+            if(font_sub[i]) fprintf(fp, " LV_FONT_DECLARE(%s)", conf_fonts[i][1]);
+        }
+        for(i = 0; i < fonts->cnt; i++)
+        {
+            const char * name = ttfont_get_name(fonts->sets[i].font);
+            if(name != NULL) fprintf(fp, " LV_FONT_DECLARE(%s)", name);
+        }
+        fputs("\n", fp);
+        if(gen_font_compress) fputs("#undef LV_USE_FONT_COMPRESSED\n#define LV_USE_FONT_COMPRESSED 1\n", fp);
+    }
+
+    fputs("\n/*Themes, the live update keeps the styles of every widget in RAM*/\n"
+          "#undef LV_THEME_LIVE_UPDATE\n#define LV_THEME_LIVE_UPDATE 0\n", fp);
+    for(i = 0; i < CONF_THEME_NUM; i++)
+    {
+        fprintf(fp, "#undef LV_USE_THEME_%s\n#define LV_USE_THEME_%s %d\n", conf_themes[i][1], conf_themes[i][1],
+                (int32_t)i == gen_theme && (!flat || gen_blob) ? 1 : 0);
+    }
+
+    if(last_report.lazy > 0)
+    {
+        fputs("\n/*The hidden subtrees are created when they are shown first*/\n"
+              "#undef LV_USE_OBJ_LAZY\n#define LV_USE_OBJ_LAZY 1\n", fp);
+    }
+
+    fputs("\n/*Not used by the generated code*/\n"
+          "#undef LV_USE_ANIMATION\n#define LV_USE_ANIMATION 0\n"
+          "#undef LV_USE_GROUP\n#define LV_USE_GROUP 0\n"
+          "\n#endif\n", fp);
+    return out_end(&out, "lv_gui_conf.h", false, NULL);
+}
+
+//Set the flags of the `LV_USE_...` macros in a space separated list
+static void conf_mark(bool * used, const char * macros)
+{
+    while(macros != NULL && *macros != '\0')
+    {
+        size_t len = strcspn(macros, " ");
+        uint32_t i;
+        for(i = 0; i < CONF_WIDGET_NUM; i++)
+        {
+            if(strlen(conf_widgets[i]) == len && !strncmp(conf_widgets[i], macros, len)) used[i] = true;
+        }
+        macros += len;
+        macros += strspn(macros, " ");
+    }
+}
+
+//Every image as const data in the target's format, so the target neither decodes nor converts them.
+//The baked subtrees of `proj` too, as `lv_gui_bake_<root ID>`.
+static bool images_write(const img_pool_t * imgs, const projsnap_t * proj)
+{
+    if(imgs->cnt == 0 && proj->bake_cnt == 0) return true;     //An earlier `lv_gui_img.c` is removed as not produced
+
+    gencode_out_t out;
+    if(!out_begin(&out)) return false;
 
-static inline void code_header_write(FILE * lv_gui_h_fp)
+    //The data is only right for the colour format it was converted to
+    imgasset_target_t target = imgasset_get_target();
+    fputs("#include \"lvgl.h\"\n\n", out.fp);
+    if(target.depth == 16)
+    {
+        fprintf(out.fp, "#if LV_COLOR_DEPTH != 16 || LV_COLOR_16_SWAP != %u\n"
+                "#error \"The images are converted for LV_COLOR_DEPTH 16 and LV_COLOR_16_SWAP %u\"\n#endif\n",
+                target.swap, target.swap);
+    }else
+    {
+        fprintf(out.fp, "#if LV_COLOR_DEPTH != %u\n#error \"The images are converted for LV_COLOR_DEPTH %u\"\n#endif\n",
+                target.depth, target.depth);
+    }
+
+    bool indexed = false;
+    bool alpha = false;
+    uint32_t i;
+    for(i = 0; i < imgs->cnt + proj->bake_cnt; i++)
+    {
+        lv_img_cf_t cf = i < imgs->cnt ? imgs->data[i].header.cf : proj->bakes[i - imgs->cnt].img.header.cf;
+        if(cf >= LV_IMG_CF_INDEXED_1BIT && cf <= LV_IMG_CF_INDEXED_8BIT) indexed = true;
+        if(cf >= LV_IMG_CF_ALPHA_1BIT && cf <= LV_IMG_CF_ALPHA_8BIT) alpha = true;
+    }
+    if(indexed) fputs("#if LV_IMG_CF_INDEXED == 0\n#error \"Enable LV_IMG_CF_INDEXED in lv_conf.h\"\n#endif\n", out.fp);
+    if(alpha) fputs("#if LV_IMG_CF_ALPHA == 0\n#error \"Enable LV_IMG_CF_ALPHA in lv_conf.h\"\n#endif\n", out.fp);
+
+    for(i = 0; i < imgs->cnt; i++) image_write(out.fp, imgs->assets[i].name, &imgs->data[i]);
+    for(i = 0; i < proj->bake_cnt; i++)
+    {
+        char name[PROJSNAP_ID_MAX + 16];
+        snprintf(name, sizeof(name), "lv_gui_bake_%s", proj->nodes[proj->bakes[i].node].id);
+        image_write(out.fp, name, &proj->bakes[i].img);
+    }
+    return out_end(&out, "lv_gui_img.c", false, NULL);
+}
+
+static void image_write(FILE * fp, const char * name, const imgasset_data_t * d)
+{
+    fprintf(fp, "\nstatic const uint8_t %s_map[] = {", name);
+    uint32_t k;
+    for(k = 0; k < d->data_size; k++)
+    {
+        fprintf(fp, k % IMG_BYTES_PER_LINE == 0 ? "\n    0x%02x," : " 0x%02x,", d->data[k]);
+    }
+    fprintf(fp, "\n};\n\nconst lv_img_dsc_t %s = {\n"
+            "    .header.always_zero = 0,\n    .header.w = %u,\n    .header.h = %u,\n"
+            "    .header.cf = %s,\n    .data_size = %u,\n    .data = %s_map,\n};\n",
+            name, d->header.w, d->header.h, imgasset_cf_get_code(d->header.cf), d->data_size, name);
+}
+
+//An image that can't be converted is left out, so the rest of the code is still generated
+static bool img_pool_build(img_pool_t * pool)
+{
+    uint32_t cnt = imgasset_get_count();
+    pool->cnt = 0;
+    pool->assets = malloc((cnt + 1) * sizeof(imgasset_t));
+    pool->data = malloc((cnt + 1) * sizeof(imgasset_data_t));
+    if(pool->assets == NULL || pool->data == NULL)
+    {
+        img_pool_free(pool);
+        return false;
+    }
+
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        imgasset_t * a = &pool->assets[pool->cnt];
+        if(!imgasset_get(i, a)) break;      //Removed in the meantime
+        if(!imgasset_convert(a, &pool->data[pool->cnt]))
+        {
+            printf("Image %s: can't convert %s\n", a->name, a->path);
+            continue;
+        }
+        pool->cnt++;
+    }
+    return true;
+}
+
+static void img_pool_free(img_pool_t * pool)
+{
+    uint32_t i;
+    for(i = 0; i < pool->cnt; i++) imgasset_data_free(&pool->data[i]);
+    free(pool->assets);
+    free(pool->data);
+    pool->assets = NULL;
+    pool->data = NULL;
+    pool->cnt = 0;
+}
+
+//Every subset in its own file, named by the font it replaces
+static bool fonts_write(const font_pool_t * fonts)
+{
+    uint32_t i;
+    for(i = 0; i < fonts->cnt; i++)
+    {
+        const fontsub_letters_t * set = &fonts->sets[i];
+        const char * name = fontsub_get_name(set->font);
+        gencode_out_t out;
+        if(!out_begin(&out)) return false;
+
+        fontsub_report_t rep;
+        if(!fontsub_write(out.fp, set, gen_font_compress, &rep))
+        {
+            printf("Font %s: can't write its subset\n", name);
+            out_end(&out, NULL, true, NULL);
+            return false;
+        }
+
+        char path[OUT_PATH_MAX];
+        snprintf(path, sizeof(path), "lv_gui_font_%s.c", strncmp(name, "lv_font_", 8) == 0 ? name + 8 : name);
+        if(!out_end(&out, path, false, NULL)) return false;
+
+        last_report.fonts++;
+        last_report.font_glyphs += rep.glyphs;
+        last_report.font_size += rep.size;
+        last_report.font_full_size += rep.full_size;
+        if(rep.cached) last_report.fonts_cached++;
+    }
+    return true;
+}
+
+//Only the fonts which have a subsetter and are used by a text, with the letters of their texts
+static bool font_pool_build(font_pool_t * pool, const projsnap_t * snap)
+{
+    memset(pool, 0, sizeof(font_pool_t));
+
+    pool->sets = calloc(snap->cnt + 1, sizeof(fontsub_letters_t));
+    if(pool->sets == NULL) return false;
+
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        //A TrueType font exists on the target only as a subset
+        if(n->text == NULL || !fontsub_is_supported(n->font) || (!gen_font_subset && !ttfont_is(n->font))) continue;
+
+        uint32_t f;
+        for(f = 0; f < pool->cnt && pool->sets[f].font != n->font; f++);
+        if(f == pool->cnt) pool->sets[pool->cnt++].font = n->font;
+        if(!fontsub_letters_add(&pool->sets[f], n->text))
+        {
+            font_pool_free(pool);
+            return false;
+        }
+    }
+
+    for(i = 0; i < pool->cnt && gen_font_chars != NULL; i++)
+    {
+        if(!fontsub_letters_add(&pool->sets[i], gen_font_chars))
+        {
+            font_pool_free(pool);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void font_pool_free(font_pool_t * pool)
 {
-    fprintf(lv_gui_h_fp, "#ifndef _INTERFACE_H \n#define _INTERFACE_H \n\nvoid %s(void);\n\n\n#endif", gui_main_name);
+    uint32_t i;
+    for(i = 0; i < pool->cnt; i++) fontsub_letters_free(&pool->sets[i]);
+    free(pool->sets);
+    memset(pool, 0, sizeof(font_pool_t));
 }
 
-static inline void code_source_write(FILE * lv_gui_c_fp)
+//One blob per screen, the widgets of a single-screen project are in `lv_gui.bin`
+static bool blobs_write(const projsnap_t * snap)
 {
-    code_source_head_write(lv_gui_c_fp);
-    code_source_body_write(lv_gui_c_fp);
+    uint32_t idx = 0;
+    uint32_t root;
+    uint32_t end;
+    for(root = 0; root < snap->cnt; root = end)
+    {
+        for(end = root + 1; end < snap->cnt && snap->nodes[end].depth > 0; end++);
+
+        gencode_out_t out;
+        if(!out_begin(&out)) return false;
+        if(!uiblob_write(out.fp, snap, root, end))
+        {
+            fclose(out.fp);
+            free(out.buf);
+            return false;
+        }
+        char path[32];
+        if(snap->screen_cnt > 1) snprintf(path, sizeof(path), "lv_gui_screen_%u.bin", idx);
+        else strcpy(path, "lv_gui.bin");
+        if(!out_end(&out, path, false, &last_report.blob_size)) return false;
+        last_report.blobs++;
+        idx++;
+    }
+    return true;
 }
 
-static inline void code_source_head_write(FILE * lv_gui_c_fp)
+//All the sources of a mode. `dry`: only add up their size
+static bool sources_write(const projsnap_t * snap, style_pool_t * pool, gencode_mode_t mode, bool dry,
+                          uint32_t * size, projsnap_step_cb_t step_cb)
 {
-    fputs("#include \"lvgl.h\"\n\n", lv_gui_c_fp);
+    gencode_out_t out;
+    char fn[PROJSNAP_ID_MAX + 64];
+
+    if(snap->screen_cnt > 1) return screens_sources_write(snap, pool, dry, size, step_cb);
+
+    if(!gen_split)
+    {
+        if(!out_begin(&out)) return false;
+        fputs("#include \"lvgl.h\"\n\n", out.fp);
+        if(src_write_img_decl(out.fp, snap, 1, snap->cnt)) fputs("\n", out.fp);
+        //Every unique style once, const so it stays in flash
+        uint32_t s;
+        for(s = 0; s < pool->cnt; s++)
+        {
+            fprintf(out.fp, "static const lv_style_t %s = %s;\n\n", pool->names[s], pool->texts[s]);
+        }
+        src_write_theme_fns(out.fp, pool, false);
+        if(mode == GENCODE_TABLE) code_source_table_write(out.fp, snap, pool, 1, snap->cnt, NULL, step_cb);
+        else code_source_body_write(out.fp, snap, pool, 1, snap->cnt, NULL, step_cb);
+        return out_end(&out, "lv_gui.c", dry, size);
+    }
+
+    //The styles are shared by the screens
+    if(pool->cnt > 0)
+    {
+        if(!out_begin(&out)) return false;
+        fputs("#include \"lvgl.h\"\n\n", out.fp);
+        uint32_t s;
+        for(s = 0; s < pool->cnt; s++) fprintf(out.fp, "const lv_style_t %s = %s;\n\n", pool->names[s], pool->texts[s]);
+        src_write_theme_fns(out.fp, pool, true);
+        if(!out_end(&out, "lv_gui_style.c", dry, size)) return false;
+    }
+
+    //A screen doesn't depend on the others, it changes only if its widgets do
+    uint32_t first;
+    uint32_t end;
+    for(first = 1; first < snap->cnt; first = end)
+    {
+        const projsnap_node_t * n = &snap->nodes[first];
+        for(end = first + 1; end < snap->cnt && snap->nodes[end].depth > 1; end++);
+
+        if(!out_begin(&out)) return false;
+        fputs("#include \"lvgl.h\"\n\n", out.fp);
+        if(src_write_img_decl(out.fp, snap, first, end)) fputs("\n", out.fp);
+        if(src_write_style_decl(out.fp, snap, pool, first, end)) fputs("\n", out.fp);
+        if(mode == GENCODE_TABLE)
+        {
+            code_source_table_write(out.fp, snap, pool, first, end, n->id, step_cb);
+        }else
+        {
+            snprintf(fn, sizeof(fn), "void lv_gui_part_%s_create(void)", n->id);
+            code_source_body_write(out.fp, snap, pool, first, end, fn, step_cb);
+        }
+        char path[PROJSNAP_ID_MAX + 32];
+        snprintf(path, sizeof(path), "lv_gui_part_%s.c", n->id);
+        if(!out_end(&out, path, dry, size)) return false;
+    }
+
+    //It only calls the screens
+    if(!out_begin(&out)) return false;
+    fputs("#include \"lvgl.h\"\n#include \"lv_gui.h\"\n\n", out.fp);
+    for(first = 1; first < snap->cnt; first++)
+    {
+        if(snap->nodes[first].depth != 1) continue;
+        if(mode == GENCODE_TABLE) fprintf(out.fp, "void lv_gui_part_%s_create(lv_obj_t ** objs);\n", snap->nodes[first].id);
+        else fprintf(out.fp, "void lv_gui_part_%s_create(void);\n", snap->nodes[first].id);
+    }
+    if(pool->scr_style != PROJSNAP_NO_STYLE) fputs("void lv_gui_theme_scr(lv_obj_t * obj);\n", out.fp);
+    if(mode == GENCODE_TABLE) fprintf(out.fp, "\nlv_obj_t * lv_gui_obj[%u];\n", snap->cnt - 1);
+    fprintf(out.fp, "\nvoid %s(void)\n{\n", gui_main_name);
+    src_write_scr_theme(out.fp, pool, "lv_scr_act()");
+    for(first = 1; first < snap->cnt; first++)
+    {
+        const char * id = snap->nodes[first].id;
+        if(snap->nodes[first].depth != 1) continue;
+        if(mode == GENCODE_TABLE) fprintf(out.fp, "    lv_gui_part_%s_create(&lv_gui_obj[LV_GUI_ID_%s]);\n", id, id);
+        else fprintf(out.fp, "    lv_gui_part_%s_create();\n", id);
+    }
+    fputs("}\n", out.fp);
+    return out_end(&out, "lv_gui.c", dry, size);
 }
 
-static void code_source_body_write(FILE * lv_gui_c_fp)
+//A multi-screen project, straight-line calls for every screen. Split: one file per screen.
+static bool screens_sources_write(const projsnap_t * snap, const style_pool_t * pool, bool dry, uint32_t * size,
+                                  projsnap_step_cb_t step_cb)
 {
-    // fprintf(lv_gui_c_fp, "void %s()\n{\n", gui_main_name);
+    gencode_out_t out;
+    uint32_t s;
+    if(gen_split && pool->cnt > 0)
+    {
+        if(!out_begin(&out)) return false;
+        fputs("#include \"lvgl.h\"\n\n", out.fp);
+        for(s = 0; s < pool->cnt; s++) fprintf(out.fp, "const lv_style_t %s = %s;\n\n", pool->names[s], pool->texts[s]);
+        src_write_theme_fns(out.fp, pool, true);
+        if(!out_end(&out, "lv_gui_style.c", dry, size)) return false;
+    }
+
+    //The screens are rendered on the generator threads, then written (or joined) in their order,
+    //so the output doesn't depend on which thread was faster
+    screen_pool_t sp;
+    if(!screens_render(&sp, snap, pool, step_cb)) return false;
 
-    // for (lv_obj_t * i = wdeque_traverse(true); i != NULL; i = wdeque_traverse(false))
-    // {
-    //     src_write_obj_create(i, lv_gui_c_fp);
-    // }
+    bool res = true;
+    out.fp = NULL;
+    if(!gen_split)
+    {
+        res = out_begin(&out);
+        if(res)
+        {
+            fputs("#include \"lvgl.h\"\n#include \"lv_gui.h\"\n\n", out.fp);
+            if(src_write_img_decl(out.fp, snap, 0, snap->cnt)) fputs("\n", out.fp);
+            for(s = 0; s < pool->cnt; s++)
+            {
+                fprintf(out.fp, "static const lv_style_t %s = %s;\n\n", pool->names[s], pool->texts[s]);
+            }
+            src_write_theme_fns(out.fp, pool, false);
+        }
+    }
 
+    uint32_t idx;
+    for(idx = 0; idx < sp.cnt; idx++)
+    {
+        gencode_out_t * scr_out = &sp.outs[idx];
+        if(!res)
+        {
+            out_discard(scr_out);
+        }else if(gen_split)
+        {
+            char path[32];
+            snprintf(path, sizeof(path), "lv_gui_screen_%u.c", idx);
+            res = scr_out->fp != NULL && out_end(scr_out, path, dry, size);
+        }else
+        {
+            res = out_append(&out, scr_out);
+        }
+    }
+    free(sp.first);
+    free(sp.outs);
+    if(!res)
+    {
+        out_discard(&out);
+        return false;
+    }
 
-    // fputs("\n}\n", lv_gui_c_fp);
+    if(gen_split)
+    {
+        if(!out_begin(&out)) return false;
+        fputs("#include \"lvgl.h\"\n#include \"lv_gui.h\"\n\n", out.fp);
+    }
+    fprintf(out.fp, "void %s(void)\n{\n    lv_scr_load(screen_0_create());\n}\n", gui_main_name);
+    return out_end(&out, "lv_gui.c", dry, size);
 }
 
-static void src_write_obj_create(lv_obj_t * obj, FILE * lv_gui_c_fp)
+//Render every screen into its own buffer on up to GEN_THREADS threads. Only the calling thread reports the progress.
+static bool screens_render(screen_pool_t * sp, const projsnap_t * snap, const style_pool_t * pool,
+                           projsnap_step_cb_t step_cb)
 {
-    widget_info_t * info = (widget_info_t *)lv_obj_get_user_data(obj);
+    memset(sp, 0, sizeof(screen_pool_t));
+    sp->snap = snap;
+    sp->pool = pool;
+    sp->first = malloc((snap->screen_cnt + 1) * sizeof(uint32_t));
+    sp->outs = calloc(snap->screen_cnt, sizeof(gencode_out_t));
+    if(sp->first == NULL || sp->outs == NULL)
+    {
+        free(sp->first);
+        free(sp->outs);
+        return false;
+    }
+    uint32_t i;
+    for(i = 0; i < snap->cnt && sp->cnt < snap->screen_cnt; i++)
+    {
+        if(snap->nodes[i].depth == 0) sp->first[sp->cnt++] = i;
+    }
+    sp->first[sp->cnt] = snap->cnt;
+
+    //This thread is one of the renderers, without more threads (or CPUs) it renders all the screens
+    pthread_t threads[GEN_THREADS - 1];
+    uint32_t thread_cnt = 0;
+    long cpu_cnt = sysconf(_SC_NPROCESSORS_ONLN);
+    while(thread_cnt < GEN_THREADS - 1 && thread_cnt + 1 < sp->cnt && thread_cnt + 1 < cpu_cnt)
+    {
+        if(pthread_create(&threads[thread_cnt], NULL, screen_worker, sp) != 0) break;
+        thread_cnt++;
+    }
+    uint32_t idx;
+    while((idx = __atomic_fetch_add(&sp->next, 1, __ATOMIC_RELAXED)) < sp->cnt)
+    {
+        screen_render(sp, idx);
+        if(step_cb != NULL) step_cb(__atomic_load_n(&sp->done, __ATOMIC_RELAXED), snap->cnt);
+    }
+    for(i = 0; i < thread_cnt; i++) pthread_join(threads[i], NULL);
+    return true;
+}
 
-    // lv_obj_t * parent = lv_obj_get_parent(obj);
-    // if(parent == NULL || parent == tft_win)
-    // {
-    //     fprintf(lv_gui_c_fp, "lv_obj_t * %s = lv_%s_create(%s, %s);\n", info->id , widget_type_name[info->type], "lv_scr_act()", "NULL");
-    //     return;
-    // }    
-    
-    // widget_info_t * par_info = (widget_info_t *)lv_obj_get_user_data(parent);
-    fprintf(lv_gui_c_fp, "    lv_obj_t * %s = lv_%s_create(%s, %s);\n", info->id , widget_type_name[info->type], "lv_scr_act()", "NULL");
+static void * screen_worker(void * param)
+{
+    screen_pool_t * sp = param;
+    while(1)
+    {
+        uint32_t idx = __atomic_fetch_add(&sp->next, 1, __ATOMIC_RELAXED);
+        if(idx >= sp->cnt) break;
+        screen_render(sp, idx);
+    }
+    return NULL;
 }
 
-static void src_write_obj_attr(lv_obj_t * obj, FILE * lv_gui_c_fp)
+//The code of a screen, a whole file if split. It reads only the snapshot and the pool, so it can run on any thread.
+static void screen_render(screen_pool_t * sp, uint32_t idx)
 {
+    gencode_out_t * out = &sp->outs[idx];
+    uint32_t first = sp->first[idx];
+    uint32_t end = sp->first[idx + 1];
+    if(!out_begin(out)) return;
 
-}
\ No newline at end of file
+    if(gen_split)
+    {
+        fputs("#include \"lvgl.h\"\n#include \"lv_gui.h\"\n\n", out->fp);
+        if(src_write_img_decl(out->fp, sp->snap, first, end)) fputs("\n", out->fp);
+        if(src_write_style_decl(out->fp, sp->snap, sp->pool, first, end)) fputs("\n", out->fp);
+    }
+    code_source_screen_write(out->fp, sp->snap, sp->pool, first, end, idx, NULL);
+    if(!gen_split) fputs("\n", out->fp);
+    __atomic_fetch_add(&sp->done, end - first, __ATOMIC_RELAXED);
+}
+
+/* The screen `idx` of the nodes [first, end), its root is the first one. Its handle is NULL until it's created.
+ * Deleting it frees every widget of it; the target has to load an other screen before deleting the active one. */
+static void code_source_screen_write(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                     uint32_t first, uint32_t end, uint32_t idx, projsnap_step_cb_t step_cb)
+{
+    tpl_set_t tpls;
+    bool tpl_ok = gen_templates && tpl_set_build(&tpls, snap, pool, first + 1, end);
+    if(tpl_ok) tpl_write_builders(lv_gui_c_fp, snap, pool, &tpls);
+    src_write_lazy_builders(snap, pool, tpl_ok ? &tpls : NULL, first + 1, end, lv_gui_c_fp);
+
+    char scr[32];
+    snprintf(scr, sizeof(scr), "lv_gui_screen_%u", idx);
+    fprintf(lv_gui_c_fp, "static lv_obj_t * %s;      /*%s*/\n\n", scr, snap->nodes[first].id);
+    fprintf(lv_gui_c_fp, "lv_obj_t * screen_%u_create(void)\n{\n", idx);
+    fprintf(lv_gui_c_fp, "    if(%s != NULL) return %s;\n\n", scr, scr);
+    fprintf(lv_gui_c_fp, "    %s = lv_obj_create(NULL, NULL);\n", scr);
+    src_write_scr_theme(lv_gui_c_fp, pool, scr);
+    if(step_cb != NULL) step_cb(first + 1, snap->cnt);
+
+    src_write_range(snap, pool, tpl_ok ? &tpls : NULL, first + 1, end, scr, lv_gui_c_fp, step_cb);
+    fprintf(lv_gui_c_fp, "    return %s;\n}\n\n", scr);
+    if(tpl_ok) tpl_set_free(&tpls);
+
+    fprintf(lv_gui_c_fp, "void screen_%u_del(void)\n{\n", idx);
+    fprintf(lv_gui_c_fp, "    if(%s == NULL) return;\n", scr);
+    fprintf(lv_gui_c_fp, "    lv_obj_del(%s);\n", scr);
+    fprintf(lv_gui_c_fp, "    %s = NULL;\n}\n", scr);
+}
+
+//The widgets [first, end) with straight-line calls in the function `fn`, NULL: `lv_gui_main()` on the active screen
+static void code_source_body_write(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                   uint32_t first, uint32_t end, const char * fn, projsnap_step_cb_t step_cb)
+{
+    tpl_set_t tpls;
+    bool tpl_ok = gen_templates && tpl_set_build(&tpls, snap, pool, first, end);
+    if(tpl_ok) tpl_write_builders(lv_gui_c_fp, snap, pool, &tpls);
+    src_write_lazy_builders(snap, pool, tpl_ok ? &tpls : NULL, first, end, lv_gui_c_fp);
+
+    if(fn != NULL)
+    {
+        fprintf(lv_gui_c_fp, "%s\n{\n", fn);
+    }else
+    {
+        fprintf(lv_gui_c_fp, "void %s(void)\n{\n", gui_main_name);
+        src_write_scr_theme(lv_gui_c_fp, pool, "lv_scr_act()");
+    }
+
+    src_write_range(snap, pool, tpl_ok ? &tpls : NULL, first, end, "lv_scr_act()", lv_gui_c_fp, step_cb);
+
+    fputs("}\n", lv_gui_c_fp);
+    if(tpl_ok) tpl_set_free(&tpls);
+}
+
+//`scr`: the parent of the widgets on the screen
+static void src_write_obj_create(const projsnap_t * snap, uint32_t i, const char * scr, FILE * lv_gui_c_fp)
+{
+    const projsnap_node_t * n = &snap->nodes[i];
+    const widget_desc_t * desc = widgetreg_get(n->type);
+    fprintf(lv_gui_c_fp, "    lv_obj_t * %s = %s(%s, %s);\n", n->id, desc->code_create, src_par_name(snap, i, scr), "NULL");
+}
+
+static const char * src_par_name(const projsnap_t * snap, uint32_t i, const char * scr)
+{
+    const projsnap_node_t * n = &snap->nodes[i];
+    if(n->parent != PROJSNAP_NO_PARENT && n->depth > 1) return snap->nodes[n->parent].id;
+    return scr;
+}
+
+//`name`: the widget in the code. `pos`: its position as an expression, NULL: the one of the node.
+static void src_write_obj_attr(const style_pool_t * pool, const projsnap_node_t * n, const char * name, const char * pos,
+                               const char * style, FILE * lv_gui_c_fp)
+{
+    if(theme_has(pool, n->type))
+    {
+        char fn[STYLE_NAME_MAX];
+        theme_fn_name(fn, sizeof(fn), n->type);
+        fprintf(lv_gui_c_fp, "    %s(%s);\n", fn, name);
+    }
+    if(pos != NULL) fprintf(lv_gui_c_fp, "    lv_obj_set_pos(%s, %s);\n", name, pos);
+    else fprintf(lv_gui_c_fp, "    lv_obj_set_pos(%s, %d, %d);\n", name, (int)n->x, (int)n->y);
+    fprintf(lv_gui_c_fp, "    lv_obj_set_size(%s, %d, %d);\n", name, (int)n->w, (int)n->h);
+    if(style != NULL) fprintf(lv_gui_c_fp, "    lv_obj_set_style(%s, &%s);\n", name, style);
+    src_write_obj_props(n, name, lv_gui_c_fp);
+}
+
+//The widget `i`, or the call of its template builder if it's an instance. Returns the next node to write.
+static uint32_t src_write_obj_or_instance(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls,
+                                          uint32_t i, const char * scr, FILE * lv_gui_c_fp)
+{
+    const projsnap_node_t * n = &snap->nodes[i];
+    if(tpls != NULL && tpls->tpl[i - tpls->first] != TPL_NONE)
+    {
+        fprintf(lv_gui_c_fp, "    lv_obj_t * %s = lv_gui_tpl_%u_%d(%s, %d, %d);\n", n->id, tpls->first,
+                (int)tpls->tpl[i - tpls->first], src_par_name(snap, i, scr), (int)n->x, (int)n->y);
+        return tpls->end[i - tpls->first];
+    }
+
+    src_write_obj_create(snap, i, scr, lv_gui_c_fp);
+    src_write_obj_attr(pool, n, n->id, NULL, pool->node_style[i] != PROJSNAP_NO_STYLE ? pool->names[pool->node_style[i]] : NULL,
+                       lv_gui_c_fp);
+    return i + 1;
+}
+
+//The widgets [first, end) with straight-line calls. A lazy subtree is only its root, its builder creates the rest.
+static void src_write_range(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls, uint32_t first,
+                            uint32_t end, const char * scr, FILE * lv_gui_c_fp, projsnap_step_cb_t step_cb)
+{
+    uint32_t i;
+    for(i = first; i < end; )
+    {
+        uint32_t next = src_write_obj_or_instance(snap, pool, tpls, i, scr, lv_gui_c_fp);
+        uint32_t lazy_end = next == i + 1 ? lazy_end_get(snap, i) : 0;
+        if(lazy_end != 0)
+        {
+            src_write_set_lazy(lv_gui_c_fp, &snap->nodes[i], snap->nodes[i].id);
+            next = lazy_end;
+        }
+        i = next;
+        if(step_cb != NULL) step_cb(i, snap->cnt);
+    }
+}
+
+/* A function per lazy subtree of [first, end) creating its widgets on its root `obj`. The nested ones come first,
+ * the builder of their parent refers to them. */
+static void src_write_lazy_builders(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * tpls,
+                                    uint32_t first, uint32_t end, FILE * lv_gui_c_fp)
+{
+    uint32_t i;
+    for(i = end; i > first; i--)
+    {
+        uint32_t lazy_end = lazy_end_get(snap, i - 1);
+        if(lazy_end == 0 || !src_lazy_written(snap, tpls, i - 1)) continue;
+        const projsnap_node_t * n = &snap->nodes[i - 1];
+        fprintf(lv_gui_c_fp, "static void lv_gui_lazy_%s(lv_obj_t * obj)\n{\n", n->id);
+        fprintf(lv_gui_c_fp, "    lv_obj_t * %s = obj;\n", n->id);
+        src_write_range(snap, pool, tpls, i, lazy_end, NULL, lv_gui_c_fp, NULL);
+        fputs("}\n\n", lv_gui_c_fp);
+    }
+}
+
+//Whether the straight-line code has the builder of the lazy subtree `i`: a template instance creates it at once
+static bool src_lazy_written(const projsnap_t * snap, const tpl_set_t * tpls, uint32_t i)
+{
+    uint32_t p;
+    for(p = i; tpls != NULL && p != PROJSNAP_NO_PARENT && p >= tpls->first; p = snap->nodes[p].parent)
+    {
+        if(tpls->tpl[p - tpls->first] != TPL_NONE) return false;
+    }
+    return true;
+}
+
+//`name`: the root of the lazy subtree in the code
+static void src_write_set_lazy(FILE * lv_gui_c_fp, const projsnap_node_t * n, const char * name)
+{
+    fprintf(lv_gui_c_fp, "    lv_obj_set_lazy(%s, lv_gui_lazy_%s, %s);\n", name, n->id,
+            gen_lazy_release ? "true" : "false");
+}
+
+/* The end of the subtree of `i` if the target creates it when it's shown first (see `gencode_set_lazy`), else 0:
+ * a hidden widget with children. Not a drop-down list or roller: their children are on their page. */
+static uint32_t lazy_end_get(const projsnap_t * snap, uint32_t i)
+{
+    const projsnap_node_t * n = &snap->nodes[i];
+    if(!gen_lazy || n->depth == 0 || n->type == WIDGET_TYPE_DDLIST || n->type == WIDGET_TYPE_ROLLER) return 0;
+    if(i + 1 >= snap->cnt || snap->nodes[i + 1].depth <= n->depth) return 0;
+
+    const widget_desc_t * desc = widgetreg_get(n->type);
+    uint8_t v;
+    for(v = 0; v < n->val_cnt; v++)
+    {
+        const widget_attr_desc_t * attr = widgetreg_attr_at(desc, n->vals[v].attr);
+        if(attr != NULL && !strcmp(attr->name, "hidden") && n->vals[v].value != 0) break;
+    }
+    if(v == n->val_cnt) return 0;
+
+    uint32_t end;
+    for(end = i + 1; end < snap->cnt && snap->nodes[end].depth > n->depth; end++);
+    return end;
+}
+
+/* The setters of the attributes of the schema which differ from the created widget's. `name`: the widget in the code.
+ * Returns how many there are, `lv_gui_c_fp` NULL: only count them. */
+static uint32_t src_write_obj_props(const projsnap_node_t * n, const char * name, FILE * lv_gui_c_fp)
+{
+    uint32_t cnt = 0;
+    const widget_attr_desc_t * text_attr = widgetreg_text_attr(n->type);
+    if(text_attr != NULL && text_attr->code != NULL)
+    {
+        const char * text = n->text != NULL ? n->text : "";
+        if(strcmp(text, text_attr->def_text != NULL ? text_attr->def_text : ""))
+        {
+            if(lv_gui_c_fp != NULL) src_write_setter(lv_gui_c_fp, text_attr->code, name, 0, text, text_attr->code_ident);
+            cnt++;
+        }
+    }
+
+    const widget_desc_t * desc = widgetreg_get(n->type);
+    uint8_t i;
+    for(i = 0; i < n->val_cnt; i++)
+    {
+        const widget_attr_desc_t * attr = widgetreg_attr_at(desc, n->vals[i].attr);
+        if(attr == NULL || attr->code == NULL) continue;
+        if(n->vals[i].value != attr->def || attr->code_always)
+        {
+            if(lv_gui_c_fp != NULL) src_write_setter(lv_gui_c_fp, attr->code, name, n->vals[i].value, NULL, false);
+            cnt++;
+        }
+    }
+    return cnt;
+}
+
+//A statement from a template of the schema. `text`: the value is this C string (`ident`: this identifier), NULL: `value`.
+static void src_write_setter(FILE * lv_gui_c_fp, const char * code, const char * name, int32_t value, const char * text,
+                             bool ident)
+{
+    fputs("    ", lv_gui_c_fp);
+    for(; *code != '\0'; code++)
+    {
+        if(code[0] == '%' && code[1] == 'o')
+        {
+            fputs(name, lv_gui_c_fp);
+            code++;
+        }else if(code[0] == '%' && code[1] == 'v')
+        {
+            code++;
+            if(text == NULL)
+            {
+                fprintf(lv_gui_c_fp, "%d", (int)value);
+                continue;
+            }
+            if(ident)
+            {
+                fputs(text, lv_gui_c_fp);
+                continue;
+            }
+            fputc('"', lv_gui_c_fp);
+            const char * c;
+            for(c = text; *c != '\0'; c++)
+            {
+                if(*c == '\n') fputs("\\n", lv_gui_c_fp);
+                else if(*c == '"' || *c == '\\') fprintf(lv_gui_c_fp, "\\%c", *c);
+                else fputc(*c, lv_gui_c_fp);
+            }
+            fputc('"', lv_gui_c_fp);
+        }else
+        {
+            fputc(*code, lv_gui_c_fp);
+        }
+    }
+    fputc('\n', lv_gui_c_fp);
+}
+
+//The styles and theme functions of `lv_gui_style.c` used by the widgets [first, end). Returns whether there was any.
+static bool src_write_style_decl(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                                 uint32_t first, uint32_t end)
+{
+    bool any = false;
+    uint32_t s;
+    for(s = 0; s < pool->node_cnt; s++)
+    {
+        uint32_t i;
+        for(i = first; i < end && pool->node_style[i] != s; i++);
+        if(i == end) continue;
+        fprintf(lv_gui_c_fp, "extern const lv_style_t %s;\n", pool->names[s]);
+        any = true;
+    }
+    if(pool->scr_style == PROJSNAP_NO_STYLE) return any;
+
+    bool scr = false;
+    bool used[WIDGET_TYPE_NUM];
+    memset(used, 0, sizeof(used));
+    uint32_t i;
+    for(i = first; i < end; i++)
+    {
+        if(snap->nodes[i].depth == 0) scr = true;
+        else used[snap->nodes[i].type] = true;
+    }
+    if(scr)
+    {
+        fputs("void lv_gui_theme_scr(lv_obj_t * obj);\n", lv_gui_c_fp);
+        any = true;
+    }
+    widget_type_t type;
+    for(type = 0; type < WIDGET_TYPE_NUM; type++)
+    {
+        if(!used[type] || !theme_has(pool, type)) continue;
+        char fn[STYLE_NAME_MAX];
+        theme_fn_name(fn, sizeof(fn), type);
+        fprintf(lv_gui_c_fp, "void %s(lv_obj_t * obj);\n", fn);
+        any = true;
+    }
+    return any;
+}
+
+//The images the image widgets [first, end) show, e.g. of the baked subtrees. Returns whether there was any.
+static bool src_write_img_decl(FILE * lv_gui_c_fp, const projsnap_t * snap, uint32_t first, uint32_t end)
+{
+    bool any = false;
+    uint32_t i;
+    for(i = first; i < end; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        if(n->type != WIDGET_TYPE_IMG || n->text == NULL || n->text[0] == '\0') continue;
+        fprintf(lv_gui_c_fp, "LV_IMG_DECLARE(%s);\n", n->text);
+        any = true;
+    }
+    return any;
+}
+
+/* The functions setting the styles of the flattened theme on a screen and on the used types, as their create
+ * functions would with the theme initialized. `shared`: called from the other files (`lv_gui_style.c`). */
+static void src_write_theme_fns(FILE * lv_gui_c_fp, const style_pool_t * pool, bool shared)
+{
+    if(pool->scr_style == PROJSNAP_NO_STYLE) return;
+    const char * qual = shared ? "" : "static ";
+    fprintf(lv_gui_c_fp, "%svoid lv_gui_theme_scr(lv_obj_t * obj)\n{\n    lv_obj_set_style(obj, &%s);\n}\n\n", qual,
+            pool->names[pool->scr_style]);
+
+    widget_type_t type;
+    for(type = 0; type < WIDGET_TYPE_NUM; type++)
+    {
+        if(!theme_has(pool, type)) continue;
+        char fn[STYLE_NAME_MAX];
+        theme_fn_name(fn, sizeof(fn), type);
+        fprintf(lv_gui_c_fp, "%svoid %s(lv_obj_t * obj)\n{\n", qual, fn);
+        const widget_theme_style_t * th = widgetreg_get(type)->theme_styles;
+        uint32_t k;
+        for(k = 0; k < WIDGETREG_THEME_MAX && th[k].code != NULL; k++)
+        {
+            if(pool->theme_style[type][k] == PROJSNAP_NO_STYLE) continue;
+            fputs("    ", lv_gui_c_fp);
+            const char * c;
+            for(c = th[k].code; *c != '\0'; c++)
+            {
+                if(c[0] == '%' && c[1] == 'o') fputs("obj", lv_gui_c_fp);
+                else if(c[0] == '%' && c[1] == 'v') fprintf(lv_gui_c_fp, "&%s", pool->names[pool->theme_style[type][k]]);
+                else
+                {
+                    fputc(*c, lv_gui_c_fp);
+                    continue;
+                }
+                c++;
+            }
+            fputc('\n', lv_gui_c_fp);
+        }
+        fputs("}\n\n", lv_gui_c_fp);
+    }
+}
+
+//The styles of the flattened theme on the screen `scr`
+static void src_write_scr_theme(FILE * lv_gui_c_fp, const style_pool_t * pool, const char * scr)
+{
+    if(pool->scr_style != PROJSNAP_NO_STYLE) fprintf(lv_gui_c_fp, "    lv_gui_theme_scr(%s);\n", scr);
+}
+
+//Whether the flattened theme styles the widgets of `type`
+static bool theme_has(const style_pool_t * pool, widget_type_t type)
+{
+    uint32_t k;
+    for(k = 0; k < WIDGETREG_THEME_MAX; k++)
+    {
+        if(pool->theme_style[type][k] != PROJSNAP_NO_STYLE) return true;
+    }
+    return false;
+}
+
+//Named by the create function of the type, e.g. `lv_gui_theme_btn` for `lv_btn_create`
+static void theme_fn_name(char * buf, size_t size, widget_type_t type)
+{
+    const char * create = widgetreg_get(type)->code_create;
+    size_t len = strlen(create);
+    if(len > strlen("lv__create")) snprintf(buf, size, "lv_gui_theme_%.*s", (int)(len - strlen("lv__create")), create + 3);
+    else snprintf(buf, size, "lv_gui_theme_%u", (unsigned)type);
+}
+
+/* Find the repeated subtrees of [first, end): equal but for the position and the IDs of their roots.
+ * The hash of a subtree folds in its children's bottom up, the equal hashes are sorted next to each other
+ * and checked node by node. The outermost repeated subtrees become the instances, in preorder. */
+static bool tpl_set_build(tpl_set_t * set, const projsnap_t * snap, const style_pool_t * pool, uint32_t first, uint32_t end)
+{
+    memset(set, 0, sizeof(tpl_set_t));
+    set->first = first;
+    if(end <= first) return false;
+    uint32_t cnt = end - first;
+    set->end = malloc(cnt * sizeof(uint32_t));
+    set->hash = malloc(cnt * sizeof(uint64_t));
+    set->tpl = malloc(cnt * sizeof(int32_t));
+    set->rep = malloc(cnt * sizeof(uint32_t));
+    set->cnt = malloc(cnt * sizeof(uint32_t));
+    uint32_t * group = malloc(cnt * sizeof(uint32_t));     //First the stack of the open nodes, then the group of a node
+    int32_t * group_tpl = malloc(cnt * sizeof(int32_t));
+    tpl_cand_t * cands = malloc(cnt * sizeof(tpl_cand_t));
+    if(set->end == NULL || set->hash == NULL || set->tpl == NULL || set->rep == NULL || set->cnt == NULL ||
+       group == NULL || group_tpl == NULL || cands == NULL)
+    {
+        free(group);
+        free(group_tpl);
+        free(cands);
+        tpl_set_free(set);
+        return false;
+    }
+
+    uint32_t sp = 0;
+    uint32_t i;
+    for(i = first; i < end; i++)
+    {
+        while(sp > 0 && snap->nodes[group[sp - 1]].depth >= snap->nodes[i].depth) set->end[group[--sp] - first] = i;
+        group[sp++] = i;
+    }
+    while(sp > 0) set->end[group[--sp] - first] = end;
+
+    uint32_t cand_cnt = 0;
+    for(i = end; i-- > first; )
+    {
+        uint64_t h = tpl_node_hash(snap, pool, i);
+        uint32_t c;
+        for(c = i + 1; c < set->end[i - first]; c = set->end[c - first])
+        {
+            int32_t pos[2] = {snap->nodes[c].x, snap->nodes[c].y};
+            h = tpl_hash_add(h, &set->hash[c - first], sizeof(uint64_t));
+            h = tpl_hash_add(h, pos, sizeof(pos));
+        }
+        set->hash[i - first] = h;
+        set->tpl[i - first] = TPL_NONE;
+        group[i - first] = UINT32_MAX;
+        group_tpl[i - first] = TPL_NONE;
+        if(set->end[i - first] - i >= TPL_NODES_MIN)
+        {
+            cands[cand_cnt].hash = h;
+            cands[cand_cnt].node = i;
+            cand_cnt++;
+        }
+    }
+
+    //A group is named by its first member, a colliding but different subtree stays alone
+    qsort(cands, cand_cnt, sizeof(tpl_cand_t), tpl_cand_cmp);
+    uint32_t c;
+    uint32_t run;
+    for(run = 0; run < cand_cnt; run = c)
+    {
+        for(c = run + 1; c < cand_cnt && cands[c].hash == cands[run].hash; c++)
+        {
+            if(tpl_subtree_equal(snap, pool, set, cands[run].node, cands[c].node))
+            {
+                group[cands[run].node - first] = cands[run].node;
+                group[cands[c].node - first] = cands[run].node;
+            }
+        }
+    }
+
+    for(i = first; i < end; )
+    {
+        uint32_t g = group[i - first];
+        if(g == UINT32_MAX)
+        {
+            i++;
+            continue;
+        }
+        int32_t t = group_tpl[g - first];
+        if(t == TPL_NONE)
+        {
+            t = set->tpl_cnt++;
+            group_tpl[g - first] = t;
+            set->rep[t] = i;
+            set->cnt[t] = 0;
+        }
+        set->tpl[i - first] = t;
+        set->cnt[t]++;
+        i = set->end[i - first];
+    }
+
+    //The others were inside instances of bigger templates
+    uint32_t t;
+    uint32_t kept = 0;
+    for(t = 0; t < set->tpl_cnt; t++)
+    {
+        if(set->cnt[t] < 2)
+        {
+            group_tpl[t] = TPL_NONE;
+            continue;
+        }
+        set->rep[kept] = set->rep[t];
+        set->cnt[kept] = set->cnt[t];
+        group_tpl[t] = kept++;
+    }
+    for(i = 0; i < cnt; i++)
+    {
+        if(set->tpl[i] != TPL_NONE) set->tpl[i] = group_tpl[set->tpl[i]];
+    }
+    set->tpl_cnt = kept;
+    //The screens are searched on several threads
+    for(t = 0; t < kept; t++)
+    {
+        __atomic_fetch_add(&last_report.templates, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&last_report.tpl_instances, set->cnt[t], __ATOMIC_RELAXED);
+    }
+
+    free(group);
+    free(group_tpl);
+    free(cands);
+    return true;
+}
+
+static void tpl_set_free(tpl_set_t * set)
+{
+    free(set->end);
+    free(set->hash);
+    free(set->tpl);
+    free(set->rep);
+    free(set->cnt);
+    memset(set, 0, sizeof(tpl_set_t));
+}
+
+//Of what the code of a widget has besides its position, ID and children
+static uint64_t tpl_node_hash(const projsnap_t * snap, const style_pool_t * pool, uint32_t i)
+{
+    const projsnap_node_t * n = &snap->nodes[i];
+    int32_t f[4] = {n->type, n->w, n->h, (int32_t)pool->node_style[i]};
+    uint64_t h = tpl_hash_add(TPL_HASH_INIT, f, sizeof(f));
+    if(n->text != NULL) h = tpl_hash_add(h, n->text, strlen(n->text) + 1);
+    uint8_t v;
+    for(v = 0; v < n->val_cnt; v++)
+    {
+        int32_t a[2] = {n->vals[v].attr, n->vals[v].value};
+        h = tpl_hash_add(h, a, sizeof(a));
+    }
+    return h;
+}
+
+//FNV-1a 64
+static uint64_t tpl_hash_add(uint64_t h, const void * data, size_t len)
+{
+    const uint8_t * d = data;
+    size_t i;
+    for(i = 0; i < len; i++)
+    {
+        h ^= d[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static int tpl_cand_cmp(const void * a, const void * b)
+{
+    const tpl_cand_t * ca = a;
+    const tpl_cand_t * cb = b;
+    if(ca->hash != cb->hash) return ca->hash < cb->hash ? -1 : 1;
+    return (ca->node > cb->node) - (ca->node < cb->node);
+}
+
+//The subtrees of `a` and `b` would be written the same but for the position and the ID of their roots
+static bool tpl_subtree_equal(const projsnap_t * snap, const style_pool_t * pool, const tpl_set_t * set,
+                              uint32_t a, uint32_t b)
+{
+    uint32_t size = set->end[a - set->first] - a;
+    if(set->end[b - set->first] - b != size) return false;
+    uint32_t k;
+    for(k = 0; k < size; k++)
+    {
+        const projsnap_node_t * na = &snap->nodes[a + k];
+        const projsnap_node_t * nb = &snap->nodes[b + k];
+        if(na->type != nb->type || na->w != nb->w || na->h != nb->h) return false;
+        if(pool->node_style[a + k] != pool->node_style[b + k]) return false;
+        if(k > 0 && (na->x != nb->x || na->y != nb->y || na->parent - a != nb->parent - b)) return false;
+        if((na->text == NULL) != (nb->text == NULL)) return false;
+        if(na->text != NULL && strcmp(na->text, nb->text)) return false;
+        if(na->val_cnt != nb->val_cnt) return false;
+        uint8_t v;
+        for(v = 0; v < na->val_cnt; v++)
+        {
+            if(na->vals[v].attr != nb->vals[v].attr || na->vals[v].value != nb->vals[v].value) return false;
+        }
+    }
+    return true;
+}
+
+//A function per template creating its subtree on `par` at `x`, `y`. The widgets in it are named by their offset.
+static void tpl_write_builders(FILE * lv_gui_c_fp, const projsnap_t * snap, const style_pool_t * pool,
+                               const tpl_set_t * set)
+{
+    uint32_t t;
+    for(t = 0; t < set->tpl_cnt; t++)
+    {
+        uint32_t r = set->rep[t];
+        uint32_t r_end = set->end[r - set->first];
+        fprintf(lv_gui_c_fp, "/*%u instances, e.g. %s*/\n", set->cnt[t], snap->nodes[r].id);
+        fprintf(lv_gui_c_fp, "static lv_obj_t * lv_gui_tpl_%u_%u(lv_obj_t * par, lv_coord_t x, lv_coord_t y)\n{\n",
+                set->first, t);
+        uint32_t i;
+        for(i = r; i < r_end; i++)
+        {
+            const projsnap_node_t * n = &snap->nodes[i];
+            char name[16];
+            char par[16];
+            snprintf(name, sizeof(name), "o%u", i - r);
+            if(i == r) strcpy(par, "par");
+            else snprintf(par, sizeof(par), "o%u", n->parent - r);
+            fprintf(lv_gui_c_fp, "    lv_obj_t * %s = %s(%s, NULL);\n", name, widgetreg_get(n->type)->code_create, par);
+            src_write_obj_attr(pool, n, name, i == r ? "x, y" : NULL,
+                               pool->node_style[i] != PROJSNAP_NO_STYLE ? pool->names[pool->node_style[i]] : NULL,
+                               lv_gui_c_fp);
+        }
+        fputs("    return o0;\n}\n\n", lv_gui_c_fp);
+    }
+}
+
+/* One const row per widget of [first, end) in creation order and a loop creating them.
+ * `part`: the ID of the screen, its function fills the `objs` array given by `lv_gui_main()`.
+ * NULL: the function is `lv_gui_main()` filling `lv_gui_obj`. */
+static void code_source_table_write(FILE * lv_gui_c_fp, const projsnap_t * snap, style_pool_t * pool,
+                                    uint32_t first, uint32_t end, const char * part, projsnap_step_cb_t step_cb)
+{
+    uint32_t cnt = end - first;
+
+    //Only the used create functions and styles get into the tables
+    int32_t type_idx[WIDGET_TYPE_NUM];
+    uint32_t type_cnt = 0;
+    uint32_t style_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < WIDGET_TYPE_NUM; i++) type_idx[i] = -1;
+    for(i = first; i < end; i++)
+    {
+        if(type_idx[snap->nodes[i].type] < 0) type_idx[snap->nodes[i].type] = type_cnt++;
+    }
+    uint32_t s;
+    for(s = 0; s < pool->cnt; s++) pool->style_idx[s] = -1;
+    for(i = first; i < end; i++)
+    {
+        s = pool->node_style[i];
+        if(s != PROJSNAP_NO_STYLE && pool->style_idx[s] < 0) pool->style_idx[s] = style_cnt++;
+    }
+
+    fprintf(lv_gui_c_fp, "#define LV_GUI_OBJ_NUM %u\n", cnt);
+    fputs("#define LV_GUI_PAR_SCR 0xFFFF      /*The parent is the active screen*/\n", lv_gui_c_fp);
+    if(style_cnt > 0) fputs("#define LV_GUI_STYLE_NONE 0xFFFF   /*The style given by the theme*/\n", lv_gui_c_fp);
+    fputs("\ntypedef struct\n{\n"
+          "    uint16_t parent;            /*Index of the parent (always a preceding row) or LV_GUI_PAR_SCR*/\n"
+          "    uint8_t type;               /*Index in `lv_gui_create_tbl`*/\n"
+          "    lv_coord_t x, y, w, h;\n", lv_gui_c_fp);
+    //Without custom styles the column isn't worth its bytes
+    if(style_cnt > 0) fputs("    uint16_t style;             /*Index in `lv_gui_style_tbl` or LV_GUI_STYLE_NONE*/\n", lv_gui_c_fp);
+    fputs("} lv_gui_desc_t;\n\n", lv_gui_c_fp);
+
+    if(style_cnt > 0)
+    {
+        fputs("static const lv_style_t * const lv_gui_style_tbl[] = {\n", lv_gui_c_fp);
+        uint32_t t;
+        for(t = 0; t < style_cnt; t++)
+        {
+            for(s = 0; pool->style_idx[s] != (int32_t)t; s++);
+            fprintf(lv_gui_c_fp, "    &%s,\n", pool->names[s]);
+        }
+        fputs("};\n\n", lv_gui_c_fp);
+    }
+
+    fputs("static lv_obj_t * (* const lv_gui_create_tbl[])(lv_obj_t * par, const lv_obj_t * copy) = {\n", lv_gui_c_fp);
+    uint32_t t;
+    for(t = 0; t < type_cnt; t++)
+    {
+        widget_type_t type;
+        for(type = 0; type_idx[type] != (int32_t)t; type++);
+        fprintf(lv_gui_c_fp, "    %s,\n", widgetreg_get(type)->code_create);
+    }
+    fputs("};\n\n", lv_gui_c_fp);
+
+    bool themed = false;
+    for(t = 0; t < type_cnt; t++)
+    {
+        widget_type_t type;
+        for(type = 0; type_idx[type] != (int32_t)t; type++);
+        if(theme_has(pool, type)) themed = true;
+    }
+    if(themed)
+    {
+        fputs("/*Sets the styles of the flattened theme, NULL: the type has none*/\n"
+              "static void (* const lv_gui_theme_tbl[])(lv_obj_t * obj) = {\n", lv_gui_c_fp);
+        for(t = 0; t < type_cnt; t++)
+        {
+            widget_type_t type;
+            for(type = 0; type_idx[type] != (int32_t)t; type++);
+            char fn[STYLE_NAME_MAX];
+            if(theme_has(pool, type)) theme_fn_name(fn, sizeof(fn), type);
+            else strcpy(fn, "NULL");
+            fprintf(lv_gui_c_fp, "    %s,\n", fn);
+        }
+        fputs("};\n\n", lv_gui_c_fp);
+    }
+
+    fputs("static const lv_gui_desc_t lv_gui_tbl[LV_GUI_OBJ_NUM] = {\n", lv_gui_c_fp);
+    for(i = first; i < end; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        if(n->depth > 1) fprintf(lv_gui_c_fp, "    {%u, ", n->parent - first);
+        else fputs("    {LV_GUI_PAR_SCR, ", lv_gui_c_fp);
+        fprintf(lv_gui_c_fp, "%d, %d, %d, %d, %d", (int)type_idx[n->type], (int)n->x, (int)n->y, (int)n->w, (int)n->h);
+        if(style_cnt > 0)
+        {
+            if(pool->node_style[i] != PROJSNAP_NO_STYLE) fprintf(lv_gui_c_fp, ", %d", (int)pool->style_idx[pool->node_style[i]]);
+            else fputs(", LV_GUI_STYLE_NONE", lv_gui_c_fp);
+        }
+        fprintf(lv_gui_c_fp, "},    /*%s*/\n", n->id);
+        if(step_cb != NULL) step_cb(i + 1, snap->cnt);
+    }
+    fputs("};\n\n", lv_gui_c_fp);
+
+    fputs("static void lv_gui_create_rows(lv_obj_t ** objs, uint32_t first, uint32_t end)\n{\n"
+          "    uint32_t i;\n"
+          "    for(i = first; i < end; i++) {\n"
+          "        const lv_gui_desc_t * d = &lv_gui_tbl[i];\n"
+          "        lv_obj_t * par = d->parent == LV_GUI_PAR_SCR ? lv_scr_act() : objs[d->parent];\n"
+          "        lv_obj_t * obj = lv_gui_create_tbl[d->type](par, NULL);\n", lv_gui_c_fp);
+    if(themed) fputs("        if(lv_gui_theme_tbl[d->type] != NULL) lv_gui_theme_tbl[d->type](obj);\n", lv_gui_c_fp);
+    fputs("        lv_obj_set_pos(obj, d->x, d->y);\n"
+          "        lv_obj_set_size(obj, d->w, d->h);\n", lv_gui_c_fp);
+    if(style_cnt > 0) fputs("        if(d->style != LV_GUI_STYLE_NONE) lv_obj_set_style(obj, lv_gui_style_tbl[d->style]);\n",
+                            lv_gui_c_fp);
+    fputs("        objs[i] = obj;\n"
+          "    }\n"
+          "}\n\n", lv_gui_c_fp);
+
+    //The builders of the lazy subtrees run later, a part's `objs` is kept for them
+    uint32_t lazy_cnt = 0;
+    for(i = first; i < end; i++)
+    {
+        if(lazy_end_get(snap, i) != 0) lazy_cnt++;
+    }
+    const char * obj_name = "objs";
+    if(part == NULL)
+    {
+        obj_name = "lv_gui_obj";
+        fputs("lv_obj_t * lv_gui_obj[LV_GUI_OBJ_NUM];\n\n", lv_gui_c_fp);
+    }else if(lazy_cnt > 0)
+    {
+        obj_name = "lv_gui_part_objs";
+        fputs("static lv_obj_t ** lv_gui_part_objs;\n\n", lv_gui_c_fp);
+    }
+    for(i = end; i > first && lazy_cnt > 0; i--)
+    {
+        uint32_t lazy_end = lazy_end_get(snap, i - 1);
+        if(lazy_end == 0) continue;
+        fprintf(lv_gui_c_fp, "static void lv_gui_lazy_%s(lv_obj_t * obj)\n{\n", snap->nodes[i - 1].id);
+        fputs("    (void)obj;                  /*The rows have the index of their parent*/\n", lv_gui_c_fp);
+        table_rows_write(lv_gui_c_fp, snap, first, i, lazy_end, end, obj_name);
+        fputs("}\n\n", lv_gui_c_fp);
+    }
+
+    if(part == NULL)
+    {
+        fprintf(lv_gui_c_fp, "void %s(void)\n{\n", gui_main_name);
+        src_write_scr_theme(lv_gui_c_fp, pool, "lv_scr_act()");
+    }else
+    {
+        fprintf(lv_gui_c_fp, "void lv_gui_part_%s_create(lv_obj_t ** objs)\n{\n", part);
+        if(lazy_cnt > 0) fputs("    lv_gui_part_objs = objs;\n", lv_gui_c_fp);
+    }
+    table_rows_write(lv_gui_c_fp, snap, first, first, end, end, obj_name);
+    fputs("}\n", lv_gui_c_fp);
+}
+
+/* The calls creating the rows [from, to) of the table of [first, end) into `obj_name`, a lazy subtree only its root.
+ * The attributes of the schema aren't table columns, only a few widgets have them. They are set right after
+ * the widget: a text set later would leave a hole (its default text) among the next widgets in `lv_mem`. */
+static void table_rows_write(FILE * lv_gui_c_fp, const projsnap_t * snap, uint32_t first, uint32_t from, uint32_t to,
+                             uint32_t end, const char * obj_name)
+{
+    uint32_t row = from - first;
+    uint32_t i;
+    for(i = from; i < to; i++)
+    {
+        uint32_t lazy_end = lazy_end_get(snap, i);
+        if(src_write_obj_props(&snap->nodes[i], NULL, NULL) == 0 && lazy_end == 0) continue;
+        fprintf(lv_gui_c_fp, "    lv_gui_create_rows(%s, %u, %u);\n", obj_name, row, i - first + 1);
+        char name[32];
+        snprintf(name, sizeof(name), "%s[%u]", obj_name, i - first);
+        src_write_obj_props(&snap->nodes[i], name, lv_gui_c_fp);
+        row = i - first + 1;
+        if(lazy_end == 0) continue;
+        src_write_set_lazy(lv_gui_c_fp, &snap->nodes[i], name);
+        row = lazy_end - first;
+        i = lazy_end - 1;
+    }
+    if(row >= to - first) return;
+    if(to == end) fprintf(lv_gui_c_fp, "    lv_gui_create_rows(%s, %u, LV_GUI_OBJ_NUM);\n", obj_name, row);
+    else fprintf(lv_gui_c_fp, "    lv_gui_create_rows(%s, %u, %u);\n", obj_name, row, to - first);
+}
+
+//The tables can't be empty and the parent index is 16 bit, write straight-line code then.
+//The screens of a multi-screen project are straight-line code too, created and deleted one by one.
+static gencode_mode_t mode_get(const projsnap_t * snap, gencode_mode_t mode)
+{
+    if(mode == GENCODE_TABLE && (snap->cnt < 2 || snap->cnt > 0xFFFF || snap->screen_cnt > 1)) return GENCODE_CALLS;
+    return mode;
+}
+
+/* The whole project as a MicroPython module, `lv_gui.py`. Everything is data read by one loop: a row of a bytes
+ * literal per widget, a tuple per style and per property. Frozen into the firmware (or compiled by mpy-cross)
+ * the literals are constants in flash, so the import runs a few dozen bytecodes however many widgets there are. */
+static bool py_source_write(const projsnap_t * snap, const style_pool_t * pool, uint32_t * size)
+{
+    //The screens have no row, the parent of their widgets is the screen given to `_build()`
+    uint32_t * row = malloc(LV_MATH_MAX(snap->cnt, 1) * sizeof(uint32_t));
+    if(row == NULL) return false;
+    uint32_t rows = 0;
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++) row[i] = snap->nodes[i].depth > 0 ? rows++ : PY_ROW_SCR;
+
+    int32_t type_idx[WIDGET_TYPE_NUM];
+    uint32_t type_cnt = 0;
+    for(i = 0; i < WIDGET_TYPE_NUM; i++) type_idx[i] = -1;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(row[i] != PY_ROW_SCR && type_idx[snap->nodes[i].type] < 0) type_idx[snap->nodes[i].type] = type_cnt++;
+    }
+
+    gencode_out_t out;
+    if(!out_begin(&out))
+    {
+        free(row);
+        return false;
+    }
+    FILE * fp = out.fp;
+    fputs("# Generated by lv_gui_designer from the project, don't edit.\n"
+          "# Freeze it into the firmware (or compile it with mpy-cross): the tables are constants in flash then.\n"
+          "import lvgl as lv\n"
+          "from ustruct import unpack_from\n"
+          "from micropython import const\n\n", fp);
+
+    fputs("# Index of every widget in `objs`\n", fp);
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(row[i] != PY_ROW_SCR) fprintf(fp, "ID_%s = const(%u)\n", snap->nodes[i].id, row[i]);
+    }
+    fprintf(fp, "_N = const(%u)\n\n", rows);
+
+    fputs("_TYPES = (", fp);
+    uint32_t t;
+    for(t = 0; t < type_cnt; t++)
+    {
+        widget_type_t type;
+        for(type = 0; type_idx[type] != (int32_t)t; type++);
+        //`lv_<class>_create` -> `lv.<class>`
+        const char * create = widgetreg_get(type)->code_create;
+        const char * cls = strncmp(create, "lv_", 3) ? create : create + 3;
+        const char * cls_end = strstr(cls, "_create");
+        int len = cls_end != NULL ? (int)(cls_end - cls) : (int)strlen(cls);
+        fprintf(fp, "%slv.%.*s,", t > 0 ? " " : "", len, cls);     //The comma keeps a single one a tuple
+    }
+    fputs(")\n\n", fp);
+
+    py_write_styles(fp, snap, pool);
+
+    //16 bit columns unless the parent indices don't fit
+    bool wide = rows > 0x7FFF;
+    uint32_t row_size = wide ? 7 * 4 : 7 * 2;
+    fprintf(fp, "# Per widget: parent (-1: the screen), type, x, y, w, h, style (-1: the theme's), int%s little endian\n",
+            wide ? "32" : "16");
+    fprintf(fp, "_FMT = '<7%c'\n_ROW = const(%u)\n", wide ? 'i' : 'h', row_size);
+    if(rows == 0) fputs("_TBL = b''\n", fp);
+    else fputs("_TBL = (\n", fp);
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(row[i] == PY_ROW_SCR) continue;
+        const projsnap_node_t * n = &snap->nodes[i];
+        int32_t cols[7];
+        cols[0] = row[n->parent] == PY_ROW_SCR ? -1 : (int32_t)row[n->parent];
+        cols[1] = type_idx[n->type];
+        cols[2] = n->x;
+        cols[3] = n->y;
+        cols[4] = n->w;
+        cols[5] = n->h;
+        cols[6] = pool->node_style[i] != PROJSNAP_NO_STYLE ? (int32_t)pool->node_style[i] : -1;
+        fputs("    b'", fp);
+        uint32_t c;
+        for(c = 0; c < 7; c++)
+        {
+            uint32_t v = (uint32_t)cols[c];
+            fprintf(fp, "\\x%02x\\x%02x", v & 0xFF, (v >> 8) & 0xFF);
+            if(wide) fprintf(fp, "\\x%02x\\x%02x", (v >> 16) & 0xFF, v >> 24);
+        }
+        fprintf(fp, "'  # %s\n", n->id);
+    }
+    if(rows > 0) fputs(")\n", fp);
+    fputs("\n", fp);
+
+    bool res = py_write_props(fp, snap, row);
+
+    fputs("objs = [None] * _N\n"
+          "_st = None\n\n"
+          "def _build(first, end, scr):\n"
+          "    global _st\n"
+          "    if _st is None:\n"
+          "        _st = [_style(d) for d in _STYLES]\n"
+          "    o = objs\n"
+          "    for i in range(first, end):\n"
+          "        p, t, x, y, w, h, s = unpack_from(_FMT, _TBL, i * _ROW)\n"
+          "        obj = _TYPES[t](scr if p < 0 else o[p])\n"
+          "        obj.set_pos(x, y)\n"
+          "        obj.set_size(w, h)\n"
+          "        if s >= 0:\n"
+          "            obj.set_style(_st[s])\n"
+          "        o[i] = obj\n"
+          "    for i, s, v in _PROPS:\n"
+          "        if first <= i < end:\n"
+          "            _SET[s](o[i], v)\n\n", fp);
+
+    if(snap->screen_cnt <= 1)
+    {
+        fputs("def main(scr=None):\n"
+              "    _build(0, _N, scr or lv.scr_act())\n", fp);
+    }else
+    {
+        //Lazy screens like the C code: created when they are needed, deleted to free their widgets
+        fputs("# The rows of every screen\n_SCREENS = (", fp);
+        uint32_t first;
+        uint32_t end;
+        for(first = 0; first < snap->cnt; first = end)
+        {
+            for(end = first + 1; end < snap->cnt && snap->nodes[end].depth > 0; end++);
+            uint32_t r_first = end > first + 1 ? row[first + 1] : 0;
+            uint32_t r_end = end > first + 1 ? row[end - 1] + 1 : 0;
+            fprintf(fp, "(%u, %u), ", r_first, r_end);
+        }
+        fputs(")\n"
+              "_scr = [None] * len(_SCREENS)\n\n"
+              "def screen_create(n):\n"
+              "    if _scr[n] is None:\n"
+              "        _scr[n] = lv.obj()\n"
+              "        _build(_SCREENS[n][0], _SCREENS[n][1], _scr[n])\n"
+              "    return _scr[n]\n\n"
+              "def screen_del(n):\n"
+              "    if _scr[n] is None:\n"
+              "        return\n"
+              "    _scr[n].delete()\n"
+              "    _scr[n] = None\n"
+              "    for i in range(_SCREENS[n][0], _SCREENS[n][1]):\n"
+              "        objs[i] = None\n\n"
+              "def main():\n"
+              "    lv.scr_load(screen_create(0))\n", fp);
+    }
+
+    free(row);
+    if(!res)
+    {
+        fclose(fp);
+        free(out.buf);
+        return false;
+    }
+    last_report.py_table_size = rows * row_size;
+    return out_end(&out, "lv_gui.py", false, size);
+}
+
+//`_STYLES`: the unique styles in the order of the pool, and `_style()` making an `lv.style_t` of one
+static void py_write_styles(FILE * fp, const projsnap_t * snap, const style_pool_t * pool)
+{
+    const char * fonts[PY_FONT_MAX];
+    uint32_t font_cnt = 0;
+    fputs("# Per style: glass; body colour, gradient colour, radius, opa; border colour, width, part, opa;\n"
+          "# shadow colour, width, type; padding top, bottom, left, right, inner; text colour, selection colour,\n"
+          "# font (index in _FONTS, -1: the default one), letter space, line space, opa; image colour, intense, opa;\n"
+          "# line colour, width, opa, rounded\n"
+          "_STYLES = (\n", fp);
+    uint32_t s;
+    for(s = 0; s < pool->node_cnt; s++)
+    {
+        uint32_t i;
+        for(i = 0; pool->node_style[i] != s; i++);      //Every style of the pool has a widget
+        const lv_style_t * st = &snap->styles[snap->nodes[i].style];
+
+        //Only the built-in fonts are known by the target
+        const char * font = style_font_name(st->text.font);
+        int32_t f = -1;
+        if(font[0] == '&' && !ttfont_is(st->text.font))
+        {
+            for(f = 0; f < (int32_t)font_cnt && strcmp(fonts[f], font); f++);
+            if(f == (int32_t)font_cnt)
+            {
+                if(font_cnt < PY_FONT_MAX) fonts[font_cnt++] = font;
+                else f = -1;
+            }
+        }
+
+        const lv_color_t colors[] = {
+            st->body.main_color, st->body.grad_color, st->body.border.color, st->body.shadow.color,
+            st->text.color, st->text.sel_color, st->image.color, st->line.color,
+        };
+        uint32_t c[sizeof(colors) / sizeof(colors[0])];
+        for(i = 0; i < sizeof(colors) / sizeof(colors[0]); i++) c[i] = lv_color_to32(colors[i]) & 0xFFFFFF;
+
+        fprintf(fp, "    (%u, 0x%06x, 0x%06x, %d, %u, 0x%06x, %d, %u, %u, 0x%06x, %d, %u, %d, %d, %d, %d, %d, "
+                "0x%06x, 0x%06x, %d, %d, %d, %u, 0x%06x, %u, %u, 0x%06x, %d, %u, %u),\n",
+                st->glass, c[0], c[1], (int)st->body.radius, st->body.opa,
+                c[2], (int)st->body.border.width, st->body.border.part, st->body.border.opa,
+                c[3], (int)st->body.shadow.width, st->body.shadow.type,
+                (int)st->body.padding.top, (int)st->body.padding.bottom, (int)st->body.padding.left,
+                (int)st->body.padding.right, (int)st->body.padding.inner,
+                c[4], c[5], (int)f, (int)st->text.letter_space, (int)st->text.line_space, st->text.opa,
+                c[6], st->image.intense, st->image.opa,
+                c[7], (int)st->line.width, st->line.opa, st->line.rounded);
+    }
+    fputs(")\n", fp);
+
+    fputs("_FONTS = (", fp);
+    for(s = 0; s < font_cnt; s++) fprintf(fp, "%slv.%s,", s > 0 ? " " : "", fonts[s] + 4);    //`&lv_font_x` -> `lv.font_x`
+    fputs(")\n\n", fp);
+
+    fputs("def _style(d):\n"
+          "    s = lv.style_t()\n"
+          "    lv.style_copy(s, lv.style_plain)\n"
+          "    s.glass = d[0]\n"
+          "    s.body.main_color = lv.color_hex(d[1])\n"
+          "    s.body.grad_color = lv.color_hex(d[2])\n"
+          "    s.body.radius = d[3]\n"
+          "    s.body.opa = d[4]\n"
+          "    s.body.border.color = lv.color_hex(d[5])\n"
+          "    s.body.border.width = d[6]\n"
+          "    s.body.border.part = d[7]\n"
+          "    s.body.border.opa = d[8]\n"
+          "    s.body.shadow.color = lv.color_hex(d[9])\n"
+          "    s.body.shadow.width = d[10]\n"
+          "    s.body.shadow.type = d[11]\n"
+          "    s.body.padding.top = d[12]\n"
+          "    s.body.padding.bottom = d[13]\n"
+          "    s.body.padding.left = d[14]\n"
+          "    s.body.padding.right = d[15]\n"
+          "    s.body.padding.inner = d[16]\n"
+          "    s.text.color = lv.color_hex(d[17])\n"
+          "    s.text.sel_color = lv.color_hex(d[18])\n"
+          "    if d[19] >= 0:\n"
+          "        s.text.font = _FONTS[d[19]]\n"
+          "    s.text.letter_space = d[20]\n"
+          "    s.text.line_space = d[21]\n"
+          "    s.text.opa = d[22]\n"
+          "    s.image.color = lv.color_hex(d[23])\n"
+          "    s.image.intense = d[24]\n"
+          "    s.image.opa = d[25]\n"
+          "    s.line.color = lv.color_hex(d[26])\n"
+          "    s.line.width = d[27]\n"
+          "    s.line.opa = d[28]\n"
+          "    s.line.rounded = d[29]\n"
+          "    return s\n\n", fp);
+}
+
+//`_PROPS`: the properties differing from the created widget's as in `src_write_obj_props()`,
+//and `_SET`: a setter of the schema per used property
+static bool py_write_props(FILE * fp, const projsnap_t * snap, const uint32_t * row)
+{
+    const widget_attr_desc_t ** setters = NULL;
+    uint32_t setter_cnt = 0;
+    bool res = true;
+
+    fputs("# Per property: widget, setter, value\n_PROPS = (\n", fp);
+    uint32_t i;
+    for(i = 0; i < snap->cnt && res; i++)
+    {
+        if(row[i] == PY_ROW_SCR) continue;
+        const projsnap_node_t * n = &snap->nodes[i];
+        const widget_attr_desc_t * text_attr = widgetreg_text_attr(n->type);
+        if(text_attr != NULL && text_attr->code_py != NULL)
+        {
+            const char * text = n->text != NULL ? n->text : "";
+            if(strcmp(text, text_attr->def_text != NULL ? text_attr->def_text : ""))
+            {
+                int32_t s = py_setter_idx(&setters, &setter_cnt, text_attr);
+                if(s < 0) res = false;
+                else py_write_prop(fp, row[i], s, 0, text);
+            }
+        }
+
+        const widget_desc_t * desc = widgetreg_get(n->type);
+        uint8_t v;
+        for(v = 0; v < n->val_cnt && res; v++)
+        {
+            const widget_attr_desc_t * attr = widgetreg_attr_at(desc, n->vals[v].attr);
+            if(attr == NULL || attr->code_py == NULL) continue;
+            if(n->vals[v].value == attr->def && !attr->code_always) continue;
+            int32_t s = py_setter_idx(&setters, &setter_cnt, attr);
+            if(s < 0) res = false;
+            else py_write_prop(fp, row[i], s, n->vals[v].value, NULL);
+        }
+    }
+    fputs(")\n\n_SET = (\n", fp);
+    for(i = 0; i < setter_cnt; i++)
+    {
+        fputs("    lambda o, v: ", fp);
+        py_write_template(fp, setters[i]->code_py);
+        fputs(",\n", fp);
+    }
+    fputs(")\n\n", fp);
+    free(setters);
+    return res;
+}
+
+//Index of the setter of `attr` in `_SET`, it's added if it's new. -1: out of memory
+static int32_t py_setter_idx(const widget_attr_desc_t *** setters, uint32_t * cnt, const widget_attr_desc_t * attr)
+{
+    uint32_t s;
+    for(s = 0; s < *cnt; s++)
+    {
+        if((*setters)[s] == attr) return s;
+    }
+    if((*cnt & 7) == 0)
+    {
+        const widget_attr_desc_t ** p = realloc(*setters, (*cnt + 8) * sizeof(widget_attr_desc_t *));
+        if(p == NULL) return -1;
+        *setters = p;
+    }
+    (*setters)[*cnt] = attr;
+    return (*cnt)++;
+}
+
+//A row of `_PROPS`. `text`: the value is this string, NULL: `value`.
+static void py_write_prop(FILE * fp, uint32_t row, int32_t setter, int32_t value, const char * text)
+{
+    fprintf(fp, "    (%u, %d, ", row, (int)setter);
+    if(text != NULL) py_write_str(fp, text);
+    else fprintf(fp, "%d", (int)value);
+    fputs("),\n", fp);
+}
+
+static void py_write_str(FILE * fp, const char * text)
+{
+    fputc('\'', fp);
+    const char * c;
+    for(c = text; *c != '\0'; c++)
+    {
+        if(*c == '\n') fputs("\\n", fp);
+        else if(*c == '\'' || *c == '\\') fprintf(fp, "\\%c", *c);
+        else if((uint8_t)*c < 0x20) fprintf(fp, "\\x%02x", (uint8_t)*c);
+        else fputc(*c, fp);         //UTF-8 as it is, the source is UTF-8
+    }
+    fputc('\'', fp);
+}
+
+//The body of a setter lambda from `code_py` of the schema: `%o` is `o`, `%v` is `v`
+static void py_write_template(FILE * fp, const char * code)
+{
+    for(; *code != '\0'; code++)
+    {
+        if(code[0] == '%' && (code[1] == 'o' || code[1] == 'v')) code++;
+        fputc(*code, fp);
+    }
+}
+
+//Deduplicate the customized styles by their initializers, so padding bytes or copies of a style don't matter.
+//The styles of the flattened theme follow them.
+static bool style_pool_build(style_pool_t * pool, const projsnap_t * snap)
+{
+    memset(pool, 0, sizeof(style_pool_t));
+    pool->scr_style = PROJSNAP_NO_STYLE;
+    widget_type_t type;
+    uint32_t k;
+    for(type = 0; type < WIDGET_TYPE_NUM; type++)
+    {
+        for(k = 0; k < WIDGETREG_THEME_MAX; k++) pool->theme_style[type][k] = PROJSNAP_NO_STYLE;
+    }
+
+    //It builds its styles into static ones of its own, the designer's theme has copies of them
+    lv_theme_t * th = NULL;
+    if(gen_theme >= 0 && gen_theme_flat && conf_theme_inits[gen_theme] != NULL)
+    {
+        th = conf_theme_inits[gen_theme](gen_theme_hue, NULL);
+    }
+    uint32_t max = snap->style_cnt + (th != NULL ? (WIDGET_TYPE_NUM + 1) * WIDGETREG_THEME_MAX : 0);
+
+    pool->node_style = malloc((snap->cnt + 1) * sizeof(uint32_t));
+    if(max > 0)
+    {
+        pool->hashes = malloc(max * sizeof(uint32_t));
+        pool->texts = calloc(max, sizeof(char *));
+        pool->names = malloc(max * STYLE_NAME_MAX);
+        pool->style_idx = malloc(max * sizeof(int32_t));
+    }
+    if(pool->node_style == NULL || (max > 0 && (pool->hashes == NULL || pool->texts == NULL ||
+                                                pool->names == NULL || pool->style_idx == NULL)))
+    {
+        style_pool_free(pool);
+        return false;
+    }
+
+    //The widgets sharing an interned style share its copy in the snapshot, write it only once
+    uint32_t * snap_pool = malloc(LV_MATH_MAX(snap->style_cnt, 1) * sizeof(uint32_t));
+    if(snap_pool == NULL)
+    {
+        style_pool_free(pool);
+        return false;
+    }
+
+    char buf[STYLE_TEXT_MAX];
+    uint32_t i;
+    for(i = 0; i < snap->style_cnt; i++) snap_pool[i] = PROJSNAP_NO_STYLE;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        pool->node_style[i] = PROJSNAP_NO_STYLE;
+        uint32_t snap_style = snap->nodes[i].style;
+        if(snap_style == PROJSNAP_NO_STYLE) continue;
+        if(snap_pool[snap_style] != PROJSNAP_NO_STYLE)
+        {
+            pool->node_style[i] = snap_pool[snap_style];
+            continue;
+        }
+
+        style_init_write(buf, &snap->styles[snap_style]);
+        uint32_t s = style_pool_add(pool, buf);
+        if(s == PROJSNAP_NO_STYLE)
+        {
+            free(snap_pool);
+            style_pool_free(pool);
+            return false;
+        }
+        pool->node_style[i] = s;
+        snap_pool[snap_style] = s;
+    }
+    free(snap_pool);
+    pool->node_cnt = pool->cnt;
+
+    if(th != NULL && !style_pool_add_theme(pool, snap, th))
+    {
+        style_pool_free(pool);
+        return false;
+    }
+    return true;
+}
+
+//The index of the style of the initializer `buf`, added if it's new. PROJSNAP_NO_STYLE: out of memory.
+static uint32_t style_pool_add(style_pool_t * pool, const char * buf)
+{
+    uint32_t hash = hash_get(buf, strlen(buf));
+    uint32_t s;
+    for(s = 0; s < pool->cnt; s++)
+    {
+        if(pool->hashes[s] == hash && strcmp(pool->texts[s], buf) == 0) return s;
+    }
+
+    pool->texts[s] = strdup(buf);
+    if(pool->texts[s] == NULL) return PROJSNAP_NO_STYLE;
+    pool->hashes[s] = hash;
+    //Different styles with the same hash get the index too
+    snprintf(pool->names[s], STYLE_NAME_MAX, "lv_gui_style_%08x", hash);
+    uint32_t k;
+    for(k = 0; k < s && pool->hashes[k] != hash; k++);
+    if(k < s) snprintf(pool->names[s], STYLE_NAME_MAX, "lv_gui_style_%08x_%u", hash, s);
+    pool->cnt++;
+    return s;
+}
+
+//The styles `th` gives to the screens and to the types of the snapshot when they are created
+static bool style_pool_add_theme(style_pool_t * pool, const projsnap_t * snap, const lv_theme_t * th)
+{
+    bool used[WIDGET_TYPE_NUM];
+    memset(used, 0, sizeof(used));
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(snap->nodes[i].depth > 0) used[snap->nodes[i].type] = true;
+    }
+
+    char buf[STYLE_TEXT_MAX];
+    style_init_write(buf, th->style.scr);
+    pool->scr_style = style_pool_add(pool, buf);
+    if(pool->scr_style == PROJSNAP_NO_STYLE) return false;
+
+    widget_type_t type;
+    for(type = 0; type < WIDGET_TYPE_NUM; type++)
+    {
+        const widget_desc_t * desc = widgetreg_get(type);
+        if(!used[type] || desc == NULL || desc->theme_styles == NULL) continue;
+        uint32_t k;
+        for(k = 0; k < WIDGETREG_THEME_MAX && desc->theme_styles[k].code != NULL; k++)
+        {
+            const lv_style_t * st = *(lv_style_t * const *)((const uint8_t *)th + desc->theme_styles[k].th_ofs);
+            if(st == NULL) continue;
+            style_init_write(buf, st);
+            pool->theme_style[type][k] = style_pool_add(pool, buf);
+            if(pool->theme_style[type][k] == PROJSNAP_NO_STYLE) return false;
+        }
+    }
+
+    //The init builds every style it points to, several parts can share one
+    lv_style_t * const * p = (lv_style_t * const *)&th->style;
+    for(i = 0; i < LV_THEME_STYLE_COUNT; i++)
+    {
+        uint32_t k;
+        for(k = 0; k < i && p[k] != p[i]; k++);
+        if(k == i && p[i] != NULL) pool->theme_ram += sizeof(lv_style_t);
+    }
+    return true;
+}
+
+static void style_pool_free(style_pool_t * pool)
+{
+    uint32_t s;
+    for(s = 0; s < pool->cnt; s++) free(pool->texts[s]);
+    free(pool->texts);
+    free(pool->hashes);
+    free(pool->names);
+    free(pool->style_idx);
+    free(pool->node_style);
+    memset(pool, 0, sizeof(style_pool_t));
+}
+
+static void style_init_write(char * buf, const lv_style_t * style)
+{
+    const lv_color_t colors[] = {
+        style->body.main_color, style->body.grad_color, style->body.border.color, style->body.shadow.color,
+        style->text.color, style->text.sel_color, style->image.color, style->line.color,
+    };
+    //Rebuilt from RGB, so the output fits any LV_COLOR_DEPTH
+    char c[sizeof(colors) / sizeof(colors[0])][40];
+    uint32_t i;
+    for(i = 0; i < sizeof(colors) / sizeof(colors[0]); i++)
+    {
+        lv_color32_t c32;
+        c32.full = lv_color_to32(colors[i]);
+        snprintf(c[i], sizeof(c[i]), "LV_COLOR_MAKE(0x%02x, 0x%02x, 0x%02x)", c32.ch.red, c32.ch.green, c32.ch.blue);
+    }
+
+    snprintf(buf, STYLE_TEXT_MAX,
+             "{\n"
+             "    .glass = %u,\n"
+             "    .body = {\n"
+             "        .main_color = %s,\n"
+             "        .grad_color = %s,\n"
+             "        .radius = %d,\n"
+             "        .opa = %u,\n"
+             "        .border = {.color = %s, .width = %d, .part = 0x%02x, .opa = %u},\n"
+             "        .shadow = {.color = %s, .width = %d, .type = %u},\n"
+             "        .padding = {.top = %d, .bottom = %d, .left = %d, .right = %d, .inner = %d},\n"
+             "    },\n"
+             "    .text = {.color = %s, .sel_color = %s, .font = %s, .letter_space = %d, .line_space = %d, .opa = %u},\n"
+             "    .image = {.color = %s, .intense = %u, .opa = %u},\n"
+             "    .line = {.color = %s, .width = %d, .opa = %u, .rounded = %u},\n"
+             "}",
+             style->glass,
+             c[0], c[1], (int)style->body.radius, style->body.opa,
+             c[2], (int)style->body.border.width, style->body.border.part, style->body.border.opa,
+             c[3], (int)style->body.shadow.width, style->body.shadow.type,
+             (int)style->body.padding.top, (int)style->body.padding.bottom, (int)style->body.padding.left,
+             (int)style->body.padding.right, (int)style->body.padding.inner,
+             c[4], c[5], style_font_name(style->text.font), (int)style->text.letter_space,
+             (int)style->text.line_space, style->text.opa,
+             c[6], style->image.intense, style->image.opa,
+             c[7], (int)style->line.width, style->line.opa, style->line.rounded);
+}
+
+static const char * style_font_name(const lv_font_t * font)
+{
+#if LV_FONT_ROBOTO_12
+    if(font == &lv_font_roboto_12) return "&lv_font_roboto_12";
+#endif
+#if LV_FONT_ROBOTO_16
+    if(font == &lv_font_roboto_16) return "&lv_font_roboto_16";
+#endif
+#if LV_FONT_ROBOTO_22
+    if(font == &lv_font_roboto_22) return "&lv_font_roboto_22";
+#endif
+#if LV_FONT_ROBOTO_28
+    if(font == &lv_font_roboto_28) return "&lv_font_roboto_28";
+#endif
+#if LV_FONT_UNSCII_8
+    if(font == &lv_font_unscii_8) return "&lv_font_unscii_8";
+#endif
+    if(ttfont_is(font)) return ttfont_get_ref(font);     //Its subset is written with the code
+    return "LV_FONT_DEFAULT";       //A custom font of the designer, not known by the target
+}
+
+//FNV-1a
+static uint32_t hash_get(const char * data, size_t len)
+{
+    uint32_t hash = 2166136261u;
+    size_t i;
+    for(i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+//The generated text goes to memory first, the file is written only if it changes
+static bool out_begin(gencode_out_t * out)
+{
+    out->buf = NULL;
+    out->len = 0;
+    out->fp = open_memstream(&out->buf, &out->len);
+    return out->fp != NULL;
+}
+
+//`dry`: only add the size to `size`
+static bool out_end(gencode_out_t * out, const char * path, bool dry, uint32_t * size)
+{
+    bool res = !ferror(out->fp);
+    if(fclose(out->fp) != 0) res = false;
+    if(res && size != NULL) *size += out->len;
+    if(res && !dry) res = out_commit(path, out->buf, out->len);
+    free(out->buf);
+    return res;
+}
+
+//Keep the file and its mtime if the content is the same, so the build doesn't recompile it
+static bool out_commit(const char * name, const char * buf, size_t len)
+{
+    uint32_t hash = hash_get(buf, len);
+    out_cache_t * c = out_cache_get(name);
+    if(c != NULL) c->produced = true;
+    char path_buf[OUT_DIR_MAX + OUT_PATH_MAX];
+    const char * path = out_path_get(path_buf, name);
+
+    struct stat st;
+    if(stat(path, &st) == 0 && st.st_size == (off_t)len)
+    {
+        //Written by us with this content and not touched since, or the same anyway
+        bool same = c != NULL && c->hash == hash && c->size == st.st_size && c->mtime == st.st_mtime;
+        if(same || out_file_equal(path, buf, len))
+        {
+            if(c != NULL)
+            {
+                c->hash = hash;
+                c->size = st.st_size;
+                c->mtime = st.st_mtime;
+            }
+            last_report.files_unchanged++;
+            return true;
+        }
+    }
+
+    //The whole buffer with one write
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) return false;
+    size_t pos = 0;
+    while(pos < len)
+    {
+        ssize_t n = write(fd, buf + pos, len - pos);
+        if(n < 0 && errno == EINTR) continue;
+        if(n <= 0) break;
+        pos += n;
+    }
+    bool res = pos == len;
+    if(close(fd) != 0) res = false;
+    last_report.files_written++;
+
+    if(c != NULL)
+    {
+        c->size = -1;
+        if(res && stat(path, &st) == 0)
+        {
+            c->hash = hash;
+            c->size = st.st_size;
+            c->mtime = st.st_mtime;
+        }
+    }
+    return res;
+}
+
+//Close `src` and add what was written into it to `dst`. false: `src` failed.
+static bool out_append(gencode_out_t * dst, gencode_out_t * src)
+{
+    if(src->fp == NULL) return false;
+    bool res = !ferror(src->fp);
+    if(fclose(src->fp) != 0) res = false;
+    if(res) fwrite(src->buf, 1, src->len, dst->fp);
+    free(src->buf);
+    src->fp = NULL;
+    return res;
+}
+
+//Close and drop an output, a NULL `fp` is skipped
+static void out_discard(gencode_out_t * out)
+{
+    if(out->fp == NULL) return;
+    fclose(out->fp);
+    free(out->buf);
+    out->fp = NULL;
+}
+
+static bool out_file_equal(const char * path, const char * buf, size_t len)
+{
+    FILE * fp = fopen(path, "r");
+    if(fp == NULL) return false;
+
+    char chunk[1024];
+    size_t pos = 0;
+    bool same = true;
+    while(same)
+    {
+        size_t n = fread(chunk, 1, sizeof(chunk), fp);
+        if(n == 0) break;
+        if(pos + n > len || memcmp(chunk, buf + pos, n) != 0) same = false;
+        pos += n;
+    }
+    fclose(fp);
+    return same && pos == len;
+}
+
+//NULL if out of memory, the files are compared by their content then
+static out_cache_t * out_cache_get(const char * path)
+{
+    uint32_t i;
+    for(i = 0; i < out_cache_cnt; i++)
+    {
+        if(strcmp(out_cache[i].path, path) == 0) return &out_cache[i];
+    }
+
+    out_cache_t * cache = realloc(out_cache, (out_cache_cnt + 1) * sizeof(out_cache_t));
+    if(cache == NULL) return NULL;
+    out_cache = cache;
+
+    out_cache_t * c = &out_cache[out_cache_cnt++];
+    memset(c, 0, sizeof(out_cache_t));
+    strncpy(c->path, path, OUT_PATH_MAX - 1);
+    c->size = -1;
+    return c;
+}
+
+static void out_cache_clean(void)
+{
+    uint32_t i = 0;
+    while(i < out_cache_cnt)
+    {
+        if(out_cache[i].produced)
+        {
+            i++;
+            continue;
+        }
+        char path[OUT_DIR_MAX + OUT_PATH_MAX];
+        remove(out_path_get(path, out_cache[i].path));
+        out_cache[i] = out_cache[--out_cache_cnt];
+    }
+}
+
+//The path of a generated file in the output directory, `buf` has OUT_DIR_MAX + OUT_PATH_MAX bytes
+static const char * out_path_get(char * buf, const char * path)
+{
+    if(gen_out_dir == NULL) return path;
+    snprintf(buf, OUT_DIR_MAX + OUT_PATH_MAX, "%s/%s", gen_out_dir, path);
+    return buf;
+}
+
+/* Replay the allocations of the generated code in the target's `lv_mem` (heapsim.h). `gen_order`: as the generated
+ * code makes them, false: in tree order with every text copied after the widgets, as `lv_gui_main()` did before.
+ * A multi-screen project switches through its screens HEAP_ROUNDS times, the next screen is created before the
+ * previous one is deleted. */
+static void heap_simulate(const projsnap_t * snap, bool gen_order, gencode_heap_t * res)
+{
+    memset(res, 0, sizeof(gencode_heap_t));
+    heapsim_t sim;
+    heapsim_widget_t * ws = calloc(snap->cnt + HEAP_DISP_OBJS, sizeof(heapsim_widget_t));
+    uint32_t * first = malloc((snap->screen_cnt + 1) * sizeof(uint32_t));
+    if(ws == NULL || first == NULL || !heapsim_init(&sim, gen_heap_size))
+    {
+        free(ws);
+        free(first);
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < HEAP_DISP_OBJS; i++) heapsim_widget_create(&sim, &ws[snap->cnt + i], WIDGET_TYPE_OBJ);
+    uint32_t scr_cnt = 0;
+    for(i = 0; i < snap->cnt && scr_cnt < snap->screen_cnt; i++)
+    {
+        if(snap->nodes[i].depth == 0) first[scr_cnt++] = i;
+    }
+    first[scr_cnt] = snap->cnt;
+
+    if(scr_cnt <= 1)
+    {
+        //The widgets are created on the active screen of the display
+        heap_screen_create(&sim, ws, snap, 1, snap->cnt, gen_order);
+    }else
+    {
+        heap_screen_create(&sim, ws, snap, first[0], first[1], gen_order);
+        uint32_t sw;
+        for(sw = 1; sw <= HEAP_ROUNDS * scr_cnt && sim.fails == 0; sw++)
+        {
+            uint32_t next = sw % scr_cnt;
+            uint32_t prev = (sw - 1) % scr_cnt;
+            heap_screen_create(&sim, ws, snap, first[next], first[next + 1], gen_order);
+            if(sim.fails > 0) break;
+            res->fail_switch = sw;
+
+            //Deleted as `lv_obj_del` does: the children before their parent, the newest first
+            for(i = first[prev + 1]; i > first[prev]; i--) heapsim_widget_del(&sim, &ws[i - 1]);
+        }
+    }
+
+    res->max_used = sim.max_used;
+    res->free_biggest = heapsim_get_free_biggest(&sim);
+    res->frag_pct = heapsim_get_frag_pct(&sim);
+    res->fails = sim.fails;
+    heapsim_deinit(&sim);
+    free(ws);
+    free(first);
+}
+
+//The widgets [first, end) with their texts, the first one is the screen in a multi-screen project. Stops at a failure.
+//`gen_order`: as the generated code creates them, without the lazy subtrees.
+static void heap_screen_create(heapsim_t * sim, heapsim_widget_t * ws, const projsnap_t * snap, uint32_t first,
+                               uint32_t end, bool gen_order)
+{
+    uint32_t i;
+    for(i = first; i < end && sim->fails == 0; i++)
+    {
+        heapsim_widget_create(sim, &ws[i], snap->nodes[i].type);
+        if(!gen_order) continue;
+        heap_text_set(sim, &ws[i], &snap->nodes[i], true);
+        //The generated code doesn't create the lazy children
+        uint32_t lazy_end = lazy_end_get(snap, i);
+        if(lazy_end != 0) i = lazy_end - 1;
+    }
+    if(gen_order) return;
+    for(i = first; i < end && sim->fails == 0; i++) heap_text_set(sim, &ws[i], &snap->nodes[i], false);
+}
+
+//The text setter of the generated code if the text isn't the default one
+static void heap_text_set(heapsim_t * sim, heapsim_widget_t * w, const projsnap_node_t * n, bool gen_order)
+{
+    const widget_attr_desc_t * text_attr = widgetreg_text_attr(n->type);
+    if(text_attr == NULL || text_attr->code == NULL) return;
+    const char * text = n->text != NULL ? n->text : "";
+    if(strcmp(text, text_attr->def_text != NULL ? text_attr->def_text : "") == 0) return;
+    heapsim_widget_set_text(sim, w, text, gen_order && text_attr->code_static);
+}
+
+//`switches`: the screens were switched, else only created
+static void heap_print(const char * name, const gencode_heap_t * heap, bool switches)
+{
+    if(heap->fails > 0 && switches)
+    {
+        printf("    %s out of memory after %u screen switches\n", name, heap->fail_switch);
+        return;
+    }
+    if(heap->fails > 0)
+    {
+        printf("    %s out of memory while creating the widgets\n", name);
+        return;
+    }
+    printf("    %s %u bytes at the peak, largest free block %u bytes (%u%% fragmented)\n",
+           name, heap->max_used, heap->free_biggest, heap->frag_pct);
+}
@@ -22,7 +22,8 @@ extern "C" {
 #include "./lv_ex_conf.h"
 #endif
 
-
+#include <stdbool.h>
+#include "projjob.h"
 
 /*********************
  *      DEFINES
@@ -31,12 +32,97 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+typedef enum
+{
+    GENCODE_CALLS,              //Straight-line calls for every widget
+    GENCODE_TABLE,              //Const tables and a loop interpreting them (smaller code, faster boot)
+    _GENCODE_MODE_NUM,
+}gencode_mode_t;
+
+//The target's `lv_mem` while the generated code creates (and switches) the screens, see heapsim.h
+typedef struct
+{
+    uint32_t max_used;                      //[bytes] at the peak
+    uint32_t free_biggest;                  //[bytes] of the largest free block at the end
+    uint8_t frag_pct;                       //Free memory not in that block at the end
+    uint32_t fails;                         //Allocations which didn't fit, the simulation stops at the first
+    uint32_t fail_switch;                   //Screen switches done before it
+}gencode_heap_t;
+
+typedef struct
+{
+    uint32_t widgets;
+    uint32_t src_size[_GENCODE_MODE_NUM];   //Bytes of the sources (lv_gui.c, or all the files if split) in both modes
+    uint32_t calls;                         //Calls in the straight-line code
+    uint32_t templates;                     //Repeated subtrees written once as a builder function
+    uint32_t tpl_instances;                 //Calls of them
+    uint32_t src_size_expanded;             //Bytes of the straight-line sources without the templates
+    uint32_t table_size;                    //Bytes of the widget table (on the designer's host)
+    uint32_t styled;                        //Widgets with a customized main style
+    uint32_t styles;                        //Unique styles among them, written once as const data
+    uint32_t style_size;                    //Bytes of the const styles
+    uint32_t ram_saved;                     //Bytes of RAM the widgets would take with an own `lv_style_t` each
+    uint32_t images;                        //Converted to the target's colour format, in `lv_gui_img.c`
+    uint32_t images_cached;                 //Taken from the asset store
+    uint32_t image_size;                    //Bytes of their const data
+    uint32_t bakes;                         //Subtrees drawn by the designer, shown by one image each
+    uint32_t bake_widgets;                  //Widgets in them, the generated code doesn't create them
+    uint32_t bake_size;                     //Bytes of the const data of their images, in `lv_gui_img.c` too
+    uint32_t fonts;                         //Subset to the letters of the project, in `lv_gui_font_<font>.c`
+    uint32_t font_glyphs;                   //Kept in them
+    uint32_t font_size;                     //Bytes of their bitmaps and tables
+    uint32_t font_full_size;                //The same of the whole fonts
+    uint32_t fonts_cached;                  //Taken from the asset store
+    uint32_t blobs;                         //Screens exported as UI blobs, `lv_gui*.bin`
+    uint32_t blob_size;                     //Bytes of them
+    uint32_t py_size;                       //Bytes of `lv_gui.py`
+    uint32_t py_table_size;                 //Bytes of its widget table
+    uint32_t theme_styles;                  //Unique styles of the flattened theme used by the widgets, const data
+    uint32_t theme_size;                    //Bytes of them
+    uint32_t theme_ram_saved;               //Bytes of the styles the theme's init would build in RAM
+    uint32_t lazy;                          //Hidden subtrees created by the target when they are shown first
+    uint32_t lazy_widgets;                  //Widgets in them, not created at the start
+    uint32_t conf_widgets;                  //`LV_USE_...` widgets kept on by `lv_gui_conf.h`
+    uint32_t conf_fonts;                    //Built-in fonts used (as they are or as a subset)
+    uint32_t files_written;
+    uint32_t files_unchanged;               //Not rewritten, their mtime is kept
+    uint32_t heap_size;                     //[bytes] of the simulated `lv_mem`
+    gencode_heap_t heap;                    //The generated code in it
+    gencode_heap_t heap_tree;               //The same in tree order, with the texts copied after the widgets
+}gencode_report_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
 void code_generation(void);
+bool code_generation_snap(const projsnap_t * snap, projsnap_step_cb_t step_cb);
+bool code_generation_file(const char * xml_path);
+void gencode_set_mode(gencode_mode_t mode);
+gencode_mode_t gencode_get_mode(void);
+void gencode_set_split(bool split);
+bool gencode_get_split(void);
+void gencode_set_font_subset(bool subset);
+bool gencode_get_font_subset(void);
+void gencode_set_font_chars(const char * chars);
+void gencode_set_font_compress(bool compress);
+void gencode_set_blob(bool blob);
+bool gencode_get_blob(void);
+bool gencode_set_out_dir(const char * dir);
+void gencode_set_templates(bool templates);
+bool gencode_get_templates(void);
+void gencode_set_lazy(bool lazy);
+bool gencode_get_lazy(void);
+void gencode_set_lazy_release(bool release);
+void gencode_set_python(bool python);
+bool gencode_get_python(void);
+bool gencode_set_theme(const char * name);
+const char * gencode_get_theme(void);
+void gencode_set_theme_hue(uint16_t hue);
+void gencode_set_theme_flat(bool flat);
+bool gencode_get_theme_flat(void);
+void gencode_set_heap_size(uint32_t size);
+const gencode_report_t * gencode_get_report(void);
 
 /**********************
  *      MACROS
@@ -0,0 +1,506 @@
+/**
+ * @file headless.c
+ * Render the project without a window, e.g. to take screenshots for visual regression tests.
+ * The screen is drawn into memory with `lv_refr_now` and every screen of the project is written into a file.
+ * Nothing is shared with other processes (no SDL, no autosave), so several projects can be rendered in parallel.
+ * The PNGs can be written in the colours of other targets' depths too, to compare them with one binary.
+ * Or the screens are compared with golden images (`imgcmp.c`) from memory, without writing them.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "headless.h"
+#include "loadproj.h"
+#include "dataset.h"
+#include "imgcmp.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PNG_STORED_MAX      65535       //Max. size of a stored (not compressed) deflate block
+#define PNG_ADLER_MOD       65521
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//The rendered screen. The display driver's user data, the flushed areas are copied here.
+typedef struct
+{
+    lv_color_t * fb;
+    lv_coord_t hres;
+    lv_coord_t vres;
+    const uint8_t * depths;     //Write the PNGs in these colour depths too
+    uint8_t depth_cnt;
+    const char * golden_dir;    //Compare with the PNGs here instead of writing the screens
+    uint8_t tol;                //Allowed difference of the colour channels
+    uint32_t cmp_failed;        //Screens differing from their golden image
+}headless_frame_t;
+
+//An area of the rendered screen written in the colours of `depth`
+typedef struct
+{
+    const headless_frame_t * frame;
+    const lv_area_t * area;
+    uint8_t depth;
+}frame_area_t;
+
+typedef struct
+{
+    const lv_color32_t * px;
+    uint32_t w;
+}color32_img_t;
+
+//Fill a row of a PNG as 8 bit RGB
+typedef void (*png_row_cb_t)(const void * user_data, uint32_t y, uint8_t * rgb);
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void headless_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static bool obj_render(lv_disp_t * disp, lv_obj_t * obj, const char * out_dir, const char * name, headless_fmt_t fmt);
+static void obj_compare(headless_frame_t * frame, const lv_area_t * area, const char * out_dir, const char * name);
+static bool raw_write(FILE * fp, const headless_frame_t * frame, const lv_area_t * area);
+//Compare the rendered area with its golden image right in the frame buffer
+static void obj_compare(headless_frame_t * frame, const lv_area_t * area, const char * out_dir, const char * name)
+{
+    char path[HEADLESS_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.png", frame->golden_dir, name);
+    imgcmp_img_t golden;
+    if(!imgcmp_png_load(path, &golden))
+    {
+        printf("%s: can't read %s\n", name, path);
+        frame->cmp_failed++;
+        return;
+    }
+
+    imgcmp_res_t res;
+    imgcmp_img_t diff;
+    imgcmp_compare(&golden, &frame->fb[(uint32_t)area->y1 * frame->hres + area->x1], frame->hres,
+                   lv_area_get_width(area), lv_area_get_height(area), frame->tol, &res, &diff);
+    imgcmp_img_free(&golden);
+
+    if(res.status == IMGCMP_MATCH)
+    {
+        printf("%s: match\n", name);
+        return;
+    }
+    imgcmp_res_print(name, &res);
+    frame->cmp_failed++;
+    if(diff.px != NULL)
+    {
+        snprintf(path, sizeof(path), "%s/%s_diff.png", out_dir, name);
+        headless_png_save(path, diff.px, diff.w, diff.h);
+        imgcmp_img_free(&diff);
+    }
+}
+
+static bool obj_write(const headless_frame_t * frame, const lv_area_t * area, const char * path, headless_fmt_t fmt,
+                      uint8_t depth);
+static bool png_write(FILE * fp, uint32_t w, uint32_t h, png_row_cb_t row_cb, const void * user_data);
+static void frame_row(const void * user_data, uint32_t y, uint8_t * rgb);
+static void color32_row(const void * user_data, uint32_t y, uint8_t * rgb);
+static bool png_chunk_write(FILE * fp, const uint32_t * crc_tab, const char * type, const uint8_t * data, uint32_t len);
+static uint32_t png_crc(const uint32_t * crc_tab, uint32_t crc, const uint8_t * data, size_t len);
+static void be32_put(uint8_t * p, uint32_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * fmt_names[_HEADLESS_FMT_NUM] = {"png", "raw"};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//_HEADLESS_FMT_NUM for an unknown name
+headless_fmt_t headless_fmt_from_name(const char * name)
+{
+    headless_fmt_t fmt;
+    for(fmt = 0; fmt < _HEADLESS_FMT_NUM; fmt++)
+    {
+        if(!strcmp(name, fmt_names[fmt])) break;
+    }
+    return fmt;
+}
+
+//Parse a comma separated list like "16,8,1" into `depths` (`HEADLESS_DEPTH_MAX` elements). 0: invalid list.
+uint8_t headless_depths_parse(const char * text, uint8_t * depths)
+{
+    uint8_t cnt = 0;
+    while(*text != '\0')
+    {
+        char * end;
+        unsigned long depth = strtoul(text, &end, 10);
+        if(end == text || (depth != 1 && depth != 8 && depth != 16 && depth != 32) || cnt >= HEADLESS_DEPTH_MAX) return 0;
+        depths[cnt++] = depth;
+        if(*end == ',') end++;
+        else if(*end != '\0') return 0;
+        text = end;
+    }
+    return cnt;
+}
+
+//Convert a colour like `LV_COLOR_MAKE` and `lv_color_to32` of a `depth` bit build would do
+void headless_color_to_depth(lv_color32_t * c, uint8_t depth)
+{
+    switch(depth)
+    {
+        case 1:
+            c->full = (c->ch.red | c->ch.green | c->ch.blue) >> 7 ? 0xFFFFFFFF : 0;
+            break;
+        case 8:
+            c->ch.red = (c->ch.red >> 5) * 36;
+            c->ch.green = (c->ch.green >> 5) * 36;
+            c->ch.blue = (c->ch.blue >> 6) * 85;
+            break;
+        case 16:
+            c->ch.red = (c->ch.red >> 3) * 8;
+            c->ch.green = (c->ch.green >> 2) * 4;
+            c->ch.blue = (c->ch.blue >> 3) * 8;
+            break;
+        default:
+            break;
+    }
+}
+
+//Load the project of the working directory onto an in-memory display and write the whole project
+//and then every screen alone into `out_dir` as `<id>.png` (or `.raw`). Call it after `lv_init` instead of creating the GUI.
+//The PNGs are written for the other `depths` too as `<id>_<depth>bpp.png`, in the colours a target of that depth
+//can show, so one binary previews several targets side by side (only the rounding of the mixed colours can differ).
+//With a `golden_dir` the screens are compared from memory with `<golden_dir>/<id>.png` instead, allowing `tol` difference
+//in every colour channel, and only the diff images of the differing ones are written as `<id>_diff.png`.
+bool headless_render(const char * out_dir, headless_fmt_t fmt, const uint8_t * depths, uint8_t depth_cnt,
+                     const char * golden_dir, uint8_t tol)
+{
+    headless_frame_t frame;
+    frame.hres = LV_HOR_RES_MAX;
+    frame.vres = LV_VER_RES_MAX;
+    frame.depths = depths;
+    frame.depth_cnt = depth_cnt;
+    frame.golden_dir = golden_dir;
+    frame.tol = tol;
+    frame.cmp_failed = 0;
+    if(golden_dir != NULL) imgcmp_init();
+    frame.fb = calloc((uint32_t)frame.hres * frame.vres, sizeof(lv_color_t));
+    uint32_t buf_px = (uint32_t)frame.hres * HEADLESS_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    if(frame.fb == NULL || buf == NULL)
+    {
+        printf("Render failed, out of memory\n");
+        free(frame.fb);
+        free(buf);
+        return false;
+    }
+
+    lv_disp_buf_t disp_buf;
+    lv_disp_buf_init(&disp_buf, buf, NULL, buf_px);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = frame.hres;
+    disp_drv.ver_res = frame.vres;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = headless_flush;
+    disp_drv.user_data = &frame;
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    bool res = false;
+    load_project(lv_disp_get_scr_act(disp));
+
+    //The top level widget is the designer's TFT Simulator, its children are the screens
+    lv_obj_t * root = lv_obj_get_child_back(lv_disp_get_scr_act(disp), NULL);
+    if(root == NULL)
+    {
+        printf("Nothing to render\n");
+    }else
+    {
+        lv_obj_set_pos(root, 0, 0);
+        res = obj_render(disp, root, out_dir, "project", fmt);
+
+        lv_obj_t * scr;
+        uint32_t scr_i = 0;
+        for(scr = lv_obj_get_child_back(root, NULL); scr != NULL && res; scr = lv_obj_get_child_back(root, scr))
+        {
+            //Only this screen is shown, even if the project hides it
+            lv_obj_t * other;
+            for(other = lv_obj_get_child_back(root, NULL); other != NULL; other = lv_obj_get_child_back(root, other))
+            {
+                lv_obj_set_hidden(other, other != scr);
+            }
+            char name[32];
+            snprintf(name, sizeof(name), "screen_%u", scr_i++);
+            res = obj_render(disp, scr, out_dir, name, fmt);
+        }
+    }
+    if(res && frame.cmp_failed > 0)
+    {
+        printf("%u image%s differ from %s\n", frame.cmp_failed, frame.cmp_failed > 1 ? "s" : "", golden_dir);
+        res = false;
+    }
+
+    //Nothing may point to the buffers on the stack
+    lv_obj_del(lv_disp_get_scr_act(disp));
+    lv_obj_del(lv_disp_get_layer_top(disp));
+    lv_obj_del(lv_disp_get_layer_sys(disp));
+    lv_disp_remove(disp);
+    free(buf);
+    free(frame.fb);
+    return res;
+}
+
+//Write `w` x `h` pixels into a PNG, e.g. the diff images of `imgcmp`
+bool headless_png_save(const char * path, const lv_color32_t * px, uint32_t w, uint32_t h)
+{
+    FILE * fp = fopen(path, "wb");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+    color32_img_t img = {px, w};
+    bool res = png_write(fp, w, h, color32_row, &img);
+    if(fclose(fp) != 0) res = false;
+    if(!res) printf("Can't write %s\n", path);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void headless_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    headless_frame_t * frame = drv->user_data;
+    uint32_t w = lv_area_get_width(area);
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++)
+    {
+        memcpy(&frame->fb[(uint32_t)y * frame->hres + area->x1], color_p, w * sizeof(lv_color_t));
+        color_p += w;
+    }
+    lv_disp_flush_ready(drv);
+}
+
+//Redraw the screen and write the part of `obj` into a file named by its ID (or by `name` if it has none)
+static bool obj_render(lv_disp_t * disp, lv_obj_t * obj, const char * out_dir, const char * name, headless_fmt_t fmt)
+{
+    headless_frame_t * frame = disp->driver.user_data;
+
+    lv_refr_now(disp);
+
+    lv_area_t scr_area;
+    lv_area_t area;
+    lv_area_set(&scr_area, 0, 0, frame->hres - 1, frame->vres - 1);
+    lv_obj_get_coords(obj, &area);
+    if(!lv_area_intersect(&area, &area, &scr_area))
+    {
+        printf("%s is out of the screen, skipped\n", name);
+        return true;
+    }
+
+    widget_info_t * info = widget_get_info(obj);
+    if(info != NULL && info->id[0] != '\0') name = info->id;
+
+    if(frame->golden_dir != NULL)
+    {
+        obj_compare(frame, &area, out_dir, name);
+        return true;
+    }
+
+    char path[HEADLESS_PATH_MAX];
+    snprintf(path, sizeof(path), "%s/%s.%s", out_dir, name, fmt_names[fmt]);
+    if(!obj_write(frame, &area, path, fmt, LV_COLOR_DEPTH)) return false;
+
+    //The raw pixels are always `lv_color_t`
+    uint8_t i;
+    for(i = 0; i < frame->depth_cnt && fmt == HEADLESS_PNG; i++)
+    {
+        if(frame->depths[i] == LV_COLOR_DEPTH) continue;
+        snprintf(path, sizeof(path), "%s/%s_%ubpp.%s", out_dir, name, frame->depths[i], fmt_names[fmt]);
+        if(!obj_write(frame, &area, path, fmt, frame->depths[i])) return false;
+    }
+    return true;
+}
+
+static bool obj_write(const headless_frame_t * frame, const lv_area_t * area, const char * path, headless_fmt_t fmt,
+                      uint8_t depth)
+{
+    FILE * fp = fopen(path, "wb");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+    frame_area_t fa = {frame, area, depth};
+    bool res = fmt == HEADLESS_RAW ? raw_write(fp, frame, area) :
+               png_write(fp, lv_area_get_width(area), lv_area_get_height(area), frame_row, &fa);
+    if(fclose(fp) != 0) res = false;
+    if(!res)
+    {
+        printf("Can't write %s\n", path);
+        return false;
+    }
+
+    printf("%s: %dx%d\n", path, lv_area_get_width(area), lv_area_get_height(area));
+    return true;
+}
+
+static bool raw_write(FILE * fp, const headless_frame_t * frame, const lv_area_t * area)
+{
+    uint32_t w = lv_area_get_width(area);
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++)
+    {
+        if(fwrite(&frame->fb[(uint32_t)y * frame->hres + area->x1], sizeof(lv_color_t), w, fp) != w) return false;
+    }
+    return true;
+}
+
+//An 8 bit RGB PNG with stored deflate blocks: bigger than a compressed one but needs no zlib
+static bool png_write(FILE * fp, uint32_t w, uint32_t h, png_row_cb_t row_cb, const void * user_data)
+{
+    uint32_t line = 1 + w * 3;                  //Filter type (none) and the pixels
+    uint32_t raw_size = line * h;
+    uint32_t block_cnt = (raw_size + PNG_STORED_MAX - 1) / PNG_STORED_MAX;
+    uint32_t idat_size = 2 + block_cnt * 5 + raw_size + 4;
+
+    uint8_t * idat = malloc(idat_size);
+    uint8_t * row = malloc(line);
+    if(idat == NULL || row == NULL)
+    {
+        free(idat);
+        free(row);
+        return false;
+    }
+
+    uint32_t crc_tab[256];
+    uint32_t n;
+    for(n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+        int k;
+        for(k = 0; k < 8; k++) c = c & 1 ? 0xEDB88320UL ^ (c >> 1) : c >> 1;
+        crc_tab[n] = c;
+    }
+
+    //zlib header, then the scanlines cut into stored blocks
+    uint8_t * p = idat;
+    *p++ = 0x78;
+    *p++ = 0x01;
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    uint32_t block_left = 0;
+    uint32_t raw_left = raw_size;
+    uint32_t y;
+    row[0] = 0;
+    for(y = 0; y < h; y++)
+    {
+        row_cb(user_data, y, &row[1]);
+        uint32_t i;
+        for(i = 0; i < line; i++)
+        {
+            if(block_left == 0)
+            {
+                block_left = raw_left < PNG_STORED_MAX ? raw_left : PNG_STORED_MAX;
+                *p++ = block_left == raw_left ? 1 : 0;      //BFINAL on the last one, BTYPE 00
+                *p++ = block_left & 0xFF;
+                *p++ = block_left >> 8;
+                *p++ = ~block_left & 0xFF;
+                *p++ = (~block_left >> 8) & 0xFF;
+            }
+
+            uint8_t v = row[i];
+            *p++ = v;
+            adler_a = (adler_a + v) % PNG_ADLER_MOD;
+            adler_b = (adler_b + adler_a) % PNG_ADLER_MOD;
+            block_left--;
+            raw_left--;
+        }
+    }
+    be32_put(p, (adler_b << 16) | adler_a);
+    free(row);
+
+    static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    uint8_t ihdr[13];
+    be32_put(&ihdr[0], w);
+    be32_put(&ihdr[4], h);
+    ihdr[8] = 8;            //Bit depth
+    ihdr[9] = 2;            //Truecolor
+    ihdr[10] = 0;           //Deflate
+    ihdr[11] = 0;           //Adaptive filtering
+    ihdr[12] = 0;           //No interlace
+
+    bool res = fwrite(sig, 1, sizeof(sig), fp) == sizeof(sig) &&
+               png_chunk_write(fp, crc_tab, "IHDR", ihdr, sizeof(ihdr)) &&
+               png_chunk_write(fp, crc_tab, "IDAT", idat, idat_size) &&
+               png_chunk_write(fp, crc_tab, "IEND", NULL, 0);
+    free(idat);
+    return res;
+}
+
+//A row of the rendered area in the colours a target with `depth` would show
+static void frame_row(const void * user_data, uint32_t y, uint8_t * rgb)
+{
+    const frame_area_t * fa = user_data;
+    const lv_color_t * px = &fa->frame->fb[(uint32_t)(fa->area->y1 + y) * fa->frame->hres + fa->area->x1];
+    uint32_t w = lv_area_get_width(fa->area);
+    uint32_t x;
+    for(x = 0; x < w; x++)
+    {
+        lv_color32_t c;
+        c.full = lv_color_to32(px[x]);
+        if(fa->depth != LV_COLOR_DEPTH) headless_color_to_depth(&c, fa->depth);
+        *rgb++ = c.ch.red;
+        *rgb++ = c.ch.green;
+        *rgb++ = c.ch.blue;
+    }
+}
+
+//A row of an image of `lv_color32_t` pixels
+static void color32_row(const void * user_data, uint32_t y, uint8_t * rgb)
+{
+    const color32_img_t * img = user_data;
+    const lv_color32_t * px = &img->px[y * img->w];
+    uint32_t x;
+    for(x = 0; x < img->w; x++)
+    {
+        *rgb++ = px[x].ch.red;
+        *rgb++ = px[x].ch.green;
+        *rgb++ = px[x].ch.blue;
+    }
+}
+
+static bool png_chunk_write(FILE * fp, const uint32_t * crc_tab, const char * type, const uint8_t * data, uint32_t len)
+{
+    uint8_t head[8];
+    be32_put(head, len);
+    memcpy(&head[4], type, 4);
+
+    uint32_t crc = png_crc(crc_tab, 0xFFFFFFFFUL, &head[4], 4);
+    if(len > 0) crc = png_crc(crc_tab, crc, data, len);
+    uint8_t tail[4];
+    be32_put(tail, crc ^ 0xFFFFFFFFUL);
+
+    if(fwrite(head, 1, sizeof(head), fp) != sizeof(head)) return false;
+    if(len > 0 && fwrite(data, 1, len, fp) != len) return false;
+    return fwrite(tail, 1, sizeof(tail), fp) == sizeof(tail);
+}
+
+static uint32_t png_crc(const uint32_t * crc_tab, uint32_t crc, const uint8_t * data, size_t len)
+{
+    size_t i;
+    for(i = 0; i < len; i++) crc = crc_tab[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static void be32_put(uint8_t * p, uint32_t v)
+{
+    p[0] = v >> 24;
+    p[1] = v >> 16;
+    p[2] = v >> 8;
+    p[3] = v;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file headless.h
+ *
+ */
+
+#ifndef _HEADLESS_H_
+#define _HEADLESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HEADLESS_BUF_LINES      40      //The display buffer is this many lines of the screen
+#define HEADLESS_PATH_MAX       512
+#define HEADLESS_DEPTH_MAX      4       //Target colour depths in one run (1, 8, 16 and 32)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    HEADLESS_PNG,               //8 bit RGB PNG
+    HEADLESS_RAW,               //The lv_color_t pixels as they are, row by row without a header
+    _HEADLESS_FMT_NUM,
+}headless_fmt_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+headless_fmt_t headless_fmt_from_name(const char * name);
+uint8_t headless_depths_parse(const char * text, uint8_t * depths);
+void headless_color_to_depth(lv_color32_t * c, uint8_t depth);
+bool headless_render(const char * out_dir, headless_fmt_t fmt, const uint8_t * depths, uint8_t depth_cnt,
+                     const char * golden_dir, uint8_t tol);
+bool headless_png_save(const char * path, const lv_color32_t * px, uint32_t w, uint32_t h);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,327 @@
+/**
+ * @file heapsim.c
+ * Replay the allocations of the generated code in a model of the target's `lv_mem`, to see whether its screens
+ * still fit after many switches. It's the first fit allocator of `lv_mem.c` (`LV_MEM_TLSF 0`) entry by entry:
+ * a 4 byte header before every entry, the sizes rounded up to 4, the first free entry large enough is taken and
+ * split, a freed entry is joined only with the free ones after it (`LV_MEM_AUTO_DEFRAG 1`), a smaller `realloc`
+ * truncates in place and a larger one moves.
+ * A widget makes the allocations of its `lv_<type>_create()` of LittlevGL 6: the node in the child list of the
+ * parent, the ext. attributes grown type by type (a check box: container, button, check box) and the inner
+ * objects and texts. The sizes are the designer's, on a 64 bit host the pointers make them a bit pessimistic.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "heapsim.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ENT_USED        0x1U                        //Bit of the header word, the rest is the size of the data
+#define ENT_SIZE(h)     ((h) & ~0x3U)
+#define OBJ_NODE_SIZE   (sizeof(lv_obj_t) + 2 * sizeof(void *))     //With the links of `lv_ll`
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void ent_trunc(heapsim_t * sim, uint32_t e, uint32_t size);
+static void ent_release(heapsim_t * sim, uint32_t e);
+static uint8_t obj_create(heapsim_t * sim, heapsim_widget_t * w);
+static void ext_alloc(heapsim_t * sim, heapsim_widget_t * w, uint8_t o, uint32_t size);
+static uint8_t cont_create(heapsim_t * sim, heapsim_widget_t * w);
+static uint8_t btn_create(heapsim_t * sim, heapsim_widget_t * w);
+static uint8_t label_create(heapsim_t * sim, heapsim_widget_t * w);
+static uint8_t ddlist_create(heapsim_t * sim, heapsim_widget_t * w);
+static void label_set_text(heapsim_t * sim, heapsim_widget_t * w, const char * text, bool static_text);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//An empty work memory of `size` bytes
+bool heapsim_init(heapsim_t * sim, uint32_t size)
+{
+    memset(sim, 0, sizeof(heapsim_t));
+    size &= ~0x3U;
+    if(size < 2 * sizeof(uint32_t)) return false;
+    sim->mem = malloc(size);
+    if(sim->mem == NULL) return false;
+    sim->size = size;
+    sim->mem[0] = size - sizeof(uint32_t);      //One free entry
+    return true;
+}
+
+void heapsim_deinit(heapsim_t * sim)
+{
+    free(sim->mem);
+    sim->mem = NULL;
+}
+
+//Like `lv_mem_alloc`. Returns the allocation (for `heapsim_free`), 0: it didn't fit.
+uint32_t heapsim_alloc(heapsim_t * sim, uint32_t size)
+{
+    if(size == 0) return 0;
+    size = (size + 3) & ~0x3U;
+
+    uint32_t words = sim->size / sizeof(uint32_t);
+    uint32_t e = 0;
+    while(e < words)
+    {
+        uint32_t h = sim->mem[e];
+        if((h & ENT_USED) == 0 && ENT_SIZE(h) >= size)
+        {
+            ent_trunc(sim, e, size);
+            sim->mem[e] |= ENT_USED;
+            sim->used += ENT_SIZE(sim->mem[e]);
+            if(sim->used > sim->max_used) sim->max_used = sim->used;
+            return e + 2;
+        }
+        e += 1 + ENT_SIZE(h) / sizeof(uint32_t);
+    }
+
+    sim->fails++;
+    return 0;
+}
+
+//Like `lv_mem_free`, 0 is ignored
+void heapsim_free(heapsim_t * sim, uint32_t p)
+{
+    if(p == 0) return;
+    uint32_t e = p - 2;
+    sim->used -= ENT_SIZE(sim->mem[e]);
+    ent_release(sim, e);
+}
+
+//Like `lv_mem_realloc`. 0: it didn't fit and `p` is kept.
+uint32_t heapsim_realloc(heapsim_t * sim, uint32_t p, uint32_t size)
+{
+    uint32_t old_size = p != 0 ? ENT_SIZE(sim->mem[p - 2]) : 0;
+    if(old_size == size) return p;
+
+    if(p != 0 && size < old_size)
+    {
+        ent_trunc(sim, p - 2, size);
+        sim->used = sim->used - old_size + ENT_SIZE(sim->mem[p - 2]);
+        return p;
+    }
+
+    uint32_t new_p = heapsim_alloc(sim, size);
+    if(new_p != 0) heapsim_free(sim, p);
+    return new_p;
+}
+
+//[bytes] of the largest free entry, the largest allocation which can succeed
+uint32_t heapsim_get_free_biggest(const heapsim_t * sim)
+{
+    uint32_t words = sim->size / sizeof(uint32_t);
+    uint32_t biggest = 0;
+    uint32_t e;
+    for(e = 0; e < words; e += 1 + ENT_SIZE(sim->mem[e]) / sizeof(uint32_t))
+    {
+        if((sim->mem[e] & ENT_USED) == 0 && ENT_SIZE(sim->mem[e]) > biggest) biggest = ENT_SIZE(sim->mem[e]);
+    }
+    return biggest;
+}
+
+//The free memory not in the largest free entry, as `frag_pct` of `lv_mem_monitor`
+uint8_t heapsim_get_frag_pct(const heapsim_t * sim)
+{
+    uint32_t words = sim->size / sizeof(uint32_t);
+    uint32_t free_size = 0;
+    uint32_t e;
+    for(e = 0; e < words; e += 1 + ENT_SIZE(sim->mem[e]) / sizeof(uint32_t))
+    {
+        if((sim->mem[e] & ENT_USED) == 0) free_size += ENT_SIZE(sim->mem[e]);
+    }
+    if(free_size == 0) return 0;
+    return 100 - (uint8_t)((uint64_t)heapsim_get_free_biggest(sim) * 100 / free_size);
+}
+
+//The allocations of a default widget of `type`, with its default text
+void heapsim_widget_create(heapsim_t * sim, heapsim_widget_t * w, widget_type_t type)
+{
+    memset(w, 0, sizeof(heapsim_widget_t));
+    w->text = HEAPSIM_WIDGET_ALLOC_MAX;
+
+    uint8_t o;
+    switch(type)
+    {
+        case WIDGET_TYPE_LABEL:
+            label_create(sim, w);
+            break;
+        case WIDGET_TYPE_BTN:
+            btn_create(sim, w);
+            break;
+        case WIDGET_TYPE_CB:
+            o = btn_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_cb_ext_t));
+            btn_create(sim, w);                         //The bullet
+            label_create(sim, w);
+            label_set_text(sim, w, "Check box", false);
+            break;
+        case WIDGET_TYPE_DDLIST:
+            ddlist_create(sim, w);
+            break;
+        case WIDGET_TYPE_ROLLER:
+            o = ddlist_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_roller_ext_t));
+            break;
+        case WIDGET_TYPE_BAR:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_bar_ext_t));
+            break;
+        case WIDGET_TYPE_SLIDER:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_bar_ext_t));
+            ext_alloc(sim, w, o, sizeof(lv_slider_ext_t));
+            break;
+        case WIDGET_TYPE_LED:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_led_ext_t));
+            break;
+        case WIDGET_TYPE_GAUGE:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_lmeter_ext_t));
+            ext_alloc(sim, w, o, sizeof(lv_gauge_ext_t));
+            w->alloc[w->cnt++] = heapsim_alloc(sim, sizeof(int16_t));     //The value of the needle
+            break;
+        case WIDGET_TYPE_ARC:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_arc_ext_t));
+            break;
+        case WIDGET_TYPE_CONT:
+            cont_create(sim, w);
+            break;
+        case WIDGET_TYPE_IMG:
+            o = obj_create(sim, w);
+            ext_alloc(sim, w, o, sizeof(lv_img_ext_t));
+            break;
+        default:
+            obj_create(sim, w);
+            break;
+    }
+}
+
+/* The text of a label or a check box, the options of a list. `static_text`: only a pointer to it is kept
+ * (`lv_label_set_static_text`), else it's copied. */
+void heapsim_widget_set_text(heapsim_t * sim, heapsim_widget_t * w, const char * text, bool static_text)
+{
+    if(w->text == HEAPSIM_WIDGET_ALLOC_MAX) return;
+    label_set_text(sim, w, text, static_text);
+}
+
+//Free the allocations as `lv_obj_del` does: the inner objects before the ext. attributes and the node
+void heapsim_widget_del(heapsim_t * sim, heapsim_widget_t * w)
+{
+    while(w->cnt > 0)
+    {
+        w->cnt--;
+        heapsim_free(sim, w->alloc[w->cnt]);
+        w->alloc[w->cnt] = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//`ent_trunc` of `lv_mem.c`: the rest of the entry becomes a free entry if there is room for more than its header
+static void ent_trunc(heapsim_t * sim, uint32_t e, uint32_t size)
+{
+    size = (size + 3) & ~0x3U;
+    uint32_t h = sim->mem[e];
+    uint32_t d_size = ENT_SIZE(h);
+
+    if(d_size == size + sizeof(uint32_t)) size = d_size;
+    if(d_size != size) sim->mem[e + 1 + size / sizeof(uint32_t)] = d_size - size - sizeof(uint32_t);
+    sim->mem[e] = size | (h & ENT_USED);
+}
+
+//`ent_release` of `lv_mem.c`: join the following free entries
+static void ent_release(heapsim_t * sim, uint32_t e)
+{
+    uint32_t words = sim->size / sizeof(uint32_t);
+    uint32_t d_size = ENT_SIZE(sim->mem[e]);
+    uint32_t next = e + 1 + d_size / sizeof(uint32_t);
+    while(next < words && (sim->mem[next] & ENT_USED) == 0)
+    {
+        d_size += ENT_SIZE(sim->mem[next]) + sizeof(uint32_t);
+        next = e + 1 + d_size / sizeof(uint32_t);
+    }
+    sim->mem[e] = d_size;
+}
+
+//`lv_obj_create`: the node and an empty slot for the ext. attributes. Returns the index of the node.
+static uint8_t obj_create(heapsim_t * sim, heapsim_widget_t * w)
+{
+    uint8_t o = w->cnt;
+    w->alloc[w->cnt++] = heapsim_alloc(sim, OBJ_NODE_SIZE);
+    w->alloc[w->cnt++] = 0;
+    return o;
+}
+
+//`lv_obj_allocate_ext_attr` of the object `o`, it grows with every type in the inheritance
+static void ext_alloc(heapsim_t * sim, heapsim_widget_t * w, uint8_t o, uint32_t size)
+{
+    uint32_t p = heapsim_realloc(sim, w->alloc[o + 1], size);
+    if(p != 0) w->alloc[o + 1] = p;
+}
+
+static uint8_t cont_create(heapsim_t * sim, heapsim_widget_t * w)
+{
+    uint8_t o = obj_create(sim, w);
+    ext_alloc(sim, w, o, sizeof(lv_cont_ext_t));
+    return o;
+}
+
+static uint8_t btn_create(heapsim_t * sim, heapsim_widget_t * w)
+{
+    uint8_t o = cont_create(sim, w);
+    ext_alloc(sim, w, o, sizeof(lv_btn_ext_t));
+    return o;
+}
+
+//The text is the last allocation of the label
+static uint8_t label_create(heapsim_t * sim, heapsim_widget_t * w)
+{
+    uint8_t o = obj_create(sim, w);
+    ext_alloc(sim, w, o, sizeof(lv_label_ext_t));
+    w->text = w->cnt;
+    w->alloc[w->cnt++] = heapsim_alloc(sim, sizeof("Text"));
+    return o;
+}
+
+//A page with its scrollable container, then the ext. attributes of the list grow and its label is created
+static uint8_t ddlist_create(heapsim_t * sim, heapsim_widget_t * w)
+{
+    uint8_t o = cont_create(sim, w);
+    ext_alloc(sim, w, o, sizeof(lv_page_ext_t));
+    cont_create(sim, w);
+    ext_alloc(sim, w, o, sizeof(lv_ddlist_ext_t));
+    label_create(sim, w);
+    label_set_text(sim, w, "Option 1\nOption 2\nOption 3", false);
+    return o;
+}
+
+//`lv_label_set_text` frees the old text before allocating the new, `lv_label_set_static_text` only frees it
+static void label_set_text(heapsim_t * sim, heapsim_widget_t * w, const char * text, bool static_text)
+{
+    heapsim_free(sim, w->alloc[w->text]);
+    w->alloc[w->text] = static_text ? 0 : heapsim_alloc(sim, strlen(text) + 1);
+}
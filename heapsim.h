@@ -0,0 +1,79 @@
+/**
+ * @file heapsim.h
+ *
+ */
+
+#ifndef _HEAPSIM_H_
+#define _HEAPSIM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "dataset.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HEAPSIM_SIZE_DEF        (32U * 1024U)   //`LV_MEM_SIZE` of `lv_conf_template.h`
+#define HEAPSIM_WIDGET_ALLOC_MAX 8              //Allocations of a widget with its inner objects (drop down list)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//The work memory of the target: `lv_mem` with the first fit allocator (`LV_MEM_TLSF 0`, `LV_MEM_AUTO_DEFRAG 1`)
+typedef struct
+{
+    uint32_t * mem;             //4 byte header words and data, as on a 32 bit target
+    uint32_t size;              //[bytes]
+    uint32_t used;              //[bytes] of data in the used entries
+    uint32_t max_used;
+    uint32_t fails;             //Allocations which didn't fit
+}heapsim_t;
+
+//The allocations of a widget in creation order, the inner objects' (e.g. the label of a check box) too
+typedef struct
+{
+    uint32_t alloc[HEAPSIM_WIDGET_ALLOC_MAX];  //Index of the data word in `mem` + 1, 0: none or failed
+    uint8_t cnt;
+    uint8_t text;               //Index of the text in `alloc`, HEAPSIM_WIDGET_ALLOC_MAX: no text
+}heapsim_widget_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool heapsim_init(heapsim_t * sim, uint32_t size);
+void heapsim_deinit(heapsim_t * sim);
+uint32_t heapsim_alloc(heapsim_t * sim, uint32_t size);
+void heapsim_free(heapsim_t * sim, uint32_t p);
+uint32_t heapsim_realloc(heapsim_t * sim, uint32_t p, uint32_t size);
+uint32_t heapsim_get_free_biggest(const heapsim_t * sim);
+uint8_t heapsim_get_frag_pct(const heapsim_t * sim);
+void heapsim_widget_create(heapsim_t * sim, heapsim_widget_t * w, widget_type_t type);
+void heapsim_widget_set_text(heapsim_t * sim, heapsim_widget_t * w, const char * text, bool static_text);
+void heapsim_widget_del(heapsim_t * sim, heapsim_widget_t * w);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,389 @@
+/**
+ * @file hotreload.c
+ * Hot reload of the project file. While the designer runs, lgd.xml is watched, and when an other program (an
+ * editor, a script) changes it, only the difference is applied to the open project. The file is diffed against
+ * the version the project was loaded from or saved to by the subtree hashes of `projdiff`, so the time goes with
+ * the changes. The changed attributes, the removed and the added widgets are patched into the live widgets in one
+ * batch, which is one undo step too. A change which can't be patched (a screen added or removed, a widget of a
+ * stored screen, reordered siblings, a changed type) is printed and nothing is applied; the project has to be
+ * loaded again then. Linux tells the changes by inotify, the other systems compare the file's modification time.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <mxml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+#include "hotreload.h"
+#include "projdiff.h"
+#include "loadproj.h"
+#include "dataset.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "widgetid.h"
+#include "screens.h"
+#include "undo.h"
+#include "autosave.h"
+#include "propbind.h"
+#include "custom_widget.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    projdiff_op_t op;
+    mxml_node_t * old_xml;
+    mxml_node_t * new_xml;
+    lv_obj_t * obj;             //The changed or removed widget, the parent of an added one
+}hot_edit_t;
+
+//The edits of a change, all of them are found before any is applied
+typedef struct
+{
+    hot_edit_t * edits;
+    uint32_t cnt;
+    uint32_t cap;
+    const char * fail;          //Why it can't be patched, NULL: it can
+    const char * fail_id;       //The element it's about
+}hot_plan_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void hotreload_task(lv_task_t * task);
+static bool file_changed(void);
+static void base_load(void);
+static void reload(void);
+static bool plan_cb(projdiff_op_t op, void * old_xml, void * new_xml, void * user_data);
+static bool plan_fail(hot_plan_t * plan, mxml_node_t * xml, const char * why);
+static lv_obj_t * widget_find(mxml_node_t * xml);
+static lv_obj_t * parent_find(mxml_node_t * xml);
+static void plan_apply(const hot_plan_t * plan);
+static void attrs_patch(lv_obj_t * obj, const widget_desc_t * desc, mxml_node_t * old_xml, mxml_node_t * new_xml);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_task_t * hotreload_task_p = NULL;
+static projdiff_tree_t * base = NULL;   //The file the open project is the same as
+static bool rebase_pending = false;     //Atomic, it's set by the save on a worker thread too
+#ifdef __linux__
+static int watch_fd = -1;
+#else
+static time_t file_mtime = 0;
+static off_t file_size = 0;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Watch lgd.xml and patch its changes into the open project. false if it can't be watched.
+bool hotreload_start(void)
+{
+    if(hotreload_task_p != NULL) return true;
+    if(load_project_has_manifest())
+    {
+        printf("Hot reload: only lgd.xml is watched, not the files of %s\n", LOADPROJ_MANIFEST_FILE);
+        return false;
+    }
+
+#ifdef __linux__
+    //The directory, since the file is replaced by a rename when it's saved (by the designer too)
+    watch_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if(watch_fd < 0 || inotify_add_watch(watch_fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+    {
+        printf("Hot reload: can't watch the project's directory\n");
+        if(watch_fd >= 0) close(watch_fd);
+        watch_fd = -1;
+        return false;
+    }
+#else
+    file_changed();     //Take the current time and size
+#endif
+    hotreload_task_p = lv_task_create(hotreload_task, HOTRELOAD_PERIOD, LV_TASK_PRIO_LOW, NULL);
+    if(hotreload_task_p == NULL)
+    {
+        hotreload_stop();
+        return false;
+    }
+    base_load();
+    return true;
+}
+
+void hotreload_stop(void)
+{
+    if(hotreload_task_p != NULL) lv_task_del(hotreload_task_p);
+    hotreload_task_p = NULL;
+#ifdef __linux__
+    if(watch_fd >= 0) close(watch_fd);
+    watch_fd = -1;
+#endif
+    projdiff_tree_del(base);
+    base = NULL;
+}
+
+//The open project is the same as lgd.xml now (it was loaded or saved), the next change is measured from it.
+//It can be called on any thread.
+void hotreload_rebase(void)
+{
+    __atomic_store_n(&rebase_pending, true, __ATOMIC_RELEASE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void hotreload_task(lv_task_t * task)
+{
+    (void)task;
+    bool changed = file_changed();
+    if(__atomic_exchange_n(&rebase_pending, false, __ATOMIC_ACQ_REL))
+    {
+        base_load();        //The change is the designer's own save
+        return;
+    }
+    if(changed) reload();
+}
+
+//The events since the last call are read, so every change is seen once
+static bool file_changed(void)
+{
+#ifdef __linux__
+    char buf[HOTRELOAD_EVENT_BUF] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool changed = false;
+    ssize_t len;
+    while((len = read(watch_fd, buf, sizeof(buf))) > 0)
+    {
+        const char * p = buf;
+        while(p < buf + len)
+        {
+            const struct inotify_event * ev = (const struct inotify_event *)p;
+            if(ev->len > 0 && !strcmp(ev->name, LOADPROJ_XML_FILE)) changed = true;
+            p += sizeof(struct inotify_event) + ev->len;
+        }
+    }
+    return changed;
+#else
+    struct stat st;
+    if(stat(LOADPROJ_XML_FILE, &st) != 0) return false;
+    bool changed = st.st_mtime != file_mtime || st.st_size != file_size;
+    file_mtime = st.st_mtime;
+    file_size = st.st_size;
+    return changed;
+#endif
+}
+
+static void base_load(void)
+{
+    struct stat st;
+    if(stat(LOADPROJ_XML_FILE, &st) != 0) return;      //Not saved yet
+    projdiff_tree_t * tree = projdiff_tree_load(LOADPROJ_XML_FILE);
+    if(tree == NULL) return;
+    projdiff_tree_del(base);
+    base = tree;
+}
+
+//Diff the changed file against the base and patch the difference into the widgets
+static void reload(void)
+{
+    uint32_t t_start = lv_tick_get();
+    projdiff_tree_t * tree = projdiff_tree_load(LOADPROJ_XML_FILE);
+    if(tree == NULL) return;        //E.g. it's written just now, the next change of it is tried again
+    if(base == NULL)
+    {
+        base = tree;
+        return;
+    }
+
+    hot_plan_t plan;
+    memset(&plan, 0, sizeof(plan));
+    int32_t res = projdiff_trees(base, tree, plan_cb, &plan);
+    if(plan.fail != NULL)
+    {
+        //The base is kept, so the change is reported again until the project is loaded again
+        printf("Hot reload: %s %s, load the project again to see the change\n", plan.fail_id, plan.fail);
+        projdiff_tree_del(tree);
+    }else if(res < 0)
+    {
+        printf("Hot reload: out of memory\n");
+        projdiff_tree_del(tree);
+    }else
+    {
+        if(plan.cnt > 0) plan_apply(&plan);
+
+        uint32_t cnt[PROJDIFF_REORDERED] = {0};
+        uint32_t i;
+        for(i = 0; i < plan.cnt; i++) cnt[plan.edits[i].op]++;
+        printf("Hot reload: %u changed, %u added, %u removed widgets in %u ms\n", cnt[PROJDIFF_CHANGED],
+               cnt[PROJDIFF_ADDED], cnt[PROJDIFF_REMOVED], lv_tick_elaps(t_start));
+        projdiff_tree_del(base);        //The elements of the plan are freed only after it's applied
+        base = tree;
+    }
+    free(plan.edits);
+}
+
+//Find the widget of every difference first, so the change is applied whole or not at all
+static bool plan_cb(projdiff_op_t op, void * old_xml, void * new_xml, void * user_data)
+{
+    hot_plan_t * plan = user_data;
+    mxml_node_t * xml = old_xml != NULL ? old_xml : new_xml;
+    lv_obj_t * obj;
+    switch(op)
+    {
+        case PROJDIFF_CHANGED:
+            if(strcasecmp(mxmlGetElement(old_xml), mxmlGetElement(new_xml)))
+            {
+                return plan_fail(plan, xml, "changed its type");
+            }
+            obj = widget_find(xml);
+            break;
+        case PROJDIFF_REMOVED:
+            obj = widget_find(xml);
+            break;
+        case PROJDIFF_ADDED:
+            if(!strcasecmp(mxmlGetElement(xml), SCREENS_TAG)) obj = NULL;
+            else obj = parent_find(xml);
+            break;
+        default:
+            return plan_fail(plan, xml, "has reordered children");
+    }
+    if(obj == NULL && !strcasecmp(mxmlGetElement(xml), SCREENS_TAG))
+    {
+        return plan_fail(plan, xml, "is a screen, they can't be added, removed or changed");
+    }
+    if(obj == NULL) return plan_fail(plan, xml, "isn't on an open screen");
+
+    widget_info_t * info = widget_get_info(obj);
+    doc_node_t * n = info != NULL ? doc_get(info->node) : NULL;
+    if(n == NULL || (op != PROJDIFF_ADDED && n->parent == DOC_ROOT))
+    {
+        return plan_fail(plan, xml, "is a screen, they can't be added, removed or changed");
+    }
+
+    if(plan->cnt == plan->cap)
+    {
+        uint32_t cap = plan->cap ? plan->cap * 2 : 64;
+        hot_edit_t * p = realloc(plan->edits, cap * sizeof(hot_edit_t));
+        if(p == NULL) return false;
+        plan->edits = p;
+        plan->cap = cap;
+    }
+    hot_edit_t * e = &plan->edits[plan->cnt++];
+    e->op = op;
+    e->old_xml = old_xml;
+    e->new_xml = new_xml;
+    e->obj = obj;
+    return true;
+}
+
+static bool plan_fail(hot_plan_t * plan, mxml_node_t * xml, const char * why)
+{
+    const char * id = mxmlElementGetAttr(xml, "id");
+    plan->fail = why;
+    plan->fail_id = id != NULL ? id : mxmlGetElement(xml);
+    return false;
+}
+
+//The live widget of an element by its ID. NULL if it has none or its screen is stored.
+static lv_obj_t * widget_find(mxml_node_t * xml)
+{
+    const char * id = mxmlElementGetAttr(xml, "id");
+    return id != NULL ? widgetid_find(id) : NULL;
+}
+
+//The live widget an added element goes to. The widgets at the top of a file without screens go to the only screen.
+static lv_obj_t * parent_find(mxml_node_t * xml)
+{
+    mxml_node_t * par = mxmlGetParent(xml);
+    if(mxmlGetParent(par) != NULL) return widget_find(par);
+
+    if(screens_get_cnt() != 1) return NULL;
+    doc_node_t * scr = doc_get(doc_get_screen());
+    return scr != NULL ? scr->obj : NULL;
+}
+
+//One batch and one undo step. The removals go first, so a widget moved to an other parent keeps its ID.
+static void plan_apply(const hot_plan_t * plan)
+{
+    static const projdiff_op_t order[] = {PROJDIFF_REMOVED, PROJDIFF_CHANGED, PROJDIFF_ADDED};
+
+    lv_obj_batch_begin();
+    undo_group_begin();
+    uint32_t o, i;
+    for(o = 0; o < sizeof(order) / sizeof(order[0]); o++)
+    {
+        for(i = 0; i < plan->cnt; i++)
+        {
+            const hot_edit_t * e = &plan->edits[i];
+            if(e->op != order[o]) continue;
+
+            widget_info_t * info = widget_get_info(e->obj);
+            if(e->op == PROJDIFF_REMOVED)
+            {
+                layerview_del(info->node);
+            }else if(e->op == PROJDIFF_CHANGED)
+            {
+                undo_edit_begin(info->node);
+                attrs_patch(e->obj, widgetreg_get(info->type), e->old_xml, e->new_xml);
+                undo_edit_end(info->node);
+                autosave_mark(info->node);
+            }else
+            {
+                lv_obj_t * obj = load_project_subtree(e->obj, e->new_xml);
+                if(obj == NULL) continue;       //An unknown tag, as the load ignores it
+                doc_id_t node = widget_get_info(obj)->node;
+                undo_record_create(node, 1);
+                autosave_mark(node);            //The subtree is journaled at once
+            }
+        }
+    }
+    undo_group_end();
+    lv_obj_batch_commit();
+    propbind_changed(layerview_get_sel_obj(), PROP_ALL);   //The Setting shows the selected one as it is now
+}
+
+//Set the attributes the new element changed, and the defaults of the ones it dropped
+static void attrs_patch(lv_obj_t * obj, const widget_desc_t * desc, mxml_node_t * old_xml, mxml_node_t * new_xml)
+{
+    int i;
+    int cnt = mxmlElementGetAttrCount(new_xml);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        const char * value = mxmlElementGetAttrByIndex(new_xml, i, &name);
+        const char * old_value = mxmlElementGetAttr(old_xml, name);
+        if(old_value != NULL && !strcmp(old_value, value)) continue;
+        widgetreg_attr_apply(widgetreg_find_attr(desc, name), obj, value);
+    }
+
+    cnt = mxmlElementGetAttrCount(old_xml);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        mxmlElementGetAttrByIndex(old_xml, i, &name);
+        if(mxmlElementGetAttr(new_xml, name) != NULL) continue;
+        const widget_attr_desc_t * attr = widgetreg_find_attr(desc, name);
+        if(attr == NULL) continue;
+        if(attr->set_int_cb != NULL) attr->set_int_cb(obj, attr->def);
+        else if(attr->set_cb != NULL) attr->set_cb(obj, attr->def_text != NULL ? attr->def_text : "");
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * @file hotreload.h
+ *
+ */
+
+#ifndef _HOTRELOAD_H_
+#define _HOTRELOAD_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HOTRELOAD_PERIOD        250     //[ms] between two checks of the project file
+#define HOTRELOAD_EVENT_BUF     4096    //Bytes of file events read at once
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool hotreload_start(void);
+void hotreload_stop(void);
+void hotreload_rebase(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
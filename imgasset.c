@@ -0,0 +1,898 @@
+/**
+ * @imgasset .c
+ * The images of the project, converted by the designer into the colour format of the target.
+ * The generated code has them as const `lv_img_dsc_t`s, so the target never decodes or converts them.
+ * A conversion is kept in the asset store under the hash of the source's content, the colour format and
+ * the target, an unchanged image is converted only once, whichever project uses it.
+ * The stored assets are LVGL `.bin` images after the store's header. They are mapped, not copied.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "imgasset.h"
+#include "assetstore.h"
+#include "widgetid.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define CACHE_VERSION   1           //Change it with the conversion, the old results won't be used then
+#define STORE_KIND      "img"
+#define SRC_SIZE_MAX    (64 * 1024 * 1024)  //Bytes of a source file
+#define QUANT_BITS      5           //Per channel, the palette is built from a histogram of this precision
+#define QUANT_BINS      (1 << (3 * QUANT_BITS))
+#define QUANT_MIXED     0xFFFFFFFF  //More than one exact colour fell into the bin
+#define EXACT_SLOTS     512         //Hash set of the colours of a drawn image, twice the largest palette
+#define LIST_TARGET     "@target"   //Not a C identifier, so it's never the name of an image
+#define CF_ENTRY(name, cf)  {name, cf, #cf}
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t w;
+    uint32_t h;
+    uint8_t * px;               //RGBA, 8 bit per channel
+    bool has_alpha;
+}src_img_t;
+
+typedef struct
+{
+    uint8_t c[3];               //Red, green, blue
+    uint32_t cnt;               //Pixels
+    uint32_t bin;
+}quant_color_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static int32_t asset_find(const char * name);
+static bool file_read(const char * path, uint8_t ** buf, size_t * len);
+static bool src_decode(const uint8_t * buf, size_t len, src_img_t * img);
+static bool pnm_uint_read(const uint8_t * buf, size_t len, size_t * pos, uint32_t * val);
+static bool pam_header_read(const uint8_t * buf, size_t len, size_t * pos, uint32_t * w, uint32_t * h,
+                            uint32_t * depth, uint32_t * maxval);
+static uint32_t data_size_get(lv_img_cf_t cf, uint32_t w, uint32_t h, uint8_t depth);
+static uint8_t color_size_get(uint8_t depth);
+static void color_write(uint8_t * p, const uint8_t * rgb, imgasset_target_t target);
+static bool convert(const src_img_t * img, lv_img_cf_t cf, imgasset_target_t target, imgasset_data_t * data);
+static bool palette_build(const src_img_t * img, uint32_t pal_size, quant_color_t * pal, uint32_t * pal_cnt,
+                          uint8_t * bin_index);
+static int color_cmp_r(const void * a, const void * b);
+static int color_cmp_g(const void * a, const void * b);
+static int color_cmp_b(const void * a, const void * b);
+static uint32_t bin_get(const uint8_t * rgb);
+static uint32_t exact_key(lv_color32_t c);
+static uint32_t exact_slot(const uint32_t * slots, uint32_t key);
+static bool cache_read(uint64_t hash, lv_img_cf_t cf, imgasset_target_t target, imgasset_data_t * data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+//The designer edits the list on the UI thread, the code generation reads it on its worker
+static pthread_mutex_t asset_mutex = PTHREAD_MUTEX_INITIALIZER;
+static imgasset_t assets[IMGASSET_MAX];
+static uint32_t asset_cnt = 0;
+static imgasset_target_t asset_target = {.depth = LV_COLOR_DEPTH, .swap = LV_COLOR_16_SWAP};
+
+static const struct
+{
+    const char * name;
+    lv_img_cf_t cf;
+    const char * code;          //In the generated code
+}cf_names[] = {
+    CF_ENTRY("true_color", LV_IMG_CF_TRUE_COLOR),
+    CF_ENTRY("true_color_alpha", LV_IMG_CF_TRUE_COLOR_ALPHA),
+    CF_ENTRY("indexed_1bit", LV_IMG_CF_INDEXED_1BIT),
+    CF_ENTRY("indexed_2bit", LV_IMG_CF_INDEXED_2BIT),
+    CF_ENTRY("indexed_4bit", LV_IMG_CF_INDEXED_4BIT),
+    CF_ENTRY("indexed_8bit", LV_IMG_CF_INDEXED_8BIT),
+    CF_ENTRY("alpha_1bit", LV_IMG_CF_ALPHA_1BIT),
+    CF_ENTRY("alpha_2bit", LV_IMG_CF_ALPHA_2BIT),
+    CF_ENTRY("alpha_4bit", LV_IMG_CF_ALPHA_4BIT),
+    CF_ENTRY("alpha_8bit", LV_IMG_CF_ALPHA_8BIT),
+};
+
+//Sorting the colours of a box by one channel
+static int (* const color_cmp[3])(const void *, const void *) = {color_cmp_r, color_cmp_g, color_cmp_b};
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+//Add an image or replace the source and the colour format of the one with this name
+bool imgasset_add(const char * name, const char * path, lv_img_cf_t cf)
+{
+    if(!widgetid_is_valid(name) || strlen(name) >= IMGASSET_NAME_MAX) return false;
+    if(path == NULL || path[0] == '\0' || strlen(path) >= IMGASSET_PATH_MAX) return false;
+    if(imgasset_cf_get_name(cf) == NULL) return false;
+
+    pthread_mutex_lock(&asset_mutex);
+    int32_t i = asset_find(name);
+    if(i < 0)
+    {
+        if(asset_cnt == IMGASSET_MAX)
+        {
+            pthread_mutex_unlock(&asset_mutex);
+            return false;
+        }
+        i = asset_cnt++;
+        strcpy(assets[i].name, name);
+    }
+    strcpy(assets[i].path, path);
+    assets[i].cf = cf;
+    pthread_mutex_unlock(&asset_mutex);
+    return true;
+}
+
+bool imgasset_remove(const char * name)
+{
+    pthread_mutex_lock(&asset_mutex);
+    int32_t i = asset_find(name);
+    if(i >= 0)
+    {
+        //Keep the order, it's the order in the generated code
+        memmove(&assets[i], &assets[i + 1], (asset_cnt - i - 1) * sizeof(imgasset_t));
+        asset_cnt--;
+    }
+    pthread_mutex_unlock(&asset_mutex);
+    return i >= 0;
+}
+
+uint32_t imgasset_get_count(void)
+{
+    pthread_mutex_lock(&asset_mutex);
+    uint32_t cnt = asset_cnt;
+    pthread_mutex_unlock(&asset_mutex);
+    return cnt;
+}
+
+//Copy the i-th image, so it stays valid while the list changes
+bool imgasset_get(uint32_t i, imgasset_t * asset)
+{
+    pthread_mutex_lock(&asset_mutex);
+    bool res = i < asset_cnt;
+    if(res) *asset = assets[i];
+    pthread_mutex_unlock(&asset_mutex);
+    return res;
+}
+
+//The images are converted to this, the generated code refuses to compile with an other LV_COLOR_DEPTH
+bool imgasset_set_target(uint8_t depth, bool swap)
+{
+    if(depth != 1 && depth != 8 && depth != 16 && depth != 32) return false;
+
+    pthread_mutex_lock(&asset_mutex);
+    asset_target.depth = depth;
+    asset_target.swap = depth == 16 && swap ? 1 : 0;
+    pthread_mutex_unlock(&asset_mutex);
+    return true;
+}
+
+imgasset_target_t imgasset_get_target(void)
+{
+    pthread_mutex_lock(&asset_mutex);
+    imgasset_target_t target = asset_target;
+    pthread_mutex_unlock(&asset_mutex);
+    return target;
+}
+
+//LV_IMG_CF_UNKNOWN if not supported
+lv_img_cf_t imgasset_cf_from_name(const char * name)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(cf_names) / sizeof(cf_names[0]); i++)
+    {
+        if(strcmp(cf_names[i].name, name) == 0) return cf_names[i].cf;
+    }
+    return LV_IMG_CF_UNKNOWN;
+}
+
+//NULL if not supported
+const char * imgasset_cf_get_name(lv_img_cf_t cf)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(cf_names) / sizeof(cf_names[0]); i++)
+    {
+        if(cf_names[i].cf == cf) return cf_names[i].name;
+    }
+    return NULL;
+}
+
+//The enumerator, e.g. "LV_IMG_CF_INDEXED_4BIT". NULL if not supported
+const char * imgasset_cf_get_code(lv_img_cf_t cf)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(cf_names) / sizeof(cf_names[0]); i++)
+    {
+        if(cf_names[i].cf == cf) return cf_names[i].code;
+    }
+    return NULL;
+}
+
+//Convert an image for the current target, or read the earlier conversion from the cache. Can run on any thread.
+bool imgasset_convert(const imgasset_t * asset, imgasset_data_t * data)
+{
+    memset(data, 0, sizeof(imgasset_data_t));
+    imgasset_target_t target = imgasset_get_target();
+
+    uint8_t * buf;
+    size_t len;
+    if(!file_read(asset->path, &buf, &len)) return false;
+
+    uint8_t key[3] = {asset->cf, target.depth, target.swap | (CACHE_VERSION << 1)};
+    data->hash = assetstore_hash(assetstore_hash(ASSETSTORE_HASH_INIT, buf, len), key, sizeof(key));
+
+    if(cache_read(data->hash, asset->cf, target, data))
+    {
+        free(buf);
+        return true;
+    }
+
+    src_img_t img;
+    bool res = src_decode(buf, len, &img);
+    free(buf);
+    if(!res) return false;
+
+    res = convert(&img, asset->cf, target, data);
+    free(img.px);
+    if(res) assetstore_put(data->hash, STORE_KIND, &data->header, sizeof(data->header), data->data, data->data_size);
+    return res;
+}
+
+//Pixels drawn by the designer and already in the colours of the target (e.g. a baked subtree), in the smallest format
+//keeping every one of them: indexed if they fit into a palette, else true colour. Can run on any thread.
+bool imgasset_convert_px(const lv_color32_t * px, uint32_t w, uint32_t h, imgasset_data_t * data)
+{
+    memset(data, 0, sizeof(imgasset_data_t));
+    imgasset_target_t target = imgasset_get_target();
+
+    //The distinct colours, till one more than a palette holds
+    uint32_t slots[EXACT_SLOTS];            //0: empty, else `exact_key`
+    uint8_t slot_index[EXACT_SLOTS];
+    lv_color32_t pal[256];
+    uint32_t pal_cnt = 0;
+    memset(slots, 0, sizeof(slots));
+    uint32_t px_cnt = w * h;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++)
+    {
+        uint32_t key = exact_key(px[i]);
+        uint32_t slot = exact_slot(slots, key);
+        if(slots[slot] != 0) continue;
+        if(pal_cnt == 256)
+        {
+            pal_cnt++;
+            break;
+        }
+        slots[slot] = key;
+        slot_index[slot] = pal_cnt;
+        pal[pal_cnt++] = px[i];
+    }
+
+    //The narrowest index the colours fit into, if it's smaller than the colours themselves
+    lv_img_cf_t cf = LV_IMG_CF_TRUE_COLOR;
+    uint32_t size = data_size_get(cf, w, h, target.depth);
+    lv_img_cf_t ind;
+    for(ind = LV_IMG_CF_INDEXED_1BIT; ind <= LV_IMG_CF_INDEXED_8BIT; ind++)
+    {
+        if(pal_cnt > (1U << lv_img_color_format_get_px_size(ind))) continue;
+        if(data_size_get(ind, w, h, target.depth) < size) cf = ind;
+        break;
+    }
+
+    if(cf == LV_IMG_CF_TRUE_COLOR)
+    {
+        src_img_t img = {.w = w, .h = h, .px = malloc(px_cnt * 4), .has_alpha = false};
+        if(img.px == NULL) return false;
+        for(i = 0; i < px_cnt; i++)
+        {
+            img.px[i * 4] = px[i].ch.red;
+            img.px[i * 4 + 1] = px[i].ch.green;
+            img.px[i * 4 + 2] = px[i].ch.blue;
+            img.px[i * 4 + 3] = 0xFF;
+        }
+        bool res = convert(&img, cf, target, data);
+        free(img.px);
+        return res;
+    }
+
+    data->header.cf = cf;
+    data->header.w = w;
+    data->header.h = h;
+    data->data_size = data_size_get(cf, w, h, target.depth);
+    data->data = calloc(1, data->data_size);
+    if(data->data == NULL) return false;
+
+    uint32_t bpp = lv_img_color_format_get_px_size(cf);
+    uint8_t * d = data->data;
+    for(i = 0; i < (1U << bpp); i++, d += sizeof(lv_color32_t))
+    {
+        d[3] = 0xFF;
+        if(i >= pal_cnt) continue;
+        d[0] = pal[i].ch.blue;
+        d[1] = pal[i].ch.green;
+        d[2] = pal[i].ch.red;
+    }
+    uint32_t stride = (w * bpp + 7) / 8;
+    uint32_t y;
+    for(y = 0; y < h; y++, d += stride)
+    {
+        uint32_t x;
+        for(x = 0; x < w; x++)
+        {
+            uint32_t v = slot_index[exact_slot(slots, exact_key(px[y * w + x]))];
+            uint32_t bit = x * bpp;
+            d[bit >> 3] |= v << (8 - bpp - (bit & 0x7));
+        }
+    }
+    return true;
+}
+
+void imgasset_data_free(imgasset_data_t * data)
+{
+    if(data->cached) assetstore_release(&data->blob);
+    else free(data->data);
+    data->data = NULL;
+    data->data_size = 0;
+}
+
+//One image in a line: name, colour format and path. The first line is the target.
+bool imgasset_list_save(const char * path)
+{
+    char tmp_path[IMGASSET_PATH_MAX + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE * fp = fopen(tmp_path, "w");
+    if(fp == NULL) return false;
+
+    pthread_mutex_lock(&asset_mutex);
+    fprintf(fp, "%s %u %u\n", LIST_TARGET, asset_target.depth, asset_target.swap);
+    uint32_t i;
+    for(i = 0; i < asset_cnt; i++)
+    {
+        fprintf(fp, "%s %s %s\n", assets[i].name, imgasset_cf_get_name(assets[i].cf), assets[i].path);
+    }
+    pthread_mutex_unlock(&asset_mutex);
+
+    bool res = !ferror(fp);
+    if(fclose(fp) != 0) res = false;
+    if(res && rename(tmp_path, path) != 0) res = false;
+    if(!res) remove(tmp_path);
+    return res;
+}
+
+//Replaces the images. A missing file is an empty list.
+bool imgasset_list_load(const char * path)
+{
+    pthread_mutex_lock(&asset_mutex);
+    asset_cnt = 0;
+    pthread_mutex_unlock(&asset_mutex);
+
+    FILE * fp = fopen(path, "r");
+    if(fp == NULL) return true;
+
+    bool res = true;
+    char line[IMGASSET_NAME_MAX + IMGASSET_PATH_MAX + 32];
+    while(fgets(line, sizeof(line), fp) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+        if(line[0] == '\0') continue;
+
+        char name[IMGASSET_NAME_MAX];
+        char cf[32];
+        unsigned depth;
+        unsigned swap;
+        int path_ofs;
+        if(sscanf(line, LIST_TARGET " %u %u", &depth, &swap) == 2)
+        {
+            if(!imgasset_set_target(depth, swap)) res = false;
+        }else if(sscanf(line, "%31s %31s %n", name, cf, &path_ofs) == 2)
+        {
+            if(!imgasset_add(name, &line[path_ofs], imgasset_cf_from_name(cf))) res = false;
+        }else
+        {
+            res = false;
+        }
+    }
+    fclose(fp);
+    if(!res) printf("%s: some images couldn't be loaded\n", path);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static int32_t asset_find(const char * name)
+{
+    uint32_t i;
+    for(i = 0; i < asset_cnt; i++)
+    {
+        if(strcmp(assets[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+static bool file_read(const char * path, uint8_t ** buf, size_t * len)
+{
+    FILE * fp = fopen(path, "rb");
+    if(fp == NULL) return false;
+
+    bool res = false;
+    *buf = NULL;
+    if(fseek(fp, 0, SEEK_END) == 0)
+    {
+        long size = ftell(fp);
+        if(size > 0 && size <= SRC_SIZE_MAX && fseek(fp, 0, SEEK_SET) == 0)
+        {
+            *len = size;
+            *buf = malloc(*len);
+            res = *buf != NULL && fread(*buf, 1, *len, fp) == *len;
+        }
+    }
+    fclose(fp);
+    if(!res)
+    {
+        free(*buf);
+        *buf = NULL;
+    }
+    return res;
+}
+
+//Binary PGM (P5), PPM (P6) or PAM (P7) with 8 bit channels. Any image tool can export them.
+static bool src_decode(const uint8_t * buf, size_t len, src_img_t * img)
+{
+    if(len < 3 || buf[0] != 'P') return false;
+
+    size_t pos = 2;
+    uint32_t depth;
+    uint32_t maxval;
+    bool ok;
+    if(buf[1] == '5' || buf[1] == '6')
+    {
+        depth = buf[1] == '5' ? 1 : 3;
+        ok = pnm_uint_read(buf, len, &pos, &img->w) && pnm_uint_read(buf, len, &pos, &img->h) &&
+             pnm_uint_read(buf, len, &pos, &maxval) && pos < len;
+        pos++;      //A single white space before the pixels
+    }else if(buf[1] == '7')
+    {
+        ok = pam_header_read(buf, len, &pos, &img->w, &img->h, &depth, &maxval);
+    }else
+    {
+        return false;
+    }
+
+    if(!ok || depth == 0 || depth > 4 || maxval == 0 || maxval > 255) return false;
+    if(img->w == 0 || img->h == 0 || img->w > IMGASSET_SIZE_MAX || img->h > IMGASSET_SIZE_MAX) return false;
+    uint32_t px_cnt = img->w * img->h;
+    if(len - pos < (size_t)px_cnt * depth) return false;
+
+    img->px = malloc(px_cnt * 4);
+    if(img->px == NULL) return false;
+    img->has_alpha = depth == 2 || depth == 4;
+
+    const uint8_t * s = &buf[pos];
+    uint8_t * d = img->px;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++)
+    {
+        uint8_t v[4];
+        uint32_t c;
+        for(c = 0; c < depth; c++) v[c] = maxval == 255 ? s[c] : (s[c] * 255 + maxval / 2) / maxval;
+        if(depth <= 2)
+        {
+            d[0] = d[1] = d[2] = v[0];
+            d[3] = depth == 2 ? v[1] : 0xFF;
+        }else
+        {
+            memcpy(d, v, 3);
+            d[3] = depth == 4 ? v[3] : 0xFF;
+        }
+        s += depth;
+        d += 4;
+    }
+    return true;
+}
+
+//Skips the white spaces and the comments before the number
+static bool pnm_uint_read(const uint8_t * buf, size_t len, size_t * pos, uint32_t * val)
+{
+    size_t p = *pos;
+    while(p < len)
+    {
+        if(buf[p] == '#')
+        {
+            while(p < len && buf[p] != '\n') p++;
+        }else if(buf[p] == ' ' || buf[p] == '\t' || buf[p] == '\r' || buf[p] == '\n')
+        {
+            p++;
+        }else
+        {
+            break;
+        }
+    }
+
+    if(p == len || buf[p] < '0' || buf[p] > '9') return false;
+    uint32_t v = 0;
+    while(p < len && buf[p] >= '0' && buf[p] <= '9')
+    {
+        v = v * 10 + buf[p] - '0';
+        if(v > 0xFFFFFF) return false;
+        p++;
+    }
+    *pos = p;
+    *val = v;
+    return true;
+}
+
+//"WIDTH", "HEIGHT", "DEPTH", "MAXVAL" and "TUPLTYPE" lines until "ENDHDR"
+static bool pam_header_read(const uint8_t * buf, size_t len, size_t * pos, uint32_t * w, uint32_t * h,
+                            uint32_t * depth, uint32_t * maxval)
+{
+    static const char * keys[] = {"WIDTH", "HEIGHT", "DEPTH", "MAXVAL"};
+    uint32_t * vals[] = {w, h, depth, maxval};
+    uint32_t found = 0;
+
+    size_t p = *pos;
+    while(p < len)
+    {
+        //The start of the next line
+        while(p < len && buf[p] != '\n') p++;
+        if(p == len) return false;
+        p++;
+
+        size_t rest = len - p;
+        if(rest >= 6 && memcmp(&buf[p], "ENDHDR", 6) == 0)
+        {
+            while(p < len && buf[p] != '\n') p++;
+            *pos = p + 1;
+            return found == 0xF && *pos <= len;
+        }
+
+        uint32_t k;
+        for(k = 0; k < 4; k++)
+        {
+            size_t key_len = strlen(keys[k]);
+            if(rest > key_len && memcmp(&buf[p], keys[k], key_len) == 0 && buf[p + key_len] == ' ')
+            {
+                size_t vp = p + key_len;
+                if(!pnm_uint_read(buf, len, &vp, vals[k])) return false;
+                found |= 1 << k;
+                break;
+            }
+        }
+        //TUPLTYPE and comments are skipped, DEPTH tells the layout
+    }
+    return false;
+}
+
+static uint32_t data_size_get(lv_img_cf_t cf, uint32_t w, uint32_t h, uint8_t depth)
+{
+    uint32_t px_size = color_size_get(depth);
+    switch(cf)
+    {
+        case LV_IMG_CF_TRUE_COLOR:
+            return w * h * px_size;
+        case LV_IMG_CF_TRUE_COLOR_ALPHA:
+            //The alpha is in the colour with 32 bit
+            return w * h * (depth == 32 ? 4 : px_size + 1);
+        case LV_IMG_CF_INDEXED_1BIT:
+        case LV_IMG_CF_INDEXED_2BIT:
+        case LV_IMG_CF_INDEXED_4BIT:
+        case LV_IMG_CF_INDEXED_8BIT:
+        {
+            uint32_t bpp = lv_img_color_format_get_px_size(cf);
+            return (1 << bpp) * sizeof(lv_color32_t) + (w * bpp + 7) / 8 * h;
+        }
+        case LV_IMG_CF_ALPHA_1BIT:
+        case LV_IMG_CF_ALPHA_2BIT:
+        case LV_IMG_CF_ALPHA_4BIT:
+        case LV_IMG_CF_ALPHA_8BIT:
+            return (w * lv_img_color_format_get_px_size(cf) + 7) / 8 * h;
+        default:
+            return 0;
+    }
+}
+
+static uint8_t color_size_get(uint8_t depth)
+{
+    return depth == 32 ? 4 : depth == 16 ? 2 : 1;
+}
+
+//A colour in the memory layout of the target's `lv_color_t`, the alpha byte of 32 bit is 0xFF
+static void color_write(uint8_t * p, const uint8_t * rgb, imgasset_target_t target)
+{
+    switch(target.depth)
+    {
+        case 1:
+            p[0] = (rgb[0] | rgb[1] | rgb[2]) >> 7;
+            break;
+        case 8:
+            p[0] = (rgb[0] & 0xE0) | ((rgb[1] >> 5) << 2) | (rgb[2] >> 6);
+            break;
+        case 16:
+        {
+            uint16_t v = ((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3);
+            p[0] = target.swap ? v >> 8 : v & 0xFF;
+            p[1] = target.swap ? v & 0xFF : v >> 8;
+            break;
+        }
+        default:
+            p[0] = rgb[2];
+            p[1] = rgb[1];
+            p[2] = rgb[0];
+            p[3] = 0xFF;
+            break;
+    }
+}
+
+static bool convert(const src_img_t * img, lv_img_cf_t cf, imgasset_target_t target, imgasset_data_t * data)
+{
+    data->header.cf = cf;
+    data->header.always_zero = 0;
+    data->header.w = img->w;
+    data->header.h = img->h;
+    data->data_size = data_size_get(cf, img->w, img->h, target.depth);
+    data->data = calloc(1, data->data_size);
+    if(data->data == NULL) return false;
+
+    uint32_t px_cnt = img->w * img->h;
+    const uint8_t * s = img->px;
+    uint8_t * d = data->data;
+    uint32_t i;
+    if(cf == LV_IMG_CF_TRUE_COLOR || cf == LV_IMG_CF_TRUE_COLOR_ALPHA)
+    {
+        uint8_t px_size = color_size_get(target.depth);
+        bool alpha = cf == LV_IMG_CF_TRUE_COLOR_ALPHA;
+        for(i = 0; i < px_cnt; i++, s += 4)
+        {
+            color_write(d, s, target);
+            d += px_size;
+            //Replaces the alpha byte of the 32 bit colour, follows the smaller ones
+            if(alpha && target.depth == 32) d[-1] = s[3];
+            else if(alpha) *d++ = s[3];
+        }
+        return true;
+    }
+
+    uint32_t bpp = lv_img_color_format_get_px_size(cf);
+    uint32_t stride = (img->w * bpp + 7) / 8;
+    uint32_t max = (1 << bpp) - 1;
+    uint8_t * bin_index = NULL;
+    if(cf >= LV_IMG_CF_INDEXED_1BIT && cf <= LV_IMG_CF_INDEXED_8BIT)
+    {
+        //The palette is `lv_color32_t` whatever the target's depth is
+        quant_color_t pal[256];
+        uint32_t pal_cnt;
+        bin_index = malloc(QUANT_BINS);
+        if(bin_index == NULL || !palette_build(img, max + 1, pal, &pal_cnt, bin_index))
+        {
+            free(bin_index);
+            imgasset_data_free(data);
+            return false;
+        }
+        for(i = 0; i <= max; i++, d += sizeof(lv_color32_t))
+        {
+            d[3] = 0xFF;
+            if(i >= pal_cnt) continue;
+            d[0] = pal[i].c[2];
+            d[1] = pal[i].c[1];
+            d[2] = pal[i].c[0];
+        }
+    }
+
+    //Indexes or opacities from the most significant bits, every line starts on a new byte
+    uint32_t y;
+    for(y = 0; y < img->h; y++, d += stride)
+    {
+        uint32_t x;
+        for(x = 0; x < img->w; x++, s += 4)
+        {
+            uint32_t v;
+            if(bin_index != NULL) v = bin_index[bin_get(s)];
+            else
+            {
+                //Without an alpha channel the brightness is the opacity, e.g. of a mask or a glyph like icon
+                uint32_t a = img->has_alpha ? s[3] : (s[0] * 299 + s[1] * 587 + s[2] * 114) / 1000;
+                v = (a * max + 127) / 255;
+            }
+            uint32_t bit = x * bpp;
+            d[bit >> 3] |= v << (8 - bpp - (bit & 0x7));
+        }
+    }
+    free(bin_index);
+    return true;
+}
+
+//Median cut on a histogram, or the exact colours if there are few enough. `bin_index` maps the bins to the palette.
+static bool palette_build(const src_img_t * img, uint32_t pal_size, quant_color_t * pal, uint32_t * pal_cnt,
+                          uint8_t * bin_index)
+{
+    uint32_t * cnt = calloc(QUANT_BINS, sizeof(uint32_t));
+    uint32_t * exact = calloc(QUANT_BINS, sizeof(uint32_t));     //0: empty, else 0x01RRGGBB or QUANT_MIXED
+    if(cnt == NULL || exact == NULL)
+    {
+        free(cnt);
+        free(exact);
+        return false;
+    }
+
+    uint32_t px_cnt = img->w * img->h;
+    const uint8_t * s = img->px;
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++, s += 4)
+    {
+        uint32_t b = bin_get(s);
+        uint32_t c = 0x01000000 | (s[0] << 16) | (s[1] << 8) | s[2];
+        cnt[b]++;
+        if(exact[b] == 0) exact[b] = c;
+        else if(exact[b] != c) exact[b] = QUANT_MIXED;
+    }
+
+    //The used bins with their exact colour, or the centre of the bin
+    uint32_t used = 0;
+    for(i = 0; i < QUANT_BINS; i++) if(cnt[i] > 0) used++;
+    quant_color_t * colors = malloc(used * sizeof(quant_color_t));
+    if(colors == NULL)
+    {
+        free(cnt);
+        free(exact);
+        return false;
+    }
+    uint32_t k = 0;
+    for(i = 0; i < QUANT_BINS; i++)
+    {
+        if(cnt[i] == 0) continue;
+        quant_color_t * c = &colors[k++];
+        c->cnt = cnt[i];
+        c->bin = i;
+        uint32_t ch;
+        for(ch = 0; ch < 3; ch++)
+        {
+            uint32_t q = (i >> ((2 - ch) * QUANT_BITS)) & ((1 << QUANT_BITS) - 1);
+            c->c[ch] = exact[i] != QUANT_MIXED ? (exact[i] >> ((2 - ch) * 8)) & 0xFF :
+                       (q << (8 - QUANT_BITS)) | (1 << (7 - QUANT_BITS));
+        }
+    }
+    free(cnt);
+    free(exact);
+
+    //Split the box with the widest channel at the median pixel until there are enough boxes
+    uint32_t box_first[256];
+    uint32_t box_end[256];
+    uint32_t box_cnt = 1;
+    box_first[0] = 0;
+    box_end[0] = used;
+    while(box_cnt < pal_size)
+    {
+        uint32_t best = box_cnt;
+        uint32_t best_ch = 0;
+        int32_t best_span = 0;
+        uint32_t b;
+        for(b = 0; b < box_cnt; b++)
+        {
+            if(box_end[b] - box_first[b] < 2) continue;
+            uint32_t ch;
+            for(ch = 0; ch < 3; ch++)
+            {
+                uint8_t lo = 255;
+                uint8_t hi = 0;
+                for(i = box_first[b]; i < box_end[b]; i++)
+                {
+                    if(colors[i].c[ch] < lo) lo = colors[i].c[ch];
+                    if(colors[i].c[ch] > hi) hi = colors[i].c[ch];
+                }
+                if(hi - lo > best_span)
+                {
+                    best = b;
+                    best_ch = ch;
+                    best_span = hi - lo;
+                }
+            }
+        }
+        if(best == box_cnt) break;      //Every box has one colour
+
+        uint32_t first = box_first[best];
+        uint32_t end = box_end[best];
+        qsort(&colors[first], end - first, sizeof(quant_color_t), color_cmp[best_ch]);
+        uint64_t total = 0;
+        for(i = first; i < end; i++) total += colors[i].cnt;
+        //Both halves keep at least one colour
+        uint64_t sum = colors[first].cnt;
+        uint32_t split;
+        for(split = first + 1; split < end - 1 && sum * 2 < total; split++) sum += colors[split].cnt;
+
+        box_first[box_cnt] = split;
+        box_end[box_cnt] = end;
+        box_end[best] = split;
+        box_cnt++;
+    }
+
+    //The pixel weighted average of every box
+    for(k = 0; k < box_cnt; k++)
+    {
+        uint64_t sum[3] = {0, 0, 0};
+        uint64_t total = 0;
+        for(i = box_first[k]; i < box_end[k]; i++)
+        {
+            uint32_t ch;
+            for(ch = 0; ch < 3; ch++) sum[ch] += (uint64_t)colors[i].c[ch] * colors[i].cnt;
+            total += colors[i].cnt;
+            bin_index[colors[i].bin] = k;
+        }
+        uint32_t ch;
+        for(ch = 0; ch < 3; ch++) pal[k].c[ch] = (sum[ch] + total / 2) / total;
+        pal[k].cnt = total;
+    }
+    *pal_cnt = box_cnt;
+    free(colors);
+    return true;
+}
+
+static int color_cmp_r(const void * a, const void * b)
+{
+    return ((const quant_color_t *)a)->c[0] - ((const quant_color_t *)b)->c[0];
+}
+
+static int color_cmp_g(const void * a, const void * b)
+{
+    return ((const quant_color_t *)a)->c[1] - ((const quant_color_t *)b)->c[1];
+}
+
+static int color_cmp_b(const void * a, const void * b)
+{
+    return ((const quant_color_t *)a)->c[2] - ((const quant_color_t *)b)->c[2];
+}
+
+static uint32_t bin_get(const uint8_t * rgb)
+{
+    return ((rgb[0] >> (8 - QUANT_BITS)) << (2 * QUANT_BITS)) | ((rgb[1] >> (8 - QUANT_BITS)) << QUANT_BITS) |
+           (rgb[2] >> (8 - QUANT_BITS));
+}
+
+static uint32_t exact_key(lv_color32_t c)
+{
+    return 0x01000000 | (c.ch.red << 16) | (c.ch.green << 8) | c.ch.blue;
+}
+
+//The slot of `key`, or the empty one where it goes. There are always empty slots.
+static uint32_t exact_slot(const uint32_t * slots, uint32_t key)
+{
+    uint32_t slot = (key * 2654435761u) % EXACT_SLOTS;
+    while(slots[slot] != 0 && slots[slot] != key) slot = (slot + 1) % EXACT_SLOTS;
+    return slot;
+}
+
+//The header and the size have to match, an asset of another conversion is converted again
+static bool cache_read(uint64_t hash, lv_img_cf_t cf, imgasset_target_t target, imgasset_data_t * data)
+{
+    assetstore_blob_t blob;
+    if(!assetstore_get(hash, STORE_KIND, &blob)) return false;
+
+    lv_img_header_t header;
+    if(blob.size >= sizeof(header))
+    {
+        memcpy(&header, blob.data, sizeof(header));
+        if(header.cf == cf && header.w > 0 && header.h > 0 &&
+           blob.size == sizeof(header) + data_size_get(cf, header.w, header.h, target.depth))
+        {
+            data->header = header;
+            data->data_size = blob.size - sizeof(header);
+            data->data = (uint8_t *)blob.data + sizeof(header);    //Read only, the generated code only prints it
+            data->blob = blob;
+            data->cached = true;
+            return true;
+        }
+    }
+    assetstore_release(&blob);
+    return false;
+}
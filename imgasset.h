@@ -0,0 +1,92 @@
+/**
+ * @file imgasset.h
+ *
+ */
+
+#ifndef _IMGASSET_H_
+#define _IMGASSET_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include "assetstore.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMGASSET_MAX            64
+#define IMGASSET_NAME_MAX       32      //With the terminating zero
+#define IMGASSET_PATH_MAX       256
+#define IMGASSET_LIST_FILE      "lv_gui_img.lst"
+#define IMGASSET_SIZE_MAX       2047    //Width and height fit in the 11 bits of `lv_img_header_t`
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    char name[IMGASSET_NAME_MAX];       //The `lv_img_dsc_t` in the generated code, a C identifier
+    char path[IMGASSET_PATH_MAX];       //Source image: binary PGM, PPM or PAM
+    lv_img_cf_t cf;                     //True color (with alpha), indexed or alpha only
+}imgasset_t;
+
+//The colour format of the target, the images are converted to it by the designer
+typedef struct
+{
+    uint8_t depth;                      //LV_COLOR_DEPTH of the target: 1, 8, 16 or 32
+    uint8_t swap;                       //LV_COLOR_16_SWAP of the target, only with 16 bit
+}imgasset_target_t;
+
+//A converted image, the same as the data of an LVGL `.bin` image without its header
+typedef struct
+{
+    lv_img_header_t header;
+    uint32_t data_size;
+    uint8_t * data;                     //In `blob` if it's cached, read only then
+    uint64_t hash;                      //Of the source's content, the colour format and the target
+    assetstore_blob_t blob;
+    bool cached;                        //Mapped from the asset store, not converted now
+}imgasset_data_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool imgasset_add(const char * name, const char * path, lv_img_cf_t cf);
+bool imgasset_remove(const char * name);
+uint32_t imgasset_get_count(void);
+bool imgasset_get(uint32_t i, imgasset_t * asset);
+bool imgasset_set_target(uint8_t depth, bool swap);
+imgasset_target_t imgasset_get_target(void);
+lv_img_cf_t imgasset_cf_from_name(const char * name);
+const char * imgasset_cf_get_name(lv_img_cf_t cf);
+const char * imgasset_cf_get_code(lv_img_cf_t cf);
+bool imgasset_convert(const imgasset_t * asset, imgasset_data_t * data);
+bool imgasset_convert_px(const lv_color32_t * px, uint32_t w, uint32_t h, imgasset_data_t * data);
+void imgasset_data_free(imgasset_data_t * data);
+bool imgasset_list_save(const char * path);
+bool imgasset_list_load(const char * path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,1039 @@
+/**
+ * @file imgcmp.c
+ * Compare rendered screens with golden images for visual regression tests.
+ * A pixel differs if any of its colour channels differs more than the tolerance. The rows are compared with
+ * SSE2, AVX2 or NEON (selected at run time like the kernels of `lv_draw_simd.c`) and only the rows with differences
+ * are looked at pixel by pixel: the differing pixels are grouped by touching `IMGCMP_TILE` sized tiles into regions,
+ * and the diff image shows them in red over the faded golden image.
+ * Directories of PNGs are compared on several threads, one image at a time on each. The headless renderer compares
+ * its frames straight from memory (`--render-golden`), without writing them into PNGs first.
+ * Any 8 bit RGB or RGBA PNG can be read, not only the stored ones written by `headless.c`.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <SDL2/SDL.h>
+#include "imgcmp.h"
+#include "headless.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The kernels compare the bytes of little endian `lv_color32_t`s*/
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define IMGCMP_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define IMGCMP_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifndef IMGCMP_X86
+#define IMGCMP_X86 0
+#endif
+
+#ifndef IMGCMP_NEON
+#define IMGCMP_NEON 0
+#endif
+
+#define IMGCMP_ALPHA_IGNORE     0xFF000000UL    //Added to the tolerance: the alpha channel never differs
+#define IMGCMP_PRINT_BOXES      4               //Regions printed of an image
+#define INFLATE_LEN_CODES       288
+#define INFLATE_DIST_CODES      30
+#define INFLATE_BITS_MAX        15
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//Count the pixels of a row which differ more than `tol` in a channel
+typedef uint32_t (*row_cmp_cb_t)(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol);
+
+//Get row `y` of the compared image, converted into `conv` (`w` pixels) if it's not `lv_color32_t`
+typedef const lv_color32_t * (*row_get_cb_t)(const void * src, uint32_t y, lv_color32_t * conv);
+
+//The rendered frame: `lv_color_t`s, `stride` pixels per row
+typedef struct
+{
+    const lv_color_t * px;
+    uint32_t stride;
+    uint32_t w;
+}frame_src_t;
+
+//Comparing the PNGs of two directories on several threads
+typedef struct
+{
+    const char * golden_dir;
+    const char * dir;
+    const char * diff_dir;
+    uint8_t tol;
+    char ** names;
+    imgcmp_res_t * res;
+    uint32_t cnt;
+    uint32_t next;              //The next image to compare, taken atomically by the threads
+}dir_job_t;
+
+typedef struct
+{
+    uint16_t cnt[INFLATE_BITS_MAX + 1];     //Codes of each length
+    uint16_t sym[INFLATE_LEN_CODES];        //The symbols ordered by their codes
+}huff_t;
+
+typedef struct
+{
+    const uint8_t * in;
+    size_t in_len;
+    size_t in_pos;
+    uint32_t bit_buf;
+    uint32_t bit_cnt;
+    uint8_t * out;
+    size_t out_len;
+    size_t out_pos;
+    bool err;
+}inflate_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void compare(const imgcmp_img_t * golden, row_get_cb_t row_get, const void * src, uint32_t w, uint32_t h,
+                    uint8_t tol, imgcmp_res_t * res, imgcmp_img_t * diff);
+static void regions_find(imgcmp_box_t * tiles, uint32_t tw, uint32_t th, imgcmp_res_t * res);
+static const lv_color32_t * frame_row_get(const void * src, uint32_t y, lv_color32_t * conv);
+static const lv_color32_t * img_row_get(const void * src, uint32_t y, lv_color32_t * conv);
+static inline bool px_differs(lv_color32_t a, lv_color32_t b, uint8_t tol);
+static uint32_t row_cmp_scalar(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol);
+#if IMGCMP_X86
+static uint32_t row_cmp_sse2(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol);
+static uint32_t row_cmp_avx2(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol);
+#elif IMGCMP_NEON
+static uint32_t row_cmp_neon(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol);
+#endif
+static void * dir_worker(void * param);
+static void dir_compare(dir_job_t * job, uint32_t i);
+static int name_cmp(const void * a, const void * b);
+static bool json_write(const char * path, const dir_job_t * job);
+static uint8_t * file_read(const char * path, size_t * len);
+static bool png_unfilter(uint8_t * raw, uint32_t w, uint32_t h, uint32_t bpp);
+static bool inflate(const uint8_t * in, size_t in_len, uint8_t * out, size_t out_len);
+static uint32_t inflate_bits(inflate_t * s, uint32_t n);
+static bool inflate_stored(inflate_t * s);
+static bool inflate_codes(inflate_t * s, const huff_t * len_code, const huff_t * dist_code);
+static bool inflate_dynamic(inflate_t * s);
+static bool huff_build(huff_t * h, const uint8_t * lens, uint32_t n);
+static int huff_decode(inflate_t * s, const huff_t * h);
+static inline uint32_t be32_get(const uint8_t * p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static row_cmp_cb_t row_cmp = row_cmp_scalar;
+static const char * simd_name = "none";
+
+static const char * status_names[_IMGCMP_STATUS_NUM] = {"match", "diff", "size", "missing", "error"};
+
+static const uint16_t len_base[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83,
+                                      99, 115, 131, 163, 195, 227, 258};
+static const uint8_t len_extra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5,
+                                      5, 0};
+static const uint16_t dist_base[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                       1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t dist_extra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11,
+                                       12, 12, 13, 13};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Select the row comparison supported by the CPU. Call it before comparing.
+void imgcmp_init(void)
+{
+#if IMGCMP_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        row_cmp = row_cmp_avx2;
+        simd_name = "AVX2";
+    }else if(__builtin_cpu_supports("sse2"))
+    {
+        row_cmp = row_cmp_sse2;
+        simd_name = "SSE2";
+    }
+#elif IMGCMP_NEON
+    row_cmp = row_cmp_neon;
+    simd_name = "NEON";
+#endif
+}
+
+const char * imgcmp_get_simd_name(void)
+{
+    return simd_name;
+}
+
+const char * imgcmp_status_name(imgcmp_status_t status)
+{
+    return status < _IMGCMP_STATUS_NUM ? status_names[status] : "?";
+}
+
+//Read an 8 bit RGB or RGBA PNG (not interlaced). Free it with `imgcmp_img_free`.
+bool imgcmp_png_load(const char * path, imgcmp_img_t * img)
+{
+    static const uint8_t sig[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    memset(img, 0, sizeof(imgcmp_img_t));
+    size_t len;
+    uint8_t * data = file_read(path, &len);
+    if(data == NULL) return false;
+
+    bool ok = len >= sizeof(sig) && memcmp(data, sig, sizeof(sig)) == 0;
+    uint32_t w = 0;
+    uint32_t h = 0;
+    uint32_t bpp = 0;
+    uint8_t * idat = NULL;
+    size_t idat_len = 0;
+    size_t pos = sizeof(sig);
+    while(ok && pos + 12 <= len)
+    {
+        uint32_t chunk_len = be32_get(&data[pos]);
+        const uint8_t * type = &data[pos + 4];
+        const uint8_t * chunk = &data[pos + 8];
+        if(chunk_len > len - pos - 12)
+        {
+            ok = false;
+            break;
+        }
+
+        if(memcmp(type, "IHDR", 4) == 0 && chunk_len >= 13)
+        {
+            w = be32_get(chunk);
+            h = be32_get(&chunk[4]);
+            bpp = chunk[9] == 2 ? 3 : (chunk[9] == 6 ? 4 : 0);
+            //Only 8 bit channels, deflate, no interlace
+            if(chunk[8] != 8 || bpp == 0 || chunk[10] != 0 || chunk[11] != 0 || chunk[12] != 0) ok = false;
+            if(w == 0 || h == 0 || (uint64_t)w * h > (1UL << 28)) ok = false;
+        }else if(memcmp(type, "IDAT", 4) == 0)
+        {
+            uint8_t * idat_new = realloc(idat, idat_len + chunk_len);
+            if(idat_new == NULL)
+            {
+                ok = false;
+                break;
+            }
+            idat = idat_new;
+            memcpy(&idat[idat_len], chunk, chunk_len);
+            idat_len += chunk_len;
+        }else if(memcmp(type, "IEND", 4) == 0)
+        {
+            break;
+        }
+        pos += 12 + chunk_len;
+    }
+    free(data);
+
+    //The zlib header: deflate without a preset dictionary
+    ok = ok && bpp != 0 && idat_len > 2 && (idat[0] & 0x0F) == 8 && (idat[1] & 0x20) == 0;
+
+    size_t raw_len = (size_t)h * (1 + (size_t)w * bpp);
+    uint8_t * raw = ok ? malloc(raw_len) : NULL;
+    if(raw == NULL || !inflate(&idat[2], idat_len - 2, raw, raw_len) || !png_unfilter(raw, w, h, bpp))
+    {
+        free(idat);
+        free(raw);
+        return false;
+    }
+    free(idat);
+
+    img->px = malloc((size_t)w * h * sizeof(lv_color32_t));
+    if(img->px == NULL)
+    {
+        free(raw);
+        return false;
+    }
+    img->w = w;
+    img->h = h;
+    uint32_t y;
+    for(y = 0; y < h; y++)
+    {
+        const uint8_t * p = &raw[(size_t)y * (1 + w * bpp) + 1];
+        lv_color32_t * px = &img->px[(size_t)y * w];
+        uint32_t x;
+        for(x = 0; x < w; x++)
+        {
+            px[x].ch.red = p[0];
+            px[x].ch.green = p[1];
+            px[x].ch.blue = p[2];
+            px[x].ch.alpha = 0xFF;
+            p += bpp;
+        }
+    }
+    free(raw);
+    return true;
+}
+
+void imgcmp_img_free(imgcmp_img_t * img)
+{
+    free(img->px);
+    img->px = NULL;
+}
+
+//Compare `w` x `h` pixels of a frame (`stride` pixels per row) with a golden image.
+//If `diff` is not NULL and the images differ, the diff image is created into it (free it with `imgcmp_img_free`).
+void imgcmp_compare(const imgcmp_img_t * golden, const lv_color_t * px, uint32_t stride, uint32_t w, uint32_t h,
+                    uint8_t tol, imgcmp_res_t * res, imgcmp_img_t * diff)
+{
+    frame_src_t src = {px, stride, w};
+    compare(golden, frame_row_get, &src, w, h, tol, res, diff);
+}
+
+//Print a line about a differing image, nothing if it matches
+void imgcmp_res_print(const char * name, const imgcmp_res_t * res)
+{
+    if(res->status == IMGCMP_MATCH) return;
+    if(res->status != IMGCMP_DIFF)
+    {
+        printf("%s: %s\n", name, imgcmp_status_name(res->status));
+        return;
+    }
+
+    printf("%s: %u px differ in %u region%s:", name, res->diff_px, res->box_cnt, res->box_cnt > 1 ? "s" : "");
+    uint32_t i;
+    for(i = 0; i < res->box_cnt && i < IMGCMP_PRINT_BOXES; i++)
+    {
+        const imgcmp_box_t * b = &res->boxes[i];
+        printf(" %u,%u %ux%u", b->x1, b->y1, b->x2 - b->x1 + 1, b->y2 - b->y1 + 1);
+    }
+    printf("%s\n", res->box_cnt > IMGCMP_PRINT_BOXES ? " ..." : "");
+}
+
+//Compare every PNG of `golden_dir` with the one of the same name in `dir` on `threads` threads (0: one per CPU),
+//print the differences and write them into `json_path` too if it's not NULL. The diff images are written into
+//`diff_dir` as `<name>_diff.png` if it's not NULL. true: every image matches.
+bool imgcmp_dirs(const char * golden_dir, const char * dir, uint8_t tol, const char * diff_dir, uint32_t threads,
+                 const char * json_path)
+{
+    DIR * d = opendir(golden_dir);
+    if(d == NULL)
+    {
+        printf("Can't open %s\n", golden_dir);
+        return false;
+    }
+
+    dir_job_t job;
+    memset(&job, 0, sizeof(job));
+    job.golden_dir = golden_dir;
+    job.dir = dir;
+    job.diff_dir = diff_dir;
+    job.tol = tol;
+
+    uint32_t name_max = 0;
+    bool ok = true;
+    struct dirent * e;
+    while((e = readdir(d)) != NULL && ok)
+    {
+        size_t len = strlen(e->d_name);
+        if(len < 5 || strcmp(&e->d_name[len - 4], ".png")) continue;
+        if(job.cnt == name_max)
+        {
+            name_max = name_max ? name_max * 2 : 64;
+            char ** names_new = realloc(job.names, name_max * sizeof(char *));
+            if(names_new == NULL)
+            {
+                ok = false;
+                break;
+            }
+            job.names = names_new;
+        }
+        job.names[job.cnt] = strdup(e->d_name);
+        if(job.names[job.cnt] == NULL) ok = false;
+        else job.cnt++;
+    }
+    closedir(d);
+
+    if(ok && job.cnt > 0)
+    {
+        qsort(job.names, job.cnt, sizeof(char *), name_cmp);
+        job.res = calloc(job.cnt, sizeof(imgcmp_res_t));
+        if(job.res == NULL) ok = false;
+    }
+    if(!ok) printf("Compare failed, out of memory\n");
+
+    if(ok)
+    {
+        imgcmp_init();
+
+        if(threads == 0) threads = sysconf(_SC_NPROCESSORS_ONLN);
+        if(threads > IMGCMP_THREAD_MAX) threads = IMGCMP_THREAD_MAX;
+        if(threads > job.cnt) threads = job.cnt;
+        if(threads == 0) threads = 1;
+
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        pthread_t tids[IMGCMP_THREAD_MAX];
+        uint32_t started = 0;
+        uint32_t i;
+        for(i = 1; i < threads; i++)
+        {
+            if(pthread_create(&tids[started], NULL, dir_worker, &job) == 0) started++;
+        }
+        dir_worker(&job);
+        for(i = 0; i < started; i++) pthread_join(tids[i], NULL);
+        double ms = (double)(SDL_GetPerformanceCounter() - t_start) * 1000.0 / SDL_GetPerformanceFrequency();
+
+        uint32_t failed = 0;
+        for(i = 0; i < job.cnt; i++)
+        {
+            imgcmp_res_print(job.names[i], &job.res[i]);
+            if(job.res[i].status != IMGCMP_MATCH) failed++;
+        }
+        printf("%u images compared in %.1f ms on %u thread%s (%s), %u differ\n", job.cnt, ms, started + 1,
+               started ? "s" : "", simd_name, failed);
+
+        if(json_path != NULL && !json_write(json_path, &job)) ok = false;
+        if(failed > 0) ok = false;
+    }
+
+    uint32_t i;
+    for(i = 0; i < job.cnt; i++) free(job.names[i]);
+    free(job.names);
+    free(job.res);
+    return ok;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void compare(const imgcmp_img_t * golden, row_get_cb_t row_get, const void * src, uint32_t w, uint32_t h,
+                    uint8_t tol, imgcmp_res_t * res, imgcmp_img_t * diff)
+{
+    memset(res, 0, sizeof(imgcmp_res_t));
+    if(diff) memset(diff, 0, sizeof(imgcmp_img_t));
+    if(golden->w != w || golden->h != h)
+    {
+        res->status = IMGCMP_SIZE;
+        return;
+    }
+
+    uint32_t tw = (w + IMGCMP_TILE - 1) / IMGCMP_TILE;
+    uint32_t th = (h + IMGCMP_TILE - 1) / IMGCMP_TILE;
+    lv_color32_t * conv = malloc(w * sizeof(lv_color32_t));
+    uint8_t * row_diff = calloc(h, 1);
+    if(conv == NULL || row_diff == NULL)
+    {
+        free(conv);
+        free(row_diff);
+        res->status = IMGCMP_ERROR;
+        return;
+    }
+
+    //Usually nothing differs: only the vectorized comparison runs
+    uint32_t y;
+    for(y = 0; y < h; y++)
+    {
+        uint32_t cnt = row_cmp(&golden->px[(size_t)y * w], row_get(src, y, conv), w, tol);
+        row_diff[y] = cnt > 0;
+        res->diff_px += cnt;
+    }
+    if(res->diff_px == 0)
+    {
+        free(conv);
+        free(row_diff);
+        res->status = IMGCMP_MATCH;
+        return;
+    }
+    res->status = IMGCMP_DIFF;
+
+    imgcmp_box_t * tiles = malloc(tw * th * sizeof(imgcmp_box_t));
+    if(diff)
+    {
+        diff->px = malloc((size_t)w * h * sizeof(lv_color32_t));
+        diff->w = w;
+        diff->h = h;
+    }
+    if(tiles == NULL || (diff && diff->px == NULL))
+    {
+        free(tiles);
+        if(diff) imgcmp_img_free(diff);
+        free(conv);
+        free(row_diff);
+        res->status = IMGCMP_ERROR;
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < tw * th; i++) tiles[i].x1 = UINT32_MAX;     //Empty
+
+    for(y = 0; y < h; y++)
+    {
+        const lv_color32_t * g = &golden->px[(size_t)y * w];
+        lv_color32_t * d = diff ? &diff->px[(size_t)y * w] : NULL;
+        uint32_t x;
+        if(d)
+        {
+            //The golden image faded to light grey
+            for(x = 0; x < w; x++)
+            {
+                uint8_t v = 192 + (g[x].ch.red + g[x].ch.green + g[x].ch.blue) / 12;
+                d[x].full = 0;
+                d[x].ch.red = v;
+                d[x].ch.green = v;
+                d[x].ch.blue = v;
+                d[x].ch.alpha = 0xFF;
+            }
+        }
+        if(!row_diff[y]) continue;
+
+        const lv_color32_t * a = row_get(src, y, conv);
+        imgcmp_box_t * tile_row = &tiles[(y / IMGCMP_TILE) * tw];
+        for(x = 0; x < w; x++)
+        {
+            if(!px_differs(g[x], a[x], tol)) continue;
+            if(d)
+            {
+                d[x].ch.red = 0xFF;
+                d[x].ch.green = 0;
+                d[x].ch.blue = 0;
+            }
+
+            imgcmp_box_t * t = &tile_row[x / IMGCMP_TILE];
+            if(t->x1 == UINT32_MAX)
+            {
+                t->x1 = x;
+                t->x2 = x;
+                t->y1 = y;
+                t->y2 = y;
+            }else
+            {
+                if(x < t->x1) t->x1 = x;
+                if(x > t->x2) t->x2 = x;
+                t->y2 = y;
+            }
+        }
+    }
+
+    regions_find(tiles, tw, th, res);
+    free(tiles);
+    free(conv);
+    free(row_diff);
+}
+
+//Merge the touching tiles with differences (also diagonally) into regions
+static void regions_find(imgcmp_box_t * tiles, uint32_t tw, uint32_t th, imgcmp_res_t * res)
+{
+    uint32_t * stack = malloc(tw * th * sizeof(uint32_t));
+    if(stack == NULL) return;
+
+    uint32_t t;
+    for(t = 0; t < tw * th; t++)
+    {
+        if(tiles[t].x1 == UINT32_MAX) continue;
+
+        imgcmp_box_t box = tiles[t];
+        tiles[t].x1 = UINT32_MAX;
+        uint32_t sp = 0;
+        stack[sp++] = t;
+        while(sp > 0)
+        {
+            uint32_t u = stack[--sp];
+            int32_t tx = u % tw;
+            int32_t ty = u / tw;
+            int32_t dx, dy;
+            for(dy = -1; dy <= 1; dy++)
+            {
+                for(dx = -1; dx <= 1; dx++)
+                {
+                    int32_t nx = tx + dx;
+                    int32_t ny = ty + dy;
+                    if(nx < 0 || ny < 0 || nx >= (int32_t)tw || ny >= (int32_t)th) continue;
+                    imgcmp_box_t * n = &tiles[ny * tw + nx];
+                    if(n->x1 == UINT32_MAX) continue;
+
+                    if(n->x1 < box.x1) box.x1 = n->x1;
+                    if(n->y1 < box.y1) box.y1 = n->y1;
+                    if(n->x2 > box.x2) box.x2 = n->x2;
+                    if(n->y2 > box.y2) box.y2 = n->y2;
+                    n->x1 = UINT32_MAX;
+                    stack[sp++] = ny * tw + nx;
+                }
+            }
+        }
+
+        if(res->box_cnt < IMGCMP_BOX_MAX) res->boxes[res->box_cnt] = box;
+        res->box_cnt++;
+    }
+    free(stack);
+}
+
+static const lv_color32_t * frame_row_get(const void * src, uint32_t y, lv_color32_t * conv)
+{
+    const frame_src_t * f = src;
+    const lv_color_t * px = &f->px[(size_t)y * f->stride];
+#if LV_COLOR_DEPTH == 32
+    (void)conv;
+    return (const lv_color32_t *)px;
+#else
+    uint32_t x;
+    for(x = 0; x < f->w; x++) conv[x].full = lv_color_to32(px[x]);
+    return conv;
+#endif
+}
+
+static const lv_color32_t * img_row_get(const void * src, uint32_t y, lv_color32_t * conv)
+{
+    (void)conv;
+    const imgcmp_img_t * img = src;
+    return &img->px[(size_t)y * img->w];
+}
+
+static inline bool px_differs(lv_color32_t a, lv_color32_t b, uint8_t tol)
+{
+    return LV_MATH_ABS(a.ch.red - b.ch.red) > tol || LV_MATH_ABS(a.ch.green - b.ch.green) > tol ||
+           LV_MATH_ABS(a.ch.blue - b.ch.blue) > tol;
+}
+
+static uint32_t row_cmp_scalar(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol)
+{
+    uint32_t cnt = 0;
+    uint32_t x;
+    for(x = 0; x < w; x++) cnt += px_differs(a[x], b[x], tol);
+    return cnt;
+}
+
+#if IMGCMP_X86
+
+//|a - b| per byte with saturating subtractions, then what is left over the tolerance has to be 0 in every pixel
+__attribute__((target("sse2"))) static uint32_t row_cmp_sse2(const lv_color32_t * a, const lv_color32_t * b,
+                                                             uint32_t w, uint8_t tol)
+{
+    const __m128i tol_v = _mm_set1_epi32((int)(IMGCMP_ALPHA_IGNORE | tol * 0x010101UL));
+    const __m128i zero = _mm_setzero_si128();
+    uint32_t cnt = 0;
+    uint32_t x;
+    for(x = 0; x + 4 <= w; x += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)&a[x]);
+        __m128i vb = _mm_loadu_si128((const __m128i *)&b[x]);
+        __m128i d = _mm_or_si128(_mm_subs_epu8(va, vb), _mm_subs_epu8(vb, va));
+        __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(d, tol_v), zero);
+        cnt += 4 - __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(same)));
+    }
+    return cnt + row_cmp_scalar(&a[x], &b[x], w - x, tol);
+}
+
+__attribute__((target("avx2"))) static uint32_t row_cmp_avx2(const lv_color32_t * a, const lv_color32_t * b,
+                                                             uint32_t w, uint8_t tol)
+{
+    const __m256i tol_v = _mm256_set1_epi32((int)(IMGCMP_ALPHA_IGNORE | tol * 0x010101UL));
+    const __m256i zero = _mm256_setzero_si256();
+    uint32_t cnt = 0;
+    uint32_t x;
+    for(x = 0; x + 8 <= w; x += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)&a[x]);
+        __m256i vb = _mm256_loadu_si256((const __m256i *)&b[x]);
+        __m256i d = _mm256_or_si256(_mm256_subs_epu8(va, vb), _mm256_subs_epu8(vb, va));
+        __m256i same = _mm256_cmpeq_epi32(_mm256_subs_epu8(d, tol_v), zero);
+        cnt += 8 - __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(same)));
+    }
+    return cnt + row_cmp_scalar(&a[x], &b[x], w - x, tol);
+}
+
+#elif IMGCMP_NEON
+
+static uint32_t row_cmp_neon(const lv_color32_t * a, const lv_color32_t * b, uint32_t w, uint8_t tol)
+{
+    const uint8x16_t tol_v = vreinterpretq_u8_u32(vdupq_n_u32(IMGCMP_ALPHA_IGNORE | tol * 0x010101UL));
+    uint32x4_t cnt_v = vdupq_n_u32(0);
+    uint32_t x;
+    for(x = 0; x + 4 <= w; x += 4)
+    {
+        uint8x16_t va = vld1q_u8((const uint8_t *)&a[x]);
+        uint8x16_t vb = vld1q_u8((const uint8_t *)&b[x]);
+        uint32x4_t over = vreinterpretq_u32_u8(vqsubq_u8(vabdq_u8(va, vb), tol_v));
+        cnt_v = vaddq_u32(cnt_v, vshrq_n_u32(vtstq_u32(over, over), 31));
+    }
+    uint32x2_t sum = vadd_u32(vget_low_u32(cnt_v), vget_high_u32(cnt_v));
+    uint32_t cnt = vget_lane_u32(vpadd_u32(sum, sum), 0);
+    return cnt + row_cmp_scalar(&a[x], &b[x], w - x, tol);
+}
+
+#endif
+
+static void * dir_worker(void * param)
+{
+    dir_job_t * job = param;
+    uint32_t i;
+    while((i = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->cnt) dir_compare(job, i);
+    return NULL;
+}
+
+static void dir_compare(dir_job_t * job, uint32_t i)
+{
+    imgcmp_res_t * res = &job->res[i];
+    char path[IMGCMP_PATH_MAX];
+
+    imgcmp_img_t golden;
+    snprintf(path, sizeof(path), "%s/%s", job->golden_dir, job->names[i]);
+    if(!imgcmp_png_load(path, &golden))
+    {
+        res->status = IMGCMP_ERROR;
+        return;
+    }
+
+    imgcmp_img_t img;
+    snprintf(path, sizeof(path), "%s/%s", job->dir, job->names[i]);
+    if(!imgcmp_png_load(path, &img))
+    {
+        res->status = access(path, F_OK) == 0 ? IMGCMP_ERROR : IMGCMP_MISSING;
+        imgcmp_img_free(&golden);
+        return;
+    }
+
+    imgcmp_img_t diff;
+    compare(&golden, img_row_get, &img, img.w, img.h, job->tol, res, job->diff_dir ? &diff : NULL);
+    if(job->diff_dir && diff.px)
+    {
+        size_t len = strlen(job->names[i]) - 4;     //Without ".png"
+        snprintf(path, sizeof(path), "%s/%.*s_diff.png", job->diff_dir, (int)len, job->names[i]);
+        headless_png_save(path, diff.px, diff.w, diff.h);
+        imgcmp_img_free(&diff);
+    }
+    imgcmp_img_free(&golden);
+    imgcmp_img_free(&img);
+}
+
+static int name_cmp(const void * a, const void * b)
+{
+    return strcmp(*(char * const *)a, *(char * const *)b);
+}
+
+//{"tol": ..., "images": [{"name": ..., "status": "match|diff|size|missing|error", "diff_px": ...,
+// "regions": ..., "boxes": [[x1, y1, x2, y2], ...]}, ...]}
+static bool json_write(const char * path, const dir_job_t * job)
+{
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "{\"tol\": %u, \"images\": [", job->tol);
+    uint32_t i;
+    for(i = 0; i < job->cnt; i++)
+    {
+        const imgcmp_res_t * res = &job->res[i];
+        fprintf(fp, "%s\n  {\"name\": \"%s\", \"status\": \"%s\", \"diff_px\": %u, \"regions\": %u, \"boxes\": [",
+                i ? "," : "", job->names[i], imgcmp_status_name(res->status), res->diff_px, res->box_cnt);
+        uint32_t b;
+        for(b = 0; b < res->box_cnt && b < IMGCMP_BOX_MAX; b++)
+        {
+            fprintf(fp, "%s[%u, %u, %u, %u]", b ? ", " : "", res->boxes[b].x1, res->boxes[b].y1, res->boxes[b].x2,
+                    res->boxes[b].y2);
+        }
+        fprintf(fp, "]}");
+    }
+    fprintf(fp, "\n]}\n");
+
+    bool ok = !ferror(fp);
+    if(fclose(fp) != 0) ok = false;
+    if(!ok) printf("Can't write %s\n", path);
+    return ok;
+}
+
+static uint8_t * file_read(const char * path, size_t * len)
+{
+    FILE * fp = fopen(path, "rb");
+    if(!fp) return NULL;
+
+    uint8_t * data = NULL;
+    long size = -1;
+    if(fseek(fp, 0, SEEK_END) == 0) size = ftell(fp);
+    if(size > 0 && fseek(fp, 0, SEEK_SET) == 0) data = malloc(size);
+    if(data && fread(data, 1, size, fp) != (size_t)size)
+    {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    *len = size;
+    return data;
+}
+
+//Undo the PNG filters of the scanlines in place (the filter byte stays before every row)
+static bool png_unfilter(uint8_t * raw, uint32_t w, uint32_t h, uint32_t bpp)
+{
+    size_t line = (size_t)w * bpp;
+    const uint8_t * prev = NULL;
+    uint32_t y;
+    for(y = 0; y < h; y++)
+    {
+        uint8_t filter = raw[0];
+        uint8_t * p = &raw[1];
+        size_t i;
+        switch(filter)
+        {
+            case 0:
+                break;
+            case 1:
+                for(i = bpp; i < line; i++) p[i] += p[i - bpp];
+                break;
+            case 2:
+                if(prev) for(i = 0; i < line; i++) p[i] += prev[i];
+                break;
+            case 3:
+                for(i = 0; i < line; i++)
+                {
+                    uint32_t left = i >= bpp ? p[i - bpp] : 0;
+                    uint32_t up = prev ? prev[i] : 0;
+                    p[i] += (left + up) >> 1;
+                }
+                break;
+            case 4:
+                for(i = 0; i < line; i++)
+                {
+                    int32_t left = i >= bpp ? p[i - bpp] : 0;
+                    int32_t up = prev ? prev[i] : 0;
+                    int32_t up_left = prev && i >= bpp ? prev[i - bpp] : 0;
+                    int32_t est = left + up - up_left;
+                    int32_t d_left = LV_MATH_ABS(est - left);
+                    int32_t d_up = LV_MATH_ABS(est - up);
+                    int32_t d_up_left = LV_MATH_ABS(est - up_left);
+                    if(d_left <= d_up && d_left <= d_up_left) p[i] += left;
+                    else if(d_up <= d_up_left) p[i] += up;
+                    else p[i] += up_left;
+                }
+                break;
+            default:
+                return false;
+        }
+        prev = p;
+        raw += 1 + line;
+    }
+    return true;
+}
+
+//Decompress a raw deflate stream into exactly `out_len` bytes
+static bool inflate(const uint8_t * in, size_t in_len, uint8_t * out, size_t out_len)
+{
+    inflate_t s;
+    memset(&s, 0, sizeof(s));
+    s.in = in;
+    s.in_len = in_len;
+    s.out = out;
+    s.out_len = out_len;
+
+    bool last;
+    do
+    {
+        last = inflate_bits(&s, 1);
+        uint32_t type = inflate_bits(&s, 2);
+        if(s.err) return false;
+
+        bool ok;
+        if(type == 0)
+        {
+            ok = inflate_stored(&s);
+        }else if(type == 1)
+        {
+            //The fixed codes
+            uint8_t lens[INFLATE_LEN_CODES];
+            uint32_t i;
+            for(i = 0; i < 144; i++) lens[i] = 8;
+            for(; i < 256; i++) lens[i] = 9;
+            for(; i < 280; i++) lens[i] = 7;
+            for(; i < INFLATE_LEN_CODES; i++) lens[i] = 8;
+            huff_t len_code;
+            huff_t dist_code;
+            huff_build(&len_code, lens, INFLATE_LEN_CODES);
+            for(i = 0; i < INFLATE_DIST_CODES; i++) lens[i] = 5;
+            huff_build(&dist_code, lens, INFLATE_DIST_CODES);
+            ok = inflate_codes(&s, &len_code, &dist_code);
+        }else if(type == 2)
+        {
+            ok = inflate_dynamic(&s);
+        }else
+        {
+            ok = false;
+        }
+        if(!ok || s.err) return false;
+    } while(!last);
+
+    return s.out_pos == s.out_len;
+}
+
+static uint32_t inflate_bits(inflate_t * s, uint32_t n)
+{
+    uint32_t v = s->bit_buf;
+    while(s->bit_cnt < n)
+    {
+        if(s->in_pos >= s->in_len)
+        {
+            s->err = true;
+            return 0;
+        }
+        v |= (uint32_t)s->in[s->in_pos++] << s->bit_cnt;
+        s->bit_cnt += 8;
+    }
+    s->bit_buf = v >> n;
+    s->bit_cnt -= n;
+    return v & ((1UL << n) - 1);
+}
+
+static bool inflate_stored(inflate_t * s)
+{
+    //From the next byte
+    s->bit_buf = 0;
+    s->bit_cnt = 0;
+    if(s->in_pos + 4 > s->in_len) return false;
+    const uint8_t * p = &s->in[s->in_pos];
+    uint32_t len = p[0] | (p[1] << 8);
+    if((uint32_t)(p[2] | (p[3] << 8)) != (~len & 0xFFFF)) return false;
+    s->in_pos += 4;
+    if(s->in_pos + len > s->in_len || s->out_pos + len > s->out_len) return false;
+    memcpy(&s->out[s->out_pos], &s->in[s->in_pos], len);
+    s->in_pos += len;
+    s->out_pos += len;
+    return true;
+}
+
+static bool inflate_codes(inflate_t * s, const huff_t * len_code, const huff_t * dist_code)
+{
+    while(1)
+    {
+        int sym = huff_decode(s, len_code);
+        if(sym < 0) return false;
+        if(sym < 256)
+        {
+            if(s->out_pos >= s->out_len) return false;
+            s->out[s->out_pos++] = sym;
+            continue;
+        }
+        if(sym == 256) return true;
+
+        sym -= 257;
+        if(sym >= 29) return false;
+        uint32_t len = len_base[sym] + inflate_bits(s, len_extra[sym]);
+        int dsym = huff_decode(s, dist_code);
+        if(dsym < 0 || dsym >= 30) return false;
+        uint32_t dist = dist_base[dsym] + inflate_bits(s, dist_extra[dsym]);
+        if(s->err || dist > s->out_pos || s->out_pos + len > s->out_len) return false;
+
+        //Byte by byte: the copy may overlap itself
+        uint8_t * d = &s->out[s->out_pos];
+        const uint8_t * from = d - dist;
+        uint32_t i;
+        for(i = 0; i < len; i++) d[i] = from[i];
+        s->out_pos += len;
+    }
+}
+
+static bool inflate_dynamic(inflate_t * s)
+{
+    static const uint8_t order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+    uint32_t nlen = inflate_bits(s, 5) + 257;
+    uint32_t ndist = inflate_bits(s, 5) + 1;
+    uint32_t ncode = inflate_bits(s, 4) + 4;
+    if(s->err || nlen > INFLATE_LEN_CODES || ndist > INFLATE_DIST_CODES) return false;
+
+    uint8_t lens[INFLATE_LEN_CODES + INFLATE_DIST_CODES];
+    memset(lens, 0, sizeof(lens));
+    uint32_t i;
+    for(i = 0; i < ncode; i++) lens[order[i]] = inflate_bits(s, 3);
+    huff_t len_code;
+    if(s->err || !huff_build(&len_code, lens, 19)) return false;
+
+    //The code lengths of both codes, compressed with the code above
+    i = 0;
+    while(i < nlen + ndist)
+    {
+        int sym = huff_decode(s, &len_code);
+        if(sym < 0) return false;
+        if(sym < 16)
+        {
+            lens[i++] = sym;
+            continue;
+        }
+
+        uint8_t len = 0;
+        uint32_t rep;
+        if(sym == 16)
+        {
+            if(i == 0) return false;
+            len = lens[i - 1];
+            rep = 3 + inflate_bits(s, 2);
+        }else if(sym == 17)
+        {
+            rep = 3 + inflate_bits(s, 3);
+        }else
+        {
+            rep = 11 + inflate_bits(s, 7);
+        }
+        if(s->err || i + rep > nlen + ndist) return false;
+        while(rep--) lens[i++] = len;
+    }
+    if(lens[256] == 0) return false;        //No end of block code
+
+    huff_t dist_code;
+    if(!huff_build(&len_code, lens, nlen) || !huff_build(&dist_code, &lens[nlen], ndist)) return false;
+    return inflate_codes(s, &len_code, &dist_code);
+}
+
+//Build a canonical Huffman code from the lengths of its codes. Incomplete codes are allowed.
+static bool huff_build(huff_t * h, const uint8_t * lens, uint32_t n)
+{
+    memset(h->cnt, 0, sizeof(h->cnt));
+    uint32_t i;
+    for(i = 0; i < n; i++) h->cnt[lens[i]]++;
+
+    int32_t left = 1;
+    uint16_t offs[INFLATE_BITS_MAX + 1];
+    offs[1] = 0;
+    uint32_t len;
+    for(len = 1; len <= INFLATE_BITS_MAX; len++)
+    {
+        left <<= 1;
+        left -= h->cnt[len];
+        if(left < 0) return false;          //Over-subscribed
+        if(len < INFLATE_BITS_MAX) offs[len + 1] = offs[len] + h->cnt[len];
+    }
+
+    for(i = 0; i < n; i++)
+    {
+        if(lens[i] != 0) h->sym[offs[lens[i]]++] = i;
+    }
+    return true;
+}
+
+//Read the bits of a code one by one until it's complete
+static int huff_decode(inflate_t * s, const huff_t * h)
+{
+    int32_t code = 0;
+    int32_t first = 0;
+    int32_t index = 0;
+    uint32_t len;
+    for(len = 1; len <= INFLATE_BITS_MAX; len++)
+    {
+        code |= inflate_bits(s, 1);
+        if(s->err) return -1;
+        int32_t cnt = h->cnt[len];
+        if(code - cnt < first) return h->sym[index + (code - first)];
+        index += cnt;
+        first += cnt;
+        first <<= 1;
+        code <<= 1;
+    }
+    return -1;
+}
+
+static inline uint32_t be32_get(const uint8_t * p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
@@ -0,0 +1,96 @@
+/**
+ * @file imgcmp.h
+ *
+ */
+
+#ifndef _IMGCMP_H_
+#define _IMGCMP_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IMGCMP_TILE             16      //The differing pixels are grouped into regions by tiles of this size
+#define IMGCMP_BOX_MAX          32      //Regions stored of an image, the rest is only counted
+#define IMGCMP_THREAD_MAX       64
+#define IMGCMP_PATH_MAX         512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    IMGCMP_MATCH,               //Every channel of every pixel is within the tolerance
+    IMGCMP_DIFF,
+    IMGCMP_SIZE,                //The sizes differ
+    IMGCMP_MISSING,             //There is no image to compare with the golden one
+    IMGCMP_ERROR,               //An image can't be read
+    _IMGCMP_STATUS_NUM,
+}imgcmp_status_t;
+
+typedef struct
+{
+    uint32_t x1;
+    uint32_t y1;
+    uint32_t x2;
+    uint32_t y2;
+}imgcmp_box_t;
+
+typedef struct
+{
+    imgcmp_status_t status;
+    uint32_t diff_px;           //Pixels out of the tolerance
+    uint32_t box_cnt;           //Regions of them, the first `IMGCMP_BOX_MAX` are in `boxes`
+    imgcmp_box_t boxes[IMGCMP_BOX_MAX];
+}imgcmp_res_t;
+
+//An image as `lv_color32_t`, row by row
+typedef struct
+{
+    lv_color32_t * px;
+    uint32_t w;
+    uint32_t h;
+}imgcmp_img_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void imgcmp_init(void);
+const char * imgcmp_get_simd_name(void);
+const char * imgcmp_status_name(imgcmp_status_t status);
+bool imgcmp_png_load(const char * path, imgcmp_img_t * img);
+void imgcmp_img_free(imgcmp_img_t * img);
+void imgcmp_compare(const imgcmp_img_t * golden, const lv_color_t * px, uint32_t stride, uint32_t w, uint32_t h,
+                    uint8_t tol, imgcmp_res_t * res, imgcmp_img_t * diff);
+void imgcmp_res_print(const char * name, const imgcmp_res_t * res);
+bool imgcmp_dirs(const char * golden_dir, const char * dir, uint8_t tol, const char * diff_dir, uint32_t threads,
+                 const char * json_path);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
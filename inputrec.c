@@ -0,0 +1,469 @@
+/**
+ * @file inputrec.c
+ * Record the input of a session and replay it on an in-memory display to measure its frames.
+ * The recording wraps the `read_cb` of every input device (the mouse, the keyboard, the mouse wheel) and writes
+ * a line into the file when the read data changes: `tick indev state x y key enc_diff`, the tick from the start
+ * of the recording and the input device by its index in the `lv_indev_get_next` order.
+ * The replay creates the designer's GUI with the same input devices and feeds the lines to them at their ticks.
+ * `lv_tick_get` returns a virtual tick there (`LV_TICK_CUSTOM_SYS_TIME_EXPR` in lv_conf.h) which jumps to the next
+ * input or task instead of waiting, so the tasks, animations and inputs run in the same order on every replay and
+ * only the time spent on the frames is measured. Start the designer in the same directory with the same project
+ * for both: the replay begins from the state it loads at startup.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <SDL2/SDL.h>
+#include "inputrec.h"
+#include "interface.h"
+#include "bench.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define INPUTREC_MAGIC      "lvrec"
+#define INPUTREC_VERSION    1
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t tick;              //[ms] from the start of the recording
+    uint8_t indev;              //Index of the input device in the `lv_indev_get_next` order
+    lv_indev_data_t data;
+}inputrec_event_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t indevs_hook(bool (*read_cb)(lv_indev_drv_t *, lv_indev_data_t *));
+static int8_t indev_find(lv_indev_drv_t * drv);
+static bool record_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
+static void record_close(void);
+static bool events_load(const char * path);
+static bool replay_read(lv_indev_drv_t * drv, lv_indev_data_t * data);
+static void replay_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static uint32_t event_next(uint8_t indev, uint32_t from);
+static uint32_t events_wake(void);
+static int time_cmp(const void * a, const void * b);
+static bool json_write(const char * path, const double * times, const uint32_t * ticks, uint32_t cnt, double median,
+                       double p99);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_indev_t * indevs[INPUTREC_INDEV_MAX];
+static bool (*indev_read_cbs[INPUTREC_INDEV_MAX])(lv_indev_drv_t *, lv_indev_data_t *);
+static lv_indev_data_t indev_last[INPUTREC_INDEV_MAX];
+static bool indev_last_valid[INPUTREC_INDEV_MAX];
+static uint32_t indev_cnt;
+
+static FILE * rec_fp;
+static uint32_t rec_start;
+
+static inputrec_event_t * events;
+static uint32_t event_cnt;
+static uint32_t event_pos[INPUTREC_INDEV_MAX];      //The next not replayed event of each input device
+static uint32_t vtick;
+static bool replaying;
+static bool frame_drawn;
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Record the input of every registered input device into `path` until the program exits.
+//Call it after the GUI is created, when all the input devices are registered.
+bool inputrec_record_start(const char * path)
+{
+    rec_fp = fopen(path, "w");
+    if(!rec_fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(rec_fp, "%s %d %d %d\n", INPUTREC_MAGIC, INPUTREC_VERSION, lv_disp_get_hor_res(NULL),
+            lv_disp_get_ver_res(NULL));
+    memset(indev_last_valid, 0, sizeof(indev_last_valid));
+    indevs_hook(record_read);
+    rec_start = lv_tick_get();
+    atexit(record_close);
+    return true;
+}
+
+//Replay the input recorded into `path` on an in-memory display of `LV_HOR_RES_MAX` x `LV_VER_RES_MAX`
+//with the designer's GUI, print the frame times and write them into `json_path` too if it's not NULL.
+//Call it after `lv_init` instead of creating the GUI.
+bool inputrec_replay(const char * path, const char * json_path)
+{
+    if(!events_load(path)) return false;
+
+    uint32_t buf_px = (uint32_t)LV_HOR_RES_MAX * BENCH_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    uint32_t frame_max = 1024;
+    double * times = malloc(frame_max * sizeof(double));
+    uint32_t * ticks = malloc(frame_max * sizeof(uint32_t));
+    if(buf == NULL || times == NULL || ticks == NULL)
+    {
+        printf("Replay failed, out of memory\n");
+        free(buf);
+        free(times);
+        free(ticks);
+        free(events);
+        return false;
+    }
+
+    //Everything from here on sees the virtual tick, even the tasks created with the GUI
+    vtick = 0;
+    replaying = true;
+
+    lv_disp_buf_t disp_buf;
+    lv_disp_buf_init(&disp_buf, buf, NULL, buf_px);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = LV_HOR_RES_MAX;
+    disp_drv.ver_res = LV_VER_RES_MAX;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = replay_flush;
+    lv_disp_drv_register(&disp_drv);
+
+    //In place of the mouse, registered first as in `hal_init`
+    lv_indev_drv_t indev_drv;
+    lv_indev_drv_init(&indev_drv);
+    indev_drv.type = LV_INDEV_TYPE_POINTER;
+    indev_drv.read_cb = replay_read;
+    lv_indev_drv_register(&indev_drv);
+
+    lv_gui_designer();
+
+    uint32_t cnt = indevs_hook(replay_read);
+    uint32_t i;
+    for(i = 0; i < event_cnt; i++)
+    {
+        if(events[i].indev >= cnt)
+        {
+            printf("%s was recorded with more input devices (%u) than the replay has (%u)\n", path,
+                   events[i].indev + 1, cnt);
+            replaying = false;
+            free(buf);
+            free(times);
+            free(ticks);
+            free(events);
+            return false;
+        }
+    }
+    for(i = 0; i < cnt; i++)
+    {
+        memset(&indev_last[i], 0, sizeof(lv_indev_data_t));
+        indev_last[i].state = LV_INDEV_STATE_REL;
+        event_pos[i] = event_next(i, 0);
+    }
+
+    uint32_t end = (event_cnt > 0 ? events[event_cnt - 1].tick : 0) + INPUTREC_TAIL_MS;
+    uint32_t frame_cnt = 0;
+    bool ok = true;
+    double freq = (double)SDL_GetPerformanceFrequency();
+    while(vtick <= end)
+    {
+        events_wake();
+
+        frame_drawn = false;
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        uint32_t till_next = lv_task_handler();
+        double t = (double)(SDL_GetPerformanceCounter() - t_start) * 1000.0 / freq;
+
+        if(frame_drawn)
+        {
+            if(frame_cnt == frame_max)
+            {
+                frame_max *= 2;
+                double * times_new = realloc(times, frame_max * sizeof(double));
+                if(times_new) times = times_new;
+                uint32_t * ticks_new = realloc(ticks, frame_max * sizeof(uint32_t));
+                if(ticks_new) ticks = ticks_new;
+                if(times_new == NULL || ticks_new == NULL)
+                {
+                    printf("Replay failed, out of memory\n");
+                    ok = false;
+                    break;
+                }
+            }
+            times[frame_cnt] = t;
+            ticks[frame_cnt] = vtick;
+            frame_cnt++;
+        }
+
+        //Jump to the next task or input, whichever is earlier
+        uint32_t next = vtick + LV_MATH_MAX(till_next, 1);
+        uint32_t next_event = events_wake();
+        if(next_event > vtick && next_event < next) next = next_event;
+        vtick = next;
+    }
+    replaying = false;
+
+    if(ok)
+    {
+        printf("%u inputs in %u.%03u s, %u frames\n", event_cnt, end / 1000, end % 1000, frame_cnt);
+        double median = 0;
+        double p99 = 0;
+        if(frame_cnt > 0)
+        {
+            //Sort a copy, the JSON has the times in the order of the frames
+            double * sorted = malloc(frame_cnt * sizeof(double));
+            if(sorted)
+            {
+                memcpy(sorted, times, frame_cnt * sizeof(double));
+                qsort(sorted, frame_cnt, sizeof(double), time_cmp);
+                median = sorted[frame_cnt / 2];
+                p99 = sorted[(frame_cnt * 99 + 99) / 100 - 1];
+                printf("%10s %10s %10s\n", "median ms", "p99 ms", "max ms");
+                printf("%10.3f %10.3f %10.3f\n", median, p99, sorted[frame_cnt - 1]);
+                free(sorted);
+            }
+        }
+        if(json_path != NULL) ok = json_write(json_path, times, ticks, frame_cnt, median, p99);
+    }
+
+    //The GUI stays on the display, the program exits after it
+    free(times);
+    free(ticks);
+    free(events);
+    events = NULL;
+    return ok;
+}
+
+//`LV_TICK_CUSTOM_SYS_TIME_EXPR`: the virtual tick while replaying, else the real one
+uint32_t inputrec_tick(void)
+{
+    return replaying ? vtick : SDL_GetTicks();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Replace the `read_cb` of the registered input devices (at most `INPUTREC_INDEV_MAX`) and return their count
+static uint32_t indevs_hook(bool (*read_cb)(lv_indev_drv_t *, lv_indev_data_t *))
+{
+    indev_cnt = 0;
+    lv_indev_t * indev = lv_indev_get_next(NULL);
+    while(indev && indev_cnt < INPUTREC_INDEV_MAX)
+    {
+        indevs[indev_cnt] = indev;
+        indev_read_cbs[indev_cnt] = indev->driver.read_cb;
+        indev->driver.read_cb = read_cb;
+        indev_cnt++;
+        indev = lv_indev_get_next(indev);
+    }
+    return indev_cnt;
+}
+
+static int8_t indev_find(lv_indev_drv_t * drv)
+{
+    uint32_t i;
+    for(i = 0; i < indev_cnt; i++)
+    {
+        if(&indevs[i]->driver == drv) return i;
+    }
+    return -1;
+}
+
+//Read the device as before and write a line if the data changed or the encoder turned
+static bool record_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+    int8_t i = indev_find(drv);
+    bool more = indev_read_cbs[i](drv, data);
+    if(rec_fp == NULL) return more;
+
+    lv_indev_data_t * last = &indev_last[i];
+    if(indev_last_valid[i] && data->enc_diff == 0 && data->state == last->state &&
+       data->point.x == last->point.x && data->point.y == last->point.y && data->key == last->key) return more;
+
+    fprintf(rec_fp, "%u %d %d %d %d %u %d\n", lv_tick_elaps(rec_start), i, data->state, data->point.x, data->point.y,
+            data->key, data->enc_diff);
+    *last = *data;
+    indev_last_valid[i] = true;
+    return more;
+}
+
+static void record_close(void)
+{
+    if(rec_fp == NULL) return;
+    bool ok = !ferror(rec_fp);
+    if(fclose(rec_fp) != 0) ok = false;
+    if(!ok) printf("Can't write the input recording\n");
+    rec_fp = NULL;
+}
+
+static bool events_load(const char * path)
+{
+    FILE * fp = fopen(path, "r");
+    if(!fp)
+    {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+
+    char magic[8];
+    int version, hres, vres;
+    if(fscanf(fp, "%7s %d %d %d", magic, &version, &hres, &vres) != 4 || strcmp(magic, INPUTREC_MAGIC) ||
+       version != INPUTREC_VERSION)
+    {
+        printf("%s is not an input recording\n", path);
+        fclose(fp);
+        return false;
+    }
+    if(hres != LV_HOR_RES_MAX || vres != LV_VER_RES_MAX)
+    {
+        printf("%s was recorded on %d x %d, the replay is %d x %d\n", path, hres, vres, LV_HOR_RES_MAX, LV_VER_RES_MAX);
+        fclose(fp);
+        return false;
+    }
+
+    uint32_t event_max = 256;
+    events = malloc(event_max * sizeof(inputrec_event_t));
+    event_cnt = 0;
+    bool ok = events != NULL;
+    unsigned tick, key;
+    int indev, state, x, y, enc_diff;
+    while(ok && fscanf(fp, "%u %d %d %d %d %u %d", &tick, &indev, &state, &x, &y, &key, &enc_diff) == 7)
+    {
+        if(indev < 0 || indev >= INPUTREC_INDEV_MAX || (event_cnt > 0 && tick < events[event_cnt - 1].tick))
+        {
+            printf("%s is invalid at input %u\n", path, event_cnt + 1);
+            ok = false;
+            break;
+        }
+        if(event_cnt == event_max)
+        {
+            event_max *= 2;
+            inputrec_event_t * events_new = realloc(events, event_max * sizeof(inputrec_event_t));
+            if(events_new == NULL)
+            {
+                ok = false;
+                break;
+            }
+            events = events_new;
+        }
+
+        inputrec_event_t * e = &events[event_cnt++];
+        memset(e, 0, sizeof(inputrec_event_t));
+        e->tick = tick;
+        e->indev = indev;
+        e->data.state = state ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        e->data.point.x = x;
+        e->data.point.y = y;
+        e->data.key = key;
+        e->data.enc_diff = enc_diff;
+    }
+    if(ok && !feof(fp))
+    {
+        printf("%s is invalid at input %u\n", path, event_cnt + 1);
+        ok = false;
+    }
+    fclose(fp);
+
+    if(!ok)
+    {
+        free(events);
+        events = NULL;
+    }
+    return ok;
+}
+
+//Give the due events of the device one by one, then repeat the last one without turning the encoder
+static bool replay_read(lv_indev_drv_t * drv, lv_indev_data_t * data)
+{
+    int8_t i = indev_find(drv);
+    uint32_t pos = event_pos[i];
+    if(pos < event_cnt && events[pos].tick <= vtick)
+    {
+        indev_last[i] = events[pos].data;
+        *data = indev_last[i];
+        event_pos[i] = event_next(i, pos + 1);
+        pos = event_pos[i];
+        return pos < event_cnt && events[pos].tick <= vtick;
+    }
+
+    *data = indev_last[i];
+    data->enc_diff = 0;
+    return false;
+}
+
+static void replay_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void)area;
+    (void)color_p;
+    frame_drawn = true;
+    lv_disp_flush_ready(drv);
+}
+
+//The index of the first event of the device from `from`, `event_cnt` if there is none
+static uint32_t event_next(uint8_t indev, uint32_t from)
+{
+    while(from < event_cnt && events[from].indev != indev) from++;
+    return from;
+}
+
+//Make the read task of the devices with due events ready, so they are read in the next `lv_task_handler`
+//at the tick of the event and not at their next period. Return the tick of the earliest not due event.
+static uint32_t events_wake(void)
+{
+    uint32_t next = UINT32_MAX;
+    uint32_t i;
+    for(i = 0; i < indev_cnt; i++)
+    {
+        uint32_t pos = event_pos[i];
+        if(pos >= event_cnt) continue;
+        if(events[pos].tick <= vtick)
+        {
+            lv_task_ready(indevs[i]->driver.read_task);
+        }
+        else if(events[pos].tick < next)
+        {
+            next = events[pos].tick;
+        }
+    }
+    return next;
+}
+
+static int time_cmp(const void * a, const void * b)
+{
+    double ta = *(const double *)a;
+    double tb = *(const double *)b;
+    return (ta > tb) - (ta < tb);
+}
+
+//{"hres": ..., "vres": ..., "inputs": ..., "frames": ..., "median_ms": ..., "p99_ms": ...,
+// "frame_ticks": [...], "frame_ms": [...]}, the tick of every frame from the start of the recording and its time
+static bool json_write(const char * path, const double * times, const uint32_t * ticks, uint32_t cnt, double median,
+                       double p99)
+{
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "{\"hres\": %d, \"vres\": %d, \"inputs\": %u, \"frames\": %u, \"median_ms\": %.4f, \"p99_ms\": %.4f,\n",
+            LV_HOR_RES_MAX, LV_VER_RES_MAX, event_cnt, cnt, median, p99);
+    fprintf(fp, "\"frame_ticks\": [");
+    uint32_t i;
+    for(i = 0; i < cnt; i++) fprintf(fp, "%s%u", i ? ", " : "", ticks[i]);
+    fprintf(fp, "],\n\"frame_ms\": [");
+    for(i = 0; i < cnt; i++) fprintf(fp, "%s%.4f", i ? ", " : "", times[i]);
+    fprintf(fp, "]}\n");
+
+    bool ok = !ferror(fp);
+    if(fclose(fp) != 0) ok = false;
+    if(!ok) printf("Can't write %s\n", path);
+    return ok;
+}
@@ -0,0 +1,54 @@
+/**
+ * @file inputrec.h
+ *
+ */
+
+#ifndef _INPUTREC_H_
+#define _INPUTREC_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define INPUTREC_INDEV_MAX      8       //Recorded input devices
+#define INPUTREC_TAIL_MS        1000    //The replay runs this long after the last input to let the animations end
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool inputrec_record_start(const char * path);
+bool inputrec_replay(const char * path, const char * json_path);
+uint32_t inputrec_tick(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -5,13 +5,26 @@
 #include "toolbox.h"
 #include "custom_widget.h"
 #include "dataset.h"
+#include "autosave.h"
+#include "screens.h"
+#include "profiler.h"
+#include "footprint.h"
+#include "thumbs.h"
 
 lv_obj_t * screen;
 lv_obj_t * tft_win;
 lv_obj_t * toolbox_win;
 lv_obj_t * setting_win;
 
-void tft_win_init(lv_obj_t * parent);
+static void screen_prev_cb(lv_obj_t * btn, lv_event_t ev);
+static void screen_next_cb(lv_obj_t * btn, lv_event_t ev);
+static void screen_add_cb(lv_obj_t * btn, lv_event_t ev);
+static void tft_band_cb(lv_obj_t * page, lv_event_t ev);
+static void band_area_get(const lv_point_t * p, lv_area_t * area);
+
+static lv_style_t band_style;
+static lv_obj_t * band = NULL;      //The rubber band while it's drawn
+static lv_point_t band_start;
 
 
 
@@ -26,30 +39,127 @@ void lv_gui_designer()
     // lv_theme_set_current(th);
 
     toolbox_win_init(screen); 
+    profiler_startup_mark("toolbox");
     setting_win_init(screen);
-    tft_win_init(screen);
+    profiler_startup_mark("setting");
+    lv_style_copy(&band_style, &lv_style_plain_color);
+    band_style.body.opa = LV_OPA_30;
+    band_style.body.border.width = 1;
+    band_style.body.border.color = band_style.body.main_color;
+    band_style.body.border.opa = LV_OPA_COVER;
+    screens_init(tft_win_create());
+    profiler_startup_mark("screens");
+    autosave_init();
+    profiler_startup_mark("autosave");
+    thumbs_init();
+    footprint_status_create(screen);
 }
 
-void tft_win_init(lv_obj_t * parent)
+//A TFT Simulator window for a screen, added to the document. NULL if out of memory.
+lv_obj_t * tft_win_create(void)
 {
-    tft_win = lv_win_create(parent, NULL);
+    lv_obj_t * win = lv_win_create(screen, NULL);
+    if(win == NULL) return NULL;
     lv_coord_t win_width, win_height;
     win_width = 480;
     win_height = 320;
 
     char title[40];
     snprintf(title, 40, "TFT Simulator  [Size:%dx%d]", win_width, win_height);
-    lv_win_set_drag(tft_win, true);
-    lv_obj_set_size(tft_win, win_width, win_height);
-    lv_win_set_title(tft_win, title);
-    lv_obj_align(tft_win, NULL, LV_ALIGN_CENTER, 0, 0);
-
-    widget_set_info(tft_win, WIDGET_TYPE_OBJ);      //obj
-
-    layerview_add(layerview_get_base(), tft_win);
+    lv_win_set_drag(win, true);
+    lv_obj_set_size(win, win_width, win_height);
+    lv_win_set_title(win, title);
+    lv_obj_align(win, NULL, LV_ALIGN_CENTER, 0, 0);
+
+    lv_obj_t * win_btn = lv_win_add_btn(win, LV_SYMBOL_PLUS);
+    lv_obj_set_event_cb(win_btn, screen_add_cb);
+
+    win_btn = lv_win_add_btn(win, LV_SYMBOL_NEXT);
+    lv_obj_set_event_cb(win_btn, screen_next_cb);
+
+    win_btn = lv_win_add_btn(win, LV_SYMBOL_PREV);
+    lv_obj_set_event_cb(win_btn, screen_prev_cb);
+
+    widget_set_info(win, WIDGET_TYPE_OBJ);      //obj
+
+    //Dragging the background draws a rubber band instead of scrolling
+    lv_obj_t * scrl = lv_page_get_scrl(lv_win_get_content(win));
+    lv_obj_set_drag(scrl, false);
+    lv_obj_set_protect(scrl, LV_PROTECT_PRESS_LOST);
+    lv_obj_set_event_cb(lv_win_get_content(win), tft_band_cb);     //The scrollable passes its events to it
+
+    if(layerview_add(DOC_ROOT, win) == DOC_NONE)
+    {
+        lv_obj_del(win);
+        return NULL;
+    }
+    return win;
 }
 
+static void screen_prev_cb(lv_obj_t * btn, lv_event_t ev)
+{
+    (void)btn;
+    if(ev == LV_EVENT_CLICKED && screens_get_act() > 0) screens_open(screens_get_act() - 1);
+}
 
+static void screen_next_cb(lv_obj_t * btn, lv_event_t ev)
+{
+    (void)btn;
+    if(ev == LV_EVENT_CLICKED) screens_open(screens_get_act() + 1);
+}
 
+static void screen_add_cb(lv_obj_t * btn, lv_event_t ev)
+{
+    (void)btn;
+    if(ev == LV_EVENT_CLICKED) screens_add();
+}
 
+//Pressing and dragging on the background selects the widgets in the rubber band, a click selects the screen.
+//With Shift they are added to the selection.
+static void tft_band_cb(lv_obj_t * page, lv_event_t ev)
+{
+    lv_indev_t * indev = lv_indev_get_act();
+    if(indev == NULL) return;
+    lv_point_t p;
+    lv_indev_get_point(indev, &p);
+    lv_area_t a;
+
+    if(ev == LV_EVENT_PRESSED)
+    {
+        band_start = p;
+    }else if(ev == LV_EVENT_PRESSING)
+    {
+        if(band == NULL)
+        {
+            if(LV_MATH_ABS(p.x - band_start.x) < LV_INDEV_DEF_DRAG_LIMIT &&
+               LV_MATH_ABS(p.y - band_start.y) < LV_INDEV_DEF_DRAG_LIMIT) return;
+            band = lv_obj_create(lv_layer_top(), NULL);
+            if(band == NULL) return;
+            lv_obj_set_style(band, &band_style);
+            lv_obj_set_click(band, false);
+        }
+        band_area_get(&p, &a);
+        lv_obj_set_pos(band, a.x1, a.y1);
+        lv_obj_set_size(band, lv_area_get_width(&a), lv_area_get_height(&a));
+    }else if(ev == LV_EVENT_RELEASED || ev == LV_EVENT_PRESS_LOST)
+    {
+        if(band != NULL)
+        {
+            lv_obj_del(band);
+            band = NULL;
+            band_area_get(&p, &a);
+            layerview_area_sel(&a);
+        }else if(ev == LV_EVENT_RELEASED)
+        {
+            layerview_click_sel(widget_get_info(lv_obj_get_parent(page))->node);
+        }
+    }
+}
 
+static void band_area_get(const lv_point_t * p, lv_area_t * area)
+{
+    area->x1 = LV_MATH_MIN(p->x, band_start.x);
+    area->y1 = LV_MATH_MIN(p->y, band_start.y);
+    area->x2 = LV_MATH_MAX(p->x, band_start.x);
+    area->y2 = LV_MATH_MAX(p->y, band_start.y);
+}
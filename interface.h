@@ -39,6 +39,7 @@ extern "C" {
  **********************/
 
 void lv_gui_designer(void);
+lv_obj_t * tft_win_create(void);
 
 /**********************
  *      MACROS
@@ -1,140 +1,649 @@
 #include <mxml.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
 #include "loadproj.h"
 #include "dataset.h"
+#include "widgetreg.h"
+#include "binproj.h"
+#include "undo.h"
+#include "screens.h"
+#include "toolbox.h"
+#include "widgetid.h"
+#include "hotreload.h"
+#include <sys/stat.h>
 
-typedef struct _widget_stack_t_{
-    lv_obj_t * widget;
-    struct _widget_stack_t_ * next;
+#define WSTACK_INIT_CAPACITY    32
+#define LOADPROJ_STEP_CHECK     16      //Elements created between two looks at the clock
+
+typedef struct
+{
+    lv_obj_t ** widget;     //widget[0] is the bottom, grows by doubling
+    uint32_t depth;
+    uint32_t capacity;
 }widget_stack_t;
 
-static widget_stack_t * wstack = NULL;
+typedef struct
+{
+    const char * path;
+    mxml_node_t * par;      //The file's top level nodes are added to it
+    bool ok;
+}parse_file_t;
 
-static mxml_sax_cb_t sax_cb(mxml_node_t *node, mxml_sax_event_t event, void *data);
-static void wstack_push(lv_obj_t * new);
-static void wstack_pop(void);
-static lv_obj_t * wstack_top(void);
+//The files of a manifest, the parsers take the next one until all are taken
+typedef struct
+{
+    parse_file_t * files;
+    uint32_t cnt;
+    uint32_t next;          //Atomic
+}parse_pool_t;
 
+static loadproj_stats_t last_stats;
+static loadproj_report_cb_t report_cb = NULL;
 
+static void sax_cb(mxml_node_t *node, mxml_sax_event_t event, void *data);
+static lv_obj_t * element_create(lv_obj_t * par, mxml_node_t * node, lv_obj_t * root);
+static bool wstack_push(widget_stack_t * stack, lv_obj_t * new);
+static void wstack_pop(widget_stack_t * stack);
+static lv_obj_t * wstack_top(widget_stack_t * stack);
+static void wstack_reset(widget_stack_t * stack);
+static void load_project_run(lv_obj_t * tft_win);
+static bool bin_load(lv_obj_t * tft_win, const char * path);
+static bool file_parse(mxml_node_t * par, const char * path);
+static bool manifest_parse(mxml_node_t * top, loadproj_job_t * job);
+static void * parse_worker(void * param);
+static void first_screen_order(loadproj_job_t * job);
+static uint32_t snap_node_add(projsnap_t * snap, const widget_desc_t * desc, uint32_t par, mxml_node_t * xml,
+                              uint32_t * auto_cnt);
+
+
+//The widgets are created in a batch: the containers are laid out and the screen is invalidated once at the end.
+//Loading isn't an undo step, the journal starts over. The screens of the file (SCREENS_TAG elements) are added
+//as new screens, and the ones far from the open screen are stored as soon as they are complete.
 void load_project(lv_obj_t * tft_win)
 {
-    FILE * fp = fopen("lgd.xml", "r");
+    undo_clear();
+    screens_load_begin();
+    lv_obj_batch_begin();
+    load_project_run(tft_win);
+    lv_obj_batch_commit();
+    screens_load_end();
+    hotreload_rebase();
+}
+
+static void load_project_run(lv_obj_t * tft_win)
+{
+    memset(&last_stats, 0, sizeof(last_stats));
+
+    //A project split into files is parsed in parallel, then its widgets are created here at once
+    if(load_project_has_manifest())
+    {
+        loadproj_job_t job;
+        if(load_project_parse(&job, tft_win)) load_project_step(&job, UINT32_MAX);
+        load_project_job_free(&job);
+        return;
+    }
+
+    //The binary project is a compiled lgd.xml, use it while it's up to date
+    if(load_project_bin_is_newer() && bin_load(tft_win, BINPROJ_FILE)) return;
+    //The warm-start cache is the same from an earlier load of this lgd.xml
+    if(load_project_cache_is_valid() && bin_load(tft_win, LOADPROJ_CACHE_FILE)) return;
+
+    FILE * fp = fopen(LOADPROJ_XML_FILE, "r");
     if(!fp)
     {
         printf("Project file not found!");
         return;
     }
 
-    wstack_push(tft_win);
-    mxml_node_t * sax_node = mxmlSAXLoadFile(NULL, fp, MXML_OPAQUE_CALLBACK, sax_cb, NULL);
+    widget_stack_t stack = {NULL, 0, 0};    //Lives only for this load
+
+    if(wstack_push(&stack, tft_win))
+    {
+        mxmlSAXLoadFile(NULL, fp, MXML_OPAQUE_CALLBACK, sax_cb, &stack);
+    }
     fclose(fp);
+    wstack_reset(&stack);
+
+    if(report_cb != NULL) report_cb(&last_stats);
 }
 
-static mxml_sax_cb_t sax_cb(mxml_node_t *node, mxml_sax_event_t event, void *data)
+const loadproj_stats_t * load_project_get_stats(void)
 {
-    if(event == MXML_SAX_ELEMENT_OPEN)
+    return &last_stats;
+}
+
+void load_project_set_report_cb(loadproj_report_cb_t cb)
+{
+    report_cb = cb;
+}
+
+//Read the XML project (lgd.xml or the files of the manifest) into memory.
+//It doesn't touch the widgets, so it can run on any thread.
+bool load_project_parse(loadproj_job_t * job, lv_obj_t * tft_win)
+{
+    memset(job, 0, sizeof(loadproj_job_t));
+
+    mxml_node_t * top = mxmlNewElement(MXML_NO_PARENT, "project");     //Holds the file's top level nodes
+    if(top == NULL) return false;
+    mxmlSetUserData(top, tft_win);
+    bool res;
+    if(load_project_has_manifest())
     {
-        //create a new widget and PUSH to stack
-        const char * element = mxmlGetElement(node);
-        if(!strcmp(element, "BTN"))
-        {
-            lv_obj_t * obj = lv_btn_create(wstack_top(), NULL);
-            wstack_push(obj);
-            
-        }
-        if(!strcmp(element, "LABEL"))
-        {
-            lv_obj_t * obj = lv_label_create(wstack_top(), NULL);
-            wstack_push(obj);
-        }
-        if(!strcmp(element, "LED"))
-        {
-            lv_obj_t * obj = lv_led_create(wstack_top(), NULL);
-            wstack_push(obj);
-        }
-        if(!strcmp(element, "CHECKBOX"))
+        res = manifest_parse(top, job);
+    }else
+    {
+        res = file_parse(top, LOADPROJ_XML_FILE);
+        job->file_cnt = res ? 1 : 0;
+    }
+    if(!res)
+    {
+        mxmlDelete(top);
+        return false;
+    }
+
+    mxml_node_t * node;
+    for(node = mxmlWalkNext(top, top, MXML_DESCEND); node != NULL; node = mxmlWalkNext(node, top, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) == MXML_ELEMENT) job->total++;
+    }
+
+    job->tree = top;
+    job->next = mxmlWalkNext(top, top, MXML_DESCEND);
+    first_screen_order(job);
+    return true;
+}
+
+//Create the widgets of the next elements on the UI thread for about `max_ms` (UINT32_MAX: all of them).
+//The first step creates only the first level of the open screen, so its containers are drawn before the rest.
+//Returns true when all are created.
+bool load_project_step(loadproj_job_t * job, uint32_t max_ms)
+{
+    mxml_node_t * top = job->tree;
+    if(top == NULL) return true;
+
+    if(job->done == 0)
+    {
+        memset(&last_stats, 0, sizeof(last_stats));
+        screens_load_begin();
+    }
+
+    uint32_t t_start = lv_tick_get();
+    uint32_t cnt = 0;
+    lv_obj_batch_begin();
+    while(1)
+    {
+        mxml_node_t * node;
+        if(job->order_next < job->order_cnt)
         {
-            lv_obj_t * obj = lv_cb_create(wstack_top(), NULL);
-            wstack_push(obj);
-        }
-        if(!strcmp(element, "BAR"))
+            if(job->done == 0 && job->order_next == job->order_level1 && max_ms != UINT32_MAX) break;
+            node = job->order[job->order_next++];
+        }else
         {
-            lv_obj_t * obj = lv_bar_create(wstack_top(), NULL);
-            wstack_push(obj);
+            node = job->next;
+            if(node == NULL) break;
+            job->next = mxmlWalkNext(node, top, MXML_DESCEND);
+            if(mxmlGetType(node) != MXML_ELEMENT) continue;
         }
-        if(!strcmp(element, "ROLLER"))
+
+        //The parents are created first, their user data is their widget (or the parent's for unknown tags)
+        lv_obj_t * par = mxmlGetUserData(mxmlGetParent(node));
+        lv_obj_t * obj = element_create(par, node, mxmlGetUserData(top));
+        mxmlSetUserData(node, obj != NULL ? obj : par);
+        cnt++;
+        if(cnt % LOADPROJ_STEP_CHECK == 0 && lv_tick_elaps(t_start) >= max_ms) break;
+    }
+    lv_obj_batch_commit();
+    job->done += cnt;
+
+    if(job->order_next < job->order_cnt || job->next != NULL) return false;
+
+    screens_load_end();
+    hotreload_rebase();
+    if(report_cb != NULL) report_cb(&last_stats);
+    return true;
+}
+
+void load_project_job_free(loadproj_job_t * job)
+{
+    if(job->tree != NULL) mxmlDelete(job->tree);
+    job->tree = NULL;
+    job->next = NULL;
+    free(job->order);
+    job->order = NULL;
+    job->order_cnt = 0;
+    job->order_next = 0;
+}
+
+//Create the widgets of an element (mxml_node_t *) and its descendants on `par`, e.g. of one added to the file
+//of the open project. Returns the widget of the element, NULL if its tag is unknown.
+lv_obj_t * load_project_subtree(lv_obj_t * par, void * xml)
+{
+    mxml_node_t * root = xml;
+    lv_obj_t * obj = element_create(par, root, NULL);
+    if(obj == NULL) return NULL;
+    mxmlSetUserData(root, obj);
+
+    mxml_node_t * node;
+    for(node = mxmlWalkNext(root, root, MXML_DESCEND); node != NULL; node = mxmlWalkNext(node, root, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) != MXML_ELEMENT) continue;
+        lv_obj_t * node_par = mxmlGetUserData(mxmlGetParent(node));
+        lv_obj_t * node_obj = element_create(node_par, node, NULL);
+        mxmlSetUserData(node, node_obj != NULL ? node_obj : node_par);
+    }
+    return obj;
+}
+
+bool load_project_bin_is_newer(void)
+{
+    struct stat bin_st, xml_st;
+    if(stat(BINPROJ_FILE, &bin_st) != 0) return false;
+    if(stat(LOADPROJ_XML_FILE, &xml_st) != 0) return true;
+    return bin_st.st_mtime >= xml_st.st_mtime;
+}
+
+//The project is split into files, the manifest is used instead of lgd.xml and the binary files
+bool load_project_has_manifest(void)
+{
+    struct stat st;
+    return stat(LOADPROJ_MANIFEST_FILE, &st) == 0;
+}
+
+//The warm-start cache was compiled from the current lgd.xml by this designer. Hashes the XML, no parsing.
+bool load_project_cache_is_valid(void)
+{
+    uint64_t key = binproj_source_key(LOADPROJ_XML_FILE);
+    return key != 0 && binproj_get_source_key(LOADPROJ_CACHE_FILE) == key;
+}
+
+//Compile lgd.xml into the warm-start cache. It doesn't touch the widgets, so it can run on any thread.
+bool load_project_cache_write(void)
+{
+    char tmp_path[sizeof(LOADPROJ_CACHE_FILE) + 4];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", LOADPROJ_CACHE_FILE);
+    if(!binproj_from_xml(LOADPROJ_XML_FILE, tmp_path) || rename(tmp_path, LOADPROJ_CACHE_FILE) != 0)
+    {
+        remove(tmp_path);
+        return false;
+    }
+    return true;
+}
+
+//Read an XML project file straight into a snapshot for the writers, e.g. to generate code in a batch.
+//No widget is created, so it runs without lv_init() and a display. The widgets outside the screen elements
+//go to the first screen like in the designer.
+bool load_project_snap(projsnap_t * snap, const char * path)
+{
+    memset(snap, 0, sizeof(projsnap_t));
+
+    mxml_node_t * top = mxmlNewElement(MXML_NO_PARENT, "project");
+    if(top == NULL) return false;
+    if(!file_parse(top, path))
+    {
+        mxmlDelete(top);
+        return false;
+    }
+
+    uint32_t total = 1;     //The screen of the widgets outside the screen elements
+    mxml_node_t * node;
+    for(node = mxmlWalkNext(top, top, MXML_DESCEND); node != NULL; node = mxmlWalkNext(node, top, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) == MXML_ELEMENT) total++;
+    }
+    snap->nodes = malloc(total * sizeof(projsnap_node_t));
+    if(snap->nodes == NULL)
+    {
+        mxmlDelete(top);
+        return false;
+    }
+
+    uint32_t auto_cnt[WIDGET_TYPE_NUM];
+    memset(auto_cnt, 0, sizeof(auto_cnt));
+    uint32_t scr = PROJSNAP_NO_PARENT;      //The last screen, the top level widgets go to it
+    bool res = true;
+    for(node = mxmlWalkNext(top, top, MXML_DESCEND); node != NULL && res; node = mxmlWalkNext(node, top, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) != MXML_ELEMENT) continue;
+
+        //The parents are visited first, their user data is their index + 1 (or the parent's for unknown tags),
+        //0 on the top level
+        mxml_node_t * par_xml = mxmlGetParent(node);
+        uintptr_t par_data = par_xml == top ? 0 : (uintptr_t)mxmlGetUserData(par_xml);
+        uint32_t idx;
+        if(par_data == 0 && !strcasecmp(mxmlGetElement(node), SCREENS_TAG))
         {
-            lv_obj_t * obj = lv_roller_create(wstack_top(), NULL);
-            wstack_push(obj);
-        }
-        if(!strcmp(element, "DDLIST"))
+            idx = snap_node_add(snap, NULL, PROJSNAP_NO_PARENT, node, auto_cnt);
+            scr = idx;
+        }else
         {
-            lv_obj_t * obj = lv_ddlist_create(wstack_top(), NULL);
-            wstack_push(obj);
+            const widget_desc_t * desc = widgetreg_find_tag(mxmlGetElement(node));
+            if(desc == NULL)
+            {
+                mxmlSetUserData(node, (void *)par_data);
+                continue;
+            }
+            if(par_data == 0 && scr == PROJSNAP_NO_PARENT)
+            {
+                scr = snap_node_add(snap, NULL, PROJSNAP_NO_PARENT, NULL, auto_cnt);
+            }
+            idx = snap_node_add(snap, desc, par_data == 0 ? scr : par_data - 1, node, auto_cnt);
         }
-        if(!strcmp(element, "ARC"))
+        res = idx != PROJSNAP_NO_PARENT;
+        mxmlSetUserData(node, (void *)(uintptr_t)(idx + 1));
+    }
+    mxmlDelete(top);
+
+    //An empty project still has its screen
+    if(res && snap->cnt == 0) res = snap_node_add(snap, NULL, PROJSNAP_NO_PARENT, NULL, auto_cnt) != PROJSNAP_NO_PARENT;
+    if(!res)
+    {
+        projsnap_free(snap);
+        return false;
+    }
+
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        if(snap->nodes[i].depth == 0) snap->screen_cnt++;
+    }
+    return true;
+}
+
+//Create the widgets of a binary project. false: it's invalid, load the XML.
+static bool bin_load(lv_obj_t * tft_win, const char * path)
+{
+    int32_t created = binproj_load(tft_win, path);
+    if(created < 0) return false;
+
+    last_stats.elements = created;
+    last_stats.widgets = created;
+    if(report_cb != NULL) report_cb(&last_stats);
+    return true;
+}
+
+//Add the top level nodes of a file to `par`
+static bool file_parse(mxml_node_t * par, const char * path)
+{
+    FILE * fp = fopen(path, "r");
+    if(!fp)
+    {
+        printf("Project file %s not found!\n", path);
+        return false;
+    }
+    bool res = mxmlLoadFile(par, fp, MXML_OPAQUE_CALLBACK) != NULL;
+    fclose(fp);
+    return res;
+}
+
+//Parse the screen files of the manifest in parallel, each into its own SCREENS_TAG element of `top`.
+//A file which can't be parsed leaves its screen empty, only a manifest without any parsed file is a failure.
+static bool manifest_parse(mxml_node_t * top, loadproj_job_t * job)
+{
+    mxml_node_t * manifest = mxmlNewElement(MXML_NO_PARENT, "manifest");
+    if(manifest == NULL) return false;
+    if(!file_parse(manifest, LOADPROJ_MANIFEST_FILE))
+    {
+        mxmlDelete(manifest);
+        return false;
+    }
+
+    //<screen file="main.xml" id="main"/>, the other elements are skipped
+    parse_pool_t pool = {NULL, 0, 0};
+    mxml_node_t * node;
+    for(node = mxmlWalkNext(manifest, manifest, MXML_DESCEND); node != NULL;
+        node = mxmlWalkNext(node, manifest, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) != MXML_ELEMENT || strcasecmp(mxmlGetElement(node), SCREENS_TAG)) continue;
+        if(mxmlElementGetAttr(node, "file") != NULL) pool.cnt++;
+    }
+    pool.files = pool.cnt > 0 ? malloc(pool.cnt * sizeof(parse_file_t)) : NULL;
+    if(pool.files == NULL)
+    {
+        if(pool.cnt == 0) printf("%s lists no screen files\n", LOADPROJ_MANIFEST_FILE);
+        mxmlDelete(manifest);
+        return false;
+    }
+
+    //The screen elements are added in the manifest's order here, the parsers add only to their own one
+    uint32_t i = 0;
+    for(node = mxmlWalkNext(manifest, manifest, MXML_DESCEND); node != NULL;
+        node = mxmlWalkNext(node, manifest, MXML_DESCEND))
+    {
+        if(mxmlGetType(node) != MXML_ELEMENT || strcasecmp(mxmlGetElement(node), SCREENS_TAG)) continue;
+        const char * path = mxmlElementGetAttr(node, "file");
+        if(path == NULL) continue;
+        parse_file_t * f = &pool.files[i++];
+        f->path = path;
+        f->par = mxmlNewElement(top, SCREENS_TAG);
+        f->ok = false;
+        const char * id = mxmlElementGetAttr(node, "id");
+        if(id != NULL) mxmlElementSetAttr(f->par, "id", id);
+    }
+
+    //This thread is one of the parsers, without more threads it parses all the files
+    pthread_t threads[LOADPROJ_PARSE_THREADS - 1];
+    uint32_t thread_cnt = 0;
+    while(thread_cnt < LOADPROJ_PARSE_THREADS - 1 && thread_cnt + 1 < pool.cnt)
+    {
+        if(pthread_create(&threads[thread_cnt], NULL, parse_worker, &pool) != 0) break;
+        thread_cnt++;
+    }
+    parse_worker(&pool);
+    for(i = 0; i < thread_cnt; i++) pthread_join(threads[i], NULL);
+
+    for(i = 0; i < pool.cnt; i++)
+    {
+        if(pool.files[i].ok) job->file_cnt++;
+        else printf("Can't load the screen file %s\n", pool.files[i].path);
+    }
+    free(pool.files);
+    mxmlDelete(manifest);
+    return job->file_cnt > 0;
+}
+
+static void * parse_worker(void * param)
+{
+    parse_pool_t * pool = param;
+    while(1)
+    {
+        uint32_t i = __atomic_fetch_add(&pool->next, 1, __ATOMIC_RELAXED);
+        if(i >= pool->cnt) break;
+        pool->files[i].ok = file_parse(pool->files[i].par, pool->files[i].path);
+    }
+    return NULL;
+}
+
+//The open screen (the first of the file) is created breadth first: its containers appear at once and the deeper
+//widgets fill in. The other screens follow in preorder, so each is complete before the next one begins.
+//Without memory for the order everything is created in preorder.
+static void first_screen_order(loadproj_job_t * job)
+{
+    mxml_node_t * top = job->tree;
+    mxml_node_t * first = NULL;
+    bool screens = false;
+    mxml_node_t * c;
+    for(c = mxmlGetFirstChild(top); c != NULL; c = mxmlGetNextSibling(c))
+    {
+        if(mxmlGetType(c) != MXML_ELEMENT) continue;
+        bool screen = !strcasecmp(mxmlGetElement(c), SCREENS_TAG);
+        if(first == NULL)
         {
-            lv_obj_t * obj = lv_arc_create(wstack_top(), NULL);
-            wstack_push(obj);
-        }
-        if(!strcmp(element, "CONTAINER"))
+            first = c;
+            screens = screen;
+        }else if(screen && !screens)
         {
-            lv_obj_t * obj = lv_cont_create(wstack_top(), NULL);
-            lv_cont_set_fit(obj, LV_FIT_FLOOD);
-            lv_cont_set_layout(obj, LV_LAYOUT_PRETTY);  //TEST Attribute
-            wstack_push(obj);
+            return;     //Widgets out of the screens are on the first one, in preorder then
         }
-        //Set Attribute
-        int i, count;
-        for (i = 0, count = mxmlElementGetAttrCount(node); i < count; i++)
+    }
+    if(first == NULL) return;
+
+    mxml_node_t ** order = malloc(job->total * sizeof(mxml_node_t *));
+    if(order == NULL) return;
+    uint32_t cnt = 0;
+    mxml_node_t * level0 = top;     //A file without screens is all the open screen
+    if(screens)
+    {
+        order[cnt++] = first;
+        level0 = first;
+    }
+    for(c = mxmlGetFirstChild(level0); c != NULL; c = mxmlGetNextSibling(c))
+    {
+        if(mxmlGetType(c) == MXML_ELEMENT) order[cnt++] = c;
+    }
+    job->order_level1 = cnt;
+    job->next = screens ? mxmlGetNextSibling(first) : NULL;
+
+    uint32_t head;
+    for(head = screens ? 1 : 0; head < cnt; head++)
+    {
+        for(c = mxmlGetFirstChild(order[head]); c != NULL; c = mxmlGetNextSibling(c))
         {
-            const char * name, * value;
-            value = mxmlElementGetAttrByIndex(node, i, &name);
-            if(!strcmp(name, "x"))
-            {
-                lv_coord_t x = atoi(value);
-                lv_obj_set_x(wstack_top(), x);
-            }
-            if(!strcmp(name, "y"))
-            {
-                lv_coord_t y = atoi(value);
-                lv_obj_set_y(wstack_top(), y);
-            }
-            // if(!strcmp(name, "fit"))
-            // {
-            //     atoi(value);
-            //     lv_obj_set_y(wstack_top(), y);
-            // }       
+            if(mxmlGetType(c) == MXML_ELEMENT) order[cnt++] = c;
         }
-        
+    }
+    job->order = (void **)order;
+    job->order_cnt = cnt;
+}
+
+static void sax_cb(mxml_node_t *node, mxml_sax_event_t event, void *data)
+{
+    widget_stack_t * stack = data;
+    if(event == MXML_SAX_ELEMENT_OPEN)
+    {
+        //create a new widget and PUSH to stack
+        //Unknown tag: keep the nesting, its children go to the parent
+        lv_obj_t * obj = element_create(wstack_top(stack), node, stack->widget[0]);
+        wstack_push(stack, obj != NULL ? obj : wstack_top(stack));
     }else if(event == MXML_SAX_ELEMENT_CLOSE)
     {
         //POP
-        wstack_pop();
+        wstack_pop(stack);
     }
 }
 
-static void wstack_push(lv_obj_t * new)
+//Returns the new widget (or screen) or NULL for an unknown tag. `root` is where the project is loaded.
+static lv_obj_t * element_create(lv_obj_t * par, mxml_node_t * node, lv_obj_t * root)
 {
-    widget_stack_t * new_top = (widget_stack_t *)malloc(sizeof(widget_stack_t));
-    new_top->next = wstack;
-    new_top->widget = new;
-    wstack = new_top;
+    last_stats.elements++;
+    if(par == root && !strcasecmp(mxmlGetElement(node), SCREENS_TAG))
+    {
+        return screens_load_screen(mxmlElementGetAttr(node, "id"));
+    }
+    const widget_desc_t * desc = widgetreg_find_tag(mxmlGetElement(node));
+    if(desc == NULL || par == NULL) return NULL;
+
+    lv_obj_t * obj = desc->create_cb(par, NULL);
+    widget_set_info(obj, desc->type);
+    widget_info_t * par_info = widget_get_info(par);
+    toolbox_adopt(obj, par_info != NULL ? par_info->node : DOC_NONE);
+    last_stats.widgets++;
+
+    //Set Attribute
+    int i, count;
+    for (i = 0, count = mxmlElementGetAttrCount(node); i < count; i++)
+    {
+        const char * name, * value;
+        value = mxmlElementGetAttrByIndex(node, i, &name);
+        widgetreg_attr_apply(widgetreg_find_attr(desc, name), obj, value);
+    }
+    return obj;
 }
 
-static void wstack_pop(void)
+static bool wstack_push(widget_stack_t * stack, lv_obj_t * new)
 {
-    if(wstack != NULL)
+    if(stack->depth == stack->capacity)
     {
-        widget_stack_t * tmp = wstack;
-        wstack = wstack->next;
-        // lv_obj_t * last = tmp->widget;
-        free(tmp);
+        uint32_t new_cap = stack->capacity ? stack->capacity * 2 : WSTACK_INIT_CAPACITY;
+        lv_obj_t ** new_buf = realloc(stack->widget, new_cap * sizeof(lv_obj_t *));
+        if(new_buf == NULL) return false;
+        stack->widget = new_buf;
+        stack->capacity = new_cap;
+        last_stats.stack_allocs++;
     }
+    stack->widget[stack->depth++] = new;
+    if(stack->depth > last_stats.peak_depth) last_stats.peak_depth = stack->depth;
+    return true;
+}
+
+static void wstack_pop(widget_stack_t * stack)
+{
+    if(stack->depth > 1) stack->depth--;    //Never pop the root (the screen) on an unbalanced file
 }
 
-static lv_obj_t * wstack_top(void)
+static lv_obj_t * wstack_top(widget_stack_t * stack)
 {
-    if(wstack != NULL) return wstack->widget;
+    if(stack->depth != 0) return stack->widget[stack->depth - 1];
     return NULL;
-}
\ No newline at end of file
+}
+
+static void wstack_reset(widget_stack_t * stack)
+{
+    free(stack->widget);
+    stack->widget = NULL;
+    stack->depth = 0;
+    stack->capacity = 0;
+}
+
+//Add a node of `xml` after the last one. A screen (`desc` NULL) has only an ID and `xml` can be NULL for it.
+//The missing attributes get the values of a loaded widget. Returns its index, PROJSNAP_NO_PARENT if out of memory.
+static uint32_t snap_node_add(projsnap_t * snap, const widget_desc_t * desc, uint32_t par, mxml_node_t * xml,
+                              uint32_t * auto_cnt)
+{
+    projsnap_node_t * n = &snap->nodes[snap->cnt];
+    memset(n, 0, sizeof(projsnap_node_t));
+    n->type = desc != NULL ? desc->type : WIDGET_TYPE_OBJ;
+    n->parent = par;
+    n->depth = par == PROJSNAP_NO_PARENT ? 0 : snap->nodes[par].depth + 1;
+    n->style = PROJSNAP_NO_STYLE;       //The XML has no styles, the loaded widgets have the built-in ones too
+    n->font = LV_FONT_DEFAULT;
+
+    const char * id = xml != NULL ? mxmlElementGetAttr(xml, "id") : NULL;
+    if(widgetid_is_valid(id)) strncpy(n->id, id, PROJSNAP_ID_MAX - 1);
+    else snprintf(n->id, PROJSNAP_ID_MAX, "%s_%u", widget_get_type_name(n->type), (unsigned)++auto_cnt[n->type]);
+
+    if(desc == NULL)
+    {
+        n->w = LOADPROJ_SCR_W;
+        n->h = LOADPROJ_SCR_H;
+        desc = widgetreg_get(WIDGET_TYPE_OBJ);
+        xml = NULL;
+    }else
+    {
+        //The designer writes all four
+        int32_t v;
+        const char * value;
+        if((value = mxmlElementGetAttr(xml, "x")) != NULL && widgetreg_parse_int(value, &v)) n->x = v;
+        if((value = mxmlElementGetAttr(xml, "y")) != NULL && widgetreg_parse_int(value, &v)) n->y = v;
+        if((value = mxmlElementGetAttr(xml, "w")) != NULL && widgetreg_parse_int(value, &v)) n->w = v;
+        if((value = mxmlElementGetAttr(xml, "h")) != NULL && widgetreg_parse_int(value, &v)) n->h = v;
+    }
+
+    //The numeric attributes with a getter in the order of `widgetreg_vals_get`
+    const widget_attr_desc_t * attr;
+    uint8_t i;
+    for(i = 0; n->val_cnt < WIDGETREG_VAL_MAX && (attr = widgetreg_attr_at(desc, i)) != NULL; i++)
+    {
+        if(attr->get_int_cb == NULL) continue;
+        widgetreg_val_t * val = &n->vals[n->val_cnt++];
+        val->attr = i;
+        val->value = attr->def;
+        const char * value = xml != NULL ? mxmlElementGetAttr(xml, attr->name) : NULL;
+        if(value != NULL) widgetreg_parse_int(value, &val->value);
+    }
+
+    attr = xml != NULL ? widgetreg_text_attr(n->type) : NULL;
+    if(attr != NULL)
+    {
+        const char * text = mxmlElementGetAttr(xml, attr->name);
+        if(text == NULL) text = attr->def_text;
+        if(text != NULL && text[0] != '\0')
+        {
+            n->text = strdup(text);
+            if(n->text == NULL) return PROJSNAP_NO_PARENT;
+        }
+    }
+    return snap->cnt++;
+}
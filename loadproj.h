@@ -22,20 +22,62 @@ extern "C" {
 #include "./lv_ex_conf.h"
 #endif
 
+#include "projjob.h"
+
 
 
 /*********************
  *      DEFINES
  *********************/
+#define LOADPROJ_XML_FILE   "lgd.xml"
+#define LOADPROJ_CACHE_FILE "lgd.lgc"       //lgd.xml compiled to the binary format, reused while the XML is the same
+#define LOADPROJ_MANIFEST_FILE  "lgd.lgm"   //Lists the files of a project split into one file per screen
+#define LOADPROJ_PARSE_THREADS  4           //Files of a manifest parsed at the same time, the calling thread included
+#define LOADPROJ_SCR_W          480         //Size of a screen read without the widgets, the TFT Simulator window's
+#define LOADPROJ_SCR_H          320
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    uint32_t elements;          //XML elements seen
+    uint32_t widgets;           //Widgets created
+    uint32_t peak_depth;        //Deepest nesting, the screen counts as 1
+    uint32_t stack_allocs;      //Allocations made by the parent stack
+}loadproj_stats_t;
+
+typedef void (*loadproj_report_cb_t)(const loadproj_stats_t * stats);
+
+//A load split into parsing (any thread) and creating the widgets (UI thread, in steps of a time budget)
+typedef struct
+{
+    void * tree;                //The parsed file (mxml_node_t *)
+    void * next;                //The next node to create in preorder, after `order`
+    void ** order;              //The elements (mxml_node_t *) of the open screen breadth first, created first
+    uint32_t order_cnt;
+    uint32_t order_next;
+    uint32_t order_level1;      //The elements of `order` before it are the screen and its children
+    uint32_t total;             //Elements in the file
+    uint32_t done;              //Elements created
+    uint32_t file_cnt;          //Files parsed, the screen files of a manifest or lgd.xml
+}loadproj_job_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void load_project(lv_obj_t * tft_win);
+const loadproj_stats_t * load_project_get_stats(void);
+void load_project_set_report_cb(loadproj_report_cb_t cb);
+bool load_project_parse(loadproj_job_t * job, lv_obj_t * tft_win);
+bool load_project_step(loadproj_job_t * job, uint32_t max_ms);
+void load_project_job_free(loadproj_job_t * job);
+lv_obj_t * load_project_subtree(lv_obj_t * par, void * xml);
+bool load_project_bin_is_newer(void);
+bool load_project_has_manifest(void);
+bool load_project_cache_is_valid(void);
+bool load_project_cache_write(void);
+bool load_project_snap(projsnap_t * snap, const char * path);
 /**********************
  *      MACROS
  **********************/
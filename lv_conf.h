@@ -28,12 +28,18 @@
  * - 8:  RGB233
  * - 16: RGB565
  * - 32: ARGB8888
+ * Can be set from the build (e.g. -DLV_COLOR_DEPTH=16) to preview at the target's depth.
+ * The monitor uploads 16 bit colors to an RGB565 texture without converting them.
  */
+#ifndef LV_COLOR_DEPTH
 #define LV_COLOR_DEPTH     32
+#endif
 
 /* Swap the 2 bytes of RGB565 color.
  * Useful if the display has a 8 bit interface (e.g. SPI)*/
+#ifndef LV_COLOR_16_SWAP
 #define LV_COLOR_16_SWAP   0
+#endif
 
 /* 1: Enable screen transparency.
  * Useful for OSD or other overlapping GUIs.
@@ -50,6 +56,57 @@
  * Can be changed in the display driver (`lv_disp_drv_t`).*/
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 
+/* Side of the tiles [px] used to collect the invalidated areas when
+ * more than `LV_INV_BUF_SIZE` areas are invalidated in one refresh period.
+ * 0: invalidate the whole screen instead*/
+#define LV_INV_TILE_SIZE    32
+
+/* Max. number of screen sized buffers LittlevGL can cycle through (see `lv_disp_buf_init_chain`).
+ * With 3 or more a frame can be rendered while the previous ones are still being flushed.
+ * 2: only double buffering (`lv_disp_buf_init`)*/
+#define LV_DISP_BUF_MAX     3
+
+/* Number of threads drawing the refreshed areas in horizontal bands (0 or 1: draw on one thread).
+ * Needs POSIX threads. The object tree mustn't be modified by other threads while drawing*/
+#define LV_REFR_THREADS     4
+
+/* Initial size [bytes] of the arena every drawing thread takes its temporary buffers from.
+ * It's reset after every refreshed area and enlarged to the most that was needed at once*/
+#define LV_DRAW_SCRATCH_SIZE    (8U * 1024U)
+
+/* 1: Scroll the pages by moving their pixels in the frame buffer and redraw only the exposed parts.
+ * Works only with true double buffering (two screen sized buffers), else the pages are redrawn*/
+#define LV_USE_SCROLL_BLIT  1
+
+/* 1: Keep the tasks in a min-heap of their next run time for every priority.
+ * `lv_task_handler` doesn't check every task on every call, it takes O(log n) per executed task.
+ * 0: Check all tasks in every `lv_task_handler` call which needs a bit less memory*/
+#define LV_TASK_HEAP        1
+
+/* Size of the queue of `lv_async_post` (a power of 2) through which other threads can pass updates
+ * to the thread of `lv_task_handler`. 0: disable the lv_async module*/
+#define LV_ASYNC_QUEUE_SIZE 256
+
+/* 1: Count how many times the pixels are drawn in a refresh (`lv_draw_overdraw_set_en`) to find overdraw.
+ * Needs LV_HOR_RES_MAX * LV_VER_RES_MAX bytes*/
+#define LV_USE_OVERDRAW     1
+
+/* 1: Measure every refresh of the displays (areas, pixels, time of the design functions by object type,
+ * time of the flushing, counts of the drawing operations) and the time of the tasks. `lv_prof_set_en(true)` starts the measuring.
+ * The last frames can be read with `lv_prof_get_frame`*/
+#define LV_USE_PROF         1
+#if LV_USE_PROF
+#define LV_PROF_FRAME_CNT   256     /*Number of frames to keep*/
+#define LV_PROF_TYPE_MAX    16      /*Object types measured in a frame, the others count only in the total*/
+
+/* 1: Take the microseconds from an expression. 0: use `lv_tick_get() * 1000` (ms resolution)*/
+#define LV_PROF_TIME_CUSTOM 1
+#if LV_PROF_TIME_CUSTOM
+#define LV_PROF_TIME_CUSTOM_INCLUDE  <SDL2/SDL.h>
+#define LV_PROF_TIME_CUSTOM_EXPR     ((uint32_t)(SDL_GetPerformanceCounter() / (SDL_GetPerformanceFrequency() / 1000000)))
+#endif
+#endif
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -69,7 +126,7 @@ typedef int16_t lv_coord_t;
 #define LV_MEM_CUSTOM      0
 #if LV_MEM_CUSTOM == 0
 /* Size of the memory used by `lv_mem_alloc` in bytes (>= 2kB)*/
-#  define LV_MEM_SIZE    (512U * 1024U)
+#  define LV_MEM_SIZE    (128U * 1024U)
 
 /* Complier prefix for a big array declaration */
 #  define LV_MEM_ATTR
@@ -78,14 +135,59 @@ typedef int16_t lv_coord_t;
  * Can be in external SRAM too. */
 #  define LV_MEM_ADR          0
 
+/* Number of memories the allocator can use: the first one (above) and the ones added by
+ * `lv_mem_add_region` (e.g. external SRAM/PSRAM) or `LV_MEM_GROW`*/
+#  define LV_MEM_REGION_MAX   16
+
+/* 1: Get a new region from the system when the memory is full. It doubles the memory
+ * (by at least `LV_MEM_GROW_SIZE` bytes). The regions are kept until the exit.*/
+#  define LV_MEM_GROW         1
+#  if LV_MEM_GROW
+#    define LV_MEM_GROW_INCLUDE <stdlib.h>  /*Header for the function below*/
+#    define LV_MEM_GROW_ALLOC   malloc      /*Allocate the memory of a new region*/
+#    define LV_MEM_GROW_SIZE    (128U * 1024U)
+#  endif
+
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #  define LV_MEM_AUTO_DEFRAG  1
+
+/* 1: Use a two level segregated fit (TLSF) allocator. Allocation and free take constant time
+ * and the adjacent free cells are always joined (`LV_MEM_AUTO_DEFRAG` is ignored).
+ * 0: Use the simple first fit allocator which needs a bit less memory*/
+#  define LV_MEM_TLSF         1
+
+/* Allocate the memories up to this size (in bytes) from chunks of same sized cells (slabs).
+ * Allocation and free are fast and the objects of the same type are close to each other.
+ * The unused cells of the chunks can't be used for other sizes. Mainly useful with the first fit allocator
+ * (`LV_MEM_TLSF 0`) which needs long search for small memories. 0: disable (max. 512)*/
+#  define LV_MEM_SLAB_MAX     0
+
+/* 1: Count the allocated memory by subsystem (object, ext. attributes, label text, image...) and record
+ * the call site (file and line) of every allocation. `lv_mem_prof_get_stat` gives the used and the highest
+ * bytes of a subsystem, `lv_mem_prof_get_alloc` lists the living allocations (e.g. the leaks).
+ * Needs LV_MEM_PROF_ENT_MAX * 24 bytes*/
+#  define LV_MEM_PROF         1
+#  if LV_MEM_PROF
+#    define LV_MEM_PROF_ENT_MAX 16384   /*Recorded allocations at once (power of 2), the others are counted only*/
+#  endif
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
 #  define LV_MEM_CUSTOM_FREE    free         /*Wrapper to free*/
 #endif     /*LV_MEM_CUSTOM*/
 
+/* The caches (images, glyphs, shadows, layers, font bitmaps) give back memory, the least recently used first,
+ * when an allocation fails and when together they hold more than this many bytes. 0: no common limit*/
+#define LV_MEM_CACHE_BUDGET     (256U * 1024U)
+
+/* 1: The linked lists of the objects, animations, tasks and groups take their nodes from pools of same sized
+ * nodes instead of allocating every node, so creating and deleting them doesn't touch the heap.
+ * The pools grow by chunks of LV_LL_POOL_CHUNK nodes and keep the freed nodes for the next ones. */
+#define LV_USE_LL_POOL      1
+#if LV_USE_LL_POOL
+#  define LV_LL_POOL_CHUNK    32
+#endif
+
 /* Garbage Collector settings
  * Used if lvgl is binded to higher level language and the memory is managed by that language */
 #define LV_ENABLE_GC 0
@@ -95,6 +197,12 @@ typedef int16_t lv_coord_t;
 #  define LV_MEM_CUSTOM_GET_SIZE  your_mem_get_size      /*Wrapper to lv_mem_get_size*/
 #endif /* LV_ENABLE_GC */
 
+/* 1: Keep the state of a LittlevGL instance (displays, input devices, objects, tasks, animations, refreshing)
+ * in a context instead of global variables. Several independent contexts (`lv_context_create`) can run
+ * in parallel, every thread on its active one (`lv_context_set_act`).
+ * Needs LV_REFR_THREADS > 1 (the library lock guards the shared allocator and caches), not for LV_ENABLE_GC*/
+#define LV_USE_CONTEXT 1
+
 /*=======================
    Input device settings
  *=======================*/
@@ -119,6 +227,97 @@ typedef int16_t lv_coord_t;
  * Time between `LV_EVENT_LONG_PRESSED_REPEAT */
 #define LV_INDEV_DEF_LONG_PRESS_REP_TIME  100
 
+/* 1: Build a spatial index on the children of objects with a lot of children
+ * to find the pressed object without testing every child */
+#define LV_USE_HIT_INDEX                  1
+#if LV_USE_HIT_INDEX
+/* Index an object after the pointer had to test this many of its children */
+#define LV_HIT_INDEX_MIN_CHILDREN         64
+
+/* Number of indexed objects. The least recently used index is dropped for a new one */
+#define LV_HIT_INDEX_SLOTS                8
+
+/* Children per grid cell if they are spread evenly */
+#define LV_HIT_INDEX_CELL_ITEMS           4
+
+/* Max. number of columns (and rows) of the grid */
+#define LV_HIT_INDEX_GRID_MAX             64
+#endif /*LV_USE_HIT_INDEX*/
+
+/* 1: Keep the bounding box of the children of the objects (with their drawing and click area), so the
+ * refresh and the input devices skip all the children of an object if none of them is on the area or point.
+ * It's updated when it's needed after a child was added, moved or resized. Costs an area per object. */
+#define LV_USE_CHILD_BOUNDS               1
+
+/* 1: Cache the area of the parents and the screen of the objects, so invalidating an object doesn't
+ * visit all its parents. It's updated when it's needed after a parent was moved, resized or hidden.
+ * Costs an area and a pointer per object. */
+#define LV_USE_OBJ_CLIP_CACHE             1
+
+/* 1: Index the objects by their style, so a modified style refreshes only its users
+ * without visiting every object. Costs 2 pointers per object. */
+#define LV_USE_STYLE_INDEX                1
+#if LV_USE_STYLE_INDEX
+/* Number of hash buckets (power of 2). The objects of a bucket are tested one by one */
+#define LV_STYLE_INDEX_BUCKETS            64
+#endif /*LV_USE_STYLE_INDEX*/
+
+/* 1: Keep an array of the children of the objects whose children are accessed by index
+ * (`lv_obj_get_child_by_index`). It's created at the first such access and updated on every change
+ * of the children, so the index and the reverse order cost nothing. Costs a pointer per such child. */
+#define LV_USE_OBJ_CHILD_ARRAY            1
+
+/* 1: Don't refresh the layout and the fit of a container on every change, only mark it.
+ * The marked containers are refreshed once before the next refresh and input read (the deepest first),
+ * or earlier by `lv_obj_align` or `lv_obj_layout_flush`. The sizes read in the meantime are the old ones. */
+#define LV_USE_LAYOUT_DEFER               1
+
+/* 1: Send `LV_SIGNAL_CORD_CHG` only to the objects which handle it (see `lv_obj_set_cord_signal`):
+ * moving an object calls its signal function only if it follows its position (e.g. the scrollable of a page),
+ * the others (e.g. containers, labels) only want to know when they are resized.
+ * A custom signal function handling it has to ask for it. */
+#define LV_USE_OBJ_CORD_SIGNAL            1
+
+/* 1: Objects can be cached as bitmaps (`lv_obj_set_layer_cache`). The area of a cached object is drawn once
+ * with everything below it and copied from the bitmap until the object, a child or something below it
+ * is invalidated. Good for static windows and panels which are redrawn because something above them changes. */
+#define LV_USE_LAYER_CACHE                1
+#if LV_USE_LAYER_CACHE
+/* Number of cached objects */
+#define LV_LAYER_CACHE_SLOTS              8
+
+/* Bytes of the bitmaps (allocated with `lv_mem_alloc`). The least recently copied ones are dropped for a new one */
+#define LV_LAYER_CACHE_BUDGET             (4U * 1024U * 1024U)
+
+/* Min. time [ms] between two redraws of a modal backdrop's bitmap (`lv_obj_set_layer_backdrop`)
+ * when something changes below it */
+#define LV_LAYER_BACKDROP_PERIOD          250
+#endif /*LV_USE_LAYER_CACHE*/
+
+/* 1: An object with opa scale (`lv_obj_set_opa_scale`) and children is drawn opaque with its children
+ * and blended once with the opa scale (the background is saved in the scratch arena).
+ * 0: every drawing of the children and their parts is blended with it, overlapping parts mix twice. */
+#define LV_USE_OPA_GROUP                  1
+
+/* 1: Tab views and tile views can slide between their tabs as two bitmaps (`lv_tabview_set_slide_snapshot`).
+ * The old and the new tab are drawn once at the start, the frames of the animation only copy them.
+ * Meant for opaque tabs: what's below them slides too. */
+#define LV_USE_SLIDE_SNAPSHOT             1
+#if LV_USE_SLIDE_SNAPSHOT
+/* Max. bytes of the two bitmaps (allocated with `lv_mem_alloc`). Larger tabs are animated as usual */
+#define LV_SLIDE_SNAPSHOT_MAX             (1024U * 1024U)
+#endif /*LV_USE_SLIDE_SNAPSHOT*/
+
+/* 1: The children of an object can be created when it's shown first (`lv_obj_set_lazy`): hidden branches
+ * and the not selected tabs of a tab view don't cost memory and creation time until they are shown
+ * by `lv_obj_set_hidden(obj, false)` or the tab selection. */
+#define LV_USE_OBJ_LAZY                   1
+#if LV_USE_OBJ_LAZY
+/* Free bytes of `lv_mem` below which the lazy children of an object allowed to release them are deleted
+ * when it's hidden again (and created again when it's shown). 0: never release */
+#define LV_OBJ_LAZY_RELEASE_FREE          (8U * 1024U)
+#endif /*LV_USE_OBJ_LAZY*/
+
 /*==================
  * Feature usage
  *==================*/
@@ -130,25 +329,61 @@ typedef int16_t lv_coord_t;
 /*Declare the type of the user data of animations (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_anim_user_data_t;
 
+/* 1: Evaluate the built-in eased paths (ease in/out, overshoot, bounce) from tables
+ * filled in `lv_anim_core_init` instead of computing a Bezier curve in every step (~2.5 kB RAM)*/
+#define LV_ANIM_PATH_LUT        1
+
 #endif
 
 /* 1: Enable shadow drawing*/
 #define LV_USE_SHADOW           1
+#if LV_USE_SHADOW
+/* Number of calculated shadows (radius, width and opacity combinations) to keep for reuse. 0: no cache*/
+#  define LV_SHADOW_CACHE_SIZE  8
+#endif
+
+/* 1: Dither the vertical gradients of the rectangles so they don't show bands with 16 bit colors.
+ * Only with LV_COLOR_DEPTH 16, the dithered rows are drawn pixel by pixel*/
+#define LV_GRAD_DITHER          1
 
 /* 1: Enable object groups (for keyboard/encoder navigation) */
 #define LV_USE_GROUP            1
 #if LV_USE_GROUP
 typedef void * lv_group_user_data_t;
+
+/* 1: Keep the objects of a group sorted by their position (rebuilt when they move)
+ * so `lv_group_focus_dir` doesn't test every object. Costs 2 * 8 bytes per object. */
+#define LV_USE_GROUP_NAV_INDEX  1
+
+/* Number of focused/edited styles cached per drawing thread so a focused object isn't
+ * restyled by the group's callback at every draw. Costs 2 * sizeof(lv_style_t) each. 0: no cache */
+#define LV_GROUP_STYLE_CACHE    4
 #endif  /*LV_USE_GROUP*/
 
 /* 1: Enable GPU interface*/
 #define LV_USE_GPU              1
 
+/* 1: Let the display drivers show the cursor of the pointer input devices (`cursor_set_cb`)
+ * so moving it redraws nothing. The cursor object is drawn if the display can't show it. */
+#define LV_USE_HW_CURSOR        1
+
+/* 1: Blend and fill with SSE2/AVX2 or NEON if the CPU supports it (16 and 32 bit color depth)*/
+#define LV_USE_SIMD             1
+
+/* 1: Draw into 1 or 2 bit-per-pixel packed buffers for monochrome panels (see lv_draw_packed.h)*/
+#define LV_USE_DRAW_PACKED      1
+
 /* 1: Enable file system (might be required for images */
 #define LV_USE_FILESYSTEM       1
 #if LV_USE_FILESYSTEM
 /*Declare the type of the user data of file system drivers (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_fs_drv_user_data_t;
+
+/*Read the files opened for reading through a cache of `LV_FS_CACHE_BLOCK_CNT` blocks of `LV_FS_CACHE_BLOCK_SIZE` bytes,
+ *so small reads (e.g. the lines of an image) don't go to the driver one by one.
+ *0: no cache. A driver can override them in its `lv_fs_drv_t`*/
+#define LV_FS_CACHE_BLOCK_SIZE  512
+#define LV_FS_CACHE_BLOCK_CNT   2
 #endif
 
 /*1: Add a `user_data` to drivers and objects*/
@@ -170,7 +405,20 @@ typedef void * lv_fs_drv_user_data_t;
  * With complex image decoders (e.g. PNG or JPG) caching can save the continuous open/decode of images.
  * However the opened images might consume additional RAM.
  * LV_IMG_CACHE_DEF_SIZE must be >= 1 */
-#define LV_IMG_CACHE_DEF_SIZE       1
+#define LV_IMG_CACHE_DEF_SIZE       16
+
+/* Default byte budget of the image cache: the images of files and of `LV_IMG_CF_RAW...` variables
+ * are decoded once into buffers allocated with `lv_mem_alloc` (if they fit) and the least recently used
+ * unpinned images are closed to stay in the budget. 0: only LV_IMG_CACHE_DEF_SIZE limits the cache */
+#define LV_IMG_CACHE_DEF_BUDGET     (64U * 1024U)
+
+/* 1: Open and decode the images of files and of `LV_IMG_CF_RAW...` variables on a background thread.
+ * Until an image is ready a LV_IMG_CACHE_ASYNC_COLOR rectangle is drawn in its place.
+ * Needs LV_REFR_THREADS > 1 and LV_ASYNC_QUEUE_SIZE. The image decoders have to be thread safe */
+#define LV_USE_IMG_CACHE_ASYNC      1
+#if LV_USE_IMG_CACHE_ASYNC
+#define LV_IMG_CACHE_ASYNC_COLOR    LV_COLOR_SILVER
+#endif
 
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_img_decoder_user_data_t;
@@ -198,11 +446,13 @@ typedef void * lv_img_decoder_user_data_t;
  *==================*/
 
 /* 1: use a custom tick source.
+ * 2: use the built-in POSIX source reading `clock_gettime(CLOCK_MONOTONIC)`.
  * It removes the need to manually update the tick with `lv_tick_inc`) */
-#define LV_TICK_CUSTOM     0
+#define LV_TICK_CUSTOM     1
 #if LV_TICK_CUSTOM == 1
-#define LV_TICK_CUSTOM_INCLUDE  "something.h"       /*Header for the sys time function*/
-#define LV_TICK_CUSTOM_SYS_TIME_EXPR (millis())     /*Expression evaluating to current systime in ms*/
+#define LV_TICK_CUSTOM_INCLUDE  "inputrec.h"        /*Header for the sys time function*/
+#define LV_TICK_CUSTOM_SYS_TIME_EXPR (inputrec_tick())     /*Expression evaluating to current systime in ms.
+                                                            *`SDL_GetTicks()` or a virtual tick while replaying an input recording*/
 #endif   /*LV_TICK_CUSTOM*/
 
 typedef void * lv_disp_drv_user_data_t;             /*Type of user data in the display driver*/
@@ -226,6 +476,12 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
 /* 1: Print the log with 'printf';
  * 0: user need to register a callback with `lv_log_register_print`*/
 #  define LV_LOG_PRINTF   1
+
+/* Size of a ring buffer (a power of 2) for the logs. They are printed later by a low priority task
+ * so logging doesn't stall the drawing. When the ring is full the logs are dropped and counted.
+ * 0: print the logs immediately */
+#  define LV_LOG_ASYNC_SIZE   64
+#  define LV_LOG_ASYNC_RATE_MS 1000   /*Repeats of a log (same file and line) within this time are only counted*/
 #endif  /*LV_USE_LOG*/
 
 /*================
@@ -274,6 +530,23 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
 /*Always set a default font from the built-in fonts*/
 #define LV_FONT_DEFAULT        &lv_font_roboto_16
 
+/*Number of glyphs to keep expanded to 8 bit-per-pixel for faster drawing. 0: no cache*/
+#define LV_GLYPH_CACHE_SIZE    256
+
+/*Load fonts from files with `lv_font_bin_load` (needs `LV_USE_FILESYSTEM`).
+ *Only the character maps and the glyph descriptors stay in RAM, the glyph bitmaps are read
+ *when they are drawn and the last used ones are kept in a cache of `LV_FONT_BIN_CACHE_BUDGET` bytes*/
+#define LV_USE_FONT_BIN        1
+#define LV_FONT_BIN_CACHE_BUDGET   (32U * 1024U)
+
+/*Let `lv_font_fmt_txt_accel_build` give a font a codepoint page table and a kerning hash table
+ *to find glyphs and kerning values in constant time. Costs about 512 bytes per 256 code point page*/
+#define LV_FONT_FMT_TXT_ACCEL  1
+
+/*Draw fonts with `LV_FONT_FMT_TXT_COMPRESSED` glyph bitmaps. They are expanded when drawn the first time
+ *so keep `LV_GLYPH_CACHE_SIZE` enabled with them*/
+#define LV_USE_FONT_COMPRESSED 1
+
 /*Declare the type of the user data of fonts (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_font_user_data_t;
 
@@ -330,6 +603,15 @@ typedef void * lv_obj_user_data_t;
 
 /*Button matrix (dependencies: -)*/
 #define LV_USE_BTNM     1
+#if LV_USE_BTNM != 0
+/*Keep the areas of the buttons and the texts drawn into maps which no button matrix uses
+ *until they are larger than this many bytes (e.g. for the keyboards created again)*/
+#  define LV_BTNM_SHARE_KEEP              (8U * 1024U)
+
+/*Draw a one line text of a released button once into an opacity map of at most this many bytes
+ *and share it with the buttons with the same text and font. 0: disable*/
+#  define LV_BTNM_LABEL_MAP_MAX           (2U * 1024U)
+#endif
 
 /*Calendar (dependencies: -)*/
 #define LV_USE_CALENDAR 1
@@ -344,6 +626,9 @@ typedef void * lv_obj_user_data_t;
 #define LV_USE_CHART    1
 #if LV_USE_CHART
 #  define LV_CHART_AXIS_TICK_LABEL_MAX_LEN    20
+/*Series with their own 32 bit point count in a ring buffer (`lv_chart_add_ring_series`).
+ * Appending is O(1) and they are drawn as a min/max envelope when they have more points than the chart has pixels*/
+#  define LV_CHART_RING_SERIES    1
 #endif
 
 /*Container (dependencies: -*/
@@ -367,6 +652,18 @@ typedef void * lv_obj_user_data_t;
 #if LV_USE_IMGBTN
 /*1: The imgbtn requires left, mid and right parts and the width can be set freely*/
 #  define LV_IMGBTN_TILED 0
+/*1: Keep the images of every state opened in the image cache (`lv_img_cache_pin`) while the imgbtn uses them,
+ *so a state change only draws the other image*/
+#  define LV_IMGBTN_PIN   1
+#endif
+
+/*Animated image streamed from a file of `lv_animimg_save` (dependencies: LV_USE_FILESYSTEM)*/
+#define LV_USE_ANIMIMG  1
+#if LV_USE_ANIMIMG
+/*Decoded frames kept in the memory (>= 2): the shown one and the ones decoded ahead of it*/
+#  define LV_ANIMIMG_RING         3
+/*[bytes] read from the file at once*/
+#  define LV_ANIMIMG_READ_AHEAD   4096
 #endif
 
 /*Keyboard (dependencies: lv_btnm)*/
@@ -386,6 +683,10 @@ typedef void * lv_obj_user_data_t;
 
 /*Store extra some info in labels (12 bytes) to speed up drawing of very long texts*/
 #  define LV_LABEL_LONG_TXT_HINT          0
+
+/*Draw the text of a rolling label (one line, no re-coloring) once into an opacity map of at most
+ *this many bytes and only copy it to the new offset in every step of the animation. 0: disable*/
+#  define LV_LABEL_ROLL_STRIP_MAX         (8U * 1024U)
 #endif
 
 /*LED (dependencies: -)*/
@@ -399,6 +700,8 @@ typedef void * lv_obj_user_data_t;
 #if LV_USE_LIST != 0
 /*Default animation time of focusing to a list element [ms] (0: no animation)  */
 #  define LV_LIST_DEF_ANIM_TIME  100
+/*Virtual lists (`lv_list_set_virtual`): only the visible rows are created and they are recycled while scrolling*/
+#  define LV_LIST_VIRTUAL        1
 #endif
 
 /*Line meter (dependencies: *;)*/
@@ -420,6 +723,12 @@ typedef void * lv_obj_user_data_t;
 #  define LV_PRELOAD_DEF_ARC_LENGTH   60      /*[deg]*/
 #  define LV_PRELOAD_DEF_SPIN_TIME    1000    /*[ms]*/
 #  define LV_PRELOAD_DEF_ANIM         LV_PRELOAD_TYPE_SPINNING_ARC
+
+/*Rotation steps of a spinner copied from pre-drawn frames (`lv_preload_set_sprite`). 0: disable the sprites*/
+#  define LV_PRELOAD_SPRITE_FRAMES    36
+
+/*[bytes] of the frames of all sprite spinners. A spinner whose frames don't fit is drawn as usual.*/
+#  define LV_PRELOAD_SPRITE_BUDGET    (128U * 1024U)
 #endif
 
 /*Roller (dependencies: lv_ddlist)*/
@@ -10,7 +10,7 @@
 #if USE_SSD1963
 
 #include <stdbool.h>
-#include "lvgl/lv_core/lv_vdb.h"
+#include <stddef.h>
 #include LV_DRV_DISP_INCLUDE
 #include LV_DRV_DELAY_INCLUDE
 
@@ -36,11 +36,24 @@ static void ssd1963_reset(void);
 static void ssd1963_set_clk(void);
 static void ssd1963_set_tft_spec(void);
 static void ssd1963_init_bl(void);
+#if defined(LV_DRV_DISP_PAR_WR_ARRAY_ASYNC) && LV_COLOR_DEPTH == 16
+static void ssd1963_dma_next(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool cmd_mode = true;
+static ssd1963_stat_t stat;
+
+#if defined(LV_DRV_DISP_PAR_WR_ARRAY_ASYNC) && LV_COLOR_DEPTH == 16
+/*The rest of the area being sent by DMA. `volatile` because it's updated from the interrupt*/
+static lv_disp_drv_t * volatile dma_drv;
+static const lv_color_t * volatile dma_p;
+static volatile uint32_t dma_w;         /*Pixels in a transfer*/
+static volatile uint32_t dma_stride;    /*Pixels from a row to the next in the buffer*/
+static volatile uint32_t dma_rows;      /*Transfers not started yet*/
+#endif
 
 /**********************
  *      MACROS
@@ -149,14 +162,26 @@ void ssd1963_init(void)
 }
 
 
-void ssd1963_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p)
+/**
+ * Flush a part of LittlevGL's buffer to the display.
+ * With `LV_DRV_DISP_PAR_WR_ARRAY_ASYNC` only the transfer is started and `lv_disp_flush_ready`
+ * is called from `ssd1963_flush_done` so LittlevGL can render while the pixels are sent.
+ * @param drv pointer to the display driver
+ * @param area the area to refresh
+ * @param color_p an array of colors
+ */
+void ssd1963_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
 {
+    int32_t x1 = area->x1;
+    int32_t y1 = area->y1;
+    int32_t x2 = area->x2;
+    int32_t y2 = area->y2;
 
     /*Return if the area is out the screen*/
-    if(x2 < 0) return;
-    if(y2 < 0) return;
-    if(x1 > SSD1963_HOR_RES - 1) return;
-    if(y1 > SSD1963_VER_RES - 1) return;
+    if(x2 < 0 || y2 < 0 || x1 > SSD1963_HOR_RES - 1 || y1 > SSD1963_VER_RES - 1) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
 
     /*Truncate the area to the screen*/
     int32_t act_x1 = x1 < 0 ? 0 : x1;
@@ -178,29 +203,89 @@ void ssd1963_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_colo
     ssd1963_data(0x00FF & act_y2);
 
     ssd1963_cmd(0x2c);
-    int16_t i;
-    uint16_t full_w = x2 - x1 + 1;
+    uint32_t full_w = x2 - x1 + 1;
+    uint32_t act_w = act_x2 - act_x1 + 1;
+    uint32_t act_h = act_y2 - act_y1 + 1;
+
+    /*Skip the truncated rows and columns*/
+    color_p += (act_y1 - y1) * full_w + (act_x1 - x1);
+
+    stat.flush_cnt++;
+    stat.flush_px += act_w * act_h;
 
     ssd1963_data_mode();
     LV_DRV_DISP_PAR_CS(0);
 #if LV_COLOR_DEPTH == 16
-    uint16_t act_w = act_x2 - act_x1 + 1;
+#ifdef LV_DRV_DISP_PAR_WR_ARRAY_ASYNC
+    /*Send the rows with one transfer if they follow each other in the buffer*/
+    dma_drv = drv;
+    dma_p = color_p;
+    dma_stride = full_w;
+    if(act_w == full_w) {
+        dma_w = act_w * act_h;
+        dma_rows = 1;
+    } else {
+        dma_w = act_w;
+        dma_rows = act_h;
+    }
+
+    stat.async_cnt++;
+    stat.async_px += act_w * act_h;
+
+    ssd1963_dma_next();
+    return;
+#else
+    int32_t i;
     for(i = act_y1; i <= act_y2; i++) {
         LV_DRV_DISP_PAR_WR_ARRAY((uint16_t *)color_p, act_w);
         color_p += full_w;
     }
-    LV_DRV_DISP_PAR_CS(1);
+#endif
 #else
-    int16_t j;
+    int32_t i;
+    uint32_t j;
     for(i = act_y1; i <= act_y2; i++) {
-        for(j = 0; j <= act_x2 - act_x1 + 1; j++) {
-            LV_DRV_DISP_PAR_WR_WORD(color_p[j]);
-            color_p += full_w;
+        for(j = 0; j < act_w; j++) {
+            LV_DRV_DISP_PAR_WR_WORD(lv_color_to16(color_p[j]));
         }
+        color_p += full_w;
     }
 #endif
+    LV_DRV_DISP_PAR_CS(1);
 
-    lv_flush_ready();
+    lv_disp_flush_ready(drv);
+}
+
+/**
+ * Call it from the DMA's transfer complete interrupt when `LV_DRV_DISP_PAR_WR_ARRAY_ASYNC` is used.
+ * Starts the next row of the area or tells LittlevGL the flush is ready.
+ */
+void ssd1963_flush_done(void)
+{
+#if defined(LV_DRV_DISP_PAR_WR_ARRAY_ASYNC) && LV_COLOR_DEPTH == 16
+    if(dma_drv == NULL) return;
+
+    if(dma_rows > 0) {
+        ssd1963_dma_next();
+        return;
+    }
+
+    LV_DRV_DISP_PAR_CS(1);
+
+    lv_disp_drv_t * drv = dma_drv;
+    dma_drv = NULL;
+    lv_disp_flush_ready(drv);
+#endif
+}
+
+/**
+ * Get the flush statistics. `async_px / flush_px` is the part of the pixels sent while
+ * LittlevGL could render.
+ * @param stat_p the statistics are copied here
+ */
+void ssd1963_get_stat(ssd1963_stat_t * stat_p)
+{
+    *stat_p = stat;
 }
 
 void ssd1963_fill(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t color)
@@ -301,6 +386,22 @@ void ssd1963_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
  *   STATIC FUNCTIONS
  **********************/
 
+#if defined(LV_DRV_DISP_PAR_WR_ARRAY_ASYNC) && LV_COLOR_DEPTH == 16
+/**
+ * Start the DMA transfer of the next row (or of the whole area if its rows are contiguous)
+ */
+static void ssd1963_dma_next(void)
+{
+    const lv_color_t * p = dma_p;
+
+    /*Update the state first, the transfer might complete before the macro returns*/
+    dma_p = p + dma_stride;
+    dma_rows--;
+
+    LV_DRV_DISP_PAR_WR_ARRAY_ASYNC((uint16_t *)p, dma_w);
+}
+#endif
+
 static void ssd1963_io_init(void)
 {
     LV_DRV_DISP_CMD_DATA(SSD1963_CMD_MODE);
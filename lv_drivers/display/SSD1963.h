@@ -22,7 +22,7 @@ extern "C" {
 #if USE_SSD1963
 
 #include <stdint.h>
-#include "lvgl/lv_misc/lv_color.h"
+#include "lvgl/lvgl.h"
 
 /*********************
  *      DEFINES
@@ -125,12 +125,20 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    uint32_t flush_cnt;     /*Flushed areas*/
+    uint32_t flush_px;      /*Flushed pixels*/
+    uint32_t async_cnt;     /*Areas sent by DMA while LittlevGL was free to render*/
+    uint32_t async_px;      /*Pixels sent by DMA*/
+} ssd1963_stat_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void ssd1963_init(void);
-void ssd1963_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
+void ssd1963_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+void ssd1963_flush_done(void);
+void ssd1963_get_stat(ssd1963_stat_t * stat_p);
 void ssd1963_fill(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t  color);
 void ssd1963_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
 
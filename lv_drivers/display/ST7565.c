@@ -12,7 +12,6 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <string.h>
-#include "lvgl/lv_core/lv_vdb.h"
 #include LV_DRV_DISP_INCLUDE
 #include LV_DRV_DELAY_INCLUDE
 
@@ -76,12 +75,26 @@
 static void st7565_sync(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
 static void st7565_command(uint8_t cmd);
 static void st7565_data(uint8_t data);
+static void st7565_dma_wait(void);
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+static void st7565_dma_next(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint8_t lcd_fb[ST7565_HOR_RES * ST7565_VER_RES / 8] = {0xAA, 0xAA};
 static uint8_t pagemap[] = { 7, 6, 5, 4, 3, 2, 1, 0 };
+static st7565_stat_t stat;
+
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+/*The pages being sent by DMA. `volatile` because they are updated from the interrupt*/
+static volatile bool dma_busy;
+static volatile uint8_t dma_x1;
+static volatile uint8_t dma_x2;
+static volatile uint8_t dma_page;       /*The next page to send*/
+static volatile uint8_t dma_page_last;
+#endif
 
 /**********************
  *      MACROS
@@ -133,13 +146,26 @@ void st7565_init(void)
 }
 
 
-void st7565_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p)
+/**
+ * Flush a part of LittlevGL's buffer to the display.
+ * The area is converted to the local frame buffer so with `LV_DRV_DISP_SPI_WR_ARRAY_ASYNC`
+ * LittlevGL gets its buffer back right away and renders while the pages are sent.
+ * @param drv pointer to the display driver
+ * @param area the area to refresh
+ * @param color_p an array of colors
+ */
+void st7565_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
 {
+    int32_t x1 = area->x1;
+    int32_t y1 = area->y1;
+    int32_t x2 = area->x2;
+    int32_t y2 = area->y2;
+
     /*Return if the area is out the screen*/
-    if(x2 < 0) return;
-    if(y2 < 0) return;
-    if(x1 > ST7565_HOR_RES - 1) return;
-    if(y1 > ST7565_VER_RES - 1) return;
+    if(x2 < 0 || y2 < 0 || x1 > ST7565_HOR_RES - 1 || y1 > ST7565_VER_RES - 1) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
 
     /*Truncate the area to the screen*/
     int32_t act_x1 = x1 < 0 ? 0 : x1;
@@ -148,8 +174,13 @@ void st7565_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color
     int32_t act_y2 = y2 > ST7565_VER_RES - 1 ? ST7565_VER_RES - 1 : y2;
 
     int32_t x, y;
+    int32_t full_w = x2 - x1 + 1;
 
-    /*Set the first row in */
+    /*The previous pages might be still sent from the frame buffer*/
+    st7565_dma_wait();
+
+    /*Skip the truncated rows and columns*/
+    color_p += (act_y1 - y1) * full_w + (act_x1 - x1);
 
     /*Refresh frame buffer*/
     for(y = act_y1; y <= act_y2; y++) {
@@ -162,11 +193,128 @@ void st7565_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color
             color_p ++;
         }
 
-        color_p += x2 - act_x2; /*Next row*/
+        color_p += full_w - (act_x2 - act_x1 + 1); /*Next row*/
     }
 
+    stat.flush_cnt++;
+    stat.flush_px += (act_x2 - act_x1 + 1) * (act_y2 - act_y1 + 1);
+
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+    stat.async_cnt++;
+    stat.async_px += (act_x2 - act_x1 + 1) * (act_y2 - act_y1 + 1);
+
+    /*LittlevGL's buffer is not needed anymore*/
+    lv_disp_flush_ready(drv);
+
+    dma_x1 = act_x1;
+    dma_x2 = act_x2;
+    dma_page = act_y1 / 8;
+    dma_page_last = act_y2 / 8;
+    dma_busy = true;
+
+    LV_DRV_DISP_SPI_CS(0);
+    st7565_dma_next();
+#else
     st7565_sync(act_x1, act_y1, act_x2, act_y2);
-    lv_flush_ready();
+    lv_disp_flush_ready(drv);
+#endif
+}
+
+#if LV_USE_DRAW_PACKED
+/**
+ * Flush a part of a packed buffer drawn with `lv_draw_packed_init_drv(drv, LV_DRAW_PACKED_1BPP_VER)`.
+ * Its bytes are the pages of the display so they are copied to the frame buffer without conversion.
+ * @param drv pointer to the display driver
+ * @param area the area to refresh. Its rows are rounded to whole pages.
+ * @param color_p the packed buffer
+ */
+void st7565_flush_packed(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    const uint8_t * buf = (const uint8_t *)color_p;
+    int32_t x1 = area->x1;
+    int32_t y1 = area->y1;
+    int32_t x2 = area->x2;
+    int32_t y2 = area->y2;
+
+    /*Return if the area is out the screen*/
+    if(x2 < 0 || y2 < 0 || x1 > ST7565_HOR_RES - 1 || y1 > ST7565_VER_RES - 1) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    /*Truncate the area to the screen*/
+    int32_t act_x1 = x1 < 0 ? 0 : x1;
+    int32_t act_y1 = y1 < 0 ? 0 : y1;
+    int32_t act_x2 = x2 > ST7565_HOR_RES - 1 ? ST7565_HOR_RES - 1 : x2;
+    int32_t act_y2 = y2 > ST7565_VER_RES - 1 ? ST7565_VER_RES - 1 : y2;
+
+    int32_t x, p;
+    int32_t full_w = x2 - x1 + 1;
+
+    /*The previous pages might be still sent from the frame buffer*/
+    st7565_dma_wait();
+
+    /*Refresh frame buffer. In the packed buffer 1 is light, in the frame buffer 1 is dark.*/
+    for(p = act_y1 / 8; p <= act_y2 / 8; p++) {
+        const uint8_t * page_p = &buf[(p - y1 / 8) * full_w + (act_x1 - x1)];
+        for(x = act_x1; x <= act_x2; x++) {
+            lcd_fb[x + p * ST7565_HOR_RES] = ~(*page_p);
+            page_p++;
+        }
+    }
+
+    stat.flush_cnt++;
+    stat.flush_px += (act_x2 - act_x1 + 1) * (act_y2 - act_y1 + 1);
+
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+    stat.async_cnt++;
+    stat.async_px += (act_x2 - act_x1 + 1) * (act_y2 - act_y1 + 1);
+
+    /*LittlevGL's buffer is not needed anymore*/
+    lv_disp_flush_ready(drv);
+
+    dma_x1 = act_x1;
+    dma_x2 = act_x2;
+    dma_page = act_y1 / 8;
+    dma_page_last = act_y2 / 8;
+    dma_busy = true;
+
+    LV_DRV_DISP_SPI_CS(0);
+    st7565_dma_next();
+#else
+    st7565_sync(act_x1, act_y1, act_x2, act_y2);
+    lv_disp_flush_ready(drv);
+#endif
+}
+#endif
+
+/**
+ * Call it from the DMA's transfer complete interrupt when `LV_DRV_DISP_SPI_WR_ARRAY_ASYNC` is used.
+ * Starts sending the next page of the flushed area.
+ */
+void st7565_flush_done(void)
+{
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+    if(dma_busy == false) return;
+
+    if(dma_page <= dma_page_last) {
+        st7565_dma_next();
+        return;
+    }
+
+    LV_DRV_DISP_SPI_CS(1);
+    dma_busy = false;
+#endif
+}
+
+/**
+ * Get the flush statistics. `async_px / flush_px` is the part of the pixels sent while
+ * LittlevGL could render.
+ * @param stat_p the statistics are copied here
+ */
+void st7565_get_stat(st7565_stat_t * stat_p)
+{
+    *stat_p = stat;
 }
 
 
@@ -185,6 +333,8 @@ void st7565_fill(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t colo
     int32_t act_x2 = x2 > ST7565_HOR_RES - 1 ? ST7565_HOR_RES - 1 : x2;
     int32_t act_y2 = y2 > ST7565_VER_RES - 1 ? ST7565_VER_RES - 1 : y2;
 
+    st7565_dma_wait();
+
     int32_t x, y;
     uint8_t white = lv_color_to1(color);
 
@@ -216,6 +366,8 @@ void st7565_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t
     int32_t act_x2 = x2 > ST7565_HOR_RES - 1 ? ST7565_HOR_RES - 1 : x2;
     int32_t act_y2 = y2 > ST7565_VER_RES - 1 ? ST7565_VER_RES - 1 : y2;
 
+    st7565_dma_wait();
+
     int32_t x, y;
 
     /*Set the first row in */
@@ -266,6 +418,37 @@ static void st7565_sync(int32_t x1, int32_t y1, int32_t x2, int32_t y2)
     LV_DRV_DISP_SPI_CS(1);
 }
 
+/**
+ * Wait until the DMA finished sending the frame buffer
+ */
+static void st7565_dma_wait(void)
+{
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+    while(dma_busy);
+#endif
+}
+
+#ifdef LV_DRV_DISP_SPI_WR_ARRAY_ASYNC
+/**
+ * Set the address of the next page and start sending its columns
+ */
+static void st7565_dma_next(void)
+{
+    uint8_t p = dma_page;
+
+    /*Update the state first, the transfer might complete before the macro returns*/
+    dma_page = p + 1;
+
+    st7565_command(CMD_SET_PAGE | pagemap[p]);
+    st7565_command(CMD_SET_COLUMN_LOWER | (dma_x1 & 0xf));
+    st7565_command(CMD_SET_COLUMN_UPPER | ((dma_x1 >> 4) & 0xf));
+    st7565_command(CMD_RMW);
+
+    LV_DRV_DISP_CMD_DATA(ST7565_DATA_MODE);
+    LV_DRV_DISP_SPI_WR_ARRAY_ASYNC(&lcd_fb[(ST7565_HOR_RES * p) + dma_x1], dma_x2 - dma_x1 + 1);
+}
+#endif
+
 /**
  * Write a command to the ST7565
  * @param cmd the command
@@ -22,7 +22,7 @@ extern "C" {
 #if USE_ST7565
 
 #include <stdint.h>
-#include "lvgl/lv_misc/lv_color.h"
+#include "lvgl/lvgl.h"
 
 /*********************
  *      DEFINES
@@ -31,12 +31,23 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct {
+    uint32_t flush_cnt;     /*Flushed areas*/
+    uint32_t flush_px;      /*Flushed pixels*/
+    uint32_t async_cnt;     /*Areas sent by DMA while LittlevGL was free to render*/
+    uint32_t async_px;      /*Pixels sent by DMA*/
+} st7565_stat_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void st7565_init(void);
-void st7565_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
+void st7565_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+#if LV_USE_DRAW_PACKED
+void st7565_flush_packed(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+#endif
+void st7565_flush_done(void);
+void st7565_get_stat(st7565_stat_t * stat_p);
 void st7565_fill(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t color);
 void st7565_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
 
@@ -1,5 +1,11 @@
 CSRCS += fbdev.c
+CSRCS += drm.c
 CSRCS += monitor.c
+CSRCS += soft_gpu.c
+CSRCS += netdisp.c
+CSRCS += netdisp_rx.c
+CSRCS += shmdisp.c
+CSRCS += shmdisp_rx.c
 CSRCS += R61581.c
 CSRCS += SSD1963.c
 CSRCS += ST7565.c
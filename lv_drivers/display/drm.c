@@ -0,0 +1,919 @@
+/**
+ * @file drm.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "drm.h"
+#if USE_DRM
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <drm_fourcc.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef DRM_CARD
+#define DRM_CARD            "/dev/dri/card0"
+#endif
+
+#ifndef DRM_CONNECTOR_ID
+#define DRM_CONNECTOR_ID    -1
+#endif
+
+#ifndef DRM_BUF_CNT
+#define DRM_BUF_CNT         3
+#endif
+
+#define DRM_DAMAGE_MAX      16      /*With more refreshed areas the whole screen is marked as damaged*/
+
+/*The format of the buffers. LittlevGL's colors are XRGB8888 or RGB565 in the memory.*/
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0
+#define DRM_PX_FORMAT       DRM_FORMAT_RGB565
+#define DRM_PX_BPP          16
+#define DRM_PX_NATIVE       1
+#else
+#define DRM_PX_FORMAT       DRM_FORMAT_XRGB8888
+#define DRM_PX_BPP          32
+#define DRM_PX_NATIVE       (LV_COLOR_DEPTH == 32)
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t handle;    /*Of the dumb buffer, 0: not created*/
+    uint32_t fb_id;
+    uint32_t pitch;
+    uint64_t size;
+    uint8_t * map;
+} drm_buf_t;
+
+/*A buffer waiting to be shown*/
+typedef struct {
+    uint8_t buf;        /*Index in `bufs`*/
+    uint8_t flushed;    /*1: call `lv_disp_flush_ready` when it's shown*/
+    uint32_t dmg_blob;  /*Damage clips to pass with it, 0: the whole screen*/
+} drm_flip_t;
+
+typedef struct {
+    uint32_t * id;
+    uint32_t obj_id;
+    uint32_t obj_type;
+    const char * name;
+} drm_prop_req_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool drm_find_output(void);
+static bool drm_find_plane(void);
+static bool drm_props_init(void);
+static uint32_t drm_prop_find(uint32_t obj_id, uint32_t obj_type, const char * name, uint64_t * value);
+static bool drm_buf_create(drm_buf_t * buf, uint32_t w, uint32_t h, uint32_t bpp, uint32_t format);
+static void drm_buf_destroy(drm_buf_t * buf);
+static uint32_t drm_damage_blob(void);
+static void drm_copy(const lv_area_t * area, const lv_color_t * color_p);
+static void drm_flip_push(uint8_t buf, bool flushed, uint32_t dmg_blob);
+static void drm_flip_next(void);
+static bool drm_commit(uint8_t buf, uint32_t dmg_blob);
+static void drm_flip_handler(int fd, unsigned int sequence, unsigned int tv_sec, unsigned int tv_usec, void * user_data);
+static void * drm_event_main(void * param);
+#if LV_USE_HW_CURSOR
+static bool drm_cursor_load(lv_disp_drv_t * drv, const lv_img_dsc_t * img);
+static void drm_cursor_apply(void);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int drm_fd = -1;
+static drmModeModeInfo mode;
+static uint32_t conn_id;
+static uint32_t crtc_id;
+static uint32_t crtc_idx;           /*Index of the CRTC in the resources, for `possible_crtcs`*/
+static uint32_t plane_id;
+static uint32_t mode_blob;
+
+static uint32_t conn_prop_crtc_id;
+static uint32_t crtc_prop_mode_id;
+static uint32_t crtc_prop_active;
+static uint32_t plane_prop_fb_id;
+static uint32_t plane_prop_crtc_id;
+static uint32_t plane_prop_src[4];  /*SRC_X, SRC_Y, SRC_W, SRC_H*/
+static uint32_t plane_prop_crtc[4]; /*CRTC_X, CRTC_Y, CRTC_W, CRTC_H*/
+static uint32_t plane_prop_damage;  /*FB_DAMAGE_CLIPS, 0: not supported*/
+
+static drm_buf_t bufs[DRM_BUF_CNT];
+static uint8_t buf_cnt;
+static uint8_t buf_shown;
+static bool direct;                 /*LittlevGL draws into `bufs`*/
+
+/*The flips are queued because only one can be pending. Protected by `flip_mutex`.*/
+static pthread_mutex_t flip_mutex = PTHREAD_MUTEX_INITIALIZER;
+static drm_flip_t flip_queue[DRM_BUF_CNT];
+static uint8_t flip_rd;
+static uint8_t flip_cnt;
+static drm_flip_t flip_act;         /*The committed flip whose event didn't arrive yet*/
+static bool flip_pending;
+static bool modeset_done;
+static bool flip_done;              /*A page flip event arrived, so the mode is set*/
+static bool dmg_lost;               /*A frame was dropped, the damage clips of the next one are incomplete*/
+static lv_disp_drv_t * flush_drv;
+
+static pthread_t event_thread;
+static bool event_thread_run;
+static int exit_pipe[2] = {-1, -1};
+
+#if LV_USE_HW_CURSOR
+static drm_buf_t cursor_buf;
+static uint32_t cursor_w;
+static uint32_t cursor_h;
+static bool cursor_on;
+static bool cursor_dirty;           /*Set or hide it when the mode is set*/
+static lv_coord_t cursor_x;
+static lv_coord_t cursor_y;
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Open the device, pick a connected connector with its preferred mode and create the buffers
+ * @return true: ready; false: the device can't be used (see the printed error)
+ */
+bool drm_init(void)
+{
+    drm_fd = open(DRM_CARD, O_RDWR | O_CLOEXEC);
+    if(drm_fd < 0) {
+        perror("drm: cannot open " DRM_CARD);
+        return false;
+    }
+
+    if(drmSetClientCap(drm_fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) != 0 ||
+            drmSetClientCap(drm_fd, DRM_CLIENT_CAP_ATOMIC, 1) != 0) {
+        fprintf(stderr, "drm: atomic modesetting is not supported by the device\n");
+        drm_exit();
+        return false;
+    }
+
+    if(!drm_find_output() || !drm_find_plane() || !drm_props_init()) {
+        drm_exit();
+        return false;
+    }
+
+    if(drmModeCreatePropertyBlob(drm_fd, &mode, sizeof(mode), &mode_blob) != 0) {
+        perror("drm: mode blob");
+        drm_exit();
+        return false;
+    }
+
+    if(!drm_buf_create(&bufs[0], mode.hdisplay, mode.vdisplay, DRM_PX_BPP, DRM_PX_FORMAT)) {
+        drm_exit();
+        return false;
+    }
+    buf_cnt = 1;
+
+    /*LittlevGL can draw into the buffers only if their lines aren't padded*/
+    if(DRM_PX_NATIVE && bufs[0].pitch == (uint32_t)mode.hdisplay * (DRM_PX_BPP / 8)) {
+        while(buf_cnt < DRM_BUF_CNT &&
+              drm_buf_create(&bufs[buf_cnt], mode.hdisplay, mode.vdisplay, DRM_PX_BPP, DRM_PX_FORMAT)) {
+            buf_cnt++;
+        }
+        direct = buf_cnt >= 2;
+    }
+
+    if(pipe(exit_pipe) != 0 || pthread_create(&event_thread, NULL, drm_event_main, NULL) != 0) {
+        perror("drm: event thread");
+        drm_exit();
+        return false;
+    }
+    event_thread_run = true;
+
+    printf("drm: %dx%d@%dHz, %d buffers, %s, %s\n", mode.hdisplay, mode.vdisplay, mode.vrefresh, buf_cnt,
+           direct ? "page flips" : "the areas are copied", plane_prop_damage ? "damage clips" : "no damage clips");
+
+    /*Without page flips the areas are copied into the first buffer: show it*/
+    if(!direct) {
+        pthread_mutex_lock(&flip_mutex);
+        drm_flip_push(0, false, 0);
+        pthread_mutex_unlock(&flip_mutex);
+    }
+
+    return true;
+}
+
+/**
+ * Release the buffers and close the device
+ */
+void drm_exit(void)
+{
+    if(event_thread_run) {
+        if(write(exit_pipe[1], "", 1) != 1) perror("drm: stop the event thread");
+        pthread_join(event_thread, NULL);
+        event_thread_run = false;
+    }
+    if(exit_pipe[0] >= 0) close(exit_pipe[0]);
+    if(exit_pipe[1] >= 0) close(exit_pipe[1]);
+    exit_pipe[0] = -1;
+    exit_pipe[1] = -1;
+
+#if LV_USE_HW_CURSOR
+    if(cursor_on && flip_done) drmModeSetCursor(drm_fd, crtc_id, 0, 0, 0);
+    drm_buf_destroy(&cursor_buf);
+    cursor_on    = false;
+    cursor_dirty = false;
+#endif
+
+    uint8_t i;
+    for(i = 0; i < DRM_BUF_CNT; i++) drm_buf_destroy(&bufs[i]);
+    buf_cnt = 0;
+    direct  = false;
+
+    if(mode_blob) drmModeDestroyPropertyBlob(drm_fd, mode_blob);
+    mode_blob = 0;
+
+    if(drm_fd >= 0) close(drm_fd);
+    drm_fd = -1;
+
+    flip_cnt     = 0;
+    flip_pending = false;
+    modeset_done = false;
+    flip_done    = false;
+}
+
+/**
+ * Get the resolution of the selected mode
+ * @param hor_res store the horizontal resolution here
+ * @param ver_res store the vertical resolution here
+ */
+void drm_get_sizes(lv_coord_t * hor_res, lv_coord_t * ver_res)
+{
+    *hor_res = mode.hdisplay;
+    *ver_res = mode.vdisplay;
+}
+
+/**
+ * Get the buffers LittlevGL can draw into directly,
+ * to give them to `lv_disp_buf_init_chain` or `lv_disp_buf_init` (if only 2).
+ * @param dest store the addresses of the buffers here
+ * @param cnt max. number of buffers to store
+ * @return number of buffers stored; 0: their format or line length isn't LittlevGL's, draw into
+ *         an other buffer and the flushed areas will be copied
+ */
+uint8_t drm_get_bufs(void * dest[], uint8_t cnt)
+{
+    if(!direct) return 0;
+
+    uint8_t i;
+    for(i = 0; i < cnt && i < buf_cnt; i++) dest[i] = bufs[i].map;
+    return i;
+}
+
+/**
+ * Flush a buffer to the marked area.
+ * One of the buffers of `drm_get_bufs`: page flip to it; other buffers: copy the area.
+ * @param drv pointer to the display driver
+ * @param area the area to refresh
+ * @param color_p an array of colors
+ */
+void drm_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    if(drm_fd < 0) {
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    uint8_t i;
+    for(i = 0; i < buf_cnt; i++) {
+        if(direct && (uint8_t *)color_p == bufs[i].map) break;
+    }
+
+    /*Not drawn into a buffer of the device*/
+    if(i == buf_cnt) {
+        drm_copy(area, color_p);
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    /*`lv_disp_flush_ready` is called from the event thread when the buffer is shown*/
+    flush_drv         = drv;
+    uint32_t dmg_blob = drm_damage_blob();
+
+    pthread_mutex_lock(&flip_mutex);
+    drm_flip_push(i, true, dmg_blob);
+    pthread_mutex_unlock(&flip_mutex);
+}
+
+#if LV_USE_HW_CURSOR
+/**
+ * Show an image as the cursor of the CRTC instead of drawing it. Use it as `cursor_set_cb`.
+ * @param drv pointer to the display driver
+ * @param img a true color image, NULL: hide the cursor
+ * @return true: the image is the cursor; false: the device has no cursor or the image is too large for it
+ */
+bool drm_cursor_set(lv_disp_drv_t * drv, const lv_img_dsc_t * img)
+{
+    if(drm_fd < 0) return false;
+
+    pthread_mutex_lock(&flip_mutex);
+    bool ok = img ? drm_cursor_load(drv, img) : true;
+    cursor_on    = img && ok;
+    cursor_dirty = true;
+
+    /*Before the mode is set it's applied by the first page flip*/
+    if(flip_done) drm_cursor_apply();
+    pthread_mutex_unlock(&flip_mutex);
+
+    return ok;
+}
+
+/**
+ * Move the cursor of the CRTC. Use it as `cursor_move_cb`.
+ * @param drv pointer to the display driver
+ * @param x new x coordinate of the top left corner of the image
+ * @param y new y coordinate of the top left corner of the image
+ */
+void drm_cursor_move(lv_disp_drv_t * drv, lv_coord_t x, lv_coord_t y)
+{
+    (void)drv; /*Unused*/
+
+    pthread_mutex_lock(&flip_mutex);
+    cursor_x = x;
+    cursor_y = y;
+    if(cursor_on && flip_done && !cursor_dirty) drmModeMoveCursor(drm_fd, crtc_id, x, y);
+    pthread_mutex_unlock(&flip_mutex);
+}
+#endif
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Find a connected connector (`DRM_CONNECTOR_ID` or the first one), its preferred mode and a CRTC for it
+ * @return true: found
+ */
+static bool drm_find_output(void)
+{
+    drmModeRes * res = drmModeGetResources(drm_fd);
+    if(res == NULL) {
+        perror("drm: drmModeGetResources");
+        return false;
+    }
+
+    drmModeConnector * conn = NULL;
+    int i;
+    for(i = 0; i < res->count_connectors; i++) {
+        conn = drmModeGetConnector(drm_fd, res->connectors[i]);
+        if(conn && conn->connection == DRM_MODE_CONNECTED && conn->count_modes > 0 &&
+                (DRM_CONNECTOR_ID < 0 || conn->connector_id == (uint32_t)DRM_CONNECTOR_ID)) break;
+        drmModeFreeConnector(conn);
+        conn = NULL;
+    }
+
+    if(conn == NULL) {
+        fprintf(stderr, "drm: no connected display\n");
+        drmModeFreeResources(res);
+        return false;
+    }
+
+    conn_id = conn->connector_id;
+    mode    = conn->modes[0];
+    for(i = 0; i < conn->count_modes; i++) {
+        if(conn->modes[i].type & DRM_MODE_TYPE_PREFERRED) {
+            mode = conn->modes[i];
+            break;
+        }
+    }
+
+    /*Keep the CRTC driving the connector or take one its encoders can use*/
+    crtc_id = 0;
+    drmModeEncoder * enc = conn->encoder_id ? drmModeGetEncoder(drm_fd, conn->encoder_id) : NULL;
+    if(enc) {
+        crtc_id = enc->crtc_id;
+        drmModeFreeEncoder(enc);
+    }
+
+    int e;
+    for(e = 0; e < conn->count_encoders && crtc_id == 0; e++) {
+        enc = drmModeGetEncoder(drm_fd, conn->encoders[e]);
+        if(enc == NULL) continue;
+        for(i = 0; i < res->count_crtcs; i++) {
+            if(enc->possible_crtcs & (1 << i)) {
+                crtc_id = res->crtcs[i];
+                break;
+            }
+        }
+        drmModeFreeEncoder(enc);
+    }
+
+    for(i = 0; i < res->count_crtcs; i++) {
+        if(res->crtcs[i] == crtc_id) crtc_idx = i;
+    }
+
+    drmModeFreeConnector(conn);
+    drmModeFreeResources(res);
+
+    if(crtc_id == 0) {
+        fprintf(stderr, "drm: no CRTC for the display\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Find the primary plane of the CRTC
+ * @return true: found
+ */
+static bool drm_find_plane(void)
+{
+    drmModePlaneRes * planes = drmModeGetPlaneResources(drm_fd);
+    if(planes == NULL) {
+        perror("drm: drmModeGetPlaneResources");
+        return false;
+    }
+
+    plane_id = 0;
+    uint32_t i;
+    for(i = 0; i < planes->count_planes && plane_id == 0; i++) {
+        drmModePlane * plane = drmModeGetPlane(drm_fd, planes->planes[i]);
+        if(plane == NULL) continue;
+
+        uint64_t type;
+        if((plane->possible_crtcs & (1 << crtc_idx)) &&
+                drm_prop_find(plane->plane_id, DRM_MODE_OBJECT_PLANE, "type", &type) && type == DRM_PLANE_TYPE_PRIMARY) {
+            plane_id = plane->plane_id;
+        }
+        drmModeFreePlane(plane);
+    }
+    drmModeFreePlaneResources(planes);
+
+    if(plane_id == 0) {
+        fprintf(stderr, "drm: no primary plane for the CRTC\n");
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Look up the properties set in the commits
+ * @return true: all the needed properties exist
+ */
+static bool drm_props_init(void)
+{
+    drm_prop_req_t reqs[] = {
+        {&conn_prop_crtc_id, conn_id, DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID"},
+        {&crtc_prop_mode_id, crtc_id, DRM_MODE_OBJECT_CRTC, "MODE_ID"},
+        {&crtc_prop_active, crtc_id, DRM_MODE_OBJECT_CRTC, "ACTIVE"},
+        {&plane_prop_fb_id, plane_id, DRM_MODE_OBJECT_PLANE, "FB_ID"},
+        {&plane_prop_crtc_id, plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_ID"},
+        {&plane_prop_src[0], plane_id, DRM_MODE_OBJECT_PLANE, "SRC_X"},
+        {&plane_prop_src[1], plane_id, DRM_MODE_OBJECT_PLANE, "SRC_Y"},
+        {&plane_prop_src[2], plane_id, DRM_MODE_OBJECT_PLANE, "SRC_W"},
+        {&plane_prop_src[3], plane_id, DRM_MODE_OBJECT_PLANE, "SRC_H"},
+        {&plane_prop_crtc[0], plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_X"},
+        {&plane_prop_crtc[1], plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_Y"},
+        {&plane_prop_crtc[2], plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_W"},
+        {&plane_prop_crtc[3], plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_H"},
+    };
+
+    uint32_t i;
+    for(i = 0; i < sizeof(reqs) / sizeof(reqs[0]); i++) {
+        *reqs[i].id = drm_prop_find(reqs[i].obj_id, reqs[i].obj_type, reqs[i].name, NULL);
+        if(*reqs[i].id == 0) {
+            fprintf(stderr, "drm: no %s property\n", reqs[i].name);
+            return false;
+        }
+    }
+
+    /*Optional, since Linux 5.0*/
+    plane_prop_damage = drm_prop_find(plane_id, DRM_MODE_OBJECT_PLANE, "FB_DAMAGE_CLIPS", NULL);
+
+    return true;
+}
+
+/**
+ * Find a property of a DRM object by its name
+ * @param obj_id ID of the object
+ * @param obj_type `DRM_MODE_OBJECT_...`
+ * @param name name of the property
+ * @param value store the current value of the property here (can be NULL)
+ * @return ID of the property or 0 if not found
+ */
+static uint32_t drm_prop_find(uint32_t obj_id, uint32_t obj_type, const char * name, uint64_t * value)
+{
+    drmModeObjectProperties * props = drmModeObjectGetProperties(drm_fd, obj_id, obj_type);
+    if(props == NULL) return 0;
+
+    uint32_t id = 0;
+    uint32_t i;
+    for(i = 0; i < props->count_props && id == 0; i++) {
+        drmModePropertyRes * prop = drmModeGetProperty(drm_fd, props->props[i]);
+        if(prop == NULL) continue;
+
+        if(strcmp(prop->name, name) == 0) {
+            id = prop->prop_id;
+            if(value) *value = props->prop_values[i];
+        }
+        drmModeFreeProperty(prop);
+    }
+    drmModeFreeObjectProperties(props);
+
+    return id;
+}
+
+/**
+ * Create a dumb buffer, add it as a framebuffer and map it
+ * @param buf store the buffer here
+ * @param w width in pixels
+ * @param h height in pixels
+ * @param bpp bits per pixel
+ * @param format fourcc format of the framebuffer
+ * @return true: created; false: failed and nothing is left allocated
+ */
+static bool drm_buf_create(drm_buf_t * buf, uint32_t w, uint32_t h, uint32_t bpp, uint32_t format)
+{
+    struct drm_mode_create_dumb creq;
+    memset(&creq, 0, sizeof(creq));
+    creq.width  = w;
+    creq.height = h;
+    creq.bpp    = bpp;
+    if(drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &creq) != 0) {
+        perror("drm: create dumb buffer");
+        return false;
+    }
+    buf->handle = creq.handle;
+    buf->pitch  = creq.pitch;
+    buf->size   = creq.size;
+
+    uint32_t handles[4] = {buf->handle};
+    uint32_t pitches[4] = {buf->pitch};
+    uint32_t offsets[4] = {0};
+    if(drmModeAddFB2(drm_fd, w, h, format, handles, pitches, offsets, &buf->fb_id, 0) != 0) {
+        perror("drm: add framebuffer");
+        drm_buf_destroy(buf);
+        return false;
+    }
+
+    struct drm_mode_map_dumb mreq;
+    memset(&mreq, 0, sizeof(mreq));
+    mreq.handle = buf->handle;
+    if(drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &mreq) != 0) {
+        perror("drm: map dumb buffer");
+        drm_buf_destroy(buf);
+        return false;
+    }
+
+    buf->map = mmap(NULL, buf->size, PROT_READ | PROT_WRITE, MAP_SHARED, drm_fd, mreq.offset);
+    if(buf->map == MAP_FAILED) {
+        perror("drm: mmap");
+        buf->map = NULL;
+        drm_buf_destroy(buf);
+        return false;
+    }
+    memset(buf->map, 0, buf->size);
+
+    return true;
+}
+
+/**
+ * Unmap and free a buffer created by `drm_buf_create`
+ * @param buf pointer to the buffer
+ */
+static void drm_buf_destroy(drm_buf_t * buf)
+{
+    if(buf->map) munmap(buf->map, buf->size);
+    if(buf->fb_id) drmModeRmFB(drm_fd, buf->fb_id);
+    if(buf->handle) {
+        struct drm_mode_destroy_dumb dreq;
+        memset(&dreq, 0, sizeof(dreq));
+        dreq.handle = buf->handle;
+        drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+    }
+    memset(buf, 0, sizeof(drm_buf_t));
+}
+
+/**
+ * Make a damage clips blob from the areas refreshed in this frame.
+ * Call it in the `flush_cb` of a full frame.
+ * @return ID of the blob, 0: the whole screen is damaged or the plane has no damage clips
+ */
+static uint32_t drm_damage_blob(void)
+{
+    if(plane_prop_damage == 0) return 0;
+
+    lv_disp_t * disp = lv_refr_get_disp_refreshing();
+    if(disp == NULL) return 0;
+
+    struct drm_mode_rect rects[DRM_DAMAGE_MAX];
+    uint32_t rect_cnt = 0;
+    uint32_t i;
+    for(i = 0; i <= disp->inv_p; i++) {
+        const lv_area_t * a;
+        if(i < disp->inv_p) {
+            if(disp->inv_area_joined[i]) continue;
+            a = &disp->inv_areas[i];
+        } else {
+#if LV_USE_SCROLL_BLIT
+            /*The moved pixels are changed too*/
+            if(disp->scroll_act == 0) continue;
+            a = &disp->scroll_area;
+#else
+            continue;
+#endif
+        }
+
+        if(rect_cnt == DRM_DAMAGE_MAX) return 0;
+        rects[rect_cnt].x1 = a->x1;
+        rects[rect_cnt].y1 = a->y1;
+        rects[rect_cnt].x2 = a->x2 + 1;
+        rects[rect_cnt].y2 = a->y2 + 1;
+        rect_cnt++;
+    }
+
+    uint32_t blob = 0;
+    if(rect_cnt == 0) return 0;
+    if(drmModeCreatePropertyBlob(drm_fd, rects, rect_cnt * sizeof(rects[0]), &blob) != 0) return 0;
+
+    return blob;
+}
+
+/**
+ * Copy an area into the shown buffer and tell the device that it changed
+ * @param area the area on the screen
+ * @param color_p the pixels of the area
+ */
+static void drm_copy(const lv_area_t * area, const lv_color_t * color_p)
+{
+    drm_buf_t * buf = &bufs[buf_shown];
+
+    if(area->x2 < 0 || area->y2 < 0 || area->x1 > mode.hdisplay - 1 || area->y1 > mode.vdisplay - 1) return;
+
+    /*Truncate the area to the screen*/
+    int32_t act_x1 = area->x1 < 0 ? 0 : area->x1;
+    int32_t act_y1 = area->y1 < 0 ? 0 : area->y1;
+    int32_t act_x2 = area->x2 > mode.hdisplay - 1 ? mode.hdisplay - 1 : area->x2;
+    int32_t act_y2 = area->y2 > mode.vdisplay - 1 ? mode.vdisplay - 1 : area->y2;
+
+    lv_coord_t w = lv_area_get_width(area);
+    int32_t y;
+    for(y = act_y1; y <= act_y2; y++) {
+        const lv_color_t * src = color_p + (y - area->y1) * w + (act_x1 - area->x1);
+        uint8_t * dest         = buf->map + y * buf->pitch + act_x1 * (DRM_PX_BPP / 8);
+#if DRM_PX_NATIVE
+        memcpy(dest, src, (act_x2 - act_x1 + 1) * sizeof(lv_color_t));
+#else
+        uint32_t * dest32 = (uint32_t *)dest;
+        int32_t x;
+        for(x = act_x1; x <= act_x2; x++) {
+            *dest32 = lv_color_to32(*src);
+            dest32++;
+            src++;
+        }
+#endif
+    }
+
+    /*The devices which upload the changes (e.g. over USB or SPI) need to know about them*/
+    drmModeClip clip;
+    clip.x1 = act_x1;
+    clip.y1 = act_y1;
+    clip.x2 = act_x2 + 1;
+    clip.y2 = act_y2 + 1;
+    drmModeDirtyFB(drm_fd, buf->fb_id, &clip, 1);
+}
+
+/**
+ * Queue a buffer to show and commit it if no flip is pending. Call it with `flip_mutex` locked.
+ * @param buf index of the buffer
+ * @param flushed true: call `lv_disp_flush_ready` when it's shown
+ * @param dmg_blob damage clips of the frame, 0: the whole screen
+ */
+static void drm_flip_push(uint8_t buf, bool flushed, uint32_t dmg_blob)
+{
+    /*LittlevGL doesn't flush a buffer again before it's shown, so the queue can't be full*/
+    drm_flip_t * f = &flip_queue[(flip_rd + flip_cnt) % DRM_BUF_CNT];
+    f->buf      = buf;
+    f->flushed  = flushed ? 1 : 0;
+    f->dmg_blob = dmg_blob;
+    flip_cnt++;
+
+    if(!flip_pending) drm_flip_next();
+}
+
+/**
+ * Commit the next queued buffer. Call it with `flip_mutex` locked.
+ * The frames which can't be committed are dropped.
+ */
+static void drm_flip_next(void)
+{
+    while(flip_cnt > 0) {
+        drm_flip_t f = flip_queue[flip_rd];
+        flip_rd = (flip_rd + 1) % DRM_BUF_CNT;
+        flip_cnt--;
+
+        bool ok = drm_commit(f.buf, f.dmg_blob);
+
+        /*The commit holds its own reference to the blob*/
+        if(f.dmg_blob) drmModeDestroyPropertyBlob(drm_fd, f.dmg_blob);
+
+        if(ok) {
+            flip_act     = f;
+            flip_pending = true;
+            return;
+        }
+
+        perror("drm: atomic commit");
+        dmg_lost = true;
+        if(f.flushed) lv_disp_flush_ready(flush_drv);
+    }
+}
+
+/**
+ * Show a buffer with a non-blocking atomic commit. The first one sets the mode too.
+ * @param buf index of the buffer
+ * @param dmg_blob damage clips of the frame, 0: the whole screen
+ * @return true: committed, a page flip event will arrive
+ */
+static bool drm_commit(uint8_t buf, uint32_t dmg_blob)
+{
+    drmModeAtomicReq * req = drmModeAtomicAlloc();
+    if(req == NULL) return false;
+
+    uint32_t flags = DRM_MODE_PAGE_FLIP_EVENT | DRM_MODE_ATOMIC_NONBLOCK;
+    if(!modeset_done) {
+        drmModeAtomicAddProperty(req, conn_id, conn_prop_crtc_id, crtc_id);
+        drmModeAtomicAddProperty(req, crtc_id, crtc_prop_mode_id, mode_blob);
+        drmModeAtomicAddProperty(req, crtc_id, crtc_prop_active, 1);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_crtc_id, crtc_id);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_src[0], 0);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_src[1], 0);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_src[2], (uint64_t)mode.hdisplay << 16);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_src[3], (uint64_t)mode.vdisplay << 16);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_crtc[0], 0);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_crtc[1], 0);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_crtc[2], mode.hdisplay);
+        drmModeAtomicAddProperty(req, plane_id, plane_prop_crtc[3], mode.vdisplay);
+        flags |= DRM_MODE_ATOMIC_ALLOW_MODESET;
+    }
+
+    drmModeAtomicAddProperty(req, plane_id, plane_prop_fb_id, bufs[buf].fb_id);
+    if(plane_prop_damage) drmModeAtomicAddProperty(req, plane_id, plane_prop_damage, dmg_lost ? 0 : dmg_blob);
+
+    int res = drmModeAtomicCommit(drm_fd, req, flags, NULL);
+    drmModeAtomicFree(req);
+    if(res != 0) return false;
+
+    modeset_done = true;
+    dmg_lost     = false;
+    return true;
+}
+
+/**
+ * Called by `drmHandleEvent` on the event thread when a committed buffer is shown
+ */
+static void drm_flip_handler(int fd, unsigned int sequence, unsigned int tv_sec, unsigned int tv_usec, void * user_data)
+{
+    (void)fd;
+    (void)sequence;
+    (void)tv_sec;
+    (void)tv_usec;
+    (void)user_data;
+
+    pthread_mutex_lock(&flip_mutex);
+    flip_pending = false;
+    flip_done    = true;
+    buf_shown    = flip_act.buf;
+
+#if LV_USE_HW_CURSOR
+    if(cursor_dirty) drm_cursor_apply();
+#endif
+
+    /*The buffer shown before is free now*/
+    if(flip_act.flushed) lv_disp_flush_ready(flush_drv);
+
+    drm_flip_next();
+    pthread_mutex_unlock(&flip_mutex);
+}
+
+/**
+ * Wait for the events of the device until `drm_exit`
+ */
+static void * drm_event_main(void * param)
+{
+    (void)param;
+
+    drmEventContext ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.version           = 2;
+    ev.page_flip_handler = drm_flip_handler;
+
+    struct pollfd pfds[2];
+    pfds[0].fd     = drm_fd;
+    pfds[0].events = POLLIN;
+    pfds[1].fd     = exit_pipe[0];
+    pfds[1].events = POLLIN;
+
+    while(1) {
+        int n = poll(pfds, 2, -1);
+        if(n < 0) {
+            if(errno == EINTR) continue;
+            perror("drm: poll");
+            break;
+        }
+
+        if(pfds[1].revents) break;
+        if(pfds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+            fprintf(stderr, "drm: the device is gone\n");
+            break;
+        }
+        if(pfds[0].revents & POLLIN) drmHandleEvent(drm_fd, &ev);
+    }
+
+    return NULL;
+}
+
+#if LV_USE_HW_CURSOR
+/**
+ * Convert an image into the cursor buffer (created with the size the device needs). Call it with `flip_mutex` locked.
+ * @param drv pointer to the display driver (for the chroma key)
+ * @param img a true color image
+ * @return true: loaded; false: the device has no cursor or the image is larger than it
+ */
+static bool drm_cursor_load(lv_disp_drv_t * drv, const lv_img_dsc_t * img)
+{
+    if(cursor_buf.handle == 0) {
+        uint64_t w = 0;
+        uint64_t h = 0;
+        if(drmGetCap(drm_fd, DRM_CAP_CURSOR_WIDTH, &w) != 0 || drmGetCap(drm_fd, DRM_CAP_CURSOR_HEIGHT, &h) != 0) {
+            w = 64;
+            h = 64;
+        }
+        if(!drm_buf_create(&cursor_buf, w, h, 32, DRM_FORMAT_ARGB8888)) return false;
+        cursor_w = w;
+        cursor_h = h;
+    }
+
+    if(img->header.w > cursor_w || img->header.h > cursor_h) return false;
+
+    /*ARGB8888, the rest of the buffer is transparent*/
+    memset(cursor_buf.map, 0, cursor_buf.size);
+    lv_img_dsc_t * dsc = (lv_img_dsc_t *)img;
+    uint32_t key       = lv_color_to32(drv->color_chroma_key) & 0xFFFFFF;
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = 0; y < (lv_coord_t)img->header.h; y++) {
+        uint32_t * px = (uint32_t *)(cursor_buf.map + y * cursor_buf.pitch);
+        for(x = 0; x < (lv_coord_t)img->header.w; x++) {
+            uint32_t c = lv_color_to32(lv_img_buf_get_px_color(dsc, x, y, NULL)) & 0xFFFFFF;
+            lv_opa_t a = lv_img_buf_get_px_alpha(dsc, x, y);
+            if(img->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && c == key) a = LV_OPA_TRANSP;
+
+            /*Premultiplied like every plane by default*/
+            px[x] = ((uint32_t)a << 24) | ((((c >> 16) & 0xFF) * a / 255) << 16) | ((((c >> 8) & 0xFF) * a / 255) << 8) |
+                    ((c & 0xFF) * a / 255);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Set or hide the cursor of the CRTC after the mode is set. Call it with `flip_mutex` locked.
+ */
+static void drm_cursor_apply(void)
+{
+    cursor_dirty = false;
+
+    int res;
+    if(cursor_on) {
+        res = drmModeSetCursor2(drm_fd, crtc_id, cursor_buf.handle, cursor_w, cursor_h, 0, 0);
+        if(res == 0) res = drmModeMoveCursor(drm_fd, crtc_id, cursor_x, cursor_y);
+    } else {
+        res = drmModeSetCursor(drm_fd, crtc_id, 0, 0, 0);
+    }
+
+    if(res != 0) perror("drm: cursor");
+}
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file drm.h
+ * Linux DRM/KMS display (/dev/dri/cardX) with atomic page flips. Needs libdrm
+ * (`-I/usr/include/libdrm -ldrm`) and a kernel with atomic modesetting.
+ *
+ * LittlevGL draws straight into the dumb buffers of the device and they are shown by page flips
+ * synchronized to the vertical blanking. `lv_disp_flush_ready` is called from the event thread of
+ * the driver when the flip happened. The refreshed areas are passed to the kernel as damage clips
+ * (`FB_DAMAGE_CLIPS`) if the plane supports them, so only those are uploaded or composited.
+ *
+ *     drm_init();
+ *     drm_get_sizes(&disp_drv.hor_res, &disp_drv.ver_res);
+ *     void * bufs[DRM_BUF_CNT];
+ *     uint8_t buf_cnt = drm_get_bufs(bufs, DRM_BUF_CNT);
+ *     if(buf_cnt) lv_disp_buf_init_chain(&disp_buf, bufs, buf_cnt, hor_res * ver_res);
+ *     else lv_disp_buf_init(&disp_buf, own_buf, NULL, own_buf_px_cnt);
+ *     disp_drv.flush_cb = drm_flush;
+ *     disp_drv.cursor_set_cb = drm_cursor_set;        (with LV_USE_HW_CURSOR)
+ *     disp_drv.cursor_move_cb = drm_cursor_move;
+ *
+ * Without screen sized buffers of the native format the flushed areas are copied into the shown buffer.
+ */
+
+#ifndef DRM_H
+#define DRM_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_DRM
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Open the device, pick a connected connector with its preferred mode and create the buffers
+ * @return true: ready; false: the device can't be used (see the printed error)
+ */
+bool drm_init(void);
+
+/**
+ * Release the buffers and close the device
+ */
+void drm_exit(void);
+
+/**
+ * Get the resolution of the selected mode
+ * @param hor_res store the horizontal resolution here
+ * @param ver_res store the vertical resolution here
+ */
+void drm_get_sizes(lv_coord_t * hor_res, lv_coord_t * ver_res);
+
+/**
+ * Get the buffers LittlevGL can draw into directly,
+ * to give them to `lv_disp_buf_init_chain` or `lv_disp_buf_init` (if only 2).
+ * @param dest store the addresses of the buffers here
+ * @param cnt max. number of buffers to store
+ * @return number of buffers stored; 0: their format or line length isn't LittlevGL's, draw into
+ *         an other buffer and the flushed areas will be copied
+ */
+uint8_t drm_get_bufs(void * dest[], uint8_t cnt);
+
+/**
+ * Flush a buffer to the marked area.
+ * One of the buffers of `drm_get_bufs`: page flip to it; other buffers: copy the area.
+ * @param drv pointer to the display driver
+ * @param area the area to refresh
+ * @param color_p an array of colors
+ */
+void drm_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+
+#if LV_USE_HW_CURSOR
+/**
+ * Show an image as the cursor of the CRTC instead of drawing it. Use it as `cursor_set_cb`.
+ * @param drv pointer to the display driver
+ * @param img a true color image, NULL: hide the cursor
+ * @return true: the image is the cursor; false: the device has no cursor or the image is too large for it
+ */
+bool drm_cursor_set(lv_disp_drv_t * drv, const lv_img_dsc_t * img);
+
+/**
+ * Move the cursor of the CRTC. Use it as `cursor_move_cb`.
+ * @param drv pointer to the display driver
+ * @param x new x coordinate of the top left corner of the image
+ * @param y new y coordinate of the top left corner of the image
+ */
+void drm_cursor_move(lv_disp_drv_t * drv, lv_coord_t x, lv_coord_t y);
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif  /*USE_DRM*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*DRM_H*/
@@ -13,11 +13,11 @@
 #include <unistd.h>
 #include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 #include <fcntl.h>
 #include <linux/fb.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
-#include "lvgl/lv_core/lv_vdb.h"
 
 /*********************
  *      DEFINES
@@ -26,6 +26,13 @@
 #define FBDEV_PATH  "/dev/fb0"
 #endif
 
+#ifndef FBDEV_DOUBLE_BUF
+#define FBDEV_DOUBLE_BUF  0
+#endif
+
+/*LittlevGL's colors can be copied as they are to a framebuffer with `LV_COLOR_DEPTH` bits per pixel*/
+#define FBDEV_NATIVE_FORMAT (LV_COLOR_DEPTH == 32 || (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0))
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -33,6 +40,9 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if FBDEV_DOUBLE_BUF
+static bool fbdev_double_buf_init(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -42,6 +52,7 @@ static struct fb_fix_screeninfo finfo;
 static char * fbp = 0;
 static long int screensize = 0;
 static int fbfd = 0;
+static bool double_buf = false;    /*LittlevGL draws into the two halves of a double height framebuffer*/
 
 /**********************
  *      MACROS
@@ -75,13 +86,21 @@ void fbdev_init(void)
 
     printf("%dx%d, %dbpp\n", vinfo.xres, vinfo.yres, vinfo.bits_per_pixel);
 
+#if FBDEV_DOUBLE_BUF
+    // Ask for a double height virtual screen to flip between its halves
+    double_buf = fbdev_double_buf_init();
+    printf("Double buffering with panning: %s\n", double_buf ? "yes" : "not supported, the areas are copied");
+#endif
+
     // Figure out the size of the screen in bytes
-    screensize =  finfo.line_length * vinfo.yres;
+    screensize =  finfo.line_length * (double_buf ? vinfo.yres_virtual : vinfo.yres);
 
     // Map the device to memory
     fbp = (char *)mmap(0, screensize, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
     if((intptr_t)fbp == -1) {
         perror("Error: failed to map framebuffer device to memory");
+        fbp = NULL;
+        double_buf = false;
         return;
     }
     printf("The framebuffer device was mapped to memory successfully.\n");
@@ -93,22 +112,58 @@ void fbdev_exit(void)
     close(fbfd);
 }
 
+/**
+ * Get the halves of the double height framebuffer to use them as LittlevGL's display buffers:
+ * `lv_disp_buf_init(&disp_buf, buf1, buf2, hor_res * ver_res)`.
+ * LittlevGL draws directly into them, `fbdev_flush` only shows the drawn one.
+ * @param buf1 store the address of the first (visible) half here
+ * @param buf2 store the address of the second half here
+ * @return false: the double buffering is not enabled (`FBDEV_DOUBLE_BUF`) or the device doesn't support it
+ */
+bool fbdev_get_double_buf(lv_color_t ** buf1, lv_color_t ** buf2)
+{
+    if(double_buf == false) return false;
+
+    *buf1 = (lv_color_t *)fbp;
+    *buf2 = (lv_color_t *)(fbp + finfo.line_length * vinfo.yres);
+    return true;
+}
+
 /**
  * Flush a buffer to the marked area
- * @param x1 left coordinate
- * @param y1 top coordinate
- * @param x2 right coordinate
- * @param y2 bottom coordinate
+ * @param drv pointer to the display driver
+ * @param area the area to refresh
  * @param color_p an array of colors
  */
-void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p)
+void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
 {
+    /*LittlevGL has drawn into a half of the framebuffer: just show it.
+     *The changes are copied to the other half by LittlevGL.*/
+    if(double_buf && ((char *)color_p == fbp || (char *)color_p == fbp + finfo.line_length * vinfo.yres)) {
+        vinfo.yoffset = (char *)color_p == fbp ? 0 : vinfo.yres;
+        if(ioctl(fbfd, FBIOPAN_DISPLAY, &vinfo) == -1) {
+            perror("Error panning the display");
+        }
+#ifdef FBIO_WAITFORVSYNC
+        // Don't let the next frame be drawn into the buffer which is still displayed
+        uint32_t crtc = 0;
+        ioctl(fbfd, FBIO_WAITFORVSYNC, &crtc);
+#endif
+        lv_disp_flush_ready(drv);
+        return;
+    }
+
+    int32_t x1 = area->x1;
+    int32_t y1 = area->y1;
+    int32_t x2 = area->x2;
+    int32_t y2 = area->y2;
+
     if(fbp == NULL ||
             x2 < 0 ||
             y2 < 0 ||
             x1 > (int32_t)vinfo.xres - 1 ||
             y1 > (int32_t)vinfo.yres - 1) {
-        lv_flush_ready();
+        lv_disp_flush_ready(drv);
         return;
     }
 
@@ -122,19 +177,33 @@ void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
     long int byte_location = 0;
     unsigned char bit_location = 0;
 
+    /*Skip the part of the lines left of the screen*/
+    color_p += act_x1 - x1;
+    color_p += (act_y1 - y1) * (x2 - x1 + 1);
+
+    /*The same format as LittlevGL's: copy whole lines*/
+    if(FBDEV_NATIVE_FORMAT && vinfo.bits_per_pixel == LV_COLOR_DEPTH) {
+        uint32_t px_size = LV_COLOR_DEPTH / 8;
+        size_t line_len = (act_x2 - act_x1 + 1) * px_size;
+        int32_t y;
+        for(y = act_y1; y <= act_y2; y++) {
+            location = (act_x1 + vinfo.xoffset) * px_size + (y + vinfo.yoffset) * finfo.line_length;
+            memcpy(&fbp[location], color_p, line_len);
+            color_p += x2 - x1 + 1;
+        }
+    }
     /*32 or 24 bit per pixel*/
-    if(vinfo.bits_per_pixel == 32 || vinfo.bits_per_pixel == 24) {
+    else if(vinfo.bits_per_pixel == 32 || vinfo.bits_per_pixel == 24) {
         uint32_t * fbp32 = (uint32_t *)fbp;
         int32_t x;
         int32_t y;
         for(y = act_y1; y <= act_y2; y++) {
             for(x = act_x1; x <= act_x2; x++) {
                 location = (x + vinfo.xoffset) + (y + vinfo.yoffset) * finfo.line_length / 4;
-                fbp32[location] = color_p->full;
-                color_p++;
+                fbp32[location] = lv_color_to32(color_p[x - act_x1]);
             }
 
-            color_p += x2 - act_x2;
+            color_p += x2 - x1 + 1;
         }
     }
     /*16 bit per pixel*/
@@ -145,11 +214,10 @@ void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
         for(y = act_y1; y <= act_y2; y++) {
             for(x = act_x1; x <= act_x2; x++) {
                 location = (x + vinfo.xoffset) + (y + vinfo.yoffset) * finfo.line_length / 2;
-                fbp16[location] = color_p->full;
-                color_p++;
+                fbp16[location] = lv_color_to16(color_p[x - act_x1]);
             }
 
-            color_p += x2 - act_x2;
+            color_p += x2 - x1 + 1;
         }
     }
     /*8 bit per pixel*/
@@ -160,11 +228,10 @@ void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
         for(y = act_y1; y <= act_y2; y++) {
             for(x = act_x1; x <= act_x2; x++) {
                 location = (x + vinfo.xoffset) + (y + vinfo.yoffset) * finfo.line_length;
-                fbp8[location] = color_p->full;
-                color_p++;
+                fbp8[location] = lv_color_to8(color_p[x - act_x1]);
             }
 
-            color_p += x2 - act_x2;
+            color_p += x2 - x1 + 1;
         }
     }
     /*1 bit per pixel*/
@@ -178,11 +245,10 @@ void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
                 byte_location = location / 8; /* find the byte we need to change */
                 bit_location = location % 8; /* inside the byte found, find the bit we need to change */
                 fbp8[byte_location] &= ~(((uint8_t)(1)) << bit_location);
-                fbp8[byte_location] |= ((uint8_t)(color_p->full)) << bit_location;
-                color_p++;
+                fbp8[byte_location] |= ((uint8_t)lv_color_to1(color_p[x - act_x1])) << bit_location;
             }
 
-            color_p += x2 - act_x2;
+            color_p += x2 - x1 + 1;
         }
     } else {
         /*Not supported bit per pixel*/
@@ -191,7 +257,7 @@ void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_
     //May be some direct update command is required
     //ret = ioctl(state->fd, FBIO_UPDATE, (unsigned long)((uintptr_t)rect));
 
-    lv_flush_ready();
+    lv_disp_flush_ready(drv);
 }
 
 /**
@@ -376,6 +442,31 @@ void fbdev_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t
  *   STATIC FUNCTIONS
  **********************/
 
+#if FBDEV_DOUBLE_BUF
+/**
+ * Set a double height virtual screen on the device. The LittlevGL's buffers need to have the
+ * same format as the framebuffer (color depth and no padding at the end of the lines).
+ * @return true: the framebuffer has two screens to flip between
+ */
+static bool fbdev_double_buf_init(void)
+{
+    if(!FBDEV_NATIVE_FORMAT || vinfo.bits_per_pixel != LV_COLOR_DEPTH) return false;
+    if(finfo.line_length != vinfo.xres * (LV_COLOR_DEPTH / 8)) return false;
+
+    struct fb_var_screeninfo vinfo_double = vinfo;
+    vinfo_double.yres_virtual = vinfo.yres * 2;
+    vinfo_double.yoffset = 0;
+    vinfo_double.xoffset = 0;
+    if(ioctl(fbfd, FBIOPUT_VSCREENINFO, &vinfo_double) == -1) return false;
+
+    // Read back what the driver really set
+    if(ioctl(fbfd, FBIOGET_VSCREENINFO, &vinfo) == -1) return false;
+    if(ioctl(fbfd, FBIOGET_FSCREENINFO, &finfo) == -1) return false;
+
+    return vinfo.yres_virtual >= vinfo.yres * 2 && finfo.line_length == vinfo.xres * (LV_COLOR_DEPTH / 8);
+}
+#endif
+
 #endif
 
 
@@ -22,7 +22,8 @@ extern "C" {
 #if USE_FBDEV
 
 #include <stdint.h>
-#include "lvgl/lv_misc/lv_color.h"
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
 
 /*********************
  *      DEFINES
@@ -37,7 +38,8 @@ extern "C" {
  **********************/
 void fbdev_init(void);
 void fbdev_exit(void);
-void fbdev_flush(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
+bool fbdev_get_double_buf(lv_color_t ** buf1, lv_color_t ** buf2);
+void fbdev_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
 void fbdev_fill(int32_t x1, int32_t y1, int32_t x2, int32_t y2, lv_color_t color);
 void fbdev_map(int32_t x1, int32_t y1, int32_t x2, int32_t y2, const lv_color_t * color_p);
 
@@ -13,6 +13,7 @@
 #  define MONITOR_SDL_INCLUDE_PATH <SDL2/SDL.h>
 #endif
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
@@ -26,10 +27,29 @@
  *********************/
 #define SDL_REFR_PERIOD     50  /*ms*/
 
+/*Max. number of areas to upload to the texture in a refresh. If there are more they are joined*/
+#define MONITOR_DIRTY_MAX   32
+
+#ifndef MONITOR_MAX_FPS
+#define MONITOR_MAX_FPS     60
+#endif
+
 #ifndef MONITOR_ZOOM
 #define MONITOR_ZOOM        1
 #endif
 
+#ifndef MONITOR_VIEW_MAX
+#define MONITOR_VIEW_MAX    4
+#endif
+
+/*Zoom range of the views and the zoom of a mouse wheel step*/
+#define MONITOR_VIEW_ZOOM_MIN   0.125f
+#define MONITOR_VIEW_ZOOM_MAX   32.0f
+#define MONITOR_VIEW_ZOOM_STEP  1.25f
+
+/*A view window is at most this part of the screen when it opens (the frame is zoomed out to fit)*/
+#define MONITOR_VIEW_SCREEN_PCT 75
+
 #if defined(__APPLE__) && defined(TARGET_OS_MAC)
 #  if __APPLE__ && TARGET_OS_MAC
 #define MONITOR_APPLE
@@ -40,27 +60,108 @@
 #  define MONITOR_EMSCRIPTEN
 #endif
 
+/*Use LittlevGL's pixel format for the texture if SDL has it, so the flushed pixels are only copied*/
+#if LV_COLOR_DEPTH == 16
+#  define MONITOR_PX_FORMAT   SDL_PIXELFORMAT_RGB565
+#else
+#  define MONITOR_PX_FORMAT   SDL_PIXELFORMAT_ARGB8888
+#endif
+
+/*Opacity of the debug colors*/
+#define MONITOR_DEBUG_OPA       LV_OPA_50
+
+/*Flushes remembered to fade out their tints (a power of 2)*/
+#define MONITOR_DEBUG_FLUSH_MAX 256
+
+#if MONITOR_DOUBLE_BUFFERED && !(LV_COLOR_DEPTH == 32 || (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0))
+#error "MONITOR_DOUBLE_BUFFERED needs LV_COLOR_DEPTH 32, or 16 without LV_COLOR_16_SWAP"
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_COLOR_DEPTH == 16
+typedef uint16_t monitor_px_t;
+#else
+typedef uint32_t monitor_px_t;
+#endif
+
 typedef struct {
     SDL_Window * window;
     SDL_Renderer * renderer;
     SDL_Texture * texture;
     volatile bool sdl_refr_qry;
+    SDL_mutex * dirty_mutex;                /*Protects `dirty` and `dirty_cnt`*/
+    lv_area_t dirty[MONITOR_DIRTY_MAX];     /*Flushed areas not uploaded to the texture yet*/
+    uint32_t dirty_cnt;
 #if MONITOR_DOUBLE_BUFFERED
-    uint32_t * tft_fb_act;
+    monitor_px_t * tft_fb_act;
 #else
-    uint32_t tft_fb[LV_HOR_RES_MAX * LV_VER_RES_MAX];
+    monitor_px_t tft_fb[LV_HOR_RES_MAX * LV_VER_RES_MAX];
 #endif
+    monitor_debug_t debug;
+    uint32_t debug_fade;                    /*[ms] to fade out the tints, 0: keep them until the area is flushed again*/
+    uint16_t * debug_px;                    /*ID of the last flush (areas) or drawing count (overdraw) of the pixels*/
+    monitor_px_t * debug_fb;                /*The frame buffer with the debug colors, uploaded instead of the real one*/
+    uint32_t debug_flush_time[MONITOR_DEBUG_FLUSH_MAX]; /*`SDL_GetTicks` of the flushes by ID*/
+    uint16_t debug_flush_id;                /*ID of the last flush, 0: none yet*/
 }monitor_t;
 
+typedef enum {
+    MONITOR_VIEW_FILTER_AUTO,               /*Nearest when zoomed in (to inspect the pixels), linear when zoomed out*/
+    MONITOR_VIEW_FILTER_NEAREST,
+    MONITOR_VIEW_FILTER_LINEAR,
+} monitor_view_filter_t;
+
+struct _monitor_view_t {
+    /*Set by `monitor_view_create`*/
+    char title[64];
+    lv_coord_t hres;
+    lv_coord_t vres;
+    SDL_mutex * mutex;                      /*Protects `fb`, `dirty` and `dirty_any`*/
+    monitor_px_t * fb;
+    lv_area_t dirty;                        /*The updated areas joined, not uploaded to the texture yet*/
+    bool dirty_any;
+    volatile bool refr_qry;
+
+    /*Used only by the SDL thread*/
+    SDL_Window * window;
+    SDL_Renderer * renderer;
+    SDL_Texture * texture;
+    bool texture_linear;                    /*The texture was created with linear filtering*/
+    monitor_view_filter_t filter;
+    float zoom;                             /*Window pixels per frame pixel*/
+    float ox;                               /*Where the frame's top left corner is in the window*/
+    float oy;
+    bool drag;                              /*The frame is being panned with the left button*/
+};
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static int monitor_sdl_refr_thread(void * param);
 static void window_create(monitor_t * m);
 static void window_update(monitor_t * m);
+static void dirty_add(monitor_t * m, const lv_area_t * area);
+static void debug_set(monitor_t * m, monitor_debug_t mode, uint32_t fade);
+static void debug_add(monitor_t * m, const lv_area_t * area);
+static bool debug_compose(monitor_t * m, const monitor_px_t * fb);
+static monitor_px_t debug_px_mix(monitor_px_t px, uint32_t tint, lv_opa_t opa);
+static void px_copy(monitor_px_t * dest, const lv_color_t * src, uint32_t cnt);
+#if MONITOR_DOUBLE_BUFFERED == 0
+static void fb_copy(monitor_t * m, const lv_area_t * area, const lv_color_t * color_p);
+#endif
+static void view_refr(void);
+static void view_open(monitor_view_t * v);
+static void view_present(monitor_view_t * v);
+static void view_fit(monitor_view_t * v);
+static void view_zoom(monitor_view_t * v, float zoom, int x, int y);
+static void view_title_update(monitor_view_t * v);
+static monitor_view_t * view_find(uint32_t window_id);
+static bool view_handler(SDL_Event * event);
+#if LV_USE_HW_CURSOR
+static void cursor_update(void);
+#endif
 
 /***********************
  *   GLOBAL PROTOTYPES
@@ -75,8 +176,27 @@ monitor_t monitor;
 monitor_t monitor2;
 #endif
 
+static monitor_view_t views[MONITOR_VIEW_MAX];
+static volatile uint32_t view_cnt;
+
 static volatile bool sdl_inited = false;
 static volatile bool sdl_quit_qry = false;
+static SDL_sem * input_sem;     /*Posted when the SDL thread handled events*/
+
+#if LV_USE_HW_CURSOR
+static SDL_mutex * cursor_mutex;    /*Protects the requested cursor*/
+static uint32_t * cursor_new_px;    /*ARGB8888 pixels of the requested cursor, NULL: the default cursor*/
+static int cursor_new_w;
+static int cursor_new_h;
+static bool cursor_new_qry;
+static SDL_Cursor * cursor;         /*The cursor in use, NULL: the default one. Used only by the SDL thread.*/
+#endif
+
+/*Tints of the flushed areas (0xRRGGBB)*/
+static const uint32_t debug_area_colors[] = {0xFF0000, 0x00FF00, 0x0000FF, 0xFFFF00, 0xFF00FF, 0x00FFFF, 0xFF8000, 0x8000FF};
+
+/*Tints by overdraw: drawn once is left as it is, then 2x blue, 3x green, 4x pink, 5x or more red*/
+static const uint32_t debug_overdraw_colors[] = {0x0000FF, 0x00FF00, 0xFF40C0, 0xFF0000};
 
 int quit_filter(void * userdata, SDL_Event * event);
 static void monitor_sdl_clean_up(void);
@@ -111,6 +231,24 @@ void monitor_init(void)
 #endif
 }
 
+/**
+ * Get the refresh period of the screen showing the window, at least the period of `MONITOR_MAX_FPS`.
+ * Pass it to `lv_disp_set_refr_period` to refresh at the screen's rate.
+ * @return the period [ms]
+ */
+uint32_t monitor_get_refr_period(void)
+{
+    SDL_DisplayMode mode;
+    uint32_t hz = 0;
+    if(monitor.window && SDL_GetWindowDisplayMode(monitor.window, &mode) == 0 && mode.refresh_rate > 0) {
+        hz = mode.refresh_rate;
+    }
+    if(hz == 0 || hz > MONITOR_MAX_FPS) hz = MONITOR_MAX_FPS;
+
+    /*Rounded down: a frame drawn a bit early waits for the vsync, a late one misses it*/
+    return 1000 / hz;
+}
+
 /**
  * Flush a buffer to the display. Calls 'lv_flush_ready()' when finished
  * @param x1 left coordinate
@@ -124,8 +262,6 @@ void monitor_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t
     lv_coord_t hres = disp_drv->rotated == 0 ? disp_drv->hor_res : disp_drv->ver_res;
     lv_coord_t vres = disp_drv->rotated == 0 ? disp_drv->ver_res : disp_drv->hor_res;
 
-//    printf("x1:%d,y1:%d,x2:%d,y2:%d\n", area->x1, area->y1, area->x2, area->y2);
-
     /*Return if the area is out the screen*/
     if(area->x2 < 0 || area->y2 < 0 || area->x1 > hres - 1 || area->y1 > vres - 1) {
 
@@ -134,32 +270,20 @@ void monitor_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t
     }
 
 #if MONITOR_DOUBLE_BUFFERED
-    monitor.tft_fb_act = (uint32_t *)color_p;
+    monitor.tft_fb_act = (monitor_px_t *)color_p;
 
+    if(monitor.debug != MONITOR_DEBUG_OFF) debug_add(&monitor, area);
+    dirty_add(&monitor, area);
     monitor.sdl_refr_qry = true;
 
     /*IMPORTANT! It must be called to tell the system the flush is ready*/
     lv_disp_flush_ready(disp_drv);
 #else
+    fb_copy(&monitor, area, color_p);
+    if(monitor.debug != MONITOR_DEBUG_OFF) debug_add(&monitor, area);
 
-    int32_t y;
-#if LV_COLOR_DEPTH != 24 && LV_COLOR_DEPTH != 32    /*32 is valid but support 24 for backward compatibility too*/
-    int32_t x;
-    for(y = area->y1; y <= area->y2; y++) {
-        for(x = area->x1; x <= area->x2; x++) {
-            monitor.tft_fb[y * MONITOR_HOR_RES + x] = lv_color_to32(*color_p);
-            color_p++;
-        }
-
-    }
-#else
-    uint32_t w = lv_area_get_width(area);
-    for(y = area->y1; y <= area->y2 && y < MONITOR_VER_RES; y++) {
-        memcpy(&monitor.tft_fb[y * MONITOR_HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
-        color_p += w;
-    }
-#endif
-
+    /*Add the area only when its pixels are in `tft_fb` to not upload it earlier*/
+    dirty_add(&monitor, area);
     monitor.sdl_refr_qry = true;
 
     /*IMPORTANT! It must be called to tell the system the flush is ready*/
@@ -189,37 +313,188 @@ void monitor_flush2(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t
     }
 
 #if MONITOR_DOUBLE_BUFFERED
-    monitor2.tft_fb_act = (uint32_t *)color_p;
+    monitor2.tft_fb_act = (monitor_px_t *)color_p;
 
+    if(monitor2.debug != MONITOR_DEBUG_OFF) debug_add(&monitor2, area);
+    dirty_add(&monitor2, area);
     monitor2.sdl_refr_qry = true;
 
     /*IMPORTANT! It must be called to tell the system the flush is ready*/
     lv_disp_flush_ready(disp_drv);
 #else
+    fb_copy(&monitor2, area, color_p);
+    if(monitor2.debug != MONITOR_DEBUG_OFF) debug_add(&monitor2, area);
 
-    int32_t y;
-#if LV_COLOR_DEPTH != 24 && LV_COLOR_DEPTH != 32    /*32 is valid but support 24 for backward compatibility too*/
-    int32_t x;
-    for(y = area->y1; y <= area->y2; y++) {
-        for(x = area->x1; x <= area->x2; x++) {
-            monitor2.tft_fb[y * MONITOR_HOR_RES + x] = lv_color_to32(*color_p);
-            color_p++;
-        }
+    dirty_add(&monitor2, area);
+    monitor2.sdl_refr_qry = true;
 
-    }
+    /*IMPORTANT! It must be called to tell the system the flush is ready*/
+    lv_disp_flush_ready(disp_drv);
+#endif
+}
+#endif
+
+/**
+ * Wait until the SDL thread handles an input event, `monitor_wake` is called or the timeout elapses.
+ * With MONITOR_APPLE and MONITOR_EMSCRIPTEN the events are not handled by the SDL thread
+ * so it only waits for the timeout.
+ * @param timeout max. time to wait [ms] or `LV_NO_TASK_READY` to wait without timeout
+ * @return true: an event arrived; false: timeout
+ */
+bool monitor_wait_input(uint32_t timeout)
+{
+    int res;
+    if(timeout == LV_NO_TASK_READY) res = SDL_SemWait(input_sem);
+    else res = SDL_SemWaitTimeout(input_sem, timeout);
+
+    return res == 0 ? true : false;
+}
+
+/**
+ * Wake up `monitor_wait_input` without an input event. Can be called from any thread.
+ */
+void monitor_wake(void)
+{
+    if(SDL_SemValue(input_sem) == 0) SDL_SemPost(input_sem);
+}
+
+/**
+ * Show which areas are flushed or how many times the pixels are drawn.
+ * Only the window shows the debug colors, LittlevGL redraws the same areas as without them.
+ * Call it from the thread of `lv_task_handler`.
+ * @param mode what to show
+ * @param fade with `MONITOR_DEBUG_AREAS` fade out the tints in this many milliseconds,
+ *             0: keep them until the area is flushed again
+ */
+void monitor_set_debug(monitor_debug_t mode, uint32_t fade)
+{
+#if LV_USE_OVERDRAW
+    lv_draw_overdraw_set_en(mode == MONITOR_DEBUG_OVERDRAW);
 #else
-    uint32_t w = lv_area_get_width(area);
-    for(y = area->y1; y <= area->y2 && y < MONITOR_VER_RES; y++) {
-        memcpy(&monitor2.tft_fb[y * MONITOR_HOR_RES + area->x1], color_p, w * sizeof(lv_color_t));
-        color_p += w;
+    if(mode == MONITOR_DEBUG_OVERDRAW) {
+        LV_LOG_WARN("monitor_set_debug: LV_USE_OVERDRAW is disabled, the drawings are not counted");
     }
 #endif
 
-    monitor2.sdl_refr_qry = true;
-
-    /*IMPORTANT! It must be called to tell the system the flush is ready*/
-    lv_disp_flush_ready(disp_drv);
+    debug_set(&monitor, mode, fade);
+#if MONITOR_DUAL
+    debug_set(&monitor2, mode, fade);
 #endif
+
+    /*Redraw everything to show (or clear) the debug colors on the whole screen*/
+    lv_obj_invalidate(lv_disp_get_scr_act(NULL));
+}
+
+/**
+ * Open a window showing a frame of any size (e.g. of an offscreen display at a target's resolution).
+ * The frame is a texture scaled by the renderer, so zooming (mouse wheel), panning (dragging) and filtering
+ * ('F': auto, nearest or linear) don't redraw it. '0' fits the frame into the window, '1' shows it 1:1.
+ * Closing the window hides it. Call it from the thread of `lv_task_handler`.
+ * @param title title of the window
+ * @param hres width of the frame
+ * @param vres height of the frame
+ * @return the new view or NULL if there are `MONITOR_VIEW_MAX` views already or out of memory
+ */
+monitor_view_t * monitor_view_create(const char * title, lv_coord_t hres, lv_coord_t vres)
+{
+    if(view_cnt >= MONITOR_VIEW_MAX) return NULL;
+
+    monitor_view_t * v = &views[view_cnt];
+    memset(v, 0, sizeof(monitor_view_t));
+    v->fb    = calloc((uint32_t)hres * vres, sizeof(monitor_px_t));
+    v->mutex = SDL_CreateMutex();
+    if(v->fb == NULL || v->mutex == NULL) {
+        free(v->fb);
+        if(v->mutex) SDL_DestroyMutex(v->mutex);
+        return NULL;
+    }
+
+    strncpy(v->title, title, sizeof(v->title) - 1);
+    v->hres = hres;
+    v->vres = vres;
+    v->zoom = 1.0f;
+    lv_area_set(&v->dirty, 0, 0, hres - 1, vres - 1);
+    v->dirty_any = true;
+    v->refr_qry  = true;
+
+    /*The SDL thread opens its window*/
+    view_cnt++;
+    return v;
+}
+
+/**
+ * Copy the changed area of a frame to a view. Only this area is uploaded to the texture.
+ * @param v pointer to a view
+ * @param fb the whole frame (`hres` x `vres` pixels)
+ * @param area the changed area
+ */
+void monitor_view_update(monitor_view_t * v, const lv_color_t * fb, const lv_area_t * area)
+{
+    lv_area_t frame;
+    lv_area_t a;
+    lv_area_set(&frame, 0, 0, v->hres - 1, v->vres - 1);
+    if(lv_area_intersect(&a, area, &frame) == false) return;
+
+    uint32_t w = lv_area_get_width(&a);
+    lv_coord_t y;
+    SDL_LockMutex(v->mutex);
+    for(y = a.y1; y <= a.y2; y++) {
+        uint32_t i = (uint32_t)y * v->hres + a.x1;
+        px_copy(&v->fb[i], &fb[i], w);
+    }
+    if(v->dirty_any) lv_area_join(&v->dirty, &v->dirty, &a);
+    else lv_area_copy(&v->dirty, &a);
+    v->dirty_any = true;
+    SDL_UnlockMutex(v->mutex);
+
+    v->refr_qry = true;
+}
+
+#if LV_USE_HW_CURSOR
+/**
+ * Show an image as the mouse cursor of the window instead of drawing it. Use it as `cursor_set_cb`.
+ * The cursor follows the mouse by itself so no `cursor_move_cb` is needed.
+ * @param disp_drv pointer to the display driver (for the chroma key)
+ * @param img a true color image, NULL: restore the default cursor
+ * @return true: it will be the cursor; false: out of memory
+ */
+bool monitor_cursor_set(lv_disp_drv_t * disp_drv, const lv_img_dsc_t * img)
+{
+    uint32_t * px = NULL;
+    int w         = 0;
+    int h         = 0;
+
+    if(img) {
+        w  = img->header.w * MONITOR_ZOOM;
+        h  = img->header.h * MONITOR_ZOOM;
+        px = malloc(w * h * sizeof(uint32_t));
+        if(px == NULL) return false;
+
+        /*ARGB8888, zoomed like the window*/
+        lv_img_dsc_t * dsc = (lv_img_dsc_t *)img;
+        uint32_t key       = lv_color_to32(disp_drv->color_chroma_key) & 0xFFFFFF;
+        int x;
+        int y;
+        for(y = 0; y < h; y++) {
+            for(x = 0; x < w; x++) {
+                uint32_t c = lv_color_to32(lv_img_buf_get_px_color(dsc, x / MONITOR_ZOOM, y / MONITOR_ZOOM, NULL)) & 0xFFFFFF;
+                lv_opa_t a = lv_img_buf_get_px_alpha(dsc, x / MONITOR_ZOOM, y / MONITOR_ZOOM);
+                if(img->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED && c == key) a = LV_OPA_TRANSP;
+                px[y * w + x] = ((uint32_t)a << 24) | c;
+            }
+        }
+    }
+
+    /*The cursor can be created only on the SDL thread*/
+    SDL_LockMutex(cursor_mutex);
+    free(cursor_new_px); /*Replace a request which wasn't handled yet*/
+    cursor_new_px  = px;
+    cursor_new_w   = w;
+    cursor_new_h   = h;
+    cursor_new_qry = true;
+    SDL_UnlockMutex(cursor_mutex);
+
+    return true;
 }
 #endif
 
@@ -257,7 +532,8 @@ int quit_filter(void * userdata, SDL_Event * event)
     (void)userdata;
 
     if(event->type == SDL_WINDOWEVENT) {
-        if(event->window.event == SDL_WINDOWEVENT_CLOSE) {
+        /*Closing a view only hides it*/
+        if(event->window.event == SDL_WINDOWEVENT_CLOSE && view_find(event->window.windowID) == NULL) {
             sdl_quit_qry = true;
         }
     }
@@ -272,15 +548,31 @@ int quit_filter(void * userdata, SDL_Event * event)
 
 static void monitor_sdl_clean_up(void)
 {
+    SDL_DestroyMutex(monitor.dirty_mutex);
     SDL_DestroyTexture(monitor.texture);
     SDL_DestroyRenderer(monitor.renderer);
     SDL_DestroyWindow(monitor.window);
 
 #if MONITOR_DUAL
+    SDL_DestroyMutex(monitor2.dirty_mutex);
     SDL_DestroyTexture(monitor2.texture);
     SDL_DestroyRenderer(monitor2.renderer);
     SDL_DestroyWindow(monitor2.window);
 
+#endif
+
+    uint32_t i;
+    for(i = 0; i < view_cnt; i++) {
+        if(views[i].texture) SDL_DestroyTexture(views[i].texture);
+        if(views[i].renderer) SDL_DestroyRenderer(views[i].renderer);
+        if(views[i].window) SDL_DestroyWindow(views[i].window);
+    }
+
+    SDL_DestroySemaphore(input_sem);
+
+#if LV_USE_HW_CURSOR
+    if(cursor) SDL_FreeCursor(cursor);
+    SDL_DestroyMutex(cursor_mutex);
 #endif
 
     SDL_Quit();
@@ -293,6 +585,12 @@ static void monitor_sdl_init(void)
 
     SDL_SetEventFilter(quit_filter, NULL);
 
+    input_sem = SDL_CreateSemaphore(0);
+
+#if LV_USE_HW_CURSOR
+    cursor_mutex = SDL_CreateMutex();
+#endif
+
     window_create(&monitor);
 #if MONITOR_DUAL
     window_create(&monitor2);
@@ -311,6 +609,9 @@ void monitor_sdl_refr_core(void)
 static void monitor_sdl_refr_core(void)
 #endif
 {
+#if LV_USE_HW_CURSOR
+    cursor_update();
+#endif
 
     if(monitor.sdl_refr_qry != false) {
         monitor.sdl_refr_qry = false;
@@ -324,9 +625,16 @@ static void monitor_sdl_refr_core(void)
     }
 #endif
 
+    view_refr();
+
 #if !defined(MONITOR_APPLE) && !defined(MONITOR_EMSCRIPTEN)
     SDL_Event event;
+    bool input = false;
     while(SDL_PollEvent(&event)) {
+        /*The events of the views don't go to the input devices*/
+        if(view_handler(&event)) continue;
+
+        input = true;
 #if USE_MOUSE != 0
         mouse_handler(&event);
 #endif
@@ -354,6 +662,9 @@ static void monitor_sdl_refr_core(void)
             }
         }
     }
+
+    /*Wake up `monitor_wait_input`. One post is enough for any number of events.*/
+    if(input && SDL_SemValue(input_sem) == 0) SDL_SemPost(input_sem);
 #endif /*MONITOR_APPLE*/
 
     /*Sleep some time*/
@@ -361,6 +672,41 @@ static void monitor_sdl_refr_core(void)
 
 }
 
+#if LV_USE_HW_CURSOR
+/**
+ * Create the requested cursor. Called on the SDL thread.
+ */
+static void cursor_update(void)
+{
+    SDL_LockMutex(cursor_mutex);
+    bool qry       = cursor_new_qry;
+    uint32_t * px  = cursor_new_px;
+    int w          = cursor_new_w;
+    int h          = cursor_new_h;
+    cursor_new_qry = false;
+    cursor_new_px  = NULL;
+    SDL_UnlockMutex(cursor_mutex);
+
+    if(qry == false) return;
+
+    SDL_Cursor * new_cursor = NULL;
+    if(px) {
+        SDL_Surface * surface = SDL_CreateRGBSurfaceWithFormatFrom(px, w, h, 32, w * sizeof(uint32_t),
+                                                                   SDL_PIXELFORMAT_ARGB8888);
+        if(surface) {
+            new_cursor = SDL_CreateColorCursor(surface, 0, 0);
+            SDL_FreeSurface(surface);
+        }
+        free(px);
+        if(new_cursor == NULL) LV_LOG_WARN("monitor: can't create the cursor");
+    }
+
+    SDL_SetCursor(new_cursor ? new_cursor : SDL_GetDefaultCursor());
+    if(cursor) SDL_FreeCursor(cursor);
+    cursor = new_cursor;
+}
+#endif
+
 static void window_create(monitor_t * m)
 {
     m->window = SDL_CreateWindow("Lvgl Designer",
@@ -373,28 +719,68 @@ static void window_create(monitor_t * m)
     m->renderer = SDL_CreateRenderer(m->window, -1, 0);
 #endif
     m->texture = SDL_CreateTexture(m->renderer,
-                                SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, MONITOR_HOR_RES, MONITOR_VER_RES);
+                                MONITOR_PX_FORMAT, SDL_TEXTUREACCESS_STATIC, MONITOR_HOR_RES, MONITOR_VER_RES);
     SDL_SetTextureBlendMode(m->texture, SDL_BLENDMODE_BLEND);
 
+    m->dirty_mutex = SDL_CreateMutex();
+    m->dirty_cnt   = 0;
+
     /*Initialize the frame buffer to gray (77 is an empirical value) */
 #if MONITOR_DOUBLE_BUFFERED
-    SDL_UpdateTexture(m->texture, NULL, m->tft_fb_act, MONITOR_HOR_RES * sizeof(uint32_t));
+    SDL_UpdateTexture(m->texture, NULL, m->tft_fb_act, MONITOR_HOR_RES * sizeof(monitor_px_t));
 #else
-    memset(m->tft_fb, 0x44, MONITOR_HOR_RES * MONITOR_VER_RES * sizeof(uint32_t));
+    memset(m->tft_fb, 0x44, MONITOR_HOR_RES * MONITOR_VER_RES * sizeof(monitor_px_t));
+
+    lv_area_t full;
+    lv_area_set(&full, 0, 0, MONITOR_HOR_RES - 1, MONITOR_VER_RES - 1);
+    dirty_add(m, &full);
 #endif
 
     m->sdl_refr_qry = true;
 
 }
 
+/**
+ * Upload the flushed areas to the texture and present it.
+ * The texture keeps its content so without new areas it's only presented again.
+ * @param m pointer to a monitor
+ */
 static void window_update(monitor_t * m)
 {
 #if MONITOR_DOUBLE_BUFFERED == 0
-    SDL_UpdateTexture(m->texture, NULL, m->tft_fb, MONITOR_HOR_RES * sizeof(uint32_t));
+    monitor_px_t * fb = m->tft_fb;
 #else
-    if(m->tft_fb_act == NULL) return;
-    SDL_UpdateTexture(m->texture, NULL, m->tft_fb_act, MONITOR_HOR_RES * sizeof(uint32_t));
+    monitor_px_t * fb = m->tft_fb_act;
+    if(fb == NULL) return;
 #endif
+
+    /*Take the areas and let the flush add the new ones meanwhile*/
+    lv_area_t dirty[MONITOR_DIRTY_MAX];
+    uint32_t dirty_cnt;
+    SDL_LockMutex(m->dirty_mutex);
+    dirty_cnt = m->dirty_cnt;
+    memcpy(dirty, m->dirty, dirty_cnt * sizeof(lv_area_t));
+    m->dirty_cnt = 0;
+
+    /*The debug colors are on the whole screen and they can fade without new areas*/
+    bool debug = m->debug != MONITOR_DEBUG_OFF;
+    if(debug) {
+        if(debug_compose(m, fb)) m->sdl_refr_qry = true;
+        SDL_UpdateTexture(m->texture, NULL, m->debug_fb, MONITOR_HOR_RES * sizeof(monitor_px_t));
+        dirty_cnt = 0;
+    }
+    SDL_UnlockMutex(m->dirty_mutex);
+
+    uint32_t i;
+    for(i = 0; i < dirty_cnt; i++) {
+        SDL_Rect r;
+        r.x = dirty[i].x1;
+        r.y = dirty[i].y1;
+        r.w = lv_area_get_width(&dirty[i]);
+        r.h = lv_area_get_height(&dirty[i]);
+        SDL_UpdateTexture(m->texture, &r, &fb[r.y * MONITOR_HOR_RES + r.x], MONITOR_HOR_RES * sizeof(monitor_px_t));
+    }
+
     SDL_RenderClear(m->renderer);
     /*Test: Draw a background to test transparent screens (LV_COLOR_SCREEN_TRANSP)*/
     //        SDL_SetRenderDrawColor(renderer, 0xff, 0, 0, 0xff);
@@ -407,4 +793,465 @@ static void window_update(monitor_t * m)
     SDL_RenderPresent(m->renderer);
 }
 
+/**
+ * Remember an area to upload it to the texture in the next `window_update`
+ * @param m pointer to a monitor
+ * @param area the flushed area (it can be partially out of the screen)
+ */
+static void dirty_add(monitor_t * m, const lv_area_t * area)
+{
+    lv_area_t scr;
+    lv_area_t a;
+    lv_area_set(&scr, 0, 0, MONITOR_HOR_RES - 1, MONITOR_VER_RES - 1);
+    if(lv_area_intersect(&a, area, &scr) == false) return;
+
+    SDL_LockMutex(m->dirty_mutex);
+
+    /*Skip it if it's already covered*/
+    uint32_t i;
+    for(i = 0; i < m->dirty_cnt; i++) {
+        if(lv_area_is_in(&a, &m->dirty[i])) break;
+    }
+
+    if(i == m->dirty_cnt) {
+        /*No more space: join all the areas into one*/
+        if(m->dirty_cnt == MONITOR_DIRTY_MAX) {
+            for(i = 1; i < m->dirty_cnt; i++) lv_area_join(&m->dirty[0], &m->dirty[0], &m->dirty[i]);
+            lv_area_join(&m->dirty[0], &m->dirty[0], &a);
+            m->dirty_cnt = 1;
+        } else {
+            m->dirty[m->dirty_cnt] = a;
+            m->dirty_cnt++;
+        }
+    }
+
+    SDL_UnlockMutex(m->dirty_mutex);
+}
+
+/**
+ * Switch the debug mode of a monitor
+ * @param m pointer to a monitor
+ * @param mode what to show
+ * @param fade [ms] to fade out the tints of the areas or 0
+ */
+static void debug_set(monitor_t * m, monitor_debug_t mode, uint32_t fade)
+{
+    SDL_LockMutex(m->dirty_mutex);
+
+    if(mode != MONITOR_DEBUG_OFF && m->debug_px == NULL) {
+        m->debug_px = calloc(LV_HOR_RES_MAX * LV_VER_RES_MAX, sizeof(uint16_t));
+        m->debug_fb = malloc(LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(monitor_px_t));
+        if(m->debug_px == NULL || m->debug_fb == NULL) {
+            LV_LOG_WARN("monitor_set_debug: out of memory");
+            free(m->debug_px);
+            free(m->debug_fb);
+            m->debug_px = NULL;
+            m->debug_fb = NULL;
+            mode = MONITOR_DEBUG_OFF;
+        }
+    }
+
+    if(m->debug_px) memset(m->debug_px, 0, LV_HOR_RES_MAX * LV_VER_RES_MAX * sizeof(uint16_t));
+    m->debug_flush_id = 0;
+    m->debug          = mode;
+    m->debug_fade     = fade;
+
+    SDL_UnlockMutex(m->dirty_mutex);
+
+    /*Upload the whole frame buffer to remove the old debug colors*/
+    lv_area_t full;
+    lv_area_set(&full, 0, 0, MONITOR_HOR_RES - 1, MONITOR_VER_RES - 1);
+    dirty_add(m, &full);
+    m->sdl_refr_qry = true;
+}
+
+/**
+ * Remember the flush of an area for the debug colors
+ * @param m pointer to a monitor
+ * @param area the flushed area (it can be partially out of the screen)
+ */
+static void debug_add(monitor_t * m, const lv_area_t * area)
+{
+    lv_area_t scr;
+    lv_area_t a;
+    lv_area_set(&scr, 0, 0, MONITOR_HOR_RES - 1, MONITOR_VER_RES - 1);
+    if(lv_area_intersect(&a, area, &scr) == false) return;
+
+    uint16_t id = 0;
+    if(m->debug == MONITOR_DEBUG_AREAS) {
+        m->debug_flush_id++;
+        if(m->debug_flush_id == 0) m->debug_flush_id = 1;
+        id = m->debug_flush_id;
+        m->debug_flush_time[id & (MONITOR_DEBUG_FLUSH_MAX - 1)] = SDL_GetTicks();
+    }
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        uint16_t * px = &m->debug_px[y * MONITOR_HOR_RES];
+        for(x = a.x1; x <= a.x2; x++) {
+#if LV_USE_OVERDRAW
+            if(m->debug == MONITOR_DEBUG_OVERDRAW) px[x] = lv_draw_overdraw_get(x, y);
+            else px[x] = id;
+#else
+            px[x] = id;
+#endif
+        }
+    }
+}
+
+/**
+ * Mix the debug colors to the frame buffer into `debug_fb`. Called with `dirty_mutex` taken.
+ * @param m pointer to a monitor
+ * @param fb the frame buffer
+ * @return true: the tints are still fading so `debug_fb` should be composed again
+ */
+static bool debug_compose(monitor_t * m, const monitor_px_t * fb)
+{
+    uint32_t now    = SDL_GetTicks();
+    uint16_t last   = m->debug_flush_id;
+    uint32_t px_cnt = (uint32_t)MONITOR_HOR_RES * MONITOR_VER_RES;
+    uint32_t i;
+
+    if(m->debug == MONITOR_DEBUG_OVERDRAW) {
+        for(i = 0; i < px_cnt; i++) {
+            uint16_t cnt = m->debug_px[i];
+            if(cnt <= 1) m->debug_fb[i] = fb[i];
+            else {
+                uint16_t c = cnt - 2 < 3 ? cnt - 2 : 3;
+                m->debug_fb[i] = debug_px_mix(fb[i], debug_overdraw_colors[c], MONITOR_DEBUG_OPA);
+            }
+        }
+        return false;
+    }
+
+    uint32_t color_cnt = sizeof(debug_area_colors) / sizeof(debug_area_colors[0]);
+    for(i = 0; i < px_cnt; i++) {
+        uint16_t id = m->debug_px[i];
+        lv_opa_t opa = id != 0 ? MONITOR_DEBUG_OPA : LV_OPA_TRANSP;
+        if(opa != LV_OPA_TRANSP && m->debug_fade) {
+            /*The time of too old flushes is overwritten, but they are faded out anyway*/
+            uint32_t age = now - m->debug_flush_time[id & (MONITOR_DEBUG_FLUSH_MAX - 1)];
+            if((uint16_t)(last - id) >= MONITOR_DEBUG_FLUSH_MAX || age >= m->debug_fade) opa = LV_OPA_TRANSP;
+            else opa = (uint32_t)MONITOR_DEBUG_OPA * (m->debug_fade - age) / m->debug_fade;
+        }
+
+        if(opa == LV_OPA_TRANSP) m->debug_fb[i] = fb[i];
+        else m->debug_fb[i] = debug_px_mix(fb[i], debug_area_colors[id % color_cnt], opa);
+    }
+
+    /*Compose again until the last tint is faded out*/
+    if(m->debug_fade == 0 || last == 0) return false;
+    return now - m->debug_flush_time[last & (MONITOR_DEBUG_FLUSH_MAX - 1)] < m->debug_fade;
+}
+
+/**
+ * Mix a color to a pixel of the texture's format
+ * @param px a pixel of the frame buffer
+ * @param tint the color to mix as 0xRRGGBB
+ * @param opa opacity of `tint`
+ * @return the mixed pixel
+ */
+static monitor_px_t debug_px_mix(monitor_px_t px, uint32_t tint, lv_opa_t opa)
+{
+#if LV_COLOR_DEPTH == 16
+    uint32_t r = ((px >> 11) & 0x1F) << 3;
+    uint32_t g = ((px >> 5) & 0x3F) << 2;
+    uint32_t b = (px & 0x1F) << 3;
+#else
+    uint32_t r = (px >> 16) & 0xFF;
+    uint32_t g = (px >> 8) & 0xFF;
+    uint32_t b = px & 0xFF;
+#endif
+    lv_opa_t opa_inv = 255 - opa;
+    r = (((tint >> 16) & 0xFF) * opa + r * opa_inv) >> 8;
+    g = (((tint >> 8) & 0xFF) * opa + g * opa_inv) >> 8;
+    b = ((tint & 0xFF) * opa + b * opa_inv) >> 8;
+#if LV_COLOR_DEPTH == 16
+    return (monitor_px_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+#else
+    return (px & 0xFF000000) | (r << 16) | (g << 8) | b;
+#endif
+}
+
+/**
+ * Copy colors into pixels of the texture's format.
+ * 16 and 32 bit colors are already in the texture's format, only the swapped 16 bit colors
+ * need their bytes swapped back. The other depths are converted.
+ * @param dest the pixels
+ * @param src the colors
+ * @param cnt number of colors
+ */
+static void px_copy(monitor_px_t * dest, const lv_color_t * src, uint32_t cnt)
+{
+#if LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        dest[i] = (uint16_t)((src[i].full >> 8) | (src[i].full << 8));
+    }
+#elif LV_COLOR_DEPTH == 16 || LV_COLOR_DEPTH == 24 || LV_COLOR_DEPTH == 32   /*32 is valid but support 24 for backward compatibility too*/
+    memcpy(dest, src, cnt * sizeof(lv_color_t));
+#else
+    uint32_t i;
+    for(i = 0; i < cnt; i++) {
+        dest[i] = lv_color_to32(src[i]);
+    }
+#endif
+}
+
+#if MONITOR_DOUBLE_BUFFERED == 0
+/**
+ * Copy a flushed area to the frame buffer of a monitor.
+ * @param m pointer to a monitor
+ * @param area the flushed area
+ * @param color_p the colors of the area
+ */
+static void fb_copy(monitor_t * m, const lv_area_t * area, const lv_color_t * color_p)
+{
+    int32_t y;
+    uint32_t w = lv_area_get_width(area);
+    for(y = area->y1; y <= area->y2 && y < MONITOR_VER_RES; y++) {
+        px_copy(&m->tft_fb[y * MONITOR_HOR_RES + area->x1], color_p, w);
+        color_p += w;
+    }
+}
+#endif
+
+/**
+ * Open the windows of the new views and present the changed ones. Called on the SDL thread.
+ */
+static void view_refr(void)
+{
+    uint32_t i;
+    for(i = 0; i < view_cnt; i++) {
+        monitor_view_t * v = &views[i];
+        if(v->window == NULL) view_open(v);
+        if(v->refr_qry) {
+            v->refr_qry = false;
+            view_present(v);
+        }
+    }
+}
+
+/**
+ * Open the window of a view as large as the frame, or zoomed out to fit on the screen
+ * @param v pointer to a view
+ */
+static void view_open(monitor_view_t * v)
+{
+    int w = v->hres;
+    int h = v->vres;
+    SDL_Rect bounds;
+    bool fit = false;
+    if(SDL_GetDisplayBounds(0, &bounds) == 0) {
+        int w_max = bounds.w * MONITOR_VIEW_SCREEN_PCT / 100;
+        int h_max = bounds.h * MONITOR_VIEW_SCREEN_PCT / 100;
+        if(w > w_max || h > h_max) {
+            if(w * h_max > h * w_max) {
+                h = h * w_max / w;
+                w = w_max;
+            } else {
+                w = w * h_max / h;
+                h = h_max;
+            }
+            fit = true;
+        }
+    }
+
+    v->window = SDL_CreateWindow(v->title, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, SDL_WINDOW_RESIZABLE);
+#if MONITOR_VIRTUAL_MACHINE || defined(MONITOR_EMSCRIPTEN)
+    v->renderer = SDL_CreateRenderer(v->window, -1, SDL_RENDERER_SOFTWARE);
+#else
+    v->renderer = SDL_CreateRenderer(v->window, -1, 0);
+#endif
+    if(fit) view_fit(v);
+    view_title_update(v);
+    v->refr_qry = true;
+}
+
+/**
+ * Upload the changed area of a view's frame and present the frame with the zoom and the position of the view.
+ * The texture is created again (and the whole frame uploaded) only when the filter changes.
+ * @param v pointer to a view
+ */
+static void view_present(monitor_view_t * v)
+{
+    if(v->renderer == NULL) return;
+
+    bool linear = v->filter == MONITOR_VIEW_FILTER_LINEAR || (v->filter == MONITOR_VIEW_FILTER_AUTO && v->zoom < 1.0f);
+    if(v->texture == NULL || v->texture_linear != linear) {
+        if(v->texture) SDL_DestroyTexture(v->texture);
+
+        /*The scale quality is taken when the texture is created*/
+        SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, linear ? "linear" : "nearest");
+        v->texture = SDL_CreateTexture(v->renderer, MONITOR_PX_FORMAT, SDL_TEXTUREACCESS_STATIC, v->hres, v->vres);
+        v->texture_linear = linear;
+        if(v->texture == NULL) return;
+
+        SDL_LockMutex(v->mutex);
+        lv_area_set(&v->dirty, 0, 0, v->hres - 1, v->vres - 1);
+        v->dirty_any = true;
+        SDL_UnlockMutex(v->mutex);
+    }
+
+    SDL_LockMutex(v->mutex);
+    if(v->dirty_any) {
+        SDL_Rect r;
+        r.x = v->dirty.x1;
+        r.y = v->dirty.y1;
+        r.w = lv_area_get_width(&v->dirty);
+        r.h = lv_area_get_height(&v->dirty);
+        SDL_UpdateTexture(v->texture, &r, &v->fb[r.y * v->hres + r.x], v->hres * sizeof(monitor_px_t));
+        v->dirty_any = false;
+    }
+    SDL_UnlockMutex(v->mutex);
+
+    SDL_Rect dest;
+    dest.x = (int)v->ox;
+    dest.y = (int)v->oy;
+    dest.w = (int)(v->hres * v->zoom + 0.5f);
+    dest.h = (int)(v->vres * v->zoom + 0.5f);
+    SDL_SetRenderDrawColor(v->renderer, 0x44, 0x44, 0x44, 0xFF);
+    SDL_RenderClear(v->renderer);
+    SDL_RenderCopy(v->renderer, v->texture, NULL, &dest);
+    SDL_RenderPresent(v->renderer);
+}
+
+/**
+ * Zoom the frame of a view to fit into the window and center it
+ * @param v pointer to a view
+ */
+static void view_fit(monitor_view_t * v)
+{
+    int w;
+    int h;
+    SDL_GetWindowSize(v->window, &w, &h);
+    float zx = (float)w / v->hres;
+    float zy = (float)h / v->vres;
+    v->zoom = zx < zy ? zx : zy;
+    v->ox   = (w - v->hres * v->zoom) / 2;
+    v->oy   = (h - v->vres * v->zoom) / 2;
+}
+
+/**
+ * Set the zoom of a view keeping the frame's pixel under a point of the window in place
+ * @param v pointer to a view
+ * @param zoom the new zoom, limited to `MONITOR_VIEW_ZOOM_MIN`...`MONITOR_VIEW_ZOOM_MAX`
+ * @param x x coordinate in the window
+ * @param y y coordinate in the window
+ */
+static void view_zoom(monitor_view_t * v, float zoom, int x, int y)
+{
+    if(zoom < MONITOR_VIEW_ZOOM_MIN) zoom = MONITOR_VIEW_ZOOM_MIN;
+    if(zoom > MONITOR_VIEW_ZOOM_MAX) zoom = MONITOR_VIEW_ZOOM_MAX;
+
+    v->ox   = x - (x - v->ox) * zoom / v->zoom;
+    v->oy   = y - (y - v->oy) * zoom / v->zoom;
+    v->zoom = zoom;
+}
+
+/**
+ * Show the zoom and the filter of a view in its title
+ * @param v pointer to a view
+ */
+static void view_title_update(monitor_view_t * v)
+{
+    static const char * filter_names[] = {"auto", "nearest", "linear"};
+    char title[sizeof(v->title) + 32];
+    /*The fitted zoom isn't limited, keep the percent short to fit after the title*/
+    int zoom_pct = (int)(v->zoom * 100 + 0.5f);
+    if(zoom_pct < 0) zoom_pct = 0;
+    if(zoom_pct > 99999) zoom_pct = 99999;
+    snprintf(title, sizeof(title), "%.*s  %d%%, %s", (int)sizeof(v->title) - 1, v->title, zoom_pct,
+             filter_names[v->filter]);
+    SDL_SetWindowTitle(v->window, title);
+}
+
+/**
+ * Find the view of a window
+ * @param window_id ID of an SDL window
+ * @return the view or NULL if it's not the window of a view
+ */
+static monitor_view_t * view_find(uint32_t window_id)
+{
+    uint32_t i;
+    for(i = 0; i < view_cnt; i++) {
+        if(views[i].window && SDL_GetWindowID(views[i].window) == window_id) return &views[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Zoom, pan and filter a view by the events of its window
+ * @param event an SDL event
+ * @return true: the event was of a view's window
+ */
+static bool view_handler(SDL_Event * event)
+{
+    uint32_t window_id;
+    switch(event->type) {
+        case SDL_WINDOWEVENT:     window_id = event->window.windowID; break;
+        case SDL_MOUSEMOTION:     window_id = event->motion.windowID; break;
+        case SDL_MOUSEBUTTONDOWN:
+        case SDL_MOUSEBUTTONUP:   window_id = event->button.windowID; break;
+        case SDL_MOUSEWHEEL:      window_id = event->wheel.windowID; break;
+        case SDL_KEYDOWN:
+        case SDL_KEYUP:           window_id = event->key.windowID; break;
+        default:                  return false;
+    }
+
+    monitor_view_t * v = view_find(window_id);
+    if(v == NULL) return false;
+
+    switch(event->type) {
+        case SDL_WINDOWEVENT:
+            if(event->window.event == SDL_WINDOWEVENT_CLOSE) SDL_HideWindow(v->window);
+            else v->refr_qry = true;    /*Exposed, resized...*/
+            break;
+        case SDL_MOUSEBUTTONDOWN:
+            if(event->button.button == SDL_BUTTON_LEFT) v->drag = true;
+            break;
+        case SDL_MOUSEBUTTONUP:
+            if(event->button.button == SDL_BUTTON_LEFT) v->drag = false;
+            break;
+        case SDL_MOUSEMOTION:
+            if(v->drag && (event->motion.state & SDL_BUTTON_LMASK)) {
+                v->ox += event->motion.xrel;
+                v->oy += event->motion.yrel;
+                v->refr_qry = true;
+            }
+            break;
+        case SDL_MOUSEWHEEL: {
+                int x;
+                int y;
+                SDL_GetMouseState(&x, &y);
+                float zoom = v->zoom;
+                int step;
+                for(step = event->wheel.y; step > 0; step--) zoom *= MONITOR_VIEW_ZOOM_STEP;
+                for(step = event->wheel.y; step < 0; step++) zoom /= MONITOR_VIEW_ZOOM_STEP;
+                view_zoom(v, zoom, x, y);
+                view_title_update(v);
+                v->refr_qry = true;
+                break;
+            }
+        case SDL_KEYDOWN:
+            if(event->key.keysym.sym == SDLK_f) v->filter = (v->filter + 1) % 3;
+            else if(event->key.keysym.sym == SDLK_0) view_fit(v);
+            else if(event->key.keysym.sym == SDLK_1) {
+                int w;
+                int h;
+                SDL_GetWindowSize(v->window, &w, &h);
+                view_zoom(v, 1.0f, w / 2, h / 2);
+            } else break;
+            view_title_update(v);
+            v->refr_qry = true;
+            break;
+        default:
+            break;
+    }
+
+    return true;
+}
+
 #endif /*USE_MONITOR*/
@@ -30,13 +30,30 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+typedef enum {
+    MONITOR_DEBUG_OFF,
+    MONITOR_DEBUG_AREAS,    /*Tint every flushed area with the next color of a palette*/
+    MONITOR_DEBUG_OVERDRAW, /*Color the pixels by how many times they were drawn in their last refresh*/
+} monitor_debug_t;
+
+/*A window showing a frame of any size, scaled by the renderer (see `monitor_view_create`)*/
+typedef struct _monitor_view_t monitor_view_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 void monitor_init(void);
+uint32_t monitor_get_refr_period(void);
 void monitor_flush(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
 void monitor_flush2(lv_disp_drv_t * disp_drv, const lv_area_t * area, lv_color_t * color_p);
+bool monitor_wait_input(uint32_t timeout);
+void monitor_wake(void);
+void monitor_set_debug(monitor_debug_t mode, uint32_t fade);
+monitor_view_t * monitor_view_create(const char * title, lv_coord_t hres, lv_coord_t vres);
+void monitor_view_update(monitor_view_t * v, const lv_color_t * fb, const lv_area_t * area);
+#if LV_USE_HW_CURSOR
+bool monitor_cursor_set(lv_disp_drv_t * disp_drv, const lv_img_dsc_t * img);
+#endif
 
 /**********************
  *      MACROS
@@ -0,0 +1,616 @@
+/**
+ * @file netdisp.c
+ * The sender of the network display (see the stream format in `netdisp.h`).
+ * Only the flushed areas are sent, each with the encoding giving the fewest bytes, so the
+ * bandwidth follows the redrawn area. The messages are queued and written to a non-blocking socket,
+ * LittlevGL never waits for the network. If the receiver falls behind by `NETDISP_OUT_MAX` bytes the
+ * areas are dropped and the whole screen is sent again when the queue is empty.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "netdisp.h"
+#if USE_NETDISP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef NETDISP_OUT_MAX
+#define NETDISP_OUT_MAX         (4UL * 1024UL * 1024UL)
+#endif
+
+#ifndef NETDISP_POLL_PERIOD
+#define NETDISP_POLL_PERIOD     10      /*[ms] Accept, read the input and send the queue this often*/
+#endif
+
+#define NETDISP_INPUT_QUEUE     32      /*Input events buffered until the next read (power of 2)*/
+#define NETDISP_FRAMES_PENDING  32      /*Frames waiting for their ACK (power of 2)*/
+#define NETDISP_RECT_HDR_SIZE   9
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int16_t x;
+    int16_t y;
+    uint8_t pressed;
+} netdisp_input_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void netdisp_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void netdisp_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void netdisp_task(lv_task_t * task);
+static void client_accept(void);
+static void client_close(void);
+static void client_read(void);
+static void msg_process(uint8_t type, const uint8_t * payload);
+static void rect_send(const lv_area_t * area, const lv_color_t * color_p);
+static uint32_t rect_encode(uint8_t * dest, const uint16_t * px, uint32_t px_cnt, netdisp_enc_t enc);
+static void rect_measure(const uint16_t * px, uint32_t px_cnt, uint32_t size[_NETDISP_ENC_NUM]);
+static uint8_t * out_reserve(uint32_t size, bool force);
+static void out_send(void);
+static void screen_invalidate(void);
+static inline uint16_t color_to565(lv_color_t color);
+static inline uint8_t * put16(uint8_t * p, uint16_t v);
+static inline uint8_t * put32(uint8_t * p, uint32_t v);
+static inline uint8_t * msg_begin(uint8_t * p, uint8_t type, uint32_t len);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_drv_t * disp_drv;
+static void (*flush_orig)(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void (*monitor_orig)(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static int listen_fd = -1;
+static int client_fd = -1;
+
+static uint8_t * out_buf;           /*Messages queued for the receiver*/
+static uint32_t out_cap;
+static uint32_t out_len;
+static uint32_t out_sent;           /*Bytes of `out_buf` already sent*/
+static bool resync;                 /*Areas were dropped: send the whole screen when the queue is empty*/
+static bool full_frame;             /*The whole screen is being sent, its areas are queued over the limit too*/
+
+static uint8_t in_buf[NETDISP_MSG_HDR_SIZE + 16];
+static uint32_t in_len;
+
+static uint16_t * px_buf;           /*The flushed area in RGB565*/
+static uint32_t px_buf_size;
+
+static uint32_t frame_id;
+static uint32_t frame_rects;        /*Areas sent in the current frame*/
+static uint32_t frame_start[NETDISP_FRAMES_PENDING];
+
+static netdisp_input_t input_queue[NETDISP_INPUT_QUEUE];
+static uint32_t input_rd;
+static uint32_t input_wr;
+static netdisp_input_t input_last;
+
+static netdisp_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Listen for a receiver on a TCP port and stream a display to it.
+ * The flushed areas are sent from the display's `flush_cb` and a frame ends in its `monitor_cb`;
+ * both are wrapped, so call it after they are set and the display is registered.
+ * @param drv pointer to the driver of a registered display (`&disp->driver`)
+ * @param port the TCP port to listen on
+ * @return true: listening; false: the port couldn't be opened
+ */
+bool netdisp_init(lv_disp_drv_t * drv, uint16_t port)
+{
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(listen_fd < 0) {
+        perror("netdisp: socket");
+        return false;
+    }
+
+    int one = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+    if(bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(listen_fd, 1) < 0) {
+        perror("netdisp: bind");
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+    fcntl(listen_fd, F_SETFL, fcntl(listen_fd, F_GETFL, 0) | O_NONBLOCK);
+
+    disp_drv        = drv;
+    flush_orig      = drv->flush_cb;
+    monitor_orig    = drv->monitor_cb;
+    drv->flush_cb   = netdisp_flush;
+    drv->monitor_cb = netdisp_monitor;
+
+    lv_task_create(netdisp_task, NETDISP_POLL_PERIOD, LV_TASK_PRIO_MID, NULL);
+    return true;
+}
+
+/**
+ * Read the pointer input of the receiver. Register it as the `read_cb` of a pointer input device.
+ * @param indev_drv pointer to the input device driver
+ * @param data store the state here
+ * @return true: more events are buffered
+ */
+bool netdisp_input_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
+{
+    (void)indev_drv;
+
+    if(input_rd != input_wr) {
+        input_last = input_queue[input_rd & (NETDISP_INPUT_QUEUE - 1)];
+        input_rd++;
+    }
+
+    data->point.x = input_last.x;
+    data->point.y = input_last.y;
+    data->state   = input_last.pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+    return input_rd != input_wr;
+}
+
+/**
+ * Tell whether a receiver is connected
+ * @return true: connected
+ */
+bool netdisp_is_connected(void)
+{
+    return client_fd >= 0;
+}
+
+/**
+ * Get the statistics of the stream
+ * @param stat_p store the statistics here
+ * @param reset true: start counting again
+ */
+void netdisp_get_stat(netdisp_stat_t * stat_p, bool reset)
+{
+    *stat_p = stat;
+    if(reset) memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Send a flushed area to the receiver and flush it to the display too
+ */
+static void netdisp_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    /*Encode it before the original `flush_cb` gives the buffer back to LittlevGL*/
+    if(client_fd >= 0) rect_send(area, color_p);
+
+    flush_orig(drv, area, color_p);
+}
+
+/**
+ * End the frame after a refresh: its areas are all queued
+ */
+static void netdisp_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    if(client_fd >= 0 && frame_rects > 0) {
+        uint8_t * p = out_reserve(NETDISP_MSG_HDR_SIZE + 8, true);
+        if(p) {
+            uint32_t start = lv_tick_get() - time;
+            frame_start[frame_id & (NETDISP_FRAMES_PENDING - 1)] = start;
+
+            p = msg_begin(p, NETDISP_MSG_FRAME, 8);
+            p = put32(p, frame_id);
+            put32(p, start);
+            frame_id++;
+            stat.frame_cnt++;
+        }
+        frame_rects = 0;
+        full_frame  = false;
+        out_send();
+    }
+
+    if(monitor_orig) monitor_orig(drv, time, px);
+}
+
+static void netdisp_task(lv_task_t * task)
+{
+    (void)task;
+
+    if(client_fd < 0) client_accept();
+    if(client_fd < 0) return;
+
+    client_read();
+    if(client_fd >= 0) out_send();
+
+    /*The dropped areas are sent again with the whole screen*/
+    if(client_fd >= 0 && resync && out_len == 0) {
+        resync = false;
+        screen_invalidate();
+    }
+}
+
+static void client_accept(void)
+{
+    client_fd = accept(listen_fd, NULL, NULL);
+    if(client_fd < 0) return;
+
+    int one = 1;
+    setsockopt(client_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    fcntl(client_fd, F_SETFL, fcntl(client_fd, F_GETFL, 0) | O_NONBLOCK);
+
+    out_len     = 0;
+    out_sent    = 0;
+    in_len      = 0;
+    resync      = false;
+    frame_rects = 0;
+
+    uint8_t * p = out_reserve(NETDISP_MSG_HDR_SIZE + 9, true);
+    if(p == NULL) {
+        client_close();
+        return;
+    }
+    p    = msg_begin(p, NETDISP_MSG_HELLO, 9);
+    p    = put32(p, NETDISP_MAGIC);
+    *p++ = NETDISP_VERSION;
+    p    = put16(p, disp_drv->hor_res);
+    put16(p, disp_drv->ver_res);
+
+    /*The receiver starts with the whole screen*/
+    screen_invalidate();
+}
+
+static void client_close(void)
+{
+    close(client_fd);
+    client_fd = -1;
+    out_len   = 0;
+    out_sent  = 0;
+
+    /*Release the pointer if the receiver was pressing*/
+    input_last.pressed = 0;
+    input_rd           = input_wr;
+}
+
+/**
+ * Read the messages of the receiver
+ */
+static void client_read(void)
+{
+    while(1) {
+        ssize_t n = recv(client_fd, &in_buf[in_len], sizeof(in_buf) - in_len, 0);
+        if(n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            client_close();
+            return;
+        }
+        if(n < 0) return;
+
+        in_len += n;
+        while(in_len >= NETDISP_MSG_HDR_SIZE) {
+            uint32_t len = in_buf[1] | (in_buf[2] << 8) | ((uint32_t)in_buf[3] << 16) | ((uint32_t)in_buf[4] << 24);
+            if(len > sizeof(in_buf) - NETDISP_MSG_HDR_SIZE) {
+                /*No such message is sent by the receiver*/
+                client_close();
+                return;
+            }
+            if(in_len < NETDISP_MSG_HDR_SIZE + len) break;
+
+            msg_process(in_buf[0], &in_buf[NETDISP_MSG_HDR_SIZE]);
+            in_len -= NETDISP_MSG_HDR_SIZE + len;
+            memmove(in_buf, &in_buf[NETDISP_MSG_HDR_SIZE + len], in_len);
+        }
+    }
+}
+
+static void msg_process(uint8_t type, const uint8_t * payload)
+{
+    if(type == NETDISP_MSG_INPUT) {
+        /*Overwrite the last event if the queue is full*/
+        if(input_wr - input_rd >= NETDISP_INPUT_QUEUE) input_wr--;
+        netdisp_input_t * in = &input_queue[input_wr & (NETDISP_INPUT_QUEUE - 1)];
+        in->x                = (int16_t)(payload[0] | (payload[1] << 8));
+        in->y                = (int16_t)(payload[2] | (payload[3] << 8));
+        in->pressed          = payload[4];
+        input_wr++;
+
+        /*The read task of the input device might be paused while it's released*/
+        lv_indev_t * indev = lv_indev_get_next(NULL);
+        while(indev) {
+            if(indev->driver.read_cb == netdisp_input_read) {
+                lv_task_resume(indev->driver.read_task);
+                lv_task_ready(indev->driver.read_task);
+            }
+            indev = lv_indev_get_next(indev);
+        }
+    } else if(type == NETDISP_MSG_ACK) {
+        uint32_t id = payload[0] | (payload[1] << 8) | ((uint32_t)payload[2] << 16) | ((uint32_t)payload[3] << 24);
+        /*The start of older frames is overwritten*/
+        if(frame_id - id - 1 < NETDISP_FRAMES_PENDING) {
+            uint32_t latency = lv_tick_elaps(frame_start[id & (NETDISP_FRAMES_PENDING - 1)]);
+            stat.ack_cnt++;
+            stat.latency_sum += latency;
+            if(latency > stat.latency_max) stat.latency_max = latency;
+        }
+    }
+}
+
+/**
+ * Queue a flushed area in the encoding which gives the fewest bytes
+ */
+static void rect_send(const lv_area_t * area, const lv_color_t * color_p)
+{
+    lv_area_t scr_a;
+    lv_area_t send_a;
+    lv_area_set(&scr_a, 0, 0, disp_drv->hor_res - 1, disp_drv->ver_res - 1);
+    if(lv_area_intersect(&send_a, area, &scr_a) == false) return;
+
+    if(resync) {
+        stat.drop_cnt++;
+        return;
+    }
+
+    uint32_t w      = lv_area_get_width(&send_a);
+    uint32_t h      = lv_area_get_height(&send_a);
+    uint32_t px_cnt = w * h;
+    if(px_cnt > px_buf_size) {
+        uint16_t * new_buf = realloc(px_buf, px_cnt * sizeof(uint16_t));
+        if(new_buf == NULL) {
+            stat.drop_cnt++;
+            resync = true;
+            return;
+        }
+        px_buf      = new_buf;
+        px_buf_size = px_cnt;
+    }
+
+    /*Convert the area to RGB565 (the rounder might have made it larger than the screen)*/
+    uint32_t area_w = lv_area_get_width(area);
+    color_p += (send_a.y1 - area->y1) * area_w + (send_a.x1 - area->x1);
+    uint16_t * px = px_buf;
+    uint32_t x, y;
+    for(y = 0; y < h; y++) {
+        for(x = 0; x < w; x++) px[x] = color_to565(color_p[x]);
+        px += w;
+        color_p += area_w;
+    }
+
+    uint32_t size[_NETDISP_ENC_NUM];
+    rect_measure(px_buf, px_cnt, size);
+    netdisp_enc_t enc = NETDISP_ENC_RAW;
+    if(size[NETDISP_ENC_RLE] < size[enc]) enc = NETDISP_ENC_RLE;
+    if(size[NETDISP_ENC_PAL] < size[enc]) enc = NETDISP_ENC_PAL;
+
+    uint32_t len = NETDISP_RECT_HDR_SIZE + size[enc];
+    uint8_t * p  = out_reserve(NETDISP_MSG_HDR_SIZE + len, full_frame);
+    if(p == NULL) {
+        /*The receiver is too slow*/
+        stat.drop_cnt++;
+        resync = true;
+        return;
+    }
+
+    p    = msg_begin(p, NETDISP_MSG_RECT, len);
+    p    = put16(p, send_a.x1);
+    p    = put16(p, send_a.y1);
+    p    = put16(p, w);
+    p    = put16(p, h);
+    *p++ = enc;
+    rect_encode(p, px_buf, px_cnt, enc);
+
+    frame_rects++;
+    stat.rect_cnt++;
+    stat.px_cnt += px_cnt;
+    stat.raw_bytes += px_cnt * sizeof(uint16_t);
+    stat.enc_cnt[enc]++;
+}
+
+/**
+ * Count the bytes of the pixels in every encoding in one pass
+ * @param px the pixels
+ * @param px_cnt number of pixels
+ * @param size store the sizes here. `UINT32_MAX` for PAL with more than `NETDISP_PAL_MAX` colors.
+ */
+static void rect_measure(const uint16_t * px, uint32_t px_cnt, uint32_t size[_NETDISP_ENC_NUM])
+{
+    uint16_t pal[NETDISP_PAL_MAX];
+    uint32_t pal_cnt  = 0;
+    bool pal_ok       = true;
+    uint32_t rle_runs = 0;
+    uint32_t pal_runs = 0;
+
+    uint32_t i = 0;
+    while(i < px_cnt) {
+        uint16_t c   = px[i];
+        uint32_t run = 1;
+        while(i + run < px_cnt && px[i + run] == c) run++;
+        i += run;
+
+        rle_runs += (run + 255) >> 8;
+        if(pal_ok == false) continue;
+
+        pal_runs += (run + 15) >> 4;
+        uint32_t k;
+        for(k = 0; k < pal_cnt && pal[k] != c; k++)
+            ;
+        if(k == pal_cnt) {
+            if(pal_cnt == NETDISP_PAL_MAX) pal_ok = false;
+            else pal[pal_cnt++] = c;
+        }
+    }
+
+    size[NETDISP_ENC_RAW] = px_cnt * sizeof(uint16_t);
+    size[NETDISP_ENC_RLE] = rle_runs * 3;
+    size[NETDISP_ENC_PAL] = pal_ok ? 1 + pal_cnt * sizeof(uint16_t) + pal_runs : UINT32_MAX;
+}
+
+/**
+ * Encode pixels
+ * @param dest store the encoded pixels here
+ * @param px the pixels
+ * @param px_cnt number of pixels
+ * @param enc the encoding
+ * @return number of bytes written
+ */
+static uint32_t rect_encode(uint8_t * dest, const uint16_t * px, uint32_t px_cnt, netdisp_enc_t enc)
+{
+    uint8_t * p = dest;
+    uint32_t i;
+
+    if(enc == NETDISP_ENC_RAW) {
+        for(i = 0; i < px_cnt; i++) p = put16(p, px[i]);
+        return p - dest;
+    }
+
+    /*The palette is in the order of the first use*/
+    uint16_t pal[NETDISP_PAL_MAX];
+    uint32_t pal_cnt = 0;
+    if(enc == NETDISP_ENC_PAL) {
+        for(i = 0; i < px_cnt; i++) {
+            uint32_t k;
+            for(k = 0; k < pal_cnt && pal[k] != px[i]; k++)
+                ;
+            if(k == pal_cnt) pal[pal_cnt++] = px[i];
+        }
+        *p++ = pal_cnt - 1;
+        for(i = 0; i < pal_cnt; i++) p = put16(p, pal[i]);
+    }
+
+    uint32_t max_run = enc == NETDISP_ENC_PAL ? 16 : 256;
+    uint32_t idx     = 0;
+    i                = 0;
+    while(i < px_cnt) {
+        uint16_t c   = px[i];
+        uint32_t run = 1;
+        while(i + run < px_cnt && run < max_run && px[i + run] == c) run++;
+        i += run;
+
+        if(enc == NETDISP_ENC_RLE) {
+            *p++ = run - 1;
+            p    = put16(p, c);
+        } else {
+            if(pal[idx] != c) {
+                for(idx = 0; pal[idx] != c; idx++)
+                    ;
+            }
+            *p++ = (idx << 4) | (run - 1);
+        }
+    }
+
+    return p - dest;
+}
+
+/**
+ * Get room at the end of the queue
+ * @param size bytes to add
+ * @param force true: the queue can be longer than `NETDISP_OUT_MAX`
+ * @return pointer to the room or NULL if the queue would be longer than `NETDISP_OUT_MAX` (or out of memory)
+ */
+static uint8_t * out_reserve(uint32_t size, bool force)
+{
+    /*Drop the sent bytes from the queue*/
+    if(out_sent > 0) {
+        memmove(out_buf, &out_buf[out_sent], out_len - out_sent);
+        out_len -= out_sent;
+        out_sent = 0;
+    }
+
+    if(force == false && out_len + size > NETDISP_OUT_MAX) return NULL;
+    if(out_len + size > out_cap) {
+        uint32_t new_cap  = LV_MATH_MAX(out_cap * 2, out_len + size);
+        uint8_t * new_buf = realloc(out_buf, new_cap);
+        if(new_buf == NULL) return NULL;
+        out_buf = new_buf;
+        out_cap = new_cap;
+    }
+
+    uint8_t * p = &out_buf[out_len];
+    out_len += size;
+    stat.sent_bytes += size;
+    return p;
+}
+
+/**
+ * Write as much of the queue to the socket as it takes without blocking
+ */
+static void out_send(void)
+{
+    while(out_sent < out_len) {
+        ssize_t n = send(client_fd, &out_buf[out_sent], out_len - out_sent, MSG_NOSIGNAL);
+        if(n < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return;
+            client_close();
+            return;
+        }
+        out_sent += n;
+    }
+
+    out_len  = 0;
+    out_sent = 0;
+}
+
+/**
+ * Redraw the whole screen of the streamed display and send it
+ */
+static void screen_invalidate(void)
+{
+    lv_disp_t * disp = lv_disp_get_next(NULL);
+    while(disp && &disp->driver != disp_drv) disp = lv_disp_get_next(disp);
+    if(disp == NULL) return;
+
+    lv_area_t scr_a;
+    lv_area_set(&scr_a, 0, 0, disp_drv->hor_res - 1, disp_drv->ver_res - 1);
+    lv_inv_area(disp, &scr_a);
+    full_frame = true;
+}
+
+static inline uint16_t color_to565(lv_color_t color)
+{
+    uint16_t c = lv_color_to16(color);
+#if LV_COLOR_16_SWAP
+    c = (c >> 8) | (c << 8);
+#endif
+    return c;
+}
+
+static inline uint8_t * put16(uint8_t * p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static inline uint8_t * put32(uint8_t * p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+static inline uint8_t * msg_begin(uint8_t * p, uint8_t type, uint32_t len)
+{
+    *p = type;
+    return put32(p + 1, len);
+}
+
+#endif /*USE_NETDISP*/
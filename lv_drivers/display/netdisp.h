@@ -0,0 +1,205 @@
+/**
+ * @file netdisp.h
+ * Stream the flushed areas of a display to a receiver over TCP and get its pointer input back.
+ * `netdisp.c` is the sender (POSIX sockets), `netdisp_rx.c` the receiver, e.g. on a device or behind
+ * a WebSocket bridge. The receiver doesn't depend on the transport: it's fed with the received bytes.
+ * Its messages are small, so it should send them without delay (`TCP_NODELAY`).
+ *
+ * Stream format. Every message is `type (u8) | payload length (u32) | payload`, little endian.
+ * Sender -> receiver:
+ *   HELLO  magic (u32) | version (u8) | horizontal resolution (u16) | vertical resolution (u16)
+ *   RECT   x1 (u16) | y1 (u16) | width (u16) | height (u16) | encoding (u8) | pixels of the rows
+ *   FRAME  frame ID (u32) | tick when drawing the frame began (u32), after the RECTs of a refresh
+ * Receiver -> sender:
+ *   INPUT  x (i16) | y (i16) | pressed (u8)
+ *   ACK    frame ID (u32) when the frame is shown; the sender measures the latency with it
+ * The pixels are RGB565 in every encoding:
+ *   RAW    the colors (u16)
+ *   RLE    runs: length - 1 (u8) | color (u16)
+ *   PAL    colors in the palette - 1 (u8) | palette (u16 each, at most 16) | runs: index << 4 | length - 1 (u8)
+ */
+
+#ifndef NETDISP_H
+#define NETDISP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_NETDISP || USE_NETDISP_RX
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define NETDISP_MAGIC           0x444E564CUL    /*"LVND" in little endian*/
+#define NETDISP_VERSION         1
+#define NETDISP_MSG_HDR_SIZE    5
+#define NETDISP_PAL_MAX         16
+
+/*Message types*/
+#define NETDISP_MSG_HELLO       1
+#define NETDISP_MSG_RECT        2
+#define NETDISP_MSG_FRAME       3
+#define NETDISP_MSG_INPUT       16
+#define NETDISP_MSG_ACK         17
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+enum {
+    NETDISP_ENC_RAW,
+    NETDISP_ENC_RLE,
+    NETDISP_ENC_PAL,
+    _NETDISP_ENC_NUM,
+};
+typedef uint8_t netdisp_enc_t;
+
+typedef struct {
+    uint32_t frame_cnt;                     /*Frames sent*/
+    uint32_t rect_cnt;                      /*Areas sent*/
+    uint32_t px_cnt;                        /*Pixels of the sent areas*/
+    uint32_t raw_bytes;                     /*The sent areas as RGB565 without encoding*/
+    uint32_t sent_bytes;                    /*Bytes of all the messages to the receiver*/
+    uint32_t enc_cnt[_NETDISP_ENC_NUM];     /*Areas sent with each encoding*/
+    uint32_t drop_cnt;                      /*Areas dropped for a slow receiver (then the screen is sent again)*/
+    uint32_t ack_cnt;                       /*Frames the receiver reported as shown*/
+    uint32_t latency_sum;                   /*[ms] from starting to draw the acknowledged frames until they were shown*/
+    uint32_t latency_max;                   /*[ms]*/
+} netdisp_stat_t;
+
+#if USE_NETDISP_RX
+struct _netdisp_rx_t;
+
+/*Called when a RECT is written into the frame buffer, to show the area on the panel*/
+typedef void (*netdisp_rx_rect_cb_t)(struct _netdisp_rx_t * rx, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
+/*Called at the end of a frame. Show it and send `netdisp_rx_ack` to the sender.*/
+typedef void (*netdisp_rx_frame_cb_t)(struct _netdisp_rx_t * rx, uint32_t frame_id);
+
+typedef struct _netdisp_rx_t {
+    uint16_t * fb;                      /*RGB565 frame buffer of `hres * vres` pixels*/
+    uint16_t hres;
+    uint16_t vres;
+    netdisp_rx_rect_cb_t rect_cb;       /*Optional*/
+    netdisp_rx_frame_cb_t frame_cb;     /*Optional*/
+    void * user_data;
+
+    /*Parser state*/
+    uint8_t hdr[NETDISP_MSG_HDR_SIZE + 9];  /*Header of the message and the fixed part of its payload*/
+    uint8_t hdr_len;
+    uint32_t left;                      /*Payload bytes of the message not read yet*/
+    uint8_t tok[3];                     /*The bytes of the current run or color*/
+    uint8_t tok_len;
+    uint16_t x1, y1, w, h;              /*The RECT being decoded*/
+    uint16_t x, y;                      /*The next pixel of the RECT*/
+    uint32_t px_left;
+    uint16_t pal[NETDISP_PAL_MAX];
+    uint8_t pal_cnt;                    /*0: the palette's size is not read yet*/
+    uint8_t pal_read;
+    netdisp_enc_t enc;
+    uint8_t hello : 1;
+    uint8_t error : 1;
+} netdisp_rx_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if USE_NETDISP
+
+/**
+ * Listen for a receiver on a TCP port and stream a display to it.
+ * The flushed areas are sent from the display's `flush_cb` and a frame ends in its `monitor_cb`;
+ * both are wrapped, so call it after they are set and the display is registered.
+ * @param drv pointer to the driver of a registered display (`&disp->driver`)
+ * @param port the TCP port to listen on
+ * @return true: listening; false: the port couldn't be opened
+ */
+bool netdisp_init(lv_disp_drv_t * drv, uint16_t port);
+
+/**
+ * Read the pointer input of the receiver. Register it as the `read_cb` of a pointer input device.
+ * @param indev_drv pointer to the input device driver
+ * @param data store the state here
+ * @return true: more events are buffered
+ */
+bool netdisp_input_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data);
+
+/**
+ * Tell whether a receiver is connected
+ * @return true: connected
+ */
+bool netdisp_is_connected(void);
+
+/**
+ * Get the statistics of the stream
+ * @param stat_p store the statistics here
+ * @param reset true: start counting again
+ */
+void netdisp_get_stat(netdisp_stat_t * stat_p, bool reset);
+
+#endif /*USE_NETDISP*/
+
+#if USE_NETDISP_RX
+
+/**
+ * Initialize a receiver. Set its callbacks after it.
+ * @param rx pointer to a receiver
+ * @param fb RGB565 frame buffer
+ * @param hres width of the frame buffer, has to be at least the sender's
+ * @param vres height of the frame buffer, has to be at least the sender's
+ */
+void netdisp_rx_init(netdisp_rx_t * rx, uint16_t * fb, uint16_t hres, uint16_t vres);
+
+/**
+ * Process bytes received from the sender. They can be split anywhere.
+ * @param rx pointer to a receiver
+ * @param data the received bytes
+ * @param len number of bytes
+ * @return false: the stream is invalid, reconnect and initialize the receiver again
+ */
+bool netdisp_rx_feed(netdisp_rx_t * rx, const uint8_t * data, uint32_t len);
+
+/**
+ * Write an INPUT message to send to the sender
+ * @param buf store the message here (`NETDISP_MSG_HDR_SIZE + 5` bytes)
+ * @param x x coordinate of the pointer
+ * @param y y coordinate of the pointer
+ * @param pressed true: pressed
+ * @return length of the message
+ */
+uint32_t netdisp_rx_input(uint8_t * buf, int16_t x, int16_t y, bool pressed);
+
+/**
+ * Write an ACK message to send to the sender when a frame is shown
+ * @param buf store the message here (`NETDISP_MSG_HDR_SIZE + 4` bytes)
+ * @param frame_id ID of the frame from `frame_cb`
+ * @return length of the message
+ */
+uint32_t netdisp_rx_ack(uint8_t * buf, uint32_t frame_id);
+
+#endif /*USE_NETDISP_RX*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_NETDISP || USE_NETDISP_RX */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* NETDISP_H */
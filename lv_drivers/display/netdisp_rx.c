@@ -0,0 +1,317 @@
+/**
+ * @file netdisp_rx.c
+ * The receiver of the network display (see the stream format in `netdisp.h`).
+ * The bytes are parsed as they arrive, a RECT is decoded straight into the frame buffer
+ * without buffering the message, so a small device can show a large stream.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "netdisp.h"
+#if USE_NETDISP_RX
+
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define NETDISP_RX_HELLO_SIZE   9
+#define NETDISP_RX_RECT_SIZE    9
+#define NETDISP_RX_FRAME_SIZE   8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool msg_begin(netdisp_rx_t * rx);
+static void msg_end(netdisp_rx_t * rx);
+static bool rect_byte(netdisp_rx_t * rx, uint8_t b);
+static bool px_put(netdisp_rx_t * rx, uint16_t color, uint32_t cnt);
+static uint8_t fixed_size(uint8_t type);
+static inline uint16_t get16(const uint8_t * p);
+static inline uint32_t get32(const uint8_t * p);
+static inline uint8_t * put32(uint8_t * p, uint32_t v);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize a receiver. Set its callbacks after it.
+ * @param rx pointer to a receiver
+ * @param fb RGB565 frame buffer
+ * @param hres width of the frame buffer, has to be at least the sender's
+ * @param vres height of the frame buffer, has to be at least the sender's
+ */
+void netdisp_rx_init(netdisp_rx_t * rx, uint16_t * fb, uint16_t hres, uint16_t vres)
+{
+    memset(rx, 0, sizeof(netdisp_rx_t));
+    rx->fb   = fb;
+    rx->hres = hres;
+    rx->vres = vres;
+}
+
+/**
+ * Process bytes received from the sender. They can be split anywhere.
+ * @param rx pointer to a receiver
+ * @param data the received bytes
+ * @param len number of bytes
+ * @return false: the stream is invalid, reconnect and initialize the receiver again
+ */
+bool netdisp_rx_feed(netdisp_rx_t * rx, const uint8_t * data, uint32_t len)
+{
+    while(len > 0 && rx->error == 0) {
+        /*Collect the header and the fixed part of the payload*/
+        uint8_t hdr_size = NETDISP_MSG_HDR_SIZE;
+        if(rx->hdr_len >= NETDISP_MSG_HDR_SIZE) hdr_size += fixed_size(rx->hdr[0]);
+        if(rx->hdr_len < hdr_size) {
+            rx->hdr[rx->hdr_len++] = *data++;
+            len--;
+            if(rx->hdr_len == hdr_size) {
+                if(hdr_size == NETDISP_MSG_HDR_SIZE) {
+                    rx->left = get32(&rx->hdr[1]);
+                    /*The message might have a fixed part*/
+                    if(fixed_size(rx->hdr[0]) > 0) continue;
+                }
+                if(msg_begin(rx) == false) rx->error = 1;
+                else if(rx->left == 0) msg_end(rx);
+            }
+            continue;
+        }
+
+        /*The rest of the payload*/
+        uint32_t n = LV_MATH_MIN(len, rx->left);
+        if(rx->hdr[0] == NETDISP_MSG_RECT) {
+            uint32_t i;
+            for(i = 0; i < n; i++) {
+                if(rect_byte(rx, data[i]) == false) {
+                    rx->error = 1;
+                    break;
+                }
+            }
+        }
+        data += n;
+        len -= n;
+        rx->left -= n;
+
+        if(rx->left == 0 && rx->error == 0) msg_end(rx);
+    }
+
+    return rx->error == 0;
+}
+
+/**
+ * Write an INPUT message to send to the sender
+ * @param buf store the message here (`NETDISP_MSG_HDR_SIZE + 5` bytes)
+ * @param x x coordinate of the pointer
+ * @param y y coordinate of the pointer
+ * @param pressed true: pressed
+ * @return length of the message
+ */
+uint32_t netdisp_rx_input(uint8_t * buf, int16_t x, int16_t y, bool pressed)
+{
+    buf[0] = NETDISP_MSG_INPUT;
+    put32(&buf[1], 5);
+    buf[5] = (uint16_t)x & 0xFF;
+    buf[6] = (uint16_t)x >> 8;
+    buf[7] = (uint16_t)y & 0xFF;
+    buf[8] = (uint16_t)y >> 8;
+    buf[9] = pressed ? 1 : 0;
+    return NETDISP_MSG_HDR_SIZE + 5;
+}
+
+/**
+ * Write an ACK message to send to the sender when a frame is shown
+ * @param buf store the message here (`NETDISP_MSG_HDR_SIZE + 4` bytes)
+ * @param frame_id ID of the frame from `frame_cb`
+ * @return length of the message
+ */
+uint32_t netdisp_rx_ack(uint8_t * buf, uint32_t frame_id)
+{
+    buf[0] = NETDISP_MSG_ACK;
+    put32(&buf[1], 4);
+    put32(&buf[5], frame_id);
+    return NETDISP_MSG_HDR_SIZE + 4;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Process the fixed part of a message
+ * @param rx pointer to a receiver
+ * @return false: invalid message
+ */
+static bool msg_begin(netdisp_rx_t * rx)
+{
+    const uint8_t * p = &rx->hdr[NETDISP_MSG_HDR_SIZE];
+    uint8_t fixed     = fixed_size(rx->hdr[0]);
+    if(rx->left < fixed) return false;
+    rx->left -= fixed;
+
+    switch(rx->hdr[0]) {
+        case NETDISP_MSG_HELLO:
+            if(get32(p) != NETDISP_MAGIC || p[4] != NETDISP_VERSION) return false;
+            if(get16(&p[5]) > rx->hres || get16(&p[7]) > rx->vres) return false;
+            rx->hello = 1;
+            break;
+        case NETDISP_MSG_RECT:
+            if(rx->hello == 0) return false;
+            rx->x1      = get16(p);
+            rx->y1      = get16(&p[2]);
+            rx->w       = get16(&p[4]);
+            rx->h       = get16(&p[6]);
+            rx->enc     = p[8];
+            rx->x       = rx->x1;
+            rx->y       = rx->y1;
+            rx->px_left = (uint32_t)rx->w * rx->h;
+            rx->tok_len = 0;
+            rx->pal_cnt = 0;
+            if(rx->enc >= _NETDISP_ENC_NUM || rx->w == 0 || rx->h == 0) return false;
+            if((uint32_t)rx->x1 + rx->w > rx->hres || (uint32_t)rx->y1 + rx->h > rx->vres) return false;
+            break;
+        case NETDISP_MSG_FRAME:
+            if(rx->frame_cb) rx->frame_cb(rx, get32(p));
+            break;
+        default:
+            /*Unknown messages are skipped*/
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * Finish a message when all its payload is read
+ * @param rx pointer to a receiver
+ */
+static void msg_end(netdisp_rx_t * rx)
+{
+    if(rx->hdr[0] == NETDISP_MSG_RECT) {
+        if(rx->px_left != 0 || rx->tok_len != 0) {
+            rx->error = 1;
+            return;
+        }
+        if(rx->rect_cb) rx->rect_cb(rx, rx->x1, rx->y1, rx->x1 + rx->w - 1, rx->y1 + rx->h - 1);
+    }
+
+    rx->hdr_len = 0;
+}
+
+/**
+ * Decode a byte of a RECT's pixels
+ * @param rx pointer to a receiver
+ * @param b the byte
+ * @return false: invalid data
+ */
+static bool rect_byte(netdisp_rx_t * rx, uint8_t b)
+{
+    rx->tok[rx->tok_len++] = b;
+
+    switch(rx->enc) {
+        case NETDISP_ENC_RAW:
+            if(rx->tok_len < 2) return true;
+            rx->tok_len = 0;
+            return px_put(rx, get16(rx->tok), 1);
+        case NETDISP_ENC_RLE:
+            if(rx->tok_len < 3) return true;
+            rx->tok_len = 0;
+            return px_put(rx, get16(&rx->tok[1]), rx->tok[0] + 1);
+        default:
+            if(rx->pal_cnt == 0) {
+                if(b >= NETDISP_PAL_MAX) return false;
+                rx->pal_cnt  = b + 1;
+                rx->pal_read = 0;
+                rx->tok_len  = 0;
+                return true;
+            }
+            if(rx->pal_read < rx->pal_cnt) {
+                if(rx->tok_len < 2) return true;
+                rx->pal[rx->pal_read++] = get16(rx->tok);
+                rx->tok_len             = 0;
+                return true;
+            }
+            rx->tok_len = 0;
+            if((b >> 4) >= rx->pal_cnt) return false;
+            return px_put(rx, rx->pal[b >> 4], (b & 0xF) + 1);
+    }
+}
+
+/**
+ * Write the next pixels of a RECT into the frame buffer
+ * @param rx pointer to a receiver
+ * @param color RGB565 color
+ * @param cnt number of pixels
+ * @return false: more pixels than the RECT has
+ */
+static bool px_put(netdisp_rx_t * rx, uint16_t color, uint32_t cnt)
+{
+    if(cnt > rx->px_left) return false;
+    rx->px_left -= cnt;
+
+    uint16_t x2 = rx->x1 + rx->w;
+    while(cnt > 0) {
+        uint32_t n    = LV_MATH_MIN(cnt, (uint32_t)(x2 - rx->x));
+        uint16_t * fb = &rx->fb[(uint32_t)rx->y * rx->hres + rx->x];
+        uint32_t i;
+        for(i = 0; i < n; i++) fb[i] = color;
+
+        cnt -= n;
+        rx->x += n;
+        if(rx->x == x2) {
+            rx->x = rx->x1;
+            rx->y++;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Get the size of the fixed part of a message's payload
+ * @param type type of the message
+ * @return size in bytes
+ */
+static uint8_t fixed_size(uint8_t type)
+{
+    switch(type) {
+        case NETDISP_MSG_HELLO: return NETDISP_RX_HELLO_SIZE;
+        case NETDISP_MSG_RECT: return NETDISP_RX_RECT_SIZE;
+        case NETDISP_MSG_FRAME: return NETDISP_RX_FRAME_SIZE;
+        default: return 0;
+    }
+}
+
+static inline uint16_t get16(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t get32(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint8_t * put32(uint8_t * p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+    return p + 4;
+}
+
+#endif /*USE_NETDISP_RX*/
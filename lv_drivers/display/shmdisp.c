@@ -0,0 +1,313 @@
+/**
+ * @file shmdisp.c
+ * The sender of the shared memory display (see the layout in `shmdisp.h`).
+ * The flushed areas are copied into the buffer of the frame being drawn, the only copy of the pixels:
+ * the readers use them in place. Before the first area of a frame the buffer is brought up to date
+ * with the areas of the previous frame, so every published buffer holds the whole screen.
+ * Publishing never waits for the readers, a slow one sees that it was overtaken and reads the next frame.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "shmdisp.h"
+#if USE_SHMDISP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SHMDISP_PAGE_SIZE       4096
+#define SHMDISP_PX_ALIGN        64      /*Of the pixels in a buffer, a cache line*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void shmdisp_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void shmdisp_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void frame_begin(void);
+static void damage_add(shmdisp_buf_hdr_t * buf, const lv_area_t * area);
+static void area_copy(uint8_t * dest, const uint8_t * src, uint32_t src_stride, const lv_area_t * area);
+static void seg_close(void);
+static void screen_invalidate(void);
+static inline shmdisp_buf_hdr_t * buf_get(uint32_t seq);
+static inline uint8_t * buf_px(shmdisp_buf_hdr_t * buf);
+static inline uint32_t seq_next(uint32_t seq);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_disp_drv_t * disp_drv;
+static void (*flush_orig)(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void (*monitor_orig)(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static char seg_name[NAME_MAX + 1];
+static shmdisp_hdr_t * hdr;         /*The mapped segment*/
+static size_t seg_size;
+static shmdisp_buf_hdr_t * cur_buf; /*The buffer of the frame being drawn, NULL between the frames*/
+static shmdisp_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Create a shared memory segment and publish the frames of a display in it.
+ * The flushed areas are copied in the display's `flush_cb` and a frame ends in its `monitor_cb`;
+ * both are wrapped, so call it after they are set and the display is registered.
+ * The segment is removed when the process exits.
+ * @param drv pointer to the driver of a registered display (`&disp->driver`)
+ * @param name name of the segment, e.g. "/lv_gui_designer" (the '/' is added if it's missing)
+ * @return true: publishing; false: the segment couldn't be created
+ */
+bool shmdisp_init(lv_disp_drv_t * drv, const char * name)
+{
+    snprintf(seg_name, sizeof(seg_name), "%s%s", name[0] == '/' ? "" : "/", name);
+
+    uint32_t stride   = drv->hor_res * sizeof(lv_color_t);
+    uint32_t px_off   = (sizeof(shmdisp_buf_hdr_t) + SHMDISP_PX_ALIGN - 1) & ~(SHMDISP_PX_ALIGN - 1);
+    uint32_t buf_size = px_off + stride * drv->ver_res;
+    buf_size          = (buf_size + SHMDISP_PAGE_SIZE - 1) & ~(SHMDISP_PAGE_SIZE - 1);
+    seg_size          = SHMDISP_HDR_SIZE + (size_t)buf_size * SHMDISP_BUF_CNT;
+
+    /*A segment left by a crashed sender is replaced, its readers keep their old mapping*/
+    shm_unlink(seg_name);
+    int fd = shm_open(seg_name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if(fd < 0) {
+        perror("shmdisp: shm_open");
+        return false;
+    }
+    if(ftruncate(fd, seg_size) < 0) {
+        perror("shmdisp: ftruncate");
+        close(fd);
+        shm_unlink(seg_name);
+        return false;
+    }
+    void * map = mmap(NULL, seg_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);      /*The mapping stays valid*/
+    if(map == MAP_FAILED) {
+        perror("shmdisp: mmap");
+        shm_unlink(seg_name);
+        return false;
+    }
+
+    /*The new segment is zeroed, no frame and every buffer free*/
+    hdr                = map;
+    hdr->magic         = SHMDISP_MAGIC;
+    hdr->version       = SHMDISP_VERSION;
+    hdr->buf_cnt       = SHMDISP_BUF_CNT;
+    hdr->hor_res       = drv->hor_res;
+    hdr->ver_res       = drv->ver_res;
+    hdr->color_depth   = LV_COLOR_DEPTH;
+    hdr->color_16_swap = LV_COLOR_16_SWAP;
+    hdr->stride        = stride;
+    hdr->buf_offset    = SHMDISP_HDR_SIZE;
+    hdr->buf_size      = buf_size;
+    hdr->px_offset     = px_off;
+    hdr->pid           = getpid();
+    atexit(seg_close);
+
+    disp_drv        = drv;
+    flush_orig      = drv->flush_cb;
+    monitor_orig    = drv->monitor_cb;
+    drv->flush_cb   = shmdisp_flush;
+    drv->monitor_cb = shmdisp_monitor;
+
+    /*The first frame fills the buffer, the next ones update it*/
+    screen_invalidate();
+    return true;
+}
+
+/**
+ * Get the statistics of the publishing
+ * @param stat_p store the statistics here
+ * @param reset true: start counting again
+ */
+void shmdisp_get_stat(shmdisp_stat_t * stat_p, bool reset)
+{
+    *stat_p = stat;
+    if(reset) memset(&stat, 0, sizeof(stat));
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Copy a flushed area into the buffer of the frame and flush it to the display too
+ */
+static void shmdisp_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    /*Copy it before the original `flush_cb` gives the buffer back to LittlevGL.
+     *The rounder might have made it larger than the screen.*/
+    lv_area_t scr_a;
+    lv_area_t copy_a;
+    lv_area_set(&scr_a, 0, 0, disp_drv->hor_res - 1, disp_drv->ver_res - 1);
+    if(lv_area_intersect(&copy_a, area, &scr_a)) {
+        if(cur_buf == NULL) frame_begin();
+
+        uint32_t area_w = lv_area_get_width(area);
+        const lv_color_t * src = color_p + (copy_a.y1 - area->y1) * area_w + (copy_a.x1 - area->x1);
+        area_copy(buf_px(cur_buf), (const uint8_t *)src, area_w * sizeof(lv_color_t), &copy_a);
+        damage_add(cur_buf, &copy_a);
+
+        stat.area_cnt++;
+        stat.px_cnt += lv_area_get_size(&copy_a);
+    }
+
+    flush_orig(drv, area, color_p);
+}
+
+/**
+ * Publish the frame after a refresh: its areas are all in the buffer
+ */
+static void shmdisp_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    if(cur_buf) {
+        uint32_t seq  = seq_next(hdr->seq);
+        cur_buf->tick = lv_tick_get() - time;
+
+        /*The pixels before the numbers, the readers load them in the other order*/
+        __atomic_store_n(&cur_buf->seq, seq, __ATOMIC_RELEASE);
+        __atomic_store_n(&hdr->seq, seq, __ATOMIC_RELEASE);
+        syscall(SYS_futex, &hdr->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+
+        cur_buf = NULL;
+        stat.frame_cnt++;
+    }
+
+    if(monitor_orig) monitor_orig(drv, time, px);
+}
+
+/**
+ * Take the buffer of the next frame from the readers and bring it up to date:
+ * it's two frames old, the areas of the previous frame are copied from its buffer.
+ */
+static void frame_begin(void)
+{
+    uint32_t prev_seq = hdr->seq;
+    cur_buf           = buf_get(seq_next(prev_seq));
+
+    /*A reader of the old frame in it sees the 0 after reading*/
+    __atomic_store_n(&cur_buf->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    cur_buf->damage_cnt = 0;
+    if(prev_seq == 0) return;
+
+    shmdisp_buf_hdr_t * prev = buf_get(prev_seq);
+    uint32_t i;
+    for(i = 0; i < prev->damage_cnt; i++) {
+        const shmdisp_area_t * d = &prev->damage[i];
+        lv_area_t a;
+        lv_area_set(&a, d->x1, d->y1, d->x2, d->y2);
+        area_copy(buf_px(cur_buf), buf_px(prev) + d->y1 * hdr->stride + d->x1 * sizeof(lv_color_t), hdr->stride, &a);
+        stat.carry_px_cnt += lv_area_get_size(&a);
+    }
+}
+
+/**
+ * Add a flushed area to the damage of the frame.
+ * The stripes of a partial display buffer are merged, the areas over `SHMDISP_DAMAGE_MAX` are joined to the last one.
+ */
+static void damage_add(shmdisp_buf_hdr_t * buf, const lv_area_t * area)
+{
+    if(buf->damage_cnt > 0) {
+        shmdisp_area_t * last = &buf->damage[buf->damage_cnt - 1];
+        bool below            = last->x1 == area->x1 && last->x2 == area->x2 && last->y2 + 1 == area->y1;
+        if(below || buf->damage_cnt == SHMDISP_DAMAGE_MAX) {
+            last->x1 = LV_MATH_MIN(last->x1, area->x1);
+            last->y1 = LV_MATH_MIN(last->y1, area->y1);
+            last->x2 = LV_MATH_MAX(last->x2, area->x2);
+            last->y2 = LV_MATH_MAX(last->y2, area->y2);
+            return;
+        }
+    }
+
+    shmdisp_area_t * d = &buf->damage[buf->damage_cnt++];
+    d->x1              = area->x1;
+    d->y1              = area->y1;
+    d->x2              = area->x2;
+    d->y2              = area->y2;
+}
+
+/**
+ * Copy the rows of an area into the pixels of a buffer
+ * @param dest the pixels of the buffer
+ * @param src the first pixel of the area
+ * @param src_stride bytes of a row of `src`
+ * @param area the area on the screen
+ */
+static void area_copy(uint8_t * dest, const uint8_t * src, uint32_t src_stride, const lv_area_t * area)
+{
+    uint32_t len = lv_area_get_width(area) * sizeof(lv_color_t);
+    dest += area->y1 * hdr->stride + area->x1 * sizeof(lv_color_t);
+
+    lv_coord_t y;
+    for(y = area->y1; y <= area->y2; y++) {
+        memcpy(dest, src, len);
+        dest += hdr->stride;
+        src += src_stride;
+    }
+}
+
+/**
+ * Tell the readers that no more frames come and remove the segment at exit
+ */
+static void seg_close(void)
+{
+    __atomic_store_n(&hdr->closed, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, &hdr->seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+    shm_unlink(seg_name);
+}
+
+/**
+ * Redraw the whole screen of the published display
+ */
+static void screen_invalidate(void)
+{
+    lv_disp_t * disp = lv_disp_get_next(NULL);
+    while(disp && &disp->driver != disp_drv) disp = lv_disp_get_next(disp);
+    if(disp == NULL) return;
+
+    lv_area_t scr_a;
+    lv_area_set(&scr_a, 0, 0, disp_drv->hor_res - 1, disp_drv->ver_res - 1);
+    lv_inv_area(disp, &scr_a);
+}
+
+static inline shmdisp_buf_hdr_t * buf_get(uint32_t seq)
+{
+    return (shmdisp_buf_hdr_t *)((uint8_t *)hdr + hdr->buf_offset + (seq % SHMDISP_BUF_CNT) * hdr->buf_size);
+}
+
+static inline uint8_t * buf_px(shmdisp_buf_hdr_t * buf)
+{
+    return (uint8_t *)buf + hdr->px_offset;
+}
+
+/**
+ * The number of the frame after an other. 0 is skipped so that the buffers still alternate.
+ */
+static inline uint32_t seq_next(uint32_t seq)
+{
+    seq++;
+    return seq != 0 ? seq : SHMDISP_BUF_CNT;
+}
+
+#endif /*USE_SHMDISP*/
@@ -0,0 +1,184 @@
+/**
+ * @file shmdisp.h
+ * Publish the frame buffer of a display in a POSIX shared memory segment for other processes
+ * (screen recorders, remote viewers, test harnesses). They map it and read the frames in place,
+ * without copying them through a socket or the window system.
+ * `shmdisp.c` is the sender, `shmdisp_rx.c` a reader for the consumers.
+ *
+ * Layout of the segment (native byte order, the reader runs on the same machine):
+ *   header     `shmdisp_hdr_t`, `SHMDISP_HDR_SIZE` bytes
+ *   buffers    `SHMDISP_BUF_CNT` times `buf_size` bytes from `buf_offset`. Every buffer is a `shmdisp_buf_hdr_t`
+ *              and the pixels of the whole screen from `px_offset`: `ver_res` rows of `stride` bytes,
+ *              `lv_color_t` of `color_depth` bits (RGB565 byte swapped if `color_16_swap`)
+ * Frame `seq` is written into buffer `seq % SHMDISP_BUF_CNT`, which holds the whole screen after it.
+ * Its `damage` lists the areas changed since frame `seq - 1`. The buffer's `seq` is 0 while it's written,
+ * then the header's `seq` is set to the frame and the futex on it is woken.
+ * A reader has the time of a frame to read the buffer: then the sender begins to write it again.
+ * It checks the buffer's `seq` after reading, if it's changed the read pixels might be torn.
+ * The frames are numbered from 1 and 0 is skipped when the number wraps around.
+ */
+
+#ifndef SHMDISP_H
+#define SHMDISP_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_SHMDISP || USE_SHMDISP_RX
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SHMDISP_MAGIC           0x4D53564CUL    /*"LVSM" in little endian*/
+#define SHMDISP_VERSION         1
+#define SHMDISP_HDR_SIZE        4096            /*The buffers begin on their own page*/
+#define SHMDISP_BUF_CNT         2               /*The readers have the previous frame while the next one is written*/
+#define SHMDISP_DAMAGE_MAX      64              /*Areas listed per frame, the further ones are joined to the last*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint16_t x1;
+    uint16_t y1;
+    uint16_t x2;                        /*Inclusive like `lv_area_t`*/
+    uint16_t y2;
+} shmdisp_area_t;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t buf_cnt;
+    uint16_t hor_res;
+    uint16_t ver_res;
+    uint8_t color_depth;                /*`LV_COLOR_DEPTH` of the sender*/
+    uint8_t color_16_swap;
+    uint8_t closed;                     /*The sender exited, no more frames come*/
+    uint8_t reserved;
+    uint32_t stride;                    /*Bytes of a row of pixels*/
+    uint32_t buf_offset;                /*Of the first buffer from the start of the segment*/
+    uint32_t buf_size;                  /*Of a buffer with its header*/
+    uint32_t px_offset;                 /*Of the pixels from the start of a buffer*/
+    uint32_t pid;                       /*Of the sender*/
+    uint32_t seq;                       /*The last complete frame, 0: none yet. Futex, woken after every frame.*/
+} shmdisp_hdr_t;
+
+typedef struct {
+    uint32_t seq;                       /*The frame in the buffer, 0 while it's written*/
+    uint32_t tick;                      /*`lv_tick_get()` of the sender when drawing the frame began*/
+    uint32_t damage_cnt;
+    uint32_t reserved;
+    shmdisp_area_t damage[SHMDISP_DAMAGE_MAX];
+} shmdisp_buf_hdr_t;
+
+typedef struct {
+    uint32_t frame_cnt;                 /*Frames published*/
+    uint32_t area_cnt;                  /*Flushed areas written into the buffers*/
+    uint32_t px_cnt;                    /*Pixels of the flushed areas*/
+    uint32_t carry_px_cnt;              /*Pixels copied from the previous buffer to bring a buffer up to date*/
+} shmdisp_stat_t;
+
+#if USE_SHMDISP_RX
+/*A frame being read, its pixels and areas point into the segment*/
+typedef struct {
+    const uint8_t * px;                 /*The first pixel of the screen, rows of `hdr->stride` bytes*/
+    const shmdisp_area_t * damage;
+    uint32_t damage_cnt;
+    uint32_t seq;
+    uint32_t tick;
+    bool all;                           /*Frames were skipped (or it's the first one): take the whole screen, not the damage*/
+} shmdisp_frame_t;
+
+typedef struct {
+    const shmdisp_hdr_t * hdr;          /*The mapped segment*/
+    size_t size;
+    uint32_t last_seq;                  /*The last frame read without tearing, 0: none*/
+} shmdisp_rx_t;
+#endif
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if USE_SHMDISP
+
+/**
+ * Create a shared memory segment and publish the frames of a display in it.
+ * The flushed areas are copied in the display's `flush_cb` and a frame ends in its `monitor_cb`;
+ * both are wrapped, so call it after they are set and the display is registered.
+ * The segment is removed when the process exits.
+ * @param drv pointer to the driver of a registered display (`&disp->driver`)
+ * @param name name of the segment, e.g. "/lv_gui_designer" (the '/' is added if it's missing)
+ * @return true: publishing; false: the segment couldn't be created
+ */
+bool shmdisp_init(lv_disp_drv_t * drv, const char * name);
+
+/**
+ * Get the statistics of the publishing
+ * @param stat_p store the statistics here
+ * @param reset true: start counting again
+ */
+void shmdisp_get_stat(shmdisp_stat_t * stat_p, bool reset);
+
+#endif /*USE_SHMDISP*/
+
+#if USE_SHMDISP_RX
+
+/**
+ * Map the segment of a sender for reading
+ * @param rx pointer to a reader
+ * @param name name of the segment given to `shmdisp_init`
+ * @return false: there's no such segment or it's of an other version
+ */
+bool shmdisp_rx_open(shmdisp_rx_t * rx, const char * name);
+
+/**
+ * Wait for a frame newer than the last one read. Read its pixels and call `shmdisp_rx_done`.
+ * @param rx pointer to a reader
+ * @param frame store the frame here
+ * @param timeout [ms] to wait at most
+ * @return false: no new frame in time or the sender exited (`rx->hdr->closed`)
+ */
+bool shmdisp_rx_wait(shmdisp_rx_t * rx, shmdisp_frame_t * frame, uint32_t timeout);
+
+/**
+ * Finish reading a frame
+ * @param rx pointer to a reader
+ * @param frame the frame of `shmdisp_rx_wait`
+ * @return false: the sender was writing the buffer meanwhile, drop the read pixels (the next frame has `all` set)
+ */
+bool shmdisp_rx_done(shmdisp_rx_t * rx, const shmdisp_frame_t * frame);
+
+/**
+ * Unmap the segment
+ * @param rx pointer to a reader
+ */
+void shmdisp_rx_close(shmdisp_rx_t * rx);
+
+#endif /*USE_SHMDISP_RX*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_SHMDISP || USE_SHMDISP_RX */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* SHMDISP_H */
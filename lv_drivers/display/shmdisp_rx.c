@@ -0,0 +1,185 @@
+/**
+ * @file shmdisp_rx.c
+ * A reader of the shared memory display (see the layout in `shmdisp.h`), e.g. for a screen recorder.
+ * The segment is mapped read-only, the reader can't disturb the sender or the other readers.
+ * It sleeps on the futex of the frame number until the sender publishes a frame.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "shmdisp.h"
+#if USE_SHMDISP_RX
+
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static inline const shmdisp_buf_hdr_t * buf_get(const shmdisp_rx_t * rx, uint32_t seq);
+static inline uint32_t seq_next(uint32_t seq);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Map the segment of a sender for reading
+ * @param rx pointer to a reader
+ * @param name name of the segment given to `shmdisp_init`
+ * @return false: there's no such segment or it's of an other version
+ */
+bool shmdisp_rx_open(shmdisp_rx_t * rx, const char * name)
+{
+    rx->hdr      = NULL;
+    rx->size     = 0;
+    rx->last_seq = 0;
+
+    int fd = shm_open(name, O_RDONLY, 0);
+    if(fd < 0) return false;
+
+    struct stat st;
+    void * map = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size >= SHMDISP_HDR_SIZE) {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);      /*The mapping stays valid*/
+    if(map == MAP_FAILED) return false;
+
+    const shmdisp_hdr_t * hdr = map;
+    if(hdr->magic != SHMDISP_MAGIC || hdr->version != SHMDISP_VERSION || hdr->buf_cnt != SHMDISP_BUF_CNT ||
+       (off_t)hdr->buf_offset + (off_t)hdr->buf_size * SHMDISP_BUF_CNT > st.st_size) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    rx->hdr  = hdr;
+    rx->size = st.st_size;
+    return true;
+}
+
+/**
+ * Wait for a frame newer than the last one read. Read its pixels and call `shmdisp_rx_done`.
+ * @param rx pointer to a reader
+ * @param frame store the frame here
+ * @param timeout [ms] to wait at most
+ * @return false: no new frame in time or the sender exited (`rx->hdr->closed`)
+ */
+bool shmdisp_rx_wait(shmdisp_rx_t * rx, shmdisp_frame_t * frame, uint32_t timeout)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    end.tv_sec += timeout / 1000;
+    end.tv_nsec += (long)(timeout % 1000) * 1000000;
+    if(end.tv_nsec >= 1000000000) {
+        end.tv_sec++;
+        end.tv_nsec -= 1000000000;
+    }
+
+    while(1) {
+        if(__atomic_load_n(&rx->hdr->closed, __ATOMIC_ACQUIRE)) return false;
+
+        uint32_t seq = __atomic_load_n(&rx->hdr->seq, __ATOMIC_ACQUIRE);
+        if(seq != 0 && seq != rx->last_seq) {
+            const shmdisp_buf_hdr_t * buf = buf_get(rx, seq);
+            /*0 or a newer frame: the sender is already writing the buffer again, take the next frame*/
+            if(__atomic_load_n(&buf->seq, __ATOMIC_ACQUIRE) == seq) {
+                frame->px         = (const uint8_t *)buf + rx->hdr->px_offset;
+                frame->damage     = buf->damage;
+                frame->damage_cnt = LV_MATH_MIN(buf->damage_cnt, SHMDISP_DAMAGE_MAX);
+                frame->seq        = seq;
+                frame->tick       = buf->tick;
+                frame->all        = rx->last_seq == 0 || seq_next(rx->last_seq) != seq;
+                return true;
+            }
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        struct timespec left;
+        left.tv_sec  = end.tv_sec - now.tv_sec;
+        left.tv_nsec = end.tv_nsec - now.tv_nsec;
+        if(left.tv_nsec < 0) {
+            left.tv_sec--;
+            left.tv_nsec += 1000000000;
+        }
+        if(left.tv_sec < 0) return false;
+
+        /*Returns at once if the frame number isn't `seq` any more*/
+        if(syscall(SYS_futex, &rx->hdr->seq, FUTEX_WAIT, seq, &left, NULL, 0) < 0 && errno == ETIMEDOUT) return false;
+    }
+}
+
+/**
+ * Finish reading a frame
+ * @param rx pointer to a reader
+ * @param frame the frame of `shmdisp_rx_wait`
+ * @return false: the sender was writing the buffer meanwhile, drop the read pixels (the next frame has `all` set)
+ */
+bool shmdisp_rx_done(shmdisp_rx_t * rx, const shmdisp_frame_t * frame)
+{
+    /*The pixels are read before the number is checked again*/
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if(__atomic_load_n(&buf_get(rx, frame->seq)->seq, __ATOMIC_RELAXED) != frame->seq) {
+        rx->last_seq = 0;
+        return false;
+    }
+
+    rx->last_seq = frame->seq;
+    return true;
+}
+
+/**
+ * Unmap the segment
+ * @param rx pointer to a reader
+ */
+void shmdisp_rx_close(shmdisp_rx_t * rx)
+{
+    if(rx->hdr) munmap((void *)rx->hdr, rx->size);
+    rx->hdr  = NULL;
+    rx->size = 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static inline const shmdisp_buf_hdr_t * buf_get(const shmdisp_rx_t * rx, uint32_t seq)
+{
+    return (const shmdisp_buf_hdr_t *)((const uint8_t *)rx->hdr + rx->hdr->buf_offset +
+                                       (seq % SHMDISP_BUF_CNT) * rx->hdr->buf_size);
+}
+
+/**
+ * The number of the frame after an other, like the sender's
+ */
+static inline uint32_t seq_next(uint32_t seq)
+{
+    seq++;
+    return seq != 0 ? seq : SHMDISP_BUF_CNT;
+}
+
+#endif /*USE_SHMDISP_RX*/
@@ -0,0 +1,158 @@
+/**
+ * @file soft_gpu.c
+ * A reference implementation of the GPU callbacks of the display driver on the CPU.
+ * It lets the simulator run the `LV_USE_GPU` paths of the drawing and count the pixels
+ * a real GPU would get. SDL's renderer can't draw into LittlevGL's buffer without a round trip
+ * through a texture, so the pixels are written with wide copies and the `lv_draw_simd` kernels.
+ * The callbacks are called by every drawing thread (`LV_REFR_THREADS`) in parallel.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "soft_gpu.h"
+#if USE_SOFT_GPU
+
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef SOFT_GPU_MIN_PX
+#define SOFT_GPU_MIN_PX     16
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void stat_add(uint32_t * cnt, uint32_t px);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static soft_gpu_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Set the GPU callbacks of a display driver. Call it before `lv_disp_drv_register`.
+ * @param drv pointer to a display driver
+ */
+void soft_gpu_init(lv_disp_drv_t * drv)
+{
+    drv->gpu_fill_cb  = soft_gpu_fill;
+    drv->gpu_blend_cb = soft_gpu_blend;
+}
+
+/**
+ * Fill an area with a color. LittlevGL calls it for the opaque fills wider than `VFILL_HW_ACC_SIZE_LIMIT`.
+ * @param drv pointer to the display driver
+ * @param dest_buf the buffer to draw into
+ * @param dest_width width of `dest_buf` in pixels
+ * @param fill_area the area to fill relative to `dest_buf`
+ * @param color the fill color
+ */
+void soft_gpu_fill(lv_disp_drv_t * drv, lv_color_t * dest_buf, lv_coord_t dest_width, const lv_area_t * fill_area,
+                   lv_color_t color)
+{
+    (void)drv;
+
+    uint32_t w          = lv_area_get_width(fill_area);
+    lv_coord_t h        = lv_area_get_height(fill_area);
+    lv_color_t * first  = &dest_buf[(uint32_t)fill_area->y1 * dest_width + fill_area->x1];
+
+    /*Fill the first row by doubling the filled part so it's written by wide copies as the other rows*/
+    first[0]      = color;
+    uint32_t done = 1;
+    while(done < w) {
+        uint32_t n = LV_MATH_MIN(done, w - done);
+        memcpy(&first[done], first, n * sizeof(lv_color_t));
+        done += n;
+    }
+
+    lv_color_t * row = first;
+    lv_coord_t y;
+    for(y = 1; y < h; y++) {
+        row += dest_width;
+        memcpy(row, first, w * sizeof(lv_color_t));
+    }
+
+    stat_add(&stat.fill_px, w * h);
+    stat_add(&stat.call_cnt, 1);
+}
+
+/**
+ * Blend pixels to a buffer: `dest = lv_color_mix(src, dest, opa)`. Used for the images and the translucent fills.
+ * @param drv pointer to the display driver
+ * @param dest the pixels to draw to
+ * @param src the pixels to draw
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ */
+void soft_gpu_blend(lv_disp_drv_t * drv, lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    (void)drv;
+
+    uint32_t i = 0;
+    if(opa >= LV_OPA_MAX) {
+        memcpy(dest, src, length * sizeof(lv_color_t));
+        stat_add(&stat.blend_px, length);
+    } else if(length < SOFT_GPU_MIN_PX) {
+        for(; i < length; i++) dest[i] = lv_color_mix(src[i], dest[i], opa);
+        stat_add(&stat.sw_px, length);
+    } else {
+#if LV_USE_SIMD
+        i = lv_draw_simd_blend(dest, src, length, opa);
+#endif
+        for(; i < length; i++) dest[i] = lv_color_mix(src[i], dest[i], opa);
+        stat_add(&stat.blend_px, length);
+    }
+
+    stat_add(&stat.call_cnt, 1);
+}
+
+/**
+ * Get the number of pixels drawn by the callbacks
+ * @param stat_p the statistics are copied here
+ * @param reset true: start counting from zero (e.g. to get the pixels of every frame)
+ */
+void soft_gpu_get_stat(soft_gpu_stat_t * stat_p, bool reset)
+{
+    if(reset) {
+        stat_p->fill_px  = __atomic_exchange_n(&stat.fill_px, 0, __ATOMIC_RELAXED);
+        stat_p->blend_px = __atomic_exchange_n(&stat.blend_px, 0, __ATOMIC_RELAXED);
+        stat_p->sw_px    = __atomic_exchange_n(&stat.sw_px, 0, __ATOMIC_RELAXED);
+        stat_p->call_cnt = __atomic_exchange_n(&stat.call_cnt, 0, __ATOMIC_RELAXED);
+    } else {
+        stat_p->fill_px  = __atomic_load_n(&stat.fill_px, __ATOMIC_RELAXED);
+        stat_p->blend_px = __atomic_load_n(&stat.blend_px, __ATOMIC_RELAXED);
+        stat_p->sw_px    = __atomic_load_n(&stat.sw_px, __ATOMIC_RELAXED);
+        stat_p->call_cnt = __atomic_load_n(&stat.call_cnt, __ATOMIC_RELAXED);
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Add to a counter of `stat` from any drawing thread
+ * @param cnt pointer to a counter
+ * @param px value to add
+ */
+static void stat_add(uint32_t * cnt, uint32_t px)
+{
+    __atomic_fetch_add(cnt, px, __ATOMIC_RELAXED);
+}
+
+#endif /*USE_SOFT_GPU*/
@@ -0,0 +1,61 @@
+/**
+ * @file soft_gpu.h
+ *
+ */
+
+#ifndef SOFT_GPU_H
+#define SOFT_GPU_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_SOFT_GPU
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    uint32_t fill_px;       /*Pixels filled by `soft_gpu_fill`*/
+    uint32_t blend_px;      /*Pixels blended by `soft_gpu_blend` with the vector kernels or copied*/
+    uint32_t sw_px;         /*Pixels of the spans shorter than SOFT_GPU_MIN_PX blended with a plain loop*/
+    uint32_t call_cnt;      /*Calls of the callbacks*/
+} soft_gpu_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void soft_gpu_init(lv_disp_drv_t * drv);
+void soft_gpu_fill(lv_disp_drv_t * drv, lv_color_t * dest_buf, lv_coord_t dest_width, const lv_area_t * fill_area,
+                   lv_color_t color);
+void soft_gpu_blend(lv_disp_drv_t * drv, lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+void soft_gpu_get_stat(soft_gpu_stat_t * stat_p, bool reset);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_SOFT_GPU */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* SOFT_GPU_H */
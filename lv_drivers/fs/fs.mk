@@ -0,0 +1,6 @@
+CSRCS += posix_fs.c
+
+DEPPATH += --dep-path $(LVGL_DIR)/lv_drivers/fs
+VPATH += :$(LVGL_DIR)/lv_drivers/fs
+
+CFLAGS += "-I$(LVGL_DIR)/lv_drivers/fs"
@@ -0,0 +1,243 @@
+/**
+ * @file posix_fs.c
+ * An lv_fs driver for the files of a POSIX system (Linux, macOS, the simulator).
+ * The files opened for reading are memory mapped: reads are copies from the mapping without system calls,
+ * and `lv_fs_map` gives the content in place, so e.g. the image decoder draws true color `.bin` images
+ * without reading them at all. Such files don't need lv_fs's read cache, the driver turns it off.
+ * If a file can't be mapped (or POSIX_FS_MMAP is 0) it's read with `read`, through lv_fs's cache.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "posix_fs.h"
+#if USE_POSIX_FS
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef POSIX_FS_MMAP
+#define POSIX_FS_MMAP       1
+#endif
+
+#define POSIX_FS_PATH_MAX   256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int fd;
+    const uint8_t * map;    /*The content of a mapped file, NULL if it's read with `read`*/
+    uint32_t size;          /*Of the mapped file*/
+    uint32_t pos;           /*Position in the mapped file*/
+} posix_fs_file_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_fs_res_t fs_open(lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode);
+static lv_fs_res_t fs_close(lv_fs_drv_t * drv, void * file_p);
+static lv_fs_res_t fs_remove(lv_fs_drv_t * drv, const char * path);
+static lv_fs_res_t fs_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br);
+static lv_fs_res_t fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t btw, uint32_t * bw);
+static lv_fs_res_t fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos);
+static lv_fs_res_t fs_tell(lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p);
+static lv_fs_res_t fs_size(lv_fs_drv_t * drv, void * file_p, uint32_t * size_p);
+static lv_fs_res_t fs_map(lv_fs_drv_t * drv, void * file_p, const void ** ptr_p, uint32_t * size_p);
+static bool full_path(char * buf, const char * path);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Register the driver with the letter POSIX_FS_LETTER. Call it after `lv_init`.
+ */
+void posix_fs_init(void)
+{
+    lv_fs_drv_t drv;
+    lv_fs_drv_init(&drv);
+
+    drv.letter    = POSIX_FS_LETTER;
+    drv.file_size = sizeof(posix_fs_file_t);
+    drv.open_cb   = fs_open;
+    drv.close_cb  = fs_close;
+    drv.remove_cb = fs_remove;
+    drv.read_cb   = fs_read;
+    drv.write_cb  = fs_write;
+    drv.seek_cb   = fs_seek;
+    drv.tell_cb   = fs_tell;
+    drv.size_cb   = fs_size;
+#if POSIX_FS_MMAP
+    drv.map_cb           = fs_map;
+    drv.cache_block_size = 0;   /*The reads are copies from the mapping, a cache would only copy them twice*/
+#endif
+
+    lv_fs_drv_register(&drv);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_fs_res_t fs_open(lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    char buf[POSIX_FS_PATH_MAX];
+    if(!full_path(buf, path)) return LV_FS_RES_INV_PARAM;
+
+    int flags;
+    if(mode == LV_FS_MODE_RD) flags = O_RDONLY;
+    else if(mode == LV_FS_MODE_WR) flags = O_WRONLY | O_CREAT | O_TRUNC;
+    else flags = O_RDWR | O_CREAT;
+
+    memset(f, 0, sizeof(posix_fs_file_t));
+    f->fd = open(buf, flags, 0644);
+    if(f->fd < 0) return LV_FS_RES_NOT_EX;
+
+#if POSIX_FS_MMAP
+    struct stat st;
+    if(mode == LV_FS_MODE_RD && fstat(f->fd, &st) == 0 && st.st_size > 0 && (uint64_t)st.st_size <= UINT32_MAX) {
+        void * map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, f->fd, 0);
+        if(map != MAP_FAILED) {
+            f->map  = map;
+            f->size = (uint32_t)st.st_size;
+        }
+    }
+#endif
+
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_close(lv_fs_drv_t * drv, void * file_p)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map != NULL) munmap((void *)f->map, f->size);
+    f->map = NULL;
+
+    return close(f->fd) == 0 ? LV_FS_RES_OK : LV_FS_RES_HW_ERR;
+}
+
+static lv_fs_res_t fs_remove(lv_fs_drv_t * drv, const char * path)
+{
+    (void)drv;
+    char buf[POSIX_FS_PATH_MAX];
+    if(!full_path(buf, path)) return LV_FS_RES_INV_PARAM;
+
+    return unlink(buf) == 0 ? LV_FS_RES_OK : LV_FS_RES_NOT_EX;
+}
+
+static lv_fs_res_t fs_read(lv_fs_drv_t * drv, void * file_p, void * buf, uint32_t btr, uint32_t * br)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map != NULL) {
+        uint32_t n = f->pos < f->size ? f->size - f->pos : 0;
+        if(n > btr) n = btr;
+        memcpy(buf, f->map + f->pos, n);
+        f->pos += n;
+        *br = n;
+        return LV_FS_RES_OK;
+    }
+
+    ssize_t n = read(f->fd, buf, btr);
+    if(n < 0) {
+        *br = 0;
+        return LV_FS_RES_HW_ERR;
+    }
+    *br = (uint32_t)n;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_write(lv_fs_drv_t * drv, void * file_p, const void * buf, uint32_t btw, uint32_t * bw)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    ssize_t n = write(f->fd, buf, btw);
+    if(n < 0) {
+        *bw = 0;
+        return LV_FS_RES_HW_ERR;
+    }
+    *bw = (uint32_t)n;
+    return (uint32_t)n == btw ? LV_FS_RES_OK : LV_FS_RES_FULL;
+}
+
+static lv_fs_res_t fs_seek(lv_fs_drv_t * drv, void * file_p, uint32_t pos)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map != NULL) {
+        f->pos = pos;
+        return LV_FS_RES_OK;
+    }
+
+    return lseek(f->fd, (off_t)pos, SEEK_SET) >= 0 ? LV_FS_RES_OK : LV_FS_RES_INV_PARAM;
+}
+
+static lv_fs_res_t fs_tell(lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map != NULL) {
+        *pos_p = f->pos;
+        return LV_FS_RES_OK;
+    }
+
+    off_t pos = lseek(f->fd, 0, SEEK_CUR);
+    if(pos < 0) return LV_FS_RES_HW_ERR;
+    *pos_p = (uint32_t)pos;
+    return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t fs_size(lv_fs_drv_t * drv, void * file_p, uint32_t * size_p)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map != NULL) {
+        *size_p = f->size;
+        return LV_FS_RES_OK;
+    }
+
+    struct stat st;
+    if(fstat(f->fd, &st) != 0) return LV_FS_RES_HW_ERR;
+    *size_p = (uint32_t)st.st_size;
+    return LV_FS_RES_OK;
+}
+
+/*Only the files opened for reading are mapped, the others can't be used in place*/
+static lv_fs_res_t fs_map(lv_fs_drv_t * drv, void * file_p, const void ** ptr_p, uint32_t * size_p)
+{
+    (void)drv;
+    posix_fs_file_t * f = file_p;
+    if(f->map == NULL) return LV_FS_RES_NOT_IMP;
+
+    *ptr_p  = f->map;
+    *size_p = f->size;
+    return LV_FS_RES_OK;
+}
+
+/*The path of the system: POSIX_FS_ROOT and the path after the letter*/
+static bool full_path(char * buf, const char * path)
+{
+    int len = snprintf(buf, POSIX_FS_PATH_MAX, "%s%s", POSIX_FS_ROOT, path);
+    return len >= 0 && len < POSIX_FS_PATH_MAX;
+}
+
+#endif /* USE_POSIX_FS */
@@ -0,0 +1,49 @@
+/**
+ * @file posix_fs.h
+ *
+ */
+
+#ifndef POSIX_FS_H
+#define POSIX_FS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_POSIX_FS
+
+#include "lvgl/lvgl.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void posix_fs_init(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_POSIX_FS */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* POSIX_FS_H */
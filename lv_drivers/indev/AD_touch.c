@@ -9,6 +9,9 @@
 
 #include LV_DRV_INDEV_INCLUDE
 #include LV_DRV_DELAY_INCLUDE
+#if USE_TOUCH_FILTER
+#include "touch_filter.h"
+#endif
 
 #define SAMPLE_POINTS   4
 
@@ -68,6 +71,11 @@ static int16_t TouchGetY(void);
 static int16_t TouchGetRawY(void);
 static int16_t TouchDetectPosition(void);
 static void TouchCalculateCalPoints(void);
+static int16_t TouchStateMachine(void);
+
+#if USE_TOUCH_FILTER
+static touch_filter_t touch_filter;
+#endif
 
 
 /********************************************************************/
@@ -98,11 +106,19 @@ void ad_touch_init(void)
     yRawTouch[2] = TOUCHCAL_LRY;
 
     TouchCalculateCalPoints();
+
+#if USE_TOUCH_FILTER
+    touch_filter_init(&touch_filter, 1);
+#endif
 }
 
 /*Use this in lv_indev_drv*/
 bool ad_touch_read(lv_indev_data_t * data)
 {
+#if USE_TOUCH_FILTER
+    /*`ad_touch_handler` has filtered the samples already*/
+    touch_filter_read(&touch_filter, data);
+#else
     static int16_t last_x = 0;
     static int16_t last_y = 0;
 
@@ -122,12 +138,33 @@ bool ad_touch_read(lv_indev_data_t * data)
         data->point.y = last_y;
         data->state = LV_INDEV_STATE_REL;
     }
+#endif
 
     return false;
 }
 
 /* Call periodically (e.g. in every 1 ms) to handle reading with ADC*/
 int16_t ad_touch_handler(void)
+{
+    int16_t done = TouchStateMachine();
+
+#if USE_TOUCH_FILTER
+    if(done) {
+        int16_t x = TouchGetX();
+        int16_t y = TouchGetY();
+        touch_filter_add(&touch_filter, x, y, (x > 0) && (y > 0) ? 1 : 0);
+    }
+#endif
+
+    return done;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/* Step the sampling with the ADC. Returns 1 when an acquisition is done*/
+static int16_t TouchStateMachine(void)
 {
     static int16_t tempX, tempY;
     int16_t temp;
@@ -266,10 +303,6 @@ int16_t ad_touch_handler(void)
     return 0; // touch screen acquisition is not done
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-
 /********************************************************************/
 static int16_t TouchGetX(void)
 {
@@ -12,12 +12,17 @@
 #include <stddef.h>
 #include LV_DRV_INDEV_INCLUDE
 #include LV_DRV_DELAY_INCLUDE
+#if USE_TOUCH_FILTER
+#include "touch_filter.h"
+#endif
 
 /*********************
  *      DEFINES
  *********************/
 #define CMD_X_READ  0b10010000
 #define CMD_Y_READ  0b11010000
+#define CMD_Z1_READ 0b10110000
+#define CMD_Z2_READ 0b11000000
 
 /**********************
  *      TYPEDEFS
@@ -28,6 +33,9 @@
  **********************/
 static void xpt2046_corr(int16_t * x, int16_t * y);
 static void xpt2046_avg(int16_t * x, int16_t * y);
+#if USE_TOUCH_FILTER
+static int16_t xpt2046_cmd(uint8_t cmd);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -36,6 +44,10 @@ int16_t avg_buf_x[XPT2046_AVG];
 int16_t avg_buf_y[XPT2046_AVG];
 uint8_t avg_last;
 
+#if USE_TOUCH_FILTER
+static touch_filter_t xpt2046_filter;
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -49,16 +61,51 @@ uint8_t avg_last;
  */
 void xpt2046_init(void)
 {
+#if USE_TOUCH_FILTER
+    touch_filter_init(&xpt2046_filter, XPT2046_Z_MIN);
+#endif
+}
+
+#if USE_TOUCH_FILTER
+/**
+ * Sample the touchpad into the filter. Call it periodically from a timer (e.g. every 1..2 ms)
+ * while nothing else uses the SPI bus. `xpt2046_read` only takes the filtered point.
+ */
+void xpt2046_sample(void)
+{
+    if(LV_DRV_INDEV_IRQ_READ != 0) {
+        touch_filter_add(&xpt2046_filter, 0, 0, 0);
+        return;
+    }
+
+    LV_DRV_INDEV_SPI_CS(0);
+    int16_t x = xpt2046_cmd(CMD_X_READ);
+    int16_t y = xpt2046_cmd(CMD_Y_READ);
+    int16_t z1 = xpt2046_cmd(CMD_Z1_READ);
+    int16_t z2 = xpt2046_cmd(CMD_Z2_READ);
+    LV_DRV_INDEV_SPI_CS(1);
 
+    /*The pressure grows as Z1 grows and Z2 falls*/
+    int32_t z = z1 + 4095 - z2;
+    if(z < 0) z = 0;
+
+    xpt2046_corr(&x, &y);
+    touch_filter_add(&xpt2046_filter, x, y, z);
 }
+#endif
 
 /**
  * Get the current position and state of the touchpad
  * @param data store the read data here
- * @return false: because no ore data to be read
+ * @return false: because no ore data to be read (`USE_TOUCH_FILTER`); true: pressed
  */
 bool xpt2046_read(lv_indev_data_t * data)
 {
+#if USE_TOUCH_FILTER
+    /*`xpt2046_sample` has done the bus transactions already*/
+    touch_filter_read(&xpt2046_filter, data);
+    return false;
+#else
     static int16_t last_x = 0;
     static int16_t last_y = 0;
     bool valid = true;
@@ -107,6 +154,7 @@ bool xpt2046_read(lv_indev_data_t * data)
     data->state = valid == false ? LV_INDEV_STATE_REL : LV_INDEV_STATE_PR;
 
     return valid;
+#endif
 }
 
 /**********************
@@ -172,4 +220,22 @@ static void xpt2046_avg(int16_t * x, int16_t * y)
     (*y) = (int32_t)y_sum / avg_last;
 }
 
+#if USE_TOUCH_FILTER
+/**
+ * Make a 12 bit conversion
+ * @param cmd the command of the channel
+ * @return the converted value
+ */
+static int16_t xpt2046_cmd(uint8_t cmd)
+{
+    int16_t v;
+
+    LV_DRV_INDEV_SPI_XCHG_BYTE(cmd);
+    v = LV_DRV_INDEV_SPI_XCHG_BYTE(0) << 8;
+    v += LV_DRV_INDEV_SPI_XCHG_BYTE(0);
+
+    return v >> 3;
+}
+#endif
+
 #endif
@@ -38,6 +38,9 @@ extern "C" {
  **********************/
 void xpt2046_init(void);
 bool xpt2046_read(lv_indev_data_t * data);
+#if USE_TOUCH_FILTER
+void xpt2046_sample(void);
+#endif
 
 /**********************
  *      MACROS
@@ -13,10 +13,16 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <linux/input.h>
+#if USE_INDEV_THREAD
+#include "indev_thread.h"
+#endif
 
 /*********************
  *      DEFINES
  *********************/
+#ifndef EVDEV_BUFFERED
+#define EVDEV_BUFFERED  0
+#endif
 
 /**********************
  *      TYPEDEFS
@@ -26,6 +32,11 @@
  *  STATIC PROTOTYPES
  **********************/
 int map(int x, int in_min, int in_max, int out_min, int out_max);
+static bool evdev_event(const struct input_event * in);
+static void evdev_sample(lv_indev_data_t * data);
+#if USE_INDEV_THREAD
+static void evdev_thread_read(int fd, void * user_data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -35,6 +46,10 @@ int evdev_root_x;
 int evdev_root_y;
 int evdev_button;
 
+#if USE_INDEV_THREAD
+static indev_queue_t evdev_queue;  /*The samples decoded by the reader thread*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -59,6 +74,10 @@ void evdev_init(void)
     evdev_root_x = 0;
     evdev_root_y = 0;
     evdev_button = LV_INDEV_STATE_REL;
+
+#if USE_INDEV_THREAD
+    indev_thread_add(evdev_fd, evdev_thread_read, NULL);
+#endif
 }
 /**
  * reconfigure the device file for evdev
@@ -69,6 +88,9 @@ void evdev_init(void)
 bool evdev_set_file(char* dev_name)
 { 
      if(evdev_fd != -1) {
+#if USE_INDEV_THREAD
+        indev_thread_remove(evdev_fd);
+#endif
         close(evdev_fd);
      }
      evdev_fd = open(dev_name, O_RDWR | O_NOCTTY | O_NDELAY);
@@ -84,75 +106,110 @@ bool evdev_set_file(char* dev_name)
      evdev_root_y = 0;
      evdev_button = LV_INDEV_STATE_REL;
 
+#if USE_INDEV_THREAD
+     indev_thread_add(evdev_fd, evdev_thread_read, NULL);
+#endif
+
      return true;
 }
 /**
  * Get the current position and state of the evdev
  * @param data store the evdev data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return true: a sample is complete and more events are waiting (`EVDEV_BUFFERED` or `USE_INDEV_THREAD`);
+ *         false: all events are read
  */
 bool evdev_read(lv_indev_data_t * data)
 {
+#if USE_INDEV_THREAD
+    /*The reader thread has decoded the events already*/
+    return indev_queue_read(&evdev_queue, data);
+#else
     struct input_event in;
+    bool more = false;
 
     while(read(evdev_fd, &in, sizeof(struct input_event)) > 0) {
-        if(in.type == EV_REL) {
-            if(in.code == REL_X)
-				#if EVDEV_SWAP_AXES
-					evdev_root_y += in.value;
-				#else
-					evdev_root_x += in.value;
-				#endif
-            else if(in.code == REL_Y)
-				#if EVDEV_SWAP_AXES
-					evdev_root_x += in.value;
-				#else
-					evdev_root_y += in.value;
-				#endif
-        } else if(in.type == EV_ABS) {
-            if(in.code == ABS_X)
-				#if EVDEV_SWAP_AXES
-					evdev_root_y = in.value;
-				#else
-					evdev_root_x = in.value;
-				#endif
-            else if(in.code == ABS_Y)
-				#if EVDEV_SWAP_AXES
-					evdev_root_x = in.value;
-				#else
-					evdev_root_y = in.value;
-				#endif
-            else if(in.code == ABS_MT_POSITION_X)
-                                #if EVDEV_SWAP_AXES
-                                        evdev_root_y = in.value;
-                                #else
-                                        evdev_root_x = in.value;
-                                #endif
-            else if(in.code == ABS_MT_POSITION_Y)
-                                #if EVDEV_SWAP_AXES
-                                        evdev_root_x = in.value;
-                                #else
-                                        evdev_root_y = in.value;
-                                #endif
-        } else if(in.type == EV_KEY) {
-            if(in.code == BTN_MOUSE || in.code == BTN_TOUCH) {
-                if(in.value == 0)
-                    evdev_button = LV_INDEV_STATE_REL;
-                else if(in.value == 1)
-                    evdev_button = LV_INDEV_STATE_PR;
-            }
+        if(evdev_event(&in)) {
+#if EVDEV_BUFFERED
+            /*A sample is complete. Report it and leave the next ones in the device's buffer for the next read.*/
+            more = true;
+            break;
+#endif
         }
     }
 
-    /*Store the collected data*/
+    evdev_sample(data);
+    return more;
+#endif
+}
 
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+int map(int x, int in_min, int in_max, int out_min, int out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+/**
+ * Process an event of the device
+ * @param in the event
+ * @return true: a sample is complete (`SYN_REPORT`)
+ */
+static bool evdev_event(const struct input_event * in)
+{
+    if(in->type == EV_REL) {
+        if(in->code == REL_X)
+#if EVDEV_SWAP_AXES
+            evdev_root_y += in->value;
+#else
+            evdev_root_x += in->value;
+#endif
+        else if(in->code == REL_Y)
+#if EVDEV_SWAP_AXES
+            evdev_root_x += in->value;
+#else
+            evdev_root_y += in->value;
+#endif
+    } else if(in->type == EV_ABS) {
+        if(in->code == ABS_X || in->code == ABS_MT_POSITION_X)
+#if EVDEV_SWAP_AXES
+            evdev_root_y = in->value;
+#else
+            evdev_root_x = in->value;
+#endif
+        else if(in->code == ABS_Y || in->code == ABS_MT_POSITION_Y)
+#if EVDEV_SWAP_AXES
+            evdev_root_x = in->value;
+#else
+            evdev_root_y = in->value;
+#endif
+    } else if(in->type == EV_KEY) {
+        if(in->code == BTN_MOUSE || in->code == BTN_TOUCH) {
+            if(in->value == 0)
+                evdev_button = LV_INDEV_STATE_REL;
+            else if(in->value == 1)
+                evdev_button = LV_INDEV_STATE_PR;
+        }
+    } else if(in->type == EV_SYN && in->code == SYN_REPORT) {
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Get the collected position and state, scaled to the display
+ * @param data store them here
+ */
+static void evdev_sample(lv_indev_data_t * data)
+{
 #if EVDEV_SCALE
     data->point.x = map(evdev_root_x, 0, EVDEV_SCALE_HOR_RES, 0, LV_HOR_RES);
     data->point.y = map(evdev_root_y, 0, EVDEV_SCALE_VER_RES, 0, LV_VER_RES);
 #else
 #if EVDEV_CALIBRATE
-	data->point.x = map(evdev_root_x, EVDEV_HOR_MIN, EVDEV_HOR_MAX, 0, LV_HOR_RES);
-	data->point.y = map(evdev_root_y, EVDEV_VER_MIN, EVDEV_VER_MAX, 0, LV_VER_RES);
+    data->point.x = map(evdev_root_x, EVDEV_HOR_MIN, EVDEV_HOR_MAX, 0, LV_HOR_RES);
+    data->point.y = map(evdev_root_y, EVDEV_VER_MIN, EVDEV_VER_MAX, 0, LV_VER_RES);
 #else
     data->point.x = evdev_root_x;
     data->point.y = evdev_root_y;
@@ -169,16 +226,31 @@ bool evdev_read(lv_indev_data_t * data)
       data->point.x = LV_HOR_RES - 1;
     if(data->point.y >= LV_VER_RES)
       data->point.y = LV_VER_RES - 1;
-
-    return false;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-int map(int x, int in_min, int in_max, int out_min, int out_max)
+#if USE_INDEV_THREAD
+/**
+ * Read the events on the reader thread and queue a sample at every `SYN_REPORT`
+ * @param fd file descriptor of the device
+ * @param user_data unused
+ */
+static void evdev_thread_read(int fd, void * user_data)
 {
-  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+    (void)user_data;
+    struct input_event in[16];
+    ssize_t n;
+
+    while((n = read(fd, in, sizeof(in))) > 0) {
+        size_t i;
+        for(i = 0; i < n / sizeof(struct input_event); i++) {
+            if(evdev_event(&in[i])) {
+                lv_indev_data_t data;
+                evdev_sample(&data);
+                indev_queue_push(&evdev_queue, data.point, data.state);
+            }
+        }
+    }
 }
+#endif
 
 #endif
@@ -51,7 +51,8 @@ bool evdev_set_file(char* dev_name);
 /**
  * Get the current position and state of the evdev
  * @param data store the evdev data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return true: a sample is complete and more events are waiting (`EVDEV_BUFFERED` or `USE_INDEV_THREAD`);
+ *         false: all events are read
  */
 bool evdev_read(lv_indev_data_t * data);
 
@@ -5,6 +5,8 @@ CSRCS += mousewheel.c
 CSRCS += evdev.c
 CSRCS += libinput.c
 CSRCS += XPT2046.c
+CSRCS += indev_thread.c
+CSRCS += touch_filter.c
 
 DEPPATH += --dep-path $(LVGL_DIR)/lv_drivers/indev
 VPATH += :$(LVGL_DIR)/lv_drivers/indev
@@ -0,0 +1,265 @@
+/**
+ * @file indev_thread.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "indev_thread.h"
+#if USE_INDEV_THREAD
+
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#ifndef INDEV_THREAD_DEV_MAX
+#define INDEV_THREAD_DEV_MAX    8
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct {
+    int fd;
+    indev_thread_read_cb_t read_cb;     /*NULL: free slot*/
+    void * user_data;
+} indev_thread_dev_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void * reader_main(void * param);
+static inline uint64_t sample_pack(lv_point_t point, lv_indev_state_t state);
+static inline void sample_unpack(uint64_t s, lv_indev_data_t * data);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static int epoll_fd = -1;
+static pthread_mutex_t dev_mutex = PTHREAD_MUTEX_INITIALIZER;   /*Held by the reader thread while it calls `read_cb`s*/
+static indev_thread_dev_t devs[INDEV_THREAD_DEV_MAX];
+static indev_thread_wake_cb_t wake_cb;
+static bool pushed;                                             /*Used only by the reader thread*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Read a device on the reader thread. The thread is started with the first device.
+ * @param fd file descriptor of the device, opened with `O_NONBLOCK`
+ * @param read_cb called when the device has events
+ * @param user_data passed to `read_cb`
+ * @return true: added; false: the thread or `epoll` couldn't be set up
+ */
+bool indev_thread_add(int fd, indev_thread_read_cb_t read_cb, void * user_data)
+{
+    if(epoll_fd < 0) {
+        epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if(epoll_fd < 0) {
+            perror("indev_thread: epoll_create1");
+            return false;
+        }
+
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, reader_main, NULL) != 0) {
+            perror("indev_thread: pthread_create");
+            close(epoll_fd);
+            epoll_fd = -1;
+            return false;
+        }
+        pthread_detach(thread);
+    }
+
+    pthread_mutex_lock(&dev_mutex);
+    uint32_t i;
+    for(i = 0; i < INDEV_THREAD_DEV_MAX; i++) {
+        if(devs[i].read_cb == NULL) break;
+    }
+    if(i == INDEV_THREAD_DEV_MAX) {
+        pthread_mutex_unlock(&dev_mutex);
+        fprintf(stderr, "indev_thread: more than %d devices\n", INDEV_THREAD_DEV_MAX);
+        return false;
+    }
+    devs[i].fd        = fd;
+    devs[i].read_cb   = read_cb;
+    devs[i].user_data = user_data;
+    pthread_mutex_unlock(&dev_mutex);
+
+    struct epoll_event ev;
+    ev.events   = EPOLLIN;
+    ev.data.u32 = i;
+    if(epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        perror("indev_thread: epoll_ctl");
+        pthread_mutex_lock(&dev_mutex);
+        devs[i].read_cb = NULL;
+        pthread_mutex_unlock(&dev_mutex);
+        return false;
+    }
+
+    /*Events which arrived before are read in the first `read_cb` too*/
+    return true;
+}
+
+/**
+ * Stop reading a device. `read_cb` isn't running and isn't called anymore when it returns,
+ * so the file descriptor can be closed after it.
+ * @param fd file descriptor of the device
+ */
+void indev_thread_remove(int fd)
+{
+    if(epoll_fd < 0) return;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+
+    pthread_mutex_lock(&dev_mutex);
+    uint32_t i;
+    for(i = 0; i < INDEV_THREAD_DEV_MAX; i++) {
+        if(devs[i].read_cb && devs[i].fd == fd) devs[i].read_cb = NULL;
+    }
+    pthread_mutex_unlock(&dev_mutex);
+}
+
+/**
+ * Set a function to call when new samples arrive, e.g. to wake up the main loop waiting for input
+ * and make the read tasks of the input devices ready (`lv_task_ready(indev->driver.read_task)`).
+ * @param cb the function or NULL
+ */
+void indev_thread_set_wake_cb(indev_thread_wake_cb_t cb)
+{
+    __atomic_store_n(&wake_cb, cb, __ATOMIC_RELEASE);
+}
+
+/**
+ * Hold off the reader thread, e.g. while changing the devices of a library it uses
+ */
+void indev_thread_lock(void)
+{
+    pthread_mutex_lock(&dev_mutex);
+}
+
+/**
+ * Let the reader thread run again
+ */
+void indev_thread_unlock(void)
+{
+    pthread_mutex_unlock(&dev_mutex);
+}
+
+/**
+ * Push a sample into a queue. Call it only from a `read_cb`.
+ * If the queue is full the sample is only kept as the latest one.
+ * @param q pointer to the queue of the device
+ * @param point the position
+ * @param state pressed or released
+ */
+void indev_queue_push(indev_queue_t * q, lv_point_t point, lv_indev_state_t state)
+{
+    uint64_t s = sample_pack(point, state);
+    pushed     = true;
+
+    /*Even if the queue is full, e.g. a release is never lost*/
+    __atomic_store_n(&q->cur, s, __ATOMIC_RELEASE);
+
+    uint32_t wr      = q->wr;
+    uint32_t wr_next = (wr + 1) & (INDEV_THREAD_QUEUE_SIZE - 1);
+    if(wr_next == __atomic_load_n(&q->rd, __ATOMIC_ACQUIRE)) return;
+
+    q->buf[wr] = s;
+    __atomic_store_n(&q->wr, wr_next, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take the next sample from a queue. Call it from the `read_cb` of the LittlevGL input device.
+ * @param q pointer to the queue of the device
+ * @param data store the sample here. The latest one if the queue is empty.
+ * @return true: more samples are queued
+ */
+bool indev_queue_read(indev_queue_t * q, lv_indev_data_t * data)
+{
+    uint32_t rd = q->rd;
+    if(rd == __atomic_load_n(&q->wr, __ATOMIC_ACQUIRE)) {
+        sample_unpack(__atomic_load_n(&q->cur, __ATOMIC_ACQUIRE), data);
+        return false;
+    }
+
+    uint64_t s = q->buf[rd];
+    sample_unpack(s, data);
+    rd = (rd + 1) & (INDEV_THREAD_QUEUE_SIZE - 1);
+    __atomic_store_n(&q->rd, rd, __ATOMIC_RELEASE);
+
+    /*If samples were dropped the latest one is read after the queue*/
+    return rd != __atomic_load_n(&q->wr, __ATOMIC_ACQUIRE) || s != __atomic_load_n(&q->cur, __ATOMIC_ACQUIRE);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Wait for the devices and read them as their events arrive
+ */
+static void * reader_main(void * param)
+{
+    (void)param;
+    struct epoll_event evs[INDEV_THREAD_DEV_MAX];
+
+    while(1) {
+        int n = epoll_wait(epoll_fd, evs, INDEV_THREAD_DEV_MAX, -1);
+        if(n < 0) {
+            if(errno == EINTR) continue;
+            perror("indev_thread: epoll_wait");
+            break;
+        }
+
+        pthread_mutex_lock(&dev_mutex);
+        pushed = false;
+        int i;
+        for(i = 0; i < n; i++) {
+            indev_thread_dev_t * dev = &devs[evs[i].data.u32];
+            if(dev->read_cb == NULL) continue;
+
+            if(evs[i].events & EPOLLIN) dev->read_cb(dev->fd, dev->user_data);
+
+            /*Unplugged: it would be reported again and again*/
+            if(evs[i].events & (EPOLLHUP | EPOLLERR)) {
+                fprintf(stderr, "indev_thread: device %d is gone\n", dev->fd);
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, dev->fd, NULL);
+                dev->read_cb = NULL;
+            }
+        }
+        bool wake = pushed;
+        pthread_mutex_unlock(&dev_mutex);
+
+        if(wake) {
+            indev_thread_wake_cb_t cb = __atomic_load_n(&wake_cb, __ATOMIC_ACQUIRE);
+            if(cb) cb();
+        }
+    }
+
+    return NULL;
+}
+
+static inline uint64_t sample_pack(lv_point_t point, lv_indev_state_t state)
+{
+    return (uint64_t)(uint16_t)point.x | ((uint64_t)(uint16_t)point.y << 16) | ((uint64_t)state << 32);
+}
+
+static inline void sample_unpack(uint64_t s, lv_indev_data_t * data)
+{
+    data->point.x = (int16_t)(s & 0xFFFF);
+    data->point.y = (int16_t)((s >> 16) & 0xFFFF);
+    data->state   = (lv_indev_state_t)(s >> 32);
+}
+
+#endif /*USE_INDEV_THREAD*/
@@ -0,0 +1,128 @@
+/**
+ * @file indev_thread.h
+ * A background thread reading the Linux input devices (`evdev.c`, `libinput.c`).
+ * It waits in `epoll` on the file descriptors of the devices, decodes their events as they arrive and puts
+ * the samples into a lock-free queue of every device. `evdev_read` and `libinput_read` only take them from
+ * the queue, so an untouched device costs no system calls and no sample is merged with the next one.
+ */
+
+#ifndef INDEV_THREAD_H
+#define INDEV_THREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_INDEV_THREAD
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lv_hal/lv_hal_indev.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if INDEV_THREAD_QUEUE_SIZE & (INDEV_THREAD_QUEUE_SIZE - 1)
+#error "INDEV_THREAD_QUEUE_SIZE must be a power of 2"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Samples of a device. Written only by the reader thread and read only by LittlevGL's thread.
+ * Zero initialize it.
+ */
+typedef struct {
+    uint64_t buf[INDEV_THREAD_QUEUE_SIZE];  /*Packed samples*/
+    uint32_t wr;                            /*Next sample to write, modified only by the reader thread*/
+    uint32_t rd;                            /*Next sample to read, modified only by LittlevGL's thread*/
+    uint64_t cur;                           /*The latest sample, even if it didn't fit into the queue*/
+} indev_queue_t;
+
+/**
+ * Called on the reader thread when a device's file descriptor is readable.
+ * Read all its events without blocking and push the samples into its queue.
+ */
+typedef void (*indev_thread_read_cb_t)(int fd, void * user_data);
+
+/**
+ * Called on the reader thread after new samples were pushed
+ */
+typedef void (*indev_thread_wake_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Read a device on the reader thread. The thread is started with the first device.
+ * @param fd file descriptor of the device, opened with `O_NONBLOCK`
+ * @param read_cb called when the device has events
+ * @param user_data passed to `read_cb`
+ * @return true: added; false: the thread or `epoll` couldn't be set up
+ */
+bool indev_thread_add(int fd, indev_thread_read_cb_t read_cb, void * user_data);
+
+/**
+ * Stop reading a device. `read_cb` isn't running and isn't called anymore when it returns,
+ * so the file descriptor can be closed after it.
+ * @param fd file descriptor of the device
+ */
+void indev_thread_remove(int fd);
+
+/**
+ * Set a function to call when new samples arrive, e.g. to wake up the main loop waiting for input
+ * and make the read tasks of the input devices ready (`lv_task_ready(indev->driver.read_task)`).
+ * @param cb the function or NULL
+ */
+void indev_thread_set_wake_cb(indev_thread_wake_cb_t cb);
+
+/**
+ * Hold off the reader thread, e.g. while changing the devices of a library it uses
+ */
+void indev_thread_lock(void);
+
+/**
+ * Let the reader thread run again
+ */
+void indev_thread_unlock(void);
+
+/**
+ * Push a sample into a queue. Call it only from a `read_cb`.
+ * If the queue is full the sample is only kept as the latest one.
+ * @param q pointer to the queue of the device
+ * @param point the position
+ * @param state pressed or released
+ */
+void indev_queue_push(indev_queue_t * q, lv_point_t point, lv_indev_state_t state);
+
+/**
+ * Take the next sample from a queue. Call it from the `read_cb` of the LittlevGL input device.
+ * @param q pointer to the queue of the device
+ * @param data store the sample here. The latest one if the queue is empty.
+ * @return true: more samples are queued
+ */
+bool indev_queue_read(indev_queue_t * q, lv_indev_data_t * data);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_INDEV_THREAD */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* INDEV_THREAD_H */
@@ -17,6 +17,9 @@
 #include <stdbool.h>
 #include <poll.h>
 #include <libinput.h>
+#if USE_INDEV_THREAD
+#include "indev_thread.h"
+#endif
 
 /*********************
  *      DEFINES
@@ -31,6 +34,10 @@
  **********************/
 static int open_restricted(const char *path, int flags, void *user_data);
 static void close_restricted(int fd, void *user_data);
+static void libinput_events(void);
+#if USE_INDEV_THREAD
+static void libinput_thread_read(int fd, void *user_data);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -49,6 +56,10 @@ const static struct libinput_interface interface = {
   .close_restricted = close_restricted,
 };
 
+#if USE_INDEV_THREAD
+static indev_queue_t libinput_queue;  /*The samples decoded by the reader thread*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -65,6 +76,12 @@ const static struct libinput_interface interface = {
  */
 bool libinput_set_file(char* dev_name)
 {
+#if USE_INDEV_THREAD
+  /*The reader thread uses the context too*/
+  indev_thread_lock();
+#endif
+  bool res = true;
+
   // This check *should* not be necessary, yet applications crashes even on NULL handles.
   // citing libinput.h:libinput_path_remove_device:
   // > If no matching device exists, this function does nothing.
@@ -76,17 +93,22 @@ bool libinput_set_file(char* dev_name)
   libinput_device = libinput_path_add_device(libinput_context, dev_name);
   if(!libinput_device) {
     perror("unable to add device to libinput context:");
-    return false;
-  }
-  libinput_device = libinput_device_ref(libinput_device);
-  if(!libinput_device) {
-    perror("unable to reference device within libinput context:");
-    return false;
+    res = false;
+  } else {
+    libinput_device = libinput_device_ref(libinput_device);
+    if(!libinput_device) {
+      perror("unable to reference device within libinput context:");
+      res = false;
+    }
   }
 
-  libinput_button = LV_INDEV_STATE_REL;
+  if(res) libinput_button = LV_INDEV_STATE_REL;
 
-  return true;
+#if USE_INDEV_THREAD
+  indev_thread_unlock();
+#endif
+
+  return res;
 }
 
 /**
@@ -106,17 +128,24 @@ void libinput_init(void)
   fds[0].fd = libinput_fd;
   fds[0].events = POLLIN;
   fds[0].revents = 0;
+
+#if USE_INDEV_THREAD
+  indev_thread_add(libinput_fd, libinput_thread_read, NULL);
+#endif
 }
 
 /**
  * Get the current position and state of the libinput
  * @param data store the libinput data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return false: because the points are not buffered, so no more data to be read;
+ *         true: more touch samples are queued (`USE_INDEV_THREAD`)
  */
 bool libinput_read(lv_indev_data_t * data)
 {
-  struct libinput_event *event;
-  struct libinput_event_touch *touch_event = NULL;
+#if USE_INDEV_THREAD
+  /*The reader thread has decoded the events already*/
+  return indev_queue_read(&libinput_queue, data);
+#else
   int rc = 0;
   struct pollfd fds[1];
 
@@ -129,31 +158,14 @@ bool libinput_read(lv_indev_data_t * data)
     default:
       break;
   }
-  libinput_dispatch(libinput_context);
-  while((event = libinput_get_event(libinput_context)) != NULL) {
-    enum libinput_event_type type = libinput_event_get_type(event);
-    switch (type) {
-      case LIBINPUT_EVENT_TOUCH_MOTION:
-      case LIBINPUT_EVENT_TOUCH_DOWN:
-        touch_event = libinput_event_get_touch_event(event);
-        most_recent_touch_point.x = libinput_event_touch_get_x_transformed(touch_event, LV_HOR_RES);
-        most_recent_touch_point.y = libinput_event_touch_get_y_transformed(touch_event, LV_VER_RES);
-        libinput_button = LV_INDEV_STATE_PR;
-        break;
-      case LIBINPUT_EVENT_TOUCH_UP:
-        libinput_button = LV_INDEV_STATE_REL;
-        break;
-      default:
-        break;
-    }
-    libinput_event_destroy(event);
-  }
+  libinput_events();
 report_most_recent_state:
   data->point.x = most_recent_touch_point.x;
   data->point.y = most_recent_touch_point.y;
   data->state = libinput_button;
 
   return false;
+#endif
 }
 
 
@@ -172,4 +184,53 @@ static void close_restricted(int fd, void *user_data)
   close(fd);
 }
 
+/**
+ * Process the pending events of the libinput context
+ */
+static void libinput_events(void)
+{
+  struct libinput_event *event;
+  struct libinput_event_touch *touch_event = NULL;
+
+  libinput_dispatch(libinput_context);
+  while((event = libinput_get_event(libinput_context)) != NULL) {
+    enum libinput_event_type type = libinput_event_get_type(event);
+    switch (type) {
+      case LIBINPUT_EVENT_TOUCH_MOTION:
+      case LIBINPUT_EVENT_TOUCH_DOWN:
+        touch_event = libinput_event_get_touch_event(event);
+        most_recent_touch_point.x = libinput_event_touch_get_x_transformed(touch_event, LV_HOR_RES);
+        most_recent_touch_point.y = libinput_event_touch_get_y_transformed(touch_event, LV_VER_RES);
+        libinput_button = LV_INDEV_STATE_PR;
+#if USE_INDEV_THREAD
+        indev_queue_push(&libinput_queue, most_recent_touch_point, libinput_button);
+#endif
+        break;
+      case LIBINPUT_EVENT_TOUCH_UP:
+        libinput_button = LV_INDEV_STATE_REL;
+#if USE_INDEV_THREAD
+        indev_queue_push(&libinput_queue, most_recent_touch_point, libinput_button);
+#endif
+        break;
+      default:
+        break;
+    }
+    libinput_event_destroy(event);
+  }
+}
+
+#if USE_INDEV_THREAD
+/**
+ * Read the events of the libinput context on the reader thread
+ * @param fd file descriptor of the context
+ * @param user_data unused
+ */
+static void libinput_thread_read(int fd, void *user_data)
+{
+  (void)fd;
+  (void)user_data;
+  libinput_events();
+}
+#endif
+
 #endif
@@ -51,7 +51,8 @@ bool libinput_set_file(char* dev_name);
 /**
  * Get the current position and state of the libinput
  * @param data store the libinput data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return false: because the points are not buffered, so no more data to be read;
+ *         true: more touch samples are queued (`USE_INDEV_THREAD`)
  */
 bool libinput_read(lv_indev_data_t * data);
 
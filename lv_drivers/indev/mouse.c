@@ -16,13 +16,32 @@
 #define MONITOR_ZOOM    1
 #endif
 
+#ifndef MOUSE_QUEUE_SIZE
+#define MOUSE_QUEUE_SIZE    0
+#endif
+
+#if MOUSE_QUEUE_SIZE & (MOUSE_QUEUE_SIZE - 1)
+#error "MOUSE_QUEUE_SIZE must be a power of 2"
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if MOUSE_QUEUE_SIZE
+/*State of the mouse after an event*/
+typedef struct {
+    int16_t x;
+    int16_t y;
+    bool left_button_down;
+} mouse_sample_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if MOUSE_QUEUE_SIZE
+static void mouse_queue_push(void);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -31,6 +50,14 @@ static bool left_button_down = false;
 static int16_t last_x = 0;
 static int16_t last_y = 0;
 
+#if MOUSE_QUEUE_SIZE
+/* Written by `mouse_handler` (SDL thread) and read by `mouse_read` (LittlevGL's thread).
+ * Each index is written only by one side so no lock is required.*/
+static mouse_sample_t queue[MOUSE_QUEUE_SIZE];
+static SDL_atomic_t queue_wr;   /*Next sample to write, modified only by `mouse_handler`*/
+static SDL_atomic_t queue_rd;   /*Next sample to read, modified only by `mouse_read`*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -51,12 +78,26 @@ void mouse_init(void)
  * Get the current position and state of the mouse
  * @param indev_drv pointer to the related input device driver
  * @param data store the mouse data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return true: there are more buffered events to read (`MOUSE_QUEUE_SIZE`); false: this is the last state
  */
 bool mouse_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data)
 {
     (void) indev_drv;      /*Unused*/
 
+#if MOUSE_QUEUE_SIZE
+    /*Report every buffered state. The last one is reported again with `false` when the queue is empty.*/
+    int rd = SDL_AtomicGet(&queue_rd);
+    if(rd != SDL_AtomicGet(&queue_wr)) {
+        SDL_MemoryBarrierAcquire();
+        mouse_sample_t * s = &queue[rd];
+        data->point.x = s->x;
+        data->point.y = s->y;
+        data->state = s->left_button_down ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        SDL_AtomicSet(&queue_rd, (rd + 1) & (MOUSE_QUEUE_SIZE - 1));
+        return true;
+    }
+#endif
+
     /*Store the collected data*/
     data->point.x = last_x;
     data->point.y = last_y;
@@ -87,12 +128,35 @@ void mouse_handler(SDL_Event * event)
             last_y = event->motion.y / MONITOR_ZOOM;
 
             break;
+        default:
+            return;
     }
 
+#if MOUSE_QUEUE_SIZE
+    mouse_queue_push();
+#endif
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+#if MOUSE_QUEUE_SIZE
+/**
+ * Add the current state to the queue. If the queue is full the state is only kept as the last state.
+ */
+static void mouse_queue_push(void)
+{
+    int wr = SDL_AtomicGet(&queue_wr);
+    int wr_next = (wr + 1) & (MOUSE_QUEUE_SIZE - 1);
+    if(wr_next == SDL_AtomicGet(&queue_rd)) return;
+
+    queue[wr].x = last_x;
+    queue[wr].y = last_y;
+    queue[wr].left_button_down = left_button_down;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&queue_wr, wr_next);
+}
+#endif
+
 #endif
@@ -53,7 +53,7 @@ void mouse_init(void);
  * Get the current position and state of the mouse
  * @param indev_drv pointer to the related input device driver
  * @param data store the mouse data here
- * @return false: because the points are not buffered, so no more data to be read
+ * @return true: there are more buffered events to read (`MOUSE_QUEUE_SIZE`); false: this is the last state
  */
 bool mouse_read(lv_indev_drv_t * indev_drv, lv_indev_data_t * data);
 
@@ -0,0 +1,151 @@
+/**
+ * @file touch_filter.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "touch_filter.h"
+#if USE_TOUCH_FILTER
+
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IIR_FRACT   4   /*Fractional bits of the smoothed point*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static int16_t median(const int16_t * ring, uint8_t cnt);
+static void publish(touch_filter_t * f, int16_t x, int16_t y, bool pressed);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize a filter
+ * @param f pointer to the filter
+ * @param press_min samples with lower pressure are taken as released
+ */
+void touch_filter_init(touch_filter_t * f, uint16_t press_min)
+{
+    memset(f, 0, sizeof(touch_filter_t));
+    f->press_min = press_min;
+}
+
+/**
+ * Add a raw sample. Call it from the sampler (timer, interrupt or thread) only.
+ * @param f pointer to the filter
+ * @param x x coordinate, already calibrated
+ * @param y y coordinate, already calibrated
+ * @param pressure pressure of the touch, 0 if released
+ */
+void touch_filter_add(touch_filter_t * f, int16_t x, int16_t y, uint16_t pressure)
+{
+    if(pressure == 0 || pressure < f->press_min) {
+        /*Released: forget the samples of the lift-off and keep the last point*/
+        f->ring_cnt = 0;
+        if(f->pressed) publish(f, f->x, f->y, false);
+        return;
+    }
+
+    f->ring_x[f->ring_pos] = x;
+    f->ring_y[f->ring_pos] = y;
+    f->ring_pos = (f->ring_pos + 1) % TOUCH_FILTER_MEDIAN;
+
+    /*The first samples of a touch are noisy: report the press when the ring is full*/
+    if(f->ring_cnt < TOUCH_FILTER_MEDIAN) {
+        f->ring_cnt++;
+        if(f->ring_cnt < TOUCH_FILTER_MEDIAN) return;
+
+        f->iir_x = (int32_t)median(f->ring_x, f->ring_cnt) << IIR_FRACT;
+        f->iir_y = (int32_t)median(f->ring_y, f->ring_cnt) << IIR_FRACT;
+    } else {
+        f->iir_x += (((int32_t)median(f->ring_x, f->ring_cnt) << IIR_FRACT) - f->iir_x) >> TOUCH_FILTER_IIR_SHIFT;
+        f->iir_y += (((int32_t)median(f->ring_y, f->ring_cnt) << IIR_FRACT) - f->iir_y) >> TOUCH_FILTER_IIR_SHIFT;
+    }
+
+    publish(f, (f->iir_x + (1 << (IIR_FRACT - 1))) >> IIR_FRACT, (f->iir_y + (1 << (IIR_FRACT - 1))) >> IIR_FRACT, true);
+}
+
+/**
+ * Get the latest filtered point. Call it from the `read_cb` of the LittlevGL input device.
+ * @param f pointer to the filter
+ * @param data store the point and the state here
+ */
+void touch_filter_read(touch_filter_t * f, lv_indev_data_t * data)
+{
+    uint32_t seq;
+
+    /*Read again if the sampler has published a point meanwhile*/
+    do {
+        seq = f->seq;
+        __sync_synchronize();
+        data->point.x = f->x;
+        data->point.y = f->y;
+        data->state = f->pressed ? LV_INDEV_STATE_PR : LV_INDEV_STATE_REL;
+        __sync_synchronize();
+    } while((seq & 1) || seq != f->seq);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the median of the ring
+ * @param ring the samples
+ * @param cnt number of samples (odd)
+ * @return the median
+ */
+static int16_t median(const int16_t * ring, uint8_t cnt)
+{
+    int16_t s[TOUCH_FILTER_MEDIAN];
+    uint8_t i;
+    uint8_t j;
+
+    /*Insertion sort, the ring is small*/
+    for(i = 0; i < cnt; i++) {
+        int16_t v = ring[i];
+        for(j = i; j > 0 && s[j - 1] > v; j--) s[j] = s[j - 1];
+        s[j] = v;
+    }
+
+    return s[cnt / 2];
+}
+
+/**
+ * Publish a point for `touch_filter_read`
+ * @param f pointer to the filter
+ * @param x x coordinate
+ * @param y y coordinate
+ * @param pressed true: pressed, false: released
+ */
+static void publish(touch_filter_t * f, int16_t x, int16_t y, bool pressed)
+{
+    f->seq++;
+    __sync_synchronize();
+    f->x = x;
+    f->y = y;
+    f->pressed = pressed ? 1 : 0;
+    __sync_synchronize();
+    f->seq++;
+}
+
+#endif /*USE_TOUCH_FILTER*/
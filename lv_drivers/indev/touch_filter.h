@@ -0,0 +1,100 @@
+/**
+ * @file touch_filter.h
+ * Filtered sampling of the resistive touch pads (`XPT2046.c`, `AD_touch.c`).
+ * A timer or interrupt adds the raw samples at a high rate. They are collected into a ring for a median filter,
+ * smoothed by an IIR filter and dropped below a pressure threshold. The read callback of LittlevGL only fetches
+ * the latest filtered point, so it never waits for the bus or the ADC.
+ */
+
+#ifndef TOUCH_FILTER_H
+#define TOUCH_FILTER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_drv_conf.h"
+#else
+#include "../../lv_drv_conf.h"
+#endif
+
+#if USE_TOUCH_FILTER
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lvgl/lv_hal/lv_hal_indev.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if TOUCH_FILTER_MEDIAN < 1 || TOUCH_FILTER_MEDIAN > 15 || (TOUCH_FILTER_MEDIAN & 1) == 0
+#error "TOUCH_FILTER_MEDIAN must be an odd number in 1..15"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * State of a filter. Only `touch_filter_add` writes it (from the sampler) and only `touch_filter_read` reads
+ * the published point (from LittlevGL), so the sampler can interrupt the reader.
+ */
+typedef struct {
+    /*Used only by the sampler*/
+    int16_t ring_x[TOUCH_FILTER_MEDIAN];    /*The latest raw samples*/
+    int16_t ring_y[TOUCH_FILTER_MEDIAN];
+    uint8_t ring_pos;
+    uint8_t ring_cnt;
+    int32_t iir_x;                          /*Smoothed point with 4 fractional bits*/
+    int32_t iir_y;
+    uint16_t press_min;
+
+    /*Published point*/
+    volatile uint32_t seq;                  /*Odd while the point is written*/
+    volatile int16_t x;
+    volatile int16_t y;
+    volatile uint8_t pressed;
+} touch_filter_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize a filter
+ * @param f pointer to the filter
+ * @param press_min samples with lower pressure are taken as released
+ */
+void touch_filter_init(touch_filter_t * f, uint16_t press_min);
+
+/**
+ * Add a raw sample. Call it from the sampler (timer, interrupt or thread) only.
+ * @param f pointer to the filter
+ * @param x x coordinate, already calibrated
+ * @param y y coordinate, already calibrated
+ * @param pressure pressure of the touch, 0 if released
+ */
+void touch_filter_add(touch_filter_t * f, int16_t x, int16_t y, uint16_t pressure);
+
+/**
+ * Get the latest filtered point. Call it from the `read_cb` of the LittlevGL input device.
+ * @param f pointer to the filter
+ * @param data store the point and the state here
+ */
+void touch_filter_read(touch_filter_t * f, lv_indev_data_t * data);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /* USE_TOUCH_FILTER */
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /* TOUCH_FILTER_H */
@@ -1,5 +1,6 @@
 include $(LVGL_DIR)/lv_drivers/display/display.mk
 include $(LVGL_DIR)/lv_drivers/indev/indev.mk
+include $(LVGL_DIR)/lv_drivers/fs/fs.mk
 
 
 CSRCS += win_drv.c
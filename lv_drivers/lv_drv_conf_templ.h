@@ -93,6 +93,9 @@
 /* Scale window by this factor (useful when simulating small screens) */
 #  define MONITOR_ZOOM        1
 
+/* Refresh at the rate of the screen (see `monitor_get_refr_period`) but at most this often */
+#  define MONITOR_MAX_FPS     60
+
 /* Used to test true double buffering with only address changing.
  * Set LV_VDB_SIZE = (LV_HOR_RES * LV_VER_RES) and  LV_VDB_DOUBLE = 1 and LV_COLOR_DEPTH = 32" */
 #  define MONITOR_DOUBLE_BUFFERED 0
@@ -190,6 +193,48 @@
 #  define FBDEV_PATH          "/dev/fb0"
 #endif
 
+/*-----------------------------------------
+ *  Linux DRM/KMS device (/dev/dri/cardX)
+ *  Needs libdrm: -I/usr/include/libdrm -ldrm
+ *-----------------------------------------*/
+#ifndef USE_DRM
+#  define USE_DRM             0
+#endif
+
+#if USE_DRM
+#  define DRM_CARD            "/dev/dri/card0"
+#  define DRM_CONNECTOR_ID    -1      /*The connector to use, -1: the first connected one*/
+#  define DRM_BUF_CNT         3       /*Dumb buffers to draw into and flip between (see `drm_get_bufs`)*/
+#endif
+
+/*-----------------------------------------------------------
+ *  Software "GPU": `gpu_fill_cb` and `gpu_blend_cb` on the CPU
+ *-----------------------------------------------------------*/
+#ifndef USE_SOFT_GPU
+#  define USE_SOFT_GPU        0
+#endif
+
+#if USE_SOFT_GPU
+#  define SOFT_GPU_MIN_PX     16      /*Blend shorter spans with a plain loop, the vector kernels don't pay off*/
+#endif
+
+/*-----------------------------------------------------------
+ *  Network display: stream the flushed areas over TCP
+ *-----------------------------------------------------------*/
+#ifndef USE_NETDISP
+#  define USE_NETDISP         0
+#endif
+
+#if USE_NETDISP
+#  define NETDISP_OUT_MAX     (4UL * 1024UL * 1024UL)  /*Bytes queued for a slow receiver at most, then the screen is sent again*/
+#  define NETDISP_POLL_PERIOD 10      /*[ms] Accept a receiver, read its input and send the queue this often*/
+#endif
+
+/*The receiver of the stream, e.g. on a device (no sockets needed, see netdisp.h)*/
+#ifndef USE_NETDISP_RX
+#  define USE_NETDISP_RX      0
+#endif
+
 /*********************
  *  INPUT DEVICES
  *********************/
@@ -210,8 +255,22 @@
 #  define XPT2046_Y_MAX       3800
 #  define XPT2046_AVG         4
 #  define XPT2046_INV         0
+#  define XPT2046_Z_MIN       400   /*Minimal pressure of a touch with `USE_TOUCH_FILTER`*/
+#endif
+
+/*-------------------------------------------------
+ * Filtered sampling of the resistive touch pads (XPT2046, AD_touch)
+ * Sample in a timer with `xpt2046_sample`/`ad_touch_handler`, the read callbacks only fetch the filtered point
+ *------------------------------------------------*/
+#ifndef USE_TOUCH_FILTER
+#  define USE_TOUCH_FILTER    0
 #endif
 
+#if USE_TOUCH_FILTER
+#  define TOUCH_FILTER_MEDIAN     5     /*Raw samples in the median filter (odd)*/
+#  define TOUCH_FILTER_IIR_SHIFT  2     /*IIR filter: move 1/2^N of the way to the new median*/
+#endif  /*USE_TOUCH_FILTER*/
+
 /*-----------------
  *    FT5406EE8
  *-----------------*/
@@ -257,6 +316,18 @@
 /*No settings*/
 #endif
 
+/*-------------------------------------------------
+ * Background reader of the Linux input devices (evdev, libinput)
+ * Waits in epoll on a thread and queues the samples
+ *------------------------------------------------*/
+#ifndef USE_INDEV_THREAD
+#  define USE_INDEV_THREAD    0
+#endif
+
+#if USE_INDEV_THREAD
+#  define INDEV_THREAD_QUEUE_SIZE  64    /*Samples buffered per device, power of 2*/
+#endif  /*USE_INDEV_THREAD*/
+
 /*-------------------------------------------------
  * Touchscreen as libinput interface (for Linux based systems)
  *------------------------------------------------*/
@@ -305,6 +376,23 @@
 /*No settings*/
 #endif
 
+/*********************
+ *  FILE SYSTEMS
+ *********************/
+
+/*-------------------------------------------------
+ *  POSIX files, memory mapped for reading in place
+ *------------------------------------------------*/
+#ifndef USE_POSIX_FS
+#  define USE_POSIX_FS        0
+#endif
+
+#if USE_POSIX_FS
+#  define POSIX_FS_LETTER     'P'     /*E.g. "P:/img/logo.bin"*/
+#  define POSIX_FS_ROOT       ""      /*Prepended to the path after "P:/", "" is the working directory, "/" the root*/
+#  define POSIX_FS_MMAP       1       /*1: map the files opened for reading, decoders use them in place (lv_fs_map)*/
+#endif
+
 #endif  /*LV_DRV_CONF_H*/
 
 #endif /*End of "Content enable"*/
@@ -38,6 +38,7 @@
 #define LV_DRV_DISP_SPI_CS(val)          /*spi_cs_set(val)*/     /*Set the SPI's Chip select to 'val'*/
 #define LV_DRV_DISP_SPI_WR_BYTE(data)    /*spi_wr(data)*/        /*Write a byte the SPI bus*/
 #define LV_DRV_DISP_SPI_WR_ARRAY(adr, n) /*spi_wr_mem(adr, n)*/  /*Write 'n' bytes to SPI bus from 'adr'*/
+/*#define LV_DRV_DISP_SPI_WR_ARRAY_ASYNC(adr, n)  spi_dma_wr_mem(adr, n)*/  /*Start a DMA write of 'n' bytes from 'adr' and return. Call the driver's `xxx_flush_done()` when it's complete*/
 
 /*------------------
  *  Parallel port
@@ -47,6 +48,7 @@
 #define LV_DRV_DISP_PAR_FAST             /*par_fast()*/        /*Set high speed on the parallel port*/
 #define LV_DRV_DISP_PAR_WR_WORD(data)    /*par_wr(data)*/      /*Write a word to the parallel port*/
 #define LV_DRV_DISP_PAR_WR_ARRAY(adr, n) /*par_wr_mem(adr,n)*/ /*Write 'n' bytes to Parallel ports from 'adr'*/
+/*#define LV_DRV_DISP_PAR_WR_ARRAY_ASYNC(adr, n)  par_dma_wr_mem(adr, n)*/  /*Start a DMA write of 'n' words from 'adr' and return. Call the driver's `xxx_flush_done()` when it's complete*/
 
 /***************************
  * INPUT DEVICE INTERFACE
@@ -93,8 +95,11 @@
 /* Scale window by this factor (useful when simulating small screens) */
 #  define MONITOR_ZOOM        1
 
+/* Refresh at the rate of the screen (see `monitor_get_refr_period`) but at most this often */
+#  define MONITOR_MAX_FPS     60
+
 /* Used to test true double buffering with only address changing.
- * Set LV_VDB_SIZE = (LV_HOR_RES * LV_VER_RES) and  LV_VDB_DOUBLE = 1 and LV_COLOR_DEPTH = 32" */
+ * Set LV_VDB_SIZE = (LV_HOR_RES * LV_VER_RES) and  LV_VDB_DOUBLE = 1 and LV_COLOR_DEPTH = 32 (or 16 without LV_COLOR_16_SWAP)" */
 #  define MONITOR_DOUBLE_BUFFERED 0
 
 /*Eclipse: <SDL2/SDL.h>    Visual Studio: <SDL.h>*/
@@ -105,6 +110,9 @@
 
 /*Open two windows to test multi display support*/
 #  define MONITOR_DUAL            0
+
+/*Max. number of extra windows showing a frame scaled by the GPU (see `monitor_view_create`)*/
+#  define MONITOR_VIEW_MAX        4
 #endif
 
 /*-----------------------------------
@@ -188,6 +196,61 @@
 
 #if USE_FBDEV
 #  define FBDEV_PATH          "/dev/fb0"
+#  define FBDEV_DOUBLE_BUF    1       /*Draw directly into a double height framebuffer and flip its halves by panning (see `fbdev_get_double_buf`)*/
+#endif
+
+/*-----------------------------------------
+ *  Linux DRM/KMS device (/dev/dri/cardX)
+ *  Needs libdrm: -I/usr/include/libdrm -ldrm
+ *-----------------------------------------*/
+#ifndef USE_DRM
+#  define USE_DRM             0
+#endif
+
+#if USE_DRM
+#  define DRM_CARD            "/dev/dri/card0"
+#  define DRM_CONNECTOR_ID    -1      /*The connector to use, -1: the first connected one*/
+#  define DRM_BUF_CNT         3       /*Dumb buffers to draw into and flip between (see `drm_get_bufs`)*/
+#endif
+
+/*-----------------------------------------------------------
+ *  Software "GPU": `gpu_fill_cb` and `gpu_blend_cb` on the CPU
+ *-----------------------------------------------------------*/
+#ifndef USE_SOFT_GPU
+#  define USE_SOFT_GPU        1
+#endif
+
+#if USE_SOFT_GPU
+#  define SOFT_GPU_MIN_PX     16      /*Blend shorter spans with a plain loop, the vector kernels don't pay off*/
+#endif
+
+/*-----------------------------------------------------------
+ *  Network display: stream the flushed areas over TCP
+ *-----------------------------------------------------------*/
+#ifndef USE_NETDISP
+#  define USE_NETDISP         1
+#endif
+
+#if USE_NETDISP
+#  define NETDISP_OUT_MAX     (4UL * 1024UL * 1024UL)  /*Bytes queued for a slow receiver at most, then the screen is sent again*/
+#  define NETDISP_POLL_PERIOD 10      /*[ms] Accept a receiver, read its input and send the queue this often*/
+#endif
+
+/*The receiver of the stream, e.g. on a device (no sockets needed, see netdisp.h)*/
+#ifndef USE_NETDISP_RX
+#  define USE_NETDISP_RX      0
+#endif
+
+/*-----------------------------------------------------------
+ *  Shared memory display: publish the frame buffer to other processes
+ *-----------------------------------------------------------*/
+#ifndef USE_SHMDISP
+#  define USE_SHMDISP         1
+#endif
+
+/*A reader of the frames, for the consumers (see shmdisp.h)*/
+#ifndef USE_SHMDISP_RX
+#  define USE_SHMDISP_RX      0
 #endif
 
 /*********************
@@ -210,8 +273,22 @@
 #  define XPT2046_Y_MAX       3800
 #  define XPT2046_AVG         4
 #  define XPT2046_INV         0
+#  define XPT2046_Z_MIN       400   /*Minimal pressure of a touch with `USE_TOUCH_FILTER`*/
+#endif
+
+/*-------------------------------------------------
+ * Filtered sampling of the resistive touch pads (XPT2046, AD_touch)
+ * Sample in a timer with `xpt2046_sample`/`ad_touch_handler`, the read callbacks only fetch the filtered point
+ *------------------------------------------------*/
+#ifndef USE_TOUCH_FILTER
+#  define USE_TOUCH_FILTER    0
 #endif
 
+#if USE_TOUCH_FILTER
+#  define TOUCH_FILTER_MEDIAN     5     /*Raw samples in the median filter (odd)*/
+#  define TOUCH_FILTER_IIR_SHIFT  2     /*IIR filter: move 1/2^N of the way to the new median*/
+#endif  /*USE_TOUCH_FILTER*/
+
 /*-----------------
  *    FT5406EE8
  *-----------------*/
@@ -243,7 +320,7 @@
 #endif
 
 #if USE_MOUSE
-/*No settings*/
+#  define MOUSE_QUEUE_SIZE    64      /*Mouse events buffered until the next read (power of 2). 0: read only the last state*/
 #endif
 
 /*-------------------------------------------
@@ -257,6 +334,18 @@
 /*No settings*/
 #endif
 
+/*-------------------------------------------------
+ * Background reader of the Linux input devices (evdev, libinput)
+ * Waits in epoll on a thread and queues the samples
+ *------------------------------------------------*/
+#ifndef USE_INDEV_THREAD
+#  define USE_INDEV_THREAD    0
+#endif
+
+#if USE_INDEV_THREAD
+#  define INDEV_THREAD_QUEUE_SIZE  64    /*Samples buffered per device, power of 2*/
+#endif  /*USE_INDEV_THREAD*/
+
 /*-------------------------------------------------
  * Touchscreen as libinput interface (for Linux based systems)
  *------------------------------------------------*/
@@ -278,6 +367,7 @@
 #if USE_EVDEV
 #  define EVDEV_NAME   "/dev/input/event0"        /*You can use the "evtest" Linux tool to get the list of devices and test them*/
 #  define EVDEV_SWAP_AXES         0               /*Swap the x and y axes of the touchscreen*/
+#  define EVDEV_BUFFERED          1               /*1: report every sample (`SYN_REPORT`) in a separate read, 0: only the last one*/
 
 #  define EVDEV_SCALE             0               /* Scale input, e.g. if touchscreen resolution does not match display resolution */
 #  if EVDEV_SCALE
@@ -305,6 +395,23 @@
 /*No settings*/
 #endif
 
+/*********************
+ *  FILE SYSTEMS
+ *********************/
+
+/*-------------------------------------------------
+ *  POSIX files, memory mapped for reading in place
+ *------------------------------------------------*/
+#ifndef USE_POSIX_FS
+#  define USE_POSIX_FS        1
+#endif
+
+#if USE_POSIX_FS
+#  define POSIX_FS_LETTER     'P'     /*E.g. "P:/img/logo.bin"*/
+#  define POSIX_FS_ROOT       ""      /*Prepended to the path after "P:/", "" is the working directory, "/" the root*/
+#  define POSIX_FS_MMAP       1       /*1: map the files opened for reading, decoders use them in place (lv_fs_map)*/
+#endif
+
 #endif  /*LV_DRV_CONF_H*/
 
 #endif /*End of "Content enable"*/
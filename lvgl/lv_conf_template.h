@@ -50,6 +50,33 @@
  * Can be changed in the display driver (`lv_disp_drv_t`).*/
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 
+/* Side of the tiles [px] used to collect the invalidated areas when
+ * more than `LV_INV_BUF_SIZE` areas are invalidated in one refresh period.
+ * 0: invalidate the whole screen instead*/
+#define LV_INV_TILE_SIZE    0
+
+/* Max. number of screen sized buffers LittlevGL can cycle through (see `lv_disp_buf_init_chain`).
+ * With 3 or more a frame can be rendered while the previous ones are still being flushed.
+ * 2: only double buffering (`lv_disp_buf_init`)*/
+#define LV_DISP_BUF_MAX     2
+
+/* Number of threads drawing the refreshed areas in horizontal bands (0 or 1: draw on one thread).
+ * Needs POSIX threads. The object tree mustn't be modified by other threads while drawing*/
+#define LV_REFR_THREADS     0
+
+/* 1: Scroll the pages by moving their pixels in the frame buffer and redraw only the exposed parts.
+ * Works only with true double buffering (two screen sized buffers), else the pages are redrawn*/
+#define LV_USE_SCROLL_BLIT  0
+
+/* 1: Keep the tasks in a min-heap of their next run time for every priority.
+ * `lv_task_handler` doesn't check every task on every call, it takes O(log n) per executed task.
+ * 0: Check all tasks in every `lv_task_handler` call which needs a bit less memory*/
+#define LV_TASK_HEAP        0
+
+/* Size of the queue of `lv_async_post` (a power of 2) through which other threads can pass updates
+ * to the thread of `lv_task_handler`. 0: disable the lv_async module*/
+#define LV_ASYNC_QUEUE_SIZE 0
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -80,12 +107,27 @@ typedef int16_t lv_coord_t;
 
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #  define LV_MEM_AUTO_DEFRAG  1
+
+/* 1: Use a two level segregated fit (TLSF) allocator. Allocation and free take constant time
+ * and the adjacent free cells are always joined (`LV_MEM_AUTO_DEFRAG` is ignored).
+ * 0: Use the simple first fit allocator which needs a bit less memory*/
+#  define LV_MEM_TLSF         0
+
+/* Allocate the memories up to this size (in bytes) from chunks of same sized cells (slabs).
+ * Allocation and free are fast and the objects of the same type are close to each other.
+ * The unused cells of the chunks can't be used for other sizes. Mainly useful with the first fit allocator
+ * (`LV_MEM_TLSF 0`) which needs long search for small memories. 0: disable (max. 512)*/
+#  define LV_MEM_SLAB_MAX     0
 #else       /*LV_MEM_CUSTOM*/
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
 #  define LV_MEM_CUSTOM_ALLOC   malloc       /*Wrapper to malloc*/
 #  define LV_MEM_CUSTOM_FREE    free         /*Wrapper to free*/
 #endif     /*LV_MEM_CUSTOM*/
 
+/* The caches (images, glyphs, shadows, layers, font bitmaps) give back memory, the least recently used first,
+ * when an allocation fails and when together they hold more than this many bytes. 0: no common limit*/
+#define LV_MEM_CACHE_BUDGET     0
+
 /* Garbage Collector settings
  * Used if lvgl is binded to higher level language and the memory is managed by that language */
 #define LV_ENABLE_GC 0
@@ -95,6 +137,12 @@ typedef int16_t lv_coord_t;
 #  define LV_MEM_CUSTOM_GET_SIZE  your_mem_get_size      /*Wrapper to lv_mem_get_size*/
 #endif /* LV_ENABLE_GC */
 
+/* 1: Keep the state of a LittlevGL instance (displays, input devices, objects, tasks, animations, refreshing)
+ * in a context instead of global variables. Several independent contexts (`lv_context_create`) can run
+ * in parallel, every thread on its active one (`lv_context_set_act`).
+ * Needs LV_REFR_THREADS > 1 (the library lock guards the shared allocator and caches), not for LV_ENABLE_GC*/
+#define LV_USE_CONTEXT 0
+
 /*=======================
    Input device settings
  *=======================*/
@@ -119,6 +167,62 @@ typedef int16_t lv_coord_t;
  * Time between `LV_EVENT_LONG_PRESSED_REPEAT */
 #define LV_INDEV_DEF_LONG_PRESS_REP_TIME  100
 
+/* 1: Build a spatial index on the children of objects with a lot of children
+ * to find the pressed object without testing every child */
+#define LV_USE_HIT_INDEX                  0
+#if LV_USE_HIT_INDEX
+/* Index an object after the pointer had to test this many of its children */
+#define LV_HIT_INDEX_MIN_CHILDREN         64
+
+/* Number of indexed objects. The least recently used index is dropped for a new one */
+#define LV_HIT_INDEX_SLOTS                8
+
+/* Children per grid cell if they are spread evenly */
+#define LV_HIT_INDEX_CELL_ITEMS           4
+
+/* Max. number of columns (and rows) of the grid */
+#define LV_HIT_INDEX_GRID_MAX             64
+#endif /*LV_USE_HIT_INDEX*/
+
+/* 1: Keep the bounding box of the children of the objects (with their drawing and click area), so the
+ * refresh and the input devices skip all the children of an object if none of them is on the area or point.
+ * It's updated when it's needed after a child was added, moved or resized. Costs an area per object. */
+#define LV_USE_CHILD_BOUNDS               0
+
+/* 1: Cache the area of the parents and the screen of the objects, so invalidating an object doesn't
+ * visit all its parents. It's updated when it's needed after a parent was moved, resized or hidden.
+ * Costs an area and a pointer per object. */
+#define LV_USE_OBJ_CLIP_CACHE             0
+
+/* 1: Index the objects by their style, so a modified style refreshes only its users
+ * without visiting every object. Costs 2 pointers per object. */
+#define LV_USE_STYLE_INDEX                0
+#if LV_USE_STYLE_INDEX
+/* Number of hash buckets (power of 2). The objects of a bucket are tested one by one */
+#define LV_STYLE_INDEX_BUCKETS            64
+#endif /*LV_USE_STYLE_INDEX*/
+
+/* 1: Don't refresh the layout and the fit of a container on every change, only mark it.
+ * The marked containers are refreshed once before the next refresh and input read (the deepest first),
+ * or earlier by `lv_obj_align` or `lv_obj_layout_flush`. The sizes read in the meantime are the old ones. */
+#define LV_USE_LAYOUT_DEFER               0
+
+/* 1: Send `LV_SIGNAL_CORD_CHG` only to the objects which handle it (see `lv_obj_set_cord_signal`):
+ * moving an object calls its signal function only if it follows its position (e.g. the scrollable of a page),
+ * the others (e.g. containers, labels) only want to know when they are resized.
+ * A custom signal function handling it has to ask for it. */
+#define LV_USE_OBJ_CORD_SIGNAL            0
+
+/* 1: The children of an object can be created when it's shown first (`lv_obj_set_lazy`): hidden branches
+ * and the not selected tabs of a tab view don't cost memory and creation time until they are shown
+ * by `lv_obj_set_hidden(obj, false)` or the tab selection. */
+#define LV_USE_OBJ_LAZY                   0
+#if LV_USE_OBJ_LAZY
+/* Free bytes of `lv_mem` below which the lazy children of an object allowed to release them are deleted
+ * when it's hidden again (and created again when it's shown). 0: never release */
+#define LV_OBJ_LAZY_RELEASE_FREE          (8U * 1024U)
+#endif /*LV_USE_OBJ_LAZY*/
+
 /*==================
  * Feature usage
  *==================*/
@@ -134,16 +238,34 @@ typedef void * lv_anim_user_data_t;
 
 /* 1: Enable shadow drawing*/
 #define LV_USE_SHADOW           1
+#if LV_USE_SHADOW
+/* Number of calculated shadows (radius, width and opacity combinations) to keep for reuse. 0: no cache*/
+#  define LV_SHADOW_CACHE_SIZE  0
+#endif
 
 /* 1: Enable object groups (for keyboard/encoder navigation) */
 #define LV_USE_GROUP            1
 #if LV_USE_GROUP
 typedef void * lv_group_user_data_t;
+
+/* Number of focused/edited styles cached per drawing thread so a focused object isn't
+ * restyled by the group's callback at every draw. Costs 2 * sizeof(lv_style_t) each. 0: no cache */
+#define LV_GROUP_STYLE_CACHE    0
 #endif  /*LV_USE_GROUP*/
 
 /* 1: Enable GPU interface*/
 #define LV_USE_GPU              1
 
+/* 1: Let the display drivers show the cursor of the pointer input devices (`cursor_set_cb`)
+ * so moving it redraws nothing. The cursor object is drawn if the display can't show it. */
+#define LV_USE_HW_CURSOR        0
+
+/* 1: Blend and fill with SSE2/AVX2 or NEON if the CPU supports it (16 and 32 bit color depth)*/
+#define LV_USE_SIMD             0
+
+/* 1: Draw into 1 or 2 bit-per-pixel packed buffers for monochrome panels (see lv_draw_packed.h)*/
+#define LV_USE_DRAW_PACKED      0
+
 /* 1: Enable file system (might be required for images */
 #define LV_USE_FILESYSTEM       1
 #if LV_USE_FILESYSTEM
@@ -172,6 +294,19 @@ typedef void * lv_fs_drv_user_data_t;
  * LV_IMG_CACHE_DEF_SIZE must be >= 1 */
 #define LV_IMG_CACHE_DEF_SIZE       1
 
+/* Default byte budget of the image cache: the images of files and of `LV_IMG_CF_RAW...` variables
+ * are decoded once into buffers allocated with `lv_mem_alloc` (if they fit) and the least recently used
+ * unpinned images are closed to stay in the budget. 0: only LV_IMG_CACHE_DEF_SIZE limits the cache */
+#define LV_IMG_CACHE_DEF_BUDGET     0
+
+/* 1: Open and decode the images of files and of `LV_IMG_CF_RAW...` variables on a background thread.
+ * Until an image is ready a LV_IMG_CACHE_ASYNC_COLOR rectangle is drawn in its place.
+ * Needs LV_REFR_THREADS > 1 and LV_ASYNC_QUEUE_SIZE. The image decoders have to be thread safe */
+#define LV_USE_IMG_CACHE_ASYNC      0
+#if LV_USE_IMG_CACHE_ASYNC
+#define LV_IMG_CACHE_ASYNC_COLOR    LV_COLOR_SILVER
+#endif
+
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_img_decoder_user_data_t;
 
@@ -198,6 +333,7 @@ typedef void * lv_img_decoder_user_data_t;
  *==================*/
 
 /* 1: use a custom tick source.
+ * 2: use the built-in POSIX source reading `clock_gettime(CLOCK_MONOTONIC)`.
  * It removes the need to manually update the tick with `lv_tick_inc`) */
 #define LV_TICK_CUSTOM     0
 #if LV_TICK_CUSTOM == 1
@@ -226,6 +362,12 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
 /* 1: Print the log with 'printf';
  * 0: user need to register a callback with `lv_log_register_print`*/
 #  define LV_LOG_PRINTF   0
+
+/* Size of a ring buffer (a power of 2) for the logs. They are printed later by a low priority task
+ * so logging doesn't stall the drawing. When the ring is full the logs are dropped and counted.
+ * 0: print the logs immediately */
+#  define LV_LOG_ASYNC_SIZE   0
+#  define LV_LOG_ASYNC_RATE_MS 1000   /*Repeats of a log (same file and line) within this time are only counted*/
 #endif  /*LV_USE_LOG*/
 
 /*================
@@ -274,6 +416,23 @@ typedef void * lv_indev_drv_user_data_t;            /*Type of user data in the i
 /*Always set a default font from the built-in fonts*/
 #define LV_FONT_DEFAULT        &lv_font_roboto_16
 
+/*Number of glyphs to keep expanded to 8 bit-per-pixel for faster drawing. 0: no cache*/
+#define LV_GLYPH_CACHE_SIZE    0
+
+/*Load fonts from files with `lv_font_bin_load` (needs `LV_USE_FILESYSTEM`).
+ *Only the character maps and the glyph descriptors stay in RAM, the glyph bitmaps are read
+ *when they are drawn and the last used ones are kept in a cache of `LV_FONT_BIN_CACHE_BUDGET` bytes*/
+#define LV_USE_FONT_BIN        0
+#define LV_FONT_BIN_CACHE_BUDGET   (16U * 1024U)
+
+/*Let `lv_font_fmt_txt_accel_build` give a font a codepoint page table and a kerning hash table
+ *to find glyphs and kerning values in constant time. Costs about 512 bytes per 256 code point page*/
+#define LV_FONT_FMT_TXT_ACCEL  0
+
+/*Draw fonts with `LV_FONT_FMT_TXT_COMPRESSED` glyph bitmaps. They are expanded when drawn the first time
+ *so keep `LV_GLYPH_CACHE_SIZE` enabled with them*/
+#define LV_USE_FONT_COMPRESSED 0
+
 /*Declare the type of the user data of fonts (can be e.g. `void *`, `int`, `struct`)*/
 typedef void * lv_font_user_data_t;
 
@@ -330,6 +489,15 @@ typedef void * lv_obj_user_data_t;
 
 /*Button matrix (dependencies: -)*/
 #define LV_USE_BTNM     1
+#if LV_USE_BTNM != 0
+/*Keep the areas of the buttons and the texts drawn into maps which no button matrix uses
+ *until they are larger than this many bytes (e.g. for the keyboards created again)*/
+#  define LV_BTNM_SHARE_KEEP              (8U * 1024U)
+
+/*Draw a one line text of a released button once into an opacity map of at most this many bytes
+ *and share it with the buttons with the same text and font. 0: disable*/
+#  define LV_BTNM_LABEL_MAP_MAX           (2U * 1024U)
+#endif
 
 /*Calendar (dependencies: -)*/
 #define LV_USE_CALENDAR 1
@@ -344,6 +512,9 @@ typedef void * lv_obj_user_data_t;
 #define LV_USE_CHART    1
 #if LV_USE_CHART
 #  define LV_CHART_AXIS_TICK_LABEL_MAX_LEN    20
+/*Series with their own 32 bit point count in a ring buffer (`lv_chart_add_ring_series`).
+ * Appending is O(1) and they are drawn as a min/max envelope when they have more points than the chart has pixels*/
+#  define LV_CHART_RING_SERIES    0
 #endif
 
 /*Container (dependencies: -*/
@@ -367,6 +538,18 @@ typedef void * lv_obj_user_data_t;
 #if LV_USE_IMGBTN
 /*1: The imgbtn requires left, mid and right parts and the width can be set freely*/
 #  define LV_IMGBTN_TILED 0
+/*1: Keep the images of every state opened in the image cache (`lv_img_cache_pin`) while the imgbtn uses them,
+ *so a state change only draws the other image*/
+#  define LV_IMGBTN_PIN   0
+#endif
+
+/*Animated image streamed from a file of `lv_animimg_save` (dependencies: LV_USE_FILESYSTEM)*/
+#define LV_USE_ANIMIMG  0
+#if LV_USE_ANIMIMG
+/*Decoded frames kept in the memory (>= 2): the shown one and the ones decoded ahead of it*/
+#  define LV_ANIMIMG_RING         3
+/*[bytes] read from the file at once*/
+#  define LV_ANIMIMG_READ_AHEAD   4096
 #endif
 
 /*Keyboard (dependencies: lv_btnm)*/
@@ -399,6 +582,8 @@ typedef void * lv_obj_user_data_t;
 #if LV_USE_LIST != 0
 /*Default animation time of focusing to a list element [ms] (0: no animation)  */
 #  define LV_LIST_DEF_ANIM_TIME  100
+/*Virtual lists (`lv_list_set_virtual`): only the visible rows are created and they are recycled while scrolling*/
+#  define LV_LIST_VIRTUAL        0
 #endif
 
 /*Line meter (dependencies: *;)*/
@@ -18,6 +18,7 @@ extern "C" {
 
 #include "src/lv_misc/lv_log.h"
 #include "src/lv_misc/lv_task.h"
+#include "src/lv_misc/lv_async.h"
 #include "src/lv_misc/lv_math.h"
 
 #include "src/lv_hal/lv_hal.h"
@@ -26,16 +27,25 @@ extern "C" {
 #include "src/lv_core/lv_group.h"
 
 #include "src/lv_core/lv_refr.h"
+#include "src/lv_core/lv_context.h"
 #include "src/lv_core/lv_disp.h"
+#include "src/lv_core/lv_prof.h"
+#include "src/lv_core/lv_layer.h"
+#include "src/lv_core/lv_slide.h"
+#include "src/lv_core/lv_hit.h"
 
 #include "src/lv_themes/lv_theme.h"
 
 #include "src/lv_font/lv_font.h"
 #include "src/lv_font/lv_font_fmt_txt.h"
+#include "src/lv_font/lv_font_bin.h"
+
+#include "src/lv_draw/lv_draw_packed.h"
 
 #include "src/lv_objx/lv_btn.h"
 #include "src/lv_objx/lv_imgbtn.h"
 #include "src/lv_objx/lv_img.h"
+#include "src/lv_objx/lv_animimg.h"
 #include "src/lv_objx/lv_label.h"
 #include "src/lv_objx/lv_line.h"
 #include "src/lv_objx/lv_page.h"
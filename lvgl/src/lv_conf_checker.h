@@ -61,6 +61,77 @@
 #define LV_DISP_DEF_REFR_PERIOD      30      /*[ms]*/
 #endif
 
+/* Side of the tiles [px] used to collect the invalidated areas when
+ * more than `LV_INV_BUF_SIZE` areas are invalidated in one refresh period.
+ * 0: invalidate the whole screen instead*/
+#ifndef LV_INV_TILE_SIZE
+#define LV_INV_TILE_SIZE    0
+#endif
+
+/* Max. number of screen sized buffers LittlevGL can cycle through (see `lv_disp_buf_init_chain`).
+ * With 3 or more a frame can be rendered while the previous ones are still being flushed.
+ * 2: only double buffering (`lv_disp_buf_init`)*/
+#ifndef LV_DISP_BUF_MAX
+#define LV_DISP_BUF_MAX     2
+#endif
+
+/* Number of threads drawing the refreshed areas in horizontal bands (0 or 1: draw on one thread).
+ * Needs POSIX threads. The object tree mustn't be modified by other threads while drawing*/
+#ifndef LV_REFR_THREADS
+#define LV_REFR_THREADS     0
+#endif
+
+/* Initial size [bytes] of the arena every drawing thread takes its temporary buffers from.
+ * It's reset after every refreshed area and enlarged to the most that was needed at once*/
+#ifndef LV_DRAW_SCRATCH_SIZE
+#define LV_DRAW_SCRATCH_SIZE    (2U * 1024U)
+#endif
+
+/* 1: Scroll the pages by moving their pixels in the frame buffer and redraw only the exposed parts.
+ * Works only with true double buffering (two screen sized buffers), else the pages are redrawn*/
+#ifndef LV_USE_SCROLL_BLIT
+#define LV_USE_SCROLL_BLIT  0
+#endif
+
+/* 1: Keep the tasks in a min-heap of their next run time for every priority.
+ * `lv_task_handler` doesn't check every task on every call, it takes O(log n) per executed task.
+ * 0: Check all tasks in every `lv_task_handler` call which needs a bit less memory*/
+#ifndef LV_TASK_HEAP
+#define LV_TASK_HEAP        0
+#endif
+
+/* Size of the queue of `lv_async_post` (a power of 2) through which other threads can pass updates
+ * to the thread of `lv_task_handler`. 0: disable the lv_async module*/
+#ifndef LV_ASYNC_QUEUE_SIZE
+#define LV_ASYNC_QUEUE_SIZE 0
+#endif
+
+/* 1: Count how many times the pixels are drawn in a refresh (`lv_draw_overdraw_set_en`) to find overdraw.
+ * Needs LV_HOR_RES_MAX * LV_VER_RES_MAX bytes*/
+#ifndef LV_USE_OVERDRAW
+#define LV_USE_OVERDRAW     0
+#endif
+
+/* 1: Measure every refresh of the displays (areas, pixels, time of the design functions by object type,
+ * time of the flushing, counts of the drawing operations) and the time of the tasks. `lv_prof_set_en(true)` starts the measuring.
+ * The last frames can be read with `lv_prof_get_frame`*/
+#ifndef LV_USE_PROF
+#define LV_USE_PROF         0
+#endif
+#if LV_USE_PROF
+#ifndef LV_PROF_FRAME_CNT
+#define LV_PROF_FRAME_CNT   128     /*Number of frames to keep*/
+#endif
+#ifndef LV_PROF_TYPE_MAX
+#define LV_PROF_TYPE_MAX    16      /*Object types measured in a frame, the others count only in the total*/
+#endif
+
+/* 1: Take the microseconds from an expression. 0: use `lv_tick_get() * 1000` (ms resolution)*/
+#ifndef LV_PROF_TIME_CUSTOM
+#define LV_PROF_TIME_CUSTOM 0
+#endif
+#endif
+
 /* Dot Per Inch: used to initialize default sizes.
  * E.g. a button with width = LV_DPI / 2 -> half inch wide
  * (Not so important, you can adjust it to modify default sizes and spaces)*/
@@ -98,10 +169,60 @@
 #  define LV_MEM_ADR          0
 #endif
 
+/* Number of memories the allocator can use: the first one (above) and the ones added by
+ * `lv_mem_add_region` (e.g. external SRAM/PSRAM) or `LV_MEM_GROW`*/
+#ifndef LV_MEM_REGION_MAX
+#  define LV_MEM_REGION_MAX   4
+#endif
+
+/* 1: Get a new region from the system when the memory is full. It doubles the memory
+ * (by at least `LV_MEM_GROW_SIZE` bytes). The regions are kept until the exit.*/
+#ifndef LV_MEM_GROW
+#  define LV_MEM_GROW         0
+#endif
+#if LV_MEM_GROW
+#ifndef LV_MEM_GROW_INCLUDE
+#  define LV_MEM_GROW_INCLUDE <stdlib.h>  /*Header for the function below*/
+#endif
+#ifndef LV_MEM_GROW_ALLOC
+#  define LV_MEM_GROW_ALLOC   malloc      /*Allocate the memory of a new region*/
+#endif
+#ifndef LV_MEM_GROW_SIZE
+#  define LV_MEM_GROW_SIZE    (32U * 1024U)
+#endif
+#endif
+
 /* Automatically defrag. on free. Defrag. means joining the adjacent free cells. */
 #ifndef LV_MEM_AUTO_DEFRAG
 #  define LV_MEM_AUTO_DEFRAG  1
 #endif
+
+/* 1: Use a two level segregated fit (TLSF) allocator. Allocation and free take constant time
+ * and the adjacent free cells are always joined (`LV_MEM_AUTO_DEFRAG` is ignored).
+ * 0: Use the simple first fit allocator which needs a bit less memory*/
+#ifndef LV_MEM_TLSF
+#  define LV_MEM_TLSF         0
+#endif
+
+/* Allocate the memories up to this size (in bytes) from chunks of same sized cells (slabs).
+ * Allocation and free are fast and the objects of the same type are close to each other.
+ * The unused cells of the chunks can't be used for other sizes. 0: disable (max. 512)*/
+#ifndef LV_MEM_SLAB_MAX
+#  define LV_MEM_SLAB_MAX     0
+#endif
+
+/* 1: Count the allocated memory by subsystem (object, ext. attributes, label text, image...) and record
+ * the call site (file and line) of every allocation. `lv_mem_prof_get_stat` gives the used and the highest
+ * bytes of a subsystem, `lv_mem_prof_get_alloc` lists the living allocations (e.g. the leaks).
+ * Needs LV_MEM_PROF_ENT_MAX * 24 bytes*/
+#ifndef LV_MEM_PROF
+#  define LV_MEM_PROF         0
+#endif
+#if LV_MEM_PROF
+#ifndef LV_MEM_PROF_ENT_MAX
+#  define LV_MEM_PROF_ENT_MAX 4096    /*Recorded allocations at once (power of 2), the others are counted only*/
+#endif
+#endif
 #else       /*LV_MEM_CUSTOM*/
 #ifndef LV_MEM_CUSTOM_INCLUDE
 #  define LV_MEM_CUSTOM_INCLUDE <stdlib.h>   /*Header for the dynamic memory function*/
@@ -114,6 +235,27 @@
 #endif
 #endif     /*LV_MEM_CUSTOM*/
 
+/* The caches (images, glyphs, shadows, layers, font bitmaps) give back memory, the least recently used first,
+ * when an allocation fails and when together they hold more than this many bytes. 0: no common limit*/
+#ifndef LV_MEM_CACHE_BUDGET
+#define LV_MEM_CACHE_BUDGET     0
+#endif
+#ifndef LV_MEM_PROF
+#  define LV_MEM_PROF         0    /*Works only with the built-in `lv_mem_alloc`*/
+#endif
+
+/* 1: The linked lists of the objects, animations, tasks and groups take their nodes from pools of same sized
+ * nodes instead of allocating every node, so creating and deleting them doesn't touch the heap.
+ * The pools grow by chunks of LV_LL_POOL_CHUNK nodes and keep the freed nodes for the next ones. */
+#ifndef LV_USE_LL_POOL
+#define LV_USE_LL_POOL      0
+#endif
+#if LV_USE_LL_POOL
+#ifndef LV_LL_POOL_CHUNK
+#  define LV_LL_POOL_CHUNK    16
+#endif
+#endif
+
 /* Garbage Collector settings
  * Used if lvgl is binded to higher level language and the memory is managed by that language */
 #ifndef LV_ENABLE_GC
@@ -131,6 +273,14 @@
 #endif
 #endif /* LV_ENABLE_GC */
 
+/* 1: Keep the state of a LittlevGL instance (displays, input devices, objects, tasks, animations, refreshing)
+ * in a context instead of global variables. Several independent contexts (`lv_context_create`) can run
+ * in parallel, every thread on its active one (`lv_context_set_act`).
+ * Needs LV_REFR_THREADS > 1 (the library lock guards the shared allocator and caches), not for LV_ENABLE_GC*/
+#ifndef LV_USE_CONTEXT
+#define LV_USE_CONTEXT 0
+#endif
+
 /*=======================
    Input device settings
  *=======================*/
@@ -165,6 +315,139 @@
 #define LV_INDEV_DEF_LONG_PRESS_REP_TIME  100
 #endif
 
+/* 1: Build a spatial index on the children of objects with a lot of children
+ * to find the pressed object without testing every child */
+#ifndef LV_USE_HIT_INDEX
+#define LV_USE_HIT_INDEX                  0
+#endif
+#if LV_USE_HIT_INDEX
+/* Index an object after the pointer had to test this many of its children */
+#ifndef LV_HIT_INDEX_MIN_CHILDREN
+#define LV_HIT_INDEX_MIN_CHILDREN         64
+#endif
+
+/* Number of indexed objects. The least recently used index is dropped for a new one */
+#ifndef LV_HIT_INDEX_SLOTS
+#define LV_HIT_INDEX_SLOTS                8
+#endif
+
+/* Children per grid cell if they are spread evenly */
+#ifndef LV_HIT_INDEX_CELL_ITEMS
+#define LV_HIT_INDEX_CELL_ITEMS           4
+#endif
+
+/* Max. number of columns (and rows) of the grid */
+#ifndef LV_HIT_INDEX_GRID_MAX
+#define LV_HIT_INDEX_GRID_MAX             64
+#endif
+#endif /*LV_USE_HIT_INDEX*/
+
+/* 1: Keep the bounding box of the children of the objects (with their drawing and click area), so the
+ * refresh and the input devices skip all the children of an object if none of them is on the area or point.
+ * It's updated when it's needed after a child was added, moved or resized. Costs an area per object. */
+#ifndef LV_USE_CHILD_BOUNDS
+#define LV_USE_CHILD_BOUNDS               0
+#endif
+
+/* 1: Cache the area of the parents and the screen of the objects, so invalidating an object doesn't
+ * visit all its parents. It's updated when it's needed after a parent was moved, resized or hidden.
+ * Costs an area and a pointer per object. */
+#ifndef LV_USE_OBJ_CLIP_CACHE
+#define LV_USE_OBJ_CLIP_CACHE             0
+#endif
+
+/* 1: Index the objects by their style, so a modified style refreshes only its users
+ * without visiting every object. Costs 2 pointers per object. */
+#ifndef LV_USE_STYLE_INDEX
+#define LV_USE_STYLE_INDEX                0
+#endif
+#if LV_USE_STYLE_INDEX
+/* Number of hash buckets (power of 2). The objects of a bucket are tested one by one */
+#ifndef LV_STYLE_INDEX_BUCKETS
+#define LV_STYLE_INDEX_BUCKETS            64
+#endif
+#endif /*LV_USE_STYLE_INDEX*/
+
+/* 1: Keep an array of the children of the objects whose children are accessed by index
+ * (`lv_obj_get_child_by_index`). It's created at the first such access and updated on every change
+ * of the children, so the index and the reverse order cost nothing. Costs a pointer per such child. */
+#ifndef LV_USE_OBJ_CHILD_ARRAY
+#define LV_USE_OBJ_CHILD_ARRAY            0
+#endif
+
+/* 1: Don't refresh the layout and the fit of a container on every change, only mark it.
+ * The marked containers are refreshed once before the next refresh and input read (the deepest first),
+ * or earlier by `lv_obj_align` or `lv_obj_layout_flush`. The sizes read in the meantime are the old ones. */
+#ifndef LV_USE_LAYOUT_DEFER
+#define LV_USE_LAYOUT_DEFER               0
+#endif
+
+/* 1: Send `LV_SIGNAL_CORD_CHG` only to the objects which handle it (see `lv_obj_set_cord_signal`):
+ * moving an object calls its signal function only if it follows its position (e.g. the scrollable of a page),
+ * the others (e.g. containers, labels) only want to know when they are resized.
+ * A custom signal function handling it has to ask for it. */
+#ifndef LV_USE_OBJ_CORD_SIGNAL
+#define LV_USE_OBJ_CORD_SIGNAL            0
+#endif
+
+/* 1: Objects can be cached as bitmaps (`lv_obj_set_layer_cache`). The area of a cached object is drawn once
+ * with everything below it and copied from the bitmap until the object, a child or something below it
+ * is invalidated. Good for static windows and panels which are redrawn because something above them changes. */
+#ifndef LV_USE_LAYER_CACHE
+#define LV_USE_LAYER_CACHE                0
+#endif
+#if LV_USE_LAYER_CACHE
+/* Number of cached objects */
+#ifndef LV_LAYER_CACHE_SLOTS
+#define LV_LAYER_CACHE_SLOTS              8
+#endif
+
+/* Bytes of the bitmaps (allocated with `lv_mem_alloc`). The least recently copied ones are dropped for a new one */
+#ifndef LV_LAYER_CACHE_BUDGET
+#define LV_LAYER_CACHE_BUDGET             (256U * 1024U)
+#endif
+
+/* Min. time [ms] between two redraws of a modal backdrop's bitmap (`lv_obj_set_layer_backdrop`)
+ * when something changes below it */
+#ifndef LV_LAYER_BACKDROP_PERIOD
+#define LV_LAYER_BACKDROP_PERIOD          250
+#endif
+#endif /*LV_USE_LAYER_CACHE*/
+
+/* 1: An object with opa scale (`lv_obj_set_opa_scale`) and children is drawn opaque with its children
+ * and blended once with the opa scale (the background is saved in the scratch arena).
+ * 0: every drawing of the children and their parts is blended with it, overlapping parts mix twice. */
+#ifndef LV_USE_OPA_GROUP
+#define LV_USE_OPA_GROUP                  0
+#endif
+
+/* 1: Tab views and tile views can slide between their tabs as two bitmaps (`lv_tabview_set_slide_snapshot`).
+ * The old and the new tab are drawn once at the start, the frames of the animation only copy them.
+ * Meant for opaque tabs: what's below them slides too. */
+#ifndef LV_USE_SLIDE_SNAPSHOT
+#define LV_USE_SLIDE_SNAPSHOT             0
+#endif
+#if LV_USE_SLIDE_SNAPSHOT
+/* Max. bytes of the two bitmaps (allocated with `lv_mem_alloc`). Larger tabs are animated as usual */
+#ifndef LV_SLIDE_SNAPSHOT_MAX
+#define LV_SLIDE_SNAPSHOT_MAX             (256U * 1024U)
+#endif
+#endif /*LV_USE_SLIDE_SNAPSHOT*/
+
+/* 1: The children of an object can be created when it's shown first (`lv_obj_set_lazy`): hidden branches
+ * and the not selected tabs of a tab view don't cost memory and creation time until they are shown
+ * by `lv_obj_set_hidden(obj, false)` or the tab selection. */
+#ifndef LV_USE_OBJ_LAZY
+#define LV_USE_OBJ_LAZY                   0
+#endif
+#if LV_USE_OBJ_LAZY
+/* Free bytes of `lv_mem` below which the lazy children of an object allowed to release them are deleted
+ * when it's hidden again (and created again when it's shown). 0: never release */
+#ifndef LV_OBJ_LAZY_RELEASE_FREE
+#define LV_OBJ_LAZY_RELEASE_FREE          (8U * 1024U)
+#endif
+#endif /*LV_USE_OBJ_LAZY*/
+
 /*==================
  * Feature usage
  *==================*/
@@ -177,18 +460,48 @@
 
 /*Declare the type of the user data of animations (can be e.g. `void *`, `int`, `struct`)*/
 
+/* 1: Evaluate the built-in eased paths (ease in/out, overshoot, bounce) from tables
+ * filled in `lv_anim_core_init` instead of computing a Bezier curve in every step (~2.5 kB RAM)*/
+#ifndef LV_ANIM_PATH_LUT
+#define LV_ANIM_PATH_LUT        0
+#endif
+
 #endif
 
 /* 1: Enable shadow drawing*/
 #ifndef LV_USE_SHADOW
 #define LV_USE_SHADOW           1
 #endif
+#if LV_USE_SHADOW
+/* Number of calculated shadows (radius, width and opacity combinations) to keep for reuse. 0: no cache*/
+#ifndef LV_SHADOW_CACHE_SIZE
+#  define LV_SHADOW_CACHE_SIZE  0
+#endif
+#endif
+
+/* 1: Dither the vertical gradients of the rectangles so they don't show bands with 16 bit colors.
+ * Only with LV_COLOR_DEPTH 16, the dithered rows are drawn pixel by pixel*/
+#ifndef LV_GRAD_DITHER
+#define LV_GRAD_DITHER          0
+#endif
 
 /* 1: Enable object groups (for keyboard/encoder navigation) */
 #ifndef LV_USE_GROUP
 #define LV_USE_GROUP            1
 #endif
 #if LV_USE_GROUP
+
+/* 1: Keep the objects of a group sorted by their position (rebuilt when they move)
+ * so `lv_group_focus_dir` doesn't test every object. Costs 2 * 8 bytes per object. */
+#ifndef LV_USE_GROUP_NAV_INDEX
+#define LV_USE_GROUP_NAV_INDEX  0
+#endif
+
+/* Number of focused/edited styles cached per drawing thread so a focused object isn't
+ * restyled by the group's callback at every draw. Costs 2 * sizeof(lv_style_t) each. 0: no cache */
+#ifndef LV_GROUP_STYLE_CACHE
+#define LV_GROUP_STYLE_CACHE    0
+#endif
 #endif  /*LV_USE_GROUP*/
 
 /* 1: Enable GPU interface*/
@@ -196,12 +509,38 @@
 #define LV_USE_GPU              1
 #endif
 
+/* 1: Let the display drivers show the cursor of the pointer input devices (`cursor_set_cb`)
+ * so moving it redraws nothing. The cursor object is drawn if the display can't show it. */
+#ifndef LV_USE_HW_CURSOR
+#define LV_USE_HW_CURSOR        0
+#endif
+
+/* 1: Blend and fill with SSE2/AVX2 or NEON if the CPU supports it (16 and 32 bit color depth)*/
+#ifndef LV_USE_SIMD
+#define LV_USE_SIMD             0
+#endif
+
+/* 1: Draw into 1 or 2 bit-per-pixel packed buffers for monochrome panels (see lv_draw_packed.h)*/
+#ifndef LV_USE_DRAW_PACKED
+#define LV_USE_DRAW_PACKED      0
+#endif
+
 /* 1: Enable file system (might be required for images */
 #ifndef LV_USE_FILESYSTEM
 #define LV_USE_FILESYSTEM       1
 #endif
 #if LV_USE_FILESYSTEM
 /*Declare the type of the user data of file system drivers (can be e.g. `void *`, `int`, `struct`)*/
+
+/*Read the files opened for reading through a cache of `LV_FS_CACHE_BLOCK_CNT` blocks of `LV_FS_CACHE_BLOCK_SIZE` bytes,
+ *so small reads (e.g. the lines of an image) don't go to the driver one by one.
+ *0: no cache. A driver can override them in its `lv_fs_drv_t`*/
+#ifndef LV_FS_CACHE_BLOCK_SIZE
+#define LV_FS_CACHE_BLOCK_SIZE  512
+#endif
+#ifndef LV_FS_CACHE_BLOCK_CNT
+#define LV_FS_CACHE_BLOCK_CNT   2
+#endif
 #endif
 
 /*1: Add a `user_data` to drivers and objects*/
@@ -233,6 +572,25 @@
 #define LV_IMG_CACHE_DEF_SIZE       1
 #endif
 
+/* Default byte budget of the image cache: the images of files and of `LV_IMG_CF_RAW...` variables
+ * are decoded once into buffers allocated with `lv_mem_alloc` (if they fit) and the least recently used
+ * unpinned images are closed to stay in the budget. 0: only LV_IMG_CACHE_DEF_SIZE limits the cache */
+#ifndef LV_IMG_CACHE_DEF_BUDGET
+#define LV_IMG_CACHE_DEF_BUDGET     0
+#endif
+
+/* 1: Open and decode the images of files and of `LV_IMG_CF_RAW...` variables on a background thread.
+ * Until an image is ready a LV_IMG_CACHE_ASYNC_COLOR rectangle is drawn in its place.
+ * Needs LV_REFR_THREADS > 1 and LV_ASYNC_QUEUE_SIZE. The image decoders have to be thread safe */
+#ifndef LV_USE_IMG_CACHE_ASYNC
+#define LV_USE_IMG_CACHE_ASYNC      0
+#endif
+#if LV_USE_IMG_CACHE_ASYNC
+#ifndef LV_IMG_CACHE_ASYNC_COLOR
+#define LV_IMG_CACHE_ASYNC_COLOR    LV_COLOR_SILVER
+#endif
+#endif
+
 /*Declare the type of the user data of image decoder (can be e.g. `void *`, `int`, `struct`)*/
 
 /*=====================
@@ -266,6 +624,7 @@
  *==================*/
 
 /* 1: use a custom tick source.
+ * 2: use the built-in POSIX source reading `clock_gettime(CLOCK_MONOTONIC)`.
  * It removes the need to manually update the tick with `lv_tick_inc`) */
 #ifndef LV_TICK_CUSTOM
 #define LV_TICK_CUSTOM     0
@@ -304,6 +663,16 @@
 #ifndef LV_LOG_PRINTF
 #  define LV_LOG_PRINTF   0
 #endif
+
+/* Size of a ring buffer (a power of 2) for the logs. They are printed later by a low priority task
+ * so logging doesn't stall the drawing. When the ring is full the logs are dropped and counted.
+ * 0: print the logs immediately */
+#ifndef LV_LOG_ASYNC_SIZE
+#  define LV_LOG_ASYNC_SIZE   0
+#endif
+#ifndef LV_LOG_ASYNC_RATE_MS
+#  define LV_LOG_ASYNC_RATE_MS 1000   /*Repeats of a log (same file and line) within this time are only counted*/
+#endif
 #endif  /*LV_USE_LOG*/
 
 /*================
@@ -384,6 +753,33 @@
 #define LV_FONT_DEFAULT        &lv_font_roboto_16
 #endif
 
+/*Number of glyphs to keep expanded to 8 bit-per-pixel for faster drawing. 0: no cache*/
+#ifndef LV_GLYPH_CACHE_SIZE
+#define LV_GLYPH_CACHE_SIZE    0
+#endif
+
+/*Load fonts from files with `lv_font_bin_load` (needs `LV_USE_FILESYSTEM`).
+ *Only the character maps and the glyph descriptors stay in RAM, the glyph bitmaps are read
+ *when they are drawn and the last used ones are kept in a cache of `LV_FONT_BIN_CACHE_BUDGET` bytes*/
+#ifndef LV_USE_FONT_BIN
+#define LV_USE_FONT_BIN        0
+#endif
+#ifndef LV_FONT_BIN_CACHE_BUDGET
+#define LV_FONT_BIN_CACHE_BUDGET   (16U * 1024U)
+#endif
+
+/*Let `lv_font_fmt_txt_accel_build` give a font a codepoint page table and a kerning hash table
+ *to find glyphs and kerning values in constant time. Costs about 512 bytes per 256 code point page*/
+#ifndef LV_FONT_FMT_TXT_ACCEL
+#define LV_FONT_FMT_TXT_ACCEL  0
+#endif
+
+/*Draw fonts with `LV_FONT_FMT_TXT_COMPRESSED` glyph bitmaps. They are expanded when drawn the first time
+ *so keep `LV_GLYPH_CACHE_SIZE` enabled with them*/
+#ifndef LV_USE_FONT_COMPRESSED
+#define LV_USE_FONT_COMPRESSED 0
+#endif
+
 /*Declare the type of the user data of fonts (can be e.g. `void *`, `int`, `struct`)*/
 
 /*=================
@@ -456,6 +852,19 @@
 #ifndef LV_USE_BTNM
 #define LV_USE_BTNM     1
 #endif
+#if LV_USE_BTNM != 0
+/*Keep the areas of the buttons and the texts drawn into maps which no button matrix uses
+ *until they are larger than this many bytes (e.g. for the keyboards created again)*/
+#ifndef LV_BTNM_SHARE_KEEP
+#  define LV_BTNM_SHARE_KEEP              (8U * 1024U)
+#endif
+
+/*Draw a one line text of a released button once into an opacity map of at most this many bytes
+ *and share it with the buttons with the same text and font. 0: disable*/
+#ifndef LV_BTNM_LABEL_MAP_MAX
+#  define LV_BTNM_LABEL_MAP_MAX           (2U * 1024U)
+#endif
+#endif
 
 /*Calendar (dependencies: -)*/
 #ifndef LV_USE_CALENDAR
@@ -480,6 +889,9 @@
 #ifndef LV_CHART_AXIS_TICK_LABEL_MAX_LEN
 #  define LV_CHART_AXIS_TICK_LABEL_MAX_LEN    20
 #endif
+#ifndef LV_CHART_RING_SERIES
+#  define LV_CHART_RING_SERIES    0
+#endif
 #endif
 
 /*Container (dependencies: -*/
@@ -517,6 +929,26 @@
 #ifndef LV_IMGBTN_TILED
 #  define LV_IMGBTN_TILED 0
 #endif
+/*1: Keep the images of every state opened in the image cache (`lv_img_cache_pin`) while the imgbtn uses them,
+ *so a state change only draws the other image*/
+#ifndef LV_IMGBTN_PIN
+#  define LV_IMGBTN_PIN   0
+#endif
+#endif
+
+/*Animated image streamed from a file of `lv_animimg_save` (dependencies: LV_USE_FILESYSTEM)*/
+#ifndef LV_USE_ANIMIMG
+#define LV_USE_ANIMIMG  0
+#endif
+#if LV_USE_ANIMIMG
+/*Decoded frames kept in the memory (>= 2): the shown one and the ones decoded ahead of it*/
+#ifndef LV_ANIMIMG_RING
+#  define LV_ANIMIMG_RING         3
+#endif
+/*[bytes] read from the file at once*/
+#ifndef LV_ANIMIMG_READ_AHEAD
+#  define LV_ANIMIMG_READ_AHEAD   4096
+#endif
 #endif
 
 /*Keyboard (dependencies: lv_btnm)*/
@@ -548,6 +980,12 @@
 #ifndef LV_LABEL_LONG_TXT_HINT
 #  define LV_LABEL_LONG_TXT_HINT          0
 #endif
+
+/*Draw the text of a rolling label (one line, no re-coloring) once into an opacity map of at most
+ *this many bytes and only copy it to the new offset in every step of the animation. 0: disable*/
+#ifndef LV_LABEL_ROLL_STRIP_MAX
+#  define LV_LABEL_ROLL_STRIP_MAX         (8U * 1024U)
+#endif
 #endif
 
 /*LED (dependencies: -)*/
@@ -569,6 +1007,9 @@
 #ifndef LV_LIST_DEF_ANIM_TIME
 #  define LV_LIST_DEF_ANIM_TIME  100
 #endif
+#ifndef LV_LIST_VIRTUAL
+#  define LV_LIST_VIRTUAL        0
+#endif
 #endif
 
 /*Line meter (dependencies: *;)*/
@@ -606,6 +1047,16 @@
 #ifndef LV_PRELOAD_DEF_ANIM
 #  define LV_PRELOAD_DEF_ANIM         LV_PRELOAD_TYPE_SPINNING_ARC
 #endif
+
+/*Rotation steps of a spinner copied from pre-drawn frames (`lv_preload_set_sprite`). 0: disable the sprites*/
+#ifndef LV_PRELOAD_SPRITE_FRAMES
+#  define LV_PRELOAD_SPRITE_FRAMES    36
+#endif
+
+/*[bytes] of the frames of all sprite spinners. A spinner whose frames don't fit is drawn as usual.*/
+#ifndef LV_PRELOAD_SPRITE_BUDGET
+#  define LV_PRELOAD_SPRITE_BUDGET    (128U * 1024U)
+#endif
 #endif
 
 /*Roller (dependencies: lv_ddlist)*/
@@ -0,0 +1,141 @@
+/**
+ * @file lv_context.c
+ * Independent LittlevGL instances in one process (see `LV_USE_CONTEXT`).
+ * The modules keep their global variables in the active context of the calling thread (`lv_context_act`):
+ * the lists of the displays, input devices, tasks, animations and groups (`LV_GC_CONTEXT_ROOTS`)
+ * and a `state` per module. So every thread can create and refresh its own displays and objects
+ * while the others do the same. The memory allocator and the caches of the drawing are shared:
+ * they are thread safe already because the drawing threads use them in parallel.
+ * The drawing threads work on the context of the refresh which started them.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_context.h"
+#if LV_USE_CONTEXT
+
+#include <string.h>
+#include "../lv_misc/lv_gc.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_draw/lv_draw.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_context_t context_def;
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+LV_THREAD_LOCAL lv_context_t * lv_context_act = &context_def;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Create a new LittlevGL instance. It has no displays, input devices, objects or tasks yet.
+ * The memory, the image decoders, the file system drivers, the image, glyph and shadow caches,
+ * the themes and the logging are shared with the other contexts.
+ * `lv_init` has to be called before.
+ * @return the new context or NULL if there is no memory
+ */
+lv_context_t * lv_context_create(void)
+{
+    lv_context_t * ctx = lv_mem_alloc(sizeof(lv_context_t));
+    lv_mem_assert(ctx);
+    if(ctx == NULL) return NULL;
+
+    memset(ctx, 0, sizeof(lv_context_t));
+
+    lv_context_t * ctx_ori = lv_context_act;
+    lv_context_act         = ctx;
+    lv_context_init();
+    lv_context_act = ctx_ori;
+
+    return ctx;
+}
+
+/**
+ * Delete a context with its displays (and their screens), groups, input devices, animations and tasks.
+ * It mustn't be active on an other thread. The default context can't be deleted.
+ * Delete it on the thread which used it: the scratch arena of the thread's drawing is freed too.
+ * @param ctx pointer to a context
+ */
+void lv_context_del(lv_context_t * ctx)
+{
+    if(ctx == NULL || ctx == &context_def) return;
+
+    lv_context_t * ctx_ori = lv_context_act;
+    lv_context_act         = ctx;
+    lv_context_deinit();
+    lv_context_act = ctx_ori == ctx ? &context_def : ctx_ori;
+
+    lv_mem_free(ctx);
+
+    /*A thread which draws an other context later allocates it again*/
+    lv_draw_scratch_free();
+}
+
+/**
+ * Set the context the calling thread works on: every `lv_...` function called by the thread
+ * uses its displays, objects, tasks etc. A context mustn't be used by two threads at once.
+ * @param ctx pointer to a context, NULL: the default context (created by `lv_init`)
+ */
+void lv_context_set_act(lv_context_t * ctx)
+{
+    lv_context_act = ctx != NULL ? ctx : &context_def;
+}
+
+/**
+ * Get the context the calling thread works on
+ * @return pointer to the active context
+ */
+lv_context_t * lv_context_get_act(void)
+{
+    return lv_context_act;
+}
+
+/**
+ * Get the default context, the active one of every thread until `lv_context_set_act`
+ * @return pointer to the default context
+ */
+lv_context_t * lv_context_get_def(void)
+{
+    return &context_def;
+}
+
+/**
+ * Allocate the zeroed state of a module in the active context. Called by the init functions of the modules.
+ * @param state_p pointer to the module's `state` in the context
+ * @param size size of the state in bytes
+ */
+void lv_context_state_init(void ** state_p, uint32_t size)
+{
+    *state_p = lv_mem_alloc(size);
+    lv_mem_assert(*state_p);
+    if(*state_p != NULL) memset(*state_p, 0, size);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#endif /*LV_USE_CONTEXT*/
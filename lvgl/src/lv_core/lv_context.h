@@ -0,0 +1,106 @@
+/**
+ * @file lv_context.h
+ *
+ */
+
+#ifndef LV_CONTEXT_H
+#define LV_CONTEXT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** A LittlevGL instance (see `LV_USE_CONTEXT`). Its content is in `lv_gc.h`.*/
+typedef struct _lv_context_t lv_context_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Initialize the modules in the active context. Called by `lv_init` and `lv_context_create`.
+ */
+void lv_context_init(void);
+
+#if LV_USE_CONTEXT
+
+/**
+ * Delete the displays, groups, input devices, animations and tasks of the active context
+ * and free the state of the modules. Called by `lv_context_del`.
+ */
+void lv_context_deinit(void);
+
+/**
+ * Allocate the zeroed state of a module in the active context. Called by the init functions of the modules.
+ * @param state_p pointer to the module's `state` in the context
+ * @param size size of the state in bytes
+ */
+void lv_context_state_init(void ** state_p, uint32_t size);
+
+/**
+ * Create a new LittlevGL instance. It has no displays, input devices, objects or tasks yet.
+ * The memory, the image decoders, the file system drivers, the image, glyph and shadow caches,
+ * the themes and the logging are shared with the other contexts.
+ * `lv_init` has to be called before.
+ * @return the new context or NULL if there is no memory
+ */
+lv_context_t * lv_context_create(void);
+
+/**
+ * Delete a context with its displays (and their screens), groups, input devices, animations and tasks.
+ * It mustn't be active on an other thread. The default context can't be deleted.
+ * Delete it on the thread which used it: the scratch arena of the thread's drawing is freed too.
+ * @param ctx pointer to a context
+ */
+void lv_context_del(lv_context_t * ctx);
+
+/**
+ * Set the context the calling thread works on: every `lv_...` function called by the thread
+ * uses its displays, objects, tasks etc. A context mustn't be used by two threads at once.
+ * @param ctx pointer to a context, NULL: the default context (created by `lv_init`)
+ */
+void lv_context_set_act(lv_context_t * ctx);
+
+/**
+ * Get the context the calling thread works on
+ * @return pointer to the active context
+ */
+lv_context_t * lv_context_get_act(void);
+
+/**
+ * Get the default context, the active one of every thread until `lv_context_set_act`
+ * @return pointer to the default context
+ */
+lv_context_t * lv_context_get_def(void);
+
+#endif /*LV_USE_CONTEXT*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_CONTEXT_H*/
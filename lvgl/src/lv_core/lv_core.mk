@@ -3,7 +3,12 @@ CSRCS += lv_indev.c
 CSRCS += lv_disp.c
 CSRCS += lv_obj.c
 CSRCS += lv_refr.c
+CSRCS += lv_context.c
+CSRCS += lv_hit.c
+CSRCS += lv_layer.c
+CSRCS += lv_slide.c
 CSRCS += lv_style.c
+CSRCS += lv_prof.c
 
 DEPPATH += --dep-path $(LVGL_DIR)/lvgl/src/lv_core
 VPATH += :$(LVGL_DIR)/lvgl/src/lv_core
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_disp.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_anim.h"
 
 /*********************
  *      DEFINES
@@ -132,6 +133,42 @@ lv_task_t * lv_disp_get_refr_task(lv_disp_t * disp)
     return disp->refr_task;
 }
 
+/**
+ * Set the refresh period of a display, e.g. to the display's vsync period or to limit the frame rate.
+ * The animations are stepped with the same period if it's the default display.
+ * @param disp pointer to a display (NULL to use the default display)
+ * @param period the refresh period [ms]
+ */
+void lv_disp_set_refr_period(lv_disp_t * disp, uint32_t period)
+{
+    if(!disp) disp = lv_disp_get_default();
+    if(!disp) {
+        LV_LOG_WARN("lv_disp_set_refr_period: no display registered");
+        return;
+    }
+
+    lv_task_set_period(disp->refr_task, period);
+
+#if LV_USE_ANIMATION
+    /*Stepping the animations more often than the refresh would be wasted*/
+    if(disp == lv_disp_get_default()) lv_anim_set_period(period);
+#endif
+}
+
+/**
+ * Get the number of refreshes which were due but couldn't be done in time since the display was registered.
+ * (While there is nothing to redraw no refresh is due, so it doesn't count.)
+ * @param disp pointer to a display (NULL to use the default display)
+ * @return the number of missed frames
+ */
+uint32_t lv_disp_get_missed_frames(lv_disp_t * disp)
+{
+    if(!disp) disp = lv_disp_get_default();
+    if(!disp) return 0;
+
+    return disp->missed_frames;
+}
+
 /**
  * Get elapsed time since last user activity on a display (e.g. click)
  * @param disp pointer to an display (NULL to get the overall smallest inactivity)
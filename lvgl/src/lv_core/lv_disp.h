@@ -72,6 +72,22 @@ void lv_disp_assign_screen(lv_disp_t * disp, lv_obj_t * scr);
  */
 lv_task_t * lv_disp_get_refr_task(lv_disp_t * disp);
 
+/**
+ * Set the refresh period of a display, e.g. to the display's vsync period or to limit the frame rate.
+ * The animations are stepped with the same period if it's the default display.
+ * @param disp pointer to a display (NULL to use the default display)
+ * @param period the refresh period [ms]
+ */
+void lv_disp_set_refr_period(lv_disp_t * disp, uint32_t period);
+
+/**
+ * Get the number of refreshes which were due but couldn't be done in time since the display was registered.
+ * (While there is nothing to redraw no refresh is due, so it doesn't count.)
+ * @param disp pointer to a display (NULL to use the default display)
+ * @return the number of missed frames
+ */
+uint32_t lv_disp_get_missed_frames(lv_disp_t * disp);
+
 /**
  * Get elapsed time since last user activity on a display (e.g. click)
  * @param disp pointer to an display (NULL to get the overall smallest inactivity)
@@ -9,7 +9,11 @@
 #include "lv_group.h"
 #if LV_USE_GROUP != 0
 #include "../lv_themes/lv_theme.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_misc/lv_math.h"
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../lv_misc/lv_gc.h"
 
 #if defined(LV_GC_INCLUDE)
@@ -19,10 +23,41 @@
 /*********************
  *      DEFINES
  *********************/
+/*How much the offset across the direction counts in the distance of two objects for `lv_group_focus_dir`*/
+#define NAV_CROSS_WEIGHT 2
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    lv_obj_t ** node; /*The node of the object in `obj_ll`*/
+    lv_coord_t x;     /*Center of the object*/
+    lv_coord_t y;
+} nav_item_t;
+
+#if LV_USE_GROUP_NAV_INDEX
+typedef struct _lv_group_nav_t
+{
+    nav_item_t * by_x;   /*The objects sorted by `x`*/
+    nav_item_t * by_y;   /*The same objects sorted by `y` (in the same allocation)*/
+    uint32_t layout_gen; /*`lv_obj_get_layout_gen()` when it was built*/
+    uint32_t cnt;
+    uint8_t valid : 1;   /*0: objects were added or removed since it was built*/
+} lv_group_nav_t;
+#endif
+
+#if LV_GROUP_STYLE_CACHE
+typedef struct
+{
+    const lv_group_t * group;
+    lv_group_style_mod_cb_t cb;
+    uint32_t gen;       /*`style_cache_gen` when it was modified*/
+    lv_style_t base;    /*The style given to `lv_group_mod_style`*/
+    lv_style_t mod;     /*`base` modified by `cb`*/
+    uint8_t valid : 1;
+} style_cache_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -32,12 +67,31 @@ static void style_mod_edit_def(lv_group_t * group, lv_style_t * style);
 static void refresh_theme(lv_group_t * g, lv_theme_t * th);
 static void focus_next_core(lv_group_t * group, void * (*begin)(const lv_ll_t *),
                             void * (*move)(const lv_ll_t *, const void *));
+static void focus_set(lv_group_t * group, lv_obj_t ** obj_next);
 static void lv_group_refocus(lv_group_t * g);
 static void obj_to_foreground(lv_obj_t * obj);
+static void nav_center(const lv_obj_t * obj, lv_point_t * p);
+static int32_t nav_dist(const lv_point_t * from, lv_coord_t x, lv_coord_t y, lv_group_dir_t dir);
+static lv_obj_t ** nav_search_all(const lv_group_t * group, const lv_point_t * from, lv_group_dir_t dir);
+#if LV_USE_GROUP_NAV_INDEX
+static lv_obj_t ** nav_search_index(lv_group_t * group, const lv_point_t * from, lv_group_dir_t dir);
+static lv_group_nav_t * nav_get(lv_group_t * group);
+static int nav_cmp_x(const void * a, const void * b);
+static int nav_cmp_y(const void * a, const void * b);
+#endif
+static void nav_invalidate(lv_group_t * group);
+static void style_cache_invalidate(void);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_GROUP_STYLE_CACHE
+/*Every drawing thread has its own cache. They are dropped by bumping the shared generation.*/
+static LV_THREAD_LOCAL style_cache_t style_cache[LV_GROUP_STYLE_CACHE];
+static LV_THREAD_LOCAL uint8_t style_cache_next;
+static LV_THREAD_LOCAL uint8_t style_cache_last; /*The last hit, an object is drawn with the same style many times*/
+static uint32_t style_cache_gen;
+#endif
 
 /**********************
  *      MACROS
@@ -64,7 +118,7 @@ lv_group_t * lv_group_create(void)
     lv_group_t * group = lv_ll_ins_head(&LV_GC_ROOT(_lv_group_ll));
     lv_mem_assert(group);
     if(group == NULL) return NULL;
-    lv_ll_init(&group->obj_ll, sizeof(lv_obj_t *));
+    lv_ll_init_pool(&group->obj_ll, sizeof(lv_obj_t *));
 
     group->obj_focus      = NULL;
     group->frozen         = 0;
@@ -73,6 +127,10 @@ lv_group_t * lv_group_create(void)
     group->editing        = 0;
     group->refocus_policy = LV_GROUP_REFOCUS_POLICY_PREV;
     group->wrap           = 1;
+    group->dir_keys       = 0;
+#if LV_USE_GROUP_NAV_INDEX
+    group->nav = NULL;
+#endif
 
 #if LV_USE_USER_DATA
     memset(&group->user_data, 0, sizeof(lv_group_user_data_t));
@@ -104,8 +162,15 @@ void lv_group_del(lv_group_t * group)
     }
 
     lv_ll_clear(&(group->obj_ll));
+#if LV_USE_GROUP_NAV_INDEX
+    if(group->nav) {
+        lv_mem_free(group->nav->by_x);
+        lv_mem_free(group->nav);
+    }
+#endif
     lv_ll_rem(&LV_GC_ROOT(_lv_group_ll), group);
     lv_mem_free(group);
+    style_cache_invalidate(); /*A new group might get the same address*/
 }
 
 /**
@@ -141,6 +206,7 @@ void lv_group_add_obj(lv_group_t * group, lv_obj_t * obj)
     lv_mem_assert(next);
     if(next == NULL) return;
     *next = obj;
+    nav_invalidate(group);
 
     /* If the head and the tail is equal then there is only one object in the linked list.
      * In this case automatically activate it*/
@@ -184,8 +250,9 @@ void lv_group_remove_obj(lv_obj_t * obj)
     {
         if(*i == obj) {
             lv_ll_rem(&g->obj_ll, i);
-            lv_mem_free(i);
+            lv_ll_free(&g->obj_ll, i);
             obj->group_p = NULL;
+            nav_invalidate(g);
             break;
         }
     }
@@ -212,6 +279,7 @@ void lv_group_remove_all_objs(lv_group_t * group)
     }
 
     lv_ll_clear(&(group->obj_ll));
+    nav_invalidate(group);
 }
 
 /**
@@ -275,6 +343,37 @@ void lv_group_focus_prev(lv_group_t * group)
     focus_next_core(group, lv_ll_get_tail, lv_ll_get_prev);
 }
 
+/**
+ * Focus the nearest object of a group in a direction on the screen (defocus the current).
+ * The focus doesn't change if there is no visible object in that direction.
+ * @param group pointer to a group
+ * @param dir LV_GROUP_DIR_UP/DOWN/LEFT/RIGHT
+ * @return true: the focus has moved; false: there is no object in that direction
+ */
+bool lv_group_focus_dir(lv_group_t * group, lv_group_dir_t dir)
+{
+    if(group->frozen) return false;
+
+    /*Without a focused object there is no "direction", start with the first one*/
+    if(group->obj_focus == NULL) {
+        lv_group_focus_next(group);
+        return group->obj_focus != NULL;
+    }
+
+    lv_point_t from;
+    nav_center(*group->obj_focus, &from);
+
+#if LV_USE_GROUP_NAV_INDEX
+    lv_obj_t ** obj_next = nav_search_index(group, &from, dir);
+#else
+    lv_obj_t ** obj_next = nav_search_all(group, &from, dir);
+#endif
+    if(obj_next == NULL) return false;
+
+    focus_set(group, obj_next);
+    return true;
+}
+
 /**
  * Do not let to change the focus from the current object
  * @param group pointer to a group
@@ -318,6 +417,7 @@ lv_res_t lv_group_send_data(lv_group_t * group, uint32_t c)
 void lv_group_set_style_mod_cb(lv_group_t * group, lv_group_style_mod_cb_t style_mod_cb)
 {
     group->style_mod_cb = style_mod_cb;
+    style_cache_invalidate();
     if(group->obj_focus != NULL) lv_obj_invalidate(*group->obj_focus);
 }
 
@@ -329,6 +429,7 @@ void lv_group_set_style_mod_cb(lv_group_t * group, lv_group_style_mod_cb_t style
 void lv_group_set_style_mod_edit_cb(lv_group_t * group, lv_group_style_mod_cb_t style_mod_edit_cb)
 {
     group->style_mod_edit_cb = style_mod_edit_cb;
+    style_cache_invalidate();
     if(group->obj_focus != NULL) lv_obj_invalidate(*group->obj_focus);
 }
 
@@ -390,23 +491,80 @@ void lv_group_set_wrap(lv_group_t * group, bool en)
     group->wrap = en ? 1 : 0;
 }
 
+/**
+ * Set whether the arrow keys of a keypad move the focus to the object in that direction
+ * instead of being sent to the focused object.
+ * @param group pointer to group
+ * @param en true: move the focus with the arrow keys
+ */
+void lv_group_set_dir_keys(lv_group_t * group, bool en)
+{
+    group->dir_keys = en ? 1 : 0;
+}
+
 /**
  * Modify a style with the set 'style_mod' function. The input style remains unchanged.
+ * With `LV_GROUP_STYLE_CACHE` the result is reused while the input's content, the group,
+ * its mode and callback are the same.
  * @param group pointer to group
  * @param style pointer to a style to modify
- * @return a copy of the input style but modified with the 'style_mod' function
+ * @return a copy of the input style but modified with the 'style_mod' function.
+ *         Don't modify it, copy it first.
  */
 lv_style_t * lv_group_mod_style(lv_group_t * group, const lv_style_t * style)
 {
+#if LV_GROUP_STYLE_CACHE
+    lv_group_style_mod_cb_t cb = group->editing ? group->style_mod_edit_cb : group->style_mod_cb;
+
+    uint8_t i;
+    uint8_t id = style_cache_last;
+    for(i = 0; i < LV_GROUP_STYLE_CACHE; i++) {
+        style_cache_t * c = &style_cache[id];
+        if(c->valid && c->group == group && c->cb == cb && c->gen == style_cache_gen &&
+           memcmp(&c->base, style, sizeof(lv_style_t)) == 0) {
+            style_cache_last = id;
+            return &c->mod;
+        }
+        id++;
+        if(id >= LV_GROUP_STYLE_CACHE) id = 0;
+    }
+
+    /*`style` might be an entry's `mod`, replaced right below*/
+    lv_style_t base;
+    lv_style_copy(&base, style);
+
+    style_cache_last  = style_cache_next;
+    style_cache_t * c = &style_cache[style_cache_next];
+    style_cache_next++;
+    if(style_cache_next >= LV_GROUP_STYLE_CACHE) style_cache_next = 0;
+
+    lv_style_copy(&c->base, &base);
+    lv_style_copy(&c->mod, &base);
+    if(cb) cb(group, &c->mod);
+    c->group = group;
+    c->cb    = cb;
+    c->gen   = style_cache_gen;
+    c->valid = 1;
+    return &c->mod;
+#else
+#if LV_REFR_THREADS > 1
+    /*The drawing threads can't share `group->style_tmp`*/
+    static LV_THREAD_LOCAL lv_style_t style_tmp;
+    lv_style_t * style_mod = &style_tmp;
+#else
+    lv_style_t * style_mod = &group->style_tmp;
+#endif
+
     /*Load the current style. It will be modified by the callback*/
-    lv_style_copy(&group->style_tmp, style);
+    lv_style_copy(style_mod, style);
 
     if(group->editing) {
-        if(group->style_mod_edit_cb) group->style_mod_edit_cb(group, &group->style_tmp);
+        if(group->style_mod_edit_cb) group->style_mod_edit_cb(group, style_mod);
     } else {
-        if(group->style_mod_cb) group->style_mod_cb(group, &group->style_tmp);
+        if(group->style_mod_cb) group->style_mod_cb(group, style_mod);
     }
-    return &group->style_tmp;
+    return style_mod;
+#endif
 }
 
 /**
@@ -500,6 +658,17 @@ bool lv_group_get_wrap(lv_group_t * group)
     return group->wrap ? true : false;
 }
 
+/**
+ * Get whether the arrow keys of a keypad move the focus.
+ * @param group pointer to group
+ * @return true: the arrow keys move the focus
+ */
+bool lv_group_get_dir_keys(const lv_group_t * group)
+{
+    if(!group) return false;
+    return group->dir_keys ? true : false;
+}
+
 /**
  * Notify the group that current theme changed and style modification callbacks need to be
  * refreshed.
@@ -509,6 +678,9 @@ void lv_group_report_style_mod(lv_group_t * group)
 {
     lv_theme_t * th = lv_theme_get_current();
 
+    /*The callbacks can be the same but style differently now (e.g. new theme colors)*/
+    style_cache_invalidate();
+
     if(group != NULL) {
         refresh_theme(group, th);
         return;
@@ -667,6 +839,12 @@ static void focus_next_core(lv_group_t * group, void * (*begin)(const lv_ll_t *)
 
     if(obj_next == group->obj_focus) return; /*There's only one visible object and it's already focused*/
 
+    focus_set(group, obj_next);
+}
+
+/*Move the focus to an other object. Only the old and the new object are redrawn.*/
+static void focus_set(lv_group_t * group, lv_obj_t ** obj_next)
+{
     if(group->obj_focus) {
         (*group->obj_focus)->signal_cb(*group->obj_focus, LV_SIGNAL_DEFOCUS, NULL);
         lv_res_t res = lv_event_send(*group->obj_focus, LV_EVENT_DEFOCUSED, NULL);
@@ -704,4 +882,203 @@ static void obj_to_foreground(lv_obj_t * obj)
     }
 }
 
+static void nav_center(const lv_obj_t * obj, lv_point_t * p)
+{
+    p->x = obj->coords.x1 + lv_area_get_width(&obj->coords) / 2;
+    p->y = obj->coords.y1 + lv_area_get_height(&obj->coords) / 2;
+}
+
+/**
+ * Distance of an object from the focused one for `lv_group_focus_dir`
+ * @param from center of the focused object
+ * @param x x coordinate of the object's center
+ * @param y y coordinate of the object's center
+ * @param dir the direction to go
+ * @return the distance along `dir` plus the weighted offset across it, or -1 if the object is not in `dir`
+ */
+static int32_t nav_dist(const lv_point_t * from, lv_coord_t x, lv_coord_t y, lv_group_dir_t dir)
+{
+    int32_t along;
+    int32_t across;
+    switch(dir) {
+        case LV_GROUP_DIR_UP:
+            along  = from->y - y;
+            across = x - from->x;
+            break;
+        case LV_GROUP_DIR_DOWN:
+            along  = y - from->y;
+            across = x - from->x;
+            break;
+        case LV_GROUP_DIR_LEFT:
+            along  = from->x - x;
+            across = y - from->y;
+            break;
+        default:
+            along  = x - from->x;
+            across = y - from->y;
+            break;
+    }
+
+    if(along <= 0) return -1;
+    if(across < 0) across = -across;
+    return along + across * NAV_CROSS_WEIGHT;
+}
+
+/*Test every object of the group*/
+static lv_obj_t ** nav_search_all(const lv_group_t * group, const lv_point_t * from, lv_group_dir_t dir)
+{
+    lv_obj_t ** best = NULL;
+    int32_t best_dist = 0;
+    lv_obj_t ** i;
+    LV_LL_READ(group->obj_ll, i)
+    {
+        if(i == group->obj_focus || lv_obj_get_hidden(*i)) continue;
+
+        lv_point_t c;
+        nav_center(*i, &c);
+        int32_t d = nav_dist(from, c.x, c.y, dir);
+        if(d >= 0 && (best == NULL || d < best_dist)) {
+            best      = i;
+            best_dist = d;
+        }
+    }
+
+    return best;
+}
+
+#if LV_USE_GROUP_NAV_INDEX
+
+/**
+ * Walk the objects sorted along the direction outwards from the focused one.
+ * As the distance is at least the offset along the direction the walk stops
+ * when this offset alone is more then the best distance so far.
+ */
+static lv_obj_t ** nav_search_index(lv_group_t * group, const lv_point_t * from, lv_group_dir_t dir)
+{
+    lv_group_nav_t * nav = nav_get(group);
+    if(nav == NULL) return nav_search_all(group, from, dir); /*Out of memory*/
+
+    bool hor                = dir == LV_GROUP_DIR_LEFT || dir == LV_GROUP_DIR_RIGHT;
+    bool forward            = dir == LV_GROUP_DIR_RIGHT || dir == LV_GROUP_DIR_DOWN;
+    const nav_item_t * item = hor ? nav->by_x : nav->by_y;
+    lv_coord_t key          = hor ? from->x : from->y;
+
+    /*Find the first object after `key` (forward) or the first object at `key` (backward)*/
+    uint32_t lo = 0;
+    uint32_t hi = nav->cnt;
+    while(lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        lv_coord_t v = hor ? item[mid].x : item[mid].y;
+        if(v < key || (forward && v == key))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    lv_obj_t ** best = NULL;
+    int32_t best_dist = 0;
+    int32_t step      = forward ? 1 : -1;
+    int32_t i         = forward ? (int32_t)lo : (int32_t)lo - 1;
+    for(; i >= 0 && i < (int32_t)nav->cnt; i += step) {
+        const nav_item_t * it = &item[i];
+        int32_t along         = hor ? it->x - key : it->y - key;
+        if(along < 0) along = -along;
+        if(best != NULL && along >= best_dist) break;
+
+        if(it->node == group->obj_focus || lv_obj_get_hidden(*it->node)) continue;
+
+        int32_t d = nav_dist(from, it->x, it->y, dir);
+        if(d >= 0 && (best == NULL || d < best_dist)) {
+            best      = it->node;
+            best_dist = d;
+        }
+    }
+
+    return best;
+}
+
+/*Get the index of a group, build it if objects were added, removed or moved since the last time*/
+static lv_group_nav_t * nav_get(lv_group_t * group)
+{
+    lv_group_nav_t * nav = group->nav;
+    if(nav == NULL) {
+        nav = lv_mem_alloc(sizeof(lv_group_nav_t));
+        lv_mem_assert(nav);
+        if(nav == NULL) return NULL;
+        memset(nav, 0, sizeof(lv_group_nav_t));
+        group->nav = nav;
+    }
+
+    uint32_t gen = lv_obj_get_layout_gen();
+    if(nav->valid && nav->layout_gen == gen) return nav;
+
+    uint32_t cnt = lv_ll_get_len(&group->obj_ll);
+    if(cnt != nav->cnt || nav->by_x == NULL) {
+        lv_mem_free(nav->by_x);
+        nav->by_x = lv_mem_alloc(LV_MATH_MAX(cnt, 1) * 2 * sizeof(nav_item_t));
+        lv_mem_assert(nav->by_x);
+        if(nav->by_x == NULL) {
+            nav->cnt   = 0;
+            nav->valid = 0;
+            return NULL;
+        }
+        nav->by_y = nav->by_x + cnt;
+        nav->cnt  = cnt;
+    }
+
+    uint32_t n = 0;
+    lv_obj_t ** i;
+    LV_LL_READ(group->obj_ll, i)
+    {
+        lv_point_t c;
+        nav_center(*i, &c);
+        nav->by_x[n].node = i;
+        nav->by_x[n].x    = c.x;
+        nav->by_x[n].y    = c.y;
+        n++;
+    }
+
+    memcpy(nav->by_y, nav->by_x, cnt * sizeof(nav_item_t));
+    qsort(nav->by_x, cnt, sizeof(nav_item_t), nav_cmp_x);
+    qsort(nav->by_y, cnt, sizeof(nav_item_t), nav_cmp_y);
+
+    nav->layout_gen = gen;
+    nav->valid      = 1;
+    return nav;
+}
+
+static int nav_cmp_x(const void * a, const void * b)
+{
+    lv_coord_t va = ((const nav_item_t *)a)->x;
+    lv_coord_t vb = ((const nav_item_t *)b)->x;
+    return (va > vb) - (va < vb);
+}
+
+static int nav_cmp_y(const void * a, const void * b)
+{
+    lv_coord_t va = ((const nav_item_t *)a)->y;
+    lv_coord_t vb = ((const nav_item_t *)b)->y;
+    return (va > vb) - (va < vb);
+}
+
+#endif /*LV_USE_GROUP_NAV_INDEX*/
+
+/*Rebuild the index at the next `lv_group_focus_dir` because objects were added or removed*/
+static void nav_invalidate(lv_group_t * group)
+{
+#if LV_USE_GROUP_NAV_INDEX
+    if(group->nav) group->nav->valid = 0;
+#else
+    (void)group; /*Unused*/
+#endif
+}
+
+/*Drop the cached modified styles of every drawing thread*/
+static void style_cache_invalidate(void)
+{
+#if LV_GROUP_STYLE_CACHE
+    style_cache_gen++;
+#endif
+}
+
 #endif /*LV_USE_GROUP != 0*/
@@ -48,6 +48,7 @@ typedef uint8_t lv_key_t;
  *      TYPEDEFS
  **********************/
 struct _lv_group_t;
+struct _lv_group_nav_t;
 
 typedef void (*lv_group_style_mod_cb_t)(struct _lv_group_t *, lv_style_t *);
 typedef void (*lv_group_focus_cb_t)(struct _lv_group_t *);
@@ -68,6 +69,9 @@ typedef struct _lv_group_t
 #if LV_USE_USER_DATA
     lv_group_user_data_t user_data;
 #endif
+#if LV_USE_GROUP_NAV_INDEX
+    struct _lv_group_nav_t * nav; /**< The objects sorted by position for `lv_group_focus_dir` (built on demand)*/
+#endif
 
     uint8_t frozen : 1;         /**< 1: can't focus to new object*/
     uint8_t editing : 1;        /**< 1: Edit mode, 0: Navigate mode*/
@@ -77,11 +81,15 @@ typedef struct _lv_group_t
                                    deletion.*/
     uint8_t wrap : 1;           /**< 1: Focus next/prev can wrap at end of list. 0: Focus next/prev stops at end
                                    of list.*/
+    uint8_t dir_keys : 1;       /**< 1: The arrow keys of a keypad move the focus with `lv_group_focus_dir`*/
 } lv_group_t;
 
 enum { LV_GROUP_REFOCUS_POLICY_NEXT = 0, LV_GROUP_REFOCUS_POLICY_PREV = 1 };
 typedef uint8_t lv_group_refocus_policy_t;
 
+enum { LV_GROUP_DIR_UP, LV_GROUP_DIR_DOWN, LV_GROUP_DIR_LEFT, LV_GROUP_DIR_RIGHT };
+typedef uint8_t lv_group_dir_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -141,6 +149,15 @@ void lv_group_focus_next(lv_group_t * group);
  */
 void lv_group_focus_prev(lv_group_t * group);
 
+/**
+ * Focus the nearest object of a group in a direction on the screen (defocus the current).
+ * The focus doesn't change if there is no visible object in that direction.
+ * @param group pointer to a group
+ * @param dir LV_GROUP_DIR_UP/DOWN/LEFT/RIGHT
+ * @return true: the focus has moved; false: there is no object in that direction
+ */
+bool lv_group_focus_dir(lv_group_t * group, lv_group_dir_t dir);
+
 /**
  * Do not let to change the focus from the current object
  * @param group pointer to a group
@@ -206,6 +223,14 @@ void lv_group_set_click_focus(lv_group_t * group, bool en);
  */
 void lv_group_set_wrap(lv_group_t * group, bool en);
 
+/**
+ * Set whether the arrow keys of a keypad move the focus to the object in that direction
+ * instead of being sent to the focused object.
+ * @param group pointer to group
+ * @param en true: move the focus with the arrow keys
+ */
+void lv_group_set_dir_keys(lv_group_t * group, bool en);
+
 /**
  * Modify a style with the set 'style_mod' function. The input style remains unchanged.
  * @param group pointer to group
@@ -273,6 +298,13 @@ bool lv_group_get_click_focus(const lv_group_t * group);
  */
 bool lv_group_get_wrap(lv_group_t * group);
 
+/**
+ * Get whether the arrow keys of a keypad move the focus.
+ * @param group pointer to group
+ * @return true: the arrow keys move the focus
+ */
+bool lv_group_get_dir_keys(const lv_group_t * group);
+
 /**
  * Notify the group that current theme changed and style modification callbacks need to be
  * refreshed.
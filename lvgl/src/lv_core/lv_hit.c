@@ -0,0 +1,387 @@
+/**
+ * @file lv_hit.c
+ * Spatial index for finding the clicked object.
+ * The input devices test the children of every object under the pointer one by one.
+ * For objects with a lot of children a uniform grid is built on the children's click areas,
+ * so only the children in the cell of the point have to be tested.
+ * The grid is relative to the parent, so moving the parent doesn't make it outdated.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_hit.h"
+#include <string.h>
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+#if LV_USE_HIT_INDEX
+typedef struct
+{
+    const lv_obj_t * par;   /*NULL: unused slot*/
+    lv_obj_t ** children;   /*In the order of the child list*/
+    uint32_t * cell_start;  /*Start of every cell in `items`, `cols * rows + 1` elements*/
+    uint16_t * items;       /*Indexes in `children` cell by cell, ascending in every cell*/
+    lv_area_t bounds;       /*Union of the children's click areas relative to the parent*/
+    lv_coord_t cell_w;
+    lv_coord_t cell_h;
+    uint16_t cols;
+    uint16_t rows;
+    uint16_t child_cnt;
+    uint32_t last_use;
+    uint8_t valid : 1;
+} lv_hit_index_t;
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    lv_hit_index_t hit_indexes[LV_HIT_INDEX_SLOTS];
+    uint8_t hit_used;
+    uint32_t hit_use_cnt;
+} lv_hit_state_t;
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_HIT_INDEX
+static lv_hit_index_t * index_find(const lv_obj_t * par);
+static lv_hit_index_t * index_get_free(void);
+static void index_free(lv_hit_index_t * idx);
+static void get_rel_area(const lv_obj_t * par, const lv_obj_t * child, lv_area_t * area);
+static uint16_t grid_size(uint32_t cnt);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_USE_HIT_INDEX
+#if LV_USE_CONTEXT
+#define hit_st ((lv_hit_state_t *)lv_context_act->hit_state)
+#else
+static lv_hit_state_t hit_state;
+#define hit_st (&hit_state)
+#endif
+#define hit_indexes (hit_st->hit_indexes)
+#define hit_used (hit_st->hit_used)
+#define hit_use_cnt (hit_st->hit_use_cnt)
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Get the area where an object can be clicked (its coordinates with the extended click area)
+ * @param obj pointer to an object
+ * @param area store the result area here
+ */
+void lv_hit_get_click_area(const lv_obj_t * obj, lv_area_t * area)
+{
+#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
+    area->x1 = obj->coords.x1 - obj->ext_click_pad_hor;
+    area->x2 = obj->coords.x2 + obj->ext_click_pad_hor;
+    area->y1 = obj->coords.y1 - obj->ext_click_pad_ver;
+    area->y2 = obj->coords.y2 + obj->ext_click_pad_ver;
+#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
+    area->x1 = obj->coords.x1 - obj->ext_click_pad.x1;
+    area->x2 = obj->coords.x2 + obj->ext_click_pad.x2;
+    area->y1 = obj->coords.y1 - obj->ext_click_pad.y1;
+    area->y2 = obj->coords.y2 + obj->ext_click_pad.y2;
+#else
+    lv_area_copy(area, &obj->coords);
+#endif
+}
+
+#if LV_USE_HIT_INDEX
+
+/**
+ * Init the hit indexes of the active context. Called by `lv_context_init`.
+ */
+void lv_hit_init(void)
+{
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->hit_state, sizeof(lv_hit_state_t));
+#endif
+}
+
+/**
+ * Build a spatial index on the children of an object.
+ * Typically called by the input device handler after it had to test a lot of children one by one.
+ * @param par pointer to an object
+ */
+void lv_hit_build(lv_obj_t * par)
+{
+    uint32_t cnt = 0;
+    lv_obj_t * child;
+    LV_LL_READ(par->child_ll, child) cnt++;
+
+    lv_hit_index_t * idx = index_find(par);
+    if(idx) index_free(idx);
+    if(cnt < LV_HIT_INDEX_MIN_CHILDREN || cnt > UINT16_MAX) return;
+
+    idx = index_get_free();
+    idx->children = lv_mem_alloc(cnt * sizeof(lv_obj_t *));
+    if(idx->children == NULL) return;
+
+    /*Collect the children and the union of their areas*/
+    uint32_t i = 0;
+    lv_area_t a;
+    LV_LL_READ(par->child_ll, child)
+    {
+        get_rel_area(par, child, &a);
+        if(i == 0) {
+            lv_area_copy(&idx->bounds, &a);
+        } else {
+            idx->bounds.x1 = LV_MATH_MIN(idx->bounds.x1, a.x1);
+            idx->bounds.y1 = LV_MATH_MIN(idx->bounds.y1, a.y1);
+            idx->bounds.x2 = LV_MATH_MAX(idx->bounds.x2, a.x2);
+            idx->bounds.y2 = LV_MATH_MAX(idx->bounds.y2, a.y2);
+        }
+        idx->children[i++] = child;
+    }
+
+    idx->cols   = grid_size(cnt);
+    idx->rows   = idx->cols;
+    idx->cell_w = (lv_area_get_width(&idx->bounds) + idx->cols - 1) / idx->cols;
+    idx->cell_h = (lv_area_get_height(&idx->bounds) + idx->rows - 1) / idx->rows;
+    if(idx->cell_w < 1) idx->cell_w = 1;
+    if(idx->cell_h < 1) idx->cell_h = 1;
+
+    uint32_t cell_cnt = (uint32_t)idx->cols * idx->rows;
+    idx->cell_start   = lv_mem_alloc((cell_cnt + 1) * sizeof(uint32_t));
+    uint32_t * fill   = lv_mem_alloc(cell_cnt * sizeof(uint32_t));
+    if(idx->cell_start == NULL || fill == NULL) {
+        if(fill) lv_mem_free(fill);
+        index_free(idx);
+        return;
+    }
+    memset(idx->cell_start, 0, (cell_cnt + 1) * sizeof(uint32_t));
+
+    /*Count the children in every cell, then put them into their cells*/
+    uint8_t pass;
+    for(pass = 0; pass < 2; pass++) {
+        for(i = 0; i < cnt; i++) {
+            get_rel_area(par, idx->children[i], &a);
+            lv_coord_t c1 = (a.x1 - idx->bounds.x1) / idx->cell_w;
+            lv_coord_t c2 = (a.x2 - idx->bounds.x1) / idx->cell_w;
+            lv_coord_t r1 = (a.y1 - idx->bounds.y1) / idx->cell_h;
+            lv_coord_t r2 = (a.y2 - idx->bounds.y1) / idx->cell_h;
+            lv_coord_t r, c;
+            for(r = r1; r <= r2; r++) {
+                for(c = c1; c <= c2; c++) {
+                    uint32_t cell = (uint32_t)r * idx->cols + c;
+                    if(pass == 0) idx->cell_start[cell + 1]++;
+                    else idx->items[fill[cell]++] = i;
+                }
+            }
+        }
+
+        if(pass == 0) {
+            uint32_t cell;
+            for(cell = 0; cell < cell_cnt; cell++) {
+                idx->cell_start[cell + 1] += idx->cell_start[cell];
+                fill[cell] = idx->cell_start[cell];
+            }
+            idx->items = lv_mem_alloc(LV_MATH_MAX(idx->cell_start[cell_cnt], 1) * sizeof(uint16_t));
+            if(idx->items == NULL) {
+                lv_mem_free(fill);
+                index_free(idx);
+                return;
+            }
+        }
+    }
+    lv_mem_free(fill);
+
+    idx->par       = par;
+    idx->child_cnt = cnt;
+    idx->last_use  = hit_use_cnt++;
+    idx->valid     = 1;
+    hit_used++;
+}
+
+/**
+ * Mark the index of an object's children as outdated. Should be called when a child is added,
+ * removed, moved, resized or reordered.
+ * @param par pointer to an object (the parent of the changed child)
+ */
+void lv_hit_invalidate(const lv_obj_t * par)
+{
+    if(hit_used == 0) return;
+
+    lv_hit_index_t * idx = index_find(par);
+    if(idx) idx->valid = 0;
+}
+
+/**
+ * Drop the index of an object. Should be called when the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_hit_remove(const lv_obj_t * obj)
+{
+    if(hit_used == 0) return;
+
+    lv_hit_index_t * idx = index_find(obj);
+    if(idx) index_free(idx);
+}
+
+/**
+ * Get the children of an object whose click area contains a point.
+ * @param par pointer to an object
+ * @param point the point to test
+ * @param buf store the children here in the order of the child list (the top most first)
+ * @param buf_size size of `buf`
+ * @return number of children stored in `buf` or LV_HIT_NO_INDEX if the caller should test
+ * all the children (there is no valid index or there were more than `buf_size` candidates)
+ */
+int16_t lv_hit_get_candidates(const lv_obj_t * par, const lv_point_t * point, lv_obj_t ** buf, uint16_t buf_size)
+{
+    if(hit_used == 0) return LV_HIT_NO_INDEX;
+
+    lv_hit_index_t * idx = index_find(par);
+    if(idx == NULL || idx->valid == 0) return LV_HIT_NO_INDEX;
+    idx->last_use = hit_use_cnt++;
+
+    lv_point_t p;
+    p.x = point->x - par->coords.x1;
+    p.y = point->y - par->coords.y1;
+    if(lv_area_is_point_on(&idx->bounds, &p) == false) return 0;
+
+    uint32_t cell = (uint32_t)((p.y - idx->bounds.y1) / idx->cell_h) * idx->cols + (p.x - idx->bounds.x1) / idx->cell_w;
+    int16_t cnt   = 0;
+    uint32_t i;
+    for(i = idx->cell_start[cell]; i < idx->cell_start[cell + 1]; i++) {
+        lv_obj_t * child = idx->children[idx->items[i]];
+        lv_area_t a;
+        lv_hit_get_click_area(child, &a);
+        if(lv_area_is_point_on(&a, point)) {
+            if(cnt == buf_size) return LV_HIT_NO_INDEX;
+            buf[cnt++] = child;
+        }
+    }
+
+    return cnt;
+}
+
+/**
+ * Get the children of an object whose click area is completely in an area (e.g. a rubber band selection).
+ * Only the cells of the grid overlapping the area are visited.
+ * @param par pointer to an object
+ * @param area the area in absolute coordinates
+ * @param cb called once on every child in the area, in no particular order
+ * @param user_data passed to `cb`
+ * @return false if the children are not indexed and the caller should test them one by one (`cb` wasn't called)
+ */
+bool lv_hit_get_in_area(const lv_obj_t * par, const lv_area_t * area, lv_hit_area_cb_t cb, void * user_data)
+{
+    if(hit_used == 0) return false;
+
+    lv_hit_index_t * idx = index_find(par);
+    if(idx == NULL || idx->valid == 0) return false;
+    idx->last_use = hit_use_cnt++;
+
+    /*The area relative to the parent, clipped to the children*/
+    lv_area_t a;
+    a.x1 = LV_MATH_MAX(area->x1 - par->coords.x1, idx->bounds.x1);
+    a.y1 = LV_MATH_MAX(area->y1 - par->coords.y1, idx->bounds.y1);
+    a.x2 = LV_MATH_MIN(area->x2 - par->coords.x1, idx->bounds.x2);
+    a.y2 = LV_MATH_MIN(area->y2 - par->coords.y1, idx->bounds.y2);
+    if(a.x1 > a.x2 || a.y1 > a.y2) return true;
+
+    lv_coord_t c1 = (a.x1 - idx->bounds.x1) / idx->cell_w;
+    lv_coord_t c2 = (a.x2 - idx->bounds.x1) / idx->cell_w;
+    lv_coord_t r1 = (a.y1 - idx->bounds.y1) / idx->cell_h;
+    lv_coord_t r2 = (a.y2 - idx->bounds.y1) / idx->cell_h;
+    lv_coord_t r, c;
+    for(r = r1; r <= r2; r++) {
+        for(c = c1; c <= c2; c++) {
+            uint32_t cell = (uint32_t)r * idx->cols + c;
+            uint32_t i;
+            for(i = idx->cell_start[cell]; i < idx->cell_start[cell + 1]; i++) {
+                lv_obj_t * child = idx->children[idx->items[i]];
+                lv_area_t ca;
+                get_rel_area(par, child, &ca);
+                if(ca.x1 < a.x1 || ca.y1 < a.y1 || ca.x2 > a.x2 || ca.y2 > a.y2) continue;
+
+                /*A child is in every cell it overlaps, report it only in its top left one*/
+                if((ca.x1 - idx->bounds.x1) / idx->cell_w != c || (ca.y1 - idx->bounds.y1) / idx->cell_h != r) continue;
+                cb(child, user_data);
+            }
+        }
+    }
+
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_hit_index_t * index_find(const lv_obj_t * par)
+{
+    if(par == NULL) return NULL;
+
+    uint8_t i;
+    for(i = 0; i < LV_HIT_INDEX_SLOTS; i++) {
+        if(hit_indexes[i].par == par) return &hit_indexes[i];
+    }
+    return NULL;
+}
+
+/**
+ * Get an unused slot or free the least recently used one
+ */
+static lv_hit_index_t * index_get_free(void)
+{
+    lv_hit_index_t * lru = &hit_indexes[0];
+    uint8_t i;
+    for(i = 0; i < LV_HIT_INDEX_SLOTS; i++) {
+        if(hit_indexes[i].par == NULL && hit_indexes[i].children == NULL) return &hit_indexes[i];
+        if(hit_indexes[i].last_use < lru->last_use) lru = &hit_indexes[i];
+    }
+    index_free(lru);
+    return lru;
+}
+
+static void index_free(lv_hit_index_t * idx)
+{
+    if(idx->par != NULL) hit_used--;
+    if(idx->children) lv_mem_free(idx->children);
+    if(idx->cell_start) lv_mem_free(idx->cell_start);
+    if(idx->items) lv_mem_free(idx->items);
+    memset(idx, 0, sizeof(lv_hit_index_t));
+}
+
+static void get_rel_area(const lv_obj_t * par, const lv_obj_t * child, lv_area_t * area)
+{
+    lv_hit_get_click_area(child, area);
+    area->x1 -= par->coords.x1;
+    area->x2 -= par->coords.x1;
+    area->y1 -= par->coords.y1;
+    area->y2 -= par->coords.y1;
+}
+
+/**
+ * Columns (and rows) of the grid: about LV_HIT_INDEX_CELL_ITEMS children per cell if they are evenly spread
+ */
+static uint16_t grid_size(uint32_t cnt)
+{
+    uint32_t cells = cnt / LV_HIT_INDEX_CELL_ITEMS;
+    uint16_t s     = 1;
+    while((uint32_t)(s + 1) * (s + 1) <= cells && s < LV_HIT_INDEX_GRID_MAX) s++;
+    return s;
+}
+
+#endif /*LV_USE_HIT_INDEX*/
@@ -0,0 +1,141 @@
+/**
+ * @file lv_hit.h
+ *
+ */
+
+#ifndef LV_HIT_H
+#define LV_HIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include "lv_obj.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+/*Returned by `lv_hit_get_candidates` if the children of the object are not indexed*/
+#define LV_HIT_NO_INDEX (-1)
+
+/*Overlapping children under a point handled by the index. With more the children are tested one by one*/
+#define LV_HIT_CANDIDATE_MAX 16
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Called by `lv_hit_get_in_area` on the children in the area
+ * @param child pointer to a child
+ * @param user_data from `lv_hit_get_in_area`
+ */
+typedef void (*lv_hit_area_cb_t)(lv_obj_t * child, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Get the area where an object can be clicked (its coordinates with the extended click area)
+ * @param obj pointer to an object
+ * @param area store the result area here
+ */
+void lv_hit_get_click_area(const lv_obj_t * obj, lv_area_t * area);
+
+#if LV_USE_HIT_INDEX
+
+/**
+ * Init the hit indexes of the active context. Called by `lv_context_init`.
+ */
+void lv_hit_init(void);
+
+/**
+ * Build a spatial index on the children of an object.
+ * Typically called by the input device handler after it had to test a lot of children one by one.
+ * @param par pointer to an object
+ */
+void lv_hit_build(lv_obj_t * par);
+
+/**
+ * Mark the index of an object's children as outdated. Should be called when a child is added,
+ * removed, moved, resized or reordered.
+ * @param par pointer to an object (the parent of the changed child)
+ */
+void lv_hit_invalidate(const lv_obj_t * par);
+
+/**
+ * Drop the index of an object. Should be called when the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_hit_remove(const lv_obj_t * obj);
+
+/**
+ * Get the children of an object whose click area contains a point.
+ * @param par pointer to an object
+ * @param point the point to test
+ * @param buf store the children here in the order of the child list (the top most first)
+ * @param buf_size size of `buf`
+ * @return number of children stored in `buf` or LV_HIT_NO_INDEX if the caller should test
+ * all the children (there is no valid index or there were more than `buf_size` candidates)
+ */
+int16_t lv_hit_get_candidates(const lv_obj_t * par, const lv_point_t * point, lv_obj_t ** buf, uint16_t buf_size);
+
+/**
+ * Get the children of an object whose click area is completely in an area (e.g. a rubber band selection).
+ * Only the cells of the grid overlapping the area are visited.
+ * @param par pointer to an object
+ * @param area the area in absolute coordinates
+ * @param cb called once on every child in the area, in no particular order
+ * @param user_data passed to `cb`
+ * @return false if the children are not indexed and the caller should test them one by one (`cb` wasn't called)
+ */
+bool lv_hit_get_in_area(const lv_obj_t * par, const lv_area_t * area, lv_hit_area_cb_t cb, void * user_data);
+
+#else
+
+static inline void lv_hit_build(lv_obj_t * par)
+{
+    (void)par; /*Unused*/
+}
+
+static inline void lv_hit_invalidate(const lv_obj_t * par)
+{
+    (void)par; /*Unused*/
+}
+
+static inline void lv_hit_remove(const lv_obj_t * obj)
+{
+    (void)obj; /*Unused*/
+}
+
+static inline bool lv_hit_get_in_area(const lv_obj_t * par, const lv_area_t * area, lv_hit_area_cb_t cb,
+                                      void * user_data)
+{
+    (void)par;       /*Unused*/
+    (void)area;      /*Unused*/
+    (void)cb;        /*Unused*/
+    (void)user_data; /*Unused*/
+    return false;
+}
+
+#endif /*LV_USE_HIT_INDEX*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_HIT_H*/
@@ -13,8 +13,14 @@
 #include "../lv_hal/lv_hal_tick.h"
 #include "../lv_core/lv_group.h"
 #include "../lv_core/lv_refr.h"
+#include "../lv_core/lv_hit.h"
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_gc.h"
+#if LV_USE_HW_CURSOR && LV_USE_IMG
+#include <string.h>
+#include "../lv_objx/lv_img.h"
+#endif
 
 /*********************
  *      DEFINES
@@ -34,21 +40,35 @@
 
 static void indev_pointer_proc(lv_indev_t * i, lv_indev_data_t * data);
 static void indev_keypad_proc(lv_indev_t * i, lv_indev_data_t * data);
+#if LV_USE_GROUP
+static bool keypad_focus_dir(lv_group_t * g, uint32_t key);
+#endif
 static void indev_encoder_proc(lv_indev_t * i, lv_indev_data_t * data);
 static void indev_button_proc(lv_indev_t * i, lv_indev_data_t * data);
 static void indev_proc_press(lv_indev_proc_t * proc);
 static void indev_proc_release(lv_indev_proc_t * proc);
 static void indev_proc_reset_query_handler(lv_indev_t * indev);
 static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj);
+static lv_obj_t * indev_search_children(const lv_indev_proc_t * proc, lv_obj_t * obj);
 static void indev_drag(lv_indev_proc_t * state);
+static lv_obj_t * indev_drag_get_obj(lv_indev_proc_t * state);
+static void indev_drag_apply(lv_indev_proc_t * state);
 static void indev_drag_throw(lv_indev_proc_t * proc);
 static bool indev_reset_check(lv_indev_proc_t * proc);
+#if LV_USE_HW_CURSOR
+static const lv_img_dsc_t * indev_cursor_get_img(lv_obj_t * cur_obj);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_CONTEXT
+#define indev_act (lv_context_act->indev_act)
+#define indev_obj_act (lv_context_act->indev_obj_act)
+#else
 static lv_indev_t * indev_act;
 static lv_obj_t * indev_obj_act = NULL;
+#endif
 
 /**********************
  *      MACROS
@@ -81,6 +101,9 @@ void lv_indev_read_task(lv_task_t * task)
     /*Read and process all indevs*/
     if(indev_act->driver.disp == NULL) return; /*Not assigned to any displays*/
 
+    /*Search the objects at their final place*/
+    lv_obj_layout_flush();
+
     /*Handle reset query before processing the point*/
     indev_proc_reset_query_handler(indev_act);
 
@@ -194,9 +217,30 @@ void lv_indev_set_cursor(lv_indev_t * indev, lv_obj_t * cur_obj)
 {
     if(indev->driver.type != LV_INDEV_TYPE_POINTER) return;
 
+#if LV_USE_HW_CURSOR
+    lv_disp_drv_t * disp_drv = &indev->driver.disp->driver;
+    if(indev->hw_cursor) {
+        disp_drv->cursor_set_cb(disp_drv, NULL);
+        indev->hw_cursor = 0;
+    }
+#endif
+
     indev->cursor = cur_obj;
     lv_obj_set_parent(indev->cursor, lv_disp_get_layer_sys(indev->driver.disp));
     lv_obj_set_pos(indev->cursor, indev->proc.types.pointer.act_point.x, indev->proc.types.pointer.act_point.y);
+
+#if LV_USE_HW_CURSOR
+    /*Let the display show the image if it can. Then the object is hidden and moving the cursor redraws nothing.*/
+    const lv_img_dsc_t * img = indev_cursor_get_img(cur_obj);
+    if(img && disp_drv->cursor_set_cb && disp_drv->cursor_set_cb(disp_drv, img)) {
+        indev->hw_cursor = 1;
+        lv_obj_set_hidden(cur_obj, true);
+        if(disp_drv->cursor_move_cb) {
+            disp_drv->cursor_move_cb(disp_drv, indev->proc.types.pointer.act_point.x,
+                                     indev->proc.types.pointer.act_point.y);
+        }
+    }
+#endif
 }
 
 #if LV_USE_GROUP
@@ -339,7 +383,16 @@ static void indev_pointer_proc(lv_indev_t * i, lv_indev_data_t * data)
     /*Move the cursor if set and moved*/
     if(i->cursor != NULL &&
        (i->proc.types.pointer.last_point.x != data->point.x || i->proc.types.pointer.last_point.y != data->point.y)) {
+#if LV_USE_HW_CURSOR
+        if(i->hw_cursor) {
+            lv_disp_drv_t * disp_drv = &i->driver.disp->driver;
+            if(disp_drv->cursor_move_cb) disp_drv->cursor_move_cb(disp_drv, data->point.x, data->point.y);
+        } else {
+            lv_obj_set_pos(i->cursor, data->point.x, data->point.y);
+        }
+#else
         lv_obj_set_pos(i->cursor, data->point.x, data->point.y);
+#endif
     }
 
     i->proc.types.pointer.act_point.x = data->point.x;
@@ -423,6 +476,10 @@ static void indev_keypad_proc(lv_indev_t * i, lv_indev_data_t * data)
             lv_group_focus_prev(g);
             if(indev_reset_check(&i->proc)) return;
         }
+        /*Move the focus with the arrows if the group is set so*/
+        else if(keypad_focus_dir(g, data->key)) {
+            if(indev_reset_check(&i->proc)) return;
+        }
         /*Just send other keys to the object (e.g. 'A' or `LV_GROUP_KEY_RIGHT`)*/
         else {
             lv_group_send_data(g, data->key);
@@ -466,6 +523,10 @@ static void indev_keypad_proc(lv_indev_t * i, lv_indev_data_t * data)
                 lv_group_focus_prev(g);
                 if(indev_reset_check(&i->proc)) return;
             }
+            /*Move the focus with the arrows again*/
+            else if(keypad_focus_dir(g, data->key)) {
+                if(indev_reset_check(&i->proc)) return;
+            }
             /*Just send other keys again to the object (e.g. 'A' or `LV_GORUP_KEY_RIGHT)*/
             else {
                 lv_group_send_data(g, data->key);
@@ -503,6 +564,32 @@ static void indev_keypad_proc(lv_indev_t * i, lv_indev_data_t * data)
 #endif
 }
 
+#if LV_USE_GROUP
+/**
+ * Move the focus of a group with an arrow key if the group has `dir_keys` enabled
+ * @param g pointer to a group
+ * @param key the pressed key
+ * @return true: the key was an arrow and it was used for the focus (even if the focus couldn't move)
+ */
+static bool keypad_focus_dir(lv_group_t * g, uint32_t key)
+{
+    if(!lv_group_get_dir_keys(g)) return false;
+
+    lv_group_dir_t dir;
+    switch(key) {
+        case LV_KEY_UP: dir = LV_GROUP_DIR_UP; break;
+        case LV_KEY_DOWN: dir = LV_GROUP_DIR_DOWN; break;
+        case LV_KEY_LEFT: dir = LV_GROUP_DIR_LEFT; break;
+        case LV_KEY_RIGHT: dir = LV_GROUP_DIR_RIGHT; break;
+        default: return false;
+    }
+
+    lv_group_set_editing(g, false); /*Editing is not used by KEYPAD is be sure it is disabled*/
+    lv_group_focus_dir(g, dir);
+    return true;
+}
+#endif
+
 /**
  * Process a new point from LV_INDEV_TYPE_ENCODER input device
  * @param i pointer to an input device
@@ -734,6 +821,8 @@ static void indev_proc_press(lv_indev_proc_t * proc)
             proc->types.pointer.drag_in_prog   = 0;
             proc->types.pointer.drag_sum.x     = 0;
             proc->types.pointer.drag_sum.y     = 0;
+            proc->types.pointer.drag_pend.x    = 0;
+            proc->types.pointer.drag_pend.y    = 0;
             proc->types.pointer.vect.x         = 0;
             proc->types.pointer.vect.y         = 0;
 
@@ -834,6 +923,12 @@ static void indev_proc_release(lv_indev_proc_t * proc)
     }
     indev_obj_act = proc->types.pointer.act_obj;
 
+    /*Move the dragged object to the released point before the release events*/
+    if(indev_obj_act && (proc->types.pointer.drag_pend.x != 0 || proc->types.pointer.drag_pend.y != 0)) {
+        indev_drag_apply(proc);
+        if(indev_reset_check(proc)) return;
+    }
+
     /*Forget the act obj and send a released signal */
     if(indev_obj_act) {
         /* If the object was protected against press lost then it possible that
@@ -971,6 +1066,8 @@ static void indev_proc_reset_query_handler(lv_indev_t * indev)
         indev->proc.longpr_rep_timestamp            = 0;
         indev->proc.types.pointer.drag_sum.x        = 0;
         indev->proc.types.pointer.drag_sum.y        = 0;
+        indev->proc.types.pointer.drag_pend.x       = 0;
+        indev->proc.types.pointer.drag_pend.y       = 0;
         indev->proc.types.pointer.drag_throw_vect.x = 0;
         indev->proc.types.pointer.drag_throw_vect.y = 0;
         indev->proc.reset_query                     = 0;
@@ -988,36 +1085,20 @@ static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj)
     lv_obj_t * found_p = NULL;
 
     /*If the point is on this object check its children too*/
-#if LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     lv_area_t ext_area;
-    ext_area.x1 = obj->coords.x1 - obj->ext_click_pad_hor;
-    ext_area.x2 = obj->coords.x2 + obj->ext_click_pad_hor;
-    ext_area.y1 = obj->coords.y1 - obj->ext_click_pad_ver;
-    ext_area.y2 = obj->coords.y2 + obj->ext_click_pad_ver;
-
-    if(lv_area_is_point_on(&ext_area, &proc->types.pointer.act_point)) {
-#elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_FULL
-    lv_area_t ext_area;
-    ext_area.x1 = obj->coords.x1 - obj->ext_click_pad.x1;
-    ext_area.x2 = obj->coords.x2 + obj->ext_click_pad.x2;
-    ext_area.y1 = obj->coords.y1 - obj->ext_click_pad.y1;
-    ext_area.y2 = obj->coords.y2 + obj->ext_click_pad.y2;
+    lv_hit_get_click_area(obj, &ext_area);
 
     if(lv_area_is_point_on(&ext_area, &proc->types.pointer.act_point)) {
+#if LV_USE_CHILD_BOUNDS
+        /*Test the children only if the point is on one of them*/
+        lv_area_t child_bounds;
+        if(lv_obj_get_child_bounds(obj, &child_bounds) &&
+           lv_area_is_point_on(&child_bounds, &proc->types.pointer.act_point)) {
+            found_p = indev_search_children(proc, obj);
+        }
 #else
-    if(lv_area_is_point_on(&obj->coords, &proc->types.pointer.act_point)) {
+        found_p = indev_search_children(proc, obj);
 #endif
-        lv_obj_t * i;
-
-        LV_LL_READ(obj->child_ll, i)
-        {
-            found_p = indev_search_obj(proc, i);
-
-            /*If a child was found then break*/
-            if(found_p != NULL) {
-                break;
-            }
-        }
 
         /*If then the children was not ok, and this obj is clickable
          * and it or its parent is not hidden then save this object*/
@@ -1035,24 +1116,68 @@ static lv_obj_t * indev_search_obj(const lv_indev_proc_t * proc, lv_obj_t * obj)
     return found_p;
 }
 
+/**
+ * Search the most top, clickable object among the children of an object on the last point of an input device
+ * @param proc pointer to  the `lv_indev_proc_t` part of the input device
+ * @param obj pointer to the parent object
+ * @return pointer to the found object or NULL if there was no suitable object
+ */
+static lv_obj_t * indev_search_children(const lv_indev_proc_t * proc, lv_obj_t * obj)
+{
+    lv_obj_t * found_p = NULL;
+    lv_obj_t * i;
+
+#if LV_USE_HIT_INDEX
+    /*Test only the children around the point if they are indexed*/
+    lv_obj_t * cand[LV_HIT_CANDIDATE_MAX];
+    int16_t cand_cnt = lv_hit_get_candidates(obj, &proc->types.pointer.act_point, cand, LV_HIT_CANDIDATE_MAX);
+    if(cand_cnt != LV_HIT_NO_INDEX) {
+        int16_t c;
+        for(c = 0; c < cand_cnt && found_p == NULL; c++) {
+            found_p = indev_search_obj(proc, cand[c]);
+        }
+    } else {
+        uint32_t child_cnt = 0;
+        LV_LL_READ(obj->child_ll, i)
+        {
+            child_cnt++;
+            found_p = indev_search_obj(proc, i);
+
+            /*If a child was found then break*/
+            if(found_p != NULL) {
+                break;
+            }
+        }
+
+        /*Too many children were tested one by one so index them for the next time*/
+        if(child_cnt >= LV_HIT_INDEX_MIN_CHILDREN) lv_hit_build(obj);
+    }
+#else
+    LV_LL_READ(obj->child_ll, i)
+    {
+        found_p = indev_search_obj(proc, i);
+
+        /*If a child was found then break*/
+        if(found_p != NULL) {
+            break;
+        }
+    }
+#endif
+
+    return found_p;
+}
+
 /**
  * Handle the dragging of indev_proc_p->types.pointer.act_obj
  * @param indev pointer to a input device state
  */
 static void indev_drag(lv_indev_proc_t * state)
 {
-    lv_obj_t * drag_obj    = state->types.pointer.act_obj;
+    lv_obj_t * drag_obj    = indev_drag_get_obj(state);
     bool drag_just_started = false;
 
-    /*If drag parent is active check recursively the drag_parent attribute*/
-    while(lv_obj_get_drag_parent(drag_obj) != false && drag_obj != NULL) {
-        drag_obj = lv_obj_get_parent(drag_obj);
-    }
-
     if(drag_obj == NULL) return;
 
-    if(lv_obj_get_drag(drag_obj) == false) return;
-
     lv_drag_dir_t allowed_dirs = lv_obj_get_drag_dir(drag_obj);
 
     /*Count the movement by drag*/
@@ -1075,61 +1200,109 @@ static void indev_drag(lv_indev_proc_t * state)
     if(state->types.pointer.drag_limit_out != 0) {
         /*Set new position if the vector is not zero*/
         if(state->types.pointer.vect.x != 0 || state->types.pointer.vect.y != 0) {
+            if(drag_just_started) {
+                state->types.pointer.drag_pend.x += state->types.pointer.drag_sum.x;
+                state->types.pointer.drag_pend.y += state->types.pointer.drag_sum.y;
+            }
+            state->types.pointer.drag_pend.x += state->types.pointer.vect.x;
+            state->types.pointer.drag_pend.y += state->types.pointer.vect.y;
+
+            /* Move the object at most once between two refreshes: the positions between them
+             * wouldn't be seen but would invalidate the areas of the object on the way.
+             * Half read period of tolerance to not skip a period because of a late read.*/
+            if(drag_just_started == false && state->types.pointer.drag_in_prog != 0) {
+                lv_task_t * refr_task = indev_act->driver.disp->refr_task;
+                lv_task_t * read_task = indev_act->driver.read_task;
+                uint32_t refr_period  = refr_task ? refr_task->period : LV_DISP_DEF_REFR_PERIOD;
+                uint32_t read_period  = read_task ? read_task->period : LV_INDEV_DEF_READ_PERIOD;
+                if(lv_tick_elaps(state->types.pointer.drag_move_time) + read_period / 2 < refr_period) return;
+            }
 
-            uint16_t inv_buf_size =
-                lv_disp_get_inv_buf_size(indev_act->driver.disp); /*Get the number of currently invalidated areas*/
+            indev_drag_apply(state);
+        }
+    }
+}
 
-            lv_coord_t prev_x     = drag_obj->coords.x1;
-            lv_coord_t prev_y     = drag_obj->coords.y1;
-            lv_coord_t prev_par_w = lv_obj_get_width(lv_obj_get_parent(drag_obj));
-            lv_coord_t prev_par_h = lv_obj_get_height(lv_obj_get_parent(drag_obj));
+/**
+ * Get the object dragged by an input device
+ * @param state pointer to an input device state
+ * @return the pressed object or its parent if the drag is passed to it. NULL if not draggable.
+ */
+static lv_obj_t * indev_drag_get_obj(lv_indev_proc_t * state)
+{
+    lv_obj_t * drag_obj = state->types.pointer.act_obj;
 
-            /*Get the coordinates of the object and modify them*/
-            lv_coord_t act_x = lv_obj_get_x(drag_obj);
-            lv_coord_t act_y = lv_obj_get_y(drag_obj);
+    /*If drag parent is active check recursively the drag_parent attribute*/
+    while(lv_obj_get_drag_parent(drag_obj) != false && drag_obj != NULL) {
+        drag_obj = lv_obj_get_parent(drag_obj);
+    }
 
-            if(allowed_dirs == LV_DRAG_DIR_ALL) {
-                if(drag_just_started) {
-                    act_x += state->types.pointer.drag_sum.x;
-                    act_y += state->types.pointer.drag_sum.y;
-                }
-                lv_obj_set_pos(drag_obj, act_x + state->types.pointer.vect.x, act_y + state->types.pointer.vect.y);
-            } else if(allowed_dirs & LV_DRAG_DIR_HOR) {
-                if(drag_just_started) {
-                    act_x += state->types.pointer.drag_sum.x;
-                }
-                lv_obj_set_x(drag_obj, act_x + state->types.pointer.vect.x);
-            } else if(allowed_dirs & LV_DRAG_DIR_VER) {
-                if(drag_just_started) {
-                    act_y += state->types.pointer.drag_sum.y;
-                }
-                lv_obj_set_y(drag_obj, act_y + state->types.pointer.vect.y);
-            }
+    if(drag_obj == NULL) return NULL;
 
-            /*Set the drag in progress flag*/
-            /*Send the drag begin signal on first move*/
-            if(state->types.pointer.drag_in_prog == 0) {
-                drag_obj->signal_cb(drag_obj, LV_SIGNAL_DRAG_BEGIN, indev_act);
-                if(indev_reset_check(state)) return;
-                lv_event_send(drag_obj, LV_EVENT_DRAG_BEGIN, NULL);
-                if(indev_reset_check(state)) return;
-            }
+    if(lv_obj_get_drag(drag_obj) == false) return NULL;
 
-            state->types.pointer.drag_in_prog = 1;
-
-            /*If the object didn't moved then clear the invalidated areas*/
-            if(drag_obj->coords.x1 == prev_x && drag_obj->coords.y1 == prev_y) {
-                state->types.pointer.drag_in_prog = 0;
-                /*In a special case if the object is moved on a page and
-                 * the scrollable has fit == true and the object is dragged of the page then
-                 * while its coordinate is not changing only the parent's size is reduced */
-                lv_coord_t act_par_w = lv_obj_get_width(lv_obj_get_parent(drag_obj));
-                lv_coord_t act_par_h = lv_obj_get_height(lv_obj_get_parent(drag_obj));
-                if(act_par_w == prev_par_w && act_par_h == prev_par_h) {
-                    uint16_t new_inv_buf_size = lv_disp_get_inv_buf_size(indev_act->driver.disp);
-                    lv_disp_pop_from_inv_buf(indev_act->driver.disp, new_inv_buf_size - inv_buf_size);
-                }
-            }
+    return drag_obj;
+}
+
+/**
+ * Move the dragged object with the collected drag distance
+ * @param state pointer to an input device state
+ */
+static void indev_drag_apply(lv_indev_proc_t * state)
+{
+    lv_obj_t * drag_obj = indev_drag_get_obj(state);
+    lv_point_t pend     = state->types.pointer.drag_pend;
+
+    state->types.pointer.drag_pend.x    = 0;
+    state->types.pointer.drag_pend.y    = 0;
+    state->types.pointer.drag_move_time = lv_tick_get();
+
+    if(drag_obj == NULL) return;
+
+    lv_drag_dir_t allowed_dirs = lv_obj_get_drag_dir(drag_obj);
+
+    uint16_t inv_buf_size =
+        lv_disp_get_inv_buf_size(indev_act->driver.disp); /*Get the number of currently invalidated areas*/
+
+    lv_coord_t prev_x     = drag_obj->coords.x1;
+    lv_coord_t prev_y     = drag_obj->coords.y1;
+    lv_coord_t prev_par_w = lv_obj_get_width(lv_obj_get_parent(drag_obj));
+    lv_coord_t prev_par_h = lv_obj_get_height(lv_obj_get_parent(drag_obj));
+
+    /*Get the coordinates of the object and modify them*/
+    lv_coord_t act_x = lv_obj_get_x(drag_obj);
+    lv_coord_t act_y = lv_obj_get_y(drag_obj);
+
+    if(allowed_dirs == LV_DRAG_DIR_ALL) {
+        lv_obj_set_pos(drag_obj, act_x + pend.x, act_y + pend.y);
+    } else if(allowed_dirs & LV_DRAG_DIR_HOR) {
+        lv_obj_set_x(drag_obj, act_x + pend.x);
+    } else if(allowed_dirs & LV_DRAG_DIR_VER) {
+        lv_obj_set_y(drag_obj, act_y + pend.y);
+    }
+
+    /*Set the drag in progress flag*/
+    /*Send the drag begin signal on first move*/
+    if(state->types.pointer.drag_in_prog == 0) {
+        drag_obj->signal_cb(drag_obj, LV_SIGNAL_DRAG_BEGIN, indev_act);
+        if(indev_reset_check(state)) return;
+        lv_event_send(drag_obj, LV_EVENT_DRAG_BEGIN, NULL);
+        if(indev_reset_check(state)) return;
+    }
+
+    state->types.pointer.drag_in_prog = 1;
+
+    /*If the object didn't moved then clear the invalidated areas*/
+    if(drag_obj->coords.x1 == prev_x && drag_obj->coords.y1 == prev_y) {
+        state->types.pointer.drag_in_prog = 0;
+        /*In a special case if the object is moved on a page and
+         * the scrollable has fit == true and the object is dragged of the page then
+         * while its coordinate is not changing only the parent's size is reduced */
+        lv_coord_t act_par_w = lv_obj_get_width(lv_obj_get_parent(drag_obj));
+        lv_coord_t act_par_h = lv_obj_get_height(lv_obj_get_parent(drag_obj));
+        if(act_par_w == prev_par_w && act_par_h == prev_par_h) {
+            uint16_t new_inv_buf_size = lv_disp_get_inv_buf_size(indev_act->driver.disp);
+            lv_disp_pop_from_inv_buf(indev_act->driver.disp, new_inv_buf_size - inv_buf_size);
         }
     }
 }
@@ -1157,9 +1330,6 @@ static void indev_drag_throw(lv_indev_proc_t * proc)
     if(lv_obj_get_drag_throw(drag_obj) == false) {
         proc->types.pointer.drag_in_prog = 0;
         drag_obj->signal_cb(drag_obj, LV_SIGNAL_DRAG_END, indev_act);
-        lv_event_send(drag_obj, LV_EVENT_DRAG_END, NULL);
-        if(indev_reset_check(proc)) return;
-
         lv_event_send(drag_obj, LV_EVENT_DRAG_END, NULL);
         return;
     }
@@ -1214,6 +1384,37 @@ static void indev_drag_throw(lv_indev_proc_t * proc)
     }
 }
 
+#if LV_USE_HW_CURSOR
+/**
+ * Get the image of a cursor object which a display can show instead of drawing the object
+ * @param cur_obj pointer to the cursor object
+ * @return the true color image variable of an `lv_img` cursor or NULL
+ */
+static const lv_img_dsc_t * indev_cursor_get_img(lv_obj_t * cur_obj)
+{
+#if LV_USE_IMG
+    lv_obj_type_t type;
+    lv_obj_get_type(cur_obj, &type);
+    if(strcmp(type.type[0], "lv_img") != 0) return NULL;
+
+    const void * src = lv_img_get_src(cur_obj);
+    if(lv_img_src_get_type(src) != LV_IMG_SRC_VARIABLE) return NULL;
+
+    /*The drivers convert only the true color formats*/
+    const lv_img_dsc_t * img = src;
+    if(img->header.cf != LV_IMG_CF_TRUE_COLOR && img->header.cf != LV_IMG_CF_TRUE_COLOR_ALPHA &&
+       img->header.cf != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+        return NULL;
+    }
+
+    return img;
+#else
+    (void)cur_obj; /*Unused*/
+    return NULL;
+#endif
+}
+#endif
+
 /**
  * Checks if the reset_query flag has been set. If so, perform necessary global indev cleanup actions
  * @param proc pointer to an input device 'proc'
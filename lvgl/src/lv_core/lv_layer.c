@@ -0,0 +1,644 @@
+/**
+ * @file lv_layer.c
+ * Bitmap cache of static objects ("layers").
+ * A cached object's area is drawn once into a bitmap, with everything below it, so the bitmap is opaque.
+ * Until the object, a child or something below it is invalidated, the refresh copies the bitmap
+ * instead of calling the design functions of the object and its children. The objects above it
+ * (e.g. a dragged object passing over a static window) don't make the bitmap outdated.
+ * The bitmaps are allocated with `lv_mem_alloc` and the least recently drawn ones are dropped
+ * to stay in `LV_LAYER_CACHE_BUDGET`.
+ * The bitmap of a backdrop (e.g. the dimming object behind a modal message box) has only the object itself
+ * with what's below it, the children are drawn on the copied bitmap. The changes below it don't make it
+ * outdated right away: they are redrawn at most every `LV_LAYER_BACKDROP_PERIOD` ms.
+ * The bitmap of a static part (e.g. the background and the axes of a chart) has what the object draws with
+ * `LV_DESIGN_DRAW_STATIC`, the rest of it and the children are drawn on the copied bitmap. The object and
+ * its children don't make it outdated, only `lv_layer_outdate` and what's below it.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_layer.h"
+#if LV_USE_LAYER_CACHE
+
+#include <string.h>
+#include "lv_disp.h"
+#include "lv_refr.h"
+#include "../lv_draw/lv_draw_basic.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_task.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_misc/lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const lv_obj_t * obj; /*NULL: unused slot*/
+    lv_color_t * buf;     /*The bitmap, NULL if it's dropped*/
+    uint32_t buf_size;    /*Bytes of `buf`*/
+    lv_area_t area;       /*On the display, the area of the object (with `ext_draw_pad`) visible in its parents*/
+    uint32_t inv_refr;    /*Refresh period of the last invalidation*/
+    uint32_t used_refr;   /*Last refresh which copied the bitmap*/
+    uint32_t draw_tick;   /*`lv_tick_get` when the bitmap was drawn*/
+    lv_area_t stale_area; /*A backdrop's area which changed below it since the bitmap was drawn*/
+    uint8_t valid : 1;
+    uint8_t backdrop : 1; /*The bitmap has the object without its children*/
+    uint8_t stale : 1;    /*`stale_area` is set*/
+    uint8_t part : 1;     /*The bitmap has the static part of the object*/
+} lv_layer_t;
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    lv_layer_t layers[LV_LAYER_CACHE_SLOTS];
+    uint32_t refr_cnt;
+    lv_layer_stat_t stat;
+    lv_task_t * backdrop_task; /*Redraws the stale areas of the backdrops*/
+} lv_layer_state_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_layer_t * layer_find(const lv_obj_t * obj);
+static bool layer_get_area(const lv_obj_t * obj, lv_disp_t * disp, lv_area_t * area_p);
+static bool layer_is_needed(lv_disp_t * disp, const lv_area_t * area_p);
+static bool layer_alloc(lv_layer_t * layer, uint32_t size);
+static void layer_free(lv_layer_t * layer);
+static bool obj_is_above(const lv_obj_t * obj, const lv_obj_t * layer_obj);
+static bool obj_is_child(const lv_obj_t * obj, const lv_obj_t * layer_obj);
+static void backdrop_task_cb(lv_task_t * task);
+static void backdrop_task_sched(void);
+static uint32_t shrinker_size_cb(void);
+static uint32_t shrinker_shrink_cb(uint32_t size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_USE_CONTEXT
+#define layer_st ((lv_layer_state_t *)lv_context_act->layer_state)
+#else
+static lv_layer_state_t layer_state;
+#define layer_st (&layer_state)
+#endif
+#define layers (layer_st->layers)
+#define refr_cnt (layer_st->refr_cnt)
+#define stat (layer_st->stat)
+#define backdrop_task (layer_st->backdrop_task)
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+const lv_mem_shrinker_t lv_layer_shrinker = {"layer_cache", shrinker_size_cb, shrinker_shrink_cb};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Init the layer cache of the active context. Called by `lv_context_init`.
+ */
+void lv_layer_init(void)
+{
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->layer_state, sizeof(lv_layer_state_t));
+#endif
+}
+
+/**
+ * Start caching an object. Called by `lv_obj_set_layer_cache`, `lv_obj_set_layer_backdrop`
+ * and `lv_obj_set_layer_static`.
+ * @param obj pointer to an object
+ * @param mode what the bitmap has, an element of `lv_layer_mode_t`
+ * @return true: ok; false: all the `LV_LAYER_CACHE_SLOTS` are used
+ */
+bool lv_layer_add(lv_obj_t * obj, lv_layer_mode_t mode)
+{
+    bool backdrop = mode == LV_LAYER_MODE_BACKDROP;
+    bool part     = mode == LV_LAYER_MODE_STATIC;
+
+    if(backdrop && backdrop_task == NULL) {
+        backdrop_task = lv_task_create(backdrop_task_cb, LV_LAYER_BACKDROP_PERIOD, LV_TASK_PRIO_MID, NULL);
+        if(backdrop_task == NULL) return false;
+        lv_task_pause(backdrop_task);
+    }
+
+    lv_layer_t * layer = layer_find(obj);
+    if(layer) {
+        /*The bitmap has an other content in the other mode*/
+        if(layer->backdrop != backdrop || layer->part != part) {
+            layer->valid    = 0;
+            layer->stale    = 0;
+            layer->backdrop = backdrop ? 1 : 0;
+            layer->part     = part ? 1 : 0;
+        }
+        return true;
+    }
+
+    layer = layer_find(NULL);
+    if(layer == NULL) {
+        LV_LOG_WARN("lv_layer_add: no free slot, increase LV_LAYER_CACHE_SLOTS");
+        return false;
+    }
+
+    memset(layer, 0, sizeof(lv_layer_t));
+    layer->obj      = obj;
+    layer->inv_refr = refr_cnt; /*Wait a period as if it was just changed*/
+    layer->backdrop = backdrop ? 1 : 0;
+    layer->part     = part ? 1 : 0;
+    stat.layer_cnt++;
+
+    return true;
+}
+
+/**
+ * Stop caching an object and free its bitmap. Called by `lv_obj_set_layer_cache` and when the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_layer_remove(const lv_obj_t * obj)
+{
+    lv_layer_t * layer = layer_find(obj);
+    if(layer == NULL) return;
+
+    layer_free(layer);
+    layer->obj = NULL;
+    stat.layer_cnt--;
+}
+
+/**
+ * Mark the bitmaps outdated which can be changed by an invalidated area. Called by `lv_inv_area_by`.
+ * @param area_p the invalidated area on the display
+ * @param obj the object which invalidated it. The bitmaps of the cached objects below it stay valid.
+ * NULL if unknown.
+ * @return true: redraw the area; false: it's under a backdrop whose bitmap is shown instead,
+ * the area is redrawn at most `LV_LAYER_BACKDROP_PERIOD` ms after the backdrop was drawn
+ */
+bool lv_layer_inv(const lv_area_t * area_p, const lv_obj_t * obj)
+{
+    if(stat.layer_cnt == 0) return true;
+
+    bool redraw = true;
+
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        lv_layer_t * layer = &layers[i];
+        if(layer->obj == NULL) continue;
+
+        /*The bitmap's area or the object's current area (it might have moved)*/
+        lv_area_t obj_area;
+        lv_coord_t ext_size = layer->obj->ext_draw_pad;
+        lv_obj_get_coords(layer->obj, &obj_area);
+        obj_area.x1 -= ext_size;
+        obj_area.y1 -= ext_size;
+        obj_area.x2 += ext_size;
+        obj_area.y2 += ext_size;
+        bool on = lv_area_is_on(area_p, &obj_area) || (layer->valid && lv_area_is_on(area_p, &layer->area));
+        if(on == false) continue;
+
+        if(obj != NULL && obj_is_above(obj, layer->obj)) continue;
+
+        /*The changes of a static part are told by `lv_layer_outdate`, the rest is drawn on the copied bitmap*/
+        if(layer->part && (obj == layer->obj || (obj != NULL && obj_is_child(obj, layer->obj)))) continue;
+
+        if(layer->backdrop && obj != NULL && obj != layer->obj) {
+            /*The children are drawn on the copied bitmap*/
+            if(obj_is_child(obj, layer->obj)) continue;
+
+            /*Below it: the bitmap shows how it was for now*/
+            if(layer->valid && lv_area_is_in(area_p, &layer->area)) {
+                if(layer->stale) {
+                    lv_area_join(&layer->stale_area, &layer->stale_area, area_p);
+                } else {
+                    lv_area_copy(&layer->stale_area, area_p);
+                    layer->stale = 1;
+                    backdrop_task_sched();
+                }
+                stat.defer_px += lv_area_get_size(area_p);
+                redraw = false;
+                continue;
+            }
+        }
+
+        layer->valid    = 0;
+        layer->inv_refr = refr_cnt;
+    }
+
+    return redraw;
+}
+
+/**
+ * Mark the bitmap of an object outdated. Unlike `lv_layer_inv` it's drawn again in the next refresh
+ * even if the object was changed in the last period. Called by `lv_obj_outdate_layer`.
+ * @param obj pointer to a cached object
+ */
+void lv_layer_outdate(const lv_obj_t * obj)
+{
+    lv_layer_t * layer = layer_find(obj);
+    if(layer == NULL) return;
+
+    layer->valid = 0;
+    layer->stale = 0;
+}
+
+/**
+ * Draw the outdated bitmaps which will be copied in this refresh. Called by the refresh before drawing.
+ * A bitmap is drawn only if its object wasn't invalidated in the last period, so a changing object is drawn
+ * as usual and gets its bitmap once it's static again.
+ * @param disp pointer to the display being refreshed (its invalidated areas are joined already)
+ * @param render_cb draws the bitmaps
+ */
+void lv_layer_refr(lv_disp_t * disp, lv_layer_render_cb_t render_cb)
+{
+    refr_cnt++;
+    if(stat.layer_cnt == 0) return;
+
+    /*The bitmaps are `lv_color_t` arrays, they can't be drawn with `set_px_cb`*/
+    if(disp->driver.set_px_cb) return;
+
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        lv_layer_t * layer = &layers[i];
+        if(layer->obj == NULL) continue;
+
+        lv_area_t area;
+        if(layer_get_area(layer->obj, disp, &area) == false) continue;
+        if(layer_is_needed(disp, &area) == false) continue;
+
+        /*Keep it from being dropped for an other bitmap of this refresh*/
+        layer->used_refr = refr_cnt;
+
+        if(layer->valid && area.x1 == layer->area.x1 && area.y1 == layer->area.y1 && area.x2 == layer->area.x2 &&
+           area.y2 == layer->area.y2) {
+            continue;
+        }
+        layer->valid = 0;
+
+        /*Changed in the last period: it's probably animated or edited, draw it as usual for now.
+         *A backdrop is changed only by itself and rarely.*/
+        if(layer->backdrop == 0 && layer->inv_refr + 1 >= refr_cnt) continue;
+
+        if(layer_alloc(layer, lv_area_get_size(&area) * sizeof(lv_color_t)) == false) continue;
+
+        lv_area_copy(&layer->area, &area);
+        render_cb((lv_obj_t *)layer->obj, layer->buf, &layer->area);
+        layer->valid     = 1;
+        layer->stale     = 0;
+        layer->draw_tick = lv_tick_get();
+        stat.render_cnt++;
+    }
+}
+
+/**
+ * Check if an object can be drawn from its bitmap on an area
+ * @param obj pointer to a cached object
+ * @param area_p an area on the display
+ * @return true: the bitmap is valid and covers the area
+ */
+bool lv_layer_is_valid(const lv_obj_t * obj, const lv_area_t * area_p)
+{
+    lv_layer_t * layer = layer_find(obj);
+    if(layer == NULL || layer->valid == 0) return false;
+
+    return lv_area_is_in(area_p, &layer->area);
+}
+
+/**
+ * Copy the bitmap of an object to the VDB. Thread safe, called by the drawing threads.
+ * @param obj pointer to a cached object
+ * @param mask_p draw only here
+ * @return true: drawn; false: the object has to be drawn as usual
+ */
+bool lv_layer_draw(const lv_obj_t * obj, const lv_area_t * mask_p)
+{
+    lv_layer_t * layer = layer_find(obj);
+    if(layer == NULL || layer->valid == 0) return false;
+    if(lv_area_is_in(mask_p, &layer->area) == false) return false;
+
+    /*Opaque, without recoloring: it's copied row by row*/
+    lv_draw_map(&layer->area, mask_p, (const uint8_t *)layer->buf, LV_OPA_COVER, false, false, LV_COLOR_BLACK,
+                LV_OPA_TRANSP);
+
+    lv_thread_lock();
+    stat.blit_px += lv_area_get_size(mask_p);
+    lv_thread_unlock();
+
+    return true;
+}
+
+/**
+ * Get the statistics of the layer cache
+ * @param stat_p the statistics are copied here
+ * @param reset true: zero the counters after copying them
+ */
+void lv_layer_get_stat(lv_layer_stat_t * stat_p, bool reset)
+{
+    memcpy(stat_p, &stat, sizeof(lv_layer_stat_t));
+    if(reset) {
+        stat.render_cnt = 0;
+        stat.blit_px    = 0;
+        stat.evict_cnt  = 0;
+        stat.defer_px   = 0;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Find the slot of an object
+ * @param obj pointer to an object, NULL to find a free slot
+ * @return the slot or NULL
+ */
+static lv_layer_t * layer_find(const lv_obj_t * obj)
+{
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        if(layers[i].obj == obj) return &layers[i];
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the area of an object's bitmap: its area with `ext_draw_pad`, truncated to its parents and the display
+ * @param obj pointer to a cached object
+ * @param disp pointer to a display
+ * @param area_p store the area here
+ * @return false: the object is not visible on the display
+ */
+static bool layer_get_area(const lv_obj_t * obj, lv_disp_t * disp, lv_area_t * area_p)
+{
+    const lv_obj_t * scr = lv_obj_get_screen(obj);
+    if(scr != lv_disp_get_scr_act(disp) && scr != lv_disp_get_layer_top(disp) && scr != lv_disp_get_layer_sys(disp)) {
+        return false;
+    }
+
+    lv_coord_t ext_size = obj->ext_draw_pad;
+    lv_obj_get_coords(obj, area_p);
+    area_p->x1 -= ext_size;
+    area_p->y1 -= ext_size;
+    area_p->x2 += ext_size;
+    area_p->y2 += ext_size;
+    if(obj->hidden) return false;
+
+    const lv_obj_t * par;
+    for(par = lv_obj_get_parent(obj); par != NULL; par = lv_obj_get_parent(par)) {
+        if(par->hidden) return false;
+        if(lv_area_intersect(area_p, area_p, &par->coords) == false) return false;
+    }
+
+    lv_area_t scr_area;
+    scr_area.x1 = 0;
+    scr_area.y1 = 0;
+    scr_area.x2 = lv_disp_get_hor_res(disp) - 1;
+    scr_area.y2 = lv_disp_get_ver_res(disp) - 1;
+
+    return lv_area_intersect(area_p, area_p, &scr_area);
+}
+
+/**
+ * Check if a bitmap would be copied in this refresh
+ * @param disp pointer to the display being refreshed
+ * @param area_p area of the bitmap
+ * @return true: an invalidated area is on it
+ */
+static bool layer_is_needed(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    uint16_t i;
+    for(i = 0; i < disp->inv_p; i++) {
+        if(disp->inv_area_joined[i] == 0 && lv_area_is_on(area_p, &disp->inv_areas[i])) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Get a bitmap for a layer. The least recently copied bitmaps are dropped to stay in `LV_LAYER_CACHE_BUDGET`.
+ * @param layer pointer to a layer
+ * @param size the bytes of the bitmap
+ * @return true: `layer->buf` is ready; false: no memory, the object is drawn as usual
+ */
+static bool layer_alloc(lv_layer_t * layer, uint32_t size)
+{
+    /*Reuse the old one unless it's much bigger*/
+    if(layer->buf != NULL && layer->buf_size >= size && layer->buf_size / 2 < size) return true;
+    layer_free(layer);
+
+    if(size > LV_LAYER_CACHE_BUDGET) return false;
+
+    while(stat.used_size + size > LV_LAYER_CACHE_BUDGET) {
+        lv_layer_t * lru = NULL;
+        uint8_t i;
+        for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+            lv_layer_t * l = &layers[i];
+            if(l->obj == NULL || l->buf == NULL || l->used_refr == refr_cnt) continue;
+            if(lru == NULL || l->used_refr < lru->used_refr) lru = l;
+        }
+
+        /*The others are copied in this refresh too*/
+        if(lru == NULL) return false;
+
+        layer_free(lru);
+        stat.evict_cnt++;
+    }
+
+    layer->buf = lv_mem_alloc(size);
+    if(layer->buf == NULL) return false;
+
+    layer->buf_size = size;
+    stat.used_size += size;
+
+    return true;
+}
+
+/**
+ * Free the bitmap of a layer
+ * @param layer pointer to a layer
+ */
+static void layer_free(lv_layer_t * layer)
+{
+    if(layer->buf != NULL) {
+        lv_mem_free(layer->buf);
+        stat.used_size -= layer->buf_size;
+    }
+
+    layer->buf      = NULL;
+    layer->buf_size = 0;
+    layer->valid    = 0;
+}
+
+/**
+ * The bytes `lv_layer_shrinker` can give back: the bitmaps of the active context not copied in this refresh
+ */
+static uint32_t shrinker_size_cb(void)
+{
+#if LV_USE_CONTEXT
+    if(lv_context_act == NULL) return 0; /*E.g. a worker thread*/
+#endif
+
+    uint32_t size = 0;
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        lv_layer_t * l = &layers[i];
+        if(l->obj == NULL || l->buf == NULL || l->used_refr == refr_cnt) continue;
+        size += l->buf_size;
+    }
+
+    return size;
+}
+
+/**
+ * Drop the least recently copied bitmaps until `size` bytes are freed, as `layer_alloc` does
+ * @param size bytes to free
+ * @return the freed bytes
+ */
+static uint32_t shrinker_shrink_cb(uint32_t size)
+{
+#if LV_USE_CONTEXT
+    if(lv_context_act == NULL) return 0;
+#endif
+
+    uint32_t freed = 0;
+    while(freed < size) {
+        lv_layer_t * lru = NULL;
+        uint8_t i;
+        for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+            lv_layer_t * l = &layers[i];
+            if(l->obj == NULL || l->buf == NULL || l->used_refr == refr_cnt) continue;
+            if(lru == NULL || l->used_refr < lru->used_refr) lru = l;
+        }
+        if(lru == NULL) break;
+
+        freed += lru->buf_size;
+        layer_free(lru);
+        stat.evict_cnt++;
+    }
+
+    return freed;
+}
+
+/**
+ * Check if an object is drawn after a cached object and its children, so it can't change its bitmap
+ * @param obj pointer to an object
+ * @param layer_obj pointer to a cached object
+ * @return true: `obj` is above; false: `obj` is below, a child or a parent of `layer_obj`
+ */
+static bool obj_is_above(const lv_obj_t * obj, const lv_obj_t * layer_obj)
+{
+    const lv_obj_t * obj_scr   = lv_obj_get_screen(obj);
+    const lv_obj_t * layer_scr = lv_obj_get_screen(layer_obj);
+    if(obj_scr != layer_scr) {
+        /*The top layer is drawn after the screen and the system layer after both*/
+        lv_disp_t * disp = lv_obj_get_disp(layer_scr);
+        if(obj_scr == lv_disp_get_layer_sys(disp)) return true;
+        if(obj_scr == lv_disp_get_layer_top(disp)) return layer_scr != lv_disp_get_layer_sys(disp);
+        return false;
+    }
+
+    uint16_t obj_depth   = 0;
+    uint16_t layer_depth = 0;
+    const lv_obj_t * o;
+    for(o = obj; o != obj_scr; o = lv_obj_get_parent(o)) obj_depth++;
+    for(o = layer_obj; o != layer_scr; o = lv_obj_get_parent(o)) layer_depth++;
+
+    /*Go up to the same level. If they meet one is the parent of the other.*/
+    const lv_obj_t * l = layer_obj;
+    o                  = obj;
+    for(; obj_depth > layer_depth; obj_depth--) o = lv_obj_get_parent(o);
+    for(; layer_depth > obj_depth; layer_depth--) l = lv_obj_get_parent(l);
+    if(o == l) return false;
+
+    /*Go up to the children of the common parent*/
+    while(lv_obj_get_parent(o) != lv_obj_get_parent(l)) {
+        o = lv_obj_get_parent(o);
+        l = lv_obj_get_parent(l);
+    }
+
+    /*The child list starts with the top most child*/
+    const lv_obj_t * par = lv_obj_get_parent(o);
+    lv_obj_t * i;
+    LV_LL_READ(par->child_ll, i)
+    {
+        if(i == o) return true;
+        if(i == l) return false;
+    }
+
+    return false;
+}
+
+/**
+ * Check if an object is a child (or a grandchild etc.) of a cached object
+ * @param obj pointer to an object
+ * @param layer_obj pointer to a cached object
+ * @return true: `obj` is drawn with `layer_obj`'s children
+ */
+static bool obj_is_child(const lv_obj_t * obj, const lv_obj_t * layer_obj)
+{
+    const lv_obj_t * par;
+    for(par = lv_obj_get_parent(obj); par != NULL; par = lv_obj_get_parent(par)) {
+        if(par == layer_obj) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Redraw the stale areas of the backdrops whose bitmap is older than `LV_LAYER_BACKDROP_PERIOD` ms
+ * @param task pointer to `backdrop_task`
+ */
+static void backdrop_task_cb(lv_task_t * task)
+{
+    (void)task; /*Unused*/
+
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        lv_layer_t * layer = &layers[i];
+        if(layer->obj == NULL || layer->stale == 0) continue;
+        if(lv_tick_elaps(layer->draw_tick) < LV_LAYER_BACKDROP_PERIOD) continue;
+
+        /*Invalidated by "unknown": the bitmap is drawn again in the next refresh*/
+        layer->stale = 0;
+        lv_inv_area(lv_obj_get_disp(layer->obj), &layer->stale_area);
+    }
+
+    backdrop_task_sched();
+}
+
+/**
+ * Run `backdrop_task` when the oldest bitmap of the stale backdrops gets `LV_LAYER_BACKDROP_PERIOD` ms old,
+ * or pause it if no backdrop is stale
+ */
+static void backdrop_task_sched(void)
+{
+    uint32_t wait = UINT32_MAX;
+    uint8_t i;
+    for(i = 0; i < LV_LAYER_CACHE_SLOTS; i++) {
+        lv_layer_t * layer = &layers[i];
+        if(layer->obj == NULL || layer->stale == 0) continue;
+
+        uint32_t elaps = lv_tick_elaps(layer->draw_tick);
+        uint32_t w     = elaps < LV_LAYER_BACKDROP_PERIOD ? LV_LAYER_BACKDROP_PERIOD - elaps : 0;
+        if(w < wait) wait = w;
+    }
+
+    if(wait == UINT32_MAX) {
+        lv_task_pause(backdrop_task);
+        return;
+    }
+
+    lv_task_set_period(backdrop_task, wait);
+    lv_task_reset(backdrop_task);
+    lv_task_resume(backdrop_task);
+}
+
+#endif /*LV_USE_LAYER_CACHE*/
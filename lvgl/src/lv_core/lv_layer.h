@@ -0,0 +1,147 @@
+/**
+ * @file lv_layer.h
+ *
+ */
+
+#ifndef LV_LAYER_H
+#define LV_LAYER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include "lv_obj.h"
+
+#if LV_USE_LAYER_CACHE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/** What the bitmap of a cached object has*/
+enum {
+    LV_LAYER_MODE_ALL,      /**< The object with its children (see `lv_obj_set_layer_cache`)*/
+    LV_LAYER_MODE_BACKDROP, /**< The object without its children (see `lv_obj_set_layer_backdrop`)*/
+    LV_LAYER_MODE_STATIC,   /**< The static part of the object (see `lv_obj_set_layer_static`)*/
+};
+typedef uint8_t lv_layer_mode_t;
+
+typedef struct
+{
+    uint32_t render_cnt; /**< Bitmaps drawn (again)*/
+    uint32_t blit_px;    /**< Pixels copied from the bitmaps instead of drawing the objects*/
+    uint32_t evict_cnt;  /**< Bitmaps dropped to stay in `LV_LAYER_CACHE_BUDGET`*/
+    uint32_t defer_px;   /**< Invalidated pixels under the backdrops which were not redrawn right away*/
+    uint32_t used_size;  /**< Bytes of the bitmaps now*/
+    uint8_t layer_cnt;   /**< Objects with `lv_obj_set_layer_cache` now*/
+} lv_layer_stat_t;
+
+/**
+ * Draw the screen on `area` into `buf` up to and including `obj` and its children (nothing above them)
+ * @param obj pointer to a cached object
+ * @param buf `lv_area_get_size(area)` pixels
+ * @param area the area of the bitmap on the display
+ */
+typedef void (*lv_layer_render_cb_t)(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Init the layer cache of the active context. Called by `lv_context_init`.
+ */
+void lv_layer_init(void);
+
+/**
+ * Start caching an object. Called by `lv_obj_set_layer_cache`, `lv_obj_set_layer_backdrop`
+ * and `lv_obj_set_layer_static`.
+ * @param obj pointer to an object
+ * @param mode what the bitmap has, an element of `lv_layer_mode_t`
+ * @return true: ok; false: all the `LV_LAYER_CACHE_SLOTS` are used
+ */
+bool lv_layer_add(lv_obj_t * obj, lv_layer_mode_t mode);
+
+/**
+ * Stop caching an object and free its bitmap. Called by `lv_obj_set_layer_cache` and when the object is deleted.
+ * @param obj pointer to an object
+ */
+void lv_layer_remove(const lv_obj_t * obj);
+
+/**
+ * Mark the bitmaps outdated which can be changed by an invalidated area. Called by `lv_inv_area_by`.
+ * @param area_p the invalidated area on the display
+ * @param obj the object which invalidated it. The bitmaps of the cached objects below it stay valid.
+ * NULL if unknown.
+ * @return true: redraw the area; false: it's under a backdrop whose bitmap is shown instead,
+ * the area is redrawn at most `LV_LAYER_BACKDROP_PERIOD` ms after the backdrop was drawn
+ */
+bool lv_layer_inv(const lv_area_t * area_p, const lv_obj_t * obj);
+
+/**
+ * Mark the bitmap of an object outdated. Unlike `lv_layer_inv` it's drawn again in the next refresh
+ * even if the object was changed in the last period. Called by `lv_obj_outdate_layer`.
+ * @param obj pointer to a cached object
+ */
+void lv_layer_outdate(const lv_obj_t * obj);
+
+/**
+ * Draw the outdated bitmaps which will be copied in this refresh. Called by the refresh before drawing.
+ * A bitmap is drawn only if its object wasn't invalidated in the last period, so a changing object is drawn
+ * as usual and gets its bitmap once it's static again. The bitmaps of the backdrops are drawn right away.
+ * @param disp pointer to the display being refreshed (its invalidated areas are joined already)
+ * @param render_cb draws the bitmaps
+ */
+void lv_layer_refr(lv_disp_t * disp, lv_layer_render_cb_t render_cb);
+
+/**
+ * Check if an object can be drawn from its bitmap on an area
+ * @param obj pointer to a cached object
+ * @param area_p an area on the display
+ * @return true: the bitmap is valid and covers the area
+ */
+bool lv_layer_is_valid(const lv_obj_t * obj, const lv_area_t * area_p);
+
+/**
+ * Copy the bitmap of an object to the VDB. Thread safe, called by the drawing threads.
+ * @param obj pointer to a cached object
+ * @param mask_p draw only here
+ * @return true: drawn; false: the object has to be drawn as usual
+ */
+bool lv_layer_draw(const lv_obj_t * obj, const lv_area_t * mask_p);
+
+/**
+ * Get the statistics of the layer cache
+ * @param stat_p the statistics are copied here
+ * @param reset true: zero the counters after copying them
+ */
+void lv_layer_get_stat(lv_layer_stat_t * stat_p, bool reset);
+
+/**
+ * Drops the least recently copied bitmaps of the active context if the memory is low (see `lv_mem_shrinker_add`)
+ */
+extern const lv_mem_shrinker_t lv_layer_shrinker;
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_LAYER_CACHE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_LAYER_H*/
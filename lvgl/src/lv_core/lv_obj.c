@@ -11,11 +11,17 @@
 #include "lv_refr.h"
 #include "lv_group.h"
 #include "lv_disp.h"
+#include "lv_hit.h"
+#include "lv_layer.h"
+#include "lv_prof.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_draw/lv_draw.h"
 #include "../lv_misc/lv_anim.h"
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_fs.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_misc/lv_async.h"
+#include "../lv_font/lv_font_bin.h"
 #include "../lv_hal/lv_hal.h"
 #include <stdint.h>
 #include <string.h>
@@ -31,9 +37,27 @@
 #define LV_OBJ_DEF_WIDTH (LV_DPI)
 #define LV_OBJ_DEF_HEIGHT (2 * LV_DPI / 3)
 
+/*Displays whose invalidated areas are collected in a batch. Others are invalidated immediately.*/
+#define LV_OBJ_BATCH_DISP_MAX 4
+
+/*Rounds of `lv_obj_layout_flush`. A round refreshes what the previous one marked, e.g. the children
+ *filling a parent which got a new size. More is surely a layout oscillating between two states.*/
+#define LV_OBJ_LAYOUT_ROUND_MAX 16
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    lv_disp_t * disp;
+    lv_area_t area; /*Union of the areas invalidated in the batch*/
+} lv_obj_batch_inv_t;
+
+typedef struct
+{
+    lv_obj_t * obj; /*NULL if deleted meanwhile*/
+    uint16_t depth; /*Number of parents*/
+} lv_obj_layout_entry_t;
 typedef struct _lv_event_temp_data
 {
     lv_obj_t * obj;
@@ -41,6 +65,26 @@ typedef struct _lv_event_temp_data
     struct _lv_event_temp_data * prev;
 } lv_event_temp_data_t;
 
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    lv_event_temp_data_t * event_temp_data_head;
+    const void * event_act_data;
+    uint16_t batch_depth;
+    lv_obj_layout_entry_t * layout_queue; /*The marked objects, grows with `lv_mem_realloc`*/
+    uint32_t layout_cnt;
+    uint32_t layout_size;
+    bool layout_flushing;
+    lv_obj_layout_stats_t layout_stats;
+    bool batch_realign_pending;
+    lv_obj_batch_inv_t batch_inv[LV_OBJ_BATCH_DISP_MAX];
+    uint32_t layout_gen; /*Incremented when an object is moved or resized*/
+    uint8_t batch_inv_cnt;
+#if LV_USE_STYLE_INDEX
+    lv_obj_t * style_index[LV_STYLE_INDEX_BUCKETS]; /*Objects by the hash of `style_p`*/
+#endif
+} lv_obj_state_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -51,13 +95,55 @@ static void delete_children(lv_obj_t * obj);
 static void lv_event_mark_deleted(lv_obj_t * obj);
 static bool lv_obj_design(lv_obj_t * obj, const lv_area_t * mask_p, lv_design_mode_t mode);
 static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param);
+static bool batch_inv_area(lv_disp_t * disp, const lv_area_t * area);
+static void layout_round(void);
+static void layout_resolve(const lv_obj_t * obj);
+static void layout_forget(lv_obj_t * obj);
+static void batch_realign(lv_obj_t * obj);
+#if LV_USE_STYLE_INDEX
+static uint32_t style_index_hash(const lv_style_t * style);
+static void style_index_add(lv_obj_t * obj);
+static void style_index_remove(lv_obj_t * obj);
+static void style_index_report(const lv_style_t * style);
+#endif
+static void child_attach(lv_obj_t * par, lv_obj_t * obj);
+static void child_detach(lv_obj_t * par, lv_obj_t * obj);
+#if LV_USE_OBJ_CLIP_CACHE
+static bool clip_refresh(lv_obj_t * obj);
+#endif
+#if LV_USE_OBJ_CHILD_ARRAY
+static void child_arr_build(lv_obj_t * obj);
+static uint16_t child_arr_find(const lv_obj_t * par, const lv_obj_t * obj);
+#endif
+#if LV_USE_OBJ_LAZY
+static void lazy_release(lv_obj_t * obj);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static bool lv_initialized = false;
-static lv_event_temp_data_t * event_temp_data_head;
-static const void * event_act_data;
+#if LV_USE_CONTEXT
+#define obj_st ((lv_obj_state_t *)lv_context_act->obj_state)
+#else
+static lv_obj_state_t obj_state;
+#define obj_st (&obj_state)
+#endif
+#define event_temp_data_head (obj_st->event_temp_data_head)
+#define event_act_data (obj_st->event_act_data)
+#define batch_depth (obj_st->batch_depth)
+#define layout_queue (obj_st->layout_queue)
+#define layout_cnt (obj_st->layout_cnt)
+#define layout_size (obj_st->layout_size)
+#define layout_flushing (obj_st->layout_flushing)
+#define layout_stats (obj_st->layout_stats)
+#define batch_realign_pending (obj_st->batch_realign_pending)
+#define batch_inv (obj_st->batch_inv)
+#define layout_gen (obj_st->layout_gen)
+#define batch_inv_cnt (obj_st->batch_inv_cnt)
+#if LV_USE_STYLE_INDEX
+#define style_index (obj_st->style_index)
+#endif
 
 /**********************
  *      MACROS
@@ -81,13 +167,66 @@ void lv_init(void)
     LV_LOG_TRACE("lv_init started");
 
     /*Initialize the lv_misc modules*/
+#if LV_REFR_THREADS > 1
+    lv_thread_init();
+#endif
     lv_mem_init();
-    lv_task_core_init();
+
+    /*The displays, objects, tasks etc. of the default context*/
+    lv_context_init();
+
+#if LV_ASYNC_QUEUE_SIZE
+    lv_async_init();
+#endif
+
+#if LV_USE_LOG && LV_LOG_ASYNC_SIZE
+    lv_log_async_init();
+#endif
 
 #if LV_USE_FILESYSTEM
     lv_fs_init();
 #endif
 
+    /*Init. the sstyles*/
+    lv_style_init();
+
+    lv_img_decoder_init();
+    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+
+    /*The caches give back memory if an allocation fails or they exceed `LV_MEM_CACHE_BUDGET`*/
+    lv_mem_shrinker_add(&lv_img_cache_shrinker);
+#if LV_GLYPH_CACHE_SIZE
+    lv_mem_shrinker_add(&lv_draw_letter_cache_shrinker);
+#endif
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+    lv_mem_shrinker_add(&lv_draw_shadow_cache_shrinker);
+#endif
+#if LV_USE_LAYER_CACHE
+    lv_mem_shrinker_add(&lv_layer_shrinker);
+#endif
+#if LV_USE_FONT_BIN
+    lv_mem_shrinker_add(&lv_font_bin_cache_shrinker);
+#endif
+
+#if LV_USE_SIMD
+    lv_draw_simd_init();
+#endif
+
+    lv_initialized = true;
+    LV_LOG_INFO("lv_init ready");
+}
+
+/**
+ * Initialize the modules in the active context. Called by `lv_init` and `lv_context_create`.
+ */
+void lv_context_init(void)
+{
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->obj_state, sizeof(lv_obj_state_t));
+#endif
+
+    lv_task_core_init();
+
 #if LV_USE_ANIMATION
     lv_anim_core_init();
 #endif
@@ -96,24 +235,71 @@ void lv_init(void)
     lv_group_init();
 #endif
 
-    /*Init. the sstyles*/
-    lv_style_init();
-
     /*Initialize the screen refresh system*/
     lv_refr_init();
 
+#if LV_USE_LAYER_CACHE
+    lv_layer_init();
+#endif
+
+#if LV_USE_HIT_INDEX
+    lv_hit_init();
+#endif
+
+#if LV_USE_PROF
+    lv_prof_init();
+#endif
+
     lv_ll_init(&LV_GC_ROOT(_lv_disp_ll), sizeof(lv_disp_t));
     lv_ll_init(&LV_GC_ROOT(_lv_indev_ll), sizeof(lv_indev_t));
 
     /*Init the input device handling*/
     lv_indev_init();
+}
 
-    lv_img_decoder_init();
-    lv_img_cache_set_size(LV_IMG_CACHE_DEF_SIZE);
+#if LV_USE_CONTEXT
+/**
+ * Delete the displays, groups, input devices, animations and tasks of the active context
+ * and free the state of the modules. Called by `lv_context_del`.
+ */
+void lv_context_deinit(void)
+{
+    /*The objects first, they delete their animations, groups, layers etc.*/
+    lv_disp_t * disp;
+    while((disp = lv_disp_get_next(NULL)) != NULL) {
+        lv_obj_t * scr;
+        while((scr = lv_ll_get_head(&disp->scr_ll)) != NULL) lv_obj_del(scr);
+        if(disp->refr_task) lv_task_del(disp->refr_task);
+        lv_disp_remove(disp);
+    }
 
-    lv_initialized = true;
-    LV_LOG_INFO("lv_init ready");
+#if LV_USE_GROUP
+    lv_group_t * group;
+    while((group = lv_ll_get_head(&LV_GC_ROOT(_lv_group_ll))) != NULL) lv_group_del(group);
+#endif
+
+    lv_ll_clear(&LV_GC_ROOT(_lv_indev_ll));
+#if LV_USE_ANIMATION
+    lv_ll_clear(&LV_GC_ROOT(_lv_anim_ll));
+#endif
+
+    /*The tasks of the input devices, the animations etc.*/
+    lv_task_t * task;
+    while((task = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll))) != NULL) lv_task_del(task);
+    lv_task_core_deinit();
+
+    lv_mem_free(layout_queue);
+
+    void ** states[] = {&lv_context_act->obj_state,   &lv_context_act->refr_state,  &lv_context_act->task_state,
+                        &lv_context_act->anim_state,  &lv_context_act->layer_state, &lv_context_act->hit_state,
+                        &lv_context_act->prof_state};
+    uint8_t i;
+    for(i = 0; i < sizeof(states) / sizeof(states[0]); i++) {
+        lv_mem_free(*states[i]);
+        *states[i] = NULL;
+    }
 }
+#endif
 
 /*--------------------
  * Create and delete
@@ -139,12 +325,19 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
             return NULL;
         }
 
-        new_obj = lv_ll_ins_head(&disp->scr_ll);
+        lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_OBJ);
+        new_obj               = lv_ll_ins_head(&disp->scr_ll);
+        lv_mem_tag_set(tag_prev);
         lv_mem_assert(new_obj);
         if(new_obj == NULL) return NULL;
 
         new_obj->par = NULL; /*Screens has no a parent*/
-        lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
+        lv_ll_init_pool(&(new_obj->child_ll), sizeof(lv_obj_t));
+        new_obj->child_cnt = 0;
+#if LV_USE_OBJ_CHILD_ARRAY
+        new_obj->child_arr      = NULL;
+        new_obj->child_arr_size = 0;
+#endif
 
         /*Set coordinates to full screen size*/
         new_obj->coords.x1    = 0;
@@ -171,6 +364,13 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->realign.auto_realign = 0;
 #endif
 
+#if LV_USE_OBJ_LAZY
+        new_obj->lazy_cb      = NULL;
+        new_obj->lazy_keep    = 0;
+        new_obj->lazy_built   = 0;
+        new_obj->lazy_release = 0;
+#endif
+
         /*Set the default styles*/
         lv_theme_t * th = lv_theme_get_current();
         if(th) {
@@ -192,17 +392,25 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->group_p = NULL;
 #endif
         /*Set attributes*/
-        new_obj->click        = 0;
-        new_obj->drag         = 0;
-        new_obj->drag_throw   = 0;
-        new_obj->drag_parent  = 0;
-        new_obj->hidden       = 0;
-        new_obj->top          = 0;
-        new_obj->protect      = LV_PROTECT_NONE;
-        new_obj->opa_scale_en = 0;
-        new_obj->opa_scale    = LV_OPA_COVER;
-        new_obj->parent_event = 0;
-        new_obj->reserved     = 0;
+        new_obj->click           = 0;
+        new_obj->drag            = 0;
+        new_obj->drag_throw      = 0;
+        new_obj->drag_parent     = 0;
+        new_obj->hidden          = 0;
+        new_obj->top             = 0;
+        new_obj->protect         = LV_PROTECT_NONE;
+        new_obj->opa_scale_en    = 0;
+        new_obj->opa_scale       = LV_OPA_COVER;
+        new_obj->parent_event    = 0;
+        new_obj->scroll_blit     = 0;
+        new_obj->cord_signal     = LV_OBJ_CORD_SIGNAL_NONE;
+        new_obj->layer_cache     = 0;
+        new_obj->layer_backdrop  = 0;
+        new_obj->layer_static    = 0;
+        new_obj->clip_ok         = 0;
+#if LV_USE_CHILD_BOUNDS
+        new_obj->child_bounds_ok = 0;
+#endif
 
         new_obj->ext_attr = NULL;
 
@@ -212,12 +420,20 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
     else {
         LV_LOG_TRACE("Object create started");
 
-        new_obj = lv_ll_ins_head(&parent->child_ll);
+        lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_OBJ);
+        new_obj               = lv_ll_ins_head(&parent->child_ll);
+        lv_mem_tag_set(tag_prev);
         lv_mem_assert(new_obj);
         if(new_obj == NULL) return NULL;
 
         new_obj->par = parent; /*Set the parent*/
-        lv_ll_init(&(new_obj->child_ll), sizeof(lv_obj_t));
+        lv_ll_init_pool(&(new_obj->child_ll), sizeof(lv_obj_t));
+        new_obj->child_cnt = 0;
+#if LV_USE_OBJ_CHILD_ARRAY
+        new_obj->child_arr      = NULL;
+        new_obj->child_arr_size = 0;
+#endif
+        child_attach(parent, new_obj);
 
         /*Set coordinates left top corner of parent*/
         new_obj->coords.x1    = parent->coords.x1;
@@ -243,6 +459,13 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->realign.base         = NULL;
         new_obj->realign.auto_realign = 0;
 #endif
+
+#if LV_USE_OBJ_LAZY
+        new_obj->lazy_cb      = NULL;
+        new_obj->lazy_keep    = 0;
+        new_obj->lazy_built   = 0;
+        new_obj->lazy_release = 0;
+#endif
         /*Set appearance*/
         lv_theme_t * th = lv_theme_get_current();
         if(th) {
@@ -275,17 +498,26 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
 #endif
 
         /*Set attributes*/
-        new_obj->click        = 1;
-        new_obj->drag         = 0;
-        new_obj->drag_dir     = LV_DRAG_DIR_ALL;
-        new_obj->drag_throw   = 0;
-        new_obj->drag_parent  = 0;
-        new_obj->hidden       = 0;
-        new_obj->top          = 0;
-        new_obj->protect      = LV_PROTECT_NONE;
-        new_obj->opa_scale    = LV_OPA_COVER;
-        new_obj->opa_scale_en = 0;
-        new_obj->parent_event = 0;
+        new_obj->click           = 1;
+        new_obj->drag            = 0;
+        new_obj->drag_dir        = LV_DRAG_DIR_ALL;
+        new_obj->drag_throw      = 0;
+        new_obj->drag_parent     = 0;
+        new_obj->hidden          = 0;
+        new_obj->top             = 0;
+        new_obj->protect         = LV_PROTECT_NONE;
+        new_obj->opa_scale       = LV_OPA_COVER;
+        new_obj->opa_scale_en    = 0;
+        new_obj->parent_event    = 0;
+        new_obj->scroll_blit     = 0;
+        new_obj->cord_signal     = LV_OBJ_CORD_SIGNAL_NONE;
+        new_obj->layer_cache     = 0;
+        new_obj->layer_backdrop  = 0;
+        new_obj->layer_static    = 0;
+        new_obj->clip_ok         = 0;
+#if LV_USE_CHILD_BOUNDS
+        new_obj->child_bounds_ok = 0;
+#endif
 
         new_obj->ext_attr = NULL;
     }
@@ -330,6 +562,7 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         new_obj->hidden       = copy->hidden;
         new_obj->top          = copy->top;
         new_obj->parent_event = copy->parent_event;
+        new_obj->cord_signal  = copy->cord_signal;
 
         new_obj->opa_scale_en = copy->opa_scale_en;
         new_obj->protect      = copy->protect;
@@ -354,8 +587,18 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy)
         LV_LOG_INFO("Object create ready");
     }
 
+    new_obj->batch_layout  = 0;
+    new_obj->batch_realign = 0;
+
+#if LV_USE_STYLE_INDEX
+    new_obj->style_pprev = NULL;
+    style_index_add(new_obj);
+#endif
+
     /*Send a signal to the parent to notify it about the new child*/
     if(parent != NULL) {
+        lv_hit_invalidate(parent);
+        lv_obj_outdate_child_bounds(parent);
         parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, new_obj);
 
         /*Invalidate the area if not screen created*/
@@ -407,12 +650,15 @@ lv_res_t lv_obj_del(lv_obj_t * obj)
 
     /*Remove the object from parent's children list*/
     lv_obj_t * par = lv_obj_get_parent(obj);
+    lv_ll_t * ll;
     if(par == NULL) { /*It is a screen*/
         lv_disp_t * d = lv_obj_get_disp(obj);
-        lv_ll_rem(&d->scr_ll, obj);
+        ll            = &d->scr_ll;
     } else {
-        lv_ll_rem(&(par->child_ll), obj);
+        child_detach(par, obj);
+        ll = &(par->child_ll);
     }
+    lv_ll_rem(ll, obj);
 
     /* Reset all input devices if the object to delete is used*/
     lv_indev_t * indev = lv_indev_get_next(NULL);
@@ -436,12 +682,27 @@ lv_res_t lv_obj_del(lv_obj_t * obj)
      * Now clean up the object specific data*/
     obj->signal_cb(obj, LV_SIGNAL_CLEANUP, NULL);
 
+    /*Drop the index of the children*/
+    lv_hit_remove(obj);
+#if LV_USE_STYLE_INDEX
+    style_index_remove(obj);
+#endif
+#if LV_USE_LAYER_CACHE
+    if(obj->layer_cache) lv_layer_remove(obj);
+#endif
+#if LV_USE_OBJ_CHILD_ARRAY
+    if(obj->child_arr) lv_mem_free(obj->child_arr);
+#endif
+    if(obj->batch_layout) layout_forget(obj);
+
     /*Delete the base objects*/
     if(obj->ext_attr != NULL) lv_mem_free(obj->ext_attr);
-    lv_mem_free(obj); /*Free the object itself*/
+    lv_ll_free(ll, obj); /*Free the object itself*/
 
     /*Send a signal to the parent to notify it about the child delete*/
     if(par != NULL) {
+        lv_hit_invalidate(par);
+        lv_obj_outdate_child_bounds(par);
         par->signal_cb(par, LV_SIGNAL_CHILD_CHG, NULL);
     }
 
@@ -449,20 +710,31 @@ lv_res_t lv_obj_del(lv_obj_t * obj)
 }
 
 /**
- * Delete all children of an object
+ * Delete all children of an object.
+ * The object is invalidated and gets `LV_SIGNAL_CHILD_CHG` only once for all the children.
  * @param obj pointer to an object
  */
 void lv_obj_clean(lv_obj_t * obj)
 {
-    lv_obj_t * child = lv_obj_get_child(obj, NULL);
+    lv_obj_t * child = lv_ll_get_head(&(obj->child_ll));
+    if(child == NULL) return;
+
+    /*The children are drawn only on the object so invalidate it once instead of every child*/
+    lv_obj_invalidate(obj);
+
     lv_obj_t * child_next;
     while(child) {
         /* Read the next child before deleting the current
          * because the next couldn't be read from a deleted (invalid) node*/
-        child_next = lv_obj_get_child(obj, child);
-        lv_obj_del(child);
+        child_next = lv_ll_get_next(&(obj->child_ll), child);
+        delete_children(child);
         child = child_next;
     }
+
+    /*Notify the object only once instead of after every child (e.g. to arrange its layout once)*/
+    lv_hit_invalidate(obj);
+    lv_obj_outdate_child_bounds(obj);
+    obj->signal_cb(obj, LV_SIGNAL_CHILD_CHG, NULL);
 }
 
 /**
@@ -470,25 +742,48 @@ void lv_obj_clean(lv_obj_t * obj)
  * @param obj pointer to an object
  */
 void lv_obj_invalidate(const lv_obj_t * obj)
+{
+    /*Start with the original coordinates*/
+    lv_coord_t ext_size = obj->ext_draw_pad;
+    lv_area_t area;
+    lv_area_copy(&area, &obj->coords);
+    area.x1 -= ext_size;
+    area.y1 -= ext_size;
+    area.x2 += ext_size;
+    area.y2 += ext_size;
+
+    lv_obj_invalidate_area(obj, &area);
+}
+
+/**
+ * Mark a part of an object as invalid therefore it will be redrawn by 'lv_refr_task'
+ * @param obj pointer to an object
+ * @param area the area to redraw in absolute coordinates. It's truncated to the parents.
+ */
+void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area)
 {
     if(lv_obj_get_hidden(obj)) return;
 
-    /*Invalidate the object only if it belongs to the 'LV_GC_ROOT(_lv_act_scr)'*/
+#if LV_USE_OBJ_CLIP_CACHE
+    /*The area of the parents and the screen are cached, so the parents are visited only after they changed*/
+    if(clip_refresh((lv_obj_t *)obj) == false) return;
+    lv_obj_t * obj_scr = obj->clip_scr;
+#else
     lv_obj_t * obj_scr = lv_obj_get_screen(obj);
-    lv_disp_t * disp   = lv_obj_get_disp(obj_scr);
+#endif
+
+    /*Invalidate the object only if it belongs to the 'LV_GC_ROOT(_lv_act_scr)'*/
+    lv_disp_t * disp = lv_obj_get_disp(obj_scr);
     if(obj_scr == lv_disp_get_scr_act(disp) || obj_scr == lv_disp_get_layer_top(disp) ||
        obj_scr == lv_disp_get_layer_sys(disp)) {
-        /*Truncate recursively to the parents*/
+        /*Truncate to the parents*/
         lv_area_t area_trunc;
+#if LV_USE_OBJ_CLIP_CACHE
+        bool union_ok = lv_area_intersect(&area_trunc, area, &obj->clip);
+#else
         lv_obj_t * par = lv_obj_get_parent(obj);
         bool union_ok  = true;
-        /*Start with the original coordinates*/
-        lv_coord_t ext_size = obj->ext_draw_pad;
-        lv_area_copy(&area_trunc, &obj->coords);
-        area_trunc.x1 -= ext_size;
-        area_trunc.y1 -= ext_size;
-        area_trunc.x2 += ext_size;
-        area_trunc.y2 += ext_size;
+        lv_area_copy(&area_trunc, area);
 
         /*Check through all parents*/
         while(par != NULL) {
@@ -498,11 +793,163 @@ void lv_obj_invalidate(const lv_obj_t * obj)
 
             par = lv_obj_get_parent(par);
         }
+#endif
+
+        if(union_ok) {
+            /*The joined areas of a batch are invalidated by the commit for no object (see `lv_inv_area`)*/
+            if(batch_depth == 0 || batch_inv_area(disp, &area_trunc) == false) lv_inv_area_by(disp, &area_trunc, obj);
+        }
+    }
+}
+
+/**
+ * Start a batch of changes (e.g. creating or restyling a lot of objects).
+ * Until `lv_obj_batch_commit` the invalidated areas are only collected and
+ * the realigns and container layouts are deferred. Batches can be nested.
+ */
+void lv_obj_batch_begin(void)
+{
+    batch_depth++;
+}
+
+/**
+ * End a batch. The outermost commit refreshes the deferred layouts (the children first),
+ * does the deferred realigns and invalidates the union of the collected areas on every display.
+ */
+void lv_obj_batch_commit(void)
+{
+    if(batch_depth == 0) {
+        LV_LOG_WARN("lv_obj_batch_commit: no batch to commit");
+        return;
+    }
+
+    batch_depth--;
+    if(batch_depth != 0) return;
+
+    lv_disp_t * d;
+    lv_obj_t * scr;
+
+    /*The layouts change the size of the containers which can move the aligned objects*/
+    lv_obj_layout_flush();
+
+#if LV_USE_OBJ_REALIGN
+    if(batch_realign_pending) {
+        batch_realign_pending = false;
+        d                     = lv_disp_get_next(NULL);
+        while(d) {
+            LV_LL_READ(d->scr_ll, scr) batch_realign(scr);
+            if(d->top_layer) batch_realign(d->top_layer);
+            if(d->sys_layer) batch_realign(d->sys_layer);
+            d = lv_disp_get_next(d);
+        }
+    }
+#endif
+
+    uint8_t i;
+    for(i = 0; i < batch_inv_cnt; i++) {
+        lv_inv_area(batch_inv[i].disp, &batch_inv[i].area);
+    }
+    batch_inv_cnt = 0;
+}
+
+/**
+ * Tell whether a batch is in progress
+ * @return true: between `lv_obj_batch_begin` and `lv_obj_batch_commit`
+ */
+bool lv_obj_batch_is_active(void)
+{
+    return batch_depth != 0;
+}
+
+/**
+ * Tell whether the layouts are only marked now, e.g. in a batch or with `LV_USE_LAYOUT_DEFER`
+ * @return true: call `lv_obj_layout_defer` instead of refreshing a layout
+ */
+bool lv_obj_layout_is_deferred(void)
+{
+#if LV_USE_LAYOUT_DEFER
+    return true;
+#else
+    return batch_depth != 0 || layout_flushing;
+#endif
+}
+
+/**
+ * Send `LV_SIGNAL_REFR_LAYOUT` to an object later instead of refreshing its layout now.
+ * For object types arranging their children (e.g. containers).
+ * Marking an already marked object is free, the requests are merged into one refresh.
+ * @param obj pointer to an object
+ */
+void lv_obj_layout_defer(lv_obj_t * obj)
+{
+    layout_stats.requested++;
+    if(obj->batch_layout) return;
+
+    if(layout_cnt == layout_size) {
+        uint32_t size                 = layout_size == 0 ? 16 : layout_size * 2;
+        lv_mem_tag_t tag_prev         = lv_mem_tag_set(LV_MEM_TAG_LAYOUT);
+        lv_obj_layout_entry_t * queue = lv_mem_realloc(layout_queue, size * sizeof(lv_obj_layout_entry_t));
+        lv_mem_tag_set(tag_prev);
+        if(queue == NULL) {
+            /*Better slow than wrong*/
+            layout_stats.done++;
+            obj->signal_cb(obj, LV_SIGNAL_REFR_LAYOUT, NULL);
+            return;
+        }
+        layout_queue = queue;
+        layout_size  = size;
+    }
+
+    uint16_t depth = 0;
+    lv_obj_t * par = obj->par;
+    while(par) {
+        depth++;
+        par = par->par;
+    }
 
-        if(union_ok) lv_inv_area(disp, &area_trunc);
+    obj->batch_layout                = 1;
+    layout_queue[layout_cnt].obj   = obj;
+    layout_queue[layout_cnt].depth = depth;
+    layout_cnt++;
+}
+
+/**
+ * Refresh the deferred layouts now, the deepest objects first.
+ * Called before every refresh and input read, call it to read the new size of a container earlier.
+ * Does nothing in a batch.
+ */
+void lv_obj_layout_flush(void)
+{
+    if(layout_cnt == 0 || layout_flushing || batch_depth != 0) return;
+
+    /*The refreshes mark the parents (their child changed) and the children (their parent changed) again.
+     *Keep marking in the meantime, merging the requests of the parents is the point of the deferring.*/
+    layout_flushing = true;
+    uint8_t round;
+    for(round = 0; round < LV_OBJ_LAYOUT_ROUND_MAX && layout_cnt != 0; round++) {
+        layout_round();
+    }
+    layout_flushing = false;
+
+    if(layout_cnt != 0) {
+        LV_LOG_WARN("lv_obj_layout_flush: the layouts don't settle");
+        uint32_t i;
+        for(i = 0; i < layout_cnt; i++) {
+            if(layout_queue[i].obj) layout_queue[i].obj->batch_layout = 0;
+        }
+        layout_cnt = 0;
     }
 }
 
+/**
+ * Get how many layout refreshes were requested and how many were done
+ * @param stats the counters are copied here. `requested - done` refreshes were saved.
+ */
+void lv_obj_layout_get_stats(lv_obj_layout_stats_t * stats)
+{
+    *stats = layout_stats;
+}
+
 /*=====================
  * Setter functions
  *====================*/
@@ -536,14 +983,24 @@ void lv_obj_set_parent(lv_obj_t * obj, lv_obj_t * parent)
 
     lv_obj_t * old_par = obj->par;
 
+    child_detach(obj->par, obj);
     lv_ll_chg_list(&obj->par->child_ll, &parent->child_ll, obj, true);
     obj->par = parent;
+    child_attach(parent, obj);
+#if LV_USE_OBJ_CLIP_CACHE
+    obj->clip_ok = 0;
+#endif
+    lv_obj_outdate_clip(obj);
     lv_obj_set_pos(obj, old_pos.x, old_pos.y);
 
     /*Notify the original parent because one of its children is lost*/
+    lv_hit_invalidate(old_par);
+    lv_obj_outdate_child_bounds(old_par);
     old_par->signal_cb(old_par, LV_SIGNAL_CHILD_CHG, NULL);
 
     /*Notify the new parent about the child*/
+    lv_hit_invalidate(parent);
+    lv_obj_outdate_child_bounds(parent);
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
 
     lv_obj_invalidate(obj);
@@ -562,9 +1019,13 @@ void lv_obj_move_foreground(lv_obj_t * obj)
 
     lv_obj_invalidate(parent);
 
+    child_detach(parent, obj);
     lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, true);
+    child_attach(parent, obj);
 
     /*Notify the new parent about the child*/
+    lv_hit_invalidate(parent);
+    lv_obj_outdate_child_bounds(parent);
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
 
     lv_obj_invalidate(parent);
@@ -583,20 +1044,55 @@ void lv_obj_move_background(lv_obj_t * obj)
 
     lv_obj_invalidate(parent);
 
+    child_detach(parent, obj);
     lv_ll_chg_list(&parent->child_ll, &parent->child_ll, obj, false);
+    child_attach(parent, obj);
 
     /*Notify the new parent about the child*/
+    lv_hit_invalidate(parent);
+    lv_obj_outdate_child_bounds(parent);
     parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
 
     lv_obj_invalidate(parent);
 }
 
+/**
+ * Move an object right below one of its siblings, so it's drawn just before it
+ * @param obj pointer to an object
+ * @param above pointer to a sibling of `obj`
+ */
+void lv_obj_move_below(lv_obj_t * obj, lv_obj_t * above)
+{
+    lv_obj_t * parent = lv_obj_get_parent(obj);
+    if(obj == above || lv_obj_get_parent(above) != parent) return;
+
+    /*The children are drawn from the tail, so `obj` has to follow `above`*/
+    lv_obj_t * before = lv_ll_get_next(&parent->child_ll, above);
+    if(before == obj) return;
+
+    lv_obj_invalidate(obj);
+
+    child_detach(parent, obj);
+    lv_ll_move_before(&parent->child_ll, obj, before);
+    child_attach(parent, obj);
+
+    /*Notify the parent about the new order*/
+    lv_hit_invalidate(parent);
+    lv_obj_outdate_child_bounds(parent);
+    parent->signal_cb(parent, LV_SIGNAL_CHILD_CHG, obj);
+
+    lv_obj_invalidate(obj);
+}
+
 /*--------------------
  * Coordinate set
  * ------------------*/
 
 /**
- * Set relative the position of an object (relative to the parent)
+ * Set relative the position of an object (relative to the parent).
+ * Only the object (`LV_SIGNAL_CORD_CHG`) and its parent (`LV_SIGNAL_CHILD_CHG`) get a signal,
+ * the coordinates of the descendants are only shifted.
+ * With `LV_USE_OBJ_CORD_SIGNAL` the object gets the signal only if it asked for it (`LV_OBJ_CORD_SIGNAL_ALL`).
  * @param obj pointer to an object
  * @param x new distance from the left side of the parent
  * @param y new distance from the top of the parent
@@ -619,8 +1115,16 @@ void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
      * occur without position change*/
     if(diff.x == 0 && diff.y == 0) return;
 
+    /*The object might move its already drawn pixels instead of being redrawn (e.g. scrolling)*/
+    lv_signal_scroll_t scroll;
+    scroll.blit = false;
+    if(obj->scroll_blit) {
+        scroll.diff = diff;
+        obj->signal_cb(obj, LV_SIGNAL_SCROLL, &scroll);
+    }
+
     /*Invalidate the original area*/
-    lv_obj_invalidate(obj);
+    if(scroll.blit == false) lv_obj_invalidate(obj);
 
     /*Save the original coordinates*/
     lv_area_t ori;
@@ -630,17 +1134,24 @@ void lv_obj_set_pos(lv_obj_t * obj, lv_coord_t x, lv_coord_t y)
     obj->coords.y1 += diff.y;
     obj->coords.x2 += diff.x;
     obj->coords.y2 += diff.y;
+    layout_gen++;
 
     refresh_children_position(obj, diff.x, diff.y);
+    lv_obj_outdate_clip(obj);
 
     /*Inform the object about its new coordinates*/
+#if LV_USE_OBJ_CORD_SIGNAL
+    if(obj->cord_signal == LV_OBJ_CORD_SIGNAL_ALL)
+#endif
     obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
 
     /*Send a signal to the parent too*/
+    lv_hit_invalidate(par);
+    lv_obj_outdate_child_bounds(par);
     par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
 
     /*Invalidate the new area*/
-    lv_obj_invalidate(obj);
+    if(scroll.blit == false) lv_obj_invalidate(obj);
 }
 
 /**
@@ -689,13 +1200,22 @@ void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
     /*Set the length and height*/
     obj->coords.x2 = obj->coords.x1 + w - 1;
     obj->coords.y2 = obj->coords.y1 + h - 1;
+    layout_gen++;
+    lv_obj_outdate_clip(obj);
 
     /*Send a signal to the object with its new coordinates*/
+#if LV_USE_OBJ_CORD_SIGNAL
+    if(obj->cord_signal != LV_OBJ_CORD_SIGNAL_NONE)
+#endif
     obj->signal_cb(obj, LV_SIGNAL_CORD_CHG, &ori);
 
     /*Send a signal to the parent too*/
     lv_obj_t * par = lv_obj_get_parent(obj);
-    if(par != NULL) par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+    if(par != NULL) {
+        lv_hit_invalidate(par);
+        lv_obj_outdate_child_bounds(par);
+        par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+    }
 
     /*Tell the children the parent's size has changed*/
     lv_obj_t * i;
@@ -709,7 +1229,14 @@ void lv_obj_set_size(lv_obj_t * obj, lv_coord_t w, lv_coord_t h)
 
     /*Automatically realign the object if required*/
 #if LV_USE_OBJ_REALIGN
-    if(obj->realign.auto_realign) lv_obj_realign(obj);
+    if(obj->realign.auto_realign) {
+        if(batch_depth == 0) {
+            lv_obj_realign(obj);
+        } else {
+            obj->batch_realign    = 1;
+            batch_realign_pending = true;
+        }
+    }
 #endif
 }
 
@@ -743,6 +1270,9 @@ void lv_obj_set_height(lv_obj_t * obj, lv_coord_t h)
  */
 void lv_obj_align(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align, lv_coord_t x_mod, lv_coord_t y_mod)
 {
+    layout_resolve(obj);
+    if(base) layout_resolve(base);
+
     lv_coord_t new_x = lv_obj_get_x(obj);
     lv_coord_t new_y = lv_obj_get_y(obj);
 
@@ -888,6 +1418,9 @@ void lv_obj_align(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align, lv_co
  */
 void lv_obj_align_origo(lv_obj_t * obj, const lv_obj_t * base, lv_align_t align, lv_coord_t x_mod, lv_coord_t y_mod)
 {
+    layout_resolve(obj);
+    if(base) layout_resolve(base);
+
     lv_coord_t new_x = lv_obj_get_x(obj);
     lv_coord_t new_y = lv_obj_get_y(obj);
 
@@ -1071,6 +1604,10 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, uint8_t w, uint8_t h)
 {
     obj->ext_click_pad_hor = w;
     obj->ext_click_pad_ver = h;
+
+    lv_hit_invalidate(lv_obj_get_parent(obj));
+
+    lv_obj_outdate_child_bounds(lv_obj_get_parent(obj));
 }
 #endif
 
@@ -1091,9 +1628,13 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
     obj->ext_click_pad.x2 = right;
     obj->ext_click_pad.y1 = top;
     obj->ext_click_pad.y2 = bottom;
+    lv_hit_invalidate(lv_obj_get_parent(obj));
+    lv_obj_outdate_child_bounds(lv_obj_get_parent(obj));
 #elif LV_USE_EXT_CLICK_AREA == LV_EXT_CLICK_AREA_TINY
     obj->ext_click_pad_hor = LV_MATH_MAX(left, right);
     obj->ext_click_pad_ver = LV_MATH_MAX(top, bottom);
+    lv_hit_invalidate(lv_obj_get_parent(obj));
+    lv_obj_outdate_child_bounds(lv_obj_get_parent(obj));
 #else
     (void)obj;    /*Unused*/
     (void)left;   /*Unused*/
@@ -1114,7 +1655,13 @@ void lv_obj_set_ext_click_area(lv_obj_t * obj, lv_coord_t left, lv_coord_t right
  */
 void lv_obj_set_style(lv_obj_t * obj, const lv_style_t * style)
 {
+#if LV_USE_STYLE_INDEX
+    style_index_remove(obj);
+    obj->style_p = style;
+    style_index_add(obj);
+#else
     obj->style_p = style;
+#endif
 
     /*Send a signal about style change to every children with NULL style*/
     refresh_children_style(obj);
@@ -1141,6 +1688,13 @@ void lv_obj_refresh_style(lv_obj_t * obj)
  */
 void lv_obj_report_style_mod(lv_style_t * style)
 {
+#if LV_USE_STYLE_INDEX
+    if(style != NULL) {
+        style_index_report(style);
+        return;
+    }
+#endif
+
     lv_disp_t * d = lv_disp_get_next(NULL);
 
     while(d) {
@@ -1168,14 +1722,26 @@ void lv_obj_report_style_mod(lv_style_t * style)
  */
 void lv_obj_set_hidden(lv_obj_t * obj, bool en)
 {
+#if LV_USE_OBJ_LAZY
+    /*Create the lazy children before they are shown*/
+    if(en == false) lv_obj_lazy_build(obj);
+#endif
+
     if(!obj->hidden) lv_obj_invalidate(obj); /*Invalidate when not hidden (hidden objects are ignored) */
 
     obj->hidden = en == false ? 0 : 1;
+    lv_obj_outdate_clip(obj);
 
     if(!obj->hidden) lv_obj_invalidate(obj); /*Invalidate when not hidden (hidden objects are ignored) */
 
     lv_obj_t * par = lv_obj_get_parent(obj);
+    lv_hit_invalidate(par);
+    lv_obj_outdate_child_bounds(par);
     par->signal_cb(par, LV_SIGNAL_CHILD_CHG, obj);
+
+#if LV_USE_OBJ_LAZY
+    if(obj->hidden) lazy_release(obj);
+#endif
 }
 
 /**
@@ -1254,60 +1820,194 @@ void lv_obj_set_parent_event(lv_obj_t * obj, bool en)
 }
 
 /**
- * Set the opa scale enable parameter (required to set opa_scale with `lv_obj_set_opa_scale()`)
+ * Set which changes of the coordinates send `LV_SIGNAL_CORD_CHG` to an object.
+ * Only with `LV_USE_OBJ_CORD_SIGNAL`, else it's sent on every change.
+ * The object types handling the signal set it when they are created. Set it for a custom signal function too.
  * @param obj pointer to an object
- * @param en true: opa scaling is enabled for this object and all children; false: no opa scaling
+ * @param cord_signal `LV_OBJ_CORD_SIGNAL_NONE/SIZE/ALL`. The default of a new object is `NONE`.
  */
-void lv_obj_set_opa_scale_enable(lv_obj_t * obj, bool en)
+void lv_obj_set_cord_signal(lv_obj_t * obj, lv_obj_cord_signal_t cord_signal)
 {
-    obj->opa_scale_en = en ? 1 : 0;
+    obj->cord_signal = cord_signal;
 }
 
+#if LV_USE_LAYER_CACHE
 /**
- * Set the opa scale of an object
+ * Cache an object as a bitmap: its area is drawn once with its children and everything below it,
+ * and copied from the bitmap until the object, a child or something below it is invalidated.
+ * Useful for static windows which are redrawn because something above them changes.
+ * The bitmaps are dropped (and drawn again) if they don't fit into `LV_LAYER_CACHE_BUDGET`.
  * @param obj pointer to an object
- * @param opa_scale a factor to scale down opacity [0..255]
+ * @param en true: cache the object (if one of the `LV_LAYER_CACHE_SLOTS` is free)
  */
-void lv_obj_set_opa_scale(lv_obj_t * obj, lv_opa_t opa_scale)
+void lv_obj_set_layer_cache(lv_obj_t * obj, bool en)
 {
-    obj->opa_scale = opa_scale;
-    lv_obj_invalidate(obj);
+    if(en == (obj->layer_cache != 0) && obj->layer_backdrop == 0 && obj->layer_static == 0) return;
+
+    if(en) {
+        if(lv_layer_add(obj, LV_LAYER_MODE_ALL)) {
+            obj->layer_cache    = 1;
+            obj->layer_backdrop = 0;
+            obj->layer_static   = 0;
+        }
+    } else {
+        lv_layer_remove(obj);
+        obj->layer_cache    = 0;
+        obj->layer_backdrop = 0;
+        obj->layer_static   = 0;
+    }
 }
 
 /**
- * Set a bit or bits in the protect filed
+ * Cache an object as a modal backdrop, e.g. the semi-transparent full-screen parent of a message box.
+ * Its bitmap has the object (dimming what's below it) but not its children: they are drawn on the copied bitmap,
+ * so only they are redrawn while they change. The changes below the object are shown from time to time,
+ * when the bitmap is drawn again at most every `LV_LAYER_BACKDROP_PERIOD` ms.
  * @param obj pointer to an object
- * @param prot 'OR'-ed values from `lv_protect_t`
+ * @param en true: cache the object as a backdrop (if one of the `LV_LAYER_CACHE_SLOTS` is free);
+ * false: don't cache it
  */
-void lv_obj_set_protect(lv_obj_t * obj, uint8_t prot)
+void lv_obj_set_layer_backdrop(lv_obj_t * obj, bool en)
 {
-    obj->protect |= prot;
+    if(en == false) {
+        lv_obj_set_layer_cache(obj, false);
+        return;
+    }
+
+    if(obj->layer_backdrop) return;
+
+    if(lv_layer_add(obj, LV_LAYER_MODE_BACKDROP)) {
+        obj->layer_cache    = 1;
+        obj->layer_backdrop = 1;
+        obj->layer_static   = 0;
+    }
 }
 
 /**
- * Clear a bit or bits in the protect filed
+ * Cache the static part of an object, e.g. the background, division lines and axes of a chart.
+ * Its bitmap has what's below the object and the object drawn with `LV_DESIGN_DRAW_STATIC`.
+ * The refresh copies the bitmap, draws the object with `LV_DESIGN_DRAW_DYNAMIC` on it, then the children.
+ * The invalidations of the object and its children keep the bitmap: call `lv_obj_outdate_layer`
+ * when the static part changes. It's drawn again when the object is resized or moved too.
+ * Only for the objects whose design function has these modes (e.g. `lv_chart`).
  * @param obj pointer to an object
- * @param prot 'OR'-ed values from `lv_protect_t`
+ * @param en true: cache the static part (if one of the `LV_LAYER_CACHE_SLOTS` is free); false: don't cache it
  */
-void lv_obj_clear_protect(lv_obj_t * obj, uint8_t prot)
+void lv_obj_set_layer_static(lv_obj_t * obj, bool en)
 {
-    prot = (~prot) & 0xFF;
-    obj->protect &= prot;
+    if(en == false) {
+        lv_obj_set_layer_cache(obj, false);
+        return;
+    }
+
+    if(obj->layer_static) return;
+
+    if(lv_layer_add(obj, LV_LAYER_MODE_STATIC)) {
+        obj->layer_cache    = 1;
+        obj->layer_backdrop = 0;
+        obj->layer_static   = 1;
+    }
 }
 
 /**
- * Set a an event handler function for an object.
- * Used by the user to react on event which happens with the object.
+ * Draw the bitmap of a cached object again and redraw the object, e.g. because the static part changed
+ * (see `lv_obj_set_layer_static`)
  * @param obj pointer to an object
- * @param event_cb the new event function
  */
-void lv_obj_set_event_cb(lv_obj_t * obj, lv_event_cb_t event_cb)
+void lv_obj_outdate_layer(lv_obj_t * obj)
 {
-    obj->event_cb = event_cb;
+    if(obj->layer_cache) lv_layer_outdate(obj);
+    lv_obj_invalidate(obj);
 }
+#endif
 
+#if LV_USE_OBJ_LAZY
 /**
- * Send an event to the object
+ * Create the children of an object only when it's shown: by `lv_obj_set_hidden(obj, false)`, or by
+ * selecting its tab if it's a tab of a tab view. A shown object creates them at the next show or
+ * `lv_obj_lazy_build`. The children it has already are kept as they are.
+ * @param obj pointer to an object
+ * @param build_cb creates the children of `obj` (called once, or again after they were released)
+ * @param release true: delete the created children when `obj` is hidden while the free memory of `lv_mem`
+ * is below `LV_OBJ_LAZY_RELEASE_FREE`. Only for children without state to lose (e.g. no user changes).
+ */
+void lv_obj_set_lazy(lv_obj_t * obj, lv_obj_lazy_cb_t build_cb, bool release)
+{
+    obj->lazy_cb      = build_cb;
+    obj->lazy_built   = 0;
+    obj->lazy_release = release ? 1 : 0;
+}
+
+/**
+ * Create the lazy children of an object now if they weren't yet (see `lv_obj_set_lazy`)
+ * @param obj pointer to an object
+ */
+void lv_obj_lazy_build(lv_obj_t * obj)
+{
+    if(obj == NULL || obj->lazy_cb == NULL || obj->lazy_built) return;
+
+    /*Set first: the callback may show the object again*/
+    obj->lazy_built = 1;
+    obj->lazy_keep  = obj->child_cnt;
+    obj->lazy_cb(obj);
+}
+#endif
+
+/**
+ * Set the opa scale enable parameter (required to set opa_scale with `lv_obj_set_opa_scale()`)
+ * @param obj pointer to an object
+ * @param en true: opa scaling is enabled for this object and all children; false: no opa scaling
+ */
+void lv_obj_set_opa_scale_enable(lv_obj_t * obj, bool en)
+{
+    obj->opa_scale_en = en ? 1 : 0;
+}
+
+/**
+ * Set the opa scale of an object
+ * @param obj pointer to an object
+ * @param opa_scale a factor to scale down opacity [0..255]
+ */
+void lv_obj_set_opa_scale(lv_obj_t * obj, lv_opa_t opa_scale)
+{
+    obj->opa_scale = opa_scale;
+    lv_obj_invalidate(obj);
+}
+
+/**
+ * Set a bit or bits in the protect filed
+ * @param obj pointer to an object
+ * @param prot 'OR'-ed values from `lv_protect_t`
+ */
+void lv_obj_set_protect(lv_obj_t * obj, uint8_t prot)
+{
+    obj->protect |= prot;
+}
+
+/**
+ * Clear a bit or bits in the protect filed
+ * @param obj pointer to an object
+ * @param prot 'OR'-ed values from `lv_protect_t`
+ */
+void lv_obj_clear_protect(lv_obj_t * obj, uint8_t prot)
+{
+    prot = (~prot) & 0xFF;
+    obj->protect &= prot;
+}
+
+/**
+ * Set a an event handler function for an object.
+ * Used by the user to react on event which happens with the object.
+ * @param obj pointer to an object
+ * @param event_cb the new event function
+ */
+void lv_obj_set_event_cb(lv_obj_t * obj, lv_event_cb_t event_cb)
+{
+    obj->event_cb = event_cb;
+}
+
+/**
+ * Send an event to the object
  * @param obj pointer to an object
  * @param event the type of the event from `lv_event_t`
  * @param data arbitrary data depending on the object type and the event. (Usually `NULL`)
@@ -1433,7 +2133,9 @@ void lv_obj_set_design_cb(lv_obj_t * obj, lv_design_cb_t design_cb)
  */
 void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size)
 {
-    obj->ext_attr = lv_mem_realloc(obj->ext_attr, ext_size);
+    lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_EXT);
+    obj->ext_attr         = lv_mem_realloc(obj->ext_attr, ext_size);
+    lv_mem_tag_set(tag_prev);
 
     return (void *)obj->ext_attr;
 }
@@ -1446,10 +2148,44 @@ void lv_obj_refresh_ext_draw_pad(lv_obj_t * obj)
 {
     obj->ext_draw_pad = 0;
     obj->signal_cb(obj, LV_SIGNAL_REFR_EXT_DRAW_PAD, NULL);
+    lv_obj_outdate_child_bounds(lv_obj_get_parent(obj));
 
     lv_obj_invalidate(obj);
 }
 
+#if LV_USE_CHILD_BOUNDS
+/**
+ * Mark the bounding box of an object's children as outdated. Should be called when a child is added,
+ * removed, moved, resized or its extended draw or click area changes.
+ * @param par pointer to an object (the parent of the changed child) or NULL
+ */
+void lv_obj_outdate_child_bounds(lv_obj_t * par)
+{
+    /*It's updated only when it's needed*/
+    if(par) par->child_bounds_ok = 0;
+}
+#endif
+
+#if LV_USE_OBJ_CLIP_CACHE
+/**
+ * Mark the cached parent area of the descendants of an object as outdated.
+ * Should be called after modifying the coordinates of the object directly (not with `lv_obj_set_pos/size`).
+ * @param obj pointer to an object
+ */
+void lv_obj_outdate_clip(lv_obj_t * obj)
+{
+    lv_obj_t * i;
+    LV_LL_READ(obj->child_ll, i)
+    {
+        /*The descendants of an outdated child are outdated too (they are updated after their parents)*/
+        if(i->clip_ok) {
+            i->clip_ok = 0;
+            lv_obj_outdate_clip(i);
+        }
+    }
+}
+#endif
+
 /*=======================
  * Getter functions
  *======================*/
@@ -1555,18 +2291,45 @@ lv_obj_t * lv_obj_get_child_back(const lv_obj_t * obj, const lv_obj_t * child)
 }
 
 /**
- * Count the children of an object (only children directly on 'obj')
+ * Get a child of an object by its index in the drawing order.
+ * With `LV_USE_OBJ_CHILD_ARRAY` it's an array lookup (the array is created at the first call),
+ * else the children are walked from the background.
  * @param obj pointer to an object
- * @return children number of 'obj'
+ * @param index 0: the "oldest" child in the background ... `lv_obj_count_children(obj) - 1`: on the top
+ * @return the child or NULL if `index` is too large
  */
-uint16_t lv_obj_count_children(const lv_obj_t * obj)
+lv_obj_t * lv_obj_get_child_by_index(const lv_obj_t * obj, uint16_t index)
 {
+    if(index >= obj->child_cnt) return NULL;
+
+#if LV_USE_OBJ_CHILD_ARRAY
+    /*The array is a cache, creating it doesn't change the object*/
+    if(obj->child_arr == NULL) child_arr_build((lv_obj_t *)obj);
+    if(obj->child_arr) return obj->child_arr[index];
+#endif
+
+    /*No memory for the array: walk from the closer end*/
     lv_obj_t * i;
-    uint16_t cnt = 0;
+    if(index < obj->child_cnt / 2) {
+        i = lv_ll_get_tail(&obj->child_ll);
+        while(index--) i = lv_ll_get_prev(&obj->child_ll, i);
+    } else {
+        i     = lv_ll_get_head(&obj->child_ll);
+        index = obj->child_cnt - 1 - index;
+        while(index--) i = lv_ll_get_next(&obj->child_ll, i);
+    }
 
-    LV_LL_READ(obj->child_ll, i) cnt++;
+    return i;
+}
 
-    return cnt;
+/**
+ * Count the children of an object (only children directly on 'obj')
+ * @param obj pointer to an object
+ * @return children number of 'obj'
+ */
+uint16_t lv_obj_count_children(const lv_obj_t * obj)
+{
+    return obj->child_cnt;
 }
 
 /** Recursively count the children of an object
@@ -1598,9 +2361,29 @@ uint16_t lv_obj_count_children_recursive(const lv_obj_t * obj)
  */
 void lv_obj_get_coords(const lv_obj_t * obj, lv_area_t * cords_p)
 {
+    layout_resolve(obj);
     lv_area_copy(cords_p, &obj->coords);
 }
 
+/**
+ * Get a number which changes whenever an object is moved or resized (including with its parent).
+ * Can be used to know if the positions saved earlier are still valid.
+ * @return the current layout generation
+ */
+uint32_t lv_obj_get_layout_gen(void)
+{
+    return layout_gen;
+}
+
+/**
+ * Change the layout generation after modifying the coordinates of an object directly
+ * (not with `lv_obj_set_pos/size`, e.g. in a widget's own layout code)
+ */
+void lv_obj_report_layout_chg(void)
+{
+    layout_gen++;
+}
+
 /**
  * Reduce area retried by `lv_obj_get_coords()` the get graphically usable area of an object.
  * (Without the size of the border or other extra graphical elements)
@@ -1625,6 +2408,8 @@ void lv_obj_get_inner_coords(const lv_obj_t * obj, lv_area_t * coords_p)
  */
 lv_coord_t lv_obj_get_x(const lv_obj_t * obj)
 {
+    layout_resolve(obj);
+
     lv_coord_t rel_x;
     lv_obj_t * parent = lv_obj_get_parent(obj);
     rel_x             = obj->coords.x1 - parent->coords.x1;
@@ -1639,6 +2424,8 @@ lv_coord_t lv_obj_get_x(const lv_obj_t * obj)
  */
 lv_coord_t lv_obj_get_y(const lv_obj_t * obj)
 {
+    layout_resolve(obj);
+
     lv_coord_t rel_y;
     lv_obj_t * parent = lv_obj_get_parent(obj);
     rel_y             = obj->coords.y1 - parent->coords.y1;
@@ -1653,6 +2440,7 @@ lv_coord_t lv_obj_get_y(const lv_obj_t * obj)
  */
 lv_coord_t lv_obj_get_width(const lv_obj_t * obj)
 {
+    layout_resolve(obj);
     return lv_area_get_width(&obj->coords);
 }
 
@@ -1663,6 +2451,7 @@ lv_coord_t lv_obj_get_width(const lv_obj_t * obj)
  */
 lv_coord_t lv_obj_get_height(const lv_obj_t * obj)
 {
+    layout_resolve(obj);
     return lv_area_get_height(&obj->coords);
 }
 
@@ -1783,6 +2572,48 @@ lv_coord_t lv_obj_get_ext_draw_pad(const lv_obj_t * obj)
     return obj->ext_draw_pad;
 }
 
+#if LV_USE_CHILD_BOUNDS
+/**
+ * Get the area covered by the children of an object with their extended draw and click area.
+ * The children are drawn only on their parent, so the children of the children are in it too.
+ * @param obj pointer to an object
+ * @param bounds store the area here
+ * @return false: the object has no children (`bounds` is not set)
+ */
+bool lv_obj_get_child_bounds(lv_obj_t * obj, lv_area_t * bounds)
+{
+    if(obj->child_cnt == 0) return false;
+
+    /*The drawing threads can update it at the same time*/
+    lv_thread_lock();
+    if(obj->child_bounds_ok == 0) {
+        bool first = true;
+        lv_obj_t * child;
+        LV_LL_READ(obj->child_ll, child)
+        {
+            lv_area_t a;
+            lv_area_t click;
+            lv_obj_get_coords(child, &a);
+            a.x1 -= child->ext_draw_pad;
+            a.y1 -= child->ext_draw_pad;
+            a.x2 += child->ext_draw_pad;
+            a.y2 += child->ext_draw_pad;
+            lv_hit_get_click_area(child, &click);
+            lv_area_join(&a, &a, &click);
+
+            if(first) lv_area_copy(&obj->child_bounds, &a);
+            else lv_area_join(&obj->child_bounds, &obj->child_bounds, &a);
+            first = false;
+        }
+        obj->child_bounds_ok = 1;
+    }
+    lv_area_copy(bounds, &obj->child_bounds);
+    lv_thread_unlock();
+
+    return true;
+}
+#endif
+
 /*-----------------
  * Appearance get
  *---------------*/
@@ -1915,6 +2746,60 @@ bool lv_obj_get_parent_event(const lv_obj_t * obj)
     return obj->parent_event == 0 ? false : true;
 }
 
+/**
+ * Get which changes of the coordinates send `LV_SIGNAL_CORD_CHG` to an object
+ * @param obj pointer to an object
+ * @return `LV_OBJ_CORD_SIGNAL_NONE/SIZE/ALL` (see `lv_obj_set_cord_signal`)
+ */
+lv_obj_cord_signal_t lv_obj_get_cord_signal(const lv_obj_t * obj)
+{
+    return obj->cord_signal;
+}
+
+#if LV_USE_LAYER_CACHE
+/**
+ * Get whether an object is cached as a bitmap
+ * @param obj pointer to an object
+ * @return true: it's cached (see `lv_obj_set_layer_cache`)
+ */
+bool lv_obj_get_layer_cache(const lv_obj_t * obj)
+{
+    return obj->layer_cache == 0 ? false : true;
+}
+
+/**
+ * Get whether an object is cached as a modal backdrop
+ * @param obj pointer to an object
+ * @return true: it's a backdrop (see `lv_obj_set_layer_backdrop`)
+ */
+bool lv_obj_get_layer_backdrop(const lv_obj_t * obj)
+{
+    return obj->layer_backdrop == 0 ? false : true;
+}
+
+/**
+ * Get whether the static part of an object is cached
+ * @param obj pointer to an object
+ * @return true: it's cached (see `lv_obj_set_layer_static`)
+ */
+bool lv_obj_get_layer_static(const lv_obj_t * obj)
+{
+    return obj->layer_static == 0 ? false : true;
+}
+#endif
+
+#if LV_USE_OBJ_LAZY
+/**
+ * Get whether the lazy children of an object are created
+ * @param obj pointer to an object
+ * @return true: they are, or it has none (see `lv_obj_set_lazy`)
+ */
+bool lv_obj_is_lazy_built(const lv_obj_t * obj)
+{
+    return obj->lazy_cb == NULL || obj->lazy_built ? true : false;
+}
+#endif
+
 /**
  * Get the opa scale enable parameter
  * @param obj pointer to an object
@@ -1935,6 +2820,10 @@ lv_opa_t lv_obj_get_opa_scale(const lv_obj_t * obj)
     const lv_obj_t * parent = obj;
 
     while(parent) {
+#if LV_USE_OPA_GROUP
+        /*The group is drawn opaque and blended with its opa scale at once*/
+        if(parent == lv_refr_get_opa_group()) return LV_OPA_COVER;
+#endif
         if(parent->opa_scale_en) return parent->opa_scale;
         parent = lv_obj_get_parent(parent);
     }
@@ -2184,6 +3073,11 @@ static lv_res_t lv_obj_signal(lv_obj_t * obj, lv_signal_t sign, void * param)
  */
 static void refresh_children_position(lv_obj_t * obj, lv_coord_t x_diff, lv_coord_t y_diff)
 {
+#if LV_USE_CHILD_BOUNDS
+    /*The children move together*/
+    lv_area_set_pos(&obj->child_bounds, obj->child_bounds.x1 + x_diff, obj->child_bounds.y1 + y_diff);
+#endif
+
     lv_obj_t * i;
     LV_LL_READ(obj->child_ll, i)
     {
@@ -2236,7 +3130,181 @@ static void refresh_children_style(lv_obj_t * obj)
 }
 
 /**
- * Called by 'lv_obj_del' to delete the children objects
+ * Add an area to the union collected for a display in the batch
+ * @param disp pointer to a display
+ * @param area the invalidated area
+ * @return false: too many displays, invalidate the area now
+ */
+static bool batch_inv_area(lv_disp_t * disp, const lv_area_t * area)
+{
+    uint8_t i;
+    for(i = 0; i < batch_inv_cnt; i++) {
+        if(batch_inv[i].disp == disp) {
+            lv_area_join(&batch_inv[i].area, &batch_inv[i].area, area);
+            return true;
+        }
+    }
+
+    if(batch_inv_cnt >= LV_OBJ_BATCH_DISP_MAX) return false;
+
+    batch_inv[batch_inv_cnt].disp = disp;
+    lv_area_copy(&batch_inv[batch_inv_cnt].area, area);
+    batch_inv_cnt++;
+    return true;
+}
+
+/**
+ * Refresh the marked objects, the deepest first. So the size of a container fitting
+ * its children is known when its parent arranges it.
+ * The parents marked meanwhile are refreshed in this round too, the children in the next one.
+ */
+static void layout_round(void)
+{
+    uint16_t depth_max = 0;
+    uint32_t i;
+    for(i = 0; i < layout_cnt; i++) {
+        if(layout_queue[i].depth > depth_max) depth_max = layout_queue[i].depth;
+    }
+
+    /*A few levels and a few objects: scanning per level is cheaper than sorting*/
+    int32_t depth;
+    for(depth = depth_max; depth >= 0; depth--) {
+        for(i = 0; i < layout_cnt; i++) {
+            /*Read again: the queue can be reallocated by the refreshes*/
+            lv_obj_t * obj = layout_queue[i].obj;
+            if(obj == NULL || layout_queue[i].depth != depth) continue;
+
+            layout_queue[i].obj = NULL;
+            obj->batch_layout   = 0;
+            layout_stats.done++;
+            obj->signal_cb(obj, LV_SIGNAL_REFR_LAYOUT, NULL);
+        }
+    }
+
+    /*Keep the children marked by this round*/
+    uint32_t new_cnt = 0;
+    for(i = 0; i < layout_cnt; i++) {
+        if(layout_queue[i].obj) layout_queue[new_cnt++] = layout_queue[i];
+    }
+    layout_cnt = new_cnt;
+}
+
+/**
+ * Refresh the deferred layouts if they can move or resize an object,
+ * i.e. the object or one of its parents is marked
+ * @param obj pointer to an object
+ */
+static void layout_resolve(const lv_obj_t * obj)
+{
+    if(layout_cnt == 0) return;
+
+    while(obj) {
+        if(obj->batch_layout) {
+            lv_obj_layout_flush();
+            return;
+        }
+        obj = obj->par;
+    }
+}
+
+/**
+ * Remove a deleted object from the deferred layouts
+ * @param obj pointer to an object being deleted
+ */
+static void layout_forget(lv_obj_t * obj)
+{
+    uint32_t i;
+    for(i = 0; i < layout_cnt; i++) {
+        if(layout_queue[i].obj == obj) {
+            layout_queue[i].obj = NULL;
+            return;
+        }
+    }
+}
+
+#if LV_USE_OBJ_REALIGN
+/**
+ * Do the deferred realigns in a subtree. The parents first, they are the typical bases.
+ * @param obj pointer to an object
+ */
+static void batch_realign(lv_obj_t * obj)
+{
+    if(obj->batch_realign) {
+        obj->batch_realign = 0;
+        lv_obj_realign(obj);
+    }
+
+    lv_obj_t * child;
+    LV_LL_READ(obj->child_ll, child) batch_realign(child);
+}
+#endif
+
+#if LV_USE_STYLE_INDEX
+/**
+ * Get the bucket of a style in the style index
+ * @param style pointer to a style
+ * @return index in `style_index`
+ */
+static uint32_t style_index_hash(const lv_style_t * style)
+{
+    /*The styles are at least 4 byte aligned, mix the higher bits in*/
+    uint32_t h = (uint32_t)((uintptr_t)style >> 2);
+    h *= 2654435761u;
+    return (h >> 16) & (LV_STYLE_INDEX_BUCKETS - 1);
+}
+
+/**
+ * Add an object to the bucket of its style. Objects with NULL style are not indexed,
+ * they are refreshed with their parent.
+ * @param obj pointer to an object (not indexed)
+ */
+static void style_index_add(lv_obj_t * obj)
+{
+    if(obj->style_p == NULL) return;
+
+    lv_obj_t ** head = &style_index[style_index_hash(obj->style_p)];
+    obj->style_next  = *head;
+    obj->style_pprev = head;
+    if(*head) (*head)->style_pprev = &obj->style_next;
+    *head = obj;
+}
+
+/**
+ * Remove an object from the style index
+ * @param obj pointer to an object
+ */
+static void style_index_remove(lv_obj_t * obj)
+{
+    if(obj->style_pprev == NULL) return;
+
+    *obj->style_pprev = obj->style_next;
+    if(obj->style_next) obj->style_next->style_pprev = obj->style_pprev;
+    obj->style_pprev = NULL;
+}
+
+/**
+ * Refresh the objects using a style and the children inheriting it.
+ * Like the walk on the object tree, it expects that the style change signals don't
+ * delete or restyle other objects.
+ * @param style pointer to a style
+ */
+static void style_index_report(const lv_style_t * style)
+{
+    lv_obj_t * i = style_index[style_index_hash(style)];
+    while(i != NULL) {
+        lv_obj_t * next = i->style_next;
+        if(i->style_p == style) {
+            refresh_children_style(i);
+            lv_obj_refresh_style(i);
+        }
+        i = next;
+    }
+}
+#endif /*LV_USE_STYLE_INDEX*/
+
+/**
+ * Called by 'lv_obj_del' and 'lv_obj_clean' to delete an object and its children.
+ * Neither the object is invalidated nor its parent is notified, the caller does them once for all.
  * @param obj pointer to an object (all of its children will be deleted)
  */
 static void delete_children(lv_obj_t * obj)
@@ -2295,14 +3363,28 @@ static void delete_children(lv_obj_t * obj)
 
     /*Remove the object from parent's children list*/
     lv_obj_t * par = lv_obj_get_parent(obj);
+    child_detach(par, obj);
     lv_ll_rem(&(par->child_ll), obj);
 
     /* Clean up the object specific data*/
     obj->signal_cb(obj, LV_SIGNAL_CLEANUP, NULL);
 
+    /*Drop the index of the children*/
+    lv_hit_remove(obj);
+#if LV_USE_STYLE_INDEX
+    style_index_remove(obj);
+#endif
+#if LV_USE_LAYER_CACHE
+    if(obj->layer_cache) lv_layer_remove(obj);
+#endif
+#if LV_USE_OBJ_CHILD_ARRAY
+    if(obj->child_arr) lv_mem_free(obj->child_arr);
+#endif
+    if(obj->batch_layout) layout_forget(obj);
+
     /*Delete the base objects*/
     if(obj->ext_attr != NULL) lv_mem_free(obj->ext_attr);
-    lv_mem_free(obj); /*Free the object itself*/
+    lv_ll_free(&(par->child_ll), obj); /*Free the object itself*/
 }
 
 static void lv_event_mark_deleted(lv_obj_t * obj)
@@ -2314,3 +3396,167 @@ static void lv_event_mark_deleted(lv_obj_t * obj)
         t = t->prev;
     }
 }
+
+/**
+ * Count a new child of an object and add it to the child array if the object has one.
+ * @param par pointer to the parent
+ * @param obj pointer to the child, already in the `child_ll` of `par` at its place
+ */
+static void child_attach(lv_obj_t * par, lv_obj_t * obj)
+{
+    par->child_cnt++;
+
+#if LV_USE_OBJ_CHILD_ARRAY
+    if(par->child_arr == NULL) return;
+
+    if(par->child_cnt > par->child_arr_size) {
+        uint32_t size = (uint32_t)par->child_arr_size * 2;
+        if(size > UINT16_MAX) size = UINT16_MAX;
+        lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_OBJ);
+        lv_obj_t ** arr       = lv_mem_realloc(par->child_arr, size * sizeof(lv_obj_t *));
+        lv_mem_tag_set(tag_prev);
+        if(arr == NULL) {
+            /*Drop the array, `lv_obj_get_child_by_index` creates it again*/
+            lv_mem_free(par->child_arr);
+            par->child_arr      = NULL;
+            par->child_arr_size = 0;
+            return;
+        }
+        par->child_arr      = arr;
+        par->child_arr_size = size;
+    }
+
+    /*The new children go to the top, the moved ones become the next after the child below them*/
+    uint16_t idx;
+    lv_obj_t * below = lv_ll_get_next(&par->child_ll, obj);
+    if(lv_ll_get_prev(&par->child_ll, obj) == NULL) idx = par->child_cnt - 1;
+    else if(below == NULL) idx = 0;
+    else idx = child_arr_find(par, below) + 1;
+
+    memmove(&par->child_arr[idx + 1], &par->child_arr[idx], (par->child_cnt - 1 - idx) * sizeof(lv_obj_t *));
+    par->child_arr[idx] = obj;
+#else
+    (void)obj; /*Unused*/
+#endif
+}
+
+/**
+ * Forget a child of an object. Called before removing it from the `child_ll` of `par`.
+ * @param par pointer to the parent
+ * @param obj pointer to the child
+ */
+static void child_detach(lv_obj_t * par, lv_obj_t * obj)
+{
+#if LV_USE_OBJ_CHILD_ARRAY
+    if(par->child_arr != NULL) {
+        uint16_t idx = child_arr_find(par, obj);
+        memmove(&par->child_arr[idx], &par->child_arr[idx + 1], (par->child_cnt - 1 - idx) * sizeof(lv_obj_t *));
+    }
+#else
+    (void)obj; /*Unused*/
+#endif
+
+    par->child_cnt--;
+
+#if LV_USE_OBJ_CHILD_ARRAY
+    if(par->child_cnt == 0 && par->child_arr != NULL) {
+        lv_mem_free(par->child_arr);
+        par->child_arr      = NULL;
+        par->child_arr_size = 0;
+    }
+#endif
+}
+
+#if LV_USE_OBJ_CLIP_CACHE
+/**
+ * Update the cached area of the parents and the screen of an object if they are outdated
+ * @param obj pointer to an object
+ * @return true: the object can be visible; false: a parent is hidden or the parents have no common area
+ */
+static bool clip_refresh(lv_obj_t * obj)
+{
+    if(obj->clip_ok) return obj->clip_vis;
+
+    lv_obj_t * par = obj->par;
+    if(par == NULL) {
+        /*Screens are truncated only by the display*/
+        obj->clip.x1  = LV_COORD_MIN;
+        obj->clip.y1  = LV_COORD_MIN;
+        obj->clip.x2  = LV_COORD_MAX;
+        obj->clip.y2  = LV_COORD_MAX;
+        obj->clip_scr = obj;
+        obj->clip_vis = 1;
+    } else {
+        bool vis      = clip_refresh(par) && par->hidden == 0;
+        obj->clip_scr = par->clip_scr;
+        obj->clip_vis = vis && lv_area_intersect(&obj->clip, &par->clip, &par->coords) ? 1 : 0;
+    }
+
+    obj->clip_ok = 1;
+    return obj->clip_vis;
+}
+
+#endif
+
+#if LV_USE_OBJ_CHILD_ARRAY
+/**
+ * Create the child array of an object from its `child_ll`
+ * @param obj pointer to an object with children but without array
+ */
+static void child_arr_build(lv_obj_t * obj)
+{
+    uint16_t size         = obj->child_cnt < 8 ? 8 : obj->child_cnt;
+    lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_OBJ);
+    obj->child_arr        = lv_mem_alloc(size * sizeof(lv_obj_t *));
+    lv_mem_tag_set(tag_prev);
+    if(obj->child_arr == NULL) return;
+    obj->child_arr_size = size;
+
+    uint16_t idx = 0;
+    lv_obj_t * i;
+    LV_LL_READ_BACK(obj->child_ll, i) obj->child_arr[idx++] = i;
+}
+
+/**
+ * Find a child in the child array. The search starts from the top because the recently created
+ * children (the usual ones to move or delete) are there.
+ * @param par pointer to an object with child array
+ * @param obj pointer to a child of `par`
+ * @return the index of `obj`
+ */
+static uint16_t child_arr_find(const lv_obj_t * par, const lv_obj_t * obj)
+{
+    uint16_t idx = par->child_cnt;
+    while(idx > 0) {
+        idx--;
+        if(par->child_arr[idx] == obj) break;
+    }
+
+    return idx;
+}
+#endif
+
+#if LV_USE_OBJ_LAZY
+/**
+ * Delete the children created by the `lazy_cb` of a hidden object if it allows it and `lv_mem` is low.
+ * They are the newest ones (the head of `child_ll`), the ones it had before are kept.
+ * @param obj pointer to a hidden object
+ */
+static void lazy_release(lv_obj_t * obj)
+{
+    if(!obj->lazy_built || !obj->lazy_release) return;
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    /*Without `lv_mem` (`LV_MEM_CUSTOM`) the free memory is unknown*/
+    if(mon.total_size == 0 || mon.free_size >= LV_OBJ_LAZY_RELEASE_FREE) return;
+
+    /*Nothing to release if the callback created them elsewhere (e.g. on the scrollable of a page)*/
+    if(obj->child_cnt <= obj->lazy_keep) return;
+
+    while(obj->child_cnt > obj->lazy_keep) {
+        lv_obj_del(lv_ll_get_head(&obj->child_ll));
+    }
+    obj->lazy_built = 0;
+}
+#endif
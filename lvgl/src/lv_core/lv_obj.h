@@ -61,6 +61,8 @@ enum {
     LV_DESIGN_DRAW_MAIN, /**< Draw the main portion of the object */
     LV_DESIGN_DRAW_POST, /**< Draw extras on the object */
     LV_DESIGN_COVER_CHK, /**< Check if the object fully covers the 'mask_p' area */
+    LV_DESIGN_DRAW_STATIC,  /**< Draw the parts of the main portion which rarely change (see `lv_obj_set_layer_static`)*/
+    LV_DESIGN_DRAW_DYNAMIC, /**< Draw the other parts of the main portion on the static ones*/
 };
 typedef uint8_t lv_design_mode_t;
 
@@ -102,6 +104,13 @@ typedef uint8_t lv_event_t; /**< Type of event being sent to the object. */
  */
 typedef void (*lv_event_cb_t)(struct _lv_obj_t * obj, lv_event_t event);
 
+#if LV_USE_OBJ_LAZY
+/**
+ * Creates the children of an object when it's shown first (see `lv_obj_set_lazy`)
+ */
+typedef void (*lv_obj_lazy_cb_t)(struct _lv_obj_t * obj);
+#endif
+
 /** Signals are for use by the object itself or to extend the object's functionality.
   * Applications should use ::lv_obj_set_event_cb to be notified of events that occur
   * on the object. */
@@ -114,6 +123,9 @@ enum {
     LV_SIGNAL_STYLE_CHG, /**< Object's style has changed */
     LV_SIGNAL_REFR_EXT_DRAW_PAD, /**< Object's extra padding has changed */
     LV_SIGNAL_GET_TYPE, /**< LittlevGL needs to retrieve the object's type */
+    LV_SIGNAL_REFR_LAYOUT, /**< Refresh the layout deferred by `lv_obj_layout_defer` */
+    LV_SIGNAL_SCROLL, /**< The object will be moved, sent only if `scroll_blit` is set. See `lv_signal_scroll_t` */
+    LV_SIGNAL_GET_VALUE_AREA, /**< Get the parts of a bar or derived object drawn by its value. See `lv_bar_value_area_t` */
 
     /*Input device related*/
     LV_SIGNAL_PRESSED,           /**< The object has been pressed*/
@@ -181,10 +193,24 @@ enum {
 
 typedef uint8_t lv_drag_dir_t;
 
+/*Which changes of the coordinates send `LV_SIGNAL_CORD_CHG` to an object with `LV_USE_OBJ_CORD_SIGNAL`*/
+enum {
+    LV_OBJ_CORD_SIGNAL_NONE = 0, /**< None, the object doesn't handle the signal*/
+    LV_OBJ_CORD_SIGNAL_SIZE,     /**< Resizing it*/
+    LV_OBJ_CORD_SIGNAL_ALL,      /**< Moving or resizing it*/
+};
+typedef uint8_t lv_obj_cord_signal_t;
+
 typedef struct _lv_obj_t
 {
     struct _lv_obj_t * par; /**< Pointer to the parent object*/
     lv_ll_t child_ll;       /**< Linked list to store the children objects*/
+    uint16_t child_cnt;     /**< Number of the children in `child_ll`*/
+
+#if LV_USE_OBJ_CHILD_ARRAY
+    uint16_t child_arr_size;       /**< Allocated items in `child_arr`*/
+    struct _lv_obj_t ** child_arr; /**< The children from the background to the foreground (NULL: not created)*/
+#endif
 
     lv_area_t coords; /**< Coordinates of the object (x1, y1, x2, y2)*/
 
@@ -195,6 +221,11 @@ typedef struct _lv_obj_t
     void * ext_attr;            /**< Object type specific extended data*/
     const lv_style_t * style_p; /**< Pointer to the object's style*/
 
+#if LV_USE_STYLE_INDEX
+    struct _lv_obj_t * style_next;   /**< Next object in the bucket of the style index*/
+    struct _lv_obj_t ** style_pprev; /**< The pointer to this object in the bucket (NULL: not indexed)*/
+#endif
+
 #if LV_USE_GROUP != 0
     void * group_p; /**< Pointer to the group of the object*/
 #endif
@@ -218,23 +249,63 @@ typedef struct _lv_obj_t
     uint8_t opa_scale_en : 1;   /**< 1: opa_scale is set*/
     uint8_t parent_event : 1;   /**< 1: Send the object's events to the parent too. */
     lv_drag_dir_t drag_dir : 2; /**<  Which directions the object can be dragged in */
-    uint8_t reserved : 6;       /**<  Reserved for future use*/
+    uint8_t batch_layout : 1;   /**< 1: Waits for `LV_SIGNAL_REFR_LAYOUT` (see `lv_obj_layout_defer`)*/
+    uint8_t batch_realign : 1;  /**< 1: Realigned when the batch is committed*/
+    uint8_t scroll_blit : 1;    /**< 1: Send `LV_SIGNAL_SCROLL` before moving to move the drawn pixels instead*/
+    uint8_t layer_cache : 1;    /**< 1: Drawn from a bitmap while it's not changed (see `lv_obj_set_layer_cache`)*/
+    uint8_t layer_backdrop : 1; /**< 1: The bitmap has the object without its children (see `lv_obj_set_layer_backdrop`)*/
+    uint8_t layer_static : 1;   /**< 1: The bitmap has the static part of the object (see `lv_obj_set_layer_static`)*/
+    uint8_t clip_ok : 1;         /**< 1: `clip`, `clip_scr` and `clip_vis` are up to date*/
+    uint8_t clip_vis : 1;        /**< 1: no parent is hidden and `clip` isn't empty*/
+    lv_obj_cord_signal_t cord_signal : 2; /**< When `LV_SIGNAL_CORD_CHG` is sent (see `lv_obj_set_cord_signal`)*/
     uint8_t protect;            /**< Automatically happening actions can be prevented. 'OR'ed values from
                                    `lv_protect_t`*/
     lv_opa_t opa_scale;         /**< Scale down the opacity by this factor. Effects all children as well*/
 
     lv_coord_t ext_draw_pad; /**< EXTtend the size in every direction for drawing. */
 
+#if LV_USE_CHILD_BOUNDS
+    lv_area_t child_bounds; /**< The children with their `ext_draw_pad` and click area (absolute coordinates)*/
+    uint8_t child_bounds_ok; /**< 1: `child_bounds` is up to date (see `lv_obj_get_child_bounds`). Not in the bit
+                                  fields above: the drawing threads update it while others read those.*/
+#endif
+
+#if LV_USE_OBJ_CLIP_CACHE
+    lv_area_t clip;              /**< Intersection of the coordinates of the parents*/
+    struct _lv_obj_t * clip_scr; /**< The screen of the object*/
+#endif
+
 #if LV_USE_OBJ_REALIGN
     lv_reailgn_t realign;       /**< Information about the last call to ::lv_obj_align. */
 #endif
 
+#if LV_USE_OBJ_LAZY
+    lv_obj_lazy_cb_t lazy_cb;   /**< Creates the children on the first show (NULL: none)*/
+    uint16_t lazy_keep;         /**< Children before `lazy_cb` created its ones, they are never released*/
+    uint8_t lazy_built : 1;     /**< 1: `lazy_cb` was called (and its children weren't released since)*/
+    uint8_t lazy_release : 1;   /**< 1: Delete the children of `lazy_cb` when hidden and the memory is low*/
+#endif
+
 #if LV_USE_USER_DATA
     lv_obj_user_data_t user_data; /**< Custom user data for object. */
 #endif
 
 } lv_obj_t;
 
+/** Parameter of `LV_SIGNAL_SCROLL`*/
+typedef struct
+{
+    lv_point_t diff; /**< The object will move by this*/
+    bool blit;       /**< Set to `true` if the pixels will be moved by `lv_refr_scroll`: the object isn't invalidated*/
+} lv_signal_scroll_t;
+
+/** Counters of the deferred layouts*/
+typedef struct
+{
+    uint32_t requested; /**< Layout refreshes asked for by the objects*/
+    uint32_t done;      /**< `LV_SIGNAL_REFR_LAYOUT` signals sent*/
+} lv_obj_layout_stats_t;
+
 /*Protect some attributes (max. 8 bit)*/
 enum {
     LV_PROTECT_NONE      = 0x00,
@@ -286,7 +357,8 @@ lv_obj_t * lv_obj_create(lv_obj_t * parent, const lv_obj_t * copy);
 lv_res_t lv_obj_del(lv_obj_t * obj);
 
 /**
- * Delete all children of an object
+ * Delete all children of an object.
+ * The object is invalidated and gets `LV_SIGNAL_CHILD_CHG` only once for all the children.
  * @param obj pointer to an object
  */
 void lv_obj_clean(lv_obj_t * obj);
@@ -297,6 +369,59 @@ void lv_obj_clean(lv_obj_t * obj);
  */
 void lv_obj_invalidate(const lv_obj_t * obj);
 
+/**
+ * Mark a part of an object as invalid therefore it will be redrawn by 'lv_refr_task'
+ * @param obj pointer to an object
+ * @param area the area to redraw in absolute coordinates. It's truncated to the parents.
+ */
+void lv_obj_invalidate_area(const lv_obj_t * obj, const lv_area_t * area);
+
+/**
+ * Start a batch of changes (e.g. creating or restyling a lot of objects).
+ * Until `lv_obj_batch_commit` the invalidated areas are only collected and
+ * the realigns and container layouts are deferred. Batches can be nested.
+ */
+void lv_obj_batch_begin(void);
+
+/**
+ * End a batch. The outermost commit refreshes the deferred layouts (the children first),
+ * does the deferred realigns and invalidates the union of the collected areas on every display.
+ */
+void lv_obj_batch_commit(void);
+
+/**
+ * Tell whether a batch is in progress
+ * @return true: between `lv_obj_batch_begin` and `lv_obj_batch_commit`
+ */
+bool lv_obj_batch_is_active(void);
+
+/**
+ * Tell whether the layouts are only marked now, e.g. in a batch or with `LV_USE_LAYOUT_DEFER`
+ * @return true: call `lv_obj_layout_defer` instead of refreshing a layout
+ */
+bool lv_obj_layout_is_deferred(void);
+
+/**
+ * Send `LV_SIGNAL_REFR_LAYOUT` to an object later instead of refreshing its layout now.
+ * For object types arranging their children (e.g. containers).
+ * Marking an already marked object is free, the requests are merged into one refresh.
+ * @param obj pointer to an object
+ */
+void lv_obj_layout_defer(lv_obj_t * obj);
+
+/**
+ * Refresh the deferred layouts now, the deepest objects first.
+ * Called before every refresh and input read, call it to read the new size of a container earlier.
+ * Does nothing in a batch.
+ */
+void lv_obj_layout_flush(void);
+
+/**
+ * Get how many layout refreshes were requested and how many were done
+ * @param stats the counters are copied here. `requested - done` refreshes were saved.
+ */
+void lv_obj_layout_get_stats(lv_obj_layout_stats_t * stats);
+
 /*=====================
  * Setter functions
  *====================*/
@@ -324,12 +449,22 @@ void lv_obj_move_foreground(lv_obj_t * obj);
  */
 void lv_obj_move_background(lv_obj_t * obj);
 
+/**
+ * Move an object right below one of its siblings, so it's drawn just before it
+ * @param obj pointer to an object
+ * @param above pointer to a sibling of `obj`
+ */
+void lv_obj_move_below(lv_obj_t * obj, lv_obj_t * above);
+
 /*--------------------
  * Coordinate set
  * ------------------*/
 
 /**
- * Set relative the position of an object (relative to the parent)
+ * Set relative the position of an object (relative to the parent).
+ * Only the object (`LV_SIGNAL_CORD_CHG`) and its parent (`LV_SIGNAL_CHILD_CHG`) get a signal,
+ * the coordinates of the descendants are only shifted.
+ * With `LV_USE_OBJ_CORD_SIGNAL` the object gets the signal only if it asked for it (`LV_OBJ_CORD_SIGNAL_ALL`).
  * @param obj pointer to an object
  * @param x new distance from the left side of the parent
  * @param y new distance from the top of the parent
@@ -502,6 +637,76 @@ void lv_obj_set_drag_parent(lv_obj_t * obj, bool en);
  */
 void lv_obj_set_parent_event(lv_obj_t * obj, bool en);
 
+/**
+ * Set which changes of the coordinates send `LV_SIGNAL_CORD_CHG` to an object.
+ * Only with `LV_USE_OBJ_CORD_SIGNAL`, else it's sent on every change.
+ * The object types handling the signal set it when they are created. Set it for a custom signal function too.
+ * @param obj pointer to an object
+ * @param cord_signal `LV_OBJ_CORD_SIGNAL_NONE/SIZE/ALL`. The default of a new object is `NONE`.
+ */
+void lv_obj_set_cord_signal(lv_obj_t * obj, lv_obj_cord_signal_t cord_signal);
+
+#if LV_USE_LAYER_CACHE
+/**
+ * Cache an object as a bitmap: its area is drawn once with its children and everything below it,
+ * and copied from the bitmap until the object, a child or something below it is invalidated.
+ * Useful for static windows which are redrawn because something above them changes.
+ * The bitmaps are dropped (and drawn again) if they don't fit into `LV_LAYER_CACHE_BUDGET`.
+ * @param obj pointer to an object
+ * @param en true: cache the object (if one of the `LV_LAYER_CACHE_SLOTS` is free)
+ */
+void lv_obj_set_layer_cache(lv_obj_t * obj, bool en);
+
+/**
+ * Cache an object as a modal backdrop, e.g. the semi-transparent full-screen parent of a message box.
+ * Its bitmap has the object (dimming what's below it) but not its children: they are drawn on the copied bitmap,
+ * so only they are redrawn while they change. The changes below the object are shown from time to time,
+ * when the bitmap is drawn again at most every `LV_LAYER_BACKDROP_PERIOD` ms.
+ * @param obj pointer to an object
+ * @param en true: cache the object as a backdrop (if one of the `LV_LAYER_CACHE_SLOTS` is free);
+ * false: don't cache it
+ */
+void lv_obj_set_layer_backdrop(lv_obj_t * obj, bool en);
+
+/**
+ * Cache the static part of an object, e.g. the background, division lines and axes of a chart.
+ * Its bitmap has what's below the object and the object drawn with `LV_DESIGN_DRAW_STATIC`.
+ * The refresh copies the bitmap, draws the object with `LV_DESIGN_DRAW_DYNAMIC` on it, then the children.
+ * The invalidations of the object and its children keep the bitmap: call `lv_obj_outdate_layer`
+ * when the static part changes. It's drawn again when the object is resized or moved too.
+ * Only for the objects whose design function has these modes (e.g. `lv_chart`).
+ * @param obj pointer to an object
+ * @param en true: cache the static part (if one of the `LV_LAYER_CACHE_SLOTS` is free); false: don't cache it
+ */
+void lv_obj_set_layer_static(lv_obj_t * obj, bool en);
+
+/**
+ * Draw the bitmap of a cached object again and redraw the object, e.g. because the static part changed
+ * (see `lv_obj_set_layer_static`)
+ * @param obj pointer to an object
+ */
+void lv_obj_outdate_layer(lv_obj_t * obj);
+#endif
+
+#if LV_USE_OBJ_LAZY
+/**
+ * Create the children of an object only when it's shown: by `lv_obj_set_hidden(obj, false)`, or by
+ * selecting its tab if it's a tab of a tab view. A shown object creates them at the next show or
+ * `lv_obj_lazy_build`. The children it has already are kept as they are.
+ * @param obj pointer to an object
+ * @param build_cb creates the children of `obj` (called once, or again after they were released)
+ * @param release true: delete the created children when `obj` is hidden while the free memory of `lv_mem`
+ * is below `LV_OBJ_LAZY_RELEASE_FREE`. Only for children without state to lose (e.g. no user changes).
+ */
+void lv_obj_set_lazy(lv_obj_t * obj, lv_obj_lazy_cb_t build_cb, bool release);
+
+/**
+ * Create the lazy children of an object now if they weren't yet (see `lv_obj_set_lazy`)
+ * @param obj pointer to an object
+ */
+void lv_obj_lazy_build(lv_obj_t * obj);
+#endif
+
 /**
  * Set the opa scale enable parameter (required to set opa_scale with `lv_obj_set_opa_scale()`)
  * @param obj pointer to an object
@@ -605,6 +810,34 @@ void * lv_obj_allocate_ext_attr(lv_obj_t * obj, uint16_t ext_size);
  */
 void lv_obj_refresh_ext_draw_pad(lv_obj_t * obj);
 
+#if LV_USE_CHILD_BOUNDS
+/**
+ * Mark the bounding box of an object's children as outdated. Should be called when a child is added,
+ * removed, moved, resized or its extended draw or click area changes.
+ * @param par pointer to an object (the parent of the changed child) or NULL
+ */
+void lv_obj_outdate_child_bounds(lv_obj_t * par);
+#else
+static inline void lv_obj_outdate_child_bounds(lv_obj_t * par)
+{
+    (void)par; /*Unused*/
+}
+#endif
+
+#if LV_USE_OBJ_CLIP_CACHE
+/**
+ * Mark the cached parent area of the descendants of an object as outdated.
+ * Should be called after modifying the coordinates of the object directly (not with `lv_obj_set_pos/size`).
+ * @param obj pointer to an object
+ */
+void lv_obj_outdate_clip(lv_obj_t * obj);
+#else
+static inline void lv_obj_outdate_clip(lv_obj_t * obj)
+{
+    (void)obj; /*Unused*/
+}
+#endif
+
 /*=======================
  * Getter functions
  *======================*/
@@ -652,6 +885,16 @@ lv_obj_t * lv_obj_get_child(const lv_obj_t * obj, const lv_obj_t * child);
  */
 lv_obj_t * lv_obj_get_child_back(const lv_obj_t * obj, const lv_obj_t * child);
 
+/**
+ * Get a child of an object by its index in the drawing order.
+ * With `LV_USE_OBJ_CHILD_ARRAY` it's an array lookup (the array is created at the first call),
+ * else the children are walked from the background.
+ * @param obj pointer to an object
+ * @param index 0: the "oldest" child in the background ... `lv_obj_count_children(obj) - 1`: on the top
+ * @return the child or NULL if `index` is too large
+ */
+lv_obj_t * lv_obj_get_child_by_index(const lv_obj_t * obj, uint16_t index);
+
 /**
  * Count the children of an object (only children directly on 'obj')
  * @param obj pointer to an object
@@ -676,6 +919,19 @@ uint16_t lv_obj_count_children_recursive(const lv_obj_t * obj);
  */
 void lv_obj_get_coords(const lv_obj_t * obj, lv_area_t * cords_p);
 
+/**
+ * Get a number which changes whenever an object is moved or resized (including with its parent).
+ * Can be used to know if the positions saved earlier are still valid.
+ * @return the current layout generation
+ */
+uint32_t lv_obj_get_layout_gen(void);
+
+/**
+ * Change the layout generation after modifying the coordinates of an object directly
+ * (not with `lv_obj_set_pos/size`, e.g. in a widget's own layout code)
+ */
+void lv_obj_report_layout_chg(void);
+
 /**
  * Reduce area retried by `lv_obj_get_coords()` the get graphically usable area of an object.
  * (Without the size of the border or other extra graphical elements)
@@ -767,6 +1023,17 @@ lv_coord_t lv_obj_get_ext_click_pad_bottom(const lv_obj_t * obj);
  */
 lv_coord_t lv_obj_get_ext_draw_pad(const lv_obj_t * obj);
 
+#if LV_USE_CHILD_BOUNDS
+/**
+ * Get the area covered by the children of an object with their extended draw and click area.
+ * The children are drawn only on their parent, so the children of the children are in it too.
+ * @param obj pointer to an object
+ * @param bounds store the area here
+ * @return false: the object has no children (`bounds` is not set)
+ */
+bool lv_obj_get_child_bounds(lv_obj_t * obj, lv_area_t * bounds);
+#endif
+
 /*-----------------
  * Appearance get
  *---------------*/
@@ -838,6 +1105,45 @@ bool lv_obj_get_drag_parent(const lv_obj_t * obj);
  */
 bool lv_obj_get_parent_event(const lv_obj_t * obj);
 
+/**
+ * Get which changes of the coordinates send `LV_SIGNAL_CORD_CHG` to an object
+ * @param obj pointer to an object
+ * @return `LV_OBJ_CORD_SIGNAL_NONE/SIZE/ALL` (see `lv_obj_set_cord_signal`)
+ */
+lv_obj_cord_signal_t lv_obj_get_cord_signal(const lv_obj_t * obj);
+
+#if LV_USE_LAYER_CACHE
+/**
+ * Get whether an object is cached as a bitmap
+ * @param obj pointer to an object
+ * @return true: it's cached (see `lv_obj_set_layer_cache`)
+ */
+bool lv_obj_get_layer_cache(const lv_obj_t * obj);
+
+/**
+ * Get whether an object is cached as a modal backdrop
+ * @param obj pointer to an object
+ * @return true: it's a backdrop (see `lv_obj_set_layer_backdrop`)
+ */
+bool lv_obj_get_layer_backdrop(const lv_obj_t * obj);
+
+/**
+ * Get whether the static part of an object is cached
+ * @param obj pointer to an object
+ * @return true: it's cached (see `lv_obj_set_layer_static`)
+ */
+bool lv_obj_get_layer_static(const lv_obj_t * obj);
+#endif
+
+#if LV_USE_OBJ_LAZY
+/**
+ * Get whether the lazy children of an object are created
+ * @param obj pointer to an object
+ * @return true: they are, or it has none (see `lv_obj_set_lazy`)
+ */
+bool lv_obj_is_lazy_built(const lv_obj_t * obj);
+#endif
+
 /**
  * Get the opa scale enable parameter
  * @param obj pointer to an object
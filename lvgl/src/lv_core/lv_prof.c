@@ -0,0 +1,357 @@
+/**
+ * @file lv_prof.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_prof.h"
+#if LV_USE_PROF
+
+#include <string.h>
+#include "lv_refr.h"
+#include "../lv_hal/lv_hal_tick.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_misc/lv_gc.h"
+
+#if LV_PROF_TIME_CUSTOM
+#include LV_PROF_TIME_CUSTOM_INCLUDE
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*Design time of an object type collected by a drawing thread*/
+typedef struct
+{
+    lv_signal_cb_t signal_cb; /*Identifies the type, the objects of a type has the same signal function*/
+    lv_prof_type_t type;
+} lv_prof_type_act_t;
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    lv_prof_frame_t frame_act; /*The refresh being measured*/
+    uint32_t task_time_act;    /*The tasks since the last frame*/
+    uint16_t task_cnt_act;
+} lv_prof_state_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void lv_prof_type_add(const lv_prof_type_t * type);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static bool prof_en;
+
+/*The frames of every context, guarded by `lv_thread_lock`*/
+static lv_prof_frame_t frames[LV_PROF_FRAME_CNT];
+static uint16_t frame_first; /*Index of the oldest frame in `frames`*/
+static uint16_t frame_cnt;
+
+static lv_prof_design_cb_t design_cb;
+
+#if LV_USE_CONTEXT
+#define prof_st ((lv_prof_state_t *)lv_context_act->prof_state)
+#else
+static lv_prof_state_t prof_state;
+#define prof_st (&prof_state)
+#endif
+#define frame_act (prof_st->frame_act)
+#define task_time_act (prof_st->task_time_act)
+#define task_cnt_act (prof_st->task_cnt_act)
+
+static LV_THREAD_LOCAL lv_prof_type_act_t types_act[LV_PROF_TYPE_MAX];
+static LV_THREAD_LOCAL uint8_t types_act_cnt;
+static LV_THREAD_LOCAL uint32_t draw_time_act;
+static LV_THREAD_LOCAL uint32_t draw_act[LV_PROF_DRAW_NUM];
+static LV_THREAD_LOCAL uint32_t draw_start[LV_PROF_DRAW_NUM]; /*`draw_act` at the last `lv_prof_start`*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Init the measuring in the active context. Called by `lv_context_init`.
+ */
+void lv_prof_init(void)
+{
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->prof_state, sizeof(lv_prof_state_t));
+#endif
+}
+
+/**
+ * Start or stop the measuring. It's stopped by default.
+ * @param en true: measure the refreshes and the tasks
+ */
+void lv_prof_set_en(bool en)
+{
+    prof_en       = en;
+    task_time_act = 0;
+    task_cnt_act  = 0;
+}
+
+/**
+ * Tell whether the measuring is running
+ * @return true: running
+ */
+bool lv_prof_get_en(void)
+{
+    return prof_en;
+}
+
+/**
+ * Forget the measured frames
+ */
+void lv_prof_clean(void)
+{
+    lv_thread_lock();
+    frame_first = 0;
+    frame_cnt   = 0;
+    lv_thread_unlock();
+}
+
+/**
+ * Get the number of the stored frames
+ * @return number of frames (at most `LV_PROF_FRAME_CNT`)
+ */
+uint16_t lv_prof_get_frame_cnt(void)
+{
+    return frame_cnt;
+}
+
+/**
+ * Get one of the stored frames
+ * @param id index of the frame, 0: the oldest one, `lv_prof_get_frame_cnt() - 1`: the last one
+ * @return pointer to the frame or NULL if `id` is too large
+ */
+const lv_prof_frame_t * lv_prof_get_frame(uint16_t id)
+{
+    if(id >= frame_cnt) return NULL;
+
+    return &frames[(frame_first + id) % LV_PROF_FRAME_CNT];
+}
+
+/**
+ * Set a function to call after every `design_cb` call, e.g. to measure the objects one by one.
+ * It's called on the drawing threads with `LV_REFR_THREADS > 1`.
+ * @param cb the function or NULL to remove it
+ */
+void lv_prof_set_design_cb(lv_prof_design_cb_t cb)
+{
+    design_cb = cb;
+}
+
+/**
+ * Get the time of the profiler's clock
+ * @return time in microseconds (wraps around)
+ */
+uint32_t lv_prof_time(void)
+{
+#if LV_PROF_TIME_CUSTOM
+    return LV_PROF_TIME_CUSTOM_EXPR;
+#else
+    return lv_tick_get() * 1000;
+#endif
+}
+
+/**
+ * Get the start time of a measurement
+ * @return the time [us] to pass to the other functions or 0 if the measuring is stopped
+ */
+uint32_t lv_prof_start(void)
+{
+    if(!prof_en) return 0;
+
+    /*The drawing operations of a `design_cb` call are counted from here*/
+    if(design_cb) memcpy(draw_start, draw_act, sizeof(draw_act));
+    return lv_prof_time();
+}
+
+/**
+ * Start measuring a new refresh. Called by `lv_disp_refr_task`.
+ * @param inv_cnt number of invalidated areas
+ */
+void lv_prof_refr_begin(uint16_t inv_cnt)
+{
+    if(!prof_en) return;
+
+    memset(&frame_act, 0, sizeof(frame_act));
+    frame_act.inv_cnt = inv_cnt;
+}
+
+/**
+ * Set the number of areas after joining them
+ * @param area_cnt number of areas to redraw
+ */
+void lv_prof_refr_areas(uint16_t area_cnt)
+{
+    frame_act.area_cnt = area_cnt;
+}
+
+/**
+ * Account the time of a `design_cb` call. Can be called on any drawing thread.
+ * @param obj the drawn object
+ * @param start return value of `lv_prof_start` before the call
+ */
+void lv_prof_refr_design(lv_obj_t * obj, uint32_t start)
+{
+    if(!prof_en || start == 0) return;
+
+    uint32_t t = lv_prof_time() - start;
+    draw_time_act += t;
+
+    if(design_cb) {
+        uint32_t draw[LV_PROF_DRAW_NUM];
+        uint8_t d;
+        for(d = 0; d < LV_PROF_DRAW_NUM; d++) draw[d] = draw_act[d] - draw_start[d];
+        design_cb(obj, t, draw);
+    }
+
+    uint8_t i;
+    for(i = 0; i < types_act_cnt; i++) {
+        if(types_act[i].signal_cb == obj->signal_cb) break;
+    }
+
+    if(i == types_act_cnt) {
+        /*The rest of the types are counted only in `draw_time`*/
+        if(types_act_cnt >= LV_PROF_TYPE_MAX) return;
+
+        lv_obj_type_t obj_type;
+        lv_obj_get_type(obj, &obj_type);
+        types_act[i].signal_cb = obj->signal_cb;
+        types_act[i].type.type = obj_type.type[0] ? obj_type.type[0] : "unknown";
+        types_act[i].type.time = 0;
+        types_act[i].type.cnt  = 0;
+        types_act_cnt++;
+    }
+
+    types_act[i].type.time += t;
+    types_act[i].type.cnt++;
+}
+
+/**
+ * Count drawing operations of the current thread. Called by the drawing functions.
+ * @param draw which operation, an element of `LV_PROF_DRAW_...`
+ * @param cnt number of them (e.g. pixels)
+ */
+void lv_prof_draw_add(lv_prof_draw_t draw, uint32_t cnt)
+{
+    if(!prof_en) return;
+
+    draw_act[draw] += cnt;
+}
+
+/**
+ * Add the design times collected by the current thread to the frame. Needs `lv_thread_lock`.
+ */
+void lv_prof_refr_merge(void)
+{
+    uint8_t i;
+    for(i = 0; i < types_act_cnt; i++) {
+        lv_prof_type_add(&types_act[i].type);
+    }
+    frame_act.draw_time += draw_time_act;
+    uint8_t d;
+    for(d = 0; d < LV_PROF_DRAW_NUM; d++) frame_act.draw[d] += draw_act[d];
+
+    types_act_cnt = 0;
+    draw_time_act = 0;
+    memset(draw_act, 0, sizeof(draw_act));
+}
+
+/**
+ * Account the time of a flushing or waiting for it
+ * @param start return value of `lv_prof_start` before the flushing
+ */
+void lv_prof_refr_flush(uint32_t start)
+{
+    if(!prof_en || start == 0) return;
+
+    frame_act.flush_time += lv_prof_time() - start;
+}
+
+/**
+ * Store the measured refresh as a new frame
+ * @param start return value of `lv_prof_start` at the beginning of the refresh
+ * @param px_num number of redrawn pixels
+ */
+void lv_prof_refr_end(uint32_t start, uint32_t px_num)
+{
+    if(!prof_en || start == 0) return;
+
+    frame_act.start     = start;
+    frame_act.refr_time = lv_prof_time() - start;
+    frame_act.px_num    = px_num;
+    frame_act.task_time = task_time_act;
+    frame_act.task_cnt  = task_cnt_act;
+    task_time_act       = 0;
+    task_cnt_act        = 0;
+
+    /*Overwrite the oldest frame when the buffer is full. The other contexts store their frames too.*/
+    lv_thread_lock();
+    if(frame_cnt < LV_PROF_FRAME_CNT) {
+        frames[(frame_first + frame_cnt) % LV_PROF_FRAME_CNT] = frame_act;
+        frame_cnt++;
+    } else {
+        frames[frame_first] = frame_act;
+        frame_first         = (frame_first + 1) % LV_PROF_FRAME_CNT;
+    }
+    lv_thread_unlock();
+}
+
+/**
+ * Account the time of a task. The refresh tasks are measured as the frames.
+ * @param task_cb the callback of the executed task (the task might be deleted already)
+ * @param start return value of `lv_prof_start` before the `task_cb`
+ */
+void lv_prof_task(lv_task_cb_t task_cb, uint32_t start)
+{
+    if(!prof_en || start == 0) return;
+    if(task_cb == lv_disp_refr_task) return;
+
+    task_time_act += lv_prof_time() - start;
+    task_cnt_act++;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Add the time of a type to the same type of the frame.
+ * The objects with an own signal function are merged into their type here.
+ * @param type time and calls of a type
+ */
+static void lv_prof_type_add(const lv_prof_type_t * type)
+{
+    uint8_t i;
+    for(i = 0; i < frame_act.type_cnt; i++) {
+        if(frame_act.types[i].type == type->type || strcmp(frame_act.types[i].type, type->type) == 0) break;
+    }
+
+    if(i == frame_act.type_cnt) {
+        if(frame_act.type_cnt >= LV_PROF_TYPE_MAX) return;
+        frame_act.types[i] = *type;
+        frame_act.type_cnt++;
+        return;
+    }
+
+    frame_act.types[i].time += type->time;
+    frame_act.types[i].cnt += type->cnt;
+}
+
+#endif /*LV_USE_PROF*/
@@ -0,0 +1,260 @@
+/**
+ * @file lv_prof.h
+ * Measure the refreshes of the displays and the tasks frame by frame.
+ * The last `LV_PROF_FRAME_CNT` frames are kept in a ring buffer to show or save them.
+ */
+
+#ifndef LV_PROF_H
+#define LV_PROF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lv_obj.h"
+#include "../lv_misc/lv_task.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*Counted drawing operations. A cost model of a target can estimate the drawing time from them.*/
+enum {
+    LV_PROF_DRAW_FILL,        /*Opaque filled pixels*/
+    LV_PROF_DRAW_BLEND,       /*Filled pixels with opacity*/
+    LV_PROF_DRAW_AA,          /*Anti-aliasing pixels (drawn one by one)*/
+    LV_PROF_DRAW_GLYPH,       /*Drawn letters*/
+    LV_PROF_DRAW_GLYPH_PX,    /*Pixels of the letters' boxes on the mask*/
+    LV_PROF_DRAW_IMG_TRUE,    /*Copied image pixels without transparency*/
+    LV_PROF_DRAW_IMG_CHROMA,  /*Copied chroma keyed image pixels*/
+    LV_PROF_DRAW_IMG_ALPHA,   /*Copied image pixels with an alpha byte*/
+    LV_PROF_DRAW_IMG_DECODE,  /*Image pixels read line by line by a decoder (indexed, alpha only, files), copied too*/
+    LV_PROF_DRAW_SHADOW,      /*Pixels of the shadows' area on the mask*/
+    LV_PROF_DRAW_NUM
+};
+typedef uint8_t lv_prof_draw_t;
+
+#if LV_USE_PROF
+
+/*Time spent in the design functions of one object type*/
+typedef struct
+{
+    const char * type; /*E.g. "lv_btn"*/
+    uint32_t time;     /*[us], summed on all drawing threads*/
+    uint32_t cnt;      /*Number of `design_cb` calls*/
+} lv_prof_type_t;
+
+/*One refresh of a display*/
+typedef struct
+{
+    uint32_t start;      /*Start of the refresh [us]*/
+    uint32_t refr_time;  /*Whole refresh [us]*/
+    uint32_t draw_time;  /*In the design functions [us], summed on all drawing threads*/
+    uint32_t flush_time; /*In `flush_cb` and waiting for the flushing [us]*/
+    uint32_t task_time;  /*In the other tasks since the previous frame [us]*/
+    uint32_t px_num;     /*Redrawn pixels*/
+    uint16_t inv_cnt;    /*Invalidated areas*/
+    uint16_t area_cnt;   /*Areas after joining them*/
+    uint16_t task_cnt;   /*Number of the other tasks run since the previous frame*/
+    uint8_t type_cnt;
+    lv_prof_type_t types[LV_PROF_TYPE_MAX];
+    uint32_t draw[LV_PROF_DRAW_NUM]; /*Drawing operations, summed on all drawing threads*/
+} lv_prof_frame_t;
+
+/**
+ * Called after every `design_cb` call while measuring
+ * @param obj the drawn object
+ * @param time time of the call [us]
+ * @param draw the drawing operations of the call, `LV_PROF_DRAW_NUM` counters
+ */
+typedef void (*lv_prof_design_cb_t)(lv_obj_t * obj, uint32_t time, const uint32_t * draw);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Init the measuring in the active context. Called by `lv_context_init`.
+ */
+void lv_prof_init(void);
+
+/**
+ * Start or stop the measuring. It's stopped by default.
+ * @param en true: measure the refreshes and the tasks
+ */
+void lv_prof_set_en(bool en);
+
+/**
+ * Tell whether the measuring is running
+ * @return true: running
+ */
+bool lv_prof_get_en(void);
+
+/**
+ * Forget the measured frames (of every context)
+ */
+void lv_prof_clean(void);
+
+/**
+ * Get the number of the stored frames
+ * @return number of frames (at most `LV_PROF_FRAME_CNT`)
+ */
+uint16_t lv_prof_get_frame_cnt(void);
+
+/**
+ * Get one of the stored frames
+ * @param id index of the frame, 0: the oldest one, `lv_prof_get_frame_cnt() - 1`: the last one
+ * @return pointer to the frame or NULL if `id` is too large
+ */
+const lv_prof_frame_t * lv_prof_get_frame(uint16_t id);
+
+/**
+ * Set a function to call after every `design_cb` call, e.g. to measure the objects one by one.
+ * It's called on the drawing threads with `LV_REFR_THREADS > 1`.
+ * @param cb the function or NULL to remove it
+ */
+void lv_prof_set_design_cb(lv_prof_design_cb_t cb);
+
+/**
+ * Get the time of the profiler's clock
+ * @return time in microseconds (wraps around)
+ */
+uint32_t lv_prof_time(void);
+
+/*=====================
+ * Called by the library
+ *====================*/
+
+/**
+ * Get the start time of a measurement
+ * @return the time [us] to pass to the other functions or 0 if the measuring is stopped
+ */
+uint32_t lv_prof_start(void);
+
+/**
+ * Start measuring a new refresh. Called by `lv_disp_refr_task`.
+ * @param inv_cnt number of invalidated areas
+ */
+void lv_prof_refr_begin(uint16_t inv_cnt);
+
+/**
+ * Set the number of areas after joining them
+ * @param area_cnt number of areas to redraw
+ */
+void lv_prof_refr_areas(uint16_t area_cnt);
+
+/**
+ * Account the time of a `design_cb` call. Can be called on any drawing thread.
+ * @param obj the drawn object
+ * @param start return value of `lv_prof_start` before the call
+ */
+void lv_prof_refr_design(lv_obj_t * obj, uint32_t start);
+
+/**
+ * Count drawing operations of the current thread. Called by the drawing functions.
+ * @param draw which operation, an element of `LV_PROF_DRAW_...`
+ * @param cnt number of them (e.g. pixels)
+ */
+void lv_prof_draw_add(lv_prof_draw_t draw, uint32_t cnt);
+
+/**
+ * Add the design times collected by the current thread to the frame. Needs `lv_thread_lock`.
+ */
+void lv_prof_refr_merge(void);
+
+/**
+ * Account the time of a flushing or waiting for it
+ * @param start return value of `lv_prof_start` before the flushing
+ */
+void lv_prof_refr_flush(uint32_t start);
+
+/**
+ * Store the measured refresh as a new frame
+ * @param start return value of `lv_prof_start` at the beginning of the refresh
+ * @param px_num number of redrawn pixels
+ */
+void lv_prof_refr_end(uint32_t start, uint32_t px_num);
+
+/**
+ * Account the time of a task. The refresh tasks are measured as the frames.
+ * @param task_cb the callback of the executed task (the task might be deleted already)
+ * @param start return value of `lv_prof_start` before the `task_cb`
+ */
+void lv_prof_task(lv_task_cb_t task_cb, uint32_t start);
+
+#else
+
+static inline uint32_t lv_prof_start(void)
+{
+    return 0;
+}
+
+static inline void lv_prof_refr_begin(uint16_t inv_cnt)
+{
+    (void)inv_cnt;
+}
+
+static inline void lv_prof_refr_areas(uint16_t area_cnt)
+{
+    (void)area_cnt;
+}
+
+static inline void lv_prof_refr_design(lv_obj_t * obj, uint32_t start)
+{
+    (void)obj;
+    (void)start;
+}
+
+static inline void lv_prof_draw_add(lv_prof_draw_t draw, uint32_t cnt)
+{
+    (void)draw;
+    (void)cnt;
+}
+
+static inline void lv_prof_refr_merge(void)
+{
+}
+
+static inline void lv_prof_refr_flush(uint32_t start)
+{
+    (void)start;
+}
+
+static inline void lv_prof_refr_end(uint32_t start, uint32_t px_num)
+{
+    (void)start;
+    (void)px_num;
+}
+
+static inline void lv_prof_task(lv_task_cb_t task_cb, uint32_t start)
+{
+    (void)task_cb;
+    (void)start;
+}
+
+#endif /*LV_USE_PROF*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_PROF_H*/
@@ -9,11 +9,16 @@
 #include <stddef.h>
 #include "lv_refr.h"
 #include "lv_disp.h"
+#include "lv_prof.h"
+#include "lv_layer.h"
 #include "../lv_hal/lv_hal_tick.h"
 #include "../lv_hal/lv_hal_disp.h"
 #include "../lv_misc/lv_task.h"
 #include "../lv_misc/lv_mem.h"
 #include "../lv_misc/lv_gc.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_misc/lv_anim.h"
 #include "../lv_draw/lv_draw.h"
 
 #if defined(LV_GC_INCLUDE)
@@ -26,27 +31,109 @@
 /* Draw translucent random colored areas on the invalidated (redrawn) areas*/
 #define MASK_AREA_DEBUG 0
 
+/*Don't split an area to bands lower than this in parallel drawing*/
+#define LV_REFR_BAND_MIN_ROWS 16
+
+/*Max. number of opaque siblings remembered to skip the covered parts of the objects below them*/
+#define LV_REFR_OCCLUDER_MAX 8
+
+/*The bitmaps of the cached objects and the snapshots are drawn up to an object (see `lv_refr_layer_render`)*/
+#define LV_REFR_LAYER_RENDER (LV_USE_LAYER_CACHE || LV_USE_SLIDE_SNAPSHOT)
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_REFR_THREADS > 1
+typedef struct
+{
+    const lv_area_t * mask;
+    uint16_t band_cnt;
+} lv_refr_bands_t;
+#endif
+
+typedef struct
+{
+    lv_area_t area; /*Opaque part of an object on the mask*/
+    uint32_t idx;   /*Index of the object among its siblings counted from the top most*/
+} lv_refr_occluder_t;
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    uint32_t px_num;
+    uint32_t px_occluded;  /*Pixels not drawn in the last refresh because they were covered*/
+    lv_disp_t * disp_refr; /*Display being refreshed*/
+#if LV_REFR_LAYER_RENDER
+    lv_obj_t * layer_act; /*The cached object whose bitmap (or snapshot) is being drawn*/
+    bool layer_done;      /*`layer_act` is drawn, nothing above it goes to the bitmap*/
+#endif
+} lv_refr_state_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void lv_refr_pace(lv_task_t * task, uint32_t start);
 static void lv_refr_join_area(void);
 static void lv_refr_areas(void);
 static void lv_refr_area(const lv_area_t * area_p);
 static void lv_refr_area_part(const lv_area_t * area_p);
+static void lv_refr_mask(const lv_area_t * mask_p);
+#if LV_REFR_THREADS > 1
+static void lv_refr_band_job(uint16_t job, void * user_data);
+#endif
 static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj);
 static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p);
 static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p);
+static void lv_refr_obj_draw(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask);
+static void lv_refr_obj_draw_children(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask);
+static void lv_refr_children(lv_obj_t * par, lv_obj_t * first, const lv_area_t * mask_p);
+static bool lv_refr_get_opaque_area(lv_obj_t * obj, const lv_area_t * mask_p, lv_area_t * res_p);
+static bool lv_refr_cull(lv_obj_t * obj, const lv_area_t * mask_p, const lv_refr_occluder_t * occ, uint8_t occ_cnt,
+                         lv_area_t * res_p);
 static void lv_refr_vdb_flush(void);
+static void lv_refr_buf_sync(uint8_t * buf_act, uint8_t * buf_ina, const lv_area_t * area_p);
+#if LV_DISP_BUF_MAX > 2
+static bool lv_refr_is_chain(lv_disp_t * disp);
+static void lv_refr_chain_prepare(void);
+static void lv_refr_chain_damage(void);
+static void lv_refr_chain_damage_add(lv_disp_buf_t * vdb, const lv_area_t * area_p);
+#endif
+#if LV_USE_SCROLL_BLIT
+static void lv_refr_scroll_exec(void);
+static bool lv_refr_is_covered_by(const lv_obj_t * obj, const lv_area_t * area);
+#endif
+#if LV_INV_TILE_SIZE
+static void lv_refr_tiles_mark(lv_disp_t * disp, const lv_area_t * area_p);
+static void lv_refr_tiles_to_areas(void);
+#endif
+#if LV_REFR_LAYER_RENDER
+static void lv_refr_layer_render(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area);
+#endif
+#if LV_USE_OPA_GROUP
+static bool lv_refr_is_opa_group(const lv_obj_t * obj);
+static void lv_refr_opa_group(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-static uint32_t px_num;
-static lv_disp_t * disp_refr; /*Display being refreshed*/
+#if LV_USE_CONTEXT
+#define refr_st ((lv_refr_state_t *)lv_context_act->refr_state)
+#else
+static lv_refr_state_t refr_state;
+#define refr_st (&refr_state)
+#endif
+#define px_num (refr_st->px_num)
+#define px_occluded (refr_st->px_occluded)
+#define disp_refr (refr_st->disp_refr)
+#if LV_REFR_LAYER_RENDER
+#define layer_act (refr_st->layer_act)
+#define layer_done (refr_st->layer_done)
+#endif
+static LV_THREAD_LOCAL uint32_t px_occluded_act; /*Counted by the drawing thread*/
+#if LV_USE_OPA_GROUP
+static LV_THREAD_LOCAL const lv_obj_t * opa_group_act; /*Drawn opaque by this thread, see `lv_refr_opa_group`*/
+#endif
 
 /**********************
  *      MACROS
@@ -61,7 +148,9 @@ static lv_disp_t * disp_refr; /*Display being refreshed*/
  */
 void lv_refr_init(void)
 {
-    /*Nothing to do*/
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->refr_state, sizeof(lv_refr_state_t));
+#endif
 }
 
 /**
@@ -93,12 +182,35 @@ void lv_refr_now(lv_disp_t * disp)
  */
 void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 {
+    lv_inv_area_by(disp, area_p, NULL);
+}
+
+/**
+ * Invalidate an area of an object on display to redraw it.
+ * Unlike `lv_inv_area` it keeps the bitmaps of the cached objects below `obj` (see `lv_obj_set_layer_cache`).
+ * @param disp pointer to display where the area should be invalidated (NULL can be used if there is
+ * only one display)
+ * @param area_p pointer to area which should be invalidated
+ * @param obj the object the area belongs to, NULL if unknown
+ */
+void lv_inv_area_by(lv_disp_t * disp, const lv_area_t * area_p, const lv_obj_t * obj)
+{
+#if LV_USE_LAYER_CACHE == 0
+    (void)obj; /*Unused*/
+#endif
     if(!disp) disp = lv_disp_get_default();
     if(!disp) return;
 
     /*Clear the invalidate buffer if the parameter is NULL*/
     if(area_p == NULL) {
         disp->inv_p = 0;
+#if LV_INV_TILE_SIZE
+        memset(disp->inv_tiles, 0, sizeof(disp->inv_tiles));
+        disp->inv_tile_act = 0;
+#endif
+#if LV_USE_SCROLL_BLIT
+        disp->scroll_act = 0;
+#endif
         return;
     }
 
@@ -115,8 +227,33 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
 
     /*The area is truncated to the screen*/
     if(suc != false) {
+#if LV_USE_LAYER_CACHE
+        /*Under a backdrop: its bitmap is shown until it's drawn again (see `lv_obj_set_layer_backdrop`)*/
+        if(lv_layer_inv(&com_area, obj) == false) return;
+#endif
         if(disp->driver.rounder_cb) disp->driver.rounder_cb(&disp_refr->driver, &com_area);
 
+        /*The refresh task is paused while there is nothing to redraw*/
+        if(disp->refr_task) {
+            if(disp->refr_task->paused) {
+#if LV_USE_ANIMATION
+                /*A late step of the animations (e.g. after a long refresh) changes what was due earlier*/
+                disp->inv_tick = lv_anim_get_step_due();
+#else
+                disp->inv_tick = lv_tick_get();
+#endif
+            }
+            lv_task_resume(disp->refr_task);
+        }
+
+#if LV_INV_TILE_SIZE
+        /*The buffer has already overflowed in this period so just mark the tiles*/
+        if(disp->inv_tile_act) {
+            lv_refr_tiles_mark(disp, &com_area);
+            return;
+        }
+#endif
+
         /*Save only if this area is not in one of the saved areas*/
         uint16_t i;
         for(i = 0; i < disp->inv_p; i++) {
@@ -126,14 +263,148 @@ void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p)
         /*Save the area*/
         if(disp->inv_p < LV_INV_BUF_SIZE) {
             lv_area_copy(&disp->inv_areas[disp->inv_p], &com_area);
-        } else { /*If no place for the area add the screen*/
+        } else {
+#if LV_INV_TILE_SIZE
+            /*If no place for the area move all the areas to the tiles*/
+            for(i = 0; i < disp->inv_p; i++) {
+                lv_refr_tiles_mark(disp, &disp->inv_areas[i]);
+            }
+            lv_refr_tiles_mark(disp, &com_area);
+            disp->inv_p        = 0;
+            disp->inv_tile_act = 1;
+            return;
+#else
+            /*If no place for the area add the screen*/
             disp->inv_p = 0;
             lv_area_copy(&disp->inv_areas[disp->inv_p], &scr_area);
+#endif
         }
         disp->inv_p++;
     }
 }
 
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the pixels of an area in the frame buffer instead of redrawing them, e.g. to scroll.
+ * The pixels are moved at the beginning of the next refresh. The exposed part of the area
+ * and the moved copies of the already invalidated areas are invalidated here.
+ * Works only with true double buffering because only then the buffer holds the whole screen.
+ * @param disp pointer to a display (NULL: the default display)
+ * @param area_p area on the display whose content moves together
+ * @param x horizontal movement
+ * @param y vertical movement
+ * @return true: the pixels will be moved; false: not possible, the area should be invalidated
+ */
+bool lv_refr_scroll(lv_disp_t * disp, const lv_area_t * area_p, lv_coord_t x, lv_coord_t y)
+{
+    if(!disp) disp = lv_disp_get_default();
+    if(!disp) return false;
+
+    lv_area_t scr_area;
+    scr_area.x1 = 0;
+    scr_area.y1 = 0;
+    scr_area.x2 = lv_disp_get_hor_res(disp) - 1;
+    scr_area.y2 = lv_disp_get_ver_res(disp) - 1;
+
+    lv_area_t area;
+    bool ok = lv_area_intersect(&area, area_p, &scr_area);
+
+    if(lv_disp_is_true_double_buf(disp) == false || disp->driver.set_px_cb) ok = false;
+#if LV_INV_TILE_SIZE
+    /*The tiles can't be moved*/
+    if(disp->inv_tile_act) ok = false;
+#endif
+
+    if(disp->scroll_act && (ok == false || area.x1 != disp->scroll_area.x1 || area.y1 != disp->scroll_area.y1 ||
+                            area.x2 != disp->scroll_area.x2 || area.y2 != disp->scroll_area.y2)) {
+        /*The pending move can't be combined with this one: just redraw its area.
+         * The moved copies of it are invalidated below if this one is made*/
+        disp->scroll_act = 0;
+        lv_inv_area(disp, &disp->scroll_area);
+#if LV_INV_TILE_SIZE
+        if(disp->inv_tile_act) ok = false;
+#endif
+    }
+
+    if(ok == false) return false;
+
+    /*The pixels which will be redrawn anyway are redrawn after the move too*/
+    uint16_t inv_cnt = disp->inv_p;
+    uint16_t i;
+    for(i = 0; i < inv_cnt; i++) {
+        lv_area_t moved;
+        if(lv_area_intersect(&moved, &disp->inv_areas[i], &area) == false) continue;
+        moved.x1 += x;
+        moved.y1 += y;
+        moved.x2 += x;
+        moved.y2 += y;
+        if(lv_area_intersect(&moved, &moved, &area)) lv_inv_area(disp, &moved);
+    }
+
+    /*Invalidate the exposed parts: they come from outside of the area*/
+    lv_area_t exp_area;
+    lv_area_copy(&exp_area, &area);
+    if(y > 0) exp_area.y2 = LV_MATH_MIN(area.y2, area.y1 + y - 1);
+    else if(y < 0) exp_area.y1 = LV_MATH_MAX(area.y1, area.y2 + y + 1);
+    if(y != 0) lv_inv_area(disp, &exp_area);
+
+    lv_area_copy(&exp_area, &area);
+    if(x > 0) exp_area.x2 = LV_MATH_MIN(area.x2, area.x1 + x - 1);
+    else if(x < 0) exp_area.x1 = LV_MATH_MAX(area.x1, area.x2 + x + 1);
+    if(x != 0) lv_inv_area(disp, &exp_area);
+
+    if(disp->scroll_act == 0) {
+        lv_area_copy(&disp->scroll_area, &area);
+        disp->scroll_ofs.x = 0;
+        disp->scroll_ofs.y = 0;
+        disp->scroll_act   = 1;
+    }
+    disp->scroll_ofs.x += x;
+    disp->scroll_ofs.y += y;
+
+    return true;
+}
+
+/**
+ * Check whether something is drawn after an object on an area: its upper siblings, the ones of its parents
+ * and the layers above its screen. The pixels of such an area can't be moved for the object.
+ * @param obj pointer to an object
+ * @param area the area on the display
+ * @return true: something is drawn on the area after `obj`
+ */
+bool lv_refr_is_covered(const lv_obj_t * obj, const lv_area_t * area)
+{
+    lv_obj_t * scr   = lv_obj_get_screen(obj);
+    lv_disp_t * disp = lv_obj_get_disp(scr);
+
+    if(lv_refr_is_covered_by(obj, area)) return true;
+    if(scr == lv_disp_get_scr_act(disp) && lv_refr_is_covered_by(lv_disp_get_layer_top(disp), area)) return true;
+    if(scr != lv_disp_get_layer_sys(disp) && lv_refr_is_covered_by(lv_disp_get_layer_sys(disp), area)) return true;
+
+    return false;
+}
+#endif
+
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Draw the screen and the layers up to and including an object (nothing above it) on an area into a bitmap.
+ * Called out of the refresh, e.g. to animate the object as a bitmap.
+ * @param obj pointer to an object on the active screen or a layer
+ * @param buf `lv_area_get_size(area)` pixels
+ * @param area the area on the display
+ */
+void lv_refr_snapshot(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area)
+{
+    /*The deferred layouts are done before drawing as in the refresh*/
+    lv_obj_layout_flush();
+
+    lv_disp_t * disp_ori = disp_refr;
+    disp_refr            = lv_obj_get_disp(obj);
+    lv_refr_layer_render(obj, buf, area);
+    disp_refr = disp_ori;
+}
+#endif
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -154,6 +425,28 @@ void lv_refr_set_disp_refreshing(lv_disp_t * disp)
     disp_refr = disp;
 }
 
+/**
+ * Get the number of pixels which were not drawn in the last refresh
+ * because an opaque object above them covered them.
+ * @return number of pixels
+ */
+uint32_t lv_refr_get_occluded_px(void)
+{
+    return px_occluded;
+}
+
+#if LV_USE_OPA_GROUP
+/**
+ * Get the object whose children are being drawn opaque by the calling thread to blend them at once.
+ * Its opa scale isn't applied on them (see `lv_obj_get_opa_scale`).
+ * @return pointer to an object or NULL if there is no such object
+ */
+const lv_obj_t * lv_refr_get_opa_group(void)
+{
+    return opa_group_act;
+}
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param task pointer to the task itself
@@ -162,16 +455,55 @@ void lv_disp_refr_task(lv_task_t * task)
 {
     LV_LOG_TRACE("lv_refr_task: started");
 
-    uint32_t start = lv_tick_get();
+    uint32_t start      = lv_tick_get();
+    uint32_t prof_start = lv_prof_start();
 
     disp_refr = task->user_data;
 
+    lv_refr_pace(task, start);
+
+    /*The deferred layouts move and resize objects, so they invalidate areas too*/
+    lv_obj_layout_flush();
+
+    lv_prof_refr_begin(disp_refr->inv_p);
+
     lv_refr_join_area();
 
+#if LV_USE_PROF
+    uint16_t area_cnt = 0;
+    uint16_t i;
+    for(i = 0; i < disp_refr->inv_p; i++) {
+        if(disp_refr->inv_area_joined[i] == 0) area_cnt++;
+    }
+    lv_prof_refr_areas(area_cnt);
+#endif
+
+#if LV_DISP_BUF_MAX > 2
+    /*Bring the next buffer of the swap chain up to date before moving or drawing into it*/
+    if(disp_refr->inv_p != 0 && lv_refr_is_chain(disp_refr)) lv_refr_chain_prepare();
+#endif
+
+#if LV_USE_SCROLL_BLIT
+    lv_refr_scroll_exec();
+#endif
+
+#if LV_USE_LAYER_CACHE
+    /*Draw the outdated bitmaps of the cached objects before the drawing threads copy them*/
+    lv_layer_refr(disp_refr, lv_refr_layer_render);
+#endif
+
     lv_refr_areas();
 
     /*If refresh happened ...*/
     if(disp_refr->inv_p != 0) {
+#if LV_DISP_BUF_MAX > 2
+        /*With a swap chain don't wait for the flushing. The refreshed areas are only noted
+         * for the other buffers and copied into them before drawing into them*/
+        if(lv_refr_is_chain(disp_refr)) {
+            lv_refr_chain_damage();
+            lv_refr_vdb_flush();
+        } else
+#endif
         /*In true double buffered mode copy the refreshed areas to the new VDB to keep it up to
          * date*/
         if(lv_disp_is_true_double_buf(disp_refr)) {
@@ -183,41 +515,50 @@ void lv_disp_refr_task(lv_task_t * task)
             /* With true double buffering the flushing should be only the address change of the
              * current frame buffer. Wait until the address change is ready and copy the changed
              * content to the other frame buffer (new active VDB) to keep the buffers synchronized*/
+            uint32_t wait_start = lv_prof_start();
             while(vdb->flushing)
                 ;
+            lv_prof_refr_flush(wait_start);
 
             uint8_t * buf_act = (uint8_t *)vdb->buf_act;
             uint8_t * buf_ina = (uint8_t *)vdb->buf_act == vdb->buf1 ? vdb->buf2 : vdb->buf1;
 
-            lv_coord_t hres = lv_disp_get_hor_res(disp_refr);
             uint16_t a;
             for(a = 0; a < disp_refr->inv_p; a++) {
-                if(disp_refr->inv_area_joined[a] == 0) {
-                    lv_coord_t y;
-                    uint32_t start_offs =
-                        (hres * disp_refr->inv_areas[a].y1 + disp_refr->inv_areas[a].x1) * sizeof(lv_color_t);
-                    uint32_t line_length = lv_area_get_width(&disp_refr->inv_areas[a]) * sizeof(lv_color_t);
-
-                    for(y = disp_refr->inv_areas[a].y1; y <= disp_refr->inv_areas[a].y2; y++) {
-                        memcpy(buf_act + start_offs, buf_ina + start_offs, line_length);
-                        start_offs += hres * sizeof(lv_color_t);
-                    }
-                }
+                if(disp_refr->inv_area_joined[a] == 0) lv_refr_buf_sync(buf_act, buf_ina, &disp_refr->inv_areas[a]);
             }
+
+#if LV_USE_SCROLL_BLIT
+            /*The moved pixels are new in the other buffer too*/
+            if(disp_refr->scroll_act) lv_refr_buf_sync(buf_act, buf_ina, &disp_refr->scroll_area);
+#endif
         } /*End of true double buffer handling*/
 
         /*Clean up*/
         memset(disp_refr->inv_areas, 0, sizeof(disp_refr->inv_areas));
         memset(disp_refr->inv_area_joined, 0, sizeof(disp_refr->inv_area_joined));
         disp_refr->inv_p = 0;
+#if LV_USE_SCROLL_BLIT
+        disp_refr->scroll_act = 0;
+#endif
+#if LV_INV_TILE_SIZE
+        memset(disp_refr->inv_tiles, 0, sizeof(disp_refr->inv_tiles));
+        disp_refr->inv_tile_act = 0;
+#endif
 
         /*Call monitor cb if present*/
         if(disp_refr->driver.monitor_cb) {
             disp_refr->driver.monitor_cb(&disp_refr->driver, lv_tick_elaps(start), px_num);
         }
+
+        lv_prof_refr_end(prof_start, px_num);
     }
 
     lv_draw_free_buf();
+    lv_mem_apply_cache_budget(); /*The caches grew while drawing*/
+
+    /*Everything is redrawn so wait for a new invalidation (`lv_inv_area` resumes the task)*/
+    lv_task_pause(task);
 
     LV_LOG_TRACE("lv_refr_task: ready");
 }
@@ -226,11 +567,46 @@ void lv_disp_refr_task(lv_task_t * task)
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Keep the refreshes on the cadence of the refresh period and count the missed ones.
+ * A refresh is due a period after the previous one was due, or at the first invalidation after it.
+ * Counting the next period from when it was due (and not from when the task ran) avoids the drift
+ * of the late runs, so animations stay at the display's rate.
+ * @param task the refresh task
+ * @param start when the refresh started
+ */
+static void lv_refr_pace(lv_task_t * task, uint32_t start)
+{
+    uint32_t period = task->period;
+    uint32_t due    = disp_refr->refr_due + period;
+    if((int32_t)(disp_refr->inv_tick - due) > 0) due = disp_refr->inv_tick;
+    if((int32_t)(start - due) < 0) due = start; /*E.g. `lv_task_ready` or `lv_refr_now`*/
+
+    uint32_t late = start - due;
+    if(period && late >= period) {
+        /*Some refreshes were skipped. Don't catch up with them, start a new cadence.*/
+        disp_refr->missed_frames += late / period;
+        LV_LOG_INFO("lv_refr_pace: missed frames");
+        due = start;
+    }
+
+    disp_refr->refr_due = due;
+    task->last_run      = due;
+}
+
 /**
  * Join the areas which has got common parts
  */
 static void lv_refr_join_area(void)
 {
+#if LV_INV_TILE_SIZE
+    /*The areas made from the tiles don't need to be joined*/
+    if(disp_refr->inv_tile_act) {
+        lv_refr_tiles_to_areas();
+        return;
+    }
+#endif
+
     uint32_t join_from;
     uint32_t join_in;
     lv_area_t joined_area;
@@ -271,15 +647,32 @@ static void lv_refr_areas(void)
     px_num = 0;
     uint32_t i;
 
+    if(disp_refr->inv_p == 0) return;
+
+    px_occluded     = 0;
+    px_occluded_act = 0;
+
+#if LV_USE_OVERDRAW
+    /*Count the drawings of the whole frame, so the overlapping parts of the areas too*/
+    for(i = 0; i < disp_refr->inv_p; i++) {
+        if(disp_refr->inv_area_joined[i] == 0) lv_draw_overdraw_clear(&disp_refr->inv_areas[i]);
+    }
+#endif
+
     for(i = 0; i < disp_refr->inv_p; i++) {
         /*Refresh the unjoined areas*/
         if(disp_refr->inv_area_joined[i] == 0) {
 
             lv_refr_area(&disp_refr->inv_areas[i]);
 
-            if(disp_refr->driver.monitor_cb) px_num += lv_area_get_size(&disp_refr->inv_areas[i]);
+            px_num += lv_area_get_size(&disp_refr->inv_areas[i]);
         }
     }
+
+    lv_thread_lock();
+    px_occluded += px_occluded_act;
+    lv_prof_refr_merge();
+    lv_thread_unlock();
 }
 
 /**
@@ -383,29 +776,98 @@ static void lv_refr_area_part(const lv_area_t * area_p)
             ;
     }
 
-    lv_obj_t * top_p;
-
     /*Get the new mask from the original area and the act. VDB
      It will be a part of 'area_p'*/
     lv_area_t start_mask;
     lv_area_intersect(&start_mask, area_p, &vdb->area);
 
+#if LV_REFR_THREADS > 1
+    /*Draw horizontal bands of the mask in parallel. They are in the same VDB but don't overlap*/
+    lv_refr_bands_t bands;
+    bands.mask     = &start_mask;
+    bands.band_cnt = LV_MATH_MIN(lv_area_get_height(&start_mask) / LV_REFR_BAND_MIN_ROWS, LV_REFR_THREADS);
+    if(bands.band_cnt > 1) {
+        lv_thread_run(lv_refr_band_job, bands.band_cnt, &bands);
+    } else {
+        lv_refr_mask(&start_mask);
+    }
+#else
+    lv_refr_mask(&start_mask);
+#endif
+
+    /* In true double buffered mode flush only once when all areas were rendered.
+     * In normal mode flush after every area */
+    if(lv_disp_is_true_double_buf(disp_refr) == false) {
+        lv_refr_vdb_flush();
+    }
+
+    /*The temporaries of the drawing are not needed any more*/
+    lv_draw_scratch_reset();
+}
+
+/**
+ * Draw the objects of the active screen and the layers on a part of the VDB
+ * @param mask_p pointer to an area in the VDB
+ */
+static void lv_refr_mask(const lv_area_t * mask_p)
+{
     /*Get the most top object which is not covered by others*/
-    top_p = lv_refr_get_top_obj(&start_mask, lv_disp_get_scr_act(disp_refr));
+    lv_obj_t * top_p = lv_refr_get_top_obj(mask_p, lv_disp_get_scr_act(disp_refr));
 
     /*Do the refreshing from the top object*/
-    lv_refr_obj_and_children(top_p, &start_mask);
+    lv_refr_obj_and_children(top_p, mask_p);
 
     /*Also refresh top and sys layer unconditionally*/
-    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), &start_mask);
-    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), &start_mask);
+    lv_refr_obj_and_children(lv_disp_get_layer_top(disp_refr), mask_p);
+    lv_refr_obj_and_children(lv_disp_get_layer_sys(disp_refr), mask_p);
+}
 
-    /* In true double buffered mode flush only once when all areas were rendered.
-     * In normal mode flush after every area */
-    if(lv_disp_is_true_double_buf(disp_refr) == false) {
-        lv_refr_vdb_flush();
+#if LV_REFR_THREADS > 1
+/**
+ * Draw one horizontal band of a mask. Called by `lv_thread_run` on a drawing thread.
+ * @param job index of the band
+ * @param user_data pointer to a `lv_refr_bands_t`
+ */
+static void lv_refr_band_job(uint16_t job, void * user_data)
+{
+    lv_refr_bands_t * bands = user_data;
+    lv_coord_t h            = lv_area_get_height(bands->mask);
+
+    lv_area_t band;
+    band.x1 = bands->mask->x1;
+    band.x2 = bands->mask->x2;
+    band.y1 = bands->mask->y1 + (h * job) / bands->band_cnt;
+    band.y2 = bands->mask->y1 + (h * (job + 1)) / bands->band_cnt - 1;
+
+    /*A custom VDB write might pack 8 rows in a byte (pages of monochrome displays).
+     *Start the bands at every 8th row of the VDB so the threads don't write the same bytes.*/
+    if(disp_refr->driver.set_px_cb) {
+        lv_coord_t vdb_y1 = lv_disp_get_buf(disp_refr)->area.y1;
+        if(job != 0) band.y1 = vdb_y1 + ((band.y1 - vdb_y1 + 7) & ~0x7);
+        if(job != bands->band_cnt - 1) band.y2 = vdb_y1 + ((band.y2 + 1 - vdb_y1 + 7) & ~0x7) - 1;
+        band.y1 = LV_MATH_MIN(band.y1, bands->mask->y2 + 1);
+        band.y2 = LV_MATH_MIN(band.y2, bands->mask->y2);
     }
+
+    /*Count the culled pixels of the band separately because a thread can run more jobs*/
+    uint32_t occluded_save = px_occluded_act;
+    px_occluded_act        = 0;
+
+    if(band.y1 <= band.y2) lv_refr_mask(&band);
+
+    lv_thread_lock();
+    px_occluded += px_occluded_act;
+    lv_prof_refr_merge();
+    lv_thread_unlock();
+    px_occluded_act = occluded_save;
+
+    /*Every drawing thread has its own scratch arena*/
+    lv_draw_scratch_reset();
+
+    /*Only the thread of `lv_task_handler` frees its draw buffer after the refresh*/
+    if(job != 0) lv_draw_free_buf();
 }
+#endif
 
 /**
  * Search the most top object which fully covers an area
@@ -419,9 +881,23 @@ static lv_obj_t * lv_refr_get_top_obj(const lv_area_t * area_p, lv_obj_t * obj)
 
     /*If this object is fully cover the draw area check the children too */
     if(lv_area_is_in(area_p, &obj->coords) && obj->hidden == 0) {
-        lv_obj_t * i;
-        LV_LL_READ(obj->child_ll, i)
-        {
+#if LV_USE_LAYER_CACHE
+        /*The bitmap of a cached object is opaque and has its children too*/
+        if(obj->layer_cache && lv_layer_is_valid(obj, area_p)) return obj;
+#endif
+#if LV_USE_OPA_GROUP
+        /*Neither the group nor its children cover: it's blended on what's below it*/
+        if(lv_refr_is_opa_group(obj)) return NULL;
+#endif
+        lv_obj_t * i = lv_ll_get_head(&obj->child_ll);
+#if LV_USE_CHILD_BOUNDS
+        /*Only a child which has the whole area can cover it*/
+        lv_area_t child_bounds;
+        if(i != NULL && lv_obj_get_child_bounds(obj, &child_bounds) && lv_area_is_in(area_p, &child_bounds) == false) {
+            i = NULL;
+        }
+#endif
+        for(; i != NULL; i = lv_ll_get_next(&obj->child_ll, i)) {
             found_p = lv_refr_get_top_obj(area_p, i);
 
             /*If a children is ok then break*/
@@ -455,28 +931,26 @@ static void lv_refr_obj_and_children(lv_obj_t * top_p, const lv_area_t * mask_p)
      * In this case use the screen directly */
     if(top_p == NULL) top_p = lv_disp_get_scr_act(disp_refr);
 
-    /*Refresh the top object and its children*/
-    lv_refr_obj(top_p, mask_p);
+    lv_obj_t * par = lv_obj_get_parent(top_p);
 
-    /*Draw the 'younger' sibling objects because they can be on top_obj */
-    lv_obj_t * par;
-    lv_obj_t * border_p = top_p;
+    /*Refresh the top object with its children and the 'younger' siblings because they can be on top_obj*/
+    if(par == NULL) lv_refr_obj(top_p, mask_p);
+    else lv_refr_children(par, top_p, mask_p);
 
-    par = lv_obj_get_parent(top_p);
+    lv_obj_t * border_p = top_p;
 
     /*Do until not reach the screen*/
     while(par != NULL) {
         /*object before border_p has to be redrawn*/
-        lv_obj_t * i = lv_ll_get_prev(&(par->child_ll), border_p);
-
-        while(i != NULL) {
-            /*Refresh the objects*/
-            lv_refr_obj(i, mask_p);
-            i = lv_ll_get_prev(&(par->child_ll), i);
+        if(border_p != top_p) {
+            lv_obj_t * i = lv_ll_get_prev(&(par->child_ll), border_p);
+            if(i != NULL) lv_refr_children(par, i, mask_p);
         }
 
         /*Call the post draw design function of the parents of the to object*/
+        uint32_t prof_start = lv_prof_start();
         par->design_cb(par, mask_p, LV_DESIGN_DRAW_POST);
+        lv_prof_refr_design(par, prof_start);
 
         /*The new border will be there last parents,
          *so the 'younger' brothers of parent will be refreshed*/
@@ -496,10 +970,14 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
     /*Do not refresh hidden objects*/
     if(obj->hidden != 0) return;
 
+#if LV_REFR_LAYER_RENDER
+    /*A bitmap is being drawn and its object is ready: the rest is above it*/
+    if(layer_done) return;
+#endif
+
     bool union_ok; /* Store the return value of area_union */
     /* Truncate the original mask to the coordinates of the parent
      * because the parent and its children are visible only here */
-    lv_area_t obj_mask;
     lv_area_t obj_ext_mask;
     lv_area_t obj_area;
     lv_coord_t ext_size = obj->ext_draw_pad;
@@ -513,45 +991,234 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
     /*Draw the parent and its children only if they ore on 'mask_parent'*/
     if(union_ok != false) {
 
-        /* Redraw the object */
-        obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_MAIN);
+#if LV_USE_LAYER_CACHE
+        /*Copy the object with its children from its bitmap if it's up to date.
+         *The bitmap of a backdrop has only the object, the bitmap of a static part only that part.*/
+        if(obj->layer_cache && lv_layer_draw(obj, &obj_ext_mask)) {
+            if(obj->layer_static) {
+                uint32_t prof_start = lv_prof_start();
+                obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_DYNAMIC);
+                lv_prof_refr_design(obj, prof_start);
+            }
+            if(obj->layer_backdrop || obj->layer_static) lv_refr_obj_draw_children(obj, mask_ori_p, &obj_ext_mask);
+            return;
+        }
+#endif
+
+#if LV_USE_OPA_GROUP
+        if(lv_refr_is_opa_group(obj)) {
+            lv_refr_opa_group(obj, mask_ori_p, &obj_ext_mask);
+            return;
+        }
+#endif
+
+        lv_refr_obj_draw(obj, mask_ori_p, &obj_ext_mask);
+    }
+}
+
+/**
+ * Draw an object and its children
+ * @param obj pointer to an object to draw
+ * @param mask_ori_p pointer to an area, the children will be drawn only here
+ * @param obj_ext_mask `mask_ori_p` truncated to the coordinates of the object with its `ext_draw_pad`
+ */
+static void lv_refr_obj_draw(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask)
+{
+#if LV_USE_LAYER_CACHE
+    /*The bitmap of a static part ends with it*/
+    if(obj == layer_act && obj->layer_static) {
+        obj->design_cb(obj, obj_ext_mask, LV_DESIGN_DRAW_STATIC);
+        layer_done = true;
+        return;
+    }
+#endif
+
+    /* Redraw the object */
+    uint32_t prof_start = lv_prof_start();
+    obj->design_cb(obj, obj_ext_mask, LV_DESIGN_DRAW_MAIN);
+    lv_prof_refr_design(obj, prof_start);
 
 #if MASK_AREA_DEBUG
-        static lv_color_t debug_color = LV_COLOR_RED;
-        lv_draw_fill(&obj_ext_mask, &obj_ext_mask, debug_color, LV_OPA_50);
-        debug_color.full *= 17;
-        debug_color.full += 0xA1;
-#endif
-        /*Create a new 'obj_mask' without 'ext_size' because the children can't be visible there*/
-        lv_obj_get_coords(obj, &obj_area);
-        union_ok = lv_area_intersect(&obj_mask, mask_ori_p, &obj_area);
-        if(union_ok != false) {
-            lv_area_t mask_child; /*Mask from obj and its child*/
-            lv_obj_t * child_p;
-            lv_area_t child_area;
-            LV_LL_READ_BACK(obj->child_ll, child_p)
-            {
-                lv_obj_get_coords(child_p, &child_area);
-                ext_size = child_p->ext_draw_pad;
-                child_area.x1 -= ext_size;
-                child_area.y1 -= ext_size;
-                child_area.x2 += ext_size;
-                child_area.y2 += ext_size;
-                /* Get the union (common parts) of original mask (from obj)
-                 * and its child */
-                union_ok = lv_area_intersect(&mask_child, &obj_mask, &child_area);
-
-                /*If the parent and the child has common area then refresh the child */
-                if(union_ok) {
-                    /*Refresh the next children*/
-                    lv_refr_obj(child_p, &mask_child);
-                }
-            }
+    static lv_color_t debug_color = LV_COLOR_RED;
+    lv_draw_fill(obj_ext_mask, obj_ext_mask, debug_color, LV_OPA_50);
+    debug_color.full *= 17;
+    debug_color.full += 0xA1;
+#endif
+
+#if LV_USE_LAYER_CACHE
+    /*The bitmap of a backdrop ends here*/
+    if(obj == layer_act && obj->layer_backdrop) {
+        layer_done = true;
+        return;
+    }
+#endif
+
+    lv_refr_obj_draw_children(obj, mask_ori_p, obj_ext_mask);
+}
+
+/**
+ * Draw the children of an object and its 'post draw' part
+ * @param obj pointer to an object whose main part is drawn
+ * @param mask_ori_p pointer to an area, the children will be drawn only here
+ * @param obj_ext_mask `mask_ori_p` truncated to the coordinates of the object with its `ext_draw_pad`
+ */
+static void lv_refr_obj_draw_children(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask)
+{
+    /*Create a new 'obj_mask' without 'ext_size' because the children can't be visible there*/
+    lv_area_t obj_mask;
+    lv_area_t obj_area;
+    lv_obj_get_coords(obj, &obj_area);
+    if(lv_area_intersect(&obj_mask, mask_ori_p, &obj_area) != false) {
+        lv_obj_t * child_p = lv_ll_get_tail(&obj->child_ll);
+#if LV_USE_CHILD_BOUNDS
+        /*Don't visit the children if none of them is on the mask*/
+        lv_area_t child_bounds;
+        if(child_p != NULL && lv_obj_get_child_bounds(obj, &child_bounds) &&
+           lv_area_is_on(&child_bounds, &obj_mask) == false) {
+            child_p = NULL;
         }
+#endif
+        if(child_p != NULL) lv_refr_children(obj, child_p, &obj_mask);
+    }
+
+#if LV_REFR_LAYER_RENDER
+    /*The 'post draw' of the parents of a cached object is above it*/
+    if(layer_done) return;
+#endif
+
+    /* If all the children are redrawn make 'post draw' design */
+    uint32_t prof_start = lv_prof_start();
+    obj->design_cb(obj, obj_ext_mask, LV_DESIGN_DRAW_POST);
+    lv_prof_refr_design(obj, prof_start);
+
+#if LV_REFR_LAYER_RENDER
+    if(obj == layer_act) layer_done = true;
+#endif
+}
+
+/**
+ * Refresh the children of an object from `first` to the top most one (Called recursively)
+ * The parts of a child which are covered by an opaque sibling above it are not drawn.
+ * @param par pointer to the parent
+ * @param first the first (bottom most) child to refresh
+ * @param mask_p pointer to an area, the objects will be drawn only here
+ */
+static void lv_refr_children(lv_obj_t * par, lv_obj_t * first, const lv_area_t * mask_p)
+{
+    lv_refr_occluder_t occ[LV_REFR_OCCLUDER_MAX];
+    uint8_t occ_cnt = 0;
+    uint32_t idx    = 0;
+    lv_obj_t * i;
+
+    /*Collect the opaque siblings above `first`. The top most ones are the most useful.
+     *The bitmap of a cached object has no siblings above it, so it can't skip anything below them.*/
+    i = lv_ll_get_head(&par->child_ll);
+#if LV_REFR_LAYER_RENDER
+    if(layer_act != NULL) i = first;
+#endif
+    for(; i != first; i = lv_ll_get_next(&par->child_ll, i)) {
+        if(occ_cnt < LV_REFR_OCCLUDER_MAX && lv_refr_get_opaque_area(i, mask_p, &occ[occ_cnt].area)) {
+            occ[occ_cnt].idx = idx;
+            occ_cnt++;
+        }
+        idx++;
+    }
+
+    /*Draw from the bottom to the top*/
+    lv_area_t child_mask;
+    for(i = first; i != NULL; i = lv_ll_get_prev(&par->child_ll, i)) {
+        /*Only the siblings above can cover the child*/
+        while(occ_cnt > 0 && occ[occ_cnt - 1].idx >= idx) occ_cnt--;
+
+        if(lv_refr_cull(i, mask_p, occ, occ_cnt, &child_mask)) lv_refr_obj(i, &child_mask);
 
-        /* If all the children are redrawn make 'post draw' design */
-        obj->design_cb(obj, &obj_ext_mask, LV_DESIGN_DRAW_POST);
+        if(idx > 0) idx--;
+    }
+}
+
+/**
+ * Get the part of an object which surely covers what is below it
+ * @param obj pointer to an object
+ * @param mask_p pointer to an area, only the opaque part here is interesting
+ * @param res_p result area
+ * @return true: `res_p` is valid; false: the object doesn't cover anything on the mask
+ */
+static bool lv_refr_get_opaque_area(lv_obj_t * obj, const lv_area_t * mask_p, lv_area_t * res_p)
+{
+    if(obj->hidden != 0) return false;
+    if(lv_obj_get_opa_scale(obj) != LV_OPA_COVER) return false;
+
+    /*Some objects swap their style while drawing on an other thread*/
+    lv_thread_lock();
+
+    /*The rounded corners doesn't cover*/
+    bool cover               = false;
+    const lv_style_t * style = lv_obj_get_style(obj);
+    if(style->body.radius != LV_RADIUS_CIRCLE) {
+        lv_area_t a;
+        lv_obj_get_coords(obj, &a);
+        a.x1 += style->body.radius;
+        a.y1 += style->body.radius;
+        a.x2 -= style->body.radius;
+        a.y2 -= style->body.radius;
+        if(lv_area_intersect(res_p, &a, mask_p)) cover = obj->design_cb(obj, res_p, LV_DESIGN_COVER_CHK);
+    }
+
+    lv_thread_unlock();
+
+    return cover;
+}
+
+/**
+ * Get the mask of an object without the parts covered by its siblings above it
+ * @param obj pointer to an object
+ * @param mask_p pointer to the mask of the parent
+ * @param occ opaque areas of the siblings above `obj`
+ * @param occ_cnt number of elements in `occ`
+ * @param res_p the mask to draw `obj` with
+ * @return true: `obj` has to be drawn on `res_p`; false: `obj` is not visible on the mask
+ */
+static bool lv_refr_cull(lv_obj_t * obj, const lv_area_t * mask_p, const lv_refr_occluder_t * occ, uint8_t occ_cnt,
+                         lv_area_t * res_p)
+{
+    lv_area_t obj_area;
+    lv_coord_t ext_size = obj->ext_draw_pad;
+    lv_obj_get_coords(obj, &obj_area);
+    obj_area.x1 -= ext_size;
+    obj_area.y1 -= ext_size;
+    obj_area.x2 += ext_size;
+    obj_area.y2 += ext_size;
+    if(lv_area_intersect(res_p, mask_p, &obj_area) == false) return false;
+
+    uint8_t k;
+    for(k = 0; k < occ_cnt; k++) {
+        const lv_area_t * o = &occ[k].area;
+        if(lv_area_is_in(res_p, o)) {
+            px_occluded_act += lv_area_get_size(res_p);
+            return false;
+        }
+
+        /*The mask remains an area only if a whole edge is covered*/
+        if(o->x1 <= res_p->x1 && o->x2 >= res_p->x2) {
+            if(o->y1 <= res_p->y1 && o->y2 >= res_p->y1) {
+                px_occluded_act += (uint32_t)lv_area_get_width(res_p) * (o->y2 - res_p->y1 + 1);
+                res_p->y1 = o->y2 + 1;
+            } else if(o->y1 <= res_p->y2 && o->y2 >= res_p->y2) {
+                px_occluded_act += (uint32_t)lv_area_get_width(res_p) * (res_p->y2 - o->y1 + 1);
+                res_p->y2 = o->y1 - 1;
+            }
+        } else if(o->y1 <= res_p->y1 && o->y2 >= res_p->y2) {
+            if(o->x1 <= res_p->x1 && o->x2 >= res_p->x1) {
+                px_occluded_act += (uint32_t)lv_area_get_height(res_p) * (o->x2 - res_p->x1 + 1);
+                res_p->x1 = o->x2 + 1;
+            } else if(o->x1 <= res_p->x2 && o->x2 >= res_p->x2) {
+                px_occluded_act += (uint32_t)lv_area_get_height(res_p) * (res_p->x2 - o->x1 + 1);
+                res_p->x2 = o->x1 - 1;
+            }
+        }
     }
+
+    return true;
 }
 
 /**
@@ -560,6 +1227,22 @@ static void lv_refr_obj(lv_obj_t * obj, const lv_area_t * mask_ori_p)
 static void lv_refr_vdb_flush(void)
 {
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+    uint32_t prof_start = lv_prof_start();
+
+#if LV_DISP_BUF_MAX > 2
+    /*Only the next buffer has to be free. `lv_refr_chain_prepare` waits for it before drawing*/
+    if(lv_refr_is_chain(disp_refr)) {
+        __atomic_add_fetch(&vdb->in_flight, 1, __ATOMIC_ACQ_REL);
+
+        lv_disp_t * disp = lv_refr_get_disp_refreshing();
+        if(disp->driver.flush_cb) disp->driver.flush_cb(&disp->driver, &vdb->area, vdb->buf_act);
+        lv_prof_refr_flush(prof_start);
+
+        vdb->buf_idx = (vdb->buf_idx + 1) % vdb->buf_cnt;
+        vdb->buf_act = vdb->bufs[vdb->buf_idx];
+        return;
+    }
+#endif
 
     /*In double buffered mode wait until the other buffer is flushed before flushing the current
      * one*/
@@ -573,6 +1256,7 @@ static void lv_refr_vdb_flush(void)
     /*Flush the rendered content to the display*/
     lv_disp_t * disp = lv_refr_get_disp_refreshing();
     if(disp->driver.flush_cb) disp->driver.flush_cb(&disp->driver, &vdb->area, vdb->buf_act);
+    lv_prof_refr_flush(prof_start);
 
     if(vdb->buf1 && vdb->buf2) {
         if(vdb->buf_act == vdb->buf1)
@@ -581,3 +1265,427 @@ static void lv_refr_vdb_flush(void)
             vdb->buf_act = vdb->buf1;
     }
 }
+
+/**
+ * Copy an area of the just flushed frame buffer to the other one to keep them synchronized
+ * @param buf_act the buffer to copy to (the new active buffer)
+ * @param buf_ina the buffer to copy from
+ * @param area_p area on the screen
+ */
+static void lv_refr_buf_sync(uint8_t * buf_act, uint8_t * buf_ina, const lv_area_t * area_p)
+{
+    lv_coord_t hres      = lv_disp_get_hor_res(disp_refr);
+    uint32_t start_offs  = (hres * area_p->y1 + area_p->x1) * sizeof(lv_color_t);
+    uint32_t line_length = lv_area_get_width(area_p) * sizeof(lv_color_t);
+
+    lv_coord_t y;
+    for(y = area_p->y1; y <= area_p->y2; y++) {
+        memcpy(buf_act + start_offs, buf_ina + start_offs, line_length);
+        start_offs += hres * sizeof(lv_color_t);
+    }
+}
+
+#if LV_DISP_BUF_MAX > 2
+/**
+ * Check if a display draws directly into the screen sized buffers of a swap chain
+ * @param disp pointer to a display
+ * @return true: more than 2 screen sized buffers are used in turn
+ */
+static bool lv_refr_is_chain(lv_disp_t * disp)
+{
+    return disp->driver.buffer->buf_cnt > 2 && lv_disp_is_true_double_buf(disp);
+}
+
+/**
+ * Wait until the active buffer of the swap chain is free and
+ * copy the areas changed since it was drawn from the last flushed buffer
+ */
+static void lv_refr_chain_prepare(void)
+{
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+    /*The display still shows the buffer flushed before the ones in flight*/
+    uint32_t wait_start = lv_prof_start();
+    while(__atomic_load_n(&vdb->in_flight, __ATOMIC_ACQUIRE) > vdb->buf_cnt - 2)
+        ;
+    lv_prof_refr_flush(wait_start);
+
+    uint8_t * buf_act  = vdb->buf_act;
+    uint8_t * buf_last = vdb->bufs[(vdb->buf_idx + vdb->buf_cnt - 1) % vdb->buf_cnt];
+    uint8_t d;
+    for(d = 0; d < vdb->dmg_cnt[vdb->buf_idx]; d++) {
+        const lv_area_t * dmg = &vdb->dmg[vdb->buf_idx][d];
+
+        /*Skip the areas which are redrawn anyway. The moved pixels have to be up to date.*/
+        bool redrawn = false;
+#if LV_USE_SCROLL_BLIT
+        if(disp_refr->scroll_act == 0)
+#endif
+        {
+            uint16_t a;
+            for(a = 0; a < disp_refr->inv_p && redrawn == false; a++) {
+                if(disp_refr->inv_area_joined[a] == 0 && lv_area_is_in(dmg, &disp_refr->inv_areas[a])) redrawn = true;
+            }
+        }
+
+        if(redrawn == false) lv_refr_buf_sync(buf_act, buf_last, dmg);
+    }
+    vdb->dmg_cnt[vdb->buf_idx] = 0;
+}
+
+/**
+ * Note the areas refreshed in the active buffer as changed for the other buffers of the swap chain
+ */
+static void lv_refr_chain_damage(void)
+{
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+
+    uint16_t a;
+    for(a = 0; a < disp_refr->inv_p; a++) {
+        if(disp_refr->inv_area_joined[a] == 0) lv_refr_chain_damage_add(vdb, &disp_refr->inv_areas[a]);
+    }
+
+#if LV_USE_SCROLL_BLIT
+    /*The moved pixels are new in the other buffers too*/
+    if(disp_refr->scroll_act) lv_refr_chain_damage_add(vdb, &disp_refr->scroll_area);
+#endif
+}
+
+/**
+ * Add a changed area to the buffers of a swap chain except the active one
+ * @param vdb pointer to the display buffer
+ * @param area_p the changed area
+ */
+static void lv_refr_chain_damage_add(lv_disp_buf_t * vdb, const lv_area_t * area_p)
+{
+    uint8_t b;
+    for(b = 0; b < vdb->buf_cnt; b++) {
+        if(b == vdb->buf_idx) continue;
+
+        lv_area_t * dmg = vdb->dmg[b];
+        uint8_t d;
+        for(d = 0; d < vdb->dmg_cnt[b]; d++) {
+            if(lv_area_is_in(area_p, &dmg[d])) break;
+        }
+        if(d < vdb->dmg_cnt[b]) continue;
+
+        /*No more place: grow the last area to cover the new one too*/
+        if(vdb->dmg_cnt[b] == LV_DISP_BUF_DMG_MAX) {
+            lv_area_join(&dmg[LV_DISP_BUF_DMG_MAX - 1], &dmg[LV_DISP_BUF_DMG_MAX - 1], area_p);
+        } else {
+            lv_area_copy(&dmg[vdb->dmg_cnt[b]], area_p);
+            vdb->dmg_cnt[b]++;
+        }
+    }
+}
+#endif
+
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the pixels requested by `lv_refr_scroll` in the frame buffer of `disp_refr`
+ */
+static void lv_refr_scroll_exec(void)
+{
+    if(disp_refr->scroll_act == 0) return;
+
+    lv_coord_t x = disp_refr->scroll_ofs.x;
+    lv_coord_t y = disp_refr->scroll_ofs.y;
+
+    /*The pixels which come from inside of the area*/
+    lv_area_t dest;
+    lv_area_copy(&dest, &disp_refr->scroll_area);
+    if(x > 0) dest.x1 += x;
+    else dest.x2 += x;
+    if(y > 0) dest.y1 += y;
+    else dest.y2 += y;
+    if(dest.x1 > dest.x2 || dest.y1 > dest.y2 || (x == 0 && y == 0)) return;
+
+    lv_disp_buf_t * vdb  = lv_disp_get_buf(disp_refr);
+    lv_coord_t hres      = lv_disp_get_hor_res(disp_refr);
+    lv_color_t * buf     = vdb->buf_act;
+    uint32_t line_length = lv_area_get_width(&dest) * sizeof(lv_color_t);
+    int32_t src_ofs      = -((int32_t)y * hres + x);
+
+    /*Go against the movement to not overwrite the rows to move*/
+    lv_coord_t row;
+    if(y > 0) {
+        for(row = dest.y2; row >= dest.y1; row--) {
+            lv_color_t * d = &buf[(int32_t)row * hres + dest.x1];
+            memmove(d, d + src_ofs, line_length);
+        }
+    } else {
+        for(row = dest.y1; row <= dest.y2; row++) {
+            lv_color_t * d = &buf[(int32_t)row * hres + dest.x1];
+            memmove(d, d + src_ofs, line_length);
+        }
+    }
+}
+
+/**
+ * Check whether an object drawn after `obj` (its upper siblings and the ones of its parents) is on an area
+ * @param obj pointer to an object. If it's a screen or a layer its children are checked.
+ * @param area the area on the screen
+ * @return true: something is drawn on the area after `obj`
+ */
+static bool lv_refr_is_covered_by(const lv_obj_t * obj, const lv_area_t * area)
+{
+    lv_obj_t * par         = lv_obj_get_parent(obj);
+    const lv_obj_t * child = obj;
+
+    /*All children of a screen are drawn after it*/
+    if(par == NULL) {
+        par   = (lv_obj_t *)obj;
+        child = NULL;
+    }
+
+    while(par) {
+        /*Go up from `child` (or from the bottom one if NULL)*/
+        lv_obj_t * i = lv_obj_get_child_back(par, child);
+        while(i) {
+            if(lv_obj_get_hidden(i) == false) {
+                lv_area_t i_area;
+                lv_area_copy(&i_area, &i->coords);
+                i_area.x1 -= i->ext_draw_pad;
+                i_area.y1 -= i->ext_draw_pad;
+                i_area.x2 += i->ext_draw_pad;
+                i_area.y2 += i->ext_draw_pad;
+                if(lv_area_is_on(&i_area, area)) return true;
+            }
+            i = lv_obj_get_child_back(par, i);
+        }
+
+        if(child == NULL) break;
+        child = par;
+        par   = lv_obj_get_parent(par);
+    }
+
+    return false;
+}
+#endif
+
+#if LV_INV_TILE_SIZE
+/**
+ * Mark the tiles of an area as invalidated
+ * @param disp pointer to display
+ * @param area_p pointer to an area on the screen
+ */
+static void lv_refr_tiles_mark(lv_disp_t * disp, const lv_area_t * area_p)
+{
+    /*A screen larger than `LV_HOR/VER_RES_MAX` is handled by stretching the last row and column*/
+    lv_coord_t r1 = LV_MATH_MIN(area_p->y1 / LV_INV_TILE_SIZE, LV_INV_TILE_ROWS - 1);
+    lv_coord_t r2 = LV_MATH_MIN(area_p->y2 / LV_INV_TILE_SIZE, LV_INV_TILE_ROWS - 1);
+    lv_coord_t c1 = LV_MATH_MIN(area_p->x1 / LV_INV_TILE_SIZE, LV_INV_TILE_COLS - 1);
+    lv_coord_t c2 = LV_MATH_MIN(area_p->x2 / LV_INV_TILE_SIZE, LV_INV_TILE_COLS - 1);
+
+    lv_coord_t r;
+    lv_coord_t c;
+    for(r = r1; r <= r2; r++) {
+        for(c = c1; c <= c2; c++) {
+            disp->inv_tiles[r][c >> 5] |= (uint32_t)1 << (c & 0x1F);
+        }
+    }
+}
+
+/**
+ * Convert the invalidated tiles of `disp_refr` to areas in `inv_areas`.
+ * The rows are scanned once and a run of tiles continues the area of the same run in the row above.
+ * If `inv_areas` gets full the new runs are joined into the last area.
+ */
+static void lv_refr_tiles_to_areas(void)
+{
+    lv_coord_t hres = lv_disp_get_hor_res(disp_refr);
+    lv_coord_t vres = lv_disp_get_ver_res(disp_refr);
+    lv_coord_t cols = LV_MATH_MIN((hres + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE, LV_INV_TILE_COLS);
+    lv_coord_t rows = LV_MATH_MIN((vres + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE, LV_INV_TILE_ROWS);
+
+    /*Runs of the previous and the current row: first and last column and the index of their area*/
+    lv_coord_t run_c1[2][LV_INV_TILE_COLS / 2 + 1];
+    lv_coord_t run_c2[2][LV_INV_TILE_COLS / 2 + 1];
+    uint16_t run_area[2][LV_INV_TILE_COLS / 2 + 1];
+    uint16_t run_cnt[2] = {0, 0};
+    uint8_t prev = 0;
+    uint8_t act  = 1;
+
+    disp_refr->inv_p = 0;
+
+    lv_coord_t r;
+    for(r = 0; r < rows; r++) {
+        lv_coord_t y1 = r * LV_INV_TILE_SIZE;
+        lv_coord_t y2 = r == rows - 1 ? vres - 1 : y1 + LV_INV_TILE_SIZE - 1;
+        uint16_t p    = 0;
+        lv_coord_t c  = 0;
+        run_cnt[act]  = 0;
+        while(c < cols) {
+            if((disp_refr->inv_tiles[r][c >> 5] & ((uint32_t)1 << (c & 0x1F))) == 0) {
+                c++;
+                continue;
+            }
+
+            lv_coord_t c1 = c;
+            while(c < cols && (disp_refr->inv_tiles[r][c >> 5] & ((uint32_t)1 << (c & 0x1F)))) c++;
+            lv_coord_t c2 = c - 1;
+
+            /*The runs are ordered so the run above (if any) can be found by stepping forward*/
+            while(p < run_cnt[prev] && run_c2[prev][p] < c1) p++;
+
+            uint16_t a;
+            if(p < run_cnt[prev] && run_c1[prev][p] == c1 && run_c2[prev][p] == c2) {
+                a                          = run_area[prev][p];
+                disp_refr->inv_areas[a].y2 = y2;
+            } else {
+                lv_area_t run;
+                run.x1 = c1 * LV_INV_TILE_SIZE;
+                run.x2 = c2 == cols - 1 ? hres - 1 : (c2 + 1) * LV_INV_TILE_SIZE - 1;
+                run.y1 = y1;
+                run.y2 = y2;
+                if(disp_refr->inv_p < LV_INV_BUF_SIZE) {
+                    a = disp_refr->inv_p;
+                    lv_area_copy(&disp_refr->inv_areas[a], &run);
+                    disp_refr->inv_p++;
+                } else {
+                    a = disp_refr->inv_p - 1;
+                    lv_area_join(&disp_refr->inv_areas[a], &disp_refr->inv_areas[a], &run);
+                }
+            }
+
+            run_c1[act][run_cnt[act]]   = c1;
+            run_c2[act][run_cnt[act]]   = c2;
+            run_area[act][run_cnt[act]] = a;
+            run_cnt[act]++;
+        }
+
+        prev = act;
+        act  = act == 0 ? 1 : 0;
+    }
+
+    if(disp_refr->driver.rounder_cb) {
+        uint16_t i;
+        for(i = 0; i < disp_refr->inv_p; i++) {
+            disp_refr->driver.rounder_cb(&disp_refr->driver, &disp_refr->inv_areas[i]);
+        }
+    }
+}
+#endif
+
+#if LV_REFR_LAYER_RENDER
+/**
+ * Draw the bitmap of a cached object: the screens and the layers below it on the bitmap's area,
+ * then the object with its children. Called before the drawing threads are started or out of the refresh.
+ * @param obj pointer to a cached object
+ * @param buf the bitmap, `lv_area_get_size(area)` pixels
+ * @param area the area of the bitmap on the display
+ */
+static void lv_refr_layer_render(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area)
+{
+    /*Draw into the bitmap as if it was the VDB*/
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+    lv_area_t vdb_area;
+    lv_area_copy(&vdb_area, &vdb->area);
+    void * vdb_buf = vdb->buf_act;
+    lv_area_copy(&vdb->area, area);
+    vdb->buf_act = buf;
+
+#if LV_USE_OVERDRAW
+    /*Only the drawings of the frame are counted*/
+    bool overdraw_en = lv_draw_overdraw_get_en();
+    lv_draw_overdraw_set_en(false);
+#endif
+
+    layer_act  = obj;
+    layer_done = false;
+
+    /*The screen is below the top layer and both are below the system layer*/
+    lv_obj_t * scr = lv_obj_get_screen(obj);
+    lv_refr_obj(lv_disp_get_scr_act(disp_refr), area);
+    if(scr != lv_disp_get_scr_act(disp_refr)) lv_refr_obj(lv_disp_get_layer_top(disp_refr), area);
+    if(scr == lv_disp_get_layer_sys(disp_refr)) lv_refr_obj(scr, area);
+
+    layer_act  = NULL;
+    layer_done = false;
+
+#if LV_USE_OVERDRAW
+    lv_draw_overdraw_set_en(overdraw_en);
+#endif
+
+    lv_area_copy(&vdb->area, &vdb_area);
+    vdb->buf_act = vdb_buf;
+
+    lv_draw_scratch_reset();
+}
+#endif
+
+#if LV_USE_OPA_GROUP
+/**
+ * Check if an object is blended at once with its children
+ * @param obj pointer to an object
+ * @return true: it has opa scale and children
+ */
+static bool lv_refr_is_opa_group(const lv_obj_t * obj)
+{
+    if(obj->opa_scale_en == 0 || obj->opa_scale == LV_OPA_COVER) return false;
+
+    return lv_ll_get_head(&obj->child_ll) != NULL;
+}
+
+/**
+ * Draw an object and its children opaque and blend them on the VDB with the opa scale of the object.
+ * The background is saved in the scratch arena before drawing them, so
+ * `vdb = mix(object drawn on the background, background, opa_scale)`. Where the object and its children
+ * haven't drawn it's the background, elsewhere the overlapping parts show only the top one.
+ * @param obj pointer to an object with `lv_refr_is_opa_group`
+ * @param mask_ori_p pointer to an area, the children will be drawn only here
+ * @param obj_ext_mask `mask_ori_p` truncated to the coordinates of the object with its `ext_draw_pad`
+ */
+static void lv_refr_opa_group(lv_obj_t * obj, const lv_area_t * mask_ori_p, const lv_area_t * obj_ext_mask)
+{
+    lv_opa_t opa = obj->opa_scale;
+    if(opa <= LV_OPA_MIN) return; /*Nothing would be visible*/
+
+    /*The pixels can't be read back with `set_px_cb`: blend every drawing as usual*/
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp_refr);
+    if(disp_refr->driver.set_px_cb != NULL) {
+        lv_refr_obj_draw(obj, mask_ori_p, obj_ext_mask);
+        return;
+    }
+
+    lv_coord_t w        = lv_area_get_width(obj_ext_mask);
+    lv_coord_t h        = lv_area_get_height(obj_ext_mask);
+    lv_coord_t vdb_w    = lv_area_get_width(&vdb->area);
+    lv_color_t * vdb_px = vdb->buf_act;
+    vdb_px += (obj_ext_mask->y1 - vdb->area.y1) * vdb_w + (obj_ext_mask->x1 - vdb->area.x1);
+
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    lv_color_t * bg = lv_draw_scratch_alloc((uint32_t)w * h * sizeof(lv_color_t));
+    if(bg == NULL) {
+        lv_refr_obj_draw(obj, mask_ori_p, obj_ext_mask);
+        return;
+    }
+
+    lv_coord_t y;
+    for(y = 0; y < h; y++) {
+        memcpy(&bg[y * w], &vdb_px[y * vdb_w], w * sizeof(lv_color_t));
+    }
+
+    const lv_obj_t * group_prev = opa_group_act;
+    opa_group_act               = obj;
+    lv_refr_obj_draw(obj, mask_ori_p, obj_ext_mask);
+    opa_group_act = group_prev;
+
+    /*Blend the drawn pixels on the saved background and copy the result back*/
+    for(y = 0; y < h; y++) {
+        lv_color_t * d = &vdb_px[y * vdb_w];
+        lv_color_t * b = &bg[y * w];
+        uint32_t x     = 0;
+#if LV_USE_SIMD
+        x = lv_draw_simd_blend(b, d, w, opa);
+#endif
+        for(; x < (uint32_t)w; x++) {
+            b[x] = lv_color_mix(d[x], b[x], opa);
+        }
+        memcpy(d, b, w * sizeof(lv_color_t));
+    }
+
+    lv_draw_scratch_release(&mark);
+}
+#endif
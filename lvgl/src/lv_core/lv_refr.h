@@ -62,6 +62,51 @@ void lv_refr_now(lv_disp_t * disp);
  */
 void lv_inv_area(lv_disp_t * disp, const lv_area_t * area_p);
 
+/**
+ * Invalidate an area of an object on display to redraw it.
+ * Unlike `lv_inv_area` it keeps the bitmaps of the cached objects below `obj` (see `lv_obj_set_layer_cache`).
+ * @param disp pointer to display where the area should be invalidated (NULL can be used if there is
+ * only one display)
+ * @param area_p pointer to area which should be invalidated
+ * @param obj the object the area belongs to, NULL if unknown
+ */
+void lv_inv_area_by(lv_disp_t * disp, const lv_area_t * area_p, const lv_obj_t * obj);
+
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the pixels of an area in the frame buffer instead of redrawing them, e.g. to scroll.
+ * The pixels are moved at the beginning of the next refresh. The exposed part of the area
+ * and the moved copies of the already invalidated areas are invalidated here.
+ * Works only with true double buffering because only then the buffer holds the whole screen.
+ * @param disp pointer to a display (NULL: the default display)
+ * @param area_p area on the display whose content moves together
+ * @param x horizontal movement
+ * @param y vertical movement
+ * @return true: the pixels will be moved; false: not possible, the area should be invalidated
+ */
+bool lv_refr_scroll(lv_disp_t * disp, const lv_area_t * area_p, lv_coord_t x, lv_coord_t y);
+
+/**
+ * Check whether something is drawn after an object on an area: its upper siblings, the ones of its parents
+ * and the layers above its screen. The pixels of such an area can't be moved for the object.
+ * @param obj pointer to an object
+ * @param area the area on the display
+ * @return true: something is drawn on the area after `obj`
+ */
+bool lv_refr_is_covered(const lv_obj_t * obj, const lv_area_t * area);
+#endif
+
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Draw the screen and the layers up to and including an object (nothing above it) on an area into a bitmap.
+ * Called out of the refresh, e.g. to animate the object as a bitmap.
+ * @param obj pointer to an object on the active screen or a layer
+ * @param buf `lv_area_get_size(area)` pixels
+ * @param area the area on the display
+ */
+void lv_refr_snapshot(lv_obj_t * obj, lv_color_t * buf, const lv_area_t * area);
+#endif
+
 /**
  * Get the display which is being refreshed
  * @return the display being refreshed
@@ -76,6 +121,22 @@ lv_disp_t * lv_refr_get_disp_refreshing(void);
  */
 void lv_refr_set_disp_refreshing(lv_disp_t * disp);
 
+/**
+ * Get the number of pixels which were not drawn in the last refresh
+ * because an opaque object above them covered them.
+ * @return number of pixels
+ */
+uint32_t lv_refr_get_occluded_px(void);
+
+#if LV_USE_OPA_GROUP
+/**
+ * Get the object whose children are being drawn opaque by the calling thread to blend them at once.
+ * Its opa scale isn't applied on them (see `lv_obj_get_opa_scale`).
+ * @return pointer to an object or NULL if there is no such object
+ */
+const lv_obj_t * lv_refr_get_opa_group(void);
+#endif
+
 /**
  * Called periodically to handle the refreshing
  * @param task pointer to the task itself
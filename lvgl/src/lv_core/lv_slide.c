@@ -0,0 +1,338 @@
+/**
+ * @file lv_slide.c
+ * Slide an object (e.g. the content of a tab view) as two bitmaps.
+ * The visible area of the object is drawn into a bitmap before and after it's moved, then the object is hidden
+ * and its parent draws the two bitmaps side by side at the position of the animation. So a frame only copies
+ * pixels instead of calling the design functions of the outgoing and the incoming tab.
+ * With `LV_USE_SCROLL_BLIT` the pixels of the area are moved in the frame buffer and only the exposed strip is copied.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_slide.h"
+#if LV_USE_SLIDE_SNAPSHOT
+
+#include <string.h>
+#include "lv_disp.h"
+#include "lv_refr.h"
+#include "../lv_draw/lv_draw_basic.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_math.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+struct _lv_slide_t
+{
+    lv_obj_t * obj;
+    lv_color_t * buf_old; /*How `obj` looked before it's moved*/
+    lv_color_t * buf_new; /*How it looks at its new position*/
+    lv_area_t area;       /*On the display, the area of the object visible in its parents*/
+    lv_coord_t dx;        /*Movement between the bitmaps, at most the size of `area`*/
+    lv_coord_t dy;
+    lv_coord_t ofs;       /*Movement of the bitmaps so far, between 0 and `dx` or `dy`*/
+    uint8_t started : 1;
+    uint8_t blit : 1;     /*The pixels of `area` can be moved in the frame buffer*/
+};
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool slide_get_area(const lv_obj_t * obj, lv_area_t * area_p);
+static bool slide_is_opaque(const lv_obj_t * obj, const lv_area_t * area_p);
+static bool slide_covers(const lv_obj_t * obj, const lv_area_t * area_p);
+#if LV_USE_SCROLL_BLIT
+static bool slide_is_overdrawn(const lv_obj_t * obj);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Start to slide an object as bitmaps: draw how it looks now. Move the object to its new position
+ * and call `lv_slide_start`.
+ * The object has to cover its visible area or its parent has to have a background of one color there,
+ * else what's below the object would slide with it.
+ * @param obj pointer to an object (e.g. the content of a tab view) whose parent will draw the slide
+ * @param blit true: the parent draws nothing over `obj` (e.g. scrollbars), the pixels can be moved
+ * with `lv_refr_scroll`
+ * @return the new slide, NULL if the object can't slide as bitmaps (move it as usual)
+ */
+lv_slide_t * lv_slide_create(lv_obj_t * obj, bool blit)
+{
+    lv_area_t area;
+    if(slide_get_area(obj, &area) == false) return NULL;
+
+    uint32_t buf_size = lv_area_get_size(&area) * sizeof(lv_color_t);
+    if(buf_size * 2 > LV_SLIDE_SNAPSHOT_MAX) return NULL;
+    if(slide_is_opaque(obj, &area) == false) return NULL;
+
+    /*The header's size is a multiple of the pointer size so the bitmaps are aligned*/
+    lv_slide_t * slide = lv_mem_alloc(sizeof(lv_slide_t) + buf_size * 2);
+    if(slide == NULL) {
+        LV_LOG_WARN("lv_slide_create: not enough memory, the object is moved as usual");
+        return NULL;
+    }
+
+    memset(slide, 0, sizeof(lv_slide_t));
+    slide->obj     = obj;
+    slide->buf_old = (lv_color_t *)(slide + 1);
+    slide->buf_new = slide->buf_old + lv_area_get_size(&area);
+    lv_area_copy(&slide->area, &area);
+#if LV_USE_SCROLL_BLIT
+    slide->blit = blit && slide_is_overdrawn(obj) == false ? 1 : 0;
+#else
+    (void)blit;
+#endif
+
+    lv_refr_snapshot(obj, slide->buf_old, &slide->area);
+
+    return slide;
+}
+
+/**
+ * Draw how the object looks at its new position and hide it. The bitmaps are drawn by `lv_slide_draw` instead.
+ * @param slide pointer to a slide from `lv_slide_create`
+ * @param dx horizontal movement of the object since `lv_slide_create`
+ * @param dy vertical movement of the object since `lv_slide_create`
+ * @return true: ok; false: it can't slide as bitmaps, delete the slide and move the object as usual
+ */
+bool lv_slide_start(lv_slide_t * slide, lv_coord_t dx, lv_coord_t dy)
+{
+    /*Two bitmaps side by side: only along one axis*/
+    if((dx != 0) == (dy != 0)) return false;
+
+    lv_area_t area;
+    if(slide_get_area(slide->obj, &area) == false) return false;
+    if(area.x1 != slide->area.x1 || area.y1 != slide->area.y1 || area.x2 != slide->area.x2 ||
+       area.y2 != slide->area.y2) {
+        return false;
+    }
+    if(slide_is_opaque(slide->obj, &area) == false) return false;
+
+    /*Farther objects (e.g. a tab a few tabs away) slide in as if they were the next one*/
+    lv_coord_t w = lv_area_get_width(&area);
+    lv_coord_t h = lv_area_get_height(&area);
+    slide->dx    = LV_MATH_MAX(LV_MATH_MIN(dx, w), -w);
+    slide->dy    = LV_MATH_MAX(LV_MATH_MIN(dy, h), -h);
+
+    lv_refr_snapshot(slide->obj, slide->buf_new, &slide->area);
+
+    slide->ofs     = 0;
+    slide->started = 1;
+    lv_obj_set_hidden(slide->obj, true);
+
+    return true;
+}
+
+/**
+ * Move the bitmaps
+ * @param slide pointer to a started slide
+ * @param pos 0: the object's old position ... `LV_SLIDE_POS_END`: its new position (e.g. the value of an animation)
+ */
+void lv_slide_set_pos(lv_slide_t * slide, int32_t pos)
+{
+    lv_coord_t dist = slide->dx != 0 ? slide->dx : slide->dy;
+    lv_coord_t ofs  = (int32_t)dist * pos / LV_SLIDE_POS_END;
+    lv_coord_t diff = ofs - slide->ofs;
+    if(diff == 0) return;
+
+    slide->ofs       = ofs;
+    lv_disp_t * disp = lv_obj_get_disp(slide->obj);
+#if LV_USE_SCROLL_BLIT
+    /*Both bitmaps move together: the drawn pixels can be moved too, only the exposed strip is copied*/
+    if(slide->blit && lv_refr_is_covered(slide->obj, &slide->area) == false) {
+        if(lv_refr_scroll(disp, &slide->area, slide->dx != 0 ? diff : 0, slide->dy != 0 ? diff : 0)) return;
+    }
+#endif
+    lv_inv_area(disp, &slide->area);
+}
+
+/**
+ * Draw the bitmaps. Called in the parent's design function after it's drawn on `LV_DESIGN_DRAW_MAIN`.
+ * Thread safe, called by the drawing threads.
+ * @param slide pointer to a slide, NULL if there is none
+ * @param mask_p draw only here
+ */
+void lv_slide_draw(const lv_slide_t * slide, const lv_area_t * mask_p)
+{
+    if(slide == NULL || slide->started == 0) return;
+
+    lv_area_t mask;
+    if(lv_area_intersect(&mask, mask_p, &slide->area) == false) return;
+
+    lv_coord_t ofs_x = slide->dx != 0 ? slide->ofs : 0;
+    lv_coord_t ofs_y = slide->dy != 0 ? slide->ofs : 0;
+
+    /*The old bitmap leaves the area and the new one comes in behind it*/
+    lv_area_t map_area;
+    lv_area_copy(&map_area, &slide->area);
+    lv_area_set_pos(&map_area, slide->area.x1 + ofs_x, slide->area.y1 + ofs_y);
+    lv_draw_map(&map_area, &mask, (const uint8_t *)slide->buf_old, LV_OPA_COVER, false, false, LV_COLOR_BLACK,
+                LV_OPA_TRANSP);
+
+    lv_area_set_pos(&map_area, slide->area.x1 + ofs_x - slide->dx, slide->area.y1 + ofs_y - slide->dy);
+    lv_draw_map(&map_area, &mask, (const uint8_t *)slide->buf_new, LV_OPA_COVER, false, false, LV_COLOR_BLACK,
+                LV_OPA_TRANSP);
+}
+
+/**
+ * Show the object again and free the slide.
+ * If the object is deleted already (e.g. in the `LV_SIGNAL_CLEANUP` of its parent) only `lv_mem_free` the slide.
+ * @param slide pointer to a slide
+ */
+void lv_slide_del(lv_slide_t * slide)
+{
+    if(slide->started) {
+        lv_obj_set_hidden(slide->obj, false);
+        lv_inv_area(lv_obj_get_disp(slide->obj), &slide->area);
+    }
+
+    lv_mem_free(slide);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Get the area of an object (with `ext_draw_pad`) visible in its parents and on the display
+ * @param obj pointer to an object
+ * @param area_p store the area here
+ * @return false: the object is not visible
+ */
+static bool slide_get_area(const lv_obj_t * obj, lv_area_t * area_p)
+{
+    /*The deferred layouts are done before drawing the bitmaps, the area is read after them*/
+    lv_obj_layout_flush();
+
+    lv_disp_t * disp     = lv_obj_get_disp(obj);
+    const lv_obj_t * scr = lv_obj_get_screen(obj);
+    if(scr != lv_disp_get_scr_act(disp) && scr != lv_disp_get_layer_top(disp) && scr != lv_disp_get_layer_sys(disp)) {
+        return false;
+    }
+
+    lv_coord_t ext_size = obj->ext_draw_pad;
+    lv_obj_get_coords(obj, area_p);
+    area_p->x1 -= ext_size;
+    area_p->y1 -= ext_size;
+    area_p->x2 += ext_size;
+    area_p->y2 += ext_size;
+    if(obj->hidden) return false;
+
+    const lv_obj_t * par;
+    for(par = lv_obj_get_parent(obj); par != NULL; par = lv_obj_get_parent(par)) {
+        if(par->hidden) return false;
+        if(lv_area_intersect(area_p, area_p, &par->coords) == false) return false;
+    }
+
+    lv_area_t scr_area;
+    scr_area.x1 = 0;
+    scr_area.y1 = 0;
+    scr_area.x2 = lv_disp_get_hor_res(disp) - 1;
+    scr_area.y2 = lv_disp_get_ver_res(disp) - 1;
+
+    return lv_area_intersect(area_p, area_p, &scr_area);
+}
+
+/**
+ * Check whether the bitmaps of an object can slide: only the object's pixels move on the area, not what's below it
+ * @param obj pointer to an object
+ * @param area_p its visible area
+ * @return true: the object covers the area or its parent is of one color there
+ */
+static bool slide_is_opaque(const lv_obj_t * obj, const lv_area_t * area_p)
+{
+    if(slide_covers(obj, area_p)) return true;
+
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    if(par == NULL) return false;
+
+    const lv_style_t * style = lv_obj_get_style(par);
+    if(style->body.opa != LV_OPA_COVER || style->body.main_color.full != style->body.grad_color.full) return false;
+    if(lv_obj_get_opa_scale(par) != LV_OPA_COVER) return false;
+    if(par->design_cb(par, area_p, LV_DESIGN_COVER_CHK) == false) return false;
+
+    /*Only the middle of the background is of one color*/
+    if(style->body.border.width != 0 && style->body.border.part != LV_BORDER_NONE &&
+       style->body.border.opa >= LV_OPA_MIN) {
+        lv_area_t bg_area;
+        lv_area_copy(&bg_area, &par->coords);
+        bg_area.x1 += style->body.border.width;
+        bg_area.y1 += style->body.border.width;
+        bg_area.x2 -= style->body.border.width;
+        bg_area.y2 -= style->body.border.width;
+        if(lv_area_is_in(area_p, &bg_area) == false) return false;
+    }
+
+    /*The older siblings are drawn between the background and the object*/
+    lv_obj_t * i;
+    for(i = lv_ll_get_next(&par->child_ll, obj); i != NULL; i = lv_ll_get_next(&par->child_ll, i)) {
+        if(i->hidden == 0 && lv_area_is_on(&i->coords, area_p)) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Check whether an object or one of its children covers an area, as the refresh does to find the top object
+ * @param obj pointer to an object
+ * @param area_p an area on the display
+ * @return true: the area is covered
+ */
+static bool slide_covers(const lv_obj_t * obj, const lv_area_t * area_p)
+{
+    if(obj->hidden || lv_area_is_in(area_p, &obj->coords) == false) return false;
+
+    lv_obj_t * i;
+    LV_LL_READ(obj->child_ll, i)
+    {
+        if(slide_covers(i, area_p)) return true;
+    }
+
+    const lv_style_t * style = lv_obj_get_style(obj);
+    return style->body.opa == LV_OPA_COVER && obj->design_cb((lv_obj_t *)obj, area_p, LV_DESIGN_COVER_CHK) != false &&
+           lv_obj_get_opa_scale(obj) == LV_OPA_COVER;
+}
+
+#if LV_USE_SCROLL_BLIT
+/**
+ * Check whether a page above the object's parent can draw over it (its border and scrollbars),
+ * so its pixels can't be moved
+ * @param obj pointer to an object
+ * @return true: there is such a page
+ */
+static bool slide_is_overdrawn(const lv_obj_t * obj)
+{
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    if(par == NULL) return false;
+
+    for(par = lv_obj_get_parent(par); par != NULL; par = lv_obj_get_parent(par)) {
+        lv_obj_type_t type;
+        lv_obj_get_type(par, &type);
+
+        uint8_t i;
+        for(i = 0; i < LV_MAX_ANCESTOR_NUM && type.type[i] != NULL; i++) {
+            if(strcmp(type.type[i], "lv_page") == 0) return true;
+        }
+    }
+
+    return false;
+}
+#endif
+
+#endif /*LV_USE_SLIDE_SNAPSHOT*/
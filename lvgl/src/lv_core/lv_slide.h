@@ -0,0 +1,96 @@
+/**
+ * @file lv_slide.h
+ *
+ */
+
+#ifndef LV_SLIDE_H
+#define LV_SLIDE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include "lv_obj.h"
+
+#if LV_USE_SLIDE_SNAPSHOT
+
+/*********************
+ *      DEFINES
+ *********************/
+/*`lv_slide_set_pos` of the end of the slide*/
+#define LV_SLIDE_POS_END 1024
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*A slide in progress: the area and the two bitmaps in one `lv_mem_alloc`ed block*/
+struct _lv_slide_t;
+typedef struct _lv_slide_t lv_slide_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Start to slide an object as bitmaps: draw how it looks now. Move the object to its new position
+ * and call `lv_slide_start`.
+ * The object has to cover its visible area or its parent has to have a background of one color there,
+ * else what's below the object would slide with it.
+ * @param obj pointer to an object (e.g. the content of a tab view) whose parent will draw the slide
+ * @param blit true: the parent draws nothing over `obj` (e.g. scrollbars), the pixels can be moved
+ * with `lv_refr_scroll`
+ * @return the new slide, NULL if the object can't slide as bitmaps (move it as usual)
+ */
+lv_slide_t * lv_slide_create(lv_obj_t * obj, bool blit);
+
+/**
+ * Draw how the object looks at its new position and hide it. The bitmaps are drawn by `lv_slide_draw` instead.
+ * @param slide pointer to a slide from `lv_slide_create`
+ * @param dx horizontal movement of the object since `lv_slide_create`
+ * @param dy vertical movement of the object since `lv_slide_create`
+ * @return true: ok; false: it can't slide as bitmaps, delete the slide and move the object as usual
+ */
+bool lv_slide_start(lv_slide_t * slide, lv_coord_t dx, lv_coord_t dy);
+
+/**
+ * Move the bitmaps
+ * @param slide pointer to a started slide
+ * @param pos 0: the object's old position ... `LV_SLIDE_POS_END`: its new position (e.g. the value of an animation)
+ */
+void lv_slide_set_pos(lv_slide_t * slide, int32_t pos);
+
+/**
+ * Draw the bitmaps. Called in the parent's design function after it's drawn on `LV_DESIGN_DRAW_MAIN`.
+ * Thread safe, called by the drawing threads.
+ * @param slide pointer to a slide, NULL if there is none
+ * @param mask_p draw only here
+ */
+void lv_slide_draw(const lv_slide_t * slide, const lv_area_t * mask_p);
+
+/**
+ * Show the object again and free the slide.
+ * If the object is deleted already (e.g. in the `LV_SIGNAL_CLEANUP` of its parent) only `lv_mem_free` the slide.
+ * @param slide pointer to a slide
+ */
+void lv_slide_del(lv_slide_t * slide);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_SLIDE_SNAPSHOT*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_SLIDE_H*/
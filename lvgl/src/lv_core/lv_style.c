@@ -222,6 +222,42 @@ void lv_style_copy(lv_style_t * dest, const lv_style_t * src)
     memcpy(dest, src, sizeof(lv_style_t));
 }
 
+/**
+ * Compare two styles field by field
+ * @param a pointer to a style
+ * @param b pointer to an other style
+ * @return `LV_STYLE_DIFF_NONE`, `LV_STYLE_DIFF_DRAW` if only colors and opacities differ,
+ *         else `LV_STYLE_DIFF_LAYOUT`
+ */
+lv_style_diff_t lv_style_diff(const lv_style_t * a, const lv_style_t * b)
+{
+    /*Not `memcmp`: the padding bytes of a style assigned as a struct are undefined*/
+
+    /*They change the size of the objects (e.g. labels, fit), their layout or their extra draw area.
+     *The radius too: e.g. the knob of a slider and the bullet of a check box are placed by it.*/
+    if(a->glass != b->glass || a->body.radius != b->body.radius || a->body.border.width != b->body.border.width ||
+       a->body.shadow.width != b->body.shadow.width || a->body.padding.top != b->body.padding.top ||
+       a->body.padding.bottom != b->body.padding.bottom || a->body.padding.left != b->body.padding.left ||
+       a->body.padding.right != b->body.padding.right || a->body.padding.inner != b->body.padding.inner ||
+       a->text.font != b->text.font || a->text.letter_space != b->text.letter_space ||
+       a->text.line_space != b->text.line_space || a->line.width != b->line.width) {
+        return LV_STYLE_DIFF_LAYOUT;
+    }
+
+    if(a->body.main_color.full != b->body.main_color.full || a->body.grad_color.full != b->body.grad_color.full ||
+       a->body.opa != b->body.opa || a->body.border.color.full != b->body.border.color.full ||
+       a->body.border.part != b->body.border.part || a->body.border.opa != b->body.border.opa ||
+       a->body.shadow.color.full != b->body.shadow.color.full || a->body.shadow.type != b->body.shadow.type ||
+       a->text.color.full != b->text.color.full || a->text.sel_color.full != b->text.sel_color.full ||
+       a->text.opa != b->text.opa || a->image.color.full != b->image.color.full ||
+       a->image.intense != b->image.intense || a->image.opa != b->image.opa ||
+       a->line.color.full != b->line.color.full || a->line.opa != b->line.opa || a->line.rounded != b->line.rounded) {
+        return LV_STYLE_DIFF_DRAW;
+    }
+
+    return LV_STYLE_DIFF_NONE;
+}
+
 /**
  * Mix two styles according to a given ratio
  * @param start start style
@@ -322,9 +358,16 @@ static void style_animator(lv_style_anim_dsc_t * dsc, lv_anim_value_t val)
     const lv_style_t * end   = &dsc->style_end;
     lv_style_t * act         = dsc->style_anim;
 
-    lv_style_mix(start, end, act, val);
+    /*Mix into a copy (with the same padding bytes) to see if the rounded values have changed at all*/
+    lv_style_t mixed;
+    memcpy(&mixed, act, sizeof(lv_style_t));
+    lv_style_mix(start, end, &mixed, val);
+
+    /*Don't refresh the users of the style (invalidate them) for nothing*/
+    if(memcmp(&mixed, act, sizeof(lv_style_t)) == 0) return;
 
-    lv_obj_report_style_mod(dsc->style_anim);
+    memcpy(act, &mixed, sizeof(lv_style_t));
+    lv_obj_report_style_mod(act);
 }
 
 /**
@@ -47,6 +47,14 @@ enum {
 };
 typedef uint8_t lv_shadow_type_t;
 
+/*How two styles differ (see `lv_style_diff`)*/
+enum {
+    LV_STYLE_DIFF_NONE = 0, /**< Equal */
+    LV_STYLE_DIFF_DRAW,     /**< Only in colors and opacities: the objects only have to be redrawn */
+    LV_STYLE_DIFF_LAYOUT,   /**< In a size, font, padding etc.: the objects have to be refreshed and laid out */
+};
+typedef uint8_t lv_style_diff_t;
+
 /**
  * Objects in LittlevGL can be assigned a style - which holds information about
  * how the object should be drawn.
@@ -149,6 +157,15 @@ void lv_style_init(void);
  */
 void lv_style_copy(lv_style_t * dest, const lv_style_t * src);
 
+/**
+ * Compare two styles field by field
+ * @param a pointer to a style
+ * @param b pointer to an other style
+ * @return `LV_STYLE_DIFF_NONE`, `LV_STYLE_DIFF_DRAW` if only colors and opacities differ,
+ *         else `LV_STYLE_DIFF_LAYOUT`
+ */
+lv_style_diff_t lv_style_diff(const lv_style_t * a, const lv_style_t * b);
+
 /**
  * Mix two styles according to a given ratio
  * @param start start style
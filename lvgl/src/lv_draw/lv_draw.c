@@ -14,15 +14,34 @@
 #include "../lv_misc/lv_log.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_core/lv_prof.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define SCRATCH_ALIGN   8
+#define SCRATCH_ALIGN_UP(x) (((x) + SCRATCH_ALIGN - 1) & ~(uint32_t)(SCRATCH_ALIGN - 1))
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*An allocation which didn't fit into the arena. The data follows the header.*/
+typedef struct _lv_draw_scratch_ovf_t {
+    struct _lv_draw_scratch_ovf_t * next;
+    uint32_t size;
+} lv_draw_scratch_ovf_t;
+
+typedef struct {
+    uint8_t * buf;
+    uint32_t size;
+    uint32_t used;
+    uint32_t ovf_size;              /*Sum of the living overflow allocations*/
+    uint32_t need;                  /*The most `used + ovf_size` since the last reset*/
+    lv_draw_scratch_ovf_t * ovf;    /*The overflow allocations, the newest first*/
+} lv_draw_scratch_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -30,8 +49,9 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
-static void * draw_buf = NULL;
-static uint32_t draw_buf_size = 0;
+static LV_THREAD_LOCAL void * draw_buf = NULL;
+static LV_THREAD_LOCAL uint32_t draw_buf_size = 0;
+static LV_THREAD_LOCAL lv_draw_scratch_t scratch;
 
 /**********************
  *      MACROS
@@ -44,6 +64,7 @@ static uint32_t draw_buf_size = 0;
 /**
  * Give a buffer with the given to use during drawing.
  * Be careful to not use the buffer while other processes are using it.
+ * Every drawing thread has its own buffer.
  * @param size the required size
  */
 void * lv_draw_get_buf(uint32_t size)
@@ -77,6 +98,118 @@ void lv_draw_free_buf(void)
     }
 }
 
+/**
+ * Take a temporary buffer from the scratch arena of the drawing thread.
+ * It's valid until `lv_draw_scratch_release` with an earlier mark or until the arena is reset
+ * after the refreshed area. Don't free it.
+ * @param size the required size in bytes
+ * @return pointer to the buffer, aligned to 8 bytes, or NULL if out of memory
+ */
+void * lv_draw_scratch_alloc(uint32_t size)
+{
+    size = SCRATCH_ALIGN_UP(size);
+
+    /*Allocate the arena on the first use*/
+    if(scratch.buf == NULL) {
+        scratch.buf  = lv_mem_alloc(LV_DRAW_SCRATCH_SIZE);
+        scratch.size = scratch.buf ? LV_DRAW_SCRATCH_SIZE : 0;
+    }
+
+    void * p;
+    if(scratch.used + size <= scratch.size) {
+        p = &scratch.buf[scratch.used];
+        scratch.used += size;
+    } else {
+        /*Bridge the rest of this area with `lv_mem`. The arena is enlarged at the reset.*/
+        lv_draw_scratch_ovf_t * ovf = lv_mem_alloc(SCRATCH_ALIGN_UP(sizeof(lv_draw_scratch_ovf_t)) + size);
+        if(ovf == NULL) {
+            LV_LOG_WARN("lv_draw_scratch_alloc: out of memory");
+            return NULL;
+        }
+        ovf->next = scratch.ovf;
+        ovf->size = size;
+        scratch.ovf = ovf;
+        scratch.ovf_size += size;
+        p = (uint8_t *)ovf + SCRATCH_ALIGN_UP(sizeof(lv_draw_scratch_ovf_t));
+    }
+
+    if(scratch.used + scratch.ovf_size > scratch.need) scratch.need = scratch.used + scratch.ovf_size;
+
+    return p;
+}
+
+/**
+ * Save the state of the scratch arena to release the buffers taken after it
+ * @param mark store the state here
+ */
+void lv_draw_scratch_mark(lv_draw_scratch_mark_t * mark)
+{
+    mark->used = scratch.used;
+    mark->ovf  = scratch.ovf;
+}
+
+/**
+ * Release the buffers taken from the scratch arena since a mark.
+ * The marks have to be released in the reverse order of taking them.
+ * @param mark a mark from `lv_draw_scratch_mark`
+ */
+void lv_draw_scratch_release(const lv_draw_scratch_mark_t * mark)
+{
+    while(scratch.ovf != mark->ovf && scratch.ovf != NULL) {
+        lv_draw_scratch_ovf_t * next = scratch.ovf->next;
+        scratch.ovf_size -= scratch.ovf->size;
+        lv_mem_free(scratch.ovf);
+        scratch.ovf = next;
+    }
+
+    scratch.used = mark->used;
+}
+
+/**
+ * Release every buffer of the scratch arena of this thread.
+ * If they didn't fit the arena is enlarged to hold as much as was needed at once.
+ * Called after every refreshed area.
+ */
+void lv_draw_scratch_reset(void)
+{
+    lv_draw_scratch_mark_t mark = {0, NULL};
+    lv_draw_scratch_release(&mark);
+
+    uint32_t size = LV_MATH_MAX(scratch.need, LV_DRAW_SCRATCH_SIZE);
+    if(size > scratch.size) {
+        /*The content is not needed, so free first and don't copy it*/
+        if(scratch.buf) lv_mem_free(scratch.buf);
+        scratch.buf  = lv_mem_alloc(size);
+        scratch.size = scratch.buf ? size : 0;
+        if(scratch.buf == NULL) LV_LOG_WARN("lv_draw_scratch_reset: out of memory");
+    }
+
+    scratch.need = 0;
+}
+
+/**
+ * Free the scratch arena of this thread. The next `lv_draw_scratch_alloc` allocates it again.
+ */
+void lv_draw_scratch_free(void)
+{
+    lv_draw_scratch_mark_t mark = {0, NULL};
+    lv_draw_scratch_release(&mark);
+
+    if(scratch.buf) lv_mem_free(scratch.buf);
+    scratch.buf  = NULL;
+    scratch.size = 0;
+    scratch.need = 0;
+}
+
+/**
+ * Get the size of the scratch arena of this thread
+ * @return the size in bytes, without the overflow allocations
+ */
+uint32_t lv_draw_scratch_get_size(void)
+{
+    return scratch.size;
+}
+
 #if LV_ANTIALIAS
 
 /**
@@ -145,6 +278,7 @@ void lv_draw_aa_ver_seg(lv_coord_t x, lv_coord_t y, lv_coord_t length, const lv_
         length = -length;
     }
 
+    lv_prof_draw_add(LV_PROF_DRAW_AA, length);
     lv_coord_t i;
     for(i = 0; i < length; i++) {
         lv_opa_t px_opa = lv_draw_aa_get_opa(length, i, opa);
@@ -171,6 +305,7 @@ void lv_draw_aa_hor_seg(lv_coord_t x, lv_coord_t y, lv_coord_t length, const lv_
         length = -length;
     }
 
+    lv_prof_draw_add(LV_PROF_DRAW_AA, length);
     lv_coord_t i;
     for(i = 0; i < length; i++) {
         lv_opa_t px_opa = lv_draw_aa_get_opa(length, i, opa);
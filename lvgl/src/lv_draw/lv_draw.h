@@ -31,6 +31,12 @@ extern "C" {
  *      TYPEDEFS
  **********************/
 
+/*State of the scratch arena to release the buffers taken after it*/
+typedef struct {
+    uint32_t used;
+    void * ovf;
+} lv_draw_scratch_mark_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -38,6 +44,7 @@ extern "C" {
 /**
  * Give a buffer with the given to use during drawing.
  * Be careful to not use the buffer while other processes are using it.
+ * `lv_draw_scratch_alloc` gives more buffers at once.
  * @param size the required size
  */
 void * lv_draw_get_buf(uint32_t size);
@@ -47,6 +54,46 @@ void * lv_draw_get_buf(uint32_t size);
  */
 void lv_draw_free_buf(void);
 
+/**
+ * Take a temporary buffer from the scratch arena of the drawing thread.
+ * It's valid until `lv_draw_scratch_release` with an earlier mark or until the arena is reset
+ * after the refreshed area. Don't free it.
+ * @param size the required size in bytes
+ * @return pointer to the buffer, aligned to 8 bytes, or NULL if out of memory
+ */
+void * lv_draw_scratch_alloc(uint32_t size);
+
+/**
+ * Save the state of the scratch arena to release the buffers taken after it
+ * @param mark store the state here
+ */
+void lv_draw_scratch_mark(lv_draw_scratch_mark_t * mark);
+
+/**
+ * Release the buffers taken from the scratch arena since a mark.
+ * The marks have to be released in the reverse order of taking them.
+ * @param mark a mark from `lv_draw_scratch_mark`
+ */
+void lv_draw_scratch_release(const lv_draw_scratch_mark_t * mark);
+
+/**
+ * Release every buffer of the scratch arena of this thread.
+ * If they didn't fit the arena is enlarged to hold as much as was needed at once.
+ * Called after every refreshed area.
+ */
+void lv_draw_scratch_reset(void);
+
+/**
+ * Free the scratch arena of this thread. The next `lv_draw_scratch_alloc` allocates it again.
+ */
+void lv_draw_scratch_free(void);
+
+/**
+ * Get the size of the scratch arena of this thread
+ * @return the size in bytes, without the overflow allocations
+ */
+uint32_t lv_draw_scratch_get_size(void);
+
 #if LV_ANTIALIAS
 
 /**
@@ -95,6 +142,7 @@ void lv_draw_aa_hor_seg(lv_coord_t x, lv_coord_t y, lv_coord_t length, const lv_
  *   POST INCLUDES
  *********************/
 #include "lv_draw_basic.h"
+#include "lv_draw_simd.h"
 #include "lv_draw_rect.h"
 #include "lv_draw_label.h"
 #include "lv_draw_img.h"
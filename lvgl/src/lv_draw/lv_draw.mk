@@ -1,4 +1,6 @@
 CSRCS += lv_draw_basic.c
+CSRCS += lv_draw_simd.c
+CSRCS += lv_draw_packed.c
 CSRCS += lv_draw.c
 CSRCS += lv_draw_rect.c
 CSRCS += lv_draw_label.c
@@ -12,21 +12,42 @@
 /*********************
  *      DEFINES
  *********************/
+#define SPAN_MIN (-INT32_MAX)
+#define SPAN_MAX INT32_MAX
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*Continuous pixels of a row, relative to the center*/
+typedef struct
+{
+    int32_t x1;
+    int32_t x2;
+} arc_span_t;
+
+/*The part of the plane between the start and end angle*/
+typedef struct
+{
+    lv_point_t start; /*Direction of the start angle (scaled sin and cos)*/
+    lv_point_t end;   /*Direction of the end angle*/
+    lv_point_t mid;   /*Direction of the middle*/
+    uint8_t full : 1; /*360 deg, no need to test the angles*/
+    uint8_t wide : 1; /*More than 180 deg*/
+} arc_sector_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static uint16_t fast_atan2(int x, int y);
-static void ver_line(lv_coord_t x, lv_coord_t y, const lv_area_t * mask, lv_coord_t len, lv_color_t color,
-                     lv_opa_t opa);
-static void hor_line(lv_coord_t x, lv_coord_t y, const lv_area_t * mask, lv_coord_t len, lv_color_t color,
-                     lv_opa_t opa);
-static bool deg_test_norm(uint16_t deg, uint16_t start, uint16_t end);
-static bool deg_test_inv(uint16_t deg, uint16_t start, uint16_t end);
+static void sector_init(arc_sector_t * sector, uint16_t start_angle, uint16_t end_angle);
+static uint8_t sector_get_spans(const arc_sector_t * sector, lv_coord_t y, arc_span_t spans[]);
+static void half_row(int32_t a, int32_t b, arc_span_t * span);
+static bool spans_has(const arc_span_t spans[], uint8_t span_cnt, int32_t x);
+static int32_t div_floor(int32_t n, int32_t d);
+#if LV_ANTIALIAS
+static void draw_aa_px(lv_coord_t center_x, lv_coord_t center_y, int32_t x, int32_t y, const lv_area_t * mask,
+                       const arc_span_t spans[], uint8_t span_cnt, lv_color_t color, lv_opa_t opa);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -56,218 +77,249 @@ void lv_draw_arc(lv_coord_t center_x, lv_coord_t center_y, uint16_t radius, cons
 {
     lv_coord_t thickness = style->line.width;
     if(thickness > radius) thickness = radius;
+    if(thickness <= 0) return;
 
-    lv_coord_t r_out = radius;
-    lv_coord_t r_in  = r_out - thickness;
-    int16_t deg_base;
-    int16_t deg;
-    lv_coord_t x_start[4];
-    lv_coord_t x_end[4];
+    int32_t r_out = radius;
+    int32_t r_in  = r_out - thickness;
 
     lv_color_t color = style->line.color;
     lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
 
-    bool (*deg_test)(uint16_t, uint16_t, uint16_t);
-    if(start_angle <= end_angle)
-        deg_test = deg_test_norm;
-    else
-        deg_test = deg_test_inv;
-
-    if(deg_test(270, start_angle, end_angle))
-        hor_line(center_x - r_out + 1, center_y, mask, thickness - 1, color, opa); // Left Middle
-    if(deg_test(90, start_angle, end_angle))
-        hor_line(center_x + r_in, center_y, mask, thickness - 1, color, opa); // Right Middle
-    if(deg_test(180, start_angle, end_angle))
-        ver_line(center_x, center_y - r_out + 1, mask, thickness - 1, color, opa); // Top Middle
-    if(deg_test(0, start_angle, end_angle))
-        ver_line(center_x, center_y + r_in, mask, thickness - 1, color, opa); // Bottom middle
-
-    uint32_t r_out_sqr = r_out * r_out;
-    uint32_t r_in_sqr  = r_in * r_in;
-    int16_t xi;
-    int16_t yi;
-    for(yi = -r_out; yi < 0; yi++) {
-        x_start[0] = LV_COORD_MIN;
-        x_start[1] = LV_COORD_MIN;
-        x_start[2] = LV_COORD_MIN;
-        x_start[3] = LV_COORD_MIN;
-        x_end[0]   = LV_COORD_MIN;
-        x_end[1]   = LV_COORD_MIN;
-        x_end[2]   = LV_COORD_MIN;
-        x_end[3]   = LV_COORD_MIN;
-        for(xi = -r_out; xi < 0; xi++) {
-
-            uint32_t r_act_sqr = xi * xi + yi * yi;
-            if(r_act_sqr > r_out_sqr) continue;
-
-            deg_base = fast_atan2(xi, yi) - 180;
-
-            deg = 180 + deg_base;
-            if(deg_test(deg, start_angle, end_angle)) {
-                if(x_start[0] == LV_COORD_MIN) x_start[0] = xi;
-            } else if(x_start[0] != LV_COORD_MIN && x_end[0] == LV_COORD_MIN) {
-                x_end[0] = xi - 1;
-            }
-
-            deg = 360 - deg_base;
-            if(deg_test(deg, start_angle, end_angle)) {
-                if(x_start[1] == LV_COORD_MIN) x_start[1] = xi;
-            } else if(x_start[1] != LV_COORD_MIN && x_end[1] == LV_COORD_MIN) {
-                x_end[1] = xi - 1;
-            }
-
-            deg = 180 - deg_base;
-            if(deg_test(deg, start_angle, end_angle)) {
-                if(x_start[2] == LV_COORD_MIN) x_start[2] = xi;
-            } else if(x_start[2] != LV_COORD_MIN && x_end[2] == LV_COORD_MIN) {
-                x_end[2] = xi - 1;
-            }
+    /*Process only the rows and columns of the mask. Only the pixels inside the radius are drawn.*/
+    int32_t y_min = LV_MATH_MAX(mask->y1 - center_y, -r_out + 1);
+    int32_t y_max = LV_MATH_MIN(mask->y2 - center_y, r_out - 1);
+    int32_t x_min = mask->x1 - center_x;
+    int32_t x_max = mask->x2 - center_x;
+    if(x_min > r_out || x_max < -r_out) return;
 
-            deg = deg_base;
-            if(deg_test(deg, start_angle, end_angle)) {
-                if(x_start[3] == LV_COORD_MIN) x_start[3] = xi;
-            } else if(x_start[3] != LV_COORD_MIN && x_end[3] == LV_COORD_MIN) {
-                x_end[3] = xi - 1;
-            }
+    arc_sector_t sector;
+    sector_init(&sector, start_angle, end_angle);
 
-            if(r_act_sqr < r_in_sqr)
-                break; /*No need to continue the iteration in x once we found the inner edge of the
-                          arc*/
-        }
+    /*The pixels are drawn with full opacity between the two squared distances from the center*/
+    uint32_t r_in_sqr = r_in * r_in;
+#if LV_ANTIALIAS
+    /*The outer edge fades out on the last pixel inside the radius, the inner edge on the first inside the ring*/
+    uint32_t r_out_sqr    = (r_out - 1) * (r_out - 1);
+    uint32_t r_out_aa_sqr = r_out * r_out;
+    uint32_t r_in_aa_sqr  = r_in > 0 ? (r_in - 1) * (r_in - 1) : 0;
+#else
+    uint32_t r_out_sqr = r_out * r_out - 1;
+#endif
 
-        if(x_start[0] != LV_COORD_MIN) {
-            if(x_end[0] == LV_COORD_MIN) x_end[0] = xi - 1;
-            hor_line(center_x + x_start[0], center_y + yi, mask, x_end[0] - x_start[0], color, opa);
+    int32_t y;
+    for(y = y_min; y <= y_max; y++) {
+        arc_span_t sector_spans[2];
+        uint8_t sector_cnt = sector_get_spans(&sector, y, sector_spans);
+        if(sector_cnt == 0) continue;
+
+        /*The ring in this row: one span or two if the row crosses the inner circle*/
+        uint32_t y_sqr = y * y;
+        int32_t xo     = lv_sqrt(r_out_sqr - y_sqr);
+        int32_t xi     = 0;
+        arc_span_t ring_spans[2];
+        uint8_t ring_cnt;
+        if(y_sqr >= r_in_sqr) {
+            ring_spans[0].x1 = -xo;
+            ring_spans[0].x2 = xo;
+            ring_cnt         = 1;
+        } else {
+            xi = lv_sqrt(r_in_sqr - y_sqr);
+            if((uint32_t)xi * xi + y_sqr < r_in_sqr) xi++; /*The first pixel which is not inside the inner circle*/
+            ring_spans[0].x1 = -xo;
+            ring_spans[0].x2 = -xi;
+            ring_spans[1].x1 = xi;
+            ring_spans[1].x2 = xo;
+            ring_cnt         = 2;
         }
 
-        if(x_start[1] != LV_COORD_MIN) {
-            if(x_end[1] == LV_COORD_MIN) x_end[1] = xi - 1;
-            hor_line(center_x + x_start[1], center_y - yi, mask, x_end[1] - x_start[1], color, opa);
+        uint8_t r;
+        uint8_t s;
+        for(r = 0; r < ring_cnt; r++) {
+            for(s = 0; s < sector_cnt; s++) {
+                int32_t x1 = LV_MATH_MAX(LV_MATH_MAX(ring_spans[r].x1, sector_spans[s].x1), x_min);
+                int32_t x2 = LV_MATH_MIN(LV_MATH_MIN(ring_spans[r].x2, sector_spans[s].x2), x_max);
+                if(x1 > x2) continue;
+
+                lv_area_t area;
+                lv_area_set(&area, center_x + x1, center_y + y, center_x + x2, center_y + y);
+                lv_draw_fill(&area, mask, color, opa);
+            }
         }
 
-        if(x_start[2] != LV_COORD_MIN) {
-            if(x_end[2] == LV_COORD_MIN) x_end[2] = xi - 1;
-            hor_line(center_x - x_end[2], center_y + yi, mask, LV_MATH_ABS(x_end[2] - x_start[2]), color, opa);
+#if LV_ANTIALIAS
+        /*Fade out the pixels around the outer circle by their distance*/
+        int32_t xo_aa = lv_sqrt(r_out_aa_sqr - 1 - y_sqr);
+        int32_t x;
+        for(x = xo + 1; x <= xo_aa; x++) {
+            uint32_t d_sqr = x * x + y_sqr;
+            lv_opa_t px_opa = (uint32_t)opa * (r_out_aa_sqr - d_sqr) / (r_out_aa_sqr - r_out_sqr);
+            draw_aa_px(center_x, center_y, x, y, mask, sector_spans, sector_cnt, color, px_opa);
+            draw_aa_px(center_x, center_y, -x, y, mask, sector_spans, sector_cnt, color, px_opa);
         }
 
-        if(x_start[3] != LV_COORD_MIN) {
-            if(x_end[3] == LV_COORD_MIN) x_end[3] = xi - 1;
-            hor_line(center_x - x_end[3], center_y - yi, mask, LV_MATH_ABS(x_end[3] - x_start[3]), color, opa);
+        /*And inside the inner circle*/
+        if(xi > 0) {
+            int32_t xi_aa = y_sqr < r_in_aa_sqr ? lv_sqrt(r_in_aa_sqr - y_sqr) + 1 : 0;
+            for(x = xi_aa; x < xi; x++) {
+                uint32_t d_sqr = x * x + y_sqr;
+                lv_opa_t px_opa = (uint32_t)opa * (d_sqr - r_in_aa_sqr) / (r_in_sqr - r_in_aa_sqr);
+                draw_aa_px(center_x, center_y, x, y, mask, sector_spans, sector_cnt, color, px_opa);
+                if(x != 0) draw_aa_px(center_x, center_y, -x, y, mask, sector_spans, sector_cnt, color, px_opa);
+            }
         }
-
-#if LV_ANTIALIAS
-        /*TODO*/
-
 #endif
     }
 }
 
-static uint16_t fast_atan2(int x, int y)
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Initialize a sector between two angles
+ * @param sector pointer to a sector to initialize
+ * @param start_angle the start angle (0 deg on the bottom, 90 deg on the right)
+ * @param end_angle the end angle
+ */
+static void sector_init(arc_sector_t * sector, uint16_t start_angle, uint16_t end_angle)
 {
-    // Fast XY vector to integer degree algorithm - Jan 2011 www.RomanBlack.com
-    // Converts any XY values including 0 to a degree value that should be
-    // within +/- 1 degree of the accurate value without needing
-    // large slow trig functions like ArcTan() or ArcCos().
-    // NOTE! at least one of the X or Y values must be non-zero!
-    // This is the full version, for all 4 quadrants and will generate
-    // the angle in integer degrees from 0-360.
-    // Any values of X and Y are usable including negative values provided
-    // they are between -1456 and 1456 so the 16bit multiply does not overflow.
-
-    unsigned char negflag;
-    unsigned char tempdegree;
-    unsigned char comp;
-    unsigned int degree; // this will hold the result
-    // signed int x;            // these hold the XY vector at the start
-    // signed int y;            // (and they will be destroyed)
-    unsigned int ux;
-    unsigned int uy;
-
-    // Save the sign flags then remove signs and get XY as unsigned ints
-    negflag = 0;
-    if(x < 0) {
-        negflag += 0x01; // x flag bit
-        x = (0 - x);     // is now +
-    }
-    ux = x; // copy to unsigned var before multiply
-    if(y < 0) {
-        negflag += 0x02; // y flag bit
-        y = (0 - y);     // is now +
-    }
-    uy = y; // copy to unsigned var before multiply
+    uint16_t span;
+    if(start_angle <= end_angle)
+        span = end_angle - start_angle;
+    else
+        span = 360 - start_angle + end_angle;
+
+    sector->full = span >= 360 ? 1 : 0;
+    sector->wide = span > 180 ? 1 : 0;
+
+    /*The direction of 0 deg is (0, 1), of 90 deg is (1, 0)*/
+    sector->start.x = lv_trigo_sin(start_angle);
+    sector->start.y = lv_trigo_sin(start_angle + 90);
+    sector->end.x   = lv_trigo_sin(end_angle);
+    sector->end.y   = lv_trigo_sin(end_angle + 90);
+    sector->mid.x   = ((int32_t)sector->start.x + sector->end.x) / 2; /*Halved to fit into `lv_coord_t`*/
+    sector->mid.y   = ((int32_t)sector->start.y + sector->end.y) / 2;
+}
 
-    // 1. Calc the scaled "degrees"
-    if(ux > uy) {
-        degree = (uy * 45) / ux; // degree result will be 0-45 range
-        negflag += 0x10;         // octant flag bit
-    } else {
-        degree = (ux * 45) / uy; // degree result will be 0-45 range
+/**
+ * Get the parts of a row which are in a sector
+ * @param sector pointer to a sector
+ * @param y the row relative to the center
+ * @param spans store the spans here (at most 2)
+ * @return number of spans
+ */
+static uint8_t sector_get_spans(const arc_sector_t * sector, lv_coord_t y, arc_span_t spans[])
+{
+    if(sector->full) {
+        spans[0].x1 = SPAN_MIN;
+        spans[0].x2 = SPAN_MAX;
+        return 1;
     }
 
-    // 2. Compensate for the 4 degree error curve
-    comp       = 0;
-    tempdegree = degree;  // use an unsigned char for speed!
-    if(tempdegree > 22) { // if top half of range
-        if(tempdegree <= 44) comp++;
-        if(tempdegree <= 41) comp++;
-        if(tempdegree <= 37) comp++;
-        if(tempdegree <= 32) comp++; // max is 4 degrees compensated
-    } else {                         // else is lower half of range
-        if(tempdegree >= 2) comp++;
-        if(tempdegree >= 6) comp++;
-        if(tempdegree >= 10) comp++;
-        if(tempdegree >= 15) comp++; // max is 4 degrees compensated
+    /*A point is after the start angle if cross(start, p) <= 0 and before the end angle if cross(p, end) <= 0.
+     *In a row both are a half row.*/
+    arc_span_t after_start;
+    arc_span_t before_end;
+    half_row(sector->start.y, (int32_t)sector->start.x * y, &after_start);
+    half_row(-sector->end.y, -(int32_t)sector->end.x * y, &before_end);
+
+    /*Not more than 180 deg: both has to be true.
+     *Also be on the side of the middle to not get the opposite direction with equal angles.*/
+    if(sector->wide == 0) {
+        arc_span_t front;
+        half_row(sector->mid.x, -(int32_t)sector->mid.y * y, &front);
+        spans[0].x1 = LV_MATH_MAX(LV_MATH_MAX(after_start.x1, before_end.x1), front.x1);
+        spans[0].x2 = LV_MATH_MIN(LV_MATH_MIN(after_start.x2, before_end.x2), front.x2);
+        return spans[0].x1 <= spans[0].x2 ? 1 : 0;
     }
-    degree += comp; // degree is now accurate to +/- 1 degree!
-
-    // Invert degree if it was X>Y octant, makes 0-45 into 90-45
-    if(negflag & 0x10) degree = (90 - degree);
-
-    // 3. Degree is now 0-90 range for this quadrant,
-    // need to invert it for whichever quadrant it was in
-    if(negflag & 0x02) {   // if -Y
-        if(negflag & 0x01) // if -Y -X
-            degree = (180 + degree);
-        else // else is -Y +X
-            degree = (180 - degree);
-    } else {               // else is +Y
-        if(negflag & 0x01) // if +Y -X
-            degree = (360 - degree);
+
+    /*More than 180 deg: any of them*/
+    uint8_t span_cnt = 0;
+    if(after_start.x1 <= after_start.x2) spans[span_cnt++] = after_start;
+    if(before_end.x1 <= before_end.x2) spans[span_cnt++] = before_end;
+
+    /*Join them if they overlap or touch. The edges can be `SPAN_MIN/MAX`, so subtract instead of adding 1.*/
+    if(span_cnt == 2 && LV_MATH_MAX(spans[0].x1, spans[1].x1) - 1 <= LV_MATH_MIN(spans[0].x2, spans[1].x2)) {
+        spans[0].x1 = LV_MATH_MIN(spans[0].x1, spans[1].x1);
+        spans[0].x2 = LV_MATH_MAX(spans[0].x2, spans[1].x2);
+        span_cnt    = 1;
     }
-    return degree;
+
+    return span_cnt;
 }
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-static void ver_line(lv_coord_t x, lv_coord_t y, const lv_area_t * mask, lv_coord_t len, lv_color_t color, lv_opa_t opa)
+/**
+ * Get the part of a row where `a * x >= b`
+ * @param a the factor of x
+ * @param b the limit
+ * @param span store the result here. `x1 > x2` if there is no such x.
+ */
+static void half_row(int32_t a, int32_t b, arc_span_t * span)
 {
-    lv_area_t area;
-    lv_area_set(&area, x, y, x, y + len);
-
-    lv_draw_fill(&area, mask, color, opa);
+    if(a > 0) {
+        span->x1 = -div_floor(-b, a); /*Round up*/
+        span->x2 = SPAN_MAX;
+    } else if(a < 0) {
+        span->x1 = SPAN_MIN;
+        span->x2 = div_floor(-b, -a);
+    } else if(b <= 0) {
+        span->x1 = SPAN_MIN;
+        span->x2 = SPAN_MAX;
+    } else {
+        span->x1 = SPAN_MAX;
+        span->x2 = SPAN_MIN;
+    }
 }
 
-static void hor_line(lv_coord_t x, lv_coord_t y, const lv_area_t * mask, lv_coord_t len, lv_color_t color, lv_opa_t opa)
+/**
+ * Check whether a point of a row is in any of its spans
+ * @param spans array of spans
+ * @param span_cnt number of spans
+ * @param x the x coordinate relative to the center
+ * @return true: `x` is in a span
+ */
+static bool spans_has(const arc_span_t spans[], uint8_t span_cnt, int32_t x)
 {
-    lv_area_t area;
-    lv_area_set(&area, x, y, x + len, y);
+    uint8_t i;
+    for(i = 0; i < span_cnt; i++) {
+        if(x >= spans[i].x1 && x <= spans[i].x2) return true;
+    }
 
-    lv_draw_fill(&area, mask, color, opa);
+    return false;
 }
 
-static bool deg_test_norm(uint16_t deg, uint16_t start, uint16_t end)
+/**
+ * Divide and round down also with negative numbers
+ * @param n the dividend
+ * @param d the divisor, greater than 0
+ * @return the rounded down quotient
+ */
+static int32_t div_floor(int32_t n, int32_t d)
 {
-    if(deg >= start && deg <= end)
-        return true;
-    else
-        return false;
+    int32_t q = n / d;
+    if(n % d != 0 && n < 0) q--;
+    return q;
 }
 
-static bool deg_test_inv(uint16_t deg, uint16_t start, uint16_t end)
+#if LV_ANTIALIAS
+/**
+ * Draw a faded pixel of the arc's edge if it's in the sector
+ * @param center_x the x coordinate of the center of the arc
+ * @param center_y the y coordinate of the center of the arc
+ * @param x the x coordinate of the pixel relative to the center
+ * @param y the y coordinate of the pixel relative to the center
+ * @param mask the pixel is drawn only in this mask
+ * @param spans the spans of the sector in the row
+ * @param span_cnt number of spans
+ * @param color color of the pixel
+ * @param opa opacity of the pixel
+ */
+static void draw_aa_px(lv_coord_t center_x, lv_coord_t center_y, int32_t x, int32_t y, const lv_area_t * mask,
+                       const arc_span_t spans[], uint8_t span_cnt, lv_color_t color, lv_opa_t opa)
 {
-    if(deg >= start || deg <= end) {
-        return true;
-    } else
-        return false;
+    if(opa < LV_OPA_MIN) return;
+    if(spans_has(spans, span_cnt, x) == false) return;
+
+    lv_draw_px(center_x + x, center_y + y, mask, color, opa);
 }
+#endif
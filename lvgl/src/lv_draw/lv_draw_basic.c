@@ -10,11 +10,17 @@
 #include <string.h>
 
 #include "../lv_core/lv_refr.h"
+#include "../lv_core/lv_prof.h"
 #include "../lv_hal/lv_hal.h"
 #include "../lv_font/lv_font.h"
+#include "../lv_font/lv_font_fmt_txt.h"
 #include "../lv_misc/lv_area.h"
 #include "../lv_misc/lv_color.h"
 #include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_thread.h"
+#include "lv_draw_simd.h"
 
 #include <stddef.h>
 #include "lv_draw.h"
@@ -30,6 +36,15 @@
 /*Always fill < 50 px with 'sw_color_fill' because of the hw. init overhead*/
 #define VFILL_HW_ACC_SIZE_LIMIT 50
 
+/*Pixels of the buffer to recolor images and to pass a fill's color to `set_px_span_cb`*/
+#define ROW_BUF_SIZE 64
+
+/*Don't cache larger glyphs [pixels]*/
+#define GLYPH_CACHE_PX_MAX 1024
+
+/*A glyph can be stored in this many slots after its hashed slot*/
+#define GLYPH_CACHE_PROBE 4
+
 #ifndef LV_ATTRIBUTE_MEM_ALIGN
 #define LV_ATTRIBUTE_MEM_ALIGN
 #endif
@@ -37,6 +52,17 @@
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_GLYPH_CACHE_SIZE
+typedef struct
+{
+    const lv_font_t * font; /*NULL: unused entry*/
+    uint32_t letter;
+    uint32_t life;          /*`glyph_cache_life` when the entry was used last time*/
+    lv_font_glyph_dsc_t dsc;
+    uint8_t * map;          /*`box_w * box_h` opacities*/
+    uint16_t map_size;      /*Allocated size of `map`. The replacing glyphs reuse it if they fit.*/
+} lv_glyph_cache_entry_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -44,17 +70,63 @@
 static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
 static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area, lv_color_t color,
                           lv_opa_t opa);
+static void sw_color_mix_row(lv_color_t * mem, uint32_t length, lv_color_t color, lv_opa_t opa);
+#if LV_USE_GPU
+static void gpu_blend_fill(lv_disp_t * disp, lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area,
+                           lv_color_t color, lv_opa_t opa);
+#endif
+static void map_span(lv_disp_t * disp, lv_color_t * vdb_px, lv_coord_t x, lv_coord_t y, const lv_color_t * src,
+                     lv_coord_t len, lv_opa_t opa);
+static void map_row_spans(lv_disp_t * disp, lv_color_t * vdb_px, lv_coord_t x, lv_coord_t y, const lv_color_t * map_row,
+                          lv_coord_t len, lv_opa_t opa, bool chroma_key, lv_color_t recolor, lv_opa_t recolor_opa);
+static void map_row_alpha(lv_color_t * vdb_px, const uint8_t * map_row, lv_coord_t len, lv_opa_t opa, bool chroma_key,
+                          lv_color_t key, lv_color_t recolor, lv_opa_t recolor_opa);
+static inline lv_color_t map_px_color(const uint8_t * px_color_p);
+static const uint8_t * letter_get_map(const lv_font_t * font_p, uint32_t letter, const lv_point_t * pos_p,
+                                      const lv_area_t * mask_p, lv_font_glyph_dsc_t * g);
+static bool letter_is_on_mask(const lv_font_t * font_p, const lv_font_glyph_dsc_t * g, const lv_point_t * pos_p,
+                              const lv_area_t * mask_p);
+static void letter_expand(const uint8_t * bitmap, const lv_font_glyph_dsc_t * g, uint8_t * map);
+static void letter_spans(lv_disp_t * disp, const uint8_t * map_p, lv_coord_t map_w, lv_coord_t x, lv_coord_t y,
+                         lv_coord_t w, lv_coord_t h, lv_color_t color);
+#if LV_GLYPH_CACHE_SIZE
+static lv_glyph_cache_entry_t * glyph_cache_find(const lv_font_t * font_p, uint32_t letter);
+static void glyph_cache_add(const lv_font_t * font_p, uint32_t letter, const lv_font_glyph_dsc_t * g,
+                            const uint8_t * map);
+static uint32_t glyph_cache_size_cb(void);
+static uint32_t glyph_cache_shrink_cb(uint32_t size);
+#endif
+
+#if LV_USE_OVERDRAW
+static void overdraw_add(const lv_area_t * area_p);
+#endif
 
 static inline lv_color_t color_mix_2_alpha(lv_color_t bg_color, lv_opa_t bg_opa, lv_color_t fg_color, lv_opa_t fg_opa);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static LV_THREAD_LOCAL lv_color_t row_buf[ROW_BUF_SIZE];
+#if LV_GLYPH_CACHE_SIZE
+static lv_glyph_cache_entry_t glyph_cache[LV_GLYPH_CACHE_SIZE];
+static uint32_t glyph_cache_life;
+#endif
+#if LV_USE_OVERDRAW
+static bool overdraw_en;
+static uint8_t overdraw_map[LV_HOR_RES_MAX * LV_VER_RES_MAX]; /*Drawings of the pixels in the current refresh*/
+#endif
 
 /**********************
  *      MACROS
  **********************/
 
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+#if LV_GLYPH_CACHE_SIZE
+const lv_mem_shrinker_t lv_draw_letter_cache_shrinker = {"glyph_cache", glyph_cache_size_cb, glyph_cache_shrink_cb};
+#endif
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -78,6 +150,14 @@ void lv_draw_px(lv_coord_t x, lv_coord_t y, const lv_area_t * mask_p, lv_color_t
         return;
     }
 
+#if LV_USE_OVERDRAW
+    if(overdraw_en) {
+        lv_area_t px_a;
+        lv_area_set(&px_a, x, y, x, y);
+        overdraw_add(&px_a);
+    }
+#endif
+
     lv_disp_t * disp    = lv_refr_get_disp_refreshing();
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
     uint32_t vdb_width  = lv_area_get_width(&vdb->area);
@@ -136,6 +216,11 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
         return;
     }
 
+#if LV_USE_OVERDRAW
+    if(overdraw_en) overdraw_add(&res_a);
+#endif
+    lv_prof_draw_add(opa == LV_OPA_COVER ? LV_PROF_DRAW_FILL : LV_PROF_DRAW_BLEND, lv_area_get_size(&res_a));
+
     lv_disp_t * disp    = lv_refr_get_disp_refreshing();
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
 
@@ -145,15 +230,9 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
     vdb_rel_a.x2 = res_a.x2 - vdb->area.x1;
     vdb_rel_a.y2 = res_a.y2 - vdb->area.y1;
 
-    lv_color_t * vdb_buf_tmp = vdb->buf_act;
-    uint32_t vdb_width       = lv_area_get_width(&vdb->area);
-    /*Move the vdb_tmp to the first row*/
-    vdb_buf_tmp += vdb_width * vdb_rel_a.y1;
+    uint32_t vdb_width = lv_area_get_width(&vdb->area);
 
 #if LV_USE_GPU
-    static LV_ATTRIBUTE_MEM_ALIGN lv_color_t color_array_tmp[LV_HOR_RES_MAX]; /*Used by 'lv_disp_mem_blend'*/
-    static lv_coord_t last_width = -1;
-
     lv_coord_t w = lv_area_get_width(&vdb_rel_a);
     /*Don't use hw. acc. for every small fill (because of the init overhead)*/
     if(w < VFILL_HW_ACC_SIZE_LIMIT) {
@@ -167,22 +246,7 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
         }
         /*Use hw blend if present and the area is not too small*/
         else if(lv_area_get_height(&vdb_rel_a) > VFILL_HW_ACC_SIZE_LIMIT && disp->driver.gpu_blend_cb) {
-            /*Fill a  one line sized buffer with a color and blend this later*/
-            if(color_array_tmp[0].full != color.full || last_width != w) {
-                uint16_t i;
-                for(i = 0; i < w; i++) {
-                    color_array_tmp[i].full = color.full;
-                }
-                last_width = w;
-            }
-
-            /*Blend the filled line to every line VDB line-by-line*/
-            lv_coord_t row;
-            for(row = vdb_rel_a.y1; row <= vdb_rel_a.y2; row++) {
-                disp->driver.gpu_blend_cb(&disp->driver, &vdb_buf_tmp[vdb_rel_a.x1], color_array_tmp, w, opa);
-                vdb_buf_tmp += vdb_width;
-            }
-
+            gpu_blend_fill(disp, vdb->buf_act, vdb_width, &vdb_rel_a, color, opa);
         }
         /*Else use sw fill if no better option*/
         else {
@@ -194,20 +258,7 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
     else {
         /*Use hw blend if present*/
         if(disp->driver.gpu_blend_cb) {
-            if(color_array_tmp[0].full != color.full || last_width != w) {
-                uint16_t i;
-                for(i = 0; i < w; i++) {
-                    color_array_tmp[i].full = color.full;
-                }
-
-                last_width = w;
-            }
-            lv_coord_t row;
-            for(row = vdb_rel_a.y1; row <= vdb_rel_a.y2; row++) {
-                disp->driver.gpu_blend_cb(&disp->driver, &vdb_buf_tmp[vdb_rel_a.x1], color_array_tmp, w, opa);
-                vdb_buf_tmp += vdb_width;
-            }
-
+            gpu_blend_fill(disp, vdb->buf_act, vdb_width, &vdb_rel_a, color, opa);
         }
         /*Use sw fill with opa if no better option*/
         else {
@@ -231,13 +282,6 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
 void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p, uint32_t letter,
                     lv_color_t color, lv_opa_t opa)
 {
-    /*clang-format off*/
-    const uint8_t bpp1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1 (Just for compatibility)*/
-    const uint8_t bpp2_opa_table[4]  = {0, 85, 170, 255}; /*Opacity mapping with bpp = 2*/
-    const uint8_t bpp4_opa_table[16] = {0,  17, 34,  51,  /*Opacity mapping with bpp = 4*/
-                                        68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
-    /*clang-format on*/
-
     if(opa < LV_OPA_MIN) return;
     if(opa > LV_OPA_MAX) opa = LV_OPA_COVER;
 
@@ -247,43 +291,17 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
     }
 
     lv_font_glyph_dsc_t g;
-    bool g_ret = lv_font_get_glyph_dsc(font_p, &g, letter, '\0');
-    if(g_ret == false) return;
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    const uint8_t * map_p = letter_get_map(font_p, letter, pos_p, mask_p, &g);
+    if(map_p == NULL) {
+        lv_draw_scratch_release(&mark); /*The map might be allocated before the font failed to give the bitmap*/
+        return;
+    }
 
     lv_coord_t pos_x = pos_p->x + g.ofs_x;
     lv_coord_t pos_y = pos_p->y + (font_p->line_height - font_p->base_line) - g.box_h - g.ofs_y;
 
-    const uint8_t * bpp_opa_table;
-    uint8_t bitmask_init;
-    uint8_t bitmask;
-
-    switch(g.bpp) {
-        case 1:
-            bpp_opa_table = bpp1_opa_table;
-            bitmask_init  = 0x80;
-            break;
-        case 2:
-            bpp_opa_table = bpp2_opa_table;
-            bitmask_init  = 0xC0;
-            break;
-        case 4:
-            bpp_opa_table = bpp4_opa_table;
-            bitmask_init  = 0xF0;
-            break;
-        case 8:
-            bpp_opa_table = NULL;
-            bitmask_init  = 0xFF;
-            break;       /*No opa table, pixel value will be used directly*/
-        default: return; /*Invalid bpp. Can't render the letter*/
-    }
-
-    const uint8_t * map_p = lv_font_get_glyph_bitmap(font_p, letter);
-
-    if(map_p == NULL) return;
-
-    /*If the letter is completely out of mask don't draw it */
-    if(pos_x + g.box_w < mask_p->x1 || pos_x > mask_p->x2 || pos_y + g.box_h < mask_p->y1 || pos_y > mask_p->y2) return;
-
     lv_disp_t * disp    = lv_refr_get_disp_refreshing();
     lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
 
@@ -291,10 +309,6 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
     lv_color_t * vdb_buf_tmp = vdb->buf_act;
     lv_coord_t col, row;
 
-    uint8_t width_byte_scr = g.box_w >> 3; /*Width in bytes (on the screen finally) (e.g. w = 11 -> 2 bytes wide)*/
-    if(g.box_w & 0x7) width_byte_scr++;
-    uint16_t width_bit = g.box_w * g.bpp; /*Letter width in bits*/
-
     /* Calculate the col/row start/end on the map*/
     lv_coord_t col_start = pos_x >= mask_p->x1 ? 0 : mask_p->x1 - pos_x;
     lv_coord_t col_end   = pos_x + g.box_w <= mask_p->x2 ? g.box_w : mask_p->x2 - pos_x + 1;
@@ -308,13 +322,30 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
     vdb_buf_tmp += (row_start * vdb_width) + col_start;
 
     /*Move on the map too*/
-    uint32_t bit_ofs = (row_start * width_bit) + (col_start * g.bpp);
-    map_p += bit_ofs >> 3;
+    map_p += (row_start * g.box_w) + col_start;
+
+    lv_prof_draw_add(LV_PROF_DRAW_GLYPH, 1);
+    if(col_start < col_end && row_start < row_end) {
+        lv_prof_draw_add(LV_PROF_DRAW_GLYPH_PX, (uint32_t)(col_end - col_start) * (row_end - row_start));
+    }
+
+#if LV_USE_OVERDRAW
+    if(overdraw_en && col_start < col_end && row_start < row_end) {
+        lv_area_t letter_a;
+        lv_area_set(&letter_a, pos_x + col_start, pos_y + row_start, pos_x + col_end - 1, pos_y + row_end - 1);
+        overdraw_add(&letter_a);
+    }
+#endif
+
+    /*The covered runs of the rows can be given to the driver at once (e.g. whole bytes of a packed buffer)*/
+    if(disp->driver.set_px_cb && disp->driver.set_px_span_cb && opa == LV_OPA_COVER) {
+        letter_spans(disp, map_p, g.box_w, pos_x + col_start - vdb->area.x1, pos_y + row_start - vdb->area.y1,
+                     col_end - col_start, row_end - row_start, color);
+        lv_draw_scratch_release(&mark);
+        return;
+    }
 
-    uint8_t letter_px;
     lv_opa_t px_opa;
-    uint16_t col_bit;
-    col_bit = bit_ofs & 0x7; /* "& 0x7" equals to "% 8" just faster */
 
     bool scr_transp = false;
 #if LV_COLOR_SCREEN_TRANSP
@@ -322,16 +353,10 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
 #endif
 
     for(row = row_start; row < row_end; row++) {
-        bitmask = bitmask_init >> col_bit;
         for(col = col_start; col < col_end; col++) {
-            letter_px = (*map_p & bitmask) >> (8 - col_bit - g.bpp);
-            if(letter_px != 0) {
-                if(opa == LV_OPA_COVER) {
-                    px_opa = g.bpp == 8 ? letter_px : bpp_opa_table[letter_px];
-                } else {
-                    px_opa = g.bpp == 8 ? (uint16_t)((uint16_t)letter_px * opa) >> 8
-                                        : (uint16_t)((uint16_t)bpp_opa_table[letter_px] * opa) >> 8;
-                }
+            px_opa = *map_p;
+            if(px_opa != 0) {
+                if(opa != LV_OPA_COVER) px_opa = (uint16_t)((uint16_t)px_opa * opa) >> 8;
 
                 if(disp->driver.set_px_cb) {
                     disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width,
@@ -352,23 +377,143 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
             }
 
             vdb_buf_tmp++;
+            map_p++;
+        }
 
-            if(col_bit < 8 - g.bpp) {
-                col_bit += g.bpp;
-                bitmask = bitmask >> g.bpp;
-            } else {
-                col_bit = 0;
-                bitmask = bitmask_init;
-                map_p++;
+        map_p += g.box_w - (col_end - col_start);          /*Next row on the map*/
+        vdb_buf_tmp += vdb_width - (col_end - col_start); /*Next row in VDB*/
+    }
+
+    lv_draw_scratch_release(&mark);
+}
+
+/**
+ * Write the opacities of a letter into an opacity map instead of the VDB, to copy them later with
+ * `lv_draw_opa_map`. Overlapping letters keep the larger opacity.
+ * @param pos_p left-top coordinate of the latter
+ * @param map_area_p area of the map, on the same coordinates as `pos_p`
+ * @param map `lv_area_get_size(map_area_p)` opacities
+ * @param font_p pointer to font
+ * @param letter a letter to draw
+ */
+void lv_draw_letter_to_map(const lv_point_t * pos_p, const lv_area_t * map_area_p, uint8_t * map,
+                           const lv_font_t * font_p, uint32_t letter)
+{
+    if(font_p == NULL) return;
+
+    lv_font_glyph_dsc_t g;
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    const uint8_t * letter_p = letter_get_map(font_p, letter, pos_p, map_area_p, &g);
+    if(letter_p == NULL) {
+        lv_draw_scratch_release(&mark);
+        return;
+    }
+
+    lv_coord_t pos_x = pos_p->x + g.ofs_x;
+    lv_coord_t pos_y = pos_p->y + (font_p->line_height - font_p->base_line) - g.box_h - g.ofs_y;
+    lv_coord_t map_w = lv_area_get_width(map_area_p);
+
+    lv_coord_t col_start = pos_x >= map_area_p->x1 ? 0 : map_area_p->x1 - pos_x;
+    lv_coord_t col_end   = pos_x + g.box_w <= map_area_p->x2 ? g.box_w : map_area_p->x2 - pos_x + 1;
+    lv_coord_t row_start = pos_y >= map_area_p->y1 ? 0 : map_area_p->y1 - pos_y;
+    lv_coord_t row_end   = pos_y + g.box_h <= map_area_p->y2 ? g.box_h : map_area_p->y2 - pos_y + 1;
+
+    lv_coord_t col, row;
+    for(row = row_start; row < row_end; row++) {
+        const uint8_t * src = &letter_p[row * g.box_w];
+        uint8_t * dest      = &map[(pos_y + row - map_area_p->y1) * map_w + pos_x - map_area_p->x1];
+        for(col = col_start; col < col_end; col++) {
+            if(src[col] > dest[col]) dest[col] = src[col];
+        }
+    }
+
+    lv_draw_scratch_release(&mark);
+}
+
+/**
+ * Draw a color through an opacity map (e.g. the letters of a text written by `lv_draw_letter_to_map`)
+ * @param cords_p coordinates of the map
+ * @param mask_p the map will drawn only on this area (truncated to VDB area)
+ * @param map_p `lv_area_get_size(cords_p)` opacities
+ * @param color color of the drawing
+ * @param opa opacity of the drawing (0..255)
+ */
+void lv_draw_opa_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint8_t * map_p, lv_color_t color,
+                     lv_opa_t opa)
+{
+    if(opa < LV_OPA_MIN) return;
+    if(opa > LV_OPA_MAX) opa = LV_OPA_COVER;
+
+    lv_area_t masked_a;
+    if(lv_area_intersect(&masked_a, cords_p, mask_p) == false) return;
+
+#if LV_USE_OVERDRAW
+    if(overdraw_en) overdraw_add(&masked_a);
+#endif
+    lv_prof_draw_add(LV_PROF_DRAW_GLYPH_PX, lv_area_get_size(&masked_a));
+
+    lv_disp_t * disp    = lv_refr_get_disp_refreshing();
+    lv_disp_buf_t * vdb = lv_disp_get_buf(disp);
+    lv_coord_t vdb_width = lv_area_get_width(&vdb->area);
+    lv_coord_t map_width = lv_area_get_width(cords_p);
+    lv_color_t * vdb_buf = vdb->buf_act;
+
+    bool scr_transp = false;
+#if LV_COLOR_SCREEN_TRANSP
+    scr_transp = disp->driver.screen_transp;
+#endif
+
+    lv_coord_t row;
+    lv_coord_t col;
+    for(row = masked_a.y1; row <= masked_a.y2; row++) {
+        const uint8_t * opa_p = &map_p[(row - cords_p->y1) * map_width + masked_a.x1 - cords_p->x1];
+        lv_color_t * vdb_px   = &vdb_buf[(row - vdb->area.y1) * vdb_width + masked_a.x1 - vdb->area.x1];
+        for(col = masked_a.x1; col <= masked_a.x2; col++, opa_p++, vdb_px++) {
+            lv_opa_t px_opa = *opa_p;
+            if(px_opa == 0) continue;
+            if(opa != LV_OPA_COVER) px_opa = (uint16_t)((uint16_t)px_opa * opa) >> 8;
+
+            if(disp->driver.set_px_cb) {
+                disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width, col - vdb->area.x1,
+                                       row - vdb->area.y1, color, px_opa);
+            } else if(vdb_px->full != color.full) {
+                if(px_opa > LV_OPA_MAX)
+                    *vdb_px = color;
+                else if(px_opa > LV_OPA_MIN) {
+                    if(scr_transp == false) {
+                        *vdb_px = lv_color_mix(color, *vdb_px, px_opa);
+                    } else {
+#if LV_COLOR_DEPTH == 32
+                        *vdb_px = color_mix_2_alpha(*vdb_px, (*vdb_px).ch.alpha, color, px_opa);
+#endif
+                    }
+                }
             }
         }
-        col_bit += ((g.box_w - col_end) + col_start) * g.bpp;
+    }
+}
 
-        map_p += (col_bit >> 3);
-        col_bit = col_bit & 0x7;
-        vdb_buf_tmp += vdb_width - (col_end - col_start); /*Next row in VDB*/
+#if LV_GLYPH_CACHE_SIZE
+/**
+ * Remove the glyphs of a font from the glyph cache. Call it before freeing a font.
+ * @param font_p pointer to a font. NULL to remove all glyphs.
+ */
+void lv_draw_letter_cache_invalidate(const lv_font_t * font_p)
+{
+    lv_thread_lock();
+    uint16_t i;
+    for(i = 0; i < LV_GLYPH_CACHE_SIZE; i++) {
+        lv_glyph_cache_entry_t * e = &glyph_cache[i];
+        if(e->font == NULL) continue;
+        if(font_p != NULL && e->font != font_p) continue;
+
+        if(e->map) lv_mem_free(e->map);
+        memset(e, 0, sizeof(lv_glyph_cache_entry_t));
     }
+    lv_thread_unlock();
 }
+#endif
 
 /**
  * Draw a color map to the display (image)
@@ -399,6 +544,12 @@ void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint
     /*If there are common part of the three area then draw to the vdb*/
     if(union_ok == false) return;
 
+#if LV_USE_OVERDRAW
+    if(overdraw_en) overdraw_add(&masked_a);
+#endif
+    lv_prof_draw_add(alpha_byte ? LV_PROF_DRAW_IMG_ALPHA : chroma_key ? LV_PROF_DRAW_IMG_CHROMA : LV_PROF_DRAW_IMG_TRUE,
+                     lv_area_get_size(&masked_a));
+
     /*The pixel size in byte is different if an alpha byte is added too*/
     uint8_t px_size_byte = alpha_byte ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
 
@@ -433,39 +584,24 @@ void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint
     scr_transp = disp->driver.screen_transp;
 #endif
 
-    /*The simplest case just copy the pixels into the VDB*/
-    if(chroma_key == false && alpha_byte == false && opa == LV_OPA_COVER && recolor_opa == LV_OPA_TRANSP) {
-
-        /*Use the custom VDB write function is exists*/
-        if(disp->driver.set_px_cb) {
-            lv_coord_t col;
-            for(row = masked_a.y1; row <= masked_a.y2; row++) {
-                for(col = 0; col < map_useful_w; col++) {
-                    lv_color_t px_color = *((lv_color_t *)&map_p[(uint32_t)col * px_size_byte]);
-                    disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width, col + masked_a.x1, row,
-                                           px_color, opa);
-                }
-                map_p += map_width * px_size_byte; /*Next row on the map*/
-            }
+    /*Without alpha byte the rows are native pixels so they can be drawn in spans*/
+    if(alpha_byte == false && (scr_transp == false || opa == LV_OPA_COVER)) {
+        for(row = masked_a.y1; row <= masked_a.y2; row++) {
+            map_row_spans(disp, vdb_buf_tmp, masked_a.x1, row, (const lv_color_t *)map_p, map_useful_w, opa, chroma_key,
+                          recolor, recolor_opa);
+            map_p += map_width * px_size_byte; /*Next row on the map*/
+            vdb_buf_tmp += vdb_width;          /*Next row on the VDB*/
         }
-        /*Normal native VDB*/
-        else {
-            for(row = masked_a.y1; row <= masked_a.y2; row++) {
-#if LV_USE_GPU
-                if(disp->driver.gpu_blend_cb == false) {
-                    sw_mem_blend(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
-                } else {
-                    disp->driver.gpu_blend_cb(&disp->driver, vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
-                }
-#else
-                sw_mem_blend(vdb_buf_tmp, (lv_color_t *)map_p, map_useful_w, opa);
-#endif
-                map_p += map_width * px_size_byte; /*Next row on the map*/
-                vdb_buf_tmp += vdb_width;          /*Next row on the VDB*/
-            }
+    }
+    /*With alpha byte on a native VDB the rows are decoded, keyed and recolored in the row buffer*/
+    else if(scr_transp == false && disp->driver.set_px_cb == NULL) {
+        for(row = masked_a.y1; row <= masked_a.y2; row++) {
+            map_row_alpha(vdb_buf_tmp, map_p, map_useful_w, opa, chroma_key, disp->driver.color_chroma_key, recolor,
+                          recolor_opa);
+            map_p += map_width * px_size_byte; /*Next row on the map*/
+            vdb_buf_tmp += vdb_width;          /*Next row on the VDB*/
         }
     }
-
     /*In the other cases every pixel need to be checked one-by-one*/
     else {
 
@@ -551,10 +687,86 @@ void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint
     }
 }
 
+#if LV_USE_OVERDRAW
+/**
+ * Start or stop counting how many times the pixels are drawn in a refresh
+ * @param en true: count the drawings
+ */
+void lv_draw_overdraw_set_en(bool en)
+{
+    if(en && !overdraw_en) memset(overdraw_map, 0, sizeof(overdraw_map));
+    overdraw_en = en;
+}
+
+/**
+ * Tell whether the drawings are counted
+ * @return true: counted
+ */
+bool lv_draw_overdraw_get_en(void)
+{
+    return overdraw_en;
+}
+
+/**
+ * Restart the counting on an area. Called by `lv_refr` before redrawing the area.
+ * @param area_p an area on the screen
+ */
+void lv_draw_overdraw_clear(const lv_area_t * area_p)
+{
+    if(!overdraw_en) return;
+
+    lv_area_t map_a;
+    lv_area_t a;
+    lv_area_set(&map_a, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    if(lv_area_intersect(&a, area_p, &map_a) == false) return;
+
+    lv_coord_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        memset(&overdraw_map[(uint32_t)y * LV_HOR_RES_MAX + a.x1], 0, lv_area_get_width(&a));
+    }
+}
+
+/**
+ * Get how many times a pixel was drawn when it was refreshed last time
+ * @param x x coordinate on the screen
+ * @param y y coordinate on the screen
+ * @return number of drawings (max. 255) or 0 if the pixel is out of the screen
+ */
+uint8_t lv_draw_overdraw_get(lv_coord_t x, lv_coord_t y)
+{
+    if(x < 0 || y < 0 || x >= LV_HOR_RES_MAX || y >= LV_VER_RES_MAX) return 0;
+
+    return overdraw_map[(uint32_t)y * LV_HOR_RES_MAX + x];
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_USE_OVERDRAW
+/**
+ * Count a drawing on an area. The drawing threads draw different bands so they count different pixels.
+ * @param area_p the drawn area on the screen
+ */
+static void overdraw_add(const lv_area_t * area_p)
+{
+    lv_area_t map_a;
+    lv_area_t a;
+    lv_area_set(&map_a, 0, 0, LV_HOR_RES_MAX - 1, LV_VER_RES_MAX - 1);
+    if(lv_area_intersect(&a, area_p, &map_a) == false) return;
+
+    lv_coord_t x;
+    lv_coord_t y;
+    for(y = a.y1; y <= a.y2; y++) {
+        uint8_t * cnt = &overdraw_map[(uint32_t)y * LV_HOR_RES_MAX];
+        for(x = a.x1; x <= a.x2; x++) {
+            if(cnt[x] != UINT8_MAX) cnt[x]++;
+        }
+    }
+}
+#endif
+
 /**
  * Blend pixels to destination memory using opacity
  * @param dest a memory address. Copy 'src' here.
@@ -567,13 +779,57 @@ static void sw_mem_blend(lv_color_t * dest, const lv_color_t * src, uint32_t len
     if(opa == LV_OPA_COVER) {
         memcpy(dest, src, length * sizeof(lv_color_t));
     } else {
-        uint32_t col;
-        for(col = 0; col < length; col++) {
+        uint32_t col = 0;
+#if LV_USE_SIMD
+        col = lv_draw_simd_blend(dest, src, length, opa);
+#endif
+        for(; col < length; col++) {
             dest[col] = lv_color_mix(src[col], dest[col], opa);
         }
     }
 }
 
+#if LV_USE_GPU
+/**
+ * Fill an area with the GPU by blending a line of the color to every row of it
+ * @param disp the display with `gpu_blend_cb`
+ * @param mem a memory address. Considered to a rectangular window according to 'mem_area'
+ * @param mem_width width of the 'mem' buffer
+ * @param fill_area coordinates of an area to fill. Relative to 'mem_area'.
+ * @param color fill color
+ * @param opa opacity (0, LV_OPA_TRANSP: transparent ... 255, LV_OPA_COVER, fully cover)
+ */
+static void gpu_blend_fill(lv_disp_t * disp, lv_color_t * mem, lv_coord_t mem_width, const lv_area_t * fill_area,
+                           lv_color_t color, lv_opa_t opa)
+{
+    lv_coord_t w = lv_area_get_width(fill_area);
+
+    /*The line comes from the scratch arena to not keep a `LV_HOR_RES_MAX` buffer for every thread*/
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    lv_color_t * line = lv_draw_scratch_alloc(w * sizeof(lv_color_t));
+    if(line == NULL) {
+        sw_color_fill(mem, mem_width, fill_area, color, opa);
+        return;
+    }
+
+    lv_coord_t i;
+    for(i = 0; i < w; i++) {
+        line[i].full = color.full;
+    }
+
+    /*Blend the filled line to every line VDB line-by-line*/
+    lv_color_t * row_p = &mem[mem_width * fill_area->y1 + fill_area->x1];
+    lv_coord_t row;
+    for(row = fill_area->y1; row <= fill_area->y2; row++) {
+        disp->driver.gpu_blend_cb(&disp->driver, row_p, line, w, opa);
+        row_p += mem_width;
+    }
+
+    lv_draw_scratch_release(&mark);
+}
+#endif
+
 /**
  * Fill an area with a color
  * @param mem a memory address. Considered to a rectangular window according to 'mem_area'
@@ -590,7 +846,19 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
     lv_coord_t col;
 
     lv_disp_t * disp = lv_refr_get_disp_refreshing();
-    if(disp->driver.set_px_cb) {
+    if(disp->driver.set_px_span_cb && disp->driver.set_px_cb) {
+        /*Pass the color in chunks of the row buffer*/
+        lv_coord_t w   = fill_area->x2 - fill_area->x1 + 1;
+        lv_coord_t buf = LV_MATH_MIN(w, ROW_BUF_SIZE);
+        for(col = 0; col < buf; col++) row_buf[col] = color;
+
+        for(row = fill_area->y1; row <= fill_area->y2; row++) {
+            for(col = fill_area->x1; col <= fill_area->x2; col += buf) {
+                lv_coord_t len = LV_MATH_MIN(buf, fill_area->x2 - col + 1);
+                disp->driver.set_px_span_cb(&disp->driver, (uint8_t *)mem, mem_width, col, row, row_buf, len, opa);
+            }
+        }
+    } else if(disp->driver.set_px_cb) {
         for(col = fill_area->x1; col <= fill_area->x2; col++) {
             for(row = fill_area->y1; row <= fill_area->y2; row++) {
                 disp->driver.set_px_cb(&disp->driver, (uint8_t *)mem, mem_width, col, row, color, opa);
@@ -627,7 +895,13 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
             lv_color_t bg_tmp  = LV_COLOR_BLACK;
             lv_color_t opa_tmp = lv_color_mix(color, bg_tmp, opa);
             for(row = fill_area->y1; row <= fill_area->y2; row++) {
-                for(col = fill_area->x1; col <= fill_area->x2; col++) {
+                col = fill_area->x1;
+#if LV_USE_SIMD
+                uint32_t w = fill_area->x2 - fill_area->x1 + 1;
+                if(scr_transp == false) col += lv_draw_simd_fill(&mem[col], w, color, opa);
+                else col += lv_draw_simd_fill_2_alpha(&mem[col], w, color, opa);
+#endif
+                for(; col <= fill_area->x2; col++) {
                     if(scr_transp == false) {
                         /*If the bg color changed recalculate the result color*/
                         if(mem[col].full != bg_tmp.full) {
@@ -649,6 +923,467 @@ static void sw_color_fill(lv_color_t * mem, lv_coord_t mem_width, const lv_area_
     }
 }
 
+/**
+ * Mix a color to every pixel of a memory
+ * @param mem pointer to the pixels
+ * @param length number of pixels
+ * @param color the color to mix
+ * @param opa opacity of `color`
+ */
+static void sw_color_mix_row(lv_color_t * mem, uint32_t length, lv_color_t color, lv_opa_t opa)
+{
+    uint32_t i = 0;
+#if LV_USE_SIMD
+    i = lv_draw_simd_fill(mem, length, color, opa);
+#endif
+    for(; i < length; i++) {
+        mem[i] = lv_color_mix(color, mem[i], opa);
+    }
+}
+
+/**
+ * Draw native pixels to a row of the VDB with the best available method
+ * @param disp the display being refreshed
+ * @param vdb_px pointer to the first pixel to draw in the VDB
+ * @param x the first column to draw relative to the VDB
+ * @param y the row to draw relative to the VDB
+ * @param src pointer to the pixels to draw
+ * @param len number of pixels
+ * @param opa opacity of the pixels
+ */
+static void map_span(lv_disp_t * disp, lv_color_t * vdb_px, lv_coord_t x, lv_coord_t y, const lv_color_t * src,
+                     lv_coord_t len, lv_opa_t opa)
+{
+    /*Use the custom VDB write function is exists*/
+    if(disp->driver.set_px_cb) {
+        lv_disp_buf_t * vdb  = lv_disp_get_buf(disp);
+        lv_coord_t vdb_width = lv_area_get_width(&vdb->area);
+        if(disp->driver.set_px_span_cb) {
+            disp->driver.set_px_span_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width, x, y, src, len, opa);
+        } else {
+            lv_coord_t i;
+            for(i = 0; i < len; i++) {
+                disp->driver.set_px_cb(&disp->driver, (uint8_t *)vdb->buf_act, vdb_width, x + i, y, src[i], opa);
+            }
+        }
+    }
+    /*Normal native VDB*/
+    else {
+#if LV_USE_GPU
+        if(disp->driver.gpu_blend_cb) {
+            disp->driver.gpu_blend_cb(&disp->driver, vdb_px, src, len, opa);
+            return;
+        }
+#endif
+        sw_mem_blend(vdb_px, src, len, opa);
+    }
+}
+
+/**
+ * Draw a row of a map without alpha byte. The pixels are drawn in spans between the chroma keyed pixels.
+ * @param disp the display being refreshed
+ * @param vdb_px pointer to the first pixel to draw in the VDB
+ * @param x the first column to draw relative to the VDB
+ * @param y the row to draw relative to the VDB
+ * @param map_row pointer to the first pixel of the row in the map
+ * @param len number of pixels
+ * @param opa opacity of the map
+ * @param chroma_key true: don't draw the `LV_COLOR_TRANSP` pixels
+ * @param recolor mix this color to the pixels
+ * @param recolor_opa the intensity of recoloring
+ */
+static void map_row_spans(lv_disp_t * disp, lv_color_t * vdb_px, lv_coord_t x, lv_coord_t y, const lv_color_t * map_row,
+                          lv_coord_t len, lv_opa_t opa, bool chroma_key, lv_color_t recolor, lv_opa_t recolor_opa)
+{
+    lv_color_t key = disp->driver.color_chroma_key;
+    lv_coord_t col = 0;
+    while(col < len) {
+        /*Find the next span of not keyed pixels*/
+        lv_coord_t end = len;
+        if(chroma_key) {
+            while(col < len && map_row[col].full == key.full) col++;
+            end = col;
+            while(end < len && map_row[end].full != key.full) end++;
+        }
+
+        if(recolor_opa == LV_OPA_TRANSP) {
+            if(end > col) map_span(disp, &vdb_px[col], x + col, y, &map_row[col], end - col, opa);
+            col = end;
+        } else {
+            /*Recolor in the row buffer*/
+            while(col < end) {
+                lv_coord_t buf_len = LV_MATH_MIN(end - col, ROW_BUF_SIZE);
+                memcpy(row_buf, &map_row[col], buf_len * sizeof(lv_color_t));
+                sw_color_mix_row(row_buf, buf_len, recolor, recolor_opa);
+                map_span(disp, &vdb_px[col], x + col, y, row_buf, buf_len, opa);
+                col += buf_len;
+            }
+        }
+    }
+}
+
+/**
+ * Draw a row of a map with alpha byte to a native VDB
+ * @param vdb_px pointer to the first pixel to draw in the VDB
+ * @param map_row pointer to the first pixel of the row in the map
+ * @param len number of pixels
+ * @param opa opacity of the map
+ * @param chroma_key true: don't draw the `key` colored pixels
+ * @param key the chroma key color
+ * @param recolor mix this color to the pixels
+ * @param recolor_opa the intensity of recoloring
+ */
+static void map_row_alpha(lv_color_t * vdb_px, const uint8_t * map_row, lv_coord_t len, lv_opa_t opa, bool chroma_key,
+                          lv_color_t key, lv_color_t recolor, lv_opa_t recolor_opa)
+{
+    lv_coord_t col;
+    if(chroma_key == false && recolor_opa == LV_OPA_TRANSP) {
+        for(col = 0; col < len; col++) {
+            const uint8_t * px_color_p = &map_row[(uint32_t)col * LV_IMG_PX_SIZE_ALPHA_BYTE];
+            lv_opa_t px_opa            = px_color_p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+            if(px_opa == LV_OPA_TRANSP) continue;
+
+            lv_color_t px_color = map_px_color(px_color_p);
+            lv_opa_t opa_result = opa;
+            if(px_opa != LV_OPA_COVER) opa_result = (uint32_t)((uint32_t)px_opa * opa_result) >> 8;
+
+            if(opa_result == LV_OPA_COVER)
+                vdb_px[col] = px_color;
+            else
+                vdb_px[col] = lv_color_mix(px_color, vdb_px[col], opa_result);
+        }
+        return;
+    }
+
+    /*Decode a part of the row to the row buffer (the keyed pixels get transparent) and recolor it at once*/
+    lv_opa_t px_opa_buf[ROW_BUF_SIZE];
+    col = 0;
+    while(col < len) {
+        lv_coord_t buf_len = LV_MATH_MIN(len - col, ROW_BUF_SIZE);
+        const uint8_t * px_color_p = &map_row[(uint32_t)col * LV_IMG_PX_SIZE_ALPHA_BYTE];
+        lv_coord_t i;
+        for(i = 0; i < buf_len; i++) {
+            row_buf[i]    = map_px_color(px_color_p);
+            px_opa_buf[i] = px_color_p[LV_IMG_PX_SIZE_ALPHA_BYTE - 1];
+            if(chroma_key && row_buf[i].full == key.full) px_opa_buf[i] = LV_OPA_TRANSP;
+            px_color_p += LV_IMG_PX_SIZE_ALPHA_BYTE;
+        }
+
+        if(recolor_opa != LV_OPA_TRANSP) sw_color_mix_row(row_buf, buf_len, recolor, recolor_opa);
+
+        lv_color_t * dest = &vdb_px[col];
+        for(i = 0; i < buf_len; i++) {
+            lv_opa_t px_opa = px_opa_buf[i];
+            if(px_opa == LV_OPA_TRANSP) continue;
+
+            lv_opa_t opa_result = opa;
+            if(px_opa != LV_OPA_COVER) opa_result = (uint32_t)((uint32_t)px_opa * opa_result) >> 8;
+
+            if(opa_result == LV_OPA_COVER)
+                dest[i] = row_buf[i];
+            else
+                dest[i] = lv_color_mix(row_buf[i], dest[i], opa_result);
+        }
+        col += buf_len;
+    }
+}
+
+/**
+ * Read the color of a pixel with alpha byte
+ * @param px_color_p pointer to the pixel in a map
+ * @return the color of the pixel
+ */
+static inline lv_color_t map_px_color(const uint8_t * px_color_p)
+{
+    lv_color_t px_color;
+#if LV_COLOR_DEPTH == 8 || LV_COLOR_DEPTH == 1
+    px_color.full = px_color_p[0];
+#elif LV_COLOR_DEPTH == 16
+    /*Because of Alpha byte 16 bit color can start on odd address which can cause crash*/
+    px_color.full = px_color_p[0] + (px_color_p[1] << 8);
+#elif LV_COLOR_DEPTH == 32
+    px_color = *((lv_color_t *)px_color_p);
+#endif
+    return px_color;
+}
+
+/**
+ * Get the descriptor of a glyph and its opacities with 8 bit-per-pixel
+ * @param font_p pointer to font
+ * @param letter a letter
+ * @param pos_p left-top coordinate of the latter
+ * @param mask_p the letter will be drawn only on this area
+ * @param g store the glyph's descriptor here
+ * @return `box_w * box_h` opacities in the scratch arena or NULL if the letter can't be drawn or it's out of the mask
+ */
+static const uint8_t * letter_get_map(const lv_font_t * font_p, uint32_t letter, const lv_point_t * pos_p,
+                                      const lv_area_t * mask_p, lv_font_glyph_dsc_t * g)
+{
+    uint8_t * map;
+    uint32_t size;
+
+#if LV_GLYPH_CACHE_SIZE
+    /*Copy it while locked because an other drawing thread might replace the entry*/
+    map = NULL;
+    lv_thread_lock();
+    lv_glyph_cache_entry_t * e = glyph_cache_find(font_p, letter);
+    if(e) {
+        *g      = e->dsc;
+        e->life = ++glyph_cache_life;
+        if(letter_is_on_mask(font_p, g, pos_p, mask_p)) {
+            size = (uint32_t)g->box_w * g->box_h;
+            map  = lv_draw_scratch_alloc(size);
+            if(map && size) memcpy(map, e->map, size);
+        }
+    }
+    lv_thread_unlock();
+    if(e) return map;
+#endif
+
+    if(lv_font_get_glyph_dsc(font_p, g, letter, '\0') == false) return NULL;
+    if(g->bpp != 1 && g->bpp != 2 && g->bpp != 4 && g->bpp != 8) return NULL; /*Invalid bpp. Can't render the letter*/
+
+    /*Don't even cache the letters out of the mask. They might never be drawn.*/
+    if(letter_is_on_mask(font_p, g, pos_p, mask_p) == false) return NULL;
+
+    size = (uint32_t)g->box_w * g->box_h;
+    map  = lv_draw_scratch_alloc(size);
+    if(map == NULL) return NULL;
+
+#if LV_USE_FONT_COMPRESSED
+    if(lv_font_fmt_txt_decompress(font_p, letter, map) == false)
+#endif
+    {
+        const uint8_t * bitmap = lv_font_get_glyph_bitmap(font_p, letter);
+        if(bitmap == NULL) return NULL;
+        letter_expand(bitmap, g, map);
+    }
+
+#if LV_GLYPH_CACHE_SIZE
+    if(size <= GLYPH_CACHE_PX_MAX) glyph_cache_add(font_p, letter, g, map);
+#endif
+
+    return map;
+}
+
+/**
+ * Tell whether a glyph is at least partially on the mask
+ * @param font_p pointer to font
+ * @param g descriptor of the glyph
+ * @param pos_p left-top coordinate of the latter
+ * @param mask_p the letter will be drawn only on this area
+ * @return false: the letter is completely out of the mask
+ */
+static bool letter_is_on_mask(const lv_font_t * font_p, const lv_font_glyph_dsc_t * g, const lv_point_t * pos_p,
+                              const lv_area_t * mask_p)
+{
+    lv_coord_t pos_x = pos_p->x + g->ofs_x;
+    lv_coord_t pos_y = pos_p->y + (font_p->line_height - font_p->base_line) - g->box_h - g->ofs_y;
+
+    if(pos_x + g->box_w < mask_p->x1 || pos_x > mask_p->x2 || pos_y + g->box_h < mask_p->y1 || pos_y > mask_p->y2) {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Convert the bitmap of a glyph to 8 bit-per-pixel opacities
+ * @param bitmap the bitmap from the font. Its rows are continuous (not aligned to bytes).
+ * @param g descriptor of the glyph
+ * @param map store the `box_w * box_h` opacities here
+ */
+static void letter_expand(const uint8_t * bitmap, const lv_font_glyph_dsc_t * g, uint8_t * map)
+{
+    /*clang-format off*/
+    static const uint8_t bpp1_opa_table[2]  = {0, 255};          /*Opacity mapping with bpp = 1 (Just for compatibility)*/
+    static const uint8_t bpp2_opa_table[4]  = {0, 85, 170, 255}; /*Opacity mapping with bpp = 2*/
+    static const uint8_t bpp4_opa_table[16] = {0,  17, 34,  51,  /*Opacity mapping with bpp = 4*/
+                                               68, 85, 102, 119, 136, 153, 170, 187, 204, 221, 238, 255};
+    /*clang-format on*/
+
+    uint32_t px_num = (uint32_t)g->box_w * g->box_h;
+
+    if(g->bpp == 8) {
+        memcpy(map, bitmap, px_num); /*No opa table, pixel value will be used directly*/
+        return;
+    }
+
+    const uint8_t * bpp_opa_table;
+    switch(g->bpp) {
+        case 1: bpp_opa_table = bpp1_opa_table; break;
+        case 2: bpp_opa_table = bpp2_opa_table; break;
+        default: bpp_opa_table = bpp4_opa_table; break;
+    }
+
+    uint8_t bpp      = g->bpp;
+    uint8_t px_mask  = (1 << bpp) - 1;
+    uint32_t bit_ofs = 0;
+    uint32_t i;
+    for(i = 0; i < px_num; i++) {
+        uint8_t letter_px = (bitmap[bit_ofs >> 3] >> (8 - bpp - (bit_ofs & 0x7))) & px_mask;
+        map[i]            = bpp_opa_table[letter_px];
+        bit_ofs += bpp;
+    }
+}
+
+/**
+ * Draw the opacities of a letter with the driver's `set_px_span_cb`: the covered runs of the rows as spans,
+ * the other pixels with `set_px_cb`
+ * @param disp the refreshed display
+ * @param map_p the first opacity to draw
+ * @param map_w width of the opacity map
+ * @param x column of the first pixel in the VDB
+ * @param y row of the first pixel in the VDB
+ * @param w number of columns to draw
+ * @param h number of rows to draw
+ * @param color color of the letter
+ */
+static void letter_spans(lv_disp_t * disp, const uint8_t * map_p, lv_coord_t map_w, lv_coord_t x, lv_coord_t y,
+                         lv_coord_t w, lv_coord_t h, lv_color_t color)
+{
+    lv_disp_buf_t * vdb  = lv_disp_get_buf(disp);
+    lv_coord_t vdb_width = lv_area_get_width(&vdb->area);
+    uint8_t * buf        = (uint8_t *)vdb->buf_act;
+
+    lv_coord_t span_max = LV_MATH_MIN(w, ROW_BUF_SIZE);
+    lv_coord_t i;
+    for(i = 0; i < span_max; i++) row_buf[i] = color;
+
+    lv_coord_t row;
+    for(row = 0; row < h; row++) {
+        lv_coord_t col = 0;
+        while(col < w) {
+            if(map_p[col] <= LV_OPA_MAX) {
+                if(map_p[col] != 0) {
+                    disp->driver.set_px_cb(&disp->driver, buf, vdb_width, x + col, y + row, color, map_p[col]);
+                }
+                col++;
+                continue;
+            }
+
+            lv_coord_t end = col + 1;
+            while(end < w && end - col < span_max && map_p[end] > LV_OPA_MAX) end++;
+            disp->driver.set_px_span_cb(&disp->driver, buf, vdb_width, x + col, y + row, row_buf, end - col,
+                                        LV_OPA_COVER);
+            col = end;
+        }
+
+        map_p += map_w;
+    }
+}
+
+#if LV_GLYPH_CACHE_SIZE
+/**
+ * Search a glyph in the cache. Call it only with `lv_thread_lock()`.
+ * @param font_p pointer to font
+ * @param letter a letter
+ * @return the entry of the glyph or NULL if not cached
+ */
+static lv_glyph_cache_entry_t * glyph_cache_find(const lv_font_t * font_p, uint32_t letter)
+{
+    uint32_t slot = (letter + ((uintptr_t)font_p >> 3)) % LV_GLYPH_CACHE_SIZE;
+    uint16_t i;
+    for(i = 0; i < GLYPH_CACHE_PROBE; i++) {
+        lv_glyph_cache_entry_t * e = &glyph_cache[slot];
+        if(e->font == font_p && e->letter == letter) return e;
+
+        slot++;
+        if(slot == LV_GLYPH_CACHE_SIZE) slot = 0;
+    }
+
+    return NULL;
+}
+
+/**
+ * Store the opacities of a glyph in place of an unused or the least recently used glyph
+ * @param font_p pointer to font
+ * @param letter a letter
+ * @param g descriptor of the glyph
+ * @param map `box_w * box_h` opacities of the glyph
+ */
+static void glyph_cache_add(const lv_font_t * font_p, uint32_t letter, const lv_font_glyph_dsc_t * g,
+                            const uint8_t * map)
+{
+    uint32_t size = (uint32_t)g->box_w * g->box_h;
+
+    lv_thread_lock();
+    if(glyph_cache_find(font_p, letter)) { /*An other drawing thread might have added it meanwhile*/
+        lv_thread_unlock();
+        return;
+    }
+
+    uint32_t slot               = (letter + ((uintptr_t)font_p >> 3)) % LV_GLYPH_CACHE_SIZE;
+    lv_glyph_cache_entry_t * e = &glyph_cache[slot];
+    uint16_t i;
+    for(i = 1; i < GLYPH_CACHE_PROBE && e->font; i++) {
+        slot++;
+        if(slot == LV_GLYPH_CACHE_SIZE) slot = 0;
+        if(glyph_cache[slot].font == NULL || glyph_cache[slot].life < e->life) e = &glyph_cache[slot];
+    }
+
+    if(size > e->map_size) {
+        /*Allocate a little more to let the similar glyphs fit later. No need to keep the old content.
+         *Clear the entry first: the allocation might shrink the cache.*/
+        if(e->map) lv_mem_free(e->map);
+        memset(e, 0, sizeof(lv_glyph_cache_entry_t));
+        uint8_t * new_map = lv_mem_alloc((size + 0xF) & ~0xF);
+        lv_mem_assert(new_map);
+        if(new_map == NULL) {
+            lv_thread_unlock();
+            return;
+        }
+        e->map      = new_map;
+        e->map_size = (size + 0xF) & ~0xF;
+    }
+
+    if(size) memcpy(e->map, map, size);
+    e->font   = font_p;
+    e->letter = letter;
+    e->dsc    = *g;
+    e->life   = ++glyph_cache_life;
+    lv_thread_unlock();
+}
+
+/**
+ * The bytes `lv_draw_letter_cache_shrinker` can give back: the opacities of the cached glyphs
+ */
+static uint32_t glyph_cache_size_cb(void)
+{
+    uint32_t size = 0;
+    uint16_t i;
+    for(i = 0; i < LV_GLYPH_CACHE_SIZE; i++) size += glyph_cache[i].map_size;
+
+    return size;
+}
+
+/**
+ * Remove the least recently used glyphs until `size` bytes are freed. Called with `lv_thread_lock()`.
+ * @param size bytes to free
+ * @return the freed bytes
+ */
+static uint32_t glyph_cache_shrink_cb(uint32_t size)
+{
+    uint32_t freed = 0;
+    while(freed < size) {
+        lv_glyph_cache_entry_t * lru = NULL;
+        uint16_t i;
+        for(i = 0; i < LV_GLYPH_CACHE_SIZE; i++) {
+            lv_glyph_cache_entry_t * e = &glyph_cache[i];
+            if(e->map == NULL) continue;
+            if(lru == NULL || e->life < lru->life) lru = e;
+        }
+        if(lru == NULL) break;
+
+        freed += lru->map_size;
+        lv_mem_free(lru->map);
+        memset(lru, 0, sizeof(lv_glyph_cache_entry_t));
+    }
+
+    return freed;
+}
+#endif
+
 /**
  * Mix two colors. Both color can have alpha value. It requires ARGB888 colors.
  * @param bg_color background color
@@ -22,6 +22,7 @@ extern "C" {
 #include "../lv_font/lv_font.h"
 #include "../lv_misc/lv_color.h"
 #include "../lv_misc/lv_area.h"
+#include "../lv_misc/lv_mem.h"
 
 /*********************
  *      DEFINES
@@ -57,6 +58,42 @@ void lv_draw_fill(const lv_area_t * cords_p, const lv_area_t * mask_p, lv_color_
 void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv_font_t * font_p, uint32_t letter,
                     lv_color_t color, lv_opa_t opa);
 
+/**
+ * Write the opacities of a letter into an opacity map instead of the VDB, to copy them later with
+ * `lv_draw_opa_map`. Overlapping letters keep the larger opacity.
+ * @param pos_p left-top coordinate of the latter
+ * @param map_area_p area of the map, on the same coordinates as `pos_p`
+ * @param map `lv_area_get_size(map_area_p)` opacities
+ * @param font_p pointer to font
+ * @param letter a letter to draw
+ */
+void lv_draw_letter_to_map(const lv_point_t * pos_p, const lv_area_t * map_area_p, uint8_t * map,
+                           const lv_font_t * font_p, uint32_t letter);
+
+/**
+ * Draw a color through an opacity map (e.g. the letters of a text written by `lv_draw_letter_to_map`)
+ * @param cords_p coordinates of the map
+ * @param mask_p the map will drawn only on this area (truncated to VDB area)
+ * @param map_p `lv_area_get_size(cords_p)` opacities
+ * @param color color of the drawing
+ * @param opa opacity of the drawing (0..255)
+ */
+void lv_draw_opa_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint8_t * map_p, lv_color_t color,
+                     lv_opa_t opa);
+
+#if LV_GLYPH_CACHE_SIZE
+/**
+ * Remove the glyphs of a font from the glyph cache. Call it before freeing a font.
+ * @param font_p pointer to a font. NULL to remove all glyphs.
+ */
+void lv_draw_letter_cache_invalidate(const lv_font_t * font_p);
+
+/**
+ * Removes the least recently used glyphs if the memory is low (see `lv_mem_shrinker_add`)
+ */
+extern const lv_mem_shrinker_t lv_draw_letter_cache_shrinker;
+#endif
+
 /**
  * Draw a color map to the display (image)
  * @param cords_p coordinates the color map
@@ -71,6 +108,34 @@ void lv_draw_letter(const lv_point_t * pos_p, const lv_area_t * mask_p, const lv
 void lv_draw_map(const lv_area_t * cords_p, const lv_area_t * mask_p, const uint8_t * map_p, lv_opa_t opa,
                  bool chroma_key, bool alpha_byte, lv_color_t recolor, lv_opa_t recolor_opa);
 
+#if LV_USE_OVERDRAW
+/**
+ * Start or stop counting how many times the pixels are drawn in a refresh
+ * @param en true: count the drawings
+ */
+void lv_draw_overdraw_set_en(bool en);
+
+/**
+ * Tell whether the drawings are counted
+ * @return true: counted
+ */
+bool lv_draw_overdraw_get_en(void);
+
+/**
+ * Restart the counting on an area. Called by `lv_refr` before redrawing the area.
+ * @param area_p an area on the screen
+ */
+void lv_draw_overdraw_clear(const lv_area_t * area_p);
+
+/**
+ * Get how many times a pixel was drawn when it was refreshed last time
+ * @param x x coordinate on the screen
+ * @param y y coordinate on the screen
+ * @return number of drawings (max. 255) or 0 if the pixel is out of the screen
+ */
+uint8_t lv_draw_overdraw_get(lv_coord_t x, lv_coord_t y);
+#endif
+
 /**********************
  *      MACROS
  **********************/
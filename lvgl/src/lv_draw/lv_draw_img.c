@@ -9,6 +9,11 @@
 #include "lv_draw_img.h"
 #include "lv_img_cache.h"
 #include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_core/lv_refr.h"
+#include "../lv_core/lv_prof.h"
+#include "../lv_misc/lv_math.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -23,6 +28,12 @@
  **********************/
 static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mask, const void * src,
                                  const lv_style_t * style, lv_opa_t opa_scale);
+static lv_res_t lv_img_draw_tiled_core(const lv_area_t * coords, const lv_area_t * mask, const void * src,
+                                       const lv_style_t * style, lv_opa_t opa_scale, const lv_point_t * offset);
+static void draw_error(const lv_area_t * coords, const lv_area_t * mask, const char * msg);
+static lv_color_t * palette_recolor(lv_img_cache_entry_t * cdsc, const lv_style_t * style, lv_opa_t * recolor_opa);
+static void row_repeat(uint8_t * dst, const uint8_t * src_row, lv_coord_t img_w, lv_coord_t x, lv_coord_t len,
+                       uint8_t px_size);
 
 /**********************
  *  STATIC VARIABLES
@@ -49,18 +60,50 @@ void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void *
 {
     if(src == NULL) {
         LV_LOG_WARN("Image draw: src is NULL");
-        lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
-        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+        draw_error(coords, mask, "No\ndata");
         return;
     }
 
+    /*The image cache and the decoders are shared by the drawing threads*/
     lv_res_t res;
+    lv_thread_lock();
     res = lv_img_draw_core(coords, mask, src, style, opa_scale);
+    lv_thread_unlock();
 
     if(res == LV_RES_INV) {
         LV_LOG_WARN("Image draw error");
-        lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
-        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, "No\ndata", LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+        draw_error(coords, mask, "No\ndata");
+        return;
+    }
+}
+
+/**
+ * Fill an area with the repeated copies of an image. The image is opened once and its rows are
+ * repeated in a row buffer, so the tiles aren't decoded one by one.
+ * @param coords the area to fill
+ * @param mask the image will be drawn only in this area
+ * @param src pointer to an image source (see `lv_draw_img`)
+ * @param style style of the image
+ * @param opa_scale scale down all opacities by the factor
+ * @param offset the point of the image in the top left corner of `coords`. Wrapped around the image's size.
+ */
+void lv_draw_img_tiled(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_style_t * style,
+                       lv_opa_t opa_scale, const lv_point_t * offset)
+{
+    if(src == NULL) {
+        LV_LOG_WARN("Image draw: src is NULL");
+        draw_error(coords, mask, "No\ndata");
+        return;
+    }
+
+    lv_res_t res;
+    lv_thread_lock();
+    res = lv_img_draw_tiled_core(coords, mask, src, style, opa_scale, offset);
+    lv_thread_unlock();
+
+    if(res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw error");
+        draw_error(coords, mask, "No\ndata");
         return;
     }
 }
@@ -448,14 +491,19 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
 
     if(cdsc == NULL) return LV_RES_INV;
 
+#if LV_USE_IMG_CACHE_ASYNC
+    if(cdsc->pending) {
+        lv_img_cache_draw_placeholder(cdsc, coords, mask, opa);
+        return LV_RES_OK;
+    }
+#endif
+
     bool chroma_keyed = lv_img_color_format_is_chroma_keyed(cdsc->dec_dsc.header.cf);
     bool alpha_byte   = lv_img_color_format_has_alpha(cdsc->dec_dsc.header.cf);
 
     if(cdsc->dec_dsc.error_msg != NULL) {
         LV_LOG_WARN("Image draw error");
-        lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
-        lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, cdsc->dec_dsc.error_msg, LV_TXT_FLAG_NONE, NULL, -1,
-                      -1, NULL);
+        draw_error(coords, mask, cdsc->dec_dsc.error_msg);
     }
     /* The decoder open could open the image and gave the entire uncompressed image.
      * Just draw it!*/
@@ -467,7 +515,13 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
     else {
         lv_coord_t width = lv_area_get_width(&mask_com);
 
-        uint8_t  * buf = lv_draw_get_buf(lv_area_get_width(&mask_com) * ((LV_COLOR_DEPTH >> 3) + 1));  /*+1 because of the possible alpha byte*/
+        lv_draw_scratch_mark_t mark;
+        lv_draw_scratch_mark(&mark);
+        uint8_t  * buf = lv_draw_scratch_alloc(lv_area_get_width(&mask_com) * ((LV_COLOR_DEPTH >> 3) + 1));  /*+1 because of the possible alpha byte*/
+        if(buf == NULL) return LV_RES_INV;
+
+        lv_opa_t recolor_opa = style->image.intense;
+        lv_color_t * palette = palette_recolor(cdsc, style, &recolor_opa);
 
         lv_area_t line;
         lv_area_copy(&line, &mask_com);
@@ -476,19 +530,195 @@ static lv_res_t lv_img_draw_core(const lv_area_t * coords, const lv_area_t * mas
         lv_coord_t y = mask_com.y1 - coords->y1;
         lv_coord_t row;
         lv_res_t read_res;
+        lv_prof_draw_add(LV_PROF_DRAW_IMG_DECODE, lv_area_get_size(&mask_com));
         for(row = mask_com.y1; row <= mask_com.y2; row++) {
-            read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
+            if(palette) read_res = lv_img_decoder_read_line_palette(&cdsc->dec_dsc, x, y, width, buf, palette);
+            else read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, x, y, width, buf);
             if(read_res != LV_RES_OK) {
-                lv_img_decoder_close(&cdsc->dec_dsc);
+                lv_draw_scratch_release(&mark);
+                lv_img_cache_invalidate_src(src); /*Don't leave a closed decoder in the cache*/
                 LV_LOG_WARN("Image draw can't read the line");
                 return LV_RES_INV;
             }
-            lv_draw_map(&line, mask, buf, opa, chroma_keyed, alpha_byte, style->image.color, style->image.intense);
+            lv_draw_map(&line, mask, buf, opa, chroma_keyed, alpha_byte, style->image.color, recolor_opa);
             line.y1++;
             line.y2++;
             y++;
         }
+
+        lv_draw_scratch_release(&mark);
     }
 
     return LV_RES_OK;
 }
+
+static lv_res_t lv_img_draw_tiled_core(const lv_area_t * coords, const lv_area_t * mask, const void * src,
+                                       const lv_style_t * style, lv_opa_t opa_scale, const lv_point_t * offset)
+{
+    lv_area_t mask_com; /*Common area of mask and coords*/
+    if(lv_area_intersect(&mask_com, mask, coords) == false) return LV_RES_OK;
+
+    lv_opa_t opa =
+        opa_scale == LV_OPA_COVER ? style->image.opa : (uint16_t)((uint16_t)style->image.opa * opa_scale) >> 8;
+
+    lv_img_cache_entry_t * cdsc = lv_img_cache_open(src, style);
+    if(cdsc == NULL) return LV_RES_INV;
+
+#if LV_USE_IMG_CACHE_ASYNC
+    if(cdsc->pending) {
+        lv_img_cache_draw_placeholder(cdsc, coords, mask, opa);
+        return LV_RES_OK;
+    }
+#endif
+
+    if(cdsc->dec_dsc.error_msg != NULL) {
+        LV_LOG_WARN("Image draw error");
+        draw_error(coords, mask, cdsc->dec_dsc.error_msg);
+        return LV_RES_OK;
+    }
+
+    lv_coord_t img_w = cdsc->dec_dsc.header.w;
+    lv_coord_t img_h = cdsc->dec_dsc.header.h;
+    if(img_w == 0 || img_h == 0) return LV_RES_OK;
+
+    bool chroma_keyed = lv_img_color_format_is_chroma_keyed(cdsc->dec_dsc.header.cf);
+    bool alpha_byte   = lv_img_color_format_has_alpha(cdsc->dec_dsc.header.cf);
+    uint8_t px_size   = alpha_byte ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+
+    /*The pixel of the image in the top left corner of `mask_com`*/
+    lv_coord_t x = (mask_com.x1 - coords->x1 + offset->x) % img_w;
+    lv_coord_t y = (mask_com.y1 - coords->y1 + offset->y) % img_h;
+    if(x < 0) x += img_w;
+    if(y < 0) y += img_h;
+
+    /*A band of rows as wide as the mask. If it's as high as the image it's filled only once
+     *and drawn below itself again and again. Else it's refilled band by band, in the worst case row by row.*/
+    lv_coord_t width  = lv_area_get_width(&mask_com);
+    lv_coord_t height = lv_area_get_height(&mask_com);
+    lv_coord_t band_h = LV_MATH_MIN(img_h, height);
+
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    uint8_t * band = lv_draw_scratch_alloc((uint32_t)width * band_h * px_size);
+    if(band == NULL) {
+        band_h = 1;
+        band   = lv_draw_scratch_alloc((uint32_t)width * px_size);
+    }
+
+    /*Without the whole decoded image the rows are read into a row buffer*/
+    const uint8_t * img_data = cdsc->dec_dsc.img_data;
+    uint8_t * img_row        = img_data == NULL ? lv_draw_scratch_alloc((uint32_t)img_w * px_size) : NULL;
+    if(band == NULL || (img_data == NULL && img_row == NULL)) {
+        lv_draw_scratch_release(&mark);
+        return LV_RES_INV;
+    }
+
+    lv_opa_t recolor_opa = style->image.intense;
+    lv_color_t * palette = img_data == NULL ? palette_recolor(cdsc, style, &recolor_opa) : NULL;
+
+    lv_area_t band_a;
+    band_a.x1 = mask_com.x1;
+    band_a.x2 = mask_com.x2;
+    band_a.y1 = mask_com.y1;
+    bool filled = false;
+    while(band_a.y1 <= mask_com.y2) {
+        band_a.y2 = band_a.y1 + band_h - 1;
+
+        if(!filled) {
+            lv_coord_t r;
+            for(r = 0; r < band_h; r++) {
+                const uint8_t * src_row;
+                if(img_data) {
+                    src_row = img_data + (uint32_t)y * img_w * px_size;
+                } else {
+                    lv_res_t read_res;
+                    if(palette) read_res = lv_img_decoder_read_line_palette(&cdsc->dec_dsc, 0, y, img_w, img_row, palette);
+                    else read_res = lv_img_decoder_read_line(&cdsc->dec_dsc, 0, y, img_w, img_row);
+                    if(read_res != LV_RES_OK) {
+                        lv_draw_scratch_release(&mark);
+                        lv_img_cache_invalidate_src(src); /*Don't leave a closed decoder in the cache*/
+                        LV_LOG_WARN("Image draw can't read the line");
+                        return LV_RES_INV;
+                    }
+                    lv_prof_draw_add(LV_PROF_DRAW_IMG_DECODE, img_w);
+                    src_row = img_row;
+                }
+                row_repeat(band + (uint32_t)r * width * px_size, src_row, img_w, x, width, px_size);
+                y++;
+                if(y >= img_h) y = 0;
+            }
+            /*A band of a whole image starts with the same row as the next one*/
+            if(band_h == img_h) filled = true;
+        }
+
+        lv_draw_map(&band_a, &mask_com, band, opa, chroma_keyed, alpha_byte, style->image.color, recolor_opa);
+        band_a.y1 += band_h;
+    }
+
+    lv_draw_scratch_release(&mark);
+    return LV_RES_OK;
+}
+
+static void draw_error(const lv_area_t * coords, const lv_area_t * mask, const char * msg)
+{
+    lv_draw_rect(coords, mask, &lv_style_plain, LV_OPA_COVER);
+    lv_draw_label(coords, mask, &lv_style_plain, LV_OPA_COVER, msg, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL, NULL);
+}
+
+/**
+ * Recolor the palette of an indexed image once instead of every pixel.
+ * The keyed color stays keyed because the map checks the key after recoloring.
+ * @param cdsc the opened image
+ * @param style style of the image
+ * @param recolor_opa the recoloring of the style, set to `LV_OPA_TRANSP` if the palette is recolored
+ * @return the recolored palette in the scratch buffer or NULL if the image has no palette (or no recoloring)
+ */
+static lv_color_t * palette_recolor(lv_img_cache_entry_t * cdsc, const lv_style_t * style, lv_opa_t * recolor_opa)
+{
+    if(*recolor_opa == LV_OPA_TRANSP) return NULL;
+
+    uint16_t palette_size;
+    const lv_color_t * img_palette = lv_img_decoder_get_palette(&cdsc->dec_dsc, &palette_size);
+    if(img_palette == NULL) return NULL;
+    lv_color_t * palette = lv_draw_scratch_alloc(palette_size * sizeof(lv_color_t));
+    if(palette == NULL) return NULL;
+
+    lv_color_t key = lv_refr_get_disp_refreshing()->driver.color_chroma_key;
+    uint16_t i;
+    for(i = 0; i < palette_size; i++) {
+        if(img_palette[i].full == key.full) palette[i] = key;
+        else palette[i] = lv_color_mix(style->image.color, img_palette[i], *recolor_opa);
+    }
+    *recolor_opa = LV_OPA_TRANSP;
+    return palette;
+}
+
+/**
+ * Repeat a row of an image in a longer row
+ * @param dst store the pixels here
+ * @param src_row a row of the image
+ * @param img_w width of the image
+ * @param x the first pixel of `src_row` to store
+ * @param len number of pixels to store
+ * @param px_size size of a pixel in bytes
+ */
+static void row_repeat(uint8_t * dst, const uint8_t * src_row, lv_coord_t img_w, lv_coord_t x, lv_coord_t len,
+                       uint8_t px_size)
+{
+    /*The end of the row from `x`, then a whole row*/
+    lv_coord_t head = LV_MATH_MIN(img_w - x, len);
+    memcpy(dst, src_row + (uint32_t)x * px_size, (uint32_t)head * px_size);
+    lv_coord_t done = head;
+    if(done >= len) return;
+
+    lv_coord_t n = LV_MATH_MIN(img_w, len - done);
+    memcpy(dst + (uint32_t)done * px_size, src_row, (uint32_t)n * px_size);
+    done += n;
+
+    /*Double the whole rows stored after the head*/
+    while(done < len) {
+        n = LV_MATH_MIN(done - head, len - done);
+        memcpy(dst + (uint32_t)done * px_size, dst + (uint32_t)head * px_size, (uint32_t)n * px_size);
+        done += n;
+    }
+}
@@ -39,6 +39,19 @@ extern "C" {
 void lv_draw_img(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_style_t * style,
                  lv_opa_t opa_scale);
 
+/**
+ * Fill an area with the repeated copies of an image. The image is opened once and its rows are
+ * repeated in a row buffer, so the tiles aren't decoded one by one.
+ * @param coords the area to fill
+ * @param mask the image will be drawn only in this area
+ * @param src pointer to an image source (see `lv_draw_img`)
+ * @param style style of the image
+ * @param opa_scale scale down all opacities by the factor
+ * @param offset the point of the image in the top left corner of `coords`. Wrapped around the image's size.
+ */
+void lv_draw_img_tiled(const lv_area_t * coords, const lv_area_t * mask, const void * src, const lv_style_t * style,
+                       lv_opa_t opa_scale, const lv_point_t * offset);
+
 /**
  * Get the type of an image source
  * @param src pointer to an image source:
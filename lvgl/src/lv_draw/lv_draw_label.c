@@ -7,7 +7,9 @@
  *      INCLUDES
  *********************/
 #include "lv_draw_label.h"
+#include <string.h>
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_mem.h"
 
 /*********************
  *      DEFINES
@@ -53,16 +55,22 @@ static uint8_t hex_char_to_num(char hex);
  * @param offset text offset in x and y direction (NULL if unused)
  * @param sel_start start index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
  * @param sel_end end index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
+ * @param hint pointer to a `lv_draw_label_hint_t` variable.
+ * It is managed by the drawer to speed up the drawing of very long texts (thousands of lines).
+ * @param layout the lines of `txt` calculated with the same style, width and flags (NULL if unused).
+ * If set `hint` is not used.
  */
 void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
-                   lv_draw_label_hint_t * hint)
+                   lv_draw_label_hint_t * hint, const lv_txt_layout_t * layout)
 {
     const lv_font_t * font = style->text.font;
     lv_coord_t w;
     if((flag & LV_TXT_FLAG_EXPAND) == 0) {
         /*Normally use the label's width as width*/
         w = lv_area_get_width(coords);
+    } else if(layout) {
+        w = layout->size.x;
     } else {
         /*If EXAPND is enabled then not limit the text's width to the object's width*/
         lv_point_t p;
@@ -90,6 +98,9 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     uint32_t line_start     = 0;
     int32_t last_line_start = -1;
 
+    /*The layout is better than the hint*/
+    if(layout) hint = NULL;
+
     /*Check the hint to use the cached info*/
     if(hint && y_ofs == 0) {
         /*If the label changed too much recalculate the hint.*/
@@ -105,10 +116,26 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         pos.y += hint->y;
     }
 
-    uint32_t line_end = line_start + lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+    uint32_t line_end;
+    uint32_t line_id = 0; /*Index of the line in `layout`*/
+
+    if(layout) {
+        /*Jump to the first visible line*/
+        if(pos.y + line_height < mask->y1) {
+            if(line_height <= 0) return;
+            line_id = (mask->y1 - pos.y + line_height - 1) / line_height - 1;
+            pos.y += (lv_coord_t)line_id * line_height;
+        }
+
+        if(line_id >= layout->line_cnt) return;
+        line_start = layout->lines[line_id].start;
+        line_end   = layout->lines[line_id + 1].start;
+    } else {
+        line_end = line_start + lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+    }
 
     /*Go the first visible line*/
-    while(pos.y + line_height < mask->y1) {
+    while(layout == NULL && pos.y + line_height < mask->y1) {
         /*Go to next line*/
         line_start = line_end;
         line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
@@ -126,14 +153,24 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
 
     /*Align to middle*/
     if(flag & LV_TXT_FLAG_CENTER) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        if(layout) {
+            line_width = layout->lines[line_id].width;
+        } else {
+            line_width =
+                lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        }
 
         pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
     }
     /*Align to the right*/
     else if(flag & LV_TXT_FLAG_RIGHT) {
-        line_width = lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        if(layout) {
+            line_width = layout->lines[line_id].width;
+        } else {
+            line_width =
+                lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+        }
         pos.x += lv_area_get_width(coords) - line_width;
     }
 
@@ -158,9 +195,10 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         i         = line_start;
         uint32_t letter;
         uint32_t letter_next;
+        uint32_t ascii_end = 0;
         while(i < line_end) {
-            letter      = lv_txt_encoded_next(txt, &i);
-            letter_next = lv_txt_encoded_next(&txt[i], NULL);
+            letter      = lv_txt_encoded_next_fast(txt, &i, &ascii_end, line_end);
+            letter_next = lv_txt_encoded_peek_fast(txt, i);
 
             /*Handle the re-color command*/
             if((flag & LV_TXT_FLAG_RECOLOR) != 0) {
@@ -225,21 +263,35 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
         }
         /*Go to next line*/
         line_start = line_end;
-        line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        if(layout) {
+            line_id++;
+            if(line_id >= layout->line_cnt) break;
+            line_end = layout->lines[line_id + 1].start;
+        } else {
+            line_end += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, w, flag);
+        }
 
         pos.x = coords->x1;
         /*Align to middle*/
         if(flag & LV_TXT_FLAG_CENTER) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+            if(layout) {
+                line_width = layout->lines[line_id].width;
+            } else {
+                line_width =
+                    lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+            }
 
             pos.x += (lv_area_get_width(coords) - line_width) / 2;
 
         }
         /*Align to the right*/
         else if(flag & LV_TXT_FLAG_RIGHT) {
-            line_width =
-                lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+            if(layout) {
+                line_width = layout->lines[line_id].width;
+            } else {
+                line_width =
+                    lv_txt_get_width(&txt[line_start], line_end - line_start, font, style->text.letter_space, flag);
+            }
             pos.x += lv_area_get_width(coords) - line_width;
         }
 
@@ -250,6 +302,66 @@ void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_st
     }
 }
 
+/**
+ * Write a one line text into an opacity map ("strip") to draw it with `lv_draw_opa_map` at any offset
+ * without drawing its letters again, e.g. in a rolling label. The re-color commands are not handled.
+ * @param style pointer to a style, its font and letter space are used
+ * @param txt 0 terminated text without line breaks
+ * @param max_size allocate the map only if it's not larger than this many bytes
+ * @param area_p store the area of the map here, relative to the left-top corner of the text
+ * @return the map allocated with `lv_mem_alloc` (the caller frees it) or NULL if it's too large
+ */
+uint8_t * lv_draw_label_strip_create(const lv_style_t * style, const char * txt, uint32_t max_size,
+                                     lv_area_t * area_p)
+{
+    const lv_font_t * font = style->text.font;
+    lv_area_set(area_p, 0, 0, 0, lv_font_get_line_height(font) - 1);
+
+    /*The glyphs can stand out of the line so find their boxes first*/
+    lv_coord_t x       = 0;
+    uint32_t i         = 0;
+    uint32_t ascii_end = 0;
+    uint32_t len       = strlen(txt);
+    while(txt[i] != '\0') {
+        uint32_t letter      = lv_txt_encoded_next_fast(txt, &i, &ascii_end, len);
+        uint32_t letter_next = lv_txt_encoded_peek_fast(txt, i);
+        lv_font_glyph_dsc_t g;
+        if(lv_font_get_glyph_dsc(font, &g, letter, letter_next) == false) continue;
+
+        if(g.box_w > 0 && g.box_h > 0) {
+            lv_coord_t y = (font->line_height - font->base_line) - g.box_h - g.ofs_y;
+            area_p->x1   = LV_MATH_MIN(area_p->x1, x + g.ofs_x);
+            area_p->x2   = LV_MATH_MAX(area_p->x2, x + g.ofs_x + g.box_w - 1);
+            area_p->y1   = LV_MATH_MIN(area_p->y1, y);
+            area_p->y2   = LV_MATH_MAX(area_p->y2, y + g.box_h - 1);
+        }
+
+        lv_coord_t letter_w = lv_font_get_glyph_width(font, letter, letter_next);
+        if(letter_w > 0) x += letter_w + style->text.letter_space;
+    }
+
+    uint32_t size = lv_area_get_size(area_p);
+    if(size > max_size) return NULL;
+
+    uint8_t * map = lv_mem_alloc(size);
+    if(map == NULL) return NULL;
+    memset(map, 0, size);
+
+    lv_point_t pos = {0, 0};
+    i              = 0;
+    ascii_end      = 0;
+    while(txt[i] != '\0') {
+        uint32_t letter      = lv_txt_encoded_next_fast(txt, &i, &ascii_end, len);
+        uint32_t letter_next = lv_txt_encoded_peek_fast(txt, i);
+        lv_draw_letter_to_map(&pos, area_p, map, font, letter);
+
+        lv_coord_t letter_w = lv_font_get_glyph_width(font, letter, letter_next);
+        if(letter_w > 0) pos.x += letter_w + style->text.letter_space;
+    }
+
+    return map;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -55,10 +55,26 @@ typedef struct {
  * @param offset text offset in x and y direction (NULL if unused)
  * @param sel_start start index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
  * @param sel_end end index of selected area (`LV_LABEL_TXT_SEL_OFF` if none)
+ * @param hint pointer to a `lv_draw_label_hint_t` variable.
+ * It is managed by the drawer to speed up the drawing of very long texts (thousands of lines).
+ * @param layout the lines of `txt` calculated with the same style, width and flags (NULL if unused).
+ * If set `hint` is not used.
  */
 void lv_draw_label(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale,
                    const char * txt, lv_txt_flag_t flag, lv_point_t * offset, uint16_t sel_start, uint16_t sel_end,
-                   lv_draw_label_hint_t * hint);
+                   lv_draw_label_hint_t * hint, const lv_txt_layout_t * layout);
+
+/**
+ * Write a one line text into an opacity map ("strip") to draw it with `lv_draw_opa_map` at any offset
+ * without drawing its letters again, e.g. in a rolling label. The re-color commands are not handled.
+ * @param style pointer to a style, its font and letter space are used
+ * @param txt 0 terminated text without line breaks
+ * @param max_size allocate the map only if it's not larger than this many bytes
+ * @param area_p store the area of the map here, relative to the left-top corner of the text
+ * @return the map allocated with `lv_mem_alloc` (the caller frees it) or NULL if it's too large
+ */
+uint8_t * lv_draw_label_strip_create(const lv_style_t * style, const char * txt, uint32_t max_size,
+                                     lv_area_t * area_p);
 
 /**********************
  *      MACROS
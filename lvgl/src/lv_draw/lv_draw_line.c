@@ -8,6 +8,8 @@
  *********************/
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
 #include "lv_draw.h"
 #include "../lv_core/lv_refr.h"
 #include "../lv_misc/lv_math.h"
@@ -15,6 +17,10 @@
 /*********************
  *      DEFINES
  *********************/
+#define LINE_SUBPX_SHIFT    8
+#define LINE_SUBPX          (1 << LINE_SUBPX_SHIFT) /*Sub-pixels in a pixel on both axes*/
+#define LINE_COVER_FULL     (2 << (2 * LINE_SUBPX_SHIFT)) /*Doubled area of a fully covered pixel*/
+#define LINE_CIRCLE_PT_MAX  32
 
 /**********************
  *      TYPEDEFS
@@ -22,38 +28,62 @@
 
 typedef struct
 {
-    lv_point_t p1;
-    lv_point_t p2;
-    lv_point_t p_act;
-    lv_coord_t dx;
-    lv_coord_t sx; /*-1: x1 < x2; 1: x2 >= x1*/
-    lv_coord_t dy;
-    lv_coord_t sy; /*-1: y1 < y2; 1: y2 >= y1*/
-    lv_coord_t err;
-    lv_coord_t e2;
-    bool hor; /*Rather horizontal or vertical*/
-} line_draw_t;
+    int32_t x;
+    int32_t y;
+} line_subpx_t;
 
+/*An edge of the polygons going downward, in sub-pixels*/
 typedef struct
 {
-    lv_coord_t width;
-    lv_coord_t width_1;
-    lv_coord_t width_half;
-} line_width_t;
+    int32_t x0;
+    int32_t y0; /*Top*/
+    int32_t x1;
+    int32_t y1; /*Bottom*/
+    int32_t dir; /*1: the polygon goes downward here, -1: upward*/
+} line_edge_t;
+
+/*The union of the polygons of a thick line*/
+typedef struct
+{
+    line_edge_t * edges; /*NULL: only count the edges*/
+    uint32_t edge_cnt;
+    line_subpx_t win_min; /*The drawn area in sub-pixels, the polygons out of it are dropped*/
+    line_subpx_t win_max;
+} line_shape_t;
+
+/*The covered area and the cover of the pixels of a row*/
+typedef struct
+{
+    int32_t * cover; /*Sum of the heights of the edges in the pixel*/
+    int32_t * area;  /*Sum of the heights times the doubled distance from the pixel's left side*/
+    int32_t w;
+    int32_t min; /*The first and last pixels with edges*/
+    int32_t max;
+} line_cells_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void line_draw_hor(line_draw_t * main_line, const lv_area_t * mask, const lv_style_t * style,
-                          lv_opa_t opa_scale);
-static void line_draw_ver(line_draw_t * main_line, const lv_area_t * mask, const lv_style_t * style,
-                          lv_opa_t opa_scale);
-static void line_draw_skew(line_draw_t * main_line, bool dir_ori, const lv_area_t * mask, const lv_style_t * style,
-                           lv_opa_t opa_scale);
-static void line_init(line_draw_t * line, const lv_point_t * p1, const lv_point_t * p2);
-static bool line_next(line_draw_t * line);
-static bool line_next_y(line_draw_t * line);
-static bool line_next_x(line_draw_t * line);
+static void line_draw_hor(const lv_point_t * p1, const lv_point_t * p2, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale);
+static void line_draw_ver(const lv_point_t * p1, const lv_point_t * p2, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale);
+static void polyline_draw(const lv_point_t * points, uint16_t point_cnt, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale, bool round);
+static void polyline_build(line_shape_t * shape, const line_subpx_t * pts, uint32_t pt_cnt, int32_t half,
+                           bool round);
+static void shape_add_poly(line_shape_t * shape, const line_subpx_t * pts, uint16_t pt_cnt);
+static void shape_add_circle(line_shape_t * shape, const line_subpx_t * c, int32_t r);
+static void shape_draw(line_shape_t * shape, const lv_area_t * draw_area, const lv_area_t * mask, lv_color_t color,
+                       lv_opa_t opa, bool aa);
+static void cells_add(line_cells_t * cells, int32_t xa, int32_t ya, int32_t xb, int32_t yb, int32_t dir);
+static void cell_add(line_cells_t * cells, int32_t x0, int32_t x1, int32_t dy);
+static lv_opa_t cover_to_opa(int32_t v, bool aa);
+static void span_draw(lv_coord_t x1, lv_coord_t x2, lv_coord_t y, const lv_area_t * mask, lv_color_t color,
+                      lv_opa_t opa, lv_opa_t cover);
+static int32_t vect_len(int32_t x, int32_t y);
+static uint16_t circle_pt_cnt(int32_t r);
+static int edge_cmp(const void * a, const void * b);
 
 /**********************
  *  STATIC VARIABLES
@@ -88,549 +118,495 @@ void lv_draw_line(const lv_point_t * point1, const lv_point_t * point2, const lv
     if(point1->y < mask->y1 && point2->y < mask->y1) return;
     if(point1->y > mask->y2 && point2->y > mask->y2) return;
 
-    line_draw_t main_line;
-    lv_point_t p1;
-    lv_point_t p2;
-
-    /*If the line if rather vertical then be sure y1 < y2 else x1 < x2*/
-
-    if(LV_MATH_ABS(point1->x - point2->x) > LV_MATH_ABS(point1->y - point2->y)) {
-
-        /*Steps less in y then x -> rather horizontal*/
-        if(point1->x < point2->x) {
-            p1.x = point1->x;
-            p1.y = point1->y;
-            p2.x = point2->x;
-            p2.y = point2->y;
-        } else {
-            p1.x = point2->x;
-            p1.y = point2->y;
-            p2.x = point1->x;
-            p2.y = point1->y;
-        }
-    } else {
-        /*Steps less in x then y -> rather vertical*/
-        if(point1->y < point2->y) {
-            p1.x = point1->x;
-            p1.y = point1->y;
-            p2.x = point2->x;
-            p2.y = point2->y;
-        } else {
-            p1.x = point2->x;
-            p1.y = point2->y;
-            p2.x = point1->x;
-            p2.y = point1->y;
-        }
-    }
-
-    line_init(&main_line, &p1, &p2);
-
     /*Special case draw a horizontal line*/
-    if(main_line.p1.y == main_line.p2.y) {
-        line_draw_hor(&main_line, mask, style, opa_scale);
+    if(point1->y == point2->y) {
+        line_draw_hor(point1, point2, mask, style, opa_scale);
     }
     /*Special case draw a vertical line*/
-    else if(main_line.p1.x == main_line.p2.x) {
-        line_draw_ver(&main_line, mask, style, opa_scale);
+    else if(point1->x == point2->x) {
+        line_draw_ver(point1, point2, mask, style, opa_scale);
     }
     /*Arbitrary skew line*/
     else {
-        bool dir_ori = false;
-#if LV_ANTIALIAS
-        bool aa = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
-        if(aa) {
-            lv_point_t p_tmp;
-
-            if(main_line.hor) {
-                if(main_line.p1.y < main_line.p2.y) {
-                    dir_ori = true;
-                    p_tmp.x = main_line.p2.x;
-                    p_tmp.y = main_line.p2.y - 1;
-                    line_init(&main_line, &p1, &p_tmp);
-                    main_line.sy = LV_MATH_ABS(main_line.sy); /*The sign can change if the line becomes horizontal*/
-                } else if(main_line.p1.y > main_line.p2.y) {
-                    dir_ori = false;
-                    p_tmp.x = main_line.p2.x;
-                    p_tmp.y = main_line.p2.y + 1;
-                    line_init(&main_line, &p1, &p_tmp);
-                    main_line.sy = -LV_MATH_ABS(main_line.sy); /*The sign can change if the line becomes horizontal*/
-                }
-            } else {
-                if(main_line.p1.x < main_line.p2.x) {
-                    dir_ori = true;
-                    p_tmp.x = main_line.p2.x - 1;
-                    p_tmp.y = main_line.p2.y;
-                    line_init(&main_line, &p1, &p_tmp);
-                    main_line.sx = LV_MATH_ABS(main_line.sx); /*The sign can change if the line becomes vertical*/
-                } else if(main_line.p1.x > main_line.p2.x) {
-                    dir_ori = false;
-                    p_tmp.x = main_line.p2.x + 1;
-                    p_tmp.y = main_line.p2.y;
-                    line_init(&main_line, &p1, &p_tmp);
-                    main_line.sx = -LV_MATH_ABS(main_line.sx); /*The sign can change if the line becomes vertical*/
-                }
-            }
-        }
-#endif
-        line_draw_skew(&main_line, dir_ori, mask, style, opa_scale);
+        lv_point_t points[2] = {*point1, *point2};
+        polyline_draw(points, 2, mask, style, opa_scale, false);
     }
 }
 
+/**
+ * Draw connected lines at once. Unlike drawing the lines one by one the joints are drawn only once
+ * (a semi transparent polyline has no darker spots) and they have no gaps: they are beveled
+ * or, with `style->line.rounded`, round like the ends of the polyline.
+ * @param points the points of the polyline
+ * @param point_cnt number of points in `points`
+ * @param mask the polyline will be drawn only on this area
+ * @param style pointer to a line's style
+ * @param opa_scale scale down all opacities by the factor
+ */
+void lv_draw_polyline(const lv_point_t * points, uint16_t point_cnt, const lv_area_t * mask,
+                      const lv_style_t * style, lv_opa_t opa_scale)
+{
+    polyline_draw(points, point_cnt, mask, style, opa_scale, style->line.rounded != 0);
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
-static void line_draw_hor(line_draw_t * main_line, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale)
+static void line_draw_hor(const lv_point_t * p1, const lv_point_t * p2, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale)
 {
     lv_coord_t width      = style->line.width - 1;
     lv_coord_t width_half = width >> 1;
     lv_coord_t width_1    = width & 0x1;
     lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->line.opa : (uint16_t)((uint16_t)style->line.opa * opa_scale) >> 8;
 
-    lv_area_t act_area;
-    act_area.x1 = main_line->p1.x;
-    act_area.x2 = main_line->p2.x;
-    act_area.y1 = main_line->p1.y - width_half - width_1;
-    act_area.y2 = main_line->p2.y + width_half;
-
     lv_area_t draw_area;
-    draw_area.x1 = LV_MATH_MIN(act_area.x1, act_area.x2);
-    draw_area.x2 = LV_MATH_MAX(act_area.x1, act_area.x2);
-    draw_area.y1 = LV_MATH_MIN(act_area.y1, act_area.y2);
-    draw_area.y2 = LV_MATH_MAX(act_area.y1, act_area.y2);
+    draw_area.x1 = LV_MATH_MIN(p1->x, p2->x);
+    draw_area.x2 = LV_MATH_MAX(p1->x, p2->x);
+    draw_area.y1 = p1->y - width_half - width_1;
+    draw_area.y2 = p1->y + width_half;
     lv_draw_fill(&draw_area, mask, style->line.color, opa);
 }
 
-static void line_draw_ver(line_draw_t * main_line, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale)
+static void line_draw_ver(const lv_point_t * p1, const lv_point_t * p2, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale)
 {
     lv_coord_t width      = style->line.width - 1;
     lv_coord_t width_half = width >> 1;
     lv_coord_t width_1    = width & 0x1;
     lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->line.opa : (uint16_t)((uint16_t)style->line.opa * opa_scale) >> 8;
 
-    lv_area_t act_area;
-    act_area.x1 = main_line->p1.x - width_half;
-    act_area.x2 = main_line->p2.x + width_half + width_1;
-    act_area.y1 = main_line->p1.y;
-    act_area.y2 = main_line->p2.y;
-
     lv_area_t draw_area;
-    draw_area.x1 = LV_MATH_MIN(act_area.x1, act_area.x2);
-    draw_area.x2 = LV_MATH_MAX(act_area.x1, act_area.x2);
-    draw_area.y1 = LV_MATH_MIN(act_area.y1, act_area.y2);
-    draw_area.y2 = LV_MATH_MAX(act_area.y1, act_area.y2);
+    draw_area.x1 = p1->x - width_half;
+    draw_area.x2 = p1->x + width_half + width_1;
+    draw_area.y1 = LV_MATH_MIN(p1->y, p2->y);
+    draw_area.y2 = LV_MATH_MAX(p1->y, p2->y);
     lv_draw_fill(&draw_area, mask, style->line.color, opa);
 }
 
-static void line_draw_skew(line_draw_t * main_line, bool dir_ori, const lv_area_t * mask, const lv_style_t * style,
-                           lv_opa_t opa_scale)
+/**
+ * Draw a polyline as the union of polygons: a rectangle for every line, a bevel triangle or a circle
+ * on the joints and circles on the ends if `round`. The coverage of the pixels is calculated exactly
+ * (in sub-pixels) and the rows are drawn as spans of equal coverage.
+ */
+static void polyline_draw(const lv_point_t * points, uint16_t point_cnt, const lv_area_t * mask,
+                          const lv_style_t * style, lv_opa_t opa_scale, bool round)
 {
+    if(style->line.width == 0 || point_cnt == 0) return;
 
     lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->line.opa : (uint16_t)((uint16_t)style->line.opa * opa_scale) >> 8;
-#if LV_ANTIALIAS
-    bool aa = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
-#endif
-    lv_point_t vect_main, vect_norm;
-    vect_main.x = main_line->p2.x - main_line->p1.x;
-    vect_main.y = main_line->p2.y - main_line->p1.y;
-
-    if(main_line->hor) {
-        if(main_line->p1.y < main_line->p2.y + dir_ori) {
-            vect_norm.x = -vect_main.y;
-            vect_norm.y = vect_main.x;
-        } else {
-            vect_norm.x = vect_main.y;
-            vect_norm.y = -vect_main.x;
-        }
-    } else {
-        if(main_line->p1.x < main_line->p2.x + dir_ori) {
-            vect_norm.x = vect_main.y;
-            vect_norm.y = -vect_main.x;
-        } else {
-            vect_norm.x = -vect_main.y;
-            vect_norm.y = vect_main.x;
-        }
-    }
+    if(opa < LV_OPA_MIN) return;
 
-    /* In case of a short but tick line the perpendicular ending is longer then the real line.
-     * it would break the calculations so make the normal vector larger*/
-    vect_norm.x = vect_norm.x << 4;
-    vect_norm.y = vect_norm.y << 4;
-
-    lv_coord_t width;
-    width = style->line.width;
-
-    /* The pattern stores the points of the line ending. It has the good direction and length.
-     * The worth case is the 45° line where pattern can have 1.41 x `width` points*/
-
-    lv_point_t * pattern = lv_draw_get_buf(width * 2 * sizeof(lv_point_t));
-    lv_coord_t i = 0;
-
-    /*Create a perpendicular pattern (a small line)*/
-    if(width != 0) {
-        line_draw_t pattern_line;
-        lv_point_t p0 = {0, 0};
-        line_init(&pattern_line, &p0, &vect_norm);
-
-        uint32_t width_sqr = width * width;
-        /* Run for a lot of times. Meanwhile the real width will be determined as well */
-        for(i = 0; i < (lv_coord_t)sizeof(pattern); i++) {
-            pattern[i].x = pattern_line.p_act.x;
-            pattern[i].y = pattern_line.p_act.y;
-
-            /*Finish the pattern line if it's length equal to the desired width (Use Pythagoras
-             * theorem)*/
-            uint32_t sqr = pattern_line.p_act.x * pattern_line.p_act.x + pattern_line.p_act.y * pattern_line.p_act.y;
-            if(sqr >= width_sqr) {
-                width = i;
 #if LV_ANTIALIAS
-                if(aa) width--;
+    bool aa = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
+#else
+    bool aa = false;
 #endif
-                break;
-            }
 
-            line_next(&pattern_line);
-        }
+    int32_t width = style->line.width;
+    int32_t half  = (width << LINE_SUBPX_SHIFT) / 2;
+
+    /* The middle of the line. With an even width it's on the pixel border where the horizontal
+     * and vertical lines put it.*/
+    int32_t ofs_x = (width & 0x1) ? LINE_SUBPX / 2 : LINE_SUBPX;
+    int32_t ofs_y = (width & 0x1) ? LINE_SUBPX / 2 : 0;
+
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+
+    line_subpx_t * pts = lv_draw_scratch_alloc(point_cnt * sizeof(line_subpx_t));
+    if(pts == NULL) return;
+
+    /*Convert to sub-pixels and drop the repeated points*/
+    uint32_t pt_cnt = 0;
+    line_subpx_t p_min = {INT32_MAX, INT32_MAX};
+    line_subpx_t p_max = {INT32_MIN, INT32_MIN};
+    uint16_t i;
+    for(i = 0; i < point_cnt; i++) {
+        if(pt_cnt != 0 && points[i].x == points[i - 1].x && points[i].y == points[i - 1].y) continue;
+        pts[pt_cnt].x = ((int32_t)points[i].x << LINE_SUBPX_SHIFT) + ofs_x;
+        pts[pt_cnt].y = ((int32_t)points[i].y << LINE_SUBPX_SHIFT) + ofs_y;
+        p_min.x = LV_MATH_MIN(p_min.x, pts[pt_cnt].x);
+        p_min.y = LV_MATH_MIN(p_min.y, pts[pt_cnt].y);
+        p_max.x = LV_MATH_MAX(p_max.x, pts[pt_cnt].x);
+        p_max.y = LV_MATH_MAX(p_max.y, pts[pt_cnt].y);
+        pt_cnt++;
     }
 
-#if LV_ANTIALIAS
-    lv_coord_t aa_last_corner;
-    lv_coord_t width_safe = width;
-    if(aa) {
-        if(width == 0) width_safe = 1;
-
-        aa_last_corner = 0;
+    if(pt_cnt == 1 && round == false) {
+        lv_draw_scratch_release(&mark);
+        return;
     }
-#endif
 
-    lv_coord_t x_center_ofs = 0;
-    lv_coord_t y_center_ofs = 0;
-
-    if(width != 0) {
-        x_center_ofs = pattern[width - 1].x / 2;
-        y_center_ofs = pattern[width - 1].y / 2;
-    } else {
-        if(main_line->hor && main_line->p1.y >= main_line->p2.y + dir_ori) pattern[0].y--;
-        if(!main_line->hor && main_line->p1.x >= main_line->p2.x + dir_ori) pattern[0].x--;
+    /*The line reaches `half` from the points and the flat ends half pixel further*/
+    int32_t reach = half + LINE_SUBPX;
+    lv_area_t draw_area;
+    draw_area.x1 = (p_min.x - reach) >> LINE_SUBPX_SHIFT;
+    draw_area.y1 = (p_min.y - reach) >> LINE_SUBPX_SHIFT;
+    draw_area.x2 = (p_max.x + reach) >> LINE_SUBPX_SHIFT;
+    draw_area.y2 = (p_max.y + reach) >> LINE_SUBPX_SHIFT;
+    if(lv_area_intersect(&draw_area, &draw_area, mask) == false) {
+        lv_draw_scratch_release(&mark);
+        return;
     }
 
-    /* Make the coordinates relative to the center */
-    for(i = 0; i < width; i++) {
-        pattern[i].x -= x_center_ofs;
-        pattern[i].y -= y_center_ofs;
-#if LV_ANTIALIAS
-        if(aa) {
-            if(i != 0) {
-                if(main_line->hor) {
-                    if(pattern[i - 1].x != pattern[i].x) {
-                        lv_coord_t seg_w = pattern[i].y - pattern[aa_last_corner].y;
-                        if(main_line->sy < 0) {
-                            lv_draw_aa_ver_seg(main_line->p1.x + pattern[aa_last_corner].x - 1,
-                                               main_line->p1.y + pattern[aa_last_corner].y + seg_w + 1, seg_w, mask,
-                                               style->line.color, opa);
-
-                            lv_draw_aa_ver_seg(main_line->p2.x + pattern[aa_last_corner].x + 1,
-                                               main_line->p2.y + pattern[aa_last_corner].y + seg_w + 1, -seg_w, mask,
-                                               style->line.color, opa);
-                        } else {
-                            lv_draw_aa_ver_seg(main_line->p1.x + pattern[aa_last_corner].x - 1,
-                                               main_line->p1.y + pattern[aa_last_corner].y, seg_w, mask,
-                                               style->line.color, opa);
-
-                            lv_draw_aa_ver_seg(main_line->p2.x + pattern[aa_last_corner].x + 1,
-                                               main_line->p2.y + pattern[aa_last_corner].y, -seg_w, mask,
-                                               style->line.color, opa);
-                        }
-                        aa_last_corner = i;
-                    }
-                } else {
-                    if(pattern[i - 1].y != pattern[i].y) {
-                        lv_coord_t seg_w = pattern[i].x - pattern[aa_last_corner].x;
-                        if(main_line->sx < 0) {
-                            lv_draw_aa_hor_seg(main_line->p1.x + pattern[aa_last_corner].x + seg_w + 1,
-                                               main_line->p1.y + pattern[aa_last_corner].y - 1, seg_w, mask,
-                                               style->line.color, opa);
-
-                            lv_draw_aa_hor_seg(main_line->p2.x + pattern[aa_last_corner].x + seg_w + 1,
-                                               main_line->p2.y + pattern[aa_last_corner].y + 1, -seg_w, mask,
-                                               style->line.color, opa);
-                        } else {
-                            lv_draw_aa_hor_seg(main_line->p1.x + pattern[aa_last_corner].x,
-                                               main_line->p1.y + pattern[aa_last_corner].y - 1, seg_w, mask,
-                                               style->line.color, opa);
-
-                            lv_draw_aa_hor_seg(main_line->p2.x + pattern[aa_last_corner].x,
-                                               main_line->p2.y + pattern[aa_last_corner].y + 1, -seg_w, mask,
-                                               style->line.color, opa);
-                        }
-                        aa_last_corner = i;
-                    }
-                }
-            }
+    line_shape_t shape;
+    memset(&shape, 0, sizeof(shape));
+    shape.win_min.x = (int32_t)draw_area.x1 << LINE_SUBPX_SHIFT;
+    shape.win_min.y = (int32_t)draw_area.y1 << LINE_SUBPX_SHIFT;
+    shape.win_max.x = ((int32_t)draw_area.x2 + 1) << LINE_SUBPX_SHIFT;
+    shape.win_max.y = ((int32_t)draw_area.y2 + 1) << LINE_SUBPX_SHIFT;
+
+    /*Count the edges first to allocate them at once*/
+    polyline_build(&shape, pts, pt_cnt, half, round);
+    if(shape.edge_cnt != 0) {
+        shape.edges = lv_draw_scratch_alloc(shape.edge_cnt * sizeof(line_edge_t));
+        if(shape.edges != NULL) {
+            shape.edge_cnt = 0;
+            polyline_build(&shape, pts, pt_cnt, half, round);
+            shape_draw(&shape, &draw_area, mask, style->line.color, opa, aa);
         }
-#endif
     }
 
-#if LV_ANTIALIAS
-    /*Add the last part of anti-aliasing for the perpendicular ending*/
-    if(width != 0 && aa) { /*Due to rounding error with very thin lines it looks ugly*/
-        if(main_line->hor) {
-            lv_coord_t seg_w = pattern[width_safe - 1].y - pattern[aa_last_corner].y;
-            if(main_line->sy < 0) {
-                lv_draw_aa_ver_seg(main_line->p1.x + pattern[aa_last_corner].x - 1,
-                                   main_line->p1.y + pattern[aa_last_corner].y + seg_w, seg_w + main_line->sy, mask,
-                                   style->line.color, opa);
-
-                lv_draw_aa_ver_seg(main_line->p2.x + pattern[aa_last_corner].x + 1,
-                                   main_line->p2.y + pattern[aa_last_corner].y + seg_w, -(seg_w + main_line->sy), mask,
-                                   style->line.color, opa);
+    lv_draw_scratch_release(&mark);
+}
 
-            } else {
-                lv_draw_aa_ver_seg(main_line->p1.x + pattern[aa_last_corner].x - 1,
-                                   main_line->p1.y + pattern[aa_last_corner].y, seg_w + main_line->sy, mask,
-                                   style->line.color, opa);
+static void polyline_build(line_shape_t * shape, const line_subpx_t * pts, uint32_t pt_cnt, int32_t half,
+                           bool round)
+{
+    if(round) {
+        shape_add_circle(shape, &pts[0], half);
+        if(pt_cnt > 1) shape_add_circle(shape, &pts[pt_cnt - 1], half);
+    }
 
-                lv_draw_aa_ver_seg(main_line->p2.x + pattern[aa_last_corner].x + 1,
-                                   main_line->p2.y + pattern[aa_last_corner].y, -(seg_w + main_line->sy), mask,
-                                   style->line.color, opa);
+    line_subpx_t n_prev = {0, 0};
+    uint32_t i;
+    for(i = 0; i + 1 < pt_cnt; i++) {
+        line_subpx_t p = pts[i];
+        line_subpx_t q = pts[i + 1];
+        int32_t dx  = q.x - p.x;
+        int32_t dy  = q.y - p.y;
+        int32_t len = vect_len(dx, dy);
+        if(len == 0) len = 1;
+
+        /*Normal vector with `half` length*/
+        line_subpx_t n;
+        n.x = (int32_t)(-(int64_t)dy * half / len);
+        n.y = (int32_t)((int64_t)dx * half / len);
+
+        /*Flat ends: half pixel longer as the horizontal and vertical lines*/
+        if(round == false) {
+            int32_t ex = (int32_t)((int64_t)dx * (LINE_SUBPX / 2) / len);
+            int32_t ey = (int32_t)((int64_t)dy * (LINE_SUBPX / 2) / len);
+            if(i == 0) {
+                p.x -= ex;
+                p.y -= ey;
             }
-        } else {
-            lv_coord_t seg_w = pattern[width_safe - 1].x - pattern[aa_last_corner].x;
-            if(main_line->sx < 0) {
-                lv_draw_aa_hor_seg(main_line->p1.x + pattern[aa_last_corner].x + seg_w,
-                                   main_line->p1.y + pattern[aa_last_corner].y - 1, seg_w + main_line->sx, mask,
-                                   style->line.color, opa);
-
-                lv_draw_aa_hor_seg(main_line->p2.x + pattern[aa_last_corner].x + seg_w,
-                                   main_line->p2.y + pattern[aa_last_corner].y + 1, -(seg_w + main_line->sx), mask,
-                                   style->line.color, opa);
-
-            } else {
-                lv_draw_aa_hor_seg(main_line->p1.x + pattern[aa_last_corner].x,
-                                   main_line->p1.y + pattern[aa_last_corner].y - 1, seg_w + main_line->sx, mask,
-                                   style->line.color, opa);
-
-                lv_draw_aa_hor_seg(main_line->p2.x + pattern[aa_last_corner].x,
-                                   main_line->p2.y + pattern[aa_last_corner].y + 1, -(seg_w + main_line->sx), mask,
-                                   style->line.color, opa);
+            if(i + 2 == pt_cnt) {
+                q.x += ex;
+                q.y += ey;
             }
         }
-    }
-#endif
 
-#if LV_ANTIALIAS
-
-    /*Shift the anti aliasing on the edges (-1, 1 or 0 (zero only in case width == 0))*/
-    lv_coord_t aa_shift1 = 0;
-    lv_coord_t aa_shift2 = 0;
-    if(aa) {
-        if(main_line->hor == false) {
-            if(main_line->sx < 0) {
-                aa_shift1 = -1;
-                aa_shift2 = width == 0 ? 0 : aa_shift1;
+        line_subpx_t quad[4];
+        quad[0].x = p.x + n.x;
+        quad[0].y = p.y + n.y;
+        quad[1].x = q.x + n.x;
+        quad[1].y = q.y + n.y;
+        quad[2].x = q.x - n.x;
+        quad[2].y = q.y - n.y;
+        quad[3].x = p.x - n.x;
+        quad[3].y = p.y - n.y;
+        shape_add_poly(shape, quad, 4);
+
+        /*Close the gap on the outer side of the joint with the previous line*/
+        if(i != 0) {
+            if(round) {
+                shape_add_circle(shape, &pts[i], half);
             } else {
-                aa_shift2 = 1;
-                aa_shift1 = width == 0 ? 0 : aa_shift2;
-            }
-        } else {
-            if(main_line->sy < 0) {
-                aa_shift1 = -1;
-                aa_shift2 = width == 0 ? 0 : aa_shift1;
-            } else {
-                aa_shift2 = 1;
-                aa_shift1 = width == 0 ? 0 : aa_shift2;
+                /*The outer side is where the line doesn't turn to*/
+                int32_t side = (int64_t)n_prev.x * dx + (int64_t)n_prev.y * dy > 0 ? -1 : 1;
+                line_subpx_t tri[3];
+                tri[0]   = pts[i];
+                tri[1].x = pts[i].x + side * n_prev.x;
+                tri[1].y = pts[i].y + side * n_prev.y;
+                tri[2].x = pts[i].x + side * n.x;
+                tri[2].y = pts[i].y + side * n.y;
+                shape_add_poly(shape, tri, 3);
             }
         }
+
+        n_prev = n;
     }
-#endif
+}
 
-    volatile lv_point_t prev_p;
-    prev_p.x = main_line->p1.x;
-    prev_p.y = main_line->p1.y;
-    lv_area_t draw_area;
-    bool first_run = true;
-
-    if(main_line->hor) {
-        while(line_next_y(main_line)) {
-            for(i = 0; i < width; i++) {
-                draw_area.x1 = prev_p.x + pattern[i].x;
-                draw_area.y1 = prev_p.y + pattern[i].y;
-                draw_area.x2 = draw_area.x1 + main_line->p_act.x - prev_p.x - 1;
-                draw_area.y2 = draw_area.y1;
-                lv_draw_fill(&draw_area, mask, style->line.color, opa);
-
-                /* Fill the gaps
-                 * When stepping in y one pixel remains empty on every corner (don't do this on the
-                 * first segment ) */
-                if(i != 0 && pattern[i].x != pattern[i - 1].x && !first_run) {
-                    lv_draw_px(draw_area.x1, draw_area.y1 - main_line->sy, mask, style->line.color, opa);
-                }
-            }
+/**
+ * Add the edges of a polygon to a shape. All polygons get the same orientation,
+ * so their union is where the sum of the edges' directions is not zero.
+ */
+static void shape_add_poly(line_shape_t * shape, const line_subpx_t * pts, uint16_t pt_cnt)
+{
+    int64_t area = 0;
+    line_subpx_t p_min = pts[0];
+    line_subpx_t p_max = pts[0];
+    uint16_t i;
+    for(i = 0; i < pt_cnt; i++) {
+        const line_subpx_t * a = &pts[i];
+        const line_subpx_t * b = &pts[i + 1 < pt_cnt ? i + 1 : 0];
+        area += (int64_t)a->x * b->y - (int64_t)b->x * a->y;
+        p_min.x = LV_MATH_MIN(p_min.x, a->x);
+        p_min.y = LV_MATH_MIN(p_min.y, a->y);
+        p_max.x = LV_MATH_MAX(p_max.x, a->x);
+        p_max.y = LV_MATH_MAX(p_max.y, a->y);
+    }
 
-#if LV_ANTIALIAS
-            if(aa) {
-                lv_draw_aa_hor_seg(prev_p.x + pattern[0].x, prev_p.y + pattern[0].y - aa_shift1,
-                                   -(main_line->p_act.x - prev_p.x), mask, style->line.color, opa);
-                lv_draw_aa_hor_seg(prev_p.x + pattern[width_safe - 1].x,
-                                   prev_p.y + pattern[width_safe - 1].y + aa_shift2, main_line->p_act.x - prev_p.x,
-                                   mask, style->line.color, opa);
-            }
-#endif
+    if(area == 0) return;
 
-            first_run = false;
+    /*A polygon out of the window changes nothing in it (the left side gets as much cover as it loses)*/
+    if(p_max.x <= shape->win_min.x || p_min.x >= shape->win_max.x) return;
+    if(p_max.y <= shape->win_min.y || p_min.y >= shape->win_max.y) return;
 
-            prev_p.x = main_line->p_act.x;
-            prev_p.y = main_line->p_act.y;
+    for(i = 0; i < pt_cnt; i++) {
+        const line_subpx_t * a = &pts[i];
+        const line_subpx_t * b = &pts[i + 1 < pt_cnt ? i + 1 : 0];
+        if(area < 0) {
+            const line_subpx_t * tmp = a;
+            a = b;
+            b = tmp;
         }
 
-        for(i = 0; i < width; i++) {
-            draw_area.x1 = prev_p.x + pattern[i].x;
-            draw_area.y1 = prev_p.y + pattern[i].y;
-            draw_area.x2 = draw_area.x1 + main_line->p_act.x - prev_p.x;
-            draw_area.y2 = draw_area.y1;
-            lv_draw_fill(&draw_area, mask, style->line.color, opa);
-
-            /* Fill the gaps
-             * When stepping in y one pixel remains empty on every corner */
-            if(i != 0 && pattern[i].x != pattern[i - 1].x && !first_run) {
-                lv_draw_px(draw_area.x1, draw_area.y1 - main_line->sy, mask, style->line.color, opa);
-            }
-        }
+        if(a->y == b->y) continue; /*Horizontal edges don't change the cover*/
 
-#if LV_ANTIALIAS
-        if(aa) {
-            lv_draw_aa_hor_seg(prev_p.x + pattern[0].x, prev_p.y + pattern[0].y - aa_shift1,
-                               -(main_line->p_act.x - prev_p.x + 1), mask, style->line.color, opa);
-            lv_draw_aa_hor_seg(prev_p.x + pattern[width_safe - 1].x, prev_p.y + pattern[width_safe - 1].y + aa_shift2,
-                               main_line->p_act.x - prev_p.x + 1, mask, style->line.color, opa);
+        const line_subpx_t * top = a->y < b->y ? a : b;
+        const line_subpx_t * bottom = a->y < b->y ? b : a;
+        if(bottom->y <= shape->win_min.y || top->y >= shape->win_max.y) continue;
+
+        if(shape->edges != NULL) {
+            line_edge_t * e = &shape->edges[shape->edge_cnt];
+            e->x0  = top->x;
+            e->y0  = top->y;
+            e->x1  = bottom->x;
+            e->y1  = bottom->y;
+            e->dir = a->y < b->y ? 1 : -1;
         }
-#endif
+        shape->edge_cnt++;
     }
-    /*Rather a vertical line*/
-    else {
-
-        while(line_next_x(main_line)) {
-            for(i = 0; i < width; i++) {
-                draw_area.x1 = prev_p.x + pattern[i].x;
-                draw_area.y1 = prev_p.y + pattern[i].y;
-                draw_area.x2 = draw_area.x1;
-                draw_area.y2 = draw_area.y1 + main_line->p_act.y - prev_p.y - 1;
-
-                lv_draw_fill(&draw_area, mask, style->line.color, opa);
-
-                /* Fill the gaps
-                 * When stepping in x one pixel remains empty on every corner (don't do this on the
-                 * first segment ) */
-                if(i != 0 && pattern[i].y != pattern[i - 1].y && !first_run) {
-                    lv_draw_px(draw_area.x1 - main_line->sx, draw_area.y1, mask, style->line.color, opa);
-                }
-            }
+}
 
-#if LV_ANTIALIAS
-            if(aa) {
-                lv_draw_aa_ver_seg(prev_p.x + pattern[0].x - aa_shift1, prev_p.y + pattern[0].y,
-                                   -(main_line->p_act.y - prev_p.y), mask, style->line.color, opa);
-                lv_draw_aa_ver_seg(prev_p.x + pattern[width_safe - 1].x + aa_shift2,
-                                   prev_p.y + pattern[width_safe - 1].y, main_line->p_act.y - prev_p.y, mask,
-                                   style->line.color, opa);
-            }
-#endif
+static void shape_add_circle(line_shape_t * shape, const line_subpx_t * c, int32_t r)
+{
+    line_subpx_t pts[LINE_CIRCLE_PT_MAX];
+    uint16_t pt_cnt = circle_pt_cnt(r);
+    uint16_t i;
+    for(i = 0; i < pt_cnt; i++) {
+        int16_t angle = (int16_t)((360 * i) / pt_cnt);
+        pts[i].x = c->x + (int32_t)(((int64_t)r * lv_trigo_sin(angle + 90)) >> LV_TRIGO_SHIFT);
+        pts[i].y = c->y + (int32_t)(((int64_t)r * lv_trigo_sin(angle)) >> LV_TRIGO_SHIFT);
+    }
 
-            first_run = false;
+    shape_add_poly(shape, pts, pt_cnt);
+}
 
-            prev_p.x = main_line->p_act.x;
-            prev_p.y = main_line->p_act.y;
+/**
+ * Rasterize a shape on `draw_area`. The edges are clipped to the rows and split on the pixel borders,
+ * every pixel gets the covered area (see FreeType's "gray" rasterizer) and the runs of pixels with equal
+ * coverage are filled at once.
+ */
+static void shape_draw(line_shape_t * shape, const lv_area_t * draw_area, const lv_area_t * mask, lv_color_t color,
+                       lv_opa_t opa, bool aa)
+{
+    line_cells_t cells;
+    cells.w     = lv_area_get_width(draw_area);
+    cells.cover = lv_draw_scratch_alloc(cells.w * sizeof(int32_t));
+    cells.area  = lv_draw_scratch_alloc(cells.w * sizeof(int32_t));
+    uint32_t * act = lv_draw_scratch_alloc(shape->edge_cnt * sizeof(uint32_t));
+    if(cells.cover == NULL || cells.area == NULL || act == NULL) return;
+
+    memset(cells.cover, 0, cells.w * sizeof(int32_t));
+    memset(cells.area, 0, cells.w * sizeof(int32_t));
+
+    /*Sort the edges by their top to keep the list of the edges in the actual row short*/
+    qsort(shape->edges, shape->edge_cnt, sizeof(line_edge_t), edge_cmp);
+
+    uint32_t next_edge = 0;
+    uint32_t act_cnt   = 0;
+    lv_coord_t y;
+    for(y = draw_area->y1; y <= draw_area->y2; y++) {
+        int32_t row_y0 = (int32_t)y << LINE_SUBPX_SHIFT;
+        int32_t row_y1 = row_y0 + LINE_SUBPX;
+
+        while(next_edge < shape->edge_cnt && shape->edges[next_edge].y0 < row_y1) {
+            act[act_cnt] = next_edge;
+            act_cnt++;
+            next_edge++;
         }
 
-        /*Draw the last part*/
-        for(i = 0; i < width; i++) {
-            draw_area.x1 = prev_p.x + pattern[i].x;
-            draw_area.y1 = prev_p.y + pattern[i].y;
-            draw_area.x2 = draw_area.x1;
-            draw_area.y2 = draw_area.y1 + main_line->p_act.y - prev_p.y;
-
-            lv_draw_fill(&draw_area, mask, style->line.color, opa);
-
-            /* Fill the gaps
-             * When stepping in x one pixel remains empty on every corner */
-            if(i != 0 && pattern[i].y != pattern[i - 1].y && !first_run) {
-                lv_draw_px(draw_area.x1 - main_line->sx, draw_area.y1, mask, style->line.color, opa);
+        cells.min = cells.w;
+        cells.max = -1;
+
+        uint32_t i;
+        uint32_t act_kept = 0;
+        for(i = 0; i < act_cnt; i++) {
+            const line_edge_t * e = &shape->edges[act[i]];
+            if(e->y1 <= row_y0) continue; /*Above this row, it's done*/
+            act[act_kept] = act[i];
+            act_kept++;
+
+            int32_t ya = LV_MATH_MAX(e->y0, row_y0);
+            int32_t yb = LV_MATH_MIN(e->y1, row_y1);
+            int32_t dy = e->y1 - e->y0;
+            int32_t xa = e->x0 + (int32_t)((int64_t)(ya - e->y0) * (e->x1 - e->x0) / dy);
+            int32_t xb = e->x0 + (int32_t)((int64_t)(yb - e->y0) * (e->x1 - e->x0) / dy);
+            cells_add(&cells, xa - shape->win_min.x, ya - row_y0, xb - shape->win_min.x, yb - row_y0, e->dir);
+        }
+        act_cnt = act_kept;
+
+        if(cells.max < 0) continue;
+
+        /*Go through the pixels and draw the runs of equal coverage*/
+        int32_t acc     = 0;
+        int32_t run_x   = cells.min;
+        lv_opa_t run_c  = LV_OPA_TRANSP;
+        int32_t x;
+        for(x = cells.min; x <= cells.max; x++) {
+            acc += cells.cover[x];
+            lv_opa_t c = cover_to_opa(acc * 2 * LINE_SUBPX - cells.area[x], aa);
+            cells.cover[x] = 0;
+            cells.area[x]  = 0;
+            if(c != run_c) {
+                span_draw(draw_area->x1 + run_x, draw_area->x1 + x - 1, y, mask, color, opa, run_c);
+                run_x = x;
+                run_c = c;
             }
         }
 
-#if LV_ANTIALIAS
-        if(aa) {
-            lv_draw_aa_ver_seg(prev_p.x + pattern[0].x - aa_shift1, prev_p.y + pattern[0].y,
-                               -(main_line->p_act.y - prev_p.y + 1), mask, style->line.color, opa);
-            lv_draw_aa_ver_seg(prev_p.x + pattern[width_safe - 1].x + aa_shift2, prev_p.y + pattern[width_safe - 1].y,
-                               main_line->p_act.y - prev_p.y + 1, mask, style->line.color, opa);
+        /*After the last edge the coverage is the same until the end of the row*/
+        lv_opa_t c = cover_to_opa(acc * 2 * LINE_SUBPX, aa);
+        if(c != run_c) {
+            span_draw(draw_area->x1 + run_x, draw_area->x1 + cells.max, y, mask, color, opa, run_c);
+            run_x = cells.max + 1;
+            run_c = c;
         }
-#endif
+        span_draw(draw_area->x1 + run_x, draw_area->x1 + cells.w - 1, y, mask, color, opa, run_c);
     }
 }
 
-static void line_init(line_draw_t * line, const lv_point_t * p1, const lv_point_t * p2)
-{
-    line->p1.x = p1->x;
-    line->p1.y = p1->y;
-    line->p2.x = p2->x;
-    line->p2.y = p2->y;
-
-    line->dx  = LV_MATH_ABS(line->p2.x - line->p1.x);
-    line->sx  = line->p1.x < line->p2.x ? 1 : -1;
-    line->dy  = LV_MATH_ABS(line->p2.y - line->p1.y);
-    line->sy  = line->p1.y < line->p2.y ? 1 : -1;
-    line->err = (line->dx > line->dy ? line->dx : -line->dy) / 2;
-    line->e2  = 0;
-    line->hor = line->dx > line->dy ? true : false; /*Rather horizontal or vertical*/
-
-    line->p_act.x = line->p1.x;
-    line->p_act.y = line->p1.y;
-}
-
-static bool line_next(line_draw_t * line)
+/**
+ * Add the part of an edge in a row to the cells
+ * @param xa, ya the top of the part, relative to the row's top left corner
+ * @param xb, yb the bottom of the part (`yb > ya`)
+ * @param dir direction of the edge (1 or -1)
+ */
+static void cells_add(line_cells_t * cells, int32_t xa, int32_t ya, int32_t xb, int32_t yb, int32_t dir)
 {
-    if(line->p_act.x == line->p2.x && line->p_act.y == line->p2.y) return false;
-    line->e2 = line->err;
-    if(line->e2 > -line->dx) {
-        line->err -= line->dy;
-        line->p_act.x += line->sx;
+    if(xa == xb) {
+        cell_add(cells, xa, xa, (yb - ya) * dir);
+        return;
     }
-    if(line->e2 < line->dy) {
-        line->err += line->dx;
-        line->p_act.y += line->sy;
+
+    /*Go from left to right and split the part on the pixel borders*/
+    int32_t x_left  = LV_MATH_MIN(xa, xb);
+    int32_t x_right = LV_MATH_MAX(xa, xb);
+    int32_t x_end   = cells->w << LINE_SUBPX_SHIFT;
+    int32_t x       = x_left;
+    int32_t y       = x_left == xa ? ya : yb;
+    while(x < x_right && x < x_end) {
+        int32_t x_next;
+        if(x < 0) x_next = LV_MATH_MIN(x_right, 0);
+        else x_next = LV_MATH_MIN(x_right, ((x >> LINE_SUBPX_SHIFT) + 1) << LINE_SUBPX_SHIFT);
+
+        int32_t y_next;
+        if(x_next == x_right) y_next = x_right == xa ? ya : yb;
+        else y_next = ya + (int32_t)((int64_t)(x_next - xa) * (yb - ya) / (xb - xa));
+
+        cell_add(cells, x, x_next, LV_MATH_ABS(y_next - y) * dir);
+        x = x_next;
+        y = y_next;
     }
-    return true;
 }
 
 /**
- * Iterate until step one in y direction.
- * @param line
- * @return
+ * Add a part of an edge in one pixel (or left to the row, it covers the first pixel then)
+ * @param x0, x1 the left and right end of the part (`x0 <= x1`)
+ * @param dy height of the part with the direction as sign
  */
-static bool line_next_y(line_draw_t * line)
+static void cell_add(line_cells_t * cells, int32_t x0, int32_t x1, int32_t dy)
 {
-    lv_coord_t last_y = line->p_act.y;
+    int32_t i;
+    int32_t area;
+    if(x1 <= 0) {
+        i    = 0;
+        area = 0;
+    } else {
+        if(x0 >= (cells->w << LINE_SUBPX_SHIFT)) return; /*Right to the row, changes nothing*/
+        i = x0 >> LINE_SUBPX_SHIFT;
+        int32_t left = i << LINE_SUBPX_SHIFT;
+        area = (x0 - left + x1 - left) * dy;
+    }
 
-    do {
-        if(!line_next(line)) return false;
-    } while(last_y == line->p_act.y);
+    cells->cover[i] += dy;
+    cells->area[i] += area;
+    if(i < cells->min) cells->min = i;
+    if(i > cells->max) cells->max = i;
+}
 
-    return true;
+/*Opacity of a pixel from its doubled covered area*/
+static lv_opa_t cover_to_opa(int32_t v, bool aa)
+{
+    v = LV_MATH_ABS(v);
+    if(v >= LINE_COVER_FULL) return LV_OPA_COVER;
+
+    lv_opa_t c = (v * LV_OPA_COVER) / LINE_COVER_FULL;
+    if(aa == false) c = c >= LV_OPA_50 ? LV_OPA_COVER : LV_OPA_TRANSP;
+    return c;
 }
 
-/**
- * Iterate until step one in x direction.
- * @param line
- * @return
- */
-static bool line_next_x(line_draw_t * line)
+/*Draw a run of pixels with the opacity scaled by their coverage*/
+static void span_draw(lv_coord_t x1, lv_coord_t x2, lv_coord_t y, const lv_area_t * mask, lv_color_t color,
+                      lv_opa_t opa, lv_opa_t cover)
+{
+    if(x2 < x1 || cover == LV_OPA_TRANSP) return;
+
+    lv_opa_t px_opa = cover == LV_OPA_COVER ? opa : (uint16_t)((uint16_t)opa * cover) >> 8;
+    if(x1 == x2) {
+        lv_draw_px(x1, y, mask, color, px_opa);
+    } else {
+        lv_area_t area;
+        area.x1 = x1;
+        area.x2 = x2;
+        area.y1 = y;
+        area.y2 = y;
+        lv_draw_fill(&area, mask, color, px_opa);
+    }
+}
+
+/*Length of a vector, precise to 15 bits*/
+static int32_t vect_len(int32_t x, int32_t y)
 {
-    lv_coord_t last_x = line->p_act.x;
+    uint32_t ax    = LV_MATH_ABS(x);
+    uint32_t ay    = LV_MATH_ABS(y);
+    uint8_t shift = 0;
+    while((ax >> shift) > 0x7FFF || (ay >> shift) > 0x7FFF) shift++;
+
+    ax >>= shift;
+    ay >>= shift;
+    return (int32_t)(lv_sqrt(ax * ax + ay * ay) << shift);
+}
 
-    do {
-        if(!line_next(line)) return false;
-    } while(last_x == line->p_act.x);
+/*Points of the polygon of a circle: enough to look round but not more*/
+static uint16_t circle_pt_cnt(int32_t r)
+{
+    if(r <= LINE_SUBPX) return 8;
+    else if(r <= 4 * LINE_SUBPX) return 16;
+    else return LINE_CIRCLE_PT_MAX;
+}
 
-    return true;
+static int edge_cmp(const void * a, const void * b)
+{
+    const line_edge_t * ea = a;
+    const line_edge_t * eb = b;
+    if(ea->y0 < eb->y0) return -1;
+    if(ea->y0 > eb->y0) return 1;
+    return 0;
 }
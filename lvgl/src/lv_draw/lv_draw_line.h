@@ -37,6 +37,19 @@ extern "C" {
 void lv_draw_line(const lv_point_t * point1, const lv_point_t * point2, const lv_area_t * mask,
                   const lv_style_t * style, lv_opa_t opa_scale);
 
+/**
+ * Draw connected lines at once. Unlike drawing the lines one by one the joints are drawn only once
+ * (a semi transparent polyline has no darker spots) and they have no gaps: they are beveled
+ * or, with `style->line.rounded`, round like the ends of the polyline.
+ * @param points the points of the polyline
+ * @param point_cnt number of points in `points`
+ * @param mask the polyline will be drawn only on this area
+ * @param style pointer to a line's style
+ * @param opa_scale scale down all opacities by the factor
+ */
+void lv_draw_polyline(const lv_point_t * points, uint16_t point_cnt, const lv_area_t * mask,
+                      const lv_style_t * style, lv_opa_t opa_scale);
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,319 @@
+/**
+ * @file lv_draw_packed.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_packed.h"
+#if LV_USE_DRAW_PACKED
+
+#include <stdbool.h>
+#include "../lv_misc/lv_math.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void set_px_1bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa);
+static void set_px_1bpp_ver(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa);
+static void set_px_2bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa);
+static void set_span_1bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa);
+static void set_span_1bpp_ver(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa);
+static void set_span_2bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa);
+static void rounder_1bpp_hor(lv_disp_drv_t * drv, lv_area_t * area);
+static void rounder_1bpp_ver(lv_disp_drv_t * drv, lv_area_t * area);
+static void rounder_2bpp_hor(lv_disp_drv_t * drv, lv_area_t * area);
+static bool span_is_one_color(const lv_color_t * colors, lv_coord_t len);
+static inline uint8_t color_to2(lv_color_t color);
+static inline uint8_t mix_2bpp(lv_color_t color, uint8_t bg, lv_opa_t opa);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Let a display driver draw into a packed buffer. Sets `set_px_cb`, `set_px_span_cb` and `rounder_cb`
+ * (the areas are rounded to whole bytes). Initialize the display buffer with the number of pixels
+ * and `lv_draw_packed_get_buf_size` bytes. True double buffering (two screen sized buffers) can't be used.
+ * @param drv pointer to a display driver initialized with `lv_disp_drv_init`
+ * @param fmt layout of the draw buffer
+ */
+void lv_draw_packed_init_drv(lv_disp_drv_t * drv, lv_draw_packed_fmt_t fmt)
+{
+    switch(fmt) {
+        case LV_DRAW_PACKED_1BPP_HOR:
+            drv->set_px_cb      = set_px_1bpp_hor;
+            drv->set_px_span_cb = set_span_1bpp_hor;
+            drv->rounder_cb     = rounder_1bpp_hor;
+            break;
+        case LV_DRAW_PACKED_1BPP_VER:
+            drv->set_px_cb      = set_px_1bpp_ver;
+            drv->set_px_span_cb = set_span_1bpp_ver;
+            drv->rounder_cb     = rounder_1bpp_ver;
+            break;
+        case LV_DRAW_PACKED_2BPP_HOR:
+            drv->set_px_cb      = set_px_2bpp_hor;
+            drv->set_px_span_cb = set_span_2bpp_hor;
+            drv->rounder_cb     = rounder_2bpp_hor;
+            break;
+    }
+}
+
+/**
+ * Get the size of a packed draw buffer
+ * @param fmt layout of the draw buffer
+ * @param px_cnt the size of the buffer in pixels as given to `lv_disp_buf_init`.
+ *               With `LV_DRAW_PACKED_1BPP_VER` at least 8 rows of the display.
+ * @return size of the buffer in bytes
+ */
+uint32_t lv_draw_packed_get_buf_size(lv_draw_packed_fmt_t fmt, uint32_t px_cnt)
+{
+    /*The rounded areas are whole bytes wide (or high) so there is no padding*/
+    if(fmt == LV_DRAW_PACKED_2BPP_HOR) return (px_cnt + 3) >> 2;
+    else return (px_cnt + 7) >> 3;
+}
+
+/**
+ * Get a pixel of a packed buffer, e.g. in `flush_cb` to show it on an other display
+ * @param fmt layout of the draw buffer
+ * @param buf pointer to the buffer
+ * @param buf_w width of the buffer (the width of the flushed area)
+ * @param x column in the buffer
+ * @param y row in the buffer
+ * @return the value of the pixel: 0..1 or 0..3
+ */
+uint8_t lv_draw_packed_get_px(lv_draw_packed_fmt_t fmt, const uint8_t * buf, lv_coord_t buf_w, lv_coord_t x,
+                              lv_coord_t y)
+{
+    switch(fmt) {
+        case LV_DRAW_PACKED_1BPP_HOR:
+            return (buf[(uint32_t)y * ((buf_w + 7) >> 3) + (x >> 3)] >> (7 - (x & 0x7))) & 0x1;
+        case LV_DRAW_PACKED_1BPP_VER:
+            return (buf[(uint32_t)(y >> 3) * buf_w + x] >> (7 - (y & 0x7))) & 0x1;
+        case LV_DRAW_PACKED_2BPP_HOR:
+            return (buf[(uint32_t)y * ((buf_w + 3) >> 2) + (x >> 2)] >> (6 - 2 * (x & 0x3))) & 0x3;
+    }
+
+    return 0;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/*With 1 bit-per-pixel the colors can't be mixed: the more opaque one is kept like by `lv_color_mix`*/
+
+static void set_px_1bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa)
+{
+    (void)drv;
+    if(opa <= LV_OPA_50) return;
+
+    uint8_t * p = &buf[(uint32_t)y * ((buf_w + 7) >> 3) + (x >> 3)];
+    uint8_t bit = 0x80 >> (x & 0x7);
+    if(lv_color_to1(color)) *p |= bit;
+    else *p &= ~bit;
+}
+
+static void set_px_1bpp_ver(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa)
+{
+    (void)drv;
+    if(opa <= LV_OPA_50) return;
+
+    uint8_t * p = &buf[(uint32_t)(y >> 3) * buf_w + x];
+    uint8_t bit = 0x80 >> (y & 0x7);
+    if(lv_color_to1(color)) *p |= bit;
+    else *p &= ~bit;
+}
+
+static void set_px_2bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                            lv_color_t color, lv_opa_t opa)
+{
+    (void)drv;
+    if(opa < LV_OPA_MIN) return;
+
+    uint8_t * p   = &buf[(uint32_t)y * ((buf_w + 3) >> 2) + (x >> 2)];
+    uint8_t shift = 6 - 2 * (x & 0x3);
+    uint8_t v     = mix_2bpp(color, (*p >> shift) & 0x3, opa);
+    *p            = (*p & ~(0x3 << shift)) | (v << shift);
+}
+
+/*The spans set the pixels of a byte at once, and a whole byte if they have the same color (e.g. fills)*/
+
+static void set_span_1bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa)
+{
+    (void)drv;
+    if(opa <= LV_OPA_50) return;
+
+    uint8_t * p     = &buf[(uint32_t)y * ((buf_w + 7) >> 3) + (x >> 3)];
+    bool one_color  = span_is_one_color(colors, len);
+    uint8_t one_bits = lv_color_to1(colors[0]) ? 0xFF : 0x00;
+
+    lv_coord_t i = 0;
+    while(i < len) {
+        uint8_t first = (x + i) & 0x7; /*The first bit to set in this byte*/
+        lv_coord_t n  = LV_MATH_MIN(8 - first, len - i);
+        uint8_t mask  = (uint8_t)(0xFF >> first) & (uint8_t)(0xFF << (8 - first - n));
+
+        uint8_t bits = one_bits;
+        if(one_color == false) {
+            lv_coord_t k;
+            bits = 0;
+            for(k = 0; k < n; k++) {
+                if(lv_color_to1(colors[i + k])) bits |= 0x80 >> (first + k);
+            }
+        }
+
+        *p = (*p & ~mask) | (bits & mask);
+        p++;
+        i += n;
+    }
+}
+
+static void set_span_1bpp_ver(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa)
+{
+    (void)drv;
+    if(opa <= LV_OPA_50) return;
+
+    /*The pixels of a row are in the same bit of consecutive bytes*/
+    uint8_t * p = &buf[(uint32_t)(y >> 3) * buf_w + x];
+    uint8_t bit = 0x80 >> (y & 0x7);
+    lv_coord_t i;
+    if(span_is_one_color(colors, len)) {
+        if(lv_color_to1(colors[0])) {
+            for(i = 0; i < len; i++) p[i] |= bit;
+        } else {
+            for(i = 0; i < len; i++) p[i] &= ~bit;
+        }
+    } else {
+        for(i = 0; i < len; i++) {
+            if(lv_color_to1(colors[i])) p[i] |= bit;
+            else p[i] &= ~bit;
+        }
+    }
+}
+
+static void set_span_2bpp_hor(lv_disp_drv_t * drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                              const lv_color_t * colors, lv_coord_t len, lv_opa_t opa)
+{
+    if(opa < LV_OPA_MIN) return;
+
+    lv_coord_t i;
+    if(opa < LV_OPA_MAX) {
+        /*Every pixel is mixed with its background*/
+        for(i = 0; i < len; i++) set_px_2bpp_hor(drv, buf, buf_w, x + i, y, colors[i], opa);
+        return;
+    }
+
+    uint8_t * p      = &buf[(uint32_t)y * ((buf_w + 3) >> 2) + (x >> 2)];
+    bool one_color   = span_is_one_color(colors, len);
+    uint8_t one_bits = color_to2(colors[0]) * 0x55;
+
+    i = 0;
+    while(i < len) {
+        uint8_t first = (x + i) & 0x3; /*The first pixel to set in this byte*/
+        lv_coord_t n  = LV_MATH_MIN(4 - first, len - i);
+        uint8_t mask  = (uint8_t)(0xFF >> (2 * first)) & (uint8_t)(0xFF << (8 - 2 * (first + n)));
+
+        uint8_t bits = one_bits;
+        if(one_color == false) {
+            lv_coord_t k;
+            bits = 0;
+            for(k = 0; k < n; k++) bits |= color_to2(colors[i + k]) << (6 - 2 * (first + k));
+        }
+
+        *p = (*p & ~mask) | (bits & mask);
+        p++;
+        i += n;
+    }
+}
+
+static void rounder_1bpp_hor(lv_disp_drv_t * drv, lv_area_t * area)
+{
+    (void)drv;
+    area->x1 &= ~0x7;
+    area->x2 |= 0x7;
+}
+
+static void rounder_1bpp_ver(lv_disp_drv_t * drv, lv_area_t * area)
+{
+    (void)drv;
+    area->y1 &= ~0x7;
+    area->y2 |= 0x7;
+}
+
+static void rounder_2bpp_hor(lv_disp_drv_t * drv, lv_area_t * area)
+{
+    (void)drv;
+    area->x1 &= ~0x3;
+    area->x2 |= 0x3;
+}
+
+/**
+ * Tell whether all the colors of a span are the same
+ * @param colors pointer to the colors
+ * @param len number of colors
+ * @return true: one color
+ */
+static bool span_is_one_color(const lv_color_t * colors, lv_coord_t len)
+{
+    lv_coord_t i;
+    for(i = 1; i < len; i++) {
+        if(colors[i].full != colors[0].full) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Convert a color to one of the 4 gray levels
+ * @param color a color
+ * @return 0: black ... 3: white
+ */
+static inline uint8_t color_to2(lv_color_t color)
+{
+    return lv_color_brightness(color) >> 6;
+}
+
+/**
+ * Mix a color to a pixel of 4 gray levels
+ * @param color the color to mix
+ * @param bg the gray level of the pixel
+ * @param opa opacity of `color`
+ * @return the new gray level
+ */
+static inline uint8_t mix_2bpp(lv_color_t color, uint8_t bg, lv_opa_t opa)
+{
+    if(opa >= LV_OPA_MAX) return color_to2(color);
+
+    uint32_t bright = ((uint32_t)lv_color_brightness(color) * opa + (uint32_t)bg * 85 * (255 - opa)) / 255;
+    return bright >> 6;
+}
+
+#endif /*LV_USE_DRAW_PACKED*/
@@ -0,0 +1,88 @@
+/**
+ * @file lv_draw_packed.h
+ * Draw buffers with 1 or 2 bit-per-pixel for monochrome and gray scale panels.
+ * The display driver's `set_px_cb`, `set_px_span_cb` and `rounder_cb` write the pixels straight into
+ * the packed buffer so `flush_cb` gets the panel's own format instead of `lv_color_t`s.
+ */
+
+#ifndef LV_DRAW_PACKED_H
+#define LV_DRAW_PACKED_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "../lv_hal/lv_hal_disp.h"
+
+#if LV_USE_DRAW_PACKED
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/** Layouts of the packed draw buffers. A row of the buffer is as wide as the area given to `flush_cb`.*/
+enum {
+    LV_DRAW_PACKED_1BPP_HOR, /**< 8 pixels of a row in a byte, the left one is the MSB. 1: light (e.g. memory LCDs)*/
+    LV_DRAW_PACKED_1BPP_VER, /**< 8 rows of a column in a byte (a page), the top one is the MSB. 1: light (e.g. ST7565)*/
+    LV_DRAW_PACKED_2BPP_HOR, /**< 4 pixels of a row in a byte, the left one in the upper bits. 0: black ... 3: white*/
+};
+typedef uint8_t lv_draw_packed_fmt_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Let a display driver draw into a packed buffer. Sets `set_px_cb`, `set_px_span_cb` and `rounder_cb`
+ * (the areas are rounded to whole bytes). Initialize the display buffer with the number of pixels
+ * and `lv_draw_packed_get_buf_size` bytes. True double buffering (two screen sized buffers) can't be used.
+ * @param drv pointer to a display driver initialized with `lv_disp_drv_init`
+ * @param fmt layout of the draw buffer
+ */
+void lv_draw_packed_init_drv(lv_disp_drv_t * drv, lv_draw_packed_fmt_t fmt);
+
+/**
+ * Get the size of a packed draw buffer
+ * @param fmt layout of the draw buffer
+ * @param px_cnt the size of the buffer in pixels as given to `lv_disp_buf_init`.
+ *               With `LV_DRAW_PACKED_1BPP_VER` at least 8 rows of the display.
+ * @return size of the buffer in bytes
+ */
+uint32_t lv_draw_packed_get_buf_size(lv_draw_packed_fmt_t fmt, uint32_t px_cnt);
+
+/**
+ * Get a pixel of a packed buffer, e.g. in `flush_cb` to show it on an other display
+ * @param fmt layout of the draw buffer
+ * @param buf pointer to the buffer
+ * @param buf_w width of the buffer (the width of the flushed area)
+ * @param x column in the buffer
+ * @param y row in the buffer
+ * @return the value of the pixel: 0..1 or 0..3
+ */
+uint8_t lv_draw_packed_get_px(lv_draw_packed_fmt_t fmt, const uint8_t * buf, lv_coord_t buf_w, lv_coord_t x,
+                              lv_coord_t y);
+
+#endif /*LV_USE_DRAW_PACKED*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_DRAW_PACKED_H*/
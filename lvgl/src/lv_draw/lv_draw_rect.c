@@ -10,6 +10,9 @@
 #include "../lv_misc/lv_circ.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_core/lv_refr.h"
+#include "../lv_core/lv_prof.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -24,9 +27,23 @@
 /*Add extra radius with LV_SHADOW_BOTTOM to cover anti-aliased corners*/
 #define SHADOW_BOTTOM_AA_EXTRA_RADIUS 3
 
+/*Don't cache the shadows of huge radius to keep the memory usage low [bytes]*/
+#define SHADOW_CACHE_ENTRY_MAX (8U * 1024U)
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+typedef struct
+{
+    uint8_t * table; /*Created by `lv_draw_shadow_full_calc`. NULL: unused entry*/
+    uint32_t size;
+    uint32_t life;   /*`shadow_cache_life` when the entry was used last time*/
+    lv_coord_t radius;
+    lv_coord_t swidth;
+    lv_opa_t opa;
+} lv_shadow_cache_entry_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
@@ -49,10 +66,94 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
                                   lv_opa_t opa_scale);
 static void lv_draw_shadow_full_straight(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                          const lv_opa_t * map);
+static uint8_t * lv_draw_shadow_full_calc(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, uint32_t * size);
+#if LV_SHADOW_CACHE_SIZE
+static uint8_t * shadow_cache_get(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa);
+static uint8_t * shadow_cache_add(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, uint8_t * table, uint32_t size);
+static uint32_t shadow_cache_size_cb(void);
+static uint32_t shadow_cache_shrink_cb(uint32_t size);
+#endif
 #endif
 
 static uint16_t lv_draw_cont_radius_corr(uint16_t r, lv_coord_t w, lv_coord_t h);
 
+#if LV_GRAD_DITHER && LV_COLOR_DEPTH == 16
+static bool grad_dither_rows(const lv_area_t * coords, const lv_area_t * mask, lv_color_t mcolor, lv_color_t gcolor,
+                             lv_coord_t row_start, lv_coord_t row_end, lv_opa_t opa);
+#endif
+
+#if LV_GRAD_DITHER && LV_COLOR_DEPTH == 16
+/**
+ * Draw the middle rows of a vertical gradient with a 4x4 ordered dither: every pixel rounds the exact mix
+ * of the colors up or down by a threshold of its position, so the 16 bit steps don't show up as bands.
+ * @param coords the coordinates of the rectangle
+ * @param mask draw only on this area
+ * @param mcolor color of the top
+ * @param gcolor color of the bottom
+ * @param row_start first row to draw (in the mask)
+ * @param row_end last row to draw (in the mask)
+ * @param opa opacity of the rows
+ * @return false: out of memory, nothing is drawn
+ */
+static bool grad_dither_rows(const lv_area_t * coords, const lv_area_t * mask, lv_color_t mcolor, lv_color_t gcolor,
+                             lv_coord_t row_start, lv_coord_t row_end, lv_opa_t opa)
+{
+    static const uint8_t bayer[4][4] = {{0, 8, 2, 10}, {12, 4, 14, 6}, {3, 11, 1, 9}, {15, 7, 13, 5}};
+
+    lv_area_t row_area;
+    row_area.x1 = LV_MATH_MAX(coords->x1, mask->x1);
+    row_area.x2 = LV_MATH_MIN(coords->x2, mask->x2);
+    if(row_area.x1 > row_area.x2) return true;
+
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    lv_color_t * buf = lv_draw_scratch_alloc(lv_area_get_width(&row_area) * sizeof(lv_color_t));
+    if(buf == NULL) return false;
+
+#if LV_COLOR_16_SWAP
+    uint16_t mgreen = (mcolor.ch.green_h << 3) + mcolor.ch.green_l;
+    uint16_t ggreen = (gcolor.ch.green_h << 3) + gcolor.ch.green_l;
+#else
+    uint16_t mgreen = mcolor.ch.green;
+    uint16_t ggreen = gcolor.ch.green;
+#endif
+
+    lv_coord_t height = lv_area_get_height(coords);
+    lv_coord_t row;
+    lv_coord_t x;
+    for(row = row_start; row <= row_end; row++) {
+        /*The exact mix in 1/256 steps of the channels. Adding at most 255 can't overflow the channels*/
+        uint8_t mix     = (uint32_t)((uint32_t)(coords->y2 - row) * 255) / height;
+        uint16_t red    = mcolor.ch.red * mix + gcolor.ch.red * (255 - mix);
+        uint16_t green  = mgreen * mix + ggreen * (255 - mix);
+        uint16_t blue   = mcolor.ch.blue * mix + gcolor.ch.blue * (255 - mix);
+        const uint8_t * th_row = bayer[row & 0x3];
+
+        lv_color_t * px = buf;
+        for(x = row_area.x1; x <= row_area.x2; x++) {
+            uint8_t th  = (th_row[x & 0x3] << 4) + 8;
+            px->ch.red  = (red + th) >> 8;
+#if LV_COLOR_16_SWAP
+            uint16_t g  = (green + th) >> 8;
+            px->ch.green_h = g >> 3;
+            px->ch.green_l = g & 0x7;
+#else
+            px->ch.green = (green + th) >> 8;
+#endif
+            px->ch.blue = (blue + th) >> 8;
+            px++;
+        }
+
+        row_area.y1 = row;
+        row_area.y2 = row;
+        lv_draw_map(&row_area, mask, (const uint8_t *)buf, opa, false, false, LV_COLOR_BLACK, LV_OPA_TRANSP);
+    }
+
+    lv_draw_scratch_release(&mark);
+    return true;
+}
+#endif
+
 #if LV_ANTIALIAS
 static lv_opa_t antialias_get_opa_circ(lv_coord_t seg, lv_coord_t px_id, lv_opa_t opa);
 #endif
@@ -60,11 +161,25 @@ static lv_opa_t antialias_get_opa_circ(lv_coord_t seg, lv_coord_t px_id, lv_opa_
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+static lv_shadow_cache_entry_t shadow_cache[LV_SHADOW_CACHE_SIZE];
+static uint32_t shadow_cache_life;
+static uint32_t shadow_cache_hit;
+static uint32_t shadow_cache_miss;
+#endif
 
 /**********************
  *      MACROS
  **********************/
 
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+const lv_mem_shrinker_t lv_draw_shadow_cache_shrinker = {"shadow_cache", shadow_cache_size_cb,
+                                                         shadow_cache_shrink_cb};
+#endif
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -108,6 +223,21 @@ void lv_draw_rect(const lv_area_t * coords, const lv_area_t * mask, const lv_sty
     }
 }
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/**
+ * Get the statistics of the shadow cache. E.g. to print them in the display driver's `monitor_cb`
+ * @param hit store the number of shadows drawn from the cache here (can be NULL)
+ * @param miss store the number of shadows which had to be calculated here (can be NULL)
+ */
+void lv_draw_rect_get_cache_stat(uint32_t * hit, uint32_t * miss)
+{
+    lv_thread_lock();
+    if(hit) *hit = shadow_cache_hit;
+    if(miss) *miss = shadow_cache_miss;
+    lv_thread_unlock();
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -173,15 +303,30 @@ static void lv_draw_rect_main_mid(const lv_area_t * coords, const lv_area_t * ma
             }
         }
         if(row_start < 0) row_start = 0;
+        /*The rows out of the mask wouldn't be drawn anyway*/
+        if(row_start < mask->y1) row_start = mask->y1;
+        if(row_end > mask->y2) row_end = mask->y2;
+        if(row_start > row_end) return;
 
-        for(row = row_start; row <= row_end; row++) {
-            work_area.y1 = row;
-            work_area.y2 = row;
-            mix          = (uint32_t)((uint32_t)(coords->y2 - work_area.y1) * 255) / height;
-            act_color    = lv_color_mix(mcolor, gcolor, mix);
+#if LV_GRAD_DITHER && LV_COLOR_DEPTH == 16
+        if(grad_dither_rows(coords, mask, mcolor, gcolor, row_start, row_end, opa)) return;
+#endif
 
-            lv_draw_fill(&work_area, mask, act_color, opa);
+        /*Neighbouring rows often get the same color (e.g. a tall rectangle or close colors), fill them at once*/
+        work_area.y1 = row_start;
+        act_color    = mcolor;
+        for(row = row_start; row <= row_end; row++) {
+            mix                  = (uint32_t)((uint32_t)(coords->y2 - row) * 255) / height;
+            lv_color_t row_color = lv_color_mix(mcolor, gcolor, mix);
+            if(row != row_start && row_color.full != act_color.full) {
+                work_area.y2 = row - 1;
+                lv_draw_fill(&work_area, mask, act_color, opa);
+                work_area.y1 = row;
+            }
+            act_color = row_color;
         }
+        work_area.y2 = row_end;
+        lv_draw_fill(&work_area, mask, act_color, opa);
     }
 }
 /**
@@ -1134,6 +1279,13 @@ static void lv_draw_shadow(const lv_area_t * coords, const lv_area_t * mask, con
     area_tmp.y2 -= radius;
     if(lv_area_is_in(mask, &area_tmp) != false) return;
 
+    lv_area_copy(&area_tmp, coords);
+    area_tmp.x1 -= style->body.shadow.width;
+    area_tmp.y1 -= style->body.shadow.width;
+    area_tmp.x2 += style->body.shadow.width;
+    area_tmp.y2 += style->body.shadow.width;
+    if(lv_area_intersect(&area_tmp, &area_tmp, mask)) lv_prof_draw_add(LV_PROF_DRAW_SHADOW, lv_area_get_size(&area_tmp));
+
     if(style->body.shadow.type == LV_SHADOW_FULL) {
         lv_draw_shadow_full(coords, mask, style, opa_scale);
     } else if(style->body.shadow.type == LV_SHADOW_BOTTOM) {
@@ -1143,6 +1295,137 @@ static void lv_draw_shadow(const lv_area_t * coords, const lv_area_t * mask, con
 
 static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                 lv_opa_t opa_scale)
+{
+    bool aa = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
+
+    lv_coord_t radius = style->body.radius;
+    lv_coord_t swidth = style->body.shadow.width;
+
+    lv_coord_t width  = lv_area_get_width(coords);
+    lv_coord_t height = lv_area_get_height(coords);
+
+    radius = lv_draw_cont_radius_corr(radius, width, height);
+
+    radius += aa;
+
+    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
+
+    /*Get the opacities of the corners from the cache or calculate them*/
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    uint8_t * table = NULL;
+    bool table_own  = false;
+#if LV_SHADOW_CACHE_SIZE
+    table = shadow_cache_get(radius, swidth, opa);
+#endif
+    if(table == NULL) {
+        uint32_t size;
+        table = lv_draw_shadow_full_calc(radius, swidth, opa, &size);
+        if(table == NULL) return;
+        table_own = true;
+#if LV_SHADOW_CACHE_SIZE
+        if(size <= SHADOW_CACHE_ENTRY_MAX) {
+            table     = shadow_cache_add(radius, swidth, opa, table, size);
+            table_own = false;
+            if(table == NULL) return;
+        }
+#endif
+    }
+
+    /*Divide the table*/
+    int16_t line_num        = radius + swidth + 1;
+    lv_coord_t * curve_x    = (lv_coord_t *)&table[0]; /*Stores the 'x' coordinates of a quarter circle.*/
+    uint16_t * line_len     = (uint16_t *)&table[line_num * sizeof(lv_coord_t)];
+    lv_opa_t * line_2d_blur = &table[line_num * (sizeof(lv_coord_t) + sizeof(uint16_t))];
+
+    int16_t line;
+    uint16_t col;
+
+    lv_point_t point_rt;
+    lv_point_t point_rb;
+    lv_point_t point_lt;
+    lv_point_t point_lb;
+    lv_point_t ofs_rb;
+    lv_point_t ofs_rt;
+    lv_point_t ofs_lb;
+    lv_point_t ofs_lt;
+    ofs_rb.x = coords->x2 - radius - aa;
+    ofs_rb.y = coords->y2 - radius - aa;
+
+    ofs_rt.x = coords->x2 - radius - aa;
+    ofs_rt.y = coords->y1 + radius + aa;
+
+    ofs_lb.x = coords->x1 + radius + aa;
+    ofs_lb.y = coords->y2 - radius - aa;
+
+    ofs_lt.x = coords->x1 + radius + aa;
+    ofs_lt.y = coords->y1 + radius + aa;
+    for(line = 0; line < line_num; line++) {
+        col = line_len[line];
+
+        /*Flush the line*/
+        point_rt.x = curve_x[line] + ofs_rt.x + 1;
+        point_rt.y = ofs_rt.y - line;
+
+        point_rb.x = curve_x[line] + ofs_rb.x + 1;
+        point_rb.y = ofs_rb.y + line;
+
+        point_lt.x = ofs_lt.x - curve_x[line] - 1;
+        point_lt.y = ofs_lt.y - line;
+
+        point_lb.x = ofs_lb.x - curve_x[line] - 1;
+        point_lb.y = ofs_lb.y + line;
+
+        uint16_t d;
+        for(d = 1; d < col; d++) {
+
+            if(point_lt.x < ofs_lt.x && point_lt.y < ofs_lt.y) {
+                lv_draw_px(point_lt.x, point_lt.y, mask, style->body.shadow.color, line_2d_blur[d]);
+            }
+
+            if(point_lb.x < ofs_lb.x && point_lb.y > ofs_lb.y) {
+                lv_draw_px(point_lb.x, point_lb.y, mask, style->body.shadow.color, line_2d_blur[d]);
+            }
+
+            if(point_rt.x > ofs_rt.x && point_rt.y < ofs_rt.y) {
+                lv_draw_px(point_rt.x, point_rt.y, mask, style->body.shadow.color, line_2d_blur[d]);
+            }
+
+            if(point_rb.x > ofs_rb.x && point_rb.y > ofs_rb.y) {
+                lv_draw_px(point_rb.x, point_rb.y, mask, style->body.shadow.color, line_2d_blur[d]);
+            }
+
+            point_rb.x++;
+            point_lb.x--;
+
+            point_rt.x++;
+            point_lt.x--;
+        }
+
+        /* Put the first line to the edges too.
+         * It is not correct because blur should be done below the corner too
+         * but is is simple, fast and gives a good enough result*/
+        if(line == 0) lv_draw_shadow_full_straight(coords, mask, style, line_2d_blur);
+
+        line_2d_blur += col; /*The lines are stored after each other*/
+    }
+
+    if(table_own) lv_mem_free(table);
+    lv_draw_scratch_release(&mark);
+}
+
+/**
+ * Calculate the opacities of a shadow's corner.
+ * The table has `radius + swidth + 1` lines and consists of
+ * the 'x' of the quarter circle on every line (`lv_coord_t`), the number of opacities on every line (`uint16_t`)
+ * and the opacities of the lines after each other (`lv_opa_t`)
+ * @param radius the corrected radius of the rectangle (anti-aliasing included)
+ * @param swidth width of the shadow
+ * @param opa opacity of the shadow
+ * @param size store the size of the table here
+ * @return the table allocated with `lv_mem_alloc` or NULL if out of memory
+ */
+static uint8_t * lv_draw_shadow_full_calc(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, uint32_t * size)
 {
 
     /* KNOWN ISSUE
@@ -1156,35 +1439,36 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
      * other corner. `col` also should start from `- swidth`
      */
 
-    bool aa = lv_disp_get_antialiasing(lv_refr_get_disp_refreshing());
-
-    lv_coord_t radius = style->body.radius;
-    lv_coord_t swidth = style->body.shadow.width;
-
-    lv_coord_t width  = lv_area_get_width(coords);
-    lv_coord_t height = lv_area_get_height(coords);
-
-    radius = lv_draw_cont_radius_corr(radius, width, height);
+    int16_t line_num = radius + swidth + 1;
+    uint32_t head_size = line_num * (sizeof(lv_coord_t) + sizeof(uint16_t));
 
-    radius += aa;
+    /*Reserve `2 * swidth` opacities for every line first and enlarge the table if required*/
+    uint32_t table_size = head_size + line_num * (2 * swidth + 2);
+    uint8_t * table     = lv_mem_alloc(table_size);
+    lv_mem_assert(table);
+    if(table == NULL) return NULL;
 
-    /*Allocate a draw buffer the buffer required to draw the shadow*/
+    /*Allocate a draw buffer the buffer required to calculate the shadow*/
     int16_t filter_width = 2 * swidth + 1;
-    uint32_t curve_x_size = ((radius + swidth + 1) + 3) & ~0x3; /*Round to 4*/
-    curve_x_size *= sizeof(lv_coord_t);
     uint32_t line_1d_blur_size = (filter_width + 3) & ~0x3;     /*Round to 4*/
     line_1d_blur_size *= sizeof(uint32_t);
     uint32_t line_2d_blur_size = ((radius + swidth + 1) + 3) & ~0x3;     /*Round to 4*/
     line_2d_blur_size *= sizeof(lv_opa_t);
 
-    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size + line_2d_blur_size);
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    uint8_t * draw_buf = lv_draw_scratch_alloc(line_1d_blur_size + line_2d_blur_size);
+    if(draw_buf == NULL) {
+        lv_mem_free(table);
+        return NULL;
+    }
 
     /*Divide the draw buffer*/
-    lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
-    uint32_t * line_1d_blur = (uint32_t *)&draw_buf[curve_x_size];
-    lv_opa_t * line_2d_blur = (lv_opa_t *)&draw_buf[curve_x_size + line_1d_blur_size];
+    uint32_t * line_1d_blur = (uint32_t *)&draw_buf[0];
+    lv_opa_t * line_2d_blur = (lv_opa_t *)&draw_buf[line_1d_blur_size];
 
-    memset(curve_x, 0, curve_x_size);
+    lv_coord_t * curve_x = (lv_coord_t *)&table[0]; /*Stores the 'x' coordinates of a quarter circle.*/
+    memset(curve_x, 0, line_num * sizeof(lv_coord_t));
     lv_point_t circ;
     lv_coord_t circ_tmp;
     lv_circ_init(&circ, &circ_tmp, radius);
@@ -1195,33 +1479,13 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
     }
     int16_t line;
     /*1D Blur horizontally*/
-    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
     for(line = 0; line < filter_width; line++) {
         line_1d_blur[line] = (uint32_t)((uint32_t)(filter_width - line) * (opa * 2) << SHADOW_OPA_EXTRA_PRECISION) /
                              (filter_width * filter_width);
     }
 
     uint16_t col;
-
-    lv_point_t point_rt;
-    lv_point_t point_rb;
-    lv_point_t point_lt;
-    lv_point_t point_lb;
-    lv_point_t ofs_rb;
-    lv_point_t ofs_rt;
-    lv_point_t ofs_lb;
-    lv_point_t ofs_lt;
-    ofs_rb.x = coords->x2 - radius - aa;
-    ofs_rb.y = coords->y2 - radius - aa;
-
-    ofs_rt.x = coords->x2 - radius - aa;
-    ofs_rt.y = coords->y1 + radius + aa;
-
-    ofs_lb.x = coords->x1 + radius + aa;
-    ofs_lb.y = coords->y2 - radius - aa;
-
-    ofs_lt.x = coords->x1 + radius + aa;
-    ofs_lt.y = coords->y1 + radius + aa;
+    uint32_t table_used = head_size;
     bool line_ready;
     for(line = 0; line <= radius + swidth; line++) { /*Check all rows and make the 1D blur to 2D*/
         line_ready = false;
@@ -1261,51 +1525,133 @@ static void lv_draw_shadow_full(const lv_area_t * coords, const lv_area_t * mask
             }
         }
 
-        /*Flush the line*/
-        point_rt.x = curve_x[line] + ofs_rt.x + 1;
-        point_rt.y = ofs_rt.y - line;
+        /*Save the line*/
+        if(table_used + col > table_size) {
+            table_size = table_used + col + (table_size >> 1);
+            table      = lv_mem_realloc(table, table_size);
+            lv_mem_assert(table);
+            if(table == NULL) {
+                lv_draw_scratch_release(&mark);
+                return NULL;
+            }
+            curve_x = (lv_coord_t *)&table[0];
+        }
+        uint16_t * line_len = (uint16_t *)&table[line_num * sizeof(lv_coord_t)];
+        line_len[line]      = col;
+        memcpy(&table[table_used], line_2d_blur, col);
+        table_used += col;
+    }
 
-        point_rb.x = curve_x[line] + ofs_rb.x + 1;
-        point_rb.y = ofs_rb.y + line;
+    lv_draw_scratch_release(&mark);
 
-        point_lt.x = ofs_lt.x - curve_x[line] - 1;
-        point_lt.y = ofs_lt.y - line;
+    *size = table_used;
+    return table;
+}
 
-        point_lb.x = ofs_lb.x - curve_x[line] - 1;
-        point_lb.y = ofs_lb.y + line;
+#if LV_SHADOW_CACHE_SIZE
+/**
+ * Search a shadow in the cache
+ * @param radius the corrected radius of the rectangle (anti-aliasing included)
+ * @param swidth width of the shadow
+ * @param opa opacity of the shadow
+ * @return copy of the cached table in the scratch arena or NULL if not found
+ */
+static uint8_t * shadow_cache_get(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa)
+{
+    uint8_t * table = NULL;
+
+    /*Copy it while locked because an other drawing thread might replace the entry*/
+    lv_thread_lock();
+    uint16_t i;
+    for(i = 0; i < LV_SHADOW_CACHE_SIZE; i++) {
+        lv_shadow_cache_entry_t * e = &shadow_cache[i];
+        if(e->table && e->radius == radius && e->swidth == swidth && e->opa == opa) {
+            e->life = ++shadow_cache_life;
+            table   = lv_draw_scratch_alloc(e->size);
+            if(table) memcpy(table, e->table, e->size);
+            break;
+        }
+    }
+    if(table) shadow_cache_hit++;
+    else shadow_cache_miss++;
+    lv_thread_unlock();
 
-        uint16_t d;
-        for(d = 1; d < col; d++) {
+    return table;
+}
 
-            if(point_lt.x < ofs_lt.x && point_lt.y < ofs_lt.y) {
-                lv_draw_px(point_lt.x, point_lt.y, mask, style->body.shadow.color, line_2d_blur[d]);
-            }
+/**
+ * Put a shadow into the cache in place of the least recently used one
+ * @param radius the corrected radius of the rectangle (anti-aliasing included)
+ * @param swidth width of the shadow
+ * @param opa opacity of the shadow
+ * @param table a table from `lv_draw_shadow_full_calc`. The cache will free it.
+ * @param size size of `table`
+ * @return copy of the table in the scratch arena or NULL if out of memory
+ */
+static uint8_t * shadow_cache_add(lv_coord_t radius, lv_coord_t swidth, lv_opa_t opa, uint8_t * table, uint32_t size)
+{
+    uint8_t * copy = lv_draw_scratch_alloc(size);
+    if(copy) memcpy(copy, table, size);
+
+    lv_thread_lock();
+    lv_shadow_cache_entry_t * e = &shadow_cache[0];
+    uint16_t i;
+    for(i = 1; i < LV_SHADOW_CACHE_SIZE && e->table; i++) {
+        if(shadow_cache[i].table == NULL || shadow_cache[i].life < e->life) e = &shadow_cache[i];
+    }
 
-            if(point_lb.x < ofs_lb.x && point_lb.y > ofs_lb.y) {
-                lv_draw_px(point_lb.x, point_lb.y, mask, style->body.shadow.color, line_2d_blur[d]);
-            }
+    if(e->table) lv_mem_free(e->table);
+    e->table  = table;
+    e->size   = size;
+    e->life   = ++shadow_cache_life;
+    e->radius = radius;
+    e->swidth = swidth;
+    e->opa    = opa;
+    lv_thread_unlock();
 
-            if(point_rt.x > ofs_rt.x && point_rt.y < ofs_rt.y) {
-                lv_draw_px(point_rt.x, point_rt.y, mask, style->body.shadow.color, line_2d_blur[d]);
-            }
+    return copy;
+}
 
-            if(point_rb.x > ofs_rb.x && point_rb.y > ofs_rb.y) {
-                lv_draw_px(point_rb.x, point_rb.y, mask, style->body.shadow.color, line_2d_blur[d]);
-            }
+/**
+ * The bytes `lv_draw_shadow_cache_shrinker` can give back: the cached tables
+ */
+static uint32_t shadow_cache_size_cb(void)
+{
+    uint32_t size = 0;
+    uint16_t i;
+    for(i = 0; i < LV_SHADOW_CACHE_SIZE; i++) {
+        if(shadow_cache[i].table) size += shadow_cache[i].size;
+    }
 
-            point_rb.x++;
-            point_lb.x--;
+    return size;
+}
 
-            point_rt.x++;
-            point_lt.x--;
+/**
+ * Remove the least recently used shadows until `size` bytes are freed. Called with `lv_thread_lock()`.
+ * @param size bytes to free
+ * @return the freed bytes
+ */
+static uint32_t shadow_cache_shrink_cb(uint32_t size)
+{
+    uint32_t freed = 0;
+    while(freed < size) {
+        lv_shadow_cache_entry_t * lru = NULL;
+        uint16_t i;
+        for(i = 0; i < LV_SHADOW_CACHE_SIZE; i++) {
+            lv_shadow_cache_entry_t * e = &shadow_cache[i];
+            if(e->table == NULL) continue;
+            if(lru == NULL || e->life < lru->life) lru = e;
         }
+        if(lru == NULL) break;
 
-        /* Put the first line to the edges too.
-         * It is not correct because blur should be done below the corner too
-         * but is is simple, fast and gives a good enough result*/
-        if(line == 0) lv_draw_shadow_full_straight(coords, mask, style, line_2d_blur);
+        freed += lru->size;
+        lv_mem_free(lru->table);
+        memset(lru, 0, sizeof(lv_shadow_cache_entry_t));
     }
+
+    return freed;
 }
+#endif
 
 static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
                                   lv_opa_t opa_scale)
@@ -1325,7 +1671,10 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
     lv_opa_t line_1d_blur_size = (swidth + 3) & ~0x3;     /*Round to 4*/
     line_1d_blur_size *= sizeof(lv_opa_t);
 
-    uint8_t * draw_buf = lv_draw_get_buf(curve_x_size + line_1d_blur_size);
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    uint8_t * draw_buf = lv_draw_scratch_alloc(curve_x_size + line_1d_blur_size);
+    if(draw_buf == NULL) return;
 
     /*Divide the draw buffer*/
     lv_coord_t  * curve_x = (lv_coord_t *)&draw_buf[0]; /*Stores the 'x' coordinates of a quarter circle.*/
@@ -1399,6 +1748,8 @@ static void lv_draw_shadow_bottom(const lv_area_t * coords, const lv_area_t * ma
         area_mid.y1++;
         area_mid.y2++;
     }
+
+    lv_draw_scratch_release(&mark);
 }
 
 static void lv_draw_shadow_full_straight(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style,
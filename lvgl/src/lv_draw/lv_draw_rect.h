@@ -36,6 +36,20 @@ extern "C" {
  */
 void lv_draw_rect(const lv_area_t * coords, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale);
 
+#if LV_USE_SHADOW && LV_SHADOW_CACHE_SIZE
+/**
+ * Get the statistics of the shadow cache. E.g. to print them in the display driver's `monitor_cb`
+ * @param hit store the number of shadows drawn from the cache here (can be NULL)
+ * @param miss store the number of shadows which had to be calculated here (can be NULL)
+ */
+void lv_draw_rect_get_cache_stat(uint32_t * hit, uint32_t * miss);
+
+/**
+ * Removes the least recently used shadows if the memory is low (see `lv_mem_shrinker_add`)
+ */
+extern const lv_mem_shrinker_t lv_draw_shadow_cache_shrinker;
+#endif
+
 /**********************
  *      MACROS
  **********************/
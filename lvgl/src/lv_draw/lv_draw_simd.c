@@ -0,0 +1,400 @@
+/**
+ * @file lv_draw_simd.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_draw_simd.h"
+#if LV_USE_SIMD
+
+#include <stddef.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+/*The kernels work on the bits of little endian ARGB8888 and RGB565 colors*/
+#if(LV_COLOR_DEPTH == 32 || (LV_COLOR_DEPTH == 16 && LV_COLOR_16_SWAP == 0)) && defined(__BYTE_ORDER__) &&           \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LV_SIMD_X86 1
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define LV_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
+#ifndef LV_SIMD_X86
+#define LV_SIMD_X86 0
+#endif
+
+#ifndef LV_SIMD_NEON
+#define LV_SIMD_NEON 0
+#endif
+
+/*Pixels in a 128 and 256 bit register*/
+#define PX_128 (16 / sizeof(lv_color_t))
+#define PX_256 (32 / sizeof(lv_color_t))
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef uint32_t (*blend_cb_t)(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+typedef uint32_t (*fill_cb_t)(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_SIMD_X86
+static uint32_t blend_sse2(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static uint32_t fill_sse2(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+static uint32_t blend_avx2(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static uint32_t fill_avx2(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+static uint32_t fill_2_alpha_sse2(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+#endif
+#elif LV_SIMD_NEON
+static uint32_t blend_neon(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+static uint32_t fill_neon(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static blend_cb_t blend_cb;
+static fill_cb_t fill_cb;
+static fill_cb_t fill_2_alpha_cb;
+static const char * simd_name = "none";
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Select the kernels supported by the CPU
+ */
+void lv_draw_simd_init(void)
+{
+#if LV_SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        blend_cb  = blend_avx2;
+        fill_cb   = fill_avx2;
+        simd_name = "AVX2";
+    } else if(__builtin_cpu_supports("sse2")) {
+        blend_cb  = blend_sse2;
+        fill_cb   = fill_sse2;
+        simd_name = "SSE2";
+    }
+
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+    if(__builtin_cpu_supports("sse2")) fill_2_alpha_cb = fill_2_alpha_sse2;
+#endif
+#elif LV_SIMD_NEON
+    blend_cb  = blend_neon;
+    fill_cb   = fill_neon;
+    simd_name = "NEON";
+#endif
+}
+
+/**
+ * Get the name of the selected instruction set
+ * @return e.g. "AVX2", "SSE2", "NEON" or "none"
+ */
+const char * lv_draw_simd_get_name(void)
+{
+    return simd_name;
+}
+
+/**
+ * Blend pixels to destination memory using opacity: `dest = lv_color_mix(src, dest, opa)`
+ * @param dest pointer to the destination pixels
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ * @return number of pixels blended from the start. The caller has to blend the rest.
+ */
+uint32_t lv_draw_simd_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    if(blend_cb == NULL) return 0;
+    return blend_cb(dest, src, length, opa);
+}
+
+/**
+ * Mix a color to pixels: `dest = lv_color_mix(color, dest, opa)`
+ * @param dest pointer to the destination pixels
+ * @param length number of pixels
+ * @param color the color to mix
+ * @param opa opacity of `color`
+ * @return number of pixels mixed from the start. The caller has to mix the rest.
+ */
+uint32_t lv_draw_simd_fill(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa)
+{
+    if(fill_cb == NULL) return 0;
+    return fill_cb(dest, length, color, opa);
+}
+
+/**
+ * Mix a color to pixels which have alpha channel too (`LV_COLOR_SCREEN_TRANSP`)
+ * @param dest pointer to the destination pixels
+ * @param length number of pixels
+ * @param color the color to mix
+ * @param opa opacity of `color`
+ * @return number of pixels mixed from the start. The caller has to mix the rest.
+ */
+uint32_t lv_draw_simd_fill_2_alpha(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa)
+{
+    if(fill_2_alpha_cb == NULL) return 0;
+    return fill_2_alpha_cb(dest, length, color, opa);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+#if LV_SIMD_X86
+
+/*Every channel is `(s * mix + d * (255 - mix)) >> 8` on 16 bit like in `lv_color_mix`*/
+__attribute__((target("sse2"))) static inline __m128i mix_sse2(__m128i s, __m128i d, __m128i mix, __m128i inv)
+{
+#if LV_COLOR_DEPTH == 32
+    const __m128i zero = _mm_setzero_si128();
+    __m128i lo         = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(s, zero), mix),
+                               _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), inv));
+    __m128i hi         = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(s, zero), mix),
+                               _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), inv));
+    __m128i res        = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+    return _mm_or_si128(res, _mm_set1_epi32((int32_t)0xFF000000));
+#else
+    const __m128i m5 = _mm_set1_epi16(0x1F);
+    const __m128i m6 = _mm_set1_epi16(0x3F);
+    __m128i r        = _mm_add_epi16(_mm_mullo_epi16(_mm_srli_epi16(s, 11), mix),
+                              _mm_mullo_epi16(_mm_srli_epi16(d, 11), inv));
+    __m128i g        = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(s, 5), m6), mix),
+                              _mm_mullo_epi16(_mm_and_si128(_mm_srli_epi16(d, 5), m6), inv));
+    __m128i b        = _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(s, m5), mix),
+                              _mm_mullo_epi16(_mm_and_si128(d, m5), inv));
+    r                = _mm_slli_epi16(_mm_srli_epi16(r, 8), 11);
+    g                = _mm_slli_epi16(_mm_srli_epi16(g, 8), 5);
+    b                = _mm_srli_epi16(b, 8);
+    return _mm_or_si128(_mm_or_si128(r, g), b);
+#endif
+}
+
+__attribute__((target("sse2"))) static uint32_t blend_sse2(lv_color_t * dest, const lv_color_t * src,
+                                                          uint32_t length, lv_opa_t opa)
+{
+    const __m128i mix = _mm_set1_epi16(opa);
+    const __m128i inv = _mm_set1_epi16(255 - opa);
+    uint32_t i;
+    for(i = 0; i + PX_128 <= length; i += PX_128) {
+        __m128i s = _mm_loadu_si128((const __m128i *)&src[i]);
+        __m128i d = _mm_loadu_si128((const __m128i *)&dest[i]);
+        _mm_storeu_si128((__m128i *)&dest[i], mix_sse2(s, d, mix, inv));
+    }
+    return i;
+}
+
+__attribute__((target("sse2"))) static uint32_t fill_sse2(lv_color_t * dest, uint32_t length, lv_color_t color,
+                                                         lv_opa_t opa)
+{
+    const __m128i mix = _mm_set1_epi16(opa);
+    const __m128i inv = _mm_set1_epi16(255 - opa);
+#if LV_COLOR_DEPTH == 32
+    const __m128i s = _mm_set1_epi32((int32_t)color.full);
+#else
+    const __m128i s = _mm_set1_epi16((int16_t)color.full);
+#endif
+    uint32_t i;
+    for(i = 0; i + PX_128 <= length; i += PX_128) {
+        __m128i d = _mm_loadu_si128((const __m128i *)&dest[i]);
+        _mm_storeu_si128((__m128i *)&dest[i], mix_sse2(s, d, mix, inv));
+    }
+    return i;
+}
+
+/*The same as `mix_sse2`. The unpack and pack instructions work in 128 bit lanes so the pixel order remains*/
+__attribute__((target("avx2"))) static inline __m256i mix_avx2(__m256i s, __m256i d, __m256i mix, __m256i inv)
+{
+#if LV_COLOR_DEPTH == 32
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i lo         = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(s, zero), mix),
+                                  _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), inv));
+    __m256i hi         = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(s, zero), mix),
+                                  _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), inv));
+    __m256i res        = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8), _mm256_srli_epi16(hi, 8));
+    return _mm256_or_si256(res, _mm256_set1_epi32((int32_t)0xFF000000));
+#else
+    const __m256i m5 = _mm256_set1_epi16(0x1F);
+    const __m256i m6 = _mm256_set1_epi16(0x3F);
+    __m256i r        = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_srli_epi16(s, 11), mix),
+                                 _mm256_mullo_epi16(_mm256_srli_epi16(d, 11), inv));
+    __m256i g        = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(s, 5), m6), mix),
+                                 _mm256_mullo_epi16(_mm256_and_si256(_mm256_srli_epi16(d, 5), m6), inv));
+    __m256i b        = _mm256_add_epi16(_mm256_mullo_epi16(_mm256_and_si256(s, m5), mix),
+                                 _mm256_mullo_epi16(_mm256_and_si256(d, m5), inv));
+    r                = _mm256_slli_epi16(_mm256_srli_epi16(r, 8), 11);
+    g                = _mm256_slli_epi16(_mm256_srli_epi16(g, 8), 5);
+    b                = _mm256_srli_epi16(b, 8);
+    return _mm256_or_si256(_mm256_or_si256(r, g), b);
+#endif
+}
+
+__attribute__((target("avx2"))) static uint32_t blend_avx2(lv_color_t * dest, const lv_color_t * src,
+                                                          uint32_t length, lv_opa_t opa)
+{
+    const __m256i mix = _mm256_set1_epi16(opa);
+    const __m256i inv = _mm256_set1_epi16(255 - opa);
+    uint32_t i;
+    for(i = 0; i + PX_256 <= length; i += PX_256) {
+        __m256i s = _mm256_loadu_si256((const __m256i *)&src[i]);
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dest[i]);
+        _mm256_storeu_si256((__m256i *)&dest[i], mix_avx2(s, d, mix, inv));
+    }
+    return i;
+}
+
+__attribute__((target("avx2"))) static uint32_t fill_avx2(lv_color_t * dest, uint32_t length, lv_color_t color,
+                                                         lv_opa_t opa)
+{
+    const __m256i mix = _mm256_set1_epi16(opa);
+    const __m256i inv = _mm256_set1_epi16(255 - opa);
+#if LV_COLOR_DEPTH == 32
+    const __m256i s = _mm256_set1_epi32((int32_t)color.full);
+#else
+    const __m256i s = _mm256_set1_epi16((int16_t)color.full);
+#endif
+    uint32_t i;
+    for(i = 0; i + PX_256 <= length; i += PX_256) {
+        __m256i d = _mm256_loadu_si256((const __m256i *)&dest[i]);
+        _mm256_storeu_si256((__m256i *)&dest[i], mix_avx2(s, d, mix, inv));
+    }
+    return i;
+}
+
+#if LV_COLOR_DEPTH == 32 && LV_COLOR_SCREEN_TRANSP
+/*The same as `color_mix_2_alpha` in `lv_draw_basic.c` with a constant foreground*/
+__attribute__((target("sse2"))) static uint32_t fill_2_alpha_sse2(lv_color_t * dest, uint32_t length,
+                                                                 lv_color_t color, lv_opa_t opa)
+{
+    /*Else the result doesn't depend on the background's alpha. Let the caller handle it.*/
+    if(opa <= LV_OPA_MIN || opa > LV_OPA_MAX) return 0;
+
+    const __m128i zero      = _mm_setzero_si128();
+    const __m128i c255      = _mm_set1_epi32(255);
+    const __m128i fg_opa    = _mm_set1_epi32(opa);
+    const __m128i fg_inv    = _mm_set1_epi32(255 - opa);
+    const __m128i fg        = _mm_set1_epi32((int32_t)color.full);
+    const __m128i fg_res    = _mm_set1_epi32((int32_t)((color.full & 0x00FFFFFF) | ((uint32_t)opa << 24)));
+    const __m128i rgb_mask  = _mm_set1_epi32(0x00FFFFFF);
+    const __m128 ratio_num  = _mm_set1_ps((float)(opa * 255));
+    const __m128i fg_lo     = _mm_unpacklo_epi8(fg, zero);
+    const __m128i fg_hi     = _mm_unpackhi_epi8(fg, zero);
+    const __m128i c255_16   = _mm_set1_epi16(255);
+    uint32_t i;
+    for(i = 0; i + 4 <= length; i += 4) {
+        __m128i bg   = _mm_loadu_si128((const __m128i *)&dest[i]);
+        __m128i bg_a = _mm_srli_epi32(bg, 24);
+
+        /*alpha_res = 255 - (((255 - fg_opa) * (255 - bg_opa)) >> 8). The products fit to 16 bit.*/
+        __m128i alpha_res = _mm_sub_epi32(c255, _mm_srli_epi32(_mm_mullo_epi16(fg_inv, _mm_sub_epi32(c255, bg_a)), 8));
+
+        /*ratio = fg_opa * 255 / alpha_res. Exact in float because the error is smaller than 1 / 255*/
+        __m128i ratio = _mm_cvttps_epi32(_mm_div_ps(ratio_num, _mm_cvtepi32_ps(alpha_res)));
+
+        /*Opaque background: simple mix with `fg_opa`*/
+        __m128i bg_cover = _mm_cmpgt_epi32(bg_a, _mm_set1_epi32(LV_OPA_MAX - 1));
+        ratio            = _mm_or_si128(_mm_and_si128(bg_cover, fg_opa), _mm_andnot_si128(bg_cover, ratio));
+        alpha_res        = _mm_or_si128(bg_cover, alpha_res);
+
+        /*Use the ratio of every pixel on its 4 channels*/
+        __m128i r16  = _mm_packs_epi32(ratio, ratio);
+        r16          = _mm_unpacklo_epi16(r16, r16);
+        __m128i r_lo = _mm_unpacklo_epi32(r16, r16);
+        __m128i r_hi = _mm_unpackhi_epi32(r16, r16);
+        __m128i lo   = _mm_add_epi16(_mm_mullo_epi16(fg_lo, r_lo),
+                                   _mm_mullo_epi16(_mm_unpacklo_epi8(bg, zero), _mm_sub_epi16(c255_16, r_lo)));
+        __m128i hi   = _mm_add_epi16(_mm_mullo_epi16(fg_hi, r_hi),
+                                   _mm_mullo_epi16(_mm_unpackhi_epi8(bg, zero), _mm_sub_epi16(c255_16, r_hi)));
+        __m128i res  = _mm_packus_epi16(_mm_srli_epi16(lo, 8), _mm_srli_epi16(hi, 8));
+        res          = _mm_or_si128(_mm_and_si128(res, rgb_mask), _mm_slli_epi32(alpha_res, 24));
+
+        /*Transparent background: the foreground with its opacity*/
+        __m128i bg_transp = _mm_cmplt_epi32(bg_a, _mm_set1_epi32(LV_OPA_MIN + 1));
+        res               = _mm_or_si128(_mm_and_si128(bg_transp, fg_res), _mm_andnot_si128(bg_transp, res));
+
+        _mm_storeu_si128((__m128i *)&dest[i], res);
+    }
+    return i;
+}
+#endif
+
+#elif LV_SIMD_NEON
+
+#if LV_COLOR_DEPTH == 32
+typedef uint8x16_t neon_px_t;
+#define NEON_LOAD(p) vld1q_u8((const uint8_t *)(p))
+#define NEON_STORE(p, v) vst1q_u8((uint8_t *)(p), v)
+#else
+typedef uint16x8_t neon_px_t;
+#define NEON_LOAD(p) vld1q_u16((const uint16_t *)(p))
+#define NEON_STORE(p, v) vst1q_u16((uint16_t *)(p), v)
+#endif
+
+/*Every channel is `(s * mix + d * (255 - mix)) >> 8` on 16 bit like in `lv_color_mix`*/
+static inline neon_px_t mix_neon(neon_px_t s, neon_px_t d, lv_opa_t opa)
+{
+#if LV_COLOR_DEPTH == 32
+    const uint8x8_t mix = vdup_n_u8(opa);
+    const uint8x8_t inv = vdup_n_u8(255 - opa);
+    uint16x8_t lo       = vmlal_u8(vmull_u8(vget_low_u8(s), mix), vget_low_u8(d), inv);
+    uint16x8_t hi       = vmlal_u8(vmull_u8(vget_high_u8(s), mix), vget_high_u8(d), inv);
+    uint8x16_t res      = vcombine_u8(vshrn_n_u16(lo, 8), vshrn_n_u16(hi, 8));
+    return vorrq_u8(res, vreinterpretq_u8_u32(vdupq_n_u32(0xFF000000)));
+#else
+    const uint16x8_t mix = vdupq_n_u16(opa);
+    const uint16x8_t inv = vdupq_n_u16(255 - opa);
+    const uint16x8_t m5  = vdupq_n_u16(0x1F);
+    const uint16x8_t m6  = vdupq_n_u16(0x3F);
+    uint16x8_t r         = vmlaq_u16(vmulq_u16(vshrq_n_u16(s, 11), mix), vshrq_n_u16(d, 11), inv);
+    uint16x8_t g = vmlaq_u16(vmulq_u16(vandq_u16(vshrq_n_u16(s, 5), m6), mix), vandq_u16(vshrq_n_u16(d, 5), m6), inv);
+    uint16x8_t b = vmlaq_u16(vmulq_u16(vandq_u16(s, m5), mix), vandq_u16(d, m5), inv);
+    r            = vshlq_n_u16(vshrq_n_u16(r, 8), 11);
+    g            = vshlq_n_u16(vshrq_n_u16(g, 8), 5);
+    b            = vshrq_n_u16(b, 8);
+    return vorrq_u16(vorrq_u16(r, g), b);
+#endif
+}
+
+static uint32_t blend_neon(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa)
+{
+    uint32_t i;
+    for(i = 0; i + PX_128 <= length; i += PX_128) {
+        NEON_STORE(&dest[i], mix_neon(NEON_LOAD(&src[i]), NEON_LOAD(&dest[i]), opa));
+    }
+    return i;
+}
+
+static uint32_t fill_neon(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa)
+{
+#if LV_COLOR_DEPTH == 32
+    const neon_px_t s = vreinterpretq_u8_u32(vdupq_n_u32(color.full));
+#else
+    const neon_px_t s = vdupq_n_u16(color.full);
+#endif
+    uint32_t i;
+    for(i = 0; i + PX_128 <= length; i += PX_128) {
+        NEON_STORE(&dest[i], mix_neon(s, NEON_LOAD(&dest[i]), opa));
+    }
+    return i;
+}
+
+#endif /*LV_SIMD_NEON*/
+
+#endif /*LV_USE_SIMD*/
@@ -0,0 +1,90 @@
+/**
+ * @file lv_draw_simd.h
+ * Vectorized versions of the pixel blending loops of `lv_draw_basic.c`.
+ * The results are the same as with `lv_color_mix` and `color_mix_2_alpha`.
+ */
+
+#ifndef LV_DRAW_SIMD_H
+#define LV_DRAW_SIMD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "../lv_misc/lv_color.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if LV_USE_SIMD
+
+/**
+ * Select the kernels supported by the CPU
+ */
+void lv_draw_simd_init(void);
+
+/**
+ * Get the name of the selected instruction set
+ * @return e.g. "AVX2", "SSE2", "NEON" or "none"
+ */
+const char * lv_draw_simd_get_name(void);
+
+/**
+ * Blend pixels to destination memory using opacity: `dest = lv_color_mix(src, dest, opa)`
+ * @param dest pointer to the destination pixels
+ * @param src pointer to the source pixels
+ * @param length number of pixels
+ * @param opa opacity of `src`
+ * @return number of pixels blended from the start. The caller has to blend the rest.
+ */
+uint32_t lv_draw_simd_blend(lv_color_t * dest, const lv_color_t * src, uint32_t length, lv_opa_t opa);
+
+/**
+ * Mix a color to pixels: `dest = lv_color_mix(color, dest, opa)`
+ * @param dest pointer to the destination pixels
+ * @param length number of pixels
+ * @param color the color to mix
+ * @param opa opacity of `color`
+ * @return number of pixels mixed from the start. The caller has to mix the rest.
+ */
+uint32_t lv_draw_simd_fill(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+
+/**
+ * Mix a color to pixels which have alpha channel too (`LV_COLOR_SCREEN_TRANSP`)
+ * @param dest pointer to the destination pixels
+ * @param length number of pixels
+ * @param color the color to mix
+ * @param opa opacity of `color`
+ * @return number of pixels mixed from the start. The caller has to mix the rest.
+ */
+uint32_t lv_draw_simd_fill_2_alpha(lv_color_t * dest, uint32_t length, lv_color_t color, lv_opa_t opa);
+
+#endif /*LV_USE_SIMD*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_DRAW_SIMD_H*/
@@ -12,17 +12,42 @@
 /*********************
  *      DEFINES
  *********************/
+#define POLY_FRACT_SHIFT 8 /*Sub-pixel precision of the edge crossings*/
+#define POLY_FRACT (1 << POLY_FRACT_SHIFT)
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*A not horizontal edge of a polygon stepping row by row*/
+typedef struct
+{
+    int32_t x;        /*Crossing with the middle of the current row [1/POLY_FRACT px]*/
+    int32_t x_rem;    /*Remainder of `x` in 1/dy units*/
+    int32_t step;     /*Change of `x` from row to row*/
+    int32_t step_rem; /*Change of `x_rem` from row to row*/
+    int32_t half;     /*Absolute change of `x` in half row. Used by the anti-aliasing*/
+    int32_t dx;
+    lv_coord_t x_top; /*The x coordinate of the upper end*/
+    lv_coord_t y1;    /*First row of the edge*/
+    lv_coord_t y2;    /*The row after the last of the edge*/
+    int8_t dir;       /*1: the edge goes downwards; -1: upwards*/
+} poly_edge_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-void tri_draw_flat(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa);
-void tri_draw_tall(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa);
-static void point_swap(lv_point_t * p1, lv_point_t * p2);
+static void poly_fill(const lv_point_t * points, uint32_t point_cnt, const lv_area_t * mask, const lv_style_t * style,
+                      lv_opa_t opa_scale, bool aa);
+static void poly_edge_start(poly_edge_t * edge, lv_coord_t y);
+static void poly_edge_step(poly_edge_t * edge);
+static void poly_draw_span(const poly_edge_t * left, const poly_edge_t * right, lv_coord_t y, const lv_area_t * mask,
+                           lv_color_t color, lv_opa_t opa);
+#if LV_ANTIALIAS
+static void poly_draw_span_aa(const poly_edge_t * left, const poly_edge_t * right, lv_coord_t y,
+                              const lv_area_t * mask, lv_color_t color, lv_opa_t opa);
+static int32_t poly_ramp_cover(lv_coord_t px, int32_t lo, int32_t hi);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -37,7 +62,7 @@ static void point_swap(lv_point_t * p1, lv_point_t * p2);
  **********************/
 
 /**
- *
+ * Draw a triangle. It's not anti-aliased to perfectly match with the adjacent triangles.
  * @param points pointer to an array with 3 points
  * @param mask the triangle will be drawn only in this mask
  * @param style style for of the triangle
@@ -45,41 +70,13 @@ static void point_swap(lv_point_t * p1, lv_point_t * p2);
  */
 void lv_draw_triangle(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale)
 {
-
-    /*Return is the triangle is degenerated*/
-    if(points[0].x == points[1].x && points[0].y == points[1].y) return;
-    if(points[1].x == points[2].x && points[1].y == points[2].y) return;
-    if(points[0].x == points[2].x && points[0].y == points[2].y) return;
-
-    if(points[0].x == points[1].x && points[1].x == points[2].x) return;
-    if(points[0].y == points[1].y && points[1].y == points[2].y) return;
-
-    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
-
-    /*Is the triangle flat or tall?*/
-    lv_coord_t x_min = LV_MATH_MIN(LV_MATH_MIN(points[0].x, points[1].x), points[2].x);
-    lv_coord_t x_max = LV_MATH_MAX(LV_MATH_MAX(points[0].x, points[1].x), points[2].x);
-    lv_coord_t y_min = LV_MATH_MIN(LV_MATH_MIN(points[0].y, points[1].y), points[2].y);
-    lv_coord_t y_max = LV_MATH_MAX(LV_MATH_MAX(points[0].y, points[1].y), points[2].y);
-
-    /* Draw the tall rectangles from vertical lines
-     * and from the flat triangles from horizontal lines
-     * to minimize the number of lines.
-     * Some pixels are overdrawn on the common edges of the triangles
-     * so use it only if the triangle has no opacity*/
-
-    /* Draw from horizontal lines*/
-    if(x_max - x_min < y_max - y_min) {
-        tri_draw_tall(points, mask, style, opa);
-    }
-    /*Else flat so draw from vertical lines*/
-    else {
-        tri_draw_flat(points, mask, style, opa);
-    }
+    poly_fill(points, 3, mask, style, opa_scale, false);
 }
 
 /**
- * Draw a polygon from triangles. Only convex polygons are supported
+ * Draw a polygon. Convex, concave and self-intersecting (non-zero winding rule) polygons are supported.
+ * The points are on the corners of the pixels so adjacent polygons don't overlap.
+ * It's anti-aliased if `LV_ANTIALIAS` is enabled.
  * @param points an array of points
  * @param point_cnt number of points
  * @param mask polygon will be drawn only in this mask
@@ -89,256 +86,277 @@ void lv_draw_triangle(const lv_point_t * points, const lv_area_t * mask, const l
 void lv_draw_polygon(const lv_point_t * points, uint32_t point_cnt, const lv_area_t * mask, const lv_style_t * style,
                      lv_opa_t opa_scale)
 {
-    if(point_cnt < 3) return;
-    if(points == NULL) return;
-
-    uint32_t i;
-    lv_point_t tri[3];
-    tri[0].x = points[0].x;
-    tri[0].y = points[0].y;
-    for(i = 0; i < point_cnt - 1; i++) {
-        tri[1].x = points[i].x;
-        tri[1].y = points[i].y;
-        tri[2].x = points[i + 1].x;
-        tri[2].y = points[i + 1].y;
-        lv_draw_triangle(tri, mask, style, opa_scale);
-    }
+    poly_fill(points, point_cnt, mask, style, opa_scale, LV_ANTIALIAS ? true : false);
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
 
-void tri_draw_flat(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa)
+/**
+ * Fill a polygon row by row with the spans between its edges.
+ * A pixel is in the polygon if its center is inside it.
+ * @param points an array of points
+ * @param point_cnt number of points
+ * @param mask polygon will be drawn only in this mask
+ * @param style style of the polygon
+ * @param opa_scale scale down all opacities by the factor (0..255)
+ * @param aa true: fade the pixels on the edges by their coverage (only with `LV_ANTIALIAS`)
+ */
+static void poly_fill(const lv_point_t * points, uint32_t point_cnt, const lv_area_t * mask, const lv_style_t * style,
+                      lv_opa_t opa_scale, bool aa)
 {
-    /*Return if the points are out of the mask*/
-    if(points[0].x < mask->x1 && points[1].x < mask->x1 && points[2].x < mask->x1) {
-        return;
-    }
+    if(point_cnt < 3) return;
+    if(points == NULL) return;
 
-    if(points[0].x > mask->x2 && points[1].x > mask->x2 && points[2].x > mask->x2) {
-        return;
-    }
+    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->body.opa : (uint16_t)((uint16_t)style->body.opa * opa_scale) >> 8;
+    if(opa < LV_OPA_MIN) return;
 
-    if(points[0].y < mask->y1 && points[1].y < mask->y1 && points[2].y < mask->y1) {
-        return;
+    lv_coord_t x_min = points[0].x;
+    lv_coord_t x_max = points[0].x;
+    lv_coord_t y_min = points[0].y;
+    lv_coord_t y_max = points[0].y;
+    uint32_t i;
+    for(i = 1; i < point_cnt; i++) {
+        x_min = LV_MATH_MIN(x_min, points[i].x);
+        x_max = LV_MATH_MAX(x_max, points[i].x);
+        y_min = LV_MATH_MIN(y_min, points[i].y);
+        y_max = LV_MATH_MAX(y_max, points[i].y);
     }
 
-    if(points[0].y > mask->y2 && points[1].y > mask->y2 && points[2].y > mask->y2) {
-        return;
+    /*The last pixels are before the right and bottom coordinates*/
+    lv_coord_t row_start = LV_MATH_MAX(y_min, mask->y1);
+    lv_coord_t row_end   = LV_MATH_MIN(y_max - 1, mask->y2);
+    if(row_start > row_end) return;
+    if(x_max <= mask->x1 || x_min > mask->x2) return;
+
+    /*The active edges first to keep the pointers aligned*/
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    poly_edge_t ** active = lv_draw_scratch_alloc(point_cnt * (sizeof(poly_edge_t *) + sizeof(poly_edge_t)));
+    if(active == NULL) return;
+    poly_edge_t * edges = (poly_edge_t *)&active[point_cnt];
+
+    /*Collect the edges which are in the rows to draw, sorted by their first row*/
+    uint32_t edge_cnt = 0;
+    for(i = 0; i < point_cnt; i++) {
+        const lv_point_t * a = &points[i];
+        const lv_point_t * b = &points[i + 1 < point_cnt ? i + 1 : 0];
+        if(a->y == b->y) continue; /*Horizontal edges are the ends of the spans*/
+
+        const lv_point_t * top    = a->y < b->y ? a : b;
+        const lv_point_t * bottom = a->y < b->y ? b : a;
+        if(bottom->y <= row_start || top->y > row_end) continue;
+
+        poly_edge_t edge;
+        edge.x_top = top->x;
+        edge.dx    = bottom->x - top->x;
+        edge.y1    = top->y;
+        edge.y2    = bottom->y;
+        edge.dir   = a->y < b->y ? 1 : -1;
+
+        uint32_t j = edge_cnt;
+        while(j > 0 && edges[j - 1].y1 > edge.y1) {
+            edges[j] = edges[j - 1];
+            j--;
+        }
+        edges[j] = edge;
+        edge_cnt++;
     }
 
-    lv_point_t tri[3];
-
-    memcpy(tri, points, sizeof(tri));
-
-    /*Sort the vertices according to their y coordinate (0: y max, 1: y mid, 2:y min)*/
-    if(tri[1].y < tri[0].y) point_swap(&tri[1], &tri[0]);
-    if(tri[2].y < tri[1].y) point_swap(&tri[2], &tri[1]);
-    if(tri[1].y < tri[0].y) point_swap(&tri[1], &tri[0]);
-
-    /*Draw the triangle*/
-    lv_point_t edge1;
-    lv_coord_t dx1  = LV_MATH_ABS(tri[0].x - tri[1].x);
-    lv_coord_t sx1  = tri[0].x < tri[1].x ? 1 : -1;
-    lv_coord_t dy1  = LV_MATH_ABS(tri[0].y - tri[1].y);
-    lv_coord_t sy1  = tri[0].y < tri[1].y ? 1 : -1;
-    lv_coord_t err1 = (dx1 > dy1 ? dx1 : -dy1) / 2;
-    lv_coord_t err_tmp1;
-
-    lv_point_t edge2;
-    lv_coord_t dx2  = LV_MATH_ABS(tri[0].x - tri[2].x);
-    lv_coord_t sx2  = tri[0].x < tri[2].x ? 1 : -1;
-    lv_coord_t dy2  = LV_MATH_ABS(tri[0].y - tri[2].y);
-    lv_coord_t sy2  = tri[0].y < tri[2].y ? 1 : -1;
-    lv_coord_t err2 = (dx1 > dy2 ? dx2 : -dy2) / 2;
-    lv_coord_t err_tmp2;
-
-    lv_coord_t y1_tmp;
-    lv_coord_t y2_tmp;
-
-    edge1.x = tri[0].x;
-    edge1.y = tri[0].y;
-    edge2.x = tri[0].x;
-    edge2.y = tri[0].y;
-    lv_area_t act_area;
-    lv_area_t draw_area;
-
-    while(1) {
-        act_area.x1 = edge1.x;
-        act_area.x2 = edge2.x;
-        act_area.y1 = edge1.y;
-        act_area.y2 = edge2.y;
-
-        /* Get the area of a line.
-         * Adjust it a little bit to perfectly match (no redrawn pixels) with the adjacent triangles*/
-        draw_area.x1 = LV_MATH_MIN(act_area.x1, act_area.x2) + 1;
-        draw_area.x2 = LV_MATH_MAX(act_area.x1, act_area.x2);
-        draw_area.y1 = LV_MATH_MIN(act_area.y1, act_area.y2) - 1;
-        draw_area.y2 = LV_MATH_MAX(act_area.y1, act_area.y2) - 1;
-
-        lv_draw_fill(&draw_area, mask, style->body.main_color, opa);
-
-        /*Calc. the next point of edge1*/
-        y1_tmp = edge1.y;
-        do {
-            if(edge1.x == tri[1].x && edge1.y == tri[1].y) {
-
-                dx1  = LV_MATH_ABS(tri[1].x - tri[2].x);
-                sx1  = tri[1].x < tri[2].x ? 1 : -1;
-                dy1  = LV_MATH_ABS(tri[1].y - tri[2].y);
-                sy1  = tri[1].y < tri[2].y ? 1 : -1;
-                err1 = (dx1 > dy1 ? dx1 : -dy1) / 2;
-            } else if(edge1.x == tri[2].x && edge1.y == tri[2].y) {
-                return;
-            }
-            err_tmp1 = err1;
-            if(err_tmp1 > -dx1) {
-                err1 -= dy1;
-                edge1.x += sx1;
-            }
-            if(err_tmp1 < dy1) {
-                err1 += dx1;
-                edge1.y += sy1;
-            }
-        } while(edge1.y == y1_tmp);
-
-        /*Calc. the next point of edge2*/
-        y2_tmp = edge2.y;
-        do {
-            if(edge2.x == tri[2].x && edge2.y == tri[2].y) return;
-            err_tmp2 = err2;
-            if(err_tmp2 > -dx2) {
-                err2 -= dy2;
-                edge2.x += sx2;
+    uint32_t next_edge  = 0;
+    uint32_t active_cnt = 0;
+    lv_coord_t y;
+    for(y = row_start; y <= row_end; y++) {
+        /*Drop the ended edges*/
+        uint32_t k = 0;
+        for(i = 0; i < active_cnt; i++) {
+            if(active[i]->y2 > y) active[k++] = active[i];
+        }
+        active_cnt = k;
+
+        /*Add the new edges*/
+        while(next_edge < edge_cnt && edges[next_edge].y1 <= y) {
+            poly_edge_start(&edges[next_edge], y);
+            active[active_cnt++] = &edges[next_edge];
+            next_edge++;
+        }
+
+        /*Keep them sorted by their crossing. They are almost sorted from the previous row.*/
+        for(i = 1; i < active_cnt; i++) {
+            poly_edge_t * e = active[i];
+            uint32_t j      = i;
+            while(j > 0 && active[j - 1]->x > e->x) {
+                active[j] = active[j - 1];
+                j--;
             }
-            if(err_tmp2 < dy2) {
-                err2 += dx2;
-                edge2.y += sy2;
+            active[j] = e;
+        }
+
+        /*The inside is where the sum of the edges' directions is not zero*/
+        int32_t winding          = 0;
+        const poly_edge_t * left = NULL;
+        for(i = 0; i < active_cnt; i++) {
+            if(winding == 0) left = active[i];
+            winding += active[i]->dir;
+            if(winding == 0) {
+#if LV_ANTIALIAS
+                if(aa) {
+                    poly_draw_span_aa(left, active[i], y, mask, style->body.main_color, opa);
+                    continue;
+                }
+#else
+                (void)aa; /*Unused*/
+#endif
+                poly_draw_span(left, active[i], y, mask, style->body.main_color, opa);
             }
-        } while(edge2.y == y2_tmp);
+        }
+
+        for(i = 0; i < active_cnt; i++) {
+            poly_edge_step(active[i]);
+        }
     }
+
+    lv_draw_scratch_release(&mark);
 }
 
-void tri_draw_tall(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa)
+/**
+ * Initialize the crossing of an edge with a row
+ * @param edge pointer to an edge
+ * @param y the row to start on
+ */
+static void poly_edge_start(poly_edge_t * edge, lv_coord_t y)
 {
-    /*
-     * Better to draw from vertical lines
-     * |\
-     * | |
-     * | |
-     * |  \
-     * |   |
-     * |___|
-     */
-
-    lv_point_t tri[3];
-
-    memcpy(tri, points, sizeof(tri));
-
-    /*Sort the vertices according to their x coordinate (0: x max, 1: x mid, 2:x min)*/
-    if(tri[1].x < tri[0].x) point_swap(&tri[1], &tri[0]);
-    if(tri[2].x < tri[1].x) point_swap(&tri[2], &tri[1]);
-    if(tri[1].x < tri[0].x) point_swap(&tri[1], &tri[0]);
-
-    /*Draw the triangle*/
-    lv_point_t edge1;
-    lv_coord_t dx1  = LV_MATH_ABS(tri[0].x - tri[1].x);
-    lv_coord_t sx1  = tri[0].x < tri[1].x ? 1 : -1;
-    lv_coord_t dy1  = LV_MATH_ABS(tri[0].y - tri[1].y);
-    lv_coord_t sy1  = tri[0].y < tri[1].y ? 1 : -1;
-    lv_coord_t err1 = (dx1 > dy1 ? dx1 : -dy1) / 2;
-    lv_coord_t err_tmp1;
-
-    lv_point_t edge2;
-    lv_coord_t dx2  = LV_MATH_ABS(tri[0].x - tri[2].x);
-    lv_coord_t sx2  = tri[0].x < tri[2].x ? 1 : -1;
-    lv_coord_t dy2  = LV_MATH_ABS(tri[0].y - tri[2].y);
-    lv_coord_t sy2  = tri[0].y < tri[2].y ? 1 : -1;
-    lv_coord_t err2 = (dx1 > dy2 ? dx2 : -dy2) / 2;
-    lv_coord_t err_tmp2;
-
-    lv_coord_t x1_tmp;
-    lv_coord_t x2_tmp;
-
-    edge1.x = tri[0].x;
-    edge1.y = tri[0].y;
-    edge2.x = tri[0].x;
-    edge2.y = tri[0].y;
-    lv_area_t act_area;
-    lv_area_t draw_area;
-
-    while(1) {
-        act_area.x1 = edge1.x;
-        act_area.x2 = edge2.x;
-        act_area.y1 = edge1.y;
-        act_area.y2 = edge2.y;
-
-        draw_area.x1 = LV_MATH_MIN(act_area.x1, act_area.x2);
-        draw_area.x2 = LV_MATH_MAX(act_area.x1, act_area.x2);
-        draw_area.y1 = LV_MATH_MIN(act_area.y1, act_area.y2);
-        draw_area.y2 = LV_MATH_MAX(act_area.y1, act_area.y2) - 1;
-
-        lv_draw_fill(&draw_area, mask, style->body.main_color, opa);
-
-        /*Calc. the next point of edge1*/
-        x1_tmp = edge1.x;
-        do {
-            if(edge1.y == tri[1].y && edge1.x == tri[1].x) {
-
-                dx1  = LV_MATH_ABS(tri[1].x - tri[2].x);
-                sx1  = tri[1].x < tri[2].x ? 1 : -1;
-                dy1  = LV_MATH_ABS(tri[1].y - tri[2].y);
-                sy1  = tri[1].y < tri[2].y ? 1 : -1;
-                err1 = (dx1 > dy1 ? dx1 : -dy1) / 2;
-            } else if(edge1.y == tri[2].y && edge1.x == tri[2].x) {
-                return;
-            }
-            err_tmp1 = err1;
-            if(err_tmp1 > -dx1) {
-                err1 -= dy1;
-                edge1.x += sx1;
-            }
-            if(err_tmp1 < dy1) {
-                err1 += dx1;
-                edge1.y += sy1;
-            }
-        } while(edge1.x == x1_tmp);
+    int32_t dy = edge->y2 - edge->y1;
+
+    /*The middle of the row, from the upper end of the edge*/
+    int64_t n   = (int64_t)(2 * (y - edge->y1) + 1) * edge->dx * (POLY_FRACT / 2);
+    int64_t q   = n / dy;
+    int64_t rem = n - q * dy;
+    if(rem < 0) {
+        q--;
+        rem += dy;
+    }
 
-        /*Calc. the next point of edge2*/
-        x2_tmp = edge2.x;
-        do {
-            if(edge2.y == tri[2].y && edge2.x == tri[2].x) {
-                return;
-            }
+    edge->x     = ((int32_t)edge->x_top << POLY_FRACT_SHIFT) + (int32_t)q;
+    edge->x_rem = (int32_t)rem;
 
-            err_tmp2 = err2;
-            if(err_tmp2 > -dx2) {
-                err2 -= dy2;
-                edge2.x += sx2;
-            }
-            if(err_tmp2 < dy2) {
-                err2 += dx2;
-                edge2.y += sy2;
-            }
-        } while(edge2.x == x2_tmp);
+    int32_t step_n = edge->dx * POLY_FRACT;
+    edge->step     = step_n / dy;
+    edge->step_rem = step_n - edge->step * dy;
+    if(edge->step_rem < 0) {
+        edge->step--;
+        edge->step_rem += dy;
     }
+
+    edge->half = LV_MATH_ABS(step_n / 2) / dy;
 }
 
 /**
- * Swap two points
- * p1 pointer to the first point
- * p2 pointer to the second point
+ * Move the crossing of an edge to the next row
+ * @param edge pointer to an edge
  */
-static void point_swap(lv_point_t * p1, lv_point_t * p2)
+static void poly_edge_step(poly_edge_t * edge)
 {
-    lv_point_t tmp;
-    tmp.x = p1->x;
-    tmp.y = p1->y;
+    edge->x += edge->step;
+    edge->x_rem += edge->step_rem;
+    if(edge->x_rem >= edge->y2 - edge->y1) {
+        edge->x++;
+        edge->x_rem -= edge->y2 - edge->y1;
+    }
+}
 
-    p1->x = p2->x;
-    p1->y = p2->y;
+/**
+ * Fill the pixels between two edges whose center is between the crossings
+ * @param left the edge where the span starts
+ * @param right the edge where the span ends
+ * @param y the row
+ * @param mask draw only in this area
+ * @param color color of the polygon
+ * @param opa opacity of the polygon
+ */
+static void poly_draw_span(const poly_edge_t * left, const poly_edge_t * right, lv_coord_t y, const lv_area_t * mask,
+                           lv_color_t color, lv_opa_t opa)
+{
+    int32_t x1 = (left->x - POLY_FRACT / 2 + POLY_FRACT - 1) >> POLY_FRACT_SHIFT;
+    int32_t x2 = ((right->x - POLY_FRACT / 2 + POLY_FRACT - 1) >> POLY_FRACT_SHIFT) - 1;
+    x1         = LV_MATH_MAX(x1, mask->x1);
+    x2         = LV_MATH_MIN(x2, mask->x2);
+    if(x1 > x2) return;
+
+    lv_area_t area;
+    lv_area_set(&area, x1, y, x2, y);
+    lv_draw_fill(&area, mask, color, opa);
+}
+
+#if LV_ANTIALIAS
+/**
+ * Fill the pixels between two edges and fade the pixels on the edges by their coverage
+ * @param left the edge where the span starts
+ * @param right the edge where the span ends
+ * @param y the row
+ * @param mask draw only in this area
+ * @param color color of the polygon
+ * @param opa opacity of the polygon
+ */
+static void poly_draw_span_aa(const poly_edge_t * left, const poly_edge_t * right, lv_coord_t y,
+                              const lv_area_t * mask, lv_color_t color, lv_opa_t opa)
+{
+    /*The edges cross the row between these x coordinates*/
+    int32_t left_lo  = left->x - left->half;
+    int32_t left_hi  = left->x + left->half;
+    int32_t right_lo = right->x - right->half;
+    int32_t right_hi = right->x + right->half;
+
+    /*Fully covered pixels*/
+    int32_t full_x1 = (left_hi + POLY_FRACT - 1) >> POLY_FRACT_SHIFT;
+    int32_t full_x2 = (right_lo >> POLY_FRACT_SHIFT) - 1;
+    if(full_x1 <= full_x2) {
+        lv_area_t area;
+        lv_area_set(&area, LV_MATH_MAX(full_x1, mask->x1), y, LV_MATH_MIN(full_x2, mask->x2), y);
+        if(area.x1 <= area.x2) lv_draw_fill(&area, mask, color, opa);
+    }
+
+    /*Partly covered pixels*/
+    int32_t x1 = LV_MATH_MAX(left_lo >> POLY_FRACT_SHIFT, mask->x1);
+    int32_t x2 = LV_MATH_MIN(((right_hi + POLY_FRACT - 1) >> POLY_FRACT_SHIFT) - 1, mask->x2);
+    int32_t x;
+    for(x = x1; x <= x2; x++) {
+        if(x >= full_x1 && x <= full_x2) {
+            x = full_x2;
+            continue;
+        }
+
+        int32_t cover = poly_ramp_cover(x, left_lo, left_hi) - poly_ramp_cover(x, right_lo, right_hi);
+        if(cover > 0) lv_draw_px(x, y, mask, color, (uint32_t)opa * cover >> POLY_FRACT_SHIFT);
+    }
+}
+
+/**
+ * Get how much of a pixel is on the right of an edge in a row
+ * @param px x coordinate of the pixel
+ * @param lo the edge's leftmost crossing in the row [1/POLY_FRACT px]
+ * @param hi the edge's rightmost crossing in the row [1/POLY_FRACT px]
+ * @return the coverage [0..POLY_FRACT]
+ */
+static int32_t poly_ramp_cover(lv_coord_t px, int32_t lo, int32_t hi)
+{
+    /*The area on the right of the edge on the left of `t` is the integral of the edge's coverage ramp*/
+    int32_t t[2];
+    int32_t area[2];
+    t[0] = (int32_t)px << POLY_FRACT_SHIFT;
+    t[1] = t[0] + POLY_FRACT;
+
+    uint8_t i;
+    for(i = 0; i < 2; i++) {
+        if(t[i] <= lo)
+            area[i] = 0;
+        else if(t[i] >= hi)
+            area[i] = (hi - lo) / 2 + (t[i] - hi);
+        else
+            area[i] = (int32_t)((int64_t)(t[i] - lo) * (t[i] - lo) / (2 * (hi - lo)));
+    }
 
-    p2->x = tmp.x;
-    p2->y = tmp.y;
+    return area[1] - area[0];
 }
+#endif
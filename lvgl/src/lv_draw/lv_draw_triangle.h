@@ -28,7 +28,7 @@ extern "C" {
  **********************/
 
 /**
- *
+ * Draw a triangle. It's not anti-aliased to perfectly match with the adjacent triangles.
  * @param points pointer to an array with 3 points
  * @param mask the triangle will be drawn only in this mask
  * @param style style for of the triangle
@@ -37,7 +37,9 @@ extern "C" {
 void lv_draw_triangle(const lv_point_t * points, const lv_area_t * mask, const lv_style_t * style, lv_opa_t opa_scale);
 
 /**
- * Draw a polygon from triangles. Only convex polygons are supported
+ * Draw a polygon. Convex, concave and self-intersecting (non-zero winding rule) polygons are supported.
+ * The points are on the corners of the pixels so adjacent polygons don't overlap.
+ * It's anti-aliased if `LV_ANTIALIAS` is enabled.
  * @param points an array of points
  * @param point_cnt number of points
  * @param mask polygon will be drawn only in this mask
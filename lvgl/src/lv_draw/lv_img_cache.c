@@ -7,46 +7,113 @@
  *      INCLUDES
  *********************/
 #include "lv_img_cache.h"
+#include "lv_draw_img.h"
 #include "../lv_hal/lv_hal_tick.h"
 #include "../lv_misc/lv_gc.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
 #endif /* LV_ENABLE_GC */
+
+#if LV_USE_IMG_CACHE_ASYNC
+#include <pthread.h>
+#include <unistd.h>
+#include "../lv_core/lv_refr.h"
+#include "../lv_misc/lv_async.h"
+#include "../lv_misc/lv_thread.h"
+#endif
 /*********************
  *      DEFINES
  *********************/
-/*Decrement life with this value in every open*/
-#define LV_IMG_CACHE_AGING 1
+/*Number of hash buckets (power of 2). The entries of a bucket are compared one by one*/
+#define LV_IMG_CACHE_BUCKETS 16
 
-/*Boost life by this factor (multiply time_to_open with this value)*/
-#define LV_IMG_CACHE_LIFE_GAIN 1
-
-/*Don't let life to be greater than this limit because it would require a lot of time to
- * "die" from very high values */
-#define LV_IMG_CACHE_LIFE_LIMIT 1000
+#define LV_IMG_CACHE_NONE 0xFFFF
 
 #if LV_IMG_CACHE_DEF_SIZE < 1
 #error "LV_IMG_CACHE_DEF_SIZE must be >= 1. See lv_conf.h"
 #endif
 
+#if LV_USE_IMG_CACHE_ASYNC
+#if LV_REFR_THREADS < 2 || LV_ASYNC_QUEUE_SIZE == 0
+#error "LV_USE_IMG_CACHE_ASYNC needs LV_REFR_THREADS > 1 and LV_ASYNC_QUEUE_SIZE. See lv_conf.h"
+#endif
+
+/*[us] to wait for free space in the full lv_async queue*/
+#define LV_IMG_CACHE_POST_RETRY 1000
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_IMG_CACHE_ASYNC
+/*An image opened in the background. Only the worker writes it until it's posted back.*/
+typedef struct _lv_img_cache_job_t
+{
+    struct _lv_img_cache_job_t * next; /*In the queue of the worker*/
+    lv_img_decoder_dsc_t dec_dsc;       /*Opened by the worker*/
+    const void * src;                   /*Own copy of a path or the pointer of a variable*/
+    const lv_style_t * style;
+    uint32_t budget;      /*Read the pixels only into a buffer of at most this size (0: no limit)*/
+    uint32_t pixels_size; /*Size of `dec_dsc.img_data` if the worker read the pixels*/
+    bool ok;
+
+    /*Where the placeholder was drawn. Written by the drawing while the lock is taken.*/
+    lv_disp_t * disp;
+    lv_area_t area;
+    bool drawn;
+} lv_img_cache_job_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static uint32_t src_hash(const void * src, lv_img_src_t src_type);
+static lv_img_cache_entry_t * cache_find(const void * src);
+static lv_img_cache_entry_t * entry_get_free(void);
+static lv_img_cache_entry_t * entry_get_lru(const lv_img_cache_entry_t * keep);
+static void entry_link(lv_img_cache_entry_t * e);
+static void entry_pixels_read(lv_img_cache_entry_t * e);
+static void entry_close(lv_img_cache_entry_t * e);
+static void budget_apply(const lv_img_cache_entry_t * keep);
+static uint32_t pixels_size(const lv_img_decoder_dsc_t * dsc);
+static const uint8_t * pixels_read(lv_img_decoder_dsc_t * dsc, uint32_t size);
+static uint32_t shrinker_size_cb(void);
+static uint32_t shrinker_shrink_cb(uint32_t size);
+#if LV_USE_IMG_CACHE_ASYNC
+static lv_res_t async_start(lv_img_cache_entry_t * e, const void * src, const lv_style_t * style);
+static void async_done_cb(void * user_data);
+static void async_job_free(lv_img_cache_job_t * job);
+static void * worker_main(void * param);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static uint16_t entry_cnt;
+static uint32_t cache_budget = LV_IMG_CACHE_DEF_BUDGET;
+static uint32_t cache_life;
+static uint16_t buckets[LV_IMG_CACHE_BUCKETS]; /*Index of the first entry in `_lv_img_cache_array`*/
+static lv_img_cache_stats_t stats;
+static lv_img_cache_entry_t * entry_busy; /*The last opened entry, it might be drawn now*/
+#if LV_USE_IMG_CACHE_ASYNC
+static bool async_en = true;
+static bool worker_started;
+static pthread_mutex_t queue_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_cond   = PTHREAD_COND_INITIALIZER;
+static lv_img_cache_job_t * queue_head; /*Jobs waiting for the worker. Only with `queue_mutex`*/
+static lv_img_cache_job_t * queue_tail;
+#endif
 
 /**********************
  *      MACROS
  **********************/
 
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+const lv_mem_shrinker_t lv_img_cache_shrinker = {"img_cache", shrinker_size_cb, shrinker_shrink_cb};
+
 /**********************
  *   GLOBAL FUNCTIONS
  **********************/
@@ -54,7 +121,9 @@ static uint16_t entry_cnt;
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The images of files and `LV_IMG_CF_RAW...` variables are decoded once into a pixel buffer if it fits
+ * in the budget, then the decoder is closed.
+ * The least recently used unpinned image is closed if a new image needs its place or the budget.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param style style of the image
  * @return pointer to the cache entry or NULL if can open the image
@@ -66,73 +135,73 @@ lv_img_cache_entry_t * lv_img_cache_open(const void * src, const lv_style_t * st
         return NULL;
     }
 
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
-
-    /*Decrement all lifes. Make the entries older*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].life > INT32_MIN + LV_IMG_CACHE_AGING) {
-            cache[i].life -= LV_IMG_CACHE_AGING;
-        }
-    }
-
     /*Is the image cached?*/
-    lv_img_cache_entry_t * cached_src = NULL;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].dec_dsc.src == src) {
-            /* If opened increment its life.
-             * Image difficult to open should live longer to keep avoid frequent their recaching.
-             * Therefore increase `life` with `time_to_open`*/
-            cached_src = &cache[i];
-            cached_src->life += cached_src->dec_dsc.time_to_open * LV_IMG_CACHE_LIFE_GAIN;
-            if(cached_src->life > LV_IMG_CACHE_LIFE_LIMIT) cached_src->life = LV_IMG_CACHE_LIFE_LIMIT;
-            LV_LOG_TRACE("image draw: image found in the cache");
-            break;
-        }
+    lv_img_cache_entry_t * cached_src = cache_find(src);
+    if(cached_src) {
+        cached_src->life = ++cache_life;
+        stats.hit++;
+        entry_busy = cached_src;
+        LV_LOG_TRACE("image draw: image found in the cache");
+        return cached_src;
     }
 
     /*The image is not cached then cache it now*/
+    stats.miss++;
+    cached_src = entry_get_free();
     if(cached_src == NULL) {
-        /*Find an entry to reuse. Select the entry with the least life*/
-        cached_src = &cache[0];
-        for(i = 1; i < entry_cnt; i++) {
-            if(cache[i].life < cached_src->life) {
-                cached_src = &cache[i];
-            }
-        }
+        LV_LOG_WARN("lv_img_cache_open: every entry is pinned");
+        return NULL;
+    }
+    entry_busy = cached_src; /*Not closed by `lv_img_cache_shrinker` while it's opened and drawn*/
 
-        /*Close the decoder to reuse if it was opened (has a valid source)*/
-        if(cached_src->dec_dsc.src) {
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
-        } else {
-            LV_LOG_INFO("image draw: cache miss, cached to an empty entry");
-        }
+    /*Keep an own copy of a path, the caller's string may be freed while the image is cached*/
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    const void * open_src = src;
+    uint32_t size         = 0;
+    if(src_type != LV_IMG_SRC_VARIABLE) {
+        size       = strlen(src) + 1;
+        char * cpy = lv_mem_alloc(size);
+        if(cpy == NULL) return NULL;
+        memcpy(cpy, src, size);
+        open_src = cpy;
+    }
 
-        /*Open the image and measure the time to open*/
-        uint32_t t_start;
-        t_start                          = lv_tick_get();
-        cached_src->dec_dsc.time_to_open = 0;
-        lv_res_t open_res                = lv_img_decoder_open(&cached_src->dec_dsc, src, style);
-        if(open_res == LV_RES_INV) {
-            LV_LOG_WARN("Image draw cannot open the image resource");
-            lv_img_decoder_close(&cached_src->dec_dsc);
-            memset(&cached_src->dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-            memset(&cached_src, 0, sizeof(lv_img_cache_entry_t));
-            cached_src->life = INT32_MIN; /*Make the empty entry very "weak" to force its use  */
-            return NULL;
-        }
+    cached_src->size = size;
+    cached_src->hash = src_hash(open_src, src_type);
 
-        cached_src->life = 0;
+#if LV_USE_IMG_CACHE_ASYNC
+    if(async_start(cached_src, open_src, style) == LV_RES_OK) {
+        entry_link(cached_src);
+        return cached_src;
+    }
+#endif
 
-        /*If `time_to_open` was not set in the open function set it here*/
-        if(cached_src->dec_dsc.time_to_open == 0) {
-            cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
-        }
+    /*Open the image and measure the time to open*/
+    uint32_t t_start;
+    t_start                          = lv_tick_get();
+    cached_src->dec_dsc.time_to_open = 0;
+    lv_res_t open_res                = lv_img_decoder_open(&cached_src->dec_dsc, open_src, style);
+    if(open_res == LV_RES_INV) {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        if(cached_src->dec_dsc.decoder) lv_img_decoder_close(&cached_src->dec_dsc);
+        if(open_src != src) lv_mem_free((void *)open_src);
+        memset(cached_src, 0, sizeof(lv_img_cache_entry_t));
+        return NULL;
+    }
 
-        if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+    /*If `time_to_open` was not set in the open function set it here*/
+    if(cached_src->dec_dsc.time_to_open == 0) {
+        cached_src->dec_dsc.time_to_open = lv_tick_elaps(t_start);
     }
 
+    if(cached_src->dec_dsc.time_to_open == 0) cached_src->dec_dsc.time_to_open = 1;
+
+    cached_src->dec_dsc.src = open_src; /*The decoder might have changed it*/
+    entry_pixels_read(cached_src);
+    entry_link(cached_src);
+
+    budget_apply(cached_src);
+
     return cached_src;
 }
 
@@ -144,52 +213,577 @@ lv_img_cache_entry_t * lv_img_cache_open(const void * src, const lv_style_t * st
  */
 void lv_img_cache_set_size(uint16_t new_entry_cnt)
 {
-    if(LV_GC_ROOT(_lv_img_cache_array) != NULL) {
+    if(LV_GC_SHARED_ROOT(_lv_img_cache_array) != NULL) {
         /*Clean the cache before free it*/
         lv_img_cache_invalidate_src(NULL);
-        lv_mem_free(LV_GC_ROOT(_lv_img_cache_array));
+        lv_mem_free(LV_GC_SHARED_ROOT(_lv_img_cache_array));
     }
 
+    uint16_t i;
+    for(i = 0; i < LV_IMG_CACHE_BUCKETS; i++) buckets[i] = LV_IMG_CACHE_NONE;
+    entry_busy = NULL;
+
     /*Reallocate the cache*/
-    LV_GC_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt);
-    lv_mem_assert(LV_GC_ROOT(_lv_img_cache_array));
-    if(LV_GC_ROOT(_lv_img_cache_array) == NULL) {
+    LV_GC_SHARED_ROOT(_lv_img_cache_array) = lv_mem_alloc(sizeof(lv_img_cache_entry_t) * new_entry_cnt);
+    lv_mem_assert(LV_GC_SHARED_ROOT(_lv_img_cache_array));
+    if(LV_GC_SHARED_ROOT(_lv_img_cache_array) == NULL) {
         entry_cnt = 0;
         return;
     }
     entry_cnt = new_entry_cnt;
 
     /*Clean the cache*/
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        memset(&LV_GC_ROOT(_lv_img_cache_array)[i].dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-        memset(&LV_GC_ROOT(_lv_img_cache_array)[i], 0, sizeof(lv_img_cache_entry_t));
-    }
+    memset(LV_GC_SHARED_ROOT(_lv_img_cache_array), 0, sizeof(lv_img_cache_entry_t) * entry_cnt);
 }
 
 /**
- * Invalidate an image source in the cache.
+ * Set how many bytes the cached images can hold (decoded pixels and file paths).
+ * The least recently used unpinned images are closed until they fit.
+ * @param budget bytes, 0: no limit, only the number of entries
+ */
+void lv_img_cache_set_budget(uint32_t budget)
+{
+    cache_budget = budget;
+    budget_apply(NULL);
+}
+
+/**
+ * Invalidate an image source in the cache (even if it's pinned).
  * Useful if the image source is updated therefore it needs to be cached again.
  * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
  */
 void lv_img_cache_invalidate_src(const void * src)
 {
+    if(src == NULL) {
+        lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+        uint16_t i;
+        for(i = 0; i < entry_cnt; i++) {
+            if(cache[i].dec_dsc.src != NULL) entry_close(&cache[i]);
+        }
+        return;
+    }
 
-    lv_img_cache_entry_t * cache = LV_GC_ROOT(_lv_img_cache_array);
+    lv_img_cache_entry_t * e = cache_find(src);
+    if(e) entry_close(e);
+}
 
-    uint16_t i;
-    for(i = 0; i < entry_cnt; i++) {
-        if(cache[i].dec_dsc.src == src || src == NULL) {
-            if(cache[i].dec_dsc.src != NULL) {
-                lv_img_decoder_close(&cache[i].dec_dsc);
-            }
+/**
+ * Open an image and keep it in the cache until `lv_img_cache_unpin`. For images drawn very often.
+ * The pins are counted, every successful pin needs an unpin.
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param style style of the image
+ * @return LV_RES_OK: cached and pinned; LV_RES_INV: the image can't be opened or every entry is pinned
+ */
+lv_res_t lv_img_cache_pin(const void * src, const lv_style_t * style)
+{
+    lv_img_cache_entry_t * e = lv_img_cache_open(src, style);
+    if(e == NULL) return LV_RES_INV;
 
-            memset(&cache[i].dec_dsc, 0, sizeof(lv_img_decoder_dsc_t));
-            memset(&cache[i], 0, sizeof(lv_img_cache_entry_t));
-        }
+    if(e->pinned == UINT8_MAX) return LV_RES_INV;
+    e->pinned++;
+    return LV_RES_OK;
+}
+
+/**
+ * Let an image pinned by `lv_img_cache_pin` be reused for other images
+ * @param src the source used in `lv_img_cache_pin`
+ */
+void lv_img_cache_unpin(const void * src)
+{
+    lv_img_cache_entry_t * e = cache_find(src);
+    if(e == NULL || e->pinned == 0) return;
+
+    e->pinned--;
+    if(e->pinned == 0) budget_apply(NULL);
+}
+
+#if LV_USE_IMG_CACHE_ASYNC
+/**
+ * Enable or disable opening the images of files and `LV_IMG_CF_RAW...` variables in the background.
+ * The images already being opened are finished anyway.
+ * @param en true: open them in the background (default); false: open them while drawing
+ */
+void lv_img_cache_set_async(bool en)
+{
+    async_en = en;
+}
+
+/**
+ * Draw the placeholder of an image being opened in the background.
+ * The area is invalidated when the image is ready. Called by the image drawing.
+ * @param entry a pending entry returned by `lv_img_cache_open`
+ * @param coords the coordinates of the image
+ * @param mask the placeholder will be drawn only in this area
+ * @param opa opacity of the placeholder
+ */
+void lv_img_cache_draw_placeholder(lv_img_cache_entry_t * entry, const lv_area_t * coords, const lv_area_t * mask,
+                                   lv_opa_t opa)
+{
+    lv_img_cache_job_t * job = entry->dec_dsc.user_data;
+    lv_disp_t * disp         = lv_refr_get_disp_refreshing();
+
+    lv_thread_lock();
+    if(job->drawn && job->disp == disp) {
+        lv_area_join(&job->area, &job->area, coords);
+    } else {
+        lv_area_copy(&job->area, coords);
+        job->disp  = disp;
+        job->drawn = true;
     }
+    lv_thread_unlock();
+
+    lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.body.main_color = LV_IMG_CACHE_ASYNC_COLOR;
+    style.body.grad_color = LV_IMG_CACHE_ASYNC_COLOR;
+    lv_draw_rect(coords, mask, &style, opa);
+}
+#endif
+
+/**
+ * Get the counters of the image cache
+ * @param stats_p the counters are copied here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats_p)
+{
+    *stats_p = stats;
 }
 
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+/**
+ * Hash an image source
+ * @param src an image source
+ * @param src_type type of `src`
+ * @return the pointer of a variable mixed, FNV-1a of a path
+ */
+static uint32_t src_hash(const void * src, lv_img_src_t src_type)
+{
+    if(src_type == LV_IMG_SRC_VARIABLE) {
+        return ((uint32_t)(uintptr_t)src * 2654435761U) >> 8;
+    }
+
+    const uint8_t * c = src;
+    uint32_t h        = 2166136261U;
+    while(*c) {
+        h ^= *c;
+        h *= 16777619U;
+        c++;
+    }
+    return h;
+}
+
+/**
+ * Search an image in the cache
+ * @param src an image source. Paths are compared by their characters.
+ * @return the entry or NULL if not cached
+ */
+static lv_img_cache_entry_t * cache_find(const void * src)
+{
+    if(entry_cnt == 0) return NULL;
+
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    lv_img_src_t src_type        = lv_img_src_get_type(src);
+    uint32_t hash                = src_hash(src, src_type);
+
+    uint16_t i = buckets[hash & (LV_IMG_CACHE_BUCKETS - 1)];
+    while(i != LV_IMG_CACHE_NONE) {
+        lv_img_cache_entry_t * e = &cache[i];
+        if(e->hash == hash) {
+            if(src_type == LV_IMG_SRC_VARIABLE) {
+                if(e->dec_dsc.src == src) return e;
+            } else if(e->dec_dsc.src_type == src_type && strcmp(e->dec_dsc.src, src) == 0) {
+                return e;
+            }
+        }
+        i = e->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get an unused entry. Close the least recently used unpinned one if all are used.
+ * @return the entry or NULL if all are pinned
+ */
+static lv_img_cache_entry_t * entry_get_free(void)
+{
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].dec_dsc.src == NULL) return &cache[i];
+    }
+
+    lv_img_cache_entry_t * e = entry_get_lru(NULL);
+    if(e == NULL) return NULL;
+
+    LV_LOG_INFO("image draw: cache miss, close and reuse an entry");
+    entry_close(e);
+    stats.evict++;
+    return e;
+}
+
+/**
+ * Get the least recently used unpinned entry
+ * @param keep an entry not to return or NULL
+ * @return the entry or NULL if there is no such entry
+ */
+static lv_img_cache_entry_t * entry_get_lru(const lv_img_cache_entry_t * keep)
+{
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    lv_img_cache_entry_t * lru   = NULL;
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        lv_img_cache_entry_t * e = &cache[i];
+        if(e->dec_dsc.src == NULL || e->pinned || e == keep) continue;
+        if(lru == NULL || e->life < lru->life) lru = e;
+    }
+
+    return lru;
+}
+
+/**
+ * Add a just opened entry to its bucket and to the size of the cache
+ * @param e pointer to an entry
+ */
+static void entry_link(lv_img_cache_entry_t * e)
+{
+    uint16_t id = e - LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    uint16_t b  = e->hash & (LV_IMG_CACHE_BUCKETS - 1);
+    e->life     = ++cache_life;
+    e->next     = buckets[b];
+    buckets[b]  = id;
+    stats.size += e->size;
+    stats.used++;
+}
+
+/**
+ * Read the whole image of a just opened entry if it fits in the budget (see `pixels_size`)
+ * @param e a just opened entry
+ */
+static void entry_pixels_read(lv_img_cache_entry_t * e)
+{
+    uint32_t size = pixels_size(&e->dec_dsc);
+    if(size == 0) return;
+
+    if(cache_budget != 0 && stats.size + e->size + size > cache_budget) {
+        /*Make room only if the others' pixels can be dropped, the line reader works too*/
+        if(e->size + size > cache_budget) return;
+        while(stats.size + e->size + size > cache_budget) {
+            lv_img_cache_entry_t * lru = entry_get_lru(e);
+            if(lru == NULL) return;
+            entry_close(lru);
+            stats.evict++;
+        }
+    }
+
+    if(pixels_read(&e->dec_dsc, size) == NULL) return;
+
+    e->own_pixels = 1;
+    e->size += size;
+}
+
+/**
+ * The bytes `lv_img_cache_shrinker` can give back: the unpinned images except the one being drawn
+ */
+static uint32_t shrinker_size_cb(void)
+{
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    uint32_t size                = 0;
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        lv_img_cache_entry_t * e = &cache[i];
+        if(e->dec_dsc.src == NULL || e->pinned || e == entry_busy) continue;
+        size += e->size;
+    }
+
+    return size;
+}
+
+/**
+ * Close the least recently used images which hold memory until `size` bytes are freed
+ * @param size bytes to free
+ * @return the freed bytes
+ */
+static uint32_t shrinker_shrink_cb(uint32_t size)
+{
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    uint32_t freed               = 0;
+    while(freed < size) {
+        lv_img_cache_entry_t * lru = NULL;
+        uint16_t i;
+        for(i = 0; i < entry_cnt; i++) {
+            lv_img_cache_entry_t * e = &cache[i];
+            if(e->dec_dsc.src == NULL || e->pinned || e == entry_busy || e->size == 0) continue;
+            if(lru == NULL || e->life < lru->life) lru = e;
+        }
+        if(lru == NULL) break;
+
+        freed += lru->size;
+        entry_close(lru);
+        stats.evict++;
+    }
+
+    return freed;
+}
+
+/**
+ * Tell the size of the whole image if the decoder gives it only line by line.
+ * Only for images read from somewhere anyway (files and raw data).
+ * The format of the buffer is what `lv_img_decoder_read_line` gives so it can be drawn the same way.
+ * @param dsc an opened image
+ * @return size of the buffer or 0 if the image shouldn't be read
+ */
+static uint32_t pixels_size(const lv_img_decoder_dsc_t * dsc)
+{
+    if(dsc->img_data != NULL || dsc->error_msg != NULL) return 0;
+
+    lv_img_cf_t cf = dsc->header.cf;
+    bool raw       = cf == LV_IMG_CF_RAW || cf == LV_IMG_CF_RAW_ALPHA || cf == LV_IMG_CF_RAW_CHROMA_KEYED;
+    if(dsc->src_type != LV_IMG_SRC_FILE && raw == false) return 0;
+
+    uint8_t px_size = lv_img_color_format_has_alpha(cf) ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    return (uint32_t)dsc->header.w * dsc->header.h * px_size;
+}
+
+/**
+ * Read the whole image into a new buffer and close the decoder.
+ * It doesn't touch the cache so it can run on any thread.
+ * @param dsc an opened image
+ * @param size the size given by `pixels_size`
+ * @return the buffer, also set as `dsc->img_data`, or NULL if the image is left as it was
+ */
+static const uint8_t * pixels_read(lv_img_decoder_dsc_t * dsc, uint32_t size)
+{
+    uint8_t * buf = lv_mem_alloc(size);
+    if(buf == NULL) return NULL;
+
+    uint32_t line = size / dsc->header.h;
+    lv_coord_t y;
+    for(y = 0; y < dsc->header.h; y++) {
+        if(lv_img_decoder_read_line(dsc, 0, y, dsc->header.w, &buf[y * line]) != LV_RES_OK) {
+            lv_mem_free(buf);
+            return NULL;
+        }
+    }
+
+    lv_img_decoder_close(dsc);
+    dsc->img_data  = buf;
+    dsc->user_data = NULL;
+    return buf;
+}
+
+/**
+ * Close the image of an entry and make it unused
+ * @param e pointer to a used entry
+ */
+static void entry_close(lv_img_cache_entry_t * e)
+{
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+    uint16_t id                  = e - cache;
+    uint16_t * i                 = &buckets[e->hash & (LV_IMG_CACHE_BUCKETS - 1)];
+    while(*i != LV_IMG_CACHE_NONE) {
+        if(*i == id) {
+            *i = e->next;
+            break;
+        }
+        i = &cache[*i].next;
+    }
+
+    /*A pending entry has no decoder yet, its job is dropped when it's ready*/
+    if(e->own_pixels) lv_mem_free((void *)e->dec_dsc.img_data);
+    else if(e->dec_dsc.decoder && e->pending == 0) lv_img_decoder_close(&e->dec_dsc);
+
+    if(e->dec_dsc.src_type != LV_IMG_SRC_VARIABLE) lv_mem_free((void *)e->dec_dsc.src);
+
+    stats.size -= e->size;
+    stats.used--;
+    memset(e, 0, sizeof(lv_img_cache_entry_t));
+}
+
+/**
+ * Close the least recently used unpinned images until the cache fits in the budget
+ * @param keep an entry to keep (the just opened one) or NULL
+ */
+static void budget_apply(const lv_img_cache_entry_t * keep)
+{
+    if(cache_budget == 0) return;
+
+    while(stats.size > cache_budget) {
+        lv_img_cache_entry_t * lru = entry_get_lru(keep);
+        if(lru == NULL) return;
+        entry_close(lru);
+        stats.evict++;
+    }
+}
+
+#if LV_USE_IMG_CACHE_ASYNC
+/**
+ * Give a just reserved entry to the worker if its image is read from somewhere (a file or raw data)
+ * @param e an unlinked entry with `size` and `hash` set
+ * @param src the source, with an own copy of a path
+ * @param style style of the image
+ * @return LV_RES_OK: the entry is pending; LV_RES_INV: open it now
+ */
+static lv_res_t async_start(lv_img_cache_entry_t * e, const void * src, const lv_style_t * style)
+{
+    if(async_en == false) return LV_RES_INV;
+
+    /*Only the header is read now, it's enough to lay out and to draw the placeholder*/
+    lv_img_header_t header;
+    if(lv_img_decoder_get_info(src, &header) != LV_RES_OK) return LV_RES_INV;
+
+    lv_img_src_t src_type = lv_img_src_get_type(src);
+    lv_img_cf_t cf        = header.cf;
+    bool raw              = cf == LV_IMG_CF_RAW || cf == LV_IMG_CF_RAW_ALPHA || cf == LV_IMG_CF_RAW_CHROMA_KEYED;
+    if(src_type != LV_IMG_SRC_FILE && raw == false) return LV_RES_INV;
+
+    if(worker_started == false) {
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, worker_main, NULL) != 0) {
+            LV_LOG_WARN("lv_img_cache: couldn't start the decoding thread");
+            async_en = false;
+            return LV_RES_INV;
+        }
+        pthread_detach(thread);
+        worker_started = true;
+    }
+
+    lv_img_cache_job_t * job = lv_mem_alloc(sizeof(lv_img_cache_job_t));
+    if(job == NULL) return LV_RES_INV;
+    memset(job, 0, sizeof(lv_img_cache_job_t));
+
+    /*The entry's copy of the path can be freed while the worker uses it*/
+    job->src = src;
+    if(src_type == LV_IMG_SRC_FILE) {
+        uint32_t len = strlen(src) + 1;
+        char * cpy   = lv_mem_alloc(len);
+        if(cpy == NULL) {
+            lv_mem_free(job);
+            return LV_RES_INV;
+        }
+        memcpy(cpy, src, len);
+        job->src = cpy;
+    }
+    job->style  = style;
+    job->budget = cache_budget;
+
+    e->dec_dsc.src       = src;
+    e->dec_dsc.src_type  = src_type;
+    e->dec_dsc.header    = header;
+    e->dec_dsc.user_data = job; /*There is no decoder yet to use it*/
+    e->pending           = 1;
+    stats.async++;
+
+    pthread_mutex_lock(&queue_mutex);
+    if(queue_tail) queue_tail->next = job;
+    else queue_head = job;
+    queue_tail = job;
+    pthread_cond_signal(&queue_cond);
+    pthread_mutex_unlock(&queue_mutex);
+
+    return LV_RES_OK;
+}
+
+/**
+ * Called on the UI thread when the worker has opened an image. Fill its entry and redraw its placeholders.
+ * @param user_data pointer to the job
+ */
+static void async_done_cb(void * user_data)
+{
+    lv_img_cache_job_t * job     = user_data;
+    lv_img_cache_entry_t * cache = LV_GC_SHARED_ROOT(_lv_img_cache_array);
+
+    /*The entry might have been invalidated or reused meanwhile*/
+    lv_img_cache_entry_t * e = NULL;
+    uint16_t i;
+    for(i = 0; i < entry_cnt; i++) {
+        if(cache[i].pending && cache[i].dec_dsc.user_data == job) {
+            e = &cache[i];
+            break;
+        }
+    }
+
+    if(job->drawn) lv_inv_area(job->disp, &job->area);
+
+    if(e == NULL) {
+        async_job_free(job);
+        return;
+    }
+
+    if(job->ok) {
+        const void * src = e->dec_dsc.src; /*Keep the entry's copy*/
+        e->dec_dsc       = job->dec_dsc;
+        e->dec_dsc.src   = src;
+        if(job->pixels_size) {
+            e->own_pixels = 1;
+            e->size += job->pixels_size;
+            stats.size += job->pixels_size;
+        }
+    } else {
+        LV_LOG_WARN("Image draw cannot open the image resource");
+        e->dec_dsc.user_data = NULL;
+        e->dec_dsc.error_msg = "No\ndata"; /*Don't try again on every refresh*/
+    }
+    e->pending = 0;
+
+    job->ok = false; /*Given to the entry*/
+    async_job_free(job);
+
+    budget_apply(e);
+}
+
+/**
+ * Free a job and the image it opened if the image wasn't taken by an entry
+ * @param job pointer to a job
+ */
+static void async_job_free(lv_img_cache_job_t * job)
+{
+    if(job->ok) {
+        if(job->pixels_size) lv_mem_free((void *)job->dec_dsc.img_data);
+        else if(job->dec_dsc.decoder) lv_img_decoder_close(&job->dec_dsc);
+    }
+
+    if(lv_img_src_get_type(job->src) == LV_IMG_SRC_FILE) lv_mem_free((void *)job->src);
+    lv_mem_free(job);
+}
+
+/**
+ * Open the queued images one by one and post them back to the UI thread
+ * @param param unused
+ */
+static void * worker_main(void * param)
+{
+    (void)param;
+
+    while(1) {
+        pthread_mutex_lock(&queue_mutex);
+        while(queue_head == NULL) pthread_cond_wait(&queue_cond, &queue_mutex);
+        lv_img_cache_job_t * job = queue_head;
+        queue_head               = job->next;
+        if(queue_head == NULL) queue_tail = NULL;
+        pthread_mutex_unlock(&queue_mutex);
+
+        lv_img_decoder_dsc_t * dsc = &job->dec_dsc;
+        uint32_t t_start           = lv_tick_get();
+        if(lv_img_decoder_open(dsc, job->src, job->style) == LV_RES_OK) {
+            if(dsc->time_to_open == 0) dsc->time_to_open = lv_tick_elaps(t_start);
+            if(dsc->time_to_open == 0) dsc->time_to_open = 1;
+
+            uint32_t size = pixels_size(dsc);
+            if(size != 0 && (job->budget == 0 || size <= job->budget)) {
+                if(pixels_read(dsc, size)) job->pixels_size = size;
+            }
+            job->ok = true;
+        } else if(dsc->decoder) {
+            lv_img_decoder_close(dsc);
+        }
+
+        while(lv_async_post(async_done_cb, job) != LV_RES_OK) usleep(LV_IMG_CACHE_POST_RETRY);
+    }
+
+    return NULL;
+}
+#endif /*LV_USE_IMG_CACHE_ASYNC*/
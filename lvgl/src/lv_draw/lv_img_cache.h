@@ -14,6 +14,7 @@ extern "C" {
  *      INCLUDES
  *********************/
 #include "lv_img_decoder.h"
+#include "../lv_misc/lv_mem.h"
 
 /*********************
  *      DEFINES
@@ -25,19 +26,36 @@ extern "C" {
 
 /**
  * When loading images from the network it can take a long time to download and decode the image.
- * 
+ *
  * To avoid repeating this heavy load images can be cached.
  */
 typedef struct
 {
     lv_img_decoder_dsc_t dec_dsc; /**< Image information */
 
-    /** Count the cache entries's life. Add `time_tio_open` to `life` when the entry is used.
-     * Decrement all lifes by one every in every ::lv_img_cache_open.
-     * If life == 0 the entry can be reused */
-    int32_t life;
+    /** Value of a counter incremented in every ::lv_img_cache_open when the entry was used last.
+     * The unpinned entry with the smallest `life` is reused first */
+    uint32_t life;
+
+    uint32_t size;          /**< Bytes allocated for the entry: the decoded pixels and the copy of a file path*/
+    uint32_t hash;          /**< Hash of the source. Pointer of a variable, the file path's characters*/
+    uint16_t next;          /**< Next entry in the same hash bucket*/
+    uint8_t pinned;         /**< Number of `lv_img_cache_pin`s. >0: Don't reuse the entry for an other image*/
+    uint8_t own_pixels : 1; /**< 1: `dec_dsc.img_data` was read by the cache, the decoder is already closed*/
+    uint8_t pending : 1;    /**< 1: Being opened in the background. Only `dec_dsc.header` is valid*/
 } lv_img_cache_entry_t;
 
+/** Counters of the image cache*/
+typedef struct
+{
+    uint32_t hit;   /**< Opens served from the cache*/
+    uint32_t miss;  /**< Opens which needed a decoder*/
+    uint32_t evict; /**< Entries closed to make room for an other image or to fit in the budget*/
+    uint32_t size;  /**< Bytes held by the cache now*/
+    uint32_t async; /**< Opens done in the background*/
+    uint16_t used;  /**< Cached images now*/
+} lv_img_cache_stats_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -45,7 +63,11 @@ typedef struct
 /**
  * Open an image using the image decoder interface and cache it.
  * The image will be left open meaning if the image decoder open callback allocated memory then it will remain.
- * The image is closed if a new image is opened and the new image takes its place in the cache.
+ * The images of files and `LV_IMG_CF_RAW...` variables are decoded once into a pixel buffer if it fits
+ * in the budget, then the decoder is closed.
+ * The least recently used unpinned image is closed if a new image needs its place or the budget.
+ * With `LV_USE_IMG_CACHE_ASYNC` these images are opened in the background: the returned entry is `pending`
+ * until then and only its header can be used.
  * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
  * @param style style of the image
  * @return pointer to the cache entry or NULL if can open the image
@@ -61,12 +83,65 @@ lv_img_cache_entry_t * lv_img_cache_open(const void * src, const lv_style_t * st
 void lv_img_cache_set_size(uint16_t new_slot_num);
 
 /**
- * Invalidate an image source in the cache.
+ * Set how many bytes the cached images can hold (decoded pixels and file paths).
+ * The least recently used unpinned images are closed until they fit.
+ * @param budget bytes, 0: no limit, only the number of entries
+ */
+void lv_img_cache_set_budget(uint32_t budget);
+
+/**
+ * Invalidate an image source in the cache (even if it's pinned).
  * Useful if the image source is updated therefore it needs to be cached again.
  * @param src an image source path to a file or pointer to an `lv_img_dsc_t` variable.
  */
 void lv_img_cache_invalidate_src(const void * src);
 
+/**
+ * Open an image and keep it in the cache until `lv_img_cache_unpin`. For images drawn very often.
+ * The pins are counted, every successful pin needs an unpin.
+ * @param src source of the image. Path to file or pointer to an `lv_img_dsc_t` variable
+ * @param style style of the image
+ * @return LV_RES_OK: cached and pinned; LV_RES_INV: the image can't be opened or every entry is pinned
+ */
+lv_res_t lv_img_cache_pin(const void * src, const lv_style_t * style);
+
+/**
+ * Let an image pinned by `lv_img_cache_pin` be reused for other images
+ * @param src the source used in `lv_img_cache_pin`
+ */
+void lv_img_cache_unpin(const void * src);
+
+#if LV_USE_IMG_CACHE_ASYNC
+/**
+ * Enable or disable opening the images of files and `LV_IMG_CF_RAW...` variables in the background.
+ * The images already being opened are finished anyway.
+ * @param en true: open them in the background (default); false: open them while drawing
+ */
+void lv_img_cache_set_async(bool en);
+
+/**
+ * Draw the placeholder of an image being opened in the background.
+ * The area is invalidated when the image is ready. Called by the image drawing.
+ * @param entry a pending entry returned by `lv_img_cache_open`
+ * @param coords the coordinates of the image
+ * @param mask the placeholder will be drawn only in this area
+ * @param opa opacity of the placeholder
+ */
+void lv_img_cache_draw_placeholder(lv_img_cache_entry_t * entry, const lv_area_t * coords, const lv_area_t * mask,
+                                   lv_opa_t opa);
+#endif
+
+/**
+ * Get the counters of the image cache
+ * @param stats_p the counters are copied here
+ */
+void lv_img_cache_get_stats(lv_img_cache_stats_t * stats_p);
+
+/**
+ * Closes the least recently used unpinned images if the memory is low (see `lv_mem_shrinker_add`)
+ */
+extern const lv_mem_shrinker_t lv_img_cache_shrinker;
+
 /**********************
  *      MACROS
  **********************/
@@ -45,7 +45,7 @@ static lv_res_t lv_img_decoder_built_in_line_true_color(lv_img_decoder_dsc_t * d
 static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
                                                    lv_coord_t len, uint8_t * buf);
 static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                     lv_coord_t len, uint8_t * buf);
+                                                     lv_coord_t len, uint8_t * buf, const lv_color_t * palette);
 
 /**********************
  *  STATIC VARIABLES
@@ -64,7 +64,7 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
  * */
 void lv_img_decoder_init(void)
 {
-    lv_ll_init(&LV_GC_ROOT(_lv_img_defoder_ll), sizeof(lv_img_decoder_t));
+    lv_ll_init(&LV_GC_SHARED_ROOT(_lv_img_defoder_ll), sizeof(lv_img_decoder_t));
 
     lv_img_decoder_t * decoder;
 
@@ -95,7 +95,7 @@ lv_res_t lv_img_decoder_get_info(const char * src, lv_img_header_t * header)
 
     lv_res_t res = LV_RES_INV;
     lv_img_decoder_t * d;
-    LV_LL_READ(LV_GC_ROOT(_lv_img_defoder_ll), d)
+    LV_LL_READ(LV_GC_SHARED_ROOT(_lv_img_defoder_ll), d)
     {
         res = LV_RES_INV;
         if(d->info_cb) {
@@ -129,7 +129,7 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, const
     lv_res_t res = LV_RES_INV;
 
     lv_img_decoder_t * d;
-    LV_LL_READ(LV_GC_ROOT(_lv_img_defoder_ll), d)
+    LV_LL_READ(LV_GC_SHARED_ROOT(_lv_img_defoder_ll), d)
     {
         /*Info an Open callbacks are required*/
         if(d->info_cb == NULL || d->open_cb == NULL) continue;
@@ -171,6 +171,55 @@ lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_c
     return res;
 }
 
+/**
+ * Get the palette of an indexed image opened by the built-in decoder
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param size_p store the number of colors here
+ * @return the palette or NULL if the image isn't indexed or an other decoder opened it
+ */
+const lv_color_t * lv_img_decoder_get_palette(const lv_img_decoder_dsc_t * dsc, uint16_t * size_p)
+{
+#if LV_IMG_CF_INDEXED
+    if(dsc->decoder == NULL || dsc->decoder->read_line_cb != lv_img_decoder_built_in_read_line) return NULL;
+
+    lv_img_cf_t cf = dsc->header.cf;
+    if(cf != LV_IMG_CF_INDEXED_1BIT && cf != LV_IMG_CF_INDEXED_2BIT && cf != LV_IMG_CF_INDEXED_4BIT &&
+       cf != LV_IMG_CF_INDEXED_8BIT) {
+        return NULL;
+    }
+
+    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+    if(user_data == NULL || user_data->palette == NULL) return NULL;
+
+    *size_p = 1 << lv_img_color_format_get_px_size(cf);
+    return user_data->palette;
+#else
+    (void)dsc;
+    (void)size_p;
+    return NULL;
+#endif
+}
+
+/**
+ * Read a line of an indexed image opened by the built-in decoder with an other palette, e.g. a recolored copy.
+ * The image's palette isn't changed, so the drawing threads can read the same image with different palettes.
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top)
+ * @param len number of pixels to read
+ * @param buf store the data here
+ * @param palette as many colors as `lv_img_decoder_get_palette` tells
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred or `lv_img_decoder_get_palette` gives NULL
+ */
+lv_res_t lv_img_decoder_read_line_palette(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                          uint8_t * buf, const lv_color_t * palette)
+{
+    uint16_t size;
+    if(lv_img_decoder_get_palette(dsc, &size) == NULL) return LV_RES_INV;
+
+    return lv_img_decoder_built_in_line_indexed(dsc, x, y, len, buf, palette);
+}
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
@@ -187,7 +236,7 @@ void lv_img_decoder_close(lv_img_decoder_dsc_t * dsc)
 lv_img_decoder_t * lv_img_decoder_create(void)
 {
     lv_img_decoder_t * decoder;
-    decoder = lv_ll_ins_head(&LV_GC_ROOT(_lv_img_defoder_ll));
+    decoder = lv_ll_ins_head(&LV_GC_SHARED_ROOT(_lv_img_defoder_ll));
     lv_mem_assert(decoder);
     if(decoder == NULL) return NULL;
 
@@ -202,7 +251,7 @@ lv_img_decoder_t * lv_img_decoder_create(void)
  */
 void lv_img_decoder_delete(lv_img_decoder_t * decoder)
 {
-    lv_ll_rem(&LV_GC_ROOT(_lv_img_defoder_ll), decoder);
+    lv_ll_rem(&LV_GC_SHARED_ROOT(_lv_img_defoder_ll), decoder);
     lv_mem_free(decoder);
 }
 
@@ -345,6 +394,18 @@ static lv_res_t lv_img_decoder_built_in_open(lv_img_decoder_t * decoder, lv_img_
             dsc->img_data = ((lv_img_dsc_t *)dsc->src)->data;
             return LV_RES_OK;
         } else {
+#if LV_USE_FILESYSTEM
+            /*If the driver can map the file it's drawn in place like a variable*/
+            lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+            const void * map;
+            uint32_t map_size;
+            uint32_t px_size = lv_img_color_format_get_px_size(cf) >> 3;
+            if(lv_fs_map(user_data->f, &map, &map_size) == LV_FS_RES_OK &&
+               map_size >= 4 + (uint32_t)dsc->header.w * dsc->header.h * px_size) {
+                dsc->img_data = (const uint8_t *)map + 4; /*Skip the header*/
+                return LV_RES_OK;
+            }
+#endif
             /*If it's a file it need to be read line by line later*/
             dsc->img_data = NULL;
             return LV_RES_OK;
@@ -444,7 +505,8 @@ static lv_res_t lv_img_decoder_built_in_read_line(lv_img_decoder_t * decoder, lv
         res = lv_img_decoder_built_in_line_alpha(dsc, x, y, len, buf);
     } else if(dsc->header.cf == LV_IMG_CF_INDEXED_1BIT || dsc->header.cf == LV_IMG_CF_INDEXED_2BIT ||
               dsc->header.cf == LV_IMG_CF_INDEXED_4BIT || dsc->header.cf == LV_IMG_CF_INDEXED_8BIT) {
-        res = lv_img_decoder_built_in_line_indexed(dsc, x, y, len, buf);
+        lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+        res = lv_img_decoder_built_in_line_indexed(dsc, x, y, len, buf, user_data->palette);
     } else {
         LV_LOG_WARN("Built-in image decoder read not supports the color format");
         return LV_RES_INV;
@@ -568,7 +630,8 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
 
 #if LV_USE_FILESYSTEM
     lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
-    uint8_t fs_buf[LV_HOR_RES_MAX];
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
 #endif
 
     const uint8_t * data_tmp = NULL;
@@ -578,6 +641,9 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
         data_tmp = img_dsc->data + ofs;
     } else {
 #if LV_USE_FILESYSTEM
+        /*A whole row of the image, it can be wider than the screen*/
+        uint8_t * fs_buf = lv_draw_scratch_alloc(w);
+        if(fs_buf == NULL) return LV_RES_INV;
         lv_fs_seek(user_data->f, ofs + 4); /*+4 to skip the header*/
         lv_fs_read(user_data->f, fs_buf, w, NULL);
         data_tmp = fs_buf;
@@ -603,6 +669,9 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
         }
     }
 
+#if LV_USE_FILESYSTEM
+    lv_draw_scratch_release(&mark);
+#endif
     return LV_RES_OK;
 
 #else
@@ -612,7 +681,7 @@ static lv_res_t lv_img_decoder_built_in_line_alpha(lv_img_decoder_dsc_t * dsc, l
 }
 
 static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y,
-                                                     lv_coord_t len, uint8_t * buf)
+                                                     lv_coord_t len, uint8_t * buf, const lv_color_t * palette)
 {
 
 #if LV_IMG_CF_INDEXED
@@ -652,10 +721,10 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
             break;
     }
 
-    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
-
 #if LV_USE_FILESYSTEM
-    uint8_t fs_buf[LV_HOR_RES_MAX];
+    lv_img_decoder_built_in_data_t * user_data = dsc->user_data;
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
 #endif
     const uint8_t * data_tmp = NULL;
     if(dsc->src_type == LV_IMG_SRC_VARIABLE) {
@@ -663,6 +732,9 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
         data_tmp                     = img_dsc->data + ofs;
     } else {
 #if LV_USE_FILESYSTEM
+        /*A whole row of the image, it can be wider than the screen*/
+        uint8_t * fs_buf = lv_draw_scratch_alloc(w);
+        if(fs_buf == NULL) return LV_RES_INV;
         lv_fs_seek(user_data->f, ofs + 4); /*+4 to skip the header*/
         lv_fs_read(user_data->f, fs_buf, w, NULL);
         data_tmp = fs_buf;
@@ -679,7 +751,7 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
     lv_color_t * cbuf = (lv_color_t *)buf;
     for(i = 0; i < len; i++) {
         val_act = (data_tmp[byte_act] & (mask << pos)) >> pos;
-        cbuf[i] = user_data->palette[val_act];
+        cbuf[i] = palette[val_act];
 
         pos -= px_size;
         if(pos < 0) {
@@ -688,8 +760,12 @@ static lv_res_t lv_img_decoder_built_in_line_indexed(lv_img_decoder_dsc_t * dsc,
         }
     }
 
+#if LV_USE_FILESYSTEM
+    lv_draw_scratch_release(&mark);
+#endif
     return LV_RES_OK;
 #else
+    (void)palette;
     LV_LOG_WARN("Image built-in indexed line reader failed because LV_IMG_CF_INDEXED is 0 in lv_conf.h");
     return LV_RES_INV;
 #endif
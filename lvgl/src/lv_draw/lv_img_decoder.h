@@ -241,6 +241,28 @@ lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t * dsc, const void * src, const
 lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
                                   uint8_t * buf);
 
+/**
+ * Get the palette of an indexed image opened by the built-in decoder
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param size_p store the number of colors here
+ * @return the palette or NULL if the image isn't indexed or an other decoder opened it
+ */
+const lv_color_t * lv_img_decoder_get_palette(const lv_img_decoder_dsc_t * dsc, uint16_t * size_p);
+
+/**
+ * Read a line of an indexed image opened by the built-in decoder with an other palette, e.g. a recolored copy.
+ * The image's palette isn't changed, so the drawing threads can read the same image with different palettes.
+ * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
+ * @param x start X coordinate (from left)
+ * @param y start Y coordinate (from top)
+ * @param len number of pixels to read
+ * @param buf store the data here
+ * @param palette as many colors as `lv_img_decoder_get_palette` tells
+ * @return LV_RES_OK: success; LV_RES_INV: an error occurred or `lv_img_decoder_get_palette` gives NULL
+ */
+lv_res_t lv_img_decoder_read_line_palette(lv_img_decoder_dsc_t * dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                          uint8_t * buf, const lv_color_t * palette);
+
 /**
  * Close a decoding session
  * @param dsc pointer to `lv_img_decoder_dsc_t` used in `lv_img_decoder_open`
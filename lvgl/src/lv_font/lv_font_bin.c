@@ -0,0 +1,787 @@
+/**
+ * @file lv_font_bin.c
+ * Fonts loaded from files. The file mirrors `lv_font_fmt_txt_dsc_t`, little endian:
+ *
+ *   header  "LVFB", u16 version, u8 line_height, u8 base_line, u8 bpp, u8 kern type (0: none, 1: pairs, 2: classes),
+ *           u16 kern_scale, u16 cmap_num, u16 0, u32 glyph_cnt, u32 tables_size, u32 bitmap_size
+ *   tables  cmap_num * {u32 range_start, u16 range_length, u16 glyph_id_start, u16 list_length, u8 type, u8 0}
+ *           the lists of every cmap: `unicode_list` (sparse), `glyph_id_ofs_list` (full)
+ *           glyph_cnt * {u32 bitmap offset, u16 adv_w, u8 box_w, u8 box_h, i8 ofs_x, u8 ofs_y, u16 0}
+ *           kern pairs: u32 pair_cnt, u8 glyph_ids_size, 3 * u8 0, glyph_ids, values
+ *           kern classes: u8 left_class_cnt, u8 right_class_cnt, u16 0, left and right mapping, class_pair_values
+ *   bitmaps bitmap_size bytes, a glyph's bitmap is at its offset
+ *
+ * Every list in the tables starts on a 4 byte boundary. Only the tables are loaded, they are used in place.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_font_bin.h"
+#if LV_USE_FONT_BIN
+
+#include <string.h>
+#include "lv_font_fmt_txt.h"
+#include "../lv_misc/lv_fs.h"
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_thread.h"
+#include "../lv_draw/lv_draw_basic.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define BIN_MAGIC "LVFB"
+#define BIN_VERSION 1
+#define BIN_HEADER_SIZE 28
+#define BIN_CMAP_SIZE 12
+#define BIN_GLYPH_SIZE 12
+
+#define KERN_NONE 0
+#define KERN_PAIRS 1
+#define KERN_CLASSES 2
+
+/*Slots of the bitmap cache. Must be a power of 2.*/
+#define CACHE_SLOTS 256
+
+/*A bitmap can be stored in this many slots after its hashed slot*/
+#define CACHE_PROBE 8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    lv_font_t font; /*First, so the font's pointer is the pointer of the whole*/
+    lv_font_fmt_txt_dsc_t fdsc;
+    lv_font_fmt_txt_kern_pair_t kern_pair;
+    lv_font_fmt_txt_kern_classes_t kern_classes;
+    lv_fs_file_t file;
+    uint8_t * tables;          /*The loaded tables, the lists of `fdsc` point into it*/
+    lv_font_fmt_txt_cmap_t * cmaps;
+    lv_font_fmt_txt_glyph_dsc_t * glyph_dsc;
+    uint32_t * bitmap_ofs;     /*Per glyph. `bitmap_index` of `glyph_dsc` has only 20 bits.*/
+    uint32_t glyph_cnt;
+    uint32_t bitmap_start;     /*File position of the bitmaps*/
+    uint32_t bitmap_size;
+} lv_font_bin_t;
+
+typedef struct
+{
+    const lv_font_t * font; /*NULL: unused slot*/
+    uint32_t gid;
+    uint32_t life;          /*`cache_life` when the bitmap was used last time*/
+    uint32_t size;
+    uint8_t * bitmap;
+} lv_font_bin_cache_entry_t;
+
+/*Reads the tables with bound checks*/
+typedef struct
+{
+    uint8_t * buf;
+    uint32_t size;
+    uint32_t pos;
+} bin_cursor_t;
+
+typedef struct
+{
+    lv_fs_file_t file;
+    uint32_t pos;
+    bool err;
+} bin_writer_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static const uint8_t * get_bitmap(const lv_font_t * font, uint32_t unicode_letter);
+static bool tables_parse(lv_font_bin_t * fb, uint16_t cmap_num, uint8_t kern_type);
+static uint8_t * cursor_take(bin_cursor_t * c, uint32_t len);
+static void u16_list_convert(uint8_t * p, uint32_t cnt);
+static uint32_t glyph_bitmap_size(const lv_font_fmt_txt_glyph_dsc_t * gdsc, uint8_t bpp);
+static lv_font_bin_cache_entry_t * cache_find(const lv_font_t * font, uint32_t gid);
+static void cache_add(const lv_font_t * font, uint32_t gid, const uint8_t * bitmap, uint32_t size);
+static void cache_evict(lv_font_bin_cache_entry_t * e);
+static bool cache_evict_lru(void);
+static uint32_t shrinker_size_cb(void);
+static uint32_t shrinker_shrink_cb(uint32_t size);
+static uint32_t cache_hash(const lv_font_t * font, uint32_t gid);
+static uint32_t save_glyph_cnt(const lv_font_fmt_txt_dsc_t * fdsc);
+static void save_tables(bin_writer_t * w, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_cnt, uint8_t kern_type);
+static void wr_bytes(bin_writer_t * w, const void * data, uint32_t len);
+static void wr_u8(bin_writer_t * w, uint8_t v);
+static void wr_u16(bin_writer_t * w, uint16_t v);
+static void wr_u32(bin_writer_t * w, uint32_t v);
+static void wr_pad(bin_writer_t * w);
+static uint16_t rd_u16(const uint8_t * p);
+static uint32_t rd_u32(const uint8_t * p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_font_bin_cache_entry_t cache[CACHE_SLOTS];
+static uint32_t cache_life;
+static uint32_t cache_budget = LV_FONT_BIN_CACHE_BUDGET;
+static lv_font_bin_stats_t cache_stats;
+
+/*The bitmap returned to a drawing thread. It's its own copy so an other thread can't evict it while it's used.*/
+static LV_THREAD_LOCAL uint8_t * ret_buf;
+static LV_THREAD_LOCAL uint32_t ret_buf_size;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *  GLOBAL VARIABLES
+ **********************/
+const lv_mem_shrinker_t lv_font_bin_cache_shrinker = {"font_bin_cache", shrinker_size_cb, shrinker_shrink_cb};
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Load a font from a file written by `lv_font_bin_save`.
+ * The file stays open until `lv_font_bin_free`, the glyph bitmaps are read from it on demand.
+ * @param path path of the file, e.g. "S:/fonts/cjk_24.bin"
+ * @return pointer to the new font or NULL if the file can't be opened or isn't a valid font
+ */
+lv_font_t * lv_font_bin_load(const char * path)
+{
+    lv_font_bin_t * fb = lv_mem_alloc(sizeof(lv_font_bin_t));
+    if(fb == NULL) return NULL;
+    memset(fb, 0, sizeof(lv_font_bin_t));
+
+    if(lv_fs_open(&fb->file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        LV_LOG_WARN("lv_font_bin_load: can't open the file");
+        lv_mem_free(fb);
+        return NULL;
+    }
+
+    uint8_t h[BIN_HEADER_SIZE];
+    uint32_t br = 0;
+    lv_fs_read(&fb->file, h, BIN_HEADER_SIZE, &br);
+    uint8_t bpp          = h[8];
+    uint8_t kern_type    = h[9];
+    uint16_t cmap_num    = rd_u16(&h[12]);
+    uint32_t tables_size = rd_u32(&h[20]);
+    if(br != BIN_HEADER_SIZE || memcmp(h, BIN_MAGIC, 4) != 0 || rd_u16(&h[4]) != BIN_VERSION ||
+       (bpp != 1 && bpp != 2 && bpp != 4) || kern_type > KERN_CLASSES || cmap_num >= (1 << 10)) {
+        LV_LOG_WARN("lv_font_bin_load: not a font file or an other version");
+        lv_fs_close(&fb->file);
+        lv_mem_free(fb);
+        return NULL;
+    }
+
+    fb->glyph_cnt    = rd_u32(&h[16]);
+    fb->bitmap_start = BIN_HEADER_SIZE + tables_size;
+    fb->bitmap_size  = rd_u32(&h[24]);
+
+    fb->fdsc.bpp          = bpp;
+    fb->fdsc.kern_scale   = rd_u16(&h[10]);
+    fb->fdsc.cmap_num     = cmap_num;
+    fb->fdsc.kern_classes = kern_type == KERN_CLASSES ? 1 : 0;
+    fb->fdsc.bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+    fb->fdsc.last_letter  = 0xFFFFFFFF; /*Not a letter, so the glyph ID cache starts empty*/
+
+    bool ok = false;
+    fb->tables = lv_mem_alloc(tables_size > 0 ? tables_size : 1);
+    if(fb->tables) {
+        br = 0;
+        lv_fs_read(&fb->file, fb->tables, tables_size, &br);
+        ok = br == tables_size && tables_parse(fb, cmap_num, kern_type);
+    }
+
+    if(!ok) {
+        LV_LOG_WARN("lv_font_bin_load: invalid or truncated font file");
+        lv_font_bin_free(&fb->font);
+        return NULL;
+    }
+
+    fb->font.get_glyph_dsc    = lv_font_get_glyph_dsc_fmt_txt;
+    fb->font.get_glyph_bitmap = get_bitmap;
+    fb->font.line_height      = h[6];
+    fb->font.base_line        = h[7];
+    fb->font.dsc              = &fb->fdsc;
+
+#if LV_FONT_FMT_TXT_ACCEL
+    /*Optional: without the tables the glyphs are searched in the character maps*/
+    lv_font_fmt_txt_accel_build(&fb->font);
+#endif
+
+    return &fb->font;
+}
+
+/**
+ * Close a font loaded with `lv_font_bin_load` and free its memory.
+ * The objects using it should be deleted or get an other font before.
+ * @param font pointer to the font
+ */
+void lv_font_bin_free(lv_font_t * font)
+{
+    if(font == NULL) return;
+    lv_font_bin_t * fb = (lv_font_bin_t *)font;
+
+#if LV_GLYPH_CACHE_SIZE
+    lv_draw_letter_cache_invalidate(font);
+#endif
+
+    lv_thread_lock();
+    uint32_t i;
+    for(i = 0; i < CACHE_SLOTS; i++) {
+        if(cache[i].font == font) cache_evict(&cache[i]);
+    }
+    lv_thread_unlock();
+
+#if LV_FONT_FMT_TXT_ACCEL
+    if(fb->fdsc.accel) lv_font_fmt_txt_accel_free(font);
+#endif
+
+    lv_fs_close(&fb->file);
+    if(fb->tables) lv_mem_free(fb->tables);
+    if(fb->cmaps) lv_mem_free(fb->cmaps);
+    if(fb->glyph_dsc) lv_mem_free(fb->glyph_dsc);
+    if(fb->bitmap_ofs) lv_mem_free(fb->bitmap_ofs);
+    lv_mem_free(fb);
+}
+
+/**
+ * Write a font in the LittlevGL's format (`lv_font_fmt_txt_dsc_t` with plain bitmaps) into a file
+ * which can be loaded with `lv_font_bin_load`, e.g. to move a compiled-in font onto the file system.
+ * @param font pointer to the font
+ * @param path path of the new file
+ * @return LV_RES_OK: written; LV_RES_INV: not a plain `lv_font_fmt_txt` font or the file couldn't be written
+ */
+lv_res_t lv_font_bin_save(const lv_font_t * font, const char * path)
+{
+    if(font->get_glyph_dsc != lv_font_get_glyph_dsc_fmt_txt) return LV_RES_INV;
+    const lv_font_fmt_txt_dsc_t * fdsc = font->dsc;
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) return LV_RES_INV;
+
+    uint32_t glyph_cnt   = save_glyph_cnt(fdsc);
+    uint32_t bitmap_size = 0;
+    uint32_t i;
+    for(i = 0; i < glyph_cnt; i++) {
+        uint32_t end = fdsc->glyph_dsc[i].bitmap_index + glyph_bitmap_size(&fdsc->glyph_dsc[i], fdsc->bpp);
+        if(end > bitmap_size) bitmap_size = end;
+    }
+
+    uint8_t kern_type = KERN_NONE;
+    if(fdsc->kern_dsc) kern_type = fdsc->kern_classes ? KERN_CLASSES : KERN_PAIRS;
+
+    bin_writer_t w;
+    w.pos = 0;
+    w.err = false;
+    if(lv_fs_open(&w.file, path, LV_FS_MODE_WR) != LV_FS_RES_OK) return LV_RES_INV;
+
+    /*The header is written again when the size of the tables is known*/
+    uint8_t h[BIN_HEADER_SIZE];
+    memset(h, 0, sizeof(h));
+    wr_bytes(&w, h, BIN_HEADER_SIZE);
+    save_tables(&w, fdsc, glyph_cnt, kern_type);
+    uint32_t tables_size = w.pos - BIN_HEADER_SIZE;
+    if(bitmap_size) wr_bytes(&w, fdsc->glyph_bitmap, bitmap_size);
+
+    if(lv_fs_seek(&w.file, 0) != LV_FS_RES_OK) w.err = true;
+    wr_bytes(&w, BIN_MAGIC, 4);
+    wr_u16(&w, BIN_VERSION);
+    wr_u8(&w, font->line_height);
+    wr_u8(&w, font->base_line);
+    wr_u8(&w, fdsc->bpp);
+    wr_u8(&w, kern_type);
+    wr_u16(&w, fdsc->kern_scale);
+    wr_u16(&w, fdsc->cmap_num);
+    wr_u16(&w, 0);
+    wr_u32(&w, glyph_cnt);
+    wr_u32(&w, tables_size);
+    wr_u32(&w, bitmap_size);
+
+    if(lv_fs_close(&w.file) != LV_FS_RES_OK) w.err = true;
+    if(w.err) lv_fs_remove(path);
+    return w.err ? LV_RES_INV : LV_RES_OK;
+}
+
+/**
+ * Set how many bytes the cached glyph bitmaps of the loaded fonts can take.
+ * The least recently used bitmaps are dropped until they fit.
+ * @param budget bytes, 0: don't cache, read every bitmap from the file
+ */
+void lv_font_bin_set_budget(uint32_t budget)
+{
+    lv_thread_lock();
+    cache_budget = budget;
+    while(cache_stats.size > cache_budget && cache_evict_lru());
+    lv_thread_unlock();
+}
+
+/**
+ * Get the counters of the glyph bitmap cache
+ * @param stats_p the counters are copied here
+ */
+void lv_font_bin_get_stats(lv_font_bin_stats_t * stats_p)
+{
+    lv_thread_lock();
+    *stats_p = cache_stats;
+    lv_thread_unlock();
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * The `get_glyph_bitmap` of the loaded fonts. Reads the bitmap from the file if it's not cached.
+ * @param font pointer to the font
+ * @param unicode_letter an unicode letter
+ * @return the bitmap, valid until the next call on the same thread. NULL if not found or can't be read.
+ */
+static const uint8_t * get_bitmap(const lv_font_t * font, uint32_t unicode_letter)
+{
+    lv_font_bin_t * fb = (lv_font_bin_t *)font;
+    uint32_t gid       = lv_font_fmt_txt_get_glyph_id(font, unicode_letter);
+    if(gid == 0 || gid >= fb->glyph_cnt) return NULL;
+
+    uint32_t size = glyph_bitmap_size(&fb->glyph_dsc[gid], fb->fdsc.bpp);
+    if(size == 0) return fb->tables; /*E.g. a space. Not read, any pointer will do.*/
+
+    const uint8_t * res = NULL;
+
+    lv_thread_lock();
+    if(ret_buf_size < size) {
+        uint8_t * buf = lv_mem_realloc(ret_buf, size);
+        if(buf) {
+            ret_buf      = buf;
+            ret_buf_size = size;
+        }
+    }
+
+    if(ret_buf_size >= size) {
+        lv_font_bin_cache_entry_t * e = cache_find(font, gid);
+        if(e) {
+            cache_stats.hit++;
+            e->life = ++cache_life;
+            memcpy(ret_buf, e->bitmap, size);
+            res = ret_buf;
+        } else {
+            cache_stats.miss++;
+            uint32_t br = 0;
+            if(lv_fs_seek(&fb->file, fb->bitmap_start + fb->bitmap_ofs[gid]) == LV_FS_RES_OK &&
+               lv_fs_read(&fb->file, ret_buf, size, &br) == LV_FS_RES_OK && br == size) {
+                cache_add(font, gid, ret_buf, size);
+                res = ret_buf;
+            }
+        }
+    }
+    lv_thread_unlock();
+
+    return res;
+}
+
+/**
+ * Build `fdsc` from the loaded tables
+ * @param fb the font being loaded, `tables` is read
+ * @param cmap_num number of the character maps
+ * @param kern_type KERN_NONE/PAIRS/CLASSES
+ * @return true: the tables are valid
+ */
+static bool tables_parse(lv_font_bin_t * fb, uint16_t cmap_num, uint8_t kern_type)
+{
+    bin_cursor_t c;
+    c.buf  = fb->tables;
+    c.size = fb->bitmap_start - BIN_HEADER_SIZE;
+    c.pos  = 0;
+
+    fb->cmaps = lv_mem_alloc(cmap_num > 0 ? cmap_num * sizeof(lv_font_fmt_txt_cmap_t) : 1);
+    if(fb->cmaps == NULL) return false;
+    const uint8_t * rec = cursor_take(&c, cmap_num * BIN_CMAP_SIZE);
+    if(rec == NULL) return false;
+
+    uint16_t i;
+    for(i = 0; i < cmap_num; i++, rec += BIN_CMAP_SIZE) {
+        lv_font_fmt_txt_cmap_t * cm = &fb->cmaps[i];
+        memset(cm, 0, sizeof(lv_font_fmt_txt_cmap_t));
+        cm->range_start    = rd_u32(&rec[0]);
+        cm->range_length   = rd_u16(&rec[4]);
+        cm->glyph_id_start = rd_u16(&rec[6]);
+        cm->list_length    = rd_u16(&rec[8]);
+        cm->type           = rec[10];
+
+        bool sparse = cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL;
+        if(sparse) {
+            uint8_t * list = cursor_take(&c, cm->list_length * sizeof(uint16_t));
+            if(list == NULL) return false;
+            u16_list_convert(list, cm->list_length);
+            cm->unicode_list = (uint16_t *)list;
+        }
+        if(cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+            /*Indexed by the relative code point*/
+            if(cm->list_length < cm->range_length) return false;
+            cm->glyph_id_ofs_list = cursor_take(&c, cm->list_length);
+            if(cm->glyph_id_ofs_list == NULL) return false;
+        } else if(cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+            uint8_t * list = cursor_take(&c, cm->list_length * sizeof(uint16_t));
+            if(list == NULL) return false;
+            u16_list_convert(list, cm->list_length);
+            cm->glyph_id_ofs_list = list;
+        }
+    }
+
+    rec = cursor_take(&c, fb->glyph_cnt * BIN_GLYPH_SIZE);
+    if(rec == NULL || fb->glyph_cnt == 0) return false;
+    fb->glyph_dsc  = lv_mem_alloc(fb->glyph_cnt * sizeof(lv_font_fmt_txt_glyph_dsc_t));
+    fb->bitmap_ofs = lv_mem_alloc(fb->glyph_cnt * sizeof(uint32_t));
+    if(fb->glyph_dsc == NULL || fb->bitmap_ofs == NULL) return false;
+
+    uint32_t g;
+    for(g = 0; g < fb->glyph_cnt; g++, rec += BIN_GLYPH_SIZE) {
+        lv_font_fmt_txt_glyph_dsc_t * gdsc = &fb->glyph_dsc[g];
+        gdsc->bitmap_index = 0; /*The bitmaps aren't in memory, see `bitmap_ofs`*/
+        gdsc->adv_w        = rd_u16(&rec[4]);
+        gdsc->box_w        = rec[6];
+        gdsc->box_h        = rec[7];
+        gdsc->ofs_x        = (int8_t)rec[8];
+        gdsc->ofs_y        = rec[9];
+        fb->bitmap_ofs[g]  = rd_u32(&rec[0]);
+        if(fb->bitmap_ofs[g] + glyph_bitmap_size(gdsc, fb->fdsc.bpp) > fb->bitmap_size) return false;
+    }
+
+    if(kern_type == KERN_PAIRS) {
+        rec = cursor_take(&c, 8);
+        if(rec == NULL || rec[4] > 1) return false;
+        lv_font_fmt_txt_kern_pair_t * kp = &fb->kern_pair;
+        kp->pair_cnt       = rd_u32(&rec[0]);
+        kp->glyph_ids_size = rec[4];
+        uint8_t * ids      = cursor_take(&c, kp->pair_cnt * 2 * (kp->glyph_ids_size ? 2 : 1));
+        if(ids == NULL) return false;
+        if(kp->glyph_ids_size) u16_list_convert(ids, kp->pair_cnt * 2);
+        kp->glyph_ids = ids;
+        kp->values    = (const int8_t *)cursor_take(&c, kp->pair_cnt);
+        if(kp->values == NULL) return false;
+        fb->fdsc.kern_dsc = kp;
+    } else if(kern_type == KERN_CLASSES) {
+        rec = cursor_take(&c, 4);
+        if(rec == NULL) return false;
+        lv_font_fmt_txt_kern_classes_t * kc = &fb->kern_classes;
+        kc->left_class_cnt      = rec[0];
+        kc->right_class_cnt     = rec[1];
+        kc->left_class_mapping  = cursor_take(&c, fb->glyph_cnt);
+        kc->right_class_mapping = cursor_take(&c, fb->glyph_cnt);
+        kc->class_pair_values   = cursor_take(&c, kc->left_class_cnt * kc->right_class_cnt);
+        if(kc->left_class_mapping == NULL || kc->right_class_mapping == NULL || kc->class_pair_values == NULL) {
+            return false;
+        }
+        fb->fdsc.kern_dsc = kc;
+    }
+
+    fb->fdsc.cmaps     = fb->cmaps;
+    fb->fdsc.glyph_dsc = fb->glyph_dsc;
+    return true;
+}
+
+/**
+ * Take the next list of the tables. Lists start on a 4 byte boundary.
+ * @param c pointer to a cursor
+ * @param len length of the list in bytes
+ * @return pointer to the list or NULL if it's out of the tables
+ */
+static uint8_t * cursor_take(bin_cursor_t * c, uint32_t len)
+{
+    if(c->pos > c->size || len > c->size - c->pos) return NULL;
+
+    uint8_t * p = &c->buf[c->pos];
+    c->pos += (len + 3) & ~0x3U;
+    if(c->pos > c->size) c->pos = c->size;
+    return p;
+}
+
+/**
+ * Convert a little endian `uint16_t` list in place to the byte order of the CPU
+ * @param p the list, 2 byte aligned
+ * @param cnt number of the elements
+ */
+static void u16_list_convert(uint8_t * p, uint32_t cnt)
+{
+    uint16_t * p16 = (uint16_t *)p;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) p16[i] = rd_u16(&p[i * 2]);
+}
+
+/**
+ * Size of a glyph's bitmap. Its rows are continuous (not aligned to bytes).
+ * @param gdsc descriptor of the glyph
+ * @param bpp bit-per-pixel of the font
+ * @return the size in bytes
+ */
+static uint32_t glyph_bitmap_size(const lv_font_fmt_txt_glyph_dsc_t * gdsc, uint8_t bpp)
+{
+    return ((uint32_t)gdsc->box_w * gdsc->box_h * bpp + 7) >> 3;
+}
+
+/**
+ * Find a cached bitmap. Only with the lock taken.
+ * @param font pointer to a font
+ * @param gid ID of the glyph
+ * @return the entry or NULL if not cached
+ */
+static lv_font_bin_cache_entry_t * cache_find(const lv_font_t * font, uint32_t gid)
+{
+    uint32_t slot = cache_hash(font, gid);
+    uint32_t i;
+    for(i = 0; i < CACHE_PROBE; i++) {
+        lv_font_bin_cache_entry_t * e = &cache[(slot + i) & (CACHE_SLOTS - 1)];
+        if(e->font == font && e->gid == gid) return e;
+    }
+    return NULL;
+}
+
+/**
+ * Cache a bitmap read from the file. Only with the lock taken.
+ * The least recently used bitmaps are dropped to fit in the budget.
+ * @param font pointer to a font
+ * @param gid ID of the glyph
+ * @param bitmap the bitmap to copy
+ * @param size size of the bitmap
+ */
+static void cache_add(const lv_font_t * font, uint32_t gid, const uint8_t * bitmap, uint32_t size)
+{
+    if(size == 0 || size > cache_budget) return;
+
+    while(cache_stats.size + size > cache_budget && cache_evict_lru());
+
+    /*A free slot of the probe window or its least recently used one*/
+    uint32_t slot = cache_hash(font, gid);
+    lv_font_bin_cache_entry_t * e = NULL;
+    uint32_t i;
+    for(i = 0; i < CACHE_PROBE; i++) {
+        lv_font_bin_cache_entry_t * s = &cache[(slot + i) & (CACHE_SLOTS - 1)];
+        if(s->font == NULL) {
+            e = s;
+            break;
+        }
+        if(e == NULL || s->life < e->life) e = s;
+    }
+    if(e->font) cache_evict(e);
+
+    e->bitmap = lv_mem_alloc(size);
+    if(e->bitmap == NULL) return;
+    memcpy(e->bitmap, bitmap, size);
+    e->font = font;
+    e->gid  = gid;
+    e->size = size;
+    e->life = ++cache_life;
+    cache_stats.size += size;
+    cache_stats.used++;
+}
+
+/**
+ * Drop a cached bitmap. Only with the lock taken.
+ * @param e pointer to a used entry
+ */
+static void cache_evict(lv_font_bin_cache_entry_t * e)
+{
+    lv_mem_free(e->bitmap);
+    cache_stats.size -= e->size;
+    cache_stats.used--;
+    cache_stats.evict++;
+    memset(e, 0, sizeof(lv_font_bin_cache_entry_t));
+}
+
+/**
+ * Drop the least recently used bitmap. Only with the lock taken.
+ * @return false: the cache was empty
+ */
+static bool cache_evict_lru(void)
+{
+    lv_font_bin_cache_entry_t * lru = NULL;
+    uint32_t i;
+    for(i = 0; i < CACHE_SLOTS; i++) {
+        if(cache[i].font == NULL) continue;
+        if(lru == NULL || cache[i].life < lru->life) lru = &cache[i];
+    }
+    if(lru == NULL) return false;
+
+    cache_evict(lru);
+    return true;
+}
+
+/**
+ * The bytes `lv_font_bin_cache_shrinker` can give back: the cached bitmaps
+ */
+static uint32_t shrinker_size_cb(void)
+{
+    return cache_stats.size;
+}
+
+/**
+ * Drop the least recently used bitmaps until `size` bytes are freed. Called with the lock taken.
+ * @param size bytes to free
+ * @return the freed bytes
+ */
+static uint32_t shrinker_shrink_cb(uint32_t size)
+{
+    uint32_t size_start = cache_stats.size;
+    while(size_start - cache_stats.size < size && cache_evict_lru());
+
+    return size_start - cache_stats.size;
+}
+
+static uint32_t cache_hash(const lv_font_t * font, uint32_t gid)
+{
+    uint32_t h = (uint32_t)((uintptr_t)font >> 3) * 2654435761U;
+    return (h ^ (gid * 40503U)) & (CACHE_SLOTS - 1);
+}
+
+/**
+ * The number of glyphs of a font: the largest glyph ID of its character maps + 1
+ * @param fdsc descriptor of the font
+ * @return number of the glyph descriptors
+ */
+static uint32_t save_glyph_cnt(const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    uint32_t max = 0;
+    uint16_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        uint32_t last = 0;
+        uint32_t k;
+        switch(cm->type) {
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY: last = cm->range_length ? cm->range_length - 1 : 0; break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_TINY: last = cm->list_length ? cm->list_length - 1 : 0; break;
+            case LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL:
+                for(k = 0; k < cm->list_length; k++) {
+                    uint8_t ofs = ((const uint8_t *)cm->glyph_id_ofs_list)[k];
+                    if(ofs > last) last = ofs;
+                }
+                break;
+            case LV_FONT_FMT_TXT_CMAP_SPARSE_FULL:
+                for(k = 0; k < cm->list_length; k++) {
+                    uint16_t ofs = ((const uint16_t *)cm->glyph_id_ofs_list)[k];
+                    if(ofs > last) last = ofs;
+                }
+                break;
+        }
+        if(cm->glyph_id_start + last > max) max = cm->glyph_id_start + last;
+    }
+    return max + 1;
+}
+
+/**
+ * Write the tables of a font
+ * @param w pointer to a writer
+ * @param fdsc descriptor of the font
+ * @param glyph_cnt number of glyph descriptors to write
+ * @param kern_type KERN_NONE/PAIRS/CLASSES
+ */
+static void save_tables(bin_writer_t * w, const lv_font_fmt_txt_dsc_t * fdsc, uint32_t glyph_cnt, uint8_t kern_type)
+{
+    uint16_t i;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        wr_u32(w, cm->range_start);
+        wr_u16(w, cm->range_length);
+        wr_u16(w, cm->glyph_id_start);
+        wr_u16(w, cm->list_length);
+        wr_u8(w, cm->type);
+        wr_u8(w, 0);
+    }
+
+    uint32_t k;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        if(cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_TINY || cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+            for(k = 0; k < cm->list_length; k++) wr_u16(w, cm->unicode_list[k]);
+            wr_pad(w);
+        }
+        if(cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+            wr_bytes(w, cm->glyph_id_ofs_list, cm->list_length);
+            wr_pad(w);
+        } else if(cm->type == LV_FONT_FMT_TXT_CMAP_SPARSE_FULL) {
+            for(k = 0; k < cm->list_length; k++) wr_u16(w, ((const uint16_t *)cm->glyph_id_ofs_list)[k]);
+            wr_pad(w);
+        }
+    }
+
+    for(k = 0; k < glyph_cnt; k++) {
+        const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[k];
+        wr_u32(w, gdsc->bitmap_index);
+        wr_u16(w, gdsc->adv_w);
+        wr_u8(w, gdsc->box_w);
+        wr_u8(w, gdsc->box_h);
+        wr_u8(w, (uint8_t)gdsc->ofs_x);
+        wr_u8(w, gdsc->ofs_y);
+        wr_u16(w, 0);
+    }
+
+    if(kern_type == KERN_PAIRS) {
+        const lv_font_fmt_txt_kern_pair_t * kp = fdsc->kern_dsc;
+        wr_u32(w, kp->pair_cnt);
+        wr_u32(w, kp->glyph_ids_size);
+        if(kp->glyph_ids_size) {
+            for(k = 0; k < kp->pair_cnt * 2; k++) wr_u16(w, ((const uint16_t *)kp->glyph_ids)[k]);
+        } else {
+            wr_bytes(w, kp->glyph_ids, kp->pair_cnt * 2);
+        }
+        wr_pad(w);
+        wr_bytes(w, kp->values, kp->pair_cnt);
+        wr_pad(w);
+    } else if(kern_type == KERN_CLASSES) {
+        const lv_font_fmt_txt_kern_classes_t * kc = fdsc->kern_dsc;
+        wr_u8(w, kc->left_class_cnt);
+        wr_u8(w, kc->right_class_cnt);
+        wr_u16(w, 0);
+        wr_bytes(w, kc->left_class_mapping, glyph_cnt);
+        wr_pad(w);
+        wr_bytes(w, kc->right_class_mapping, glyph_cnt);
+        wr_pad(w);
+        wr_bytes(w, kc->class_pair_values, kc->left_class_cnt * kc->right_class_cnt);
+        wr_pad(w);
+    }
+}
+
+static void wr_bytes(bin_writer_t * w, const void * data, uint32_t len)
+{
+    if(w->err || len == 0) return;
+
+    uint32_t bw = 0;
+    if(lv_fs_write(&w->file, data, len, &bw) != LV_FS_RES_OK || bw != len) w->err = true;
+    w->pos += len;
+}
+
+static void wr_u8(bin_writer_t * w, uint8_t v)
+{
+    wr_bytes(w, &v, 1);
+}
+
+static void wr_u16(bin_writer_t * w, uint16_t v)
+{
+    uint8_t b[2] = {v & 0xFF, v >> 8};
+    wr_bytes(w, b, 2);
+}
+
+static void wr_u32(bin_writer_t * w, uint32_t v)
+{
+    uint8_t b[4] = {v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24};
+    wr_bytes(w, b, 4);
+}
+
+/**
+ * Fill up to the next 4 byte boundary, where the next list starts
+ * @param w pointer to a writer
+ */
+static void wr_pad(bin_writer_t * w)
+{
+    static const uint8_t zeros[3] = {0, 0, 0};
+    wr_bytes(w, zeros, (4 - (w->pos & 0x3)) & 0x3);
+}
+
+static uint16_t rd_u16(const uint8_t * p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t * p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#endif /*LV_USE_FONT_BIN*/
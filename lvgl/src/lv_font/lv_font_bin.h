@@ -0,0 +1,110 @@
+/**
+ * @file lv_font_bin.h
+ * Fonts loaded from files in the layout of `lv_font_fmt_txt_dsc_t`.
+ * The character maps, the glyph descriptors and the kerning are loaded into RAM,
+ * the glyph bitmaps are read through `lv_fs` when they are drawn and kept in a cache with a byte budget.
+ */
+
+#ifndef LV_FONT_BIN_H
+#define LV_FONT_BIN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lv_font.h"
+#include "../lv_misc/lv_types.h"
+#include "../lv_misc/lv_mem.h"
+
+#if LV_USE_FONT_BIN
+
+#if LV_USE_FILESYSTEM == 0
+#error "LV_USE_FONT_BIN needs LV_USE_FILESYSTEM"
+#endif
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/** Counters of the glyph bitmap cache of the loaded fonts*/
+typedef struct
+{
+    uint32_t hit;   /**< Bitmaps served from the cache*/
+    uint32_t miss;  /**< Bitmaps read from a file*/
+    uint32_t evict; /**< Bitmaps dropped to fit in the budget*/
+    uint32_t size;  /**< Bytes held by the cache now*/
+    uint16_t used;  /**< Cached bitmaps now*/
+} lv_font_bin_stats_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Load a font from a file written by `lv_font_bin_save`.
+ * The file stays open until `lv_font_bin_free`, the glyph bitmaps are read from it on demand.
+ * @param path path of the file, e.g. "S:/fonts/cjk_24.bin"
+ * @return pointer to the new font or NULL if the file can't be opened or isn't a valid font
+ */
+lv_font_t * lv_font_bin_load(const char * path);
+
+/**
+ * Close a font loaded with `lv_font_bin_load` and free its memory.
+ * The objects using it should be deleted or get an other font before.
+ * @param font pointer to the font
+ */
+void lv_font_bin_free(lv_font_t * font);
+
+/**
+ * Write a font in the LittlevGL's format (`lv_font_fmt_txt_dsc_t` with plain bitmaps) into a file
+ * which can be loaded with `lv_font_bin_load`, e.g. to move a compiled-in font onto the file system.
+ * @param font pointer to the font
+ * @param path path of the new file
+ * @return LV_RES_OK: written; LV_RES_INV: not a plain `lv_font_fmt_txt` font or the file couldn't be written
+ */
+lv_res_t lv_font_bin_save(const lv_font_t * font, const char * path);
+
+/**
+ * Set how many bytes the cached glyph bitmaps of the loaded fonts can take.
+ * The least recently used bitmaps are dropped until they fit.
+ * @param budget bytes, 0: don't cache, read every bitmap from the file
+ */
+void lv_font_bin_set_budget(uint32_t budget);
+
+/**
+ * Get the counters of the glyph bitmap cache
+ * @param stats_p the counters are copied here
+ */
+void lv_font_bin_get_stats(lv_font_bin_stats_t * stats_p);
+
+/**
+ * Drops the least recently used glyph bitmaps if the memory is low (see `lv_mem_shrinker_add`)
+ */
+extern const lv_mem_shrinker_t lv_font_bin_cache_shrinker;
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_FONT_BIN*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_FONT_BIN_H*/
@@ -11,23 +11,60 @@
 #include "lv_font_fmt_txt.h"
 #include "../lv_misc/lv_log.h"
 #include "../lv_misc/lv_utils.h"
+#include "../lv_misc/lv_mem.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
  *********************/
+#define ACCEL_PAGE_SHIFT    8
+#define ACCEL_PAGE_SIZE     (1 << ACCEL_PAGE_SHIFT)
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_FONT_FMT_TXT_ACCEL
+/*Lookup tables of a font. Read only once built so the drawing threads can use them without locking*/
+typedef struct _lv_font_fmt_txt_accel_t
+{
+    uint32_t page_first;    /*Code point of the first page >> ACCEL_PAGE_SHIFT*/
+    uint32_t page_cnt;      /*Pages from `page_first` to the last page with glyphs*/
+    uint16_t * page_index;  /*`page_cnt` indexes in `pages`. 0: the page has no glyphs*/
+    uint16_t * pages;       /*Glyph IDs of the used pages, `ACCEL_PAGE_SIZE` each. Page 0 is all zero*/
+    uint32_t * kern_keys;   /*Open addressing hash of the kerning pairs: `left << 16 | right`, 0: empty*/
+    int8_t * kern_values;
+    uint32_t kern_mask;     /*Entries in `kern_keys` - 1, a power of 2*/
+} lv_font_fmt_txt_accel_t;
+#endif
+
+#if LV_USE_FONT_COMPRESSED
+typedef struct
+{
+    const uint8_t * in;     /*The next byte to read*/
+    uint32_t buf;           /*The last read bytes, only the lower `cnt` bits are unused yet*/
+    uint8_t cnt;
+} lv_font_fmt_txt_bit_reader_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter);
+static uint32_t cmap_search(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter);
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right);
 static int32_t unicode_list_compare(const void * ref, const void * element);
 static int32_t kern_pair_8_compare(const void * ref, const void * element);
 static int32_t kern_pair_16_compare(const void * ref, const void * element);
+#if LV_USE_FONT_COMPRESSED
+static inline uint8_t bits_read(lv_font_fmt_txt_bit_reader_t * reader, uint8_t n);
+static void decompress(const uint8_t * in, uint32_t px_num, uint8_t bpp, uint8_t * map);
+#endif
+#if LV_FONT_FMT_TXT_ACCEL
+static bool accel_pages_build(lv_font_fmt_txt_accel_t * accel, const lv_font_fmt_txt_dsc_t * fdsc);
+static bool accel_kern_build(lv_font_fmt_txt_accel_t * accel, const lv_font_fmt_txt_dsc_t * fdsc);
+static void accel_free(lv_font_fmt_txt_accel_t * accel);
+static inline uint32_t accel_kern_hash(uint32_t key, uint32_t mask);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -54,6 +91,8 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element);
 const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unicode_letter)
 {
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_PLAIN) return NULL; /*Use `lv_font_fmt_txt_decompress`*/
+
     uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
     if(!gid) return false;
 
@@ -65,6 +104,32 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t unic
     return NULL;
 }
 
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Decompress the bitmap of a glyph to 8 bit-per-pixel opacities. Thread safe.
+ * The bitmaps of the `LV_FONT_FMT_TXT_COMPRESSED` fonts can't be read by `lv_font_get_bitmap_fmt_txt`, only so.
+ * @param font pointer to a font in the LittlevGL's format
+ * @param unicode_letter an unicode letter
+ * @param map store the `box_w * box_h` opacities here
+ * @return true: `map` is filled; false: the font isn't compressed or it doesn't have the letter
+ */
+bool lv_font_fmt_txt_decompress(const lv_font_t * font, uint32_t unicode_letter, uint8_t * map)
+{
+    if(font->get_glyph_bitmap != lv_font_get_bitmap_fmt_txt) return false;
+
+    const lv_font_fmt_txt_dsc_t * fdsc = (const lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->bitmap_format != LV_FONT_FMT_TXT_COMPRESSED) return false;
+
+    uint32_t gid = get_glyph_dsc_id(font, unicode_letter);
+    if(!gid) return false;
+
+    const lv_font_fmt_txt_glyph_dsc_t * gdsc = &fdsc->glyph_dsc[gid];
+    decompress(&fdsc->glyph_bitmap[gdsc->bitmap_index], (uint32_t)gdsc->box_w * gdsc->box_h, fdsc->bpp, map);
+
+    return true;
+}
+#endif
+
 /**
  * Used as `get_glyph_dsc` callback in LittelvGL's native font format if the font is uncompressed.
  * @param font_p pointer to font
@@ -103,6 +168,60 @@ bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t *
     return true;
 }
 
+/**
+ * Get the index of a letter's descriptor in `glyph_dsc`. For fonts which keep their bitmaps elsewhere.
+ * @param font pointer to a font in the LittlevGL's format
+ * @param unicode_letter an unicode letter
+ * @return the glyph ID or 0 if the font doesn't have the letter
+ */
+uint32_t lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t unicode_letter)
+{
+    return get_glyph_dsc_id(font, unicode_letter);
+}
+
+#if LV_FONT_FMT_TXT_ACCEL
+/**
+ * Build lookup tables for a font to find its glyph IDs and kerning values without searching.
+ * Call it once when the font is set up, before it's used to draw.
+ * The code points are mapped by a two level page table: a page of 256 glyph IDs for every
+ * 256 code points which have glyphs. The kerning pairs are put into a hash table.
+ * @param font pointer to a font in the LittlevGL's format
+ * @return LV_RES_OK: the tables are built (or were built earlier); LV_RES_INV: out of memory,
+ *         the font still works without the tables
+ */
+lv_res_t lv_font_fmt_txt_accel_build(lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->accel) return LV_RES_OK;
+
+    lv_font_fmt_txt_accel_t * accel = lv_mem_alloc(sizeof(lv_font_fmt_txt_accel_t));
+    if(accel == NULL) return LV_RES_INV;
+    memset(accel, 0, sizeof(lv_font_fmt_txt_accel_t));
+
+    if(!accel_pages_build(accel, fdsc) || !accel_kern_build(accel, fdsc)) {
+        LV_LOG_WARN("lv_font_fmt_txt_accel_build: out of memory");
+        accel_free(accel);
+        return LV_RES_INV;
+    }
+
+    fdsc->accel = accel;
+    return LV_RES_OK;
+}
+
+/**
+ * Free the lookup tables of a font built by `lv_font_fmt_txt_accel_build`
+ * @param font pointer to a font in the LittlevGL's format
+ */
+void lv_font_fmt_txt_accel_free(lv_font_t * font)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
+    if(fdsc->accel == NULL) return;
+
+    accel_free(fdsc->accel);
+    fdsc->accel = NULL;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -113,15 +232,44 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
 
     lv_font_fmt_txt_dsc_t * fdsc = (lv_font_fmt_txt_dsc_t *) font->dsc;
 
-    /*Check the chacge first*/
+#if LV_FONT_FMT_TXT_ACCEL
+    const lv_font_fmt_txt_accel_t * accel = fdsc->accel;
+    if(accel) {
+        uint32_t page = (letter >> ACCEL_PAGE_SHIFT) - accel->page_first;
+        if(page >= accel->page_cnt) return 0;
+        return accel->pages[((uint32_t)accel->page_index[page] << ACCEL_PAGE_SHIFT) + (letter & (ACCEL_PAGE_SIZE - 1))];
+    }
+#endif
+
+    /*Check the chacge first. With more drawing threads the cache could be seen half updated*/
+#if LV_REFR_THREADS <= 1
     if(letter == fdsc->last_letter) return fdsc->last_glyph_id;
+#endif
 
+    uint32_t glyph_id = cmap_search(fdsc, letter);
+
+    /*Update the cache*/
+#if LV_REFR_THREADS <= 1
+    fdsc->last_letter = letter;
+    fdsc->last_glyph_id = glyph_id;
+#endif
+    return glyph_id;
+}
+
+/**
+ * Find the glyph ID of a letter in the character maps of a font
+ * @param fdsc pointer to the font's descriptor
+ * @param letter an unicode letter
+ * @return the glyph ID or 0 if the font doesn't have the letter
+ */
+static uint32_t cmap_search(const lv_font_fmt_txt_dsc_t * fdsc, uint32_t letter)
+{
     uint16_t i;
     for(i = 0; i < fdsc->cmap_num; i++) {
 
         /*Relative code point*/
         uint32_t rcp = letter - fdsc->cmaps[i].range_start;
-        if(rcp > fdsc->cmaps[i].range_length) continue;
+        if(rcp >= fdsc->cmaps[i].range_length) continue;
         uint32_t glyph_id = 0;
         if(fdsc->cmaps[i].type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY) {
             glyph_id = fdsc->cmaps[i].glyph_id_start + rcp;
@@ -145,21 +293,15 @@ static uint32_t get_glyph_dsc_id(const lv_font_t * font, uint32_t letter)
             if(p) {
                 uint32_t ofs = (uintptr_t)p - (uintptr_t) fdsc->cmaps[i].unicode_list;
                 ofs = ofs >> 1;     /*The list stores `uint16_t` so the get the index divide by 2*/
-                const uint8_t * gid_ofs_16 = fdsc->cmaps[i].glyph_id_ofs_list;
+                const uint16_t * gid_ofs_16 = fdsc->cmaps[i].glyph_id_ofs_list;
                 glyph_id = fdsc->cmaps[i].glyph_id_start + gid_ofs_16[ofs];
             }
         }
 
-        /*Update the cache*/
-        fdsc->last_letter = letter;
-        fdsc->last_glyph_id = glyph_id;
         return glyph_id;
     }
 
-    fdsc->last_letter = letter;
-    fdsc->last_glyph_id = 0;
     return 0;
-
 }
 
 static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t gid_right)
@@ -168,6 +310,19 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
 
     int8_t value = 0;
 
+#if LV_FONT_FMT_TXT_ACCEL
+    const lv_font_fmt_txt_accel_t * accel = fdsc->accel;
+    if(accel && accel->kern_keys) {
+        uint32_t key = (gid_left << 16) | gid_right;
+        uint32_t i = accel_kern_hash(key, accel->kern_mask);
+        while(accel->kern_keys[i] != 0) {
+            if(accel->kern_keys[i] == key) return accel->kern_values[i];
+            i = (i + 1) & accel->kern_mask;
+        }
+        return 0;
+    }
+#endif
+
     if(fdsc->kern_classes == 0) {
         /*Kern pairs*/
         const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
@@ -188,13 +343,13 @@ static int8_t get_kern_value(const lv_font_t * font, uint32_t gid_left, uint32_t
             /* Use binary search to find the kern value.
              * The pairs are ordered left_id first, then right_id secondly. */
             const uint16_t * g_ids = kdsc->glyph_ids;
-            uint32_t g_id_both = (uint32_t)((uint32_t)gid_right << 8) + gid_left; /*Create one number from the ids*/
-            uint8_t * kid_p = lv_utils_bsearch(&g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
+            uint16_t g_id_both[2] = {gid_left, gid_right}; /*Laid out like a pair in `g_ids`*/
+            uint8_t * kid_p = lv_utils_bsearch(g_id_both, g_ids, kdsc->pair_cnt, 4, kern_pair_16_compare);
 
             /*If the `g_id_both` were found get its index from the pointer*/
             if(kid_p) {
                 uintptr_t ofs = (uintptr_t)kid_p - (uintptr_t)g_ids;
-                ofs = ofs >> 4;     /*ofs is 4 byte pairs, divide by 4 to refer as a single value*/
+                ofs = ofs >> 2;     /*ofs is 4 byte pairs, divide by 4 to refer as a single value*/
                 value = kdsc->values[ofs];
             }
 
@@ -238,6 +393,168 @@ static int32_t kern_pair_16_compare(const void * ref, const void * element)
     else return (int32_t) ref16_p[1] - element16_p[1];
 }
 
+#if LV_FONT_FMT_TXT_ACCEL
+/**
+ * Map all the code points of a font to glyph IDs in pages of `ACCEL_PAGE_SIZE`.
+ * The pages are filled by searching the character maps so the result is the same as without the tables.
+ * @param accel the tables to fill
+ * @param fdsc pointer to the font's descriptor
+ * @return true: built; false: out of memory
+ */
+static bool accel_pages_build(lv_font_fmt_txt_accel_t * accel, const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    /*Find the range of pages with any code point*/
+    uint32_t page_first = UINT32_MAX;
+    uint32_t page_last = 0;
+    uint16_t i;
+    uint32_t k;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        if(cm->range_length == 0) continue;
+        uint32_t first = cm->range_start >> ACCEL_PAGE_SHIFT;
+        uint32_t last = (cm->range_start + cm->range_length - 1) >> ACCEL_PAGE_SHIFT;
+        if(first < page_first) page_first = first;
+        if(last > page_last) page_last = last;
+    }
+
+    if(page_first > page_last) return true;    /*No characters at all: every letter is outside of the pages*/
+
+    accel->page_first = page_first;
+    accel->page_cnt = page_last - page_first + 1;
+    accel->page_index = lv_mem_alloc(accel->page_cnt * sizeof(uint16_t));
+    if(accel->page_index == NULL) return false;
+    memset(accel->page_index, 0, accel->page_cnt * sizeof(uint16_t));
+
+    /*Mark the pages which can have glyphs. Sparse maps mark only the pages of their letters*/
+    uint32_t used = 0;
+    for(i = 0; i < fdsc->cmap_num; i++) {
+        const lv_font_fmt_txt_cmap_t * cm = &fdsc->cmaps[i];
+        if(cm->range_length == 0) continue;
+        if(cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY || cm->type == LV_FONT_FMT_TXT_CMAP_FORMAT0_FULL) {
+            uint32_t first = cm->range_start >> ACCEL_PAGE_SHIFT;
+            uint32_t last = (cm->range_start + cm->range_length - 1) >> ACCEL_PAGE_SHIFT;
+            for(k = first; k <= last; k++) {
+                if(accel->page_index[k - page_first] == 0) used++;
+                accel->page_index[k - page_first] = 1;
+            }
+        } else {
+            for(k = 0; k < cm->list_length; k++) {
+                uint32_t p = ((cm->range_start + cm->unicode_list[k]) >> ACCEL_PAGE_SHIFT) - page_first;
+                if(p >= accel->page_cnt) continue;  /*Beyond the range, `cmap_search` ignores it too*/
+                if(accel->page_index[p] == 0) used++;
+                accel->page_index[p] = 1;
+            }
+        }
+    }
+
+    if(used >= UINT16_MAX) return false;
+
+    /*Page 0 stays all zero for the pages without glyphs*/
+    accel->pages = lv_mem_alloc((used + 1) * ACCEL_PAGE_SIZE * sizeof(uint16_t));
+    if(accel->pages == NULL) return false;
+    memset(accel->pages, 0, ACCEL_PAGE_SIZE * sizeof(uint16_t));
+
+    uint16_t next = 1;
+    for(k = 0; k < accel->page_cnt; k++) {
+        if(accel->page_index[k] == 0) continue;
+
+        uint16_t * page = &accel->pages[(uint32_t)next << ACCEL_PAGE_SHIFT];
+        uint32_t letter = (page_first + k) << ACCEL_PAGE_SHIFT;
+        bool empty = true;
+        uint32_t j;
+        for(j = 0; j < ACCEL_PAGE_SIZE; j++) {
+            page[j] = letter + j == 0 ? 0 : cmap_search(fdsc, letter + j);
+            if(page[j]) empty = false;
+        }
+
+        /*E.g. letters covered by an earlier map which doesn't have them: reuse the memory for the next page*/
+        if(empty) accel->page_index[k] = 0;
+        else accel->page_index[k] = next++;
+    }
+
+    return true;
+}
+
+/**
+ * Put the kerning pairs of a font into an open addressing hash table.
+ * Kerning classes are looked up from two arrays anyway so they don't need a table.
+ * @param accel the tables to fill
+ * @param fdsc pointer to the font's descriptor
+ * @return true: built or not needed; false: out of memory
+ */
+static bool accel_kern_build(lv_font_fmt_txt_accel_t * accel, const lv_font_fmt_txt_dsc_t * fdsc)
+{
+    if(fdsc->kern_dsc == NULL || fdsc->kern_classes) return true;
+
+    const lv_font_fmt_txt_kern_pair_t * kdsc = fdsc->kern_dsc;
+    if(kdsc->pair_cnt == 0 || kdsc->glyph_ids_size > 1) return true;
+
+    /*Keep the table at most half full so the probe sequences stay short*/
+    uint32_t size = 16;
+    while(size < kdsc->pair_cnt * 2) size <<= 1;
+
+    accel->kern_keys = lv_mem_alloc(size * sizeof(uint32_t));
+    accel->kern_values = lv_mem_alloc(size * sizeof(int8_t));
+    if(accel->kern_keys == NULL || accel->kern_values == NULL) return false;
+    memset(accel->kern_keys, 0, size * sizeof(uint32_t));
+    accel->kern_mask = size - 1;
+
+    uint32_t k;
+    for(k = 0; k < kdsc->pair_cnt; k++) {
+        uint32_t left;
+        uint32_t right;
+        if(kdsc->glyph_ids_size == 0) {
+            const uint8_t * g_ids = kdsc->glyph_ids;
+            left = g_ids[k * 2];
+            right = g_ids[k * 2 + 1];
+        } else {
+            const uint16_t * g_ids = kdsc->glyph_ids;
+            left = g_ids[k * 2];
+            right = g_ids[k * 2 + 1];
+        }
+
+        /*Glyph 0 means "no glyph" so its pairs can't be used*/
+        if(left == 0 || right == 0) continue;
+
+        uint32_t key = (left << 16) | right;
+        uint32_t i = accel_kern_hash(key, accel->kern_mask);
+        while(accel->kern_keys[i] != 0 && accel->kern_keys[i] != key) i = (i + 1) & accel->kern_mask;
+
+        /*With duplicates keep the first one*/
+        if(accel->kern_keys[i] == key) continue;
+        accel->kern_keys[i] = key;
+        accel->kern_values[i] = kdsc->values[k];
+    }
+
+    return true;
+}
+
+/**
+ * Free the lookup tables and their memory
+ * @param accel pointer to the tables
+ */
+static void accel_free(lv_font_fmt_txt_accel_t * accel)
+{
+    if(accel->page_index) lv_mem_free(accel->page_index);
+    if(accel->pages) lv_mem_free(accel->pages);
+    if(accel->kern_keys) lv_mem_free(accel->kern_keys);
+    if(accel->kern_values) lv_mem_free(accel->kern_values);
+    lv_mem_free(accel);
+}
+
+/**
+ * Get the first slot of a kerning pair in the hash table
+ * @param key `left << 16 | right`
+ * @param mask size of the table - 1
+ * @return index in the table
+ */
+static inline uint32_t accel_kern_hash(uint32_t key, uint32_t mask)
+{
+    /*Fibonacci hashing: the multiplication mixes the two glyph IDs into the upper bits*/
+    return ((key * 2654435769U) >> 16) & mask;
+}
+#endif
+
 /** Code Comparator.
  *
  *  Compares the value of both input arguments.
@@ -255,3 +572,47 @@ static int32_t unicode_list_compare(const void * ref, const void * element)
 {
     return (*(uint16_t *)ref) - (*(uint16_t *)element);
 }
+
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Read bits from the bit stream of a compressed glyph. Only the bytes of the glyph are read.
+ * @param reader pointer to a reader
+ * @param n number of bits to read, max. 8
+ * @return the next `n` bits
+ */
+static inline uint8_t bits_read(lv_font_fmt_txt_bit_reader_t * reader, uint8_t n)
+{
+    while(reader->cnt < n) {
+        reader->buf = (reader->buf << 8) | *reader->in;
+        reader->in++;
+        reader->cnt += 8;
+    }
+    reader->cnt -= n;
+    return (reader->buf >> reader->cnt) & ((1 << n) - 1);
+}
+
+/**
+ * Expand the prefix codes of a glyph (see `LV_FONT_FMT_TXT_COMPRESSED`) to 8 bit-per-pixel opacities
+ * @param in the first byte of the glyph's bit stream
+ * @param px_num `box_w * box_h` of the glyph
+ * @param bpp bit-per-pixel of the font: 1, 2, 4 or 8
+ * @param map store the `px_num` opacities here
+ */
+static void decompress(const uint8_t * in, uint32_t px_num, uint8_t bpp, uint8_t * map)
+{
+    uint8_t px_max    = (1 << bpp) - 1;
+    uint8_t opa_scale = 255 / px_max; /*255, 85, 17 or 1 like the opacity tables of the plain bitmaps*/
+
+    lv_font_fmt_txt_bit_reader_t reader;
+    reader.in  = in;
+    reader.buf = 0;
+    reader.cnt = 0;
+
+    uint32_t i;
+    for(i = 0; i < px_num; i++) {
+        if(bits_read(&reader, 1) == 0) map[i] = 0;
+        else if(bits_read(&reader, 1) == 0) map[i] = 255;
+        else map[i] = bits_read(&reader, bpp) * opa_scale;
+    }
+}
+#endif
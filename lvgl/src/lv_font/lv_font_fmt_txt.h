@@ -23,6 +23,7 @@ extern "C" {
 #include <stddef.h>
 #include <stdbool.h>
 #include "lv_font.h"
+#include "../lv_misc/lv_types.h"
 
 /*********************
  *      DEFINES
@@ -143,7 +144,12 @@ typedef struct {
 }lv_font_fmt_txt_kern_classes_t;
 
 
-/** Bitmap formats*/
+/** Bitmap formats
+ * `LV_FONT_FMT_TXT_COMPRESSED` (needs `LV_USE_FONT_COMPRESSED`): the `bitmap_index` of a glyph points
+ * to its own bit stream (MSB first) which gives its `box_w * box_h` pixels row by row with prefix codes:
+ *  - `0`: transparent pixel
+ *  - `10`: fully opaque pixel (all the `bpp` bits set)
+ *  - `11` and `bpp` bits: any other value*/
 typedef enum {
     LV_FONT_FMT_TXT_PLAIN      = 0,
     LV_FONT_FMT_TXT_COMPRESSED = 1,
@@ -190,6 +196,10 @@ typedef struct {
     uint32_t last_letter;
     uint32_t last_glyph_id;
 
+#if LV_FONT_FMT_TXT_ACCEL
+    /*Lookup tables made by `lv_font_fmt_txt_accel_build`. NULL: search in `cmaps` and `kern_dsc`*/
+    struct _lv_font_fmt_txt_accel_t * accel;
+#endif
 }lv_font_fmt_txt_dsc_t;
 
 /**********************
@@ -204,6 +214,18 @@ typedef struct {
  */
 const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t letter);
 
+#if LV_USE_FONT_COMPRESSED
+/**
+ * Decompress the bitmap of a glyph to 8 bit-per-pixel opacities. Thread safe.
+ * The bitmaps of the `LV_FONT_FMT_TXT_COMPRESSED` fonts can't be read by `lv_font_get_bitmap_fmt_txt`, only so.
+ * @param font pointer to a font in the LittlevGL's format
+ * @param unicode_letter an unicode letter
+ * @param map store the `box_w * box_h` opacities here
+ * @return true: `map` is filled; false: the font isn't compressed or it doesn't have the letter
+ */
+bool lv_font_fmt_txt_decompress(const lv_font_t * font, uint32_t unicode_letter, uint8_t * map);
+#endif
+
 /**
  * Used as `get_glyph_dsc` callback in LittelvGL's native font format if the font is uncompressed.
  * @param font_p pointer to font
@@ -214,6 +236,33 @@ const uint8_t * lv_font_get_bitmap_fmt_txt(const lv_font_t * font, uint32_t lett
  */
 bool lv_font_get_glyph_dsc_fmt_txt(const lv_font_t * font, lv_font_glyph_dsc_t * dsc_out, uint32_t unicode_letter, uint32_t unicode_letter_next);
 
+/**
+ * Get the index of a letter's descriptor in `glyph_dsc`. For fonts which keep their bitmaps elsewhere.
+ * @param font pointer to a font in the LittlevGL's format
+ * @param unicode_letter an unicode letter
+ * @return the glyph ID or 0 if the font doesn't have the letter
+ */
+uint32_t lv_font_fmt_txt_get_glyph_id(const lv_font_t * font, uint32_t unicode_letter);
+
+#if LV_FONT_FMT_TXT_ACCEL
+/**
+ * Build lookup tables for a font to find its glyph IDs and kerning values without searching.
+ * Call it once when the font is set up, before it's used to draw.
+ * The code points are mapped by a two level page table: a page of 256 glyph IDs for every
+ * 256 code points which have glyphs. The kerning pairs are put into a hash table.
+ * @param font pointer to a font in the LittlevGL's format
+ * @return LV_RES_OK: the tables are built (or were built earlier); LV_RES_INV: out of memory,
+ *         the font still works without the tables
+ */
+lv_res_t lv_font_fmt_txt_accel_build(lv_font_t * font);
+
+/**
+ * Free the lookup tables of a font built by `lv_font_fmt_txt_accel_build`
+ * @param font pointer to a font in the LittlevGL's format
+ */
+void lv_font_fmt_txt_accel_free(lv_font_t * font);
+#endif
+
 /**********************
  *      MACROS
  **********************/
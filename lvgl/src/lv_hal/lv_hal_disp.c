@@ -36,7 +36,11 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_CONTEXT
+#define disp_def (lv_context_act->disp_def)
+#else
 static lv_disp_t * disp_def;
+#endif
 
 /**********************
  *      MACROS
@@ -80,7 +84,13 @@ void lv_disp_drv_init(lv_disp_drv_t * driver)
     driver->user_data = NULL;
 #endif
 
-    driver->set_px_cb = NULL;
+    driver->set_px_cb      = NULL;
+    driver->set_px_span_cb = NULL;
+
+#if LV_USE_HW_CURSOR
+    driver->cursor_set_cb  = NULL;
+    driver->cursor_move_cb = NULL;
+#endif
 }
 
 /**
@@ -108,6 +118,34 @@ void lv_disp_buf_init(lv_disp_buf_t * disp_buf, void * buf1, void * buf2, uint32
     disp_buf->size    = size_in_px_cnt;
 }
 
+#if LV_DISP_BUF_MAX > 2
+/**
+ * Initialize a display buffer with more screen sized buffers which are drawn and flushed in turn.
+ * A frame is drawn while the previous ones are still being flushed and
+ * it's waited for `lv_disp_flush_ready` only if all the other buffers are in flight.
+ * `lv_disp_flush_ready` has to be called for every flushed buffer in the order of the flushes,
+ * when the buffer before it isn't used by the display anymore.
+ * Before drawing into a buffer only the areas changed since it was drawn last are copied into it.
+ * @param disp_buf pointer `lv_disp_buf_t` variable to initialize
+ * @param bufs array of the buffers
+ * @param buf_cnt number of buffers in `bufs` (max. `LV_DISP_BUF_MAX`)
+ * @param size_in_px_cnt size of every buffer in pixel count. Has to be the size of the screen.
+ */
+void lv_disp_buf_init_chain(lv_disp_buf_t * disp_buf, void * const bufs[], uint8_t buf_cnt, uint32_t size_in_px_cnt)
+{
+    if(buf_cnt > LV_DISP_BUF_MAX) {
+        LV_LOG_WARN("lv_disp_buf_init_chain: more buffers than LV_DISP_BUF_MAX, the rest is not used");
+        buf_cnt = LV_DISP_BUF_MAX;
+    }
+
+    lv_disp_buf_init(disp_buf, bufs[0], buf_cnt > 1 ? bufs[1] : NULL, size_in_px_cnt);
+    if(buf_cnt <= 2) return;
+
+    memcpy(disp_buf->bufs, bufs, buf_cnt * sizeof(void *));
+    disp_buf->buf_cnt = buf_cnt;
+}
+#endif
+
 /**
  * Register an initialized display driver.
  * Automatically set the first display as active.
@@ -125,7 +163,15 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
     memcpy(&disp->driver, driver, sizeof(lv_disp_drv_t));
     memset(&disp->inv_area_joined, 0, sizeof(disp->inv_area_joined));
     memset(&disp->inv_areas, 0, sizeof(disp->inv_areas));
-    lv_ll_init(&disp->scr_ll, sizeof(lv_obj_t));
+#if LV_INV_TILE_SIZE
+    memset(&disp->inv_tiles, 0, sizeof(disp->inv_tiles));
+    disp->inv_tile_act = 0;
+#endif
+#if LV_USE_SCROLL_BLIT
+    disp->scroll_act = 0;
+#endif
+    lv_ll_init_pool(&disp->scr_ll, sizeof(lv_obj_t));
+    disp->refr_task = NULL; /*Created later, `lv_inv_area` shouldn't resume it before*/
 
     if(disp_def == NULL) disp_def = disp;
 
@@ -135,6 +181,10 @@ lv_disp_t * lv_disp_drv_register(lv_disp_drv_t * driver)
 
     disp->inv_p = 0;
 
+    disp->refr_due      = lv_tick_get() - LV_DISP_DEF_REFR_PERIOD;
+    disp->inv_tick      = disp->refr_due;
+    disp->missed_frames = 0;
+
     disp->act_scr   = lv_obj_create(NULL, NULL); /*Create a default screen on the display*/
     disp->top_layer = lv_obj_create(NULL, NULL); /*Create top layer on the display*/
     disp->sys_layer = lv_obj_create(NULL, NULL); /*Create top layer on the display*/
@@ -267,6 +317,9 @@ bool lv_disp_get_antialiasing(lv_disp_t * disp)
  */
 LV_ATTRIBUTE_FLUSH_READY void lv_disp_flush_ready(lv_disp_drv_t * disp_drv)
 {
+#if LV_DISP_BUF_MAX > 2
+    if(disp_drv->buffer->buf_cnt > 2) __atomic_sub_fetch(&disp_drv->buffer->in_flight, 1, __ATOMIC_RELEASE);
+#endif
     disp_drv->buffer->flushing = 0;
 
     /*If the screen is transparent initialize it when the flushing is ready*/
@@ -310,7 +363,8 @@ uint16_t lv_disp_get_inv_buf_size(lv_disp_t * disp)
 }
 
 /**
- * Pop (delete) the last 'num' invalidated areas from the buffer
+ * Pop (delete) the last 'num' invalidated areas from the buffer.
+ * The areas collected in tiles (after the buffer overflowed) can't be deleted, they will be redrawn.
  * @param num number of areas to delete
  */
 void lv_disp_pop_from_inv_buf(lv_disp_t * disp, uint16_t num)
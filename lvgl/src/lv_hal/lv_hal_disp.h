@@ -22,6 +22,9 @@ extern "C" {
 #include "../lv_misc/lv_area.h"
 #include "../lv_misc/lv_ll.h"
 #include "../lv_misc/lv_task.h"
+#if LV_USE_HW_CURSOR
+#include "../lv_draw/lv_img_decoder.h"
+#endif
 
 /*********************
  *      DEFINES
@@ -30,6 +33,17 @@ extern "C" {
 #define LV_INV_BUF_SIZE 32 /*Buffer size for invalid areas */
 #endif
 
+#if LV_INV_TILE_SIZE
+/*Tiles of the invalidated area bitmap. The columns of a row are stored in 32 bit words */
+#define LV_INV_TILE_COLS ((LV_HOR_RES_MAX + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE)
+#define LV_INV_TILE_ROWS ((LV_VER_RES_MAX + LV_INV_TILE_SIZE - 1) / LV_INV_TILE_SIZE)
+#define LV_INV_TILE_WORDS ((LV_INV_TILE_COLS + 31) / 32)
+#endif
+
+#if LV_DISP_BUF_MAX > 2
+#define LV_DISP_BUF_DMG_MAX 8 /*Changed areas stored per buffer of a swap chain. More are merged.*/
+#endif
+
 #ifndef LV_ATTRIBUTE_FLUSH_READY
 #define LV_ATTRIBUTE_FLUSH_READY
 #endif
@@ -54,6 +68,15 @@ typedef struct
     uint32_t size; /*In pixel count*/
     lv_area_t area;
     volatile uint32_t flushing : 1;
+#if LV_DISP_BUF_MAX > 2
+    /*Swap chain (`lv_disp_buf_init_chain`)*/
+    void * bufs[LV_DISP_BUF_MAX];
+    uint8_t buf_cnt;                /*More than 2: the buffers are used in turn*/
+    uint8_t buf_idx;                /*Index of `buf_act`*/
+    volatile uint8_t in_flight;     /*Flushed buffers whose `lv_disp_flush_ready` didn't arrive yet*/
+    uint8_t dmg_cnt[LV_DISP_BUF_MAX];
+    lv_area_t dmg[LV_DISP_BUF_MAX][LV_DISP_BUF_DMG_MAX]; /*Areas changed since a buffer was drawn*/
+#endif
 } lv_disp_buf_t;
 
 /**
@@ -94,10 +117,24 @@ typedef struct _disp_drv_t
     void (*set_px_cb)(struct _disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
                       lv_color_t color, lv_opa_t opa);
 
+    /** OPTIONAL: Set `len` pixels of a row from `x` like `set_px_cb`. Works only together with `set_px_cb`
+     * but called instead of it for fills and images to save a call on every pixel. */
+    void (*set_px_span_cb)(struct _disp_drv_t * disp_drv, uint8_t * buf, lv_coord_t buf_w, lv_coord_t x, lv_coord_t y,
+                           const lv_color_t * colors, lv_coord_t len, lv_opa_t opa);
+
     /** OPTIONAL: Called after every refresh cycle to tell the rendering and flushing time + the
      * number of flushed pixels */
     void (*monitor_cb)(struct _disp_drv_t * disp_drv, uint32_t time, uint32_t px);
 
+#if LV_USE_HW_CURSOR
+    /** OPTIONAL: Show a true color image as the cursor of the display with its top left corner on the pointer
+     * (NULL: remove the cursor). Return false if it can't be shown, then the cursor object is drawn instead. */
+    bool (*cursor_set_cb)(struct _disp_drv_t * disp_drv, const lv_img_dsc_t * img);
+
+    /** OPTIONAL: Move the cursor of the display. Not needed if the cursor follows the pointer by itself. */
+    void (*cursor_move_cb)(struct _disp_drv_t * disp_drv, lv_coord_t x, lv_coord_t y);
+#endif
+
 #if LV_USE_GPU
     /** OPTIONAL: Blend two memories using opacity (GPU only)*/
     void (*gpu_blend_cb)(struct _disp_drv_t * disp_drv, lv_color_t * dest, const lv_color_t * src, uint32_t length,
@@ -142,6 +179,20 @@ typedef struct _disp_t
     lv_area_t inv_areas[LV_INV_BUF_SIZE];
     uint8_t inv_area_joined[LV_INV_BUF_SIZE];
     uint32_t inv_p : 10;
+#if LV_INV_TILE_SIZE
+    uint32_t inv_tile_act : 1; /**< `inv_areas` overflowed, the invalidated areas are collected in `inv_tiles`*/
+    uint32_t inv_tiles[LV_INV_TILE_ROWS][LV_INV_TILE_WORDS];
+#endif
+#if LV_USE_SCROLL_BLIT
+    lv_area_t scroll_area;    /**< Its pixels are moved by `scroll_ofs` in the next refresh (see `lv_refr_scroll`)*/
+    lv_point_t scroll_ofs;
+    uint32_t scroll_act : 1;
+#endif
+
+    /*Frame pacing*/
+    uint32_t refr_due;      /**< When the last refresh was due. The next one is due a period later.*/
+    uint32_t inv_tick;      /**< First invalidation after the last refresh*/
+    uint32_t missed_frames; /**< Refreshes which were due but couldn't be done (see `lv_disp_get_missed_frames`)*/
 
     /*Miscellaneous data*/
     uint32_t last_activity_time; /**< Last time there was activity on this display */
@@ -176,6 +227,22 @@ void lv_disp_drv_init(lv_disp_drv_t * driver);
  */
 void lv_disp_buf_init(lv_disp_buf_t * disp_buf, void * buf1, void * buf2, uint32_t size_in_px_cnt);
 
+#if LV_DISP_BUF_MAX > 2
+/**
+ * Initialize a display buffer with more screen sized buffers which are drawn and flushed in turn.
+ * A frame is drawn while the previous ones are still being flushed and
+ * it's waited for `lv_disp_flush_ready` only if all the other buffers are in flight.
+ * `lv_disp_flush_ready` has to be called for every flushed buffer in the order of the flushes,
+ * when the buffer before it isn't used by the display anymore.
+ * Before drawing into a buffer only the areas changed since it was drawn last are copied into it.
+ * @param disp_buf pointer `lv_disp_buf_t` variable to initialize
+ * @param bufs array of the buffers
+ * @param buf_cnt number of buffers in `bufs` (max. `LV_DISP_BUF_MAX`)
+ * @param size_in_px_cnt size of every buffer in pixel count. Has to be the size of the screen.
+ */
+void lv_disp_buf_init_chain(lv_disp_buf_t * disp_buf, void * const bufs[], uint8_t buf_cnt, uint32_t size_in_px_cnt);
+#endif
+
 /**
  * Register an initialized display driver.
  * Automatically set the first display as active.
@@ -119,6 +119,8 @@ typedef struct _lv_indev_proc_t
             lv_point_t vect; /**< Difference between `act_point` and `last_point`. */
             lv_point_t drag_sum; /*Count the dragged pixels to check LV_INDEV_DEF_DRAG_LIMIT*/
             lv_point_t drag_throw_vect;
+            lv_point_t drag_pend;   /*Dragged distance not applied yet. Moved at most once in a refresh period*/
+            uint32_t drag_move_time; /*When the dragged object was moved last*/
             struct _lv_obj_t * act_obj;      /*The object being pressed*/
             struct _lv_obj_t * last_obj;     /*The last obejct which was pressed (used by dragthrow and
                                                 other post-release event)*/
@@ -155,6 +157,9 @@ typedef struct _lv_indev_t
     lv_indev_drv_t driver;
     lv_indev_proc_t proc;
     struct _lv_obj_t * cursor;     /**< Cursor for LV_INPUT_TYPE_POINTER*/
+#if LV_USE_HW_CURSOR
+    uint8_t hw_cursor;             /**< 1: the display shows the image of `cursor` (`cursor_set_cb`)*/
+#endif
     struct _lv_group_t * group;    /**< Keypad destination group*/
     const lv_point_t * btn_points; /**< Array points assigned to the button ()screen will be pressed
                                       here by the buttons*/
@@ -17,6 +17,8 @@
 
 #if LV_TICK_CUSTOM == 1
 #include LV_TICK_CUSTOM_INCLUDE
+#elif LV_TICK_CUSTOM == 2
+#include <time.h>
 #endif
 
 /*********************
@@ -70,6 +72,13 @@ uint32_t lv_tick_get(void)
                                 Continue until make a non interrupted cycle */
 
     return result;
+#elif LV_TICK_CUSTOM == 2
+    /*Read the monotonic clock directly: no periodic wake up and no drift from sleep overshoot*/
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    /*It counts from the boot and wraps around like `sys_time` (see `lv_tick_elaps`)*/
+    return (uint32_t)((uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000);
 #else
     return LV_TICK_CUSTOM_SYS_TIME_EXPR;
 #endif
@@ -15,6 +15,7 @@
 #include "lv_task.h"
 #include "lv_math.h"
 #include "lv_gc.h"
+#include "../lv_core/lv_obj.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
@@ -26,21 +27,66 @@
 #define LV_ANIM_RESOLUTION 1024
 #define LV_ANIM_RES_SHIFT 10
 
+#if LV_ANIM_PATH_LUT
+#define LV_ANIM_LUT_SHIFT 2 /*A table entry in every 4th step*/
+#define LV_ANIM_LUT_CNT ((LV_ANIM_RESOLUTION >> LV_ANIM_LUT_SHIFT) + 1)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_ANIM_PATH_LUT
+/*The paths evaluated from a table*/
+enum {
+    LV_ANIM_LUT_EASE_IN,
+    LV_ANIM_LUT_EASE_OUT,
+    LV_ANIM_LUT_EASE_IN_OUT,
+    LV_ANIM_LUT_OVERSHOOT,
+    LV_ANIM_LUT_BOUNCE,
+    _LV_ANIM_LUT_NUM
+};
+#endif
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    uint32_t last_task_run;
+    uint32_t step_due;     /*When the running step of `anim_task` was due*/
+    bool stepping;
+    lv_anim_t * anim_act;  /*The animation being handled by `anim_task`. NULL if deleted meanwhile.*/
+    lv_anim_t * anim_next; /*The animation `anim_task` handles next. Stepped by `lv_anim_del`*/
+    lv_task_t * anim_task_p;
+} lv_anim_state_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void anim_task(lv_task_t * param);
-static bool anim_ready_handler(lv_anim_t * a);
+static void anim_ready_handler(lv_anim_t * a);
+#if LV_ANIM_PATH_LUT
+static void anim_path_lut_init(void);
+static lv_anim_value_t anim_path_lut(const lv_anim_t * a, const int16_t * lut);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-static uint32_t last_task_run;
-static bool anim_list_changed;
+#if LV_USE_CONTEXT
+#define anim_st ((lv_anim_state_t *)lv_context_act->anim_state)
+#else
+static lv_anim_state_t anim_state;
+#define anim_st (&anim_state)
+#endif
+#define last_task_run (anim_st->last_task_run)
+#define step_due (anim_st->step_due)
+#define stepping (anim_st->stepping)
+#define anim_act (anim_st->anim_act)
+#define anim_next (anim_st->anim_next)
+#define anim_task_p (anim_st->anim_task_p)
+#if LV_ANIM_PATH_LUT
+static int16_t path_lut[_LV_ANIM_LUT_NUM][LV_ANIM_LUT_CNT]; /*Values of the paths from 0 to 1024*/
+static bool path_lut_ready;
+#endif
 
 /**********************
  *      MACROS
@@ -55,9 +101,17 @@ static bool anim_list_changed;
  */
 void lv_anim_core_init(void)
 {
-    lv_ll_init(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->anim_state, sizeof(lv_anim_state_t));
+#endif
+    lv_ll_init_pool(&LV_GC_ROOT(_lv_anim_ll), sizeof(lv_anim_t));
     last_task_run = lv_tick_get();
-    lv_task_create(anim_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, NULL);
+    anim_task_p   = lv_task_create(anim_task, LV_DISP_DEF_REFR_PERIOD, LV_TASK_PRIO_MID, NULL);
+    lv_task_pause(anim_task_p); /*No animations yet*/
+
+#if LV_ANIM_PATH_LUT
+    anim_path_lut_init();
+#endif
 }
 
 /**
@@ -87,8 +141,21 @@ void lv_anim_create(lv_anim_t * a)
     /* Do not let two animations for the  same 'var' with the same 'fp'*/
     if(a->exec_cb != NULL) lv_anim_del(a->var, a->exec_cb); /*fp == NULL would delete all animations of var*/
 
-    /*Add the new animation to the animation linked list*/
-    lv_anim_t * new_anim = lv_ll_ins_head(&LV_GC_ROOT(_lv_anim_ll));
+    /*Add the new animation next to the other animations of 'var', so `anim_task` steps them together.
+     *While stepping, it goes to the head so it's not reached in the current round.*/
+    lv_anim_t * same_var = NULL;
+    if(stepping == false) {
+        LV_LL_READ(LV_GC_ROOT(_lv_anim_ll), same_var) {
+            if(same_var->var == a->var) break;
+        }
+    }
+    lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_ANIM);
+    lv_anim_t * new_anim;
+    if(same_var)
+        new_anim = lv_ll_ins_prev(&LV_GC_ROOT(_lv_anim_ll), same_var);
+    else
+        new_anim = lv_ll_ins_head(&LV_GC_ROOT(_lv_anim_ll));
+    lv_mem_tag_set(tag_prev);
     lv_mem_assert(new_anim);
     if(new_anim == NULL) return;
 
@@ -96,12 +163,15 @@ void lv_anim_create(lv_anim_t * a)
     a->playback_now = 0;
     memcpy(new_anim, a, sizeof(lv_anim_t));
 
-    /*Set the start value*/
+    /*Set the start value.
+     * The new animation is on the head so `anim_task` won't step it in the current round*/
     if(new_anim->exec_cb) new_anim->exec_cb(new_anim->var, new_anim->start);
 
-    /* Creating an animation changed the linked list.
-     * It's important if it happens in a ready callback. (see `anim_task`)*/
-    anim_list_changed = true;
+    /*The task was paused while there were no animations. Don't count the paused time in the new animation.*/
+    if(anim_task_p->paused) {
+        last_task_run = lv_tick_get();
+        lv_task_resume(anim_task_p);
+    }
 
     LV_LOG_TRACE("animation created")
 }
@@ -124,10 +194,12 @@ bool lv_anim_del(void * var, lv_anim_exec_xcb_t exec_cb)
         a_next = lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
 
         if(a->var == var && (a->exec_cb == exec_cb || exec_cb == NULL)) {
+            /*Don't let `anim_task` continue with a deleted animation*/
+            if(a == anim_act) anim_act = NULL;
+            if(a == anim_next) anim_next = a_next;
+
             lv_ll_rem(&LV_GC_ROOT(_lv_anim_ll), a);
-            lv_mem_free(a);
-            anim_list_changed = true; /*Read by `anim_task`. It need to know if a delete occurred in
-                                         the linked list*/
+            lv_ll_free(&LV_GC_ROOT(_lv_anim_ll), a);
             del = true;
         }
 
@@ -150,6 +222,24 @@ uint16_t lv_anim_count_running(void)
     return cnt++;
 }
 
+/**
+ * Set how often the animations are stepped. Typically the refresh period of the display.
+ * @param period the period [ms]
+ */
+void lv_anim_set_period(uint32_t period)
+{
+    lv_task_set_period(anim_task_p, period);
+}
+
+/**
+ * Get when the changes made now were due. During a late step of the animations it's earlier than now.
+ * @return the tick of the due time
+ */
+uint32_t lv_anim_get_step_due(void)
+{
+    return stepping ? step_due : lv_tick_get();
+}
+
 /**
  * Calculate the time of an animation with a given speed and the start and end values
  * @param speed speed of animation in unit/sec
@@ -203,6 +293,10 @@ lv_anim_value_t lv_anim_path_linear(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_in(const lv_anim_t * a)
 {
+#if LV_ANIM_PATH_LUT
+    if(path_lut_ready) return anim_path_lut(a, path_lut[LV_ANIM_LUT_EASE_IN]);
+#endif
+
     /*Calculate the current step*/
     uint32_t t;
     if(a->time == a->act_time)
@@ -227,6 +321,10 @@ lv_anim_value_t lv_anim_path_ease_in(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_out(const lv_anim_t * a)
 {
+#if LV_ANIM_PATH_LUT
+    if(path_lut_ready) return anim_path_lut(a, path_lut[LV_ANIM_LUT_EASE_OUT]);
+#endif
+
     /*Calculate the current step*/
 
     uint32_t t;
@@ -252,6 +350,10 @@ lv_anim_value_t lv_anim_path_ease_out(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_ease_in_out(const lv_anim_t * a)
 {
+#if LV_ANIM_PATH_LUT
+    if(path_lut_ready) return anim_path_lut(a, path_lut[LV_ANIM_LUT_EASE_IN_OUT]);
+#endif
+
     /*Calculate the current step*/
 
     uint32_t t;
@@ -277,6 +379,10 @@ lv_anim_value_t lv_anim_path_ease_in_out(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_overshoot(const lv_anim_t * a)
 {
+#if LV_ANIM_PATH_LUT
+    if(path_lut_ready) return anim_path_lut(a, path_lut[LV_ANIM_LUT_OVERSHOOT]);
+#endif
+
     /*Calculate the current step*/
 
     uint32_t t;
@@ -302,6 +408,10 @@ lv_anim_value_t lv_anim_path_overshoot(const lv_anim_t * a)
  */
 lv_anim_value_t lv_anim_path_bounce(const lv_anim_t * a)
 {
+#if LV_ANIM_PATH_LUT
+    if(path_lut_ready) return anim_path_lut(a, path_lut[LV_ANIM_LUT_BOUNCE]);
+#endif
+
     /*Calculate the current step*/
     uint32_t t;
     if(a->time == a->act_time)
@@ -366,6 +476,20 @@ lv_anim_value_t lv_anim_path_step(const lv_anim_t * a)
         return a->start;
 }
 
+#if LV_ANIM_PATH_LUT
+/**
+ * Evaluate the eased paths from their tables or compute them in every step, e.g. to compare the two
+ * @param en true: from the tables (default); false: compute them
+ */
+void lv_anim_path_set_lut(bool en)
+{
+    if(en)
+        anim_path_lut_init();
+    else
+        path_lut_ready = false;
+}
+#endif
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -378,60 +502,129 @@ static void anim_task(lv_task_t * param)
 {
     (void)param;
 
-    lv_anim_t * a;
-    LV_LL_READ(LV_GC_ROOT(_lv_anim_ll), a)
-    {
-        a->has_run = 0;
-    }
-
     uint32_t elaps = lv_tick_elaps(last_task_run);
 
-    a = lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-
+    /*A step after a long refresh is late. Its frame was due a period after the previous step.*/
+    step_due = elaps > anim_task_p->period ? last_task_run + anim_task_p->period : lv_tick_get();
+    stepping = true;
+
+    /* The callbacks can create and delete animations. The new ones are added to the head
+     * so they are not reached in this round, and `lv_anim_del` steps `anim_next` if it deletes it.
+     * This way the list is read only once regardless of the changes.
+     * The animations of a variable are next to each other. If an object has more of them (e.g. x and y)
+     * they are stepped in a batch, so the object is invalidated once with the joined area.*/
+    bool group = false;
+    lv_anim_t * a = lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
     while(a != NULL) {
-        /*It can be set by `lv_anim_del()` typically in `end_cb`. If set then an animation delete
-         * happened in `anim_ready_handler` which could make this linked list reading corrupt
-         * because the list is changed meanwhile
-         */
-        anim_list_changed = false;
-
-        if(!a->has_run) {
-            a->has_run = 1; /*The list readying might be reseted so need to know which anim has run already*/
-            a->act_time += elaps;
-            if(a->act_time >= 0) {
-                if(a->act_time > a->time) a->act_time = a->time;
-
-                int32_t new_value;
-                new_value = a->path_cb(a);
-
-                /*Apply the calculated value*/
-                if(a->exec_cb) a->exec_cb(a->var, new_value);
-
-                /*If the time is elapsed the animation is ready*/
-                if(a->act_time >= a->time) {
-                    anim_ready_handler(a);
-                }
+        anim_act  = a;
+        anim_next = lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+
+        void * var = a->var;
+        if(group == false && anim_next != NULL && anim_next->var == var) {
+            lv_obj_batch_begin();
+            group = true;
+        }
+
+        a->act_time += elaps;
+        if(a->act_time >= 0) {
+            if(a->act_time > a->time) a->act_time = a->time;
+
+            int32_t new_value;
+            new_value = a->path_cb(a);
+
+            /*Apply the calculated value*/
+            if(a->exec_cb) a->exec_cb(a->var, new_value);
+
+            /*If the time is elapsed the animation is ready (if it wasn't deleted in `exec_cb`)*/
+            if(anim_act != NULL && a->act_time >= a->time) {
+                anim_ready_handler(a);
             }
         }
 
-        /* If the linked list changed due to anim. delete then it's not safe to continue
-         * the reading of the list from here -> start from the head*/
-        if(anim_list_changed)
-            a = lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll));
-        else
-            a = lv_ll_get_next(&LV_GC_ROOT(_lv_anim_ll), a);
+        if(group && (anim_next == NULL || anim_next->var != var)) {
+            lv_obj_batch_commit();
+            group = false;
+        }
+
+        a = anim_next;
     }
 
+    anim_act  = NULL;
+    anim_next = NULL;
+    stepping  = false;
+
     last_task_run = lv_tick_get();
+
+    /*Don't wake up the task handler while there is nothing to animate*/
+    if(lv_ll_get_head(&LV_GC_ROOT(_lv_anim_ll)) == NULL) lv_task_pause(anim_task_p);
+}
+
+#if LV_ANIM_PATH_LUT
+/**
+ * Fill the tables of the paths by evaluating them in every `1 << LV_ANIM_LUT_SHIFT` step
+ */
+static void anim_path_lut_init(void)
+{
+    static const lv_anim_path_cb_t paths[_LV_ANIM_LUT_NUM] = {
+        lv_anim_path_ease_in, lv_anim_path_ease_out, lv_anim_path_ease_in_out,
+        lv_anim_path_overshoot, lv_anim_path_bounce,
+    };
+
+    /*An animation from 0 to 1024 in 1024 ms gives the path's value in every step*/
+    lv_anim_t a;
+    lv_anim_init(&a);
+    a.start = 0;
+    a.end   = LV_ANIM_RESOLUTION;
+    a.time  = LV_ANIM_RESOLUTION;
+
+    path_lut_ready = false;
+    uint8_t p;
+    uint16_t i;
+    for(p = 0; p < _LV_ANIM_LUT_NUM; p++) {
+        for(i = 0; i < LV_ANIM_LUT_CNT; i++) {
+            a.act_time     = i << LV_ANIM_LUT_SHIFT;
+            path_lut[p][i] = paths[p](&a);
+        }
+    }
+    path_lut_ready = true;
 }
 
+/**
+ * Calculate the current value of an animation by interpolating between the entries of a path table
+ * @param a pointer to an animation
+ * @param lut the table of the path
+ * @return the current value to set
+ */
+static lv_anim_value_t anim_path_lut(const lv_anim_t * a, const int16_t * lut)
+{
+    uint32_t t;
+    if(a->time == a->act_time)
+        t = LV_ANIM_RESOLUTION;
+    else
+        t = (uint32_t)((uint32_t)a->act_time * LV_ANIM_RESOLUTION) / a->time;
+
+    uint32_t i   = t >> LV_ANIM_LUT_SHIFT;
+    int32_t step = lut[i];
+    if(i < LV_ANIM_LUT_CNT - 1) {
+        int32_t rem = t & ((1 << LV_ANIM_LUT_SHIFT) - 1);
+        step += ((lut[i + 1] - step) * rem) >> LV_ANIM_LUT_SHIFT;
+    }
+
+    int32_t new_value;
+    new_value = step * (a->end - a->start);
+    new_value = new_value >> LV_ANIM_RES_SHIFT;
+    new_value += a->start;
+
+    return (lv_anim_value_t)new_value;
+}
+#endif
+
 /**
  * Called when an animation is ready to do the necessary thinks
  * e.g. repeat, play back, delete etc.
  * @param a pointer to an animation descriptor
- * @return true: animation delete occurred nnd the `LV_GC_ROOT(_lv_anim_ll)` has changed
  * */
-static bool anim_ready_handler(lv_anim_t * a)
+static void anim_ready_handler(lv_anim_t * a)
 {
 
     /*Delete the animation if
@@ -444,8 +637,7 @@ static bool anim_ready_handler(lv_anim_t * a)
         lv_anim_t a_tmp;
         memcpy(&a_tmp, a, sizeof(lv_anim_t));
         lv_ll_rem(&LV_GC_ROOT(_lv_anim_ll), a);
-        lv_mem_free(a);
-        anim_list_changed = true;
+        lv_ll_free(&LV_GC_ROOT(_lv_anim_ll), a);
 
         /* Call the callback function at the end*/
         if(a_tmp.ready_cb != NULL) a_tmp.ready_cb(&a_tmp);
@@ -467,7 +659,5 @@ static bool anim_ready_handler(lv_anim_t * a)
             a->end   = tmp;
         }
     }
-
-    return anim_list_changed;
 }
 #endif
@@ -85,7 +85,6 @@ typedef struct _lv_anim_t
     uint8_t repeat : 1;   /**< Repeat the animation infinitely*/
     /*Animation system use these - user shouldn't set*/
     uint8_t playback_now : 1; /**< Play back is in progress*/
-    uint32_t has_run : 1;     /**< Indicates the animation has run in this round*/
 } lv_anim_t;
 
 
@@ -289,6 +288,18 @@ static inline bool lv_anim_custom_del(lv_anim_t * a, lv_anim_custom_exec_cb_t ex
  */
 uint16_t lv_anim_count_running(void);
 
+/**
+ * Set how often the animations are stepped. Typically the refresh period of the display.
+ * @param period the period [ms]
+ */
+void lv_anim_set_period(uint32_t period);
+
+/**
+ * Get when the changes made now were due. During a late step of the animations it's earlier than now.
+ * @return the tick of the due time
+ */
+uint32_t lv_anim_get_step_due(void);
+
 /**
  * Calculate the time of an animation with a given speed and the start and end values
  * @param speed speed of animation in unit/sec
@@ -348,6 +359,14 @@ lv_anim_value_t lv_anim_path_bounce(const lv_anim_t * a);
  */
 lv_anim_value_t lv_anim_path_step(const lv_anim_t * a);
 
+#if LV_ANIM_PATH_LUT
+/**
+ * Evaluate the eased paths from their tables or compute them in every step, e.g. to compare the two
+ * @param en true: from the tables (default); false: compute them
+ */
+void lv_anim_path_set_lut(bool en);
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -0,0 +1,186 @@
+/**
+ * @file lv_async.c
+ * A bounded multi-producer single-consumer queue. Every cell has a sequence number which tells
+ * whether it's free for the position of a producer or it's filled for the consumer.
+ * The producers reserve a position with a compare-and-swap so they never wait for each other.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_async.h"
+#if LV_ASYNC_QUEUE_SIZE
+
+#include "lv_task.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#if (LV_ASYNC_QUEUE_SIZE & (LV_ASYNC_QUEUE_SIZE - 1)) != 0
+#error "LV_ASYNC_QUEUE_SIZE has to be a power of 2"
+#endif
+
+#define QUEUE_MASK (LV_ASYNC_QUEUE_SIZE - 1)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t seq; /*== position: free for the producer of that position; == position + 1: filled*/
+    lv_async_cb_t async_cb;
+    void * user_data;
+} lv_async_cell_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void async_task(lv_task_t * task);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_async_cell_t queue[LV_ASYNC_QUEUE_SIZE];
+static uint32_t enq_pos; /*The next position to fill. Shared by the producers.*/
+static uint32_t deq_pos; /*The next position to read. Used only on the UI thread.*/
+static uint8_t posted;   /*Set after a post, cleared by `async_task`*/
+static lv_async_wake_cb_t async_wake_cb;
+static lv_task_t * async_task_p;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Init the lv_async module
+ */
+void lv_async_init(void)
+{
+    uint32_t i;
+    for(i = 0; i < LV_ASYNC_QUEUE_SIZE; i++) {
+        __atomic_store_n(&queue[i].seq, i, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&enq_pos, 0, __ATOMIC_RELAXED);
+    deq_pos = 0;
+    __atomic_store_n(&posted, 0, __ATOMIC_RELEASE);
+
+    /*Run before the display refresh (`LV_TASK_PRIO_MID`) so the updates of a batch are drawn together*/
+    async_task_p = lv_task_create(async_task, 0, LV_TASK_PRIO_HIGHEST, NULL);
+    lv_task_pause(async_task_p);
+}
+
+/**
+ * Post an update from any thread. `async_cb` will be called on the thread of `lv_task_handler`
+ * before the next refresh, in the order of posting (per thread).
+ * It never blocks. `user_data` shouldn't be allocated with `lv_mem_alloc` by other threads.
+ * @param async_cb the function to call on the UI thread
+ * @param user_data passed to `async_cb`. Typically it's freed by `async_cb`
+ * @return LV_RES_OK: posted; LV_RES_INV: the queue is full (`async_cb` won't be called)
+ */
+lv_res_t lv_async_post(lv_async_cb_t async_cb, void * user_data)
+{
+    lv_async_cell_t * cell;
+    uint32_t pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+    while(1) {
+        cell         = &queue[pos & QUEUE_MASK];
+        uint32_t seq = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        int32_t dif  = (int32_t)(seq - pos);
+        if(dif == 0) {
+            /*The cell is free. Reserve it, or retry with the new position if an other thread was faster.*/
+            if(__atomic_compare_exchange_n(&enq_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(dif < 0) {
+            /*The cell still holds the update of the previous round. (Don't log, it's not the UI thread.)*/
+            return LV_RES_INV;
+        } else {
+            pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->async_cb  = async_cb;
+    cell->user_data = user_data;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+
+    __atomic_store_n(&posted, 1, __ATOMIC_RELEASE);
+    lv_async_wake_cb_t wake_cb = __atomic_load_n(&async_wake_cb, __ATOMIC_ACQUIRE);
+    if(wake_cb) wake_cb();
+
+    return LV_RES_OK;
+}
+
+/**
+ * Set a function to call after every post. E.g. to wake up the main loop waiting for input events.
+ * It's called on the posting thread so it has to be thread safe.
+ * @param wake_cb the function or NULL
+ */
+void lv_async_set_wake_cb(lv_async_wake_cb_t wake_cb)
+{
+    __atomic_store_n(&async_wake_cb, wake_cb, __ATOMIC_RELEASE);
+}
+
+/**
+ * Apply the posted updates immediately. Only on the thread of `lv_task_handler`.
+ * @return number of updates applied
+ */
+uint32_t lv_async_flush(void)
+{
+    uint32_t cnt = 0;
+
+    /*Clear the flag first: what is posted after it is either applied now or sets it again*/
+    __atomic_store_n(&posted, 0, __ATOMIC_SEQ_CST);
+
+    /*Don't apply more than a full queue. Updates posted by the callbacks wait for the next run.*/
+    while(cnt < LV_ASYNC_QUEUE_SIZE) {
+        lv_async_cell_t * cell = &queue[deq_pos & QUEUE_MASK];
+        uint32_t seq           = __atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE);
+        if(seq != deq_pos + 1) break; /*Empty, or the producer hasn't finished writing the cell yet*/
+
+        lv_async_cb_t async_cb = cell->async_cb;
+        void * user_data       = cell->user_data;
+
+        /*Free the cell for the producer of the next round*/
+        __atomic_store_n(&cell->seq, deq_pos + LV_ASYNC_QUEUE_SIZE, __ATOMIC_RELEASE);
+        deq_pos++;
+
+        async_cb(user_data);
+        cnt++;
+    }
+
+    if(cnt == LV_ASYNC_QUEUE_SIZE) __atomic_store_n(&posted, 1, __ATOMIC_RELEASE);
+
+    return cnt;
+}
+
+/**
+ * Resume the task applying the updates if something was posted since its last run.
+ * Called by `lv_task_handler`.
+ */
+void lv_async_wake_check(void)
+{
+    if(async_task_p == NULL) return;
+    if(__atomic_load_n(&posted, __ATOMIC_ACQUIRE) == 0) return;
+
+    lv_task_resume(async_task_p);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Apply the posted updates and sleep until the next post
+ * @param task pointer to the task itself
+ */
+static void async_task(lv_task_t * task)
+{
+    lv_async_flush();
+
+    if(__atomic_load_n(&posted, __ATOMIC_ACQUIRE) == 0) lv_task_pause(task);
+}
+
+#endif /*LV_ASYNC_QUEUE_SIZE*/
@@ -0,0 +1,96 @@
+/**
+ * @file lv_async.h
+ * Pass updates from other threads to the thread calling `lv_task_handler`.
+ * The other threads post callbacks into a bounded lock-free queue
+ * and a high priority lv_task calls them on the UI thread.
+ */
+
+#ifndef LV_ASYNC_H
+#define LV_ASYNC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+#include "lv_types.h"
+
+#if LV_ASYNC_QUEUE_SIZE
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * An update to apply on the UI thread
+ * @param user_data the `user_data` parameter of `lv_async_post`
+ */
+typedef void (*lv_async_cb_t)(void * user_data);
+
+/**
+ * Called by `lv_async_post` on the posting thread to interrupt the sleep of the UI thread
+ */
+typedef void (*lv_async_wake_cb_t)(void);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Init the lv_async module
+ */
+void lv_async_init(void);
+
+/**
+ * Post an update from any thread. `async_cb` will be called on the thread of `lv_task_handler`
+ * before the next refresh, in the order of posting (per thread).
+ * It never blocks. `user_data` shouldn't be allocated with `lv_mem_alloc` by other threads.
+ * @param async_cb the function to call on the UI thread
+ * @param user_data passed to `async_cb`. Typically it's freed by `async_cb`
+ * @return LV_RES_OK: posted; LV_RES_INV: the queue is full (`async_cb` won't be called)
+ */
+lv_res_t lv_async_post(lv_async_cb_t async_cb, void * user_data);
+
+/**
+ * Set a function to call after every post. E.g. to wake up the main loop waiting for input events.
+ * It's called on the posting thread so it has to be thread safe.
+ * @param wake_cb the function or NULL
+ */
+void lv_async_set_wake_cb(lv_async_wake_cb_t wake_cb);
+
+/**
+ * Apply the posted updates immediately. Only on the thread of `lv_task_handler`.
+ * @return number of updates applied
+ */
+uint32_t lv_async_flush(void);
+
+/**
+ * Resume the task applying the updates if something was posted since its last run.
+ * Called by `lv_task_handler`.
+ */
+void lv_async_wake_check(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_ASYNC_QUEUE_SIZE*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_ASYNC_H*/
@@ -29,15 +29,37 @@
 #undef free
 #endif
 
+#define LV_FS_CACHE_EMPTY 0xFFFFFFFF
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    uint32_t start; /*Position of the block in the file, LV_FS_CACHE_EMPTY: unused*/
+    uint32_t len;   /*The bytes read into it, less than the block size at the end of the file*/
+    uint32_t used;  /*Stamp of the last read from it, the least recently used block is replaced*/
+    uint8_t * data;
+} lv_fs_cache_block_t;
+
+typedef struct _lv_fs_cache_t
+{
+    uint32_t pos;     /*Position of the reads and seeks of the user*/
+    uint32_t drv_pos; /*Position of the driver, it's seeked only if it's not where the next read starts*/
+    uint32_t stamp;
+    uint16_t block_size;
+    uint8_t block_cnt;
+    lv_fs_cache_block_t * blocks; /*Right after it in the same allocation, followed by the data of the blocks*/
+} lv_fs_cache_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static const char * lv_fs_get_real_path(const char * path);
 static lv_fs_drv_t * lv_fs_get_drv(char letter);
+static void lv_fs_cache_create(lv_fs_file_t * file_p);
+static lv_fs_res_t lv_fs_cache_read(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br);
+static lv_fs_res_t lv_fs_drv_read_at(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br);
 
 /**********************
  *  STATIC VARIABLES
@@ -56,7 +78,7 @@ static lv_fs_drv_t * lv_fs_get_drv(char letter);
  */
 void lv_fs_init(void)
 {
-    lv_ll_init(&LV_GC_ROOT(_lv_drv_ll), sizeof(lv_fs_drv_t));
+    lv_ll_init(&LV_GC_SHARED_ROOT(_lv_drv_ll), sizeof(lv_fs_drv_t));
 }
 
 /**
@@ -87,6 +109,7 @@ lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mo
 {
     file_p->drv    = NULL;
     file_p->file_d = NULL;
+    file_p->cache  = NULL;
 
     if(path == NULL) return LV_FS_RES_INV_PARAM;
 
@@ -125,8 +148,12 @@ lv_fs_res_t lv_fs_open(lv_fs_file_t * file_p, const char * path, lv_fs_mode_t mo
         lv_mem_free(file_p->file_d);
         file_p->file_d = NULL;
         file_p->drv    = NULL;
+        return res;
     }
 
+    /*Only read only files are cached, so the cache never has to be written back*/
+    if(mode == LV_FS_MODE_RD) lv_fs_cache_create(file_p);
+
     return res;
 }
 
@@ -147,6 +174,8 @@ lv_fs_res_t lv_fs_close(lv_fs_file_t * file_p)
 
     lv_fs_res_t res = file_p->drv->close_cb(file_p->drv, file_p->file_d);
 
+    if(file_p->cache != NULL) lv_mem_free(file_p->cache);
+    file_p->cache = NULL;
     lv_mem_free(file_p->file_d); /*Clean up*/
     file_p->file_d = NULL;
     file_p->drv    = NULL;
@@ -196,7 +225,9 @@ lv_fs_res_t lv_fs_read(lv_fs_file_t * file_p, void * buf, uint32_t btr, uint32_t
     if(file_p->drv->read_cb == NULL) return LV_FS_RES_NOT_IMP;
 
     uint32_t br_tmp = 0;
-    lv_fs_res_t res = file_p->drv->read_cb(file_p->drv, file_p->file_d, buf, btr, &br_tmp);
+    lv_fs_res_t res;
+    if(file_p->cache != NULL) res = lv_fs_cache_read(file_p, buf, btr, &br_tmp);
+    else res = file_p->drv->read_cb(file_p->drv, file_p->file_d, buf, btr, &br_tmp);
     if(br != NULL) *br = br_tmp;
 
     return res;
@@ -222,6 +253,8 @@ lv_fs_res_t lv_fs_write(lv_fs_file_t * file_p, const void * buf, uint32_t btw, u
         return LV_FS_RES_NOT_IMP;
     }
 
+    if(file_p->cache != NULL) return LV_FS_RES_DENIED; /*Opened only for reading*/
+
     uint32_t bw_tmp = 0;
     lv_fs_res_t res = file_p->drv->write_cb(file_p->drv, file_p->file_d, buf, btw, &bw_tmp);
     if(bw != NULL) *bw = bw_tmp;
@@ -245,6 +278,12 @@ lv_fs_res_t lv_fs_seek(lv_fs_file_t * file_p, uint32_t pos)
         return LV_FS_RES_NOT_IMP;
     }
 
+    /*The driver is seeked by the next read if it has to go to the driver*/
+    if(file_p->cache != NULL) {
+        file_p->cache->pos = pos;
+        return LV_FS_RES_OK;
+    }
+
     lv_fs_res_t res = file_p->drv->seek_cb(file_p->drv, file_p->file_d, pos);
 
     return res;
@@ -263,6 +302,11 @@ lv_fs_res_t lv_fs_tell(lv_fs_file_t * file_p, uint32_t * pos)
         return LV_FS_RES_INV_PARAM;
     }
 
+    if(file_p->cache != NULL) {
+        *pos = file_p->cache->pos;
+        return LV_FS_RES_OK;
+    }
+
     if(file_p->drv->tell_cb == NULL) {
         pos = 0;
         return LV_FS_RES_NOT_IMP;
@@ -285,10 +329,12 @@ lv_fs_res_t lv_fs_trunc(lv_fs_file_t * file_p)
         return LV_FS_RES_INV_PARAM;
     }
 
-    if(file_p->drv->tell_cb == NULL) {
+    if(file_p->drv->trunc_cb == NULL) {
         return LV_FS_RES_NOT_IMP;
     }
 
+    if(file_p->cache != NULL) return LV_FS_RES_DENIED; /*Opened only for reading*/
+
     lv_fs_res_t res = file_p->drv->trunc_cb(file_p->drv, file_p->file_d);
 
     return res;
@@ -314,6 +360,23 @@ lv_fs_res_t lv_fs_size(lv_fs_file_t * file_p, uint32_t * size)
     return res;
 }
 
+/**
+ * Get the whole content of a file in memory without copying it.
+ * Only drivers with `map_cb` can do it, e.g. ones which `mmap` the files.
+ * @param file_p pointer to a lv_fs_file_t variable
+ * @param ptr_p pointer to a variable to store the address of the content. It's valid until the file is closed.
+ * @param size_p pointer to a variable to store the size of the content
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum (LV_FS_RES_NOT_IMP if the driver can't map files)
+ */
+lv_fs_res_t lv_fs_map(lv_fs_file_t * file_p, const void ** ptr_p, uint32_t * size_p)
+{
+    if(file_p->drv == NULL || ptr_p == NULL || size_p == NULL) return LV_FS_RES_INV_PARAM;
+
+    if(file_p->drv->map_cb == NULL) return LV_FS_RES_NOT_IMP;
+
+    return file_p->drv->map_cb(file_p->drv, file_p->file_d, ptr_p, size_p);
+}
+
 /**
  * Rename a file
  * @param oldname path to the file
@@ -475,6 +538,9 @@ lv_fs_res_t lv_fs_free_space(char letter, uint32_t * total_p, uint32_t * free_p)
 void lv_fs_drv_init(lv_fs_drv_t * drv)
 {
     memset(drv, 0, sizeof(lv_fs_drv_t));
+
+    drv->cache_block_size = LV_FS_CACHE_BLOCK_SIZE;
+    drv->cache_block_cnt  = LV_FS_CACHE_BLOCK_CNT;
 }
 
 /**
@@ -486,7 +552,7 @@ void lv_fs_drv_register(lv_fs_drv_t * drv_p)
 {
     /*Save the new driver*/
     lv_fs_drv_t * new_drv;
-    new_drv = lv_ll_ins_head(&LV_GC_ROOT(_lv_drv_ll));
+    new_drv = lv_ll_ins_head(&LV_GC_SHARED_ROOT(_lv_drv_ll));
     lv_mem_assert(new_drv);
     if(new_drv == NULL) return;
 
@@ -503,7 +569,7 @@ char * lv_fs_get_letters(char * buf)
     lv_fs_drv_t * drv;
     uint8_t i = 0;
 
-    LV_LL_READ(LV_GC_ROOT(_lv_drv_ll), drv)
+    LV_LL_READ(LV_GC_SHARED_ROOT(_lv_drv_ll), drv)
     {
         buf[i] = drv->letter;
         i++;
@@ -630,7 +696,7 @@ static lv_fs_drv_t * lv_fs_get_drv(char letter)
 {
     lv_fs_drv_t * drv;
 
-    LV_LL_READ(LV_GC_ROOT(_lv_drv_ll), drv)
+    LV_LL_READ(LV_GC_SHARED_ROOT(_lv_drv_ll), drv)
     {
         if(drv->letter == letter) {
             return drv;
@@ -640,4 +706,133 @@ static lv_fs_drv_t * lv_fs_get_drv(char letter)
     return NULL;
 }
 
+/**
+ * Add the read cache to a file opened for reading, with the block size and count of its driver.
+ * Without memory for it the file is read without a cache.
+ * @param file_p pointer to a just opened lv_fs_file_t variable
+ */
+static void lv_fs_cache_create(lv_fs_file_t * file_p)
+{
+    lv_fs_drv_t * drv = file_p->drv;
+    if(drv->cache_block_size == 0 || drv->cache_block_cnt == 0) return;
+    if(drv->read_cb == NULL || drv->seek_cb == NULL) return;
+
+    uint32_t blocks_size = sizeof(lv_fs_cache_block_t) * drv->cache_block_cnt;
+    uint32_t data_size   = (uint32_t)drv->cache_block_size * drv->cache_block_cnt;
+    lv_fs_cache_t * cache = lv_mem_alloc(sizeof(lv_fs_cache_t) + blocks_size + data_size);
+    if(cache == NULL) {
+        LV_LOG_WARN("lv_fs_open: no memory for the read cache, the file is not cached");
+        return;
+    }
+
+    cache->pos        = 0;
+    cache->drv_pos    = 0;
+    cache->stamp      = 0;
+    cache->block_size = drv->cache_block_size;
+    cache->block_cnt  = drv->cache_block_cnt;
+    cache->blocks     = (lv_fs_cache_block_t *)(cache + 1);
+
+    uint8_t * data = (uint8_t *)cache->blocks + blocks_size;
+    uint8_t i;
+    for(i = 0; i < cache->block_cnt; i++) {
+        cache->blocks[i].start = LV_FS_CACHE_EMPTY;
+        cache->blocks[i].len   = 0;
+        cache->blocks[i].used  = 0;
+        cache->blocks[i].data  = data + (uint32_t)i * cache->block_size;
+    }
+
+    file_p->cache = cache;
+}
+
+/**
+ * Read from a cached file. The reads smaller than a block are served from the cache,
+ * the bigger ones are read directly into `buf`.
+ * @param file_p pointer to a cached lv_fs_file_t variable
+ * @param buf pointer to a buffer where the read bytes are stored
+ * @param btr Bytes To Read
+ * @param br the number of real read bytes (Bytes Read)
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum
+ */
+static lv_fs_res_t lv_fs_cache_read(lv_fs_file_t * file_p, uint8_t * buf, uint32_t btr, uint32_t * br)
+{
+    lv_fs_cache_t * cache = file_p->cache;
+    *br = 0;
+
+    while(btr > 0) {
+        /*Find the block of the position and the least recently used one to replace if there is none*/
+        lv_fs_cache_block_t * hit    = NULL;
+        lv_fs_cache_block_t * victim = &cache->blocks[0];
+        uint8_t i;
+        for(i = 0; i < cache->block_cnt; i++) {
+            lv_fs_cache_block_t * b = &cache->blocks[i];
+            if(b->start != LV_FS_CACHE_EMPTY && cache->pos >= b->start && cache->pos - b->start < cache->block_size) {
+                hit = b;
+                break;
+            }
+            if(b->used < victim->used) victim = b;
+        }
+
+        if(hit != NULL) {
+            uint32_t ofs = cache->pos - hit->start;
+            if(ofs >= hit->len) break; /*The end of the file*/
+
+            uint32_t n = hit->len - ofs;
+            if(n > btr) n = btr;
+            memcpy(buf, hit->data + ofs, n);
+            hit->used = ++cache->stamp;
+            buf += n;
+            btr -= n;
+            *br += n;
+            cache->pos += n;
+            continue;
+        }
+
+        /*Caching a read of a block or more wouldn't save anything but push out the useful blocks*/
+        if(btr >= cache->block_size) {
+            uint32_t n      = 0;
+            lv_fs_res_t res = lv_fs_drv_read_at(file_p, cache->pos, buf, btr, &n);
+            *br += n;
+            cache->pos += n;
+            return res;
+        }
+
+        uint32_t start  = cache->pos - cache->pos % cache->block_size;
+        victim->start   = LV_FS_CACHE_EMPTY;
+        lv_fs_res_t res = lv_fs_drv_read_at(file_p, start, victim->data, cache->block_size, &victim->len);
+        if(res != LV_FS_RES_OK) return res;
+        victim->start = start;
+    }
+
+    return LV_FS_RES_OK;
+}
+
+/**
+ * Read from the driver of a cached file at a position. The driver is seeked only if it's not there.
+ * @param file_p pointer to a cached lv_fs_file_t variable
+ * @param pos position in the file
+ * @param buf pointer to a buffer where the read bytes are stored
+ * @param btr Bytes To Read
+ * @param br the number of real read bytes (Bytes Read)
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum
+ */
+static lv_fs_res_t lv_fs_drv_read_at(lv_fs_file_t * file_p, uint32_t pos, void * buf, uint32_t btr, uint32_t * br)
+{
+    lv_fs_cache_t * cache = file_p->cache;
+    lv_fs_drv_t * drv     = file_p->drv;
+    lv_fs_res_t res;
+    *br = 0;
+
+    if(cache->drv_pos != pos) {
+        cache->drv_pos = LV_FS_CACHE_EMPTY; /*Unknown if the seek fails*/
+        res            = drv->seek_cb(drv, file_p->file_d, pos);
+        if(res != LV_FS_RES_OK) return res;
+        cache->drv_pos = pos;
+    }
+
+    res            = drv->read_cb(drv, file_p->file_d, buf, btr, br);
+    cache->drv_pos = res == LV_FS_RES_OK ? pos + *br : LV_FS_CACHE_EMPTY;
+
+    return res;
+}
+
 #endif /*LV_USE_FILESYSTEM*/
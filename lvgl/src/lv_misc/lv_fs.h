@@ -67,6 +67,8 @@ typedef struct _lv_fs_drv_t
     char letter;
     uint16_t file_size;
     uint16_t rddir_size;
+    uint16_t cache_block_size;  /*Read through a cache of this block size, 0: don't cache (`LV_FS_CACHE_BLOCK_SIZE` by default)*/
+    uint8_t cache_block_cnt;    /*Blocks per file opened for reading (`LV_FS_CACHE_BLOCK_CNT` by default)*/
     bool (*ready_cb)(struct _lv_fs_drv_t * drv);
 
     lv_fs_res_t (*open_cb)(struct _lv_fs_drv_t * drv, void * file_p, const char * path, lv_fs_mode_t mode);
@@ -78,6 +80,8 @@ typedef struct _lv_fs_drv_t
     lv_fs_res_t (*tell_cb)(struct _lv_fs_drv_t * drv, void * file_p, uint32_t * pos_p);
     lv_fs_res_t (*trunc_cb)(struct _lv_fs_drv_t * drv, void * file_p);
     lv_fs_res_t (*size_cb)(struct _lv_fs_drv_t * drv, void * file_p, uint32_t * size_p);
+    /*Optional: give the whole file in memory (e.g. `mmap`ed or in memory mapped flash). Valid until it's closed.*/
+    lv_fs_res_t (*map_cb)(struct _lv_fs_drv_t * drv, void * file_p, const void ** ptr_p, uint32_t * size_p);
     lv_fs_res_t (*rename_cb)(struct _lv_fs_drv_t * drv, const char * oldname, const char * newname);
     lv_fs_res_t (*free_space_cb)(struct _lv_fs_drv_t * drv, uint32_t * total_p, uint32_t * free_p);
 
@@ -90,10 +94,13 @@ typedef struct _lv_fs_drv_t
 #endif
 } lv_fs_drv_t;
 
+struct _lv_fs_cache_t;
+
 typedef struct
 {
     void * file_d;
     lv_fs_drv_t * drv;
+    struct _lv_fs_cache_t * cache; /*The read cache; NULL if the file is not cached*/
 } lv_fs_file_t;
 
 typedef struct
@@ -209,6 +216,16 @@ lv_fs_res_t lv_fs_trunc(lv_fs_file_t * file_p);
  */
 lv_fs_res_t lv_fs_size(lv_fs_file_t * file_p, uint32_t * size);
 
+/**
+ * Get the whole content of a file in memory without copying it.
+ * Only drivers with `map_cb` can do it, e.g. ones which `mmap` the files.
+ * @param file_p pointer to a lv_fs_file_t variable
+ * @param ptr_p pointer to a variable to store the address of the content. It's valid until the file is closed.
+ * @param size_p pointer to a variable to store the size of the content
+ * @return LV_FS_RES_OK or any error from lv_fs_res_t enum (LV_FS_RES_NOT_IMP if the driver can't map files)
+ */
+lv_fs_res_t lv_fs_map(lv_fs_file_t * file_p, const void ** ptr_p, uint32_t * size_p);
+
 /**
  * Rename a file
  * @param oldname path to the file
@@ -24,7 +24,9 @@
 /**********************
  *  STATIC VARIABLES
  **********************/
-#if(!defined(LV_ENABLE_GC)) || LV_ENABLE_GC == 0
+#if LV_USE_CONTEXT
+LV_GC_SHARED_ROOTS(LV_NO_PREFIX) /*The others are in the contexts*/
+#elif(!defined(LV_ENABLE_GC)) || LV_ENABLE_GC == 0
 LV_ROOTS
 #endif /* LV_ENABLE_GC */
 /**********************
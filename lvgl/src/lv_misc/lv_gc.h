@@ -25,23 +25,31 @@ extern "C" {
 #include "lv_mem.h"
 #include "lv_ll.h"
 #include "../lv_draw/lv_img_cache.h"
+#include "../lv_core/lv_context.h"
+#include "lv_thread.h"
 
 /*********************
  *      DEFINES
  *********************/
 
-#define LV_GC_ROOTS(prefix)                                                                                            \
+#define LV_GC_ROOTS(prefix) LV_GC_CONTEXT_ROOTS(prefix) LV_GC_SHARED_ROOTS(prefix)
+
+/*The roots of a LittlevGL instance, in its context with `LV_USE_CONTEXT`*/
+#define LV_GC_CONTEXT_ROOTS(prefix)                                                                                    \
     prefix lv_ll_t _lv_task_ll;  /*Linked list to store the lv_tasks*/                                                 \
     prefix lv_ll_t _lv_disp_ll;  /*Linked list of screens*/                                                            \
     prefix lv_ll_t _lv_indev_ll; /*Linked list of screens*/                                                            \
-    prefix lv_ll_t _lv_drv_ll;                                                                                         \
-    prefix lv_ll_t _lv_file_ll;                                                                                        \
     prefix lv_ll_t _lv_anim_ll;                                                                                        \
     prefix lv_ll_t _lv_group_ll;                                                                                       \
-    prefix lv_ll_t _lv_img_defoder_ll;                                                                                 \
-    prefix lv_img_cache_entry_t * _lv_img_cache_array;                                                                 \
     prefix void * _lv_task_act;
 
+/*The roots shared by the instances: the file system drivers, the image decoders and the image cache*/
+#define LV_GC_SHARED_ROOTS(prefix)                                                                                     \
+    prefix lv_ll_t _lv_drv_ll;                                                                                         \
+    prefix lv_ll_t _lv_file_ll;                                                                                        \
+    prefix lv_ll_t _lv_img_defoder_ll;                                                                                 \
+    prefix lv_img_cache_entry_t * _lv_img_cache_array;
+
 #define LV_NO_PREFIX
 #define LV_ROOTS LV_GC_ROOTS(LV_NO_PREFIX)
 
@@ -49,14 +57,49 @@ extern "C" {
 #if LV_MEM_CUSTOM != 1
 #error "GC requires CUSTOM_MEM"
 #endif /* LV_MEM_CUSTOM */
+#if LV_USE_CONTEXT
+#error "LV_USE_CONTEXT can't be used with LV_ENABLE_GC"
+#endif
+#define LV_GC_SHARED_ROOT(x) LV_GC_ROOT(x)
+#elif LV_USE_CONTEXT
+#if LV_REFR_THREADS < 2
+#error "LV_USE_CONTEXT requires LV_REFR_THREADS > 1"
+#endif
+#define LV_GC_ROOT(x) (lv_context_act->x)
+#define LV_GC_SHARED_ROOT(x) x
+LV_GC_SHARED_ROOTS(extern)
 #else  /* LV_ENABLE_GC */
 #define LV_GC_ROOT(x) x
+#define LV_GC_SHARED_ROOT(x) x
 LV_GC_ROOTS(extern)
 #endif /* LV_ENABLE_GC */
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_CONTEXT
+/**
+ * The state of a LittlevGL instance. The modules keep their global variables here:
+ * the `state` of a module is allocated by its init function (called by `lv_context_create`)
+ * and freed by `lv_context_del`.
+ */
+struct _lv_context_t
+{
+    LV_GC_CONTEXT_ROOTS(LV_NO_PREFIX)
+    void * obj_state;   /**< lv_obj.c: layouts, batches and the events being sent*/
+    void * refr_state;  /**< lv_refr.c: the display being refreshed*/
+    void * task_state;  /**< lv_task.c: the task heaps*/
+    void * anim_state;  /**< lv_anim.c: the animation being stepped*/
+    struct _lv_indev_t * indev_act;  /**< lv_indev.c: the input device being read*/
+    struct _lv_obj_t * indev_obj_act; /**< lv_indev.c: the object the input device is sending events to*/
+    struct _disp_t * disp_def;        /**< lv_hal_disp.c: the default display*/
+    void * layer_state; /**< lv_layer.c: the cached bitmaps*/
+    void * hit_state;   /**< lv_hit.c: the hit indexes*/
+    void * prof_state;  /**< lv_prof.c: the refresh being measured*/
+};
+
+extern LV_THREAD_LOCAL lv_context_t * lv_context_act;
+#endif
 
 /**********************
  * GLOBAL PROTOTYPES
@@ -2,6 +2,7 @@
  * @file lv_ll.c
  * Handle linked lists.
  * The nodes are dynamically allocated by the 'lv_mem' module,
+ * or taken from a pool of same sized nodes which is filled by chunks from 'lv_mem'.
  */
 
 /*********************
@@ -12,6 +13,7 @@
 
 #include "lv_ll.h"
 #include "lv_mem.h"
+#include "lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -20,19 +22,44 @@
 #define LL_PREV_P_OFFSET(ll_p) (ll_p->n_size)
 #define LL_NEXT_P_OFFSET(ll_p) (ll_p->n_size + sizeof(lv_ll_node_t *))
 
+/*Number of node sizes with pool. The lists of other sizes allocate their nodes*/
+#define LL_POOL_MAX 8
+
+/*The pools are shared by the contexts which can run on parallel threads*/
+#if LV_USE_CONTEXT
+#define LL_POOL_LOCK() lv_thread_lock()
+#define LL_POOL_UNLOCK() lv_thread_unlock()
+#else
+#define LL_POOL_LOCK()
+#define LL_POOL_UNLOCK()
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_USE_LL_POOL
+/*The free nodes of a node size. They are linked by their first pointer.*/
+typedef struct _lv_ll_pool_t
+{
+    uint32_t size; /*Of a node with the prev. and next pointers*/
+    lv_ll_node_t * free;
+} lv_ll_pool_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static void node_set_prev(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * prev);
 static void node_set_next(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * next);
+static lv_ll_node_t * node_alloc(lv_ll_t * ll_p);
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+#if LV_USE_LL_POOL
+static lv_ll_pool_t pools[LL_POOL_MAX];
+static uint8_t pool_cnt;
+#endif
 
 /**********************
  *      MACROS
@@ -66,6 +93,43 @@ void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size)
 #endif
 
     ll_p->n_size = node_size;
+#if LV_USE_LL_POOL
+    ll_p->pool = NULL;
+#endif
+}
+
+/**
+ * Initialize a linked list whose nodes come from the pool of the nodes of this size.
+ * Its nodes have to be freed with `lv_ll_free` (or `lv_ll_clear`) and can be moved only to lists
+ * with the same node size also initialized with this function.
+ * Without `LV_USE_LL_POOL` it's `lv_ll_init`.
+ * @param ll_p pointer to ll_dsc variable
+ * @param node_size the size of 1 node in bytes
+ */
+void lv_ll_init_pool(lv_ll_t * ll_p, uint32_t node_size)
+{
+    lv_ll_init(ll_p, node_size);
+
+#if LV_USE_LL_POOL
+    uint32_t size = ll_p->n_size + LL_NODE_META_SIZE;
+    uint8_t i;
+    LL_POOL_LOCK();
+    for(i = 0; i < pool_cnt; i++) {
+        if(pools[i].size == size) {
+            ll_p->pool = &pools[i];
+            LL_POOL_UNLOCK();
+            return;
+        }
+    }
+
+    if(pool_cnt < LL_POOL_MAX) {
+        pools[pool_cnt].size = size;
+        pools[pool_cnt].free = NULL;
+        ll_p->pool           = &pools[pool_cnt];
+        pool_cnt++;
+    }
+    LL_POOL_UNLOCK();
+#endif
 }
 
 /**
@@ -77,7 +141,7 @@ void * lv_ll_ins_head(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = node_alloc(ll_p);
 
     if(n_new != NULL) {
         node_set_prev(ll_p, n_new, NULL);       /*No prev. before the new head*/
@@ -113,7 +177,7 @@ void * lv_ll_ins_prev(lv_ll_t * ll_p, void * n_act)
         n_new = lv_ll_ins_head(ll_p);
         if(n_new == NULL) return NULL;
     } else {
-        n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+        n_new = node_alloc(ll_p);
         if(n_new == NULL) return NULL;
 
         n_prev = lv_ll_get_prev(ll_p, n_act);
@@ -135,7 +199,7 @@ void * lv_ll_ins_tail(lv_ll_t * ll_p)
 {
     lv_ll_node_t * n_new;
 
-    n_new = lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+    n_new = node_alloc(ll_p);
     if(n_new == NULL) return NULL;
 
     if(n_new != NULL) {
@@ -187,6 +251,30 @@ void lv_ll_rem(lv_ll_t * ll_p, void * node_p)
     }
 }
 
+/**
+ * Free a node removed from a linked list by `lv_ll_rem`. It goes back to the pool of the list
+ * or to `lv_mem_free` if the list has no pool.
+ * @param ll_p pointer to the linked list of 'node_p' (before `lv_ll_rem`)
+ * @param node_p pointer to the removed node
+ */
+void lv_ll_free(lv_ll_t * ll_p, void * node_p)
+{
+#if LV_USE_LL_POOL
+    if(ll_p->pool != NULL) {
+        lv_ll_pool_t * pool = ll_p->pool;
+        LL_POOL_LOCK();
+        memcpy(node_p, &pool->free, sizeof(lv_ll_node_t *));
+        pool->free = node_p;
+        LL_POOL_UNLOCK();
+        return;
+    }
+#else
+    (void)ll_p; /*Unused*/
+#endif
+
+    lv_mem_free(node_p);
+}
+
 /**
  * Remove and free all elements from a linked list. The list remain valid but become empty.
  * @param ll_p pointer to linked list
@@ -203,14 +291,15 @@ void lv_ll_clear(lv_ll_t * ll_p)
         i_next = lv_ll_get_next(ll_p, i);
 
         lv_ll_rem(ll_p, i);
-        lv_mem_free(i);
+        lv_ll_free(ll_p, i);
 
         i = i_next;
     }
 }
 
 /**
- * Move a node to a new linked list
+ * Move a node to a new linked list. Both of the lists have to allocate their nodes in the same way
+ * (`lv_ll_init` or `lv_ll_init_pool` with the same node size).
  * @param ll_ori_p pointer to the original (old) linked list
  * @param ll_new_p pointer to the new linked list
  * @param node pointer to a node
@@ -428,3 +517,41 @@ static void node_set_next(lv_ll_t * ll_p, lv_ll_node_t * act, lv_ll_node_t * nex
     else
         memset(act + LL_NEXT_P_OFFSET(ll_p), 0, node_p_size);
 }
+
+/**
+ * Allocate a node for a linked list: take it from the pool of the list or allocate it.
+ * An empty pool gets a chunk of LV_LL_POOL_CHUNK nodes. The chunks aren't freed,
+ * the freed nodes wait for the next ones in the pool.
+ * @param ll_p pointer to linked list
+ * @return pointer to the new node or NULL if out of memory
+ */
+static lv_ll_node_t * node_alloc(lv_ll_t * ll_p)
+{
+#if LV_USE_LL_POOL
+    lv_ll_pool_t * pool = ll_p->pool;
+    if(pool != NULL) {
+        LL_POOL_LOCK();
+        if(pool->free == NULL) {
+            lv_ll_node_t * chunk = lv_mem_alloc(pool->size * LV_LL_POOL_CHUNK);
+            if(chunk == NULL) {
+                LL_POOL_UNLOCK();
+                return NULL;
+            }
+
+            uint32_t i;
+            for(i = 0; i < LV_LL_POOL_CHUNK; i++) {
+                lv_ll_node_t * n = chunk + i * pool->size;
+                memcpy(n, &pool->free, sizeof(lv_ll_node_t *));
+                pool->free = n;
+            }
+        }
+
+        lv_ll_node_t * n = pool->free;
+        memcpy(&pool->free, n, sizeof(lv_ll_node_t *));
+        LL_POOL_UNLOCK();
+        return n;
+    }
+#endif
+
+    return lv_mem_alloc(ll_p->n_size + LL_NODE_META_SIZE);
+}
@@ -1,6 +1,7 @@
 /**
  * @file lv_ll.c
- * Handle linked lists. The nodes are dynamically allocated by the 'lv_mem' module.
+ * Handle linked lists. The nodes are dynamically allocated by the 'lv_mem' module
+ * or taken from a pool of same sized nodes (`lv_ll_init_pool`).
  */
 
 #ifndef LV_LL_H
@@ -29,12 +30,17 @@ extern "C" {
 /** Dummy type to make handling easier*/
 typedef uint8_t lv_ll_node_t;
 
+struct _lv_ll_pool_t;
+
 /** Description of a linked list*/
 typedef struct
 {
     uint32_t n_size;
     lv_ll_node_t * head;
     lv_ll_node_t * tail;
+#if LV_USE_LL_POOL
+    struct _lv_ll_pool_t * pool; /**< The nodes are taken from here (NULL: `lv_mem_alloc`)*/
+#endif
 } lv_ll_t;
 
 /**********************
@@ -48,6 +54,16 @@ typedef struct
  */
 void lv_ll_init(lv_ll_t * ll_p, uint32_t node_size);
 
+/**
+ * Initialize a linked list whose nodes come from the pool of the nodes of this size.
+ * Its nodes have to be freed with `lv_ll_free` (or `lv_ll_clear`) and can be moved only to lists
+ * with the same node size also initialized with this function.
+ * Without `LV_USE_LL_POOL` it's `lv_ll_init`.
+ * @param ll_p pointer to ll_dsc variable
+ * @param node_size the size of 1 node in bytes
+ */
+void lv_ll_init_pool(lv_ll_t * ll_p, uint32_t node_size);
+
 /**
  * Add a new head to a linked list
  * @param ll_p pointer to linked list
@@ -78,6 +94,14 @@ void * lv_ll_ins_tail(lv_ll_t * ll_p);
  */
 void lv_ll_rem(lv_ll_t * ll_p, void * node_p);
 
+/**
+ * Free a node removed from a linked list by `lv_ll_rem`. It goes back to the pool of the list
+ * or to `lv_mem_free` if the list has no pool.
+ * @param ll_p pointer to the linked list of 'node_p' (before `lv_ll_rem`)
+ * @param node_p pointer to the removed node
+ */
+void lv_ll_free(lv_ll_t * ll_p, void * node_p);
+
 /**
  * Remove and free all elements from a linked list. The list remain valid but become empty.
  * @param ll_p pointer to linked list
@@ -1,6 +1,9 @@
 /**
  * @file lv_log.c
- *
+ * With `LV_LOG_ASYNC_SIZE` the logs are copied into a ring buffer and printed by a low priority task,
+ * so a log in the drawing doesn't wait for the terminal. The ring is a bounded multi-producer queue like
+ * `lv_async`'s: a cell is free for the producers of round `r` if its `turn` is `2 * r` and filled if `2 * r + 1`,
+ * so the zeroed ring works before `lv_init` too.
  */
 
 /*********************
@@ -9,26 +12,68 @@
 #include "lv_log.h"
 #if LV_USE_LOG
 
-#if LV_LOG_PRINTF
+#if LV_LOG_PRINTF || LV_LOG_ASYNC_SIZE
 #include <stdio.h>
 #endif
+#if LV_LOG_ASYNC_SIZE
+#include <string.h>
+#include "lv_task.h"
+#include "../lv_hal/lv_hal_tick.h"
+#endif
 /*********************
  *      DEFINES
  *********************/
+#if LV_LOG_ASYNC_SIZE
+#if (LV_LOG_ASYNC_SIZE & (LV_LOG_ASYNC_SIZE - 1)) != 0
+#error "LV_LOG_ASYNC_SIZE has to be a power of 2"
+#endif
+
+#define LOG_MASK (LV_LOG_ASYNC_SIZE - 1)
+#define LOG_DSC_LEN 96 /*Longer descriptions are truncated*/
+#endif
 
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_LOG_ASYNC_SIZE
+typedef struct
+{
+    uint32_t turn;    /*See the top of the file*/
+    lv_log_level_t level;
+    const char * file;
+    int line;
+    uint32_t repeats; /*The previous log was repeated this many times before this one*/
+    char dsc[LOG_DSC_LEN];
+} lv_log_cell_t;
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static void log_print(lv_log_level_t level, const char * file, int line, const char * dsc);
+#if LV_LOG_ASYNC_SIZE
+static void log_enqueue(lv_log_level_t level, const char * file, int line, const char * dsc);
+static void log_task(lv_task_t * task);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static lv_log_print_g_cb_t custom_print_cb;
 
+#if LV_LOG_ASYNC_SIZE
+static lv_log_cell_t log_ring[LV_LOG_ASYNC_SIZE];
+static uint32_t enq_pos;      /*The next position to fill. Shared by the producers.*/
+static uint32_t deq_pos;      /*The next position to print. Used only on the UI thread.*/
+static uint8_t logged;        /*Set after a log, cleared by `log_task`*/
+static uint32_t dropped_cnt;  /*Logs lost because the ring was full*/
+static const char * rep_file; /*The last queued log and when it was queued*/
+static int rep_line;
+static uint32_t rep_tick;
+static uint32_t rep_cnt;      /*Repeats of the last queued log which were only counted*/
+static lv_task_t * log_task_p;
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -37,6 +82,72 @@ static lv_log_print_g_cb_t custom_print_cb;
  *   GLOBAL FUNCTIONS
  **********************/
 
+#if LV_LOG_ASYNC_SIZE
+/**
+ * Init the printing of the queued logs. Logs added before are queued too.
+ */
+void lv_log_async_init(void)
+{
+    /*Print after the display refresh (`LV_TASK_PRIO_MID`)*/
+    log_task_p = lv_task_create(log_task, 0, LV_TASK_PRIO_LOWEST, NULL);
+    lv_task_pause(log_task_p);
+    __atomic_store_n(&logged, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Print the queued logs immediately. Only on the thread of `lv_task_handler`.
+ * @return number of logs printed
+ */
+uint32_t lv_log_flush(void)
+{
+    uint32_t cnt = 0;
+
+    /*Clear the flag first: what is logged after it is either printed now or sets it again*/
+    __atomic_store_n(&logged, 0, __ATOMIC_SEQ_CST);
+
+    while(cnt < LV_LOG_ASYNC_SIZE) {
+        lv_log_cell_t * cell = &log_ring[deq_pos & LOG_MASK];
+        uint32_t turn        = (deq_pos / LV_LOG_ASYNC_SIZE) * 2;
+        if(__atomic_load_n(&cell->turn, __ATOMIC_ACQUIRE) != turn + 1) break; /*Empty or being written*/
+
+        if(cell->repeats) {
+            char buf[48];
+            snprintf(buf, sizeof(buf), "The previous log was repeated %u times", (unsigned int)cell->repeats);
+            log_print(LV_LOG_LEVEL_INFO, "lv_log", 0, buf);
+        }
+        log_print(cell->level, cell->file, cell->line, cell->dsc);
+
+        /*Free the cell for the producer of the next round*/
+        __atomic_store_n(&cell->turn, turn + 2, __ATOMIC_RELEASE);
+        deq_pos++;
+        cnt++;
+    }
+
+    uint32_t dropped = __atomic_exchange_n(&dropped_cnt, 0, __ATOMIC_RELAXED);
+    if(dropped) {
+        char buf[48];
+        snprintf(buf, sizeof(buf), "%u logs were dropped", (unsigned int)dropped);
+        log_print(LV_LOG_LEVEL_WARN, "lv_log", 0, buf);
+    }
+
+    if(cnt == LV_LOG_ASYNC_SIZE) __atomic_store_n(&logged, 1, __ATOMIC_RELEASE);
+
+    return cnt;
+}
+
+/**
+ * Resume the task printing the logs if something was logged since its last run.
+ * Called by `lv_task_handler`.
+ */
+void lv_log_wake_check(void)
+{
+    if(log_task_p == NULL) return;
+    if(__atomic_load_n(&logged, __ATOMIC_ACQUIRE) == 0) return;
+
+    lv_task_resume(log_task_p);
+}
+#endif
+
 /**
  * Register custom print/write function to call when a log is added.
  * It can format its "File path", "Line number" and "Description" as required
@@ -60,12 +171,10 @@ void lv_log_add(lv_log_level_t level, const char * file, int line, const char *
     if(level >= _LV_LOG_LEVEL_NUM) return; /*Invalid level*/
 
     if(level >= LV_LOG_LEVEL) {
-
-#if LV_LOG_PRINTF
-        static const char * lvl_prefix[] = {"Trace", "Info", "Warn", "Error"};
-        printf("%s: %s \t(%s #%d)\n", lvl_prefix[level], dsc, file, line);
+#if LV_LOG_ASYNC_SIZE
+        log_enqueue(level, file, line, dsc);
 #else
-        if(custom_print_cb) custom_print_cb(level, file, line, dsc);
+        log_print(level, file, line, dsc);
 #endif
     }
 }
@@ -74,4 +183,76 @@ void lv_log_add(lv_log_level_t level, const char * file, int line, const char *
  *   STATIC FUNCTIONS
  **********************/
 
+static void log_print(lv_log_level_t level, const char * file, int line, const char * dsc)
+{
+#if LV_LOG_PRINTF
+    static const char * lvl_prefix[] = {"Trace", "Info", "Warn", "Error"};
+    printf("%s: %s \t(%s #%d)\n", lvl_prefix[level], dsc, file, line);
+#else
+    if(custom_print_cb) custom_print_cb(level, file, line, dsc);
+#endif
+}
+
+#if LV_LOG_ASYNC_SIZE
+/**
+ * Copy a log into the ring. It never blocks, so it can be called from any thread.
+ */
+static void log_enqueue(lv_log_level_t level, const char * file, int line, const char * dsc)
+{
+    /*Only count the repeats of the same log in a short time (e.g. a warning in every frame).
+     *Races of the threads here only make the counting inexact.*/
+    if(__atomic_load_n(&rep_file, __ATOMIC_RELAXED) == file && __atomic_load_n(&rep_line, __ATOMIC_RELAXED) == line &&
+       lv_tick_elaps(__atomic_load_n(&rep_tick, __ATOMIC_RELAXED)) < LV_LOG_ASYNC_RATE_MS) {
+        __atomic_fetch_add(&rep_cnt, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    lv_log_cell_t * cell;
+    uint32_t pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+    while(1) {
+        cell          = &log_ring[pos & LOG_MASK];
+        uint32_t turn = (pos / LV_LOG_ASYNC_SIZE) * 2;
+        int32_t dif   = (int32_t)(__atomic_load_n(&cell->turn, __ATOMIC_ACQUIRE) - turn);
+        if(dif == 0) {
+            /*The cell is free. Reserve it, or retry with the new position if an other thread was faster.*/
+            if(__atomic_compare_exchange_n(&enq_pos, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if(dif < 0) {
+            /*The cell still holds the log of the previous round*/
+            __atomic_fetch_add(&dropped_cnt, 1, __ATOMIC_RELAXED);
+            return;
+        } else {
+            pos = __atomic_load_n(&enq_pos, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_store_n(&rep_file, file, __ATOMIC_RELAXED);
+    __atomic_store_n(&rep_line, line, __ATOMIC_RELAXED);
+    __atomic_store_n(&rep_tick, lv_tick_get(), __ATOMIC_RELAXED);
+
+    cell->level   = level;
+    cell->file    = file;
+    cell->line    = line;
+    cell->repeats = __atomic_exchange_n(&rep_cnt, 0, __ATOMIC_RELAXED);
+    strncpy(cell->dsc, dsc, LOG_DSC_LEN - 1);
+    cell->dsc[LOG_DSC_LEN - 1] = '\0';
+    __atomic_store_n(&cell->turn, (pos / LV_LOG_ASYNC_SIZE) * 2 + 1, __ATOMIC_RELEASE);
+
+    /*No wake up call: the logs can wait for the next `lv_task_handler`*/
+    __atomic_store_n(&logged, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Print the queued logs and sleep until the next log
+ * @param task pointer to the task itself
+ */
+static void log_task(lv_task_t * task)
+{
+    lv_log_flush();
+
+    if(__atomic_load_n(&logged, __ATOMIC_ACQUIRE) == 0) lv_task_pause(task);
+}
+#endif
+
 #endif /*LV_USE_LOG*/
@@ -48,6 +48,25 @@ typedef void (*lv_log_print_g_cb_t)(lv_log_level_t level, const char *, uint32_t
  * GLOBAL PROTOTYPES
  **********************/
 
+#if LV_LOG_ASYNC_SIZE
+/**
+ * Init the printing of the queued logs. Logs added before are queued too.
+ */
+void lv_log_async_init(void);
+
+/**
+ * Print the queued logs immediately. Only on the thread of `lv_task_handler`.
+ * @return number of logs printed
+ */
+uint32_t lv_log_flush(void);
+
+/**
+ * Resume the task printing the logs if something was logged since its last run.
+ * Called by `lv_task_handler`.
+ */
+void lv_log_wake_check(void);
+#endif
+
 /**
  * Register custom print/write function to call when a log is added.
  * It can format its "File path", "Line number" and "Description" as required
@@ -94,6 +94,32 @@ int32_t lv_bezier3(uint32_t t, int32_t u0, int32_t u1, int32_t u2, int32_t u3)
     return v1 + v2 + v3 + v4;
 }
 
+/**
+ * Calculate the integer square root of a number.
+ * @param x a number
+ * @return the largest integer whose square is not greater than `x`
+ */
+uint32_t lv_sqrt(uint32_t x)
+{
+    uint32_t res = 0;
+    uint32_t bit = (uint32_t)1 << 30;
+
+    while(bit > x) bit >>= 2;
+
+    /*Find the result bit by bit from the highest one*/
+    while(bit != 0) {
+        if(x >= res + bit) {
+            x -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return res;
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -9,12 +9,22 @@
  *********************/
 #include "lv_mem.h"
 #include "lv_math.h"
+#include "lv_thread.h"
+#include <stdbool.h>
 #include <string.h>
 
 #if LV_MEM_CUSTOM != 0
 #include LV_MEM_CUSTOM_INCLUDE
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_GROW
+#include LV_MEM_GROW_INCLUDE
+#endif
+
+/*The functions are defined here, the macros only add the call site*/
+#undef lv_mem_alloc
+#undef lv_mem_realloc
+
 /*********************
  *      DEFINES
  *********************/
@@ -27,6 +37,85 @@
 #define MEM_UNIT uint32_t
 #endif
 
+#if LV_MEM_CUSTOM == 0 && LV_MEM_SLAB_MAX > 0
+#define MEM_SLAB 1
+#else
+#define MEM_SLAB 0
+#endif
+
+#if MEM_SLAB
+#if LV_MEM_SIZE >= (1UL << 29)
+#error "LV_MEM_SIZE has to be smaller than 512 MB with LV_MEM_SLAB_MAX"
+#endif
+
+/*The slab cells are `SLAB_STEP` bytes bigger in every size class*/
+#define SLAB_STEP 8
+#define SLAB_CLASS_CNT ((LV_MEM_SLAB_MAX + SLAB_STEP - 1) / SLAB_STEP)
+#if SLAB_CLASS_CNT > 64
+#error "LV_MEM_SLAB_MAX has to be 512 or smaller"
+#endif
+
+/*Allocate about this much memory for the cells of a chunk but at least `SLAB_CELL_CNT_MIN` cells*/
+#define SLAB_CHUNK_SIZE 1024
+#define SLAB_CELL_CNT_MIN 4
+#endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_TLSF
+#if LV_MEM_SIZE >= (1UL << 30)
+#error "LV_MEM_SIZE has to be smaller than 1 GB with LV_MEM_TLSF"
+#endif
+
+/*The free entries are stored in lists by their size. Every first level (power of 2) range
+ * is divided into TLSF_SL_CNT second level ranges. */
+#define TLSF_SL_CNT_LOG2 4
+#define TLSF_SL_CNT (1U << TLSF_SL_CNT_LOG2)
+
+#ifdef LV_MEM_ENV64
+#define TLSF_ALIGN_LOG2 3
+#else
+#define TLSF_ALIGN_LOG2 2
+#endif
+
+/*The free entries smaller than this are stored only in the first first level list, by their exact size*/
+#define TLSF_FL_SHIFT (TLSF_SL_CNT_LOG2 + TLSF_ALIGN_LOG2)
+#define TLSF_SMALL_SIZE (1U << TLSF_FL_SHIFT)
+#define TLSF_FL_CNT (31 - TLSF_FL_SHIFT)
+
+/*A free entry has to store its list links and its size at its end*/
+#define TLSF_MIN_SIZE (sizeof(lv_mem_free_links_t) + sizeof(MEM_UNIT))
+#define TLSF_LINKS(e) ((lv_mem_free_links_t *)&(e)->first_data)
+#endif
+
+#if LV_MEM_CUSTOM == 0
+#if LV_MEM_REGION_MAX < 1
+#error "LV_MEM_REGION_MAX has to be at least 1"
+#endif
+
+/*The size of a region is limited by the size field of the headers*/
+#define MEM_REGION_SIZE_MAX (1UL << 28)
+
+/*A new region has to hold an allocation of this size besides the headers*/
+#define MEM_REGION_SIZE_MIN 64
+#endif
+
+/*Number of caches which can give back memory (see `lv_mem_shrinker_add`)*/
+#define LV_MEM_SHRINKER_MAX 8
+
+#if LV_MEM_PROF
+#if LV_MEM_CUSTOM != 0 || LV_ENABLE_GC != 0
+#error "LV_MEM_PROF works only with the built-in allocator (LV_MEM_CUSTOM 0, LV_ENABLE_GC 0)"
+#endif
+#if (LV_MEM_PROF_ENT_MAX & (LV_MEM_PROF_ENT_MAX - 1)) != 0 || LV_MEM_PROF_ENT_MAX > 65536
+#error "LV_MEM_PROF_ENT_MAX has to be a power of 2 and 65536 or smaller"
+#endif
+
+/*Fill the table only this much to keep the searches short. The allocations above it are only counted.*/
+#define PROF_ENT_LIMIT (LV_MEM_PROF_ENT_MAX - LV_MEM_PROF_ENT_MAX / 8)
+
+/*Remember the tag of this many files of the call sites*/
+#define PROF_FILE_CACHE_CNT 32
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -38,9 +127,26 @@ typedef union
 {
     struct
     {
-        MEM_UNIT used : 1;    // 1: if the entry is used
-        MEM_UNIT d_size : 31; // Size off the data (1 means 4 bytes)
+        MEM_UNIT used : 1; // 1: if the entry is used
+#if MEM_SLAB
+        MEM_UNIT slab : 1; // 1: the entry is a cell in a slab chunk (see `c`)
+#endif
+#if LV_MEM_CUSTOM == 0 && LV_MEM_TLSF
+        MEM_UNIT prev_free : 1;            // 1: the previous entry in the work memory is free
+        MEM_UNIT d_size : (30 - MEM_SLAB); // Size off the data (1 means 4 bytes)
+#else
+        MEM_UNIT d_size : (31 - MEM_SLAB); // Size off the data (1 means 4 bytes)
+#endif
     } s;
+#if MEM_SLAB
+    struct
+    {
+        MEM_UNIT used : 1;
+        MEM_UNIT slab : 1;
+        MEM_UNIT cls : 6;      // Size class of the cell
+        MEM_UNIT cell_id : 16; // Index of the cell in its chunk
+    } c;
+#endif
     MEM_UNIT header; // The header (used + d_size)
 } lv_mem_header_t;
 
@@ -50,15 +156,108 @@ typedef struct
     uint8_t first_data; /*First data byte in the allocated data (Just for easily create a pointer)*/
 } lv_mem_ent_t;
 
+#if LV_MEM_CUSTOM == 0
+/*A continuous memory managed by the built-in allocator. The entries never span two regions.*/
+typedef struct
+{
+    uint8_t * start;
+    uint32_t size;
+    uint32_t ofs; /*Sum of the sizes of the previous regions, i.e. the offset of the region in all regions*/
+} lv_mem_region_t;
+#endif
+
+#if LV_MEM_CUSTOM == 0 && LV_MEM_TLSF
+/*Stored in the data of the free entries*/
+typedef struct
+{
+    lv_mem_ent_t * next; /*Next free entry in the same size list*/
+    lv_mem_ent_t * prev; /*Previous free entry in the same size list*/
+} lv_mem_free_links_t;
+#endif
+
+#if MEM_SLAB
+/*A block of same sized cells. The cells are stored after it.*/
+typedef struct _lv_mem_slab_chunk_t
+{
+    struct _lv_mem_slab_chunk_t * next; /*Next chunk of the same class with free cells*/
+    struct _lv_mem_slab_chunk_t * prev; /*Previous chunk of the same class with free cells*/
+    lv_mem_ent_t * free_cell;           /*First free cell. The next is stored in its data.*/
+    uint16_t free_cnt;
+    uint16_t cell_cnt;
+} lv_mem_slab_chunk_t;
+#endif
+
 #endif /* LV_ENABLE_GC */
 
+#if LV_MEM_PROF
+/*A recorded allocation in the open addressing hash table of the profiler*/
+typedef struct
+{
+    const char * file;
+    uint32_t ofs; /*Offset of the data in all regions (see `lv_mem_region_t`) + 1. 0: empty slot*/
+    uint32_t size;
+    uint32_t id;
+    uint16_t line;
+    lv_mem_tag_t tag;
+} lv_mem_prof_ent_t;
+
+typedef struct
+{
+    const char * name; /*File name without the extension*/
+    lv_mem_tag_t tag;
+} lv_mem_prof_file_tag_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 #if LV_MEM_CUSTOM == 0
+static bool region_add(void * mem, uint32_t size);
+static uint32_t region_find(const void * p);
+#if LV_MEM_GROW
+static bool region_grow(uint32_t size);
+#endif
 static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e);
+#if LV_MEM_TLSF == 0
+static bool ent_is_adjacent(lv_mem_ent_t * e, lv_mem_ent_t * e_next);
+#endif
+static void * ent_find_alloc(uint32_t size);
+static void ent_release(lv_mem_ent_t * e);
+#if MEM_SLAB
+static void * slab_alloc(uint32_t size);
+static void slab_free(lv_mem_ent_t * e);
+static void slab_chunk_free(uint32_t cls, lv_mem_slab_chunk_t * chunk);
+static uint32_t slab_get_cell_cnt(uint32_t cls);
+#endif
+#if LV_MEM_TLSF
+static void tlsf_init(void);
+static void tlsf_region_init(uint8_t * start, uint32_t size);
+static void * tlsf_alloc(uint32_t size);
+static void tlsf_free(lv_mem_ent_t * e);
+static bool tlsf_resize(lv_mem_ent_t * e, uint32_t size);
+static void tlsf_split(lv_mem_ent_t * e, uint32_t size);
+static lv_mem_ent_t * tlsf_search(uint32_t size);
+static void tlsf_insert(lv_mem_ent_t * e);
+static void tlsf_remove(lv_mem_ent_t * e);
+static void tlsf_mapping(uint32_t size, uint32_t * fl, uint32_t * sl);
+static uint32_t tlsf_fls(uint32_t x);
+static uint32_t tlsf_ffs(uint32_t x);
+#else
 static void * ent_alloc(lv_mem_ent_t * e, uint32_t size);
 static void ent_trunc(lv_mem_ent_t * e, uint32_t size);
+static bool ent_grow(lv_mem_ent_t * e, uint32_t size);
+#endif
+#endif
+#if LV_MEM_PROF
+static void prof_init(void);
+static void prof_add(const void * data);
+static void prof_remove(const void * data);
+static void prof_resize(const void * data);
+static uint32_t prof_find(const void * data);
+static uint32_t prof_get_ofs(const void * data);
+static uint32_t prof_hash(uint32_t ofs);
+static lv_mem_tag_t prof_file_tag(const char * file);
+static void prof_stat_add(lv_mem_tag_t tag, int32_t size);
 #endif
 
 /**********************
@@ -66,10 +265,57 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size);
  **********************/
 #if LV_MEM_CUSTOM == 0
 static uint8_t * work_mem;
+static lv_mem_region_t regions[LV_MEM_REGION_MAX]; /*The first one is `work_mem`*/
+static uint32_t region_cnt;
+static uint32_t mem_total;                          /*Sum of the sizes of the regions*/
+#if LV_MEM_TLSF
+static uint32_t free_fl_map;                                /*Bit `fl` is set if `free_sl_map[fl] != 0`*/
+static uint32_t free_sl_map[TLSF_FL_CNT];                   /*Bit `sl` is set if `free_lists[fl][sl] != NULL`*/
+static lv_mem_ent_t * free_lists[TLSF_FL_CNT][TLSF_SL_CNT]; /*The first free entry of every size range*/
+#endif
+#if MEM_SLAB
+static lv_mem_slab_chunk_t * slab_partial[SLAB_CLASS_CNT]; /*Chunks with free cells in every size class*/
+static uint32_t slab_chunk_cnt;                            /*Number of chunks*/
+static uint32_t slab_used_cnt;                             /*Number of used cells*/
+#endif
+static uint32_t mem_used;                                   /*Allocated data bytes*/
+static uint32_t mem_max_used;                               /*Highest `mem_used` since the last reset*/
+static uint32_t realloc_in_place_cnt;
+static uint32_t realloc_move_cnt;
 #endif
 
 static uint32_t zero_mem; /*Give the address of this variable if 0 byte should be allocated*/
 
+static const lv_mem_shrinker_t * shrinkers[LV_MEM_SHRINKER_MAX];
+static uint8_t shrinker_cnt;
+static uint32_t cache_budget = LV_MEM_CACHE_BUDGET;
+static uint32_t shrink_cnt;
+static bool shrinking; /*A shrinker's allocation mustn't shrink the caches again*/
+
+#if LV_MEM_PROF
+static lv_mem_prof_ent_t prof_ents[LV_MEM_PROF_ENT_MAX];
+static uint32_t prof_ent_cnt;
+static lv_mem_prof_stat_t prof_stats[_LV_MEM_TAG_NUM];
+static uint32_t prof_lost_cnt;  /*Living allocations not in `prof_ents`*/
+static uint32_t prof_next_id;
+static LV_THREAD_LOCAL lv_mem_tag_t prof_tag; /*Set by `lv_mem_tag_set`, every thread (context) tags its own allocations*/
+static const char * prof_file;  /*Call site of the current allocation*/
+static uint32_t prof_line;
+static lv_mem_prof_file_tag_t prof_file_cache[PROF_FILE_CACHE_CNT]; /*The `name` is the `__FILE__` pointer here*/
+
+static const char * prof_tag_names[_LV_MEM_TAG_NUM] = {"other", "obj", "ext", "style", "text",
+                                                       "layout", "anim", "task", "font", "img"};
+
+/*The allocations of these files get their tag if no tag is set*/
+static const lv_mem_prof_file_tag_t prof_file_tags[] = {
+    {"lv_label", LV_MEM_TAG_TEXT},        {"lv_ta", LV_MEM_TAG_TEXT},       {"lv_table", LV_MEM_TAG_TEXT},
+    {"lv_txt", LV_MEM_TAG_TEXT},          {"lv_roller", LV_MEM_TAG_TEXT},   {"lv_tabview", LV_MEM_TAG_TEXT},
+    {"lv_style", LV_MEM_TAG_STYLE},       {"lv_anim", LV_MEM_TAG_ANIM},     {"lv_task", LV_MEM_TAG_TASK},
+    {"lv_font_fmt_txt", LV_MEM_TAG_FONT}, {"lv_font_bin", LV_MEM_TAG_FONT}, {"lv_img", LV_MEM_TAG_IMG},
+    {"lv_img_cache", LV_MEM_TAG_IMG},     {"lv_img_decoder", LV_MEM_TAG_IMG}, {"lv_canvas", LV_MEM_TAG_IMG},
+};
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -93,10 +339,45 @@ void lv_mem_init(void)
     work_mem = (uint8_t *)LV_MEM_ADR;
 #endif
 
-    lv_mem_ent_t * full = (lv_mem_ent_t *)work_mem;
-    full->header.s.used = 0;
-    /*The total mem size id reduced by the first header and the close patterns */
-    full->header.s.d_size = LV_MEM_SIZE - sizeof(lv_mem_header_t);
+#if LV_MEM_TLSF
+    tlsf_init();
+#endif
+    region_cnt = 0;
+    mem_total  = 0;
+    region_add(work_mem, LV_MEM_SIZE);
+
+#if MEM_SLAB
+    memset(slab_partial, 0, sizeof(slab_partial));
+    slab_chunk_cnt = 0;
+    slab_used_cnt  = 0;
+#endif
+    mem_used     = 0;
+    mem_max_used = 0;
+#endif
+
+#if LV_MEM_PROF
+    prof_init();
+#endif
+}
+
+/**
+ * Add a memory to the built-in allocator, e.g. an external SRAM. It's used when the others are full.
+ * @param mem pointer to the memory. It's aligned by the allocator.
+ * @param size size of `mem` in bytes
+ * @return true: the memory is added; false: `LV_MEM_REGION_MAX` regions are in use or `mem` is too small
+ */
+bool lv_mem_add_region(void * mem, uint32_t size)
+{
+#if LV_MEM_CUSTOM == 0
+    lv_thread_lock();
+    bool res = region_add(mem, size);
+    lv_thread_unlock();
+
+    return res;
+#else
+    (void)mem;
+    (void)size;
+    return false;
 #endif
 }
 
@@ -126,22 +407,30 @@ void * lv_mem_alloc(uint32_t size)
 #endif
     void * alloc = NULL;
 
+    lv_thread_lock();
+
 #if LV_MEM_CUSTOM == 0
     /*Use the built-in allocators*/
-    lv_mem_ent_t * e = NULL;
+#if MEM_SLAB
+    /*Small memories are allocated from the chunks of their size class*/
+    if(size <= LV_MEM_SLAB_MAX) alloc = slab_alloc(size);
+#endif
 
-    // Search for a appropriate entry
-    do {
-        // Get the next entry
-        e = ent_get_next(e);
+    if(alloc == NULL) alloc = ent_find_alloc(size);
 
-        /*If there is next entry then try to allocate there*/
-        if(e != NULL) {
-            alloc = ent_alloc(e, size);
-        }
-        // End if there is not next entry OR the alloc. is successful
-    } while(e != NULL && alloc == NULL);
+    /*Let the caches give back memory. The freed memory can be fragmented so try again after every round.*/
+    if(alloc == NULL) {
+        while(alloc == NULL && lv_mem_shrink(size + sizeof(lv_mem_header_t)) != 0) alloc = ent_find_alloc(size);
+        if(alloc != NULL) shrink_cnt++;
+    }
 
+    if(alloc != NULL) {
+        mem_used += lv_mem_get_size(alloc);
+        if(mem_used > mem_max_used) mem_max_used = mem_used;
+#if LV_MEM_PROF
+        prof_add(alloc);
+#endif
+    }
 #else
 /*Use custom, user defined malloc function*/
 #if LV_ENABLE_GC == 1 /*gc must not include header*/
@@ -162,6 +451,8 @@ void * lv_mem_alloc(uint32_t size)
     if(alloc != NULL) memset(alloc, 0xaa, size);
 #endif
 
+    lv_thread_unlock();
+
     if(alloc == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
     return alloc;
@@ -176,6 +467,8 @@ void lv_mem_free(const void * data)
     if(data == &zero_mem) return;
     if(data == NULL) return;
 
+    lv_thread_lock();
+
 #if LV_MEM_ADD_JUNK
     memset((void *)data, 0xbb, lv_mem_get_size(data));
 #endif
@@ -187,19 +480,19 @@ void lv_mem_free(const void * data)
 #endif
 
 #if LV_MEM_CUSTOM == 0
-#if LV_MEM_AUTO_DEFRAG
-    /* Make a simple defrag.
-     * Join the following free entries after this*/
-    lv_mem_ent_t * e_next;
-    e_next = ent_get_next(e);
-    while(e_next != NULL) {
-        if(e_next->header.s.used == 0) {
-            e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
-        } else {
-            break;
-        }
-        e_next = ent_get_next(e_next);
+    mem_used -= lv_mem_get_size(data);
+#if LV_MEM_PROF
+    prof_remove(data);
+#endif
+
+#if MEM_SLAB
+    if(e->header.s.slab) {
+        slab_free(e);
+    } else {
+        ent_release(e);
     }
+#else
+    ent_release(e);
 #endif
 #else /*Use custom, user defined free function*/
 #if LV_ENABLE_GC == 0
@@ -208,6 +501,8 @@ void lv_mem_free(const void * data)
     LV_MEM_CUSTOM_FREE((void *)data);
 #endif /*LV_ENABLE_GC*/
 #endif
+
+    lv_thread_unlock();
 }
 
 /**
@@ -222,8 +517,10 @@ void lv_mem_free(const void * data)
 
 void * lv_mem_realloc(void * data_p, uint32_t new_size)
 {
+    lv_thread_lock();
+
     /*data_p could be previously freed pointer (in this case it is invalid)*/
-    if(data_p != NULL) {
+    if(data_p != NULL && data_p != &zero_mem) {
         lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
         if(e->header.s.used == 0) {
             data_p = NULL;
@@ -231,16 +528,60 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
     }
 
     uint32_t old_size = lv_mem_get_size(data_p);
-    if(old_size == new_size) return data_p; /*Also avoid reallocating the same memory*/
+    if(old_size == new_size) { /*Also avoid reallocating the same memory*/
+        lv_thread_unlock();
+        return data_p;
+    }
 
 #if LV_MEM_CUSTOM == 0
-    /* Truncate the memory if the new size is smaller. */
-    if(new_size < old_size) {
-        lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
-        ent_trunc(e, new_size);
+    lv_mem_ent_t * e = NULL;
+    if(old_size != 0) e = (lv_mem_ent_t *)((uint8_t *)data_p - sizeof(lv_mem_header_t));
+    bool in_place = e != NULL;
+
+#if MEM_SLAB
+    /*Keep the cell if the new size belongs to the same size class. Else move the data.*/
+    if(in_place && e->header.s.slab) {
+        if(new_size <= old_size && new_size + SLAB_STEP > old_size) {
+            realloc_in_place_cnt++;
+            lv_thread_unlock();
+            return data_p;
+        }
+        in_place = false;
+    }
+#endif
+
+#if LV_MEM_TLSF
+    /*Truncate the memory or extend it with the next free entry*/
+    if(in_place && tlsf_resize(e, new_size)) {
+        mem_used = mem_used - old_size + lv_mem_get_size(&e->first_data);
+        if(mem_used > mem_max_used) mem_max_used = mem_used;
+#if LV_MEM_PROF
+        prof_resize(&e->first_data);
+#endif
+        realloc_in_place_cnt++;
+        lv_thread_unlock();
+        return &e->first_data;
+    }
+#else
+    /* Truncate the memory if the new size is smaller, else extend it with the free entries after it */
+    if(in_place) {
+        if(new_size < old_size) ent_trunc(e, new_size);
+        else in_place = ent_grow(e, new_size);
+    }
+
+    if(in_place) {
+        mem_used = mem_used - old_size + lv_mem_get_size(&e->first_data);
+        if(mem_used > mem_max_used) mem_max_used = mem_used;
+#if LV_MEM_PROF
+        prof_resize(&e->first_data);
+#endif
+        realloc_in_place_cnt++;
+        lv_thread_unlock();
         return &e->first_data;
     }
 #endif
+    if(old_size != 0) realloc_move_cnt++;
+#endif
 
     void * new_p;
     new_p = lv_mem_alloc(new_size);
@@ -253,6 +594,8 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
         }
     }
 
+    lv_thread_unlock();
+
     if(new_p == NULL) LV_LOG_WARN("Couldn't allocate memory");
 
     return new_p;
@@ -270,11 +613,28 @@ void * lv_mem_realloc(void * data_p, uint32_t new_size)
 #endif /* lv_enable_gc */
 
 /**
- * Join the adjacent free memory blocks
+ * Join the adjacent free memory blocks and free the empty slab chunks
  */
 void lv_mem_defrag(void)
 {
 #if LV_MEM_CUSTOM == 0
+    lv_thread_lock();
+
+#if MEM_SLAB
+    /*Give back the chunks without used cells*/
+    uint32_t cls;
+    for(cls = 0; cls < SLAB_CLASS_CNT; cls++) {
+        lv_mem_slab_chunk_t * chunk = slab_partial[cls];
+        while(chunk != NULL) {
+            lv_mem_slab_chunk_t * chunk_next = chunk->next;
+            if(chunk->free_cnt == chunk->cell_cnt) slab_chunk_free(cls, chunk);
+            chunk = chunk_next;
+        }
+    }
+#endif
+
+    /*With TLSF the free entries are joined on free*/
+#if LV_MEM_TLSF == 0
     lv_mem_ent_t * e_free;
     lv_mem_ent_t * e_next;
     e_free = ent_get_next(NULL);
@@ -289,12 +649,12 @@ void lv_mem_defrag(void)
             }
         }
 
-        if(e_free == NULL) return;
+        if(e_free == NULL) break;
 
         /*Joint the following free entries to the free*/
         e_next = ent_get_next(e_free);
         while(e_next != NULL) {
-            if(e_next->header.s.used == 0) {
+            if(e_next->header.s.used == 0 && ent_is_adjacent(e_free, e_next)) {
                 e_free->header.s.d_size += e_next->header.s.d_size + sizeof(e_next->header);
             } else {
                 break;
@@ -303,12 +663,15 @@ void lv_mem_defrag(void)
             e_next = ent_get_next(e_next);
         }
 
-        if(e_next == NULL) return;
+        if(e_next == NULL) break;
 
         /*Continue from the lastly checked entry*/
         e_free = e_next;
     }
 #endif
+
+    lv_thread_unlock();
+#endif
 }
 
 /**
@@ -339,10 +702,137 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p)
 
         e = ent_get_next(e);
     }
-    mon_p->total_size = LV_MEM_SIZE;
+
+#if MEM_SLAB
+    /*Count the used cells instead of their chunks*/
+    mon_p->used_cnt = mon_p->used_cnt - slab_chunk_cnt + slab_used_cnt;
+#endif
+
+    mon_p->total_size = mem_total;
+    mon_p->region_cnt = region_cnt;
     mon_p->used_pct   = 100 - (100U * mon_p->free_size) / mon_p->total_size;
     mon_p->frag_pct   = (uint32_t)mon_p->free_biggest_size * 100U / mon_p->free_size;
     mon_p->frag_pct   = 100 - mon_p->frag_pct;
+    mon_p->max_used   = mem_max_used;
+
+    mon_p->realloc_in_place_cnt = realloc_in_place_cnt;
+    mon_p->realloc_move_cnt     = realloc_move_cnt;
+#endif
+
+    lv_thread_lock();
+    uint8_t i;
+    for(i = 0; i < shrinker_cnt; i++) mon_p->cache_size += shrinkers[i]->size_cb();
+    mon_p->shrink_cnt = shrink_cnt;
+    lv_thread_unlock();
+}
+
+/**
+ * Register a cache to give back memory. A failed allocation asks the caches and tries again,
+ * and the caches are shrunk to the budget set by `lv_mem_set_cache_budget`.
+ * @param shrinker pointer to a static descriptor of the cache
+ * @return true: registered; false: `LV_MEM_SHRINKER_MAX` caches are registered already
+ */
+bool lv_mem_shrinker_add(const lv_mem_shrinker_t * shrinker)
+{
+    lv_thread_lock();
+    bool res = shrinker_cnt < LV_MEM_SHRINKER_MAX;
+    if(res) shrinkers[shrinker_cnt++] = shrinker;
+    else LV_LOG_WARN("lv_mem_shrinker_add: increase LV_MEM_SHRINKER_MAX");
+    lv_thread_unlock();
+
+    return res;
+}
+
+/**
+ * Ask the caches to give back memory, the biggest cache first
+ * @param size the bytes to free
+ * @return the freed bytes. Less than `size` if the caches have no more.
+ */
+uint32_t lv_mem_shrink(uint32_t size)
+{
+    lv_thread_lock();
+    if(shrinking) {
+        lv_thread_unlock();
+        return 0;
+    }
+    shrinking = true;
+
+    uint32_t freed = 0;
+    uint32_t asked = 0; /*A bit for every shrinker asked already*/
+    while(freed < size) {
+        uint32_t size_max = 0;
+        uint8_t i_max     = 0;
+        uint8_t i;
+        for(i = 0; i < shrinker_cnt; i++) {
+            if(asked & (1U << i)) continue;
+            uint32_t s = shrinkers[i]->size_cb();
+            if(s > size_max) {
+                size_max = s;
+                i_max    = i;
+            }
+        }
+        if(size_max == 0) break;
+
+        asked |= 1U << i_max;
+        uint32_t f = shrinkers[i_max]->shrink_cb(size - freed);
+        LV_LOG_INFO("lv_mem_shrink: the cache gave back memory");
+        freed += f;
+    }
+
+    shrinking = false;
+    lv_thread_unlock();
+
+    return freed;
+}
+
+/**
+ * Set how many bytes the registered caches can hold together. They are shrunk now
+ * and after every refresh if they exceed it.
+ * @param budget bytes, 0: no common limit (only the caches' own ones)
+ */
+void lv_mem_set_cache_budget(uint32_t budget)
+{
+    cache_budget = budget;
+    lv_mem_apply_cache_budget();
+}
+
+/**
+ * Get the common budget of the caches
+ * @return bytes, 0: no common limit
+ */
+uint32_t lv_mem_get_cache_budget(void)
+{
+    return cache_budget;
+}
+
+/**
+ * Shrink the caches if they exceed the budget set by `lv_mem_set_cache_budget`. Called after every refresh.
+ */
+void lv_mem_apply_cache_budget(void)
+{
+    if(cache_budget == 0) return;
+
+    lv_thread_lock();
+    uint32_t size = 0;
+    uint8_t i;
+    for(i = 0; i < shrinker_cnt; i++) size += shrinkers[i]->size_cb();
+    if(size > cache_budget) lv_mem_shrink(size - cache_budget);
+    lv_thread_unlock();
+}
+
+/**
+ * Start measuring the highest memory usage again from the current usage
+ */
+void lv_mem_reset_max_used(void)
+{
+#if LV_MEM_CUSTOM == 0
+    lv_thread_lock();
+    mem_max_used = mem_used;
+#if LV_MEM_PROF
+    lv_mem_tag_t tag;
+    for(tag = 0; tag < _LV_MEM_TAG_NUM; tag++) prof_stats[tag].max_used = prof_stats[tag].used;
+#endif
+    lv_thread_unlock();
 #endif
 }
 
@@ -361,6 +851,10 @@ uint32_t lv_mem_get_size(const void * data)
 
     lv_mem_ent_t * e = (lv_mem_ent_t *)((uint8_t *)data - sizeof(lv_mem_header_t));
 
+#if MEM_SLAB
+    if(e->header.s.slab) return (e->header.c.cls + 1) * SLAB_STEP;
+#endif
+
     return e->header.s.d_size;
 }
 
@@ -373,6 +867,144 @@ uint32_t lv_mem_get_size(const void * data)
 
 #endif /*LV_ENABLE_GC*/
 
+#if LV_MEM_PROF
+
+/**
+ * Tag the next allocations of the calling thread (until the next call). Restore the previous tag when they are done.
+ * @param tag a subsystem, `LV_MEM_TAG_OTHER` to tag by the call site again
+ * @return the previous tag
+ */
+lv_mem_tag_t lv_mem_tag_set(lv_mem_tag_t tag)
+{
+    lv_mem_tag_t prev = prof_tag;
+    prof_tag          = tag;
+    return prev;
+}
+
+/**
+ * Get the memory usage of a tag
+ * @param tag a subsystem
+ * @param stat the usage is copied here
+ */
+void lv_mem_prof_get_stat(lv_mem_tag_t tag, lv_mem_prof_stat_t * stat)
+{
+    lv_thread_lock();
+    *stat = prof_stats[tag];
+    lv_thread_unlock();
+}
+
+/**
+ * Get the name of a tag
+ * @param tag a subsystem
+ * @return the name, e.g. "text"
+ */
+const char * lv_mem_prof_get_tag_name(lv_mem_tag_t tag)
+{
+    return tag < _LV_MEM_TAG_NUM ? prof_tag_names[tag] : "unknown";
+}
+
+/**
+ * Get the id the next allocation will get. The allocations with greater or equal id are made after the call.
+ * @return id of the next allocation
+ */
+uint32_t lv_mem_prof_get_next_id(void)
+{
+    return prof_next_id;
+}
+
+/**
+ * Get the number of living allocations which couldn't be recorded (`LV_MEM_PROF_ENT_MAX` is small)
+ * @return number of allocations counted in no tag
+ */
+uint32_t lv_mem_prof_get_lost_cnt(void)
+{
+    return prof_lost_cnt;
+}
+
+/**
+ * Iterate over the living allocations
+ * @param i start with 0, it's the position of the next allocation after the call
+ * @param alloc the allocation is copied here
+ * @return false: no more allocations
+ */
+bool lv_mem_prof_get_alloc(uint32_t * i, lv_mem_prof_alloc_t * alloc)
+{
+    bool found = false;
+
+    lv_thread_lock();
+    while(*i < LV_MEM_PROF_ENT_MAX && !found) {
+        const lv_mem_prof_ent_t * ent = &prof_ents[*i];
+        (*i)++;
+        if(ent->ofs == 0) continue;
+
+        uint32_t ofs = ent->ofs - 1;
+        uint32_t r   = region_cnt - 1;
+        while(regions[r].ofs > ofs) r--;
+
+        alloc->data = &regions[r].start[ofs - regions[r].ofs];
+        alloc->size = ent->size;
+        alloc->id   = ent->id;
+        alloc->file = ent->file;
+        alloc->line = ent->line;
+        alloc->tag  = ent->tag;
+        found       = true;
+    }
+    lv_thread_unlock();
+
+    return found;
+}
+
+/**
+ * `lv_mem_alloc` with its call site. Used by the `lv_mem_alloc` macro.
+ * @param size size of the memory to allocate in bytes
+ * @param file the file of the call site
+ * @param line the line of the call site
+ * @return pointer to the allocated memory
+ */
+void * lv_mem_alloc_at(uint32_t size, const char * file, uint32_t line)
+{
+    lv_thread_lock();
+    const char * file_prev = prof_file;
+    uint32_t line_prev     = prof_line;
+    prof_file              = file;
+    prof_line              = line;
+
+    void * alloc = lv_mem_alloc(size);
+
+    prof_file = file_prev;
+    prof_line = line_prev;
+    lv_thread_unlock();
+
+    return alloc;
+}
+
+/**
+ * `lv_mem_realloc` with its call site. Used by the `lv_mem_realloc` macro.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file the file of the call site
+ * @param line the line of the call site
+ * @return pointer to the new memory
+ */
+void * lv_mem_realloc_at(void * data_p, uint32_t new_size, const char * file, uint32_t line)
+{
+    lv_thread_lock();
+    const char * file_prev = prof_file;
+    uint32_t line_prev     = prof_line;
+    prof_file              = file;
+    prof_line              = line;
+
+    void * new_p = lv_mem_realloc(data_p, new_size);
+
+    prof_file = file_prev;
+    prof_line = line_prev;
+    lv_thread_unlock();
+
+    return new_p;
+}
+
+#endif /*LV_MEM_PROF*/
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -388,35 +1020,328 @@ static lv_mem_ent_t * ent_get_next(lv_mem_ent_t * act_e)
     lv_mem_ent_t * next_e = NULL;
 
     if(act_e == NULL) { /*NULL means: get the first entry*/
-        next_e = (lv_mem_ent_t *)work_mem;
+        next_e = (lv_mem_ent_t *)regions[0].start;
     } else { /*Get the next entry */
         uint8_t * data = &act_e->first_data;
         next_e         = (lv_mem_ent_t *)&data[act_e->header.s.d_size];
 
-        if(&next_e->first_data >= &work_mem[LV_MEM_SIZE]) next_e = NULL;
+        /*Continue with the first entry of the next region at the end of a region*/
+        uint32_t r = region_find(act_e);
+        if(&next_e->first_data >= &regions[r].start[regions[r].size]) {
+            next_e = r + 1 < region_cnt ? (lv_mem_ent_t *)regions[r + 1].start : NULL;
+        }
     }
 
     return next_e;
 }
 
+#if LV_MEM_TLSF == 0
 /**
- * Try to do the real allocation with a given size
- * @param e try to allocate to this entry
- * @param size size of the new memory in bytes
- * @return pointer to the allocated memory or NULL if not enough memory in the entry
+ * Tell whether an entry directly follows an other in the same region, i.e. they could be joined
+ * @param e pointer to an entry
+ * @param e_next the next entry of `e` given by `ent_get_next`
+ * @return true: `e_next` starts at the end of `e`
  */
-static void * ent_alloc(lv_mem_ent_t * e, uint32_t size)
+static bool ent_is_adjacent(lv_mem_ent_t * e, lv_mem_ent_t * e_next)
 {
-    void * alloc = NULL;
-
-    /*If the memory is free and big enough then use it */
-    if(e->header.s.used == 0 && e->header.s.d_size >= size) {
-        /*Truncate the entry to the desired size */
-        ent_trunc(e, size),
-
-            e->header.s.used = 1;
+    /*The regions can be next to each other in the address space*/
+    return (uint8_t *)e_next == &(&e->first_data)[e->header.s.d_size] && region_find(e) == region_find(e_next);
+}
+#endif
 
-        /*Save the allocated data*/
+/**
+ * Add a memory to the regions and make one free entry from it
+ * @param mem pointer to the memory
+ * @param size size of `mem` in bytes
+ * @return true: the region is added; false: no more regions (`LV_MEM_REGION_MAX`) or `mem` is too small
+ */
+static bool region_add(void * mem, uint32_t size)
+{
+    if(region_cnt >= LV_MEM_REGION_MAX) return false;
+
+    /*Align the start and the size to the allocation unit*/
+    uintptr_t start = ((uintptr_t)mem + sizeof(MEM_UNIT) - 1) & ~((uintptr_t)sizeof(MEM_UNIT) - 1);
+    uintptr_t end   = ((uintptr_t)mem + size) & ~((uintptr_t)sizeof(MEM_UNIT) - 1);
+    if(end <= start || end - start < 2 * sizeof(lv_mem_header_t) + MEM_REGION_SIZE_MIN) return false;
+    size = (uint32_t)LV_MATH_MIN(end - start, MEM_REGION_SIZE_MAX);
+
+    lv_mem_region_t * region = &regions[region_cnt];
+    region->start            = (uint8_t *)start;
+    region->size             = size;
+    region->ofs              = mem_total;
+    region_cnt++;
+    mem_total += size;
+
+#if LV_MEM_TLSF
+    tlsf_region_init(region->start, size);
+#else
+    lv_mem_ent_t * full = (lv_mem_ent_t *)region->start;
+    full->header.header = 0;
+    full->header.s.used = 0;
+    /*The total mem size id reduced by the first header and the close patterns */
+    full->header.s.d_size = size - sizeof(lv_mem_header_t);
+#endif
+
+    return true;
+}
+
+/**
+ * Get the region of a memory
+ * @param p pointer into a region
+ * @return index of the region
+ */
+static uint32_t region_find(const void * p)
+{
+    uint32_t r;
+    for(r = region_cnt - 1; r > 0; r--) {
+        const uint8_t * start = regions[r].start;
+        if((const uint8_t *)p >= start && (const uint8_t *)p < &start[regions[r].size]) break;
+    }
+
+    return r;
+}
+
+#if LV_MEM_GROW
+/**
+ * Get a new region from the system which can hold an allocation of `size`.
+ * The size of the memory is doubled (but it grows at least by `LV_MEM_GROW_SIZE`).
+ * @param size size of the allocation in bytes
+ * @return true: a region is added
+ */
+static bool region_grow(uint32_t size)
+{
+    if(region_cnt >= LV_MEM_REGION_MAX) return false;
+
+    uint32_t need = size + 4 * sizeof(lv_mem_header_t) + MEM_REGION_SIZE_MIN;
+    if(need > MEM_REGION_SIZE_MAX) return false;
+
+    uint32_t grow = LV_MATH_MAX(LV_MEM_GROW_SIZE, mem_total);
+    grow          = LV_MATH_MIN(LV_MATH_MAX(grow, need), MEM_REGION_SIZE_MAX);
+
+    void * mem = LV_MEM_GROW_ALLOC(grow);
+    if(mem == NULL) return false;
+
+    LV_LOG_INFO("lv_mem: a new region is added");
+    return region_add(mem, grow);
+}
+#endif
+
+/**
+ * Allocate an entry from the work memory
+ * @param size size of the new memory in bytes (already aligned)
+ * @return pointer to the allocated memory or NULL if there is no big enough free entry
+ */
+static void * ent_find_alloc(uint32_t size)
+{
+    void * alloc = NULL;
+#if LV_MEM_GROW
+    bool grown = false;
+#endif
+
+    do {
+#if LV_MEM_TLSF
+        alloc = tlsf_alloc(size);
+#else
+        lv_mem_ent_t * e = NULL;
+
+        // Search for a appropriate entry
+        do {
+            // Get the next entry
+            e = ent_get_next(e);
+
+            /*If there is next entry then try to allocate there*/
+            if(e != NULL) {
+                alloc = ent_alloc(e, size);
+            }
+            // End if there is not next entry OR the alloc. is successful
+        } while(e != NULL && alloc == NULL);
+#endif
+
+#if LV_MEM_GROW
+        /*Try again once in a new region*/
+        if(alloc == NULL && !grown) {
+            grown = true;
+            if(!region_grow(size)) break;
+        } else {
+            break;
+        }
+#else
+        break;
+#endif
+    } while(1);
+
+    return alloc;
+}
+
+/**
+ * Give back an entry to the work memory
+ * @param e pointer to a used entry
+ */
+static void ent_release(lv_mem_ent_t * e)
+{
+#if LV_MEM_TLSF
+    /*Put it to the free lists. The adjacent free entries are always joined*/
+    tlsf_free(e);
+#else
+    e->header.s.used = 0;
+
+#if LV_MEM_AUTO_DEFRAG
+    /* Make a simple defrag.
+     * Join the following free entries after this*/
+    lv_mem_ent_t * e_next;
+    e_next = ent_get_next(e);
+    while(e_next != NULL) {
+        if(e_next->header.s.used == 0 && ent_is_adjacent(e, e_next)) {
+            e->header.s.d_size += e_next->header.s.d_size + sizeof(e->header);
+        } else {
+            break;
+        }
+        e_next = ent_get_next(e_next);
+    }
+#endif
+#endif
+}
+
+#if MEM_SLAB
+/**
+ * Allocate a cell from the chunks of size class of `size`. Create a new chunk if all are full.
+ * @param size size of the new memory in bytes (1..LV_MEM_SLAB_MAX)
+ * @return pointer to the allocated memory or NULL if a new chunk couldn't be allocated
+ */
+static void * slab_alloc(uint32_t size)
+{
+    uint32_t cls                = (size - 1) / SLAB_STEP;
+    uint32_t cell_size          = (cls + 1) * SLAB_STEP + sizeof(lv_mem_header_t);
+    lv_mem_slab_chunk_t * chunk = slab_partial[cls];
+
+    if(chunk == NULL) {
+        uint32_t cell_cnt = slab_get_cell_cnt(cls);
+        chunk             = ent_find_alloc(sizeof(lv_mem_slab_chunk_t) + cell_cnt * cell_size);
+        if(chunk == NULL) return NULL;
+
+        /*Link the cells in their order to give them out from the beginning of the chunk*/
+        uint8_t * cells  = (uint8_t *)chunk + sizeof(lv_mem_slab_chunk_t);
+        chunk->free_cell = NULL;
+        uint32_t i;
+        for(i = cell_cnt; i > 0; i--) {
+            lv_mem_ent_t * cell                   = (lv_mem_ent_t *)&cells[(i - 1) * cell_size];
+            cell->header.header                   = 0;
+            cell->header.c.slab                   = 1;
+            cell->header.c.cls                    = cls;
+            cell->header.c.cell_id                = i - 1;
+            *((lv_mem_ent_t **)&cell->first_data) = chunk->free_cell;
+            chunk->free_cell                      = cell;
+        }
+
+        chunk->cell_cnt = cell_cnt;
+        chunk->free_cnt = cell_cnt;
+        chunk->prev     = NULL;
+        chunk->next     = NULL;
+
+        slab_partial[cls] = chunk;
+        slab_chunk_cnt++;
+    }
+
+    lv_mem_ent_t * cell = chunk->free_cell;
+    chunk->free_cell    = *((lv_mem_ent_t **)&cell->first_data);
+    chunk->free_cnt--;
+
+    /*Remove the full chunk from the list*/
+    if(chunk->free_cnt == 0) {
+        slab_partial[cls] = chunk->next;
+        if(chunk->next != NULL) chunk->next->prev = NULL;
+    }
+
+    cell->header.c.used = 1;
+    slab_used_cnt++;
+
+    return &cell->first_data;
+}
+
+/**
+ * Give back a cell to its chunk. Free the chunk if it's empty and there is an other chunk with free cells.
+ * @param e pointer to a used cell
+ */
+static void slab_free(lv_mem_ent_t * e)
+{
+    uint32_t cls       = e->header.c.cls;
+    uint32_t cell_size = (cls + 1) * SLAB_STEP + sizeof(lv_mem_header_t);
+    lv_mem_slab_chunk_t * chunk =
+        (lv_mem_slab_chunk_t *)((uint8_t *)e - e->header.c.cell_id * cell_size - sizeof(lv_mem_slab_chunk_t));
+
+    e->header.c.used                   = 0;
+    *((lv_mem_ent_t **)&e->first_data) = chunk->free_cell;
+    chunk->free_cell                   = e;
+    chunk->free_cnt++;
+    slab_used_cnt--;
+
+    /*The chunk was full so add it to the list again*/
+    if(chunk->free_cnt == 1) {
+        chunk->prev = NULL;
+        chunk->next = slab_partial[cls];
+        if(chunk->next != NULL) chunk->next->prev = chunk;
+        slab_partial[cls] = chunk;
+    }
+
+    /*Keep one empty chunk to not allocate a new one if a cell is freed and allocated repeatedly*/
+    if(chunk->free_cnt == chunk->cell_cnt && (chunk->next != NULL || chunk->prev != NULL)) {
+        slab_chunk_free(cls, chunk);
+    }
+}
+
+/**
+ * Remove an empty chunk from the list of its class and give it back to the work memory
+ * @param cls size class of the chunk
+ * @param chunk pointer to a chunk without used cells
+ */
+static void slab_chunk_free(uint32_t cls, lv_mem_slab_chunk_t * chunk)
+{
+    if(chunk->prev != NULL) {
+        chunk->prev->next = chunk->next;
+    } else {
+        slab_partial[cls] = chunk->next;
+    }
+
+    if(chunk->next != NULL) chunk->next->prev = chunk->prev;
+
+    slab_chunk_cnt--;
+    ent_release((lv_mem_ent_t *)((uint8_t *)chunk - sizeof(lv_mem_header_t)));
+}
+
+/**
+ * Get the number of cells in the chunks of a size class
+ * @param cls a size class
+ * @return number of cells
+ */
+static uint32_t slab_get_cell_cnt(uint32_t cls)
+{
+    uint32_t cell_size = (cls + 1) * SLAB_STEP + sizeof(lv_mem_header_t);
+    uint32_t cell_cnt  = SLAB_CHUNK_SIZE / cell_size;
+    if(cell_cnt < SLAB_CELL_CNT_MIN) cell_cnt = SLAB_CELL_CNT_MIN;
+
+    return cell_cnt;
+}
+#endif
+
+#if LV_MEM_TLSF == 0
+/**
+ * Try to do the real allocation with a given size
+ * @param e try to allocate to this entry
+ * @param size size of the new memory in bytes
+ * @return pointer to the allocated memory or NULL if not enough memory in the entry
+ */
+static void * ent_alloc(lv_mem_ent_t * e, uint32_t size)
+{
+    void * alloc = NULL;
+
+    /*If the memory is free and big enough then use it */
+    if(e->header.s.used == 0 && e->header.s.d_size >= size) {
+        /*Truncate the entry to the desired size */
+        ent_trunc(e, size),
+
+            e->header.s.used = 1;
+
+        /*Save the allocated data*/
         alloc = &e->first_data;
     }
 
@@ -453,6 +1378,7 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size)
     if(e->header.s.d_size != size) {
         uint8_t * e_data             = &e->first_data;
         lv_mem_ent_t * after_new_e   = (lv_mem_ent_t *)&e_data[size];
+        after_new_e->header.header   = 0;
         after_new_e->header.s.used   = 0;
         after_new_e->header.s.d_size = e->header.s.d_size - size - sizeof(lv_mem_header_t);
     }
@@ -461,4 +1387,486 @@ static void ent_trunc(lv_mem_ent_t * e, uint32_t size)
     e->header.s.d_size = size;
 }
 
+/**
+ * Enlarge a used entry without moving it: join the adjacent free entries after it
+ * and give back the rest of the last one
+ * @param e pointer to a used entry
+ * @param size the new size in bytes
+ * @return true: the entry is enlarged; false: the free entries after it are not big enough (nothing changed)
+ */
+static bool ent_grow(lv_mem_ent_t * e, uint32_t size)
+{
+    /*Measure first to leave the free entries as they are if they are not enough*/
+    uint32_t d_size     = e->header.s.d_size;
+    lv_mem_ent_t * last = e;
+    lv_mem_ent_t * next = ent_get_next(e);
+    while(d_size < size && next != NULL && next->header.s.used == 0 && ent_is_adjacent(last, next)) {
+        d_size += sizeof(lv_mem_header_t) + next->header.s.d_size;
+        last = next;
+        next = ent_get_next(next);
+    }
+
+    if(d_size < size) return false;
+
+    /*The joined sizes are aligned so the rounded `size` fits too*/
+    e->header.s.d_size = d_size;
+    ent_trunc(e, size);
+
+    return true;
+}
+
+#else /*LV_MEM_TLSF*/
+
+/**
+ * Empty the free lists
+ */
+static void tlsf_init(void)
+{
+    free_fl_map = 0;
+    memset(free_sl_map, 0, sizeof(free_sl_map));
+    memset(free_lists, 0, sizeof(free_lists));
+}
+
+/**
+ * Create one free entry from a whole region and a used, zero sized entry after it
+ * to not need to check the end of the region
+ * @param start start of the region (aligned)
+ * @param size size of the region in bytes (aligned)
+ */
+static void tlsf_region_init(uint8_t * start, uint32_t size)
+{
+    lv_mem_ent_t * full      = (lv_mem_ent_t *)start;
+    full->header.header      = 0;
+    full->header.s.used      = 0;
+    full->header.s.prev_free = 0;
+    full->header.s.d_size    = size - 2 * sizeof(lv_mem_header_t);
+
+    lv_mem_ent_t * end      = (lv_mem_ent_t *)&(&full->first_data)[full->header.s.d_size];
+    end->header.header      = 0;
+    end->header.s.used      = 1;
+    end->header.s.prev_free = 0;
+    end->header.s.d_size    = 0;
+
+    tlsf_insert(full);
+}
+
+/**
+ * Allocate from the smallest size range which surely has a big enough free entry
+ * @param size size of the new memory in bytes (already aligned)
+ * @return pointer to the allocated memory or NULL if there is no big enough free entry
+ */
+static void * tlsf_alloc(uint32_t size)
+{
+    if(size < TLSF_MIN_SIZE) size = TLSF_MIN_SIZE;
+
+    lv_mem_ent_t * e = tlsf_search(size);
+    if(e == NULL) return NULL;
+
+    tlsf_remove(e);
+    e->header.s.used = 1;
+    tlsf_split(e, size);
+
+    lv_mem_ent_t * next      = (lv_mem_ent_t *)&(&e->first_data)[e->header.s.d_size];
+    next->header.s.prev_free = 0;
+
+    return &e->first_data;
+}
+
+/**
+ * Free an entry and join it with the adjacent free entries
+ * @param e pointer to a used entry
+ */
+static void tlsf_free(lv_mem_ent_t * e)
+{
+    e->header.s.used = 0;
+
+    if(e->header.s.prev_free) {
+        /*The previous free entry saved its size in its last data unit*/
+        MEM_UNIT prev_size  = ((MEM_UNIT *)e)[-1];
+        lv_mem_ent_t * prev = (lv_mem_ent_t *)((uint8_t *)e - prev_size - sizeof(lv_mem_header_t));
+        tlsf_remove(prev);
+        prev->header.s.d_size += e->header.s.d_size + sizeof(lv_mem_header_t);
+        e = prev;
+    }
+
+    lv_mem_ent_t * next = (lv_mem_ent_t *)&(&e->first_data)[e->header.s.d_size];
+    if(next->header.s.used == 0) {
+        tlsf_remove(next);
+        e->header.s.d_size += next->header.s.d_size + sizeof(lv_mem_header_t);
+    }
+
+    tlsf_insert(e);
+}
+
+/**
+ * Change the size of a used entry without moving it
+ * @param e pointer to a used entry
+ * @param size the new size in bytes
+ * @return true: the entry is resized; false: the next entry is not free or not big enough
+ */
+static bool tlsf_resize(lv_mem_ent_t * e, uint32_t size)
+{
+    /*Round the size up to the alignment*/
+    size = (size + (1U << TLSF_ALIGN_LOG2) - 1) & ~((1U << TLSF_ALIGN_LOG2) - 1);
+    if(size < TLSF_MIN_SIZE) size = TLSF_MIN_SIZE;
+
+    if(size > e->header.s.d_size) {
+        lv_mem_ent_t * next = (lv_mem_ent_t *)&(&e->first_data)[e->header.s.d_size];
+        if(next->header.s.used) return false;
+        if(e->header.s.d_size + sizeof(lv_mem_header_t) + next->header.s.d_size < size) return false;
+
+        tlsf_remove(next);
+        e->header.s.d_size += next->header.s.d_size + sizeof(lv_mem_header_t);
+
+        next                     = (lv_mem_ent_t *)&(&e->first_data)[e->header.s.d_size];
+        next->header.s.prev_free = 0;
+    }
+
+    tlsf_split(e, size);
+
+    return true;
+}
+
+/**
+ * Free the end of a used entry if it's big enough for a new entry
+ * @param e pointer to a used entry
+ * @param size the size to keep in bytes (already aligned)
+ */
+static void tlsf_split(lv_mem_ent_t * e, uint32_t size)
+{
+    if(e->header.s.d_size < size + sizeof(lv_mem_header_t) + TLSF_MIN_SIZE) return;
+
+    lv_mem_ent_t * rest      = (lv_mem_ent_t *)&(&e->first_data)[size];
+    rest->header.header      = 0;
+    rest->header.s.used      = 1;
+    rest->header.s.prev_free = 0;
+    rest->header.s.d_size    = e->header.s.d_size - size - sizeof(lv_mem_header_t);
+    e->header.s.d_size       = size;
+
+    tlsf_free(rest);
+}
+
+/**
+ * Find a free entry which is at least `size` big
+ * @param size size in bytes
+ * @return pointer to a free entry or NULL if there is no big enough free entry
+ */
+static lv_mem_ent_t * tlsf_search(uint32_t size)
+{
+    uint32_t fl;
+    uint32_t sl;
+
+    /*Round up to the next size range to be sure all entries in the range are big enough*/
+    uint32_t size_round = size;
+    if(size_round >= TLSF_SMALL_SIZE) size_round += (1U << (tlsf_fls(size_round) - TLSF_SL_CNT_LOG2)) - 1;
+
+    tlsf_mapping(size_round, &fl, &sl);
+    if(fl < TLSF_FL_CNT) {
+        uint32_t sl_map = free_sl_map[fl] & (~0U << sl);
+        if(sl_map == 0) {
+            /*Take the smallest non empty size range from the bigger first levels*/
+            uint32_t fl_map = free_fl_map & (~0U << (fl + 1));
+            if(fl_map != 0) {
+                fl     = tlsf_ffs(fl_map);
+                sl_map = free_sl_map[fl];
+            }
+        }
+
+        if(sl_map != 0) return free_lists[fl][tlsf_ffs(sl_map)];
+    }
+
+    /*Check the entries of the not rounded size range too. It matters only if the memory is almost full.*/
+    tlsf_mapping(size, &fl, &sl);
+    lv_mem_ent_t * e = free_lists[fl][sl];
+    while(e != NULL) {
+        if(e->header.s.d_size >= size) return e;
+        e = TLSF_LINKS(e)->next;
+    }
+
+    return NULL;
+}
+
+/**
+ * Add a free entry to the list of its size range
+ * @param e pointer to a free entry
+ */
+static void tlsf_insert(lv_mem_ent_t * e)
+{
+    uint32_t fl;
+    uint32_t sl;
+    tlsf_mapping(e->header.s.d_size, &fl, &sl);
+
+    lv_mem_free_links_t * links = TLSF_LINKS(e);
+    links->prev                 = NULL;
+    links->next                 = free_lists[fl][sl];
+    if(links->next != NULL) TLSF_LINKS(links->next)->prev = e;
+
+    free_lists[fl][sl] = e;
+    free_sl_map[fl] |= 1U << sl;
+    free_fl_map |= 1U << fl;
+
+    /*Save the size in the last data unit to let `tlsf_free` find the start of this entry from the next one*/
+    lv_mem_ent_t * next      = (lv_mem_ent_t *)&(&e->first_data)[e->header.s.d_size];
+    ((MEM_UNIT *)next)[-1]   = e->header.s.d_size;
+    next->header.s.prev_free = 1;
+}
+
+/**
+ * Remove a free entry from the list of its size range
+ * @param e pointer to a free entry
+ */
+static void tlsf_remove(lv_mem_ent_t * e)
+{
+    uint32_t fl;
+    uint32_t sl;
+    tlsf_mapping(e->header.s.d_size, &fl, &sl);
+
+    lv_mem_free_links_t * links = TLSF_LINKS(e);
+    if(links->next != NULL) TLSF_LINKS(links->next)->prev = links->prev;
+
+    if(links->prev != NULL) {
+        TLSF_LINKS(links->prev)->next = links->next;
+    } else {
+        free_lists[fl][sl] = links->next;
+        if(links->next == NULL) {
+            free_sl_map[fl] &= ~(1U << sl);
+            if(free_sl_map[fl] == 0) free_fl_map &= ~(1U << fl);
+        }
+    }
+}
+
+/**
+ * Get the size range of a size
+ * @param size size in bytes
+ * @param fl store the first level index here
+ * @param sl store the second level index here
+ */
+static void tlsf_mapping(uint32_t size, uint32_t * fl, uint32_t * sl)
+{
+    if(size < TLSF_SMALL_SIZE) {
+        *fl = 0;
+        *sl = size >> TLSF_ALIGN_LOG2;
+    } else {
+        uint32_t f = tlsf_fls(size);
+        *sl        = (size >> (f - TLSF_SL_CNT_LOG2)) ^ TLSF_SL_CNT;
+        *fl        = f - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+/**
+ * Find the last (most significant) set bit
+ * @param x a non-zero value
+ * @return index of the bit
+ */
+static uint32_t tlsf_fls(uint32_t x)
+{
+#if defined(__GNUC__)
+    return 31 - __builtin_clz(x);
+#else
+    uint32_t i = 0;
+    while(x >>= 1) i++;
+    return i;
 #endif
+}
+
+/**
+ * Find the first (least significant) set bit
+ * @param x a non-zero value
+ * @return index of the bit
+ */
+static uint32_t tlsf_ffs(uint32_t x)
+{
+#if defined(__GNUC__)
+    return __builtin_ctz(x);
+#else
+    uint32_t i = 0;
+    while((x & 1) == 0) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+#endif
+}
+
+#endif /*LV_MEM_TLSF*/
+
+#endif
+
+#if LV_MEM_PROF
+
+static void prof_init(void)
+{
+    memset(prof_ents, 0, sizeof(prof_ents));
+    memset(prof_stats, 0, sizeof(prof_stats));
+    memset(prof_file_cache, 0, sizeof(prof_file_cache));
+    prof_ent_cnt  = 0;
+    prof_lost_cnt = 0;
+    prof_next_id  = 0;
+    prof_tag      = LV_MEM_TAG_OTHER;
+    prof_file     = NULL;
+    prof_line     = 0;
+}
+
+/**
+ * Record a new allocation with the current tag and call site
+ * @param data pointer to the allocated memory
+ */
+static void prof_add(const void * data)
+{
+    lv_mem_tag_t tag = prof_tag != LV_MEM_TAG_OTHER ? prof_tag : prof_file_tag(prof_file);
+    uint32_t size    = lv_mem_get_size(data);
+    prof_next_id++;
+
+    if(prof_ent_cnt >= PROF_ENT_LIMIT) {
+        prof_lost_cnt++;
+        return;
+    }
+
+    uint32_t ofs  = prof_get_ofs(data);
+    uint32_t mask = LV_MEM_PROF_ENT_MAX - 1;
+    uint32_t i    = prof_hash(ofs);
+    while(prof_ents[i].ofs != 0) i = (i + 1) & mask;
+
+    lv_mem_prof_ent_t * ent = &prof_ents[i];
+    ent->file               = prof_file;
+    ent->ofs                = ofs + 1;
+    ent->size               = size;
+    ent->id                 = prof_next_id - 1;
+    ent->line               = prof_line;
+    ent->tag                = tag;
+    prof_ent_cnt++;
+
+    prof_stats[tag].cnt++;
+    prof_stats[tag].total_cnt++;
+    prof_stat_add(tag, size);
+}
+
+/**
+ * Forget a freed allocation
+ * @param data pointer to the allocated memory
+ */
+static void prof_remove(const void * data)
+{
+    uint32_t i = prof_find(data);
+    if(i == LV_MEM_PROF_ENT_MAX) {
+        if(prof_lost_cnt > 0) prof_lost_cnt--;
+        return;
+    }
+
+    prof_stats[prof_ents[i].tag].cnt--;
+    prof_stat_add(prof_ents[i].tag, -(int32_t)prof_ents[i].size);
+    prof_ent_cnt--;
+
+    /*Move the next entries of the same probe sequence back to keep them reachable*/
+    uint32_t mask = LV_MEM_PROF_ENT_MAX - 1;
+    uint32_t j    = i;
+    while(1) {
+        j = (j + 1) & mask;
+        if(prof_ents[j].ofs == 0) break;
+
+        uint32_t home = prof_hash(prof_ents[j].ofs - 1);
+        if(((j - home) & mask) >= ((j - i) & mask)) {
+            prof_ents[i] = prof_ents[j];
+            i            = j;
+        }
+    }
+    prof_ents[i].ofs = 0;
+}
+
+/**
+ * Update the size of an allocation resized in place. It keeps its tag and call site.
+ * @param data pointer to the allocated memory
+ */
+static void prof_resize(const void * data)
+{
+    uint32_t i = prof_find(data);
+    if(i == LV_MEM_PROF_ENT_MAX) return;
+
+    uint32_t size = lv_mem_get_size(data);
+    prof_stat_add(prof_ents[i].tag, (int32_t)size - (int32_t)prof_ents[i].size);
+    prof_ents[i].size = size;
+}
+
+/**
+ * Find the entry of an allocation
+ * @param data pointer to the allocated memory
+ * @return index in `prof_ents` or `LV_MEM_PROF_ENT_MAX` if not recorded
+ */
+static uint32_t prof_find(const void * data)
+{
+    uint32_t ofs  = prof_get_ofs(data);
+    uint32_t mask = LV_MEM_PROF_ENT_MAX - 1;
+    uint32_t i    = prof_hash(ofs);
+    while(prof_ents[i].ofs != 0) {
+        if(prof_ents[i].ofs == ofs + 1) return i;
+        i = (i + 1) & mask;
+    }
+
+    return LV_MEM_PROF_ENT_MAX;
+}
+
+/**
+ * Get the offset of an allocated memory in all regions
+ * @param data pointer to an allocated memory
+ * @return the offset (see `lv_mem_region_t`)
+ */
+static uint32_t prof_get_ofs(const void * data)
+{
+    const lv_mem_region_t * region = &regions[region_find(data)];
+    return region->ofs + (uint32_t)((const uint8_t *)data - region->start);
+}
+
+/**
+ * The first slot of an allocation in `prof_ents`
+ * @param ofs offset of the data in all regions
+ * @return index in `prof_ents`
+ */
+static uint32_t prof_hash(uint32_t ofs)
+{
+    /*The offsets are aligned, mix the higher bits down (Fibonacci hashing)*/
+    return (((ofs >> 2) * 2654435761U) >> 16) & (LV_MEM_PROF_ENT_MAX - 1);
+}
+
+/**
+ * Get the tag of the allocations of a file
+ * @param file `__FILE__` of the call site or NULL
+ * @return the tag from `prof_file_tags` or `LV_MEM_TAG_OTHER`
+ */
+static lv_mem_tag_t prof_file_tag(const char * file)
+{
+    if(file == NULL) return LV_MEM_TAG_OTHER;
+
+    /*The same file has the same `__FILE__` pointer, so compare the names only once*/
+    uint32_t c = (uint32_t)(((uintptr_t)file >> 3) % PROF_FILE_CACHE_CNT);
+    if(prof_file_cache[c].name == file) return prof_file_cache[c].tag;
+
+    const char * name = file;
+    const char * p;
+    for(p = file; *p != '\0'; p++) {
+        if(*p == '/' || *p == '\\') name = p + 1;
+    }
+    const char * ext = strrchr(name, '.');
+    size_t len       = ext != NULL ? (size_t)(ext - name) : strlen(name);
+
+    lv_mem_tag_t tag = LV_MEM_TAG_OTHER;
+    uint32_t i;
+    for(i = 0; i < sizeof(prof_file_tags) / sizeof(prof_file_tags[0]); i++) {
+        if(strlen(prof_file_tags[i].name) == len && memcmp(prof_file_tags[i].name, name, len) == 0) {
+            tag = prof_file_tags[i].tag;
+            break;
+        }
+    }
+
+    prof_file_cache[c].name = file;
+    prof_file_cache[c].tag  = tag;
+    return tag;
+}
+
+static void prof_stat_add(lv_mem_tag_t tag, int32_t size)
+{
+    lv_mem_prof_stat_t * stat = &prof_stats[tag];
+    stat->used += size;
+    if(stat->used > stat->max_used) stat->max_used = stat->used;
+}
+
+#endif /*LV_MEM_PROF*/
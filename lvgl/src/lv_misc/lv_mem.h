@@ -21,6 +21,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 #include "lv_log.h"
 
 /*********************
@@ -54,8 +55,72 @@ typedef struct
     uint32_t used_cnt;
     uint8_t used_pct; /**< Percentage used */
     uint8_t frag_pct; /**< Amount of fragmentation */
+    uint32_t max_used; /**< Highest number of allocated data bytes since `lv_mem_init` or `lv_mem_reset_max_used`*/
+    uint8_t region_cnt; /**< Number of memory regions (see `lv_mem_add_region` and `LV_MEM_GROW`)*/
+    uint32_t realloc_in_place_cnt; /**< `lv_mem_realloc`s which kept the memory (resized it) since `lv_mem_init`*/
+    uint32_t realloc_move_cnt;     /**< `lv_mem_realloc`s which allocated a new memory and copied the data*/
+    uint32_t cache_size;           /**< Bytes the caches could give back now (see `lv_mem_shrinker_add`)*/
+    uint32_t shrink_cnt;           /**< Allocations which succeeded only after the caches gave back memory*/
 } lv_mem_monitor_t;
 
+/**
+ * A cache which gives back memory when an allocation fails or the caches exceed their common budget
+ * (see `lv_mem_shrinker_add`). The callbacks are called with the library lock taken.
+ */
+typedef struct
+{
+    const char * name;
+    uint32_t (*size_cb)(void);            /**< Bytes the cache could give back now*/
+    uint32_t (*shrink_cb)(uint32_t size); /**< Free at least `size` bytes if it can, the least recently used first.
+                                               Return the freed bytes.*/
+} lv_mem_shrinker_t;
+
+/**
+ * Subsystems of the allocations counted by the memory profiler (`LV_MEM_PROF`).
+ * The objects, ext. attributes, layouts, animations and tasks are tagged where they are created
+ * (`lv_mem_tag_set`), the others by the file of the call site (e.g. `lv_label.c` allocates text).
+ */
+enum {
+    LV_MEM_TAG_OTHER,
+    LV_MEM_TAG_OBJ,    /**< The objects (`lv_obj_t`)*/
+    LV_MEM_TAG_EXT,    /**< Ext. attributes of the object types*/
+    LV_MEM_TAG_STYLE,  /**< Style animations*/
+    LV_MEM_TAG_TEXT,   /**< Texts of the labels, text areas, tables etc. and their line layouts*/
+    LV_MEM_TAG_LAYOUT, /**< The queue of the deferred layouts*/
+    LV_MEM_TAG_ANIM,
+    LV_MEM_TAG_TASK,
+    LV_MEM_TAG_FONT,   /**< Glyph look-up tables and the fonts loaded at run time*/
+    LV_MEM_TAG_IMG,    /**< Image cache, decoders and the file names of image sources*/
+    _LV_MEM_TAG_NUM
+};
+typedef uint8_t lv_mem_tag_t;
+
+#if LV_MEM_PROF
+/**
+ * Memory usage of a tag
+ */
+typedef struct
+{
+    uint32_t used;      /**< Allocated bytes*/
+    uint32_t max_used;  /**< Highest `used` since `lv_mem_init` or `lv_mem_reset_max_used`*/
+    uint32_t cnt;       /**< Living allocations*/
+    uint32_t total_cnt; /**< Allocations since `lv_mem_init`*/
+} lv_mem_prof_stat_t;
+
+/**
+ * A living allocation recorded by the memory profiler
+ */
+typedef struct
+{
+    const void * data;
+    uint32_t size;
+    uint32_t id;        /**< Allocations are numbered from 0 in their order, see `lv_mem_prof_get_next_id`*/
+    const char * file;  /**< Call site of `lv_mem_alloc` or `lv_mem_realloc`, NULL if unknown*/
+    uint16_t line;
+    lv_mem_tag_t tag;
+} lv_mem_prof_alloc_t;
+#endif
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -65,6 +130,14 @@ typedef struct
  */
 void lv_mem_init(void);
 
+/**
+ * Add a memory to the built-in allocator, e.g. an external SRAM. It's used when the others are full.
+ * @param mem pointer to the memory. It's aligned by the allocator.
+ * @param size size of `mem` in bytes
+ * @return true: the memory is added; false: `LV_MEM_REGION_MAX` regions are in use or `mem` is too small
+ */
+bool lv_mem_add_region(void * mem, uint32_t size);
+
 /**
  * Allocate a memory dynamically
  * @param size size of the memory to allocate in bytes
@@ -88,10 +161,43 @@ void lv_mem_free(const void * data);
 void * lv_mem_realloc(void * data_p, uint32_t new_size);
 
 /**
- * Join the adjacent free memory blocks
+ * Join the adjacent free memory blocks and free the empty slab chunks
  */
 void lv_mem_defrag(void);
 
+/**
+ * Register a cache to give back memory. A failed allocation asks the caches and tries again,
+ * and the caches are shrunk to the budget set by `lv_mem_set_cache_budget`.
+ * @param shrinker pointer to a static descriptor of the cache
+ * @return true: registered; false: `LV_MEM_SHRINKER_MAX` caches are registered already
+ */
+bool lv_mem_shrinker_add(const lv_mem_shrinker_t * shrinker);
+
+/**
+ * Ask the caches to give back memory, the biggest cache first
+ * @param size the bytes to free
+ * @return the freed bytes. Less than `size` if the caches have no more.
+ */
+uint32_t lv_mem_shrink(uint32_t size);
+
+/**
+ * Set how many bytes the registered caches can hold together. They are shrunk now
+ * and after every refresh if they exceed it.
+ * @param budget bytes, 0: no common limit (only the caches' own ones)
+ */
+void lv_mem_set_cache_budget(uint32_t budget);
+
+/**
+ * Get the common budget of the caches
+ * @return bytes, 0: no common limit
+ */
+uint32_t lv_mem_get_cache_budget(void);
+
+/**
+ * Shrink the caches if they exceed the budget set by `lv_mem_set_cache_budget`. Called after every refresh.
+ */
+void lv_mem_apply_cache_budget(void);
+
 /**
  * Give information about the work memory of dynamic allocation
  * @param mon_p pointer to a dm_mon_p variable,
@@ -99,6 +205,11 @@ void lv_mem_defrag(void);
  */
 void lv_mem_monitor(lv_mem_monitor_t * mon_p);
 
+/**
+ * Start measuring the highest memory usage again from the current usage
+ */
+void lv_mem_reset_max_used(void);
+
 /**
  * Give the size of an allocated memory
  * @param data pointer to an allocated memory
@@ -106,10 +217,84 @@ void lv_mem_monitor(lv_mem_monitor_t * mon_p);
  */
 uint32_t lv_mem_get_size(const void * data);
 
+#if LV_MEM_PROF
+/**
+ * Tag the next allocations of the calling thread (until the next call). Restore the previous tag when they are done.
+ * @param tag a subsystem, `LV_MEM_TAG_OTHER` to tag by the call site again
+ * @return the previous tag
+ */
+lv_mem_tag_t lv_mem_tag_set(lv_mem_tag_t tag);
+
+/**
+ * Get the memory usage of a tag
+ * @param tag a subsystem
+ * @param stat the usage is copied here
+ */
+void lv_mem_prof_get_stat(lv_mem_tag_t tag, lv_mem_prof_stat_t * stat);
+
+/**
+ * Get the name of a tag
+ * @param tag a subsystem
+ * @return the name, e.g. "text"
+ */
+const char * lv_mem_prof_get_tag_name(lv_mem_tag_t tag);
+
+/**
+ * Get the id the next allocation will get. The allocations with greater or equal id are made after the call.
+ * @return id of the next allocation
+ */
+uint32_t lv_mem_prof_get_next_id(void);
+
+/**
+ * Get the number of living allocations which couldn't be recorded (`LV_MEM_PROF_ENT_MAX` is small)
+ * @return number of allocations counted in no tag
+ */
+uint32_t lv_mem_prof_get_lost_cnt(void);
+
+/**
+ * Iterate over the living allocations
+ * @param i start with 0, it's the position of the next allocation after the call
+ * @param alloc the allocation is copied here
+ * @return false: no more allocations
+ */
+bool lv_mem_prof_get_alloc(uint32_t * i, lv_mem_prof_alloc_t * alloc);
+
+/**
+ * `lv_mem_alloc` with its call site. Used by the `lv_mem_alloc` macro.
+ * @param size size of the memory to allocate in bytes
+ * @param file the file of the call site
+ * @param line the line of the call site
+ * @return pointer to the allocated memory
+ */
+void * lv_mem_alloc_at(uint32_t size, const char * file, uint32_t line);
+
+/**
+ * `lv_mem_realloc` with its call site. Used by the `lv_mem_realloc` macro.
+ * @param data_p pointer to an allocated memory
+ * @param new_size the desired new size in byte
+ * @param file the file of the call site
+ * @param line the line of the call site
+ * @return pointer to the new memory
+ */
+void * lv_mem_realloc_at(void * data_p, uint32_t new_size, const char * file, uint32_t line);
+#else
+static inline lv_mem_tag_t lv_mem_tag_set(lv_mem_tag_t tag)
+{
+    (void)tag;
+    return LV_MEM_TAG_OTHER;
+}
+#endif
+
 /**********************
  *      MACROS
  **********************/
 
+#if LV_MEM_PROF
+/*Record the call sites*/
+#define lv_mem_alloc(size) lv_mem_alloc_at(size, __FILE__, __LINE__)
+#define lv_mem_realloc(data_p, new_size) lv_mem_realloc_at(data_p, new_size, __FILE__, __LINE__)
+#endif
+
 /**
  * Halt on NULL pointer
  * p pointer to a memory
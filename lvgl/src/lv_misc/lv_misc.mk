@@ -4,6 +4,8 @@ CSRCS += lv_task.c
 CSRCS += lv_fs.c
 CSRCS += lv_anim.c
 CSRCS += lv_mem.c
+CSRCS += lv_thread.c
+CSRCS += lv_async.c
 CSRCS += lv_ll.c
 CSRCS += lv_color.c
 CSRCS += lv_txt.c
@@ -11,6 +11,9 @@
 #include "lv_task.h"
 #include "../lv_hal/lv_hal_tick.h"
 #include "lv_gc.h"
+#include "lv_async.h"
+#include "lv_log.h"
+#include "../lv_core/lv_prof.h"
 
 #if defined(LV_GC_INCLUDE)
 #include LV_GC_INCLUDE
@@ -23,22 +26,80 @@
 #define DEF_PRIO LV_TASK_PRIO_MID
 #define DEF_PERIOD 500
 
+#if LV_TASK_HEAP
+#if LV_ENABLE_GC
+#error "LV_TASK_HEAP is not supported with LV_ENABLE_GC"
+#endif
+
+#define HEAP_NONE 0xFFFFFFFF /*`heap_i` if the task is not in a heap (turned off or paused)*/
+#define HEAP_DONE 0xFFFFFFFE /*`heap_i` if the task ran in the current `lv_task_handler` call*/
+#define HEAP_SIZE_MIN 8
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_TASK_HEAP
+/*Array of tasks. As a heap the task with the earliest next run is on index 0
+ * and a task is never after its children (`2 * i + 1` and `2 * i + 2`)*/
+typedef struct
+{
+    lv_task_t ** tasks;
+    uint32_t cnt;
+    uint32_t size;
+} lv_task_heap_t;
+#endif
+
+/*The global variables of the module, every context has its own with `LV_USE_CONTEXT`*/
+typedef struct
+{
+    bool lv_task_run;
+    uint8_t idle_last;
+    bool task_deleted;
+    bool task_created;
+    bool task_handler_mutex; /*Avoid concurrent running of the task handler*/
+    uint32_t idle_period_start;
+    uint32_t busy_time;
+#if LV_TASK_HEAP
+    lv_task_heap_t task_heap[_LV_TASK_PRIO_NUM]; /*A heap for every priority (except `LV_TASK_PRIO_OFF`)*/
+    lv_task_heap_t task_done;                    /*The tasks which ran in the current handler call (not a heap)*/
+#endif
+} lv_task_state_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static bool lv_task_exec(lv_task_t * task);
+#if LV_TASK_HEAP
+static bool task_heap_reserve(lv_task_heap_t * heap, uint32_t cnt);
+static void task_heap_insert(lv_task_t * task);
+static void task_heap_remove(lv_task_t * task);
+static void task_heap_update(lv_task_t * task);
+static void task_heap_sift_up(lv_task_heap_t * heap, uint32_t i);
+static void task_heap_sift_down(lv_task_heap_t * heap, uint32_t i);
+static bool task_heap_before(const lv_task_t * a, const lv_task_t * b);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
-static bool lv_task_run  = false;
-static uint8_t idle_last = 0;
-static bool task_deleted;
-static bool task_created;
+#if LV_USE_CONTEXT
+#define task_st ((lv_task_state_t *)lv_context_act->task_state)
+#else
+static lv_task_state_t task_state;
+#define task_st (&task_state)
+#endif
+#define lv_task_run (task_st->lv_task_run)
+#define idle_last (task_st->idle_last)
+#define task_deleted (task_st->task_deleted)
+#define task_created (task_st->task_created)
+#define task_handler_mutex (task_st->task_handler_mutex)
+#define idle_period_start (task_st->idle_period_start)
+#define busy_time (task_st->busy_time)
+#if LV_TASK_HEAP
+#define task_heap (task_st->task_heap)
+#define task_done (task_st->task_done)
+#endif
 
 /**********************
  *      MACROS
@@ -53,35 +114,97 @@ static bool task_created;
  */
 void lv_task_core_init(void)
 {
-    lv_ll_init(&LV_GC_ROOT(_lv_task_ll), sizeof(lv_task_t));
+#if LV_USE_CONTEXT
+    lv_context_state_init(&lv_context_act->task_state, sizeof(lv_task_state_t));
+#endif
+    lv_ll_init_pool(&LV_GC_ROOT(_lv_task_ll), sizeof(lv_task_t));
 
     /*Initially enable the lv_task handling*/
     lv_task_enable(true);
 }
 
+#if LV_USE_CONTEXT
+/**
+ * Free the memory of the lv_task module of the active context. Its tasks have to be deleted already.
+ */
+void lv_task_core_deinit(void)
+{
+#if LV_TASK_HEAP
+    uint8_t p;
+    for(p = 0; p < _LV_TASK_PRIO_NUM; p++) lv_mem_free(task_heap[p].tasks);
+    lv_mem_free(task_done.tasks);
+#endif
+    lv_mem_free(lv_context_act->task_state);
+    lv_context_act->task_state = NULL;
+}
+#endif
+
 /**
  * Call it  periodically to handle lv_tasks.
+ * @return time until the next task has to run [ms], or `LV_NO_TASK_READY` if there is no active task.
+ *         It's enough to call this function again after this time (or when an input event arrives).
  */
-LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
+LV_ATTRIBUTE_TASK_HANDLER uint32_t lv_task_handler(void)
 {
     LV_LOG_TRACE("lv_task_handler started");
 
     /*Avoid concurrent running of the task handler*/
-    static bool task_handler_mutex = false;
-    if(task_handler_mutex) return;
+    if(task_handler_mutex) return 0;
     task_handler_mutex = true;
 
-    static uint32_t idle_period_start = 0;
-    static uint32_t handler_start     = 0;
-    static uint32_t busy_time         = 0;
-
     if(lv_task_run == false) {
         task_handler_mutex = false; /*Release mutex*/
-        return;
+        return LV_NO_TASK_READY;
     }
 
-    handler_start = lv_tick_get();
+    uint32_t handler_start = lv_tick_get();
+
+#if LV_ASYNC_QUEUE_SIZE
+    /*Wake up the task of `lv_async` if other threads posted updates*/
+    lv_async_wake_check();
+#endif
+
+#if LV_USE_LOG && LV_LOG_ASYNC_SIZE
+    /*Print the queued logs after the refresh*/
+    lv_log_wake_check();
+#endif
+
+#if LV_TASK_HEAP
+    /* Always run the due task with the highest priority. The tasks are taken out from the heaps while
+     * the handler runs so every task runs at most once and tasks which are not due are not checked.*/
+    task_done.cnt = 0;
+    while(task_heap_reserve(&task_done, task_done.cnt + 1)) {
+        lv_task_t * task = NULL;
+        int8_t p;
+        for(p = LV_TASK_PRIO_HIGHEST; p > LV_TASK_PRIO_OFF; p--) {
+            if(task_heap[p].cnt == 0) continue;
+            lv_task_t * top = task_heap[p].tasks[0];
+            if(lv_tick_elaps(top->last_run) >= top->period) {
+                task = top;
+                break;
+            }
+        }
+        if(task == NULL) break;
 
+        task_heap_remove(task);
+        task->heap_i                     = HEAP_DONE;
+        task_done.tasks[task_done.cnt++] = task;
+
+        LV_GC_ROOT(_lv_task_act) = task;
+        lv_task_exec(task); /*It might delete the task. Then `lv_task_del` clears it in `task_done`*/
+    }
+    LV_GC_ROOT(_lv_task_act) = NULL;
+
+    /*Put back the tasks into the heaps with their new next run time*/
+    uint32_t i;
+    for(i = 0; i < task_done.cnt; i++) {
+        lv_task_t * task = task_done.tasks[i];
+        if(task == NULL) continue;
+        task->heap_i = HEAP_NONE;
+        task_heap_insert(task);
+    }
+    task_done.cnt = 0;
+#else
     /* Run all task from the highest to the lowest priority
      * If a lower priority task is executed check task again from the highest priority
      * but on the priority of executed tasks don't run tasks before the executed*/
@@ -142,12 +265,13 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
             LV_GC_ROOT(_lv_task_act) = next; /*Load the next task*/
         }
     } while(!end_flag);
+#endif
 
     busy_time += lv_tick_elaps(handler_start);
     uint32_t idle_period_time = lv_tick_elaps(idle_period_start);
     if(idle_period_time >= IDLE_MEAS_PERIOD) {
-
-        idle_last         = (uint32_t)((uint32_t)busy_time * 100) / IDLE_MEAS_PERIOD; /*Calculate the busy percentage*/
+        /*Use the real length of the period because the handler might not be called for a long time*/
+        idle_last         = (uint32_t)((uint32_t)busy_time * 100) / idle_period_time; /*Calculate the busy percentage*/
         idle_last         = idle_last > 100 ? 0 : 100 - idle_last;                    /*But we need idle time*/
         busy_time         = 0;
         idle_period_start = lv_tick_get();
@@ -156,6 +280,8 @@ LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void)
     task_handler_mutex = false; /*Release the mutex*/
 
     LV_LOG_TRACE("lv_task_handler ready");
+
+    return lv_task_get_time_till_next();
 }
 /**
  * Create an "empty" task. It needs to initialzed with at least
@@ -168,7 +294,8 @@ lv_task_t * lv_task_create_basic(void)
     lv_task_t * tmp;
 
     /*Create task lists in order of priority from high to low*/
-    tmp = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
+    lv_mem_tag_t tag_prev = lv_mem_tag_set(LV_MEM_TAG_TASK);
+    tmp                   = lv_ll_get_head(&LV_GC_ROOT(_lv_task_ll));
 
     /*It's the first task*/
     if(NULL == tmp) {
@@ -195,16 +322,23 @@ lv_task_t * lv_task_create_basic(void)
             if(new_task == NULL) return NULL;
         }
     }
+    lv_mem_tag_set(tag_prev);
 
     new_task->period  = DEF_PERIOD;
     new_task->task_cb = NULL;
     new_task->prio    = DEF_PRIO;
 
     new_task->once     = 0;
+    new_task->paused   = 0;
     new_task->last_run = lv_tick_get();
 
     new_task->user_data = NULL;
 
+#if LV_TASK_HEAP
+    new_task->heap_i = HEAP_NONE;
+    task_heap_insert(new_task);
+#endif
+
     task_created = true;
 
     return new_task;
@@ -250,9 +384,21 @@ void lv_task_set_cb(lv_task_t * task, lv_task_cb_t task_cb)
  */
 void lv_task_del(lv_task_t * task)
 {
+#if LV_TASK_HEAP
+    if(task->heap_i == HEAP_DONE) {
+        /*Deleted in `lv_task_handler` so don't put it back*/
+        uint32_t i;
+        for(i = 0; i < task_done.cnt; i++) {
+            if(task_done.tasks[i] == task) task_done.tasks[i] = NULL;
+        }
+    } else {
+        task_heap_remove(task);
+    }
+#endif
+
     lv_ll_rem(&LV_GC_ROOT(_lv_task_ll), task);
 
-    lv_mem_free(task);
+    lv_ll_free(&LV_GC_ROOT(_lv_task_ll), task);
 
     if(LV_GC_ROOT(_lv_task_act) == task) task_deleted = true; /*The active task was deleted*/
 }
@@ -266,6 +412,11 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
 {
     if(task->prio == prio) return;
 
+#if LV_TASK_HEAP
+    /*Move it to the heap of the new priority*/
+    task_heap_remove(task);
+#endif
+
     /*Find the tasks with new priority*/
     lv_task_t * i;
     LV_LL_READ(LV_GC_ROOT(_lv_task_ll), i)
@@ -282,6 +433,10 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
     }
 
     task->prio = prio;
+
+#if LV_TASK_HEAP
+    task_heap_insert(task);
+#endif
 }
 
 /**
@@ -292,6 +447,10 @@ void lv_task_set_prio(lv_task_t * task, lv_task_prio_t prio)
 void lv_task_set_period(lv_task_t * task, uint32_t period)
 {
     task->period = period;
+
+#if LV_TASK_HEAP
+    task_heap_update(task);
+#endif
 }
 
 /**
@@ -301,6 +460,10 @@ void lv_task_set_period(lv_task_t * task, uint32_t period)
 void lv_task_ready(lv_task_t * task)
 {
     task->last_run = lv_tick_get() - task->period - 1;
+
+#if LV_TASK_HEAP
+    task_heap_update(task);
+#endif
 }
 
 /**
@@ -320,6 +483,74 @@ void lv_task_once(lv_task_t * task)
 void lv_task_reset(lv_task_t * task)
 {
     task->last_run = lv_tick_get();
+
+#if LV_TASK_HEAP
+    task_heap_update(task);
+#endif
+}
+
+/**
+ * Pause a lv_task. It won't run and `lv_task_handler` won't wait for it until it's resumed.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_pause(lv_task_t * task)
+{
+    task->paused = 1;
+
+#if LV_TASK_HEAP
+    task_heap_remove(task);
+#endif
+}
+
+/**
+ * Resume a paused lv_task. It runs as soon as its period has elapsed since its last run.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_resume(lv_task_t * task)
+{
+    task->paused = 0;
+
+#if LV_TASK_HEAP
+    task_heap_insert(task);
+#endif
+}
+
+/**
+ * Get the time until the next active task has to run
+ * @return time in ms, 0 if a task is already due, or `LV_NO_TASK_READY` if there is no active task
+ */
+uint32_t lv_task_get_time_till_next(void)
+{
+    uint32_t time_till_next = LV_NO_TASK_READY;
+
+#if LV_TASK_HEAP
+    /*Only the first task of the heaps can be the next*/
+    uint8_t p;
+    for(p = LV_TASK_PRIO_LOWEST; p < _LV_TASK_PRIO_NUM; p++) {
+        if(task_heap[p].cnt == 0) continue;
+        lv_task_t * task = task_heap[p].tasks[0];
+
+        uint32_t elp = lv_tick_elaps(task->last_run);
+        if(elp >= task->period) return 0;
+
+        if(task->period - elp < time_till_next) time_till_next = task->period - elp;
+    }
+#else
+    lv_task_t * task;
+    LV_LL_READ(LV_GC_ROOT(_lv_task_ll), task)
+    {
+        /*The tasks are ordered by priority so only turned off tasks come from here*/
+        if(task->prio == LV_TASK_PRIO_OFF) break;
+        if(task->paused) continue;
+
+        uint32_t elp = lv_tick_elaps(task->last_run);
+        if(elp >= task->period) return 0;
+
+        if(task->period - elp < time_till_next) time_till_next = task->period - elp;
+    }
+#endif
+
+    return time_till_next;
 }
 
 /**
@@ -353,13 +584,18 @@ static bool lv_task_exec(lv_task_t * task)
 {
     bool exec = false;
 
+    if(task->paused) return false;
+
     /*Execute if at least 'period' time elapsed*/
     uint32_t elp = lv_tick_elaps(task->last_run);
     if(elp >= task->period) {
         task->last_run = lv_tick_get();
         task_deleted   = false;
         task_created   = false;
-        if(task->task_cb) task->task_cb(task);
+        lv_task_cb_t task_cb = task->task_cb;
+        uint32_t prof_start  = lv_prof_start();
+        if(task_cb) task_cb(task);
+        lv_prof_task(task_cb, prof_start);
 
         /*Delete if it was a one shot lv_task*/
         if(task_deleted == false) { /*The task might be deleted by itself as well*/
@@ -372,3 +608,140 @@ static bool lv_task_exec(lv_task_t * task)
 
     return exec;
 }
+
+#if LV_TASK_HEAP
+/**
+ * Be sure a task array can store a given number of tasks
+ * @param heap pointer to a task array
+ * @param cnt required number of tasks
+ * @return true: there is enough space; false: out of memory
+ */
+static bool task_heap_reserve(lv_task_heap_t * heap, uint32_t cnt)
+{
+    if(cnt <= heap->size) return true;
+
+    uint32_t new_size = heap->size == 0 ? HEAP_SIZE_MIN : heap->size * 2;
+    while(new_size < cnt) new_size *= 2;
+
+    lv_task_t ** new_tasks = lv_mem_realloc(heap->tasks, new_size * sizeof(lv_task_t *));
+    if(new_tasks == NULL) return false;
+
+    heap->tasks = new_tasks;
+    heap->size  = new_size;
+
+    return true;
+}
+
+/**
+ * Add a task to the heap of its priority if it's not turned off or paused
+ * @param task pointer to a task which is not in a heap
+ */
+static void task_heap_insert(lv_task_t * task)
+{
+    /*Already in a heap or ran in the current `lv_task_handler` call (it will be put back there)*/
+    if(task->heap_i != HEAP_NONE) return;
+    if(task->prio == LV_TASK_PRIO_OFF || task->paused) return;
+
+    lv_task_heap_t * heap = &task_heap[task->prio];
+    if(task_heap_reserve(heap, heap->cnt + 1) == false) {
+        LV_LOG_ERROR("lv_task: out of memory, the task won't run");
+        return;
+    }
+
+    task->heap_i             = heap->cnt;
+    heap->tasks[heap->cnt++] = task;
+    task_heap_sift_up(heap, task->heap_i);
+}
+
+/**
+ * Remove a task from the heap of its priority
+ * @param task pointer to a task (it's not necessarily in a heap)
+ */
+static void task_heap_remove(lv_task_t * task)
+{
+    if(task->heap_i == HEAP_NONE || task->heap_i == HEAP_DONE) return;
+
+    lv_task_heap_t * heap = &task_heap[task->prio];
+    uint32_t i            = task->heap_i;
+    task->heap_i          = HEAP_NONE;
+
+    heap->cnt--;
+    if(i == heap->cnt) return;
+
+    /*Move the last task to the empty place and restore the order around it*/
+    lv_task_t * last = heap->tasks[heap->cnt];
+    heap->tasks[i]   = last;
+    last->heap_i     = i;
+    task_heap_sift_up(heap, i);
+    task_heap_sift_down(heap, last->heap_i);
+}
+
+/**
+ * Move a task to its place in its heap after its next run time has changed
+ * @param task pointer to a task (it's not necessarily in a heap)
+ */
+static void task_heap_update(lv_task_t * task)
+{
+    if(task->heap_i == HEAP_NONE || task->heap_i == HEAP_DONE) return;
+
+    lv_task_heap_t * heap = &task_heap[task->prio];
+    task_heap_sift_up(heap, task->heap_i);
+    task_heap_sift_down(heap, task->heap_i);
+}
+
+/**
+ * Move a task towards the top of the heap while it should run earlier than its parent
+ * @param heap pointer to a heap
+ * @param i index of the task to move
+ */
+static void task_heap_sift_up(lv_task_heap_t * heap, uint32_t i)
+{
+    lv_task_t * task = heap->tasks[i];
+    while(i > 0) {
+        uint32_t parent = (i - 1) / 2;
+        if(task_heap_before(task, heap->tasks[parent]) == false) break;
+
+        heap->tasks[i]         = heap->tasks[parent];
+        heap->tasks[i]->heap_i = i;
+        i                      = parent;
+    }
+
+    heap->tasks[i] = task;
+    task->heap_i   = i;
+}
+
+/**
+ * Move a task towards the bottom of the heap while one of its children should run earlier
+ * @param heap pointer to a heap
+ * @param i index of the task to move
+ */
+static void task_heap_sift_down(lv_task_heap_t * heap, uint32_t i)
+{
+    lv_task_t * task = heap->tasks[i];
+    while(1) {
+        uint32_t child = 2 * i + 1;
+        if(child >= heap->cnt) break;
+        if(child + 1 < heap->cnt && task_heap_before(heap->tasks[child + 1], heap->tasks[child])) child++;
+        if(task_heap_before(heap->tasks[child], task) == false) break;
+
+        heap->tasks[i]         = heap->tasks[child];
+        heap->tasks[i]->heap_i = i;
+        i                      = child;
+    }
+
+    heap->tasks[i] = task;
+    task->heap_i   = i;
+}
+
+/**
+ * Tell whether a task has to run earlier than an other
+ * @param a pointer to a task
+ * @param b pointer to an other task
+ * @return true: `a` has to run earlier than `b`
+ */
+static bool task_heap_before(const lv_task_t * a, const lv_task_t * b)
+{
+    /*Compare the difference to handle the overflow of the tick*/
+    return (int32_t)((a->last_run + a->period) - (b->last_run + b->period)) < 0 ? true : false;
+}
+#endif
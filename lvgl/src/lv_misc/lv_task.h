@@ -31,6 +31,9 @@ extern "C" {
 #ifndef LV_ATTRIBUTE_TASK_HANDLER
 #define LV_ATTRIBUTE_TASK_HANDLER
 #endif
+
+/*Returned by `lv_task_handler` if there is no active task to wait for*/
+#define LV_NO_TASK_READY 0xFFFFFFFF
 /**********************
  *      TYPEDEFS
  **********************/
@@ -69,6 +72,11 @@ typedef struct _lv_task_t
 
     uint8_t prio : 3; /**< Task priority */
     uint8_t once : 1; /**< 1: one shot task */
+    uint8_t paused : 1; /**< 1: don't run the task and don't wait for it until resumed */
+
+#if LV_TASK_HEAP
+    uint32_t heap_i; /**< Index of the task in the heap of its priority */
+#endif
 } lv_task_t;
 
 /**********************
@@ -80,12 +88,21 @@ typedef struct _lv_task_t
  */
 void lv_task_core_init(void);
 
+#if LV_USE_CONTEXT
+/**
+ * Free the memory of the lv_task module of the active context. Its tasks have to be deleted already.
+ */
+void lv_task_core_deinit(void);
+#endif
+
 //! @cond Doxygen_Suppress
 
 /**
  * Call it  periodically to handle lv_tasks.
+ * @return time until the next task has to run [ms], or `LV_NO_TASK_READY` if there is no active task.
+ *         It's enough to call this function again after this time (or when an input event arrives).
  */
-LV_ATTRIBUTE_TASK_HANDLER void lv_task_handler(void);
+LV_ATTRIBUTE_TASK_HANDLER uint32_t lv_task_handler(void);
 
 //! @endcond
 
@@ -154,6 +171,24 @@ void lv_task_once(lv_task_t * task);
  */
 void lv_task_reset(lv_task_t * task);
 
+/**
+ * Pause a lv_task. It won't run and `lv_task_handler` won't wait for it until it's resumed.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_pause(lv_task_t * task);
+
+/**
+ * Resume a paused lv_task. It runs as soon as its period has elapsed since its last run.
+ * @param task pointer to a lv_task.
+ */
+void lv_task_resume(lv_task_t * task);
+
+/**
+ * Get the time until the next active task has to run
+ * @return time in ms, 0 if a task is already due, or `LV_NO_TASK_READY` if there is no active task
+ */
+uint32_t lv_task_get_time_till_next(void);
+
 /**
  * Enable or disable the whole  lv_task handling
  * @param en: true: lv_task handling is running, false: lv_task handling is suspended
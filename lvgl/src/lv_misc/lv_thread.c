@@ -0,0 +1,186 @@
+/**
+ * @file lv_thread.c
+ *
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_thread.h"
+#if LV_REFR_THREADS > 1
+
+#include <pthread.h>
+#include "lv_log.h"
+#include "lv_gc.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void * worker_main(void * param);
+static void lib_mutex_init(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static pthread_mutex_t lib_mutex;
+static pthread_once_t lib_mutex_once = PTHREAD_ONCE_INIT; /*`lv_mem` can lock before `lv_thread_init`*/
+static pthread_mutex_t job_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t job_start  = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t job_done   = PTHREAD_COND_INITIALIZER;
+static pthread_t workers[LV_REFR_THREADS - 1];
+static uint16_t worker_cnt;
+
+/*The current jobs. Written by `lv_thread_run` only while `job_mutex` is taken*/
+static lv_thread_job_cb_t job_cb_act;
+static void * job_user_data;
+static uint16_t job_cnt_act;
+static uint16_t job_pending;
+static uint32_t job_gen;
+#if LV_USE_CONTEXT
+static lv_context_t * job_ctx; /*The context of the current jobs*/
+static pthread_mutex_t run_mutex = PTHREAD_MUTEX_INITIALIZER; /*The helper threads serve one context at a time*/
+#endif
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Initialize the lock and start the helper threads
+ */
+void lv_thread_init(void)
+{
+    static uint8_t inited = 0;
+    if(inited) return;
+    inited = 1;
+
+    pthread_once(&lib_mutex_once, lib_mutex_init);
+
+    /*If a thread can't be started the jobs are run by the others*/
+    for(worker_cnt = 0; worker_cnt < LV_REFR_THREADS - 1; worker_cnt++) {
+        uintptr_t id = worker_cnt + 1;
+        if(pthread_create(&workers[worker_cnt], NULL, worker_main, (void *)id) != 0) {
+            LV_LOG_WARN("lv_thread_init: couldn't start a drawing thread");
+            break;
+        }
+    }
+}
+
+/**
+ * Take the library lock. It protects the memory allocator and the drawing code which is not
+ * thread safe (e.g. the image cache). It can be taken recursively.
+ */
+void lv_thread_lock(void)
+{
+    pthread_once(&lib_mutex_once, lib_mutex_init);
+    pthread_mutex_lock(&lib_mutex);
+}
+
+/**
+ * Release the library lock
+ */
+void lv_thread_unlock(void)
+{
+    pthread_mutex_unlock(&lib_mutex);
+}
+
+/**
+ * Run jobs in parallel and wait until all of them are ready
+ * @param job_cb the function to call for every job
+ * @param job_cnt number of jobs. Typically `LV_REFR_THREADS`, more jobs are run one after the other
+ * @param user_data passed to `job_cb`
+ */
+void lv_thread_run(lv_thread_job_cb_t job_cb, uint16_t job_cnt, void * user_data)
+{
+    /*The jobs without a thread are run here after the first one*/
+    uint16_t par_cnt = job_cnt > worker_cnt + 1 ? worker_cnt + 1 : job_cnt;
+
+#if LV_USE_CONTEXT
+    /*If an other context has the helper threads run every job here*/
+    if(par_cnt > 1 && pthread_mutex_trylock(&run_mutex) != 0) par_cnt = 1;
+#endif
+
+    if(par_cnt > 1) {
+        pthread_mutex_lock(&job_mutex);
+#if LV_USE_CONTEXT
+        job_ctx = lv_context_act;
+#endif
+        job_cb_act    = job_cb;
+        job_user_data = user_data;
+        job_cnt_act   = par_cnt;
+        job_pending   = par_cnt - 1;
+        job_gen++;
+        pthread_cond_broadcast(&job_start);
+        pthread_mutex_unlock(&job_mutex);
+    }
+
+    uint16_t i;
+    job_cb(0, user_data);
+    for(i = par_cnt; i < job_cnt; i++) job_cb(i, user_data);
+
+    if(par_cnt > 1) {
+        pthread_mutex_lock(&job_mutex);
+        while(job_pending != 0) pthread_cond_wait(&job_done, &job_mutex);
+        pthread_mutex_unlock(&job_mutex);
+#if LV_USE_CONTEXT
+        pthread_mutex_unlock(&run_mutex);
+#endif
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void lib_mutex_init(void)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lib_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static void * worker_main(void * param)
+{
+    uint16_t id  = (uintptr_t)param;
+    uint32_t gen = 0;
+
+    pthread_mutex_lock(&job_mutex);
+    while(1) {
+        while(gen == job_gen) pthread_cond_wait(&job_start, &job_mutex);
+        gen = job_gen;
+
+        /*Not every thread is needed for small areas*/
+        if(id >= job_cnt_act) continue;
+
+        lv_thread_job_cb_t job_cb = job_cb_act;
+        void * user_data          = job_user_data;
+#if LV_USE_CONTEXT
+        lv_context_act = job_ctx;
+#endif
+        pthread_mutex_unlock(&job_mutex);
+
+        job_cb(id, user_data);
+
+        pthread_mutex_lock(&job_mutex);
+        job_pending--;
+        if(job_pending == 0) pthread_cond_signal(&job_done);
+    }
+
+    return NULL;
+}
+
+#endif /*LV_REFR_THREADS > 1*/
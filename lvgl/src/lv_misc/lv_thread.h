@@ -0,0 +1,95 @@
+/**
+ * @file lv_thread.h
+ * Helper threads for drawing a refreshed area in parallel.
+ * Everything else in the library still runs on the thread calling `lv_task_handler`.
+ */
+
+#ifndef LV_THREAD_H
+#define LV_THREAD_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#if LV_REFR_THREADS > 1
+/*The variable has a separate instance in every drawing thread*/
+#define LV_THREAD_LOCAL __thread
+#else
+#define LV_THREAD_LOCAL
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * A job of `lv_thread_run`
+ * @param job index of the job (0 is run on the calling thread)
+ * @param user_data the `user_data` parameter of `lv_thread_run`
+ */
+typedef void (*lv_thread_job_cb_t)(uint16_t job, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+#if LV_REFR_THREADS > 1
+
+/**
+ * Initialize the lock and start the helper threads
+ */
+void lv_thread_init(void);
+
+/**
+ * Take the library lock. It protects the memory allocator and the drawing code which is not
+ * thread safe (e.g. the image cache). It can be taken recursively.
+ */
+void lv_thread_lock(void);
+
+/**
+ * Release the library lock
+ */
+void lv_thread_unlock(void);
+
+/**
+ * Run jobs in parallel and wait until all of them are ready
+ * @param job_cb the function to call for every job
+ * @param job_cnt number of jobs. Typically `LV_REFR_THREADS`, more jobs are run one after the other
+ * @param user_data passed to `job_cb`
+ */
+void lv_thread_run(lv_thread_job_cb_t job_cb, uint16_t job_cnt, void * user_data);
+
+#else
+
+static inline void lv_thread_lock(void)
+{
+}
+
+static inline void lv_thread_unlock(void)
+{
+}
+
+#endif /*LV_REFR_THREADS > 1*/
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_THREAD_H*/
@@ -7,13 +7,24 @@
  *      INCLUDES
  *********************/
 #include "lv_txt.h"
+#include <string.h>
 #include "lv_math.h"
+#include "lv_mem.h"
 
 /*********************
  *      DEFINES
  *********************/
 #define NO_BREAK_FOUND UINT32_MAX
 
+/*Alignment flags doesn't change the layout of a text*/
+#define LAYOUT_FLAG_MASK (LV_TXT_FLAG_RECOLOR | LV_TXT_FLAG_EXPAND)
+
+/*Measure so many lines at most after an edit, if they still don't get the same as before calculate the whole layout*/
+#define LAYOUT_EDIT_LINE_MAX 16
+
+/*A line break depends on the text to a few letters after the next line's start (overflowing letter and kerning)*/
+#define LAYOUT_EDIT_LOOKAHEAD 8
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -155,13 +166,14 @@ uint16_t lv_txt_get_next_line(const char * txt, const lv_font_t * font, lv_coord
     uint32_t letter_w;
     uint32_t letter      = 0;
     uint32_t letter_next = 0;
+    uint32_t ascii_end   = 0;
 
-    letter_next = lv_txt_encoded_next(txt, &i_next);
+    letter_next = lv_txt_encoded_next_fast(txt, &i_next, &ascii_end, UINT32_MAX);
 
     while(txt[i] != '\0') {
         letter      = letter_next;
         i           = i_next;
-        letter_next = lv_txt_encoded_next(txt, &i_next);
+        letter_next = lv_txt_encoded_next_fast(txt, &i_next, &ascii_end, UINT32_MAX);
 
         /*Handle the recolor command*/
         if((flag & LV_TXT_FLAG_RECOLOR) != 0) {
@@ -234,11 +246,12 @@ lv_coord_t lv_txt_get_width(const char * txt, uint16_t length, const lv_font_t *
     lv_txt_cmd_state_t cmd_state = LV_TXT_CMD_STATE_WAIT;
     uint32_t letter;
     uint32_t letter_next;
+    uint32_t ascii_end = 0;
 
     if(length != 0) {
         while(i < length) {
-            letter      = lv_txt_encoded_next(txt, &i);
-            letter_next = lv_txt_encoded_next(&txt[i], NULL);
+            letter      = lv_txt_encoded_next_fast(txt, &i, &ascii_end, length);
+            letter_next = lv_txt_encoded_peek_fast(txt, i);
             if((flag & LV_TXT_FLAG_RECOLOR) != 0) {
                 if(lv_txt_is_cmd(&cmd_state, letter) != false) {
                     continue;
@@ -300,6 +313,255 @@ bool lv_txt_is_cmd(lv_txt_cmd_state_t * state, uint32_t c)
     return ret;
 }
 
+/**
+ * Initialize a text layout as invalid
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_init(lv_txt_layout_t * layout)
+{
+    memset(layout, 0, sizeof(lv_txt_layout_t));
+}
+
+/**
+ * Calculate the line breaks and line widths of a text if the layout is not valid for it yet
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param line_space line space
+ * @param max_width max with of the text (break the lines to fit this size) Set CORD_MAX to avoid
+ * line breaks
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout is valid; false: out of memory or invalid parameters
+ */
+bool lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                          lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag)
+{
+    if(lv_txt_layout_is_valid(layout, txt, font, letter_space, line_space, max_width, flag)) return true;
+
+    layout->valid = 0;
+    if(txt == NULL) return false;
+    if(font == NULL) return false;
+
+    flag &= LAYOUT_FLAG_MASK;
+    if(flag & LV_TXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
+
+    uint32_t line_start   = 0;
+    uint32_t line_cnt     = 0;
+    uint8_t letter_height = lv_font_get_line_height(font);
+    lv_point_t size       = {0, 0};
+
+    /*The same as `lv_txt_get_size` but save the lines*/
+    while(1) {
+        /*Reserve place for the closing line too*/
+        if(line_cnt >= layout->line_cap) {
+            uint32_t new_cap          = layout->line_cap ? layout->line_cap * 2 : 4;
+            lv_txt_line_t * new_lines = lv_mem_realloc(layout->lines, new_cap * sizeof(lv_txt_line_t));
+            if(new_lines == NULL) return false; /*Not fatal: the text needs to be measured on every use*/
+            layout->lines    = new_lines;
+            layout->line_cap = new_cap;
+        }
+
+        layout->lines[line_cnt].start = line_start;
+        layout->lines[line_cnt].width = 0;
+        if(txt[line_start] == '\0') break;
+
+        uint32_t new_line_start = line_start;
+        new_line_start += lv_txt_get_next_line(&txt[line_start], font, letter_space, max_width, flag);
+        lv_coord_t line_width;
+        line_width = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, letter_space, flag);
+
+        layout->lines[line_cnt].width = line_width;
+        size.x                        = LV_MATH_MAX(line_width, size.x);
+        size.y += letter_height + line_space;
+
+        line_cnt++;
+        line_start = new_line_start;
+    }
+
+    /*Make the text one line taller if the last character is '\n' or '\r'*/
+    if((line_start != 0) && (txt[line_start - 1] == '\n' || txt[line_start - 1] == '\r')) {
+        size.y += letter_height + line_space;
+    }
+
+    /*Correction with the last line space or set the height manually if the text is empty*/
+    if(size.y == 0)
+        size.y = letter_height;
+    else
+        size.y -= line_space;
+
+    layout->line_cnt     = line_cnt;
+    layout->size         = size;
+    layout->txt          = txt;
+    layout->font         = font;
+    layout->letter_space = letter_space;
+    layout->line_space   = line_space;
+    layout->max_width    = max_width;
+    layout->flag         = flag;
+    layout->valid        = 1;
+
+    return true;
+}
+
+/**
+ * Check whether a text layout was calculated with the given text and parameters.
+ * The alignment flags doesn't matter.
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param line_space line space
+ * @param max_width max with of the text
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout can be used instead of measuring the text
+ */
+bool lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                            lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag)
+{
+    if(layout == NULL || layout->valid == 0) return false;
+
+    flag &= LAYOUT_FLAG_MASK;
+    if(flag & LV_TXT_FLAG_EXPAND) max_width = LV_COORD_MAX;
+
+    if(layout->txt != txt || layout->font != font) return false;
+    if(layout->letter_space != letter_space || layout->line_space != line_space) return false;
+    if(layout->max_width != max_width || layout->flag != flag) return false;
+
+    return true;
+}
+
+/**
+ * Update a valid layout after a part of its text was replaced.
+ * Only the lines from the edited one are measured again until the line breaks get the same as before.
+ * @param layout pointer to a text layout valid for the text before the edit
+ * @param txt the edited '\0' terminated string (it can be moved by the edit)
+ * @param pos byte index of the edit
+ * @param del_len number of bytes deleted from `pos`
+ * @param ins_len number of bytes inserted to `pos`
+ * @param first_p the index of the first measured line is stored here
+ * @param last_p the index of the last measured line is stored here
+ * @return true: the layout is updated; false: the layout wasn't valid or too many lines changed,
+ *         it's marked invalid and should be calculated again with `lv_txt_layout_update`
+ */
+bool lv_txt_layout_edit(lv_txt_layout_t * layout, const char * txt, uint32_t pos, uint32_t del_len, uint32_t ins_len,
+                        uint32_t * first_p, uint32_t * last_p)
+{
+    if(layout == NULL || layout->valid == 0) return false;
+
+    layout->valid = 0;
+    if(txt == NULL) return false;
+
+    lv_txt_line_t * lines = layout->lines;
+    uint32_t old_cnt      = layout->line_cnt;
+
+    /*Find the last line which starts before the edit*/
+    uint32_t first = 0;
+    uint32_t last  = old_cnt;
+    while(first + 1 < last) {
+        uint32_t mid = (first + last) / 2;
+        if(lines[mid].start <= pos)
+            first = mid;
+        else
+            last = mid;
+    }
+
+    /*Go back to a line whose start can't depend on the edited letters*/
+    while(first > 0 && lines[first + 1].start + LAYOUT_EDIT_LOOKAHEAD > pos) first--;
+
+    /*Measure the lines until one starts at the same (shifted) place in the unchanged end of the text*/
+    lv_txt_line_t new_lines[LAYOUT_EDIT_LINE_MAX];
+    uint32_t new_cnt    = 0;
+    uint32_t old_id     = first + 1;
+    uint32_t line_start = lines[first].start;
+    while(1) {
+        if(txt[line_start] == '\0') {
+            old_id = old_cnt; /*Only the closing line remains*/
+            break;
+        }
+
+        if(new_cnt >= LAYOUT_EDIT_LINE_MAX) return false;
+
+        uint32_t new_line_start = line_start;
+        new_line_start += lv_txt_get_next_line(&txt[line_start], layout->font, layout->letter_space,
+                                               layout->max_width, layout->flag);
+        new_lines[new_cnt].start = line_start;
+        new_lines[new_cnt].width = lv_txt_get_width(&txt[line_start], new_line_start - line_start, layout->font,
+                                                    layout->letter_space, layout->flag);
+        new_cnt++;
+        line_start = new_line_start;
+
+        if(line_start >= pos + ins_len) {
+            uint32_t old_start = line_start - ins_len + del_len;
+            while(old_id < old_cnt && lines[old_id].start < old_start) old_id++;
+            if(old_id < old_cnt && lines[old_id].start == old_start) break;
+        }
+    }
+
+    /*Replace the measured lines and shift the rest with the closing line*/
+    uint32_t tail_cnt = old_cnt + 1 - old_id;
+    uint32_t line_cnt = first + new_cnt + tail_cnt - 1;
+    if(line_cnt >= layout->line_cap) {
+        uint32_t new_cap = LV_MATH_MAX(layout->line_cap * 2, line_cnt + 1);
+        lines            = lv_mem_realloc(layout->lines, new_cap * sizeof(lv_txt_line_t));
+        if(lines == NULL) return false;
+        layout->lines    = lines;
+        layout->line_cap = new_cap;
+    }
+
+    memmove(&lines[first + new_cnt], &lines[old_id], tail_cnt * sizeof(lv_txt_line_t));
+    memcpy(&lines[first], new_lines, new_cnt * sizeof(lv_txt_line_t));
+
+    uint32_t i;
+    for(i = first + new_cnt; i <= line_cnt; i++) {
+        lines[i].start = lines[i].start + ins_len - del_len;
+    }
+
+    /*Get the size the same way as `lv_txt_layout_update`*/
+    uint8_t letter_height = lv_font_get_line_height(layout->font);
+    lv_coord_t line_h     = letter_height + layout->line_space;
+    uint32_t txt_end      = lines[line_cnt].start;
+    lv_point_t size       = {0, (lv_coord_t)(line_cnt * line_h)};
+    for(i = 0; i < line_cnt; i++) size.x = LV_MATH_MAX(lines[i].width, size.x);
+
+    if((txt_end != 0) && (txt[txt_end - 1] == '\n' || txt[txt_end - 1] == '\r')) {
+        size.y += line_h;
+    }
+
+    if(size.y == 0)
+        size.y = letter_height;
+    else
+        size.y -= layout->line_space;
+
+    layout->line_cnt = line_cnt;
+    layout->size     = size;
+    layout->txt      = txt;
+    layout->valid    = 1;
+
+    if(first_p) *first_p = first;
+    if(last_p) *last_p = new_cnt > 0 ? first + new_cnt - 1 : first;
+
+    return true;
+}
+
+/**
+ * Mark a text layout invalid. Required if the text was modified in place.
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_invalidate(lv_txt_layout_t * layout)
+{
+    layout->valid = 0;
+}
+
+/**
+ * Free the memory allocated by a text layout
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_free(lv_txt_layout_t * layout)
+{
+    if(layout->lines) lv_mem_free(layout->lines);
+    lv_txt_layout_init(layout);
+}
+
 /**
  * Insert a string into an other
  * @param txt_buf the original text (must be big enough for the result text)
@@ -311,14 +573,10 @@ void lv_txt_ins(char * txt_buf, uint32_t pos, const char * ins_txt)
 {
     uint32_t old_len = strlen(txt_buf);
     uint32_t ins_len = strlen(ins_txt);
-    uint32_t new_len = ins_len + old_len;
     pos              = lv_txt_encoded_get_byte_id(txt_buf, pos); /*Convert to byte index instead of letter index*/
 
     /*Copy the second part into the end to make place to text to insert*/
-    uint32_t i;
-    for(i = new_len; i >= pos + ins_len; i--) {
-        txt_buf[i] = txt_buf[i - ins_len];
-    }
+    memmove(txt_buf + pos + ins_len, txt_buf + pos, old_len - pos + 1);
 
     /* Copy the text into the new space*/
     memcpy(txt_buf + pos, ins_txt, ins_len);
@@ -338,12 +596,44 @@ void lv_txt_cut(char * txt, uint32_t pos, uint32_t len)
 
     pos = lv_txt_encoded_get_byte_id(txt, pos); /*Convert to byte index instead of letter index*/
     len = lv_txt_encoded_get_byte_id(&txt[pos], len);
+    if(pos + len > old_len) len = old_len - pos;
 
-    /*Copy the second part into the end to make place to text to insert*/
-    uint32_t i;
-    for(i = pos; i <= old_len - len; i++) {
-        txt[i] = txt[i + len];
+    /*Copy the second part into the place of the deleted part*/
+    memmove(txt + pos, txt + pos + len, old_len - pos - len + 1);
+}
+
+/**
+ * Count the 7-bit ASCII bytes at the start of a string, a word at a time.
+ * They are the same in every encoding so they can be read without decoding.
+ * @param txt pointer to a string
+ * @param max check so many bytes at most. Words are read only within them, so it can't be more than
+ *            the bytes left in the string. `UINT32_MAX` if the length is unknown: then it's checked byte by byte.
+ * @return number of bytes before the first non-ASCII byte or '\0' (at most `max`)
+ */
+uint32_t lv_txt_ascii_len(const char * txt, uint32_t max)
+{
+    const uint8_t * p = (const uint8_t *)txt;
+    uint32_t i        = 0;
+
+    /*Byte by byte to the first aligned word*/
+    while(i < max && ((uintptr_t)&p[i] & (sizeof(uint32_t) - 1)) != 0) {
+        if(p[i] == 0 || p[i] >= 0x80) return i;
+        i++;
+    }
+
+    /*Only in the known part of the string, the bytes after its '\0' can't be read.
+     *A byte with bit 7 or a 0 byte sets bit 7 of the word or of its decrement
+     *(the borrow of a 0 byte can set more but they come after it)*/
+    while(max != UINT32_MAX && max - i >= sizeof(uint32_t)) {
+        uint32_t w;
+        memcpy(&w, &p[i], sizeof(uint32_t));
+        if(((w - 0x01010101) | w) & 0x80808080) break;
+        i += sizeof(uint32_t);
     }
+
+    while(i < max && p[i] != 0 && p[i] < 0x80) i++;
+
+    return i;
 }
 
 #if LV_TXT_ENC == LV_TXT_ENC_UTF8
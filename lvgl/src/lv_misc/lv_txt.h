@@ -56,6 +56,34 @@ enum {
 };
 typedef uint8_t lv_txt_cmd_state_t;
 
+/** A line of a `lv_txt_layout_t`*/
+typedef struct
+{
+    uint32_t start;   /**< Byte index of the first character of the line*/
+    lv_coord_t width; /**< Width of the line as `lv_txt_get_width` gives it*/
+} lv_txt_line_t;
+
+/**
+ * The line breaks and line widths of a text.
+ * Calculate it once to not measure the text with `lv_txt_get_next_line` and `lv_txt_get_width` on every use.
+ * It's valid only with the same text and parameters it was calculated with. */
+typedef struct
+{
+    lv_txt_line_t * lines; /**< `line_cnt` lines and one more with the end of the text*/
+    uint32_t line_cnt;
+    uint32_t line_cap;     /**< Number of allocated lines*/
+    lv_point_t size;       /**< Size of the text as `lv_txt_get_size` gives it*/
+
+    /*Parameters of the calculation*/
+    const char * txt;
+    const lv_font_t * font;
+    lv_coord_t letter_space;
+    lv_coord_t line_space;
+    lv_coord_t max_width;
+    lv_txt_flag_t flag;
+    uint8_t valid : 1;
+} lv_txt_layout_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -111,6 +139,70 @@ lv_coord_t lv_txt_get_width(const char * txt, uint16_t length, const lv_font_t *
  */
 bool lv_txt_is_cmd(lv_txt_cmd_state_t * state, uint32_t c);
 
+/**
+ * Initialize a text layout as invalid
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_init(lv_txt_layout_t * layout);
+
+/**
+ * Calculate the line breaks and line widths of a text if the layout is not valid for it yet
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param line_space line space
+ * @param max_width max with of the text (break the lines to fit this size) Set CORD_MAX to avoid
+ * line breaks
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout is valid; false: out of memory or invalid parameters
+ */
+bool lv_txt_layout_update(lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                          lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag);
+
+/**
+ * Check whether a text layout was calculated with the given text and parameters.
+ * The alignment flags doesn't matter.
+ * @param layout pointer to a text layout
+ * @param txt a '\0' terminated string
+ * @param font pointer to a font
+ * @param letter_space letter space
+ * @param line_space line space
+ * @param max_width max with of the text
+ * @param flag settings for the text from 'txt_flag_t' enum
+ * @return true: the layout can be used instead of measuring the text
+ */
+bool lv_txt_layout_is_valid(const lv_txt_layout_t * layout, const char * txt, const lv_font_t * font,
+                            lv_coord_t letter_space, lv_coord_t line_space, lv_coord_t max_width, lv_txt_flag_t flag);
+
+/**
+ * Update a valid layout after a part of its text was replaced.
+ * Only the lines from the edited one are measured again until the line breaks get the same as before.
+ * @param layout pointer to a text layout valid for the text before the edit
+ * @param txt the edited '\0' terminated string (it can be moved by the edit)
+ * @param pos byte index of the edit
+ * @param del_len number of bytes deleted from `pos`
+ * @param ins_len number of bytes inserted to `pos`
+ * @param first_p the index of the first measured line is stored here
+ * @param last_p the index of the last measured line is stored here
+ * @return true: the layout is updated; false: the layout wasn't valid or too many lines changed,
+ *         it's marked invalid and should be calculated again with `lv_txt_layout_update`
+ */
+bool lv_txt_layout_edit(lv_txt_layout_t * layout, const char * txt, uint32_t pos, uint32_t del_len, uint32_t ins_len,
+                        uint32_t * first_p, uint32_t * last_p);
+
+/**
+ * Mark a text layout invalid. Required if the text was modified in place.
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_invalidate(lv_txt_layout_t * layout);
+
+/**
+ * Free the memory allocated by a text layout
+ * @param layout pointer to a text layout
+ */
+void lv_txt_layout_free(lv_txt_layout_t * layout);
+
 /**
  * Insert a string into an other
  * @param txt_buf the original text (must be big enough for the result text)
@@ -128,6 +220,16 @@ void lv_txt_ins(char * txt_buf, uint32_t pos, const char * ins_txt);
  */
 void lv_txt_cut(char * txt, uint32_t pos, uint32_t len);
 
+/**
+ * Count the 7-bit ASCII bytes at the start of a string, a word at a time.
+ * They are the same in every encoding so they can be read without decoding.
+ * @param txt pointer to a string
+ * @param max check so many bytes at most. Words are read only within them, so it can't be more than
+ *            the bytes left in the string. `UINT32_MAX` if the length is unknown: then it's checked byte by byte.
+ * @return number of bytes before the first non-ASCII byte or '\0' (at most `max`)
+ */
+uint32_t lv_txt_ascii_len(const char * txt, uint32_t max);
+
 /***************************************************************
  *  GLOBAL FUNCTION POINTERS FOR CAHRACTER ENCODING INTERFACE
  ***************************************************************/
@@ -198,6 +300,36 @@ extern uint32_t (*lv_encoded_get_char_id)(const char *, uint32_t);
  */
 extern uint32_t (*lv_txt_get_encoded_length)(const char *);
 
+/**
+ * Decode the next character like `lv_txt_encoded_next` but read the ASCII runs byte by byte.
+ * The runs are found with `lv_txt_ascii_len`, the decoder is called only for the other characters.
+ * @param txt pointer to '\0' terminated string
+ * @param i start index in 'txt'. After the call it will point to the next encoded char in 'txt'.
+ * @param ascii_end end of the known ASCII run, updated by the function. Initialize it to 0.
+ * @param len length of 'txt' in bytes if it's known (e.g. the end of a line), `UINT32_MAX` if not
+ * @return the decoded Unicode character or 0 on invalid data
+ */
+static inline uint32_t lv_txt_encoded_next_fast(const char * txt, uint32_t * i, uint32_t * ascii_end, uint32_t len)
+{
+    if(*i >= *ascii_end) {
+        if((uint8_t)txt[*i] >= 0x80 || txt[*i] == '\0') return lv_txt_encoded_next(txt, i);
+        *ascii_end = *i + lv_txt_ascii_len(&txt[*i], len != UINT32_MAX ? len - *i : UINT32_MAX);
+    }
+    return (uint8_t)txt[(*i)++];
+}
+
+/**
+ * Get the character at an index without moving, ASCII without calling the decoder
+ * @param txt pointer to '\0' terminated string
+ * @param i index in 'txt'
+ * @return the decoded Unicode character or 0 on invalid data
+ */
+static inline uint32_t lv_txt_encoded_peek_fast(const char * txt, uint32_t i)
+{
+    if((uint8_t)txt[i] < 0x80) return (uint8_t)txt[i];
+    return lv_txt_encoded_next(&txt[i], NULL);
+}
+
 /**********************
  *      MACROS
  **********************/
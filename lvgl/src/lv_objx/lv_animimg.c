@@ -0,0 +1,764 @@
+/**
+ * @file lv_animimg.c
+ * Animated image streamed from a file. The file stores only the areas changing between the frames, little endian:
+ *
+ *   header  "LVAI", u16 version, u8 color format, u8 color depth, u16 width, u16 height, u32 frame_cnt, u32 0
+ *   frames  frame_cnt * {u32 size of the rest of the frame, u16 duration [ms], u16 area_cnt,
+ *                        area_cnt * {u16 x, u16 y, u16 w, u16 h, w * h pixels row by row}}
+ *
+ * The first frame has one area of the whole image. The pixels are in the target's format, the depth has to match.
+ *
+ * The frames are decoded into a ring of `LV_ANIMIMG_RING` frames right after a frame is shown, so the next ones are
+ * ready when they are due. A slot is brought up to date from the previous frame by copying only the areas changed
+ * in the frames since the slot was decoded, then the areas of the new frame are read into it. Showing a frame
+ * invalidates only its changed areas. The memory doesn't depend on the length of the animation.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_animimg.h"
+#if LV_USE_ANIMIMG != 0
+
+#include <string.h>
+#include "../lv_misc/lv_mem.h"
+#include "../lv_misc/lv_log.h"
+#include "../lv_misc/lv_math.h"
+#include "../lv_draw/lv_draw_basic.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define ANIMIMG_MAGIC "LVAI"
+#define ANIMIMG_VERSION 1
+#define ANIMIMG_HEADER_SIZE 20
+#define ANIMIMG_FRAME_HEADER_SIZE 8
+#define ANIMIMG_AREA_HEADER_SIZE 8
+
+#if LV_ANIMIMG_RING < 2
+#error "lv_animimg: LV_ANIMIMG_RING has to be at least 2 (the shown frame and the next one)"
+#endif
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    lv_fs_file_t file;
+    bool err;
+} animimg_writer_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool lv_animimg_design(lv_obj_t * animimg, const lv_area_t * mask, lv_design_mode_t mode);
+static lv_res_t lv_animimg_signal(lv_obj_t * animimg, lv_signal_t sign, void * param);
+static void anim_task(lv_task_t * task);
+static void frame_invalidate(lv_obj_t * animimg, const lv_animimg_slot_t * slot);
+static bool frame_decode(lv_obj_t * animimg);
+static void slot_carry(lv_animimg_ext_t * ext, uint32_t dec);
+static void damage_add(lv_animimg_slot_t * slot, const lv_area_t * area);
+static bool src_read(lv_animimg_ext_t * ext, void * dest, uint32_t len);
+static void src_close(lv_obj_t * animimg);
+static uint32_t save_diff(const lv_img_dsc_t * prev, const lv_img_dsc_t * cur, uint8_t px_size, lv_area_t * areas);
+static bool row_diff(const uint8_t * a, const uint8_t * b, lv_coord_t w, uint8_t px_size, lv_coord_t * x1,
+                     lv_coord_t * x2);
+static void wr_bytes(animimg_writer_t * w, const void * data, uint32_t len);
+static void wr_u16(animimg_writer_t * w, uint16_t v);
+static void wr_u32(animimg_writer_t * w, uint32_t v);
+static uint16_t rd_u16(const uint8_t * p);
+static uint32_t rd_u32(const uint8_t * p);
+static inline uint8_t * slot_px(const lv_animimg_ext_t * ext, uint32_t dec);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_signal_cb_t ancestor_signal;
+
+/**********************
+ *      MACROS
+ **********************/
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Create an animated image object
+ * @param par pointer to an object, it will be the parent of the new animated image
+ * @param copy pointer to an animated image object, if not NULL then the new object will be copied from it
+ * @return pointer to the created animated image
+ */
+lv_obj_t * lv_animimg_create(lv_obj_t * par, const lv_obj_t * copy)
+{
+    LV_LOG_TRACE("animated image create started");
+
+    /*Create the ancestor basic object*/
+    lv_obj_t * new_animimg = lv_obj_create(par, copy);
+    lv_mem_assert(new_animimg);
+    if(new_animimg == NULL) return NULL;
+
+    if(ancestor_signal == NULL) ancestor_signal = lv_obj_get_signal_cb(new_animimg);
+
+    /*Allocate the object type specific extended data*/
+    lv_animimg_ext_t * ext = lv_obj_allocate_ext_attr(new_animimg, sizeof(lv_animimg_ext_t));
+    lv_mem_assert(ext);
+    if(ext == NULL) return NULL;
+
+    memset(ext, 0, sizeof(lv_animimg_ext_t));
+    ext->loop    = 1;
+    ext->playing = 1;
+
+    lv_obj_set_signal_cb(new_animimg, lv_animimg_signal);
+    lv_obj_set_design_cb(new_animimg, lv_animimg_design);
+
+    /*Init the new animated image object*/
+    if(copy == NULL) {
+        lv_obj_set_click(new_animimg, false);
+        lv_obj_set_style(new_animimg, NULL); /*Inherit the style by default like an image*/
+    }
+    /*Copy an existing object*/
+    else {
+        lv_animimg_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
+        ext->loop                   = copy_ext->loop;
+        ext->playing                = copy_ext->playing;
+        if(copy_ext->src) lv_animimg_set_src(new_animimg, copy_ext->src);
+
+        /*Refresh the style with new signal function*/
+        lv_obj_refresh_style(new_animimg);
+    }
+
+    LV_LOG_INFO("animated image created");
+
+    return new_animimg;
+}
+
+/**
+ * Write frames into a file which an animated image can play. Only the areas changing from frame to frame
+ * are stored. The frames have to be of the same size and `LV_IMG_CF_TRUE_COLOR...` color format.
+ * @param path path of the new file, e.g. "S:/anim/boot.lvai"
+ * @param frames the frames in the order to show
+ * @param durations [ms] to show each frame
+ * @param cnt number of frames
+ * @return LV_RES_OK: written; LV_RES_INV: the frames can't be stored or the file couldn't be written
+ */
+lv_res_t lv_animimg_save(const char * path, const lv_img_dsc_t * const * frames, const uint16_t * durations,
+                         uint32_t cnt)
+{
+    if(cnt == 0) return LV_RES_INV;
+
+    const lv_img_header_t * h = &frames[0]->header;
+    if(h->cf != LV_IMG_CF_TRUE_COLOR && h->cf != LV_IMG_CF_TRUE_COLOR_ALPHA &&
+       h->cf != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+        LV_LOG_WARN("lv_animimg_save: only true color frames can be stored");
+        return LV_RES_INV;
+    }
+    uint32_t i;
+    for(i = 1; i < cnt; i++) {
+        if(frames[i]->header.cf != h->cf || frames[i]->header.w != h->w || frames[i]->header.h != h->h) {
+            LV_LOG_WARN("lv_animimg_save: the frames differ in size or color format");
+            return LV_RES_INV;
+        }
+    }
+
+    animimg_writer_t w;
+    w.err = false;
+    if(lv_fs_open(&w.file, path, LV_FS_MODE_WR) != LV_FS_RES_OK) return LV_RES_INV;
+
+    uint8_t px_size = lv_img_color_format_get_px_size(h->cf) >> 3;
+    wr_bytes(&w, ANIMIMG_MAGIC, 4);
+    wr_u16(&w, ANIMIMG_VERSION);
+    uint8_t fmt[2] = {h->cf, LV_COLOR_DEPTH};
+    wr_bytes(&w, fmt, 2);
+    wr_u16(&w, h->w);
+    wr_u16(&w, h->h);
+    wr_u32(&w, cnt);
+    wr_u32(&w, 0);
+
+    for(i = 0; i < cnt && w.err == false; i++) {
+        lv_area_t areas[LV_ANIMIMG_DAMAGE_MAX];
+        uint32_t area_cnt;
+        if(i == 0) {
+            lv_area_set(&areas[0], 0, 0, h->w - 1, h->h - 1);
+            area_cnt = 1;
+        } else {
+            area_cnt = save_diff(frames[i - 1], frames[i], px_size, areas);
+        }
+
+        uint32_t size = ANIMIMG_FRAME_HEADER_SIZE - 4;
+        uint32_t a;
+        for(a = 0; a < area_cnt; a++) size += ANIMIMG_AREA_HEADER_SIZE + lv_area_get_size(&areas[a]) * px_size;
+        wr_u32(&w, size);
+        wr_u16(&w, durations[i]);
+        wr_u16(&w, area_cnt);
+
+        for(a = 0; a < area_cnt; a++) {
+            lv_area_t * ar = &areas[a];
+            wr_u16(&w, ar->x1);
+            wr_u16(&w, ar->y1);
+            wr_u16(&w, lv_area_get_width(ar));
+            wr_u16(&w, lv_area_get_height(ar));
+            lv_coord_t y;
+            for(y = ar->y1; y <= ar->y2; y++) {
+                wr_bytes(&w, &frames[i]->data[((uint32_t)y * h->w + ar->x1) * px_size], lv_area_get_width(ar) * px_size);
+            }
+        }
+    }
+
+    if(lv_fs_close(&w.file) != LV_FS_RES_OK) w.err = true;
+    return w.err ? LV_RES_INV : LV_RES_OK;
+}
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * Play the frames of a file written by `lv_animimg_save`. The frames are read and decoded while they are shown,
+ * only `LV_ANIMIMG_RING` decoded frames are kept in the memory. The object gets the size of the frames.
+ * @param animimg pointer to an animated image object
+ * @param path path of the file
+ * @return LV_RES_OK: playing; LV_RES_INV: the file can't be opened or isn't valid (nothing is shown)
+ */
+lv_res_t lv_animimg_set_src(lv_obj_t * animimg, const char * path)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+
+    /*`path` might be the current source (e.g. to start again)*/
+    char * new_src = lv_mem_alloc(strlen(path) + 1);
+    lv_mem_assert(new_src);
+    if(new_src == NULL) return LV_RES_INV;
+    strcpy(new_src, path);
+
+    src_close(animimg);
+    lv_obj_invalidate(animimg);
+    ext->src = new_src;
+
+    if(lv_fs_open(&ext->file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        LV_LOG_WARN("lv_animimg_set_src: can't open the file");
+        src_close(animimg);
+        return LV_RES_INV;
+    }
+    ext->opened = 1;
+
+    uint8_t hdr[ANIMIMG_HEADER_SIZE];
+    uint32_t br = 0;
+    lv_fs_read(&ext->file, hdr, ANIMIMG_HEADER_SIZE, &br);
+    if(br != ANIMIMG_HEADER_SIZE || memcmp(hdr, ANIMIMG_MAGIC, 4) != 0 || rd_u16(&hdr[4]) != ANIMIMG_VERSION ||
+       hdr[7] != LV_COLOR_DEPTH || rd_u32(&hdr[12]) == 0 ||
+       (hdr[6] != LV_IMG_CF_TRUE_COLOR && hdr[6] != LV_IMG_CF_TRUE_COLOR_ALPHA &&
+        hdr[6] != LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED)) {
+        LV_LOG_WARN("lv_animimg_set_src: not an animated image of this color depth");
+        src_close(animimg);
+        return LV_RES_INV;
+    }
+
+    ext->cf         = hdr[6];
+    ext->px_size    = lv_img_color_format_get_px_size(ext->cf) >> 3;
+    ext->w          = rd_u16(&hdr[8]);
+    ext->h          = rd_u16(&hdr[10]);
+    ext->frame_cnt  = rd_u32(&hdr[12]);
+    ext->next_frame = 0;
+    ext->dec_cnt    = 0;
+    ext->shown      = 0;
+    ext->late_cnt   = 0;
+    ext->rd_len     = 0;
+    ext->rd_pos     = 0;
+
+    ext->ring   = lv_mem_alloc((uint32_t)ext->w * ext->h * ext->px_size * LV_ANIMIMG_RING);
+    ext->rd_buf = lv_mem_alloc(LV_ANIMIMG_READ_AHEAD);
+    if(ext->ring == NULL || ext->rd_buf == NULL || ext->w == 0 || ext->h == 0 || frame_decode(animimg) == false) {
+        LV_LOG_WARN("lv_animimg_set_src: can't decode the first frame");
+        src_close(animimg);
+        return LV_RES_INV;
+    }
+
+    lv_obj_set_size(animimg, ext->w, ext->h);
+    lv_obj_invalidate(animimg);
+
+    ext->task = lv_task_create(anim_task, ext->slot[0].duration, LV_TASK_PRIO_MID, animimg);
+    if(ext->playing == 0 || ext->frame_cnt == 1) lv_task_pause(ext->task);
+
+    /*Decode the next frames till they are due*/
+    while(ext->dec_cnt < LV_ANIMIMG_RING && ext->frame_cnt > 1 && frame_decode(animimg))
+        ;
+
+    return LV_RES_OK;
+}
+
+/**
+ * Start or stop the animation. A stopped animation shows its current frame.
+ * @param animimg pointer to an animated image object
+ * @param en true: play
+ */
+void lv_animimg_set_playing(lv_obj_t * animimg, bool en)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    ext->playing           = en ? 1 : 0;
+    if(ext->task == NULL) return;
+
+    if(en && ext->frame_cnt > 1) {
+        lv_task_reset(ext->task);
+        lv_task_resume(ext->task);
+    } else {
+        lv_task_pause(ext->task);
+    }
+}
+
+/**
+ * Set whether the animation starts again after the last frame
+ * @param animimg pointer to an animated image object
+ * @param en true: loop (default); false: stop on the last frame
+ */
+void lv_animimg_set_loop(lv_obj_t * animimg, bool en)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    ext->loop              = en ? 1 : 0;
+
+    /*Decode the first frame ahead now if the last one is shown*/
+    if(ext->task && ext->playing && ext->frame_cnt > 1) lv_task_resume(ext->task);
+}
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+/**
+ * Get the path of the played file
+ * @param animimg pointer to an animated image object
+ * @return the path or NULL if nothing is played
+ */
+const char * lv_animimg_get_src(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->src;
+}
+
+/**
+ * Get the number of frames of the played file
+ * @param animimg pointer to an animated image object
+ * @return number of frames
+ */
+uint32_t lv_animimg_get_frame_cnt(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->ring ? ext->frame_cnt : 0;
+}
+
+/**
+ * Get the index of the shown frame
+ * @param animimg pointer to an animated image object
+ * @return index of the frame in the file
+ */
+uint32_t lv_animimg_get_frame(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->ring ? ext->slot[ext->shown % LV_ANIMIMG_RING].frame : 0;
+}
+
+/**
+ * Get the number of frames which weren't decoded ahead when they were due (e.g. the file system was slow)
+ * @param animimg pointer to an animated image object
+ * @return number of late frames
+ */
+uint32_t lv_animimg_get_late_cnt(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->late_cnt;
+}
+
+/**
+ * Tell whether the animation is playing
+ * @param animimg pointer to an animated image object
+ * @return true: playing
+ */
+bool lv_animimg_get_playing(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->playing ? true : false;
+}
+
+/**
+ * Tell whether the animation starts again after the last frame
+ * @param animimg pointer to an animated image object
+ * @return true: loop
+ */
+bool lv_animimg_get_loop(const lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    return ext->loop ? true : false;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+/**
+ * Handle the drawing related tasks of the animated images
+ * @param animimg pointer to an object
+ * @param mask the object will be drawn only in this area
+ * @param mode LV_DESIGN_COVER_CHK: only check if the object fully covers the 'mask_p' area
+ *                                  (return 'true' if yes)
+ *             LV_DESIGN_DRAW: draw the object (always return 'true')
+ *             LV_DESIGN_DRAW_POST: drawing after every children are drawn
+ * @param return true/false, depends on 'mode'
+ */
+static bool lv_animimg_design(lv_obj_t * animimg, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+
+    if(mode == LV_DESIGN_COVER_CHK) {
+        if(ext->ring == NULL || ext->cf != LV_IMG_CF_TRUE_COLOR) return false;
+        return lv_area_is_in(mask, &animimg->coords);
+    } else if(mode == LV_DESIGN_DRAW_MAIN) {
+        if(ext->ring == NULL) return true;
+
+        const lv_style_t * style = lv_obj_get_style(animimg);
+        lv_opa_t opa_scale       = lv_obj_get_opa_scale(animimg);
+        lv_opa_t opa =
+            opa_scale == LV_OPA_COVER ? style->image.opa : (uint16_t)((uint16_t)style->image.opa * opa_scale) >> 8;
+
+        /*The decoded frame is drawn in place, it's never in the image cache.
+         *The task writes only the other slots of the ring, and not while drawing.*/
+        lv_area_t coords;
+        lv_area_set(&coords, animimg->coords.x1, animimg->coords.y1, animimg->coords.x1 + ext->w - 1,
+                    animimg->coords.y1 + ext->h - 1);
+        lv_draw_map(&coords, mask, slot_px(ext, ext->shown), opa, lv_img_color_format_is_chroma_keyed(ext->cf),
+                    lv_img_color_format_has_alpha(ext->cf), style->image.color, style->image.intense);
+    }
+
+    return true;
+}
+
+/**
+ * Signal function of the animated image
+ * @param animimg pointer to an animated image object
+ * @param sign a signal type from lv_signal_t enum
+ * @param param pointer to a signal specific variable
+ * @return LV_RES_OK: the object is not deleted in the function; LV_RES_INV: the object is deleted
+ */
+static lv_res_t lv_animimg_signal(lv_obj_t * animimg, lv_signal_t sign, void * param)
+{
+    lv_res_t res;
+
+    /* Include the ancient signal function */
+    res = ancestor_signal(animimg, sign, param);
+    if(res != LV_RES_OK) return res;
+
+    if(sign == LV_SIGNAL_CLEANUP) {
+        src_close(animimg);
+    } else if(sign == LV_SIGNAL_GET_TYPE) {
+        lv_obj_type_t * buf = param;
+        uint8_t i;
+        for(i = 0; i < LV_MAX_ANCESTOR_NUM - 1; i++) { /*Find the last set data*/
+            if(buf->type[i] == NULL) break;
+        }
+        buf->type[i] = "lv_animimg";
+    }
+
+    return res;
+}
+
+/**
+ * Show the next frame when the time of the current one is over and decode the frames after it
+ * @param task the task of an animated image
+ */
+static void anim_task(lv_task_t * task)
+{
+    lv_obj_t * animimg     = task->user_data;
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+
+    if(ext->dec_cnt == ext->shown + 1) {
+        /*Not decoded ahead: the last frame without loop, or the file system was too slow*/
+        if(ext->next_frame == ext->frame_cnt && ext->loop == 0) {
+            lv_task_pause(task);
+            return;
+        }
+        if(frame_decode(animimg) == false) {
+            lv_task_pause(task);
+            return;
+        }
+        ext->late_cnt++;
+    }
+
+    ext->shown++;
+    const lv_animimg_slot_t * slot = &ext->slot[ext->shown % LV_ANIMIMG_RING];
+    frame_invalidate(animimg, slot);
+    lv_task_set_period(task, slot->duration);
+
+    /*Every slot but the shown one can be decoded ahead*/
+    while(ext->dec_cnt - ext->shown < LV_ANIMIMG_RING && frame_decode(animimg))
+        ;
+}
+
+/**
+ * Invalidate the areas of a frame which changed since the previous frame
+ */
+static void frame_invalidate(lv_obj_t * animimg, const lv_animimg_slot_t * slot)
+{
+    if(slot->all) {
+        lv_obj_invalidate(animimg);
+        return;
+    }
+
+    uint8_t i;
+    for(i = 0; i < slot->damage_cnt; i++) {
+        lv_area_t a = slot->damage[i];
+        a.x1 += animimg->coords.x1;
+        a.x2 += animimg->coords.x1;
+        a.y1 += animimg->coords.y1;
+        a.y2 += animimg->coords.y1;
+        lv_obj_invalidate_area(animimg, &a);
+    }
+}
+
+/**
+ * Decode the next frame of the file into the next slot of the ring
+ * @param animimg pointer to an animated image object
+ * @return false: it's the end without loop, or the file is damaged (then nothing more is decoded)
+ */
+static bool frame_decode(lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+    if(ext->opened == 0) return false;
+
+    if(ext->next_frame == ext->frame_cnt) {
+        if(ext->loop == 0) return false;
+        if(lv_fs_seek(&ext->file, ANIMIMG_HEADER_SIZE) != LV_FS_RES_OK) return false;
+        ext->rd_len     = 0;
+        ext->rd_pos     = 0;
+        ext->next_frame = 0;
+    }
+
+    uint32_t dec             = ext->dec_cnt;
+    lv_animimg_slot_t * slot = &ext->slot[dec % LV_ANIMIMG_RING];
+    uint8_t * px             = slot_px(ext, dec);
+    if(dec > 0) slot_carry(ext, dec);
+
+    uint8_t fh[ANIMIMG_FRAME_HEADER_SIZE] = {0};
+    bool ok           = src_read(ext, fh, ANIMIMG_FRAME_HEADER_SIZE) && rd_u32(&fh[0]) >= ANIMIMG_FRAME_HEADER_SIZE - 4;
+    uint32_t left     = ok ? rd_u32(&fh[0]) - (ANIMIMG_FRAME_HEADER_SIZE - 4) : 0;
+    uint16_t area_cnt = rd_u16(&fh[6]);
+    slot->frame       = ext->next_frame;
+    slot->duration    = LV_MATH_MAX(rd_u16(&fh[4]), 1);
+    slot->damage_cnt  = 0;
+    slot->all         = ext->next_frame == 0 ? 1 : 0;
+
+    uint32_t stride = (uint32_t)ext->w * ext->px_size;
+    uint16_t i;
+    for(i = 0; ok && i < area_cnt; i++) {
+        uint8_t ah[ANIMIMG_AREA_HEADER_SIZE];
+        ok = left >= ANIMIMG_AREA_HEADER_SIZE && src_read(ext, ah, ANIMIMG_AREA_HEADER_SIZE);
+        if(!ok) break;
+        lv_area_t a;
+        lv_area_set(&a, rd_u16(&ah[0]), rd_u16(&ah[2]), rd_u16(&ah[0]) + rd_u16(&ah[4]) - 1,
+                    rd_u16(&ah[2]) + rd_u16(&ah[6]) - 1);
+        uint32_t len = lv_area_get_width(&a) * ext->px_size;
+        left -= ANIMIMG_AREA_HEADER_SIZE;
+        ok = rd_u16(&ah[4]) > 0 && rd_u16(&ah[6]) > 0 && a.x2 < ext->w && a.y2 < ext->h &&
+             left >= len * lv_area_get_height(&a);
+        if(!ok) break;
+
+        lv_coord_t y;
+        for(y = a.y1; ok && y <= a.y2; y++) ok = src_read(ext, &px[y * stride + a.x1 * ext->px_size], len);
+        left -= len * lv_area_get_height(&a);
+        damage_add(slot, &a);
+    }
+
+    if(!ok || left != 0) {
+        LV_LOG_WARN("lv_animimg: the file is damaged, the animation stops");
+        lv_fs_close(&ext->file);
+        ext->opened = 0;
+        return false;
+    }
+
+    ext->next_frame++;
+    ext->dec_cnt++;
+    return true;
+}
+
+/**
+ * Bring a slot up to the previous frame: it holds the frame `LV_ANIMIMG_RING` frames before the new one,
+ * the areas changed in the frames after it are copied from the previous frame.
+ * @param ext the ext. of the animated image
+ * @param dec the frame to decode into the slot (> 0)
+ */
+static void slot_carry(lv_animimg_ext_t * ext, uint32_t dec)
+{
+    uint8_t * dest      = slot_px(ext, dec);
+    const uint8_t * src = slot_px(ext, dec - 1);
+    uint32_t stride     = (uint32_t)ext->w * ext->px_size;
+    uint32_t first      = dec >= LV_ANIMIMG_RING ? dec - LV_ANIMIMG_RING + 1 : 0;
+
+    /*Until the ring is full the slot is empty, the first frame changes the whole image*/
+    uint32_t d;
+    for(d = first; d < dec; d++) {
+        if(dec < LV_ANIMIMG_RING || ext->slot[d % LV_ANIMIMG_RING].all) {
+            memcpy(dest, src, stride * ext->h);
+            return;
+        }
+    }
+
+    for(d = first; d < dec; d++) {
+        const lv_animimg_slot_t * s = &ext->slot[d % LV_ANIMIMG_RING];
+        uint8_t i;
+        for(i = 0; i < s->damage_cnt; i++) {
+            const lv_area_t * a = &s->damage[i];
+            uint32_t ofs        = a->y1 * stride + a->x1 * ext->px_size;
+            uint32_t len        = lv_area_get_width(a) * ext->px_size;
+            lv_coord_t y;
+            for(y = a->y1; y <= a->y2; y++, ofs += stride) memcpy(&dest[ofs], &src[ofs], len);
+        }
+    }
+}
+
+/**
+ * Add a decoded area to the changed areas of a frame. The ones over `LV_ANIMIMG_DAMAGE_MAX` are joined to the last.
+ */
+static void damage_add(lv_animimg_slot_t * slot, const lv_area_t * area)
+{
+    if(slot->damage_cnt == LV_ANIMIMG_DAMAGE_MAX) {
+        lv_area_t * last = &slot->damage[LV_ANIMIMG_DAMAGE_MAX - 1];
+        lv_area_join(last, last, area);
+    } else {
+        slot->damage[slot->damage_cnt++] = *area;
+    }
+}
+
+/**
+ * Read from the file through the read-ahead buffer. Long reads go straight into the destination.
+ * @return false: the file ended or couldn't be read
+ */
+static bool src_read(lv_animimg_ext_t * ext, void * dest, uint32_t len)
+{
+    uint8_t * d = dest;
+    while(len > 0) {
+        if(ext->rd_pos == ext->rd_len) {
+            uint32_t br = 0;
+            if(len >= LV_ANIMIMG_READ_AHEAD) {
+                if(lv_fs_read(&ext->file, d, len, &br) != LV_FS_RES_OK || br != len) return false;
+                return true;
+            }
+            if(lv_fs_read(&ext->file, ext->rd_buf, LV_ANIMIMG_READ_AHEAD, &br) != LV_FS_RES_OK || br == 0) return false;
+            ext->rd_len = br;
+            ext->rd_pos = 0;
+        }
+
+        uint32_t n = LV_MATH_MIN(len, ext->rd_len - ext->rd_pos);
+        memcpy(d, &ext->rd_buf[ext->rd_pos], n);
+        ext->rd_pos += n;
+        d += n;
+        len -= n;
+    }
+    return true;
+}
+
+/**
+ * Stop the animation, close the file and free the ring
+ */
+static void src_close(lv_obj_t * animimg)
+{
+    lv_animimg_ext_t * ext = lv_obj_get_ext_attr(animimg);
+
+    if(ext->task) lv_task_del(ext->task);
+    if(ext->opened) lv_fs_close(&ext->file);
+    if(ext->ring) lv_mem_free(ext->ring);
+    if(ext->rd_buf) lv_mem_free(ext->rd_buf);
+    if(ext->src) lv_mem_free(ext->src);
+    ext->task   = NULL;
+    ext->opened = 0;
+    ext->ring   = NULL;
+    ext->rd_buf = NULL;
+    ext->src    = NULL;
+}
+
+/**
+ * Find the areas of a frame which differ from the previous one. The changed rows are grouped into bands
+ * as wide as their changes, the bands over `LV_ANIMIMG_DAMAGE_MAX` are joined to the last.
+ * @return number of areas
+ */
+static uint32_t save_diff(const lv_img_dsc_t * prev, const lv_img_dsc_t * cur, uint8_t px_size, lv_area_t * areas)
+{
+    lv_coord_t w    = cur->header.w;
+    uint32_t stride = (uint32_t)w * px_size;
+    uint32_t cnt    = 0;
+    bool in_band    = false;
+
+    lv_coord_t y;
+    for(y = 0; y < cur->header.h; y++) {
+        lv_coord_t x1, x2;
+        if(row_diff(&prev->data[y * stride], &cur->data[y * stride], w, px_size, &x1, &x2) == false) {
+            in_band = false;
+            continue;
+        }
+
+        lv_area_t row;
+        lv_area_set(&row, x1, y, x2, y);
+        if(in_band || cnt == LV_ANIMIMG_DAMAGE_MAX) {
+            lv_area_join(&areas[cnt - 1], &areas[cnt - 1], &row);
+        } else {
+            areas[cnt++] = row;
+        }
+        in_band = true;
+    }
+
+    return cnt;
+}
+
+/**
+ * Find the first and the last differing pixel of two rows
+ * @return false: the rows are the same
+ */
+static bool row_diff(const uint8_t * a, const uint8_t * b, lv_coord_t w, uint8_t px_size, lv_coord_t * x1,
+                     lv_coord_t * x2)
+{
+    if(memcmp(a, b, (uint32_t)w * px_size) == 0) return false;
+
+    lv_coord_t x;
+    for(x = 0; memcmp(&a[x * px_size], &b[x * px_size], px_size) == 0; x++)
+        ;
+    *x1 = x;
+    for(x = w - 1; memcmp(&a[x * px_size], &b[x * px_size], px_size) == 0; x--)
+        ;
+    *x2 = x;
+    return true;
+}
+
+static void wr_bytes(animimg_writer_t * w, const void * data, uint32_t len)
+{
+    if(w->err) return;
+    uint32_t bw = 0;
+    if(lv_fs_write(&w->file, data, len, &bw) != LV_FS_RES_OK || bw != len) w->err = true;
+}
+
+static void wr_u16(animimg_writer_t * w, uint16_t v)
+{
+    uint8_t b[2] = {v & 0xFF, v >> 8};
+    wr_bytes(w, b, 2);
+}
+
+static void wr_u32(animimg_writer_t * w, uint32_t v)
+{
+    uint8_t b[4] = {v & 0xFF, (v >> 8) & 0xFF, (v >> 16) & 0xFF, v >> 24};
+    wr_bytes(w, b, 4);
+}
+
+static uint16_t rd_u16(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8);
+}
+
+static uint32_t rd_u32(const uint8_t * p)
+{
+    return p[0] | (p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * The pixels of the slot of a decoded frame
+ */
+static inline uint8_t * slot_px(const lv_animimg_ext_t * ext, uint32_t dec)
+{
+    return &ext->ring[(dec % LV_ANIMIMG_RING) * (uint32_t)ext->w * ext->h * ext->px_size];
+}
+
+#endif
@@ -0,0 +1,216 @@
+/**
+ * @file lv_animimg.h
+ *
+ */
+
+#ifndef LV_ANIMIMG_H
+#define LV_ANIMIMG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lv_conf.h"
+#else
+#include "../../../lv_conf.h"
+#endif
+
+#if LV_USE_ANIMIMG != 0
+
+#if LV_USE_FILESYSTEM == 0
+#error "lv_animimg: LV_USE_FILESYSTEM is required. Enable it in lv_conf.h (LV_USE_FILESYSTEM  1) "
+#endif
+
+#include "../lv_core/lv_obj.h"
+#include "../lv_misc/lv_fs.h"
+#include "../lv_misc/lv_task.h"
+#include "../lv_draw/lv_draw.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_ANIMIMG_DAMAGE_MAX 8 /*Changed areas kept per decoded frame, the further ones are joined to the last*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/*A decoded frame in the ring*/
+typedef struct
+{
+    lv_area_t damage[LV_ANIMIMG_DAMAGE_MAX]; /*Changed since the previous frame, relative to the image*/
+    uint32_t frame;                          /*Index of the frame in the file*/
+    uint16_t duration;                       /*[ms] to show it*/
+    uint8_t damage_cnt;
+    uint8_t all : 1;                         /*The whole image changed (the first frame)*/
+} lv_animimg_slot_t;
+
+/*Data of animated image*/
+typedef struct
+{
+    /*No inherited ext.*/ /*Ext. of ancestor*/
+    /*New data for this type */
+    char * src;                              /*Path of the file*/
+    lv_fs_file_t file;
+    lv_task_t * task;                        /*Shows the next frame when the current one's time is over*/
+    uint8_t * ring;                          /*`LV_ANIMIMG_RING` frames of the whole image*/
+    lv_animimg_slot_t slot[LV_ANIMIMG_RING];
+    uint8_t * rd_buf;                        /*`LV_ANIMIMG_READ_AHEAD` bytes read from the file*/
+    uint32_t rd_len;
+    uint32_t rd_pos;
+    uint32_t frame_cnt;
+    uint32_t next_frame;                     /*Index of the frame to decode next*/
+    uint32_t dec_cnt;                        /*Frames decoded since the start, frame `n` is in slot `n % LV_ANIMIMG_RING`*/
+    uint32_t shown;                          /*The decoded frame on the screen*/
+    uint32_t late_cnt;                       /*Frames which weren't decoded ahead when they were due*/
+    lv_coord_t w;
+    lv_coord_t h;
+    uint8_t cf;                              /*Color format from `lv_img_color_format_t`*/
+    uint8_t px_size;                         /*Bytes of a pixel*/
+    uint8_t loop : 1;                        /*Start again after the last frame*/
+    uint8_t playing : 1;
+    uint8_t opened : 1;
+} lv_animimg_ext_t;
+
+/*Styles*/
+enum {
+    LV_ANIMIMG_STYLE_MAIN,
+};
+typedef uint8_t lv_animimg_style_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Create an animated image object
+ * @param par pointer to an object, it will be the parent of the new animated image
+ * @param copy pointer to an animated image object, if not NULL then the new object will be copied from it
+ * @return pointer to the created animated image
+ */
+lv_obj_t * lv_animimg_create(lv_obj_t * par, const lv_obj_t * copy);
+
+/**
+ * Write frames into a file which an animated image can play. Only the areas changing from frame to frame
+ * are stored. The frames have to be of the same size and `LV_IMG_CF_TRUE_COLOR...` color format.
+ * @param path path of the new file, e.g. "S:/anim/boot.lvai"
+ * @param frames the frames in the order to show
+ * @param durations [ms] to show each frame
+ * @param cnt number of frames
+ * @return LV_RES_OK: written; LV_RES_INV: the frames can't be stored or the file couldn't be written
+ */
+lv_res_t lv_animimg_save(const char * path, const lv_img_dsc_t * const * frames, const uint16_t * durations,
+                         uint32_t cnt);
+
+/*=====================
+ * Setter functions
+ *====================*/
+
+/**
+ * Play the frames of a file written by `lv_animimg_save`. The frames are read and decoded while they are shown,
+ * only `LV_ANIMIMG_RING` decoded frames are kept in the memory. The object gets the size of the frames.
+ * @param animimg pointer to an animated image object
+ * @param path path of the file
+ * @return LV_RES_OK: playing; LV_RES_INV: the file can't be opened or isn't valid (nothing is shown)
+ */
+lv_res_t lv_animimg_set_src(lv_obj_t * animimg, const char * path);
+
+/**
+ * Start or stop the animation. A stopped animation shows its current frame.
+ * @param animimg pointer to an animated image object
+ * @param en true: play
+ */
+void lv_animimg_set_playing(lv_obj_t * animimg, bool en);
+
+/**
+ * Set whether the animation starts again after the last frame
+ * @param animimg pointer to an animated image object
+ * @param en true: loop (default); false: stop on the last frame
+ */
+void lv_animimg_set_loop(lv_obj_t * animimg, bool en);
+
+/**
+ * Set the style of an animated image
+ * @param animimg pointer to an animated image object
+ * @param type which style should be set (can be only `LV_ANIMIMG_STYLE_MAIN`)
+ * @param style pointer to a style
+ */
+static inline void lv_animimg_set_style(lv_obj_t * animimg, lv_animimg_style_t type, const lv_style_t * style)
+{
+    (void)type; /*Unused*/
+    lv_obj_set_style(animimg, style);
+}
+
+/*=====================
+ * Getter functions
+ *====================*/
+
+/**
+ * Get the path of the played file
+ * @param animimg pointer to an animated image object
+ * @return the path or NULL if nothing is played
+ */
+const char * lv_animimg_get_src(const lv_obj_t * animimg);
+
+/**
+ * Get the number of frames of the played file
+ * @param animimg pointer to an animated image object
+ * @return number of frames
+ */
+uint32_t lv_animimg_get_frame_cnt(const lv_obj_t * animimg);
+
+/**
+ * Get the index of the shown frame
+ * @param animimg pointer to an animated image object
+ * @return index of the frame in the file
+ */
+uint32_t lv_animimg_get_frame(const lv_obj_t * animimg);
+
+/**
+ * Get the number of frames which weren't decoded ahead when they were due (e.g. the file system was slow)
+ * @param animimg pointer to an animated image object
+ * @return number of late frames
+ */
+uint32_t lv_animimg_get_late_cnt(const lv_obj_t * animimg);
+
+/**
+ * Tell whether the animation is playing
+ * @param animimg pointer to an animated image object
+ * @return true: playing
+ */
+bool lv_animimg_get_playing(const lv_obj_t * animimg);
+
+/**
+ * Tell whether the animation starts again after the last frame
+ * @param animimg pointer to an animated image object
+ * @return true: loop
+ */
+bool lv_animimg_get_loop(const lv_obj_t * animimg);
+
+/**
+ * Get the style of an animated image
+ * @param animimg pointer to an animated image object
+ * @param type which style should be get (can be only `LV_ANIMIMG_STYLE_MAIN`)
+ * @return pointer to the style
+ */
+static inline const lv_style_t * lv_animimg_get_style(const lv_obj_t * animimg, lv_animimg_style_t type)
+{
+    (void)type; /*Unused*/
+    return lv_obj_get_style(animimg);
+}
+
+/**********************
+ *      MACROS
+ **********************/
+
+#endif /*LV_USE_ANIMIMG*/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_ANIMIMG_H*/
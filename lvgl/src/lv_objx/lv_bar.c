@@ -14,7 +14,9 @@
 #include "../lv_draw/lv_draw.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_misc/lv_anim.h"
+#include "../lv_misc/lv_math.h"
 #include <stdio.h>
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -29,6 +31,8 @@
  **********************/
 static bool lv_bar_design(lv_obj_t * bar, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_bar_signal(lv_obj_t * bar, lv_signal_t sign, void * param);
+static void lv_bar_indic_area_get(const lv_obj_t * bar, lv_area_t * indic_area);
+static lv_coord_t indic_radius_get(const lv_area_t * indic_area, lv_coord_t radius);
 
 #if LV_USE_ANIMATION
 static void lv_bar_anim(void * bar, lv_anim_value_t value);
@@ -143,8 +147,10 @@ void lv_bar_set_value(lv_obj_t * bar, int16_t value, lv_anim_enable_t anim)
     if(ext->cur_value == new_value) return;
 
     if(anim == LV_ANIM_OFF) {
+        lv_bar_value_area_t old;
+        lv_bar_get_value_area(bar, &old);
         ext->cur_value = new_value;
-        lv_obj_invalidate(bar);
+        lv_bar_invalidate_value(bar, &old);
     } else {
 #if LV_USE_ANIMATION
         /*No animation in progress -> simply set the values*/
@@ -154,8 +160,11 @@ void lv_bar_set_value(lv_obj_t * bar, int16_t value, lv_anim_enable_t anim)
         }
         /*Animation in progress. Start from the animation end value*/
         else {
+            lv_bar_value_area_t old;
+            lv_bar_get_value_area(bar, &old);
             ext->anim_start = ext->anim_end;
             ext->anim_end   = new_value;
+            lv_bar_invalidate_value(bar, &old);
         }
 
         lv_anim_t a;
@@ -248,10 +257,107 @@ void lv_bar_set_style(lv_obj_t * bar, lv_bar_style_t type, const lv_style_t * st
     }
 }
 
+/**
+ * Redraw only what a change of the value (or the animation state) moved on a bar.
+ * Nothing is redrawn if the indicator and the knob stay on the same pixels.
+ * @param bar pointer to a bar object
+ * @param old the value area got with `lv_bar_get_value_area` before the change
+ */
+void lv_bar_invalidate_value(lv_obj_t * bar, const lv_bar_value_area_t * old)
+{
+    lv_bar_value_area_t act;
+    lv_bar_get_value_area(bar, &act);
+
+    /*The indicator grows or shrinks at its edges: redraw the spans between the old and new edges*/
+    const lv_area_t * o = &old->indic;
+    const lv_area_t * n = &act.indic;
+    lv_coord_t r_old    = indic_radius_get(o, old->indic_radius);
+    lv_coord_t r_act    = indic_radius_get(n, act.indic_radius);
+    lv_coord_t pad      = LV_MATH_MAX(r_old, r_act) + LV_MATH_MAX(old->indic_shadow, act.indic_shadow) + 1;
+    lv_area_t span;
+    bool grad = (old->indic_grad || act.indic_grad) && (o->y1 != n->y1 || o->y2 != n->y2);
+    if(grad || r_old != r_act) {
+        /*A stretched gradient or the rounding of a short indicator changes everywhere*/
+        lv_area_join(&span, o, n);
+        span.x1 -= pad;
+        span.y1 -= pad;
+        span.x2 += pad;
+        span.y2 += pad;
+        lv_obj_invalidate_area(bar, &span);
+    } else if(o->y1 == n->y1 && o->y2 == n->y2) {
+        span.y1 = n->y1 - pad;
+        span.y2 = n->y2 + pad;
+        if(o->x1 != n->x1) {
+            span.x1 = LV_MATH_MIN(o->x1, n->x1) - pad;
+            span.x2 = LV_MATH_MAX(o->x1, n->x1) + pad;
+            lv_obj_invalidate_area(bar, &span);
+        }
+        if(o->x2 != n->x2) {
+            span.x1 = LV_MATH_MIN(o->x2, n->x2) - pad;
+            span.x2 = LV_MATH_MAX(o->x2, n->x2) + pad;
+            lv_obj_invalidate_area(bar, &span);
+        }
+    } else if(o->x1 == n->x1 && o->x2 == n->x2) {
+        span.x1 = n->x1 - pad;
+        span.x2 = n->x2 + pad;
+        if(o->y1 != n->y1) {
+            span.y1 = LV_MATH_MIN(o->y1, n->y1) - pad;
+            span.y2 = LV_MATH_MAX(o->y1, n->y1) + pad;
+            lv_obj_invalidate_area(bar, &span);
+        }
+        if(o->y2 != n->y2) {
+            span.y1 = LV_MATH_MIN(o->y2, n->y2) - pad;
+            span.y2 = LV_MATH_MAX(o->y2, n->y2) + pad;
+            lv_obj_invalidate_area(bar, &span);
+        }
+    } else {
+        lv_area_join(&span, o, n);
+        span.x1 -= pad;
+        span.y1 -= pad;
+        span.x2 += pad;
+        span.y2 += pad;
+        lv_obj_invalidate_area(bar, &span);
+    }
+
+    /*The knob is redrawn where it was and where it is*/
+    const lv_area_t * ko = &old->knob;
+    const lv_area_t * kn = &act.knob;
+    if(ko->x1 == kn->x1 && ko->y1 == kn->y1 && ko->x2 == kn->x2 && ko->y2 == kn->y2) return;
+
+    if(ko->x2 >= ko->x1) {
+        lv_area_copy(&span, ko);
+        span.x1 -= old->knob_pad;
+        span.y1 -= old->knob_pad;
+        span.x2 += old->knob_pad;
+        span.y2 += old->knob_pad;
+        lv_obj_invalidate_area(bar, &span);
+    }
+    if(kn->x2 >= kn->x1) {
+        lv_area_copy(&span, kn);
+        span.x1 -= act.knob_pad;
+        span.y1 -= act.knob_pad;
+        span.x2 += act.knob_pad;
+        span.y2 += act.knob_pad;
+        lv_obj_invalidate_area(bar, &span);
+    }
+}
+
 /*=====================
  * Getter functions
  *====================*/
 
+/**
+ * Get the parts of a bar which depend on its value, as they are drawn now
+ * @param bar pointer to a bar object
+ * @param area store the areas here
+ */
+void lv_bar_get_value_area(const lv_obj_t * bar, lv_bar_value_area_t * area)
+{
+    memset(area, 0, sizeof(lv_bar_value_area_t));
+    area->knob.x2 = -1;
+    bar->signal_cb((lv_obj_t *)bar, LV_SIGNAL_GET_VALUE_AREA, area);
+}
+
 /**
  * Get the value of a bar
  * @param bar pointer to a bar object
@@ -384,82 +490,7 @@ static bool lv_bar_design(lv_obj_t * bar, const lv_area_t * mask, lv_design_mode
         ) {
             const lv_style_t * style_indic = lv_bar_get_style(bar, LV_BAR_STYLE_INDIC);
             lv_area_t indic_area;
-            lv_area_copy(&indic_area, &bar->coords);
-            indic_area.x1 += style_indic->body.padding.left;
-            indic_area.x2 -= style_indic->body.padding.right;
-            indic_area.y1 += style_indic->body.padding.top;
-            indic_area.y2 -= style_indic->body.padding.bottom;
-
-            lv_coord_t w = lv_area_get_width(&indic_area);
-            lv_coord_t h = lv_area_get_height(&indic_area);
-
-            if(w >= h) {
-                /*Horizontal*/
-#if LV_USE_ANIMATION
-                if(ext->anim_state != LV_BAR_ANIM_STATE_INV) {
-                    /*Calculate the coordinates of anim. start and end*/
-                    lv_coord_t anim_start_x =
-                        (int32_t)((int32_t)w * (ext->anim_start - ext->min_value)) / (ext->max_value - ext->min_value);
-                    lv_coord_t anim_end_x =
-                        (int32_t)((int32_t)w * (ext->anim_end - ext->min_value)) / (ext->max_value - ext->min_value);
-
-                    /*Calculate the real position based on `anim_state` (between `anim_start` and
-                     * `anim_end`)*/
-                    indic_area.x2 =
-                        anim_start_x + (((anim_end_x - anim_start_x) * ext->anim_state) >> LV_BAR_ANIM_STATE_NORM);
-                } else
-#endif
-                {
-                    indic_area.x2 =
-                        (int32_t)((int32_t)w * (ext->cur_value - ext->min_value)) / (ext->max_value - ext->min_value);
-                }
-
-                indic_area.x2 = indic_area.x1 + indic_area.x2 - 1;
-                if(ext->sym && ext->min_value < 0 && ext->max_value > 0) {
-                    /*Calculate the coordinate of the zero point*/
-                    lv_coord_t zero;
-                    zero = indic_area.x1 + (-ext->min_value * w) / (ext->max_value - ext->min_value);
-                    if(indic_area.x2 > zero)
-                        indic_area.x1 = zero;
-                    else {
-                        indic_area.x1 = indic_area.x2;
-                        indic_area.x2 = zero;
-                    }
-                }
-            } else {
-#if LV_USE_ANIMATION
-                if(ext->anim_state != LV_BAR_ANIM_STATE_INV) {
-                    /*Calculate the coordinates of anim. start and end*/
-                    lv_coord_t anim_start_y =
-                        (int32_t)((int32_t)h * (ext->anim_start - ext->min_value)) / (ext->max_value - ext->min_value);
-                    lv_coord_t anim_end_y =
-                        (int32_t)((int32_t)h * (ext->anim_end - ext->min_value)) / (ext->max_value - ext->min_value);
-
-                    /*Calculate the real position based on `anim_state` (between `anim_start` and
-                     * `anim_end`)*/
-                    indic_area.y1 =
-                        anim_start_y + (((anim_end_y - anim_start_y) * ext->anim_state) >> LV_BAR_ANIM_STATE_NORM);
-                } else
-#endif
-                {
-                    indic_area.y1 =
-                        (int32_t)((int32_t)h * (ext->cur_value - ext->min_value)) / (ext->max_value - ext->min_value);
-                }
-
-                indic_area.y1 = indic_area.y2 - indic_area.y1 + 1;
-
-                if(ext->sym && ext->min_value < 0 && ext->max_value > 0) {
-                    /*Calculate the coordinate of the zero point*/
-                    lv_coord_t zero;
-                    zero = indic_area.y2 - (-ext->min_value * h) / (ext->max_value - ext->min_value);
-                    if(indic_area.y1 < zero)
-                        indic_area.y2 = zero;
-                    else {
-                        indic_area.y2 = indic_area.y1;
-                        indic_area.y1 = zero;
-                    }
-                }
-            }
+            lv_bar_indic_area_get(bar, &indic_area);
 
             /*Draw the indicator*/
             lv_draw_rect(&indic_area, mask, style_indic, opa_scale);
@@ -481,6 +512,109 @@ static bool lv_bar_design(lv_obj_t * bar, const lv_area_t * mask, lv_design_mode
     return true;
 }
 
+/**
+ * Get the area of the indicator as it's drawn with the current value or animation state
+ * @param bar pointer to a bar object
+ * @param indic_area store the area here
+ */
+static void lv_bar_indic_area_get(const lv_obj_t * bar, lv_area_t * indic_area)
+{
+    lv_bar_ext_t * ext             = lv_obj_get_ext_attr(bar);
+    const lv_style_t * style_indic = lv_bar_get_style(bar, LV_BAR_STYLE_INDIC);
+    lv_area_copy(indic_area, &bar->coords);
+    indic_area->x1 += style_indic->body.padding.left;
+    indic_area->x2 -= style_indic->body.padding.right;
+    indic_area->y1 += style_indic->body.padding.top;
+    indic_area->y2 -= style_indic->body.padding.bottom;
+
+    lv_coord_t w = lv_area_get_width(indic_area);
+    lv_coord_t h = lv_area_get_height(indic_area);
+
+    if(w >= h) {
+        /*Horizontal*/
+#if LV_USE_ANIMATION
+        if(ext->anim_state != LV_BAR_ANIM_STATE_INV) {
+            /*Calculate the coordinates of anim. start and end*/
+            lv_coord_t anim_start_x =
+                (int32_t)((int32_t)w * (ext->anim_start - ext->min_value)) / (ext->max_value - ext->min_value);
+            lv_coord_t anim_end_x =
+                (int32_t)((int32_t)w * (ext->anim_end - ext->min_value)) / (ext->max_value - ext->min_value);
+
+            /*Calculate the real position based on `anim_state` (between `anim_start` and
+             * `anim_end`)*/
+            indic_area->x2 =
+                anim_start_x + (((anim_end_x - anim_start_x) * ext->anim_state) >> LV_BAR_ANIM_STATE_NORM);
+        } else
+#endif
+        {
+            indic_area->x2 =
+                (int32_t)((int32_t)w * (ext->cur_value - ext->min_value)) / (ext->max_value - ext->min_value);
+        }
+
+        indic_area->x2 = indic_area->x1 + indic_area->x2 - 1;
+        if(ext->sym && ext->min_value < 0 && ext->max_value > 0) {
+            /*Calculate the coordinate of the zero point*/
+            lv_coord_t zero;
+            zero = indic_area->x1 + (-ext->min_value * w) / (ext->max_value - ext->min_value);
+            if(indic_area->x2 > zero)
+                indic_area->x1 = zero;
+            else {
+                indic_area->x1 = indic_area->x2;
+                indic_area->x2 = zero;
+            }
+        }
+    } else {
+#if LV_USE_ANIMATION
+        if(ext->anim_state != LV_BAR_ANIM_STATE_INV) {
+            /*Calculate the coordinates of anim. start and end*/
+            lv_coord_t anim_start_y =
+                (int32_t)((int32_t)h * (ext->anim_start - ext->min_value)) / (ext->max_value - ext->min_value);
+            lv_coord_t anim_end_y =
+                (int32_t)((int32_t)h * (ext->anim_end - ext->min_value)) / (ext->max_value - ext->min_value);
+
+            /*Calculate the real position based on `anim_state` (between `anim_start` and
+             * `anim_end`)*/
+            indic_area->y1 =
+                anim_start_y + (((anim_end_y - anim_start_y) * ext->anim_state) >> LV_BAR_ANIM_STATE_NORM);
+        } else
+#endif
+        {
+            indic_area->y1 =
+                (int32_t)((int32_t)h * (ext->cur_value - ext->min_value)) / (ext->max_value - ext->min_value);
+        }
+
+        indic_area->y1 = indic_area->y2 - indic_area->y1 + 1;
+
+        if(ext->sym && ext->min_value < 0 && ext->max_value > 0) {
+            /*Calculate the coordinate of the zero point*/
+            lv_coord_t zero;
+            zero = indic_area->y2 - (-ext->min_value * h) / (ext->max_value - ext->min_value);
+            if(indic_area->y1 < zero)
+                indic_area->y2 = zero;
+            else {
+                indic_area->y2 = indic_area->y1;
+                indic_area->y1 = zero;
+            }
+        }
+    }
+}
+
+/**
+ * The radius an indicator is drawn with: `lv_draw_rect` limits it to the half of the shorter side
+ * @param indic_area area of the indicator
+ * @param radius radius of the style
+ * @return the radius drawn
+ */
+static lv_coord_t indic_radius_get(const lv_area_t * indic_area, lv_coord_t radius)
+{
+    lv_coord_t w = lv_area_get_width(indic_area);
+    lv_coord_t h = lv_area_get_height(indic_area);
+    if(w < 0) w = 0;
+    if(h < 0) h = 0;
+    lv_coord_t short_side = LV_MATH_MIN(w, h);
+    return LV_MATH_MIN(radius, short_side / 2);
+}
+
 /**
  * Signal function of the bar
  * @param bar pointer to a bar object
@@ -499,6 +633,13 @@ static lv_res_t lv_bar_signal(lv_obj_t * bar, lv_signal_t sign, void * param)
     if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         const lv_style_t * style_indic = lv_bar_get_style(bar, LV_BAR_STYLE_INDIC);
         if(style_indic->body.shadow.width > bar->ext_draw_pad) bar->ext_draw_pad = style_indic->body.shadow.width;
+    } else if(sign == LV_SIGNAL_GET_VALUE_AREA) {
+        lv_bar_value_area_t * area     = param;
+        const lv_style_t * style_indic = lv_bar_get_style(bar, LV_BAR_STYLE_INDIC);
+        lv_bar_indic_area_get(bar, &area->indic);
+        area->indic_radius = style_indic->body.radius;
+        area->indic_shadow = style_indic->body.shadow.width;
+        area->indic_grad   = style_indic->body.main_color.full != style_indic->body.grad_color.full;
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
         uint8_t i;
@@ -515,15 +656,24 @@ static lv_res_t lv_bar_signal(lv_obj_t * bar, lv_signal_t sign, void * param)
 static void lv_bar_anim(void * bar, lv_anim_value_t value)
 {
     lv_bar_ext_t * ext = lv_obj_get_ext_attr(bar);
-    ext->anim_state    = value;
-    lv_obj_invalidate(bar);
+    if(ext->anim_state == value) return;
+
+    lv_bar_value_area_t old;
+    lv_bar_get_value_area(bar, &old);
+    ext->anim_state = value;
+    lv_bar_invalidate_value(bar, &old);
 }
 
 static void lv_bar_anim_ready(lv_anim_t * a)
 {
     lv_bar_ext_t * ext = lv_obj_get_ext_attr(a->var);
-    ext->anim_state    = LV_BAR_ANIM_STATE_INV;
-    lv_bar_set_value(a->var, ext->anim_end, false);
+
+    /*Jump to the end value and leave the animation together so the bar doesn't step back meanwhile*/
+    lv_bar_value_area_t old;
+    lv_bar_get_value_area(a->var, &old);
+    ext->anim_state = LV_BAR_ANIM_STATE_INV;
+    ext->cur_value  = ext->anim_end;
+    lv_bar_invalidate_value(a->var, &old);
 }
 #endif
 
@@ -73,6 +73,17 @@ enum {
 };
 typedef uint8_t lv_bar_style_t;
 
+/** Parameter of `LV_SIGNAL_GET_VALUE_AREA`: the parts of a bar drawn differently by another value*/
+typedef struct
+{
+    lv_area_t indic;           /**< The indicator. Only the span between its old and new edges is redrawn*/
+    lv_area_t knob;            /**< Moves with the value, redrawn at its old and new place. `x2 < x1`: no knob*/
+    lv_coord_t indic_radius;   /**< Radius of the indicator's style*/
+    lv_coord_t indic_shadow;   /**< Shadow width of the indicator's style*/
+    lv_coord_t knob_pad;       /**< Drawn around the knob (shadow)*/
+    uint8_t indic_grad : 1;    /**< The indicator has a (vertical) gradient, stretched by its height*/
+} lv_bar_value_area_t;
+
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
@@ -128,10 +139,25 @@ void lv_bar_set_anim_time(lv_obj_t * bar, uint16_t anim_time);
  */
 void lv_bar_set_style(lv_obj_t * bar, lv_bar_style_t type, const lv_style_t * style);
 
+/**
+ * Redraw only what a change of the value (or the animation state) moved on a bar.
+ * Nothing is redrawn if the indicator and the knob stay on the same pixels.
+ * @param bar pointer to a bar object
+ * @param old the value area got with `lv_bar_get_value_area` before the change
+ */
+void lv_bar_invalidate_value(lv_obj_t * bar, const lv_bar_value_area_t * old);
+
 /*=====================
  * Getter functions
  *====================*/
 
+/**
+ * Get the parts of a bar which depend on its value, as they are drawn now
+ * @param bar pointer to a bar object
+ * @param area store the areas here
+ */
+void lv_bar_get_value_area(const lv_obj_t * bar, lv_bar_value_area_t * area);
+
 /**
  * Get the value of a bar
  * @param bar pointer to a bar object
@@ -14,15 +14,63 @@
 #include "../lv_core/lv_refr.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_misc/lv_txt.h"
+#include "../lv_misc/lv_thread.h"
 
 /*********************
  *      DEFINES
  *********************/
+#define SHARED_LAYOUT 0
+#define SHARED_LABEL 1
 
 /**********************
  *      TYPEDEFS
  **********************/
 
+/*Data shared by the button matrices, kept in a list from the last used to the least recently used*/
+typedef struct _lv_btnm_shared_t
+{
+    struct _lv_btnm_shared_t * next;
+    uint32_t hash;
+    uint32_t size;    /*Bytes of the data*/
+    uint16_t ref_cnt; /*Buttons or button matrices using it*/
+    uint8_t type;     /*`SHARED_LAYOUT` or `SHARED_LABEL`*/
+} lv_btnm_shared_t;
+
+/*Size and style of a button matrix the areas of its buttons depend on*/
+typedef struct
+{
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_coord_t pad_top;
+    lv_coord_t pad_bottom;
+    lv_coord_t pad_left;
+    lv_coord_t pad_right;
+    lv_coord_t pad_inner;
+} layout_geo_t;
+
+/*The areas of the buttons for a map structure, size and style*/
+typedef struct _lv_btnm_layout_t
+{
+    lv_btnm_shared_t head;
+    layout_geo_t geo;
+    uint16_t btn_cnt;
+    uint16_t entry_cnt; /*Entries of the map without the closing ""*/
+    /*Followed by `btn_cnt` areas, then by a byte for every entry: 0 for "\n" or the width of the button*/
+} lv_btnm_layout_t;
+
+#if LV_BTNM_LABEL_MAP_MAX
+/*A one line text of a button drawn into an opacity map*/
+typedef struct _lv_btnm_label_t
+{
+    lv_btnm_shared_t head;
+    const lv_font_t * font;
+    lv_coord_t letter_space;
+    lv_area_t area; /*Of the map, relative to the left-top corner of the text*/
+    uint8_t * map;  /*Allocated by `lv_draw_label_strip_create`*/
+    /*Followed by the text*/
+} lv_btnm_label_t;
+#endif
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
@@ -36,8 +84,18 @@ static bool button_is_click_trig(lv_btnm_ctrl_t ctrl_bits);
 static bool button_is_tgl_enabled(lv_btnm_ctrl_t ctrl_bits);
 static bool button_get_tgl_state(lv_btnm_ctrl_t ctrl_bits);
 static uint16_t get_button_from_point(lv_obj_t * btnm, lv_point_t * p);
-static void allocate_btn_areas_and_controls(const lv_obj_t * btnm, const char ** map);
+static bool allocate_btn_areas_and_controls(const lv_obj_t * btnm, const char ** map);
+static lv_btnm_layout_t * layout_get(const lv_obj_t * btnm, const char ** map);
+static void layout_calc(const lv_obj_t * btnm, const char ** map, const layout_geo_t * geo, lv_area_t * areas);
+static uint8_t * layout_key(const lv_btnm_layout_t * layout);
+#if LV_BTNM_LABEL_MAP_MAX
+static lv_btnm_label_t * label_get(const char * txt, const lv_style_t * style);
+#endif
+static void shared_release(lv_btnm_shared_t * shared);
+static void shared_free_unused(void);
 static void invalidate_button_area(const lv_obj_t * btnm, uint16_t btn_idx);
+static void invalidate_buttons(const lv_obj_t * btnm, uint16_t btn_idx1, uint16_t btn_idx2);
+static void btn_cache_reset(const lv_obj_t * btnm);
 static bool maps_are_identical(const char ** map1, const char ** map2);
 static void make_one_button_toggled(lv_obj_t * btnm, uint16_t btn_idx);
 
@@ -49,6 +107,13 @@ static const char * lv_btnm_def_map[] = {"Btn1", "Btn2", "Btn3", "\n", "Btn4", "
 static lv_design_cb_t ancestor_design_f;
 static lv_signal_cb_t ancestor_signal;
 
+/*The layouts and the labels of every button matrix (of every context, guarded by `lv_thread_lock`)*/
+static lv_btnm_shared_t * shared_list;
+static uint32_t shared_unused_size; /*Bytes of the data no button matrix uses*/
+#if LV_BTNM_LABEL_MAP_MAX
+static lv_btnm_label_t label_none; /*A text which can't be drawn into a map*/
+#endif
+
 /**********************
  *      MACROS
  **********************/
@@ -85,6 +150,8 @@ lv_obj_t * lv_btnm_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->btn_id_act                       = LV_BTNM_BTN_NONE;
     ext->button_areas                     = NULL;
     ext->ctrl_bits                        = NULL;
+    ext->btn_cache                        = NULL;
+    ext->layout                           = NULL;
     ext->map_p                            = NULL;
     ext->recolor                          = 0;
     ext->one_toggle                       = 0;
@@ -101,6 +168,7 @@ lv_obj_t * lv_btnm_create(lv_obj_t * par, const lv_obj_t * copy)
 
     /*Init the new button matrix object*/
     if(copy == NULL) {
+        lv_obj_set_cord_signal(new_btnm, LV_OBJ_CORD_SIGNAL_SIZE);
         lv_obj_set_size(new_btnm, LV_DPI * 3, LV_DPI * 2);
         lv_btnm_set_map(new_btnm, lv_btnm_def_map);
 
@@ -156,97 +224,28 @@ void lv_btnm_set_map(const lv_obj_t * btnm, const char * map[])
      * set/allocation when map hasn't changed.
      */
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
-    if(!maps_are_identical(ext->map_p, map)) {
 
-        /*Analyze the map and create the required number of buttons*/
-        allocate_btn_areas_and_controls(btnm, map);
-    }
-    ext->map_p = map;
+    /*The texts might be changed in place or the width is different*/
+    btn_cache_reset(btnm);
 
-    /*Set size and positions of the buttons*/
-    const lv_style_t * style_bg = lv_btnm_get_style(btnm, LV_BTNM_STYLE_BG);
-    lv_coord_t max_w            = lv_obj_get_width(btnm) - style_bg->body.padding.left - style_bg->body.padding.right;
-    lv_coord_t max_h            = lv_obj_get_height(btnm) - style_bg->body.padding.top - style_bg->body.padding.bottom;
-    lv_coord_t act_y            = style_bg->body.padding.top;
+    if(!maps_are_identical(ext->map_p, map) || ext->btn_cache == NULL) {
 
-    /*Count the lines to calculate button height*/
-    uint8_t line_cnt = 1;
-    uint8_t li;
-    for(li = 0; strlen(map[li]) != 0; li++) {
-        if(strcmp(map[li], "\n") == 0) line_cnt++;
-    }
-
-    lv_coord_t btn_h = max_h - ((line_cnt - 1) * style_bg->body.padding.inner);
-    btn_h            = btn_h / line_cnt;
-    btn_h--; /*-1 because e.g. height = 100 means 101 pixels (0..100)*/
-
-    /* Count the units and the buttons in a line
-     * (A button can be 1,2,3... unit wide)*/
-    uint16_t unit_cnt;           /*Number of units in a row*/
-    uint16_t unit_act_cnt;       /*Number of units currently put in a row*/
-    uint16_t btn_cnt;            /*Number of buttons in a row*/
-    uint16_t i_tot          = 0; /*Act. index in the str map*/
-    uint16_t btn_i          = 0; /*Act. index of button areas*/
-    const char ** map_p_tmp = map;
-
-    /*Count the units and the buttons in a line*/
-    while(1) {
-        unit_cnt = 0;
-        btn_cnt  = 0;
-        /*Count the buttons in a line*/
-        while(strcmp(map_p_tmp[btn_cnt], "\n") != 0 && strlen(map_p_tmp[btn_cnt]) != 0) { /*Check a line*/
-            unit_cnt += get_button_width(ext->ctrl_bits[btn_i + btn_cnt]);
-            btn_cnt++;
-        }
-
-        /*Make sure the last row is at the bottom of 'btnm'*/
-        if(map_p_tmp[btn_cnt][0] == '\0') { /*Last row?*/
-            btn_h = max_h - act_y + style_bg->body.padding.bottom - 1;
-        }
-
-        /*Only deal with the non empty lines*/
-        if(btn_cnt != 0) {
-            /*Calculate the width of all units*/
-            lv_coord_t all_unit_w = max_w - ((btn_cnt - 1) * style_bg->body.padding.inner);
-
-            /*Set the button size and positions and set the texts*/
-            uint16_t i;
-            lv_coord_t act_x = style_bg->body.padding.left;
-            lv_coord_t act_unit_w;
-            unit_act_cnt = 0;
-            for(i = 0; i < btn_cnt; i++) {
-                /* one_unit_w = all_unit_w / unit_cnt
-                 * act_unit_w = one_unit_w * button_width
-                 * do this two operations but the multiply first to divide a greater number */
-                act_unit_w = (all_unit_w * get_button_width(ext->ctrl_bits[btn_i])) / unit_cnt;
-                act_unit_w--; /*-1 because e.g. width = 100 means 101 pixels (0..100)*/
-
-                /*Always recalculate act_x because of rounding errors */
-                act_x = (unit_act_cnt * all_unit_w) / unit_cnt + i * style_bg->body.padding.inner +
-                        style_bg->body.padding.left;
-
-                /* Set the button's area.
-                 * If inner padding is zero then use the prev. button x2 as x1 to avoid rounding
-                 * errors*/
-                if(style_bg->body.padding.inner == 0 && act_x != style_bg->body.padding.left) {
-                    lv_area_set(&ext->button_areas[btn_i], ext->button_areas[btn_i - 1].x2, act_y, act_x + act_unit_w,
-                                act_y + btn_h);
-                } else {
-                    lv_area_set(&ext->button_areas[btn_i], act_x, act_y, act_x + act_unit_w, act_y + btn_h);
-                }
-
-                unit_act_cnt += get_button_width(ext->ctrl_bits[btn_i]);
-
-                i_tot++;
-                btn_i++;
-            }
+        /*Analyze the map and create the required number of buttons*/
+        if(allocate_btn_areas_and_controls(btnm, map) == false) {
+            ext->map_p = map;
+            lv_obj_invalidate(btnm);
+            return;
         }
-        act_y += btn_h + style_bg->body.padding.inner;
-
-        if(strlen(map_p_tmp[btn_cnt]) == 0) break; /*Break on end of map*/
-        map_p_tmp = &map_p_tmp[btn_cnt + 1];       /*Set the map to the next line*/
-        i_tot++;                                   /*Skip the '\n'*/
     }
+    ext->map_p = map;
+
+    /*Set size and positions of the buttons. They are calculated for the first button matrix with
+     *this layout and shared by the others (e.g. by the keyboards).*/
+    lv_btnm_layout_t * layout = layout_get(btnm, map);
+    if(ext->layout) shared_release(&ext->layout->head);
+    ext->layout       = layout;
+    ext->button_areas = layout ? (lv_area_t *)(layout + 1) : NULL;
+    if(layout == NULL) ext->btn_cnt = 0;
 
     lv_obj_invalidate(btnm);
 }
@@ -285,8 +284,8 @@ void lv_btnm_set_pressed(const lv_obj_t * btnm, uint16_t id)
 
     if(id == ext->btn_id_pr) return;
 
+    invalidate_buttons(btnm, ext->btn_id_pr, id);
     ext->btn_id_pr = id;
-    lv_obj_invalidate(btnm);
 }
 
 /**
@@ -303,22 +302,27 @@ void lv_btnm_set_style(lv_obj_t * btnm, lv_btnm_style_t type, const lv_style_t *
         case LV_BTNM_STYLE_BG: lv_obj_set_style(btnm, style); break;
         case LV_BTNM_STYLE_BTN_REL:
             ext->styles_btn[LV_BTN_STATE_REL] = style;
+            btn_cache_reset(btnm);
             lv_obj_invalidate(btnm);
             break;
         case LV_BTNM_STYLE_BTN_PR:
             ext->styles_btn[LV_BTN_STATE_PR] = style;
+            btn_cache_reset(btnm);
             lv_obj_invalidate(btnm);
             break;
         case LV_BTNM_STYLE_BTN_TGL_REL:
             ext->styles_btn[LV_BTN_STATE_TGL_REL] = style;
+            btn_cache_reset(btnm);
             lv_obj_invalidate(btnm);
             break;
         case LV_BTNM_STYLE_BTN_TGL_PR:
             ext->styles_btn[LV_BTN_STATE_TGL_PR] = style;
+            btn_cache_reset(btnm);
             lv_obj_invalidate(btnm);
             break;
         case LV_BTNM_STYLE_BTN_INA:
             ext->styles_btn[LV_BTN_STATE_INA] = style;
+            btn_cache_reset(btnm);
             lv_obj_invalidate(btnm);
             break;
     }
@@ -334,6 +338,7 @@ void lv_btnm_set_recolor(const lv_obj_t * btnm, bool en)
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
 
     ext->recolor = en;
+    btn_cache_reset(btnm);
     lv_obj_invalidate(btnm);
 }
 
@@ -347,6 +352,7 @@ void lv_btnm_set_btn_ctrl(const lv_obj_t * btnm, uint16_t btn_id, lv_btnm_ctrl_t
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
 
     if(btn_id >= ext->btn_cnt) return;
+    if((ext->ctrl_bits[btn_id] & ctrl) == ctrl) return;
 
     ext->ctrl_bits[btn_id] |= ctrl;
     invalidate_button_area(btnm, btn_id);
@@ -362,6 +368,7 @@ void lv_btnm_clear_btn_ctrl(const lv_obj_t * btnm, uint16_t btn_id, lv_btnm_ctrl
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
 
     if(btn_id >= ext->btn_cnt) return;
+    if((ext->ctrl_bits[btn_id] & ctrl) == 0) return;
 
     ext->ctrl_bits[btn_id] &= (~ctrl);
     invalidate_button_area(btnm, btn_id);
@@ -619,18 +626,12 @@ static bool lv_btnm_design(lv_obj_t * btnm, const lv_area_t * mask, lv_design_mo
         lv_coord_t btn_h;
 
         uint16_t btn_i = 0;
-        uint16_t txt_i = 0;
         lv_style_t style_tmp;
         lv_txt_flag_t txt_flag = LV_TXT_FLAG_NONE;
 
         if(ext->recolor) txt_flag = LV_TXT_FLAG_RECOLOR;
 
-        for(btn_i = 0; btn_i < ext->btn_cnt; btn_i++, txt_i++) {
-            /*Search the next valid text in the map*/
-            while(strcmp(ext->map_p[txt_i], "\n") == 0) {
-                txt_i++;
-            }
-
+        for(btn_i = 0; btn_i < ext->btn_cnt; btn_i++) {
             /*Skip hidden buttons*/
             if(button_is_hidden(ext->ctrl_bits[btn_i])) continue;
 
@@ -658,6 +659,17 @@ static bool lv_btnm_design(lv_obj_t * btnm, const lv_area_t * mask, lv_design_mo
             else
                 btn_style = lv_btnm_get_style(btnm, LV_BTNM_STYLE_BTN_REL); /*Not possible option, just to be sure*/
 
+            /*Skip the buttons out of the mask (e.g. only a pressed button is redrawn)*/
+            lv_area_t area_ext;
+            lv_area_copy(&area_ext, &area_tmp);
+            if(btn_style->body.shadow.width > 0) {
+                area_ext.x1 -= btn_style->body.shadow.width;
+                area_ext.y1 -= btn_style->body.shadow.width;
+                area_ext.x2 += btn_style->body.shadow.width;
+                area_ext.y2 += btn_style->body.shadow.width;
+            }
+            if(lv_area_is_on(&area_ext, mask) == false) continue;
+
             lv_style_copy(&style_tmp, btn_style);
 
             /*Remove borders on the edges if `LV_BORDER_INTERNAL`*/
@@ -669,31 +681,64 @@ static bool lv_btnm_design(lv_obj_t * btnm, const lv_area_t * mask, lv_design_mo
                     style_tmp.body.border.part &= ~LV_BORDER_BOTTOM;
                 }
 
-                if(txt_i == 0) {
-                    style_tmp.body.border.part &= ~LV_BORDER_LEFT;
-                } else if(strcmp(ext->map_p[txt_i - 1], "\n") == 0) {
+                /*The first and last buttons of the rows*/
+                if(btn_i == 0 || ext->button_areas[btn_i - 1].y1 != ext->button_areas[btn_i].y1) {
                     style_tmp.body.border.part &= ~LV_BORDER_LEFT;
                 }
 
-                if(ext->map_p[txt_i + 1][0] == '\0' || strcmp(ext->map_p[txt_i + 1], "\n") == 0) {
+                if(btn_i == ext->btn_cnt - 1 || ext->button_areas[btn_i + 1].y1 != ext->button_areas[btn_i].y1) {
                     style_tmp.body.border.part &= ~LV_BORDER_RIGHT;
                 }
             }
             lv_draw_rect(&area_tmp, mask, &style_tmp, opa_scale);
 
-            /*Calculate the size of the text*/
+            /*Get the size of the text. It's calculated only if the font or the spaces are changed.
+             *Other drawing threads can draw the same button in an other band, so it's updated under the lock.*/
             if(btn_style->glass) btn_style = bg_style;
-            const lv_font_t * font = btn_style->text.font;
+            lv_btnm_btn_cache_t * cache = &ext->btn_cache[btn_i];
+            const char * txt            = ext->map_p[cache->txt_id];
             lv_point_t txt_size;
-            lv_txt_get_size(&txt_size, ext->map_p[txt_i], font, btn_style->text.letter_space,
-                            btn_style->text.line_space, lv_area_get_width(&area_btnm), txt_flag);
+            lv_thread_lock();
+            if(cache->txt_font != btn_style->text.font || cache->txt_letter_space != btn_style->text.letter_space ||
+               cache->txt_line_space != btn_style->text.line_space) {
+                lv_txt_get_size(&cache->txt_size, txt, btn_style->text.font, btn_style->text.letter_space,
+                                btn_style->text.line_space, lv_area_get_width(&area_btnm), txt_flag);
+                cache->txt_font         = btn_style->text.font;
+                cache->txt_letter_space = btn_style->text.letter_space;
+                cache->txt_line_space   = btn_style->text.line_space;
+            }
+            txt_size = cache->txt_size;
+
+#if LV_BTNM_LABEL_MAP_MAX
+            /*The released buttons' texts are drawn once into a map, shared with the same texts of the other buttons*/
+            if(cache->label == NULL && btn_i != ext->btn_id_pr && ext->recolor == 0) {
+                cache->label = label_get(txt, btn_style);
+            }
+            const lv_btnm_label_t * label = cache->label;
+#endif
+            lv_thread_unlock();
 
             area_tmp.x1 += (btn_w - txt_size.x) / 2;
             area_tmp.y1 += (btn_h - txt_size.y) / 2;
             area_tmp.x2 = area_tmp.x1 + txt_size.x;
             area_tmp.y2 = area_tmp.y1 + txt_size.y;
 
-            lv_draw_label(&area_tmp, mask, btn_style, opa_scale, ext->map_p[txt_i], txt_flag, NULL, -1, -1, NULL);
+#if LV_BTNM_LABEL_MAP_MAX
+            if(label != NULL && label != &label_none && label->font == btn_style->text.font &&
+               label->letter_space == btn_style->text.letter_space) {
+                lv_opa_t opa = opa_scale == LV_OPA_COVER ? btn_style->text.opa
+                                                         : (uint16_t)((uint16_t)btn_style->text.opa * opa_scale) >> 8;
+                lv_area_t map_area;
+                lv_area_copy(&map_area, &label->area);
+                map_area.x1 += area_tmp.x1;
+                map_area.x2 += area_tmp.x1;
+                map_area.y1 += area_tmp.y1;
+                map_area.y2 += area_tmp.y1;
+                lv_draw_opa_map(&map_area, mask, label->map, btn_style->text.color, opa);
+                continue;
+            }
+#endif
+            lv_draw_label(&area_tmp, mask, btn_style, opa_scale, txt, txt_flag, NULL, -1, -1, NULL, NULL);
         }
     }
     return true;
@@ -717,10 +762,20 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
     lv_point_t p;
     if(sign == LV_SIGNAL_CLEANUP) {
-        lv_mem_free(ext->button_areas);
-        lv_mem_free(ext->ctrl_bits);
-    } else if(sign == LV_SIGNAL_STYLE_CHG || sign == LV_SIGNAL_CORD_CHG) {
+        btn_cache_reset(btnm);
+        if(ext->layout) shared_release(&ext->layout->head);
+        ext->layout = NULL;
+
+        /*The cached data and the control bytes are in the same memory*/
+        lv_mem_free(ext->btn_cache);
+    } else if(sign == LV_SIGNAL_STYLE_CHG) {
         lv_btnm_set_map(btnm, ext->map_p);
+    } else if(sign == LV_SIGNAL_CORD_CHG) {
+        /*The buttons are relative to the matrix so only a new size needs a new layout*/
+        if(lv_obj_get_width(btnm) != lv_area_get_width(param) ||
+           lv_obj_get_height(btnm) != lv_area_get_height(param)) {
+            lv_btnm_set_map(btnm, ext->map_p);
+        }
     } else if(sign == LV_SIGNAL_PRESSED) {
         lv_indev_t * indev = lv_indev_get_act();
         if(lv_indev_get_type(indev) == LV_INDEV_TYPE_POINTER || lv_indev_get_type(indev) == LV_INDEV_TYPE_BUTTON) {
@@ -729,10 +784,9 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
             lv_indev_get_point(param, &p);
             btn_pr = get_button_from_point(btnm, &p);
 
-            invalidate_button_area(btnm, ext->btn_id_pr) /*Invalidate the old area*/;
+            invalidate_buttons(btnm, ext->btn_id_pr, btn_pr); /*Invalidate the old and the new area*/
             ext->btn_id_pr  = btn_pr;
             ext->btn_id_act = btn_pr;
-            invalidate_button_area(btnm, ext->btn_id_pr); /*Invalidate the new area*/
         }
         if(ext->btn_id_act != LV_BTNM_BTN_NONE) {
             if(button_is_click_trig(ext->ctrl_bits[ext->btn_id_act]) == false &&
@@ -805,7 +859,11 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
                 res        = lv_event_send(btnm, LV_EVENT_VALUE_CHANGED, &b);
             }
         }
-    } else if(sign == LV_SIGNAL_PRESS_LOST || sign == LV_SIGNAL_DEFOCUS) {
+    } else if(sign == LV_SIGNAL_PRESS_LOST) {
+        invalidate_button_area(btnm, ext->btn_id_pr);
+        ext->btn_id_pr  = LV_BTNM_BTN_NONE;
+        ext->btn_id_act = LV_BTNM_BTN_NONE;
+    } else if(sign == LV_SIGNAL_DEFOCUS) {
         ext->btn_id_pr  = LV_BTNM_BTN_NONE;
         ext->btn_id_act = LV_BTNM_BTN_NONE;
         lv_obj_invalidate(btnm);
@@ -836,7 +894,8 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
         ext->btn_id_act = ext->btn_id_pr;
         lv_obj_invalidate(btnm);
     } else if(sign == LV_SIGNAL_CONTROL) {
-        char c = *((char *)param);
+        char c              = *((char *)param);
+        uint16_t btn_id_old = ext->btn_id_pr;
         if(c == LV_KEY_RIGHT) {
             if(ext->btn_id_pr == LV_BTNM_BTN_NONE)
                 ext->btn_id_pr = 0;
@@ -844,12 +903,12 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
                 ext->btn_id_pr++;
             if(ext->btn_id_pr >= ext->btn_cnt - 1) ext->btn_id_pr = ext->btn_cnt - 1;
             ext->btn_id_act = ext->btn_id_pr;
-            lv_obj_invalidate(btnm);
+            invalidate_buttons(btnm, btn_id_old, ext->btn_id_pr);
         } else if(c == LV_KEY_LEFT) {
             if(ext->btn_id_pr == LV_BTNM_BTN_NONE) ext->btn_id_pr = 0;
             if(ext->btn_id_pr > 0) ext->btn_id_pr--;
             ext->btn_id_act = ext->btn_id_pr;
-            lv_obj_invalidate(btnm);
+            invalidate_buttons(btnm, btn_id_old, ext->btn_id_pr);
         } else if(c == LV_KEY_DOWN) {
             const lv_style_t * style = lv_btnm_get_style(btnm, LV_BTNM_STYLE_BG);
             /*Find the area below the the current*/
@@ -871,7 +930,7 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
                 if(area_below < ext->btn_cnt) ext->btn_id_pr = area_below;
             }
             ext->btn_id_act = ext->btn_id_pr;
-            lv_obj_invalidate(btnm);
+            invalidate_buttons(btnm, btn_id_old, ext->btn_id_pr);
         } else if(c == LV_KEY_UP) {
             const lv_style_t * style = lv_btnm_get_style(btnm, LV_BTNM_STYLE_BG);
             /*Find the area below the the current*/
@@ -892,7 +951,7 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
                 if(area_above >= 0) ext->btn_id_pr = area_above;
             }
             ext->btn_id_act = ext->btn_id_pr;
-            lv_obj_invalidate(btnm);
+            invalidate_buttons(btnm, btn_id_old, ext->btn_id_pr);
         }
     } else if(sign == LV_SIGNAL_GET_EDITABLE) {
         bool * editable = (bool *)param;
@@ -913,8 +972,9 @@ static lv_res_t lv_btnm_signal(lv_obj_t * btnm, lv_signal_t sign, void * param)
  * Create the required number of buttons and control bytes according to a map
  * @param btnm pointer to button matrix object
  * @param map_p pointer to a string array
+ * @return false: out of memory, the button matrix has no buttons
  */
-static void allocate_btn_areas_and_controls(const lv_obj_t * btnm, const char ** map)
+static bool allocate_btn_areas_and_controls(const lv_obj_t * btnm, const char ** map)
 {
     /*Count the buttons in the map*/
     uint16_t btn_cnt = 0;
@@ -928,24 +988,348 @@ static void allocate_btn_areas_and_controls(const lv_obj_t * btnm, const char **
 
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
 
-    if(ext->button_areas != NULL) {
-        lv_mem_free(ext->button_areas);
-        ext->button_areas = NULL;
-    }
-    if(ext->ctrl_bits != NULL) {
-        lv_mem_free(ext->ctrl_bits);
+    /* Allocate the cached data and the control bytes in one memory (in this order to keep the alignment).
+     * The areas are in the shared layout (see `layout_get`).
+     * `lv_mem_realloc` keeps the memory if the size doesn't change (e.g. when the keyboard changes its layout)
+     * or can grow/shrink it in place.*/
+    uint32_t size                   = (sizeof(lv_btnm_btn_cache_t) + sizeof(lv_btnm_ctrl_t)) * btn_cnt;
+    lv_btnm_btn_cache_t * btn_cache = lv_mem_realloc(ext->btn_cache, size);
+    lv_mem_assert(btn_cache);
+    if(btn_cache == NULL) {
+        /*The old buttons don't match the new map: show none*/
+        lv_mem_free(ext->btn_cache);
+        ext->btn_cache = NULL;
         ext->ctrl_bits = NULL;
+        ext->btn_cnt   = 0;
+        return false;
     }
 
-    ext->button_areas = lv_mem_alloc(sizeof(lv_area_t) * btn_cnt);
-    lv_mem_assert(ext->button_areas);
-    ext->ctrl_bits = lv_mem_alloc(sizeof(lv_btnm_ctrl_t) * btn_cnt);
-    lv_mem_assert(ext->ctrl_bits);
-    if(ext->button_areas == NULL || ext->ctrl_bits == NULL) btn_cnt = 0;
+    ext->btn_cache = btn_cache;
+    ext->ctrl_bits = (lv_btnm_ctrl_t *)&ext->btn_cache[btn_cnt];
 
     memset(ext->ctrl_bits, 0, sizeof(lv_btnm_ctrl_t) * btn_cnt);
 
+    /*Save where the texts of the buttons are to not search them in the map on every drawing*/
+    uint16_t btn_i = 0;
+    for(i = 0; btn_i < btn_cnt; i++) {
+        if(strcmp(map[i], "\n") == 0) continue;
+        ext->btn_cache[btn_i].txt_id   = i;
+        ext->btn_cache[btn_i].txt_font = NULL;
+#if LV_BTNM_LABEL_MAP_MAX
+        ext->btn_cache[btn_i].label = NULL;
+#endif
+        btn_i++;
+    }
+
     ext->btn_cnt = btn_cnt;
+    return true;
+}
+
+/**
+ * Get the areas of the buttons for the map, the size and the style of a button matrix.
+ * Calculate them only if no other button matrix has the same layout.
+ * @param btnm pointer to a button matrix object
+ * @param map the new map of the button matrix, its control bytes are already set
+ * @return the layout, release it with `shared_release`; NULL: out of memory
+ */
+static lv_btnm_layout_t * layout_get(const lv_obj_t * btnm, const char ** map)
+{
+    lv_btnm_ext_t * ext         = lv_obj_get_ext_attr(btnm);
+    const lv_style_t * style_bg = lv_btnm_get_style(btnm, LV_BTNM_STYLE_BG);
+
+    layout_geo_t geo;
+    memset(&geo, 0, sizeof(geo)); /*Compared as bytes*/
+    geo.w          = lv_obj_get_width(btnm);
+    geo.h          = lv_obj_get_height(btnm);
+    geo.pad_top    = style_bg->body.padding.top;
+    geo.pad_bottom = style_bg->body.padding.bottom;
+    geo.pad_left   = style_bg->body.padding.left;
+    geo.pad_right  = style_bg->body.padding.right;
+    geo.pad_inner  = style_bg->body.padding.inner;
+
+    /*Only the line breaks and the widths of the buttons matter from the map*/
+    uint32_t hash = 2166136261U;
+    const uint8_t * g = (const uint8_t *)&geo;
+    uint32_t i;
+    for(i = 0; i < sizeof(geo); i++) hash = (hash ^ g[i]) * 16777619U;
+    uint16_t entry_cnt;
+    uint16_t btn_i = 0;
+    for(entry_cnt = 0; map[entry_cnt][0] != '\0'; entry_cnt++) {
+        uint8_t k = strcmp(map[entry_cnt], "\n") == 0 ? 0 : get_button_width(ext->ctrl_bits[btn_i++]);
+        hash      = (hash ^ k) * 16777619U;
+    }
+
+    lv_thread_lock();
+    lv_btnm_shared_t ** prev_next = &shared_list;
+    lv_btnm_shared_t * shared;
+    for(shared = shared_list; shared != NULL; prev_next = &shared->next, shared = shared->next) {
+        if(shared->type != SHARED_LAYOUT || shared->hash != hash) continue;
+        lv_btnm_layout_t * layout = (lv_btnm_layout_t *)shared;
+        if(layout->entry_cnt != entry_cnt || layout->btn_cnt != ext->btn_cnt ||
+           memcmp(&layout->geo, &geo, sizeof(geo)) != 0) {
+            continue;
+        }
+
+        const uint8_t * key = layout_key(layout);
+        btn_i               = 0;
+        for(i = 0; i < entry_cnt; i++) {
+            uint8_t k = strcmp(map[i], "\n") == 0 ? 0 : get_button_width(ext->ctrl_bits[btn_i++]);
+            if(key[i] != k) break;
+        }
+        if(i != entry_cnt) continue;
+
+        /*Move it to the front*/
+        *prev_next   = shared->next;
+        shared->next = shared_list;
+        shared_list  = shared;
+        if(shared->ref_cnt == 0) shared_unused_size -= shared->size;
+        shared->ref_cnt++;
+        lv_thread_unlock();
+        return layout;
+    }
+    lv_thread_unlock();
+
+    uint32_t size             = sizeof(lv_btnm_layout_t) + sizeof(lv_area_t) * ext->btn_cnt + entry_cnt;
+    lv_btnm_layout_t * layout = lv_mem_alloc(size);
+    lv_mem_assert(layout);
+    if(layout == NULL) return NULL;
+
+    layout->head.hash    = hash;
+    layout->head.size    = size;
+    layout->head.ref_cnt = 1;
+    layout->head.type    = SHARED_LAYOUT;
+    layout->geo          = geo;
+    layout->btn_cnt      = ext->btn_cnt;
+    layout->entry_cnt    = entry_cnt;
+
+    uint8_t * key = layout_key(layout);
+    btn_i         = 0;
+    for(i = 0; i < entry_cnt; i++) {
+        key[i] = strcmp(map[i], "\n") == 0 ? 0 : get_button_width(ext->ctrl_bits[btn_i++]);
+    }
+
+    layout_calc(btnm, map, &geo, (lv_area_t *)(layout + 1));
+
+    lv_thread_lock();
+    layout->head.next = shared_list;
+    shared_list       = &layout->head;
+    lv_thread_unlock();
+
+    return layout;
+}
+
+/**
+ * Calculate the areas of the buttons
+ * @param btnm pointer to a button matrix object
+ * @param map the map of the button matrix
+ * @param geo the size and the paddings of the button matrix
+ * @param areas store the areas of the buttons here
+ */
+static void layout_calc(const lv_obj_t * btnm, const char ** map, const layout_geo_t * geo, lv_area_t * areas)
+{
+    lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
+    lv_coord_t max_w    = geo->w - geo->pad_left - geo->pad_right;
+    lv_coord_t max_h    = geo->h - geo->pad_top - geo->pad_bottom;
+    lv_coord_t act_y    = geo->pad_top;
+
+    /*Count the lines to calculate button height*/
+    uint8_t line_cnt = 1;
+    uint8_t li;
+    for(li = 0; strlen(map[li]) != 0; li++) {
+        if(strcmp(map[li], "\n") == 0) line_cnt++;
+    }
+
+    lv_coord_t btn_h = max_h - ((line_cnt - 1) * geo->pad_inner);
+    btn_h            = btn_h / line_cnt;
+    btn_h--; /*-1 because e.g. height = 100 means 101 pixels (0..100)*/
+
+    /* Count the units and the buttons in a line
+     * (A button can be 1,2,3... unit wide)*/
+    uint16_t unit_cnt;           /*Number of units in a row*/
+    uint16_t unit_act_cnt;       /*Number of units currently put in a row*/
+    uint16_t btn_cnt;            /*Number of buttons in a row*/
+    uint16_t btn_i          = 0; /*Act. index of button areas*/
+    const char ** map_p_tmp = map;
+
+    /*Count the units and the buttons in a line*/
+    while(1) {
+        unit_cnt = 0;
+        btn_cnt  = 0;
+        /*Count the buttons in a line*/
+        while(strcmp(map_p_tmp[btn_cnt], "\n") != 0 && strlen(map_p_tmp[btn_cnt]) != 0) { /*Check a line*/
+            unit_cnt += get_button_width(ext->ctrl_bits[btn_i + btn_cnt]);
+            btn_cnt++;
+        }
+
+        /*Make sure the last row is at the bottom of 'btnm'*/
+        if(map_p_tmp[btn_cnt][0] == '\0') { /*Last row?*/
+            btn_h = max_h - act_y + geo->pad_bottom - 1;
+        }
+
+        /*Only deal with the non empty lines*/
+        if(btn_cnt != 0) {
+            /*Calculate the width of all units*/
+            lv_coord_t all_unit_w = max_w - ((btn_cnt - 1) * geo->pad_inner);
+
+            /*Set the button size and positions and set the texts*/
+            uint16_t i;
+            lv_coord_t act_x = geo->pad_left;
+            lv_coord_t act_unit_w;
+            unit_act_cnt = 0;
+            for(i = 0; i < btn_cnt; i++) {
+                /* one_unit_w = all_unit_w / unit_cnt
+                 * act_unit_w = one_unit_w * button_width
+                 * do this two operations but the multiply first to divide a greater number */
+                act_unit_w = (all_unit_w * get_button_width(ext->ctrl_bits[btn_i])) / unit_cnt;
+                act_unit_w--; /*-1 because e.g. width = 100 means 101 pixels (0..100)*/
+
+                /*Always recalculate act_x because of rounding errors */
+                act_x = (unit_act_cnt * all_unit_w) / unit_cnt + i * geo->pad_inner +
+                        geo->pad_left;
+
+                /* Set the button's area.
+                 * If inner padding is zero then use the prev. button x2 as x1 to avoid rounding
+                 * errors*/
+                if(geo->pad_inner == 0 && act_x != geo->pad_left) {
+                    lv_area_set(&areas[btn_i], areas[btn_i - 1].x2, act_y, act_x + act_unit_w, act_y + btn_h);
+                } else {
+                    lv_area_set(&areas[btn_i], act_x, act_y, act_x + act_unit_w, act_y + btn_h);
+                }
+
+                unit_act_cnt += get_button_width(ext->ctrl_bits[btn_i]);
+
+                btn_i++;
+            }
+        }
+        act_y += btn_h + geo->pad_inner;
+
+        if(strlen(map_p_tmp[btn_cnt]) == 0) break; /*Break on end of map*/
+        map_p_tmp = &map_p_tmp[btn_cnt + 1];       /*Set the map to the next line*/
+    }
+}
+
+/**
+ * Get the widths of the entries of the map a layout was calculated for
+ * @param layout pointer to a layout
+ * @return `entry_cnt` bytes: 0 for a line break or the width of a button
+ */
+static uint8_t * layout_key(const lv_btnm_layout_t * layout)
+{
+    return (uint8_t *)((lv_area_t *)(layout + 1) + layout->btn_cnt);
+}
+
+#if LV_BTNM_LABEL_MAP_MAX
+/**
+ * Get the text of a button drawn into an opacity map. Draw it only if no other button has the same text and font.
+ * @param txt the text of the button
+ * @param style the style of the button's text
+ * @return the drawn text, release it with `shared_release`; `&label_none` if it can't be drawn into a map
+ */
+static lv_btnm_label_t * label_get(const char * txt, const lv_style_t * style)
+{
+    /*Only one line of one color can be copied*/
+    if(strpbrk(txt, "\n\r") != NULL || txt[0] == '\0') return &label_none;
+
+    uint32_t hash = ((uint32_t)(uintptr_t)style->text.font * 2654435761U) ^ (uint16_t)style->text.letter_space;
+    const uint8_t * c;
+    for(c = (const uint8_t *)txt; *c; c++) hash = (hash ^ *c) * 16777619U;
+
+    lv_thread_lock();
+    lv_btnm_shared_t ** prev_next = &shared_list;
+    lv_btnm_shared_t * shared;
+    for(shared = shared_list; shared != NULL; prev_next = &shared->next, shared = shared->next) {
+        if(shared->type != SHARED_LABEL || shared->hash != hash) continue;
+        lv_btnm_label_t * label = (lv_btnm_label_t *)shared;
+        if(label->font != style->text.font || label->letter_space != style->text.letter_space ||
+           strcmp((const char *)(label + 1), txt) != 0) {
+            continue;
+        }
+
+        /*Move it to the front*/
+        *prev_next   = shared->next;
+        shared->next = shared_list;
+        shared_list  = shared;
+        if(shared->ref_cnt == 0) shared_unused_size -= shared->size;
+        shared->ref_cnt++;
+        lv_thread_unlock();
+        return label;
+    }
+    lv_thread_unlock();
+
+    lv_area_t area;
+    uint8_t * map = lv_draw_label_strip_create(style, txt, LV_BTNM_LABEL_MAP_MAX, &area);
+    if(map == NULL) return &label_none;
+
+    uint32_t txt_len        = strlen(txt);
+    lv_btnm_label_t * label = lv_mem_alloc(sizeof(lv_btnm_label_t) + txt_len + 1);
+    if(label == NULL) {
+        lv_mem_free(map);
+        return &label_none;
+    }
+
+    label->head.hash    = hash;
+    label->head.size    = sizeof(lv_btnm_label_t) + txt_len + 1 + lv_area_get_size(&area);
+    label->head.ref_cnt = 1;
+    label->head.type    = SHARED_LABEL;
+    label->font         = style->text.font;
+    label->letter_space = style->text.letter_space;
+    label->map          = map;
+    lv_area_copy(&label->area, &area);
+    memcpy(label + 1, txt, txt_len + 1);
+
+    lv_thread_lock();
+    label->head.next = shared_list;
+    shared_list      = &label->head;
+    lv_thread_unlock();
+
+    return label;
+}
+#endif
+
+/**
+ * Stop using a layout or a label. It's kept for the next button matrices while
+ * the unused ones are not larger than `LV_BTNM_SHARE_KEEP` bytes.
+ * @param shared pointer to a layout or a label
+ */
+static void shared_release(lv_btnm_shared_t * shared)
+{
+#if LV_BTNM_LABEL_MAP_MAX
+    if(shared == &label_none.head) return;
+#endif
+
+    lv_thread_lock();
+    shared->ref_cnt--;
+    if(shared->ref_cnt == 0) {
+        shared_unused_size += shared->size;
+        shared_free_unused();
+    }
+    lv_thread_unlock();
+}
+
+/**
+ * Free the least recently used layouts and labels nothing uses until they fit into `LV_BTNM_SHARE_KEEP` bytes.
+ * Call it with the library lock taken.
+ */
+static void shared_free_unused(void)
+{
+    while(shared_unused_size > LV_BTNM_SHARE_KEEP) {
+        /*Find the last unused one*/
+        lv_btnm_shared_t ** prev_next = &shared_list;
+        lv_btnm_shared_t ** last_next = NULL;
+        lv_btnm_shared_t * shared;
+        for(shared = shared_list; shared != NULL; prev_next = &shared->next, shared = shared->next) {
+            if(shared->ref_cnt == 0) last_next = prev_next;
+        }
+        if(last_next == NULL) break;
+
+        shared     = *last_next;
+        *last_next = shared->next;
+        shared_unused_size -= shared->size;
+#if LV_BTNM_LABEL_MAP_MAX
+        if(shared->type == SHARED_LABEL) lv_mem_free(((lv_btnm_label_t *)shared)->map);
+#endif
+        lv_mem_free(shared);
+    }
 }
 
 /**
@@ -998,25 +1382,42 @@ static bool button_get_tgl_state(lv_btnm_ctrl_t ctrl_bits)
 static uint16_t get_button_from_point(lv_obj_t * btnm, lv_point_t * p)
 {
     lv_area_t btnm_cords;
-    lv_area_t btn_area;
     lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
-    uint16_t i;
     lv_obj_get_coords(btnm, &btnm_cords);
 
-    for(i = 0; i < ext->btn_cnt; i++) {
-        lv_area_copy(&btn_area, &ext->button_areas[i]);
-        btn_area.x1 += btnm_cords.x1;
-        btn_area.y1 += btnm_cords.y1;
-        btn_area.x2 += btnm_cords.x1;
-        btn_area.y2 += btnm_cords.y1;
-        if(lv_area_is_point_on(&btn_area, p) != false) {
-            break;
-        }
+    /*The buttons are in rows from top to bottom and from left to right in a row*/
+    lv_coord_t x = p->x - btnm_cords.x1;
+    lv_coord_t y = p->y - btnm_cords.y1;
+
+    /*Find the first button which is not above the point. It's in the row of the point if any.*/
+    uint16_t first = 0;
+    uint16_t last  = ext->btn_cnt;
+    while(first < last) {
+        uint16_t mid = first + (last - first) / 2;
+        if(ext->button_areas[mid].y2 < y) first = mid + 1;
+        else last = mid;
+    }
+    if(first == ext->btn_cnt || ext->button_areas[first].y1 > y) return LV_BTNM_BTN_NONE;
+
+    /*Find the end of the row*/
+    lv_coord_t row_y1 = ext->button_areas[first].y1;
+    uint16_t row_end  = ext->btn_cnt;
+    last              = first;
+    while(last < row_end) {
+        uint16_t mid = last + (row_end - last) / 2;
+        if(ext->button_areas[mid].y1 == row_y1) last = mid + 1;
+        else row_end = mid;
     }
 
-    if(i == ext->btn_cnt) i = LV_BTNM_BTN_NONE;
+    /*Find the first button in the row which is not left to the point*/
+    while(first < last) {
+        uint16_t mid = first + (last - first) / 2;
+        if(ext->button_areas[mid].x2 < x) first = mid + 1;
+        else last = mid;
+    }
+    if(first == row_end || ext->button_areas[first].x1 > x) return LV_BTNM_BTN_NONE;
 
-    return i;
+    return first;
 }
 
 static void invalidate_button_area(const lv_obj_t * btnm, uint16_t btn_idx)
@@ -1036,7 +1437,47 @@ static void invalidate_button_area(const lv_obj_t * btnm, uint16_t btn_idx)
     btn_area.x2 += btnm_area.x1;
     btn_area.y2 += btnm_area.y1;
 
-    lv_inv_area(lv_obj_get_disp(btnm), &btn_area);
+    /*The shadow of the button can be out of its area (e.g. only in pressed state)*/
+    lv_coord_t shadow_w = 0;
+    uint8_t i;
+    for(i = 0; i < _LV_BTN_STATE_NUM; i++) {
+        if(ext->styles_btn[i]->body.shadow.width > shadow_w) shadow_w = ext->styles_btn[i]->body.shadow.width;
+    }
+    btn_area.x1 -= shadow_w;
+    btn_area.y1 -= shadow_w;
+    btn_area.x2 += shadow_w;
+    btn_area.y2 += shadow_w;
+
+    lv_inv_area_by(lv_obj_get_disp(btnm), &btn_area, btnm);
+}
+
+/**
+ * Invalidate the areas of two buttons, e.g. the previously and the newly pressed
+ * @param btnm pointer to a button matrix object
+ * @param btn_idx1 index of a button or LV_BTNM_BTN_NONE
+ * @param btn_idx2 index of an other button or LV_BTNM_BTN_NONE
+ */
+static void invalidate_buttons(const lv_obj_t * btnm, uint16_t btn_idx1, uint16_t btn_idx2)
+{
+    invalidate_button_area(btnm, btn_idx1);
+    if(btn_idx2 != btn_idx1) invalidate_button_area(btnm, btn_idx2);
+}
+
+/**
+ * Calculate the sizes of the texts again on the next drawing
+ * @param btnm pointer to a button matrix object
+ */
+static void btn_cache_reset(const lv_obj_t * btnm)
+{
+    lv_btnm_ext_t * ext = lv_obj_get_ext_attr(btnm);
+    uint16_t i;
+    for(i = 0; i < ext->btn_cnt; i++) {
+        ext->btn_cache[i].txt_font = NULL;
+#if LV_BTNM_LABEL_MAP_MAX
+        if(ext->btn_cache[i].label) shared_release(&ext->btn_cache[i].label->head);
+        ext->btn_cache[i].label = NULL;
+#endif
+    }
 }
 
 /**
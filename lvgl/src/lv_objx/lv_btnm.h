@@ -46,14 +46,29 @@ enum {
 };
 typedef uint16_t lv_btnm_ctrl_t;
 
+/*Data of a button calculated once instead of on every drawing*/
+typedef struct
+{
+    const lv_font_t * txt_font;  /*Font of `txt_size` or NULL if it's not calculated yet*/
+    lv_point_t txt_size;         /*Size of the button's text*/
+    lv_coord_t txt_letter_space; /*Letter and line space of `txt_size`*/
+    lv_coord_t txt_line_space;
+    uint16_t txt_id;             /*Index of the button's text in the map*/
+#if LV_BTNM_LABEL_MAP_MAX
+    struct _lv_btnm_label_t * label; /*The text drawn into a map (shared), NULL if not drawn yet*/
+#endif
+} lv_btnm_btn_cache_t;
+
 /*Data of button matrix*/
 typedef struct
 {
     /*No inherited ext.*/ /*Ext. of ancestor*/
     /*New data for this type */
     const char ** map_p;                              /*Pointer to the current map*/
-    lv_area_t * button_areas;                         /*Array of areas of buttons*/
+    lv_area_t * button_areas;                         /*Array of areas of buttons (in `layout`)*/
+    struct _lv_btnm_layout_t * layout;                /*The areas shared with the same button matrices*/
     lv_btnm_ctrl_t * ctrl_bits;                       /*Array of control bytes*/
+    lv_btnm_btn_cache_t * btn_cache;                  /*Cached data of the buttons, then the ctrl. bytes*/
     const lv_style_t * styles_btn[_LV_BTN_STATE_NUM]; /*Styles of buttons in each state*/
     uint16_t btn_cnt;                                 /*Number of button in 'map_p'(Handled by the library)*/
     uint16_t btn_id_pr;                               /*Index of the currently pressed button or LV_BTNM_BTN_NONE*/
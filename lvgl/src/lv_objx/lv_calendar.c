@@ -12,6 +12,7 @@
 #include "../lv_draw/lv_draw.h"
 #include "../lv_hal/lv_hal_indev.h"
 #include "../lv_misc/lv_utils.h"
+#include "../lv_misc/lv_math.h"
 #include "../lv_core/lv_indev.h"
 #include "../lv_themes/lv_theme.h"
 #include <string.h>
@@ -23,12 +24,14 @@
 /**********************
  *      TYPEDEFS
  **********************/
+/*Flags of `day_states`*/
 enum {
-    DAY_DRAW_PREV_MONTH,
-    DAY_DRAW_ACT_MONTH,
-    DAY_DRAW_NEXT_MONTH,
+    DAY_STATE_PREV_MONTH  = 0x01, /*The day is in the previous month*/
+    DAY_STATE_NEXT_MONTH  = 0x02, /*The day is in the next month*/
+    DAY_STATE_HIGHLIGHTED = 0x04,
+    DAY_STATE_TODAY       = 0x08,
+    DAY_STATE_WEEK        = 0x10, /*The day is in the week of today (in the week box)*/
 };
-typedef uint8_t day_draw_state_t;
 
 /**********************
  *  STATIC PROTOTYPES
@@ -41,6 +44,12 @@ static lv_coord_t get_day_names_height(lv_obj_t * calendar);
 static void draw_header(lv_obj_t * calendar, const lv_area_t * mask);
 static void draw_day_names(lv_obj_t * calendar, const lv_area_t * mask);
 static void draw_days(lv_obj_t * calendar, const lv_area_t * mask);
+static void calc_days(lv_obj_t * calendar, uint8_t * day_nums, uint8_t * day_states);
+static void refr_days(lv_obj_t * calendar);
+static void get_day_area(lv_obj_t * calendar, uint8_t day_id, lv_area_t * area);
+static void get_week_box_area(lv_obj_t * calendar, uint8_t week, lv_area_t * area);
+static void invalidate_header(lv_obj_t * calendar);
+static void invalidate_day(lv_obj_t * calendar, uint8_t day_id);
 static uint8_t get_day_of_week(uint32_t year, uint32_t month, uint32_t day);
 static bool is_highlighted(lv_obj_t * calendar, int32_t year, int32_t month, int32_t day);
 static const char * get_day_name(lv_obj_t * calendar, uint8_t day);
@@ -57,6 +66,11 @@ static const char * day_name[7]    = {"Su", "Mo", "Tu", "We", "Th", "Fr", "Sa"};
 static const char * month_name[12] = {"January", "February", "March",     "April",   "May",      "June",
                                       "July",    "August",   "September", "October", "November", "December"};
 
+/*The numbers of the days to not convert them on every draw*/
+static const char * day_num_txt[32] = {"",   "1",  "2",  "3",  "4",  "5",  "6",  "7",  "8",  "9",  "10",
+                                       "11", "12", "13", "14", "15", "16", "17", "18", "19", "20", "21",
+                                       "22", "23", "24", "25", "26", "27", "28", "29", "30", "31"};
+
 /**********************
  *      MACROS
  **********************/
@@ -100,6 +114,8 @@ lv_obj_t * lv_calendar_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->pressed_date.month = 0;
     ext->pressed_date.day   = 0;
 
+    ext->btn_pressing = 0;
+
     ext->highlighted_dates      = NULL;
     ext->highlighted_dates_num  = 0;
     ext->day_names              = NULL;
@@ -112,6 +128,8 @@ lv_obj_t * lv_calendar_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->style_today_box        = &lv_style_pretty_color;
     ext->style_day_names        = &lv_style_pretty;
 
+    calc_days(new_calendar, ext->day_nums, ext->day_states);
+
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_calendar, lv_calendar_signal);
     lv_obj_set_design_cb(new_calendar, lv_calendar_design);
@@ -166,6 +184,9 @@ lv_obj_t * lv_calendar_create(lv_obj_t * par, const lv_obj_t * copy)
         ext->style_week_box         = copy_ext->style_week_box;
         ext->style_today_box        = copy_ext->style_today_box;
         ext->style_day_names        = copy_ext->style_day_names;
+
+        calc_days(new_calendar, ext->day_nums, ext->day_states);
+
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_calendar);
     }
@@ -200,7 +221,7 @@ void lv_calendar_set_today_date(lv_obj_t * calendar, lv_calendar_date_t * today)
     ext->today.month        = today->month;
     ext->today.day          = today->day;
 
-    lv_obj_invalidate(calendar);
+    refr_days(calendar);
 }
 
 /**
@@ -212,18 +233,23 @@ void lv_calendar_set_today_date(lv_obj_t * calendar, lv_calendar_date_t * today)
 void lv_calendar_set_showed_date(lv_obj_t * calendar, lv_calendar_date_t * showed)
 {
     lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
+    bool month_chg = ext->showed_date.year != showed->year || ext->showed_date.month != showed->month;
     ext->showed_date.year   = showed->year;
     ext->showed_date.month  = showed->month;
     ext->showed_date.day    = showed->day;
 
-    lv_obj_invalidate(calendar);
+    /*The day is not shown*/
+    if(month_chg) {
+        invalidate_header(calendar);
+        refr_days(calendar);
+    }
 }
 
 /**
  * Set the the highlighted dates
  * @param calendar pointer to a calendar object
  * @param highlighted pointer to an `lv_calendar_date_t` array containing the dates. ONLY A POINTER
- * WILL BE SAVED! CAN'T BE LOCAL ARRAY.
+ * WILL BE SAVED! CAN'T BE LOCAL ARRAY. Call this function again after changing the array.
  * @param date_num number of dates in the array
  */
 void lv_calendar_set_highlighted_dates(lv_obj_t * calendar, lv_calendar_date_t * highlighted, uint16_t date_num)
@@ -232,7 +258,7 @@ void lv_calendar_set_highlighted_dates(lv_obj_t * calendar, lv_calendar_date_t *
     ext->highlighted_dates     = highlighted;
     ext->highlighted_dates_num = date_num;
 
-    lv_obj_invalidate(calendar);
+    refr_days(calendar);
 }
 
 /**
@@ -260,7 +286,7 @@ void lv_calendar_set_month_names(lv_obj_t * calendar, const char ** day_names)
 {
     lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
     ext->month_names        = day_names;
-    lv_obj_invalidate(calendar);
+    invalidate_header(calendar);
 }
 
 /**
@@ -469,10 +495,10 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
         /*If the header is pressed mark an arrow as pressed*/
         if(lv_area_is_point_on(&header_area, &p)) {
             if(p.x < header_area.x1 + lv_area_get_width(&header_area) / 2) {
-                if(ext->btn_pressing != -1) lv_obj_invalidate(calendar);
+                if(ext->btn_pressing != -1) invalidate_header(calendar);
                 ext->btn_pressing = -1;
             } else {
-                if(ext->btn_pressing != 1) lv_obj_invalidate(calendar);
+                if(ext->btn_pressing != 1) invalidate_header(calendar);
                 ext->btn_pressing = 1;
             }
 
@@ -482,12 +508,12 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
         }
         /*If a day is pressed save it*/
         else if(calculate_touched_day(calendar, &p)) {
-            if(ext->btn_pressing != 0) lv_obj_invalidate(calendar);
+            if(ext->btn_pressing != 0) invalidate_header(calendar);
             ext->btn_pressing = 0;
         }
         /*ELse set a deafault state*/
         else {
-            if(ext->btn_pressing != 0) lv_obj_invalidate(calendar);
+            if(ext->btn_pressing != 0) invalidate_header(calendar);
             ext->btn_pressing       = 0;
             ext->pressed_date.year  = 0;
             ext->pressed_date.month = 0;
@@ -495,8 +521,8 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
         }
     } else if(sign == LV_SIGNAL_PRESS_LOST) {
         lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
-        ext->btn_pressing       = 0;
-        lv_obj_invalidate(calendar);
+        if(ext->btn_pressing != 0) invalidate_header(calendar);
+        ext->btn_pressing = 0;
 
     } else if(sign == LV_SIGNAL_RELEASED) {
         lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
@@ -519,8 +545,12 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
             if(res != LV_RES_OK) return res;
         }
 
+        /*A new month is shown and the arrow is released*/
+        if(ext->btn_pressing != 0) {
+            invalidate_header(calendar);
+            refr_days(calendar);
+        }
         ext->btn_pressing = 0;
-        lv_obj_invalidate(calendar);
     } else if(sign == LV_SIGNAL_CONTROL) {
         uint8_t c               = *((uint8_t *)param);
         lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
@@ -531,7 +561,8 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
             } else {
                 ext->showed_date.month++;
             }
-            lv_obj_invalidate(calendar);
+            invalidate_header(calendar);
+            refr_days(calendar);
         } else if(c == LV_KEY_LEFT || c == LV_KEY_DOWN) {
             if(ext->showed_date.month <= 1) {
                 ext->showed_date.month = 12;
@@ -539,7 +570,8 @@ static lv_res_t lv_calendar_signal(lv_obj_t * calendar, lv_signal_t sign, void *
             } else {
                 ext->showed_date.month--;
             }
-            lv_obj_invalidate(calendar);
+            invalidate_header(calendar);
+            refr_days(calendar);
         }
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
@@ -584,22 +616,17 @@ static bool calculate_touched_day(lv_obj_t * calendar, const lv_point_t * touche
         uint8_t i_pos           = 0;
         i_pos                   = (y_pos * 7) + x_pos;
         lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
-        if(i_pos < get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1)) {
+        if(ext->day_states[i_pos] & DAY_STATE_PREV_MONTH) {
             ext->pressed_date.year  = ext->showed_date.year - (ext->showed_date.month == 1 ? 1 : 0);
             ext->pressed_date.month = ext->showed_date.month == 1 ? 12 : (ext->showed_date.month - 1);
-            ext->pressed_date.day   = get_month_length(ext->pressed_date.year, ext->pressed_date.month) -
-                                    get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1) + 1 + i_pos;
-        } else if(i_pos < (get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1) +
-                           get_month_length(ext->showed_date.year, ext->showed_date.month))) {
-            ext->pressed_date.year  = ext->showed_date.year;
-            ext->pressed_date.month = ext->showed_date.month;
-            ext->pressed_date.day   = i_pos + 1 - get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1);
-        } else if(i_pos < 42) {
+        } else if(ext->day_states[i_pos] & DAY_STATE_NEXT_MONTH) {
             ext->pressed_date.year  = ext->showed_date.year + (ext->showed_date.month == 12 ? 1 : 0);
             ext->pressed_date.month = ext->showed_date.month == 12 ? 1 : (ext->showed_date.month + 1);
-            ext->pressed_date.day   = i_pos + 1 - get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1) -
-                                    get_month_length(ext->showed_date.year, ext->showed_date.month);
+        } else {
+            ext->pressed_date.year  = ext->showed_date.year;
+            ext->pressed_date.month = ext->showed_date.month;
         }
+        ext->pressed_date.day = ext->day_nums[i_pos];
         return true;
     } else {
         return false;
@@ -648,6 +675,8 @@ static void draw_header(lv_obj_t * calendar, const lv_area_t * mask)
     header_area.y1 = calendar->coords.y1;
     header_area.y2 = calendar->coords.y1 + get_header_height(calendar);
 
+    if(lv_area_is_on(&header_area, mask) == false) return;
+
     lv_draw_rect(&header_area, mask, ext->style_header, opa_scale);
 
     /*Add the year + month name*/
@@ -657,19 +686,22 @@ static void draw_header(lv_obj_t * calendar, const lv_area_t * mask)
     txt_buf[5] = '\0';
     strcpy(&txt_buf[5], get_month_name(calendar, ext->showed_date.month));
     header_area.y1 += ext->style_header->body.padding.top;
-    lv_draw_label(&header_area, mask, ext->style_header, opa_scale, txt_buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL);
+    lv_draw_label(&header_area, mask, ext->style_header, opa_scale, txt_buf, LV_TXT_FLAG_CENTER, NULL,
+                  -1, -1, NULL, NULL);
 
     /*Add the left arrow*/
     const lv_style_t * arrow_style = ext->btn_pressing < 0 ? ext->style_header_pr : ext->style_header;
     header_area.x1 += ext->style_header->body.padding.left;
-    lv_draw_label(&header_area, mask, arrow_style, opa_scale, LV_SYMBOL_LEFT, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+    lv_draw_label(&header_area, mask, arrow_style, opa_scale, LV_SYMBOL_LEFT, LV_TXT_FLAG_NONE, NULL,
+                  -1, -1, NULL, NULL);
 
     /*Add the right arrow*/
     arrow_style    = ext->btn_pressing > 0 ? ext->style_header_pr : ext->style_header;
     header_area.x1 = header_area.x2 - ext->style_header->body.padding.right -
                      lv_txt_get_width(LV_SYMBOL_RIGHT, strlen(LV_SYMBOL_RIGHT), arrow_style->text.font,
                                       arrow_style->text.line_space, LV_TXT_FLAG_NONE);
-    lv_draw_label(&header_area, mask, arrow_style, opa_scale, LV_SYMBOL_RIGHT, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+    lv_draw_label(&header_area, mask, arrow_style, opa_scale, LV_SYMBOL_RIGHT, LV_TXT_FLAG_NONE, NULL,
+                  -1, -1, NULL, NULL);
 }
 
 /**
@@ -689,12 +721,17 @@ static void draw_day_names(lv_obj_t * calendar, const lv_area_t * mask)
     lv_area_t label_area;
     label_area.y1 = calendar->coords.y1 + get_header_height(calendar) + ext->style_day_names->body.padding.top;
     label_area.y2 = label_area.y1 + lv_font_get_line_height(ext->style_day_names->text.font);
+
+    lv_area_t names_area;
+    lv_area_set(&names_area, calendar->coords.x1, label_area.y1, calendar->coords.x2, label_area.y2);
+    if(lv_area_is_on(&names_area, mask) == false) return;
+
     uint32_t i;
     for(i = 0; i < 7; i++) {
         label_area.x1 = calendar->coords.x1 + (w * i) / 7 + l_pad;
         label_area.x2 = label_area.x1 + box_w - 1;
         lv_draw_label(&label_area, mask, ext->style_day_names, opa_scale, get_day_name(calendar, i), LV_TXT_FLAG_CENTER,
-                      NULL, -1, -1, NULL);
+                      NULL, -1, -1, NULL, NULL);
     }
 }
 
@@ -707,134 +744,211 @@ static void draw_days(lv_obj_t * calendar, const lv_area_t * mask)
 {
     lv_calendar_ext_t * ext     = lv_obj_get_ext_attr(calendar);
     const lv_style_t * style_bg = lv_calendar_get_style(calendar, LV_CALENDAR_STYLE_BG);
-    lv_area_t label_area;
-    lv_opa_t opa_scale = lv_obj_get_opa_scale(calendar);
-    label_area.y1      = calendar->coords.y1 + get_header_height(calendar) + ext->style_day_names->body.padding.top +
-                    lv_font_get_line_height(ext->style_day_names->text.font) +
-                    ext->style_day_names->body.padding.bottom;
-    label_area.y2 = label_area.y1 + lv_font_get_line_height(style_bg->text.font);
-
-    lv_coord_t w          = lv_obj_get_width(calendar) - style_bg->body.padding.left - style_bg->body.padding.right;
-    lv_coord_t h          = calendar->coords.y2 - label_area.y1 - style_bg->body.padding.bottom;
-    lv_coord_t box_w      = w / 7;
-    lv_coord_t vert_space = (h - (6 * lv_font_get_line_height(style_bg->text.font))) / 5;
-
-    uint32_t week;
-    uint8_t day_cnt;
-    uint8_t month_start_day = get_day_of_week(ext->showed_date.year, ext->showed_date.month, 1);
-    day_draw_state_t draw_state; /*true: Not the prev. or next month is drawn*/
-    const lv_style_t * act_style;
-
-    /*If starting with the first day of the week then the previous month is not visible*/
-    if(month_start_day == 0) {
-        day_cnt    = 1;
-        draw_state = DAY_DRAW_ACT_MONTH;
-        act_style  = style_bg;
-    } else {
-        draw_state = DAY_DRAW_PREV_MONTH;
-        day_cnt = get_month_length(ext->showed_date.year, ext->showed_date.month - 1); /*Length of the previous month*/
-        day_cnt -= month_start_day - 1; /*First visible number of the previous month*/
-        act_style = ext->style_inactive_days;
-    }
-
-    bool month_of_today_shown = false;
-    if(ext->showed_date.year == ext->today.year && ext->showed_date.month == ext->today.month) {
-        month_of_today_shown = true;
-    }
-
-    char buf[3];
-    bool in_week_box = false;
+    lv_opa_t opa_scale          = lv_obj_get_opa_scale(calendar);
 
     /*Draw 6 weeks*/
+    uint8_t week;
     for(week = 0; week < 6; week++) {
 
         /*Draw the "week box"*/
-        if(month_of_today_shown &&
-           ((draw_state == DAY_DRAW_ACT_MONTH && ext->today.day >= day_cnt && ext->today.day < day_cnt + 7) ||
-            (draw_state == DAY_DRAW_PREV_MONTH && ext->today.day <= 7 - month_start_day && week == 0))) {
+        if(ext->day_states[week * 7] & DAY_STATE_WEEK) {
             lv_area_t week_box_area;
-            lv_area_copy(&week_box_area, &label_area); /*'label_area' is already set for this row*/
-            week_box_area.x1 =
-                calendar->coords.x1 + style_bg->body.padding.left - ext->style_week_box->body.padding.left;
-            week_box_area.x2 =
-                calendar->coords.x2 - style_bg->body.padding.right + ext->style_week_box->body.padding.right;
-
-            week_box_area.y1 -= ext->style_week_box->body.padding.top;
-            week_box_area.y2 += ext->style_week_box->body.padding.bottom;
+            get_week_box_area(calendar, week, &week_box_area);
             lv_draw_rect(&week_box_area, mask, ext->style_week_box, opa_scale);
-
-            in_week_box = true;
-        } else {
-            in_week_box = false;
         }
 
         /*Draw the 7 days of a week*/
-        uint32_t day;
-        for(day = 0; day < 7; day++) {
-            /*The previous month is over*/
-            if(draw_state == DAY_DRAW_PREV_MONTH && day == month_start_day) {
-                draw_state = DAY_DRAW_ACT_MONTH;
-                day_cnt    = 1;
-                act_style  = style_bg;
-            }
-            /*The current month is over*/
-            if(draw_state == DAY_DRAW_ACT_MONTH &&
-               day_cnt > get_month_length(ext->showed_date.year, ext->showed_date.month)) {
-                draw_state = DAY_DRAW_NEXT_MONTH;
-                day_cnt    = 1;
-                act_style  = ext->style_inactive_days;
-            }
-
-            label_area.x1 =
-                calendar->coords.x1 + (w * day) / 7 + style_bg->body.padding.left + style_bg->body.padding.right;
-            label_area.x2 = label_area.x1 + box_w - 1;
+        uint8_t day_id;
+        for(day_id = week * 7; day_id < week * 7 + 7; day_id++) {
+            uint8_t state = ext->day_states[day_id];
+            lv_area_t label_area;
+            get_day_area(calendar, day_id, &label_area);
 
             /*Draw the "today box"*/
-            if(draw_state == DAY_DRAW_ACT_MONTH && month_of_today_shown && ext->today.day == day_cnt) {
+            if(state & DAY_STATE_TODAY) {
                 lv_area_t today_box_area;
                 lv_area_copy(&today_box_area, &label_area);
-                today_box_area.x1 = label_area.x1;
-                today_box_area.x2 = label_area.x2;
-
                 today_box_area.y1 = label_area.y1 - ext->style_today_box->body.padding.top;
                 today_box_area.y2 = label_area.y2 + ext->style_today_box->body.padding.bottom;
                 lv_draw_rect(&today_box_area, mask, ext->style_today_box, opa_scale);
             }
 
-            /*Get the final style : highlighted/week box/today box/normal*/
+            /*Get the final style : highlighted/today box/inactive/week box/normal*/
             const lv_style_t * final_style;
-            if(draw_state == DAY_DRAW_PREV_MONTH &&
-               is_highlighted(calendar, ext->showed_date.year - (ext->showed_date.month == 1 ? 1 : 0),
-                              ext->showed_date.month == 1 ? 12 : ext->showed_date.month - 1, day_cnt)) {
+            if(state & DAY_STATE_HIGHLIGHTED)
                 final_style = ext->style_highlighted_days;
-            } else if(draw_state == DAY_DRAW_ACT_MONTH &&
-                      is_highlighted(calendar, ext->showed_date.year, ext->showed_date.month, day_cnt)) {
-                final_style = ext->style_highlighted_days;
-            } else if(draw_state == DAY_DRAW_NEXT_MONTH &&
-                      is_highlighted(calendar, ext->showed_date.year + (ext->showed_date.month == 12 ? 1 : 0),
-                                     ext->showed_date.month == 12 ? 1 : ext->showed_date.month + 1, day_cnt)) {
-                final_style = ext->style_highlighted_days;
-            } else if(month_of_today_shown && day_cnt == ext->today.day && draw_state == DAY_DRAW_ACT_MONTH)
+            else if(state & DAY_STATE_TODAY)
                 final_style = ext->style_today_box;
-            else if(in_week_box && draw_state == DAY_DRAW_ACT_MONTH)
+            else if(state & (DAY_STATE_PREV_MONTH | DAY_STATE_NEXT_MONTH))
+                final_style = ext->style_inactive_days;
+            else if(state & DAY_STATE_WEEK)
                 final_style = ext->style_week_box;
             else
-                final_style = act_style;
+                final_style = style_bg;
 
             /*Write the day's number*/
-            lv_utils_num_to_str(day_cnt, buf);
-            lv_draw_label(&label_area, mask, final_style, opa_scale, buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL);
+            lv_draw_label(&label_area, mask, final_style, opa_scale, day_num_txt[ext->day_nums[day_id]],
+                          LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL, NULL);
+        }
+    }
+}
+
+/**
+ * Calculate the number and the state of the shown days of `showed_date`
+ * @param calendar pointer to a calendar object
+ * @param day_nums store the number of the days here (`LV_CALENDAR_DAY_CNT` elements)
+ * @param day_states store the `DAY_STATE_...` flags of the days here (`LV_CALENDAR_DAY_CNT` elements)
+ */
+static void calc_days(lv_obj_t * calendar, uint8_t * day_nums, uint8_t * day_states)
+{
+    lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
+    int32_t year            = ext->showed_date.year;
+    int32_t month           = ext->showed_date.month;
+    int32_t prev_year       = year - (month == 1 ? 1 : 0);
+    int32_t prev_month      = month == 1 ? 12 : month - 1;
+    int32_t next_year       = year + (month == 12 ? 1 : 0);
+    int32_t next_month      = month == 12 ? 1 : month + 1;
+
+    uint8_t month_start_day = get_day_of_week(year, month, 1);
+    uint8_t month_len       = get_month_length(year, month);
+    uint8_t prev_month_len  = get_month_length(year, month - 1);
+
+    /*The index of today if its month is shown*/
+    uint8_t today_id = LV_CALENDAR_DAY_CNT;
+    if(ext->today.year == year && ext->today.month == month && ext->today.day >= 1 && ext->today.day <= month_len) {
+        today_id = month_start_day + ext->today.day - 1;
+    }
 
-            /*Go to the next day*/
-            day_cnt++;
+    uint8_t i;
+    for(i = 0; i < LV_CALENDAR_DAY_CNT; i++) {
+        uint8_t state;
+        if(i < month_start_day) {
+            day_nums[i] = prev_month_len - month_start_day + 1 + i;
+            state       = DAY_STATE_PREV_MONTH;
+            if(is_highlighted(calendar, prev_year, prev_month, day_nums[i])) state |= DAY_STATE_HIGHLIGHTED;
+        } else if(i < month_start_day + month_len) {
+            day_nums[i] = i + 1 - month_start_day;
+            state       = 0;
+            if(is_highlighted(calendar, year, month, day_nums[i])) state |= DAY_STATE_HIGHLIGHTED;
+        } else {
+            day_nums[i] = i + 1 - month_start_day - month_len;
+            state       = DAY_STATE_NEXT_MONTH;
+            if(is_highlighted(calendar, next_year, next_month, day_nums[i])) state |= DAY_STATE_HIGHLIGHTED;
         }
 
-        /*Got to the next weeks row*/
-        label_area.y1 += vert_space + lv_font_get_line_height(style_bg->text.font);
-        label_area.y2 += vert_space + lv_font_get_line_height(style_bg->text.font);
+        if(i == today_id) state |= DAY_STATE_TODAY;
+        if(today_id < LV_CALENDAR_DAY_CNT && i / 7 == today_id / 7) state |= DAY_STATE_WEEK;
+
+        day_states[i] = state;
     }
 }
 
+/**
+ * Calculate the shown days again and invalidate only the changed ones
+ * @param calendar pointer to a calendar object
+ */
+static void refr_days(lv_obj_t * calendar)
+{
+    lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
+    uint8_t day_nums[LV_CALENDAR_DAY_CNT];
+    uint8_t day_states[LV_CALENDAR_DAY_CNT];
+    calc_days(calendar, day_nums, day_states);
+
+    uint8_t week;
+    for(week = 0; week < 6; week++) {
+        /*If the week box is added or removed the whole week changes*/
+        bool week_chg = ((day_states[week * 7] ^ ext->day_states[week * 7]) & DAY_STATE_WEEK) != 0;
+        if(week_chg) {
+            lv_area_t week_box_area;
+            get_week_box_area(calendar, week, &week_box_area);
+            lv_obj_invalidate_area(calendar, &week_box_area);
+        }
+
+        uint8_t day_id;
+        for(day_id = week * 7; day_id < week * 7 + 7; day_id++) {
+            if(week_chg || day_nums[day_id] != ext->day_nums[day_id] || day_states[day_id] != ext->day_states[day_id]) {
+                invalidate_day(calendar, day_id);
+            }
+        }
+    }
+
+    memcpy(ext->day_nums, day_nums, sizeof(day_nums));
+    memcpy(ext->day_states, day_states, sizeof(day_states));
+}
+
+/**
+ * Get the area of a day's number
+ * @param calendar pointer to a calendar object
+ * @param day_id index of the day [0..LV_CALENDAR_DAY_CNT - 1]
+ * @param area store the area here
+ */
+static void get_day_area(lv_obj_t * calendar, uint8_t day_id, lv_area_t * area)
+{
+    lv_calendar_ext_t * ext     = lv_obj_get_ext_attr(calendar);
+    const lv_style_t * style_bg = lv_calendar_get_style(calendar, LV_CALENDAR_STYLE_BG);
+    lv_coord_t font_h           = lv_font_get_line_height(style_bg->text.font);
+    lv_coord_t days_y1          = calendar->coords.y1 + get_header_height(calendar) +
+                         ext->style_day_names->body.padding.top +
+                         lv_font_get_line_height(ext->style_day_names->text.font) +
+                         ext->style_day_names->body.padding.bottom;
+
+    lv_coord_t w          = lv_obj_get_width(calendar) - style_bg->body.padding.left - style_bg->body.padding.right;
+    lv_coord_t h          = calendar->coords.y2 - days_y1 - style_bg->body.padding.bottom;
+    lv_coord_t vert_space = (h - (6 * font_h)) / 5;
+
+    uint8_t week = day_id / 7;
+    uint8_t day  = day_id % 7;
+    area->x1     = calendar->coords.x1 + (w * day) / 7 + style_bg->body.padding.left + style_bg->body.padding.right;
+    area->x2     = area->x1 + w / 7 - 1;
+    area->y1     = days_y1 + week * (vert_space + font_h);
+    area->y2     = area->y1 + font_h;
+}
+
+/**
+ * Get the area of the week box in a week
+ * @param calendar pointer to a calendar object
+ * @param week index of the week [0..5]
+ * @param area store the area here
+ */
+static void get_week_box_area(lv_obj_t * calendar, uint8_t week, lv_area_t * area)
+{
+    lv_calendar_ext_t * ext     = lv_obj_get_ext_attr(calendar);
+    const lv_style_t * style_bg = lv_calendar_get_style(calendar, LV_CALENDAR_STYLE_BG);
+
+    get_day_area(calendar, week * 7, area);
+    area->x1 = calendar->coords.x1 + style_bg->body.padding.left - ext->style_week_box->body.padding.left;
+    area->x2 = calendar->coords.x2 - style_bg->body.padding.right + ext->style_week_box->body.padding.right;
+    area->y1 -= ext->style_week_box->body.padding.top;
+    area->y2 += ext->style_week_box->body.padding.bottom;
+}
+
+/**
+ * Invalidate the header, e.g. because of a new month or a pressed arrow
+ * @param calendar pointer to a calendar object
+ */
+static void invalidate_header(lv_obj_t * calendar)
+{
+    lv_area_t header_area;
+    lv_area_copy(&header_area, &calendar->coords);
+    header_area.y2 = header_area.y1 + get_header_height(calendar);
+    lv_obj_invalidate_area(calendar, &header_area);
+}
+
+/**
+ * Invalidate a day with its today box
+ * @param calendar pointer to a calendar object
+ * @param day_id index of the day [0..LV_CALENDAR_DAY_CNT - 1]
+ */
+static void invalidate_day(lv_obj_t * calendar, uint8_t day_id)
+{
+    lv_calendar_ext_t * ext = lv_obj_get_ext_attr(calendar);
+    lv_area_t area;
+    get_day_area(calendar, day_id, &area);
+    area.y1 -= LV_MATH_MAX(ext->style_today_box->body.padding.top, 0);
+    area.y2 += LV_MATH_MAX(ext->style_today_box->body.padding.bottom, 0);
+    lv_obj_invalidate_area(calendar, &area);
+}
+
 /**
  * Check weather a date is highlighted or not
  * @param calendar pointer to a calendar object
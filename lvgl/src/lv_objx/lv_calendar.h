@@ -26,6 +26,7 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#define LV_CALENDAR_DAY_CNT 42 /*Number of shown days: 6 weeks*/
 
 /**********************
  *      TYPEDEFS
@@ -56,6 +57,10 @@ typedef struct
     const char ** day_names;   /*Pointer to an array with the name of the days (NULL: use default names)*/
     const char ** month_names; /*Pointer to an array with the name of the month (NULL. use default names)*/
 
+    /*The shown days of `showed_date`. Refreshed when the month, today or the highlighted dates change.*/
+    uint8_t day_nums[LV_CALENDAR_DAY_CNT];   /*Number of the day in its month*/
+    uint8_t day_states[LV_CALENDAR_DAY_CNT]; /*Month, highlighted, today etc. flags of the days*/
+
     /*Styles*/
     const lv_style_t * style_header;
     const lv_style_t * style_header_pr;
@@ -119,7 +124,7 @@ void lv_calendar_set_showed_date(lv_obj_t * calendar, lv_calendar_date_t * showe
  * Set the the highlighted dates
  * @param calendar pointer to a calendar object
  * @param highlighted pointer to an `lv_calendar_date_t` array containing the dates. ONLY A POINTER
- * WILL BE SAVED! CAN'T BE LOCAL ARRAY.
+ * WILL BE SAVED! CAN'T BE LOCAL ARRAY. Call this function again after changing the array.
  * @param date_num number of dates in the array
  */
 void lv_calendar_set_highlighted_dates(lv_obj_t * calendar, lv_calendar_date_t * highlighted, uint16_t date_num);
@@ -10,6 +10,7 @@
 #include "lv_canvas.h"
 #include "../lv_misc/lv_math.h"
 #include "../lv_draw/lv_draw.h"
+#include "../lv_draw/lv_img_cache.h"
 #include "../lv_core/lv_refr.h"
 
 #if LV_USE_CANVAS != 0
@@ -22,10 +23,40 @@
  *      TYPEDEFS
  **********************/
 
+/*An image to rotate*/
+typedef struct
+{
+    lv_img_dsc_t * img;
+    const lv_style_t * style;
+    uint8_t px_size;          /*Bytes of a pixel to read true color images directly. 0: other formats*/
+    uint8_t alpha : 1;        /*The image has alpha channel*/
+    uint8_t chroma_keyed : 1; /*The `LV_COLOR_TRANSP` pixels are transparent*/
+} lv_canvas_rotate_src_t;
+
+/*A dummy display to fool the lv_draw functions. They will think they draw to real screen.*/
+typedef struct
+{
+    lv_disp_t disp;
+    lv_disp_buf_t disp_buf;
+    lv_disp_t * disp_ori; /*The display which was refreshed before*/
+    lv_area_t mask;       /*The whole canvas*/
+} lv_canvas_target_t;
+
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static lv_res_t lv_canvas_signal(lv_obj_t * canvas, lv_signal_t sign, void * param);
+static const lv_area_t * lv_canvas_draw_start(lv_obj_t * canvas, lv_canvas_target_t * target);
+static void lv_canvas_draw_finish(lv_obj_t * canvas, lv_canvas_target_t * target, const lv_area_t * area);
+static void lv_canvas_target_open(lv_obj_t * canvas, lv_canvas_target_t * target);
+static void lv_canvas_target_close(lv_canvas_target_t * target);
+static void lv_canvas_invalidate_area(lv_obj_t * canvas, const lv_area_t * area);
+static lv_opa_t lv_canvas_rotate_sample(const lv_canvas_rotate_src_t * src, int32_t xs, int32_t ys,
+                                        lv_color_t * color);
+static void lv_canvas_rotate_get_px(const lv_canvas_rotate_src_t * src, int32_t x, int32_t y, lv_color_t * color,
+                                    lv_opa_t * opa);
+static void lv_canvas_rotate_blend(lv_img_dsc_t * dsc, int32_t x, int32_t y, lv_color_t color, lv_opa_t opa,
+                                   const lv_style_t * style);
 
 /**********************
  *  STATIC VARIABLES
@@ -33,6 +64,12 @@ static lv_res_t lv_canvas_signal(lv_obj_t * canvas, lv_signal_t sign, void * par
 static lv_signal_cb_t ancestor_signal;
 static lv_design_cb_t ancestor_design;
 
+/*The canvas drawn between `lv_canvas_draw_begin/end()`*/
+static lv_obj_t * batch_canvas;
+static lv_canvas_target_t batch_target;
+static lv_area_t batch_dirty;
+static bool batch_dirty_valid;
+
 /**********************
  *      MACROS
  **********************/
@@ -119,6 +156,8 @@ void lv_canvas_set_buffer(lv_obj_t * canvas, void * buf, lv_coord_t w, lv_coord_
     ext->dsc.data      = buf;
     ext->dsc.data_size = (lv_img_color_format_get_px_size(cf) * w * h) / 8;
 
+    /*The cache knows the images by their address, an image freed earlier might have been here*/
+    lv_img_cache_invalidate_src(&ext->dsc);
     lv_img_set_src(canvas, &ext->dsc);
 }
 
@@ -134,7 +173,10 @@ void lv_canvas_set_px(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_color_t
     lv_canvas_ext_t * ext = lv_obj_get_ext_attr(canvas);
 
     lv_img_buf_set_px_color(&ext->dsc, x, y, c);
-    lv_obj_invalidate(canvas);
+
+    lv_area_t area;
+    lv_area_set(&area, x, y, x, y);
+    lv_canvas_invalidate_area(canvas, &area);
 }
 
 /**
@@ -249,6 +291,10 @@ void lv_canvas_copy_buf(lv_obj_t * canvas, const void * to_copy, lv_coord_t x, l
         px += ext->dsc.header.w * px_size;
         to_copy8 += w * px_size;
     }
+
+    lv_area_t area;
+    lv_area_set(&area, x, y, x + w - 1, y + h - 1);
+    lv_canvas_invalidate_area(canvas, &area);
 }
 
 /**
@@ -266,162 +312,105 @@ void lv_canvas_copy_buf(lv_obj_t * canvas, const void * to_copy, lv_coord_t x, l
  */
 void lv_canvas_rotate(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, lv_coord_t offset_x, lv_coord_t offset_y,
                       int32_t pivot_x, int32_t pivot_y)
+{
+    lv_canvas_rotate_zoom(canvas, img, angle, LV_CANVAS_ZOOM_NONE, offset_x, offset_y, pivot_x, pivot_y);
+}
+
+/**
+ * Rotate and zoom an image and store the result on a canvas. The pixels are bilinear filtered.
+ * @param canvas pointer to a canvas object
+ * @param img pointer to an image descriptor.
+ *             Can be the image descriptor of an other canvas too (`lv_canvas_get_img()`).
+ * @param angle the angle of rotation (0..360);
+ * @param zoom the zoom factor: `LV_CANVAS_ZOOM_NONE` (256): no zoom, 128: half size, 512: double size
+ * @param offset_x offset X to tell where to put the result data on destination canvas
+ * @param offset_y offset X to tell where to put the result data on destination canvas
+ * @param pivot_x pivot X of rotation and zoom. Relative to the source canvas
+ *                Set to `source width / 2` to rotate around the center
+ * @param pivot_y pivot Y of rotation and zoom. Relative to the source canvas
+ *                Set to `source height / 2` to rotate around the center
+ */
+void lv_canvas_rotate_zoom(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, uint16_t zoom, lv_coord_t offset_x,
+                           lv_coord_t offset_y, int32_t pivot_x, int32_t pivot_y)
 {
     lv_canvas_ext_t * ext_dst = lv_obj_get_ext_attr(canvas);
-    const lv_style_t * style  = lv_canvas_get_style(canvas, LV_CANVAS_STYLE_MAIN);
-    int32_t sinma             = lv_trigo_sin(-angle);
-    int32_t cosma             = lv_trigo_sin(-angle + 90); /* cos */
+    if(zoom < LV_CANVAS_ZOOM_MIN) zoom = LV_CANVAS_ZOOM_MIN;
+
+    lv_canvas_rotate_src_t src;
+    src.img   = img;
+    src.style = lv_canvas_get_style(canvas, LV_CANVAS_STYLE_MAIN);
+    src.alpha = lv_img_color_format_has_alpha(img->header.cf) ? 1 : 0;
+    src.chroma_keyed = lv_img_color_format_is_chroma_keyed(img->header.cf) ? 1 : 0;
+    if(img->header.cf == LV_IMG_CF_TRUE_COLOR || img->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED ||
+       img->header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+        src.px_size = lv_img_color_format_get_px_size(img->header.cf) >> 3;
+    } else {
+        src.px_size = 0;
+    }
+
+    /*Change of the source coordinates with a step on the canvas [1/LV_TRIGO_SIN_MAX px]*/
+    int32_t sinma  = lv_trigo_sin(-angle);
+    int32_t cosma  = lv_trigo_sin(-angle + 90); /* cos */
+    int32_t step_x = cosma * LV_CANVAS_ZOOM_NONE / zoom;
+    int32_t step_y = sinma * LV_CANVAS_ZOOM_NONE / zoom;
 
     int32_t img_width   = img->header.w;
     int32_t img_height  = img->header.h;
     int32_t dest_width  = ext_dst->dsc.header.w;
     int32_t dest_height = ext_dst->dsc.header.h;
 
+    /*Draw only in the bounding box of the transformed image*/
+    int32_t x_min = INT32_MAX;
+    int32_t y_min = INT32_MAX;
+    int32_t x_max = INT32_MIN;
+    int32_t y_max = INT32_MIN;
+    uint8_t i;
+    for(i = 0; i < 4; i++) {
+        int32_t xc = (i & 0x1 ? img_width : 0) - pivot_x;
+        int32_t yc = (i & 0x2 ? img_height : 0) - pivot_y;
+        int32_t xd = (((cosma * xc + sinma * yc) >> LV_TRIGO_SHIFT) * zoom) / LV_CANVAS_ZOOM_NONE;
+        int32_t yd = (((cosma * yc - sinma * xc) >> LV_TRIGO_SHIFT) * zoom) / LV_CANVAS_ZOOM_NONE;
+        xd += pivot_x + offset_x;
+        yd += pivot_y + offset_y;
+        x_min = LV_MATH_MIN(x_min, xd - 2);
+        y_min = LV_MATH_MIN(y_min, yd - 2);
+        x_max = LV_MATH_MAX(x_max, xd + 2);
+        y_max = LV_MATH_MAX(y_max, yd + 2);
+    }
+
+    lv_area_t dest_area;
+    dest_area.x1 = LV_MATH_MAX(x_min, 0);
+    dest_area.y1 = LV_MATH_MAX(y_min, 0);
+    dest_area.x2 = LV_MATH_MIN(x_max, dest_width - 1);
+    dest_area.y2 = LV_MATH_MIN(y_max, dest_height - 1);
+    if(dest_area.x1 > dest_area.x2 || dest_area.y1 > dest_area.y2) return;
+
+    int32_t xs_max = img_width << 8;
+    int32_t ys_max = img_height << 8;
     int32_t x;
     int32_t y;
-    for(x = -offset_x; x < dest_width - offset_x; x++) {
-        for(y = -offset_y; y < dest_height - offset_y; y++) {
-            /*Get the target point relative coordinates to the pivot*/
-            int32_t xt = x - pivot_x;
-            int32_t yt = y - pivot_y;
-
+    for(y = dest_area.y1; y <= dest_area.y2; y++) {
+        /*Get the first point of the row relative to the pivot and step along the row*/
+        int32_t xt     = dest_area.x1 - offset_x - pivot_x;
+        int32_t yt     = y - offset_y - pivot_y;
+        int32_t xs_acc = (int32_t)(((int64_t)cosma * xt - (int64_t)sinma * yt) * LV_CANVAS_ZOOM_NONE / zoom);
+        int32_t ys_acc = (int32_t)(((int64_t)sinma * xt + (int64_t)cosma * yt) * LV_CANVAS_ZOOM_NONE / zoom);
+
+        for(x = dest_area.x1; x <= dest_area.x2; x++, xs_acc += step_x, ys_acc += step_y) {
             /*Get the source pixel from the upscaled image*/
-            int32_t xs = ((cosma * xt - sinma * yt) >> (LV_TRIGO_SHIFT - 8)) + pivot_x * 256;
-            int32_t ys = ((sinma * xt + cosma * yt) >> (LV_TRIGO_SHIFT - 8)) + pivot_y * 256;
-
-            /*Get the integer part of the source pixel*/
-            int xs_int = xs >> 8;
-            int ys_int = ys >> 8;
-
-            if(xs_int >= img_width)
-                continue;
-            else if(xs_int < 0)
-                continue;
-
-            if(ys_int >= img_height)
-                continue;
-            else if(ys_int < 0)
-                continue;
-
-            /*Get the fractional part of the source pixel*/
-            int xs_fract = xs & 0xff;
-            int ys_fract = ys & 0xff;
-
-            /* If the fractional < 0x70 mix the source pixel with the left/top pixel
-             * If the fractional > 0x90 mix the source pixel with the right/bottom pixel
-             * In the 0x70..0x90 range use the unchanged source pixel */
-
-            int xn;      /*x neightboor*/
-            lv_opa_t xr; /*x mix ratio*/
-            if(xs_fract < 0x70) {
-                xn = xs_int - 1;
-                xr = xs_fract * 2;
-            } else if(xs_fract > 0x90) {
-                xn = xs_int + 1;
-                xr = (0xFF - xs_fract) * 2;
-            } else {
-                xn = xs_int;
-                xr = 0xFF;
-            }
-
-            /*Handle under/overflow*/
-            if(xn >= img_width)
-                continue;
-            else if(xn < 0)
-                continue;
-
-            int yn;      /*y neightboor*/
-            lv_opa_t yr; /*y mix ratio*/
-            if(ys_fract < 0x70) {
-                yn = ys_int - 1;
-                yr = ys_fract * 2;
-            } else if(ys_fract > 0x90) {
-                yn = ys_int + 1;
-                yr = (0xFF - ys_fract) * 2;
-            } else {
-                yn = ys_int;
-                yr = 0xFF;
-            }
-
-            /*Handle under/overflow*/
-            if(yn >= img_height)
-                continue;
-            else if(yn < 0)
-                continue;
-
-            /*Get the mixture of the original source and the neightboor pixels in both directions*/
-            lv_color_t c_dest_int = lv_img_buf_get_px_color(img, xs_int, ys_int, style);
-
-            if(lv_img_color_format_is_chroma_keyed(img->header.cf)) {
-                lv_color_t ct = LV_COLOR_TRANSP;
-                if(c_dest_int.full == ct.full) continue;
-            }
-
-            lv_color_t c_dest_xn = lv_img_buf_get_px_color(img, xn, ys_int, style);
-            lv_color_t c_dest_yn = lv_img_buf_get_px_color(img, xs_int, yn, style);
-            lv_color_t x_dest    = lv_color_mix(c_dest_int, c_dest_xn, xr);
-            lv_color_t y_dest    = lv_color_mix(c_dest_int, c_dest_yn, yr);
-            lv_color_t color_res = lv_color_mix(x_dest, y_dest, LV_OPA_50);
-
-            if(x + offset_x >= 0 && x + offset_x < dest_width && y + offset_y >= 0 && y + offset_y < dest_height) {
-                /*If the image has no alpha channel just simple set the result color on the canvas*/
-                if(lv_img_color_format_has_alpha(img->header.cf) == false) {
-                    lv_img_buf_set_px_color(&ext_dst->dsc, x + offset_x, y + offset_y, color_res);
-                } else {
-                    /*Get result pixel opacity*/
-                    lv_opa_t opa_int = lv_img_buf_get_px_alpha(img, xs_int, ys_int);
-                    lv_opa_t opa_xn  = lv_img_buf_get_px_alpha(img, xn, ys_int);
-                    lv_opa_t opa_yn  = lv_img_buf_get_px_alpha(img, xs_int, yn);
-                    lv_opa_t opa_x   = (opa_int * xr + (opa_xn * (255 - xr))) >> 8;
-                    lv_opa_t opa_y   = (opa_int * yr + (opa_yn * (255 - yr))) >> 8;
-                    lv_opa_t opa_res = (opa_x + opa_y) / 2;
-                    if(opa_res <= LV_OPA_MIN) continue;
-
-                    lv_color_t bg_color = lv_img_buf_get_px_color(&ext_dst->dsc, x + offset_x, y + offset_y, style);
-
-                    /*If the canvas has no alpha but the image has mix the image's color with
-                     * canvas*/
-                    if(lv_img_color_format_has_alpha(ext_dst->dsc.header.cf) == false) {
-                        if(opa_res < LV_OPA_MAX) color_res = lv_color_mix(color_res, bg_color, opa_res);
-                        lv_img_buf_set_px_color(&ext_dst->dsc, x + offset_x, y + offset_y, color_res);
-                    }
-                    /*Both the image and canvas has alpha channel. Some extra calculation is
-                       required*/
-                    else {
-                        lv_opa_t bg_opa = lv_img_buf_get_px_alpha(&ext_dst->dsc, x + offset_x, y + offset_y);
-                        /* Pick the foreground if it's fully opaque or the Background is fully
-                         * transparent*/
-                        if(opa_res >= LV_OPA_MAX || bg_opa <= LV_OPA_MIN) {
-                            lv_img_buf_set_px_color(&ext_dst->dsc, x + offset_x, y + offset_y, color_res);
-                            lv_img_buf_set_px_alpha(&ext_dst->dsc, x + offset_x, y + offset_y, opa_res);
-                        }
-                        /*Opaque background: use simple mix*/
-                        else if(bg_opa >= LV_OPA_MAX) {
-                            lv_img_buf_set_px_color(&ext_dst->dsc, x + offset_x, y + offset_y,
-                                                    lv_color_mix(color_res, bg_color, opa_res));
-                        }
-                        /*Both colors have alpha. Expensive calculation need to be applied*/
-                        else {
-
-                            /*Info:
-                             * https://en.wikipedia.org/wiki/Alpha_compositing#Analytical_derivation_of_the_over_operator*/
-                            lv_opa_t opa_res_2 = 255 - ((uint16_t)((uint16_t)(255 - opa_res) * (255 - bg_opa)) >> 8);
-                            if(opa_res_2 == 0) {
-                                opa_res_2 = 1; /*never happens, just to be sure*/
-                            }
-                            lv_opa_t ratio = (uint16_t)((uint16_t)opa_res * 255) / opa_res_2;
-
-                            lv_img_buf_set_px_color(&ext_dst->dsc, x + offset_x, y + offset_y,
-                                                    lv_color_mix(color_res, bg_color, ratio));
-                            lv_img_buf_set_px_alpha(&ext_dst->dsc, x + offset_x, y + offset_y, opa_res_2);
-                        }
-                    }
-                }
-            }
+            int32_t xs = (xs_acc >> (LV_TRIGO_SHIFT - 8)) + pivot_x * 256;
+            int32_t ys = (ys_acc >> (LV_TRIGO_SHIFT - 8)) + pivot_y * 256;
+            if(xs < 0 || xs >= xs_max || ys < 0 || ys >= ys_max) continue;
+
+            lv_color_t color;
+            lv_opa_t opa = lv_canvas_rotate_sample(&src, xs, ys, &color);
+            if(opa <= LV_OPA_MIN) continue;
+
+            lv_canvas_rotate_blend(&ext_dst->dsc, x, y, color, opa, src.style);
         }
     }
 
-    lv_obj_invalidate(canvas);
+    lv_canvas_invalidate_area(canvas, &dest_area);
 }
 
 /**
@@ -440,6 +429,40 @@ void lv_canvas_fill_bg(lv_obj_t * canvas, lv_color_t color)
             lv_img_buf_set_px_color(dsc, x, y, color);
         }
     }
+
+    lv_obj_invalidate(canvas);
+}
+
+/**
+ * Start drawing many primitives to a canvas.
+ * The drawing is redirected to the canvas only once and the drawn area is invalidated in `lv_canvas_draw_end()`.
+ * Only one canvas can be drawn like this at a time and `lv_task_handler()` shouldn't be called until the end.
+ * @param canvas pointer to a canvas object
+ */
+void lv_canvas_draw_begin(lv_obj_t * canvas)
+{
+    if(batch_canvas != NULL) {
+        LV_LOG_WARN("lv_canvas_draw_begin: an other canvas is being drawn");
+        return;
+    }
+
+    lv_canvas_target_open(canvas, &batch_target);
+    batch_canvas      = canvas;
+    batch_dirty_valid = false;
+}
+
+/**
+ * Finish drawing the primitives started with `lv_canvas_draw_begin()` and invalidate the area they cover
+ * @param canvas pointer to a canvas object
+ */
+void lv_canvas_draw_end(lv_obj_t * canvas)
+{
+    if(batch_canvas != canvas) return;
+
+    lv_canvas_target_close(&batch_target);
+    batch_canvas = NULL;
+
+    if(batch_dirty_valid) lv_canvas_invalidate_area(canvas, &batch_dirty);
 }
 
 /**
@@ -454,41 +477,25 @@ void lv_canvas_fill_bg(lv_obj_t * canvas, lv_color_t color)
 void lv_canvas_draw_rect(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h,
                          const lv_style_t * style)
 {
-    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
-
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
     lv_area_t coords;
     coords.x1 = x;
     coords.y1 = y;
     coords.x2 = x + w - 1;
     coords.y2 = y + h - 1;
 
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
-
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
-
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
-
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
 
-    lv_draw_rect(&coords, &mask, style, LV_OPA_COVER);
+    lv_draw_rect(&coords, mask, style, LV_OPA_COVER);
 
-    lv_refr_set_disp_refreshing(refr_ori);
+    /*The shadow is out of the rectangle*/
+    lv_area_t dirty;
+    lv_area_copy(&dirty, &coords);
+    dirty.x1 -= style->body.shadow.width;
+    dirty.y1 -= style->body.shadow.width;
+    dirty.x2 += style->body.shadow.width;
+    dirty.y2 += style->body.shadow.width;
+    lv_canvas_draw_finish(canvas, &target, &dirty);
 }
 
 /**
@@ -506,36 +513,12 @@ void lv_canvas_draw_text(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
 {
     lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
 
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
     lv_area_t coords;
     coords.x1 = x;
     coords.y1 = y;
     coords.x2 = x + max_w - 1;
     coords.y2 = dsc->header.h - 1;
 
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
-
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
-
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
-
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
-
     lv_txt_flag_t flag;
     switch(align) {
         case LV_LABEL_ALIGN_LEFT: flag = LV_TXT_FLAG_NONE; break;
@@ -544,10 +527,19 @@ void lv_canvas_draw_text(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
         default: flag = LV_TXT_FLAG_NONE; break;
     }
 
-    lv_draw_label(&coords, &mask, style, LV_OPA_COVER, txt, flag, NULL, LV_LABEL_TEXT_SEL_OFF, LV_LABEL_TEXT_SEL_OFF,
-                  NULL);
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
+
+    lv_draw_label(&coords, mask, style, LV_OPA_COVER, txt, flag, NULL, LV_LABEL_TEXT_SEL_OFF, LV_LABEL_TEXT_SEL_OFF,
+                  NULL, NULL);
 
-    lv_refr_set_disp_refreshing(refr_ori);
+    /*Only the lines of the text*/
+    lv_point_t size;
+    lv_txt_get_size(&size, txt, style->text.font, style->text.letter_space, style->text.line_space, max_w, flag);
+    lv_area_t dirty;
+    lv_area_copy(&dirty, &coords);
+    dirty.y2 = LV_MATH_MIN(dirty.y2, y + size.y - 1);
+    lv_canvas_draw_finish(canvas, &target, &dirty);
 }
 
 /**
@@ -558,16 +550,6 @@ void lv_canvas_draw_text(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord
  */
 void lv_canvas_draw_img(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, const void * src, const lv_style_t * style)
 {
-    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
-
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
     lv_img_header_t header;
     lv_res_t res = lv_img_decoder_get_info(src, &header);
     if(res != LV_RES_OK) {
@@ -581,25 +563,12 @@ void lv_canvas_draw_img(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, const voi
     coords.x2 = x + header.w - 1;
     coords.y2 = y + header.h - 1;
 
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
-
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
-
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
-
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
 
-    lv_draw_img(&coords, &mask, src, style, LV_OPA_COVER);
+    lv_draw_img(&coords, mask, src, style, LV_OPA_COVER);
 
-    lv_refr_set_disp_refreshing(refr_ori);
+    lv_canvas_draw_finish(canvas, &target, &coords);
 }
 
 /**
@@ -611,38 +580,30 @@ void lv_canvas_draw_img(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, const voi
  */
 void lv_canvas_draw_line(lv_obj_t * canvas, const lv_point_t * points, uint32_t point_cnt, const lv_style_t * style)
 {
-    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
-
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
-
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
+    if(point_cnt < 2) return;
 
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
-
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
 
+    lv_area_t dirty;
+    lv_area_set(&dirty, points[0].x, points[0].y, points[0].x, points[0].y);
     uint32_t i;
     for(i = 0; i < point_cnt - 1; i++) {
-        lv_draw_line(&points[i], &points[i + 1], &mask, style, LV_OPA_COVER);
+        lv_draw_line(&points[i], &points[i + 1], mask, style, LV_OPA_COVER);
+
+        dirty.x1 = LV_MATH_MIN(dirty.x1, points[i + 1].x);
+        dirty.y1 = LV_MATH_MIN(dirty.y1, points[i + 1].y);
+        dirty.x2 = LV_MATH_MAX(dirty.x2, points[i + 1].x);
+        dirty.y2 = LV_MATH_MAX(dirty.y2, points[i + 1].y);
     }
 
-    lv_refr_set_disp_refreshing(refr_ori);
+    /*The width of the lines and the anti-aliasing*/
+    lv_coord_t pad = style->line.width / 2 + 2;
+    dirty.x1 -= pad;
+    dirty.y1 -= pad;
+    dirty.x2 += pad;
+    dirty.y2 += pad;
+    lv_canvas_draw_finish(canvas, &target, &dirty);
 }
 
 /**
@@ -654,35 +615,23 @@ void lv_canvas_draw_line(lv_obj_t * canvas, const lv_point_t * points, uint32_t
  */
 void lv_canvas_draw_polygon(lv_obj_t * canvas, const lv_point_t * points, uint32_t point_cnt, const lv_style_t * style)
 {
-    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
-
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
-
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
-
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
+    if(point_cnt < 3) return;
 
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
 
-    lv_draw_polygon(points, point_cnt, &mask, style, LV_OPA_COVER);
+    lv_draw_polygon(points, point_cnt, mask, style, LV_OPA_COVER);
 
-    lv_refr_set_disp_refreshing(refr_ori);
+    lv_area_t dirty;
+    lv_area_set(&dirty, points[0].x, points[0].y, points[0].x, points[0].y);
+    uint32_t i;
+    for(i = 1; i < point_cnt; i++) {
+        dirty.x1 = LV_MATH_MIN(dirty.x1, points[i].x);
+        dirty.y1 = LV_MATH_MIN(dirty.y1, points[i].y);
+        dirty.x2 = LV_MATH_MAX(dirty.x2, points[i].x);
+        dirty.y2 = LV_MATH_MAX(dirty.y2, points[i].y);
+    }
+    lv_canvas_draw_finish(canvas, &target, &dirty);
 }
 
 /**
@@ -698,35 +647,14 @@ void lv_canvas_draw_polygon(lv_obj_t * canvas, const lv_point_t * points, uint32
 void lv_canvas_draw_arc(lv_obj_t * canvas, lv_coord_t x, lv_coord_t y, lv_coord_t r, int32_t start_angle,
                         int32_t end_angle, const lv_style_t * style)
 {
-    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
-
-    /* Create a dummy display to fool the lv_draw function.
-     * It will think it draws to real screen. */
-    lv_area_t mask;
-    mask.x1 = 0;
-    mask.x2 = dsc->header.w - 1;
-    mask.y1 = 0;
-    mask.y2 = dsc->header.h - 1;
-
-    lv_disp_t disp;
-    memset(&disp, 0, sizeof(lv_disp_t));
+    lv_canvas_target_t target;
+    const lv_area_t * mask = lv_canvas_draw_start(canvas, &target);
 
-    lv_disp_buf_t disp_buf;
-    lv_disp_buf_init(&disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
-    lv_area_copy(&disp_buf.area, &mask);
-
-    lv_disp_drv_init(&disp.driver);
-
-    disp.driver.buffer  = &disp_buf;
-    disp.driver.hor_res = dsc->header.w;
-    disp.driver.ver_res = dsc->header.h;
+    lv_draw_arc(x, y, r, mask, start_angle, end_angle, style, LV_OPA_COVER);
 
-    lv_disp_t * refr_ori = lv_refr_get_disp_refreshing();
-    lv_refr_set_disp_refreshing(&disp);
-
-    lv_draw_arc(x, y, r, &mask, start_angle, end_angle, style, LV_OPA_COVER);
-
-    lv_refr_set_disp_refreshing(refr_ori);
+    lv_area_t dirty;
+    lv_area_set(&dirty, x - r, y - r, x + r, y + r);
+    lv_canvas_draw_finish(canvas, &target, &dirty);
 }
 
 /**********************
@@ -762,4 +690,239 @@ static lv_res_t lv_canvas_signal(lv_obj_t * canvas, lv_signal_t sign, void * par
     return res;
 }
 
+/**
+ * Prepare to draw a primitive to a canvas
+ * @param canvas pointer to a canvas object
+ * @param target redirect the drawing with this if the canvas is not drawn between `lv_canvas_draw_begin/end()`
+ * @return the mask to draw with
+ */
+static const lv_area_t * lv_canvas_draw_start(lv_obj_t * canvas, lv_canvas_target_t * target)
+{
+    if(batch_canvas == canvas) return &batch_target.mask;
+
+    lv_canvas_target_open(canvas, target);
+    return &target->mask;
+}
+
+/**
+ * Finish drawing a primitive to a canvas and invalidate the area where it was drawn
+ * @param canvas pointer to a canvas object
+ * @param target the same as in `lv_canvas_draw_start()`
+ * @param area the area where the primitive was drawn
+ */
+static void lv_canvas_draw_finish(lv_obj_t * canvas, lv_canvas_target_t * target, const lv_area_t * area)
+{
+    if(batch_canvas == canvas) {
+        if(batch_dirty_valid)
+            lv_area_join(&batch_dirty, &batch_dirty, area);
+        else
+            lv_area_copy(&batch_dirty, area);
+        batch_dirty_valid = true;
+        return;
+    }
+
+    lv_canvas_target_close(target);
+    lv_canvas_invalidate_area(canvas, area);
+}
+
+/**
+ * Redirect the drawing to the buffer of a canvas
+ * @param canvas pointer to a canvas object
+ * @param target pointer to a target to initialize
+ */
+static void lv_canvas_target_open(lv_obj_t * canvas, lv_canvas_target_t * target)
+{
+    lv_img_dsc_t * dsc = lv_canvas_get_img(canvas);
+
+    target->mask.x1 = 0;
+    target->mask.x2 = dsc->header.w - 1;
+    target->mask.y1 = 0;
+    target->mask.y2 = dsc->header.h - 1;
+
+    memset(&target->disp, 0, sizeof(lv_disp_t));
+
+    lv_disp_buf_init(&target->disp_buf, (void *)dsc->data, NULL, dsc->header.w * dsc->header.h);
+    lv_area_copy(&target->disp_buf.area, &target->mask);
+
+    lv_disp_drv_init(&target->disp.driver);
+
+    target->disp.driver.buffer  = &target->disp_buf;
+    target->disp.driver.hor_res = dsc->header.w;
+    target->disp.driver.ver_res = dsc->header.h;
+
+    target->disp_ori = lv_refr_get_disp_refreshing();
+    lv_refr_set_disp_refreshing(&target->disp);
+}
+
+/**
+ * Restore the drawing to the display used before `lv_canvas_target_open()`
+ * @param target pointer to an opened target
+ */
+static void lv_canvas_target_close(lv_canvas_target_t * target)
+{
+    lv_refr_set_disp_refreshing(target->disp_ori);
+}
+
+/**
+ * Invalidate an area of a canvas
+ * @param canvas pointer to a canvas object
+ * @param area the area to invalidate relative to the canvas's buffer
+ */
+static void lv_canvas_invalidate_area(lv_obj_t * canvas, const lv_area_t * area)
+{
+    /*With an offset the image is wrapped around so the area might be anywhere*/
+    if(lv_img_get_offset_x(canvas) != 0 || lv_img_get_offset_y(canvas) != 0) {
+        lv_obj_invalidate(canvas);
+        return;
+    }
+
+    lv_area_t area_abs;
+    area_abs.x1 = canvas->coords.x1 + area->x1;
+    area_abs.y1 = canvas->coords.y1 + area->y1;
+    area_abs.x2 = canvas->coords.x1 + area->x2;
+    area_abs.y2 = canvas->coords.y1 + area->y2;
+    if(lv_area_intersect(&area_abs, &area_abs, &canvas->coords) == false) return;
+
+    lv_obj_invalidate_area(canvas, &area_abs);
+}
+
+/**
+ * Get the bilinear filtered color of an image in a point
+ * @param src the image to rotate
+ * @param xs x coordinate in the image [1/256 px]
+ * @param ys y coordinate in the image [1/256 px]
+ * @param color store the color here
+ * @return the opacity in the point
+ */
+static lv_opa_t lv_canvas_rotate_sample(const lv_canvas_rotate_src_t * src, int32_t xs, int32_t ys,
+                                        lv_color_t * color)
+{
+    /*The pixels' center is at 0.5 so get the pixels around the point from there*/
+    int32_t x0 = (xs - 128) >> 8;
+    int32_t y0 = (ys - 128) >> 8;
+    lv_opa_t xr = 255 - ((xs - 128) & 0xFF); /*Ratio of the left pixels*/
+    lv_opa_t yr = 255 - ((ys - 128) & 0xFF); /*Ratio of the top pixels*/
+    int32_t x1 = x0 + 1;
+    int32_t y1 = y0 + 1;
+
+    /*Repeat the pixels of the edges*/
+    int32_t w = src->img->header.w;
+    int32_t h = src->img->header.h;
+    if(x0 < 0) x0 = 0;
+    if(y0 < 0) y0 = 0;
+    if(x1 >= w) x1 = w - 1;
+    if(y1 >= h) y1 = h - 1;
+
+    lv_color_t c00, c10, c01, c11;
+    lv_opa_t opa00, opa10, opa01, opa11;
+    lv_canvas_rotate_get_px(src, x0, y0, &c00, &opa00);
+    lv_canvas_rotate_get_px(src, x1, y0, &c10, &opa10);
+    lv_canvas_rotate_get_px(src, x0, y1, &c01, &opa01);
+    lv_canvas_rotate_get_px(src, x1, y1, &c11, &opa11);
+
+    if(src->alpha == 0 && src->chroma_keyed == 0) {
+        *color = lv_color_mix(lv_color_mix(c00, c10, xr), lv_color_mix(c01, c11, xr), yr);
+        return LV_OPA_COVER;
+    }
+
+    /*Don't mix the color of the transparent pixels. Use the nearest visible instead.*/
+    lv_color_t c_vis = opa00 > LV_OPA_MIN ? c00 : opa10 > LV_OPA_MIN ? c10 : opa01 > LV_OPA_MIN ? c01 : c11;
+    if(opa00 <= LV_OPA_MIN) c00 = c_vis;
+    if(opa10 <= LV_OPA_MIN) c10 = c_vis;
+    if(opa01 <= LV_OPA_MIN) c01 = c_vis;
+    if(opa11 <= LV_OPA_MIN) c11 = c_vis;
+
+    *color = lv_color_mix(lv_color_mix(c00, c10, xr), lv_color_mix(c01, c11, xr), yr);
+
+    uint16_t opa_top    = ((uint16_t)opa00 * xr + (uint16_t)opa10 * (255 - xr)) >> 8;
+    uint16_t opa_bottom = ((uint16_t)opa01 * xr + (uint16_t)opa11 * (255 - xr)) >> 8;
+    return (opa_top * yr + opa_bottom * (255 - yr)) >> 8;
+}
+
+/**
+ * Get the color and opacity of an image's pixel. True color images are read directly.
+ * @param src the image to rotate
+ * @param x x coordinate of the pixel
+ * @param y y coordinate of the pixel
+ * @param color store the color here
+ * @param opa store the opacity here
+ */
+static void lv_canvas_rotate_get_px(const lv_canvas_rotate_src_t * src, int32_t x, int32_t y, lv_color_t * color,
+                                    lv_opa_t * opa)
+{
+    if(src->px_size) {
+        const uint8_t * px = &src->img->data[(y * src->img->header.w + x) * src->px_size];
+        memcpy(color, px, sizeof(lv_color_t));
+        *opa = src->alpha ? px[src->px_size - 1] : LV_OPA_COVER;
+    } else {
+        *color = lv_img_buf_get_px_color(src->img, x, y, src->style);
+        *opa   = src->alpha ? lv_img_buf_get_px_alpha(src->img, x, y) : LV_OPA_COVER;
+    }
+
+    if(src->chroma_keyed) {
+        lv_color_t ct = LV_COLOR_TRANSP;
+        if(color->full == ct.full) *opa = LV_OPA_TRANSP;
+    }
+}
+
+/**
+ * Draw a pixel on a canvas' image considering the opacity of the pixel and the image
+ * @param dsc pointer to the image of the canvas
+ * @param x x coordinate of the pixel
+ * @param y y coordinate of the pixel
+ * @param color color of the pixel
+ * @param opa opacity of the pixel
+ * @param style style of the canvas
+ */
+static void lv_canvas_rotate_blend(lv_img_dsc_t * dsc, int32_t x, int32_t y, lv_color_t color, lv_opa_t opa,
+                                   const lv_style_t * style)
+{
+    /*Opaque pixels can be simply set*/
+    if(opa >= LV_OPA_MAX) {
+        if(dsc->header.cf == LV_IMG_CF_TRUE_COLOR || dsc->header.cf == LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED) {
+            uint8_t * buf_u8 = (uint8_t *)dsc->data;
+            memcpy(&buf_u8[(y * dsc->header.w + x) * sizeof(lv_color_t)], &color, sizeof(lv_color_t));
+            return;
+        }
+
+        lv_img_buf_set_px_color(dsc, x, y, color);
+        if(lv_img_color_format_has_alpha(dsc->header.cf)) lv_img_buf_set_px_alpha(dsc, x, y, LV_OPA_COVER);
+        return;
+    }
+
+    lv_color_t bg_color = lv_img_buf_get_px_color(dsc, x, y, style);
+
+    /*If the canvas has no alpha mix the pixel's color with canvas*/
+    if(lv_img_color_format_has_alpha(dsc->header.cf) == false) {
+        lv_img_buf_set_px_color(dsc, x, y, lv_color_mix(color, bg_color, opa));
+        return;
+    }
+
+    /*Both the pixel and canvas has alpha channel. Some extra calculation is required*/
+    lv_opa_t bg_opa = lv_img_buf_get_px_alpha(dsc, x, y);
+
+    /*Pick the foreground if the background is fully transparent*/
+    if(bg_opa <= LV_OPA_MIN) {
+        lv_img_buf_set_px_color(dsc, x, y, color);
+        lv_img_buf_set_px_alpha(dsc, x, y, opa);
+    }
+    /*Opaque background: use simple mix*/
+    else if(bg_opa >= LV_OPA_MAX) {
+        lv_img_buf_set_px_color(dsc, x, y, lv_color_mix(color, bg_color, opa));
+    }
+    /*Both colors have alpha. Expensive calculation need to be applied*/
+    else {
+        /*Info:
+         * https://en.wikipedia.org/wiki/Alpha_compositing#Analytical_derivation_of_the_over_operator*/
+        lv_opa_t opa_res = 255 - ((uint16_t)((uint16_t)(255 - opa) * (255 - bg_opa)) >> 8);
+        if(opa_res == 0) {
+            opa_res = 1; /*never happens, just to be sure*/
+        }
+        lv_opa_t ratio = (uint16_t)((uint16_t)opa * 255) / opa_res;
+
+        lv_img_buf_set_px_color(dsc, x, y, lv_color_mix(color, bg_color, ratio));
+        lv_img_buf_set_px_alpha(dsc, x, y, opa_res);
+    }
+}
+
 #endif
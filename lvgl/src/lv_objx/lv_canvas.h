@@ -27,6 +27,8 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+#define LV_CANVAS_ZOOM_NONE 256 /*Zoom factor of the original size*/
+#define LV_CANVAS_ZOOM_MIN 16   /*Smaller zoom factors are handled as this*/
 
 /**********************
  *      TYPEDEFS
@@ -165,6 +167,23 @@ void lv_canvas_copy_buf(lv_obj_t * canvas, const void * to_copy, lv_coord_t x, l
 void lv_canvas_rotate(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, lv_coord_t offset_x, lv_coord_t offset_y,
                       int32_t pivot_x, int32_t pivot_y);
 
+/**
+ * Rotate and zoom an image and store the result on a canvas. The pixels are bilinear filtered.
+ * @param canvas pointer to a canvas object
+ * @param img pointer to an image descriptor.
+ *             Can be the image descriptor of an other canvas too (`lv_canvas_get_img()`).
+ * @param angle the angle of rotation (0..360);
+ * @param zoom the zoom factor: `LV_CANVAS_ZOOM_NONE` (256): no zoom, 128: half size, 512: double size
+ * @param offset_x offset X to tell where to put the result data on destination canvas
+ * @param offset_y offset X to tell where to put the result data on destination canvas
+ * @param pivot_x pivot X of rotation and zoom. Relative to the source canvas
+ *                Set to `source width / 2` to rotate around the center
+ * @param pivot_y pivot Y of rotation and zoom. Relative to the source canvas
+ *                Set to `source height / 2` to rotate around the center
+ */
+void lv_canvas_rotate_zoom(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, uint16_t zoom, lv_coord_t offset_x,
+                           lv_coord_t offset_y, int32_t pivot_x, int32_t pivot_y);
+
 /**
  * Fill the canvas with color
  * @param canvas pointer to a canvas
@@ -172,6 +191,20 @@ void lv_canvas_rotate(lv_obj_t * canvas, lv_img_dsc_t * img, int16_t angle, lv_c
  */
 void lv_canvas_fill_bg(lv_obj_t * canvas, lv_color_t color);
 
+/**
+ * Start drawing many primitives to a canvas.
+ * The drawing is redirected to the canvas only once and the drawn area is invalidated in `lv_canvas_draw_end()`.
+ * Only one canvas can be drawn like this at a time and `lv_task_handler()` shouldn't be called until the end.
+ * @param canvas pointer to a canvas object
+ */
+void lv_canvas_draw_begin(lv_obj_t * canvas);
+
+/**
+ * Finish drawing the primitives started with `lv_canvas_draw_begin()` and invalidate the area they cover
+ * @param canvas pointer to a canvas object
+ */
+void lv_canvas_draw_end(lv_obj_t * canvas);
+
 /**
  * Draw a rectangle on the canvas
  * @param canvas pointer to a canvas object
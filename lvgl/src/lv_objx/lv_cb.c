@@ -11,6 +11,7 @@
 
 #include "../lv_core/lv_group.h"
 #include "../lv_themes/lv_theme.h"
+#include "../lv_misc/lv_thread.h"
 
 /*********************
  *      DEFINES
@@ -232,7 +233,9 @@ static bool lv_cb_design(lv_obj_t * cb, const lv_area_t * mask, lv_design_mode_t
         lv_btn_ext_t * bullet_ext = lv_obj_get_ext_attr(cb_ext->bullet);
 
         /*Be sure the state of the bullet is the same as the parent button*/
+        lv_thread_lock();
         bullet_ext->state = cb_ext->bg_btn.state;
+        lv_thread_unlock();
 
         result = ancestor_bg_design(cb, mask, mode);
 
@@ -262,22 +265,23 @@ static bool lv_bullet_design(lv_obj_t * bullet, const lv_area_t * mask, lv_desig
         /* If the check box is the active in a group and
          * the background is not visible (transparent)
          * then activate the style of the bullet*/
-        const lv_style_t * style_ori  = lv_obj_get_style(bullet);
         lv_obj_t * bg                 = lv_obj_get_parent(bullet);
         const lv_style_t * style_page = lv_obj_get_style(bg);
         lv_group_t * g                = lv_obj_get_group(bg);
-        if(style_page->body.opa == LV_OPA_TRANSP) { /*Is the Background visible?*/
-            if(lv_group_get_focused(g) == bg) {
-                lv_style_t * style_mod;
-                style_mod       = lv_group_mod_style(g, style_ori);
-                bullet->style_p = style_mod; /*Temporally change the style to the activated */
-            }
+        if(style_page->body.opa == LV_OPA_TRANSP && lv_group_get_focused(g) == bg) { /*Is the Background visible?*/
+            /*Other drawing threads have to wait until the style is reverted*/
+            lv_thread_lock();
+            const lv_style_t * style_ori = bullet->style_p;
+            lv_style_t * style_mod       = lv_group_mod_style(g, lv_obj_get_style(bullet));
+            bullet->style_p              = style_mod; /*Temporally change the style to the activated */
+            ancestor_bullet_design(bullet, mask, mode);
+            bullet->style_p = style_ori; /*Revert the style*/
+            lv_thread_unlock();
+        } else {
+            ancestor_bullet_design(bullet, mask, mode);
         }
-#endif
+#else
         ancestor_bullet_design(bullet, mask, mode);
-
-#if LV_USE_GROUP
-        bullet->style_p = style_ori; /*Revert the style*/
 #endif
     } else if(mode == LV_DESIGN_DRAW_POST) {
         ancestor_bullet_design(bullet, mask, mode);
@@ -25,6 +25,14 @@
 #define LV_CHART_AXIS_MAJOR_TICK_LEN_COE 1 / 15
 #define LV_CHART_AXIS_MINOR_TICK_LEN_COE 2 / 3
 
+#if LV_CHART_RING_SERIES
+#define LV_CHART_IS_RING(ser) ((ser)->ring_cnt != 0)
+#define LV_CHART_SER_POINT_CNT(ext, ser) ((ser)->ring_cnt != 0 ? (ser)->ring_cnt : (ext)->point_cnt)
+#else
+#define LV_CHART_IS_RING(ser) false
+#define LV_CHART_SER_POINT_CNT(ext, ser) ((ext)->point_cnt)
+#endif
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -41,9 +49,16 @@ static void lv_chart_draw_cols(lv_obj_t * chart, const lv_area_t * mask);
 static void lv_chart_draw_vertical_lines(lv_obj_t * chart, const lv_area_t * mask);
 static void lv_chart_draw_areas(lv_obj_t * chart, const lv_area_t * mask);
 static void lv_chart_draw_axes(lv_obj_t * chart, const lv_area_t * mask);
+static void lv_chart_draw_series(lv_obj_t * chart, const lv_area_t * mask);
+static void lv_chart_inv_static(lv_obj_t * chart);
 static void lv_chart_inv_lines(lv_obj_t * chart, uint16_t i);
 static void lv_chart_inv_points(lv_obj_t * chart, uint16_t i);
 static void lv_chart_inv_cols(lv_obj_t * chart, uint16_t i);
+#if LV_CHART_RING_SERIES
+static void lv_chart_draw_rings(lv_obj_t * chart, const lv_area_t * mask);
+static void lv_chart_ring_append(lv_obj_t * chart, lv_chart_series_t * ser, const lv_coord_t y_array[], uint32_t cnt);
+static void lv_chart_inv_ring(lv_obj_t * chart, uint32_t n, uint32_t first, uint32_t last);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -173,6 +188,10 @@ lv_chart_series_t * lv_chart_add_series(lv_obj_t * chart, lv_color_t color)
     }
 
     ser->start_point = 0;
+#if LV_CHART_RING_SERIES
+    ser->ring_cnt   = 0;
+    ser->ring_start = 0;
+#endif
 
     uint16_t i;
     lv_coord_t * p_tmp = ser->points;
@@ -186,6 +205,50 @@ lv_chart_series_t * lv_chart_add_series(lv_obj_t * chart, lv_color_t color)
     return ser;
 }
 
+#if LV_CHART_RING_SERIES
+/**
+ * Allocate and add a data series with its own number of points kept in a ring buffer.
+ * `lv_chart_set_next` overwrites the oldest point in O(1) and only the columns which got new data are invalidated
+ * in `LV_CHART_UPDATE_MODE_CIRCULAR` mode. If there are more points than pixels the series is drawn
+ * as a min/max envelope per pixel column. Ring series are always drawn as lines, whatever the chart type.
+ * @param chart pointer to a chart object
+ * @param color color of the data series
+ * @param point_cnt number of points in the series (at least 2)
+ * @return pointer to the allocated data series or NULL if it doesn't fit in the memory
+ */
+lv_chart_series_t * lv_chart_add_ring_series(lv_obj_t * chart, lv_color_t color, uint32_t point_cnt)
+{
+    lv_chart_ext_t * ext    = lv_obj_get_ext_attr(chart);
+    lv_chart_series_t * ser = lv_ll_ins_head(&ext->series_ll);
+    lv_mem_assert(ser);
+    if(ser == NULL) return NULL;
+
+    if(point_cnt < 2) point_cnt = 2;
+
+    ser->color  = color;
+    ser->points = lv_mem_alloc(sizeof(lv_coord_t) * point_cnt);
+    lv_mem_assert(ser->points);
+    if(ser->points == NULL) {
+        lv_ll_rem(&ext->series_ll, ser);
+        lv_mem_free(ser);
+        return NULL;
+    }
+
+    ser->start_point = 0;
+    ser->ring_cnt    = point_cnt;
+    ser->ring_start  = 0;
+
+    uint32_t i;
+    for(i = 0; i < point_cnt; i++) {
+        ser->points[i] = LV_CHART_POINT_DEF;
+    }
+
+    ext->series.num++;
+
+    return ser;
+}
+#endif
+
 /**
  * Clear the point of a serie
  * @param chart pointer to a chart object
@@ -197,12 +260,16 @@ void lv_chart_clear_serie(lv_obj_t * chart, lv_chart_series_t * serie)
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
     if(ext == NULL) return;
 
+    uint32_t point_cnt = LV_CHART_SER_POINT_CNT(ext, serie);
     uint32_t i;
-    for(i = 0; i < ext->point_cnt; i++) {
+    for(i = 0; i < point_cnt; i++) {
         serie->points[i] = LV_CHART_POINT_DEF;
     }
 
     serie->start_point = 0;
+#if LV_CHART_RING_SERIES
+    serie->ring_start = 0;
+#endif
 }
 
 /*=====================
@@ -223,7 +290,7 @@ void lv_chart_set_div_line_count(lv_obj_t * chart, uint8_t hdiv, uint8_t vdiv)
     ext->hdiv_cnt = hdiv;
     ext->vdiv_cnt = vdiv;
 
-    lv_obj_invalidate(chart);
+    lv_chart_inv_static(chart);
 }
 
 /**
@@ -277,6 +344,8 @@ void lv_chart_set_point_count(lv_obj_t * chart, uint16_t point_cnt)
 
     LV_LL_READ_BACK(ext->series_ll, ser)
     {
+        if(LV_CHART_IS_RING(ser)) continue; /*They keep their own point count*/
+
         if(ser->start_point != 0) {
             lv_coord_t * new_points = lv_mem_alloc(sizeof(lv_coord_t) * point_cnt);
             lv_mem_assert(new_points);
@@ -370,11 +439,15 @@ void lv_chart_set_series_darking(lv_obj_t * chart, lv_opa_t dark_eff)
 void lv_chart_init_points(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y)
 {
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
-    uint16_t i;
-    for(i = 0; i < ext->point_cnt; i++) {
+    uint32_t point_cnt   = LV_CHART_SER_POINT_CNT(ext, ser);
+    uint32_t i;
+    for(i = 0; i < point_cnt; i++) {
         ser->points[i] = y;
     }
     ser->start_point = 0;
+#if LV_CHART_RING_SERIES
+    ser->ring_start = 0;
+#endif
     lv_chart_refresh(chart);
 }
 
@@ -387,8 +460,11 @@ void lv_chart_init_points(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t
 void lv_chart_set_points(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y_array[])
 {
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
-    memcpy(ser->points, y_array, ext->point_cnt * (sizeof(lv_coord_t)));
+    memcpy(ser->points, y_array, LV_CHART_SER_POINT_CNT(ext, ser) * (sizeof(lv_coord_t)));
     ser->start_point = 0;
+#if LV_CHART_RING_SERIES
+    ser->ring_start = 0;
+#endif
     lv_chart_refresh(chart);
 }
 
@@ -400,6 +476,13 @@ void lv_chart_set_points(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y
  */
 void lv_chart_set_next(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y)
 {
+#if LV_CHART_RING_SERIES
+    if(ser->ring_cnt != 0) {
+        lv_chart_ring_append(chart, ser, &y, 1);
+        return;
+    }
+#endif
+
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
     if(ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT) {
         ser->points[ser->start_point] =
@@ -419,6 +502,39 @@ void lv_chart_set_next(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y)
     }
 }
 
+#if LV_CHART_RING_SERIES
+/**
+ * Add more data to a data line at once, like calling `lv_chart_set_next` for each but invalidating only once
+ * @param chart pointer to chart object
+ * @param ser pointer to a data series on 'chart'
+ * @param y_array the new values, the oldest first
+ * @param cnt number of values in `y_array`
+ */
+void lv_chart_set_next_array(lv_obj_t * chart, lv_chart_series_t * ser, const lv_coord_t y_array[], uint32_t cnt)
+{
+    if(cnt == 0) return;
+
+    if(ser->ring_cnt != 0) {
+        lv_chart_ring_append(chart, ser, y_array, cnt);
+        return;
+    }
+
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+    uint32_t i;
+    if(ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT) {
+        for(i = 0; i < cnt; i++) {
+            ser->points[ser->start_point] = y_array[i];
+            ser->start_point              = (ser->start_point + 1) % ext->point_cnt;
+        }
+        lv_chart_refresh(chart);
+    } else {
+        for(i = 0; i < cnt; i++) {
+            lv_chart_set_next(chart, ser, y_array[i]);
+        }
+    }
+}
+#endif
+
 /**
  * Set update mode of the chart object.
  * @param chart pointer to a chart object
@@ -446,6 +562,8 @@ void lv_chart_set_x_tick_length(lv_obj_t * chart, uint8_t major_tick_len, uint8_
     lv_chart_ext_t * ext       = lv_obj_get_ext_attr(chart);
     ext->x_axis.major_tick_len = major_tick_len;
     ext->x_axis.minor_tick_len = minor_tick_len;
+
+    lv_chart_inv_static(chart);
 }
 
 /**
@@ -461,6 +579,8 @@ void lv_chart_set_y_tick_length(lv_obj_t * chart, uint8_t major_tick_len, uint8_
     lv_chart_ext_t * ext       = lv_obj_get_ext_attr(chart);
     ext->y_axis.major_tick_len = major_tick_len;
     ext->y_axis.minor_tick_len = minor_tick_len;
+
+    lv_chart_inv_static(chart);
 }
 
 /**
@@ -478,6 +598,8 @@ void lv_chart_set_x_tick_texts(lv_obj_t * chart, const char * list_of_values, ui
     ext->x_axis.num_tick_marks = num_tick_marks;
     ext->x_axis.list_of_values = list_of_values;
     ext->x_axis.options        = options;
+
+    lv_chart_inv_static(chart);
 }
 
 /**
@@ -495,6 +617,8 @@ void lv_chart_set_y_tick_texts(lv_obj_t * chart, const char * list_of_values, ui
     ext->y_axis.num_tick_marks = num_tick_marks;
     ext->y_axis.list_of_values = list_of_values;
     ext->y_axis.options        = options;
+
+    lv_chart_inv_static(chart);
 }
 
 /**
@@ -507,6 +631,7 @@ void lv_chart_set_margin(lv_obj_t * chart, uint16_t margin)
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
     ext->margin          = margin;
     lv_obj_refresh_ext_draw_pad(chart);
+    lv_chart_inv_static(chart);
 }
 
 /*=====================
@@ -604,6 +729,9 @@ uint16_t lv_chart_get_margin(lv_obj_t * chart)
  *                                  (return 'true' if yes)
  *             LV_DESIGN_DRAW: draw the object (always return 'true')
  *             LV_DESIGN_DRAW_POST: drawing after every children are drawn
+ *             LV_DESIGN_DRAW_STATIC: draw the background, the division lines and the axes
+ *                                    (cached by `lv_obj_set_layer_static`)
+ *             LV_DESIGN_DRAW_DYNAMIC: draw the series on them
  * @param return true/false, depends on 'mode'
  */
 static bool lv_chart_design(lv_obj_t * chart, const lv_area_t * mask, lv_design_mode_t mode)
@@ -614,18 +742,16 @@ static bool lv_chart_design(lv_obj_t * chart, const lv_area_t * mask, lv_design_
     } else if(mode == LV_DESIGN_DRAW_MAIN) {
         /*Draw the background*/
         lv_draw_rect(&chart->coords, mask, lv_obj_get_style(chart), lv_obj_get_opa_scale(chart));
-
-        lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
-
         lv_chart_draw_div(chart, mask);
-
-        if(ext->type & LV_CHART_TYPE_LINE) lv_chart_draw_lines(chart, mask);
-        if(ext->type & LV_CHART_TYPE_COLUMN) lv_chart_draw_cols(chart, mask);
-        if(ext->type & LV_CHART_TYPE_POINT) lv_chart_draw_points(chart, mask);
-        if(ext->type & LV_CHART_TYPE_VERTICAL_LINE) lv_chart_draw_vertical_lines(chart, mask);
-        if(ext->type & LV_CHART_TYPE_AREA) lv_chart_draw_areas(chart, mask);
-
+        lv_chart_draw_series(chart, mask);
+        lv_chart_draw_axes(chart, mask);
+    } else if(mode == LV_DESIGN_DRAW_STATIC) {
+        /*The axes go below the series here but they are mostly on the margin*/
+        lv_draw_rect(&chart->coords, mask, lv_obj_get_style(chart), lv_obj_get_opa_scale(chart));
+        lv_chart_draw_div(chart, mask);
         lv_chart_draw_axes(chart, mask);
+    } else if(mode == LV_DESIGN_DRAW_DYNAMIC) {
+        lv_chart_draw_series(chart, mask);
     }
     return true;
 }
@@ -662,6 +788,8 @@ static lv_res_t lv_chart_signal(lv_obj_t * chart, lv_signal_t sign, void * param
     } else if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         /*Provide extra px draw area around the chart*/
         chart->ext_draw_pad = ext->margin;
+    } else if(sign == LV_SIGNAL_STYLE_CHG) {
+        lv_chart_inv_static(chart);
     }
 
     return res;
@@ -738,14 +866,11 @@ static void lv_chart_draw_lines(lv_obj_t * chart, const lv_area_t * mask)
     lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
 
     uint16_t i;
-    lv_point_t p1;
-    lv_point_t p2;
     lv_coord_t w     = lv_obj_get_width(chart);
     lv_coord_t h     = lv_obj_get_height(chart);
     lv_coord_t x_ofs = chart->coords.x1;
     lv_coord_t y_ofs = chart->coords.y1;
     int32_t y_tmp;
-    lv_coord_t p_prev;
     lv_coord_t p_act;
     lv_chart_series_t * ser;
     lv_opa_t opa_scale = lv_obj_get_opa_scale(chart);
@@ -754,39 +879,42 @@ static void lv_chart_draw_lines(lv_obj_t * chart, const lv_area_t * mask)
     style.line.opa   = ext->series.opa;
     style.line.width = ext->series.width;
 
+    /*The points of a series without gaps are drawn as one polyline*/
+    lv_draw_scratch_mark_t mark;
+    lv_draw_scratch_mark(&mark);
+    lv_point_t * points = lv_draw_scratch_alloc(ext->point_cnt * sizeof(lv_point_t));
+    if(points == NULL) return;
+
     /*Go through all data lines*/
     LV_LL_READ_BACK(ext->series_ll, ser)
     {
+        if(LV_CHART_IS_RING(ser)) continue;
         style.line.color = ser->color;
 
         lv_coord_t start_point = ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->start_point : 0;
+        uint16_t run_cnt = 0;
 
-        p1.x = 0 + x_ofs;
-        p2.x = 0 + x_ofs;
-
-        p_prev = start_point;
-        y_tmp  = (int32_t)((int32_t)ser->points[p_prev] - ext->ymin) * h;
-        y_tmp  = y_tmp / (ext->ymax - ext->ymin);
-        p2.y   = h - y_tmp + y_ofs;
-
-        for(i = 1; i < ext->point_cnt; i++) {
-            p1.x = p2.x;
-            p1.y = p2.y;
-
-            p2.x = ((w * i) / (ext->point_cnt - 1)) + x_ofs;
-
+        for(i = 0; i < ext->point_cnt; i++) {
             p_act = (start_point + i) % ext->point_cnt;
 
+            if(ser->points[p_act] == LV_CHART_POINT_DEF) {
+                if(run_cnt > 1) lv_draw_polyline(points, run_cnt, mask, &style, opa_scale);
+                run_cnt = 0;
+                continue;
+            }
+
             y_tmp = (int32_t)((int32_t)ser->points[p_act] - ext->ymin) * h;
             y_tmp = y_tmp / (ext->ymax - ext->ymin);
-            p2.y  = h - y_tmp + y_ofs;
 
-            if(ser->points[p_prev] != LV_CHART_POINT_DEF && ser->points[p_act] != LV_CHART_POINT_DEF)
-                lv_draw_line(&p1, &p2, mask, &style, opa_scale);
-
-            p_prev = p_act;
+            points[run_cnt].x = (ext->point_cnt > 1 ? (w * i) / (ext->point_cnt - 1) : 0) + x_ofs;
+            points[run_cnt].y = h - y_tmp + y_ofs;
+            run_cnt++;
         }
+
+        if(run_cnt > 1) lv_draw_polyline(points, run_cnt, mask, &style, opa_scale);
     }
+
+    lv_draw_scratch_release(&mark);
 }
 
 /**
@@ -820,6 +948,7 @@ static void lv_chart_draw_points(lv_obj_t * chart, const lv_area_t * mask)
 
     LV_LL_READ_BACK(ext->series_ll, ser)
     {
+        if(LV_CHART_IS_RING(ser)) continue;
         lv_coord_t start_point = ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->start_point : 0;
 
         style_point.body.main_color = ser->color;
@@ -889,6 +1018,7 @@ static void lv_chart_draw_cols(lv_obj_t * chart, const lv_area_t * mask)
             col_a.x2 = col_a.x1 + col_w;
             x_act += col_w;
 
+            if(LV_CHART_IS_RING(ser)) continue;
             if(col_a.x2 < mask->x1) continue;
             if(col_a.x1 > mask->x2) break;
 
@@ -941,6 +1071,7 @@ static void lv_chart_draw_vertical_lines(lv_obj_t * chart, const lv_area_t * mas
     /*Go through all data lines*/
     LV_LL_READ_BACK(ext->series_ll, ser)
     {
+        if(LV_CHART_IS_RING(ser)) continue;
         lv_coord_t start_point = ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->start_point : 0;
         style.line.color       = ser->color;
 
@@ -999,6 +1130,7 @@ static void lv_chart_draw_areas(lv_obj_t * chart, const lv_area_t * mask)
     /*Go through all data lines*/
     LV_LL_READ_BACK(ext->series_ll, ser)
     {
+        if(LV_CHART_IS_RING(ser)) continue;
         lv_coord_t start_point = ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->start_point : 0;
         style.body.main_color  = ser->color;
         style.body.opa         = ext->series.opa;
@@ -1022,15 +1154,15 @@ static void lv_chart_draw_areas(lv_obj_t * chart, const lv_area_t * mask)
             p2.y  = h - y_tmp + y_ofs;
 
             if(ser->points[p_prev] != LV_CHART_POINT_DEF && ser->points[p_act] != LV_CHART_POINT_DEF) {
-                lv_point_t triangle_points[3];
-                triangle_points[0]   = p1;
-                triangle_points[1]   = p2;
-                triangle_points[2].x = p1.x;
-                triangle_points[2].y = chart->coords.y2;
-                lv_draw_triangle(triangle_points, mask, &style, opa_scale);
-                triangle_points[2].x = p2.x;
-                triangle_points[0].y = chart->coords.y2;
-                lv_draw_triangle(triangle_points, mask, &style, opa_scale);
+                /*The polygon's points are on the pixel corners so the bottom is after the last row*/
+                lv_point_t area_points[4];
+                area_points[0]   = p1;
+                area_points[1]   = p2;
+                area_points[2].x = p2.x;
+                area_points[2].y = chart->coords.y2 + 1;
+                area_points[3].x = p1.x;
+                area_points[3].y = chart->coords.y2 + 1;
+                lv_draw_polygon(area_points, 4, mask, &style, opa_scale);
             }
             p_prev = p_act;
         }
@@ -1138,7 +1270,7 @@ static void lv_chart_draw_y_ticks(lv_obj_t * chart, const lv_area_t * mask)
                     /* set the area at some distance of the major tick len left of the tick */
                     lv_area_t a = {(p2.x - size.x - LV_CHART_AXIS_TO_LABEL_DISTANCE), (p2.y - size.y / 2),
                                    (p2.x - LV_CHART_AXIS_TO_LABEL_DISTANCE), (p2.y + size.y / 2)};
-                    lv_draw_label(&a, mask, style, opa_scale, buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL);
+                    lv_draw_label(&a, mask, style, opa_scale, buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL, NULL);
                 }
             }
 
@@ -1246,7 +1378,7 @@ static void lv_chart_draw_x_ticks(lv_obj_t * chart, const lv_area_t * mask)
                     /* set the area at some distance of the major tick len under of the tick */
                     lv_area_t a = {(p2.x - size.x / 2), (p2.y + LV_CHART_AXIS_TO_LABEL_DISTANCE), (p2.x + size.x / 2),
                                    (p2.y + size.y + LV_CHART_AXIS_TO_LABEL_DISTANCE)};
-                    lv_draw_label(&a, mask, style, opa_scale, buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL);
+                    lv_draw_label(&a, mask, style, opa_scale, buf, LV_TXT_FLAG_CENTER, NULL, -1, -1, NULL, NULL);
                 }
             }
         }
@@ -1259,6 +1391,39 @@ static void lv_chart_draw_axes(lv_obj_t * chart, const lv_area_t * mask)
     lv_chart_draw_x_ticks(chart, mask);
 }
 
+/**
+ * Draw the series of a chart with its type
+ * @param chart pointer to chart object
+ * @param mask mask, inherited from the design function
+ */
+static void lv_chart_draw_series(lv_obj_t * chart, const lv_area_t * mask)
+{
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+
+    if(ext->type & LV_CHART_TYPE_LINE) lv_chart_draw_lines(chart, mask);
+    if(ext->type & LV_CHART_TYPE_COLUMN) lv_chart_draw_cols(chart, mask);
+    if(ext->type & LV_CHART_TYPE_POINT) lv_chart_draw_points(chart, mask);
+    if(ext->type & LV_CHART_TYPE_VERTICAL_LINE) lv_chart_draw_vertical_lines(chart, mask);
+    if(ext->type & LV_CHART_TYPE_AREA) lv_chart_draw_areas(chart, mask);
+#if LV_CHART_RING_SERIES
+    if(ext->type != LV_CHART_TYPE_NONE) lv_chart_draw_rings(chart, mask);
+#endif
+}
+
+/**
+ * Redraw a chart whose background, division lines or axes changed.
+ * Their bitmap is drawn again if it's cached (see `lv_obj_set_layer_static`).
+ * @param chart pointer to chart object
+ */
+static void lv_chart_inv_static(lv_obj_t * chart)
+{
+#if LV_USE_LAYER_CACHE
+    lv_obj_outdate_layer(chart);
+#else
+    lv_obj_invalidate(chart);
+#endif
+}
+
 /**
  * invalid area of the new line data lines on a chart
  * @param obj pointer to chart object
@@ -1276,13 +1441,13 @@ static void lv_chart_inv_lines(lv_obj_t * chart, uint16_t i)
         if(i < ext->point_cnt - 1) {
             coords.x1 = ((w * i) / (ext->point_cnt - 1)) + x_ofs - ext->series.width;
             coords.x2 = ((w * (i + 1)) / (ext->point_cnt - 1)) + x_ofs + ext->series.width;
-            lv_inv_area(lv_obj_get_disp(chart), &coords);
+            lv_inv_area_by(lv_obj_get_disp(chart), &coords, chart);
         }
 
         if(i > 0) {
             coords.x1 = ((w * (i - 1)) / (ext->point_cnt - 1)) + x_ofs - ext->series.width;
             coords.x2 = ((w * i) / (ext->point_cnt - 1)) + x_ofs + ext->series.width;
-            lv_inv_area(lv_obj_get_disp(chart), &coords);
+            lv_inv_area_by(lv_obj_get_disp(chart), &coords, chart);
         }
     }
 }
@@ -1305,7 +1470,7 @@ static void lv_chart_inv_points(lv_obj_t * chart, uint16_t i)
     cir_a.x2 = cir_a.x1 + ext->series.width;
     cir_a.x1 -= ext->series.width;
 
-    lv_inv_area(lv_obj_get_disp(chart), &cir_a);
+    lv_inv_area_by(lv_obj_get_disp(chart), &cir_a, chart);
 }
 
 /**
@@ -1331,7 +1496,206 @@ static void lv_chart_inv_cols(lv_obj_t * chart, uint16_t i)
     col_a.x1 = x_act;
     col_a.x2 = col_a.x1 + col_w;
 
-    lv_inv_area(lv_obj_get_disp(chart), &col_a);
+    lv_inv_area_by(lv_obj_get_disp(chart), &col_a, chart);
+}
+
+#if LV_CHART_RING_SERIES
+/**
+ * Get the pixel column of a point of a ring series
+ * @param p index of the point from the left
+ * @param n number of points in the series
+ * @param w width of the chart
+ * @return the column, relative to the left of the chart
+ */
+static lv_coord_t lv_chart_ring_col(uint32_t p, uint32_t n, lv_coord_t w)
+{
+    return (lv_coord_t)(((uint64_t)p * w) / (n - 1));
+}
+
+/**
+ * Get the first point of a ring series in a pixel column
+ * @param c the column, relative to the left of the chart
+ * @param n number of points in the series
+ * @param w width of the chart
+ * @return index of the point from the left or `n` if the column is right to the last point
+ */
+static uint32_t lv_chart_ring_first(lv_coord_t c, uint32_t n, lv_coord_t w)
+{
+    uint64_t p = ((uint64_t)c * (n - 1) + w - 1) / w;
+    return p > n ? n : (uint32_t)p;
+}
+
+/**
+ * Get the y coordinate of a value on a chart
+ * @param chart pointer to chart object
+ * @param v the value
+ * @return the absolute y coordinate
+ */
+static lv_coord_t lv_chart_ring_y(lv_obj_t * chart, lv_coord_t v)
+{
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+    lv_coord_t h         = lv_obj_get_height(chart);
+
+    int32_t y_tmp = (int32_t)((int32_t)v - ext->ymin) * h;
+    y_tmp         = y_tmp / (ext->ymax - ext->ymin);
+    return h - y_tmp + chart->coords.y1;
+}
+
+/**
+ * Draw the ring series as lines. Only the points in the columns of the mask are visited and
+ * the points of a column are drawn as a vertical line from their minimum to their maximum.
+ * @param chart pointer to chart object
+ * @param mask mask, inherited from the design function
+ */
+static void lv_chart_draw_rings(lv_obj_t * chart, const lv_area_t * mask)
+{
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+
+    lv_coord_t w     = lv_obj_get_width(chart);
+    lv_coord_t x_ofs = chart->coords.x1;
+    lv_chart_series_t * ser;
+    lv_opa_t opa_scale = lv_obj_get_opa_scale(chart);
+    lv_style_t style;
+    lv_style_copy(&style, &lv_style_plain);
+    style.line.opa   = ext->series.opa;
+    style.line.width = ext->series.width;
+
+    if(w <= 0) return;
+
+    /*The lines of the columns next to the mask can reach into it*/
+    lv_coord_t c_start = mask->x1 - x_ofs - ext->series.width;
+    lv_coord_t c_end   = mask->x2 - x_ofs + ext->series.width;
+    if(c_start < 0) c_start = 0;
+    if(c_end > w) c_end = w;
+    if(c_start > c_end) return;
+
+    /*Go through all ring series*/
+    LV_LL_READ_BACK(ext->series_ll, ser)
+    {
+        if(ser->ring_cnt == 0) continue;
+
+        style.line.color = ser->color;
+
+        uint32_t n     = ser->ring_cnt;
+        uint32_t start = ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT ? ser->ring_start : 0;
+
+        /*Start one point left to the columns and end one right to them for the lines crossing the edges*/
+        uint32_t p     = lv_chart_ring_first(c_start, n, w);
+        uint32_t p_end = lv_chart_ring_first(c_end + 1, n, w);
+        if(p > 0) p--;
+        if(p_end < n) p_end++;
+
+        uint32_t idx = p >= n - start ? p - (n - start) : p + start;
+        lv_coord_t y_prev = LV_CHART_POINT_DEF;
+        lv_point_t p1;
+        lv_point_t p2;
+
+        while(p < p_end) {
+            lv_coord_t c     = lv_chart_ring_col(p, n, w);
+            uint32_t col_end = lv_chart_ring_first(c + 1, n, w);
+            if(col_end > p_end) col_end = p_end;
+
+            p2.x = c + x_ofs;
+
+            /*Connect the first point of the column to the last of the previous*/
+            lv_coord_t y_act = ser->points[idx];
+            if(y_prev != LV_CHART_POINT_DEF && y_act != LV_CHART_POINT_DEF) {
+                p2.y = lv_chart_ring_y(chart, y_act);
+                lv_draw_line(&p1, &p2, mask, &style, opa_scale);
+            }
+
+            /*Get the envelope of the column*/
+            lv_coord_t y_min = LV_COORD_MAX;
+            lv_coord_t y_max = LV_COORD_MIN;
+            for(; p < col_end; p++) {
+                y_act = ser->points[idx];
+                idx++;
+                if(idx == n) idx = 0;
+
+                if(y_act == LV_CHART_POINT_DEF) continue;
+                if(y_act < y_min) y_min = y_act;
+                if(y_act > y_max) y_max = y_act;
+            }
+
+            if(y_min < y_max) {
+                p1.x = p2.x;
+                p1.y = lv_chart_ring_y(chart, y_max);
+                p2.y = lv_chart_ring_y(chart, y_min);
+                lv_draw_line(&p1, &p2, mask, &style, opa_scale);
+            }
+
+            y_prev = y_act;
+            if(y_prev != LV_CHART_POINT_DEF) {
+                p1.x = p2.x;
+                p1.y = lv_chart_ring_y(chart, y_prev);
+            }
+        }
+    }
 }
 
+/**
+ * Write new values into a ring series and invalidate the area they change
+ * @param chart pointer to chart object
+ * @param ser pointer to a ring series on 'chart'
+ * @param y_array the new values, the oldest first
+ * @param cnt number of values in `y_array`
+ */
+static void lv_chart_ring_append(lv_obj_t * chart, lv_chart_series_t * ser, const lv_coord_t y_array[], uint32_t cnt)
+{
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+    uint32_t n           = ser->ring_cnt;
+
+    /*Only the last `n` values remain*/
+    uint32_t skip  = cnt > n ? cnt - n : 0;
+    uint32_t first = (uint32_t)(((uint64_t)ser->ring_start + skip) % n);
+    y_array += skip;
+    cnt -= skip;
+
+    uint32_t part = n - first;
+    if(part > cnt) part = cnt;
+    memcpy(&ser->points[first], y_array, part * sizeof(lv_coord_t));
+    if(cnt > part) memcpy(ser->points, &y_array[part], (cnt - part) * sizeof(lv_coord_t));
+
+    ser->ring_start = cnt > n - first ? cnt - (n - first) : first + cnt;
+    if(ser->ring_start == n) ser->ring_start = 0;
+
+    if(ext->update_mode == LV_CHART_UPDATE_MODE_SHIFT) {
+        /*Every point moves to the left*/
+        lv_chart_refresh(chart);
+    } else if(cnt == n) {
+        lv_chart_refresh(chart);
+    } else if(cnt > n - first) {
+        /*Wrapped around: the end and the beginning changed*/
+        lv_chart_inv_ring(chart, n, first, n - 1);
+        lv_chart_inv_ring(chart, n, 0, cnt - (n - first) - 1);
+    } else {
+        lv_chart_inv_ring(chart, n, first, first + cnt - 1);
+    }
+}
+
+/**
+ * Invalidate the columns of some points of a ring series and the lines to their neighbours
+ * @param chart pointer to chart object
+ * @param n number of points in the series
+ * @param first index of the first changed point
+ * @param last index of the last changed point
+ */
+static void lv_chart_inv_ring(lv_obj_t * chart, uint32_t n, uint32_t first, uint32_t last)
+{
+    lv_chart_ext_t * ext = lv_obj_get_ext_attr(chart);
+
+    lv_coord_t w     = lv_obj_get_width(chart);
+    lv_coord_t x_ofs = chart->coords.x1;
+
+    if(first > 0) first--;
+    if(last < n - 1) last++;
+
+    lv_area_t coords;
+    lv_obj_get_coords(chart, &coords);
+    coords.x1 = lv_chart_ring_col(first, n, w) + x_ofs - ext->series.width;
+    coords.x2 = lv_chart_ring_col(last, n, w) + x_ofs + ext->series.width;
+    lv_inv_area_by(lv_obj_get_disp(chart), &coords, chart);
+}
+#endif
+
 #endif
@@ -61,6 +61,10 @@ typedef struct
     lv_coord_t * points;
     lv_color_t color;
     uint16_t start_point;
+#if LV_CHART_RING_SERIES
+    uint32_t ring_cnt;   /*Point number of a ring series, 0: normal series with `point_cnt` points*/
+    uint32_t ring_start; /*Index of the oldest point of a ring series (the next to be overwritten)*/
+#endif
 } lv_chart_series_t;
 
 /** Data of axis */
@@ -134,6 +138,20 @@ lv_obj_t * lv_chart_create(lv_obj_t * par, const lv_obj_t * copy);
  */
 lv_chart_series_t * lv_chart_add_series(lv_obj_t * chart, lv_color_t color);
 
+#if LV_CHART_RING_SERIES
+/**
+ * Allocate and add a data series with its own number of points kept in a ring buffer.
+ * `lv_chart_set_next` overwrites the oldest point in O(1) and only the columns which got new data are invalidated
+ * in `LV_CHART_UPDATE_MODE_CIRCULAR` mode. If there are more points than pixels the series is drawn
+ * as a min/max envelope per pixel column. Ring series are always drawn as lines, whatever the chart type.
+ * @param chart pointer to a chart object
+ * @param color color of the data series
+ * @param point_cnt number of points in the series (at least 2)
+ * @return pointer to the allocated data series or NULL if it doesn't fit in the memory
+ */
+lv_chart_series_t * lv_chart_add_ring_series(lv_obj_t * chart, lv_color_t color, uint32_t point_cnt);
+#endif
+
 /**
  * Clear the point of a serie
  * @param chart pointer to a chart object
@@ -220,6 +238,17 @@ void lv_chart_set_points(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y
  */
 void lv_chart_set_next(lv_obj_t * chart, lv_chart_series_t * ser, lv_coord_t y);
 
+#if LV_CHART_RING_SERIES
+/**
+ * Add more data to a data line at once, like calling `lv_chart_set_next` for each but invalidating only once
+ * @param chart pointer to chart object
+ * @param ser pointer to a data series on 'chart'
+ * @param y_array the new values, the oldest first
+ * @param cnt number of values in `y_array`
+ */
+void lv_chart_set_next_array(lv_obj_t * chart, lv_chart_series_t * ser, const lv_coord_t y_array[], uint32_t cnt);
+#endif
+
 /**
  * Set update mode of the chart object.
  * @param chart pointer to a chart object
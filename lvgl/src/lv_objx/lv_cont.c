@@ -20,6 +20,7 @@
 #include "../lv_misc/lv_area.h"
 #include "../lv_misc/lv_color.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_core/lv_hit.h"
 
 /*********************
  *      DEFINES
@@ -33,6 +34,7 @@
  *  STATIC PROTOTYPES
  **********************/
 static lv_res_t lv_cont_signal(lv_obj_t * cont, lv_signal_t sign, void * param);
+static void lv_cont_refr(lv_obj_t * cont);
 static void lv_cont_refr_layout(lv_obj_t * cont);
 static void lv_cont_layout_col(lv_obj_t * cont);
 static void lv_cont_layout_row(lv_obj_t * cont);
@@ -87,6 +89,7 @@ lv_obj_t * lv_cont_create(lv_obj_t * par, const lv_obj_t * copy)
 
     /*Init the new container*/
     if(copy == NULL) {
+        lv_obj_set_cord_signal(new_cont, LV_OBJ_CORD_SIGNAL_SIZE);
         /*Set the default styles if it's not screen*/
         if(par != NULL) {
             lv_theme_t * th = lv_theme_get_current();
@@ -240,18 +243,19 @@ static lv_res_t lv_cont_signal(lv_obj_t * cont, lv_signal_t sign, void * param)
     if(res != LV_RES_OK) return res;
 
     if(sign == LV_SIGNAL_STYLE_CHG) { /*Recalculate the padding if the style changed*/
-        lv_cont_refr_layout(cont);
-        lv_cont_refr_autofit(cont);
+        lv_cont_refr(cont);
     } else if(sign == LV_SIGNAL_CHILD_CHG) {
-        lv_cont_refr_layout(cont);
-        lv_cont_refr_autofit(cont);
+        lv_cont_refr(cont);
     } else if(sign == LV_SIGNAL_CORD_CHG) {
         if(lv_obj_get_width(cont) != lv_area_get_width(param) || lv_obj_get_height(cont) != lv_area_get_height(param)) {
-            lv_cont_refr_layout(cont);
-            lv_cont_refr_autofit(cont);
+            lv_cont_refr(cont);
         }
     } else if(sign == LV_SIGNAL_PARENT_SIZE_CHG) {
         /*FLOOD and FILL fit needs to be refreshed if the parent size has changed*/
+        if(lv_obj_layout_is_deferred()) lv_obj_layout_defer(cont);
+        else lv_cont_refr_autofit(cont);
+    } else if(sign == LV_SIGNAL_REFR_LAYOUT) {
+        lv_cont_refr_layout(cont);
         lv_cont_refr_autofit(cont);
 
     } else if(sign == LV_SIGNAL_GET_TYPE) {
@@ -266,6 +270,21 @@ static lv_res_t lv_cont_signal(lv_obj_t * cont, lv_signal_t sign, void * param)
     return res;
 }
 
+/**
+ * Refresh the layout and the fit of a container, or only mark it if the layouts are deferred
+ * @param cont pointer to a container object
+ */
+static void lv_cont_refr(lv_obj_t * cont)
+{
+    if(lv_obj_layout_is_deferred()) {
+        lv_obj_layout_defer(cont);
+        return;
+    }
+
+    lv_cont_refr_layout(cont);
+    lv_cont_refr_autofit(cont);
+}
+
 /**
  * Refresh the layout of a container
  * @param cont pointer to an object which layout should be refreshed
@@ -670,12 +689,16 @@ static void lv_cont_refr_autofit(lv_obj_t * cont)
 
         lv_obj_invalidate(cont);
         lv_area_copy(&cont->coords, &new_area);
+        lv_obj_report_layout_chg();
+        lv_obj_outdate_clip(cont);
         lv_obj_invalidate(cont);
 
         /*Notify the object about its new coordinates*/
         cont->signal_cb(cont, LV_SIGNAL_CORD_CHG, &ori);
 
         /*Inform the parent about the new coordinates*/
+        lv_hit_invalidate(par);
+        lv_obj_outdate_child_bounds(par);
         par->signal_cb(par, LV_SIGNAL_CHILD_CHG, cont);
 
         if(lv_obj_get_auto_realign(cont)) {
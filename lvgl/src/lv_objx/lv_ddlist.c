@@ -33,13 +33,17 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+static lv_txt_flag_t lv_ddlist_get_txt_flag(const lv_obj_t * ddlist);
 static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_design_mode_t mode);
+static bool lv_ddlist_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_ddlist_signal(lv_obj_t * ddlist, lv_signal_t sign, void * param);
 static lv_res_t lv_ddlist_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void * param);
 static lv_res_t release_handler(lv_obj_t * ddlist);
 static void lv_ddlist_refr_size(lv_obj_t * ddlist, lv_anim_enable_t anim);
 static void lv_ddlist_pos_current_option(lv_obj_t * ddlist);
 static void lv_ddlist_refr_width(lv_obj_t * ddlist);
+static void lv_ddlist_refr_label(lv_obj_t * ddlist);
+static const lv_txt_layout_t * lv_ddlist_get_layout(const lv_obj_t * ddlist);
 #if LV_USE_ANIMATION
 static void lv_ddlist_anim_ready_cb(lv_anim_t * a);
 static void lv_ddlist_anim_finish(lv_obj_t * ddlist);
@@ -93,9 +97,11 @@ lv_obj_t * lv_ddlist_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->sel_opt_id     = 0;
     ext->sel_opt_id_ori = 0;
     ext->option_cnt     = 0;
+    ext->opt_page_cnt   = 1;
     ext->sel_style      = &lv_style_plain_color;
     ext->draw_arrow     = 0; /*Do not draw arrow by default*/
     ext->stay_open      = 0;
+    lv_txt_layout_init(&ext->opt_layout);
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_ddlist, lv_ddlist_signal);
@@ -111,6 +117,8 @@ lv_obj_t * lv_ddlist_create(lv_obj_t * par, const lv_obj_t * copy)
         lv_page_set_scrl_fit2(new_ddlist, LV_FIT_FILL, LV_FIT_TIGHT);
 
         ext->label = lv_label_create(new_ddlist, NULL);
+        lv_label_set_long_mode(ext->label, LV_LABEL_LONG_CROP); /*Sized to the options by `lv_ddlist_refr_label`*/
+        lv_obj_set_design_cb(ext->label, lv_ddlist_label_design);
         lv_cont_set_fit2(new_ddlist, LV_FIT_TIGHT, LV_FIT_NONE);
         lv_page_set_sb_mode(new_ddlist, LV_SB_MODE_HIDE);
         lv_page_set_style(new_ddlist, LV_PAGE_STYLE_SCRL, &lv_style_transp_tight);
@@ -133,11 +141,13 @@ lv_obj_t * lv_ddlist_create(lv_obj_t * par, const lv_obj_t * copy)
     else {
         lv_ddlist_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
         ext->label                 = lv_label_create(new_ddlist, copy_ext->label);
+        lv_obj_set_design_cb(ext->label, lv_ddlist_label_design);
         lv_label_set_text(ext->label, lv_label_get_text(copy_ext->label));
         ext->sel_opt_id     = copy_ext->sel_opt_id;
         ext->sel_opt_id_ori = copy_ext->sel_opt_id;
         ext->fix_height     = copy_ext->fix_height;
         ext->option_cnt     = copy_ext->option_cnt;
+        ext->opt_page_cnt   = copy_ext->opt_page_cnt;
         ext->sel_style      = copy_ext->sel_style;
         ext->draw_arrow     = copy_ext->draw_arrow;
         ext->stay_open      = copy_ext->stay_open;
@@ -171,10 +181,13 @@ void lv_ddlist_set_options(lv_obj_t * ddlist, const char * options)
         if(options[i] == '\n') ext->option_cnt++;
     }
     ext->option_cnt++; /*Last option has no `\n`*/
+    ext->option_cnt *= ext->opt_page_cnt;
     ext->sel_opt_id     = 0;
     ext->sel_opt_id_ori = 0;
 
     lv_label_set_text(ext->label, options);
+    lv_txt_layout_invalidate(&ext->opt_layout); /*The text might be reallocated to the same place*/
+    lv_ddlist_refr_label(ddlist);
 
     lv_ddlist_refr_width(ddlist);
 
@@ -338,17 +351,22 @@ void lv_ddlist_get_selected_str(const lv_obj_t * ddlist, char * buf, uint16_t bu
 {
     lv_ddlist_ext_t * ext = lv_obj_get_ext_attr(ddlist);
 
-    uint16_t i;
-    uint16_t line        = 0;
-    const char * opt_txt = lv_label_get_text(ext->label);
-    uint16_t txt_len     = strlen(opt_txt);
+    uint32_t i;
+    const char * opt_txt           = lv_label_get_text(ext->label);
+    const lv_txt_layout_t * layout = lv_ddlist_get_layout(ddlist);
+    uint16_t opt_id                = ext->sel_opt_id % (ext->option_cnt / ext->opt_page_cnt);
 
-    for(i = 0; i < txt_len && line != ext->sel_opt_id; i++) {
-        if(opt_txt[i] == '\n') line++;
+    if(layout && opt_id < layout->line_cnt) {
+        i = layout->lines[opt_id].start;
+    } else {
+        uint16_t line = 0;
+        for(i = 0; opt_txt[i] != '\0' && line != opt_id; i++) {
+            if(opt_txt[i] == '\n') line++;
+        }
     }
 
     uint16_t c;
-    for(c = 0; opt_txt[i] != '\n' && i < txt_len; c++, i++) {
+    for(c = 0; opt_txt[i] != '\n' && opt_txt[i] != '\0'; c++, i++) {
         if(buf_size && c >= buf_size - 1) {
             LV_LOG_WARN("lv_ddlist_get_selected_str: the buffer was too small")
             break;
@@ -456,6 +474,64 @@ void lv_ddlist_close(lv_obj_t * ddlist, lv_anim_enable_t anim)
     lv_ddlist_refr_size(ddlist, anim);
 }
 
+/**
+ * Draw the options of a drop down list which are on the mask (also used by the roller).
+ * Only the visible options are measured and drawn.
+ * @param ddlist pointer to a drop down list object
+ * @param mask draw only on this area
+ * @param style style of the text
+ * @param opa_scale scale down the opacity by this factor
+ */
+void lv_ddlist_draw_options(const lv_obj_t * ddlist, const lv_area_t * mask, const lv_style_t * style,
+                            lv_opa_t opa_scale)
+{
+    lv_ddlist_ext_t * ext = lv_obj_get_ext_attr(ddlist);
+    if(ext->label == NULL) return;
+
+    const lv_area_t * coords       = &ext->label->coords;
+    const char * txt               = lv_label_get_text(ext->label);
+    lv_txt_flag_t flag             = lv_ddlist_get_txt_flag(ddlist);
+    const lv_txt_layout_t * layout = lv_ddlist_get_layout(ddlist);
+
+    /*Without the layout (out of memory) draw the whole text. The repeated pages will be empty.*/
+    if(layout == NULL) {
+        lv_draw_label(coords, mask, style, opa_scale, txt, flag, NULL, -1, -1, NULL, NULL);
+        return;
+    }
+
+    lv_coord_t row_h = lv_font_get_line_height(style->text.font) + style->text.line_space;
+    if(row_h <= 0) return;
+
+    int32_t row_first = (mask->y1 - coords->y1) / row_h;
+    int32_t row_last  = (mask->y2 - coords->y1) / row_h;
+    if(row_first < 0) row_first = 0;
+    if(row_last >= ext->option_cnt) row_last = ext->option_cnt - 1;
+
+    uint16_t real_cnt = ext->option_cnt / ext->opt_page_cnt;
+
+    /*Draw every row with a one line layout. So only its option is drawn even if the mask has more rows.*/
+    lv_txt_layout_t row_layout = *layout;
+    row_layout.line_cnt        = 1;
+
+    int32_t row;
+    for(row = row_first; row <= row_last; row++) {
+        uint16_t opt_id = row % real_cnt;
+        if(opt_id >= layout->line_cnt) continue; /*An empty option after a closing '\n'*/
+
+        lv_area_t row_area;
+        row_area.x1 = coords->x1;
+        row_area.x2 = coords->x2;
+        row_area.y1 = coords->y1 + row * row_h;
+        row_area.y2 = row_area.y1 + row_h - 1;
+
+        lv_area_t row_mask;
+        if(lv_area_intersect(&row_mask, mask, &row_area) == false) continue;
+
+        row_layout.lines = &layout->lines[opt_id];
+        lv_draw_label(&row_area, &row_mask, style, opa_scale, txt, flag, NULL, -1, -1, NULL, &row_layout);
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -552,9 +628,7 @@ static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_desig
                 lv_style_copy(&new_style, style);
                 new_style.text.color = sel_style->text.color;
                 new_style.text.opa   = sel_style->text.opa;
-                lv_txt_flag_t flag   = lv_ddlist_get_txt_flag(ddlist);
-                lv_draw_label(&ext->label->coords, &mask_sel, &new_style, opa_scale, lv_label_get_text(ext->label),
-                              flag, NULL, -1, -1, NULL);
+                lv_ddlist_draw_options(ddlist, &mask_sel, &new_style, opa_scale);
             }
         }
 
@@ -583,7 +657,7 @@ static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_desig
                 area_ok = lv_area_intersect(&mask_arrow, mask, &area_arrow);
                 if(area_ok) {
                     lv_draw_label(&area_arrow, &mask_arrow, &new_style, opa_scale, LV_SYMBOL_DOWN, LV_TXT_FLAG_NONE,
-                                  NULL, -1, -1, NULL); /*Use a down arrow in ddlist, you can replace it with your
+                                  NULL, -1, -1, NULL, NULL); /*Use a down arrow in ddlist, you can replace it with your
                                                     custom symbol*/
                 }
             }
@@ -595,6 +669,31 @@ static bool lv_ddlist_design(lv_obj_t * ddlist, const lv_area_t * mask, lv_desig
     return true;
 }
 
+/**
+ * Handle the drawing related tasks of the label of the options
+ * @param label pointer to the label of a drop down list
+ * @param mask the object will be drawn only in this area
+ * @param mode LV_DESIGN_COVER_CHK: only check if the object fully covers the 'mask_p' area
+ *                                  (return 'true' if yes)
+ *             LV_DESIGN_DRAW: draw the object (always return 'true')
+ *             LV_DESIGN_DRAW_POST: drawing after every children are drawn
+ * @param return true/false, depends on 'mode'
+ */
+static bool lv_ddlist_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    /* A label never covers an area */
+    if(mode == LV_DESIGN_COVER_CHK) {
+        return false;
+    }
+    /*Draw only the visible options instead of the whole text*/
+    else if(mode == LV_DESIGN_DRAW_MAIN) {
+        lv_obj_t * ddlist = lv_obj_get_parent(lv_obj_get_parent(label));
+        lv_ddlist_draw_options(ddlist, mask, lv_obj_get_style(label), lv_obj_get_opa_scale(label));
+    }
+
+    return true;
+}
+
 /**
  * Signal function of the drop down list
  * @param ddlist pointer to a drop down list object
@@ -612,9 +711,11 @@ static lv_res_t lv_ddlist_signal(lv_obj_t * ddlist, lv_signal_t sign, void * par
     lv_ddlist_ext_t * ext = lv_obj_get_ext_attr(ddlist);
 
     if(sign == LV_SIGNAL_STYLE_CHG) {
+        lv_ddlist_refr_label(ddlist);
         lv_ddlist_refr_size(ddlist, 0);
     } else if(sign == LV_SIGNAL_CLEANUP) {
         ext->label = NULL;
+        lv_txt_layout_free(&ext->opt_layout);
     } else if(sign == LV_SIGNAL_FOCUS) {
 #if LV_USE_GROUP
         lv_group_t * g             = lv_obj_get_group(ddlist);
@@ -765,22 +866,14 @@ static lv_res_t release_handler(lv_obj_t * ddlist)
         if(lv_indev_get_type(indev) == LV_INDEV_TYPE_POINTER || lv_indev_get_type(indev) == LV_INDEV_TYPE_BUTTON) {
             lv_point_t p;
             lv_indev_get_point(indev, &p);
-            p.y -= ext->label->coords.y1;
-            p.x -= ext->label->coords.x1;
-            uint16_t letter_i;
-            letter_i = lv_label_get_letter_on(ext->label, &p);
-
-            uint16_t new_opt  = 0;
-            const char * txt  = lv_label_get_text(ext->label);
-            uint32_t i        = 0;
-            uint32_t line_cnt = 0;
-            uint32_t letter;
-            for(line_cnt = 0; line_cnt < letter_i; line_cnt++) {
-                letter = lv_txt_encoded_next(txt, &i);
-                /*Count he lines to reach the clicked letter. But ignore the last '\n' because it
-                 * still belongs to the clicked line*/
-                if(letter == '\n' && i != letter_i) new_opt++;
-            }
+
+            /*The options are in rows with the same height. The clicked row is the option.*/
+            const lv_style_t * label_style = lv_obj_get_style(ext->label);
+            lv_coord_t row_h = lv_font_get_line_height(label_style->text.font) + label_style->text.line_space;
+            int32_t new_opt  = 0;
+            if(row_h > 0) new_opt = (p.y - ext->label->coords.y1 + label_style->text.line_space / 2) / row_h;
+            if(new_opt < 0) new_opt = 0;
+            if(new_opt >= ext->option_cnt) new_opt = ext->option_cnt - 1;
 
             ext->sel_opt_id     = new_opt;
             ext->sel_opt_id_ori = ext->sel_opt_id;
@@ -937,9 +1030,54 @@ static void lv_ddlist_refr_width(lv_obj_t * ddlist)
 {
     /*Set the TIGHT fit horizontally the set the width to the content*/
     lv_page_set_scrl_fit2(ddlist, LV_FIT_TIGHT, lv_page_get_scrl_fit_bottom(ddlist));
+    /*The FILL fit keeps the width of the TIGHT one, so it's needed now even if the layouts are deferred*/
+    lv_obj_layout_flush();
 
     /*Revert FILL fit to fill the parent with the options area. It allows to RIGHT/CENTER align the text*/
     lv_page_set_scrl_fit2(ddlist, LV_FIT_FILL, lv_page_get_scrl_fit_bottom(ddlist));
 }
 
+/**
+ * Set the size of the label to its options. It's done here and not by the label
+ * because in infinite rollers the options are shown more times than they are in the text.
+ * @param ddlist pointer to a ddlist
+ */
+static void lv_ddlist_refr_label(lv_obj_t * ddlist)
+{
+    lv_ddlist_ext_t * ext = lv_obj_get_ext_attr(ddlist);
+    if(ext->label == NULL) return;
+
+    const lv_style_t * style       = lv_obj_get_style(ext->label);
+    const lv_txt_layout_t * layout = lv_ddlist_get_layout(ddlist);
+    lv_point_t size;
+    if(layout) {
+        size.x = layout->size.x;
+    } else {
+        lv_txt_get_size(&size, lv_label_get_text(ext->label), style->text.font, style->text.letter_space,
+                        style->text.line_space, LV_COORD_MAX, LV_TXT_FLAG_NONE);
+    }
+
+    size.y = ext->option_cnt * (lv_font_get_line_height(style->text.font) + style->text.line_space) -
+             style->text.line_space;
+
+    lv_obj_set_size(ext->label, size.x, size.y);
+}
+
+/**
+ * Get the start and width of the options. Measure them if the text or the style has changed.
+ * @param ddlist pointer to a ddlist
+ * @return the layout of the label's text or NULL if there is no memory for it
+ */
+static const lv_txt_layout_t * lv_ddlist_get_layout(const lv_obj_t * ddlist)
+{
+    lv_ddlist_ext_t * ext = lv_obj_get_ext_attr(ddlist);
+    if(ext->label == NULL) return NULL;
+
+    const lv_style_t * style = lv_obj_get_style(ext->label);
+    bool ok = lv_txt_layout_update(&ext->opt_layout, lv_label_get_text(ext->label), style->text.font,
+                                   style->text.letter_space, style->text.line_space, LV_COORD_MAX, LV_TXT_FLAG_NONE);
+
+    return ok ? &ext->opt_layout : NULL;
+}
+
 #endif
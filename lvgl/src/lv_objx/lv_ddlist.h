@@ -49,6 +49,8 @@ typedef struct
     lv_obj_t * label;             /*Label for the options*/
     const lv_style_t * sel_style; /*Style of the selected option*/
     uint16_t option_cnt;          /*Number of options*/
+    lv_txt_layout_t opt_layout;   /*Start and width of the options in the label's text*/
+    uint8_t opt_page_cnt;         /*The options follow each other this many times (more than 1 in infinite rollers)*/
     uint16_t sel_opt_id;          /*Index of the current option*/
     uint16_t sel_opt_id_ori;      /*Store the original index on focus*/
     uint8_t opened : 1;           /*1: The list is opened (handled by the library)*/
@@ -256,6 +258,17 @@ void lv_ddlist_open(lv_obj_t * ddlist, lv_anim_enable_t anim);
  */
 void lv_ddlist_close(lv_obj_t * ddlist, lv_anim_enable_t anim);
 
+/**
+ * Draw the options of a drop down list which are on the mask (also used by the roller).
+ * Only the visible options are measured and drawn.
+ * @param ddlist pointer to a drop down list object
+ * @param mask draw only on this area
+ * @param style style of the text
+ * @param opa_scale scale down the opacity by this factor
+ */
+void lv_ddlist_draw_options(const lv_obj_t * ddlist, const lv_area_t * mask, const lv_style_t * style,
+                            lv_opa_t opa_scale);
+
 /**********************
  *      MACROS
  **********************/
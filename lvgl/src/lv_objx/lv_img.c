@@ -79,6 +79,7 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->auto_size = 1;
     ext->offset.x  = 0;
     ext->offset.y  = 0;
+    ext->tiled     = 0;
 
     /*Init the new object*/
     lv_obj_set_signal_cb(new_img, lv_img_signal);
@@ -99,6 +100,7 @@ lv_obj_t * lv_img_create(lv_obj_t * par, const lv_obj_t * copy)
     } else {
         lv_img_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
         ext->auto_size          = copy_ext->auto_size;
+        ext->tiled              = copy_ext->tiled;
         lv_img_set_src(new_img, copy_ext->src);
 
         /*Refresh the style with new signal function*/
@@ -238,6 +240,21 @@ void lv_img_set_offset_y(lv_obj_t * img, lv_coord_t y)
     }
 }
 
+/**
+ * Repeat the image to fill the object. The image is decoded once for all the copies.
+ * The offset is wrapped around the image's size. Enabling it disables the auto size.
+ * @param img pointer to an image
+ * @param en true: tile the image; false: draw it as usual
+ */
+void lv_img_set_tiled(lv_obj_t * img, bool en)
+{
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    ext->tiled = en ? 1 : 0;
+    if(en) ext->auto_size = 0;
+    lv_obj_invalidate(img);
+}
+
 /*=====================
  * Getter functions
  *====================*/
@@ -281,6 +298,18 @@ bool lv_img_get_auto_size(const lv_obj_t * img)
     return ext->auto_size == 0 ? false : true;
 }
 
+/**
+ * Get whether the image is repeated to fill the object
+ * @param img pointer to an image
+ * @return true: the image is tiled
+ */
+bool lv_img_get_tiled(const lv_obj_t * img)
+{
+    lv_img_ext_t * ext = lv_obj_get_ext_attr(img);
+
+    return ext->tiled == 0 ? false : true;
+}
+
 /**
  * Get the offset.x attribute of the img object.
  * @param img pointer to an image
@@ -338,7 +367,10 @@ static bool lv_img_design(lv_obj_t * img, const lv_area_t * mask, lv_design_mode
 
         lv_obj_get_coords(img, &coords);
 
-        if(ext->src_type == LV_IMG_SRC_FILE || ext->src_type == LV_IMG_SRC_VARIABLE) {
+        if((ext->src_type == LV_IMG_SRC_FILE || ext->src_type == LV_IMG_SRC_VARIABLE) && ext->tiled) {
+            LV_LOG_TRACE("lv_img_design: start to draw tiled image");
+            lv_draw_img_tiled(&coords, mask, ext->src, style, opa_scale, &ext->offset);
+        } else if(ext->src_type == LV_IMG_SRC_FILE || ext->src_type == LV_IMG_SRC_VARIABLE) {
             coords.x1 -= ext->offset.x;
             coords.y1 -= ext->offset.y;
 
@@ -359,7 +391,7 @@ static bool lv_img_design(lv_obj_t * img, const lv_area_t * mask, lv_design_mode
             lv_style_t style_mod;
             lv_style_copy(&style_mod, style);
             style_mod.text.color = style->image.color;
-            lv_draw_label(&coords, mask, &style_mod, opa_scale, ext->src, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL);
+            lv_draw_label(&coords, mask, &style_mod, opa_scale, ext->src, LV_TXT_FLAG_NONE, NULL, -1, -1, NULL, NULL);
         } else {
             /*Trigger the error handler of image drawer*/
             LV_LOG_WARN("lv_img_design: image source type is unknown");
@@ -45,6 +45,7 @@ typedef struct
     uint8_t src_type : 2;  /*See: lv_img_src_t*/
     uint8_t auto_size : 1; /*1: automatically set the object size to the image size*/
     uint8_t cf : 5;        /*Color format from `lv_img_color_format_t`*/
+    uint8_t tiled : 1;     /*1: repeat the image to fill the object*/
 } lv_img_ext_t;
 
 /*Styles*/
@@ -100,6 +101,14 @@ void lv_img_set_offset_x(lv_obj_t * img, lv_coord_t x);
  */
 void lv_img_set_offset_y(lv_obj_t * img, lv_coord_t y);
 
+/**
+ * Repeat the image to fill the object. The image is decoded once for all the copies.
+ * The offset is wrapped around the image's size. Enabling it disables the auto size.
+ * @param img pointer to an image
+ * @param en true: tile the image; false: draw it as usual
+ */
+void lv_img_set_tiled(lv_obj_t * img, bool en);
+
 /**
  * Set the style of an image
  * @param img pointer to an image object
@@ -137,6 +146,13 @@ const char * lv_img_get_file_name(const lv_obj_t * img);
  */
 bool lv_img_get_auto_size(const lv_obj_t * img);
 
+/**
+ * Get whether the image is repeated to fill the object
+ * @param img pointer to an image
+ * @return true: the image is tiled
+ */
+bool lv_img_get_tiled(const lv_obj_t * img);
+
 /**
  * Get the offset.x attribute of the img object.
  * @param img pointer to an image
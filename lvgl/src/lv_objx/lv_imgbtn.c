@@ -8,6 +8,7 @@
  *********************/
 #include "lv_imgbtn.h"
 #if LV_USE_IMGBTN != 0
+#include "../lv_draw/lv_img_cache.h"
 
 /*********************
  *      DEFINES
@@ -23,6 +24,8 @@
 static bool lv_imgbtn_design(lv_obj_t * imgbtn, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_imgbtn_signal(lv_obj_t * imgbtn, lv_signal_t sign, void * param);
 static void refr_img(lv_obj_t * imgbtn);
+static void src_set(lv_obj_t * imgbtn, lv_btn_state_t state, const void ** slot, uint8_t id, const void * src);
+static void src_unpin_all(lv_obj_t * imgbtn);
 
 /**********************
  *  STATIC VARIABLES
@@ -71,6 +74,9 @@ lv_obj_t * lv_imgbtn_create(lv_obj_t * par, const lv_obj_t * copy)
 #endif
 
     ext->act_cf = LV_IMG_CF_UNKNOWN;
+#if LV_IMGBTN_PIN
+    ext->pinned = 0;
+#endif
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_imgbtn, lv_imgbtn_signal);
@@ -83,13 +89,16 @@ lv_obj_t * lv_imgbtn_create(lv_obj_t * par, const lv_obj_t * copy)
     /*Copy an existing image button*/
     else {
         lv_imgbtn_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
+        lv_btn_state_t state;
+        for(state = 0; state < _LV_BTN_STATE_NUM; state++) {
 #if LV_IMGBTN_TILED == 0
-        memcpy(ext->img_src, copy_ext->img_src, sizeof(ext->img_src));
+            src_set(new_imgbtn, state, &ext->img_src[state], state, copy_ext->img_src[state]);
 #else
-        memcpy(ext->img_src_left, copy_ext->img_src_left, sizeof(ext->img_src_left));
-        memcpy(ext->img_src_mid, copy_ext->img_src_mid, sizeof(ext->img_src_mid));
-        memcpy(ext->img_src_right, copy_ext->img_src_right, sizeof(ext->img_src_right));
+            src_set(new_imgbtn, state, &ext->img_src_left[state], state * 3, copy_ext->img_src_left[state]);
+            src_set(new_imgbtn, state, &ext->img_src_mid[state], state * 3 + 1, copy_ext->img_src_mid[state]);
+            src_set(new_imgbtn, state, &ext->img_src_right[state], state * 3 + 2, copy_ext->img_src_right[state]);
 #endif
+        }
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_imgbtn);
     }
@@ -114,7 +123,7 @@ void lv_imgbtn_set_src(lv_obj_t * imgbtn, lv_btn_state_t state, const void * src
 {
     lv_imgbtn_ext_t * ext = lv_obj_get_ext_attr(imgbtn);
 
-    ext->img_src[state] = src;
+    src_set(imgbtn, state, &ext->img_src[state], state, src);
 
     refr_img(imgbtn);
 }
@@ -136,9 +145,9 @@ void lv_imgbtn_set_src(lv_obj_t * imgbtn, lv_btn_state_t state, const void * src
 {
     lv_imgbtn_ext_t * ext = lv_obj_get_ext_attr(imgbtn);
 
-    ext->img_src_left[state] = src_left;
-    ext->img_src_mid[state] = src_mid;
-    ext->img_src_right[state] = src_right;
+    src_set(imgbtn, state, &ext->img_src_left[state], state * 3, src_left);
+    src_set(imgbtn, state, &ext->img_src_mid[state], state * 3 + 1, src_mid);
+    src_set(imgbtn, state, &ext->img_src_right[state], state * 3 + 2, src_right);
 
     refr_img(imgbtn);
 }
@@ -301,22 +310,18 @@ static bool lv_imgbtn_design(lv_obj_t * imgbtn, const lv_area_t * mask, lv_desig
             lv_draw_img(&coords, mask, src, style, opa_scale);
         }
 
+        /*The middle image is opened once and repeated between the sides*/
         src = ext->img_src_mid[state];
         if(src) {
-            lv_coord_t obj_w = lv_obj_get_width(imgbtn);
-            lv_coord_t i;
             lv_img_decoder_get_info(src, &header);
 
             coords.x1 = imgbtn->coords.x1 + left_w;
             coords.y1 = imgbtn->coords.y1;
-            coords.x2 = coords.x1 + header.w - 1;
+            coords.x2 = imgbtn->coords.x2 - right_w;
             coords.y2 = imgbtn->coords.y1 + header.h - 1;
 
-            for(i = 0; i < obj_w - right_w - left_w; i += header.w) {
-                lv_draw_img(&coords, mask, src, style, opa_scale);
-                coords.x1 = coords.x2 + 1;
-                coords.x2 += header.w;
-            }
+            lv_point_t offset = {0, 0};
+            lv_draw_img_tiled(&coords, mask, src, style, opa_scale, &offset);
         }
 
 #endif
@@ -349,7 +354,7 @@ static lv_res_t lv_imgbtn_signal(lv_obj_t * imgbtn, lv_signal_t sign, void * par
          * changed as well Set the new image for the new state.*/
         refr_img(imgbtn);
     } else if(sign == LV_SIGNAL_CLEANUP) {
-        /*Nothing to cleanup. (No dynamically allocated memory in 'ext')*/
+        src_unpin_all(imgbtn);
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
         uint8_t i;
@@ -390,4 +395,56 @@ static void refr_img(lv_obj_t * imgbtn)
     lv_obj_invalidate(imgbtn);
 }
 
+/**
+ * Store an image source of a state and pin it in the image cache instead of the old one
+ * @param imgbtn pointer to an image button object
+ * @param state the state of the source
+ * @param slot the source's place in `ext`
+ * @param id the source's bit in `ext->pinned`: `state` or `state * 3 + part` (left, mid, right) if tiled
+ * @param src the new image source
+ */
+static void src_set(lv_obj_t * imgbtn, lv_btn_state_t state, const void ** slot, uint8_t id, const void * src)
+{
+#if LV_IMGBTN_PIN
+    lv_imgbtn_ext_t * ext = lv_obj_get_ext_attr(imgbtn);
+    uint16_t bit          = (uint16_t)1 << id;
+    if(src == *slot && (ext->pinned & bit)) return;
+
+    /*Pin the new one first: if it's the same image its decoded pixels stay*/
+    bool pinned = false;
+    if(src) pinned = lv_img_cache_pin(src, lv_imgbtn_get_style(imgbtn, state)) == LV_RES_OK;
+    if(ext->pinned & bit) lv_img_cache_unpin(*slot);
+    if(pinned)
+        ext->pinned |= bit;
+    else
+        ext->pinned &= ~bit;
+#else
+    (void)imgbtn; /*Unused*/
+    (void)state;
+    (void)id;
+#endif
+    *slot = src;
+}
+
+/*Let the image cache reuse the entries of every pinned source*/
+static void src_unpin_all(lv_obj_t * imgbtn)
+{
+#if LV_IMGBTN_PIN
+    lv_imgbtn_ext_t * ext = lv_obj_get_ext_attr(imgbtn);
+    lv_btn_state_t state;
+    for(state = 0; state < _LV_BTN_STATE_NUM; state++) {
+#if LV_IMGBTN_TILED == 0
+        if(ext->pinned & (1 << state)) lv_img_cache_unpin(ext->img_src[state]);
+#else
+        if(ext->pinned & (1 << (state * 3))) lv_img_cache_unpin(ext->img_src_left[state]);
+        if(ext->pinned & (1 << (state * 3 + 1))) lv_img_cache_unpin(ext->img_src_mid[state]);
+        if(ext->pinned & (1 << (state * 3 + 2))) lv_img_cache_unpin(ext->img_src_right[state]);
+#endif
+    }
+    ext->pinned = 0;
+#else
+    (void)imgbtn; /*Unused*/
+#endif
+}
+
 #endif
@@ -50,6 +50,9 @@ typedef struct
     const void * img_src_right[_LV_BTN_STATE_NUM]; /*Store right side images to each state*/
 #endif
     lv_img_cf_t act_cf; /*Color format of the currently active image*/
+#if LV_IMGBTN_PIN
+    uint16_t pinned; /*A bit for every source pinned in the image cache (see `src_set` in lv_imgbtn.c)*/
+#endif
 } lv_imgbtn_ext_t;
 
 /*Styles*/
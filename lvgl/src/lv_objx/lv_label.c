@@ -13,6 +13,8 @@
 #include "../lv_core/lv_group.h"
 #include "../lv_misc/lv_color.h"
 #include "../lv_misc/lv_math.h"
+#include <stdarg.h>
+#include <stdio.h>
 
 /*********************
  *      DEFINES
@@ -25,6 +27,7 @@
 #define LV_LABEL_DOT_END_INV 0xFFFF
 #define LV_LABEL_HINT_HEIGHT_LIMIT                                                                                     \
     1024 /*Enable "hint" to buffer info about labels larger than this. (Speed up their drawing)*/
+#define LV_LABEL_TXT_RESERVE_DIV 8 /*Reserve 1/8 more memory on insert to not reallocate the text on every character*/
 
 /**********************
  *      TYPEDEFS
@@ -36,12 +39,28 @@
 static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param);
 static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_mode_t mode);
 static void lv_label_refr_text(lv_obj_t * label);
+static bool lv_label_is_layout_editable(const lv_obj_t * label);
+static void lv_label_refr_lines(lv_obj_t * label, uint32_t pos, uint32_t del_len, uint32_t ins_len);
 static void lv_label_revert_dots(lv_obj_t * label);
+static bool lv_label_text_grow(lv_obj_t * label, uint32_t size);
+static bool lv_label_is_text_same(const lv_obj_t * label, const char * text, uint32_t len);
+static void lv_label_refr_digit_cells(lv_obj_t * label);
+static bool lv_label_set_digits(lv_obj_t * label, const char * text, uint32_t len);
+static const lv_txt_layout_t * lv_label_get_layout(const lv_obj_t * label, lv_coord_t max_w, lv_txt_flag_t flag);
+static void lv_label_get_text_size(const lv_obj_t * label, lv_point_t * size, lv_txt_flag_t flag);
+static uint32_t lv_label_get_line_on(const lv_txt_layout_t * layout, lv_coord_t y, lv_coord_t letter_height,
+                                     lv_coord_t line_space);
 
 #if LV_USE_ANIMATION
 static void lv_label_set_offset_x(lv_obj_t * label, lv_coord_t x);
 static void lv_label_set_offset_y(lv_obj_t * label, lv_coord_t y);
 #endif
+#if LV_LABEL_ROLL_STRIP
+static void lv_label_strip_refr(lv_obj_t * label);
+static void lv_label_strip_draw(lv_obj_t * label, const lv_area_t * coords, const lv_area_t * mask,
+                                const lv_style_t * style, lv_opa_t opa_scale);
+static void lv_label_strip_free(lv_obj_t * label);
+#endif
 
 static bool lv_label_set_dot_tmp(lv_obj_t * label, char * data, uint16_t len);
 static char * lv_label_get_dot_tmp(lv_obj_t * label);
@@ -84,23 +103,36 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
     lv_mem_assert(ext);
     if(ext == NULL) return NULL;
 
-    ext->text       = NULL;
-    ext->static_txt = 0;
-    ext->recolor    = 0;
-    ext->body_draw  = 0;
-    ext->align      = LV_LABEL_ALIGN_LEFT;
-    ext->dot_end    = LV_LABEL_DOT_END_INV;
-    ext->long_mode  = LV_LABEL_LONG_EXPAND;
+    ext->text        = NULL;
+    ext->static_txt  = 0;
+    ext->reserve     = 0;
+    ext->recolor     = 0;
+    ext->body_draw   = 0;
+    ext->digit_cells = 0;
+    ext->digit_w     = 0;
+    ext->digit_x1    = 0;
+    ext->digit_x2    = 0;
+    ext->align       = LV_LABEL_ALIGN_LEFT;
+    ext->dot_end     = LV_LABEL_DOT_END_INV;
+    ext->long_mode   = LV_LABEL_LONG_EXPAND;
 #if LV_USE_ANIMATION
     ext->anim_speed = LV_LABEL_DEF_SCROLL_SPEED;
 #endif
     ext->offset.x = 0;
     ext->offset.y = 0;
+#if LV_LABEL_ROLL_STRIP
+    ext->strip       = NULL;
+    ext->strip_none  = 0;
+    ext->strip_txt_w = 0;
+    lv_area_set(&ext->strip_area, 0, 0, 0, 0);
+#endif
 
     ext->hint.line_start = -1;
     ext->hint.coord_y    = 0;
     ext->hint.y          = 0;
 
+    lv_txt_layout_init(&ext->layout);
+
 #if LV_LABEL_TEXT_SEL
     ext->txt_sel_start = LV_LABEL_TEXT_SEL_OFF;
     ext->txt_sel_end   = LV_LABEL_TEXT_SEL_OFF;
@@ -113,6 +145,7 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
 
     /*Init the new label*/
     if(copy == NULL) {
+        lv_obj_set_cord_signal(new_label, LV_OBJ_CORD_SIGNAL_SIZE);
         lv_obj_set_click(new_label, false);
         lv_label_set_long_mode(new_label, LV_LABEL_LONG_EXPAND);
         lv_label_set_text(new_label, "Text");
@@ -124,7 +157,9 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
         lv_label_set_long_mode(new_label, lv_label_get_long_mode(copy));
         lv_label_set_recolor(new_label, lv_label_get_recolor(copy));
         lv_label_set_body_draw(new_label, lv_label_get_body_draw(copy));
+        lv_label_set_digit_cells(new_label, lv_label_get_digit_cells(copy));
         lv_label_set_align(new_label, lv_label_get_align(copy));
+        ext->reserve = copy_ext->reserve;
         if(copy_ext->static_txt == 0)
             lv_label_set_text(new_label, lv_label_get_text(copy));
         else
@@ -167,10 +202,17 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy)
  */
 void lv_label_set_text(lv_obj_t * label, const char * text)
 {
-    lv_obj_invalidate(label);
-
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
 
+    /*Nothing to refresh if the same text is set again. Only the cells of the changed digits in numeric mode.*/
+    if(text != NULL && text != ext->text) {
+        uint32_t len = strlen(text);
+        if(lv_label_is_text_same(label, text, len)) return;
+        if(lv_label_set_digits(label, text, len)) return;
+    }
+
+    lv_obj_invalidate(label);
+
     /*If text is NULL then refresh */
     if(text == NULL) {
         lv_label_refr_text(label);
@@ -179,9 +221,16 @@ void lv_label_set_text(lv_obj_t * label, const char * text)
 
     if(ext->text == text) {
         /*If set its own text then reallocate it (maybe its size changed)*/
-        ext->text = lv_mem_realloc(ext->text, strlen(ext->text) + 1);
-        lv_mem_assert(ext->text);
-        if(ext->text == NULL) return;
+        if(ext->reserve == 0) {
+            ext->text = lv_mem_realloc(ext->text, strlen(ext->text) + 1);
+            lv_mem_assert(ext->text);
+            if(ext->text == NULL) return;
+        }
+    } else if(ext->reserve != 0 && ext->static_txt == 0 && ext->text != NULL) {
+        /*Copy the text into the reserved memory*/
+        uint32_t len = strlen(text) + 1;
+        if(lv_label_text_grow(label, len) == false) return;
+        memmove(ext->text, text, len);
     } else {
         /*Allocate space for the new text*/
         uint32_t len = strlen(text) + 1;
@@ -201,6 +250,73 @@ void lv_label_set_text(lv_obj_t * label, const char * text)
     lv_label_refr_text(label);
 }
 
+/**
+ * Set a new formatted text for a label. The text is printed directly into the label's memory
+ * and nothing is redrawn if it's the same as the current text.
+ * @param label pointer to a label object
+ * @param fmt `printf`-like format
+ */
+void lv_label_set_text_fmt(lv_obj_t * label, const char * fmt, ...)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    /*Print behind the current text to compare them. Static text and text with dots are simply replaced.*/
+    char * old_txt  = ext->text;
+    bool static_txt = ext->static_txt != 0;
+    uint32_t ofs    = 0;
+    if(static_txt) {
+        ext->text       = NULL;
+        ext->static_txt = 0;
+    } else if(ext->text != NULL && ext->dot_end == LV_LABEL_DOT_END_INV) {
+        ofs = strlen(ext->text) + 1;
+    }
+
+    va_list args;
+    va_list args_copy;
+    va_start(args, fmt);
+    va_copy(args_copy, args);
+
+    uint32_t size = lv_mem_get_size(ext->text);
+    int len       = vsnprintf(ext->text ? &ext->text[ofs] : NULL, ext->text ? size - ofs : 0, fmt, args);
+    bool ok       = len >= 0;
+    if(ok && ofs + len + 1 > size) {
+        ok = lv_label_text_grow(label, ofs + len + 1);
+        if(ok) vsnprintf(&ext->text[ofs], len + 1, fmt, args_copy);
+    }
+
+    va_end(args_copy);
+    va_end(args);
+
+    if(ok == false) {
+        if(static_txt) {
+            ext->text       = old_txt;
+            ext->static_txt = 1;
+        }
+        return;
+    }
+
+    /*Keep the current text if it's the same. The printed copy stays behind it in the unused memory.*/
+    if(ofs != 0 && strcmp(ext->text, &ext->text[ofs]) == 0) return;
+    if(ofs != 0 && lv_label_set_digits(label, &ext->text[ofs], len)) return;
+    if(static_txt && strcmp(old_txt, ext->text) == 0) {
+        lv_mem_free(ext->text);
+        ext->text       = old_txt;
+        ext->static_txt = 1;
+        return;
+    }
+
+    lv_obj_invalidate(label);
+
+    if(ofs != 0) memmove(ext->text, &ext->text[ofs], len + 1);
+    if(ext->reserve == 0) {
+        ext->text = lv_mem_realloc(ext->text, len + 1);
+        lv_mem_assert(ext->text);
+        if(ext->text == NULL) return;
+    }
+
+    lv_label_refr_text(label);
+}
+
 /**
  * Set a new text for a label from a character array. The array don't has to be '\0' terminated.
  * Memory will be allocated to store the array by the label.
@@ -210,26 +326,38 @@ void lv_label_set_text(lv_obj_t * label, const char * text)
  */
 void lv_label_set_array_text(lv_obj_t * label, const char * array, uint16_t size)
 {
-    lv_obj_invalidate(label);
-
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
 
+    /*Nothing to refresh if the same text is set again*/
+    if(array != NULL && array != ext->text && memchr(array, '\0', size) == NULL) {
+        if(lv_label_is_text_same(label, array, size)) return;
+        if(lv_label_set_digits(label, array, size)) return;
+    }
+
+    lv_obj_invalidate(label);
+
     /*If trying to set its own text or the array is NULL then refresh */
     if(array == ext->text || array == NULL) {
         lv_label_refr_text(label);
         return;
     }
 
-    /*Allocate space for the new text*/
-    if(ext->text != NULL && ext->static_txt == 0) {
-        lv_mem_free(ext->text);
-        ext->text = NULL;
-    }
-    ext->text = lv_mem_alloc(size + 1);
-    lv_mem_assert(ext->text);
-    if(ext->text == NULL) return;
+    if(ext->reserve != 0 && ext->static_txt == 0 && ext->text != NULL) {
+        /*Copy the array into the reserved memory*/
+        if(lv_label_text_grow(label, size + 1) == false) return;
+        memmove(ext->text, array, size);
+    } else {
+        /*Allocate space for the new text*/
+        if(ext->text != NULL && ext->static_txt == 0) {
+            lv_mem_free(ext->text);
+            ext->text = NULL;
+        }
+        ext->text = lv_mem_alloc(size + 1);
+        lv_mem_assert(ext->text);
+        if(ext->text == NULL) return;
 
-    memcpy(ext->text, array, size);
+        memcpy(ext->text, array, size);
+    }
     ext->text[size] = '\0';
     ext->static_txt = 0; /*Now the text is dynamically allocated*/
 
@@ -258,6 +386,56 @@ void lv_label_set_static_text(lv_obj_t * label, const char * text)
     lv_label_refr_text(label);
 }
 
+/**
+ * Keep the memory of the text between the changes to not reallocate and copy it on every new text.
+ * If a longer text is set the memory is doubled, but it's never shrunk.
+ * Useful for frequently updated labels, e.g. counters and live values.
+ * A static text is copied into the reserved memory.
+ * @param label pointer to a label object
+ * @param size number of bytes to reserve now (with the closing '\0').
+ *             0: free the unused memory and allocate the exact size for each text again
+ */
+void lv_label_set_reserve(lv_obj_t * label, uint32_t size)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    if(ext->static_txt != 0 && ext->text != NULL && size != 0) {
+        char * static_txt = ext->text;
+        uint32_t len      = strlen(static_txt) + 1;
+        ext->text         = lv_mem_alloc(LV_MATH_MAX(len, size));
+        lv_mem_assert(ext->text);
+        if(ext->text == NULL) {
+            ext->text = static_txt;
+            return;
+        }
+        memcpy(ext->text, static_txt, len);
+        ext->static_txt = 0;
+        ext->layout.txt = ext->text; /*The lines are the same with the copy*/
+    }
+
+    ext->reserve = 0;
+    if(ext->static_txt == 0 && ext->text != NULL) {
+        uint32_t len = strlen(ext->text) + 1;
+        /*In dot mode a '\0' can be in the middle of the text*/
+        if(ext->long_mode == LV_LABEL_LONG_DOT) len = lv_mem_get_size(ext->text);
+
+        char * new_txt;
+        if(size == 0)
+            new_txt = lv_mem_realloc(ext->text, len);
+        else if(size > lv_mem_get_size(ext->text))
+            new_txt = lv_mem_realloc(ext->text, size);
+        else
+            new_txt = ext->text;
+
+        lv_mem_assert(new_txt);
+        if(new_txt == NULL) return;
+        ext->text       = new_txt;
+        ext->layout.txt = new_txt; /*The lines are the same in the moved text*/
+    }
+
+    if(size != 0) ext->reserve = 1;
+}
+
 /**
  * Set the behavior of the label with longer text then the object size
  * @param label pointer to a label object
@@ -342,6 +520,23 @@ void lv_label_set_body_draw(lv_obj_t * label, bool en)
     lv_obj_invalidate(label);
 }
 
+/**
+ * Set the numeric display mode. If the digits of the font have the same width (as in most fonts)
+ * they are in fixed cells: a new text which differs only in some digits (e.g. the next value of a counter)
+ * redraws only their cells instead of the whole label.
+ * Not used with recoloring, with rolling texts and while dots are shown.
+ * @param label pointer to a label object
+ * @param en true: enable the numeric mode
+ */
+void lv_label_set_digit_cells(lv_obj_t * label, bool en)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    if(ext->digit_cells == en) return;
+
+    ext->digit_cells = en == false ? 0 : 1;
+    lv_label_refr_digit_cells(label);
+}
+
 /**
  * Set the label's animation speed in LV_LABEL_LONG_SROLL/SCROLL_CIRC modes
  * @param label pointer to a label object
@@ -404,6 +599,17 @@ char * lv_label_get_text(const lv_obj_t * label)
     return ext->text;
 }
 
+/**
+ * Get the memory reserved for the text of a label
+ * @param label pointer to a label object
+ * @return size of the memory of the text in bytes or 0 if no memory is reserved
+ */
+uint32_t lv_label_get_reserve(const lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    return ext->reserve ? lv_mem_get_size(ext->text) : 0;
+}
+
 /**
  * Get the long mode of a label
  * @param label pointer to a label object
@@ -448,6 +654,17 @@ bool lv_label_get_body_draw(const lv_obj_t * label)
     return ext->body_draw == 0 ? false : true;
 }
 
+/**
+ * Get whether the numeric display mode is enabled
+ * @param label pointer to a label object
+ * @return true: only the changed digits are redrawn (see `lv_label_set_digit_cells`)
+ */
+bool lv_label_get_digit_cells(const lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    return ext->digit_cells == 0 ? false : true;
+}
+
 /**
  * Get the label's animation speed in LV_LABEL_LONG_ROLL and SCROLL modes
  * @param label pointer to a label object
@@ -495,14 +712,34 @@ void lv_label_get_letter_pos(const lv_obj_t * label, uint16_t index, lv_point_t
 
     index = lv_txt_encoded_get_byte_id(txt, index);
 
-    /*Search the line of the index letter */;
-    while(txt[new_line_start] != '\0') {
-        new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
-        if(index < new_line_start || txt[new_line_start] == '\0')
-            break; /*The line of 'index' letter begins at 'line_start'*/
+    uint32_t line_id               = 0;
+    const lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    if(layout) {
+        /*Search the line of the index letter in the already calculated lines*/
+        uint32_t line_end = layout->line_cnt;
+        while(line_id + 1 < line_end) {
+            uint32_t mid = (line_id + line_end) / 2;
+            if(index >= layout->lines[mid].start)
+                line_id = mid;
+            else
+                line_end = mid;
+        }
+
+        if(layout->line_cnt > 0) {
+            line_start     = layout->lines[line_id].start;
+            new_line_start = layout->lines[line_id + 1].start;
+            y              = line_id * (letter_height + style->text.line_space);
+        }
+    } else {
+        /*Search the line of the index letter */;
+        while(txt[new_line_start] != '\0') {
+            new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
+            if(index < new_line_start || txt[new_line_start] == '\0')
+                break; /*The line of 'index' letter begins at 'line_start'*/
 
-        y += letter_height + style->text.line_space;
-        line_start = new_line_start;
+            y += letter_height + style->text.line_space;
+            line_start = new_line_start;
+        }
     }
 
     /*If the last character is line break then go to the next line*/
@@ -518,16 +755,21 @@ void lv_label_get_letter_pos(const lv_obj_t * label, uint16_t index, lv_point_t
 
     if(index != line_start) x += style->text.letter_space;
 
-    if(ext->align == LV_LABEL_ALIGN_CENTER) {
-        lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
-        x += lv_obj_get_width(label) / 2 - line_w / 2;
-
-    } else if(ext->align == LV_LABEL_ALIGN_RIGHT) {
+    if(ext->align == LV_LABEL_ALIGN_CENTER || ext->align == LV_LABEL_ALIGN_RIGHT) {
         lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        if(layout && layout->line_cnt > 0 && line_start == layout->lines[line_id].start) {
+            line_w = layout->lines[line_id].width;
+        } else {
+            line_w =
+                lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        }
 
-        x += lv_obj_get_width(label) - line_w;
+        /*Rounded as the lines are drawn*/
+        if(ext->align == LV_LABEL_ALIGN_CENTER) {
+            x += (lv_obj_get_width(label) - line_w) / 2;
+        } else {
+            x += lv_obj_get_width(label) - line_w;
+        }
     }
     pos->x = x;
     pos->y = y;
@@ -562,21 +804,34 @@ uint16_t lv_label_get_letter_on(const lv_obj_t * label, lv_point_t * pos)
         max_w = LV_COORD_MAX;
     }
 
-    /*Search the line of the index letter */;
-    while(txt[line_start] != '\0') {
-        new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
+    uint32_t line_id               = 0;
+    const lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    if(layout) {
+        line_id        = lv_label_get_line_on(layout, pos->y, letter_height, style->text.line_space);
+        line_start     = layout->lines[line_id].start;
+        new_line_start = layout->lines[LV_MATH_MIN(line_id + 1, layout->line_cnt)].start;
+    } else {
+        /*Search the line of the index letter */;
+        while(txt[line_start] != '\0') {
+            new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
 
-        if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
-        y += letter_height + style->text.line_space;
+            if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
+            y += letter_height + style->text.line_space;
 
-        line_start = new_line_start;
+            line_start = new_line_start;
+        }
     }
 
     /*Calculate the x coordinate*/
     lv_coord_t x = 0;
     if(ext->align == LV_LABEL_ALIGN_CENTER) {
         lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        if(layout) {
+            line_w = line_id < layout->line_cnt ? layout->lines[line_id].width : 0;
+        } else {
+            line_w =
+                lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        }
         x += lv_obj_get_width(label) / 2 - line_w / 2;
     }
 
@@ -677,14 +932,22 @@ bool lv_label_is_char_under_pos(const lv_obj_t * label, lv_point_t * pos)
         max_w = LV_COORD_MAX;
     }
 
-    /*Search the line of the index letter */;
-    while(txt[line_start] != '\0') {
-        new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
+    uint32_t line_id               = 0;
+    const lv_txt_layout_t * layout = lv_label_get_layout(label, max_w, flag);
+    if(layout) {
+        line_id        = lv_label_get_line_on(layout, pos->y, letter_height, style->text.line_space);
+        line_start     = layout->lines[line_id].start;
+        new_line_start = layout->lines[LV_MATH_MIN(line_id + 1, layout->line_cnt)].start;
+    } else {
+        /*Search the line of the index letter */;
+        while(txt[line_start] != '\0') {
+            new_line_start += lv_txt_get_next_line(&txt[line_start], font, style->text.letter_space, max_w, flag);
 
-        if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
-        y += letter_height + style->text.line_space;
+            if(pos->y <= y + letter_height) break; /*The line is found (stored in 'line_start')*/
+            y += letter_height + style->text.line_space;
 
-        line_start = new_line_start;
+            line_start = new_line_start;
+        }
     }
 
     /*Calculate the x coordinate*/
@@ -692,7 +955,12 @@ bool lv_label_is_char_under_pos(const lv_obj_t * label, lv_point_t * pos)
     lv_coord_t last_x = 0;
     if(ext->align == LV_LABEL_ALIGN_CENTER) {
         lv_coord_t line_w;
-        line_w = lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        if(layout) {
+            line_w = line_id < layout->line_cnt ? layout->lines[line_id].width : 0;
+        } else {
+            line_w =
+                lv_txt_get_width(&txt[line_start], new_line_start - line_start, font, style->text.letter_space, flag);
+        }
         x += lv_obj_get_width(label) / 2 - line_w / 2;
     }
 
@@ -751,23 +1019,29 @@ void lv_label_ins_text(lv_obj_t * label, uint32_t pos, const char * txt)
     /*Can not append to static text*/
     if(ext->static_txt != 0) return;
 
-    lv_obj_invalidate(label);
+    bool layout_valid = lv_label_is_layout_editable(label);
+    if(layout_valid == false) lv_obj_invalidate(label);
 
-    /*Allocate space for the new text*/
+    /*Allocate space for the new text.
+     *Reserve some more to not reallocate and copy the whole text on every inserted character*/
     uint32_t old_len = strlen(ext->text);
     uint32_t ins_len = strlen(txt);
     uint32_t new_len = ins_len + old_len;
-    ext->text        = lv_mem_realloc(ext->text, new_len + 1);
-    lv_mem_assert(ext->text);
-    if(ext->text == NULL) return;
+    if(lv_mem_get_size(ext->text) < new_len + 1) {
+        if(lv_label_text_grow(label, new_len + 1 + new_len / LV_LABEL_TXT_RESERVE_DIV) == false) return;
+    }
 
     if(pos == LV_LABEL_POS_LAST) {
         pos = lv_txt_get_encoded_length(ext->text);
     }
 
+    uint32_t byte_pos = lv_txt_encoded_get_byte_id(ext->text, pos);
     lv_txt_ins(ext->text, pos, txt);
 
-    lv_label_refr_text(label);
+    if(layout_valid)
+        lv_label_refr_lines(label, byte_pos, 0, ins_len);
+    else
+        lv_label_refr_text(label);
 }
 
 /**
@@ -784,14 +1058,21 @@ void lv_label_cut_text(lv_obj_t * label, uint32_t pos, uint32_t cnt)
     /*Can not append to static text*/
     if(ext->static_txt != 0) return;
 
-    lv_obj_invalidate(label);
+    bool layout_valid = lv_label_is_layout_editable(label);
+    if(layout_valid == false) lv_obj_invalidate(label);
+
+    char * label_txt  = lv_label_get_text(label);
+    uint32_t old_len  = strlen(label_txt);
+    uint32_t byte_pos = lv_txt_encoded_get_byte_id(label_txt, pos);
 
-    char * label_txt = lv_label_get_text(label);
     /*Delete the characters*/
     lv_txt_cut(label_txt, pos, cnt);
 
     /*Refresh the label*/
-    lv_label_refr_text(label);
+    if(layout_valid)
+        lv_label_refr_lines(label, byte_pos, old_len - strlen(label_txt), 0);
+    else
+        lv_label_refr_text(label);
 }
 
 /**********************
@@ -853,8 +1134,7 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
         if((ext->long_mode == LV_LABEL_LONG_SROLL || ext->long_mode == LV_LABEL_LONG_SROLL_CIRC) &&
            (ext->align == LV_LABEL_ALIGN_CENTER || ext->align == LV_LABEL_ALIGN_RIGHT)) {
             lv_point_t size;
-            lv_txt_get_size(&size, ext->text, style->text.font, style->text.letter_space, style->text.line_space,
-                            LV_COORD_MAX, flag);
+            lv_label_get_text_size(label, &size, flag);
             if(size.x > lv_obj_get_width(label)) {
                 flag &= ~LV_TXT_FLAG_RIGHT;
                 flag &= ~LV_TXT_FLAG_CENTER;
@@ -865,13 +1145,22 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
         if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC || lv_obj_get_height(label) < LV_LABEL_HINT_HEIGHT_LIMIT)
             hint = NULL;
 
+#if LV_LABEL_ROLL_STRIP
+        /*The rolling text is copied from its strip to the offset instead of drawing the letters*/
+        if(ext->strip != NULL && ext->offset.y == 0 && lv_label_get_text_sel_start(label) == LV_LABEL_TEXT_SEL_OFF) {
+            lv_label_strip_draw(label, &coords, mask, style, opa_scale);
+            return true;
+        }
+#endif
+
+        const lv_txt_layout_t * layout = lv_label_get_layout(label, lv_area_get_width(&coords), flag);
+
         lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ext->offset,
-                      lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), hint);
+                      lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), hint, layout);
 
         if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC) {
             lv_point_t size;
-            lv_txt_get_size(&size, ext->text, style->text.font, style->text.letter_space, style->text.line_space,
-                            LV_COORD_MAX, flag);
+            lv_label_get_text_size(label, &size, flag);
 
             lv_point_t ofs;
 
@@ -882,7 +1171,7 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
                 ofs.y = ext->offset.y;
 
                 lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ofs,
-                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL);
+                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL, layout);
             }
 
             /*Draw the text again below the original to make an circular effect */
@@ -890,7 +1179,7 @@ static bool lv_label_design(lv_obj_t * label, const lv_area_t * mask, lv_design_
                 ofs.x = ext->offset.x;
                 ofs.y = ext->offset.y + size.y + lv_font_get_line_height(style->text.font);
                 lv_draw_label(&coords, mask, style, opa_scale, ext->text, flag, &ofs,
-                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL);
+                              lv_label_get_text_sel_start(label), lv_label_get_text_sel_end(label), NULL, layout);
             }
         }
     }
@@ -919,16 +1208,26 @@ static lv_res_t lv_label_signal(lv_obj_t * label, lv_signal_t sign, void * param
             ext->text = NULL;
         }
         lv_label_dot_tmp_free(label);
+        lv_txt_layout_free(&ext->layout);
+#if LV_LABEL_ROLL_STRIP
+        lv_label_strip_free(label);
+#endif
     } else if(sign == LV_SIGNAL_STYLE_CHG) {
         /*Revert dots for proper refresh*/
         lv_label_revert_dots(label);
+        lv_label_refr_digit_cells(label);
 
         lv_label_refr_text(label);
     } else if(sign == LV_SIGNAL_CORD_CHG) {
-        if(lv_area_get_width(&label->coords) != lv_area_get_width(param) ||
-           lv_area_get_height(&label->coords) != lv_area_get_height(param)) {
+        if(lv_area_get_width(&label->coords) != lv_area_get_width(param)) {
             lv_label_revert_dots(label);
             lv_label_refr_text(label);
+        } else if(lv_area_get_height(&label->coords) != lv_area_get_height(param)) {
+            /*In break mode the lines don't depend on the height. If they are the current ones it's their height.*/
+            if(lv_label_is_layout_editable(label) == false || lv_obj_get_height(label) != ext->layout.size.y) {
+                lv_label_revert_dots(label);
+                lv_label_refr_text(label);
+            }
         }
     } else if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         if(ext->body_draw) {
@@ -962,6 +1261,10 @@ static void lv_label_refr_text(lv_obj_t * label)
     if(ext->text == NULL) return;
 
     ext->hint.line_start = -1; /*The hint is invalid if the text changes*/
+    lv_txt_layout_invalidate(&ext->layout);
+#if LV_LABEL_ROLL_STRIP
+    lv_label_strip_free(label);
+#endif
 
     lv_coord_t max_w         = lv_obj_get_width(label);
     const lv_style_t * style = lv_obj_get_style(label);
@@ -977,7 +1280,15 @@ static void lv_label_refr_text(lv_obj_t * label)
     lv_txt_flag_t flag = LV_TXT_FLAG_NONE;
     if(ext->recolor != 0) flag |= LV_TXT_FLAG_RECOLOR;
     if(ext->expand != 0) flag |= LV_TXT_FLAG_EXPAND;
-    lv_txt_get_size(&size, ext->text, font, style->text.letter_space, style->text.line_space, max_w, flag);
+
+    /*In break mode the width is kept so calculate the final lines already and use their size*/
+    if(ext->long_mode == LV_LABEL_LONG_BREAK &&
+       lv_txt_layout_update(&ext->layout, ext->text, font, style->text.letter_space, style->text.line_space, max_w,
+                            flag)) {
+        size = ext->layout.size;
+    } else {
+        lv_txt_get_size(&size, ext->text, font, style->text.letter_space, style->text.line_space, max_w, flag);
+    }
 
     /*Set the full size in expand mode*/
     if(ext->long_mode == LV_LABEL_LONG_EXPAND) {
@@ -1110,9 +1421,219 @@ static void lv_label_refr_text(lv_obj_t * label)
         /*Do nothing*/
     }
 
+    /*Calculate the lines with the final text and size the same way as the drawing will need them*/
+    lv_txt_layout_update(&ext->layout, ext->text, font, style->text.letter_space, style->text.line_space,
+                         lv_obj_get_width(label), flag);
+
     lv_obj_invalidate(label);
 }
 
+/**
+ * Check whether the lines of a label can be updated after an edit instead of refreshing the whole text
+ * @param label pointer to a label object
+ * @return true: `lv_label_refr_lines` can be used
+ */
+static bool lv_label_is_layout_editable(const lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    /*Only in break mode the size depends on the lines only. The body is drawn on the whole label.*/
+    if(ext->long_mode != LV_LABEL_LONG_BREAK || ext->body_draw != 0) return false;
+
+    lv_txt_flag_t flag = LV_TXT_FLAG_NONE;
+    if(ext->recolor != 0) flag |= LV_TXT_FLAG_RECOLOR;
+    if(ext->expand != 0) flag |= LV_TXT_FLAG_EXPAND;
+
+    return lv_label_get_layout(label, lv_obj_get_width(label), flag) != NULL;
+}
+
+/**
+ * Refresh a label after a part of its text was replaced. Only the changed lines are measured and redrawn.
+ * @param label pointer to a label object whose layout was editable before the edit
+ * @param pos byte index of the edit
+ * @param del_len number of deleted bytes
+ * @param ins_len number of inserted bytes
+ */
+static void lv_label_refr_lines(lv_obj_t * label, uint32_t pos, uint32_t del_len, uint32_t ins_len)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    ext->hint.line_start = -1; /*The hint is invalid if the text changes*/
+
+    uint32_t old_cnt = ext->layout.line_cnt;
+    lv_coord_t old_h = ext->layout.size.y;
+    uint32_t first;
+    uint32_t last;
+    if(lv_txt_layout_edit(&ext->layout, ext->text, pos, del_len, ins_len, &first, &last) == false) {
+        lv_obj_invalidate(label);
+        lv_label_refr_text(label);
+        return;
+    }
+
+    /*Redraw the measured lines or everything below them if the lines after them moved*/
+    const lv_style_t * style = lv_obj_get_style(label);
+    lv_coord_t line_h        = lv_font_get_line_height(style->text.font) + style->text.line_space;
+    lv_area_t area;
+    area.x1 = label->coords.x1;
+    area.x2 = label->coords.x2;
+    area.y1 = label->coords.y1 + ext->offset.y + first * line_h;
+    if(ext->layout.line_cnt == old_cnt && ext->layout.size.y == old_h) {
+        area.y2 = area.y1 + (last - first + 1) * line_h - 1;
+    } else {
+        area.y2 = label->coords.y2;
+    }
+    lv_obj_invalidate_area(label, &area);
+
+    /*Invalidates the whole label only if the height really changes*/
+    lv_obj_set_height(label, ext->layout.size.y);
+}
+
+/**
+ * Make the dynamically allocated text of a label at least `size` bytes large. The text is kept.
+ * If memory is reserved for the text it's at least doubled.
+ * @param label pointer to a label object
+ * @param size the required size in bytes
+ * @return true: the text is large enough; false: out of memory
+ */
+static bool lv_label_text_grow(lv_obj_t * label, uint32_t size)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    uint32_t old_size = lv_mem_get_size(ext->text);
+    if(old_size >= size) return true;
+
+    if(ext->reserve != 0) size = LV_MATH_MAX(size, old_size * 2);
+
+    char * new_txt = lv_mem_realloc(ext->text, size);
+    lv_mem_assert(new_txt);
+    if(new_txt == NULL) return false;
+
+    ext->text = new_txt;
+    return true;
+}
+
+/**
+ * Check whether a label has a given text already
+ * @param label pointer to a label object
+ * @param text the text to compare with, it doesn't need to be '\0' terminated
+ * @param len length of `text` in bytes
+ * @return true: the label's own dynamic text is the same; false: other text, static text or text with dots
+ */
+static bool lv_label_is_text_same(const lv_obj_t * label, const char * text, uint32_t len)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    if(ext->text == NULL || ext->static_txt != 0 || ext->dot_end != LV_LABEL_DOT_END_INV) return false;
+
+    return strlen(ext->text) == len && memcmp(ext->text, text, len) == 0;
+}
+
+/**
+ * Measure the digit cells of a label in numeric mode (see `lv_label_set_digit_cells`)
+ * @param label pointer to a label object
+ */
+static void lv_label_refr_digit_cells(lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    ext->digit_w = 0;
+    if(ext->digit_cells == 0) return;
+
+    /*Every digit has to be as wide as the others, with any digit or nothing after it (kerning)*/
+    const lv_font_t * font = lv_obj_get_style(label)->text.font;
+    lv_coord_t w           = lv_font_get_glyph_width(font, '0', '\0');
+    lv_coord_t x1          = 0;
+    lv_coord_t x2          = w;
+    uint32_t d;
+    uint32_t next;
+    for(d = '0'; d <= '9'; d++) {
+        lv_font_glyph_dsc_t g;
+        if(lv_font_get_glyph_dsc(font, &g, d, '\0') == false) return;
+        if(lv_font_get_glyph_width(font, d, '\0') != w) return;
+        for(next = '0'; next <= '9'; next++) {
+            if(lv_font_get_glyph_width(font, d, next) != w) return;
+        }
+
+        x1 = LV_MATH_MIN(x1, g.ofs_x);
+        x2 = LV_MATH_MAX(x2, g.ofs_x + g.box_w);
+    }
+
+    ext->digit_w  = w;
+    ext->digit_x1 = x1;
+    ext->digit_x2 = x2;
+}
+
+/**
+ * Set a new text in numeric mode if only digits change: they are replaced in place
+ * and only their cells are invalidated. The size and the lines of the label stay the same.
+ * @param label pointer to a label object
+ * @param text the new text, it doesn't need to be '\0' terminated
+ * @param len length of `text` in bytes
+ * @return true: the text is set; false: set it as usual
+ */
+static bool lv_label_set_digits(lv_obj_t * label, const char * text, uint32_t len)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+
+    if(ext->digit_w == 0 || ext->text == NULL || ext->static_txt != 0 || ext->recolor != 0) return false;
+    if(ext->dot_end != LV_LABEL_DOT_END_INV) return false;
+    if(ext->long_mode == LV_LABEL_LONG_SROLL || ext->long_mode == LV_LABEL_LONG_SROLL_CIRC) return false;
+    if(strlen(ext->text) != len) return false;
+
+    /*Only digits can change and their kerning with the other neighbors can't*/
+    const lv_style_t * style = lv_obj_get_style(label);
+    const lv_font_t * font   = style->text.font;
+    uint32_t first           = len;
+    uint32_t last            = 0;
+    uint32_t i;
+    for(i = 0; i < len; i++) {
+        char old_c = ext->text[i];
+        char new_c = text[i];
+        if(old_c == new_c) continue;
+        if(old_c < '0' || old_c > '9' || new_c < '0' || new_c > '9') return false;
+
+        if(i > 0 && (text[i - 1] < '0' || text[i - 1] > '9')) {
+            uint8_t prev = text[i - 1];
+            if(prev >= 0x80) return false;
+            if(lv_font_get_glyph_width(font, prev, old_c) != lv_font_get_glyph_width(font, prev, new_c)) return false;
+        }
+        if(i + 1 < len && (text[i + 1] < '0' || text[i + 1] > '9')) {
+            uint8_t next = text[i + 1];
+            if(next >= 0x80) return false;
+            if(lv_font_get_glyph_width(font, old_c, next) != lv_font_get_glyph_width(font, new_c, next)) return false;
+        }
+
+        if(first == len) first = i;
+        last = i;
+    }
+
+    /*Invalidate the runs of changed digits. They are in the same place in the old and the new text.*/
+    lv_coord_t line_h = lv_font_get_line_height(font);
+    for(i = first; i <= last; i++) {
+        if(ext->text[i] == text[i]) continue;
+
+        uint32_t run_end = i;
+        while(run_end < last && ext->text[run_end + 1] != text[run_end + 1]) run_end++;
+
+        lv_point_t pos;
+        lv_label_get_letter_pos(label, lv_encoded_get_char_id(ext->text, i), &pos);
+
+        lv_area_t area;
+        area.x1 = label->coords.x1 + ext->offset.x + pos.x + ext->digit_x1;
+        area.x2 = label->coords.x1 + ext->offset.x + pos.x + (run_end - i) * (ext->digit_w + style->text.letter_space) +
+                  ext->digit_x2 - 1;
+        area.y1 = label->coords.y1 + ext->offset.y + pos.y;
+        area.y2 = area.y1 + line_h - 1;
+        lv_obj_invalidate_area(label, &area);
+
+        i = run_end;
+    }
+
+    if(first < len) memcpy(&ext->text[first], &text[first], last - first + 1);
+
+    return true;
+}
+
 static void lv_label_revert_dots(lv_obj_t * label)
 {
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
@@ -1130,15 +1651,80 @@ static void lv_label_revert_dots(lv_obj_t * label)
     }
     ext->text[byte_i + i] = dot_tmp[i];
     lv_label_dot_tmp_free(label);
+    lv_txt_layout_invalidate(&ext->layout);
 
     ext->dot_end = LV_LABEL_DOT_END_INV;
 }
 
+/**
+ * Get the saved layout of a label if it was calculated with the given width and flags
+ * @param label pointer to a label object
+ * @param max_w the max. width of the lines
+ * @param flag the text flags
+ * @return pointer to the layout or NULL if the text needs to be measured
+ */
+static const lv_txt_layout_t * lv_label_get_layout(const lv_obj_t * label, lv_coord_t max_w, lv_txt_flag_t flag)
+{
+    lv_label_ext_t * ext     = lv_obj_get_ext_attr(label);
+    const lv_style_t * style = lv_obj_get_style(label);
+
+    if(lv_txt_layout_is_valid(&ext->layout, ext->text, style->text.font, style->text.letter_space,
+                              style->text.line_space, max_w, flag)) {
+        return &ext->layout;
+    }
+
+    return NULL;
+}
+
+/**
+ * Get the size of the text of a label without line breaks
+ * @param label pointer to a label object
+ * @param size store the size here
+ * @param flag the text flags
+ */
+static void lv_label_get_text_size(const lv_obj_t * label, lv_point_t * size, lv_txt_flag_t flag)
+{
+    const lv_txt_layout_t * layout = lv_label_get_layout(label, LV_COORD_MAX, flag);
+    if(layout) {
+        *size = layout->size;
+    } else {
+        lv_label_ext_t * ext     = lv_obj_get_ext_attr(label);
+        const lv_style_t * style = lv_obj_get_style(label);
+        lv_txt_get_size(size, ext->text, style->text.font, style->text.letter_space, style->text.line_space,
+                        LV_COORD_MAX, flag);
+    }
+}
+
+/**
+ * Get the line of a layout on a y coordinate the same way as `lv_label_get_letter_on` searches it
+ * @param layout pointer to a text layout
+ * @param y a y coordinate relative to the label
+ * @param letter_height height of the lines
+ * @param line_space space between the lines
+ * @return the index of the line. `line_cnt` if `y` is below the last line.
+ */
+static uint32_t lv_label_get_line_on(const lv_txt_layout_t * layout, lv_coord_t y, lv_coord_t letter_height,
+                                     lv_coord_t line_space)
+{
+    uint32_t line_id  = 0;
+    lv_coord_t line_y = 0;
+    while(line_id < layout->line_cnt) {
+        if(y <= line_y + letter_height) break;
+        line_y += letter_height + line_space;
+        line_id++;
+    }
+
+    return line_id;
+}
+
 #if LV_USE_ANIMATION
 static void lv_label_set_offset_x(lv_obj_t * label, lv_coord_t x)
 {
     lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
     ext->offset.x        = x;
+#if LV_LABEL_ROLL_STRIP
+    lv_label_strip_refr(label);
+#endif
     lv_obj_invalidate(label);
 }
 
@@ -1150,6 +1736,82 @@ static void lv_label_set_offset_y(lv_obj_t * label, lv_coord_t y)
 }
 #endif
 
+#if LV_LABEL_ROLL_STRIP
+/**
+ * Draw the text of a horizontally rolling label into its strip if it's not drawn yet.
+ * Called from the animation (not by the drawing threads) so the strip is ready when the label is drawn.
+ * @param label pointer to a label object
+ */
+static void lv_label_strip_refr(lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    if(ext->strip != NULL || ext->strip_none || ext->text == NULL) return;
+
+    /*Only one line of one color can be copied*/
+    if(ext->recolor || strpbrk(ext->text, "\n\r") != NULL ||
+       (ext->long_mode != LV_LABEL_LONG_SROLL && ext->long_mode != LV_LABEL_LONG_SROLL_CIRC)) {
+        ext->strip_none = 1;
+        return;
+    }
+
+    const lv_style_t * style = lv_obj_get_style(label);
+    ext->strip = lv_draw_label_strip_create(style, ext->text, LV_LABEL_ROLL_STRIP_MAX, &ext->strip_area);
+    if(ext->strip == NULL) {
+        ext->strip_none = 1;
+        return;
+    }
+
+    uint32_t len     = strlen(ext->text);
+    ext->strip_txt_w = lv_txt_get_width(ext->text, len > UINT16_MAX ? UINT16_MAX : len, style->text.font,
+                                        style->text.letter_space, LV_TXT_FLAG_NONE);
+}
+
+/**
+ * Copy the strip of a rolling label to its offset, twice in circular mode
+ * @param label pointer to a label object
+ * @param coords coordinates of the label
+ * @param mask the label will be drawn only in this area
+ * @param style the style of the label
+ * @param opa_scale scale down the opacity by the factor
+ */
+static void lv_label_strip_draw(lv_obj_t * label, const lv_area_t * coords, const lv_area_t * mask,
+                                const lv_style_t * style, lv_opa_t opa_scale)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    lv_opa_t opa = opa_scale == LV_OPA_COVER ? style->text.opa : (uint16_t)((uint16_t)style->text.opa * opa_scale) >> 8;
+
+    lv_area_t area;
+    lv_area_copy(&area, &ext->strip_area);
+    area.x1 += coords->x1 + ext->offset.x;
+    area.x2 += coords->x1 + ext->offset.x;
+    area.y1 += coords->y1 + ext->offset.y;
+    area.y2 += coords->y1 + ext->offset.y;
+    lv_draw_opa_map(&area, mask, ext->strip, style->text.color, opa);
+
+    /*Draw the text again next to the original to make an circular effect */
+    if(ext->long_mode == LV_LABEL_LONG_SROLL_CIRC && ext->strip_txt_w > lv_area_get_width(coords)) {
+        lv_coord_t gap = ext->strip_txt_w + lv_font_get_glyph_width(style->text.font, ' ', ' ') * LV_LABEL_WAIT_CHAR_COUNT;
+        area.x1 += gap;
+        area.x2 += gap;
+        lv_draw_opa_map(&area, mask, ext->strip, style->text.color, opa);
+    }
+}
+
+/**
+ * Free the strip of a label, it's drawn again when the label rolls
+ * @param label pointer to a label object
+ */
+static void lv_label_strip_free(lv_obj_t * label)
+{
+    lv_label_ext_t * ext = lv_obj_get_ext_attr(label);
+    if(ext->strip != NULL) {
+        lv_mem_free(ext->strip);
+        ext->strip = NULL;
+    }
+    ext->strip_none = 0;
+}
+#endif
+
 /**
  * Store `len` characters from `data`. Allocates space if necessary.
  *
@@ -34,6 +34,9 @@ extern "C" {
 #define LV_LABEL_POS_LAST 0xFFFF
 #define LV_LABEL_TEXT_SEL_OFF 0xFFFF
 
+/*The rolling texts are copied from an opacity map*/
+#define LV_LABEL_ROLL_STRIP (LV_USE_ANIMATION && LV_LABEL_ROLL_STRIP_MAX > 0)
+
 /**********************
  *      TYPEDEFS
  **********************/
@@ -74,10 +77,21 @@ typedef struct
     lv_point_t offset; /*Text draw position offset*/
 
     lv_draw_label_hint_t hint; /*Used to buffer info about large text*/
+    lv_txt_layout_t layout;    /*Line breaks of the text to not measure it on every draw*/
 #if LV_USE_ANIMATION
     uint16_t anim_speed; /*Speed of scroll and roll animation in px/sec unit*/
 #endif
 
+#if LV_LABEL_ROLL_STRIP
+    uint8_t * strip;      /*The rolling text drawn by `lv_draw_label_strip_create`, NULL if not drawn yet*/
+    lv_area_t strip_area; /*Area of `strip` relative to the text*/
+    lv_coord_t strip_txt_w; /*Width of the text in `strip`*/
+#endif
+
+    lv_coord_t digit_w;  /*Width of the digit cells, 0: the digits are not in cells (see `lv_label_set_digit_cells`)*/
+    lv_coord_t digit_x1; /*Left edge of the digits' bitmaps in their cells (<= 0)*/
+    lv_coord_t digit_x2; /*Right edge (exclusive) of the digits' bitmaps in their cells (>= `digit_w`)*/
+
 #if LV_LABEL_TEXT_SEL
     uint16_t txt_sel_start; /*Left-most selection character*/
     uint16_t txt_sel_end;   /*Right-most selection character*/
@@ -85,12 +99,17 @@ typedef struct
 
     lv_label_long_mode_t long_mode : 3; /*Determinate what to do with the long texts*/
     uint8_t static_txt : 1;             /*Flag to indicate the text is static*/
+    uint8_t reserve : 1;                /*Keep the memory of the text and grow it by doubling*/
     uint8_t align : 2;                  /*Align type from 'lv_label_align_t'*/
     uint8_t recolor : 1;                /*Enable in-line letter re-coloring*/
     uint8_t expand : 1;                 /*Ignore real width (used by the library with LV_LABEL_LONG_ROLL)*/
     uint8_t body_draw : 1;              /*Draw background body*/
+    uint8_t digit_cells : 1;            /*Redraw only the changed digits of a new text*/
     uint8_t dot_tmp_alloc : 1; /*True if dot_tmp has been allocated. False if dot_tmp directly holds up to 4 bytes of
                                   characters */
+#if LV_LABEL_ROLL_STRIP
+    uint8_t strip_none : 1; /*The text can't be drawn into a strip, don't try again until it changes*/
+#endif
 } lv_label_ext_t;
 
 /** Label styles*/
@@ -122,6 +141,14 @@ lv_obj_t * lv_label_create(lv_obj_t * par, const lv_obj_t * copy);
  */
 void lv_label_set_text(lv_obj_t * label, const char * text);
 
+/**
+ * Set a new formatted text for a label. The text is printed directly into the label's memory
+ * and nothing is redrawn if it's the same as the current text.
+ * @param label pointer to a label object
+ * @param fmt `printf`-like format
+ */
+void lv_label_set_text_fmt(lv_obj_t * label, const char * fmt, ...);
+
 /**
  * Set a new text for a label from a character array. The array don't has to be '\0' terminated.
  * Memory will be allocated to store the array by the label.
@@ -139,6 +166,17 @@ void lv_label_set_array_text(lv_obj_t * label, const char * array, uint16_t size
  */
 void lv_label_set_static_text(lv_obj_t * label, const char * text);
 
+/**
+ * Keep the memory of the text between the changes to not reallocate and copy it on every new text.
+ * If a longer text is set the memory is doubled, but it's never shrunk.
+ * Useful for frequently updated labels, e.g. counters and live values.
+ * A static text is copied into the reserved memory.
+ * @param label pointer to a label object
+ * @param size number of bytes to reserve now (with the closing '\0').
+ *             0: free the unused memory and allocate the exact size for each text again
+ */
+void lv_label_set_reserve(lv_obj_t * label, uint32_t size);
+
 /**
  * Set the behavior of the label with longer text then the object size
  * @param label pointer to a label object
@@ -169,6 +207,16 @@ void lv_label_set_recolor(lv_obj_t * label, bool en);
  */
 void lv_label_set_body_draw(lv_obj_t * label, bool en);
 
+/**
+ * Set the numeric display mode. If the digits of the font have the same width (as in most fonts)
+ * they are in fixed cells: a new text which differs only in some digits (e.g. the next value of a counter)
+ * redraws only their cells instead of the whole label.
+ * Not used with recoloring, with rolling texts and while dots are shown.
+ * @param label pointer to a label object
+ * @param en true: enable the numeric mode
+ */
+void lv_label_set_digit_cells(lv_obj_t * label, bool en);
+
 /**
  * Set the label's animation speed in LV_LABEL_LONG_SROLL/SCROLL_CIRC modes
  * @param label pointer to a label object
@@ -213,6 +261,13 @@ void lv_label_set_text_sel_end(lv_obj_t * label, uint16_t index);
  */
 char * lv_label_get_text(const lv_obj_t * label);
 
+/**
+ * Get the memory reserved for the text of a label
+ * @param label pointer to a label object
+ * @return size of the memory of the text in bytes or 0 if no memory is reserved
+ */
+uint32_t lv_label_get_reserve(const lv_obj_t * label);
+
 /**
  * Get the long mode of a label
  * @param label pointer to a label object
@@ -241,6 +296,13 @@ bool lv_label_get_recolor(const lv_obj_t * label);
  */
 bool lv_label_get_body_draw(const lv_obj_t * label);
 
+/**
+ * Get whether the numeric display mode is enabled
+ * @param label pointer to a label object
+ * @return true: only the changed digits are redrawn (see `lv_label_set_digit_cells`)
+ */
+bool lv_label_get_digit_cells(const lv_obj_t * label);
+
 /**
  * Get the label's animation speed in LV_LABEL_LONG_ROLL and SCROLL modes
  * @param label pointer to a label object
@@ -28,6 +28,10 @@
  **********************/
 static bool lv_line_design(lv_obj_t * line, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_line_signal(lv_obj_t * line, lv_signal_t sign, void * param);
+static const lv_point_t * point_get(const lv_line_ext_t * ext, uint16_t id);
+static void point_abs(const lv_obj_t * line, const lv_point_t * p, lv_point_t * abs);
+static void point_area(const lv_obj_t * line, const lv_point_t * p, lv_coord_t width, lv_area_t * area);
+static void segment_invalidate(lv_obj_t * line, const lv_point_t * p1, const lv_point_t * p2);
 
 /**********************
  *  STATIC VARIABLES
@@ -65,6 +69,9 @@ lv_obj_t * lv_line_create(lv_obj_t * par, const lv_obj_t * copy)
 
     ext->point_num   = 0;
     ext->point_array = NULL;
+    ext->ring        = NULL;
+    ext->ring_size   = 0;
+    ext->ring_start  = 0;
     ext->auto_size   = 1;
     ext->y_inv       = 0;
 
@@ -84,7 +91,14 @@ lv_obj_t * lv_line_create(lv_obj_t * par, const lv_obj_t * copy)
         lv_line_set_auto_size(new_line, lv_line_get_auto_size(copy));
         lv_line_set_y_invert(new_line, lv_line_get_y_invert(copy));
         lv_line_set_auto_size(new_line, lv_line_get_auto_size(copy));
-        lv_line_set_points(new_line, copy_ext->point_array, copy_ext->point_num);
+        if(copy_ext->ring) {
+            /*Store the points too, the copy's ring can wrap*/
+            lv_line_set_point_capacity(new_line, copy_ext->ring_size);
+            uint16_t i;
+            for(i = 0; i < copy_ext->point_num; i++) lv_line_append_point(new_line, point_get(copy_ext, i));
+        } else {
+            lv_line_set_points(new_line, copy_ext->point_array, copy_ext->point_num);
+        }
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_line);
     }
@@ -108,8 +122,14 @@ lv_obj_t * lv_line_create(lv_obj_t * par, const lv_obj_t * copy)
 void lv_line_set_points(lv_obj_t * line, const lv_point_t point_a[], uint16_t point_num)
 {
     lv_line_ext_t * ext = lv_obj_get_ext_attr(line);
-    ext->point_array    = point_a;
-    ext->point_num      = point_num;
+    if(ext->ring && point_a != ext->ring) {
+        lv_mem_free(ext->ring);
+        ext->ring       = NULL;
+        ext->ring_size  = 0;
+        ext->ring_start = 0;
+    }
+    ext->point_array = point_a;
+    ext->point_num   = point_num;
 
     if(point_num > 0 && ext->auto_size != 0) {
         uint16_t i;
@@ -141,7 +161,101 @@ void lv_line_set_auto_size(lv_obj_t * line, bool en)
     ext->auto_size = en == false ? 0 : 1;
 
     /*Refresh the object*/
-    if(en) lv_line_set_points(line, ext->point_array, ext->point_num);
+    if(en && ext->ring) {
+        /*The stored points can wrap, set the size to them and keep them*/
+        lv_coord_t xmax = LV_COORD_MIN;
+        lv_coord_t ymax = LV_COORD_MIN;
+        uint16_t i;
+        for(i = 0; i < ext->point_num; i++) {
+            xmax = LV_MATH_MAX(point_get(ext, i)->x, xmax);
+            ymax = LV_MATH_MAX(point_get(ext, i)->y, ymax);
+        }
+        const lv_style_t * style = lv_line_get_style(line, LV_LINE_STYLE_MAIN);
+        if(ext->point_num > 0) lv_obj_set_size(line, xmax + style->line.width, ymax + style->line.width);
+        lv_obj_invalidate(line);
+    } else if(en) {
+        lv_line_set_points(line, ext->point_array, ext->point_num);
+    }
+}
+
+/**
+ * Let the line store its points in a ring buffer for `lv_line_append_point`.
+ * The current points are copied into it (the last `capacity` of them).
+ * @param line pointer to a line object
+ * @param capacity max. number of points. 0: free the buffer and keep no points.
+ */
+void lv_line_set_point_capacity(lv_obj_t * line, uint16_t capacity)
+{
+    lv_line_ext_t * ext = lv_obj_get_ext_attr(line);
+
+    lv_point_t * ring = NULL;
+    uint16_t num      = 0;
+    if(capacity > 0) {
+        ring = lv_mem_alloc(capacity * sizeof(lv_point_t));
+        lv_mem_assert(ring);
+        if(ring == NULL) return;
+
+        num = LV_MATH_MIN(ext->point_num, capacity);
+        uint16_t i;
+        for(i = 0; i < num; i++) ring[i] = *point_get(ext, ext->point_num - num + i);
+    }
+
+    lv_mem_free(ext->ring);
+    ext->ring        = ring;
+    ext->ring_size   = capacity;
+    ext->ring_start  = 0;
+    ext->point_array = ring;
+    ext->point_num   = num;
+
+    lv_obj_invalidate(line);
+}
+
+/**
+ * Add a point to the end of the line, e.g. the next sample of a live trace.
+ * If the buffer set by `lv_line_set_point_capacity` is full the first point is dropped.
+ * Only the new (and the dropped) segment is redrawn. With auto size the object only grows.
+ * @param line pointer to a line object
+ * @param point the new point
+ */
+void lv_line_append_point(lv_obj_t * line, const lv_point_t * point)
+{
+    lv_line_ext_t * ext = lv_obj_get_ext_attr(line);
+    if(ext->ring == NULL) {
+        LV_LOG_WARN("lv_line_append_point: no point buffer, use `lv_line_set_point_capacity`");
+        return;
+    }
+
+    /*Drop the first point (and its segment) if the ring is full*/
+    if(ext->point_num == ext->ring_size) {
+        if(ext->point_num > 1) segment_invalidate(line, point_get(ext, 0), point_get(ext, 1));
+        ext->ring_start++;
+        if(ext->ring_start >= ext->ring_size) ext->ring_start = 0;
+        ext->point_num--;
+    }
+
+    uint32_t id = (uint32_t)ext->ring_start + ext->point_num;
+    if(id >= ext->ring_size) id -= ext->ring_size;
+    ext->ring[id] = *point;
+    ext->point_num++;
+
+    /*Grow the object for the new point. It redraws all of it.*/
+    if(ext->auto_size) {
+        const lv_style_t * style = lv_line_get_style(line, LV_LINE_STYLE_MAIN);
+        lv_coord_t w             = LV_MATH_MAX(lv_obj_get_width(line), point->x + style->line.width);
+        lv_coord_t h             = LV_MATH_MAX(lv_obj_get_height(line), point->y + style->line.width);
+        if(ext->point_num == 1) {
+            w = point->x + style->line.width;
+            h = point->y + style->line.width;
+        }
+        if(w != lv_obj_get_width(line) || h != lv_obj_get_height(line)) {
+            lv_obj_set_size(line, w, h);
+            return;
+        }
+    }
+
+    /*The joint of the previous point changes too, it's in the area of the new segment*/
+    if(ext->point_num > 1) segment_invalidate(line, point_get(ext, ext->point_num - 2), point);
+    else segment_invalidate(line, point, point);
 }
 
 /**
@@ -215,56 +329,44 @@ static bool lv_line_design(lv_obj_t * line, const lv_area_t * mask, lv_design_mo
 
         const lv_style_t * style = lv_obj_get_style(line);
         lv_opa_t opa_scale       = lv_obj_get_opa_scale(line);
-        lv_area_t area;
-        lv_obj_get_coords(line, &area);
-        lv_coord_t x_ofs = area.x1;
-        lv_coord_t y_ofs = area.y1;
-        lv_point_t p1;
-        lv_point_t p2;
-        lv_coord_t h = lv_obj_get_height(line);
         uint16_t i;
 
-        lv_style_t circle_style_tmp; /*If rounded...*/
-        lv_style_copy(&circle_style_tmp, style);
-        circle_style_tmp.body.radius     = LV_RADIUS_CIRCLE;
-        circle_style_tmp.body.main_color = style->line.color;
-        circle_style_tmp.body.grad_color = style->line.color;
-        circle_style_tmp.body.opa        = style->line.opa;
-        lv_area_t circle_area;
-
-        /*Read all points and draw the lines*/
-        for(i = 0; i < ext->point_num - 1; i++) {
-
-            p1.x = ext->point_array[i].x + x_ofs;
-            p2.x = ext->point_array[i + 1].x + x_ofs;
-
-            if(ext->y_inv == 0) {
-                p1.y = ext->point_array[i].y + y_ofs;
-                p2.y = ext->point_array[i + 1].y + y_ofs;
-            } else {
-                p1.y = h - ext->point_array[i].y + y_ofs;
-                p2.y = h - ext->point_array[i + 1].y + y_ofs;
+        /*Only the segments on the mask are drawn (e.g. only the new one after `lv_line_append_point`),
+         *with one more point on both sides for the joints*/
+        uint16_t first = ext->point_num;
+        uint16_t last  = 0;
+        lv_area_t seg;
+        lv_area_t p_area;
+        point_area(line, point_get(ext, 0), style->line.width, &p_area);
+        for(i = 0; i < ext->point_num; i++) {
+            lv_area_copy(&seg, &p_area);
+            if(i + 1 < ext->point_num) {
+                point_area(line, point_get(ext, i + 1), style->line.width, &p_area);
+                seg.x1 = LV_MATH_MIN(seg.x1, p_area.x1);
+                seg.y1 = LV_MATH_MIN(seg.y1, p_area.y1);
+                seg.x2 = LV_MATH_MAX(seg.x2, p_area.x2);
+                seg.y2 = LV_MATH_MAX(seg.y2, p_area.y2);
             }
-            lv_draw_line(&p1, &p2, mask, style, opa_scale);
-
-            /*Draw circle on the joints if enabled*/
-            if(style->line.rounded) {
-                circle_area.x1 = p1.x - ((style->line.width - 1) >> 1) - ((style->line.width - 1) & 0x1);
-                circle_area.y1 = p1.y - ((style->line.width - 1) >> 1) - ((style->line.width - 1) & 0x1);
-                circle_area.x2 = p1.x + ((style->line.width - 1) >> 1);
-                circle_area.y2 = p1.y + ((style->line.width - 1) >> 1);
-                lv_draw_rect(&circle_area, mask, &circle_style_tmp, opa_scale);
+            if(lv_area_is_on(&seg, mask)) {
+                if(first == ext->point_num) first = i;
+                last = i;
             }
         }
+        if(first == ext->point_num) return true;
+        if(first > 0) first--;
+        last = LV_MATH_MIN(last + 2, ext->point_num - 1);
+        uint16_t cnt = last - first + 1;
 
-        /*Draw circle on the last point too if enabled*/
-        if(style->line.rounded) {
-            circle_area.x1 = p2.x - ((style->line.width - 1) >> 1) - ((style->line.width - 1) & 0x1);
-            circle_area.y1 = p2.y - ((style->line.width - 1) >> 1) - ((style->line.width - 1) & 0x1);
-            circle_area.x2 = p2.x + ((style->line.width - 1) >> 1);
-            circle_area.y2 = p2.y + ((style->line.width - 1) >> 1);
-            lv_draw_rect(&circle_area, mask, &circle_style_tmp, opa_scale);
-        }
+        lv_draw_scratch_mark_t mark;
+        lv_draw_scratch_mark(&mark);
+        lv_point_t * points = lv_draw_scratch_alloc(cnt * sizeof(lv_point_t));
+        if(points == NULL) return false;
+
+        for(i = 0; i < cnt; i++) point_abs(line, point_get(ext, first + i), &points[i]);
+
+        /*Draw all lines at once to get proper (and round if enabled) joints*/
+        lv_draw_polyline(points, cnt, mask, style, opa_scale);
+        lv_draw_scratch_release(&mark);
     }
     return true;
 }
@@ -290,6 +392,11 @@ static lv_res_t lv_line_signal(lv_obj_t * line, lv_signal_t sign, void * param)
             if(buf->type[i] == NULL) break;
         }
         buf->type[i] = "lv_line";
+    } else if(sign == LV_SIGNAL_CLEANUP) {
+        lv_line_ext_t * ext = lv_obj_get_ext_attr(line);
+        lv_mem_free(ext->ring);
+        ext->ring        = NULL;
+        ext->point_array = NULL;
     } else if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         const lv_style_t * style = lv_line_get_style(line, LV_LINE_STYLE_MAIN);
         if(line->ext_draw_pad < style->line.width) line->ext_draw_pad = style->line.width;
@@ -297,4 +404,51 @@ static lv_res_t lv_line_signal(lv_obj_t * line, lv_signal_t sign, void * param)
 
     return res;
 }
+
+/*A point of the line, `point_array` can be a ring*/
+static const lv_point_t * point_get(const lv_line_ext_t * ext, uint16_t id)
+{
+    if(ext->ring == NULL) return &ext->point_array[id];
+
+    uint32_t i = (uint32_t)ext->ring_start + id;
+    if(i >= ext->ring_size) i -= ext->ring_size;
+    return &ext->ring[i];
+}
+
+/*The absolute coordinates of a point of the line*/
+static void point_abs(const lv_obj_t * line, const lv_point_t * p, lv_point_t * abs)
+{
+    lv_line_ext_t * ext = lv_obj_get_ext_attr(line);
+
+    abs->x = line->coords.x1 + p->x;
+    if(ext->y_inv == 0) abs->y = line->coords.y1 + p->y;
+    else abs->y = line->coords.y1 + lv_obj_get_height(line) - p->y;
+}
+
+/*The absolute area a point of the line can draw on: the point +- the line width*/
+static void point_area(const lv_obj_t * line, const lv_point_t * p, lv_coord_t width, lv_area_t * area)
+{
+    lv_point_t abs;
+    point_abs(line, p, &abs);
+
+    area->x1 = abs.x - width;
+    area->y1 = abs.y - width;
+    area->x2 = abs.x + width;
+    area->y2 = abs.y + width;
+}
+
+static void segment_invalidate(lv_obj_t * line, const lv_point_t * p1, const lv_point_t * p2)
+{
+    const lv_style_t * style = lv_line_get_style(line, LV_LINE_STYLE_MAIN);
+    lv_area_t a1;
+    lv_area_t a2;
+    point_area(line, p1, style->line.width, &a1);
+    point_area(line, p2, style->line.width, &a2);
+    a1.x1 = LV_MATH_MIN(a1.x1, a2.x1);
+    a1.y1 = LV_MATH_MIN(a1.y1, a2.y1);
+    a1.x2 = LV_MATH_MAX(a1.x2, a2.x2);
+    a1.y2 = LV_MATH_MAX(a1.y2, a2.y2);
+    lv_obj_invalidate_area(line, &a1);
+}
+
 #endif
@@ -37,6 +37,9 @@ typedef struct
     /*Inherited from 'base_obj' so no inherited ext.*/ /*Ext. of ancestor*/
     const lv_point_t * point_array;                    /*Pointer to an array with the points of the line*/
     uint16_t point_num;                                /*Number of points in 'point_array' */
+    lv_point_t * ring;     /*Points stored by the line for `lv_line_append_point`. NULL: `point_array` is the user's*/
+    uint16_t ring_size;    /*Capacity of `ring`*/
+    uint16_t ring_start;   /*Index of the first point in `ring`, the points wrap around its end*/
     uint8_t auto_size : 1;                             /*1: set obj. width to x max and obj. height to y max */
     uint8_t y_inv : 1;                                 /*1: y == 0 will be on the bottom*/
 } lv_line_ext_t;
@@ -71,6 +74,23 @@ lv_obj_t * lv_line_create(lv_obj_t * par, const lv_obj_t * copy);
  */
 void lv_line_set_points(lv_obj_t * line, const lv_point_t point_a[], uint16_t point_num);
 
+/**
+ * Let the line store its points in a ring buffer for `lv_line_append_point`.
+ * The current points are copied into it (the last `capacity` of them).
+ * @param line pointer to a line object
+ * @param capacity max. number of points. 0: free the buffer and keep no points.
+ */
+void lv_line_set_point_capacity(lv_obj_t * line, uint16_t capacity);
+
+/**
+ * Add a point to the end of the line, e.g. the next sample of a live trace.
+ * If the buffer set by `lv_line_set_point_capacity` is full the first point is dropped.
+ * Only the new (and the dropped) segment is redrawn. With auto size the object only grows.
+ * @param line pointer to a line object
+ * @param point the new point
+ */
+void lv_line_append_point(lv_obj_t * line, const lv_point_t * point);
+
 /**
  * Enable (or disable) the auto-size option. The size of the object will fit to its points.
  * (set width to x max and height to y max)
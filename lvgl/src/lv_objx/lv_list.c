@@ -11,6 +11,7 @@
 
 #include "../lv_core/lv_group.h"
 #include "../lv_themes/lv_theme.h"
+#include "../lv_core/lv_refr.h"
 #include "../lv_misc/lv_anim.h"
 #include "../lv_misc/lv_math.h"
 
@@ -37,6 +38,14 @@ static void lv_list_btn_single_select(lv_obj_t * btn);
 static bool lv_list_is_list_btn(lv_obj_t * list_btn);
 static bool lv_list_is_list_img(lv_obj_t * list_btn);
 static bool lv_list_is_list_label(lv_obj_t * list_btn);
+#if LV_LIST_VIRTUAL
+static lv_res_t lv_list_virtual_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void * param);
+static void lv_list_virtual_refr_rows(lv_obj_t * list);
+static void lv_list_virtual_place(lv_obj_t * list);
+static void lv_list_virtual_scroll(lv_obj_t * list);
+static void lv_list_virtual_sb_refr(lv_obj_t * list);
+static void lv_list_virtual_free(lv_obj_t * list);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -47,6 +56,9 @@ static lv_signal_cb_t img_signal;
 static lv_signal_cb_t label_signal;
 static lv_signal_cb_t ancestor_page_signal;
 static lv_signal_cb_t ancestor_btn_signal;
+#if LV_LIST_VIRTUAL
+static lv_signal_cb_t ancestor_scrl_signal;
+#endif
 #if LV_USE_GROUP
 /*Used to make the last clicked button pressed (selected) when the list become focused and
  * `click_focus == 1`*/
@@ -95,6 +107,9 @@ lv_obj_t * lv_list_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->last_sel     = NULL;
     ext->selected_btn = NULL;
 #endif
+#if LV_LIST_VIRTUAL
+    memset(&ext->virt, 0, sizeof(ext->virt));
+#endif
 
     lv_obj_set_signal_cb(new_list, lv_list_signal);
 
@@ -160,6 +175,9 @@ void lv_list_clean(lv_obj_t * obj)
     lv_obj_clean(scrl);
     lv_list_ext_t * ext = lv_obj_get_ext_attr(obj);
     ext->size           = 0;
+#if LV_LIST_VIRTUAL
+    lv_list_virtual_free(obj);
+#endif
 }
 
 /*======================
@@ -256,6 +274,122 @@ bool lv_list_remove(const lv_obj_t * list, uint16_t index)
     return false;
 }
 
+#if LV_LIST_VIRTUAL
+/**
+ * Make a list virtual: show `item_cnt` items but create only the rows needed to fill the list
+ * and bind them to other items while scrolling. All rows should have the same height.
+ * The buttons of the list are deleted and `lv_list_add_btn` shouldn't be used on a virtual list.
+ * @param list pointer to a list object
+ * @param item_cnt number of items
+ * @param img_src image of the rows (can be changed in `bind_cb`) or NULL to create the rows without image
+ * @param bind_cb called to show an item on a row, NULL to make the list normal again
+ */
+void lv_list_set_virtual(lv_obj_t * list, uint32_t item_cnt, const void * img_src, lv_list_bind_cb_t bind_cb)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    lv_obj_t * scrl     = lv_page_get_scrl(list);
+
+    lv_list_clean(list);
+
+    ext->virt.bind_cb  = bind_cb;
+    ext->virt.img_src  = img_src;
+    ext->virt.item_cnt = item_cnt;
+    ext->virt.first    = 0;
+    ext->virt.row_h    = 0;
+
+    if(bind_cb == NULL) {
+        if(lv_obj_get_signal_cb(scrl) == lv_list_virtual_scrl_signal) lv_obj_set_signal_cb(scrl, ancestor_scrl_signal);
+        ext->virt.item_cnt = 0;
+        lv_page_set_scrl_layout(list, LV_LIST_LAYOUT_DEF);
+        lv_page_set_scrl_fit2(list, LV_FIT_FLOOD, LV_FIT_TIGHT);
+        return;
+    }
+
+    /*The rows are placed by the list*/
+    if(ancestor_scrl_signal == NULL) ancestor_scrl_signal = lv_obj_get_signal_cb(scrl);
+    lv_obj_set_signal_cb(scrl, lv_list_virtual_scrl_signal);
+    lv_page_set_scrl_layout(list, LV_LAYOUT_OFF);
+    lv_page_set_scrl_fit2(list, LV_FIT_FLOOD, LV_FIT_NONE);
+    lv_obj_set_y(scrl, lv_obj_get_style(list)->body.padding.top);
+
+    lv_list_virtual_refr_rows(list);
+}
+
+/**
+ * Set the number of items of a virtual list and bind the rows again (e.g. the items changed)
+ * @param list pointer to a virtual list object
+ * @param item_cnt new number of items
+ */
+void lv_list_set_virtual_cnt(lv_obj_t * list, uint32_t item_cnt)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    if(ext->virt.bind_cb == NULL) return;
+
+    ext->virt.item_cnt = item_cnt;
+
+    /*Bind every row again*/
+    uint16_t i;
+    for(i = 0; i < ext->virt.row_cnt; i++) {
+        ext->virt.row_item[i] = UINT32_MAX;
+    }
+
+    lv_list_virtual_refr_rows(list);
+}
+
+/**
+ * Scroll a virtual list to an item
+ * @param list pointer to a virtual list object
+ * @param index index of the item
+ * @param anim LV_ANIM_ON: scroll with animation; LV_ANIM_OFF: jump
+ */
+void lv_list_focus_virtual(lv_obj_t * list, uint32_t index, lv_anim_enable_t anim)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    if(ext->virt.bind_cb == NULL || index >= ext->virt.item_cnt || ext->virt.row_cnt == 0) return;
+
+    /*Jump to a window with the item in the middle when it is far*/
+    uint16_t page_rows = ext->virt.row_cnt / 3;
+    if(index < ext->virt.first || index >= ext->virt.first + ext->virt.row_cnt) {
+        ext->virt.first = index > page_rows ? index - page_rows : 0;
+        if(ext->virt.first > ext->virt.item_cnt - ext->virt.row_cnt) {
+            ext->virt.first = ext->virt.item_cnt - ext->virt.row_cnt;
+        }
+        lv_list_virtual_place(list);
+    }
+
+    lv_page_focus(list, ext->virt.rows[index % ext->virt.row_cnt], anim);
+}
+
+/**
+ * Get the number of items of a virtual list
+ * @param list pointer to a list object
+ * @return the number of items, 0 if the list is not virtual
+ */
+uint32_t lv_list_get_virtual_cnt(const lv_obj_t * list)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    return ext->virt.item_cnt;
+}
+
+/**
+ * Get the item shown by a row of a virtual list, e.g. in the event callback of the row
+ * @param list pointer to a virtual list object
+ * @param btn pointer to a row (button) of the list
+ * @return index of the item or -1 if `btn` is not a row of `list`
+ */
+int32_t lv_list_get_virtual_index(const lv_obj_t * list, const lv_obj_t * btn)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+
+    uint16_t i;
+    for(i = 0; i < ext->virt.row_cnt; i++) {
+        if(ext->virt.rows[i] == btn) return ext->virt.row_item[i];
+    }
+
+    return -1;
+}
+#endif
+
 /*=====================
  * Setter functions
  *====================*/
@@ -363,6 +497,14 @@ void lv_list_set_style(lv_obj_t * list, lv_list_style_t type, const lv_style_t *
             lv_btn_set_style(btn, btn_style_refr, ext->styles_btn[btn_style_refr]);
             btn = lv_list_get_prev_btn(list, btn);
         }
+
+#if LV_LIST_VIRTUAL
+        /*The rows might get an other height*/
+        if(ext->virt.bind_cb) {
+            ext->virt.row_h = 0;
+            lv_list_virtual_refr_rows(list);
+        }
+#endif
     }
 }
 
@@ -808,6 +950,24 @@ static lv_res_t lv_list_signal(lv_obj_t * list, lv_signal_t sign, void * param)
                 if(btn) lv_list_set_btn_selected(list, btn);
             }
         }
+#endif
+#if LV_LIST_VIRTUAL
+    } else if(sign == LV_SIGNAL_CORD_CHG) {
+        /*A new height needs an other number of rows*/
+        lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+        if(ext->virt.bind_cb && lv_obj_get_height(list) != lv_area_get_height(param)) {
+            lv_list_virtual_refr_rows(list);
+        }
+    } else if(sign == LV_SIGNAL_STYLE_CHG) {
+        /*The paddings might change the height of the rows*/
+        lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+        if(ext->virt.bind_cb) {
+            ext->virt.row_h = 0;
+            lv_list_virtual_refr_rows(list);
+        }
+    } else if(sign == LV_SIGNAL_CLEANUP) {
+        /*The rows are already deleted as the children of the scrollable*/
+        lv_list_virtual_free(list);
 #endif
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
@@ -882,6 +1042,227 @@ static lv_res_t lv_list_btn_signal(lv_obj_t * btn, lv_signal_t sign, void * para
     return res;
 }
 
+#if LV_LIST_VIRTUAL
+/**
+ * Signal function of the scrollable of virtual lists.
+ * Moves the window of rows before the page limits the position of the scrollable.
+ * @param scrl pointer to the scrollable of a virtual list
+ * @param sign a signal type from lv_signal_t enum
+ * @param param pointer to a signal specific variable
+ * @return LV_RES_OK: the object is not deleted in the function; LV_RES_INV: the object is deleted
+ */
+static lv_res_t lv_list_virtual_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void * param)
+{
+    lv_res_t res;
+    lv_obj_t * list     = lv_obj_get_parent(scrl);
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+
+    if(sign == LV_SIGNAL_CORD_CHG && ext->virt.refr_ip == 0) lv_list_virtual_scroll(list);
+
+    res = ancestor_scrl_signal(scrl, sign, param);
+    if(res != LV_RES_OK) return res;
+
+    /*The page has just set the scrollbar from the window of rows*/
+    if(sign == LV_SIGNAL_CORD_CHG) lv_list_virtual_sb_refr(list);
+
+    return res;
+}
+
+/**
+ * Create or delete rows to fill the list, measure them and bind them to the items
+ * @param list pointer to a virtual list object
+ */
+static void lv_list_virtual_refr_rows(lv_obj_t * list)
+{
+    lv_list_ext_t * ext            = lv_obj_get_ext_attr(list);
+    lv_obj_t * scrl                = lv_page_get_scrl(list);
+    const lv_style_t * style_scrl  = lv_obj_get_style(scrl);
+    uint16_t i;
+
+    ext->virt.refr_ip = 1;
+
+    /*Measure a row with the first item*/
+    if(ext->virt.row_h == 0 && ext->virt.item_cnt > 0) {
+        lv_obj_t * probe = lv_list_add_btn(list, ext->virt.img_src, "");
+        ext->virt.bind_cb(list, probe, 0);
+        ext->virt.row_h = lv_obj_get_height(probe) + style_scrl->body.padding.inner;
+        if(ext->virt.row_h <= 0) ext->virt.row_h = 1;
+        lv_obj_del(probe);
+        ext->size--;
+    }
+
+    /*A page of spare rows above and under the visible ones*/
+    uint32_t row_cnt = 0;
+    if(ext->virt.item_cnt > 0) {
+        row_cnt = 3 * (lv_obj_get_height(list) / ext->virt.row_h + 1);
+        if(row_cnt > ext->virt.item_cnt) row_cnt = ext->virt.item_cnt;
+    }
+
+    if(row_cnt != ext->virt.row_cnt) {
+        /*Recycle the rows which remain, but the items of the rows change*/
+        for(i = row_cnt; i < ext->virt.row_cnt; i++) {
+            lv_obj_del(ext->virt.rows[i]);
+            ext->size--;
+        }
+
+        if(row_cnt > 0) {
+            ext->virt.rows     = lv_mem_realloc(ext->virt.rows, row_cnt * sizeof(lv_obj_t *));
+            ext->virt.row_item = lv_mem_realloc(ext->virt.row_item, row_cnt * sizeof(uint32_t));
+            lv_mem_assert(ext->virt.rows);
+            lv_mem_assert(ext->virt.row_item);
+        } else {
+            lv_mem_free(ext->virt.rows);
+            lv_mem_free(ext->virt.row_item);
+            ext->virt.rows     = NULL;
+            ext->virt.row_item = NULL;
+        }
+
+        for(i = ext->virt.row_cnt; i < row_cnt; i++) {
+            ext->virt.rows[i] = lv_list_add_btn(list, ext->virt.img_src, "");
+        }
+        for(i = 0; i < row_cnt; i++) {
+            ext->virt.row_item[i] = UINT32_MAX;
+        }
+
+        ext->virt.row_cnt = row_cnt;
+    }
+
+    if(ext->virt.first + row_cnt > ext->virt.item_cnt) ext->virt.first = ext->virt.item_cnt - row_cnt;
+
+    lv_obj_set_height(scrl, style_scrl->body.padding.top + row_cnt * ext->virt.row_h -
+                                style_scrl->body.padding.inner + style_scrl->body.padding.bottom);
+
+    lv_list_virtual_place(list);
+
+    ext->virt.refr_ip = 0;
+
+    lv_list_virtual_sb_refr(list);
+}
+
+/**
+ * Bind the rows to the items of the window and put them to their place in it
+ * @param list pointer to a virtual list object
+ */
+static void lv_list_virtual_place(lv_obj_t * list)
+{
+    lv_list_ext_t * ext           = lv_obj_get_ext_attr(list);
+    const lv_style_t * style_scrl = lv_obj_get_style(lv_page_get_scrl(list));
+
+    uint16_t i;
+    for(i = 0; i < ext->virt.row_cnt; i++) {
+        uint32_t item = ext->virt.first + i;
+        uint16_t r    = item % ext->virt.row_cnt;
+        lv_obj_t * row = ext->virt.rows[r];
+
+        /*Only the rows of the items which left the window are bound again*/
+        if(ext->virt.row_item[r] != item) {
+            ext->virt.row_item[r] = item;
+            lv_btn_set_state(row, LV_BTN_STATE_REL);
+            ext->virt.bind_cb(list, row, item);
+        }
+
+        lv_obj_set_y(row, style_scrl->body.padding.top + i * ext->virt.row_h);
+    }
+}
+
+/**
+ * Move the window of rows if the visible rows got close to one of its ends
+ * @param list pointer to a virtual list object
+ */
+static void lv_list_virtual_scroll(lv_obj_t * list)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    if(ext->virt.row_cnt == 0 || ext->virt.row_cnt >= ext->virt.item_cnt) return;
+
+    lv_obj_t * scrl         = lv_page_get_scrl(list);
+    const lv_style_t * style = lv_obj_get_style(list);
+    int32_t page_rows       = ext->virt.row_cnt / 3;
+
+    /*Rows above the visible ones in the window*/
+    int32_t above = (style->body.padding.top - lv_obj_get_y(scrl) - lv_obj_get_style(scrl)->body.padding.top) /
+                    ext->virt.row_h;
+    if(above >= page_rows / 2 && above <= page_rows + page_rows / 2) return;
+
+    /*Keep a page of rows above*/
+    int32_t first_new = (int32_t)ext->virt.first + above - page_rows;
+    if(first_new < 0) first_new = 0;
+    if(first_new > (int32_t)(ext->virt.item_cnt - ext->virt.row_cnt)) first_new = ext->virt.item_cnt - ext->virt.row_cnt;
+    if(first_new == (int32_t)ext->virt.first) return;
+
+    /*Move the scrollable as much as the rows in it: what is visible stays in place*/
+    ext->virt.refr_ip = 1;
+    lv_obj_set_y(scrl, lv_obj_get_y(scrl) + (first_new - (int32_t)ext->virt.first) * ext->virt.row_h);
+    ext->virt.first = first_new;
+    lv_list_virtual_place(list);
+    ext->virt.refr_ip = 0;
+}
+
+/**
+ * Set the vertical scrollbar from the height of all items instead of the window of rows
+ * @param list pointer to a virtual list object
+ */
+static void lv_list_virtual_sb_refr(lv_obj_t * list)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+    if(ext->page.sb.ver_draw == 0 || ext->virt.row_cnt == 0) return;
+
+    lv_obj_t * scrl               = lv_page_get_scrl(list);
+    const lv_style_t * style      = lv_obj_get_style(list);
+    const lv_style_t * style_scrl = lv_obj_get_style(scrl);
+    const lv_style_t * style_sb   = ext->page.sb.style;
+    lv_coord_t obj_h              = lv_obj_get_height(list);
+    lv_coord_t sb_ver_pad         = LV_MATH_MAX(style_sb->body.padding.inner, style->body.padding.bottom);
+
+    /*The heights of the all items and of the ones above the list*/
+    int32_t full_h = style_scrl->body.padding.top + (int32_t)ext->virt.item_cnt * ext->virt.row_h -
+                     style_scrl->body.padding.inner + style_scrl->body.padding.bottom + style->body.padding.top +
+                     style->body.padding.bottom;
+    int32_t above_h = (int32_t)ext->virt.first * ext->virt.row_h + style->body.padding.top - lv_obj_get_y(scrl);
+    if(full_h <= obj_h) return;
+
+    int32_t size = ((int32_t)obj_h * (obj_h - 2 * sb_ver_pad)) / full_h;
+    if(size < LV_PAGE_SB_MIN_SIZE) size = LV_PAGE_SB_MIN_SIZE;
+
+    /*Invalidate the old and the new area*/
+    lv_disp_t * disp = lv_obj_get_disp(list);
+    lv_area_t sb_area_tmp;
+    lv_area_copy(&sb_area_tmp, &ext->page.sb.ver_area);
+    sb_area_tmp.x1 += list->coords.x1;
+    sb_area_tmp.y1 += list->coords.y1;
+    sb_area_tmp.x2 += list->coords.x1;
+    sb_area_tmp.y2 += list->coords.y1;
+    lv_inv_area(disp, &sb_area_tmp);
+
+    lv_area_set_height(&ext->page.sb.ver_area, size);
+    lv_area_set_pos(&ext->page.sb.ver_area, ext->page.sb.ver_area.x1,
+                    sb_ver_pad + (above_h * (obj_h - size - 2 * sb_ver_pad)) / (full_h - obj_h));
+
+    lv_area_copy(&sb_area_tmp, &ext->page.sb.ver_area);
+    sb_area_tmp.x1 += list->coords.x1;
+    sb_area_tmp.y1 += list->coords.y1;
+    sb_area_tmp.x2 += list->coords.x1;
+    sb_area_tmp.y2 += list->coords.y1;
+    lv_inv_area(disp, &sb_area_tmp);
+}
+
+/**
+ * Free the rows of a virtual list. The rows have to be deleted already.
+ * @param list pointer to a list object
+ */
+static void lv_list_virtual_free(lv_obj_t * list)
+{
+    lv_list_ext_t * ext = lv_obj_get_ext_attr(list);
+
+    lv_mem_free(ext->virt.rows);
+    lv_mem_free(ext->virt.row_item);
+    ext->virt.rows     = NULL;
+    ext->virt.row_item = NULL;
+    ext->virt.row_cnt  = 0;
+    ext->virt.item_cnt = 0;
+    ext->virt.first    = 0;
+}
+#endif
+
 /**
  * Make a single button selected in the list, deselect others.
  * @param btn pointer to the currently pressed list btn object
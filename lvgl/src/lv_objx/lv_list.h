@@ -47,6 +47,14 @@ extern "C" {
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_LIST_VIRTUAL
+/**
+ * Show an item on a row of a virtual list, e.g. set the text of `lv_list_get_btn_label(btn)`.
+ * The rows are recycled so set everything which differs between the items.
+ */
+typedef void (*lv_list_bind_cb_t)(lv_obj_t * list, lv_obj_t * btn, uint32_t index);
+#endif
+
 /*Data of list*/
 typedef struct
 {
@@ -62,6 +70,20 @@ typedef struct
     lv_obj_t * last_sel;     /* The last selected button. It will be reverted when the list is focused again */
     lv_obj_t * selected_btn; /* The button is currently being selected*/
 #endif
+#if LV_LIST_VIRTUAL
+    struct
+    {
+        lv_list_bind_cb_t bind_cb; /*NULL: not a virtual list*/
+        const void * img_src;      /*Image of the new rows*/
+        lv_obj_t ** rows;          /*Item `i` is shown by `rows[i % row_cnt]`*/
+        uint32_t * row_item;       /*The item shown by each row*/
+        uint32_t item_cnt;
+        uint32_t first;            /*The item shown at the top of the scrollable*/
+        uint16_t row_cnt;
+        lv_coord_t row_h;          /*Height of a row with the inner padding, 0: not measured yet*/
+        uint8_t refr_ip : 1;       /*The rows are being moved*/
+    } virt;
+#endif
 } lv_list_ext_t;
 
 /** List styles. */
@@ -118,6 +140,49 @@ lv_obj_t * lv_list_add_btn(lv_obj_t * list, const void * img_src, const char * t
  */
 bool lv_list_remove(const lv_obj_t * list, uint16_t index);
 
+#if LV_LIST_VIRTUAL
+/**
+ * Make a list virtual: show `item_cnt` items but create only the rows needed to fill the list
+ * and bind them to other items while scrolling. All rows should have the same height.
+ * The buttons of the list are deleted and `lv_list_add_btn` shouldn't be used on a virtual list.
+ * @param list pointer to a list object
+ * @param item_cnt number of items
+ * @param img_src image of the rows (can be changed in `bind_cb`) or NULL to create the rows without image
+ * @param bind_cb called to show an item on a row, NULL to make the list normal again
+ */
+void lv_list_set_virtual(lv_obj_t * list, uint32_t item_cnt, const void * img_src, lv_list_bind_cb_t bind_cb);
+
+/**
+ * Set the number of items of a virtual list and bind the rows again (e.g. the items changed)
+ * @param list pointer to a virtual list object
+ * @param item_cnt new number of items
+ */
+void lv_list_set_virtual_cnt(lv_obj_t * list, uint32_t item_cnt);
+
+/**
+ * Scroll a virtual list to an item
+ * @param list pointer to a virtual list object
+ * @param index index of the item
+ * @param anim LV_ANIM_ON: scroll with animation; LV_ANIM_OFF: jump
+ */
+void lv_list_focus_virtual(lv_obj_t * list, uint32_t index, lv_anim_enable_t anim);
+
+/**
+ * Get the number of items of a virtual list
+ * @param list pointer to a list object
+ * @return the number of items, 0 if the list is not virtual
+ */
+uint32_t lv_list_get_virtual_cnt(const lv_obj_t * list);
+
+/**
+ * Get the item shown by a row of a virtual list, e.g. in the event callback of the row
+ * @param list pointer to a virtual list object
+ * @param btn pointer to a row (button) of the list
+ * @return index of the item or -1 if `btn` is not a row of `list`
+ */
+int32_t lv_list_get_virtual_index(const lv_obj_t * list, const lv_obj_t * btn);
+#endif
+
 /*=====================
  * Setter functions
  *====================*/
@@ -29,6 +29,9 @@
  **********************/
 static bool lv_lmeter_design(lv_obj_t * lmeter, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_lmeter_signal(lv_obj_t * lmeter, lv_signal_t sign, void * param);
+static void lv_lmeter_get_line_points(const lv_obj_t * lmeter, const lv_style_t * style, uint8_t line_cnt,
+                                      uint8_t id, lv_point_t * p_out, lv_point_t * p_in);
+static int16_t lv_lmeter_get_level(const lv_obj_t * lmeter, uint8_t line_cnt);
 static lv_coord_t lv_lmeter_coord_round(int32_t x);
 
 /**********************
@@ -122,9 +125,49 @@ void lv_lmeter_set_value(lv_obj_t * lmeter, int16_t value)
     lv_lmeter_ext_t * ext = lv_obj_get_ext_attr(lmeter);
     if(ext->cur_value == value) return;
 
+    int16_t level_old = lv_lmeter_get_level(lmeter, ext->line_cnt);
+
     ext->cur_value = value > ext->max_value ? ext->max_value : value;
     ext->cur_value = ext->cur_value < ext->min_value ? ext->min_value : ext->cur_value;
-    lv_obj_invalidate(lmeter);
+
+    /*A descendant might draw anything by the value so refresh it entirely*/
+    if(lv_obj_get_design_cb(lmeter) != lv_lmeter_design) {
+        lv_obj_invalidate(lmeter);
+        return;
+    }
+
+    /*Else only the lines between the old and the new level change their color*/
+    int16_t level_new = lv_lmeter_get_level(lmeter, ext->line_cnt);
+    int16_t first     = LV_MATH_MIN(level_old, level_new);
+    int16_t last      = LV_MATH_MIN(LV_MATH_MAX(level_old, level_new), ext->line_cnt) - 1;
+    if(first > last) return;
+
+    const lv_style_t * style = lv_lmeter_get_style(lmeter, LV_LMETER_STYLE_MAIN);
+    lv_area_t area;
+    area.x1 = LV_COORD_MAX;
+    area.y1 = LV_COORD_MAX;
+    area.x2 = LV_COORD_MIN;
+    area.y2 = LV_COORD_MIN;
+
+    int16_t i;
+    for(i = first; i <= last; i++) {
+        lv_point_t p_out;
+        lv_point_t p_in;
+        lv_lmeter_get_line_points(lmeter, style, ext->line_cnt, i, &p_out, &p_in);
+        area.x1 = LV_MATH_MIN(area.x1, LV_MATH_MIN(p_out.x, p_in.x));
+        area.y1 = LV_MATH_MIN(area.y1, LV_MATH_MIN(p_out.y, p_in.y));
+        area.x2 = LV_MATH_MAX(area.x2, LV_MATH_MAX(p_out.x, p_in.x));
+        area.y2 = LV_MATH_MAX(area.y2, LV_MATH_MAX(p_out.y, p_in.y));
+    }
+
+    /*The width of the lines (+1 if focused) and the anti-aliasing*/
+    lv_coord_t pad = style->line.width / 2 + 2;
+    area.x1 -= pad;
+    area.y1 -= pad;
+    area.x2 += pad;
+    area.y2 += pad;
+
+    lv_obj_invalidate_area(lmeter, &area);
 }
 
 /**
@@ -227,6 +270,49 @@ uint16_t lv_lmeter_get_scale_angle(const lv_obj_t * lmeter)
     return ext->scale_angle;
 }
 
+/*=====================
+ * Other functions
+ *====================*/
+
+/**
+ * Draw the scale lines of a line meter with the given settings.
+ * Descendants can use it to draw more scales without modifying the line meter.
+ * @param lmeter pointer to a line meter object
+ * @param mask the lines will be drawn only in this area
+ * @param style color, width and length (`body.padding.left`) of the lines
+ * @param line_cnt number of lines on the scale angle
+ */
+void lv_lmeter_draw_scale(lv_obj_t * lmeter, const lv_area_t * mask, const lv_style_t * style, uint8_t line_cnt)
+{
+    lv_opa_t opa_scale = lv_obj_get_opa_scale(lmeter);
+    lv_style_t style_tmp;
+    lv_style_copy(&style_tmp, style);
+
+#if LV_USE_GROUP
+    lv_group_t * g = lv_obj_get_group(lmeter);
+    if(lv_group_get_focused(g) == lmeter) {
+        style_tmp.line.width += 1;
+    }
+#endif
+
+    int16_t level = lv_lmeter_get_level(lmeter, line_cnt);
+    uint8_t i;
+
+    for(i = 0; i < line_cnt; i++) {
+        lv_point_t p1;
+        lv_point_t p2;
+        lv_lmeter_get_line_points(lmeter, style, line_cnt, i, &p1, &p2);
+
+        if(i >= level)
+            style_tmp.line.color = style->line.color;
+        else {
+            style_tmp.line.color = lv_color_mix(style->body.grad_color, style->body.main_color, (255 * i) / line_cnt);
+        }
+
+        lv_draw_line(&p1, &p2, mask, &style_tmp, opa_scale);
+    }
+}
+
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -249,70 +335,8 @@ static bool lv_lmeter_design(lv_obj_t * lmeter, const lv_area_t * mask, lv_desig
     }
     /*Draw the object*/
     else if(mode == LV_DESIGN_DRAW_MAIN) {
-        lv_lmeter_ext_t * ext    = lv_obj_get_ext_attr(lmeter);
-        const lv_style_t * style = lv_obj_get_style(lmeter);
-        lv_opa_t opa_scale       = lv_obj_get_opa_scale(lmeter);
-        lv_style_t style_tmp;
-        lv_style_copy(&style_tmp, style);
-
-#if LV_USE_GROUP
-        lv_group_t * g = lv_obj_get_group(lmeter);
-        if(lv_group_get_focused(g) == lmeter) {
-            style_tmp.line.width += 1;
-        }
-#endif
-
-        lv_coord_t r_out = lv_obj_get_width(lmeter) / 2;
-        lv_coord_t r_in  = r_out - style->body.padding.left;
-        if(r_in < 1) r_in = 1;
-
-        lv_coord_t x_ofs  = lv_obj_get_width(lmeter) / 2 + lmeter->coords.x1;
-        lv_coord_t y_ofs  = lv_obj_get_height(lmeter) / 2 + lmeter->coords.y1;
-        int16_t angle_ofs = 90 + (360 - ext->scale_angle) / 2;
-        int16_t level =
-            (int32_t)((int32_t)(ext->cur_value - ext->min_value) * ext->line_cnt) / (ext->max_value - ext->min_value);
-        uint8_t i;
-
-        style_tmp.line.color = style->body.main_color;
-
-        /*Calculate every coordinate in a bigger size to make rounding later*/
-        r_out = r_out << LV_LMETER_LINE_UPSCALE;
-        r_in  = r_in << LV_LMETER_LINE_UPSCALE;
-
-        for(i = 0; i < ext->line_cnt; i++) {
-            /*Calculate the position a scale label*/
-            int16_t angle = (i * ext->scale_angle) / (ext->line_cnt - 1) + angle_ofs;
-
-            lv_coord_t y_out = (int32_t)((int32_t)lv_trigo_sin(angle) * r_out) >> LV_TRIGO_SHIFT;
-            lv_coord_t x_out = (int32_t)((int32_t)lv_trigo_sin(angle + 90) * r_out) >> LV_TRIGO_SHIFT;
-            lv_coord_t y_in  = (int32_t)((int32_t)lv_trigo_sin(angle) * r_in) >> LV_TRIGO_SHIFT;
-            lv_coord_t x_in  = (int32_t)((int32_t)lv_trigo_sin(angle + 90) * r_in) >> LV_TRIGO_SHIFT;
-
-            /*Rounding*/
-            x_out = lv_lmeter_coord_round(x_out);
-            x_in  = lv_lmeter_coord_round(x_in);
-            y_out = lv_lmeter_coord_round(y_out);
-            y_in  = lv_lmeter_coord_round(y_in);
-
-            lv_point_t p1;
-            lv_point_t p2;
-
-            p2.x = x_in + x_ofs;
-            p2.y = y_in + y_ofs;
-
-            p1.x = x_out + x_ofs;
-            p1.y = y_out + y_ofs;
-
-            if(i >= level)
-                style_tmp.line.color = style->line.color;
-            else {
-                style_tmp.line.color =
-                    lv_color_mix(style->body.grad_color, style->body.main_color, (255 * i) / ext->line_cnt);
-            }
-
-            lv_draw_line(&p1, &p2, mask, &style_tmp, opa_scale);
-        }
-
+        lv_lmeter_ext_t * ext = lv_obj_get_ext_attr(lmeter);
+        lv_lmeter_draw_scale(lmeter, mask, lv_obj_get_style(lmeter), ext->line_cnt);
     }
     /*Post draw when the children are drawn*/
     else if(mode == LV_DESIGN_DRAW_POST) {
@@ -355,6 +379,52 @@ static lv_res_t lv_lmeter_signal(lv_obj_t * lmeter, lv_signal_t sign, void * par
     return res;
 }
 
+/**
+ * Get the end points of a scale line
+ * @param lmeter pointer to a line meter object
+ * @param style the length of the lines is `body.padding.left`
+ * @param line_cnt number of lines on the scale angle
+ * @param id index of the line
+ * @param p_out store the outer end point here
+ * @param p_in store the inner end point here
+ */
+static void lv_lmeter_get_line_points(const lv_obj_t * lmeter, const lv_style_t * style, uint8_t line_cnt,
+                                      uint8_t id, lv_point_t * p_out, lv_point_t * p_in)
+{
+    lv_lmeter_ext_t * ext = lv_obj_get_ext_attr(lmeter);
+
+    lv_coord_t r_out = lv_obj_get_width(lmeter) / 2;
+    lv_coord_t r_in  = r_out - style->body.padding.left;
+    if(r_in < 1) r_in = 1;
+
+    lv_coord_t x_ofs  = lv_obj_get_width(lmeter) / 2 + lmeter->coords.x1;
+    lv_coord_t y_ofs  = lv_obj_get_height(lmeter) / 2 + lmeter->coords.y1;
+    int16_t angle_ofs = 90 + (360 - ext->scale_angle) / 2;
+
+    /*Calculate every coordinate in a bigger size to make rounding later*/
+    int32_t r_out_up = (int32_t)r_out << LV_LMETER_LINE_UPSCALE;
+    int32_t r_in_up  = (int32_t)r_in << LV_LMETER_LINE_UPSCALE;
+
+    int16_t angle = (id * ext->scale_angle) / (line_cnt - 1) + angle_ofs;
+
+    p_out->y = lv_lmeter_coord_round(((int32_t)lv_trigo_sin(angle) * r_out_up) >> LV_TRIGO_SHIFT) + y_ofs;
+    p_out->x = lv_lmeter_coord_round(((int32_t)lv_trigo_sin(angle + 90) * r_out_up) >> LV_TRIGO_SHIFT) + x_ofs;
+    p_in->y  = lv_lmeter_coord_round(((int32_t)lv_trigo_sin(angle) * r_in_up) >> LV_TRIGO_SHIFT) + y_ofs;
+    p_in->x  = lv_lmeter_coord_round(((int32_t)lv_trigo_sin(angle + 90) * r_in_up) >> LV_TRIGO_SHIFT) + x_ofs;
+}
+
+/**
+ * Get how many lines are active by the current value
+ * @param lmeter pointer to a line meter object
+ * @param line_cnt number of lines on the scale angle
+ * @return number of active lines from the start of the scale
+ */
+static int16_t lv_lmeter_get_level(const lv_obj_t * lmeter, uint8_t line_cnt)
+{
+    lv_lmeter_ext_t * ext = lv_obj_get_ext_attr(lmeter);
+    return (int32_t)((int32_t)(ext->cur_value - ext->min_value) * line_cnt) / (ext->max_value - ext->min_value);
+}
+
 /**
  * Round a coordinate which is upscaled  (>=x.5 -> x + 1;   <x.5 -> x)
  * @param x a coordinate which is greater then it should be
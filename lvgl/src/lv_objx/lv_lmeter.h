@@ -151,6 +151,20 @@ static inline const lv_style_t * lv_lmeter_get_style(const lv_obj_t * lmeter, lv
     return lv_obj_get_style(lmeter);
 }
 
+/*=====================
+ * Other functions
+ *====================*/
+
+/**
+ * Draw the scale lines of a line meter with the given settings.
+ * Descendants can use it to draw more scales without modifying the line meter.
+ * @param lmeter pointer to a line meter object
+ * @param mask the lines will be drawn only in this area
+ * @param style color, width and length (`body.padding.left`) of the lines
+ * @param line_cnt number of lines on the scale angle
+ */
+void lv_lmeter_draw_scale(lv_obj_t * lmeter, const lv_area_t * mask, const lv_style_t * style, uint8_t line_cnt);
+
 /**********************
  *      MACROS
  **********************/
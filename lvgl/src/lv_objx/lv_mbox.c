@@ -39,6 +39,7 @@ static void mbox_realign(lv_obj_t * mbox);
 #if LV_USE_ANIMATION
 static void lv_mbox_close_ready_cb(lv_anim_t * a);
 #endif
+static void mbox_close(lv_obj_t * mbox);
 static void lv_mbox_default_event_cb(lv_obj_t * mbox, lv_event_t event);
 
 /**********************
@@ -197,7 +198,8 @@ void lv_mbox_set_anim_time(lv_obj_t * mbox, uint16_t anim_time)
 }
 
 /**
- * Automatically delete the message box after a given time
+ * Automatically delete the message box after a given time.
+ * If its parent is a modal backdrop (`lv_obj_set_layer_backdrop`) with no other children it's deleted too.
  * @param mbox pointer to a message box object
  * @param delay a time (in milliseconds) to wait before delete the message box
  */
@@ -247,7 +249,7 @@ void lv_mbox_start_auto_close(lv_obj_t * mbox, uint16_t delay)
     }
 #else
     (void)delay; /*Unused*/
-    lv_obj_del(mbox);
+    mbox_close(mbox);
 #endif
 }
 
@@ -515,10 +517,28 @@ static void mbox_realign(lv_obj_t * mbox)
 #if LV_USE_ANIMATION
 static void lv_mbox_close_ready_cb(lv_anim_t * a)
 {
-    lv_obj_del(a->var);
+    mbox_close(a->var);
 }
 #endif
 
+/**
+ * Delete a message box. A modal backdrop (`lv_obj_set_layer_backdrop`) which has only the message box
+ * is deleted with it.
+ * @param mbox pointer to a message box object
+ */
+static void mbox_close(lv_obj_t * mbox)
+{
+#if LV_USE_LAYER_CACHE
+    lv_obj_t * par = lv_obj_get_parent(mbox);
+    if(par != NULL && lv_obj_get_layer_backdrop(par) && lv_obj_count_children(par) == 1) {
+        lv_obj_del(par);
+        return;
+    }
+#endif
+
+    lv_obj_del(mbox);
+}
+
 static void lv_mbox_default_event_cb(lv_obj_t * mbox, lv_event_t event)
 {
     if(event != LV_EVENT_VALUE_CHANGED) return;
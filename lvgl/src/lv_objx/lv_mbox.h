@@ -115,7 +115,8 @@ void lv_mbox_set_text(lv_obj_t * mbox, const char * txt);
 void lv_mbox_set_anim_time(lv_obj_t * mbox, uint16_t anim_time);
 
 /**
- * Automatically delete the message box after a given time
+ * Automatically delete the message box after a given time.
+ * If its parent is a modal backdrop (`lv_obj_set_layer_backdrop`) with no other children it's deleted too.
  * @param mbox pointer to a message box object
  * @param delay a time (in milliseconds) to wait before delete the message box
  */
@@ -13,13 +13,14 @@
 #include "../lv_draw/lv_draw.h"
 #include "../lv_themes/lv_theme.h"
 #include "../lv_core/lv_refr.h"
+#include "../lv_core/lv_disp.h"
 #include "../lv_misc/lv_anim.h"
 #include "../lv_misc/lv_math.h"
+#include "../lv_misc/lv_thread.h"
 
 /*********************
  *      DEFINES
  *********************/
-#define LV_PAGE_SB_MIN_SIZE (LV_DPI / 8)
 
 /*[ms] Scroll anim time on `lv_page_scroll_up/down/left/rigth`*/
 #define LV_PAGE_SCROLL_ANIM_TIME 200
@@ -46,6 +47,9 @@ static bool lv_scrl_design(lv_obj_t * scrl, const lv_area_t * mask, lv_design_mo
 static lv_res_t lv_page_signal(lv_obj_t * page, lv_signal_t sign, void * param);
 static lv_res_t lv_page_scrollable_signal(lv_obj_t * scrl, lv_signal_t sign, void * param);
 static void scrl_def_event_cb(lv_obj_t * scrl, lv_event_t event);
+#if LV_USE_SCROLL_BLIT
+static bool scroll_blit(lv_obj_t * page, const lv_point_t * diff);
+#endif
 #if LV_USE_ANIMATION
 static void edge_flash_anim(void * page, lv_anim_value_t v);
 static void edge_flash_anim_end(lv_anim_t * a);
@@ -110,6 +114,10 @@ lv_obj_t * lv_page_create(lv_obj_t * par, const lv_obj_t * copy)
     if(copy == NULL) {
         ext->scrl = lv_cont_create(new_page, NULL);
         lv_obj_set_signal_cb(ext->scrl, lv_page_scrollable_signal);
+        lv_obj_set_cord_signal(ext->scrl, LV_OBJ_CORD_SIGNAL_ALL); /*Follows its position when scrolled*/
+#if LV_USE_SCROLL_BLIT
+        ext->scrl->scroll_blit = 1;
+#endif
         lv_obj_set_design_cb(ext->scrl, lv_scrl_design);
         lv_obj_set_drag(ext->scrl, true);
         lv_obj_set_drag_throw(ext->scrl, true);
@@ -146,6 +154,10 @@ lv_obj_t * lv_page_create(lv_obj_t * par, const lv_obj_t * copy)
         lv_page_ext_t * copy_ext = lv_obj_get_ext_attr(copy);
         ext->scrl                = lv_cont_create(new_page, copy_ext->scrl);
         lv_obj_set_signal_cb(ext->scrl, lv_page_scrollable_signal);
+        lv_obj_set_cord_signal(ext->scrl, LV_OBJ_CORD_SIGNAL_ALL); /*Follows its position when scrolled*/
+#if LV_USE_SCROLL_BLIT
+        ext->scrl->scroll_blit = 1;
+#endif
 
         lv_page_set_sb_mode(new_page, copy_ext->sb.mode);
 
@@ -746,30 +758,35 @@ static bool lv_scrl_design(lv_obj_t * scrl, const lv_area_t * mask, lv_design_mo
         /* If the page is focused in a group and
          * the background object is not visible (transparent)
          * then "activate" the style of the scrollable*/
-        const lv_style_t * style_scrl_ori = lv_obj_get_style(scrl);
-        lv_obj_t * page                   = lv_obj_get_parent(scrl);
-        const lv_style_t * style_page     = lv_obj_get_style(page);
-        lv_group_t * g                    = lv_obj_get_group(page);
-        if((style_page->body.opa == LV_OPA_TRANSP) &&
-           style_page->body.border.width == 0) { /*Is the background visible?*/
-            if(lv_group_get_focused(g) == page) {
-                lv_style_t * style_mod;
-                style_mod = lv_group_mod_style(g, style_scrl_ori);
-                /*If still not visible modify the style a littel bit*/
-                if((style_mod->body.opa == LV_OPA_TRANSP) && style_mod->body.border.width == 0) {
-                    style_mod->body.opa          = LV_OPA_50;
-                    style_mod->body.border.width = 1;
-                    style_mod                    = lv_group_mod_style(g, style_mod);
-                }
-
-                scrl->style_p = style_mod; /*Temporally change the style to the activated */
+        lv_obj_t * page               = lv_obj_get_parent(scrl);
+        const lv_style_t * style_page = lv_obj_get_style(page);
+        lv_group_t * g                = lv_obj_get_group(page);
+        if((style_page->body.opa == LV_OPA_TRANSP) && style_page->body.border.width == 0 && /*Is the background visible?*/
+           lv_group_get_focused(g) == page) {
+            /*Other drawing threads have to wait until the style is reverted*/
+            lv_thread_lock();
+            const lv_style_t * style_scrl_ori = scrl->style_p;
+            lv_style_t * style_mod;
+            style_mod = lv_group_mod_style(g, lv_obj_get_style(scrl));
+            /*If still not visible modify the style a littel bit.
+             *On a copy, the modified style can be cached by the group.*/
+            if((style_mod->body.opa == LV_OPA_TRANSP) && style_mod->body.border.width == 0) {
+                lv_style_t style_vis;
+                lv_style_copy(&style_vis, style_mod);
+                style_vis.body.opa          = LV_OPA_50;
+                style_vis.body.border.width = 1;
+                style_mod                   = lv_group_mod_style(g, &style_vis);
             }
+
+            scrl->style_p = style_mod; /*Temporally change the style to the activated */
+            ancestor_design(scrl, mask, mode);
+            scrl->style_p = style_scrl_ori; /*Revert the style*/
+            lv_thread_unlock();
+        } else {
+            ancestor_design(scrl, mask, mode);
         }
-#endif
+#else
         ancestor_design(scrl, mask, mode);
-
-#if LV_USE_GROUP
-        scrl->style_p = style_scrl_ori; /*Revert the style*/
 #endif
     } else if(mode == LV_DESIGN_DRAW_POST) {
         ancestor_design(scrl, mask, mode);
@@ -1063,6 +1080,12 @@ static lv_res_t lv_page_scrollable_signal(lv_obj_t * scrl, lv_signal_t sign, voi
             }
         }
     }
+#if LV_USE_SCROLL_BLIT
+    else if(sign == LV_SIGNAL_SCROLL) {
+        lv_signal_scroll_t * scroll = param;
+        scroll->blit                = scroll_blit(page, &scroll->diff);
+    }
+#endif
 
     return res;
 }
@@ -1226,4 +1249,143 @@ static void edge_flash_anim_end(lv_anim_t * a)
 }
 #endif
 
+#if LV_USE_SCROLL_BLIT
+/**
+ * Move the drawn pixels of the page instead of redrawing it when the scrollable moves.
+ * Only the scrollable and a background of one color can be on the moved area
+ * and nothing can be drawn over it, except the scrollbars which are invalidated.
+ * @param page pointer to a page object
+ * @param diff the scrollable will move by this
+ * @return true: the pixels will be moved and the rest of the page is invalidated;
+ *         false: the scrollable should be redrawn
+ */
+static bool scroll_blit(lv_obj_t * page, const lv_point_t * diff)
+{
+    /*The other widgets draw on fix positions over or under the scrollable (e.g. the selected row of a roller)*/
+    if(lv_obj_get_design_cb(page) != lv_page_design) return false;
+    if(lv_obj_get_opa_scale(page) != LV_OPA_COVER) return false;
+
+    lv_page_ext_t * ext = lv_obj_get_ext_attr(page);
+#if LV_USE_ANIMATION
+    if(ext->edge_flash.left_ip || ext->edge_flash.right_ip || ext->edge_flash.top_ip || ext->edge_flash.bottom_ip) {
+        return false;
+    }
+#endif
+
+    /*Only the screens on the display are drawn*/
+    lv_obj_t * scr   = lv_obj_get_screen(page);
+    lv_disp_t * disp = lv_obj_get_disp(scr);
+    if(scr != lv_disp_get_scr_act(disp) && scr != lv_disp_get_layer_top(disp) && scr != lv_disp_get_layer_sys(disp)) {
+        return false;
+    }
+
+    /*The border is drawn over the scrollable and the parent is visible in the rounded corners: leave them out.
+     * The area shouldn't depend on the direction to let more moves in a refresh period be joined.*/
+    const lv_style_t * style = lv_obj_get_style(page);
+    lv_coord_t pad           = LV_MATH_MAX(style->body.border.width, style->body.radius);
+
+    lv_area_t area;
+    lv_area_copy(&area, &page->coords);
+    area.x1 += pad;
+    area.x2 -= pad;
+    area.y1 += pad;
+    area.y2 -= pad;
+    if(area.x1 > area.x2 || area.y1 > area.y2) return false;
+
+    /*The visible part of the page*/
+    lv_area_t vis_area;
+    lv_area_copy(&vis_area, &page->coords);
+
+    lv_obj_t * par = lv_obj_get_parent(page);
+    while(par) {
+        if(lv_obj_get_hidden(par)) return false;
+        if(lv_area_intersect(&vis_area, &vis_area, &par->coords) == false) return false;
+        if(lv_area_intersect(&area, &area, &par->coords) == false) return false;
+
+        /*The border and the scrollbars of the parent pages are drawn over the page*/
+        if(lv_obj_get_design_cb(par) == lv_page_design) {
+            const lv_style_t * par_style = lv_obj_get_style(par);
+            lv_page_ext_t * par_ext      = lv_obj_get_ext_attr(par);
+            lv_coord_t par_pad           = par_style->body.border.width;
+            if(par_pad != 0) par_pad = LV_MATH_MAX(par_pad, par_style->body.radius);
+
+            lv_area_t par_area;
+            lv_area_copy(&par_area, &par->coords);
+            par_area.x1 += par_pad;
+            par_area.x2 -= par_pad;
+            par_area.y1 += par_pad;
+            par_area.y2 -= par_pad;
+            if(lv_area_intersect(&area, &area, &par_area) == false) return false;
+
+            lv_area_t sb_area;
+            if(par_ext->sb.hor_draw && (par_ext->sb.mode & LV_SB_MODE_HIDE) == 0) {
+                lv_area_copy(&sb_area, &par_ext->sb.hor_area);
+                lv_area_set_pos(&sb_area, sb_area.x1 + par->coords.x1, sb_area.y1 + par->coords.y1);
+                if(lv_area_is_on(&sb_area, &area)) return false;
+            }
+            if(par_ext->sb.ver_draw && (par_ext->sb.mode & LV_SB_MODE_HIDE) == 0) {
+                lv_area_copy(&sb_area, &par_ext->sb.ver_area);
+                lv_area_set_pos(&sb_area, sb_area.x1 + par->coords.x1, sb_area.y1 + par->coords.y1);
+                if(lv_area_is_on(&sb_area, &area)) return false;
+            }
+        }
+        par = lv_obj_get_parent(par);
+    }
+
+    /*Under the scrollable: a background of one color or nothing if the scrollable covers the area*/
+    lv_obj_t * scrl               = ext->scrl;
+    const lv_style_t * style_scrl = lv_obj_get_style(scrl);
+    if(style->body.opa != LV_OPA_COVER || style->body.main_color.full != style->body.grad_color.full) {
+        if(style_scrl->body.opa != LV_OPA_COVER || style_scrl->body.radius != 0) return false;
+
+        lv_area_t scrl_area;
+        lv_area_copy(&scrl_area, &scrl->coords);
+        if(lv_area_is_in(&area, &scrl_area) == false) return false;
+        lv_area_set_pos(&scrl_area, scrl_area.x1 + diff->x, scrl_area.y1 + diff->y);
+        if(lv_area_is_in(&area, &scrl_area) == false) return false;
+    }
+
+    /*Over the page*/
+    if(lv_refr_is_covered(page, &area)) return false;
+
+    if(lv_refr_scroll(disp, &area, diff->x, diff->y) == false) return false;
+
+    /*The scrollbars are moved too but they stay*/
+    lv_area_t sb_area;
+    if(ext->sb.hor_draw) {
+        lv_area_copy(&sb_area, &ext->sb.hor_area);
+        lv_area_set_pos(&sb_area, sb_area.x1 + page->coords.x1 + diff->x, sb_area.y1 + page->coords.y1 + diff->y);
+        lv_inv_area(disp, &sb_area);
+    }
+    if(ext->sb.ver_draw) {
+        lv_area_copy(&sb_area, &ext->sb.ver_area);
+        lv_area_set_pos(&sb_area, sb_area.x1 + page->coords.x1 + diff->x, sb_area.y1 + page->coords.y1 + diff->y);
+        lv_inv_area(disp, &sb_area);
+    }
+
+    /*Redraw the scrollable around the moved area*/
+    lv_area_t inv_area;
+    lv_area_copy(&inv_area, &vis_area);
+    inv_area.y2 = area.y1 - 1;
+    if(inv_area.y1 <= inv_area.y2) lv_inv_area(disp, &inv_area);
+
+    lv_area_copy(&inv_area, &vis_area);
+    inv_area.y1 = area.y2 + 1;
+    if(inv_area.y1 <= inv_area.y2) lv_inv_area(disp, &inv_area);
+
+    lv_area_copy(&inv_area, &area);
+    inv_area.x1 = vis_area.x1;
+    inv_area.x2 = area.x1 - 1;
+    if(inv_area.x1 <= inv_area.x2) lv_inv_area(disp, &inv_area);
+
+    lv_area_copy(&inv_area, &area);
+    inv_area.x1 = area.x2 + 1;
+    inv_area.x2 = vis_area.x2;
+    if(inv_area.x1 <= inv_area.x2) lv_inv_area(disp, &inv_area);
+
+    return true;
+}
+
+#endif
+
 #endif
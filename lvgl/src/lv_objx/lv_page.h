@@ -33,6 +33,8 @@ extern "C" {
 /*********************
  *      DEFINES
  *********************/
+/**Minimal length of the scrollbars*/
+#define LV_PAGE_SB_MIN_SIZE (LV_DPI / 8)
 
 /**********************
  *      TYPEDEFS
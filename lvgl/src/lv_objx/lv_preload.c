@@ -9,7 +9,9 @@
 #include "lv_preload.h"
 #if LV_USE_PRELOAD != 0
 
+#include <string.h>
 #include "../lv_misc/lv_math.h"
+#include "../lv_core/lv_refr.h"
 #include "../lv_draw/lv_draw_rect.h"
 #include "../lv_draw/lv_draw_arc.h"
 #include "../lv_themes/lv_theme.h"
@@ -29,21 +31,49 @@
 #define LV_PRELOAD_DEF_ANIM LV_PRELOAD_TYPE_SPINNING_ARC /*animation type*/
 #endif
 
+/*Different sizes and styles of sprite spinners at once*/
+#define LV_PRELOAD_SPRITE_SET_MAX 4
+
 /**********************
  *      TYPEDEFS
  **********************/
+#if LV_PRELOAD_SPRITE_FRAMES
+struct _lv_preload_sprite_t
+{
+    /*Everything the drawn arc depends on beside the angle*/
+    lv_coord_t w;
+    lv_coord_t h;
+    lv_coord_t line_width;
+    lv_anim_value_t arc_length;
+    lv_opa_t opa;
+    uint8_t rounded;
+
+    uint16_t ref_cnt;                           /*Preloaders using it, 0: free slot*/
+    uint8_t * frames[LV_PRELOAD_SPRITE_FRAMES]; /*`w * h` opacities of the arc, NULL until first shown*/
+};
+#endif
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
 static bool lv_preload_design(lv_obj_t * preload, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_preload_signal(lv_obj_t * preload, lv_signal_t sign, void * param);
+#if LV_PRELOAD_SPRITE_FRAMES
+static bool sprite_is_match(const lv_preload_sprite_t * sprite, const lv_obj_t * preload, const lv_style_t * style);
+static void sprite_update(lv_obj_t * preload);
+static void sprite_release(lv_obj_t * preload);
+static void sprite_frame_draw(lv_obj_t * preload, uint16_t frame);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static lv_signal_cb_t ancestor_signal;
 static lv_design_cb_t ancestor_design;
+#if LV_PRELOAD_SPRITE_FRAMES
+static lv_preload_sprite_t sprites[LV_PRELOAD_SPRITE_SET_MAX];
+static uint32_t sprite_reserved; /*Bytes of all the frames of the used sprites, drawn or not*/
+#endif
 
 /**********************
  *      MACROS
@@ -81,6 +111,11 @@ lv_obj_t * lv_preload_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->arc_length = LV_PRELOAD_DEF_ARC_LENGTH;
     ext->anim_type  = LV_PRELOAD_DEF_ANIM;
     ext->anim_dir   = LV_PRELOAD_DIR_FORWARD;
+#if LV_PRELOAD_SPRITE_FRAMES
+    ext->sprite       = NULL;
+    ext->sprite_frame = 0;
+    ext->sprite_en    = 0;
+#endif
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_preload, lv_preload_signal);
@@ -107,6 +142,9 @@ lv_obj_t * lv_preload_create(lv_obj_t * par, const lv_obj_t * copy)
         ext->arc_length             = copy_ext->arc_length;
         ext->time                   = copy_ext->time;
         ext->anim_dir               = copy_ext->anim_dir;
+#if LV_PRELOAD_SPRITE_FRAMES
+        ext->sprite_en = copy_ext->sprite_en;
+#endif
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_preload);
     }
@@ -256,6 +294,26 @@ void lv_preload_set_dir(lv_obj_t * preload, lv_preload_dir_t dir)
     lv_preload_set_type(preload, ext->anim_type);
 }
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/**
+ * Copy the arc of a spinning preloader from `LV_PRELOAD_SPRITE_FRAMES` pre-drawn rotation frames
+ * instead of drawing it in every step. A frame is drawn when it's first shown and the preloaders
+ * of the same size and style share them. The frames take `LV_PRELOAD_SPRITE_BUDGET` bytes at most,
+ * a preloader whose frames don't fit is drawn as usual.
+ * @param preload pointer to pre loader object
+ * @param en true: use the sprite (only with `LV_PRELOAD_TYPE_SPINNING_ARC`)
+ */
+void lv_preload_set_sprite(lv_obj_t * preload, bool en)
+{
+    lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
+    if(ext->sprite_en == (en ? 1 : 0)) return;
+
+    ext->sprite_en = en ? 1 : 0;
+    if(en == false) sprite_release(preload);
+    lv_obj_invalidate(preload);
+}
+#endif
+
 /*=====================
  * Getter functions
  *====================*/
@@ -315,6 +373,19 @@ lv_preload_dir_t lv_preload_get_dir(lv_obj_t * preload)
     return ext->anim_dir;
 }
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/**
+ * Get whether a preloader copies its arc from pre-drawn frames
+ * @param preload pointer to pre loader object
+ * @return true: `lv_preload_set_sprite` enabled it
+ */
+bool lv_preload_get_sprite(const lv_obj_t * preload)
+{
+    lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
+    return ext->sprite_en ? true : false;
+}
+#endif
+
 /*=====================
  * Other functions
  *====================*/
@@ -329,12 +400,33 @@ void lv_preload_spinner_anim(void * ptr, lv_anim_value_t val)
     lv_obj_t * preload     = ptr;
     lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
 
+#if LV_PRELOAD_SPRITE_FRAMES
+    /*Round to the frames of the sprite. The steps between them don't change anything.*/
+    uint16_t frame = 0;
+    if(ext->sprite_en && ext->anim_type == LV_PRELOAD_TYPE_SPINNING_ARC) {
+        frame = (((int32_t)val * LV_PRELOAD_SPRITE_FRAMES + 180) / 360) % LV_PRELOAD_SPRITE_FRAMES;
+        val   = (int32_t)frame * 360 / LV_PRELOAD_SPRITE_FRAMES;
+    }
+#endif
+
     int16_t angle_start = val - ext->arc_length / 2 + 180;
     int16_t angle_end   = angle_start + ext->arc_length;
 
     angle_start = angle_start % 360;
     angle_end   = angle_end % 360;
 
+#if LV_PRELOAD_SPRITE_FRAMES
+    if(ext->sprite_en && ext->anim_type == LV_PRELOAD_TYPE_SPINNING_ARC) {
+        sprite_update(preload);
+        if(ext->sprite && ext->sprite_frame == frame && lv_arc_get_angle_start(preload) == (uint16_t)angle_start) return;
+
+        lv_arc_set_angles(preload, angle_start, angle_end);
+        ext->sprite_frame = frame;
+        if(ext->sprite && ext->sprite->frames[frame] == NULL) sprite_frame_draw(preload, frame);
+        return;
+    }
+#endif
+
     lv_arc_set_angles(preload, angle_start, angle_end);
 }
 
@@ -385,6 +477,17 @@ static bool lv_preload_design(lv_obj_t * preload, const lv_area_t * mask, lv_des
 
             lv_draw_rect(&bg_area, mask, &bg_style, lv_obj_get_opa_scale(preload));
         }
+
+#if LV_PRELOAD_SPRITE_FRAMES
+        /*Copy the arc from the current frame if it's drawn already*/
+        lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
+        if(ext->sprite && ext->sprite->frames[ext->sprite_frame] && sprite_is_match(ext->sprite, preload, style)) {
+            lv_draw_opa_map(&preload->coords, mask, ext->sprite->frames[ext->sprite_frame], style->line.color,
+                            LV_OPA_COVER);
+            return true;
+        }
+#endif
+
         /*Draw the arc above the background circle */
         ancestor_design(preload, mask, mode);
     }
@@ -411,7 +514,9 @@ static lv_res_t lv_preload_signal(lv_obj_t * preload, lv_signal_t sign, void * p
     if(res != LV_RES_OK) return res;
 
     if(sign == LV_SIGNAL_CLEANUP) {
-        /*Nothing to cleanup. (No dynamically allocated memory in 'ext')*/
+#if LV_PRELOAD_SPRITE_FRAMES
+        sprite_release(preload);
+#endif
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
         uint8_t i;
@@ -424,4 +529,148 @@ static lv_res_t lv_preload_signal(lv_obj_t * preload, lv_signal_t sign, void * p
     return res;
 }
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/**
+ * Check if the frames of a sprite can be used for a preloader
+ * @param sprite pointer to a sprite
+ * @param preload pointer to a pre loader object
+ * @param style the style of the preloader
+ * @return true: the arc of `preload` looks the same as in the frames
+ */
+static bool sprite_is_match(const lv_preload_sprite_t * sprite, const lv_obj_t * preload, const lv_style_t * style)
+{
+    lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
+
+    return sprite->w == lv_obj_get_width(preload) && sprite->h == lv_obj_get_height(preload) &&
+           sprite->line_width == style->line.width && sprite->rounded == style->line.rounded &&
+           sprite->opa == style->body.opa && sprite->arc_length == ext->arc_length;
+}
+
+/**
+ * Get the sprite of a preloader's current size and style, or drop its sprite if it can't have one.
+ * Called in the animation, so the frames are never changed while they are copied.
+ * @param preload pointer to a pre loader object
+ */
+static void sprite_update(lv_obj_t * preload)
+{
+    lv_preload_ext_t * ext   = lv_obj_get_ext_attr(preload);
+    const lv_style_t * style = lv_preload_get_style(preload, LV_PRELOAD_STYLE_MAIN);
+    if(ext->sprite && sprite_is_match(ext->sprite, preload, style)) return;
+
+    sprite_release(preload);
+
+    /*The frames are opacities of the whole preloader, the opacity scale would be drawn into them*/
+    if(lv_obj_get_opa_scale(preload) != LV_OPA_COVER) return;
+
+    uint8_t i;
+    for(i = 0; i < LV_PRELOAD_SPRITE_SET_MAX; i++) {
+        if(sprites[i].ref_cnt > 0 && sprite_is_match(&sprites[i], preload, style)) {
+            sprites[i].ref_cnt++;
+            ext->sprite = &sprites[i];
+            return;
+        }
+    }
+
+    uint32_t size = (uint32_t)lv_obj_get_width(preload) * lv_obj_get_height(preload) * LV_PRELOAD_SPRITE_FRAMES;
+    if(size == 0 || sprite_reserved + size > LV_PRELOAD_SPRITE_BUDGET) return;
+
+    for(i = 0; i < LV_PRELOAD_SPRITE_SET_MAX; i++) {
+        if(sprites[i].ref_cnt > 0) continue;
+
+        lv_preload_sprite_t * sprite = &sprites[i];
+        memset(sprite, 0, sizeof(lv_preload_sprite_t));
+        sprite->w          = lv_obj_get_width(preload);
+        sprite->h          = lv_obj_get_height(preload);
+        sprite->line_width = style->line.width;
+        sprite->rounded    = style->line.rounded;
+        sprite->opa        = style->body.opa;
+        sprite->arc_length = ext->arc_length;
+        sprite->ref_cnt    = 1;
+        sprite_reserved += size;
+        ext->sprite = sprite;
+        return;
+    }
+}
+
+/**
+ * Stop using the sprite of a preloader. The frames are freed when no preloader uses them.
+ * @param preload pointer to a pre loader object
+ */
+static void sprite_release(lv_obj_t * preload)
+{
+    lv_preload_ext_t * ext       = lv_obj_get_ext_attr(preload);
+    lv_preload_sprite_t * sprite = ext->sprite;
+    if(sprite == NULL) return;
+
+    ext->sprite = NULL;
+    sprite->ref_cnt--;
+    if(sprite->ref_cnt > 0) return;
+
+    uint16_t i;
+    for(i = 0; i < LV_PRELOAD_SPRITE_FRAMES; i++) {
+        if(sprite->frames[i]) lv_mem_free(sprite->frames[i]);
+        sprite->frames[i] = NULL;
+    }
+    sprite_reserved -= (uint32_t)sprite->w * sprite->h * LV_PRELOAD_SPRITE_FRAMES;
+}
+
+/**
+ * Draw a frame of a preloader's sprite with its current angles: the arc is drawn in white on black
+ * into a buffer as if it was the display and the brightness of its pixels are their opacities.
+ * @param preload pointer to a pre loader object with a sprite
+ * @param frame index of the frame
+ */
+static void sprite_frame_draw(lv_obj_t * preload, uint16_t frame)
+{
+    lv_preload_ext_t * ext = lv_obj_get_ext_attr(preload);
+    uint32_t px_cnt        = (uint32_t)ext->sprite->w * ext->sprite->h;
+
+    uint8_t * map    = lv_mem_alloc(px_cnt);
+    lv_color_t * buf = lv_mem_alloc(px_cnt * sizeof(lv_color_t));
+    if(map == NULL || buf == NULL) {
+        if(map) lv_mem_free(map);
+        if(buf) lv_mem_free(buf);
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < px_cnt; i++) buf[i] = LV_COLOR_BLACK;
+
+    lv_disp_t disp;
+    lv_disp_buf_t disp_buf;
+    memset(&disp, 0, sizeof(lv_disp_t));
+    lv_disp_buf_init(&disp_buf, buf, NULL, px_cnt);
+    lv_area_copy(&disp_buf.area, &preload->coords);
+    lv_disp_drv_init(&disp.driver);
+    disp.driver.buffer  = &disp_buf;
+    disp.driver.hor_res = ext->sprite->w;
+    disp.driver.ver_res = ext->sprite->h;
+
+    lv_style_t style;
+    lv_style_copy(&style, lv_preload_get_style(preload, LV_PRELOAD_STYLE_MAIN));
+    style.line.color = LV_COLOR_WHITE;
+
+    lv_disp_t * disp_ori         = lv_refr_get_disp_refreshing();
+    const lv_style_t * style_ori = preload->style_p;
+    lv_refr_set_disp_refreshing(&disp);
+    preload->style_p = &style;
+
+    ancestor_design(preload, &preload->coords, LV_DESIGN_DRAW_MAIN);
+
+    preload->style_p = style_ori;
+    lv_refr_set_disp_refreshing(disp_ori);
+
+    for(i = 0; i < px_cnt; i++) {
+        map[i] = lv_color_brightness(buf[i]);
+#if LV_COLOR_DEPTH == 32
+        /*`lv_color_mix` rounds down: white mixed to black with `opa` is `opa - 1`*/
+        if(map[i] > 0 && map[i] < LV_OPA_COVER) map[i]++;
+#endif
+    }
+    lv_mem_free(buf);
+
+    ext->sprite->frames[frame] = map;
+}
+#endif
+
 #endif
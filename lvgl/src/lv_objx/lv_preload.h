@@ -60,6 +60,11 @@ enum {
 };
 typedef uint8_t lv_preload_dir_t;
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/*Pre-drawn frames of the spinning arc, shared by the spinners of the same size and style*/
+typedef struct _lv_preload_sprite_t lv_preload_sprite_t;
+#endif
+
 /*Data of pre loader*/
 typedef struct
 {
@@ -67,8 +72,15 @@ typedef struct
     /*New data for this type */
     lv_anim_value_t arc_length;      /*Length of the spinning indicator in degree*/
     uint16_t time;                   /*Time of one round*/
+#if LV_PRELOAD_SPRITE_FRAMES
+    lv_preload_sprite_t * sprite;    /*The frames the arc is copied from, NULL: drawn as usual*/
+    uint16_t sprite_frame;           /*The frame of the current angles*/
+#endif
     lv_preload_type_t anim_type : 1; /*Type of the arc animation*/
     lv_preload_dir_t anim_dir : 1;   /*Animation Direction*/
+#if LV_PRELOAD_SPRITE_FRAMES
+    uint8_t sprite_en : 1;           /*Copy the spinning arc from pre-drawn frames*/
+#endif
 } lv_preload_ext_t;
 
 /*Styles*/
@@ -134,6 +146,18 @@ void lv_preload_set_type(lv_obj_t * preload, lv_preload_type_t type);
  */
 void lv_preload_set_dir(lv_obj_t * preload, lv_preload_dir_t dir);
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/**
+ * Copy the arc of a spinning preloader from `LV_PRELOAD_SPRITE_FRAMES` pre-drawn rotation frames
+ * instead of drawing it in every step. A frame is drawn when it's first shown and the preloaders
+ * of the same size and style share them. The frames take `LV_PRELOAD_SPRITE_BUDGET` bytes at most,
+ * a preloader whose frames don't fit is drawn as usual.
+ * @param preload pointer to pre loader object
+ * @param en true: use the sprite (only with `LV_PRELOAD_TYPE_SPINNING_ARC`)
+ */
+void lv_preload_set_sprite(lv_obj_t * preload, bool en);
+#endif
+
 /*=====================
  * Getter functions
  *====================*/
@@ -172,6 +196,15 @@ lv_preload_type_t lv_preload_get_type(lv_obj_t * preload);
  */
 lv_preload_dir_t lv_preload_get_dir(lv_obj_t * preload);
 
+#if LV_PRELOAD_SPRITE_FRAMES
+/**
+ * Get whether a preloader copies its arc from pre-drawn frames
+ * @param preload pointer to pre loader object
+ * @return true: `lv_preload_set_sprite` enabled it
+ */
+bool lv_preload_get_sprite(const lv_obj_t * preload);
+#endif
+
 /*=====================
  * Other functions
  *====================*/
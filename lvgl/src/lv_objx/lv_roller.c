@@ -76,6 +76,7 @@ lv_obj_t * lv_roller_create(lv_obj_t * par, const lv_obj_t * copy)
     lv_mem_assert(ext);
     if(ext == NULL) return NULL;
     ext->ddlist.draw_arrow = 0; /*Do not draw arrow by default*/
+    ext->mode              = LV_ROLLER_MODE_NORMAL;
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_roller, lv_roller_signal);
@@ -137,7 +138,8 @@ void lv_roller_set_options(lv_obj_t * roller, const char * options, lv_roller_mo
     lv_roller_ext_t * ext = lv_obj_get_ext_attr(roller);
 
     if(mode == LV_ROLLER_MODE_NORMAL) {
-        ext->mode = LV_ROLLER_MODE_NORMAL;
+        ext->mode                = LV_ROLLER_MODE_NORMAL;
+        ext->ddlist.opt_page_cnt = 1;
         lv_ddlist_set_options(roller, options);
 
         /* Make sure the roller's height and the scrollable's height is refreshed.
@@ -147,16 +149,9 @@ void lv_roller_set_options(lv_obj_t * roller, const char * options, lv_roller_mo
     } else {
         ext->mode = LV_ROLLER_MODE_INIFINITE;
 
-        uint32_t opt_len = strlen(options) + 1; /*+1 to add '\n' after option lists*/
-        char * opt_extra = lv_mem_alloc(opt_len * LV_ROLLER_INF_PAGES);
-        uint8_t i;
-        for(i = 0; i < LV_ROLLER_INF_PAGES; i++) {
-            strcpy(&opt_extra[opt_len * i], options);
-            opt_extra[opt_len * (i + 1) - 1] = '\n';
-        }
-        opt_extra[opt_len * LV_ROLLER_INF_PAGES - 1] = '\0';
-        lv_ddlist_set_options(roller, opt_extra);
-        lv_mem_free(opt_extra);
+        /*Store the options once but show them on more pages. The rows wrap around in the text.*/
+        ext->ddlist.opt_page_cnt = LV_ROLLER_INF_PAGES;
+        lv_ddlist_set_options(roller, options);
 
         /* Make sure the roller's height and the scrollable's height is refreshed.
          * They are refreshed in `LV_SIGNAL_COORD_CHG` but if the new options has the same width
@@ -333,7 +328,6 @@ static bool lv_roller_design(lv_obj_t * roller, const lv_area_t * mask, lv_desig
     /*Post draw when the children are drawn*/
     else if(mode == LV_DESIGN_DRAW_POST) {
         const lv_style_t * style = lv_roller_get_style(roller, LV_ROLLER_STYLE_BG);
-        lv_roller_ext_t * ext    = lv_obj_get_ext_attr(roller);
         const lv_font_t * font   = style->text.font;
         lv_coord_t font_h        = lv_font_get_line_height(font);
         lv_opa_t opa_scale       = lv_obj_get_opa_scale(roller);
@@ -351,23 +345,10 @@ static bool lv_roller_design(lv_obj_t * roller, const lv_area_t * mask, lv_desig
         if(area_ok) {
             const lv_style_t * sel_style = lv_roller_get_style(roller, LV_ROLLER_STYLE_SEL);
             lv_style_t new_style;
-            lv_txt_flag_t txt_align = LV_TXT_FLAG_NONE;
-
-            {
-                lv_label_align_t label_align = lv_label_get_align(ext->ddlist.label);
-
-                if(LV_LABEL_ALIGN_CENTER == label_align) {
-                    txt_align |= LV_TXT_FLAG_CENTER;
-                } else if(LV_LABEL_ALIGN_RIGHT == label_align) {
-                    txt_align |= LV_TXT_FLAG_RIGHT;
-                }
-            }
-
             lv_style_copy(&new_style, style);
             new_style.text.color = sel_style->text.color;
             new_style.text.opa   = sel_style->text.opa;
-            lv_draw_label(&ext->ddlist.label->coords, &mask_sel, &new_style, opa_scale,
-                          lv_label_get_text(ext->ddlist.label), txt_align, NULL, -1, -1, NULL);
+            lv_ddlist_draw_options(roller, &mask_sel, &new_style, opa_scale);
         }
     }
 
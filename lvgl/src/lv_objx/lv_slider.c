@@ -30,6 +30,8 @@
  **********************/
 static bool lv_slider_design(lv_obj_t * slider, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_slider_signal(lv_obj_t * slider, lv_signal_t sign, void * param);
+static void lv_slider_area_get(const lv_obj_t * slider, lv_area_t * area_bg, lv_area_t * area_indic,
+                               lv_area_t * knob_area);
 
 /**********************
  *  STATIC VARIABLES
@@ -79,6 +81,7 @@ lv_obj_t * lv_slider_create(lv_obj_t * par, const lv_obj_t * copy)
 
     /*Init the new slider slider*/
     if(copy == NULL) {
+        lv_obj_set_cord_signal(new_slider, LV_OBJ_CORD_SIGNAL_SIZE);
         lv_obj_set_click(new_slider, true);
         lv_obj_set_protect(new_slider, LV_PROTECT_PRESS_LOST);
 
@@ -230,47 +233,18 @@ static bool lv_slider_design(lv_obj_t * slider, const lv_area_t * mask, lv_desig
     }
     /*Draw the object*/
     else if(mode == LV_DESIGN_DRAW_MAIN) {
-        lv_slider_ext_t * ext = lv_obj_get_ext_attr(slider);
-
         const lv_style_t * style_bg    = lv_slider_get_style(slider, LV_SLIDER_STYLE_BG);
         const lv_style_t * style_knob  = lv_slider_get_style(slider, LV_SLIDER_STYLE_KNOB);
         const lv_style_t * style_indic = lv_slider_get_style(slider, LV_SLIDER_STYLE_INDIC);
 
         lv_opa_t opa_scale = lv_obj_get_opa_scale(slider);
 
-        lv_coord_t slider_w = lv_area_get_width(&slider->coords);
-        lv_coord_t slider_h = lv_area_get_height(&slider->coords);
-
-        /*Draw the bar*/
         lv_area_t area_bg;
-        lv_area_copy(&area_bg, &slider->coords);
-
-        /*Be sure at least LV_SLIDER_SIZE_MIN  size will remain*/
-        lv_coord_t pad_top_bg    = style_bg->body.padding.top;
-        lv_coord_t pad_bottom_bg = style_bg->body.padding.bottom;
-        lv_coord_t pad_left_bg   = style_bg->body.padding.left;
-        lv_coord_t pad_right_bg  = style_bg->body.padding.right;
-        if(pad_top_bg + pad_bottom_bg + LV_SLIDER_SIZE_MIN > lv_area_get_height(&area_bg)) {
-            pad_top_bg    = (lv_area_get_height(&area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
-            pad_bottom_bg = pad_top_bg;
-        }
-        if(pad_left_bg + pad_right_bg + LV_SLIDER_SIZE_MIN > lv_area_get_width(&area_bg)) {
-            pad_left_bg  = (lv_area_get_width(&area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
-            pad_right_bg = (lv_area_get_width(&area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
-        }
-
-        if(ext->knob_in) { /*Enable extra size if the knob is inside */
-            area_bg.x1 += pad_left_bg;
-            area_bg.x2 -= pad_right_bg;
-            area_bg.y1 += pad_top_bg;
-            area_bg.y2 -= pad_bottom_bg;
-        } else {                                                   /*Let space only in the perpendicular directions*/
-            area_bg.x1 += slider_w < slider_h ? pad_left_bg : 0;   /*Pad only for vertical slider*/
-            area_bg.x2 -= slider_w < slider_h ? pad_right_bg : 0;  /*Pad only for vertical slider*/
-            area_bg.y1 += slider_w > slider_h ? pad_top_bg : 0;    /*Pad only for horizontal slider*/
-            area_bg.y2 -= slider_w > slider_h ? pad_bottom_bg : 0; /*Pad only for horizontal slider*/
-        }
+        lv_area_t area_indic;
+        lv_area_t knob_area;
+        lv_slider_area_get(slider, &area_bg, &area_indic, &knob_area);
 
+        /*Draw the bar*/
 #if LV_USE_GROUP == 0
         lv_draw_rect(&area_bg, mask, style_bg, lv_obj_get_opa_scale(slider));
 #else
@@ -287,168 +261,210 @@ static bool lv_slider_design(lv_obj_t * slider, const lv_area_t * mask, lv_desig
         }
 #endif
 
-        /*Draw the indicator*/
-        lv_area_t area_indic;
-        lv_area_copy(&area_indic, &area_bg);
-
-        /*Be sure at least ver pad/hor pad width indicator will remain*/
-        lv_coord_t pad_top_indic    = style_indic->body.padding.top;
-        lv_coord_t pad_bottom_indic = style_indic->body.padding.bottom;
-        lv_coord_t pad_left_indic   = style_indic->body.padding.left;
-        lv_coord_t pad_right_indic  = style_indic->body.padding.right;
-        if(pad_top_indic + pad_bottom_indic + LV_SLIDER_SIZE_MIN > lv_area_get_height(&area_bg)) {
-            pad_top_indic    = (lv_area_get_height(&area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
-            pad_bottom_indic = pad_top_indic;
-        }
-        if(pad_left_indic + pad_right_indic + LV_SLIDER_SIZE_MIN > lv_area_get_width(&area_bg)) {
-            pad_left_indic  = (lv_area_get_width(&area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
-            pad_right_indic = pad_left_indic;
+        /*Draw the indicator but don't draw an ugly 1px wide rectangle on the left on min. value*/
+        if(area_indic.x1 != area_indic.x2) lv_draw_rect(&area_indic, mask, style_indic, opa_scale);
+
+        /*Before the knob add the border if required*/
+#if LV_USE_GROUP
+        /* Draw the borders later if the bar is focused.
+         * At value = 100% the indicator can cover to whole background and the focused style won't
+         * be visible*/
+        if(lv_obj_is_focused(slider)) {
+            lv_style_t style_tmp;
+            lv_style_copy(&style_tmp, style_bg);
+            style_tmp.body.opa          = LV_OPA_TRANSP;
+            style_tmp.body.shadow.width = 0;
+            lv_draw_rect(&area_bg, mask, &style_tmp, opa_scale);
         }
+#endif
+
+        /*Draw the knob*/
+        lv_draw_rect(&knob_area, mask, style_knob, opa_scale);
+    }
+    /*Post draw when the children are drawn*/
+    else if(mode == LV_DESIGN_DRAW_POST) {
+    }
+
+    return true;
+}
+
+/**
+ * Get the areas of the parts of a slider as they are drawn with the current value or animation state
+ * @param slider pointer to a slider object
+ * @param area_bg store the area of the bar here
+ * @param area_indic store the area of the indicator here
+ * @param knob_area store the area of the knob here
+ */
+static void lv_slider_area_get(const lv_obj_t * slider, lv_area_t * area_bg, lv_area_t * area_indic,
+                               lv_area_t * knob_area)
+{
+    lv_slider_ext_t * ext = lv_obj_get_ext_attr(slider);
+
+    const lv_style_t * style_bg    = lv_slider_get_style(slider, LV_SLIDER_STYLE_BG);
+    const lv_style_t * style_indic = lv_slider_get_style(slider, LV_SLIDER_STYLE_INDIC);
+
+    lv_coord_t slider_w = lv_area_get_width(&slider->coords);
+    lv_coord_t slider_h = lv_area_get_height(&slider->coords);
+
+    /*The bar*/
+    lv_area_copy(area_bg, &slider->coords);
+
+    /*Be sure at least LV_SLIDER_SIZE_MIN  size will remain*/
+    lv_coord_t pad_top_bg    = style_bg->body.padding.top;
+    lv_coord_t pad_bottom_bg = style_bg->body.padding.bottom;
+    lv_coord_t pad_left_bg   = style_bg->body.padding.left;
+    lv_coord_t pad_right_bg  = style_bg->body.padding.right;
+    if(pad_top_bg + pad_bottom_bg + LV_SLIDER_SIZE_MIN > lv_area_get_height(area_bg)) {
+        pad_top_bg    = (lv_area_get_height(area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
+        pad_bottom_bg = pad_top_bg;
+    }
+    if(pad_left_bg + pad_right_bg + LV_SLIDER_SIZE_MIN > lv_area_get_width(area_bg)) {
+        pad_left_bg  = (lv_area_get_width(area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
+        pad_right_bg = (lv_area_get_width(area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
+    }
+
+    if(ext->knob_in) { /*Enable extra size if the knob is inside */
+        area_bg->x1 += pad_left_bg;
+        area_bg->x2 -= pad_right_bg;
+        area_bg->y1 += pad_top_bg;
+        area_bg->y2 -= pad_bottom_bg;
+    } else {                                                    /*Let space only in the perpendicular directions*/
+        area_bg->x1 += slider_w < slider_h ? pad_left_bg : 0;   /*Pad only for vertical slider*/
+        area_bg->x2 -= slider_w < slider_h ? pad_right_bg : 0;  /*Pad only for vertical slider*/
+        area_bg->y1 += slider_w > slider_h ? pad_top_bg : 0;    /*Pad only for horizontal slider*/
+        area_bg->y2 -= slider_w > slider_h ? pad_bottom_bg : 0; /*Pad only for horizontal slider*/
+    }
+
+    /*The indicator*/
+    lv_area_copy(area_indic, area_bg);
+
+    /*Be sure at least ver pad/hor pad width indicator will remain*/
+    lv_coord_t pad_top_indic    = style_indic->body.padding.top;
+    lv_coord_t pad_bottom_indic = style_indic->body.padding.bottom;
+    lv_coord_t pad_left_indic   = style_indic->body.padding.left;
+    lv_coord_t pad_right_indic  = style_indic->body.padding.right;
+    if(pad_top_indic + pad_bottom_indic + LV_SLIDER_SIZE_MIN > lv_area_get_height(area_bg)) {
+        pad_top_indic    = (lv_area_get_height(area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
+        pad_bottom_indic = pad_top_indic;
+    }
+    if(pad_left_indic + pad_right_indic + LV_SLIDER_SIZE_MIN > lv_area_get_width(area_bg)) {
+        pad_left_indic  = (lv_area_get_width(area_bg) - LV_SLIDER_SIZE_MIN) >> 1;
+        pad_right_indic = pad_left_indic;
+    }
+
+    area_indic->x1 += pad_left_indic;
+    area_indic->x2 -= pad_right_indic;
+    area_indic->y1 += pad_top_indic;
+    area_indic->y2 -= pad_bottom_indic;
 
-        area_indic.x1 += pad_left_indic;
-        area_indic.x2 -= pad_right_indic;
-        area_indic.y1 += pad_top_indic;
-        area_indic.y2 -= pad_bottom_indic;
+    lv_coord_t cur_value = lv_slider_get_value(slider);
+    lv_coord_t min_value = lv_slider_get_min_value(slider);
+    lv_coord_t max_value = lv_slider_get_max_value(slider);
 
-        lv_coord_t cur_value = lv_slider_get_value(slider);
-        lv_coord_t min_value = lv_slider_get_min_value(slider);
-        lv_coord_t max_value = lv_slider_get_max_value(slider);
+    /*If dragged draw to the drag position*/
+    if(ext->drag_value != LV_SLIDER_NOT_PRESSED) cur_value = ext->drag_value;
 
-        /*If dragged draw to the drag position*/
-        if(ext->drag_value != LV_SLIDER_NOT_PRESSED) cur_value = ext->drag_value;
+    if(slider_w >= slider_h) {
+        lv_coord_t indic_w = lv_area_get_width(area_indic);
+#if LV_USE_ANIMATION
+        if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
+            /*Calculate the coordinates of anim. start and end*/
+            lv_coord_t anim_start_x =
+                (int32_t)((int32_t)indic_w * (ext->bar.anim_start - min_value)) / (max_value - min_value);
+            lv_coord_t anim_end_x =
+                (int32_t)((int32_t)indic_w * (ext->bar.anim_end - min_value)) / (max_value - min_value);
+
+            /*Calculate the real position based on `anim_state` (between `anim_start` and
+             * `anim_end`)*/
+            area_indic->x2 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
+        } else
+#endif
+        {
+            area_indic->x2 = (int32_t)((int32_t)indic_w * (cur_value - min_value)) / (max_value - min_value);
+        }
+        area_indic->x2 = area_indic->x1 + area_indic->x2 - 1;
+    } else {
+        lv_coord_t indic_h = lv_area_get_height(area_indic);
+#if LV_USE_ANIMATION
+        if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
+            /*Calculate the coordinates of anim. start and end*/
+            lv_coord_t anim_start_y =
+                (int32_t)((int32_t)indic_h * (ext->bar.anim_start - min_value)) / (max_value - min_value);
+            lv_coord_t anim_end_y =
+                (int32_t)((int32_t)indic_h * (ext->bar.anim_end - min_value)) / (max_value - min_value);
+
+            /*Calculate the real position based on `anim_state` (between `anim_start` and
+             * `anim_end`)*/
+            area_indic->y1 = anim_start_y + (((anim_end_y - anim_start_y) * ext->bar.anim_state) >> 8);
+        } else
+#endif
+        {
+            area_indic->y1 = (int32_t)((int32_t)indic_h * (cur_value - min_value)) / (max_value - min_value);
+        }
+        area_indic->y1 = area_indic->y2 - area_indic->y1 + 1;
+    }
 
-        if(slider_w >= slider_h) {
-            lv_coord_t indic_w = lv_area_get_width(&area_indic);
+    /*The knob*/
+    lv_area_copy(knob_area, &slider->coords);
+
+    if(slider_w >= slider_h) {
+        if(ext->knob_in == 0) {
+            knob_area->x1 = area_indic->x2 - slider_h / 2;
+            knob_area->x2 = knob_area->x1 + slider_h - 1;
+        } else {
 #if LV_USE_ANIMATION
             if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
-                /*Calculate the coordinates of anim. start and end*/
+                lv_coord_t w = slider_w - slider_h - 1;
                 lv_coord_t anim_start_x =
-                    (int32_t)((int32_t)indic_w * (ext->bar.anim_start - min_value)) / (max_value - min_value);
+                    (int32_t)((int32_t)w * (ext->bar.anim_start - min_value)) / (max_value - min_value);
                 lv_coord_t anim_end_x =
-                    (int32_t)((int32_t)indic_w * (ext->bar.anim_end - min_value)) / (max_value - min_value);
+                    (int32_t)((int32_t)w * (ext->bar.anim_end - min_value)) / (max_value - min_value);
 
                 /*Calculate the real position based on `anim_state` (between `anim_start` and
                  * `anim_end`)*/
-                area_indic.x2 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
+                knob_area->x1 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
             } else
 #endif
             {
-                area_indic.x2 = (int32_t)((int32_t)indic_w * (cur_value - min_value)) / (max_value - min_value);
+                knob_area->x1 = (int32_t)((int32_t)(slider_w - slider_h - 1) * (cur_value - min_value)) /
+                                (max_value - min_value);
             }
-            area_indic.x2 = area_indic.x1 + area_indic.x2 - 1;
 
-            /*Draw the indicator but don't draw an ugly 1px wide rectangle on the left on min.
-             * value*/
-            if(area_indic.x1 != area_indic.x2) lv_draw_rect(&area_indic, mask, style_indic, opa_scale);
+            knob_area->x1 += slider->coords.x1;
+            knob_area->x2 = knob_area->x1 + slider_h - 1;
+        }
 
+        knob_area->y1 = slider->coords.y1;
+        knob_area->y2 = slider->coords.y2;
+    } else {
+        if(ext->knob_in == 0) {
+            knob_area->y1 = area_indic->y1 - slider_w / 2;
+            knob_area->y2 = knob_area->y1 + slider_w - 1;
         } else {
-            lv_coord_t indic_h = lv_area_get_height(&area_indic);
 #if LV_USE_ANIMATION
             if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
-                /*Calculate the coordinates of anim. start and end*/
-                lv_coord_t anim_start_y =
-                    (int32_t)((int32_t)indic_h * (ext->bar.anim_start - min_value)) / (max_value - min_value);
-                lv_coord_t anim_end_y =
-                    (int32_t)((int32_t)indic_h * (ext->bar.anim_end - min_value)) / (max_value - min_value);
+                lv_coord_t h = slider_h - slider_w - 1;
+                lv_coord_t anim_start_x =
+                    (int32_t)((int32_t)h * (ext->bar.anim_start - min_value)) / (max_value - min_value);
+                lv_coord_t anim_end_x =
+                    (int32_t)((int32_t)h * (ext->bar.anim_end - min_value)) / (max_value - min_value);
 
                 /*Calculate the real position based on `anim_state` (between `anim_start` and
                  * `anim_end`)*/
-                area_indic.y1 = anim_start_y + (((anim_end_y - anim_start_y) * ext->bar.anim_state) >> 8);
+                knob_area->y2 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
             } else
 #endif
             {
-                area_indic.y1 = (int32_t)((int32_t)indic_h * (cur_value - min_value)) / (max_value - min_value);
+                knob_area->y2 = (int32_t)((int32_t)(slider_h - slider_w - 1) * (cur_value - min_value)) /
+                                (max_value - min_value);
             }
-            area_indic.y1 = area_indic.y2 - area_indic.y1 + 1;
 
-            /*Draw the indicator but don't draw an ugly 1px height rectangle on the bottom on min.
-             * value*/
-            if(area_indic.x1 != area_indic.x2) lv_draw_rect(&area_indic, mask, style_indic, opa_scale);
-        }
-
-        /*Before the knob add the border if required*/
-#if LV_USE_GROUP
-        /* Draw the borders later if the bar is focused.
-         * At value = 100% the indicator can cover to whole background and the focused style won't
-         * be visible*/
-        if(lv_obj_is_focused(slider)) {
-            lv_style_t style_tmp;
-            lv_style_copy(&style_tmp, style_bg);
-            style_tmp.body.opa          = LV_OPA_TRANSP;
-            style_tmp.body.shadow.width = 0;
-            lv_draw_rect(&area_bg, mask, &style_tmp, opa_scale);
+            knob_area->y2 = slider->coords.y2 - knob_area->y2;
+            knob_area->y1 = knob_area->y2 - slider_w - 1;
         }
-#endif
-
-        /*Draw the knob*/
-        lv_area_t knob_area;
-        lv_area_copy(&knob_area, &slider->coords);
-
-        if(slider_w >= slider_h) {
-            if(ext->knob_in == 0) {
-                knob_area.x1 = area_indic.x2 - slider_h / 2;
-                knob_area.x2 = knob_area.x1 + slider_h - 1;
-            } else {
-#if LV_USE_ANIMATION
-                if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
-                    lv_coord_t w = slider_w - slider_h - 1;
-                    lv_coord_t anim_start_x =
-                        (int32_t)((int32_t)w * (ext->bar.anim_start - min_value)) / (max_value - min_value);
-                    lv_coord_t anim_end_x =
-                        (int32_t)((int32_t)w * (ext->bar.anim_end - min_value)) / (max_value - min_value);
-
-                    /*Calculate the real position based on `anim_state` (between `anim_start` and
-                     * `anim_end`)*/
-                    knob_area.x1 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
-                } else
-#endif
-                {
-                    knob_area.x1 = (int32_t)((int32_t)(slider_w - slider_h - 1) * (cur_value - min_value)) /
-                                   (max_value - min_value);
-                }
-
-                knob_area.x1 += slider->coords.x1;
-                knob_area.x2 = knob_area.x1 + slider_h - 1;
-            }
-
-            knob_area.y1 = slider->coords.y1;
-            knob_area.y2 = slider->coords.y2;
-        } else {
-            if(ext->knob_in == 0) {
-                knob_area.y1 = area_indic.y1 - slider_w / 2;
-                knob_area.y2 = knob_area.y1 + slider_w - 1;
-            } else {
-#if LV_USE_ANIMATION
-                if(ext->bar.anim_state != LV_BAR_ANIM_STATE_INV) {
-                    lv_coord_t h = slider_h - slider_w - 1;
-                    lv_coord_t anim_start_x =
-                        (int32_t)((int32_t)h * (ext->bar.anim_start - min_value)) / (max_value - min_value);
-                    lv_coord_t anim_end_x =
-                        (int32_t)((int32_t)h * (ext->bar.anim_end - min_value)) / (max_value - min_value);
-
-                    /*Calculate the real position based on `anim_state` (between `anim_start` and
-                     * `anim_end`)*/
-                    knob_area.y2 = anim_start_x + (((anim_end_x - anim_start_x) * ext->bar.anim_state) >> 8);
-                } else
-#endif
-                {
-                    knob_area.y2 = (int32_t)((int32_t)(slider_h - slider_w - 1) * (cur_value - min_value)) /
-                                   (max_value - min_value);
-                }
-
-                knob_area.y2 = slider->coords.y2 - knob_area.y2;
-                knob_area.y1 = knob_area.y2 - slider_w - 1;
-            }
-            knob_area.x1 = slider->coords.x1;
-            knob_area.x2 = slider->coords.x2;
-        }
-        lv_draw_rect(&knob_area, mask, style_knob, opa_scale);
-    }
-    /*Post draw when the children are drawn*/
-    else if(mode == LV_DESIGN_DRAW_POST) {
+        knob_area->x1 = slider->coords.x1;
+        knob_area->x2 = slider->coords.x2;
     }
-
-    return true;
 }
 
 /**
@@ -496,8 +512,10 @@ static lv_res_t lv_slider_signal(lv_obj_t * slider, lv_signal_t sign, void * par
             tmp = ext->bar.max_value;
 
         if(tmp != ext->drag_value) {
+            lv_bar_value_area_t old;
+            lv_bar_get_value_area(slider, &old);
             ext->drag_value = tmp;
-            lv_obj_invalidate(slider);
+            lv_bar_invalidate_value(slider, &old);
             res = lv_event_send(slider, LV_EVENT_VALUE_CHANGED, NULL);
             if(res != LV_RES_OK) return res;
         }
@@ -522,6 +540,18 @@ static lv_res_t lv_slider_signal(lv_obj_t * slider, lv_signal_t sign, void * par
            lv_obj_get_height(slider) != lv_area_get_height(param)) {
             slider->signal_cb(slider, LV_SIGNAL_REFR_EXT_DRAW_PAD, NULL);
         }
+    } else if(sign == LV_SIGNAL_GET_VALUE_AREA) {
+        /*The bar's areas don't apply: the slider has its own paddings and the knob*/
+        lv_bar_value_area_t * area     = param;
+        const lv_style_t * style_indic = lv_slider_get_style(slider, LV_SLIDER_STYLE_INDIC);
+        const lv_style_t * style_knob  = lv_slider_get_style(slider, LV_SLIDER_STYLE_KNOB);
+        lv_area_t area_bg;
+        lv_slider_area_get(slider, &area_bg, &area->indic, &area->knob);
+
+        area->indic_radius = style_indic->body.radius;
+        area->indic_shadow = style_indic->body.shadow.width;
+        area->knob_pad     = style_knob->body.shadow.width + 1;
+        area->indic_grad   = style_indic->body.main_color.full != style_indic->body.grad_color.full;
     } else if(sign == LV_SIGNAL_REFR_EXT_DRAW_PAD) {
         const lv_style_t * style      = lv_slider_get_style(slider, LV_SLIDER_STYLE_BG);
         const lv_style_t * knob_style = lv_slider_get_style(slider, LV_SLIDER_STYLE_KNOB);
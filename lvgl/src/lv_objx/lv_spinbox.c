@@ -76,6 +76,9 @@ lv_obj_t * lv_spinbox_create(lv_obj_t * par, const lv_obj_t * copy)
     lv_ta_set_one_line(new_spinbox, true);
     lv_ta_set_cursor_click_pos(new_spinbox, false);
 
+    /*Redraw only the changed digits of the value*/
+    lv_label_set_digit_cells(lv_ta_get_label(new_spinbox), true);
+
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_spinbox, lv_spinbox_signal);
     lv_obj_set_design_cb(new_spinbox, ancestor_design); /*Leave the Text area's design function*/
@@ -30,6 +30,7 @@
  *  STATIC PROTOTYPES
  **********************/
 static lv_res_t lv_sw_signal(lv_obj_t * sw, lv_signal_t sign, void * param);
+static void lv_sw_knob_style_set(lv_obj_t * sw, const lv_style_t * style);
 
 /**********************
  *  STATIC VARIABLES
@@ -134,7 +135,7 @@ void lv_sw_on(lv_obj_t * sw, lv_anim_enable_t anim)
 #endif
     lv_sw_ext_t * ext = lv_obj_get_ext_attr(sw);
     lv_slider_set_value(sw, LV_SW_MAX_VALUE, anim);
-    lv_slider_set_style(sw, LV_SLIDER_STYLE_KNOB, ext->style_knob_on);
+    lv_sw_knob_style_set(sw, ext->style_knob_on);
 }
 
 /**
@@ -149,7 +150,7 @@ void lv_sw_off(lv_obj_t * sw, lv_anim_enable_t anim)
 #endif
     lv_sw_ext_t * ext = lv_obj_get_ext_attr(sw);
     lv_slider_set_value(sw, 0, anim);
-    lv_slider_set_style(sw, LV_SLIDER_STYLE_KNOB, ext->style_knob_off);
+    lv_sw_knob_style_set(sw, ext->style_knob_off);
 }
 
 /**
@@ -320,11 +321,11 @@ static lv_res_t lv_sw_signal(lv_obj_t * sw, lv_signal_t sign, void * param)
         }
     } else if(sign == LV_SIGNAL_PRESS_LOST) {
         if(lv_sw_get_state(sw)) {
-            lv_slider_set_style(sw, LV_SLIDER_STYLE_KNOB, ext->style_knob_on);
+            lv_sw_knob_style_set(sw, ext->style_knob_on);
             lv_slider_set_value(sw, LV_SW_MAX_VALUE, LV_ANIM_ON);
             if(res != LV_RES_OK) return res;
         } else {
-            lv_slider_set_style(sw, LV_SLIDER_STYLE_KNOB, ext->style_knob_off);
+            lv_sw_knob_style_set(sw, ext->style_knob_off);
             lv_slider_set_value(sw, 0, LV_ANIM_ON);
             if(res != LV_RES_OK) return res;
         }
@@ -386,4 +387,32 @@ static lv_res_t lv_sw_signal(lv_obj_t * sw, lv_signal_t sign, void * param)
     return res;
 }
 
+/**
+ * Set the knob's style on a state change. If the shadow stays the same
+ * only the knob is redrawn, not the whole switch.
+ * @param sw pointer to a switch object
+ * @param style the knob's style of the new state
+ */
+static void lv_sw_knob_style_set(lv_obj_t * sw, const lv_style_t * style)
+{
+    const lv_style_t * old = lv_slider_get_style(sw, LV_SLIDER_STYLE_KNOB);
+    if(old == style) return;
+
+    if(old == NULL || style == NULL || old->body.shadow.width != style->body.shadow.width) {
+        lv_slider_set_style(sw, LV_SLIDER_STYLE_KNOB, style);
+        return;
+    }
+
+    lv_sw_ext_t * ext      = lv_obj_get_ext_attr(sw);
+    ext->slider.style_knob = style;
+
+    lv_bar_value_area_t area;
+    lv_bar_get_value_area(sw, &area);
+    area.knob.x1 -= area.knob_pad;
+    area.knob.y1 -= area.knob_pad;
+    area.knob.x2 += area.knob_pad;
+    area.knob.y2 += area.knob_pad;
+    lv_obj_invalidate_area(sw, &area.knob);
+}
+
 #endif
@@ -393,10 +393,8 @@ void lv_ta_del_char(lv_obj_t * ta)
     }
 
     char * label_txt = lv_label_get_text(ext->label);
-    /*Delete a character*/
-    lv_txt_cut(label_txt, ext->cursor.pos - 1, 1);
-    /*Refresh the label*/
-    lv_label_set_text(ext->label, label_txt);
+    /*Delete a character and refresh the label*/
+    lv_label_cut_text(ext->label, ext->cursor.pos - 1, 1);
     lv_ta_clear_selection(ta);
 
     /*Don't let 'width == 0' because cursor will not be visible*/
@@ -564,8 +562,8 @@ void lv_ta_set_cursor_pos(lv_obj_t * ta, int16_t pos)
         lv_obj_set_y(label_par, -cur_pos.y + style->body.padding.top);
     }
 
-    /*Check the bottom*/
-    if(label_cords.y1 + cur_pos.y + font_h + style->body.padding.bottom > ta_cords.y2) {
+    /*Check the bottom (a line fitting exactly, e.g. in one line mode, is not scrolled)*/
+    if(label_cords.y1 + cur_pos.y + font_h + style->body.padding.bottom > ta_cords.y2 + 1) {
         lv_obj_set_y(label_par, -(cur_pos.y - lv_obj_get_height(ta) + font_h + style->body.padding.top +
                                   style->body.padding.bottom));
     }
@@ -1285,7 +1283,7 @@ static bool lv_ta_scrollable_design(lv_obj_t * scrl, const lv_area_t * mask, lv_
             cur_area.x1 += cur_style.body.padding.left;
             cur_area.y1 += cur_style.body.padding.top;
             lv_draw_label(&cur_area, mask, &cur_style, opa_scale, letter_buf, LV_TXT_FLAG_NONE, 0,
-                          LV_LABEL_TEXT_SEL_OFF, LV_LABEL_TEXT_SEL_OFF, NULL);
+                          LV_LABEL_TEXT_SEL_OFF, LV_LABEL_TEXT_SEL_OFF, NULL, NULL);
 
         } else if(ext->cursor.type == LV_CURSOR_OUTLINE) {
             cur_style.body.opa = LV_OPA_TRANSP;
@@ -1494,7 +1492,7 @@ static void cursor_blink_anim(lv_obj_t * ta, lv_anim_value_t show)
             area_tmp.y1 += ext->label->coords.y1;
             area_tmp.x2 += ext->label->coords.x1;
             area_tmp.y2 += ext->label->coords.y1;
-            lv_inv_area(disp, &area_tmp);
+            lv_inv_area_by(disp, &area_tmp, ta);
         }
     }
 }
@@ -1697,7 +1695,7 @@ static void refr_cursor_area(lv_obj_t * ta)
     area_tmp.y1 += ext->label->coords.y1;
     area_tmp.x2 += ext->label->coords.x1;
     area_tmp.y2 += ext->label->coords.y1;
-    lv_inv_area(disp, &area_tmp);
+    lv_inv_area_by(disp, &area_tmp, ta);
 
     lv_area_copy(&ext->cursor.area, &cur_area);
 
@@ -1706,7 +1704,7 @@ static void refr_cursor_area(lv_obj_t * ta)
     area_tmp.y1 += ext->label->coords.y1;
     area_tmp.x2 += ext->label->coords.x1;
     area_tmp.y2 += ext->label->coords.y1;
-    lv_inv_area(disp, &area_tmp);
+    lv_inv_area_by(disp, &area_tmp, ta);
 }
 
 static void placeholder_update(lv_obj_t * ta)
@@ -28,6 +28,7 @@
 static bool lv_table_design(lv_obj_t * table, const lv_area_t * mask, lv_design_mode_t mode);
 static lv_res_t lv_table_signal(lv_obj_t * table, lv_signal_t sign, void * param);
 static lv_coord_t get_row_height(lv_obj_t * table, uint16_t row_id);
+static void refr_row_height(lv_obj_t * table, uint16_t row_start, uint16_t row_end);
 static void refr_size(lv_obj_t * table);
 
 /**********************
@@ -68,6 +69,7 @@ lv_obj_t * lv_table_create(lv_obj_t * par, const lv_obj_t * copy)
 
     /*Initialize the allocated 'ext' */
     ext->cell_data     = NULL;
+    ext->row_y         = NULL;
     ext->cell_style[0] = &lv_style_plain;
     ext->cell_style[1] = &lv_style_plain;
     ext->cell_style[2] = &lv_style_plain;
@@ -106,8 +108,10 @@ lv_obj_t * lv_table_create(lv_obj_t * par, const lv_obj_t * copy)
         ext->cell_style[1]        = copy_ext->cell_style[1];
         ext->cell_style[2]        = copy_ext->cell_style[2];
         ext->cell_style[3]        = copy_ext->cell_style[3];
-        ext->col_cnt              = copy_ext->col_cnt;
-        ext->row_cnt              = copy_ext->row_cnt;
+
+        /*Allocate the (empty) cells and rows too*/
+        lv_table_set_col_cnt(new_table, copy_ext->col_cnt);
+        lv_table_set_row_cnt(new_table, copy_ext->row_cnt);
 
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_table);
@@ -155,6 +159,7 @@ void lv_table_set_cell_value(lv_obj_t * table, uint16_t row, uint16_t col, const
     ext->cell_data[cell] = lv_mem_realloc(ext->cell_data[cell], strlen(txt) + 2); /*+1: trailing '\0; +1: format byte*/
     strcpy(ext->cell_data[cell] + 1, txt);                                        /*Leave the format byte*/
     ext->cell_data[cell][0] = format.format_byte;
+    refr_row_height(table, row, row + 1);
     refr_size(table);
 }
 
@@ -183,6 +188,22 @@ void lv_table_set_row_cnt(lv_obj_t * table, uint16_t row_cnt)
         ext->cell_data = NULL;
     }
 
+    /*Measure only the new rows*/
+    if(ext->row_cnt > 0) {
+        ext->row_y = lv_mem_realloc(ext->row_y, (ext->row_cnt + 1) * sizeof(ext->row_y[0]));
+        lv_mem_assert(ext->row_y);
+        if(old_row_cnt == 0) ext->row_y[0] = 0;
+
+        uint16_t row;
+        for(row = old_row_cnt; row < row_cnt; row++) {
+            ext->row_y[row + 1] = ext->row_y[old_row_cnt];
+        }
+        if(old_row_cnt < row_cnt) refr_row_height(table, old_row_cnt, row_cnt);
+    } else {
+        lv_mem_free(ext->row_y);
+        ext->row_y = NULL;
+    }
+
     refr_size(table);
 }
 
@@ -216,6 +237,7 @@ void lv_table_set_col_cnt(lv_obj_t * table, uint16_t col_cnt)
         lv_mem_free(ext->cell_data);
         ext->cell_data = NULL;
     }
+    refr_row_height(table, 0, ext->row_cnt);
     refr_size(table);
 }
 
@@ -234,6 +256,7 @@ void lv_table_set_col_width(lv_obj_t * table, uint16_t col_id, lv_coord_t w)
 
     lv_table_ext_t * ext = lv_obj_get_ext_attr(table);
     ext->col_w[col_id]   = w;
+    refr_row_height(table, 0, ext->row_cnt);
     refr_size(table);
 }
 
@@ -294,6 +317,8 @@ void lv_table_set_cell_type(lv_obj_t * table, uint16_t row, uint16_t col, uint8_
     format.format_byte      = ext->cell_data[cell][0];
     format.s.type           = type;
     ext->cell_data[cell][0] = format.format_byte;
+    refr_row_height(table, row, row + 1);
+    refr_size(table);
 }
 
 /**
@@ -322,6 +347,8 @@ void lv_table_set_cell_crop(lv_obj_t * table, uint16_t row, uint16_t col, bool c
     format.format_byte      = ext->cell_data[cell][0];
     format.s.crop           = crop;
     ext->cell_data[cell][0] = format.format_byte;
+    refr_row_height(table, row, row + 1);
+    refr_size(table);
 }
 
 /**
@@ -351,6 +378,7 @@ void lv_table_set_cell_merge_right(lv_obj_t * table, uint16_t row, uint16_t col,
     format.format_byte      = ext->cell_data[cell][0];
     format.s.right_merge    = en ? 1 : 0;
     ext->cell_data[cell][0] = format.format_byte;
+    refr_row_height(table, row, row + 1);
     refr_size(table);
 }
 
@@ -366,23 +394,26 @@ void lv_table_set_style(lv_obj_t * table, lv_table_style_t type, const lv_style_
 
     switch(type) {
         case LV_TABLE_STYLE_BG:
-            lv_obj_set_style(table, style);
-            refr_size(table);
+            lv_obj_set_style(table, style); /*The rows are measured again on the style change signal*/
             break;
         case LV_TABLE_STYLE_CELL1:
             ext->cell_style[0] = style;
+            refr_row_height(table, 0, ext->row_cnt);
             refr_size(table);
             break;
         case LV_TABLE_STYLE_CELL2:
             ext->cell_style[1] = style;
+            refr_row_height(table, 0, ext->row_cnt);
             refr_size(table);
             break;
         case LV_TABLE_STYLE_CELL3:
             ext->cell_style[2] = style;
+            refr_row_height(table, 0, ext->row_cnt);
             refr_size(table);
             break;
         case LV_TABLE_STYLE_CELL4:
             ext->cell_style[3] = style;
+            refr_row_height(table, 0, ext->row_cnt);
             refr_size(table);
             break;
     }
@@ -613,13 +644,34 @@ static bool lv_table_design(lv_obj_t * table, const lv_area_t * mask, lv_design_
 
         uint16_t col;
         uint16_t row;
-        uint16_t cell = 0;
+        uint32_t cell;
+
+        if(ext->row_y == NULL) return true;
+
+        /*The shadows of the cells can reach into the mask from the rows around it*/
+        lv_coord_t shadow = 0;
+        uint8_t style_i;
+        for(style_i = 0; style_i < LV_TABLE_CELL_STYLE_CNT; style_i++) {
+            shadow = LV_MATH_MAX(shadow, ext->cell_style[style_i]->body.shadow.width);
+        }
+
+        /*Find the first row reaching into the mask*/
+        int32_t y_ofs    = table->coords.y1 + bg_style->body.padding.top;
+        int32_t mask_y1  = mask->y1 - shadow - y_ofs;
+        int32_t mask_y2  = mask->y2 + shadow - y_ofs;
+        uint16_t row_min = 0;
+        uint16_t row_max = ext->row_cnt;
+        while(row_min < row_max) {
+            uint16_t row_mid = row_min + (row_max - row_min) / 2;
+            if(ext->row_y[row_mid + 1] < mask_y1) row_min = row_mid + 1;
+            else row_max = row_mid;
+        }
 
-        cell_area.y2 = table->coords.y1 + bg_style->body.padding.top;
-        for(row = 0; row < ext->row_cnt; row++) {
-            h_row = get_row_height(table, row);
+        cell = (uint32_t)row_min * ext->col_cnt;
+        for(row = row_min; row < ext->row_cnt && ext->row_y[row] <= mask_y2; row++) {
+            h_row = ext->row_y[row + 1] - ext->row_y[row];
 
-            cell_area.y1 = cell_area.y2;
+            cell_area.y1 = y_ofs + ext->row_y[row];
             cell_area.y2 = cell_area.y1 + h_row;
 
             cell_area.x2 = table->coords.x1 + bg_style->body.padding.left;
@@ -691,28 +743,36 @@ static bool lv_table_design(lv_obj_t * table, const lv_area_t * mask, lv_design_
                     label_mask_ok = lv_area_intersect(&label_mask, mask, &cell_area);
                     if(label_mask_ok) {
                         lv_draw_label(&txt_area, &label_mask, cell_style, opa_scale, ext->cell_data[cell] + 1,
-                                      txt_flags, NULL, -1, -1, NULL);
+                                      txt_flags, NULL, -1, -1, NULL, NULL);
                     }
-                    /*Draw lines after '\n's*/
+                    /*Draw lines after '\n's. The text before them is measured in a copy:
+                     *the other drawing threads read the cell's text meanwhile.*/
                     lv_point_t p1;
                     lv_point_t p2;
                     p1.x = cell_area.x1;
                     p2.x = cell_area.x2;
+                    lv_draw_scratch_mark_t mark;
+                    lv_draw_scratch_mark(&mark);
+                    char * txt_part = NULL;
                     uint16_t i;
                     for(i = 1; ext->cell_data[cell][i] != '\0'; i++) {
                         if(ext->cell_data[cell][i] == '\n') {
-                            ext->cell_data[cell][i] = '\0';
-                            lv_txt_get_size(&txt_size, ext->cell_data[cell] + 1, cell_style->text.font,
+                            if(txt_part == NULL) {
+                                txt_part = lv_draw_scratch_alloc(strlen(ext->cell_data[cell]));
+                                if(txt_part == NULL) break;
+                            }
+                            memcpy(txt_part, ext->cell_data[cell] + 1, i - 1);
+                            txt_part[i - 1] = '\0';
+                            lv_txt_get_size(&txt_size, txt_part, cell_style->text.font,
                                             cell_style->text.letter_space, cell_style->text.line_space,
                                             lv_area_get_width(&txt_area), txt_flags);
 
                             p1.y = txt_area.y1 + txt_size.y + cell_style->text.line_space / 2;
                             p2.y = txt_area.y1 + txt_size.y + cell_style->text.line_space / 2;
                             lv_draw_line(&p1, &p2, mask, cell_style, opa_scale);
-
-                            ext->cell_data[cell][i] = '\n';
                         }
                     }
+                    lv_draw_scratch_release(&mark);
                 }
 
                 cell += col_merge + 1;
@@ -745,13 +805,22 @@ static lv_res_t lv_table_signal(lv_obj_t * table, lv_signal_t sign, void * param
     if(sign == LV_SIGNAL_CLEANUP) {
         /*Free the cell texts*/
         lv_table_ext_t * ext = lv_obj_get_ext_attr(table);
-        uint16_t cell;
-        for(cell = 0; cell < ext->col_cnt * ext->row_cnt; cell++) {
+        uint32_t cell;
+        for(cell = 0; cell < (uint32_t)ext->col_cnt * ext->row_cnt; cell++) {
             if(ext->cell_data[cell]) {
                 lv_mem_free(ext->cell_data[cell]);
                 ext->cell_data[cell] = NULL;
             }
         }
+        lv_mem_free(ext->cell_data);
+        ext->cell_data = NULL;
+        lv_mem_free(ext->row_y);
+        ext->row_y = NULL;
+    } else if(sign == LV_SIGNAL_STYLE_CHG) {
+        /*The fonts and paddings might have changed*/
+        lv_table_ext_t * ext = lv_obj_get_ext_attr(table);
+        refr_row_height(table, 0, ext->row_cnt);
+        refr_size(table);
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
         uint8_t i;
@@ -775,9 +844,7 @@ static void refr_size(lv_obj_t * table)
     for(i = 0; i < ext->col_cnt; i++) {
         w += ext->col_w[i];
     }
-    for(i = 0; i < ext->row_cnt; i++) {
-        h += get_row_height(table, i);
-    }
+    if(ext->row_y) h = ext->row_y[ext->row_cnt];
 
     const lv_style_t * bg_style = lv_obj_get_style(table);
 
@@ -788,6 +855,34 @@ static void refr_size(lv_obj_t * table)
     lv_obj_invalidate(table);
 }
 
+/**
+ * Measure some rows again and move the rows below them if their height changed
+ * @param table pointer to a table object
+ * @param row_start the first row to measure
+ * @param row_end the row after the last one to measure
+ */
+static void refr_row_height(lv_obj_t * table, uint16_t row_start, uint16_t row_end)
+{
+    lv_table_ext_t * ext = lv_obj_get_ext_attr(table);
+    if(ext->row_y == NULL || row_start >= row_end) return;
+
+    int32_t y_end_old = ext->row_y[row_end];
+    int32_t y         = ext->row_y[row_start];
+    uint16_t row;
+    for(row = row_start; row < row_end; row++) {
+        y += get_row_height(table, row);
+        ext->row_y[row + 1] = y;
+    }
+
+    int32_t diff = y - y_end_old;
+    if(diff != 0) {
+        uint32_t i;
+        for(i = row_end + 1; i <= ext->row_cnt; i++) {
+            ext->row_y[i] += diff;
+        }
+    }
+}
+
 static lv_coord_t get_row_height(lv_obj_t * table, uint16_t row_id)
 {
     lv_table_ext_t * ext = lv_obj_get_ext_attr(table);
@@ -795,8 +890,8 @@ static lv_coord_t get_row_height(lv_obj_t * table, uint16_t row_id)
     lv_coord_t txt_w;
     const lv_style_t * cell_style;
 
-    uint16_t row_start = row_id * ext->col_cnt;
-    uint16_t cell;
+    uint32_t row_start = (uint32_t)row_id * ext->col_cnt;
+    uint32_t cell;
     uint16_t col;
     lv_coord_t h_max = lv_font_get_line_height(ext->cell_style[0]->text.font) + ext->cell_style[0]->body.padding.top +
                        ext->cell_style[0]->body.padding.bottom;
@@ -65,6 +65,7 @@ typedef struct
     uint16_t col_cnt;
     uint16_t row_cnt;
     char ** cell_data;
+    int32_t * row_y; /*Top of each row relative to the first, the height of all rows in the last element*/
     const lv_style_t * cell_style[LV_TABLE_CELL_STYLE_CNT];
     lv_coord_t col_w[LV_TABLE_COL_MAX];
 } lv_table_ext_t;
@@ -42,11 +42,23 @@ static void tabpage_pressing_handler(lv_obj_t * tabview, lv_obj_t * tabpage);
 static void tabpage_press_lost_handler(lv_obj_t * tabview, lv_obj_t * tabpage);
 static void tab_btnm_event_cb(lv_obj_t * tab_btnm, lv_event_t event);
 static void tabview_realign(lv_obj_t * tabview);
+#if LV_USE_SLIDE_SNAPSHOT
+static bool lv_tabview_design(lv_obj_t * tabview, const lv_area_t * mask, lv_design_mode_t mode);
+static void tabview_slide_end(lv_obj_t * tabview);
+#if LV_USE_ANIMATION
+static bool tabview_slide_start(lv_obj_t * tabview, lv_coord_t cont_x);
+static void tabview_slide_anim(void * tabview, lv_anim_value_t pos);
+static void tabview_slide_ready(lv_anim_t * a);
+#endif
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
 static lv_signal_cb_t ancestor_signal;
+#if LV_USE_SLIDE_SNAPSHOT
+static lv_design_cb_t ancestor_design;
+#endif
 static lv_signal_cb_t page_signal;
 static lv_signal_cb_t page_scrl_signal;
 static const char * tab_def[] = {""};
@@ -74,6 +86,9 @@ lv_obj_t * lv_tabview_create(lv_obj_t * par, const lv_obj_t * copy)
     lv_mem_assert(new_tabview);
     if(new_tabview == NULL) return NULL;
     if(ancestor_signal == NULL) ancestor_signal = lv_obj_get_signal_cb(new_tabview);
+#if LV_USE_SLIDE_SNAPSHOT
+    if(ancestor_design == NULL) ancestor_design = lv_obj_get_design_cb(new_tabview);
+#endif
 
     /*Allocate the tab type specific extended data*/
     lv_tabview_ext_t * ext = lv_obj_allocate_ext_attr(new_tabview, sizeof(lv_tabview_ext_t));
@@ -96,12 +111,20 @@ lv_obj_t * lv_tabview_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->anim_time = LV_TABVIEW_DEF_ANIM_TIME;
 #endif
     ext->btns_hide = 0;
+#if LV_USE_SLIDE_SNAPSHOT
+    ext->slide          = NULL;
+    ext->slide_snapshot = 0;
+#endif
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_tabview, lv_tabview_signal);
+#if LV_USE_SLIDE_SNAPSHOT
+    lv_obj_set_design_cb(new_tabview, lv_tabview_design);
+#endif
 
     /*Init the new tab tab*/
     if(copy == NULL) {
+        lv_obj_set_cord_signal(new_tabview, LV_OBJ_CORD_SIGNAL_SIZE);
         ext->tab_name_ptr = lv_mem_alloc(sizeof(char *));
         lv_mem_assert(ext->tab_name_ptr);
         if(ext->tab_name_ptr == NULL) return NULL;
@@ -159,6 +182,9 @@ lv_obj_t * lv_tabview_create(lv_obj_t * par, const lv_obj_t * copy)
 #if LV_USE_ANIMATION
         ext->anim_time = copy_ext->anim_time;
 #endif
+#if LV_USE_SLIDE_SNAPSHOT
+        ext->slide_snapshot = copy_ext->slide_snapshot;
+#endif
 
         ext->tab_name_ptr = lv_mem_alloc(sizeof(char *));
         lv_mem_assert(ext->tab_name_ptr);
@@ -333,6 +359,11 @@ void lv_tabview_set_tab_act(lv_obj_t * tabview, uint16_t id, lv_anim_enable_t an
 #endif
     lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
 
+#if LV_USE_SLIDE_SNAPSHOT
+    /*The content is shown again where the slide left it*/
+    tabview_slide_end(tabview);
+#endif
+
     const lv_style_t * style = lv_obj_get_style(ext->content);
 
     if(id >= ext->tab_cnt) id = ext->tab_cnt - 1;
@@ -341,6 +372,12 @@ void lv_tabview_set_tab_act(lv_obj_t * tabview, uint16_t id, lv_anim_enable_t an
 
     ext->tab_cur = id;
 
+#if LV_USE_OBJ_LAZY
+    /*Create the lazy children of the tab before it slides in*/
+    lv_obj_t * tab = lv_tabview_get_tab(tabview, id);
+    if(tab != NULL) lv_obj_lazy_build(tab);
+#endif
+
     lv_coord_t cont_x;
 
     switch(ext->btns_pos) {
@@ -363,7 +400,11 @@ void lv_tabview_set_tab_act(lv_obj_t * tabview, uint16_t id, lv_anim_enable_t an
         lv_obj_set_x(ext->content, cont_x);
     }
 #if LV_USE_ANIMATION
-    else {
+    else
+#if LV_USE_SLIDE_SNAPSHOT
+        if(tabview_slide_start(tabview, cont_x) == false)
+#endif
+    {
         lv_anim_t a;
         a.var            = ext->content;
         a.start          = lv_obj_get_x(ext->content);
@@ -472,6 +513,21 @@ void lv_tabview_set_anim_time(lv_obj_t * tabview, uint16_t anim_time)
 #endif
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Slide between the tabs as bitmaps: the old and the new tab are drawn once when a tab is loaded
+ * with animation and the frames only copy them. For complex, opaque tabs (or tabs on a background of one color).
+ * Tabs a few tabs away slide in as if they were the next one.
+ * @param tabview pointer to Tab view object
+ * @param en true: slide as bitmaps; false: move the tabs as usual
+ */
+void lv_tabview_set_slide_snapshot(lv_obj_t * tabview, bool en)
+{
+    lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+    ext->slide_snapshot    = en == false ? 0 : 1;
+}
+#endif
+
 /**
  * Set the style of a tab view
  * @param tabview pointer to a tan view object
@@ -611,6 +667,19 @@ uint16_t lv_tabview_get_anim_time(const lv_obj_t * tabview)
 #endif
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Get whether the tab view slides between the tabs as bitmaps
+ * @param tabview pointer to Tab view object
+ * @return true: slides as bitmaps
+ */
+bool lv_tabview_get_slide_snapshot(const lv_obj_t * tabview)
+{
+    lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+    return ext->slide_snapshot ? true : false;
+}
+#endif
+
 /**
  * Get a style of a tab view
  * @param tabview pointer to a ab view object
@@ -661,6 +730,31 @@ bool lv_tabview_get_btns_hidden(const lv_obj_t * tabview)
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Handle the drawing related tasks of the tab views
+ * @param tabview pointer to an object
+ * @param mask the object will be drawn only in this area
+ * @param mode LV_DESIGN_COVER_CHK: only check if the object fully covers the 'mask_p' area
+ *                                  (return 'true' if yes)
+ *             LV_DESIGN_DRAW: draw the object (always return 'true')
+ *             LV_DESIGN_DRAW_POST: drawing after every children are drawn
+ * @param return true/false, depends on 'mode'
+ */
+static bool lv_tabview_design(lv_obj_t * tabview, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    bool res = ancestor_design(tabview, mask, mode);
+
+    /*The hidden content is drawn from the bitmaps of the slide*/
+    if(mode == LV_DESIGN_DRAW_MAIN) {
+        lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+        lv_slide_draw(ext->slide, mask);
+    }
+
+    return res;
+}
+#endif
+
 /**
  * Signal function of the Tab view
  * @param tabview pointer to a Tab view object
@@ -678,6 +772,11 @@ static lv_res_t lv_tabview_signal(lv_obj_t * tabview, lv_signal_t sign, void * p
 
     lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
     if(sign == LV_SIGNAL_CLEANUP) {
+#if LV_USE_SLIDE_SNAPSHOT
+        /*The content is deleted already*/
+        if(ext->slide) lv_mem_free(ext->slide);
+        ext->slide = NULL;
+#endif
         uint8_t i;
         for(i = 0; ext->tab_name_ptr[i][0] != '\0'; i++) lv_mem_free(ext->tab_name_ptr[i]);
 
@@ -688,6 +787,9 @@ static lv_res_t lv_tabview_signal(lv_obj_t * tabview, lv_signal_t sign, void * p
     } else if(sign == LV_SIGNAL_CORD_CHG) {
         if(ext->content != NULL && (lv_obj_get_width(tabview) != lv_area_get_width(param) ||
                                     lv_obj_get_height(tabview) != lv_area_get_height(param))) {
+#if LV_USE_SLIDE_SNAPSHOT
+            tabview_slide_end(tabview);
+#endif
             tabview_realign(tabview);
         }
     } else if(sign == LV_SIGNAL_RELEASED) {
@@ -1115,4 +1217,81 @@ static void tabview_realign(lv_obj_t * tabview)
 
     lv_tabview_set_tab_act(tabview, ext->tab_cur, LV_ANIM_OFF);
 }
+
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Stop the slide between the tabs (if any) and show the content
+ * @param tabview pointer to a Tab view object
+ */
+static void tabview_slide_end(lv_obj_t * tabview)
+{
+    lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+    if(ext->slide == NULL) return;
+
+#if LV_USE_ANIMATION
+    lv_anim_del(tabview, tabview_slide_anim);
+#endif
+    lv_slide_del(ext->slide);
+    ext->slide = NULL;
+}
+
+#if LV_USE_ANIMATION
+/**
+ * Move the content to a new tab as bitmaps if enabled
+ * @param tabview pointer to a Tab view object
+ * @param cont_x the new x coordinate of the content
+ * @return true: the slide is started; false: animate the content as usual
+ */
+static bool tabview_slide_start(lv_obj_t * tabview, lv_coord_t cont_x)
+{
+    lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+    if(ext->slide_snapshot == 0) return false;
+
+    lv_coord_t x_act = lv_obj_get_x(ext->content);
+    if(x_act == cont_x) return false;
+
+    lv_slide_t * slide = lv_slide_create(ext->content, true);
+    if(slide == NULL) return false;
+
+    /*The content might be moving to an other tab: it's moved from here*/
+    lv_anim_del(ext->content, (lv_anim_exec_xcb_t)lv_obj_set_x);
+    lv_obj_set_x(ext->content, cont_x);
+    if(lv_slide_start(slide, cont_x - x_act, 0) == false) {
+        lv_slide_del(slide);
+        lv_obj_set_x(ext->content, x_act);
+        return false;
+    }
+    ext->slide = slide;
+
+    lv_anim_t a;
+    a.var            = tabview;
+    a.start          = 0;
+    a.end            = LV_SLIDE_POS_END;
+    a.exec_cb        = tabview_slide_anim;
+    a.path_cb        = lv_anim_path_linear;
+    a.ready_cb       = tabview_slide_ready;
+    a.act_time       = 0;
+    a.time           = ext->anim_time;
+    a.playback       = 0;
+    a.playback_pause = 0;
+    a.repeat         = 0;
+    a.repeat_pause   = 0;
+    lv_anim_create(&a);
+
+    return true;
+}
+
+static void tabview_slide_anim(void * tabview, lv_anim_value_t pos)
+{
+    lv_tabview_ext_t * ext = lv_obj_get_ext_attr(tabview);
+    if(ext->slide) lv_slide_set_pos(ext->slide, pos);
+}
+
+static void tabview_slide_ready(lv_anim_t * a)
+{
+    tabview_slide_end(a->var);
+}
+#endif
+#endif
+
 #endif
@@ -33,6 +33,7 @@ extern "C" {
 #include "../lv_core/lv_obj.h"
 #include "../lv_objx/lv_win.h"
 #include "../lv_objx/lv_page.h"
+#include "../lv_core/lv_slide.h"
 
 /*********************
  *      DEFINES
@@ -60,6 +61,10 @@ typedef struct
     uint16_t tab_cnt;
 #if LV_USE_ANIMATION
     uint16_t anim_time;
+#endif
+#if LV_USE_SLIDE_SNAPSHOT
+    lv_slide_t * slide; /*The tabs sliding as bitmaps, NULL if none*/
+    uint8_t slide_snapshot : 1; /*1: slide between the tabs as bitmaps*/
 #endif
     uint8_t slide_enable : 1; /*1: enable horizontal sliding by touch pad*/
     uint8_t draging : 1;
@@ -136,6 +141,17 @@ void lv_tabview_set_sliding(lv_obj_t * tabview, bool en);
  */
 void lv_tabview_set_anim_time(lv_obj_t * tabview, uint16_t anim_time);
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Slide between the tabs as bitmaps: the old and the new tab are drawn once when a tab is loaded
+ * with animation and the frames only copy them. For complex, opaque tabs (or tabs on a background of one color).
+ * Tabs a few tabs away slide in as if they were the next one.
+ * @param tabview pointer to Tab view object
+ * @param en true: slide as bitmaps; false: move the tabs as usual
+ */
+void lv_tabview_set_slide_snapshot(lv_obj_t * tabview, bool en);
+#endif
+
 /**
  * Set the style of a tab view
  * @param tabview pointer to a tan view object
@@ -197,6 +213,15 @@ bool lv_tabview_get_sliding(const lv_obj_t * tabview);
  */
 uint16_t lv_tabview_get_anim_time(const lv_obj_t * tabview);
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Get whether the tab view slides between the tabs as bitmaps
+ * @param tabview pointer to Tab view object
+ * @return true: slides as bitmaps
+ */
+bool lv_tabview_get_slide_snapshot(const lv_obj_t * tabview);
+#endif
+
 /**
  * Get a style of a tab view
  * @param tabview pointer to a ab view object
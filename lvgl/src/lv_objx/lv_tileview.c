@@ -37,6 +37,15 @@ static lv_res_t lv_tileview_scrl_signal(lv_obj_t * scrl, lv_signal_t sign, void
 static void tileview_scrl_event_cb(lv_obj_t * scrl, lv_event_t event);
 static void drag_end_handler(lv_obj_t * tileview);
 static bool set_valid_drag_dirs(lv_obj_t * tileview);
+#if LV_USE_SLIDE_SNAPSHOT
+static bool lv_tileview_design(lv_obj_t * tileview, const lv_area_t * mask, lv_design_mode_t mode);
+static void tileview_slide_end(lv_obj_t * tileview);
+#if LV_USE_ANIMATION
+static bool tileview_slide_start(lv_obj_t * tileview, lv_coord_t x_coord, lv_coord_t y_coord);
+static void tileview_slide_anim(void * tileview, lv_anim_value_t pos);
+static void tileview_slide_ready(lv_anim_t * a);
+#endif
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -84,10 +93,17 @@ lv_obj_t * lv_tileview_create(lv_obj_t * par, const lv_obj_t * copy)
     ext->act_id.y      = 0;
     ext->valid_pos     = NULL;
     ext->valid_pos_cnt = 0;
+#if LV_USE_SLIDE_SNAPSHOT
+    ext->slide          = NULL;
+    ext->slide_snapshot = 0;
+#endif
 
     /*The signal and design functions are not copied so set them here*/
     lv_obj_set_signal_cb(new_tileview, lv_tileview_signal);
     lv_obj_set_signal_cb(lv_page_get_scrl(new_tileview), lv_tileview_scrl_signal);
+#if LV_USE_SLIDE_SNAPSHOT
+    lv_obj_set_design_cb(new_tileview, lv_tileview_design);
+#endif
 
     /*Init the new tileview*/
     if(copy == NULL) {
@@ -121,6 +137,9 @@ lv_obj_t * lv_tileview_create(lv_obj_t * par, const lv_obj_t * copy)
 #if LV_USE_ANIMATION
         ext->anim_time = copy_ext->anim_time;
 #endif
+#if LV_USE_SLIDE_SNAPSHOT
+        ext->slide_snapshot = copy_ext->slide_snapshot;
+#endif
 
         /*Refresh the style with new signal function*/
         lv_obj_refresh_style(new_tileview);
@@ -210,6 +229,11 @@ void lv_tileview_set_tile_act(lv_obj_t * tileview, lv_coord_t x, lv_coord_t y, l
 
     if(valid == false) return; /*Don't load not valid tiles*/
 
+#if LV_USE_SLIDE_SNAPSHOT
+    /*The tiles are shown again where the slide left them*/
+    tileview_slide_end(tileview);
+#endif
+
     ext->act_id.x = x;
     ext->act_id.y = y;
 
@@ -218,32 +242,37 @@ void lv_tileview_set_tile_act(lv_obj_t * tileview, lv_coord_t x, lv_coord_t y, l
     lv_obj_t * scrl    = lv_page_get_scrl(tileview);
     if(anim) {
 #if LV_USE_ANIMATION
-        lv_coord_t x_act = lv_obj_get_x(scrl);
-        lv_coord_t y_act = lv_obj_get_y(scrl);
-
-        lv_anim_t a;
-        a.var            = scrl;
-        a.exec_cb        = (lv_anim_exec_xcb_t)lv_obj_set_x;
-        a.path_cb        = lv_anim_path_linear;
-        a.ready_cb       = NULL;
-        a.act_time       = 0;
-        a.time           = ext->anim_time;
-        a.playback       = 0;
-        a.playback_pause = 0;
-        a.repeat         = 0;
-        a.repeat_pause   = 0;
-
-        if(x_coord != x_act) {
-            a.start = x_act;
-            a.end   = x_coord;
-            lv_anim_create(&a);
-        }
+#if LV_USE_SLIDE_SNAPSHOT
+        if(tileview_slide_start(tileview, x_coord, y_coord) == false)
+#endif
+        {
+            lv_coord_t x_act = lv_obj_get_x(scrl);
+            lv_coord_t y_act = lv_obj_get_y(scrl);
+
+            lv_anim_t a;
+            a.var            = scrl;
+            a.exec_cb        = (lv_anim_exec_xcb_t)lv_obj_set_x;
+            a.path_cb        = lv_anim_path_linear;
+            a.ready_cb       = NULL;
+            a.act_time       = 0;
+            a.time           = ext->anim_time;
+            a.playback       = 0;
+            a.playback_pause = 0;
+            a.repeat         = 0;
+            a.repeat_pause   = 0;
+
+            if(x_coord != x_act) {
+                a.start = x_act;
+                a.end   = x_coord;
+                lv_anim_create(&a);
+            }
 
-        if(y_coord != y_act) {
-            a.start   = y_act;
-            a.end     = y_coord;
-            a.exec_cb = (lv_anim_exec_xcb_t)lv_obj_set_y;
-            lv_anim_create(&a);
+            if(y_coord != y_act) {
+                a.start   = y_act;
+                a.end     = y_coord;
+                a.exec_cb = (lv_anim_exec_xcb_t)lv_obj_set_y;
+                lv_anim_create(&a);
+            }
         }
 #endif
     } else {
@@ -255,6 +284,21 @@ void lv_tileview_set_tile_act(lv_obj_t * tileview, lv_coord_t x, lv_coord_t y, l
     if(res != LV_RES_OK) return; /*Prevent the tile loading*/
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Slide between the tiles as bitmaps: the old and the new tile are drawn once when a tile is loaded
+ * with animation and the frames only copy them. For complex, opaque tiles (or tiles on a background of one color).
+ * Tiles a few tiles away slide in as if they were the next one.
+ * @param tileview pointer to a Tileview object
+ * @param en true: slide as bitmaps; false: move the tiles as usual
+ */
+void lv_tileview_set_slide_snapshot(lv_obj_t * tileview, bool en)
+{
+    lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+    ext->slide_snapshot     = en == false ? 0 : 1;
+}
+#endif
+
 /**
  * Set a style of a tileview.
  * @param tileview pointer to tileview object
@@ -277,6 +321,19 @@ void lv_tileview_set_style(lv_obj_t * tileview, lv_tileview_style_t type, const
  * New object specific "get" functions come here
  */
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Get whether the tileview slides between the tiles as bitmaps
+ * @param tileview pointer to a Tileview object
+ * @return true: slides as bitmaps
+ */
+bool lv_tileview_get_slide_snapshot(const lv_obj_t * tileview)
+{
+    lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+    return ext->slide_snapshot ? true : false;
+}
+#endif
+
 /**
  * Get style of a tileview.
  * @param tileview pointer to tileview object
@@ -306,6 +363,31 @@ const lv_style_t * lv_tileview_get_style(const lv_obj_t * tileview, lv_tileview_
  *   STATIC FUNCTIONS
  **********************/
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Handle the drawing related tasks of the tileviews
+ * @param tileview pointer to an object
+ * @param mask the object will be drawn only in this area
+ * @param mode LV_DESIGN_COVER_CHK: only check if the object fully covers the 'mask_p' area
+ *                                  (return 'true' if yes)
+ *             LV_DESIGN_DRAW: draw the object (always return 'true')
+ *             LV_DESIGN_DRAW_POST: drawing after every children are drawn
+ * @param return true/false, depends on 'mode'
+ */
+static bool lv_tileview_design(lv_obj_t * tileview, const lv_area_t * mask, lv_design_mode_t mode)
+{
+    bool res = ancestor_design(tileview, mask, mode);
+
+    /*The hidden scrollable is drawn from the bitmaps of the slide*/
+    if(mode == LV_DESIGN_DRAW_MAIN) {
+        lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+        lv_slide_draw(ext->slide, mask);
+    }
+
+    return res;
+}
+#endif
+
 /**
  * Signal function of the tileview
  * @param tileview pointer to a tileview object
@@ -322,7 +404,12 @@ static lv_res_t lv_tileview_signal(lv_obj_t * tileview, lv_signal_t sign, void *
     if(res != LV_RES_OK) return res;
 
     if(sign == LV_SIGNAL_CLEANUP) {
-        /*Nothing to cleanup. (No dynamically allocated memory in 'ext')*/
+#if LV_USE_SLIDE_SNAPSHOT
+        /*The scrollable is deleted already*/
+        lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+        if(ext->slide) lv_mem_free(ext->slide);
+        ext->slide = NULL;
+#endif
     } else if(sign == LV_SIGNAL_GET_TYPE) {
         lv_obj_type_t * buf = param;
         uint8_t i;
@@ -562,4 +649,90 @@ static bool set_valid_drag_dirs(lv_obj_t * tileview)
     return true;
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Stop the slide between the tiles (if any) and show the scrollable
+ * @param tileview pointer to a tileview object
+ */
+static void tileview_slide_end(lv_obj_t * tileview)
+{
+    lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+    if(ext->slide == NULL) return;
+
+#if LV_USE_ANIMATION
+    lv_anim_del(tileview, tileview_slide_anim);
+#endif
+    lv_slide_del(ext->slide);
+    ext->slide = NULL;
+}
+
+#if LV_USE_ANIMATION
+/**
+ * Move the scrollable to a new tile as bitmaps if enabled
+ * @param tileview pointer to a tileview object
+ * @param x_coord the new x coordinate of the scrollable
+ * @param y_coord the new y coordinate of the scrollable
+ * @return true: the slide is started; false: animate the scrollable as usual
+ */
+static bool tileview_slide_start(lv_obj_t * tileview, lv_coord_t x_coord, lv_coord_t y_coord)
+{
+    lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+    if(ext->slide_snapshot == 0) return false;
+
+    lv_obj_t * scrl  = lv_page_get_scrl(tileview);
+    lv_coord_t x_act = lv_obj_get_x(scrl);
+    lv_coord_t y_act = lv_obj_get_y(scrl);
+    if(x_act != x_coord && y_act != y_coord) return false;
+    if(x_act == x_coord && y_act == y_coord) return false;
+
+    /*The scrollbars and the border are drawn over the scrollable: its pixels can be moved only without them*/
+    const lv_style_t * style = lv_tileview_get_style(tileview, LV_TILEVIEW_STYLE_MAIN);
+    bool blit = style->body.border.width == 0 || style->body.border.part == LV_BORDER_NONE;
+    if(lv_page_get_sb_mode(tileview) != LV_SB_MODE_OFF) blit = false;
+
+    lv_slide_t * slide = lv_slide_create(scrl, blit);
+    if(slide == NULL) return false;
+
+    /*The scrollable might be moving to an other tile: it's moved from here*/
+    lv_anim_del(scrl, (lv_anim_exec_xcb_t)lv_obj_set_x);
+    lv_anim_del(scrl, (lv_anim_exec_xcb_t)lv_obj_set_y);
+    lv_obj_set_pos(scrl, x_coord, y_coord);
+    if(lv_slide_start(slide, lv_obj_get_x(scrl) - x_act, lv_obj_get_y(scrl) - y_act) == false) {
+        lv_slide_del(slide);
+        lv_obj_set_pos(scrl, x_act, y_act);
+        return false;
+    }
+    ext->slide = slide;
+
+    lv_anim_t a;
+    a.var            = tileview;
+    a.start          = 0;
+    a.end            = LV_SLIDE_POS_END;
+    a.exec_cb        = tileview_slide_anim;
+    a.path_cb        = lv_anim_path_linear;
+    a.ready_cb       = tileview_slide_ready;
+    a.act_time       = 0;
+    a.time           = ext->anim_time;
+    a.playback       = 0;
+    a.playback_pause = 0;
+    a.repeat         = 0;
+    a.repeat_pause   = 0;
+    lv_anim_create(&a);
+
+    return true;
+}
+
+static void tileview_slide_anim(void * tileview, lv_anim_value_t pos)
+{
+    lv_tileview_ext_t * ext = lv_obj_get_ext_attr(tileview);
+    if(ext->slide) lv_slide_set_pos(ext->slide, pos);
+}
+
+static void tileview_slide_ready(lv_anim_t * a)
+{
+    tileview_slide_end(a->var);
+}
+#endif
+#endif
+
 #endif
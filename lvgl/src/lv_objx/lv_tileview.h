@@ -22,6 +22,7 @@ extern "C" {
 #if LV_USE_TILEVIEW != 0
 
 #include "../lv_objx/lv_page.h"
+#include "../lv_core/lv_slide.h"
 
 /*********************
  *      DEFINES
@@ -42,6 +43,10 @@ typedef struct
     uint16_t anim_time;
 #endif
     lv_point_t act_id;
+#if LV_USE_SLIDE_SNAPSHOT
+    lv_slide_t * slide; /*The tiles sliding as bitmaps, NULL if none*/
+    uint8_t slide_snapshot : 1; /*1: slide between the tiles as bitmaps*/
+#endif
     uint8_t drag_top_en : 1;
     uint8_t drag_bottom_en : 1;
     uint8_t drag_left_en : 1;
@@ -121,6 +126,17 @@ static inline void lv_tileview_set_anim_time(lv_obj_t * tileview, uint16_t anim_
     lv_page_set_anim_time(tileview, anim_time);
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Slide between the tiles as bitmaps: the old and the new tile are drawn once when a tile is loaded
+ * with animation and the frames only copy them. For complex, opaque tiles (or tiles on a background of one color).
+ * Tiles a few tiles away slide in as if they were the next one.
+ * @param tileview pointer to a Tileview object
+ * @param en true: slide as bitmaps; false: move the tiles as usual
+ */
+void lv_tileview_set_slide_snapshot(lv_obj_t * tileview, bool en);
+#endif
+
 /**
  * Set a style of a tileview.
  * @param tileview pointer to tileview object
@@ -153,6 +169,15 @@ static inline uint16_t lv_tileview_get_anim_time(lv_obj_t * tileview)
     return lv_page_get_anim_time(tileview);
 }
 
+#if LV_USE_SLIDE_SNAPSHOT
+/**
+ * Get whether the tileview slides between the tiles as bitmaps
+ * @param tileview pointer to a Tileview object
+ * @return true: slides as bitmaps
+ */
+bool lv_tileview_get_slide_snapshot(const lv_obj_t * tileview);
+#endif
+
 /**
  * Get style of a tileview.
  * @param tileview pointer to tileview object
@@ -110,6 +110,7 @@ lv_obj_t * lv_win_create(lv_obj_t * par, const lv_obj_t * copy)
         }
 
         lv_obj_set_signal_cb(new_win, lv_win_signal);
+        lv_obj_set_cord_signal(new_win, LV_OBJ_CORD_SIGNAL_SIZE);
     }
     /*Copy an existing object*/
     else {
@@ -8,6 +8,7 @@
  *********************/
 #include "lv_theme.h"
 #include "../lv_core/lv_obj.h"
+#include <string.h>
 
 /*********************
  *      DEFINES
@@ -20,6 +21,10 @@
 /**********************
  *  STATIC PROTOTYPES
  **********************/
+#if LV_THEME_LIVE_UPDATE
+static void refresh_changed(lv_obj_t * obj);
+static bool has_part_styles(lv_obj_t * obj);
+#endif
 
 /**********************
  *  STATIC VARIABLES
@@ -38,6 +43,15 @@ static lv_theme_t * current_theme;
 static lv_style_t th_styles[LV_THEME_STYLE_COUNT];
 static bool inited = false;
 static lv_theme_t current_theme;
+
+/* The styles changed by the last `lv_theme_set_current` in a size, font, padding etc. (see `lv_style_diff`)*/
+static bool th_layout[LV_THEME_STYLE_COUNT];
+
+/* Types drawn only with their main style (their parts are objects with own styles).
+ * The other types have part styles (e.g. the knob of a slider), they are refreshed on any layout change. */
+static const char * const main_style_types[] = {"lv_obj", "lv_cont", "lv_label", "lv_btn", "lv_imgbtn", "lv_img",
+                                                 "lv_led", "lv_line", "lv_lmeter", "lv_gauge", "lv_arc",
+                                                 "lv_preload", "lv_cb"};
 #endif
 
 /**********************
@@ -55,6 +69,9 @@ static lv_theme_t current_theme;
  */
 void lv_theme_set_current(lv_theme_t * th)
 {
+    /*Restyling every object moves and resizes a lot of them. Invalidate and lay out only once.*/
+    lv_obj_batch_begin();
+
 #if LV_THEME_LIVE_UPDATE == 0
     current_theme = th;
 
@@ -80,12 +97,25 @@ void lv_theme_set_current(lv_theme_t * th)
         inited = true;
     }
 
-    /*Copy the styles pointed by the new theme to the `th_styles` style array*/
+    /*Copy only the changed styles pointed by the new theme to the `th_styles` style array*/
     uint16_t i;
+    bool changed = false;
+    bool layout  = false;
     lv_style_t ** th_style = (lv_style_t **)&th->style;
     for(i = 0; i < style_num; i++) {
-        uintptr_t s = (uintptr_t)th_style[i];
-        if(s) memcpy(&th_styles[i], (void *)s, sizeof(lv_style_t));
+        const lv_style_t * s = th_style[i];
+        th_layout[i]         = false;
+        if(s == NULL) continue;
+
+        lv_style_diff_t diff = lv_style_diff(&th_styles[i], s);
+        if(diff == LV_STYLE_DIFF_NONE) continue;
+
+        lv_style_copy(&th_styles[i], s);
+        changed = true;
+        if(diff == LV_STYLE_DIFF_LAYOUT) {
+            th_layout[i] = true;
+            layout       = true;
+        }
     }
 
 #if LV_USE_GROUP
@@ -93,14 +123,24 @@ void lv_theme_set_current(lv_theme_t * th)
     memcpy(&current_theme.group, &th->group, sizeof(th->group));
 #endif
 
-    /*Let the object know their style might change*/
-    lv_obj_report_style_mod(NULL);
+    /*Only the objects whose sizes might change are refreshed and laid out, the rest is only redrawn*/
+    lv_disp_t * d;
+    for(d = lv_disp_get_next(NULL); d != NULL && changed; d = lv_disp_get_next(d)) {
+        lv_obj_t * scr;
+        LV_LL_READ(d->scr_ll, scr)
+        {
+            if(layout) refresh_changed(scr);
+            lv_obj_invalidate(scr);
+        }
+    }
 
 #endif
 
 #if LV_USE_GROUP
     lv_group_report_style_mod(NULL);
 #endif
+
+    lv_obj_batch_commit();
 }
 
 /**
@@ -122,3 +162,42 @@ lv_theme_t * lv_theme_get_current(void)
 /**********************
  *   STATIC FUNCTIONS
  **********************/
+
+#if LV_THEME_LIVE_UPDATE
+/**
+ * Refresh an object and its children if their style (or an inherited one) changed in a size, font, padding etc.
+ * @param obj pointer to an object
+ */
+static void refresh_changed(lv_obj_t * obj)
+{
+    const lv_style_t * style = lv_obj_get_style(obj);
+    bool refresh             = has_part_styles(obj);
+    if(style >= th_styles && style < &th_styles[LV_THEME_STYLE_COUNT] && th_layout[style - th_styles]) refresh = true;
+    if(refresh) lv_obj_refresh_style(obj);
+
+    lv_obj_t * child;
+    LV_LL_READ(obj->child_ll, child)
+    {
+        refresh_changed(child);
+    }
+}
+
+/**
+ * Tell whether an object might be drawn with styles of the theme besides its main style
+ * @param obj pointer to an object
+ * @return true: it's not one of `main_style_types`
+ */
+static bool has_part_styles(lv_obj_t * obj)
+{
+    lv_obj_type_t type;
+    lv_obj_get_type(obj, &type);
+    if(type.type[0] == NULL) return true;
+
+    uint8_t i;
+    for(i = 0; i < sizeof(main_style_types) / sizeof(main_style_types[0]); i++) {
+        if(strcmp(type.type[0], main_style_types[i]) == 0) return false;
+    }
+
+    return true;
+}
+#endif
@@ -8,16 +8,44 @@
  *      INCLUDES
  *********************/
 #define _DEFAULT_SOURCE /* needed for usleep() */
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #define SDL_MAIN_HANDLED        /*To fix SDL's "undefined reference to WinMain" issue*/
 #include <SDL2/SDL.h>
 #include "lvgl/lvgl.h"
 #include "lv_drivers/display/monitor.h"
+#include "lv_drivers/display/soft_gpu.h"
+#include "lv_drivers/display/netdisp.h"
+#include "lv_drivers/display/shmdisp.h"
+#include "lv_drivers/fs/posix_fs.h"
 #include "lv_drivers/indev/mouse.h"
 #include "lv_drivers/indev/mousewheel.h"
 #include "lv_drivers/indev/keyboard.h"
 #include "interface.h"
+#include "binproj.h"
+#include "autosave.h"
+#include "gencode.h"
+#include "footprint.h"
+#include "imgasset.h"
+#include "headless.h"
+#include "profiler.h"
+#include "bench.h"
+#include "inputrec.h"
+#include "imgcmp.h"
+#include "frametime.h"
+#include "advisor.h"
+#include "drawcost.h"
+#include "assetstore.h"
+#include "ttfont.h"
+#include "stress.h"
+#include "memprof.h"
+#include "preview.h"
+#include "snapguide.h"
+#include "projdiff.h"
+#include "hotreload.h"
+#include "bake.h"
 
 /*********************
  *      DEFINES
@@ -30,20 +58,54 @@
 # endif
 #endif
 
+/*The partial display buffers are this part of the screen*/
+#define DISP_BUF_PART_DIV   10
+
+/*Refresh the screen this many times to measure the frame time of a display buffer*/
+#define DISP_BUF_REPORT_FRAMES  20
+
+/*Read period of the pressed input devices [ms]. The released ones use `LV_INDEV_DEF_READ_PERIOD`*/
+#define INDEV_READ_PERIOD_PRESSED   10
+
 /**********************
  *      TYPEDEFS
  **********************/
+typedef enum {
+    DISP_BUF_FULL,          /*One buffer with the size of the screen*/
+    DISP_BUF_PART,          /*One buffer with 1/DISP_BUF_PART_DIV of the screen*/
+    DISP_BUF_PART_DOUBLE,   /*Two buffers with 1/DISP_BUF_PART_DIV of the screen*/
+    _DISP_BUF_NUM
+} disp_buf_mode_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void hal_init(void);
-static int tick_thread(void * data);
+static void hal_init(disp_buf_mode_t buf_mode);
+static uint32_t disp_buf_set(disp_buf_mode_t mode);
+static void disp_buf_report(disp_buf_mode_t mode);
+static bool indev_sleep(void);
+static void indev_period_adapt(void);
+static void indev_wake(void);
+static bool input_wait(uint32_t timeout);
+static void async_wake(void);
+#ifdef SDL_APPLE
+static void sdl_event_handle(SDL_Event * event);
+#endif
 static void memory_monitor(lv_task_t * param);
+static void fonts_accel_init(void);
+#if USE_SOFT_GPU
+static void gpu_report(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+#endif
+#if USE_NETDISP
+static void stream_report(lv_task_t * task);
+#endif
 
 /**********************
  *  STATIC VARIABLES
  **********************/
+static const char * disp_buf_names[_DISP_BUF_NUM] = {"full", "part", "double"};
+static lv_disp_buf_t disp_buf1;
+static lv_color_t * disp_buf_mem[2];
 
 /**********************
  *      MACROS
@@ -55,39 +117,500 @@ static void memory_monitor(lv_task_t * param);
 
 int main(int argc, char ** argv)
 {
-    (void) argc;    /*Unused*/
-    (void) argv;    /*Unused*/
+    profiler_startup_begin();
+
+    /*Convert between the XML and the binary project format without starting the GUI*/
+    if(argc == 4 && !strcmp(argv[1], "--xml2bin")) {
+        return binproj_from_xml(argv[2], argv[3]) ? 0 : 1;
+    }
+    if(argc == 4 && !strcmp(argv[1], "--bin2xml")) {
+        return binproj_to_xml(argv[2], argv[3]) ? 0 : 1;
+    }
+    /*Rebuild a project from the autosave journal*/
+    if(argc == 4 && !strcmp(argv[1], "--recover")) {
+        return autosave_recover(argv[2], argv[3]) ? 0 : 1;
+    }
+    /*Compare or merge project files as `diff` and a git merge driver: 0 same (merged), 1 changes (conflicts), 2 error*/
+    if(argc == 4 && !strcmp(argv[1], "--diff")) {
+        int32_t res = projdiff_files(argv[2], argv[3]);
+        return res < 0 ? 2 : res > 0;
+    }
+    if(argc == 6 && !strcmp(argv[1], "--merge")) {
+        int32_t res = projdiff_merge(argv[2], argv[3], argv[4], argv[5]);
+        return res < 0 ? 2 : res > 0;
+    }
+
+    /*`--generate <project.xml>` generates the code of the project without LittlevGL and a window and exits,
+     *`-o <dir>` writes the generated files into `dir` (default: the working directory).
+     *Select the display buffer with `--disp-buf full|part|double`.
+     *`--disp-buf-report` measures all of them at startup.
+     *`--poll` calls the task handler in every 5 ms instead of waiting for the next task or input.
+     *`--codegen table|calls` selects table driven or straight-line generated code,
+     *`--codegen-split` writes every screen into an own file.
+     *`--codegen-blob` exports every screen as a binary blob too, for `runtime/lv_gui_blob.c` on the target,
+     *`--codegen-expand` writes the repeated subtrees of the straight-line code out instead of calling a template builder,
+     *`--codegen-py` writes the project as a MicroPython module too, `lv_gui.py`,
+     *`--codegen-lazy` creates the children of the hidden widgets only when the target shows them first,
+     *`--codegen-lazy-release` deletes them again when they are hidden while the target's `lv_mem` is low,
+     *`--codegen-theme <name>` styles the generated widgets with this theme (e.g. `material`): its used styles are
+     *    written as const data and set by the code, so the target doesn't initialize a theme,
+     *`--codegen-theme-hue <deg>` initializes it with this hue (default 0),
+     *`--codegen-theme-runtime` keeps the theme in the generated `lv_gui_conf.h` for the target to initialize instead,
+     *`--codegen-heap <bytes>` simulates the generated code in a target `lv_mem` of this size (default 32768),
+     *`--codegen-bake <id,id,...>` draws these subtrees of the open screen into const images in the target's colours,
+     *    the generated code shows one image for each instead of creating their widgets,
+     *`--img <name> <file> <cf>` adds an image to the project (e.g. `--img logo logo.pam indexed_4bit`),
+     *`--img-target 16|16swap|...` selects the colour format the images are converted to,
+     *`--font-subset` writes the used fonts with only the glyphs of the project's texts,
+     *`--font-chars <text>` keeps these letters in the subsets too (e.g. of texts set at run time),
+     *`--font-compress` compresses the glyph bitmaps of the subsets (needs `LV_USE_FONT_COMPRESSED` on the target),
+     *`--render <dir>` writes the screens of the project into `dir` without opening a window and exits,
+     *`--render-fmt png|raw` selects their file format,
+     *`--render-depth 16,8,1` writes the PNGs in the colours of these target depths too,
+     *`--render-golden <dir>` compares the rendered screens with the PNGs of `dir` from memory and writes only the diff images,
+     *`--compare <golden dir> <dir>` compares the PNGs of two directories without a window, prints the differing regions and exits,
+     *`--compare-tol <n>` allows `n` difference in every colour channel (default 0), also for `--render-golden`,
+     *`--compare-diff <dir>` writes the diff images of the differing PNGs into `dir`,
+     *`--compare-threads <n>` compares on `n` threads (default one per CPU), `--compare-out <file>` writes the results as JSON too,
+     *`--preview 320x240,800x480@16` shows the open screen on these target resolutions (and colour depths) while it's edited,
+     *    `@1p` and `@2` draw into 1 and 2 bit packed buffers like the driver of a monochrome panel,
+     *`--zoom 1280x720` shows the open screen on this target resolution (`@<depth>` like above) in an own window,
+     *    the GPU zooms (mouse wheel), pans (drag) and filters ('F') it without redrawing ('0': fit, '1': 1:1),
+     *`--preview-budget <percent>` sets how much of the time a preview may spend with drawing (a slower one is refreshed less often),
+     *`--budget-ram <bytes>` warns in the status bar when a screen needs more `lv_mem` on the target,
+     *`--budget-flash <bytes>` warns when the images and the fonts need more flash,
+     *`--snap-grid <px>` snaps the dragged widgets to a grid where no edge of an other widget is near,
+     *`--snap-dist <px>` sets how near an edge snaps (0: only the grid),
+     *`--watch` patches the changes other programs make to lgd.xml into the open project while the designer runs,
+     *`--asset-store <dir>` keeps the converted images and font subsets in `dir` (default: $LV_GUI_ASSET_STORE or
+     *    ~/.cache/lv_gui_designer/assets), every project on the machine reuses them,
+     *`--ttf <file>` loads a TrueType or OpenType font, the Setting's font size applies it at any size to the selected
+     *    widgets (the first file, or the one of their font). The generated code gets a subset of it,
+     *`--bench` draws a fixed set of scenes without a window, prints the frame times and the speed of the SIMD pixel
+     *    kernels against the plain C loops and exits,
+     *`--bench-frames <n>` measures `n` frames of every scene, `--bench-out <file>` writes the times as JSON too,
+     *`--bench-model <file>` fits the costs of the drawing operations on this machine to the scenes and writes them,
+     *`--frametime <model>` prints the frame times of the screens predicted with a model of `--bench-model` and exits,
+     *`--frametime-top <n>` lists the `n` costliest widgets of every screen,
+     *`--advise <model>` finds the slow design patterns of the open screen while it's edited, estimates their cost
+     *    with a model of `--bench-model` and shows them in the Layer View,
+     *`--draw-cost` measures the drawing of every widget and shows it in the Layer View, which can sort by it,
+     *`--stress <dir>` builds large projects in `dir` without a window, measures the designer's operations on them and exits,
+     *`--stress-sizes 1000,10000` sets the widgets of the projects, `--stress-out <file>` writes the results as JSON too,
+     *`--record <file>` records the input of the session into `file`,
+     *`--replay <file>` replays a recorded session without a window with a virtual tick, prints the frame times and exits,
+     *`--replay-out <file>` writes the time of every replayed frame as JSON too,
+     *`--prof` shows the FPS, the CPU usage and the draw time on the screen,
+     *`--prof-out <file>` writes the measured frames into `file` on exit,
+     *`--prof-fmt json|trace` selects its format (`trace` is for chrome://tracing),
+     *`--prof-startup` prints the time of the startup phases until the first frame,
+     *`--mem-prof` shows the `lv_mem` usage by subsystem and prints the allocations still alive at exit by call site,
+     *`--debug-areas` tints every flushed area with a new color, `--debug-fade <ms>` fades the tints out,
+     *`--debug-overdraw` colors the pixels by how many times they are drawn (blue 2x, green 3x, pink 4x, red more),
+     *`--gpu` draws the fills and the blends with the display driver's GPU callbacks (`soft_gpu`),
+     *`--gpu-report` prints the pixels drawn by them in every frame,
+     *`--stream <port>` streams the redrawn areas to a receiver connecting to this TCP port and takes its pointer input,
+     *`--stream-report` prints the bytes per frame and the latency of the stream every second,
+     *`--shm <name>` publishes the frames in the POSIX shared memory segment `name` with the areas changed in each,
+     *    other processes (e.g. recorders, test harnesses) read them in place and wait on a futex for the next one*/
+    disp_buf_mode_t buf_mode = DISP_BUF_FULL;
+    bool buf_report = false;
+    bool poll = false;
+    bool img_changed = false;
+    const char * generate_path = NULL;
+    const char * generate_dir = NULL;
+    const char * render_dir = NULL;
+    headless_fmt_t render_fmt = HEADLESS_PNG;
+    uint8_t render_depths[HEADLESS_DEPTH_MAX];
+    uint8_t render_depth_cnt = 0;
+    const char * render_golden = NULL;
+    const char * compare_golden = NULL;
+    const char * compare_dir = NULL;
+    const char * compare_diff = NULL;
+    const char * compare_out = NULL;
+    uint8_t compare_tol = 0;
+    uint32_t compare_threads = 0;
+    preview_target_t preview_targets[PREVIEW_MAX];
+    uint8_t preview_cnt = 0;
+    uint8_t preview_budget = PREVIEW_BUDGET_DEF;
+    preview_target_t zoom_target;
+    bool zoom = false;
+    bool bench = false;
+    uint32_t bench_frames = BENCH_FRAMES_DEF;
+    const char * bench_out = NULL;
+    const char * bench_model = NULL;
+    const char * frametime_model = NULL;
+    uint32_t frametime_top = FRAMETIME_TOP_DEF;
+    const char * advise_model = NULL;
+    bool draw_cost = false;
+    const char * ttf_paths[TTFONT_FACE_MAX];
+    uint32_t ttf_cnt = 0;
+    const char * stress_dir = NULL;
+    uint32_t stress_sizes[STRESS_SIZE_MAX] = {1000, 10000, 50000};
+    uint32_t stress_size_cnt = 3;
+    const char * stress_out = NULL;
+    const char * record_path = NULL;
+    const char * replay_path = NULL;
+    const char * replay_out = NULL;
+    bool watch = false;
+    bool prof_overlay = false;
+    bool prof_startup = false;
+    bool mem_prof = false;
+    const char * prof_out = NULL;
+    profiler_fmt_t prof_fmt = PROFILER_JSON;
+    monitor_debug_t debug_mode = MONITOR_DEBUG_OFF;
+    uint32_t debug_fade = 0;
+    bool gpu = false;
+    bool gpu_report_en = false;
+    uint16_t stream_port = 0;
+    bool stream_report_en = false;
+    const char * shm_name = NULL;
+    uint32_t budget_ram = 0;
+    uint32_t budget_flash = 0;
+    imgasset_list_load(IMGASSET_LIST_FILE);
+    int i;
+    for(i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--disp-buf-report")) {
+            buf_report = true;
+        } else if(!strcmp(argv[i], "--poll")) {
+            poll = true;
+        } else if(!strcmp(argv[i], "--generate") && i + 1 < argc) {
+            generate_path = argv[++i];
+        } else if(!strcmp(argv[i], "-o") && i + 1 < argc) {
+            generate_dir = argv[++i];
+        } else if(!strcmp(argv[i], "--codegen-split")) {
+            gencode_set_split(true);
+        } else if(!strcmp(argv[i], "--codegen-blob")) {
+            gencode_set_blob(true);
+        } else if(!strcmp(argv[i], "--codegen-expand")) {
+            gencode_set_templates(false);
+        } else if(!strcmp(argv[i], "--codegen-py")) {
+            gencode_set_python(true);
+        } else if(!strcmp(argv[i], "--codegen-lazy")) {
+            gencode_set_lazy(true);
+        } else if(!strcmp(argv[i], "--codegen-lazy-release")) {
+            gencode_set_lazy(true);
+            gencode_set_lazy_release(true);
+        } else if(!strcmp(argv[i], "--font-subset")) {
+            gencode_set_font_subset(true);
+        } else if(!strcmp(argv[i], "--font-chars") && i + 1 < argc) {
+            gencode_set_font_chars(argv[++i]);
+        } else if(!strcmp(argv[i], "--font-compress")) {
+            gencode_set_font_compress(true);
+        } else if(!strcmp(argv[i], "--codegen-theme") && i + 1 < argc) {
+            if(!gencode_set_theme(argv[++i])) {
+                fprintf(stderr, "Unknown theme \"%s\" (templ, default, alien, night, mono, material, zen or nemo)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--codegen-theme-hue") && i + 1 < argc) {
+            gencode_set_theme_hue(strtoul(argv[++i], NULL, 10));
+        } else if(!strcmp(argv[i], "--codegen-theme-runtime")) {
+            gencode_set_theme_flat(false);
+        } else if(!strcmp(argv[i], "--codegen-heap") && i + 1 < argc) {
+            gencode_set_heap_size(strtoul(argv[++i], NULL, 10));
+        } else if(!strcmp(argv[i], "--codegen-bake") && i + 1 < argc) {
+            bake_set(argv[++i]);
+        } else if(!strcmp(argv[i], "--codegen") && i + 1 < argc) {
+            i++;
+            if(!strcmp(argv[i], "table")) gencode_set_mode(GENCODE_TABLE);
+            else if(!strcmp(argv[i], "calls")) gencode_set_mode(GENCODE_CALLS);
+            else {
+                fprintf(stderr, "Unknown code generation \"%s\" (table or calls)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--img") && i + 3 < argc) {
+            if(!imgasset_add(argv[i + 1], argv[i + 2], imgasset_cf_from_name(argv[i + 3]))) {
+                fprintf(stderr, "Can't add the image \"%s\" (a C identifier, a file and a colour format)\n", argv[i + 1]);
+                return 1;
+            }
+            i += 3;
+            img_changed = true;
+        } else if(!strcmp(argv[i], "--img-target") && i + 1 < argc) {
+            i++;
+            char * end;
+            long depth = strtol(argv[i], &end, 10);
+            if(!imgasset_set_target(depth, !strcmp(end, "swap")) || (*end != '\0' && strcmp(end, "swap"))) {
+                fprintf(stderr, "Unknown image target \"%s\" (1, 8, 16, 16swap or 32)\n", argv[i]);
+                return 1;
+            }
+            img_changed = true;
+        } else if(!strcmp(argv[i], "--render") && i + 1 < argc) {
+            render_dir = argv[++i];
+        } else if(!strcmp(argv[i], "--render-fmt") && i + 1 < argc) {
+            i++;
+            render_fmt = headless_fmt_from_name(argv[i]);
+            if(render_fmt == _HEADLESS_FMT_NUM) {
+                fprintf(stderr, "Unknown render format \"%s\" (png or raw)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--render-golden") && i + 1 < argc) {
+            render_golden = argv[++i];
+        } else if(!strcmp(argv[i], "--compare") && i + 2 < argc) {
+            compare_golden = argv[++i];
+            compare_dir = argv[++i];
+        } else if(!strcmp(argv[i], "--compare-tol") && i + 1 < argc) {
+            unsigned long tol = strtoul(argv[++i], NULL, 10);
+            compare_tol = tol > 255 ? 255 : tol;
+        } else if(!strcmp(argv[i], "--compare-diff") && i + 1 < argc) {
+            compare_diff = argv[++i];
+        } else if(!strcmp(argv[i], "--compare-threads") && i + 1 < argc) {
+            compare_threads = strtoul(argv[++i], NULL, 10);
+        } else if(!strcmp(argv[i], "--compare-out") && i + 1 < argc) {
+            compare_out = argv[++i];
+        } else if(!strcmp(argv[i], "--render-depth") && i + 1 < argc) {
+            i++;
+            render_depth_cnt = headless_depths_parse(argv[i], render_depths);
+            if(render_depth_cnt == 0) {
+                fprintf(stderr, "Invalid render depths \"%s\" (e.g. 16,8,1)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--preview") && i + 1 < argc) {
+            i++;
+            preview_cnt = preview_targets_parse(argv[i], preview_targets);
+            if(preview_cnt == 0) {
+                fprintf(stderr, "Invalid previews \"%s\" (e.g. 320x240,800x480@16, at most %d)\n", argv[i], PREVIEW_MAX);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--zoom") && i + 1 < argc) {
+            i++;
+            preview_target_t targets[PREVIEW_MAX];
+            if(preview_targets_parse(argv[i], targets) != 1) {
+                fprintf(stderr, "Invalid zoomed preview \"%s\" (e.g. 1280x720 or 320x240@16)\n", argv[i]);
+                return 1;
+            }
+            zoom_target = targets[0];
+            zoom_target.zoom = true;
+            zoom = true;
+        } else if(!strcmp(argv[i], "--preview-budget") && i + 1 < argc) {
+            unsigned long budget = strtoul(argv[++i], NULL, 10);
+            preview_budget = budget > 100 ? 100 : budget;
+        } else if(!strcmp(argv[i], "--budget-ram") && i + 1 < argc) {
+            budget_ram = strtoul(argv[++i], NULL, 10);
+            footprint_set_budget(budget_ram, budget_flash);
+        } else if(!strcmp(argv[i], "--budget-flash") && i + 1 < argc) {
+            budget_flash = strtoul(argv[++i], NULL, 10);
+            footprint_set_budget(budget_ram, budget_flash);
+        } else if(!strcmp(argv[i], "--snap-grid") && i + 1 < argc) {
+            snapguide_set_grid(strtol(argv[++i], NULL, 10));
+        } else if(!strcmp(argv[i], "--snap-dist") && i + 1 < argc) {
+            snapguide_set_dist(strtol(argv[++i], NULL, 10));
+        } else if(!strcmp(argv[i], "--ttf") && i + 1 < argc) {
+            if(ttf_cnt < TTFONT_FACE_MAX) ttf_paths[ttf_cnt++] = argv[i + 1];
+            i++;
+        } else if(!strcmp(argv[i], "--asset-store") && i + 1 < argc) {
+            assetstore_set_dir(argv[++i]);
+        } else if(!strcmp(argv[i], "--watch")) {
+            watch = true;
+        } else if(!strcmp(argv[i], "--bench")) {
+            bench = true;
+        } else if(!strcmp(argv[i], "--bench-frames") && i + 1 < argc) {
+            bench_frames = strtoul(argv[++i], NULL, 10);
+        } else if(!strcmp(argv[i], "--bench-out") && i + 1 < argc) {
+            bench_out = argv[++i];
+        } else if(!strcmp(argv[i], "--bench-model") && i + 1 < argc) {
+            bench_model = argv[++i];
+        } else if(!strcmp(argv[i], "--frametime") && i + 1 < argc) {
+            frametime_model = argv[++i];
+        } else if(!strcmp(argv[i], "--advise") && i + 1 < argc) {
+            advise_model = argv[++i];
+        } else if(!strcmp(argv[i], "--draw-cost")) {
+            draw_cost = true;
+        } else if(!strcmp(argv[i], "--frametime-top") && i + 1 < argc) {
+            frametime_top = strtoul(argv[++i], NULL, 10);
+        } else if(!strcmp(argv[i], "--record") && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if(!strcmp(argv[i], "--replay") && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if(!strcmp(argv[i], "--replay-out") && i + 1 < argc) {
+            replay_out = argv[++i];
+        } else if(!strcmp(argv[i], "--stress") && i + 1 < argc) {
+            stress_dir = argv[++i];
+        } else if(!strcmp(argv[i], "--stress-sizes") && i + 1 < argc) {
+            i++;
+            stress_size_cnt = stress_sizes_parse(argv[i], stress_sizes);
+            if(stress_size_cnt == 0) {
+                fprintf(stderr, "Invalid project sizes \"%s\" (e.g. 1000,10000)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--stress-out") && i + 1 < argc) {
+            stress_out = argv[++i];
+        } else if(!strcmp(argv[i], "--prof")) {
+            prof_overlay = true;
+        } else if(!strcmp(argv[i], "--prof-startup")) {
+            prof_startup = true;
+        } else if(!strcmp(argv[i], "--mem-prof")) {
+            mem_prof = true;
+        } else if(!strcmp(argv[i], "--prof-out") && i + 1 < argc) {
+            prof_out = argv[++i];
+        } else if(!strcmp(argv[i], "--prof-fmt") && i + 1 < argc) {
+            i++;
+            prof_fmt = profiler_fmt_from_name(argv[i]);
+            if(prof_fmt == _PROFILER_FMT_NUM) {
+                fprintf(stderr, "Unknown profile format \"%s\" (json or trace)\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--debug-areas")) {
+            debug_mode = MONITOR_DEBUG_AREAS;
+        } else if(!strcmp(argv[i], "--debug-overdraw")) {
+            debug_mode = MONITOR_DEBUG_OVERDRAW;
+        } else if(!strcmp(argv[i], "--debug-fade") && i + 1 < argc) {
+            debug_fade = strtoul(argv[++i], NULL, 10);
+        } else if(!strcmp(argv[i], "--gpu")) {
+            gpu = true;
+        } else if(!strcmp(argv[i], "--gpu-report")) {
+            gpu_report_en = true;
+        } else if(!strcmp(argv[i], "--stream") && i + 1 < argc) {
+            stream_port = strtoul(argv[++i], NULL, 10);
+        } else if(!strcmp(argv[i], "--stream-report")) {
+            stream_report_en = true;
+        } else if(!strcmp(argv[i], "--shm") && i + 1 < argc) {
+            shm_name = argv[++i];
+        } else if(!strcmp(argv[i], "--disp-buf") && i + 1 < argc) {
+            i++;
+            for(buf_mode = 0; buf_mode < _DISP_BUF_NUM; buf_mode++) {
+                if(!strcmp(argv[i], disp_buf_names[buf_mode])) break;
+            }
+            if(buf_mode == _DISP_BUF_NUM) {
+                fprintf(stderr, "Unknown display buffer \"%s\" (full, part or double)\n", argv[i]);
+                return 1;
+            }
+        }
+    }
+
+    if(img_changed && !imgasset_list_save(IMGASSET_LIST_FILE)) {
+        fprintf(stderr, "Can't save %s\n", IMGASSET_LIST_FILE);
+    }
+
+    /*The generator works on the parsed project, it needs neither LittlevGL nor the HAL*/
+    if(generate_path != NULL) {
+        if(!gencode_set_out_dir(generate_dir)) {
+            fprintf(stderr, "The output directory \"%s\" is too long\n", generate_dir);
+            return 1;
+        }
+        return code_generation_file(generate_path) ? 0 : 1;
+    }
+
+    profiler_startup_mark("arguments");
 
     /*Initialize LittlevGL*/
     lv_init();
+    profiler_startup_mark("lv_init");
+
+#if USE_POSIX_FS
+    /*The files of the disk as "P:/...", the `.bin` images are drawn from their mappings*/
+    posix_fs_init();
+#endif
+
+    /*Look up the glyphs of the built-in fonts from tables instead of searching them*/
+    fonts_accel_init();
+    profiler_startup_mark("fs, fonts");
+
+    /*Render into memory without the SDL window and the designer's GUI*/
+    if(render_dir != NULL) {
+        return headless_render(render_dir, render_fmt, render_depths, render_depth_cnt, render_golden, compare_tol) ? 0 : 1;
+    }
+    if(compare_golden != NULL) {
+        return imgcmp_dirs(compare_golden, compare_dir, compare_tol, compare_diff, compare_threads, compare_out) ? 0 : 1;
+    }
+    if(bench) {
+        return bench_run(bench_frames, bench_out, bench_model) ? 0 : 1;
+    }
+    if(frametime_model != NULL) {
+        return frametime_run(frametime_model, frametime_top) ? 0 : 1;
+    }
+    if(stress_dir != NULL) {
+        return stress_run(stress_dir, stress_sizes, stress_size_cnt, stress_out) ? 0 : 1;
+    }
+    if(replay_path != NULL) {
+        return inputrec_replay(replay_path, replay_out) ? 0 : 1;
+    }
 
     /*Initialize the HAL (display, input devices, tick) for LittlevGL*/
-    hal_init();
+    hal_init(buf_mode);
 
     lv_gui_designer();
+    if(zoom && preview_cnt < PREVIEW_MAX) preview_targets[preview_cnt++] = zoom_target;
+    if(preview_cnt > 0) preview_create(preview_targets, preview_cnt, preview_budget);
+    if(watch) hotreload_start();
+    if(advise_model != NULL) advisor_init(advise_model);
+    if(draw_cost) drawcost_init();
+    for(i = 0; i < (int)ttf_cnt; i++) {
+        if(ttfont_add_face(ttf_paths[i]) < 0) fprintf(stderr, "Can't load the font %s\n", ttf_paths[i]);
+    }
+
+    if(buf_report) disp_buf_report(buf_mode);
+
+    if(prof_overlay) profiler_overlay_create();
+    if(mem_prof) {
+        memprof_overlay_create();
+        memprof_report_at_exit();
+    }
+    if(debug_mode != MONITOR_DEBUG_OFF) monitor_set_debug(debug_mode, debug_fade);
+    if(prof_out != NULL) profiler_export_at_exit(prof_out, prof_fmt);
+#if USE_SOFT_GPU
+    if(gpu) soft_gpu_init(&lv_disp_get_default()->driver);
+    if(gpu_report_en) lv_disp_get_default()->driver.monitor_cb = gpu_report;
+#else
+    if(gpu || gpu_report_en) fprintf(stderr, "The GPU callbacks are disabled (USE_SOFT_GPU in lv_drv_conf.h)\n");
+#endif
+#if USE_NETDISP
+    /*After the `monitor_cb` of `--gpu-report`: the stream wraps it*/
+    if(stream_port != 0 && netdisp_init(&lv_disp_get_default()->driver, stream_port)) {
+        lv_indev_drv_t stream_indev_drv;
+        lv_indev_drv_init(&stream_indev_drv);
+        stream_indev_drv.type = LV_INDEV_TYPE_POINTER;
+        stream_indev_drv.read_cb = netdisp_input_read;
+        lv_indev_drv_register(&stream_indev_drv);
+        if(stream_report_en) lv_task_create(stream_report, 1000, LV_TASK_PRIO_LOW, NULL);
+        printf("Streaming on TCP port %u\n", stream_port);
+    }
+#else
+    if(stream_port != 0) fprintf(stderr, "The stream is disabled (USE_NETDISP in lv_drv_conf.h)\n");
+#endif
+#if USE_SHMDISP
+    /*Wraps the `flush_cb` and the `monitor_cb` like the stream*/
+    if(shm_name != NULL && shmdisp_init(&lv_disp_get_default()->driver, shm_name)) {
+        printf("Publishing the frames in the shared memory %s\n", shm_name);
+    }
+#else
+    if(shm_name != NULL) fprintf(stderr, "The shared memory display is disabled (USE_SHMDISP in lv_drv_conf.h)\n");
+#endif
+
+    /*After every input device is registered*/
+    if(record_path != NULL && !inputrec_record_start(record_path)) return 1;
+
+    /*Draw the first frame now to time it. The second one is the same without touching the memory the first time.*/
+    if(prof_startup) {
+        lv_task_handler();
+        profiler_startup_mark("tasks");
+        lv_refr_now(NULL);
+        profiler_startup_mark("first frame");
+        lv_obj_invalidate(lv_scr_act());
+        lv_refr_now(NULL);
+        profiler_startup_mark("second frame");
+        profiler_startup_report();
+    }
 
 
     while(1) {
         /* Periodically call the lv_task handler.
          * It could be done in a timer interrupt or an OS task too.*/
-        lv_task_handler();
-        usleep(5 * 1000);
+        uint32_t time_till_next = lv_task_handler();
+        indev_period_adapt();
+
+        if(poll) {
+            usleep(5 * 1000);
+        } else {
+            /*Sleep until the next task is due or an input event arrives*/
+            if(indev_sleep()) time_till_next = lv_task_get_time_till_next();
+            if(time_till_next != 0 && input_wait(time_till_next)) indev_wake();
+        }
 
 #ifdef SDL_APPLE
         SDL_Event event;
 
         while(SDL_PollEvent(&event)) {
-#if USE_MOUSE != 0
-            mouse_handler(&event);
-#endif
-
-#if USE_KEYBOARD
-            keyboard_handler(&event);
-#endif
-
-#if USE_MOUSEWHEEL != 0
-            mousewheel_handler(&event);
-#endif
+            sdl_event_handle(&event);
         }
 #endif
     }
@@ -99,25 +622,72 @@ int main(int argc, char ** argv)
  *   STATIC FUNCTIONS
  **********************/
 
+/**
+ * Build the glyph and kerning lookup tables of the built-in fonts once, before anything is drawn
+ */
+static void fonts_accel_init(void)
+{
+#if LV_FONT_FMT_TXT_ACCEL
+    lv_font_t * fonts[] = {
+#if LV_FONT_ROBOTO_12
+        &lv_font_roboto_12,
+#endif
+#if LV_FONT_ROBOTO_16
+        &lv_font_roboto_16,
+#endif
+#if LV_FONT_ROBOTO_22
+        &lv_font_roboto_22,
+#endif
+#if LV_FONT_ROBOTO_28
+        &lv_font_roboto_28,
+#endif
+#if LV_FONT_UNSCII_8
+        &lv_font_unscii_8,
+#endif
+        NULL
+    };
+
+    uint32_t i;
+    for(i = 0; fonts[i]; i++) {
+        if(lv_font_fmt_txt_accel_build(fonts[i]) != LV_RES_OK) {
+            fprintf(stderr, "Not enough memory for the font lookup tables\n");
+        }
+    }
+#endif
+}
+
 /**
  * Initialize the Hardware Abstraction Layer (HAL) for the Littlev graphics library
+ * @param buf_mode the kind of display buffer to use
  */
-static void hal_init(void)
+static void hal_init(disp_buf_mode_t buf_mode)
 {
     /* Use the 'monitor' driver which creates window on PC's monitor to simulate a display*/
     monitor_init();
+    profiler_startup_mark("monitor");
 
     /*Create a display buffer*/
-    static lv_disp_buf_t disp_buf1;
-    static lv_color_t buf1_1[3840*2160];
-    lv_disp_buf_init(&disp_buf1, buf1_1, NULL, 3840*2160);
+    uint32_t buf_size = disp_buf_set(buf_mode);
+    if(buf_size == 0) {
+        fprintf(stderr, "Couldn't allocate the display buffer\n");
+        exit(1);
+    }
+    printf("display buffer: %s, %u kB\n", disp_buf_names[buf_mode], buf_size / 1024);
+    profiler_startup_mark("display buffer");
 
     /*Create a display*/
     lv_disp_drv_t disp_drv;
     lv_disp_drv_init(&disp_drv);            /*Basic initialization*/
     disp_drv.buffer = &disp_buf1;
     disp_drv.flush_cb = monitor_flush;    /*Used when `LV_VDB_SIZE != 0` in lv_conf.h (buffered drawing)*/
-    lv_disp_drv_register(&disp_drv);
+#if LV_USE_HW_CURSOR
+    disp_drv.cursor_set_cb = monitor_cursor_set;    /*A cursor image (see below) becomes the cursor of the window*/
+#endif
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+
+    /*Refresh and step the animations at the screen's rate instead of `LV_DISP_DEF_REFR_PERIOD`.
+     *While nothing changes the refresh task is paused, so it doesn't wake up the main loop.*/
+    lv_disp_set_refr_period(disp, monitor_get_refr_period());
 
     /* Add the mouse as input device
      * Use the 'mouse' driver which reads the PC's mouse*/
@@ -134,33 +704,183 @@ static void hal_init(void)
     // lv_img_set_src(cursor_obj, &mouse_cursor_icon);             /*Set the image source*/
     // lv_indev_set_cursor(mouse_indev, cursor_obj);               /*Connect the image  object to the driver*/
 
-    /* Tick init.
-     * You have to call 'lv_tick_inc()' in periodically to inform LittelvGL about how much time were elapsed
-     * Create an SDL thread to do this*/
-    SDL_CreateThread(tick_thread, "tick", NULL);
+    /*Stop waiting for input when other threads post updates with `lv_async_post`*/
+    lv_async_set_wake_cb(async_wake);
+
+    /* The tick comes from `SDL_GetTicks()` through `inputrec_tick()` (`LV_TICK_CUSTOM` in lv_conf.h)
+     * so no thread is needed to call `lv_tick_inc()`*/
 
     /* Optional:
      * Create a memory monitor task which prints the memory usage in periodically.*/
     lv_task_create(memory_monitor, 3000, LV_TASK_PRIO_MID, NULL);
+    profiler_startup_mark("drivers");
 }
 
 /**
- * A task to measure the elapsed time for LittlevGL
- * @param data unused
- * @return never return
+ * (Re)allocate the display buffer(s) according to the resolution of the monitor.
+ * Don't call it during refreshing.
+ * @param mode the kind of display buffer
+ * @return size of the display buffer(s) in bytes or 0 if they couldn't be allocated
  */
-static int tick_thread(void * data)
+static uint32_t disp_buf_set(disp_buf_mode_t mode)
 {
-    (void)data;
+    uint32_t px_cnt = (uint32_t)MONITOR_HOR_RES * MONITOR_VER_RES;
+    if(mode != DISP_BUF_FULL) px_cnt /= DISP_BUF_PART_DIV;
 
-    while(1) {
-        SDL_Delay(5);   /*Sleep for 5 millisecond*/
-        lv_tick_inc(5); /*Tell LittelvGL that 5 milliseconds were elapsed*/
+    free(disp_buf_mem[0]);
+    free(disp_buf_mem[1]);
+    disp_buf_mem[0] = malloc(px_cnt * sizeof(lv_color_t));
+    disp_buf_mem[1] = mode == DISP_BUF_PART_DOUBLE ? malloc(px_cnt * sizeof(lv_color_t)) : NULL;
+
+    if(disp_buf_mem[0] == NULL || (mode == DISP_BUF_PART_DOUBLE && disp_buf_mem[1] == NULL)) return 0;
+
+    lv_disp_buf_init(&disp_buf1, disp_buf_mem[0], disp_buf_mem[1], px_cnt);
+
+    return px_cnt * sizeof(lv_color_t) * (mode == DISP_BUF_PART_DOUBLE ? 2 : 1);
+}
+
+/**
+ * Print the memory need and the frame time of every kind of display buffer
+ * by redrawing the current screen with them, then go back to `mode`.
+ * @param mode the kind of display buffer to use after the report
+ */
+static void disp_buf_report(disp_buf_mode_t mode)
+{
+    disp_buf_mode_t m;
+    for(m = 0; m < _DISP_BUF_NUM; m++) {
+        uint32_t buf_size = disp_buf_set(m);
+        if(buf_size == 0) {
+            printf("display buffer %-6s: couldn't be allocated\n", disp_buf_names[m]);
+            continue;
+        }
+
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        uint32_t f;
+        for(f = 0; f < DISP_BUF_REPORT_FRAMES; f++) {
+            lv_obj_invalidate(lv_scr_act());
+            lv_refr_now(NULL);
+        }
+        uint64_t t_elaps = SDL_GetPerformanceCounter() - t_start;
+
+        double frame_ms = (double)t_elaps * 1000 / SDL_GetPerformanceFrequency() / DISP_BUF_REPORT_FRAMES;
+        printf("display buffer %-6s: %6u kB, %7.2f ms/frame\n", disp_buf_names[m], buf_size / 1024, frame_ms);
     }
 
-    return 0;
+    if(disp_buf_set(mode) == 0) {
+        fprintf(stderr, "Couldn't allocate the display buffer\n");
+        exit(1);
+    }
+    lv_obj_invalidate(lv_scr_act());
+}
+
+/**
+ * Pause the read task of the released input devices. They are woken up by `indev_wake` on input.
+ * The pressed and dragged (or thrown) ones are still read periodically.
+ * @return true: at least one read task was paused
+ */
+static bool indev_sleep(void)
+{
+    bool paused = false;
+    lv_indev_t * indev = lv_indev_get_next(NULL);
+    while(indev) {
+        if(indev->driver.read_task->paused == 0 && indev->proc.state == LV_INDEV_STATE_REL &&
+           lv_indev_is_dragging(indev) == false) {
+            lv_task_pause(indev->driver.read_task);
+            paused = true;
+        }
+        indev = lv_indev_get_next(indev);
+    }
+
+    return paused;
+}
+
+/**
+ * Read the pressed input devices more often to follow them closely, e.g. when drawing.
+ * The released ones are read rarely (or paused by `indev_sleep`).
+ */
+static void indev_period_adapt(void)
+{
+    lv_indev_t * indev = lv_indev_get_next(NULL);
+    while(indev) {
+        uint32_t period = indev->proc.state == LV_INDEV_STATE_PR ? INDEV_READ_PERIOD_PRESSED : LV_INDEV_DEF_READ_PERIOD;
+        if(indev->driver.read_task->period != period) lv_task_set_period(indev->driver.read_task, period);
+        indev = lv_indev_get_next(indev);
+    }
+}
+
+/**
+ * Resume the read task of all input devices and read them immediately
+ */
+static void indev_wake(void)
+{
+    lv_indev_t * indev = lv_indev_get_next(NULL);
+    while(indev) {
+        lv_task_resume(indev->driver.read_task);
+        lv_task_ready(indev->driver.read_task);
+        indev = lv_indev_get_next(indev);
+    }
+}
+
+/**
+ * Wait for an input event
+ * @param timeout max. time to wait [ms] or `LV_NO_TASK_READY` to wait without timeout
+ * @return true: an event arrived; false: timeout
+ */
+static bool input_wait(uint32_t timeout)
+{
+#ifdef SDL_APPLE
+    /*The events are handled in this thread*/
+    SDL_Event event;
+    int res;
+    if(timeout == LV_NO_TASK_READY) res = SDL_WaitEvent(&event);
+    else res = SDL_WaitEventTimeout(&event, timeout > INT32_MAX ? INT32_MAX : (int)timeout);
+
+    if(res == 0) return false;
+
+    sdl_event_handle(&event);
+    return true;
+#else
+    /*The events are handled in the SDL thread of the monitor driver*/
+    return monitor_wait_input(timeout);
+#endif
 }
 
+/**
+ * Interrupt `input_wait` from an other thread
+ */
+static void async_wake(void)
+{
+#ifdef SDL_APPLE
+    SDL_Event event;
+    memset(&event, 0, sizeof(event));
+    event.type = SDL_USEREVENT;
+    SDL_PushEvent(&event);
+#else
+    monitor_wake();
+#endif
+}
+
+#ifdef SDL_APPLE
+/**
+ * Pass an SDL event to the input device drivers
+ * @param event pointer to an SDL event
+ */
+static void sdl_event_handle(SDL_Event * event)
+{
+#if USE_MOUSE != 0
+    mouse_handler(event);
+#endif
+
+#if USE_KEYBOARD
+    keyboard_handler(event);
+#endif
+
+#if USE_MOUSEWHEEL != 0
+    mousewheel_handler(event);
+#endif
+}
+#endif
+
 /**
  * Print the memory usage periodically
  * @param param
@@ -171,9 +891,58 @@ static void memory_monitor(lv_task_t * param)
 
     lv_mem_monitor_t mon;
     lv_mem_monitor(&mon);
-    printf("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d\n", (int)mon.total_size - mon.free_size,
+    printf("used: %6d (%3d %%), frag: %3d %%, biggest free: %6d, regions: %d, realloc in place/moved: %d/%d, "
+           "caches: %d, shrinks: %d\n",
+            (int)mon.total_size - mon.free_size,
             mon.used_pct,
             mon.frag_pct,
-            (int)mon.free_biggest_size);
+            (int)mon.free_biggest_size,
+            mon.region_cnt,
+            (int)mon.realloc_in_place_cnt,
+            (int)mon.realloc_move_cnt,
+            (int)mon.cache_size,
+            (int)mon.shrink_cnt);
+
+}
 
+#if USE_SOFT_GPU
+/**
+ * Print the pixels drawn by the GPU callbacks after every refresh. Used as the display driver's `monitor_cb`.
+ * @param drv pointer to the display driver
+ * @param time duration of the refresh [ms]
+ * @param px number of redrawn pixels
+ */
+static void gpu_report(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    (void) drv; /*Unused*/
+
+    soft_gpu_stat_t stat;
+    soft_gpu_get_stat(&stat, true);
+    printf("frame: %3u ms, %7u px, gpu fill: %7u px, gpu blend: %7u px, sw blend: %6u px, calls: %5u\n",
+           time, px, stat.fill_px, stat.blend_px, stat.sw_px, stat.call_cnt);
 }
+#endif
+
+#if USE_NETDISP
+/**
+ * Print the statistics of the stream of the last second
+ * @param task unused
+ */
+static void stream_report(lv_task_t * task)
+{
+    (void) task; /*Unused*/
+
+    if(netdisp_is_connected() == false) return;
+
+    netdisp_stat_t stat;
+    netdisp_get_stat(&stat, true);
+    if(stat.frame_cnt == 0) return;
+
+    printf("stream: %3u frames, %7u B/frame (%3u %% of RGB565), areas raw/rle/pal: %u/%u/%u, "
+           "latency: avg %3u ms, max %3u ms, dropped: %u\n",
+           stat.frame_cnt, stat.sent_bytes / stat.frame_cnt,
+           stat.raw_bytes ? (uint32_t)((uint64_t)stat.sent_bytes * 100 / stat.raw_bytes) : 0,
+           stat.enc_cnt[NETDISP_ENC_RAW], stat.enc_cnt[NETDISP_ENC_RLE], stat.enc_cnt[NETDISP_ENC_PAL],
+           stat.ack_cnt ? stat.latency_sum / stat.ack_cnt : 0, stat.latency_max, stat.drop_cnt);
+}
+#endif
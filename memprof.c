@@ -0,0 +1,255 @@
+/**
+ * @file memprof.c
+ * Show and print the `lv_mem` usage by subsystem counted by `LV_MEM_PROF`.
+ * The report lists the living allocations by call site. Printed at exit the ones since the designer's
+ * GUI was created are the project and the leaks of the editing, e.g. a deleted widget's memory still there.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "memprof.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+#if LV_MEM_PROF
+//The living allocations of a call site
+typedef struct
+{
+    const char * file;
+    uint32_t line;
+    lv_mem_tag_t tag;
+    uint32_t size;
+    uint32_t cnt;
+}memprof_site_t;
+#endif
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_MEM_PROF
+static void overlay_task(lv_task_t * task);
+static int alloc_cmp(const void * a, const void * b);
+static int site_cmp(const void * a, const void * b);
+static const char * file_name(const char * file);
+static void report_at_exit(void);
+#endif
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+#if LV_MEM_PROF
+static lv_obj_t * overlay_label;
+static lv_style_t overlay_style;
+static uint32_t exit_since_id;
+static bool exit_set;
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Show the used and the highest memory of every subsystem in the bottom left corner
+void memprof_overlay_create(void)
+{
+#if LV_MEM_PROF
+    if(overlay_label != NULL) return;
+
+    lv_style_copy(&overlay_style, &lv_style_plain);
+    overlay_style.body.main_color = LV_COLOR_BLACK;
+    overlay_style.body.grad_color = LV_COLOR_BLACK;
+    overlay_style.body.opa = LV_OPA_60;
+    overlay_style.body.padding.left = 4;
+    overlay_style.body.padding.right = 4;
+    overlay_style.body.padding.top = 2;
+    overlay_style.body.padding.bottom = 2;
+    overlay_style.text.color = LV_COLOR_WHITE;
+
+    overlay_label = lv_label_create(lv_disp_get_layer_sys(NULL), NULL);
+    lv_label_set_style(overlay_label, LV_LABEL_STYLE_MAIN, &overlay_style);
+    lv_label_set_body_draw(overlay_label, true);
+    lv_label_set_text(overlay_label, "lv_mem -");
+
+    lv_task_create(overlay_task, MEMPROF_OVERLAY_PERIOD, LV_TASK_PRIO_LOW, NULL);
+#else
+    printf("The memory profiler is disabled (LV_MEM_PROF in lv_conf.h)\n");
+#endif
+}
+
+//Print the usage of every subsystem and the living allocations made since `since_id` (`lv_mem_prof_get_next_id`)
+//by call site. 0: all of them.
+void memprof_print(FILE * fp, uint32_t since_id)
+{
+#if LV_MEM_PROF
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    fprintf(fp, "lv_mem: %u of %u bytes used, highest %u\n", mon.total_size - mon.free_size, mon.total_size,
+            mon.max_used);
+    fprintf(fp, "%-8s %10s %10s %8s %10s\n", "tag", "used", "max", "cnt", "allocs");
+
+    lv_mem_tag_t tag;
+    for(tag = 0; tag < _LV_MEM_TAG_NUM; tag++)
+    {
+        lv_mem_prof_stat_t stat;
+        lv_mem_prof_get_stat(tag, &stat);
+        fprintf(fp, "%-8s %10u %10u %8u %10u\n", lv_mem_prof_get_tag_name(tag), stat.used, stat.max_used, stat.cnt,
+                stat.total_cnt);
+    }
+    if(lv_mem_prof_get_lost_cnt() > 0)
+    {
+        fprintf(fp, "%u allocations aren't counted, raise LV_MEM_PROF_ENT_MAX in lv_conf.h\n",
+                lv_mem_prof_get_lost_cnt());
+    }
+
+    //Collect the allocations, sort them by call site and merge the same sites
+    uint32_t cap = 256;
+    uint32_t cnt = 0;
+    lv_mem_prof_alloc_t * allocs = malloc(cap * sizeof(lv_mem_prof_alloc_t));
+    lv_mem_prof_alloc_t alloc;
+    uint32_t i = 0;
+    while(allocs != NULL && lv_mem_prof_get_alloc(&i, &alloc))
+    {
+        if(alloc.id < since_id) continue;
+        if(cnt == cap)
+        {
+            lv_mem_prof_alloc_t * new_allocs = realloc(allocs, cap * 2 * sizeof(lv_mem_prof_alloc_t));
+            if(new_allocs == NULL) break;
+            allocs = new_allocs;
+            cap *= 2;
+        }
+        allocs[cnt++] = alloc;
+    }
+    if(allocs == NULL)
+    {
+        fprintf(fp, "Out of memory, the allocations aren't listed\n");
+        return;
+    }
+
+    memprof_site_t * sites = malloc(LV_MATH_MAX(cnt, 1) * sizeof(memprof_site_t));
+    if(sites == NULL)
+    {
+        fprintf(fp, "Out of memory, the allocations aren't listed\n");
+        free(allocs);
+        return;
+    }
+
+    qsort(allocs, cnt, sizeof(lv_mem_prof_alloc_t), alloc_cmp);
+    uint32_t site_cnt = 0;
+    uint32_t size_sum = 0;
+    for(i = 0; i < cnt; i++)
+    {
+        alloc = allocs[i];
+        size_sum += alloc.size;
+        if(site_cnt > 0 && sites[site_cnt - 1].file == alloc.file && sites[site_cnt - 1].line == alloc.line)
+        {
+            sites[site_cnt - 1].size += alloc.size;
+            sites[site_cnt - 1].cnt++;
+            continue;
+        }
+        memprof_site_t * site = &sites[site_cnt++];
+        site->file = alloc.file;
+        site->line = alloc.line;
+        site->tag = alloc.tag;
+        site->size = alloc.size;
+        site->cnt = 1;
+    }
+    qsort(sites, site_cnt, sizeof(memprof_site_t), site_cmp);
+
+    fprintf(fp, "%u living allocations (%u bytes) from %u call sites%s\n", cnt, size_sum, site_cnt,
+            since_id ? " since the mark" : "");
+    for(i = 0; i < site_cnt && i < MEMPROF_SITE_MAX; i++)
+    {
+        fprintf(fp, "%10u bytes %6u x  %-6s %s:%u\n", sites[i].size, sites[i].cnt,
+                lv_mem_prof_get_tag_name(sites[i].tag), file_name(sites[i].file), sites[i].line);
+    }
+    if(site_cnt > MEMPROF_SITE_MAX) fprintf(fp, "... %u more call sites\n", site_cnt - MEMPROF_SITE_MAX);
+
+    free(sites);
+    free(allocs);
+#else
+    (void)since_id;
+    fprintf(fp, "The memory profiler is disabled (LV_MEM_PROF in lv_conf.h)\n");
+#endif
+}
+
+//Print the report when the designer exits with the allocations made after this call (e.g. after creating the GUI)
+void memprof_report_at_exit(void)
+{
+#if LV_MEM_PROF
+    if(!exit_set) atexit(report_at_exit);
+    exit_set = true;
+    exit_since_id = lv_mem_prof_get_next_id();
+#else
+    printf("The memory profiler is disabled (LV_MEM_PROF in lv_conf.h)\n");
+#endif
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+#if LV_MEM_PROF
+
+static void overlay_task(lv_task_t * task)
+{
+    (void)task;
+
+    char buf[_LV_MEM_TAG_NUM * 32] = "lv_mem -";
+    uint32_t len = 0;
+    lv_mem_tag_t tag;
+    for(tag = 0; tag < _LV_MEM_TAG_NUM; tag++)
+    {
+        lv_mem_prof_stat_t stat;
+        lv_mem_prof_get_stat(tag, &stat);
+        if(stat.max_used == 0) continue;
+        len += snprintf(&buf[len], sizeof(buf) - len, "%s%s %u.%u / %u.%u kB", len ? "\n" : "",
+                        lv_mem_prof_get_tag_name(tag), stat.used / 1024, (stat.used % 1024) * 10 / 1024,
+                        stat.max_used / 1024, (stat.max_used % 1024) * 10 / 1024);
+        if(len >= sizeof(buf)) break;
+    }
+
+    //Don't redraw the overlay if nothing changed
+    if(strcmp(buf, lv_label_get_text(overlay_label)) != 0) lv_label_set_text(overlay_label, buf);
+    lv_obj_align(overlay_label, NULL, LV_ALIGN_IN_BOTTOM_LEFT, 4, -4);
+}
+
+//By call site
+static int alloc_cmp(const void * a, const void * b)
+{
+    const lv_mem_prof_alloc_t * aa = a;
+    const lv_mem_prof_alloc_t * ab = b;
+    if(aa->file != ab->file) return (uintptr_t)aa->file < (uintptr_t)ab->file ? -1 : 1;
+    if(aa->line != ab->line) return aa->line < ab->line ? -1 : 1;
+    return 0;
+}
+
+//The biggest first
+static int site_cmp(const void * a, const void * b)
+{
+    const memprof_site_t * sa = a;
+    const memprof_site_t * sb = b;
+    if(sa->size != sb->size) return sa->size > sb->size ? -1 : 1;
+    return 0;
+}
+
+//`__FILE__` without the directories
+static const char * file_name(const char * file)
+{
+    if(file == NULL) return "unknown";
+    const char * name = strrchr(file, '/');
+    return name ? name + 1 : file;
+}
+
+static void report_at_exit(void)
+{
+    printf("Memory of the designer at exit, allocated after creating the GUI:\n");
+    memprof_print(stdout, exit_since_id);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/**
+ * @file memprof.h
+ *
+ */
+
+#ifndef _MEMPROF_H_
+#define _MEMPROF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define MEMPROF_OVERLAY_PERIOD      500         //[ms] between two updates of the overlay
+#define MEMPROF_SITE_MAX            20          //Call sites listed in the report, the biggest first
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void memprof_overlay_create(void);
+void memprof_print(FILE * fp, uint32_t since_id);
+void memprof_report_at_exit(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,409 @@
+/**
+ * @file preview.c
+ * Show the open screen on other target resolutions and colour depths while it's edited.
+ * Every preview is an own display with its own draw buffer, refresh task and widgets (built from a snapshot of
+ * the open screen), its frame is shown in a window of the designer's display. The refresh tasks of the previews
+ * have lower priority than the designer's and a slow preview is refreshed less often to stay in its frame budget,
+ * so the previews can't stall the editing.
+ * A zoomed preview's frame is shown in an own window as a texture instead: zooming and panning it is done by the
+ * GPU, nothing is redrawn for them.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "preview.h"
+#include "headless.h"
+#include "projjob.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "lv_drivers/display/monitor.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    preview_target_t target;
+    lv_disp_t * disp;
+    lv_disp_buf_t disp_buf;
+    lv_color_t * buf;           //Draw buffer of `disp`
+#if LV_USE_DRAW_PACKED
+    lv_draw_packed_fmt_t packed_fmt;
+#endif
+    lv_color_t * fb;            //The frame of `disp`, shown by `img` on the designer's display
+    lv_img_dsc_t img_dsc;
+    lv_obj_t * win;
+    lv_obj_t * img;
+    monitor_view_t * view;      //Shows `fb` instead of `win` if the target is zoomed
+    lv_area_t flushed;          //The flushed areas of the current refresh joined
+    bool flushed_any;
+}preview_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool preview_add(const preview_target_t * target);
+static void preview_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void preview_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px);
+static void preview_build(preview_t * p, const projsnap_t * snap);
+static void sync_task(lv_task_t * task);
+static bool snap_equal(const projsnap_t * a, const projsnap_t * b);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static preview_t previews[PREVIEW_MAX];
+static uint8_t preview_cnt;
+static uint8_t preview_budget;
+static projsnap_t shown;            //The previews show it, their widgets use its styles
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Parse a comma separated list like "320x240,800x480@16" into `targets` (`PREVIEW_MAX` elements). 0: invalid list.
+//Without "@<depth>" the target has the designer's colour depth. "@1p" and "@2" are drawn into packed buffers
+//(pages of 8 rows and 4 grey levels) the way a monochrome panel's driver draws.
+uint8_t preview_targets_parse(const char * text, preview_target_t * targets)
+{
+    uint8_t cnt = 0;
+    while(*text != '\0')
+    {
+        char * end;
+        unsigned long hres = strtoul(text, &end, 10);
+        if(end == text || *end != 'x') return 0;
+        text = end + 1;
+        unsigned long vres = strtoul(text, &end, 10);
+        if(end == text) return 0;
+        unsigned long depth = LV_COLOR_DEPTH;
+        bool packed = false;
+        if(*end == '@')
+        {
+            text = end + 1;
+            depth = strtoul(text, &end, 10);
+            if(end == text) return 0;
+            if(*end == 'p' && depth == 1)
+            {
+                packed = true;
+                end++;
+            }
+            if(depth == 2) packed = true;
+        }
+        if(hres == 0 || hres > LV_HOR_RES_MAX || vres == 0 || vres > LV_VER_RES_MAX) return 0;
+        if((depth != 1 && depth != 2 && depth != 8 && depth != 16 && depth != 32) || cnt >= PREVIEW_MAX) return 0;
+#if LV_USE_DRAW_PACKED == 0
+        if(packed) return 0;
+#endif
+        targets[cnt].hres = hres;
+        targets[cnt].vres = vres;
+        targets[cnt].depth = depth;
+        targets[cnt].packed = packed;
+        targets[cnt].zoom = false;
+        cnt++;
+        if(*end == ',') end++;
+        else if(*end != '\0') return 0;
+        text = end;
+    }
+    return cnt;
+}
+
+//Open a preview for every target. `budget`: the percentage of the time a preview may spend with drawing.
+//Call it after the designer's display and GUI are created.
+void preview_create(const preview_target_t * targets, uint8_t cnt, uint8_t budget)
+{
+    preview_budget = budget;
+    uint8_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(!preview_add(&targets[i]))
+        {
+            printf("Preview: out of memory for %dx%d\n", targets[i].hres, targets[i].vres);
+        }
+    }
+    if(preview_cnt > 0) lv_task_create(sync_task, PREVIEW_SYNC_PERIOD, LV_TASK_PRIO_LOW, NULL);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool preview_add(const preview_target_t * target)
+{
+    if(preview_cnt >= PREVIEW_MAX) return false;
+
+    preview_t * p = &previews[preview_cnt];
+    memset(p, 0, sizeof(preview_t));
+    p->target = *target;
+    uint32_t px_cnt = (uint32_t)target->hres * target->vres;
+    uint32_t buf_px = (uint32_t)target->hres * PREVIEW_BUF_LINES;
+    uint32_t buf_size = buf_px * sizeof(lv_color_t);
+#if LV_USE_DRAW_PACKED
+    if(target->packed)
+    {
+        p->packed_fmt = target->depth == 1 ? LV_DRAW_PACKED_1BPP_VER : LV_DRAW_PACKED_2BPP_HOR;
+        buf_size = lv_draw_packed_get_buf_size(p->packed_fmt, buf_px);
+    }
+#endif
+    p->fb = calloc(px_cnt, sizeof(lv_color_t));
+    p->buf = malloc(buf_size);
+    if(p->fb == NULL || p->buf == NULL)
+    {
+        free(p->fb);
+        free(p->buf);
+        return false;
+    }
+
+    lv_disp_t * editor_disp = lv_disp_get_default();
+    lv_disp_buf_init(&p->disp_buf, p->buf, NULL, buf_px);
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = target->hres;
+    disp_drv.ver_res = target->vres;
+    disp_drv.buffer = &p->disp_buf;
+    disp_drv.flush_cb = preview_flush;
+    disp_drv.monitor_cb = preview_monitor;
+    disp_drv.user_data = p;
+#if LV_USE_DRAW_PACKED
+    if(target->packed) lv_draw_packed_init_drv(&disp_drv, p->packed_fmt);
+#endif
+    p->disp = lv_disp_drv_register(&disp_drv);
+    lv_disp_set_default(editor_disp);
+    if(p->disp == NULL)
+    {
+        free(p->fb);
+        free(p->buf);
+        return false;
+    }
+    //The designer's display is refreshed first in every round of the task handler
+    lv_task_set_prio(p->disp->refr_task, LV_TASK_PRIO_LOW);
+
+    p->img_dsc.header.always_zero = 0;
+    p->img_dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+    p->img_dsc.header.w = target->hres;
+    p->img_dsc.header.h = target->vres;
+    p->img_dsc.data_size = px_cnt * sizeof(lv_color_t);
+    p->img_dsc.data = (const uint8_t *)p->fb;
+
+    char title[48];
+    snprintf(title, sizeof(title), "Preview  [Size:%dx%d, %u bit%s]", target->hres, target->vres, target->depth,
+             target->packed ? " packed" : "");
+    if(target->zoom)
+    {
+        p->view = monitor_view_create(title, target->hres, target->vres);
+        if(p->view == NULL)
+        {
+            lv_task_del(p->disp->refr_task);
+            lv_disp_remove(p->disp);
+            free(p->fb);
+            free(p->buf);
+            return false;
+        }
+        preview_cnt++;
+        return true;
+    }
+
+    p->win = lv_win_create(lv_disp_get_scr_act(editor_disp), NULL);
+    lv_win_set_title(p->win, title);
+    lv_win_set_drag(p->win, true);
+    lv_win_set_sb_mode(p->win, LV_SB_MODE_AUTO);
+    p->img = lv_img_create(p->win, NULL);
+    lv_img_set_src(p->img, &p->img_dsc);
+
+    //Make the content area as large as the frame
+    lv_obj_set_size(p->win, target->hres, target->vres);
+    lv_obj_t * page = lv_win_get_content(p->win);
+    const lv_style_t * scrl_style = lv_win_get_style(p->win, LV_WIN_STYLE_CONTENT);
+    lv_coord_t content_w = lv_obj_get_width(page) - scrl_style->body.padding.left - scrl_style->body.padding.right;
+    lv_coord_t content_h = lv_obj_get_height(page) - scrl_style->body.padding.top - scrl_style->body.padding.bottom;
+    lv_obj_set_size(p->win, 2 * target->hres - content_w, 2 * target->vres - content_h);
+    lv_obj_align(p->win, NULL, LV_ALIGN_IN_TOP_RIGHT, -10 - preview_cnt * 30, 10 + preview_cnt * 30);
+
+    preview_cnt++;
+    return true;
+}
+
+//Copy the drawn pixels into the frame in the colours of the target
+static void preview_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    preview_t * p = drv->user_data;
+    uint32_t w = lv_area_get_width(area);
+    lv_coord_t y;
+#if LV_USE_DRAW_PACKED
+    if(p->target.packed)
+    {
+        //The rounded area can be larger than the frame
+        lv_area_t frame;
+        lv_area_set(&frame, 0, 0, p->target.hres - 1, p->target.vres - 1);
+        lv_area_t shown_a;
+        if(lv_area_intersect(&shown_a, area, &frame))
+        {
+            uint8_t max = (1 << p->target.depth) - 1;
+            for(y = shown_a.y1; y <= shown_a.y2; y++)
+            {
+                lv_color_t * dest = &p->fb[(uint32_t)y * p->target.hres];
+                lv_coord_t x;
+                for(x = shown_a.x1; x <= shown_a.x2; x++)
+                {
+                    uint8_t v = lv_draw_packed_get_px(p->packed_fmt, (const uint8_t *)color_p, w,
+                                                      x - area->x1, y - area->y1);
+                    uint8_t grey = v * 255 / max;
+                    dest[x] = lv_color_make(grey, grey, grey);
+                }
+            }
+            if(p->flushed_any) lv_area_join(&p->flushed, &p->flushed, &shown_a);
+            else lv_area_copy(&p->flushed, &shown_a);
+            p->flushed_any = true;
+        }
+        lv_disp_flush_ready(drv);
+        return;
+    }
+#endif
+    for(y = area->y1; y <= area->y2; y++)
+    {
+        lv_color_t * dest = &p->fb[(uint32_t)y * p->target.hres + area->x1];
+        if(p->target.depth == LV_COLOR_DEPTH)
+        {
+            memcpy(dest, color_p, w * sizeof(lv_color_t));
+        }else
+        {
+            uint32_t x;
+            for(x = 0; x < w; x++)
+            {
+                lv_color32_t c;
+                c.full = lv_color_to32(color_p[x]);
+                headless_color_to_depth(&c, p->target.depth);
+                dest[x] = lv_color_make(c.ch.red, c.ch.green, c.ch.blue);
+            }
+        }
+        color_p += w;
+    }
+
+    if(p->flushed_any) lv_area_join(&p->flushed, &p->flushed, area);
+    else lv_area_copy(&p->flushed, area);
+    p->flushed_any = true;
+    lv_disp_flush_ready(drv);
+}
+
+//Called after every refresh of a preview: show the new pixels and keep the preview in its frame budget
+static void preview_monitor(lv_disp_drv_t * drv, uint32_t time, uint32_t px)
+{
+    (void)px;
+    preview_t * p = drv->user_data;
+    if(p->flushed_any && p->view != NULL)
+    {
+        monitor_view_update(p->view, p->fb, &p->flushed);
+        p->flushed_any = false;
+    }
+    else if(p->flushed_any)
+    {
+        lv_area_t area = p->flushed;
+        area.x1 += p->img->coords.x1;
+        area.y1 += p->img->coords.y1;
+        area.x2 += p->img->coords.x1;
+        area.y2 += p->img->coords.y1;
+        lv_obj_invalidate_area(p->img, &area);
+        p->flushed_any = false;
+    }
+
+    //A slow preview is refreshed less often: it may draw only `preview_budget` % of the time
+    uint32_t period = preview_budget > 0 ? time * 100 / preview_budget : PREVIEW_REFR_PERIOD;
+    if(period < PREVIEW_REFR_PERIOD) period = PREVIEW_REFR_PERIOD;
+    lv_task_set_period(p->disp->refr_task, period);
+}
+
+//Create the widgets of a snapshot on the screen of a preview. The root (the TFT Simulator) is the screen.
+static void preview_build(preview_t * p, const projsnap_t * snap)
+{
+    lv_obj_t * scr = lv_disp_get_scr_act(p->disp);
+    lv_obj_clean(scr);
+    if(snap->cnt == 0) return;
+
+    lv_obj_t ** made = malloc(snap->cnt * sizeof(lv_obj_t *));     //The widget of every snapshot node
+    if(made == NULL)
+    {
+        printf("Preview: out of memory, the screen can't be shown\n");
+        return;
+    }
+    made[0] = scr;
+
+    lv_obj_batch_begin();
+    uint32_t i;
+    for(i = 1; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * r = &snap->nodes[i];
+        const widget_desc_t * desc = widgetreg_get(r->type);
+        lv_obj_t * obj = desc != NULL ? desc->create_cb(made[r->parent], NULL) : NULL;
+        if(obj == NULL)
+        {
+            made[i] = made[r->parent];      //Its children go to the parent
+            continue;
+        }
+        made[i] = obj;
+        if(r->style != PROJSNAP_NO_STYLE) lv_obj_set_style(obj, &snap->styles[r->style]);
+        if(r->text != NULL) widgetreg_text_apply(obj, r->type, r->text);
+        widgetreg_vals_apply(obj, r->type, r->vals, r->val_cnt);
+        lv_obj_set_size(obj, r->w, r->h);
+        lv_obj_set_pos(obj, r->x, r->y);
+    }
+    lv_obj_batch_commit();
+    free(made);
+}
+
+//Show the open screen in the previews again if it has changed since the last check
+static void sync_task(lv_task_t * task)
+{
+    (void)task;
+    if(projjob_is_busy()) return;       //E.g. a project is being loaded
+
+    projsnap_t snap;
+    if(!projsnap_take(&snap, doc_get_screen())) return;
+    if(snap_equal(&snap, &shown))
+    {
+        projsnap_free(&snap);
+        return;
+    }
+
+    //The old widgets are deleted first, so the styles of `shown` can be freed after them
+    uint8_t i;
+    for(i = 0; i < preview_cnt; i++) preview_build(&previews[i], &snap);
+    projsnap_free(&shown);
+    shown = snap;
+}
+
+//Would the two snapshots look the same? The IDs don't matter.
+static bool snap_equal(const projsnap_t * a, const projsnap_t * b)
+{
+    if(a->cnt != b->cnt || a->style_cnt != b->style_cnt) return false;
+    if(a->style_cnt > 0 && memcmp(a->styles, b->styles, a->style_cnt * sizeof(lv_style_t))) return false;
+
+    uint32_t i;
+    for(i = 0; i < a->cnt; i++)
+    {
+        const projsnap_node_t * na = &a->nodes[i];
+        const projsnap_node_t * nb = &b->nodes[i];
+        if(na->type != nb->type || na->parent != nb->parent || na->style != nb->style || na->font != nb->font) return false;
+        if(na->x != nb->x || na->y != nb->y || na->w != nb->w || na->h != nb->h) return false;
+        if((na->text == NULL) != (nb->text == NULL)) return false;
+        if(na->text != NULL && strcmp(na->text, nb->text)) return false;
+        if(na->val_cnt != nb->val_cnt) return false;
+        uint8_t v;
+        for(v = 0; v < na->val_cnt; v++)
+        {
+            if(na->vals[v].attr != nb->vals[v].attr || na->vals[v].value != nb->vals[v].value) return false;
+        }
+    }
+    return true;
+}
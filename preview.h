@@ -0,0 +1,64 @@
+/**
+ * @file preview.h
+ *
+ */
+
+#ifndef _PREVIEW_H_
+#define _PREVIEW_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PREVIEW_MAX             4           //Previews in one run
+#define PREVIEW_BUF_LINES       20          //The draw buffer of a preview's display is this many lines
+#define PREVIEW_SYNC_PERIOD     300         //[ms] between two checks of the open screen for changes
+#define PREVIEW_REFR_PERIOD     LV_DISP_DEF_REFR_PERIOD     //[ms] The shortest refresh period of a preview
+#define PREVIEW_BUDGET_DEF      20          //[%] of the time a preview may spend with drawing by default
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    lv_coord_t hres;
+    lv_coord_t vres;
+    uint8_t depth;              //Colour depth of the target: 1, 2, 8, 16 or 32
+    bool packed;                //Drawn into a packed buffer like on a monochrome panel (always with 2 bit)
+    bool zoom;                  //Shown in an own window scaled by the GPU instead of 1:1 on the designer's display
+}preview_target_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+uint8_t preview_targets_parse(const char * text, preview_target_t * targets);
+void preview_create(const preview_target_t * targets, uint8_t cnt, uint8_t budget);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,292 @@
+/**
+ * @file profiler.c
+ * Show and save the frames measured by `lv_prof`.
+ * The overlay sits on the system layer so it stays above every screen and doesn't take the clicks.
+ * It's refreshed too, so it adds a small frame of its own in every `PROFILER_OVERLAY_PERIOD`.
+ * The startup phases are timed separately (without `lv_prof`, most of them run before `lv_init`):
+ * the wall and the CPU time of each, so waiting (e.g. for the disk or the window) shows up as the difference.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "profiler.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    double wall;                //[ms] since `profiler_startup_begin`
+    double cpu;
+}startup_phase_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+#if LV_USE_PROF
+static void overlay_task(lv_task_t * task);
+static void json_write(FILE * fp);
+static void trace_write(FILE * fp);
+static void export_at_exit(void);
+#endif
+static double wall_ms(void);
+static double cpu_ms(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const char * fmt_names[_PROFILER_FMT_NUM] = {"json", "trace"};
+static startup_phase_t startup_phases[PROFILER_STARTUP_MAX];
+static uint32_t startup_cnt;
+static double startup_wall0;
+static double startup_cpu0;
+#if LV_USE_PROF
+static lv_obj_t * overlay_label;
+static lv_style_t overlay_style;
+static const char * exit_path;
+static profiler_fmt_t exit_fmt;
+#endif
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//_PROFILER_FMT_NUM for an unknown name
+profiler_fmt_t profiler_fmt_from_name(const char * name)
+{
+    profiler_fmt_t fmt;
+    for(fmt = 0; fmt < _PROFILER_FMT_NUM; fmt++)
+    {
+        if(!strcmp(name, fmt_names[fmt])) break;
+    }
+    return fmt;
+}
+
+//Start the measuring and show the FPS, the CPU usage, the draw time and the used memory in the top right corner
+void profiler_overlay_create(void)
+{
+#if LV_USE_PROF
+    if(overlay_label != NULL) return;
+
+    lv_prof_set_en(true);
+
+    lv_style_copy(&overlay_style, &lv_style_plain);
+    overlay_style.body.main_color = LV_COLOR_BLACK;
+    overlay_style.body.grad_color = LV_COLOR_BLACK;
+    overlay_style.body.opa = LV_OPA_60;
+    overlay_style.body.padding.left = 4;
+    overlay_style.body.padding.right = 4;
+    overlay_style.body.padding.top = 2;
+    overlay_style.body.padding.bottom = 2;
+    overlay_style.text.color = LV_COLOR_WHITE;
+
+    overlay_label = lv_label_create(lv_disp_get_layer_sys(NULL), NULL);
+    lv_label_set_style(overlay_label, LV_LABEL_STYLE_MAIN, &overlay_style);
+    lv_label_set_body_draw(overlay_label, true);
+    lv_label_set_text(overlay_label, "FPS -");
+
+    lv_task_create(overlay_task, PROFILER_OVERLAY_PERIOD, LV_TASK_PRIO_LOW, NULL);
+#else
+    printf("The profiler is disabled (LV_USE_PROF in lv_conf.h)\n");
+#endif
+}
+
+//Write the stored frames into a file
+bool profiler_export(const char * path, profiler_fmt_t fmt)
+{
+#if LV_USE_PROF
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    if(fmt == PROFILER_TRACE) trace_write(fp);
+    else json_write(fp);
+
+    bool res = !ferror(fp);
+    if(fclose(fp) != 0) res = false;
+    if(!res)
+    {
+        printf("Can't write %s\n", path);
+        return false;
+    }
+
+    printf("%s: %u frames\n", path, lv_prof_get_frame_cnt());
+    return true;
+#else
+    (void)fmt;
+    printf("The profiler is disabled (LV_USE_PROF in lv_conf.h), %s isn't written\n", path);
+    return false;
+#endif
+}
+
+//Start the measuring and write the last frames into `path` when the designer exits (e.g. its window is closed)
+void profiler_export_at_exit(const char * path, profiler_fmt_t fmt)
+{
+#if LV_USE_PROF
+    lv_prof_set_en(true);
+
+    if(exit_path == NULL) atexit(export_at_exit);
+    exit_path = path;
+    exit_fmt = fmt;
+#else
+    profiler_export(path, fmt);
+#endif
+}
+
+//Start timing the startup, the first phase begins now
+void profiler_startup_begin(void)
+{
+    startup_cnt = 0;
+    startup_wall0 = wall_ms();
+    startup_cpu0 = cpu_ms();
+}
+
+//The end of a startup phase (and the start of the next one). Cheap, it's called even if nothing is reported.
+void profiler_startup_mark(const char * phase)
+{
+    if(startup_cnt >= PROFILER_STARTUP_MAX) return;
+    startup_phase_t * p = &startup_phases[startup_cnt++];
+    p->name = phase;
+    p->wall = wall_ms() - startup_wall0;
+    p->cpu = cpu_ms() - startup_cpu0;
+}
+
+//Print the duration of every startup phase marked so far
+void profiler_startup_report(void)
+{
+    printf("startup phase         wall [ms]   cpu [ms]       at [ms]\n");
+    double wall_prev = 0;
+    double cpu_prev = 0;
+    uint32_t i;
+    for(i = 0; i < startup_cnt; i++)
+    {
+        const startup_phase_t * p = &startup_phases[i];
+        printf("  %-18s %10.2f %10.2f %13.2f\n", p->name, p->wall - wall_prev, p->cpu - cpu_prev, p->wall);
+        wall_prev = p->wall;
+        cpu_prev = p->cpu;
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static double wall_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+//Of the whole process, so the drawing threads are counted too
+static double cpu_ms(void)
+{
+    return (double)clock() * 1000 / CLOCKS_PER_SEC;
+}
+
+#if LV_USE_PROF
+
+static void overlay_task(lv_task_t * task)
+{
+    (void)task;
+
+    //Average the frames of the last `PROFILER_FPS_WINDOW`
+    uint32_t now = lv_prof_time();
+    uint32_t frame_cnt = 0;
+    uint32_t refr_sum = 0;
+    uint16_t id = lv_prof_get_frame_cnt();
+    while(id > 0)
+    {
+        const lv_prof_frame_t * frame = lv_prof_get_frame(--id);
+        if(now - frame->start > PROFILER_FPS_WINDOW) break;
+        frame_cnt++;
+        refr_sum += frame->refr_time;
+    }
+    uint32_t refr_avg = frame_cnt ? refr_sum / frame_cnt : 0;
+
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+
+    char buf[96];
+    snprintf(buf, sizeof(buf), "FPS %u\nCPU %u %%\nDraw %u.%u ms\nMem %u %%",
+             frame_cnt, 100 - lv_task_get_idle(), refr_avg / 1000, (refr_avg % 1000) / 100, mon.used_pct);
+
+    //Don't redraw (and so measure) the overlay if nothing changed
+    if(strcmp(buf, lv_label_get_text(overlay_label)) != 0) lv_label_set_text(overlay_label, buf);
+    lv_obj_align(overlay_label, NULL, LV_ALIGN_IN_TOP_RIGHT, -4, 4);
+}
+
+//{"frames": [{"start": ..., "types": {"lv_btn": {"time": ..., "cnt": ...}, ...}}, ...]}, the times in us from the first frame
+static void json_write(FILE * fp)
+{
+    uint16_t cnt = lv_prof_get_frame_cnt();
+    uint32_t t0 = cnt ? lv_prof_get_frame(0)->start : 0;
+
+    fprintf(fp, "{\"frames\": [");
+    uint16_t id;
+    for(id = 0; id < cnt; id++)
+    {
+        const lv_prof_frame_t * f = lv_prof_get_frame(id);
+        fprintf(fp, "%s\n  {\"start\": %u, \"refr\": %u, \"draw\": %u, \"flush\": %u, \"task\": %u, \"task_cnt\": %u, "
+                "\"inv\": %u, \"areas\": %u, \"px\": %u, \"types\": {",
+                id ? "," : "", f->start - t0, f->refr_time, f->draw_time, f->flush_time, f->task_time, f->task_cnt,
+                f->inv_cnt, f->area_cnt, f->px_num);
+        uint8_t i;
+        for(i = 0; i < f->type_cnt; i++)
+        {
+            fprintf(fp, "%s\"%s\": {\"time\": %u, \"cnt\": %u}", i ? ", " : "",
+                    f->types[i].type, f->types[i].time, f->types[i].cnt);
+        }
+        fprintf(fp, "}}");
+    }
+    fprintf(fp, "\n]}\n");
+}
+
+//A "refresh" slice for every frame and counters of the design time by type, the pixels and the tasks
+static void trace_write(FILE * fp)
+{
+    uint16_t cnt = lv_prof_get_frame_cnt();
+    uint32_t t0 = cnt ? lv_prof_get_frame(0)->start : 0;
+
+    fprintf(fp, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    uint16_t id;
+    for(id = 0; id < cnt; id++)
+    {
+        const lv_prof_frame_t * f = lv_prof_get_frame(id);
+        uint32_t ts = f->start - t0;
+        fprintf(fp, "%s\n  {\"name\": \"refresh\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %u, \"dur\": %u, "
+                "\"args\": {\"inv\": %u, \"areas\": %u, \"px\": %u, \"draw_us\": %u, \"flush_us\": %u}},",
+                id ? "," : "", ts, f->refr_time, f->inv_cnt, f->area_cnt, f->px_num, f->draw_time, f->flush_time);
+        fprintf(fp, "\n  {\"name\": \"pixels\", \"ph\": \"C\", \"pid\": 1, \"ts\": %u, \"args\": {\"px\": %u}},",
+                ts, f->px_num);
+        fprintf(fp, "\n  {\"name\": \"tasks\", \"ph\": \"C\", \"pid\": 1, \"ts\": %u, \"args\": {\"us\": %u, \"cnt\": %u}},",
+                ts, f->task_time, f->task_cnt);
+        fprintf(fp, "\n  {\"name\": \"design [us]\", \"ph\": \"C\", \"pid\": 1, \"ts\": %u, \"args\": {", ts);
+        uint8_t i;
+        for(i = 0; i < f->type_cnt; i++)
+        {
+            fprintf(fp, "%s\"%s\": %u", i ? ", " : "", f->types[i].type, f->types[i].time);
+        }
+        fprintf(fp, "}}");
+    }
+    fprintf(fp, "\n]}\n");
+}
+
+static void export_at_exit(void)
+{
+    profiler_export(exit_path, exit_fmt);
+}
+
+#endif
@@ -0,0 +1,64 @@
+/**
+ * @file profiler.h
+ *
+ */
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROFILER_OVERLAY_PERIOD     500         //[ms] between two updates of the overlay
+#define PROFILER_FPS_WINDOW         1000000     //[us] the FPS and the draw time are averaged on this long
+#define PROFILER_STARTUP_MAX        24          //Startup phases recorded by `profiler_startup_mark`
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    PROFILER_JSON,              //The frames as an array of objects
+    PROFILER_TRACE,             //Chrome trace event format (chrome://tracing, Perfetto)
+    _PROFILER_FMT_NUM,
+}profiler_fmt_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+profiler_fmt_t profiler_fmt_from_name(const char * name);
+void profiler_overlay_create(void);
+bool profiler_export(const char * path, profiler_fmt_t fmt);
+void profiler_export_at_exit(const char * path, profiler_fmt_t fmt);
+void profiler_startup_begin(void);
+void profiler_startup_mark(const char * phase);
+void profiler_startup_report(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,856 @@
+/**
+ * @file projdiff.c
+ * Structural diff and 3-way merge of project files, and the content hash of the document's nodes.
+ * The files are parsed into trees with a Merkle hash on every element (of its tag and attributes, then of
+ * the hashes of its children), so an unchanged subtree is skipped after comparing one number. Children are
+ * matched by their `id`, the ones without an ID by their order among such siblings. The children of a parent
+ * are put into a hash table only when the parent differs, so the time goes with the changes, not with the
+ * size of the projects. Neither LittlevGL nor the widgets are used for the files.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <mxml.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "projdiff.h"
+#include "dataset.h"
+#include "widgetreg.h"
+#include "xmlstream.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PD_NONE             0xFFFFFFFF
+#define PD_INIT_NODES       256
+#define PD_INIT_SLOTS       64          //Must be a power of 2
+#define HASH_INIT           0xcbf29ce484222325ULL  //FNV-1a, 64 bit
+#define HASH_PRIME          0x100000001b3ULL
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//An element of a parsed file. The first one is the invisible top, the file's elements are its children.
+typedef struct
+{
+    mxml_node_t * xml;
+    const char * id;            //NULL: matched by `ord`
+    uint32_t ord;               //Among the siblings without ID
+    uint32_t parent;
+    uint32_t first_child, last_child, next;
+    uint32_t anon_cnt;          //Children without ID
+    uint64_t own;               //Of the tag and the attributes
+    uint64_t hash;              //Of the subtree
+    uint8_t indexed : 1;        //The children are in `slots`
+}pd_node_t;
+
+struct _projdiff_tree_t
+{
+    const char * path;
+    mxml_node_t * top;
+    pd_node_t * nodes;          //Preorder
+    uint32_t cnt;
+    uint32_t cap;
+    uint32_t * slots;           //Indexed children by their parent and key, open addressing. Node index + 1, 0: free
+    uint32_t slot_mask;
+    uint32_t slot_used;
+};
+
+typedef projdiff_tree_t pd_tree_t;
+
+typedef bool (*diff_cb_t)(projdiff_op_t op, const pd_tree_t * a, uint32_t ia, const pd_tree_t * b, uint32_t ib,
+                          void * user_data);
+
+typedef struct
+{
+    projdiff_cb_t cb;
+    void * user_data;
+}trees_ctx_t;
+
+typedef struct
+{
+    uint32_t b, o, t;           //The node in the base, ours and theirs, PD_NONE if it's not there
+    uint32_t o_child;           //Next child of ours to merge
+    uint32_t t_child;           //Next child of theirs, visited after the ones of ours
+}merge_frame_t;
+
+typedef struct
+{
+    pd_tree_t * base;
+    pd_tree_t * ours;
+    pd_tree_t * theirs;
+    xmlstream_t xs;
+    merge_frame_t * stack;
+    uint32_t depth;
+    uint32_t cap;
+    int32_t conflicts;
+    bool oom;
+}merge_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool tree_load(pd_tree_t * tree, const char * path);
+static void tree_free(pd_tree_t * tree);
+static int32_t tree_diff(pd_tree_t * a, pd_tree_t * b, diff_cb_t cb, void * user_data);
+static bool print_cb(projdiff_op_t op, const pd_tree_t * a, uint32_t ia, const pd_tree_t * b, uint32_t ib,
+                     void * user_data);
+static bool trees_cb(projdiff_op_t op, const pd_tree_t * a, uint32_t ia, const pd_tree_t * b, uint32_t ib,
+                     void * user_data);
+static uint32_t node_add(pd_tree_t * tree, mxml_node_t * xml, uint32_t parent);
+static uint64_t own_hash(mxml_node_t * xml);
+static bool children_index(pd_tree_t * tree, uint32_t par);
+static uint32_t child_find(pd_tree_t * tree, uint32_t par, const pd_node_t * key);
+static uint64_t key_hash(uint32_t par, const pd_node_t * key);
+static bool key_eq(const pd_node_t * a, const pd_node_t * b);
+static const char * path_get(const pd_tree_t * tree, uint32_t idx, char * buf, size_t size);
+static void attrs_diff(mxml_node_t * a, mxml_node_t * b);
+static bool merge_push(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t);
+static void merge_node(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t);
+static void merge_attrs(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t);
+static void merge_conflict(merge_ctx_t * ctx, const pd_tree_t * tree, uint32_t idx, const char * what);
+static void subtree_write(xmlstream_t * xs, const pd_tree_t * tree, uint32_t root);
+static void attrs_write(xmlstream_t * xs, mxml_node_t * xml);
+static bool str_eq(const char * a, const char * b);
+static uint64_t hash_bytes(uint64_t h, const void * data, size_t size);
+static uint64_t doc_own_hash(doc_id_t id);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Print the differences of two project files: the added (+), removed (-) and changed (~) widgets with
+ * their changed attributes.
+ * @param path_a the old file
+ * @param path_b the new file
+ * @return the number of changed widgets, -1 on error
+ */
+int32_t projdiff_files(const char * path_a, const char * path_b)
+{
+    pd_tree_t a, b;
+    if(!tree_load(&a, path_a)) return -1;
+    if(!tree_load(&b, path_b))
+    {
+        tree_free(&a);
+        return -1;
+    }
+
+    int32_t changes = tree_diff(&a, &b, print_cb, NULL);
+    if(changes < 0) printf("Diff failed, out of memory\n");
+    tree_free(&a);
+    tree_free(&b);
+    return changes;
+}
+
+/**
+ * Parse a project file and hash its elements to diff it later, e.g. the version an open project was loaded from.
+ * @param path the file
+ * @return the tree, NULL on error (it's printed)
+ */
+projdiff_tree_t * projdiff_tree_load(const char * path)
+{
+    pd_tree_t * tree = malloc(sizeof(pd_tree_t));
+    if(tree == NULL) return NULL;
+    if(!tree_load(tree, path))
+    {
+        free(tree);
+        return NULL;
+    }
+    tree->path = NULL;      //Only for the messages of the load
+    return tree;
+}
+
+void projdiff_tree_del(projdiff_tree_t * tree)
+{
+    if(tree == NULL) return;
+    tree_free(tree);
+    free(tree);
+}
+
+/**
+ * Walk the differences of two parsed files as `projdiff_files` prints them. The unchanged subtrees are skipped.
+ * A changed element is reported before the changes of its children.
+ * @param a the old tree
+ * @param b the new tree
+ * @param cb called with every difference
+ * @param user_data passed to `cb`
+ * @return the number of changed elements, -1 if out of memory or `cb` stopped the walk
+ */
+int32_t projdiff_trees(projdiff_tree_t * a, projdiff_tree_t * b, projdiff_cb_t cb, void * user_data)
+{
+    trees_ctx_t ctx = {cb, user_data};
+    return tree_diff(a, b, trees_cb, &ctx);
+}
+
+/**
+ * Merge the changes of two versions of a project made since their common base, as a git merge driver does.
+ * A subtree changed on one side only is taken from that side. Where both changed a widget, its attributes
+ * are merged one by one. On a conflict (both changed the same attribute, or one deleted what the other
+ * changed) ours is kept and the conflict is printed.
+ * @param base the common ancestor
+ * @param ours our version
+ * @param theirs their version
+ * @param out the merged project is written here, it can be one of the inputs
+ * @return the number of conflicts, -1 on error
+ */
+int32_t projdiff_merge(const char * base, const char * ours, const char * theirs, const char * out)
+{
+    pd_tree_t tb, to, tt;
+    if(!tree_load(&tb, base)) return -1;
+    if(!tree_load(&to, ours))
+    {
+        tree_free(&tb);
+        return -1;
+    }
+    if(!tree_load(&tt, theirs))
+    {
+        tree_free(&tb);
+        tree_free(&to);
+        return -1;
+    }
+
+    merge_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.base = &tb;
+    ctx.ours = &to;
+    ctx.theirs = &tt;
+    if(!xmlstream_open(&ctx.xs, out))
+    {
+        printf("Can't create %s\n", out);
+        tree_free(&tb);
+        tree_free(&to);
+        tree_free(&tt);
+        return -1;
+    }
+
+    merge_push(&ctx, 0, 0, 0);          //The tops, they aren't written
+    while(ctx.depth > 0 && !ctx.oom)
+    {
+        merge_frame_t * f = &ctx.stack[ctx.depth - 1];
+        if(f->o_child != PD_NONE)
+        {
+            uint32_t c = f->o_child;
+            f->o_child = to.nodes[c].next;
+            uint32_t bc = PD_NONE;
+            uint32_t tc = PD_NONE;
+            if(f->b != PD_NONE && children_index(&tb, f->b)) bc = child_find(&tb, f->b, &to.nodes[c]);
+            if(f->t != PD_NONE && children_index(&tt, f->t)) tc = child_find(&tt, f->t, &to.nodes[c]);
+
+            if(tc != PD_NONE)
+            {
+                merge_node(&ctx, bc, c, tc);        //Can push a frame, `f` is invalid after it
+            }else if(bc == PD_NONE)
+            {
+                subtree_write(&ctx.xs, &to, c);     //Added by us
+            }else if(to.nodes[c].hash != tb.nodes[bc].hash)
+            {
+                merge_conflict(&ctx, &to, c, "changed by ours, deleted by theirs");
+                subtree_write(&ctx.xs, &to, c);
+            }
+            continue;
+        }
+        if(f->t_child != PD_NONE)
+        {
+            uint32_t c = f->t_child;
+            f->t_child = tt.nodes[c].next;
+            if(f->o != PD_NONE && children_index(&to, f->o) && child_find(&to, f->o, &tt.nodes[c]) != PD_NONE)
+            {
+                continue;       //Merged with the children of ours
+            }
+            uint32_t bc = PD_NONE;
+            if(f->b != PD_NONE && children_index(&tb, f->b)) bc = child_find(&tb, f->b, &tt.nodes[c]);
+            if(bc == PD_NONE)
+            {
+                subtree_write(&ctx.xs, &tt, c);     //Added by them
+            }else if(tt.nodes[c].hash != tb.nodes[bc].hash)
+            {
+                merge_conflict(&ctx, &tt, c, "deleted by ours, changed by theirs");
+                subtree_write(&ctx.xs, &tt, c);
+            }
+            continue;
+        }
+
+        ctx.depth--;
+        if(ctx.depth > 0) xmlstream_end(&ctx.xs);
+    }
+
+    int32_t res = ctx.conflicts;
+    if(ctx.oom)
+    {
+        printf("Merge failed, out of memory\n");
+        xmlstream_abort(&ctx.xs);
+        res = -1;
+    }else if(!xmlstream_close(&ctx.xs))
+    {
+        printf("Can't write %s\n", out);
+        res = -1;
+    }
+    free(ctx.stack);
+    tree_free(&tb);
+    tree_free(&to);
+    tree_free(&tt);
+    return res;
+}
+
+/**
+ * Get the hash of the content of a subtree of the document: the widgets' types, IDs, geometry, texts,
+ * attributes and main styles. Only the nodes changed since the last call are hashed again.
+ * @param id root of the subtree, DOC_ROOT: every open screen
+ * @return the hash, equal for equal subtrees
+ */
+uint64_t projdiff_doc_hash(doc_id_t id)
+{
+    return doc_hash_get(id, doc_own_hash);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Parse a file and hash its elements. Prints the error.
+static bool tree_load(pd_tree_t * tree, const char * path)
+{
+    memset(tree, 0, sizeof(pd_tree_t));
+    tree->path = path;
+    FILE * fp = fopen(path, "r");
+    if(fp == NULL)
+    {
+        printf("Can't open %s\n", path);
+        return false;
+    }
+    tree->top = mxmlNewElement(MXML_NO_PARENT, "project");
+    bool res = tree->top != NULL && mxmlLoadFile(tree->top, fp, MXML_OPAQUE_CALLBACK) != NULL;
+    fclose(fp);
+    if(!res)
+    {
+        printf("Can't parse %s\n", path);
+        tree_free(tree);
+        return false;
+    }
+
+    //The index of the node of an element is kept in its user data while the tree is built
+    if(node_add(tree, tree->top, PD_NONE) == PD_NONE)
+    {
+        printf("%s: out of memory\n", path);
+        tree_free(tree);
+        return false;
+    }
+    mxml_node_t * xml;
+    for(xml = mxmlWalkNext(tree->top, tree->top, MXML_DESCEND); xml != NULL;
+        xml = mxmlWalkNext(xml, tree->top, MXML_DESCEND))
+    {
+        if(mxmlGetType(xml) != MXML_ELEMENT) continue;
+        uint32_t par = (uint32_t)(uintptr_t)mxmlGetUserData(mxmlGetParent(xml));
+        if(node_add(tree, xml, par) == PD_NONE)
+        {
+            printf("%s: out of memory\n", path);
+            tree_free(tree);
+            return false;
+        }
+    }
+
+    //The children are after their parent in preorder, so hash backwards
+    uint32_t i;
+    for(i = tree->cnt; i > 0; i--)
+    {
+        pd_node_t * n = &tree->nodes[i - 1];
+        uint64_t h = hash_bytes(HASH_INIT, &n->own, sizeof(n->own));
+        uint32_t c;
+        for(c = n->first_child; c != PD_NONE; c = tree->nodes[c].next)
+        {
+            h = hash_bytes(h, &tree->nodes[c].hash, sizeof(uint64_t));
+        }
+        n->hash = h;
+    }
+    return true;
+}
+
+static void tree_free(pd_tree_t * tree)
+{
+    if(tree->top != NULL) mxmlDelete(tree->top);
+    free(tree->nodes);
+    free(tree->slots);
+    memset(tree, 0, sizeof(pd_tree_t));
+}
+
+//Pairs of matched nodes are compared on a stack instead of recursion since the projects can be very deep
+static int32_t tree_diff(pd_tree_t * a, pd_tree_t * b, diff_cb_t cb, void * user_data)
+{
+    uint32_t * stack = malloc(2 * PD_INIT_NODES * sizeof(uint32_t));
+    if(stack == NULL) return -1;
+    uint32_t stack_cap = PD_INIT_NODES;
+    stack[0] = 0;
+    stack[1] = 0;
+    uint32_t depth = 1;
+    int32_t changes = 0;
+    bool stop = false;          //Out of memory or stopped by `cb`
+
+    while(depth > 0 && !stop)
+    {
+        depth--;
+        uint32_t ia = stack[depth * 2];
+        uint32_t ib = stack[depth * 2 + 1];
+        pd_node_t * na = &a->nodes[ia];
+        pd_node_t * nb = &b->nodes[ib];
+        if(na->hash == nb->hash) continue;       //The whole subtree is the same
+
+        if(na->own != nb->own)
+        {
+            changes++;
+            stop = !cb(PROJDIFF_CHANGED, a, ia, b, ib, user_data);
+            if(stop) break;
+        }
+
+        if(!children_index(a, ia) || !children_index(b, ib))
+        {
+            stop = true;
+            break;
+        }
+        uint32_t c;
+        for(c = na->first_child; c != PD_NONE && !stop; c = a->nodes[c].next)
+        {
+            uint32_t m = child_find(b, ib, &a->nodes[c]);
+            if(m == PD_NONE)
+            {
+                changes++;
+                stop = !cb(PROJDIFF_REMOVED, a, c, b, PD_NONE, user_data);
+                continue;
+            }
+            if(a->nodes[c].hash == b->nodes[m].hash) continue;
+            if(depth == stack_cap)
+            {
+                uint32_t * s = realloc(stack, 2 * stack_cap * 2 * sizeof(uint32_t));
+                if(s == NULL)
+                {
+                    stop = true;
+                    break;
+                }
+                stack = s;
+                stack_cap *= 2;
+            }
+            stack[depth * 2] = c;
+            stack[depth * 2 + 1] = m;
+            depth++;
+        }
+
+        //The siblings are in preorder, so the matched ones keep their order while their indices grow
+        uint32_t last = 0;
+        bool added = false;
+        bool reordered = false;
+        for(c = nb->first_child; c != PD_NONE && !stop; c = b->nodes[c].next)
+        {
+            uint32_t m = child_find(a, ia, &b->nodes[c]);
+            if(m != PD_NONE)
+            {
+                if(added || m < last) reordered = true;
+                last = m;
+                continue;
+            }
+            changes++;
+            added = true;
+            stop = !cb(PROJDIFF_ADDED, a, PD_NONE, b, c, user_data);
+        }
+        if(reordered && !stop) stop = !cb(PROJDIFF_REORDERED, a, ia, b, ib, user_data);
+    }
+
+    free(stack);
+    return stop ? -1 : changes;
+}
+
+static bool print_cb(projdiff_op_t op, const pd_tree_t * a, uint32_t ia, const pd_tree_t * b, uint32_t ib,
+                     void * user_data)
+{
+    (void)user_data;
+    char path[PROJDIFF_PATH_MAX];
+    switch(op)
+    {
+        case PROJDIFF_CHANGED:
+            printf("~ %s\n", path_get(a, ia, path, sizeof(path)));
+            attrs_diff(a->nodes[ia].xml, b->nodes[ib].xml);
+            break;
+        case PROJDIFF_REMOVED:
+            printf("- %s <%s>\n", path_get(a, ia, path, sizeof(path)), mxmlGetElement(a->nodes[ia].xml));
+            break;
+        case PROJDIFF_ADDED:
+            printf("+ %s <%s>\n", path_get(b, ib, path, sizeof(path)), mxmlGetElement(b->nodes[ib].xml));
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+static bool trees_cb(projdiff_op_t op, const pd_tree_t * a, uint32_t ia, const pd_tree_t * b, uint32_t ib,
+                     void * user_data)
+{
+    trees_ctx_t * ctx = user_data;
+    return ctx->cb(op, ia != PD_NONE ? a->nodes[ia].xml : NULL, ib != PD_NONE ? b->nodes[ib].xml : NULL,
+                   ctx->user_data);
+}
+
+//Append an element as the last child of `parent`. Returns its index, PD_NONE if out of memory.
+static uint32_t node_add(pd_tree_t * tree, mxml_node_t * xml, uint32_t parent)
+{
+    if(tree->cnt == tree->cap)
+    {
+        uint32_t cap = tree->cap ? tree->cap * 2 : PD_INIT_NODES;
+        pd_node_t * p = realloc(tree->nodes, cap * sizeof(pd_node_t));
+        if(p == NULL) return PD_NONE;
+        tree->nodes = p;
+        tree->cap = cap;
+    }
+
+    uint32_t idx = tree->cnt++;
+    pd_node_t * n = &tree->nodes[idx];
+    memset(n, 0, sizeof(pd_node_t));
+    n->xml = xml;
+    n->id = parent != PD_NONE ? mxmlElementGetAttr(xml, "id") : NULL;
+    n->parent = parent;
+    n->first_child = n->last_child = n->next = PD_NONE;
+    n->own = own_hash(xml);
+    mxmlSetUserData(xml, (void *)(uintptr_t)idx);
+
+    if(parent != PD_NONE)
+    {
+        pd_node_t * p = &tree->nodes[parent];
+        if(n->id == NULL) n->ord = p->anon_cnt++;
+        if(p->last_child != PD_NONE) tree->nodes[p->last_child].next = idx;
+        else p->first_child = idx;
+        p->last_child = idx;
+    }
+    return idx;
+}
+
+//The attributes are summed, so their order in the file doesn't matter
+static uint64_t own_hash(mxml_node_t * xml)
+{
+    const char * tag = mxmlGetElement(xml);
+    uint64_t h = hash_bytes(HASH_INIT, tag, strlen(tag) + 1);
+    uint64_t sum = 0;
+    int i;
+    int cnt = mxmlElementGetAttrCount(xml);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        const char * value = mxmlElementGetAttrByIndex(xml, i, &name);
+        uint64_t a = hash_bytes(HASH_INIT, name, strlen(name) + 1);
+        sum += hash_bytes(a, value, strlen(value) + 1);
+    }
+    return hash_bytes(h, &sum, sizeof(sum));
+}
+
+//Put the children of a node into the table once. false if out of memory.
+static bool children_index(pd_tree_t * tree, uint32_t par)
+{
+    pd_node_t * p = &tree->nodes[par];
+    if(p->indexed) return true;
+
+    uint32_t c;
+    for(c = p->first_child; c != PD_NONE; c = tree->nodes[c].next)
+    {
+        if(tree->slot_used * 2 >= tree->slot_mask)
+        {
+            uint32_t new_mask = tree->slot_mask ? tree->slot_mask * 2 + 1 : PD_INIT_SLOTS - 1;
+            uint32_t * new_slots = calloc(new_mask + 1, sizeof(uint32_t));
+            if(new_slots == NULL) return false;
+            uint32_t i;
+            for(i = 0; tree->slots != NULL && i <= tree->slot_mask; i++)    //Rehash
+            {
+                if(tree->slots[i] == 0) continue;
+                const pd_node_t * n = &tree->nodes[tree->slots[i] - 1];
+                uint32_t j = key_hash(n->parent, n) & new_mask;
+                while(new_slots[j] != 0) j = (j + 1) & new_mask;
+                new_slots[j] = tree->slots[i];
+            }
+            free(tree->slots);
+            tree->slots = new_slots;
+            tree->slot_mask = new_mask;
+        }
+
+        //A duplicated key isn't added, the widget is seen as added or removed
+        if(child_find(tree, par, &tree->nodes[c]) != PD_NONE) continue;
+        uint32_t j = key_hash(par, &tree->nodes[c]) & tree->slot_mask;
+        while(tree->slots[j] != 0) j = (j + 1) & tree->slot_mask;
+        tree->slots[j] = c + 1;
+        tree->slot_used++;
+    }
+    tree->nodes[par].indexed = 1;
+    return true;
+}
+
+//The child of `par` with the key of `key` (a node of any tree). PD_NONE if there is none.
+static uint32_t child_find(pd_tree_t * tree, uint32_t par, const pd_node_t * key)
+{
+    if(tree->slots == NULL) return PD_NONE;
+    uint32_t j = key_hash(par, key) & tree->slot_mask;
+    while(tree->slots[j] != 0)
+    {
+        const pd_node_t * n = &tree->nodes[tree->slots[j] - 1];
+        if(n->parent == par && key_eq(n, key)) return tree->slots[j] - 1;
+        j = (j + 1) & tree->slot_mask;
+    }
+    return PD_NONE;
+}
+
+static uint64_t key_hash(uint32_t par, const pd_node_t * key)
+{
+    uint64_t h = hash_bytes(HASH_INIT, &par, sizeof(par));
+    if(key->id != NULL) return hash_bytes(h, key->id, strlen(key->id));
+    return hash_bytes(h, &key->ord, sizeof(key->ord)) ^ 1;      //Not to collide with an ID
+}
+
+static bool key_eq(const pd_node_t * a, const pd_node_t * b)
+{
+    if(a->id == NULL || b->id == NULL) return a->id == b->id && a->ord == b->ord;
+    return !strcmp(a->id, b->id);
+}
+
+//The IDs from the screen down to a node, e.g. `/main/card/btn_ok`. Shortened at the start if it's too long.
+static const char * path_get(const pd_tree_t * tree, uint32_t idx, char * buf, size_t size)
+{
+    size_t pos = size - 1;
+    buf[pos] = '\0';
+    for(; idx != 0 && idx != PD_NONE; idx = tree->nodes[idx].parent)
+    {
+        const pd_node_t * n = &tree->nodes[idx];
+        char ord[16];
+        const char * seg = n->id;
+        if(seg == NULL)
+        {
+            snprintf(ord, sizeof(ord), "#%u", (unsigned)n->ord);
+            seg = ord;
+        }
+        size_t len = strlen(seg);
+        if(len + 1 + 3 > pos)
+        {
+            pos -= 3;
+            memcpy(&buf[pos], "...", 3);
+            break;
+        }
+        pos -= len;
+        memcpy(&buf[pos], seg, len);
+        buf[--pos] = '/';
+    }
+    return &buf[pos];
+}
+
+static void attrs_diff(mxml_node_t * a, mxml_node_t * b)
+{
+    if(strcmp(mxmlGetElement(a), mxmlGetElement(b)))
+    {
+        printf("    <%s> -> <%s>\n", mxmlGetElement(a), mxmlGetElement(b));
+    }
+
+    int i;
+    int cnt = mxmlElementGetAttrCount(a);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        const char * va = mxmlElementGetAttrByIndex(a, i, &name);
+        const char * vb = mxmlElementGetAttr(b, name);
+        if(vb == NULL) printf("    -%s=\"%s\"\n", name, va);
+        else if(strcmp(va, vb)) printf("    %s: \"%s\" -> \"%s\"\n", name, va, vb);
+    }
+    cnt = mxmlElementGetAttrCount(b);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        const char * vb = mxmlElementGetAttrByIndex(b, i, &name);
+        if(mxmlElementGetAttr(a, name) == NULL) printf("    +%s=\"%s\"\n", name, vb);
+    }
+}
+
+//Start merging the children of a node. The frames of the ancestors may move.
+static bool merge_push(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t)
+{
+    if(ctx->depth == ctx->cap)
+    {
+        uint32_t cap = ctx->cap ? ctx->cap * 2 : 64;
+        merge_frame_t * s = realloc(ctx->stack, cap * sizeof(merge_frame_t));
+        if(s == NULL)
+        {
+            ctx->oom = true;
+            return false;
+        }
+        ctx->stack = s;
+        ctx->cap = cap;
+    }
+    merge_frame_t * f = &ctx->stack[ctx->depth++];
+    f->b = b;
+    f->o = o;
+    f->t = t;
+    f->o_child = ctx->ours->nodes[o].first_child;
+    f->t_child = ctx->theirs->nodes[t].first_child;
+    return true;
+}
+
+//Merge a node which is in ours and theirs. Its children are merged by the frame it pushes.
+static void merge_node(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t)
+{
+    const pd_node_t * no = &ctx->ours->nodes[o];
+    const pd_node_t * nt = &ctx->theirs->nodes[t];
+    const pd_node_t * nb = b != PD_NONE ? &ctx->base->nodes[b] : NULL;
+    if(no->hash == nt->hash || (nb != NULL && nt->hash == nb->hash))
+    {
+        subtree_write(&ctx->xs, ctx->ours, o);
+        return;
+    }
+    if(nb != NULL && no->hash == nb->hash)
+    {
+        subtree_write(&ctx->xs, ctx->theirs, t);
+        return;
+    }
+
+    //Both changed it or both added it differently
+    if(strcmp(mxmlGetElement(no->xml), mxmlGetElement(nt->xml)))
+    {
+        merge_conflict(ctx, ctx->ours, o, "the type was changed by both");
+    }
+    xmlstream_begin(&ctx->xs, mxmlGetElement(no->xml));
+    merge_attrs(ctx, b, o, t);
+    merge_push(ctx, b, o, t);
+}
+
+//Take every attribute from the side which changed it
+static void merge_attrs(merge_ctx_t * ctx, uint32_t b, uint32_t o, uint32_t t)
+{
+    mxml_node_t * xb = b != PD_NONE ? ctx->base->nodes[b].xml : NULL;
+    mxml_node_t * xo = ctx->ours->nodes[o].xml;
+    mxml_node_t * xt = ctx->theirs->nodes[t].xml;
+    mxml_node_t * sides[3] = {xo, xt, xb};
+
+    //Every name once: the ones of ours, then the ones only theirs or only the base has
+    uint8_t s;
+    for(s = 0; s < 3; s++)
+    {
+        if(sides[s] == NULL) continue;
+        int i;
+        int cnt = mxmlElementGetAttrCount(sides[s]);
+        for(i = 0; i < cnt; i++)
+        {
+            const char * name;
+            mxmlElementGetAttrByIndex(sides[s], i, &name);
+            if(s >= 1 && mxmlElementGetAttr(xo, name) != NULL) continue;
+            if(s == 2 && mxmlElementGetAttr(xt, name) != NULL) continue;
+
+            const char * vo = mxmlElementGetAttr(xo, name);
+            const char * vt = mxmlElementGetAttr(xt, name);
+            const char * vb = xb != NULL ? mxmlElementGetAttr(xb, name) : NULL;
+            const char * v = vo;
+            if(str_eq(vo, vb)) v = vt;
+            else if(!str_eq(vt, vb) && !str_eq(vo, vt))
+            {
+                char what[64];
+                snprintf(what, sizeof(what), "`%s` was changed by both", name);
+                merge_conflict(ctx, ctx->ours, o, what);
+            }
+            if(v != NULL) xmlstream_attr(&ctx->xs, name, v);
+        }
+    }
+}
+
+static void merge_conflict(merge_ctx_t * ctx, const pd_tree_t * tree, uint32_t idx, const char * what)
+{
+    char path[PROJDIFF_PATH_MAX];
+    ctx->conflicts++;
+    printf("Conflict: %s: %s, ours is kept\n", path_get(tree, idx, path, sizeof(path)), what);
+}
+
+static void subtree_write(xmlstream_t * xs, const pd_tree_t * tree, uint32_t root)
+{
+    uint32_t idx = root;
+    while(1)
+    {
+        const pd_node_t * n = &tree->nodes[idx];
+        xmlstream_begin(xs, mxmlGetElement(n->xml));
+        attrs_write(xs, n->xml);
+        if(n->first_child != PD_NONE)
+        {
+            idx = n->first_child;
+            continue;
+        }
+
+        while(1)        //End the element and the ancestors which have no more children
+        {
+            xmlstream_end(xs);
+            if(idx == root) return;
+            if(tree->nodes[idx].next != PD_NONE)
+            {
+                idx = tree->nodes[idx].next;
+                break;
+            }
+            idx = tree->nodes[idx].parent;
+        }
+    }
+}
+
+static void attrs_write(xmlstream_t * xs, mxml_node_t * xml)
+{
+    int i;
+    int cnt = mxmlElementGetAttrCount(xml);
+    for(i = 0; i < cnt; i++)
+    {
+        const char * name;
+        const char * value = mxmlElementGetAttrByIndex(xml, i, &name);
+        xmlstream_attr(xs, name, value);
+    }
+}
+
+static bool str_eq(const char * a, const char * b)
+{
+    if(a == NULL || b == NULL) return a == b;
+    return !strcmp(a, b);
+}
+
+static uint64_t hash_bytes(uint64_t h, const void * data, size_t size)
+{
+    const uint8_t * d = data;
+    size_t i;
+    for(i = 0; i < size; i++)
+    {
+        h ^= d[i];
+        h *= HASH_PRIME;
+    }
+    return h;
+}
+
+//The content of a widget of the document, what is saved of it
+static uint64_t doc_own_hash(doc_id_t id)
+{
+    lv_obj_t * obj = doc_get(id)->obj;
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return 0;
+
+    uint64_t h = hash_bytes(HASH_INIT, &info->type, sizeof(info->type));
+    h = hash_bytes(h, info->id, strlen(info->id));
+    lv_coord_t geom[4] = {lv_obj_get_x(obj), lv_obj_get_y(obj), lv_obj_get_width(obj), lv_obj_get_height(obj)};
+    h = hash_bytes(h, geom, sizeof(geom));
+
+    const char * text = widgetreg_text_get(obj, info->type);
+    if(text != NULL) h = hash_bytes(h, text, strlen(text) + 1);
+    widgetreg_val_t vals[WIDGETREG_VAL_MAX];
+    uint8_t cnt = widgetreg_vals_get(obj, info->type, vals);
+    uint8_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        h = hash_bytes(h, &vals[i].attr, sizeof(vals[i].attr));
+        h = hash_bytes(h, &vals[i].value, sizeof(vals[i].value));
+    }
+
+    //Equal styles are interned into one by their bytes, so the bytes tell them apart the same way
+    const lv_style_t * style = lv_obj_get_style(obj);
+    if(style != NULL) h = hash_bytes(h, style, sizeof(lv_style_t));
+    return h;
+}
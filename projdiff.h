@@ -0,0 +1,70 @@
+/**
+ * @file projdiff.h
+ *
+ */
+
+#ifndef _PROJDIFF_H_
+#define _PROJDIFF_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROJDIFF_PATH_MAX       256     //Longer paths of the changed widgets are printed shortened
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    PROJDIFF_CHANGED,           //The tag or the attributes of an element
+    PROJDIFF_REMOVED,           //An element with its subtree, only the old one is set
+    PROJDIFF_ADDED,             //An element with its subtree, only the new one is set
+    PROJDIFF_REORDERED,         //The children of the element were reordered or one was added before an other
+}projdiff_op_t;
+
+typedef struct _projdiff_tree_t projdiff_tree_t;
+
+//`old_xml` and `new_xml` are the elements (mxml_node_t *) of the two trees, NULL where there's none.
+//Return false to stop the walk.
+typedef bool (*projdiff_cb_t)(projdiff_op_t op, void * old_xml, void * new_xml, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+int32_t projdiff_files(const char * path_a, const char * path_b);
+int32_t projdiff_merge(const char * base, const char * ours, const char * theirs, const char * out);
+projdiff_tree_t * projdiff_tree_load(const char * path);
+void projdiff_tree_del(projdiff_tree_t * tree);
+int32_t projdiff_trees(projdiff_tree_t * a, projdiff_tree_t * b, projdiff_cb_t cb, void * user_data);
+uint64_t projdiff_doc_hash(doc_id_t id);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,497 @@
+/**
+ * @projjob .c
+ * Save, load and code generation on a worker thread, so the designer keeps drawing and taking input.
+ * Saving and code generation write a snapshot: the UI thread copies the few fields of the nodes
+ * the writers need, so the worker never touches the widgets while the user keeps editing.
+ * Loading goes the other way: the worker parses the file and the UI thread creates the widgets
+ * in steps. The worker reports progress and completion with lv_async_post().
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "projjob.h"
+#include "saveproj.h"
+#include "loadproj.h"
+#include "gencode.h"
+#include "widgetreg.h"
+#include "stylepool.h"
+#include "undo.h"
+#include "screens.h"
+#include "bake.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROGRESS_STEPS      100     //A job reports its progress at most this many times
+#define POST_RETRY_DELAY    1000    //[us] to wait for free space in the full lv_async queue
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    projjob_kind_t kind;
+    projsnap_t snap;            //Save and code generation
+    loadproj_job_t load;        //Load
+    lv_obj_t * tft_win;
+    bool ok;
+}projjob_t;
+
+//Passed from the worker to the UI thread
+typedef struct
+{
+    projjob_t * job;
+    uint32_t done;
+    uint32_t total;
+    bool finished;
+}projjob_msg_t;
+
+typedef struct
+{
+    projsnap_t * snap;
+    uint32_t cur;               //The node being visited, the parent of the next one
+    uint32_t depth;
+    uint32_t style_size;        //Allocated in `snap->styles`
+    const lv_style_t ** shared_keys;    //The interned styles already in `snap->styles`, open addressing
+    uint32_t * shared_idx;              //Their index in `snap->styles`
+    uint32_t shared_mask;
+    bool oom;                   //A text couldn't be copied
+}snap_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool job_start(projjob_t * job);
+static void job_run(projjob_t * job);
+static void job_ran(projjob_t * job);
+static void job_finish(projjob_t * job);
+static void * worker_main(void * param);
+static void worker_step_cb(uint32_t done, uint32_t total);
+static void msg_post(projjob_t * job, uint32_t done, uint32_t total, bool finished);
+static void msg_cb(void * user_data);
+static void load_task(lv_task_t * task);
+static bool snap_enter_cb(doc_id_t id, void * user_data);
+static bool snap_leave_cb(doc_id_t id, void * user_data);
+static uint32_t snap_style_add(snap_ctx_t * ctx, const lv_obj_t * obj);
+static uint32_t * snap_shared_find(snap_ctx_t * ctx, const lv_style_t * style);
+static bool style_is_default(const lv_style_t * style);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static projjob_t * job_act = NULL;      //Only one job runs at a time. Used only on the UI thread
+static projjob_progress_cb_t job_progress_cb = NULL;
+static projjob_done_cb_t job_done_cb = NULL;
+
+static projjob_t * worker_job = NULL;   //Used only by the worker
+static uint32_t worker_reported = 0;
+static pthread_mutex_t cache_mutex = PTHREAD_MUTEX_INITIALIZER;    //One worker writes the warm-start cache at a time
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Copy a subtree for the writers. An empty snapshot for DOC_NONE.
+bool projsnap_take(projsnap_t * snap, doc_id_t root)
+{
+    snap->nodes = NULL;
+    snap->cnt = 0;
+    snap->styles = NULL;
+    snap->style_cnt = 0;
+    snap->screen_cnt = 0;
+    snap->bakes = NULL;
+    snap->bake_cnt = 0;
+    if(doc_get(root) == NULL || root == DOC_ROOT) return true;
+
+    lv_obj_layout_flush();      //The containers' sizes are refreshed only before the next frame
+
+    snap_ctx_t ctx;
+    ctx.snap = snap;
+    ctx.cur = PROJSNAP_NO_PARENT;
+    ctx.depth = 0;
+    ctx.style_size = 0;
+    ctx.oom = false;
+    //A subtree can't have more nodes than the document
+    snap->nodes = malloc((doc_get_count() + 1) * sizeof(projsnap_node_t));
+    if(snap->nodes == NULL) return false;
+
+    //Without memory for the table every customized node gets its own copy
+    stylepool_stat_t pool_stat;
+    stylepool_get_stat(&pool_stat);
+    ctx.shared_mask = 15;
+    while(ctx.shared_mask < pool_stat.cnt * 2) ctx.shared_mask = ctx.shared_mask * 2 + 1;
+    ctx.shared_keys = calloc(ctx.shared_mask + 1, sizeof(const lv_style_t *));
+    ctx.shared_idx = malloc((ctx.shared_mask + 1) * sizeof(uint32_t));
+
+    doc_traverse(root, snap_enter_cb, snap_leave_cb, &ctx);
+    free(ctx.shared_keys);
+    free(ctx.shared_idx);
+    snap->screen_cnt = 1;
+    if(ctx.oom)
+    {
+        projsnap_free(snap);    //The writers would lose the texts
+        return false;
+    }
+    return true;
+}
+
+//Add the roots of `src` after the ones of `snap`, e.g. the screens of a project. `src` is copied.
+bool projsnap_append(projsnap_t * snap, const projsnap_t * src)
+{
+    if(src->cnt == 0) return true;
+
+    projsnap_node_t * nodes = realloc(snap->nodes, (snap->cnt + src->cnt) * sizeof(projsnap_node_t));
+    if(nodes == NULL) return false;
+    snap->nodes = nodes;
+    if(src->style_cnt > 0)
+    {
+        lv_style_t * styles = realloc(snap->styles, (snap->style_cnt + src->style_cnt) * sizeof(lv_style_t));
+        if(styles == NULL) return false;
+        snap->styles = styles;
+        memcpy(&styles[snap->style_cnt], src->styles, src->style_cnt * sizeof(lv_style_t));
+    }
+
+    uint32_t i;
+    bool res = true;
+    for(i = 0; i < src->cnt; i++)
+    {
+        projsnap_node_t * n = &nodes[snap->cnt + i];
+        *n = src->nodes[i];
+        if(n->parent != PROJSNAP_NO_PARENT) n->parent += snap->cnt;
+        if(n->style != PROJSNAP_NO_STYLE) n->style += snap->style_cnt;
+        if(n->text != NULL && (n->text = strdup(n->text)) == NULL) res = false;
+    }
+    snap->cnt += src->cnt;
+    snap->style_cnt += src->style_cnt;
+    snap->screen_cnt += src->screen_cnt;
+    return res;         //The nodes are added anyway, so `projsnap_free` frees them
+}
+
+void projsnap_free(projsnap_t * snap)
+{
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++) free(snap->nodes[i].text);
+    for(i = 0; i < snap->bake_cnt; i++) imgasset_data_free(&snap->bakes[i].img);
+    free(snap->nodes);
+    free(snap->styles);
+    free(snap->bakes);
+    snap->nodes = NULL;
+    snap->cnt = 0;
+    snap->styles = NULL;
+    snap->style_cnt = 0;
+    snap->screen_cnt = 0;
+    snap->bakes = NULL;
+    snap->bake_cnt = 0;
+}
+
+//The callbacks are called on the UI thread
+void projjob_set_cb(projjob_progress_cb_t progress_cb, projjob_done_cb_t done_cb)
+{
+    job_progress_cb = progress_cb;
+    job_done_cb = done_cb;
+}
+
+bool projjob_save(void)
+{
+    if(job_act != NULL) return false;
+
+    if(doc_get_screen() == DOC_NONE) return false;
+
+    projjob_t * job = calloc(1, sizeof(projjob_t));
+    if(job == NULL) return false;
+    job->kind = PROJJOB_SAVE;
+    if(!screens_snap_take(&job->snap))
+    {
+        free(job);
+        return false;
+    }
+    return job_start(job);
+}
+
+bool projjob_codegen(void)
+{
+    if(job_act != NULL) return false;
+
+    projjob_t * job = calloc(1, sizeof(projjob_t));
+    if(job == NULL) return false;
+    job->kind = PROJJOB_CODEGEN;
+    if(!screens_snap_take(&job->snap))
+    {
+        free(job);
+        return false;
+    }
+    bake_capture(&job->snap);       //Draws with the widgets
+    return job_start(job);
+}
+
+bool projjob_load(lv_obj_t * tft_win)
+{
+    if(job_act != NULL) return false;
+
+    //The binary project (or the warm-start cache) is mapped, not parsed, creating its widgets is all the work
+    //and it needs the UI thread
+    if(!load_project_has_manifest() && (load_project_bin_is_newer() || load_project_cache_is_valid()))
+    {
+        load_project(tft_win);
+        if(job_done_cb != NULL) job_done_cb(PROJJOB_LOAD, true);
+        return true;
+    }
+
+    projjob_t * job = calloc(1, sizeof(projjob_t));
+    if(job == NULL) return false;
+    undo_clear();       //Loading isn't an undo step
+    job->kind = PROJJOB_LOAD;
+    job->tft_win = tft_win;
+    return job_start(job);
+}
+
+bool projjob_is_busy(void)
+{
+    return job_act != NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static bool job_start(projjob_t * job)
+{
+    job_act = job;
+
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int res = pthread_create(&thread, &attr, worker_main, job);
+    pthread_attr_destroy(&attr);
+
+    //Without a thread do the job here
+    if(res != 0)
+    {
+        job_run(job);
+        job_ran(job);
+    }
+    return true;
+}
+
+static void job_run(projjob_t * job)
+{
+    worker_job = job;
+    worker_reported = 0;
+
+    switch(job->kind)
+    {
+        case PROJJOB_SAVE:
+            job->ok = save_project_snap(&job->snap, worker_step_cb);
+            break;
+        case PROJJOB_CODEGEN:
+            job->ok = code_generation_snap(&job->snap, worker_step_cb);
+            break;
+        case PROJJOB_LOAD:
+            job->ok = load_project_parse(&job->load, job->tft_win);
+            break;
+    }
+}
+
+//Back on the UI thread after job_run()
+static void job_ran(projjob_t * job)
+{
+    if(job->kind == PROJJOB_LOAD && job->ok)
+    {
+        //Parsed, create the widgets in steps and let the display refresh between them
+        lv_task_create(load_task, PROJJOB_LOAD_PERIOD, LV_TASK_PRIO_MID, job);
+    }else
+    {
+        job_finish(job);
+    }
+}
+
+static void job_finish(projjob_t * job)
+{
+    job_act = NULL;
+    if(job_done_cb != NULL) job_done_cb(job->kind, job->ok);
+
+    projsnap_free(&job->snap);
+    load_project_job_free(&job->load);
+    free(job);
+}
+
+static void * worker_main(void * param)
+{
+    projjob_t * job = param;
+    job_run(job);
+    bool cache_write = job->kind == PROJJOB_LOAD && job->ok && !load_project_has_manifest();
+    msg_post(job, 0, 0, true);      //The job belongs to the UI thread again
+
+    //While the UI thread creates the widgets compile the XML for the next load of the same project.
+    //An other worker is already doing it if it's locked.
+    if(cache_write && pthread_mutex_trylock(&cache_mutex) == 0)
+    {
+        if(!load_project_cache_write()) printf("Can't write %s\n", LOADPROJ_CACHE_FILE);
+        pthread_mutex_unlock(&cache_mutex);
+    }
+    return NULL;
+}
+
+static void worker_step_cb(uint32_t done, uint32_t total)
+{
+    uint32_t step = (uint64_t)done * PROGRESS_STEPS / total;
+    if(step == worker_reported) return;
+    worker_reported = step;
+    msg_post(worker_job, done, total, false);
+}
+
+//Progress can be dropped if the queue is full, the completion is retried
+static void msg_post(projjob_t * job, uint32_t done, uint32_t total, bool finished)
+{
+    while(1)
+    {
+        projjob_msg_t * msg = malloc(sizeof(projjob_msg_t));
+        if(msg != NULL)
+        {
+            msg->job = job;
+            msg->done = done;
+            msg->total = total;
+            msg->finished = finished;
+            if(lv_async_post(msg_cb, msg) == LV_RES_OK) return;
+            free(msg);
+        }
+        if(!finished) return;
+        usleep(POST_RETRY_DELAY);
+    }
+}
+
+static void msg_cb(void * user_data)
+{
+    projjob_msg_t * msg = user_data;
+    projjob_t * job = msg->job;
+
+    if(!msg->finished)
+    {
+        if(job_progress_cb != NULL) job_progress_cb(job->kind, msg->done, msg->total);
+    }else
+    {
+        job_ran(job);
+    }
+    free(msg);
+}
+
+static void load_task(lv_task_t * task)
+{
+    projjob_t * job = task->user_data;
+
+    bool finished = load_project_step(&job->load, PROJJOB_LOAD_BUDGET);
+    if(job_progress_cb != NULL) job_progress_cb(PROJJOB_LOAD, job->load.done, job->load.total);
+    if(!finished) return;
+
+    lv_task_del(task);
+    job_finish(job);
+}
+
+static bool snap_enter_cb(doc_id_t id, void * user_data)
+{
+    snap_ctx_t * ctx = user_data;
+    lv_obj_t * obj = doc_get(id)->obj;
+    widget_info_t * info = widget_get_info(obj);
+    projsnap_node_t * n = &ctx->snap->nodes[ctx->snap->cnt];
+    n->type = info->type;
+    n->parent = ctx->cur;
+    n->depth = ctx->depth;
+    strncpy(n->id, info->id, PROJSNAP_ID_MAX - 1);
+    n->id[PROJSNAP_ID_MAX - 1] = '\0';
+    n->x = lv_obj_get_x(obj);
+    n->y = lv_obj_get_y(obj);
+    n->w = lv_obj_get_width(obj);
+    n->h = lv_obj_get_height(obj);
+    n->style = snap_style_add(ctx, obj);
+    const char * text = widgetreg_text_get(obj, info->type);
+    n->text = text != NULL && text[0] != '\0' ? strdup(text) : NULL;
+    if(text != NULL && text[0] != '\0' && n->text == NULL) ctx->oom = true;
+    n->font = lv_obj_get_style(obj)->text.font;
+    n->val_cnt = widgetreg_vals_get(obj, info->type, n->vals);
+    n->uid = doc_get(id)->uid;
+
+    ctx->cur = ctx->snap->cnt++;
+    ctx->depth++;
+    return true;
+}
+
+static bool snap_leave_cb(doc_id_t id, void * user_data)
+{
+    (void)id;
+    snap_ctx_t * ctx = user_data;
+    ctx->cur = ctx->snap->nodes[ctx->cur].parent;
+    ctx->depth--;
+    return true;
+}
+
+//Only the main style, and only if it's not what the widget gets anyway from the theme or the built-in styles.
+//The widgets sharing an interned style share its copy too.
+static uint32_t snap_style_add(snap_ctx_t * ctx, const lv_obj_t * obj)
+{
+    if(obj->style_p == NULL || style_is_default(obj->style_p)) return PROJSNAP_NO_STYLE;
+
+    uint32_t * shared = stylepool_is_interned(obj->style_p) ? snap_shared_find(ctx, obj->style_p) : NULL;
+    if(shared != NULL && *shared != PROJSNAP_NO_STYLE) return *shared;
+
+    projsnap_t * snap = ctx->snap;
+    if(snap->style_cnt == ctx->style_size)
+    {
+        uint32_t size = ctx->style_size == 0 ? 8 : ctx->style_size * 2;
+        lv_style_t * styles = realloc(snap->styles, size * sizeof(lv_style_t));
+        if(styles == NULL) return PROJSNAP_NO_STYLE;    //Generated with the theme's style then
+        snap->styles = styles;
+        ctx->style_size = size;
+    }
+
+    memcpy(&snap->styles[snap->style_cnt], obj->style_p, sizeof(lv_style_t));
+    if(shared != NULL) *shared = snap->style_cnt;
+    return snap->style_cnt++;
+}
+
+//The slot of an interned style's index in `snap->styles`, PROJSNAP_NO_STYLE in it if it's not copied yet.
+//NULL if there is no table.
+static uint32_t * snap_shared_find(snap_ctx_t * ctx, const lv_style_t * style)
+{
+    if(ctx->shared_keys == NULL || ctx->shared_idx == NULL) return NULL;
+
+    //There are at most half as many interned styles as slots, so there is always an empty one
+    uint32_t i = ((uint32_t)((uintptr_t)style >> 3) * 2654435761u) & ctx->shared_mask;
+    while(ctx->shared_keys[i] != NULL && ctx->shared_keys[i] != style) i = (i + 1) & ctx->shared_mask;
+    if(ctx->shared_keys[i] == NULL)
+    {
+        ctx->shared_keys[i] = style;
+        ctx->shared_idx[i] = PROJSNAP_NO_STYLE;
+    }
+    return &ctx->shared_idx[i];
+}
+
+static bool style_is_default(const lv_style_t * style)
+{
+    static const lv_style_t * builtin[] = {
+        &lv_style_scr, &lv_style_transp, &lv_style_transp_fit, &lv_style_transp_tight,
+        &lv_style_plain, &lv_style_plain_color, &lv_style_pretty, &lv_style_pretty_color,
+        &lv_style_btn_rel, &lv_style_btn_pr, &lv_style_btn_tgl_rel, &lv_style_btn_tgl_pr, &lv_style_btn_ina,
+    };
+
+    uint32_t i;
+    for(i = 0; i < sizeof(builtin) / sizeof(builtin[0]); i++)
+    {
+        if(style == builtin[i]) return true;
+    }
+
+    //The theme's styles are a struct of pointers only
+    lv_theme_t * th = lv_theme_get_current();
+    if(th == NULL) return false;
+    lv_style_t ** th_styles = (lv_style_t **)&th->style;
+    for(i = 0; i < sizeof(th->style) / sizeof(lv_style_t *); i++)
+    {
+        if(style == th_styles[i]) return true;
+    }
+    return false;
+}
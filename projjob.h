@@ -0,0 +1,120 @@
+/**
+ * @file projjob.h
+ *
+ */
+
+#ifndef _PROJJOB_H_
+#define _PROJJOB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include "dataset.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "imgasset.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROJSNAP_NO_PARENT      0xFFFFFFFF
+#define PROJSNAP_ID_MAX         sizeof(((widget_info_t *)0)->id)
+#define PROJSNAP_NO_STYLE       0xFFFFFFFF
+#define PROJJOB_LOAD_BUDGET     10      //[ms] of creating widgets in one run of the load task
+#define PROJJOB_LOAD_PERIOD     5       //[ms] between the runs, the display is refreshed in the meantime
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    widget_type_t type;
+    uint32_t parent;            //Index in the snapshot, PROJSNAP_NO_PARENT for the root
+    uint32_t depth;             //The root is 0
+    char id[PROJSNAP_ID_MAX];
+    lv_coord_t x, y, w, h;
+    uint32_t style;             //Index in `styles` if the main style was customized, else PROJSNAP_NO_STYLE
+    char * text;                //A copy of the text it shows, NULL if none
+    const lv_font_t * font;     //The text is drawn with this
+    widgetreg_val_t vals[WIDGETREG_VAL_MAX];    //Its numeric attributes, the default ones too
+    uint8_t val_cnt;
+    uint32_t uid;               //Of its document node, for the autosave journal
+}projsnap_node_t;
+
+//A subtree drawn by the designer, the generated code shows it as this image instead of creating its widgets
+typedef struct
+{
+    uint32_t node;              //Index of its root in the snapshot
+    lv_coord_t x, y;            //Of the image in the root's parent, it has the root's shadow too
+    imgasset_data_t img;        //In the colours of the target
+    uint32_t draw_us;           //[us] the designer took to draw the subtree
+    uint32_t img_draw_us;       //[us] the same with the image instead
+}projsnap_bake_t;
+
+//Everything the writers need from a subtree, so they can run without touching the widgets
+typedef struct
+{
+    projsnap_node_t * nodes;    //Preorder
+    uint32_t cnt;
+    lv_style_t * styles;        //Copies of the customized main styles, the interned ones once
+    uint32_t style_cnt;
+    uint32_t screen_cnt;        //Roots (depth 0), a snapshot of a subtree has one
+    projsnap_bake_t * bakes;    //In preorder of their roots, see `bake_capture`
+    uint32_t bake_cnt;
+}projsnap_t;
+
+typedef enum
+{
+    PROJJOB_SAVE,
+    PROJJOB_LOAD,
+    PROJJOB_CODEGEN,
+}projjob_kind_t;
+
+/**
+ * Progress of a writer, called on the thread running it
+ * @param done nodes written
+ * @param total nodes in the snapshot
+ */
+typedef void (*projsnap_step_cb_t)(uint32_t done, uint32_t total);
+
+//Called on the UI thread
+typedef void (*projjob_progress_cb_t)(projjob_kind_t kind, uint32_t done, uint32_t total);
+typedef void (*projjob_done_cb_t)(projjob_kind_t kind, bool ok);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool projsnap_take(projsnap_t * snap, doc_id_t root);
+bool projsnap_append(projsnap_t * snap, const projsnap_t * src);
+void projsnap_free(projsnap_t * snap);
+
+void projjob_set_cb(projjob_progress_cb_t progress_cb, projjob_done_cb_t done_cb);
+bool projjob_save(void);
+bool projjob_codegen(void);
+bool projjob_load(lv_obj_t * tft_win);
+bool projjob_is_busy(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
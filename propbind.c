@@ -0,0 +1,237 @@
+/**
+ * @file propbind.c
+ * The properties of the selected (watched) widget for the fields showing them.
+ * Every property has a version which is bumped when it's changed. The subscribed fields are updated by a task
+ * at most once a frame, and only if the version of their property moved and its value differs from the shown one.
+ * The fields change the widget only through `propbind_set`.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include "propbind.h"
+#include "dataset.h"
+#include "stylepool.h"
+#include "autosave.h"
+#include "undo.h"
+#include "ttfont.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    prop_t prop;
+    prop_show_cb_t cb;
+    void * user_data;
+    uint32_t shown_ver;         //The version of `prop` when it was shown
+    int32_t shown_value;
+    bool valid;                 //false: show it in any case
+}propbind_sub_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static lv_obj_t * watched_obj(void);
+static void sync_task(lv_task_t * task);
+static void radius_edit_cb(lv_style_t * style, void * user_data);
+static void font_edit_cb(lv_style_t * style, void * user_data);
+static const lv_font_t * font_size_get(lv_obj_t * obj, int32_t px);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static propbind_sub_t subs[PROPBIND_SUB_MAX];
+static uint8_t sub_cnt = 0;
+static doc_id_t watched = DOC_NONE;
+static uint32_t watched_uid;            //The node IDs are reused
+static uint32_t prop_ver[_PROP_NUM];    //Of the watched widget's properties
+static bool dirty = false;              //A field might be out of date
+static lv_task_t * sync_task_p = NULL;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Call `cb` with the value of `prop` of the watched widget whenever it changes. false: too many subscribers.
+bool propbind_subscribe(prop_t prop, prop_show_cb_t cb, void * user_data)
+{
+    if(sub_cnt >= PROPBIND_SUB_MAX || prop >= _PROP_NUM) return false;
+    if(sync_task_p == NULL)
+    {
+        sync_task_p = lv_task_create(sync_task, PROPBIND_PERIOD, LV_TASK_PRIO_MID, NULL);
+        if(sync_task_p == NULL) return false;
+    }
+
+    propbind_sub_t * s = &subs[sub_cnt++];
+    s->prop = prop;
+    s->cb = cb;
+    s->user_data = user_data;
+    s->valid = false;
+    dirty = true;
+    return true;
+}
+
+//Show the properties of this widget in the fields. DOC_NONE: none, the fields keep the last values.
+void propbind_watch(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    watched = n != NULL ? node : DOC_NONE;
+    watched_uid = n != NULL ? n->uid : 0;
+    propbind_resend(PROP_ALL);
+}
+
+//Tell that a property of a widget has changed, e.g. by dragging or undo. PROP_ALL: anything could.
+//Cheap for the not watched widgets, so it can be called for every change.
+void propbind_changed(lv_obj_t * obj, prop_t prop)
+{
+    if(obj == NULL || obj != watched_obj()) return;
+
+    if(prop == PROP_ALL)
+    {
+        uint8_t i;
+        for(i = 0; i < _PROP_NUM; i++) prop_ver[i]++;
+    }else
+    {
+        prop_ver[prop]++;
+    }
+    dirty = true;
+}
+
+//Show the value of `prop` again even if it hasn't changed, e.g. to replace an invalid input. PROP_ALL: every field.
+void propbind_resend(prop_t prop)
+{
+    uint8_t i;
+    for(i = 0; i < sub_cnt; i++)
+    {
+        if(prop == PROP_ALL || subs[i].prop == prop) subs[i].valid = false;
+    }
+    dirty = true;
+}
+
+int32_t propbind_get(lv_obj_t * obj, prop_t prop)
+{
+    switch(prop)
+    {
+        case PROP_X: return lv_obj_get_x(obj);
+        case PROP_Y: return lv_obj_get_y(obj);
+        case PROP_W: return lv_obj_get_width(obj);
+        case PROP_H: return lv_obj_get_height(obj);
+        case PROP_RADIUS: return lv_obj_get_style(obj)->body.radius;
+        case PROP_FONT_SIZE:
+        {
+            uint16_t px;
+            return ttfont_get_info(lv_obj_get_style(obj)->text.font, NULL, &px) ? px : 0;
+        }
+        default: return 0;
+    }
+}
+
+//Change a property of a widget as one undo step. false if the value is invalid for it or out of memory.
+//The ID can't be set here, see `widgetid_rename`.
+bool propbind_set(lv_obj_t * obj, prop_t prop, int32_t value)
+{
+    bool valid;
+    switch(prop)
+    {
+        case PROP_X:
+        case PROP_Y: valid = value >= LV_COORD_MIN && value <= LV_COORD_MAX; break;
+        case PROP_W:
+        case PROP_H: valid = value >= 0 && value <= LV_COORD_MAX; break;
+        case PROP_RADIUS: valid = value >= 0 && value <= LV_RADIUS_CIRCLE; break;
+        case PROP_FONT_SIZE: valid = value == 0 || (value >= TTFONT_PX_MIN && value <= TTFONT_PX_MAX); break;
+        default: valid = false; break;
+    }
+    widget_info_t * info = widget_get_info(obj);
+    if(!valid || info == NULL) return false;
+    if(propbind_get(obj, prop) == value) return true;
+
+    bool res = true;
+    lv_coord_t v = value;
+    const lv_font_t * font = NULL;
+    if(prop == PROP_FONT_SIZE)
+    {
+        font = font_size_get(obj, value);
+        if(font == NULL) return false;
+    }
+    undo_edit_begin(info->node);
+    switch(prop)
+    {
+        case PROP_X: lv_obj_set_x(obj, v); break;
+        case PROP_Y: lv_obj_set_y(obj, v); break;
+        case PROP_W: lv_obj_set_width(obj, v); break;
+        case PROP_H: lv_obj_set_height(obj, v); break;
+        case PROP_RADIUS: res = stylepool_edit(obj, radius_edit_cb, &v); break;   //The same radius shares one style
+        case PROP_FONT_SIZE: res = stylepool_edit(obj, font_edit_cb, (void *)font); break;
+        default: break;
+    }
+    undo_edit_end(info->node);
+    if(res) autosave_mark(info->node);
+    propbind_changed(obj, prop);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static lv_obj_t * watched_obj(void)
+{
+    doc_node_t * n = doc_get(watched);
+    if(n == NULL || n->uid != watched_uid) return NULL;
+    return n->obj;
+}
+
+static void sync_task(lv_task_t * task)
+{
+    (void)task;
+    if(!dirty) return;
+    lv_obj_t * obj = watched_obj();
+    if(obj == NULL) return;
+    dirty = false;
+
+    lv_obj_layout_flush();      //Show where the layout of the parent puts it
+
+    uint8_t i;
+    for(i = 0; i < sub_cnt; i++)
+    {
+        propbind_sub_t * s = &subs[i];
+        if(s->valid && s->shown_ver == prop_ver[s->prop]) continue;
+
+        int32_t value = propbind_get(obj, s->prop);
+        bool show = !s->valid || s->prop == PROP_ID || value != s->shown_value;
+        s->shown_ver = prop_ver[s->prop];
+        s->shown_value = value;
+        s->valid = true;
+        if(show) s->cb(obj, s->prop, value, s->user_data);
+    }
+}
+
+static void radius_edit_cb(lv_style_t * style, void * user_data)
+{
+    style->body.radius = *(lv_coord_t *)user_data;
+}
+
+static void font_edit_cb(lv_style_t * style, void * user_data)
+{
+    style->text.font = user_data;
+}
+
+//The widget's TrueType face (or the first one loaded) at a size, rasterized on demand. 0: back to the default font.
+static const lv_font_t * font_size_get(lv_obj_t * obj, int32_t px)
+{
+    if(px == 0) return LV_FONT_DEFAULT;
+    uint32_t face = 0;
+    ttfont_get_info(lv_obj_get_style(obj)->text.font, &face, NULL);
+    return ttfont_get(face, px);
+}
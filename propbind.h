@@ -0,0 +1,74 @@
+/**
+ * @file propbind.h
+ *
+ */
+
+#ifndef _PROPBIND_H_
+#define _PROPBIND_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define PROPBIND_SUB_MAX        16                          //Fields subscribed to the watched widget
+#define PROPBIND_PERIOD         LV_DISP_DEF_REFR_PERIOD     //[ms] The fields are updated at most once a frame
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    PROP_ID,            //The text of `widget_info_t`, its value is 0
+    PROP_X,
+    PROP_Y,
+    PROP_W,
+    PROP_H,
+    PROP_RADIUS,        //Of the main style
+    PROP_FONT_SIZE,     //[px] of the TrueType font of the main style, 0: a built-in font
+    _PROP_NUM,
+}prop_t;
+
+#define PROP_ALL        _PROP_NUM
+
+//Show the new value of a property of the watched widget
+typedef void (*prop_show_cb_t)(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool propbind_subscribe(prop_t prop, prop_show_cb_t cb, void * user_data);
+void propbind_watch(doc_id_t node);
+void propbind_changed(lv_obj_t * obj, prop_t prop);
+void propbind_resend(prop_t prop);
+int32_t propbind_get(lv_obj_t * obj, prop_t prop);
+bool propbind_set(lv_obj_t * obj, prop_t prop, int32_t value);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,337 @@
+/**
+ * @file lv_gui_blob.c
+ * The loader of the screens exported by the designer. It builds the widgets straight from the blob:
+ * the node table is read in place, the IDs and the texts of the labels and check boxes are shown
+ * from the string pool without copying them. Only the `lv_obj_t` pointers and one `lv_style_t`
+ * per unique style take RAM (a style holds a font pointer, so it can't be position independent).
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include "lv_gui_blob.h"
+#include <string.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef lv_obj_t * (*lv_gui_blob_create_cb_t)(lv_obj_t * par, const lv_obj_t * copy);
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void style_build(lv_style_t * style, const lv_gui_blob_style_t * src, const lv_gui_blob_header_t * h);
+static const lv_font_t * font_get(const lv_gui_blob_header_t * h, uint16_t idx);
+static lv_color_t color_get(uint32_t rgb);
+static void text_set(lv_obj_t * obj, lv_gui_blob_type_t type, const char * text);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+/*Indexed by `lv_gui_blob_type_t`, NULL: disabled in lv_conf.h*/
+static const lv_gui_blob_create_cb_t lv_gui_blob_create_tbl[_LV_GUI_BLOB_TYPE_NUM] = {
+    lv_obj_create,
+#if LV_USE_LABEL
+    lv_label_create,
+#else
+    NULL,
+#endif
+#if LV_USE_BTN
+    lv_btn_create,
+#else
+    NULL,
+#endif
+#if LV_USE_CB
+    lv_cb_create,
+#else
+    NULL,
+#endif
+#if LV_USE_DDLIST
+    lv_ddlist_create,
+#else
+    NULL,
+#endif
+#if LV_USE_BAR
+    lv_bar_create,
+#else
+    NULL,
+#endif
+#if LV_USE_LED
+    lv_led_create,
+#else
+    NULL,
+#endif
+#if LV_USE_GAUGE
+    lv_gauge_create,
+#else
+    NULL,
+#endif
+#if LV_USE_SLIDER
+    lv_slider_create,
+#else
+    NULL,
+#endif
+#if LV_USE_ROLLER
+    lv_roller_create,
+#else
+    NULL,
+#endif
+#if LV_USE_ARC
+    lv_arc_create,
+#else
+    NULL,
+#endif
+#if LV_USE_CONT
+    lv_cont_create,
+#else
+    NULL,
+#endif
+};
+
+static lv_gui_blob_font_cb_t font_cb;
+
+/**********************
+ *      MACROS
+ **********************/
+#define BLOB_AT(h, ofs) ((const uint8_t *)(h) + (ofs))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Check a blob, e.g. after it was downloaded
+ * @param blob pointer to the blob
+ * @param size the bytes available there
+ * @return LV_GUI_BLOB_OK or what's wrong with it
+ */
+lv_gui_blob_res_t lv_gui_blob_check(const void * blob, uint32_t size)
+{
+    const lv_gui_blob_header_t * h = blob;
+    if(((uintptr_t)blob & (LV_GUI_BLOB_ALIGN - 1)) != 0) return LV_GUI_BLOB_INV_ALIGN;
+    if(size < sizeof(lv_gui_blob_header_t)) return LV_GUI_BLOB_INV_SIZE;
+    if(h->magic != LV_GUI_BLOB_MAGIC) return LV_GUI_BLOB_INV_MAGIC;
+    if(h->version != LV_GUI_BLOB_VERSION) return LV_GUI_BLOB_INV_VERSION;
+    if(h->size > size || h->header_size < sizeof(lv_gui_blob_header_t) || h->header_size > h->size) {
+        return LV_GUI_BLOB_INV_SIZE;
+    }
+
+    /*Every table has to be in the blob, so the loader needn't check the offsets again*/
+    if((uint64_t)h->node_ofs + (uint64_t)h->node_cnt * sizeof(lv_gui_blob_node_t) > h->size ||
+       (uint64_t)h->style_ofs + (uint64_t)h->style_cnt * sizeof(lv_gui_blob_style_t) > h->size ||
+       (uint64_t)h->asset_ofs + (uint64_t)h->asset_cnt * sizeof(lv_gui_blob_asset_t) > h->size ||
+       (uint64_t)h->str_ofs + h->str_size > h->size || h->str_size == 0 ||
+       BLOB_AT(h, h->str_ofs)[h->str_size - 1] != '\0') {
+        return LV_GUI_BLOB_INV_SIZE;
+    }
+
+    uint32_t hash = 2166136261u;
+    const uint8_t * p = BLOB_AT(h, h->header_size);
+    uint32_t i;
+    for(i = h->header_size; i < h->size; i++) {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    if(hash != h->hash) return LV_GUI_BLOB_INV_HASH;
+
+    const lv_gui_blob_node_t * nodes = (const lv_gui_blob_node_t *)BLOB_AT(h, h->node_ofs);
+    for(i = 0; i < h->node_cnt; i++) {
+        const lv_gui_blob_node_t * n = &nodes[i];
+        if(n->parent != LV_GUI_BLOB_NONE && n->parent >= i) return LV_GUI_BLOB_INV_SIZE;
+        if(n->style != LV_GUI_BLOB_NONE && n->style >= h->style_cnt) return LV_GUI_BLOB_INV_SIZE;
+        if(n->id >= h->str_size) return LV_GUI_BLOB_INV_SIZE;
+        if(n->text != LV_GUI_BLOB_NO_STR && n->text >= h->str_size) return LV_GUI_BLOB_INV_SIZE;
+    }
+    const lv_gui_blob_asset_t * assets = (const lv_gui_blob_asset_t *)BLOB_AT(h, h->asset_ofs);
+    for(i = 0; i < h->asset_cnt; i++) {
+        if(assets[i].name >= h->str_size) return LV_GUI_BLOB_INV_SIZE;
+    }
+
+    return LV_GUI_BLOB_OK;
+}
+
+/**
+ * Create the screen of a blob (it isn't loaded, call `lv_scr_load(s->scr)`)
+ * @param s the screen to initialize
+ * @param blob pointer to a checked blob, e.g. mapped from the flash
+ * @return LV_GUI_BLOB_OK or LV_GUI_BLOB_NO_MEM (nothing is left created then)
+ */
+lv_gui_blob_res_t lv_gui_blob_create(lv_gui_blob_screen_t * s, const void * blob)
+{
+    const lv_gui_blob_header_t * h = blob;
+    memset(s, 0, sizeof(lv_gui_blob_screen_t));
+    s->blob = h;
+
+    s->objs = lv_mem_alloc((h->node_cnt ? h->node_cnt : 1) * sizeof(lv_obj_t *));
+    if(h->style_cnt > 0) s->styles = lv_mem_alloc(h->style_cnt * sizeof(lv_style_t));
+    s->scr = lv_obj_create(NULL, NULL);
+    if(s->objs == NULL || (h->style_cnt > 0 && s->styles == NULL) || s->scr == NULL) {
+        lv_gui_blob_del(s);
+        return LV_GUI_BLOB_NO_MEM;
+    }
+
+    const lv_gui_blob_style_t * styles = (const lv_gui_blob_style_t *)BLOB_AT(h, h->style_ofs);
+    uint32_t i;
+    for(i = 0; i < h->style_cnt; i++) style_build(&s->styles[i], &styles[i], h);
+
+    const lv_gui_blob_node_t * nodes = (const lv_gui_blob_node_t *)BLOB_AT(h, h->node_ofs);
+    const char * str = (const char *)BLOB_AT(h, h->str_ofs);
+    for(i = 0; i < h->node_cnt; i++) {
+        const lv_gui_blob_node_t * n = &nodes[i];
+        lv_obj_t * par = n->parent == LV_GUI_BLOB_NONE ? s->scr : s->objs[n->parent];
+        if(par == NULL) par = s->scr;      /*Its parent's type is disabled*/
+        lv_gui_blob_create_cb_t create = n->type < _LV_GUI_BLOB_TYPE_NUM ? lv_gui_blob_create_tbl[n->type] : NULL;
+        if(create == NULL) {
+            s->objs[i] = NULL;
+            continue;
+        }
+
+        lv_obj_t * obj = create(par, NULL);
+        if(obj == NULL) {
+            lv_gui_blob_del(s);
+            return LV_GUI_BLOB_NO_MEM;
+        }
+        if(n->style != LV_GUI_BLOB_NONE) lv_obj_set_style(obj, &s->styles[n->style]);
+        if(n->text != LV_GUI_BLOB_NO_STR) text_set(obj, n->type, str + n->text);
+        lv_obj_set_pos(obj, n->x, n->y);
+        lv_obj_set_size(obj, n->w, n->h);
+        s->objs[i] = obj;
+    }
+
+    return LV_GUI_BLOB_OK;
+}
+
+/**
+ * Delete the screen and free its memory. The blob can be unmapped after it.
+ * @param s a screen created by `lv_gui_blob_create()`
+ */
+void lv_gui_blob_del(lv_gui_blob_screen_t * s)
+{
+    if(s->scr != NULL) lv_obj_del(s->scr);     /*Before the styles, the widgets use them*/
+    if(s->objs != NULL) lv_mem_free(s->objs);
+    if(s->styles != NULL) lv_mem_free(s->styles);
+    memset(s, 0, sizeof(lv_gui_blob_screen_t));
+}
+
+/**
+ * Find a widget by the ID it has in the designer
+ * @param s a created screen
+ * @param id the ID
+ * @return the widget or NULL
+ */
+lv_obj_t * lv_gui_blob_find(const lv_gui_blob_screen_t * s, const char * id)
+{
+    const lv_gui_blob_header_t * h = s->blob;
+    if(h == NULL) return NULL;
+
+    const lv_gui_blob_node_t * nodes = (const lv_gui_blob_node_t *)BLOB_AT(h, h->node_ofs);
+    const char * str = (const char *)BLOB_AT(h, h->str_ofs);
+    uint32_t i;
+    for(i = 0; i < h->node_cnt; i++) {
+        if(strcmp(str + nodes[i].id, id) == 0) return s->objs[i];
+    }
+    return NULL;
+}
+
+/**
+ * Set the resolver of the fonts which aren't LVGL's built-in fonts
+ * @param cb the resolver or NULL
+ */
+void lv_gui_blob_set_font_cb(lv_gui_blob_font_cb_t cb)
+{
+    font_cb = cb;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void style_build(lv_style_t * style, const lv_gui_blob_style_t * src, const lv_gui_blob_header_t * h)
+{
+    lv_style_copy(style, &lv_style_plain);
+    style->glass = src->glass;
+    style->body.main_color = color_get(src->main_color);
+    style->body.grad_color = color_get(src->grad_color);
+    style->body.radius = src->radius;
+    style->body.opa = src->body_opa;
+    style->body.border.color = color_get(src->border_color);
+    style->body.border.width = src->border_width;
+    style->body.border.part = src->border_part;
+    style->body.border.opa = src->border_opa;
+    style->body.shadow.color = color_get(src->shadow_color);
+    style->body.shadow.width = src->shadow_width;
+    style->body.shadow.type = src->shadow_type;
+    style->body.padding.top = src->pad_top;
+    style->body.padding.bottom = src->pad_bottom;
+    style->body.padding.left = src->pad_left;
+    style->body.padding.right = src->pad_right;
+    style->body.padding.inner = src->pad_inner;
+    style->text.color = color_get(src->text_color);
+    style->text.sel_color = color_get(src->sel_color);
+    style->text.font = font_get(h, src->font);
+    style->text.letter_space = src->letter_space;
+    style->text.line_space = src->line_space;
+    style->text.opa = src->text_opa;
+    style->image.color = color_get(src->image_color);
+    style->image.intense = src->image_intense;
+    style->image.opa = src->image_opa;
+    style->line.color = color_get(src->line_color);
+    style->line.width = src->line_width;
+    style->line.opa = src->line_opa;
+    style->line.rounded = src->line_rounded;
+}
+
+static const lv_font_t * font_get(const lv_gui_blob_header_t * h, uint16_t idx)
+{
+    if(idx == LV_GUI_BLOB_NONE || idx >= h->asset_cnt) return LV_FONT_DEFAULT;
+    const lv_gui_blob_asset_t * asset = &((const lv_gui_blob_asset_t *)BLOB_AT(h, h->asset_ofs))[idx];
+    if(asset->kind != LV_GUI_BLOB_ASSET_FONT) return LV_FONT_DEFAULT;
+    const char * name = (const char *)BLOB_AT(h, h->str_ofs) + asset->name;
+
+#if LV_FONT_ROBOTO_12
+    if(strcmp(name, "lv_font_roboto_12") == 0) return &lv_font_roboto_12;
+#endif
+#if LV_FONT_ROBOTO_16
+    if(strcmp(name, "lv_font_roboto_16") == 0) return &lv_font_roboto_16;
+#endif
+#if LV_FONT_ROBOTO_22
+    if(strcmp(name, "lv_font_roboto_22") == 0) return &lv_font_roboto_22;
+#endif
+#if LV_FONT_ROBOTO_28
+    if(strcmp(name, "lv_font_roboto_28") == 0) return &lv_font_roboto_28;
+#endif
+#if LV_FONT_UNSCII_8
+    if(strcmp(name, "lv_font_unscii_8") == 0) return &lv_font_unscii_8;
+#endif
+    const lv_font_t * font = font_cb != NULL ? font_cb(name) : NULL;
+    return font != NULL ? font : LV_FONT_DEFAULT;
+}
+
+static lv_color_t color_get(uint32_t rgb)
+{
+    return lv_color_make((rgb >> 16) & 0xFF, (rgb >> 8) & 0xFF, rgb & 0xFF);
+}
+
+/*The labels and the check boxes show the text from the blob, the lists copy their options*/
+static void text_set(lv_obj_t * obj, lv_gui_blob_type_t type, const char * text)
+{
+    switch(type) {
+#if LV_USE_LABEL
+        case LV_GUI_BLOB_TYPE_LABEL: lv_label_set_static_text(obj, text); break;
+#endif
+#if LV_USE_CB
+        case LV_GUI_BLOB_TYPE_CB: lv_cb_set_static_text(obj, text); break;
+#endif
+#if LV_USE_DDLIST
+        case LV_GUI_BLOB_TYPE_DDLIST: lv_ddlist_set_options(obj, text); break;
+#endif
+#if LV_USE_ROLLER
+        case LV_GUI_BLOB_TYPE_ROLLER: lv_roller_set_options(obj, text, LV_ROLLER_MODE_NORMAL); break;
+#endif
+        default: break;
+    }
+}
@@ -0,0 +1,210 @@
+/**
+ * @file lv_gui_blob.h
+ * Create the screens exported by the designer (`--codegen-blob`) from their binary blobs.
+ * Ship it with `lv_gui_blob.c` next to `lv_gui.c`; the designer uses this header too, for the format.
+ */
+
+#ifndef LV_GUI_BLOB_H
+#define LV_GUI_BLOB_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#else
+#include "lvgl/lvgl.h"
+#endif
+
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define LV_GUI_BLOB_MAGIC       0x4255474CUL    /*"LGUB" in a little endian blob*/
+#define LV_GUI_BLOB_VERSION     1
+#define LV_GUI_BLOB_NONE        0xFFFF          /*No parent (on the screen), style (the theme's) or font*/
+#define LV_GUI_BLOB_NO_STR      0xFFFFFFFFUL
+#define LV_GUI_BLOB_ALIGN       4               /*The blob has to start on an address aligned like this*/
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+/*The values of `widget_type_t` of the designer*/
+enum {
+    LV_GUI_BLOB_TYPE_OBJ = 0,
+    LV_GUI_BLOB_TYPE_LABEL,
+    LV_GUI_BLOB_TYPE_BTN,
+    LV_GUI_BLOB_TYPE_CB,
+    LV_GUI_BLOB_TYPE_DDLIST,
+    LV_GUI_BLOB_TYPE_BAR,
+    LV_GUI_BLOB_TYPE_LED,
+    LV_GUI_BLOB_TYPE_GAUGE,
+    LV_GUI_BLOB_TYPE_SLIDER,
+    LV_GUI_BLOB_TYPE_ROLLER,
+    LV_GUI_BLOB_TYPE_ARC,
+    LV_GUI_BLOB_TYPE_CONT,
+    _LV_GUI_BLOB_TYPE_NUM,
+};
+typedef uint8_t lv_gui_blob_type_t;
+
+/* Blob layout, position independent: every reference is an index or an offset from the start of the blob.
+ * header | node table | style pool | asset table | string pool
+ * All fields are little endian and the tables are 4 byte aligned, so the loader reads them in place.
+ * The nodes are in creation order, a node's parent always comes before it. */
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;       /*sizeof(lv_gui_blob_header_t), lets newer loaders skip added fields*/
+    uint32_t size;              /*Of the whole blob, to catch a truncated download*/
+    uint32_t hash;              /*FNV-1a of the bytes after the header*/
+    uint16_t node_cnt;
+    uint16_t style_cnt;
+    uint16_t asset_cnt;
+    uint16_t reserved;
+    uint32_t node_ofs;
+    uint32_t style_ofs;
+    uint32_t asset_ofs;
+    uint32_t str_ofs;
+    uint32_t str_size;          /*The pool ends with '\0'*/
+} lv_gui_blob_header_t;
+
+typedef struct
+{
+    uint16_t parent;            /*Index of the parent node or LV_GUI_BLOB_NONE for the widgets of the screen*/
+    lv_gui_blob_type_t type;
+    uint8_t reserved;
+    int16_t x, y, w, h;
+    uint16_t style;             /*Index in the style pool or LV_GUI_BLOB_NONE*/
+    uint16_t reserved2;
+    uint32_t id;                /*Offset of the widget's ID in the string pool*/
+    uint32_t text;              /*Offset of its text (or options) or LV_GUI_BLOB_NO_STR*/
+} lv_gui_blob_node_t;
+
+/*A main style independent of LV_COLOR_DEPTH and the struct layout of the target*/
+typedef struct
+{
+    uint32_t main_color;        /*0x00RRGGBB, all of the colors*/
+    uint32_t grad_color;
+    uint32_t border_color;
+    uint32_t shadow_color;
+    uint32_t text_color;
+    uint32_t sel_color;
+    uint32_t image_color;
+    uint32_t line_color;
+    int16_t radius;
+    int16_t border_width;
+    int16_t shadow_width;
+    int16_t pad_top;
+    int16_t pad_bottom;
+    int16_t pad_left;
+    int16_t pad_right;
+    int16_t pad_inner;
+    int16_t letter_space;
+    int16_t line_space;
+    int16_t line_width;
+    uint16_t font;              /*Index in the asset table or LV_GUI_BLOB_NONE for LV_FONT_DEFAULT*/
+    uint8_t glass;
+    uint8_t body_opa;
+    uint8_t border_part;
+    uint8_t border_opa;
+    uint8_t shadow_type;
+    uint8_t text_opa;
+    uint8_t image_intense;
+    uint8_t image_opa;
+    uint8_t line_opa;
+    uint8_t line_rounded;
+    uint16_t reserved;
+} lv_gui_blob_style_t;
+
+enum {
+    LV_GUI_BLOB_ASSET_FONT = 0,
+};
+typedef uint16_t lv_gui_blob_asset_kind_t;
+
+/*An asset the blob refers to by name, it's linked into the firmware*/
+typedef struct
+{
+    uint32_t name;              /*Offset in the string pool, e.g. "lv_font_roboto_16"*/
+    lv_gui_blob_asset_kind_t kind;
+    uint16_t reserved;
+} lv_gui_blob_asset_t;
+
+enum {
+    LV_GUI_BLOB_OK = 0,
+    LV_GUI_BLOB_INV_MAGIC,      /*Not a blob or not in the byte order of the target*/
+    LV_GUI_BLOB_INV_VERSION,
+    LV_GUI_BLOB_INV_SIZE,       /*Truncated or the tables are out of it*/
+    LV_GUI_BLOB_INV_HASH,       /*Damaged*/
+    LV_GUI_BLOB_INV_ALIGN,      /*Not on an LV_GUI_BLOB_ALIGN aligned address*/
+    LV_GUI_BLOB_NO_MEM,
+};
+typedef uint8_t lv_gui_blob_res_t;
+
+/*Resolve a font the blob refers to by name, return NULL if it's unknown (LV_FONT_DEFAULT is used then)*/
+typedef const lv_font_t * (*lv_gui_blob_font_cb_t)(const char * name);
+
+/*A screen created from a blob. The blob has to stay mapped while the screen exists,
+ *the widgets show its strings without copying them.*/
+typedef struct
+{
+    const lv_gui_blob_header_t * blob;
+    lv_obj_t * scr;
+    lv_obj_t ** objs;           /*Per node, NULL if its type is disabled in lv_conf.h*/
+    lv_style_t * styles;        /*The style pool, one RAM style per unique style shared by its widgets*/
+} lv_gui_blob_screen_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+
+/**
+ * Check a blob, e.g. after it was downloaded
+ * @param blob pointer to the blob
+ * @param size the bytes available there
+ * @return LV_GUI_BLOB_OK or what's wrong with it
+ */
+lv_gui_blob_res_t lv_gui_blob_check(const void * blob, uint32_t size);
+
+/**
+ * Create the screen of a blob (it isn't loaded, call `lv_scr_load(s->scr)`)
+ * @param s the screen to initialize
+ * @param blob pointer to a checked blob, e.g. mapped from the flash
+ * @return LV_GUI_BLOB_OK or LV_GUI_BLOB_NO_MEM (nothing is left created then)
+ */
+lv_gui_blob_res_t lv_gui_blob_create(lv_gui_blob_screen_t * s, const void * blob);
+
+/**
+ * Delete the screen and free its memory. The blob can be unmapped after it.
+ * @param s a screen created by `lv_gui_blob_create()`
+ */
+void lv_gui_blob_del(lv_gui_blob_screen_t * s);
+
+/**
+ * Find a widget by the ID it has in the designer
+ * @param s a created screen
+ * @param id the ID
+ * @return the widget or NULL
+ */
+lv_obj_t * lv_gui_blob_find(const lv_gui_blob_screen_t * s, const char * id);
+
+/**
+ * Set the resolver of the fonts which aren't LVGL's built-in fonts
+ * @param cb the resolver or NULL
+ */
+void lv_gui_blob_set_font_cb(lv_gui_blob_font_cb_t cb);
+
+/**********************
+ *      MACROS
+ **********************/
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif /*LV_GUI_BLOB_H*/
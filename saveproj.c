@@ -1,34 +1,91 @@
+#include <stdio.h>
+#include <string.h>
 #include "saveproj.h"
-#include <mxml.h>
 #include "dataset.h"
-#include "custom_widget.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "xmlstream.h"
+#include "screens.h"
+#include "hotreload.h"
 
-static void widget2xml_traverse(lv_obj_t * layer, mxml_node_t * par_node);
+static void attrs_write(xmlstream_t * xs, const projsnap_node_t * n);
 
+bool save_project(doc_id_t root)
+{
+    projsnap_t snap;
+    if(!projsnap_take(&snap, root))
+    {
+        printf("Save failed, out of memory\n");
+        return false;
+    }
+    bool res = save_project_snap(&snap, NULL);
+    projsnap_free(&snap);
+    return res;
+}
 
-void save_project(lv_obj_t * par_layer)
+//Doesn't touch the widgets, so it can run on any thread
+bool save_project_snap(const projsnap_t * snap, projsnap_step_cb_t step_cb)
 {
-    mxml_node_t * xml_root = mxmlNewXML("1.0");
-    widget2xml_traverse(par_layer, xml_root);
-    printf("Create OK");
-    FILE * fp = fopen("save.xml", "w");
+    xmlstream_t xs;
+    if(!xmlstream_open(&xs, SAVEPROJ_XML_FILE))
+    {
+        printf("Can't create %s\n", SAVEPROJ_XML_FILE);
+        return false;
+    }
 
-    mxmlSaveFile(xml_root, fp, MXML_NO_CALLBACK);
-    fclose(fp);
-}
+    uint32_t i;
+    uint32_t open = 0;      //Elements not ended yet, the ancestors of the next node
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        for(; open > n->depth; open--) xmlstream_end(&xs);
 
-static void widget2xml_traverse(lv_obj_t * layer, mxml_node_t * par_node)
-{  
-    layerview_ext_t * ext = lv_obj_get_ext_attr(layer);
-    widget_info_t * info = lv_obj_get_user_data(ext->bind);
-    mxml_node_t * node = mxmlNewElement(par_node, widget_get_type_name(info->type));
+        if(n->depth == 0 && snap->screen_cnt > 1)
+        {
+            xmlstream_begin(&xs, SCREENS_TAG);      //Only named, the loader creates the windows of the screens
+            xmlstream_attr(&xs, "id", n->id);
+        }else
+        {
+            const widget_desc_t * desc = widgetreg_get(n->type);
+            xmlstream_begin(&xs, desc ? desc->tag : widget_get_type_name(n->type));
+            xmlstream_attr(&xs, "id", n->id);
+            xmlstream_attr_int(&xs, "x", n->x);
+            xmlstream_attr_int(&xs, "y", n->y);
+            xmlstream_attr_int(&xs, "w", n->w);
+            xmlstream_attr_int(&xs, "h", n->h);
+            attrs_write(&xs, n);
+        }
+        open++;
 
-    lv_obj_t * child_layer = ext->child;
+        if(step_cb != NULL) step_cb(i + 1, snap->cnt);
+    }
+    for(; open > 0; open--) xmlstream_end(&xs);
 
-    while (child_layer)     //Iterate all children
+    if(!xmlstream_close(&xs))    //Renames the finished file over the old one
     {
-        widget2xml_traverse(child_layer, node);
-        ext = lv_obj_get_ext_attr(child_layer);
-        child_layer = ext->right;
-    } 
-}
\ No newline at end of file
+        printf("Save failed, %s is unchanged\n", SAVEPROJ_XML_FILE);
+        return false;
+    }
+    printf("Save OK\n");
+    hotreload_rebase();     //Not a change to reload
+    return true;
+}
+
+//The attributes of the schema, without the default values
+static void attrs_write(xmlstream_t * xs, const projsnap_node_t * n)
+{
+    const widget_attr_desc_t * text_attr = widgetreg_text_attr(n->type);
+    if(text_attr != NULL)
+    {
+        const char * text = n->text != NULL ? n->text : "";
+        if(strcmp(text, text_attr->def_text != NULL ? text_attr->def_text : "")) xmlstream_attr(xs, text_attr->name, text);
+    }
+
+    const widget_desc_t * desc = widgetreg_get(n->type);
+    uint8_t i;
+    for(i = 0; i < n->val_cnt; i++)
+    {
+        const widget_attr_desc_t * attr = widgetreg_attr_at(desc, n->vals[i].attr);
+        if(attr != NULL && n->vals[i].value != attr->def) xmlstream_attr_int(xs, attr->name, n->vals[i].value);
+    }
+}
@@ -24,9 +24,14 @@ extern "C" {
 
 
 
+#include <stdbool.h>
+#include "doctree.h"
+#include "projjob.h"
+
 /*********************
  *      DEFINES
  *********************/
+#define SAVEPROJ_XML_FILE   "save.xml"
 
 /**********************
  *      TYPEDEFS
@@ -35,7 +40,8 @@ extern "C" {
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
-void save_project(lv_obj_t * par_layer);
+bool save_project(doc_id_t root);
+bool save_project_snap(const projsnap_t * snap, projsnap_step_cb_t step_cb);
 /**********************
  *      MACROS
  **********************/
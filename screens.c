@@ -0,0 +1,351 @@
+/**
+ * @file screens.c
+ * The screens of a multi-screen project. Every screen is a TFT Simulator window on the root level of the document,
+ * only the open one is shown. The widgets exist only on the open screen and on its SCREENS_LIVE_NEIGHBOURS
+ * neighbours (so stepping to the next one is instant); the other screens are stored as snapshots in the heap,
+ * a few dozen bytes per widget instead of the lv_mem the widgets would take, and are created again when opened.
+ * The open screen is the first one in the document, so doc_get_screen() and `tft_win` are the open one.
+ * Saving and code generation take every screen, the stored ones from their snapshots.
+ * Used only on the UI thread.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "screens.h"
+#include "interface.h"
+#include "dataset.h"
+#include "widgetid.h"
+#include "widgetreg.h"
+#include "stylepool.h"
+#include "toolbox.h"
+#include "autosave.h"
+#include "undo.h"
+#include "custom_widget.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SCREENS_INIT_CAPACITY   8
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    doc_id_t node;              //Its window in the document, DOC_NONE: stored
+    projsnap_t store;           //The widgets of a stored screen, the screen is the root. Empty while it's live
+}screen_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t screen_new(void);
+static bool screen_store(screen_t * s);
+static bool screen_build(screen_t * s);
+static void screens_trim(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+extern lv_obj_t * tft_win;
+static screen_t * screens = NULL;
+static uint32_t screen_cnt = 0;
+static uint32_t screen_cap = 0;
+static uint32_t act = SCREENS_NONE;         //The open screen
+static uint32_t load_cur = SCREENS_NONE;    //The screen being loaded, it's not stored until it's complete
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//`win` is the first screen, already in the document
+void screens_init(lv_obj_t * win)
+{
+    if(screen_cnt != 0) return;
+
+    screens = calloc(SCREENS_INIT_CAPACITY, sizeof(screen_t));
+    if(screens == NULL) return;
+    screen_cap = SCREENS_INIT_CAPACITY;
+    screens[0].node = widget_get_info(win)->node;
+    screen_cnt = 1;
+    act = 0;
+    tft_win = win;
+}
+
+//Add an empty screen after the last one and open it. Returns its index or SCREENS_NONE.
+uint32_t screens_add(void)
+{
+    uint32_t idx = screen_new();
+    if(idx == SCREENS_NONE) return SCREENS_NONE;
+    screens_open(idx);
+    return idx;
+}
+
+//Show a screen in the TFT Simulator, a stored one is created again. The ones far from it are stored.
+bool screens_open(uint32_t idx)
+{
+    if(idx >= screen_cnt) return false;
+
+    screen_t * s = &screens[idx];
+    if(s->node == DOC_NONE && !screen_build(s)) return false;
+
+    if(act != idx && act < screen_cnt && screens[act].node != DOC_NONE)
+    {
+        lv_obj_set_hidden(doc_get(screens[act].node)->obj, true);
+    }
+    act = idx;
+    doc_move(s->node, DOC_ROOT, doc_get(DOC_ROOT)->first_child);
+    tft_win = doc_get(s->node)->obj;
+    lv_obj_set_hidden(tft_win, false);
+
+    screens_trim();
+    layerview_set_sel(s->node);
+    return true;
+}
+
+uint32_t screens_get_cnt(void)
+{
+    return screen_cnt;
+}
+
+uint32_t screens_get_act(void)
+{
+    return act;
+}
+
+//The snapshot of a stored screen, NULL if it's live
+const projsnap_t * screens_get_stored(uint32_t idx)
+{
+    if(idx >= screen_cnt || screens[idx].node != DOC_NONE) return NULL;
+    return &screens[idx].store;
+}
+
+//One screen, a copy of a stored one. An empty snapshot for an invalid index.
+bool screens_snap_take_one(uint32_t idx, projsnap_t * snap)
+{
+    memset(snap, 0, sizeof(projsnap_t));
+    if(idx >= screen_cnt) return true;
+
+    const screen_t * s = &screens[idx];
+    if(s->node != DOC_NONE) return projsnap_take(snap, s->node);
+    if(projsnap_append(snap, &s->store)) return true;
+    projsnap_free(snap);
+    return false;
+}
+
+//Every screen of the project in their order, each of them is a root of the snapshot
+bool screens_snap_take(projsnap_t * snap)
+{
+    memset(snap, 0, sizeof(projsnap_t));
+
+    uint32_t i;
+    for(i = 0; i < screen_cnt; i++)
+    {
+        const screen_t * s = &screens[i];
+        bool res;
+        if(s->node == DOC_NONE)
+        {
+            res = projsnap_append(snap, &s->store);
+        }else if(snap->cnt == 0)
+        {
+            res = projsnap_take(snap, s->node);
+        }else
+        {
+            projsnap_t part;
+            res = projsnap_take(&part, s->node) && projsnap_append(snap, &part);
+            projsnap_free(&part);
+        }
+
+        if(!res)
+        {
+            projsnap_free(snap);
+            return false;
+        }
+    }
+    return true;
+}
+
+//A load adds the screens of the file after the existing ones
+void screens_load_begin(void)
+{
+    load_cur = SCREENS_NONE;
+}
+
+/**
+ * A screen of the loaded file begins, the previous one is complete and it's stored if it's far from the open one.
+ * The first screen of the file goes to the open one if that's empty, e.g. when the designer just started.
+ * @param id its ID, NULL: keep the generated one
+ * @return the window to create its widgets on, NULL if out of memory
+ */
+lv_obj_t * screens_load_screen(const char * id)
+{
+    uint32_t prev = load_cur;
+    uint32_t idx = SCREENS_NONE;
+    if(prev == SCREENS_NONE && act < screen_cnt && screens[act].node != DOC_NONE &&
+       doc_get(screens[act].node)->first_child == DOC_NONE)
+    {
+        idx = act;
+    }else
+    {
+        idx = screen_new();
+        if(idx == SCREENS_NONE) return NULL;
+    }
+    load_cur = idx;
+    if(prev != SCREENS_NONE) screens_trim();
+
+    lv_obj_t * win = doc_get(screens[idx].node)->obj;
+    if(id != NULL && !widgetid_rename(win, id)) printf("Screens: can't name a screen %s\n", id);
+    return win;
+}
+
+void screens_load_end(void)
+{
+    load_cur = SCREENS_NONE;
+    screens_trim();
+    layerview_refr_request();
+}
+
+void screens_get_stat(screens_stat_t * stat)
+{
+    memset(stat, 0, sizeof(screens_stat_t));
+    stat->cnt = screen_cnt;
+
+    uint32_t i;
+    for(i = 0; i < screen_cnt; i++)
+    {
+        const projsnap_t * st = &screens[i].store;
+        if(screens[i].node != DOC_NONE)
+        {
+            stat->live++;
+            continue;
+        }
+        stat->stored_nodes += st->cnt;
+        stat->stored_size += st->cnt * sizeof(projsnap_node_t) + st->style_cnt * sizeof(lv_style_t);
+        uint32_t n;
+        for(n = 0; n < st->cnt; n++)
+        {
+            if(st->nodes[n].text != NULL) stat->stored_size += strlen(st->nodes[n].text) + 1;
+        }
+    }
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//A hidden empty screen after the last one. Returns its index or SCREENS_NONE.
+static uint32_t screen_new(void)
+{
+    if(screen_cnt == screen_cap)
+    {
+        uint32_t new_cap = screen_cap ? screen_cap * 2 : SCREENS_INIT_CAPACITY;
+        screen_t * new_screens = realloc(screens, new_cap * sizeof(screen_t));
+        if(new_screens == NULL) return SCREENS_NONE;
+        screens = new_screens;
+        screen_cap = new_cap;
+    }
+
+    lv_obj_t * win = tft_win_create();
+    if(win == NULL) return SCREENS_NONE;
+    lv_obj_set_hidden(win, true);
+
+    screen_t * s = &screens[screen_cnt];
+    memset(s, 0, sizeof(screen_t));
+    s->node = widget_get_info(win)->node;
+    return screen_cnt++;
+}
+
+//Free the widgets of a screen and keep only their snapshot
+static bool screen_store(screen_t * s)
+{
+    doc_id_t node = s->node;
+    if(!projsnap_take(&s->store, node))
+    {
+        printf("Screens: out of memory, a screen keeps its widgets\n");
+        return false;
+    }
+    //The snapshot was allocated for the whole document
+    projsnap_node_t * nodes = realloc(s->store.nodes, s->store.cnt * sizeof(projsnap_node_t));
+    if(nodes != NULL) s->store.nodes = nodes;
+
+    autosave_mark_stored(node);
+    undo_clear();       //Its steps would refer to widgets which aren't there
+    layerview_unload(node);
+    s->node = DOC_NONE;
+    return true;
+}
+
+//Create the widgets of a stored screen again, with their IDs, styles and texts
+static bool screen_build(screen_t * s)
+{
+    projsnap_t * st = &s->store;
+    doc_id_t * made = malloc(st->cnt * sizeof(doc_id_t));      //The document node of every snapshot node
+    lv_obj_t * win = made != NULL ? tft_win_create() : NULL;
+    if(win == NULL)
+    {
+        free(made);
+        printf("Screens: out of memory, a screen can't be opened\n");
+        return false;
+    }
+    lv_obj_set_hidden(win, true);
+    doc_id_t node = widget_get_info(win)->node;
+    if(!widgetid_rename(win, st->nodes[0].id)) printf("Screens: the ID %s is taken\n", st->nodes[0].id);
+    made[0] = node;
+
+    lv_obj_batch_begin();
+    uint32_t i;
+    for(i = 1; i < st->cnt; i++)
+    {
+        const projsnap_node_t * r = &st->nodes[i];
+        lv_obj_t * obj = toolbox_restore(r->type, made[r->parent]);
+        if(obj == NULL)
+        {
+            made[i] = made[r->parent];      //Its children go to the parent
+            continue;
+        }
+        made[i] = widget_get_info(obj)->node;
+        if(!widgetid_rename(obj, r->id)) printf("Screens: the ID %s is taken\n", r->id);
+        if(r->style != PROJSNAP_NO_STYLE)
+        {
+            const lv_style_t * style = stylepool_intern(&st->styles[r->style]);
+            if(style != NULL)
+            {
+                stylepool_set(obj, style);
+                stylepool_release(style);       //The widget has its own reference
+            }
+        }
+        if(r->text != NULL) widgetreg_text_apply(obj, r->type, r->text);
+        widgetreg_vals_apply(obj, r->type, r->vals, r->val_cnt);
+        lv_obj_set_size(obj, r->w, r->h);
+        lv_obj_set_pos(obj, r->x, r->y);
+    }
+    lv_obj_batch_commit();
+    free(made);
+
+    autosave_forget(st->nodes[0].uid);     //The journal has the stored version, the new one replaces it
+    projsnap_free(st);
+    s->node = node;
+    return true;
+}
+
+//Store the live screens which are not close to the open one
+static void screens_trim(void)
+{
+    uint32_t i;
+    for(i = 0; i < screen_cnt; i++)
+    {
+        screen_t * s = &screens[i];
+        if(s->node == DOC_NONE || i == act || i == load_cur) continue;
+        uint32_t dist = i > act ? i - act : act - i;
+        if(dist > SCREENS_LIVE_NEIGHBOURS) screen_store(s);
+    }
+}
@@ -0,0 +1,73 @@
+/**
+ * @file screens.h
+ *
+ */
+
+#ifndef _SCREENS_H_
+#define _SCREENS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+#include "projjob.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SCREENS_LIVE_NEIGHBOURS     1           //Screens this close to the open one keep their widgets, hidden
+#define SCREENS_NONE                0xFFFFFFFF
+#define SCREENS_TAG                 "screen"    //Element of a screen in the project files
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t cnt;
+    uint32_t live;              //Screens with widgets, the open one too
+    uint32_t stored_nodes;      //Widgets of the other screens, kept only in their snapshots
+    uint32_t stored_size;       //Bytes of those snapshots
+}screens_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void screens_init(lv_obj_t * win);
+uint32_t screens_add(void);
+bool screens_open(uint32_t idx);
+uint32_t screens_get_cnt(void);
+uint32_t screens_get_act(void);
+const projsnap_t * screens_get_stored(uint32_t idx);
+bool screens_snap_take_one(uint32_t idx, projsnap_t * snap);
+bool screens_snap_take(projsnap_t * snap);
+void screens_load_begin(void);
+lv_obj_t * screens_load_screen(const char * id);
+void screens_load_end(void);
+void screens_get_stat(screens_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
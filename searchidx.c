@@ -0,0 +1,615 @@
+/**
+ * @file searchidx.c
+ * Indices of the widgets of the document for the search of the Setting window: by type, by main style and by
+ * the words of their texts (postings in one hash table), and by ID prefix (a trie counting the widgets below
+ * every node). The added and edited widgets are queued and indexed before the next query, the freed ones are
+ * dropped at once. A query walks the shortest list of its terms and tests the other terms on the indexed
+ * fields, so it never touches the widgets.
+ * Query terms, separated by spaces, all have to match: `type:btn`, `id:btn_` (or just `btn_`),
+ * `style:<widget ID>` (the same style as that widget) or `style:plain` (a built-in style), `text:<word>`.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "searchidx.h"
+#include "dataset.h"
+#include "widgetreg.h"
+#include "widgetid.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define IDX_NONE            0           //No posting, trie node or record. The root of the trie is never a member.
+#define TRIE_NONE           0xFFFFFFFF  //The root of the trie is 0
+#define INIT_SLOTS          256         //Must be a power of 2
+#define ID_MAX              sizeof(((widget_info_t *)0)->id)
+#define HASH_INIT           0xcbf29ce484222325ULL  //FNV-1a, 64 bit
+#define HASH_PRIME          0x100000001b3ULL
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    TERM_TYPE,
+    TERM_ID,
+    TERM_STYLE,
+    TERM_TEXT,
+}term_kind_t;
+
+typedef struct
+{
+    term_kind_t kind;
+    uint64_t key;               //Of the postings (not TERM_ID)
+    char str[SEARCHIDX_WORD_MAX + 1];   //The ID prefix
+    uint32_t trie;              //The trie node of the prefix
+    uint32_t cnt;               //Widgets matching it alone
+}term_t;
+
+//The indexed fields of a node
+typedef struct
+{
+    uint8_t indexed : 1;
+    uint8_t queued : 1;
+    char id[ID_MAX];
+    uint32_t trie;              //The trie node of `id`, TRIE_NONE if it's not in the trie
+    doc_id_t id_next, id_prev;  //Among the members of `trie`
+    uint32_t first_post;        //Its postings, linked by `node_next`
+}rec_t;
+
+typedef struct
+{
+    uint64_t key;
+    doc_id_t node;
+    uint32_t key_next, key_prev;
+    uint32_t node_next;         //Free list too
+}post_t;
+
+typedef struct
+{
+    uint64_t key;               //0: free
+    uint32_t head;
+    uint32_t cnt;
+}slot_t;
+
+typedef struct
+{
+    char c;
+    uint32_t child, sibling;
+    doc_id_t members;           //IDs ending here
+    uint32_t cnt;               //IDs in the subtree
+}trie_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void add_cb(doc_id_t id);
+static void remove_cb(doc_id_t id);
+static void queue_flush(void);
+static bool rec_reserve(doc_id_t id);
+static void node_index(doc_id_t id);
+static void node_unindex(doc_id_t id);
+static bool post_add(doc_id_t id, uint64_t key);
+static slot_t * slot_find(uint64_t key, bool add);
+static bool slots_grow(void);
+static bool trie_insert(doc_id_t id);
+static void trie_remove(doc_id_t id);
+static uint32_t trie_find(const char * prefix, bool add);
+static bool term_parse(term_t * term, const char * str);
+static bool kind_is(const char * str, size_t len, const char * kind);
+static bool term_match(const term_t * term, doc_id_t id);
+static bool node_has_key(doc_id_t id, uint64_t key);
+static uint64_t key_get(char kind, const void * data, size_t size);
+static const lv_style_t * style_by_name(const char * name);
+static void * arr_grow(void * arr, uint32_t * cap, uint32_t need, size_t size);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static rec_t * recs = NULL;             //By node ID
+static uint32_t rec_cap = 0;
+static post_t * posts = NULL;           //[0] is unused
+static uint32_t post_cnt = 0;
+static uint32_t post_cap = 0;
+static uint32_t post_free = IDX_NONE;
+static slot_t * slots = NULL;
+static uint32_t slot_mask = 0;
+static uint32_t slot_used = 0;
+static trie_t * trie = NULL;            //[0] is the root
+static uint32_t trie_cnt = 0;
+static uint32_t trie_cap = 0;
+static doc_id_t * queue = NULL;         //Nodes to index again
+static uint32_t queue_cnt = 0;
+static uint32_t queue_cap = 0;
+static uint32_t * walk = NULL;          //Stack of the trie walk of a query
+static uint32_t walk_cap = 0;
+static bool oom = false;                //Something couldn't be indexed, a query may miss it
+
+static const struct
+{
+    const char * name;
+    const lv_style_t * style;
+}builtin_styles[] = {
+    {"scr", &lv_style_scr}, {"transp", &lv_style_transp}, {"transp_fit", &lv_style_transp_fit},
+    {"transp_tight", &lv_style_transp_tight}, {"plain", &lv_style_plain}, {"plain_color", &lv_style_plain_color},
+    {"pretty", &lv_style_pretty}, {"pretty_color", &lv_style_pretty_color}, {"btn_rel", &lv_style_btn_rel},
+    {"btn_pr", &lv_style_btn_pr}, {"btn_tgl_rel", &lv_style_btn_tgl_rel}, {"btn_tgl_pr", &lv_style_btn_tgl_pr},
+    {"btn_ina", &lv_style_btn_ina},
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Follow the nodes of the document from now on
+void searchidx_init(void)
+{
+    if(trie != NULL) return;
+    trie = calloc(64, sizeof(trie_t));
+    if(trie == NULL) return;
+    trie_cap = 64;
+    trie_cnt = 1;
+    doc_set_watch_cb(add_cb, remove_cb);
+}
+
+//A widget changed, index it again before the next query
+void searchidx_mark(doc_id_t id)
+{
+    if(trie == NULL || id == DOC_ROOT || !rec_reserve(id) || recs[id].queued) return;
+    doc_id_t * q = arr_grow(queue, &queue_cap, queue_cnt + 1, sizeof(doc_id_t));
+    if(q == NULL)
+    {
+        oom = true;
+        return;
+    }
+    queue = q;
+    queue[queue_cnt++] = id;
+    recs[id].queued = 1;
+}
+
+/**
+ * Find the widgets matching a query
+ * @param query terms separated by spaces, see the top of the file
+ * @param cb called on every matching widget
+ * @param user_data passed to `cb`
+ * @return the number of matching widgets, -1 if the query is invalid
+ */
+int32_t searchidx_query(const char * query, searchidx_cb_t cb, void * user_data)
+{
+    if(trie == NULL) return -1;
+    queue_flush();
+    if(oom) printf("Search: out of memory, some widgets aren't indexed\n");
+
+    term_t terms[SEARCHIDX_TERM_MAX];
+    uint8_t term_cnt = 0;
+    char buf[64];
+    while(*query != '\0')
+    {
+        while(*query == ' ') query++;
+        size_t len = strcspn(query, " ");
+        if(len == 0) break;
+        if(term_cnt == SEARCHIDX_TERM_MAX || len >= sizeof(buf)) return -1;
+        memcpy(buf, query, len);
+        buf[len] = '\0';
+        query += len;
+        if(!term_parse(&terms[term_cnt], buf)) return -1;
+        term_cnt++;
+    }
+    if(term_cnt == 0) return -1;
+
+    //Walk the shortest list
+    uint8_t best = 0;
+    uint8_t i;
+    for(i = 1; i < term_cnt; i++)
+    {
+        if(terms[i].cnt < terms[best].cnt) best = i;
+    }
+    if(terms[best].cnt == 0) return 0;
+
+    int32_t found = 0;
+    if(terms[best].kind != TERM_ID)
+    {
+        slot_t * s = slot_find(terms[best].key, false);
+        uint32_t p = s ? s->head : IDX_NONE;
+        for(; p != IDX_NONE; p = posts[p].key_next)
+        {
+            doc_id_t id = posts[p].node;
+            for(i = 0; i < term_cnt && (i == best || term_match(&terms[i], id)); i++);
+            if(i < term_cnt) continue;
+            found++;
+            cb(id, user_data);
+        }
+        return found;
+    }
+
+    //The members of the prefix's trie node and of the nodes below it
+    uint32_t depth = 0;
+    uint32_t * w = arr_grow(walk, &walk_cap, 1, sizeof(uint32_t));
+    if(w == NULL) return -1;
+    walk = w;
+    walk[depth++] = terms[best].trie;
+    while(depth > 0)
+    {
+        trie_t * t = &trie[walk[--depth]];
+        doc_id_t id;
+        for(id = t->members; id != IDX_NONE; id = recs[id].id_next)
+        {
+            for(i = 0; i < term_cnt && (i == best || term_match(&terms[i], id)); i++);
+            if(i < term_cnt) continue;
+            found++;
+            cb(id, user_data);
+        }
+        uint32_t c;
+        for(c = t->child; c != IDX_NONE; c = trie[c].sibling)
+        {
+            if(trie[c].cnt == 0) continue;
+            w = arr_grow(walk, &walk_cap, depth + 1, sizeof(uint32_t));
+            if(w == NULL) return found;
+            walk = w;
+            walk[depth++] = c;
+        }
+    }
+    return found;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void add_cb(doc_id_t id)
+{
+    searchidx_mark(id);         //Its widget isn't ready yet, it's indexed at the next query
+}
+
+static void remove_cb(doc_id_t id)
+{
+    if(id >= rec_cap) return;
+    node_unindex(id);
+    recs[id].queued = 0;        //Its ID can be reused and queued again
+}
+
+static void queue_flush(void)
+{
+    uint32_t i;
+    for(i = 0; i < queue_cnt; i++)
+    {
+        doc_id_t id = queue[i];
+        if(!recs[id].queued) continue;      //Freed since it was queued
+        recs[id].queued = 0;
+        node_unindex(id);
+        if(doc_get(id) != NULL) node_index(id);
+    }
+    queue_cnt = 0;
+}
+
+static bool rec_reserve(doc_id_t id)
+{
+    if(id < rec_cap) return true;
+    uint32_t old_cap = rec_cap;
+    rec_t * r = arr_grow(recs, &rec_cap, id + 1, sizeof(rec_t));
+    if(r == NULL)
+    {
+        oom = true;
+        return false;
+    }
+    recs = r;
+    memset(&recs[old_cap], 0, (rec_cap - old_cap) * sizeof(rec_t));
+    return true;
+}
+
+static void node_index(doc_id_t id)
+{
+    lv_obj_t * obj = doc_get(id)->obj;
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return;
+
+    rec_t * r = &recs[id];
+    r->indexed = 1;
+    r->first_post = IDX_NONE;
+    r->trie = TRIE_NONE;
+    const lv_style_t * style = lv_obj_get_style(obj);
+    bool ok = post_add(id, key_get('t', &info->type, sizeof(info->type)));
+    ok = ok && post_add(id, key_get('s', &style, sizeof(style)));
+
+    //The words of the text, lower case
+    const char * text = widgetreg_text_get(obj, info->type);
+    uint32_t words = 0;
+    while(ok && text != NULL && *text != '\0' && words < SEARCHIDX_WORDS_MAX)
+    {
+        char word[SEARCHIDX_WORD_MAX];
+        size_t len = 0;
+        while(*text != '\0' && !isalnum((unsigned char)*text) && (unsigned char)*text < 0x80) text++;
+        while(*text != '\0' && (isalnum((unsigned char)*text) || (unsigned char)*text >= 0x80))
+        {
+            if(len < sizeof(word)) word[len++] = tolower((unsigned char)*text);
+            text++;
+        }
+        if(len == 0) break;
+        uint64_t key = key_get('w', word, len);
+        if(!node_has_key(id, key)) ok = post_add(id, key);
+        words++;
+    }
+
+    strcpy(r->id, info->id);
+    ok = ok && trie_insert(id);
+    if(!ok) oom = true;
+}
+
+static void node_unindex(doc_id_t id)
+{
+    rec_t * r = &recs[id];
+    if(!r->indexed) return;
+
+    uint32_t p = r->first_post;
+    while(p != IDX_NONE)
+    {
+        post_t * e = &posts[p];
+        slot_t * s = slot_find(e->key, false);
+        if(e->key_prev != IDX_NONE) posts[e->key_prev].key_next = e->key_next;
+        else s->head = e->key_next;
+        if(e->key_next != IDX_NONE) posts[e->key_next].key_prev = e->key_prev;
+        s->cnt--;
+
+        uint32_t next = e->node_next;
+        e->node_next = post_free;
+        post_free = p;
+        p = next;
+    }
+    r->first_post = IDX_NONE;
+    if(r->trie != TRIE_NONE) trie_remove(id);
+    r->indexed = 0;
+}
+
+static bool post_add(doc_id_t id, uint64_t key)
+{
+    slot_t * s = slot_find(key, true);
+    if(s == NULL) return false;
+
+    uint32_t p = post_free;
+    if(p != IDX_NONE)
+    {
+        post_free = posts[p].node_next;
+    }else
+    {
+        if(post_cnt == 0) post_cnt = 1;
+        post_t * e = arr_grow(posts, &post_cap, post_cnt + 1, sizeof(post_t));
+        if(e == NULL) return false;
+        posts = e;
+        p = post_cnt++;
+    }
+
+    post_t * e = &posts[p];
+    e->key = key;
+    e->node = id;
+    e->key_prev = IDX_NONE;
+    e->key_next = s->head;
+    if(s->head != IDX_NONE) posts[s->head].key_prev = p;
+    s->head = p;
+    s->cnt++;
+    e->node_next = recs[id].first_post;
+    recs[id].first_post = p;
+    return true;
+}
+
+//The slot of a key. The keys stay in the table with 0 postings, there are only a few kinds of them.
+static slot_t * slot_find(uint64_t key, bool add)
+{
+    if(add && slot_used * 2 >= slot_mask && !slots_grow()) return NULL;
+    if(slots == NULL) return NULL;
+
+    uint32_t i = (uint32_t)key & slot_mask;
+    while(slots[i].key != 0)
+    {
+        if(slots[i].key == key) return &slots[i];
+        i = (i + 1) & slot_mask;
+    }
+    if(!add) return NULL;
+    slots[i].key = key;
+    slots[i].head = IDX_NONE;
+    slots[i].cnt = 0;
+    slot_used++;
+    return &slots[i];
+}
+
+static bool slots_grow(void)
+{
+    uint32_t new_mask = slot_mask ? slot_mask * 2 + 1 : INIT_SLOTS - 1;
+    slot_t * new_slots = calloc(new_mask + 1, sizeof(slot_t));
+    if(new_slots == NULL) return false;
+    uint32_t i;
+    for(i = 0; slots != NULL && i <= slot_mask; i++)
+    {
+        if(slots[i].key == 0) continue;
+        uint32_t j = (uint32_t)slots[i].key & new_mask;
+        while(new_slots[j].key != 0) j = (j + 1) & new_mask;
+        new_slots[j] = slots[i];
+    }
+    free(slots);
+    slots = new_slots;
+    slot_mask = new_mask;
+    return true;
+}
+
+static bool trie_insert(doc_id_t id)
+{
+    rec_t * r = &recs[id];
+    uint32_t t = trie_find(r->id, true);
+    if(t == TRIE_NONE) return false;
+
+    //Count it on the path
+    uint32_t c = 0;
+    const char * s = r->id;
+    trie[0].cnt++;
+    while(*s != '\0')
+    {
+        for(c = trie[c].child; trie[c].c != *s; c = trie[c].sibling);
+        trie[c].cnt++;
+        s++;
+    }
+
+    r->trie = t;
+    r->id_prev = IDX_NONE;
+    r->id_next = trie[t].members;
+    if(r->id_next != IDX_NONE) recs[r->id_next].id_prev = id;
+    trie[t].members = id;
+    return true;
+}
+
+static void trie_remove(doc_id_t id)
+{
+    rec_t * r = &recs[id];
+    uint32_t c = 0;
+    const char * s = r->id;
+    trie[0].cnt--;
+    while(*s != '\0')
+    {
+        for(c = trie[c].child; trie[c].c != *s; c = trie[c].sibling);
+        trie[c].cnt--;
+        s++;
+    }
+
+    if(r->id_prev != IDX_NONE) recs[r->id_prev].id_next = r->id_next;
+    else trie[r->trie].members = r->id_next;
+    if(r->id_next != IDX_NONE) recs[r->id_next].id_prev = r->id_prev;
+    r->trie = TRIE_NONE;
+}
+
+//The trie node of a prefix, TRIE_NONE if there is none (or out of memory). The root for "".
+static uint32_t trie_find(const char * prefix, bool add)
+{
+    uint32_t t = 0;
+    for(; *prefix != '\0'; prefix++)
+    {
+        uint32_t c;
+        for(c = trie[t].child; c != IDX_NONE && trie[c].c != *prefix; c = trie[c].sibling);
+        if(c == IDX_NONE)
+        {
+            if(!add) return TRIE_NONE;
+            trie_t * n = arr_grow(trie, &trie_cap, trie_cnt + 1, sizeof(trie_t));
+            if(n == NULL) return TRIE_NONE;
+            trie = n;
+            c = trie_cnt++;
+            memset(&trie[c], 0, sizeof(trie_t));
+            trie[c].c = *prefix;
+            trie[c].sibling = trie[t].child;
+            trie[t].child = c;
+        }
+        t = c;
+    }
+    return t;
+}
+
+static bool term_parse(term_t * term, const char * str)
+{
+    const char * colon = strchr(str, ':');
+    const char * value = colon ? colon + 1 : str;
+    size_t kind_len = colon ? (size_t)(colon - str) : 0;
+    if(kind_len == 0 || kind_is(str, kind_len, "id"))
+    {
+        term->kind = TERM_ID;
+        if(strlen(value) >= sizeof(term->str)) return false;
+        strcpy(term->str, value);
+        term->trie = trie_find(value, false);
+        term->cnt = term->trie != TRIE_NONE ? trie[term->trie].cnt : 0;
+        return true;
+    }
+
+    if(kind_is(str, kind_len, "type"))
+    {
+        const widget_desc_t * desc = widgetreg_find_tag(value);
+        if(desc == NULL) return false;
+        term->kind = TERM_TYPE;
+        term->key = key_get('t', &desc->type, sizeof(desc->type));
+    }else if(kind_is(str, kind_len, "style"))
+    {
+        const lv_style_t * style = style_by_name(value);
+        lv_obj_t * obj = style ? NULL : widgetid_find(value);
+        if(obj != NULL) style = lv_obj_get_style(obj);
+        if(style == NULL) return false;
+        term->kind = TERM_STYLE;
+        term->key = key_get('s', &style, sizeof(style));
+    }else if(kind_is(str, kind_len, "text"))
+    {
+        char word[SEARCHIDX_WORD_MAX];
+        size_t len;
+        for(len = 0; value[len] != '\0' && len < sizeof(word); len++) word[len] = tolower((unsigned char)value[len]);
+        if(len == 0) return false;
+        term->kind = TERM_TEXT;
+        term->key = key_get('w', word, len);
+    }else
+    {
+        return false;
+    }
+    slot_t * s = slot_find(term->key, false);
+    term->cnt = s ? s->cnt : 0;
+    return true;
+}
+
+static bool kind_is(const char * str, size_t len, const char * kind)
+{
+    return len == strlen(kind) && !strncmp(str, kind, len);
+}
+
+static bool term_match(const term_t * term, doc_id_t id)
+{
+    if(term->kind == TERM_ID) return !strncmp(recs[id].id, term->str, strlen(term->str));
+    return node_has_key(id, term->key);
+}
+
+static bool node_has_key(doc_id_t id, uint64_t key)
+{
+    uint32_t p;
+    for(p = recs[id].first_post; p != IDX_NONE; p = posts[p].node_next)
+    {
+        if(posts[p].key == key) return true;
+    }
+    return false;
+}
+
+//Never 0, that marks the free slots
+static uint64_t key_get(char kind, const void * data, size_t size)
+{
+    uint64_t h = HASH_INIT;
+    h ^= (uint8_t)kind;
+    h *= HASH_PRIME;
+    const uint8_t * d = data;
+    size_t i;
+    for(i = 0; i < size; i++)
+    {
+        h ^= d[i];
+        h *= HASH_PRIME;
+    }
+    return h | 1;
+}
+
+static const lv_style_t * style_by_name(const char * name)
+{
+    uint32_t i;
+    for(i = 0; i < sizeof(builtin_styles) / sizeof(builtin_styles[0]); i++)
+    {
+        if(!strcmp(builtin_styles[i].name, name)) return builtin_styles[i].style;
+    }
+    return NULL;
+}
+
+//Make room for `need` elements, doubling the capacity. NULL if out of memory, `arr` stays valid then.
+static void * arr_grow(void * arr, uint32_t * cap, uint32_t need, size_t size)
+{
+    if(need <= *cap && arr != NULL) return arr;
+    uint32_t new_cap = *cap ? *cap : 64;
+    while(new_cap < need) new_cap *= 2;
+    void * p = realloc(arr, new_cap * size);
+    if(p == NULL) return NULL;
+    *cap = new_cap;
+    return p;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file searchidx.h
+ *
+ */
+
+#ifndef _SEARCHIDX_H_
+#define _SEARCHIDX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SEARCHIDX_TERM_MAX      4       //Terms of a query
+#define SEARCHIDX_WORD_MAX      32      //Longer words of the texts are indexed by their start
+#define SEARCHIDX_WORDS_MAX     64      //Words of a text indexed, the rest can't be searched
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**
+ * Called on every widget matching a query
+ * @param id its node
+ * @param user_data from searchidx_query()
+ */
+typedef void (*searchidx_cb_t)(doc_id_t id, void * user_data);
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void searchidx_init(void);
+void searchidx_mark(doc_id_t id);
+int32_t searchidx_query(const char * query, searchidx_cb_t cb, void * user_data);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -9,12 +9,21 @@
 #include "./lvgl/lvgl.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include "setting.h"
 #include "dataset.h"
 #include "custom_widget.h"
 #include "gencode.h"
 #include "loadproj.h"
 #include "saveproj.h"
+#include "projjob.h"
+#include "widgetid.h"
+#include "undo.h"
+#include "propbind.h"
+#include "bulkedit.h"
+#include "searchidx.h"
+#include "autosave.h"
 
 #if LV_EX_KEYBOARD || LV_EX_MOUSEWHEEL
 #include "lv_drv_conf.h"
@@ -42,15 +51,24 @@ extern lv_obj_t * tft_win;
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    doc_id_t screen;            //Only its widgets are selected
+    uint32_t shown;
+}search_ctx_t;
+
 typedef struct
 {
     lv_obj_t * obj_selected;
+    lv_obj_t * id;
     lv_obj_t * pos_x;
     lv_obj_t * pos_y;
     lv_obj_t * size_h;
     lv_obj_t * size_w;
     lv_obj_t * drag;
     lv_obj_t * click;
+    lv_obj_t * radius;
+    lv_obj_t * font_size;
     
 }setting_attr_panel_t;
 
@@ -59,11 +77,51 @@ typedef struct
  **********************/
 static void setting_indev_init(lv_group_t * g);
 static void saveproj_cb(lv_obj_t * obj, lv_event_t ev);
+static void rename_cb(lv_obj_t * ta, lv_event_t ev)
+{
+    bool apply = ev == LV_EVENT_DEFOCUSED;
+    if(ev == LV_EVENT_KEY) apply = *((const uint32_t *)lv_event_get_data()) == LV_KEY_ENTER;
+    if(apply)
+    {
+        lv_obj_t * obj = layerview_get_sel_obj();
+        if(obj == NULL) return;
+        char old_id[sizeof(widget_get_info(obj)->id)];
+        strcpy(old_id, widget_get_info(obj)->id);
+        if(widgetid_rename(obj, lv_ta_get_text(ta)))
+        {
+            undo_record_rename(layerview_get_sel_node(), old_id);
+            autosave_mark(layerview_get_sel_node());
+            propbind_changed(obj, PROP_ID);
+            layerview_refr_request();
+        }else
+        {
+            propbind_resend(PROP_ID);       //Invalid or taken, show the old one
+        }
+    }
+}
+
 static void loadproj_cb(lv_obj_t * obj, lv_event_t ev);
+static void codegen_cb(lv_obj_t * obj, lv_event_t ev);
+static void rename_cb(lv_obj_t * ta, lv_event_t ev);
+static void field_cb(lv_obj_t * ta, lv_event_t ev);
+static void field_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data);
+static void id_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data);
+static void selected_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data);
+static void field_bind(lv_group_t * g, lv_obj_t * ta, prop_t prop);
+static void search_cb(lv_obj_t * ta, lv_event_t ev);
+static void search_found_cb(doc_id_t id, void * user_data);
+static void job_indicator_show(projjob_kind_t kind);
+static void job_indicator_hide(void);
+static void job_progress_cb(projjob_kind_t kind, uint32_t done, uint32_t total);
+static void job_done_cb(projjob_kind_t kind, bool ok);
 /**********************
  *  STATIC VARIABLES
  **********************/
 static setting_attr_panel_t base_attr;
+static const char * prop_names[_PROP_NUM] = {"ID", "X", "Y", "width", "height", "radius", "font size"};
+static lv_obj_t * job_bar = NULL;       //Progress of the running save/load/code generation
+static lv_obj_t * search_info = NULL;   //Matches and time of the last search
+static const char * job_titles[] = {"Setting (saving...)", "Setting (loading...)", "Setting (generating code...)"};
 /**********************
  *      MACROS
  **********************/
@@ -78,6 +136,9 @@ void setting_win_init(lv_obj_t * parent)
     lv_win_set_title(setting_win, "Setting");
     lv_obj_set_size(setting_win, lv_obj_get_width_fit(parent) / 4.5 , lv_obj_get_height(parent));
     lv_obj_align(setting_win, NULL, LV_ALIGN_IN_RIGHT_MID, 0, 0);
+#if LV_USE_LAYER_CACHE
+    lv_obj_set_layer_cache(setting_win, true);     //Redrawn from its bitmap until a setting is changed
+#endif
     lv_page_set_scrl_fit2(lv_win_get_content(setting_win), LV_FIT_FLOOD, LV_FIT_TIGHT);
     lv_page_set_scrl_layout(lv_win_get_content(setting_win), LV_LAYOUT_PRETTY);
 
@@ -89,22 +150,31 @@ void setting_win_init(lv_obj_t * parent)
     lv_obj_set_protect(win_btn, LV_PROTECT_CLICK_FOCUS);
     lv_obj_set_event_cb(win_btn, loadproj_cb);    
 
+    win_btn = lv_win_add_btn(setting_win, LV_SYMBOL_FILE);
+    lv_obj_set_protect(win_btn, LV_PROTECT_CLICK_FOCUS);
+    lv_obj_set_event_cb(win_btn, codegen_cb);
+
+    projjob_set_cb(job_progress_cb, job_done_cb);
+
     lv_group_t * g = lv_group_create();
     setting_indev_init(g);
 
     //ID
-
+    lv_obj_t * cont_id = tbox_create(setting_win, "ID: ");
+    base_attr.id = tbox_get_ta(cont_id);
+    lv_obj_set_event_cb(base_attr.id, rename_cb);
+    lv_group_add_obj(g, base_attr.id);
+    propbind_subscribe(PROP_ID, id_show_cb, base_attr.id);
 
     //POSITION
     lv_obj_t * title = lv_label_create(setting_win, NULL);
     lv_label_set_text(title, "\n\n\n[Postion]");
     lv_obj_t * cont_x = tbox_create(setting_win, "X: ");
     lv_obj_t * cont_y = tbox_create(setting_win, "Y: ");
-    // base_attr.pos_x = tbox_get_ta(cont_x);
-    // base_attr.pos_y = tbox_get_ta(cont_y);
-    // lv_group_add_obj(g, base_attr.pos_x);
-    // lv_group_add_obj(g, base_attr.pos_y);
-
+    base_attr.pos_x = tbox_get_ta(cont_x);
+    base_attr.pos_y = tbox_get_ta(cont_y);
+    field_bind(g, base_attr.pos_x, PROP_X);
+    field_bind(g, base_attr.pos_y, PROP_Y);
 
     //SIZE
     title = lv_label_create(setting_win, NULL);
@@ -113,6 +183,8 @@ void setting_win_init(lv_obj_t * parent)
     lv_obj_t * cont_w = tbox_create(setting_win, "Width:");
     base_attr.size_h = tbox_get_ta(cont_h);
     base_attr.size_w = tbox_get_ta(cont_w);
+    field_bind(g, base_attr.size_h, PROP_H);
+    field_bind(g, base_attr.size_w, PROP_W);
     
     //DRAG && CLICK
     lv_obj_t * cb_drag = lv_cb_create(setting_win, NULL);
@@ -121,9 +193,32 @@ void setting_win_init(lv_obj_t * parent)
     lv_obj_t * cb_click = lv_cb_create(setting_win, cb_drag);
     lv_cb_set_text(cb_click, "Click    ");
     lv_obj_align(cb_click, cb_drag, LV_ALIGN_OUT_RIGHT_MID, 20, 0); 
+
+    //STYLE
+    title = lv_label_create(setting_win, NULL);
+    lv_label_set_text(title, "[Style]");
+    lv_obj_t * cont_radius = tbox_create(setting_win, "Radius:");
+    base_attr.radius = tbox_get_ta(cont_radius);
+    field_bind(g, base_attr.radius, PROP_RADIUS);
+    lv_obj_t * cont_font_size = tbox_create(setting_win, "Font size:");     //Of a TrueType font, 0: the default font
+    base_attr.font_size = tbox_get_ta(cont_font_size);
+    field_bind(g, base_attr.font_size, PROP_FONT_SIZE);
     
     //SElECTED
     base_attr.obj_selected = lv_label_create(setting_win, NULL);
+    propbind_subscribe(PROP_ID, selected_show_cb, base_attr.obj_selected);
+
+    //SEARCH
+    lv_obj_t * search_ta = lv_ta_create(setting_win, NULL);
+    lv_ta_set_one_line(search_ta, true);
+    lv_ta_set_text(search_ta, "");
+    lv_ta_set_placeholder_text(search_ta, "type:btn id:btn_ text:ok");
+    lv_ta_set_cursor_type(search_ta, LV_CURSOR_NONE);
+    lv_obj_set_width(search_ta, lv_page_get_fit_width(lv_win_get_content(setting_win)));
+    lv_obj_set_event_cb(search_ta, search_cb);
+    lv_group_add_obj(g, search_ta);
+    search_info = lv_label_create(setting_win, NULL);
+    lv_label_set_text(search_info, "");
 
     //Layer View
     layerview_init(setting_win);
@@ -134,26 +229,6 @@ void setting_win_init(lv_obj_t * parent)
 
 }
 
-void setting_attr_mod(lv_obj_t * obj)
-{
-    lv_coord_t x = lv_obj_get_x(obj);
-    char x_str[8];
-    snprintf(x_str, 8, "%d", x);
-    lv_ta_set_text(base_attr.pos_x, x_str);
-    lv_coord_t y = lv_obj_get_y(obj);
-    char y_str[8];
-    snprintf(y_str, 8, "%d", y);    
-    lv_ta_set_text(base_attr.pos_y, y_str);
-}
-
-void lb_selected_mod(lv_obj_t * obj)
-{
-    widget_info_t * info = lv_obj_get_user_data(obj);
-    char str[30];
-    snprintf(str, 29, "(%s)%x", widget_get_type_name(info->type), obj);
-    lv_label_set_text(base_attr.obj_selected, str);
-}
-
 /**********************
  *   STATIC FUNCTIONS
  **********************/
@@ -179,18 +254,170 @@ static void setting_indev_init(lv_group_t * g)
 }
 
 
+//Select the widgets of the open screen matching the query while it's typed
+static void search_cb(lv_obj_t * ta, lv_event_t ev)
+{
+    if(ev != LV_EVENT_VALUE_CHANGED) return;
+    const char * query = lv_ta_get_text(ta);
+    if(query[0] == '\0')
+    {
+        lv_label_set_text(search_info, "");
+        return;
+    }
+
+    search_ctx_t ctx;
+    ctx.screen = doc_get_screen();
+    ctx.shown = 0;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    int32_t found = searchidx_query(query, search_found_cb, &ctx);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    uint32_t us = (t1.tv_sec - t0.tv_sec) * 1000000 + (t1.tv_nsec - t0.tv_nsec) / 1000;
+
+    if(found < 0) lv_label_set_text(search_info, "Invalid search");
+    else if(ctx.shown == (uint32_t)found) lv_label_set_text_fmt(search_info, "%u found in %u us", ctx.shown, us);
+    else lv_label_set_text_fmt(search_info, "%u found (%d on other screens) in %u us", ctx.shown, found - ctx.shown, us);
+}
+
+//Select a match and unfold its ancestors so its row is shown. The old selection is kept if nothing matches.
+static void search_found_cb(doc_id_t id, void * user_data)
+{
+    search_ctx_t * ctx = user_data;
+    if(!doc_is_descendant(id, ctx->screen)) return;
+    if(ctx->shown == 0) layerview_clear_sel();
+    ctx->shown++;
+
+    doc_id_t p;
+    for(p = doc_get(id)->parent; p != ctx->screen && p != DOC_ROOT; p = doc_get(p)->parent)
+    {
+        layerview_set_collapsed(p, false);
+    }
+    layerview_add_sel(id);
+}
+
+//The jobs run on a worker thread, the designer stays usable while they run
 static void saveproj_cb(lv_obj_t * obj, lv_event_t ev)
 {
-    if(ev == LV_EVENT_CLICKED)
+    if(ev == LV_EVENT_CLICKED && !projjob_is_busy())
     {
-        // save_project(tft_win);
+        job_indicator_show(PROJJOB_SAVE);
+        if(!projjob_save()) job_indicator_hide();
     }
 }
 
 static void loadproj_cb(lv_obj_t * obj, lv_event_t ev)
 {
-    if(ev == LV_EVENT_CLICKED)
+    if(ev == LV_EVENT_CLICKED && !projjob_is_busy())
+    {
+        job_indicator_show(PROJJOB_LOAD);
+        if(!projjob_load(tft_win)) job_indicator_hide();
+    }
+}
+
+static void codegen_cb(lv_obj_t * obj, lv_event_t ev)
+{
+    if(ev == LV_EVENT_CLICKED && !projjob_is_busy())
+    {
+        job_indicator_show(PROJJOB_CODEGEN);
+        if(!projjob_codegen()) job_indicator_hide();
+    }
+}
+
+//A numeric field of the selected widget is edited, the selected widgets are changed when it's applied
+static void field_cb(lv_obj_t * ta, lv_event_t ev)
+{
+    bool apply = ev == LV_EVENT_DEFOCUSED;
+    if(ev == LV_EVENT_KEY) apply = *((const uint32_t *)lv_event_get_data()) == LV_KEY_ENTER;
+    if(!apply) return;
+
+    lv_obj_t * obj = layerview_get_sel_obj();
+    if(obj == NULL) return;
+    prop_t prop;
+    if(ta == base_attr.pos_x) prop = PROP_X;
+    else if(ta == base_attr.pos_y) prop = PROP_Y;
+    else if(ta == base_attr.size_w) prop = PROP_W;
+    else if(ta == base_attr.size_h) prop = PROP_H;
+    else if(ta == base_attr.radius) prop = PROP_RADIUS;
+    else prop = PROP_FONT_SIZE;
+
+    char * end;
+    long value = strtol(lv_ta_get_text(ta), &end, 10);
+    if(end == lv_ta_get_text(ta) || *end != '\0' || value < INT32_MIN || value > INT32_MAX ||
+       !bulkedit_set(prop, value))
+    {
+        printf("Can't set the %s to %s\n", prop_names[prop], lv_ta_get_text(ta));
+        propbind_resend(prop);      //Show the old one
+    }
+}
+
+static void field_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data)
+{
+    (void)obj;
+    (void)prop;
+    char str[12];
+    snprintf(str, sizeof(str), "%d", value);
+    lv_ta_set_text(user_data, str);
+}
+
+static void id_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data)
+{
+    (void)prop;
+    (void)value;
+    lv_ta_set_text(user_data, widget_get_info(obj)->id);
+}
+
+static void selected_show_cb(lv_obj_t * obj, prop_t prop, int32_t value, void * user_data)
+{
+    (void)prop;
+    (void)value;
+    widget_info_t * info = widget_get_info(obj);
+    char str[30];
+    snprintf(str, 29, "(%s)%s", widget_get_type_name(info->type), info->id);
+    lv_label_set_text(user_data, str);
+}
+
+static void field_bind(lv_group_t * g, lv_obj_t * ta, prop_t prop)
+{
+    lv_obj_set_event_cb(ta, field_cb);
+    lv_group_add_obj(g, ta);
+    propbind_subscribe(prop, field_show_cb, ta);
+}
+
+static void job_indicator_show(projjob_kind_t kind)
+{
+    lv_win_set_title(setting_win, job_titles[kind]);
+
+    if(job_bar == NULL) job_bar = lv_bar_create(lv_layer_top(), NULL);
+    lv_obj_set_size(job_bar, lv_obj_get_width(setting_win), LV_DPI / 10);
+    lv_obj_align(job_bar, setting_win, LV_ALIGN_IN_BOTTOM_MID, 0, 0);
+    lv_bar_set_range(job_bar, 0, 100);
+    lv_bar_set_value(job_bar, 0, LV_ANIM_OFF);
+}
+
+static void job_indicator_hide(void)
+{
+    lv_win_set_title(setting_win, "Setting");
+    if(job_bar != NULL) lv_obj_del(job_bar);
+    job_bar = NULL;
+}
+
+static void job_progress_cb(projjob_kind_t kind, uint32_t done, uint32_t total)
+{
+    (void)kind;
+    if(job_bar == NULL || total == 0) return;
+    lv_bar_set_value(job_bar, (uint64_t)done * 100 / total, LV_ANIM_OFF);
+}
+
+static void job_done_cb(projjob_kind_t kind, bool ok)
+{
+    job_indicator_hide();
+    if(!ok) printf("%s failed\n", kind == PROJJOB_LOAD ? "Load" : kind == PROJJOB_SAVE ? "Save" : "Code generation");
+#if LV_EX_PRINTF
+    if(kind == PROJJOB_LOAD && ok)
     {
-        load_project(tft_win);
+        const loadproj_stats_t * stats = load_project_get_stats();
+        printf("Loaded %u widgets (%u elements), peak depth: %u, stack allocs: %u\n",
+               stats->widgets, stats->elements, stats->peak_depth, stats->stack_allocs);
     }
-}
\ No newline at end of file
+#endif
+}
@@ -0,0 +1,326 @@
+/**
+ * @file snapguide.c
+ * Snapping of a dragged widget to the edges and the centres of its siblings and its parent, or to a grid.
+ * When a drag begins the edges of the siblings are collected into a sorted array per axis, so the nearest
+ * edge is found by a binary search on every move however many siblings there are. The widget follows the
+ * pointer from where it would be without snapping, and a snapped edge is shown by a guide line on the top
+ * layer: only the lines are redrawn besides the widget. Alt held while dragging turns the snapping off.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <SDL2/SDL.h>
+#include "snapguide.h"
+#include "dataset.h"
+#include "custom_widget.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SNAPGUIDE_NONE      LV_COORD_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    AXIS_X,
+    AXIS_Y,
+    _AXIS_NUM,
+}axis_t;
+
+//The edges of one axis, sorted
+typedef struct
+{
+    lv_coord_t * pos;           //Relative to the parent, like lv_obj_get_x/y()
+    uint32_t cnt;
+    uint32_t cap;
+}edge_index_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool index_build(lv_obj_t * obj);
+static bool edges_add(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h);
+static bool edge_push(edge_index_t * idx, lv_coord_t pos);
+static int edge_cmp(const void * a, const void * b);
+static lv_coord_t edge_nearest(const edge_index_t * idx, lv_coord_t pos);
+static lv_coord_t snap_axis(axis_t axis, lv_coord_t raw, lv_coord_t size, lv_coord_t * guide);
+static void snap_apply(lv_obj_t * obj);
+static void guide_show(axis_t axis, lv_coord_t pos);
+static void guide_hide(axis_t axis);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static edge_index_t edges[_AXIS_NUM];
+static lv_obj_t * guides[_AXIS_NUM];
+static lv_style_t guide_style;
+static bool guide_style_inited = false;
+static lv_coord_t grid = SNAPGUIDE_GRID_DEF;
+static lv_coord_t dist = SNAPGUIDE_DIST_DEF;
+
+//The dragged widget, where the pointer would have moved it and where it was put
+static lv_obj_t * drag_obj = NULL;
+static lv_obj_t * drag_par = NULL;
+static lv_coord_t raw_x, raw_y;
+static lv_coord_t set_x, set_y;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Snap the left and top edges to a grid of `step` pixels when no edge is near. 0: no grid.
+void snapguide_set_grid(lv_coord_t step)
+{
+    grid = step > 0 ? step : 0;
+}
+
+//Snap an edge to an other one closer than `d` pixels. 0: don't snap to the edges.
+void snapguide_set_dist(lv_coord_t d)
+{
+    dist = d > 0 ? d : 0;
+}
+
+//A widget is started to be dragged, index the edges of its siblings
+void snapguide_drag_begin(lv_obj_t * obj)
+{
+    drag_obj = NULL;
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    if(par == NULL || widget_get_info(obj) == NULL) return;
+    if(dist == 0 && grid == 0) return;
+    if(!index_build(obj))
+    {
+        printf("Snap guides: out of memory\n");
+        return;
+    }
+
+    drag_obj = obj;
+    drag_par = par;
+    raw_x = set_x = lv_obj_get_x(obj);
+    raw_y = set_y = lv_obj_get_y(obj);
+    snap_apply(obj);
+}
+
+//The dragged widget moved, put it to the nearest edge or grid line
+void snapguide_drag(lv_obj_t * obj)
+{
+    if(obj != drag_obj || lv_obj_get_parent(obj) != drag_par) return;
+
+    if(lv_obj_get_x(obj) == set_x && lv_obj_get_y(obj) == set_y) return;     //Not moved since it was put
+    snap_apply(obj);
+}
+
+//The drag ended, the widget stays where it was snapped
+void snapguide_drag_end(lv_obj_t * obj)
+{
+    if(obj != drag_obj) return;
+    snapguide_drag(obj);
+    guide_hide(AXIS_X);
+    guide_hide(AXIS_Y);
+    drag_obj = NULL;
+    drag_par = NULL;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Collect the edges and centres of the siblings of `obj` and of its parent. The selected ones move with it.
+static bool index_build(lv_obj_t * obj)
+{
+    edges[AXIS_X].cnt = 0;
+    edges[AXIS_Y].cnt = 0;
+
+    lv_obj_t * par = lv_obj_get_parent(obj);
+    if(!edges_add(0, 0, lv_obj_get_width(par), lv_obj_get_height(par))) return false;
+
+    widget_info_t * info = widget_get_info(obj);
+    bool moved_along = layerview_is_sel(info->node);
+    lv_obj_t * child;
+    LV_LL_READ(par->child_ll, child)
+    {
+        if(child == obj || lv_obj_get_hidden(child)) continue;
+        widget_info_t * ci = widget_get_info(child);
+        if(ci == NULL) continue;                    //Not a widget of the project, e.g. the scrollbar
+        if(moved_along && layerview_is_sel(ci->node)) continue;
+        if(!edges_add(lv_obj_get_x(child), lv_obj_get_y(child), lv_obj_get_width(child), lv_obj_get_height(child)))
+        {
+            return false;
+        }
+    }
+
+    axis_t a;
+    for(a = 0; a < _AXIS_NUM; a++)
+    {
+        qsort(edges[a].pos, edges[a].cnt, sizeof(lv_coord_t), edge_cmp);
+    }
+    return true;
+}
+
+static bool edges_add(lv_coord_t x, lv_coord_t y, lv_coord_t w, lv_coord_t h)
+{
+    return edge_push(&edges[AXIS_X], x) && edge_push(&edges[AXIS_X], x + w / 2) && edge_push(&edges[AXIS_X], x + w) &&
+           edge_push(&edges[AXIS_Y], y) && edge_push(&edges[AXIS_Y], y + h / 2) && edge_push(&edges[AXIS_Y], y + h);
+}
+
+static bool edge_push(edge_index_t * idx, lv_coord_t pos)
+{
+    if(idx->cnt == idx->cap)
+    {
+        uint32_t cap = idx->cap ? idx->cap * 2 : 64;
+        lv_coord_t * p = realloc(idx->pos, cap * sizeof(lv_coord_t));
+        if(p == NULL) return false;
+        idx->pos = p;
+        idx->cap = cap;
+    }
+    idx->pos[idx->cnt++] = pos;
+    return true;
+}
+
+static int edge_cmp(const void * a, const void * b)
+{
+    lv_coord_t pa = *(const lv_coord_t *)a;
+    lv_coord_t pb = *(const lv_coord_t *)b;
+    return (pa > pb) - (pa < pb);
+}
+
+//The indexed edge nearest to `pos` by a binary search, SNAPGUIDE_NONE if there is none
+static lv_coord_t edge_nearest(const edge_index_t * idx, lv_coord_t pos)
+{
+    if(idx->cnt == 0) return SNAPGUIDE_NONE;
+
+    uint32_t lo = 0;
+    uint32_t hi = idx->cnt;
+    while(lo < hi)      //The first edge not before `pos`
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if(idx->pos[mid] < pos) lo = mid + 1;
+        else hi = mid;
+    }
+
+    if(lo == idx->cnt) return idx->pos[lo - 1];
+    if(lo == 0) return idx->pos[0];
+    return pos - idx->pos[lo - 1] <= idx->pos[lo] - pos ? idx->pos[lo - 1] : idx->pos[lo];
+}
+
+/**
+ * Snap the start, the centre or the end of a widget on an axis, whichever is the closest to an edge.
+ * Without a near edge its start snaps to the grid.
+ * @param axis AXIS_X or AXIS_Y
+ * @param raw the start where the pointer moved it
+ * @param size its width or height
+ * @param guide store the snapped edge here to show it, unchanged if it didn't snap to an edge
+ * @return the new start
+ */
+static lv_coord_t snap_axis(axis_t axis, lv_coord_t raw, lv_coord_t size, lv_coord_t * guide)
+{
+    lv_coord_t ofs[3] = {0, size / 2, size};
+    lv_coord_t best = SNAPGUIDE_NONE;
+    lv_coord_t best_d = dist + 1;
+    uint8_t i;
+    for(i = 0; i < 3 && dist > 0; i++)
+    {
+        lv_coord_t e = edge_nearest(&edges[axis], raw + ofs[i]);
+        if(e == SNAPGUIDE_NONE) break;
+        lv_coord_t d = LV_MATH_ABS(e - (raw + ofs[i]));
+        if(d < best_d)
+        {
+            best_d = d;
+            best = e - ofs[i];
+            *guide = e;
+        }
+    }
+    if(best != SNAPGUIDE_NONE) return best;
+
+    if(grid > 0)
+    {
+        lv_coord_t g = raw >= 0 ? (raw + grid / 2) / grid : -((-raw + grid / 2) / grid);
+        return g * grid;
+    }
+    return raw;
+}
+
+//Put the dragged widget to the nearest edge or grid line from where the pointer moved it
+static void snap_apply(lv_obj_t * obj)
+{
+    lv_coord_t x = lv_obj_get_x(obj);
+    lv_coord_t y = lv_obj_get_y(obj);
+    //The drag moves the widget from where it was put, so follow the pointer from the unsnapped position
+    raw_x += x - set_x;
+    raw_y += y - set_y;
+
+    lv_coord_t gx = SNAPGUIDE_NONE;
+    lv_coord_t gy = SNAPGUIDE_NONE;
+    if(SDL_GetModState() & KMOD_ALT)
+    {
+        set_x = raw_x;
+        set_y = raw_y;
+    }else
+    {
+        set_x = snap_axis(AXIS_X, raw_x, lv_obj_get_width(obj), &gx);
+        set_y = snap_axis(AXIS_Y, raw_y, lv_obj_get_height(obj), &gy);
+    }
+    if(set_x != x || set_y != y) lv_obj_set_pos(obj, set_x, set_y);
+
+    if(gx != SNAPGUIDE_NONE) guide_show(AXIS_X, gx);
+    else guide_hide(AXIS_X);
+    if(gy != SNAPGUIDE_NONE) guide_show(AXIS_Y, gy);
+    else guide_hide(AXIS_Y);
+}
+
+//Show the guide of an axis at an edge of the dragged widget's parent
+static void guide_show(axis_t axis, lv_coord_t pos)
+{
+    if(guides[axis] == NULL)
+    {
+        if(!guide_style_inited)
+        {
+            guide_style_inited = true;
+            lv_style_copy(&guide_style, &lv_style_plain);
+            guide_style.body.main_color = LV_COLOR_MAGENTA;
+            guide_style.body.grad_color = LV_COLOR_MAGENTA;
+            guide_style.body.radius = 0;
+            guide_style.body.opa = LV_OPA_COVER;
+        }
+        guides[axis] = lv_obj_create(lv_layer_top(), NULL);
+        if(guides[axis] == NULL) return;
+        lv_obj_set_style(guides[axis], &guide_style);
+        lv_obj_set_click(guides[axis], false);
+    }
+
+    //Only the visible part of the parent, e.g. not the whole scrollable of a page
+    lv_area_t par_a;
+    lv_obj_get_coords(drag_par, &par_a);
+    lv_coord_t x1 = par_a.x1;
+    lv_coord_t y1 = par_a.y1;
+    lv_obj_t * anc;
+    for(anc = lv_obj_get_parent(drag_par); anc != NULL; anc = lv_obj_get_parent(anc))
+    {
+        if(!lv_area_intersect(&par_a, &par_a, &anc->coords)) break;
+    }
+    lv_obj_t * g = guides[axis];
+    if(axis == AXIS_X)
+    {
+        lv_obj_set_size(g, 1, lv_area_get_height(&par_a));
+        lv_obj_set_pos(g, x1 + pos, par_a.y1);
+    }else
+    {
+        lv_obj_set_size(g, lv_area_get_width(&par_a), 1);
+        lv_obj_set_pos(g, par_a.x1, y1 + pos);
+    }
+    lv_obj_set_hidden(g, false);
+}
+
+static void guide_hide(axis_t axis)
+{
+    if(guides[axis] != NULL) lv_obj_set_hidden(guides[axis], true);
+}
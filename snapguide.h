@@ -0,0 +1,56 @@
+/**
+ * @file snapguide.h
+ *
+ */
+
+#ifndef _SNAPGUIDE_H_
+#define _SNAPGUIDE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define SNAPGUIDE_DIST_DEF      (LV_DPI / 20)   //[px] An edge closer than this to an other one snaps to it
+#define SNAPGUIDE_GRID_DEF      0               //[px] Step of the grid, 0: no grid
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void snapguide_set_grid(lv_coord_t step);
+void snapguide_set_dist(lv_coord_t dist);
+void snapguide_drag_begin(lv_obj_t * obj);
+void snapguide_drag(lv_obj_t * obj);
+void snapguide_drag_end(lv_obj_t * obj);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,513 @@
+/**
+ * @file stress.c
+ * Measure the designer's own operations on large synthesized projects: creating the widgets through the Layer View,
+ * selecting them, switching the theme, generating the code, saving, deleting and loading the project.
+ * The designer's GUI is created on an in-memory display and nothing is drawn, so only the data paths are measured.
+ * The project files are written into the given directory, it must not hold a project.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <SDL2/SDL.h>
+#include "stress.h"
+#include "interface.h"
+#include "toolbox.h"
+#include "custom_widget.h"
+#include "doctree.h"
+#include "dataset.h"
+#include "gencode.h"
+#include "saveproj.h"
+#include "loadproj.h"
+#include "stylepool.h"
+#include "undo.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STRESS_BUF_LINES    40
+#define STRESS_GRID_COLS    10      //The widgets of a parent are put on a grid of this many columns
+#define STRESS_PATH_MAX     512
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    const char * name;
+    uint16_t fanout;                //Children of every container, this sets the depth of the tree too
+}stress_shape_t;
+
+typedef enum
+{
+    STRESS_OP_ADD,
+    STRESS_OP_SEL,
+    STRESS_OP_THEME,
+    STRESS_OP_STYLE,
+    STRESS_OP_GENCODE,
+    STRESS_OP_SAVE,
+    STRESS_OP_DEL,
+    STRESS_OP_UNDO,
+    STRESS_OP_LOAD,
+    _STRESS_OP_NUM,
+}stress_op_t;
+
+typedef struct
+{
+    double ms;
+    uint32_t cnt;                   //Repetitions or the handled widgets
+    uint32_t mem_max;               //Highest `lv_mem` usage during the operation [bytes]
+    long rss_kb;                    //Peak resident memory of the process after the operation
+}stress_meas_t;
+
+typedef struct
+{
+    uint32_t size;                  //Requested widgets
+    const stress_shape_t * shape;
+    uint32_t created;               //Less than `size` if `lv_mem` got full
+    uint32_t depth;
+    stress_meas_t ops[_STRESS_OP_NUM];
+}stress_res_t;
+
+//The state of building a project
+typedef struct
+{
+    doc_id_t * nodes;               //Every created widget in the order of creating
+    uint32_t created;
+    uint32_t next_check;            //Check the free memory when this many widgets are created
+    bool full;                      //`lv_mem` is about to run out
+    double ms;
+}stress_build_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void stress_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+static void project_run(lv_obj_t * load_par, uint32_t size, const stress_shape_t * shape, doc_id_t * nodes,
+                        stress_res_t * res);
+static void project_build(stress_build_t * build, uint32_t size, const stress_shape_t * shape, stress_res_t * res);
+static void batch_create(stress_build_t * build, doc_id_t par, widget_type_t type, uint32_t cnt);
+static uint32_t style_edit(const doc_id_t * nodes, uint32_t cnt);
+static void style_edit_cb(lv_style_t * style, void * user_data);
+static uint32_t project_clear(void);
+static void meas_start(uint64_t * t_start);
+static void meas_end(stress_meas_t * meas, uint64_t t_start, uint32_t cnt);
+static void meas_mem(stress_meas_t * meas);
+static double time_ms(uint64_t t_start);
+static long rss_peak_kb(void);
+static void res_print(const stress_res_t * res);
+static bool json_write(const char * path, const stress_res_t * res, uint32_t cnt);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static const stress_shape_t shapes[] =
+{
+    {"wide", 100},
+    {"balanced", 10},
+    {"deep", 2},
+};
+
+#define STRESS_SHAPE_CNT    (sizeof(shapes) / sizeof(shapes[0]))
+
+static const char * op_names[_STRESS_OP_NUM] =
+{
+    "layerview_add", "layerview_set_sel", "toolbox_set_theme", "stylepool_edit", "code_generation", "save_project",
+    "layerview_del", "undo_redo", "load_project",
+};
+
+//The leaves of the tree get these types in turn, the inner nodes are containers
+static const widget_type_t leaf_types[] =
+{
+    WIDGET_TYPE_BTN, WIDGET_TYPE_LABEL, WIDGET_TYPE_SLIDER, WIDGET_TYPE_CB, WIDGET_TYPE_BAR, WIDGET_TYPE_LED,
+};
+
+#define STRESS_LEAF_TYPE_CNT    (sizeof(leaf_types) / sizeof(leaf_types[0]))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Build a project of every size in `sizes` in every shape in `dir` and measure the operations on it.
+//The results are printed and written into `json_path` too if it's not NULL. Call it after `lv_init` instead of creating the GUI.
+bool stress_run(const char * dir, const uint32_t * sizes, uint32_t size_cnt, const char * json_path)
+{
+    char cwd[STRESS_PATH_MAX];
+    if(getcwd(cwd, sizeof(cwd)) == NULL || chdir(dir) != 0)
+    {
+        printf("Can't enter %s\n", dir);
+        return false;
+    }
+    FILE * fp = fopen(LOADPROJ_XML_FILE, "r");
+    if(fp)
+    {
+        fclose(fp);
+        printf("%s has a project (%s), it would be overwritten\n", dir, LOADPROJ_XML_FILE);
+        if(chdir(cwd) != 0) printf("Can't go back to %s\n", cwd);
+        return false;
+    }
+
+    uint32_t size_max = 0;
+    uint32_t i;
+    for(i = 0; i < size_cnt; i++) size_max = LV_MATH_MAX(size_max, sizes[i]);
+
+    //The designer's GUI stays on this display until the exit
+    static lv_disp_buf_t disp_buf;
+    uint32_t buf_px = (uint32_t)LV_HOR_RES_MAX * STRESS_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    doc_id_t * nodes = malloc(size_max * sizeof(doc_id_t));
+    stress_res_t * res = calloc(size_cnt * STRESS_SHAPE_CNT, sizeof(stress_res_t));
+    if(buf == NULL || nodes == NULL || res == NULL)
+    {
+        printf("Stress test failed, out of memory\n");
+        free(buf);
+        free(nodes);
+        free(res);
+        if(chdir(cwd) != 0) printf("Can't go back to %s\n", cwd);
+        return false;
+    }
+    lv_disp_buf_init(&disp_buf, buf, NULL, buf_px);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = LV_HOR_RES_MAX;
+    disp_drv.ver_res = LV_VER_RES_MAX;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = stress_flush;
+    lv_disp_drv_register(&disp_drv);
+
+    lv_gui_designer();
+
+    //The loaded widgets aren't part of the document, they go to a hidden object deleted after every load
+    lv_obj_t * load_par = lv_obj_create(lv_disp_get_scr_act(NULL), NULL);
+    lv_obj_set_hidden(load_par, true);
+
+    printf("%-6s %-9s %-18s %10s %7s %12s %10s\n", "size", "shape", "operation", "ms", "count", "lv_mem max", "RSS kB");
+    uint32_t res_cnt = 0;
+    uint32_t s;
+    for(i = 0; i < size_cnt; i++)
+    {
+        for(s = 0; s < STRESS_SHAPE_CNT; s++)
+        {
+            project_run(load_par, sizes[i], &shapes[s], nodes, &res[res_cnt]);
+            res_print(&res[res_cnt]);
+            res_cnt++;
+        }
+    }
+
+    bool ok = true;
+    if(chdir(cwd) != 0)
+    {
+        printf("Can't go back to %s\n", cwd);
+        ok = false;
+    }
+    if(ok && json_path != NULL) ok = json_write(json_path, res, res_cnt);
+
+    free(nodes);
+    free(res);
+    return ok;
+}
+
+//Parse a comma separated list like "1000,10000,50000" into `sizes` (`STRESS_SIZE_MAX` elements). 0: invalid list.
+uint32_t stress_sizes_parse(const char * text, uint32_t * sizes)
+{
+    uint32_t cnt = 0;
+    while(*text != '\0')
+    {
+        char * end;
+        unsigned long size = strtoul(text, &end, 10);
+        if(end == text || size == 0 || cnt >= STRESS_SIZE_MAX) return 0;
+        sizes[cnt++] = size;
+        if(*end == ',') end++;
+        else if(*end != '\0') return 0;
+        text = end;
+    }
+    return cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static void stress_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    (void)area;
+    (void)color_p;
+    lv_disp_flush_ready(drv);
+}
+
+//Build one project, measure the operations on it and leave an empty screen behind
+static void project_run(lv_obj_t * load_par, uint32_t size, const stress_shape_t * shape, doc_id_t * nodes,
+                        stress_res_t * res)
+{
+    memset(res, 0, sizeof(stress_res_t));
+    res->size = size;
+    res->shape = shape;
+
+    stress_build_t build;
+    memset(&build, 0, sizeof(build));
+    build.nodes = nodes;
+    lv_mem_reset_max_used();
+    project_build(&build, size, shape, res);
+    res->created = build.created;
+    res->ops[STRESS_OP_ADD].ms = build.ms;
+    res->ops[STRESS_OP_ADD].cnt = build.created;
+    meas_mem(&res->ops[STRESS_OP_ADD]);
+    if(build.created == 0) return;
+
+    //Widgets from everywhere in the tree, as clicking their rows does
+    uint64_t t_start;
+    uint32_t sel_cnt = LV_MATH_MIN(STRESS_SEL_CNT, build.created);
+    uint32_t i;
+    meas_start(&t_start);
+    for(i = 0; i < sel_cnt; i++) layerview_set_sel(nodes[(uint64_t)i * build.created / sel_cnt]);
+    meas_end(&res->ops[STRESS_OP_SEL], t_start, sel_cnt);
+
+    //Every theme and then back to the first one
+    uint16_t th_cnt = toolbox_get_theme_cnt();
+    meas_start(&t_start);
+    for(i = 1; i <= th_cnt; i++) toolbox_set_theme(i % th_cnt, 0);
+    meas_end(&res->ops[STRESS_OP_THEME], t_start, th_cnt);
+
+    meas_start(&t_start);
+    uint32_t edit_cnt = style_edit(nodes, build.created);
+    meas_end(&res->ops[STRESS_OP_STYLE], t_start, edit_cnt);
+
+    meas_start(&t_start);
+    code_generation();
+    meas_end(&res->ops[STRESS_OP_GENCODE], t_start, 1);
+
+    meas_start(&t_start);
+    bool saved = save_project(doc_get_screen());
+    meas_end(&res->ops[STRESS_OP_SAVE], t_start, 1);
+
+    meas_start(&t_start);
+    uint32_t del_cnt = project_clear();
+    meas_end(&res->ops[STRESS_OP_DEL], t_start, del_cnt);
+
+    //Every step of the journal back and forth, the screen is empty again at the end
+    undo_stat_t ustat;
+    undo_get_stat(&ustat);
+    meas_start(&t_start);
+    uint32_t step_cnt = 0;
+    uint32_t back_max = 0;      //The undone deletions recreate the widgets, the undone creations delete them again
+    while(undo_undo())
+    {
+        step_cnt++;
+        back_max = LV_MATH_MAX(back_max, doc_get_count());
+    }
+    while(undo_redo()) step_cnt++;
+    meas_end(&res->ops[STRESS_OP_UNDO], t_start, step_cnt);
+    printf("Undo: %u steps in %u bytes (%u dropped), up to %u widgets recreated\n", ustat.undo_cnt, ustat.used,
+           ustat.dropped, back_max > doc_get_count() ? back_max - doc_get_count() : 0);
+
+    //The saved project is loaded as the designer's own project file
+    if(!saved || rename(SAVEPROJ_XML_FILE, LOADPROJ_XML_FILE) != 0) return;
+    uint32_t info_cnt = widget_info_get_count();
+    meas_start(&t_start);
+    load_project(load_par);
+    meas_end(&res->ops[STRESS_OP_LOAD], t_start, widget_info_get_count() - info_cnt);
+    lv_obj_clean(load_par);
+    remove(LOADPROJ_XML_FILE);
+}
+
+//Create containers level by level with `shape->fanout` children each. The first widgets of a level are
+//the containers of the next level, the rest are leaves of the `leaf_types`.
+static void project_build(stress_build_t * build, uint32_t size, const stress_shape_t * shape, stress_res_t * res)
+{
+    uint32_t fanout = shape->fanout;
+    doc_id_t screen = doc_get_screen();
+    const doc_id_t * pars = &screen;
+    uint32_t par_cnt = 1;
+    build->next_check = STRESS_MEM_CHECK;
+
+    while(build->created < size && par_cnt > 0 && !build->full)
+    {
+        uint32_t level_start = build->created;
+        uint32_t level_cnt = LV_MATH_MIN(par_cnt * fanout, size - level_start);
+        uint32_t rest = size - level_start - level_cnt;
+        uint32_t cont_cnt = LV_MATH_MIN(level_cnt, (rest + fanout - 1) / fanout);
+
+        uint32_t level_i = 0;
+        uint32_t p;
+        for(p = 0; p < par_cnt && level_i < level_cnt && !build->full; p++)
+        {
+            uint32_t cnt = LV_MATH_MIN(fanout, level_cnt - level_i);
+            uint32_t conts = level_i < cont_cnt ? LV_MATH_MIN(cont_cnt - level_i, cnt) : 0;
+            batch_create(build, pars[p], WIDGET_TYPE_CONT, conts);
+            batch_create(build, pars[p], leaf_types[(level_start + p) % STRESS_LEAF_TYPE_CNT], cnt - conts);
+            level_i += cnt;
+        }
+
+        pars = &build->nodes[level_start];
+        par_cnt = LV_MATH_MIN(cont_cnt, build->created - level_start);
+        res->depth++;
+    }
+}
+
+//Create `cnt` widgets of `type` in the batches of the toolbox and add them to `build->nodes`
+static void batch_create(stress_build_t * build, doc_id_t par, widget_type_t type, uint32_t cnt)
+{
+    lv_obj_t * objs[STRESS_MEM_CHECK];
+    while(cnt > 0 && !build->full)
+    {
+        if(build->created >= build->next_check)
+        {
+            lv_mem_monitor_t mon;
+            lv_mem_monitor(&mon);
+            //A new region is added to `lv_mem` when it's full, if it still can grow
+            bool can_grow = LV_MEM_GROW && mon.region_cnt < LV_MEM_REGION_MAX;
+            if(mon.free_size < STRESS_MEM_RESERVE && !can_grow)
+            {
+                build->full = true;
+                break;
+            }
+            build->next_check = build->created + STRESS_MEM_CHECK;
+        }
+
+        toolbox_batch_t batch;
+        memset(&batch, 0, sizeof(batch));
+        batch.cnt = LV_MATH_MIN(cnt, build->next_check - build->created);
+        batch.cols = STRESS_GRID_COLS;
+
+        uint64_t t_start = SDL_GetPerformanceCounter();
+        uint32_t done = toolbox_create_batch(type, par, &batch, objs);
+        build->ms += time_ms(t_start);
+
+        uint32_t i;
+        for(i = 0; i < done; i++) build->nodes[build->created++] = widget_get_info(objs[i])->node;
+        if(done < batch.cnt) build->full = true;
+        cnt -= done;
+    }
+}
+
+//Give every widget the same radius, as editing them one by one in the Setting panel does
+static uint32_t style_edit(const doc_id_t * nodes, uint32_t cnt)
+{
+    lv_obj_t ** objs = malloc(LV_MATH_MAX(cnt, 1) * sizeof(lv_obj_t *));
+    if(objs == NULL) return 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++) objs[i] = doc_get(nodes[i])->obj;
+
+    lv_coord_t radius = STRESS_STYLE_RADIUS;
+    uint32_t done = stylepool_edit_objs(objs, cnt, style_edit_cb, &radius);
+    free(objs);
+
+    stylepool_stat_t stat;
+    stylepool_get_stat(&stat);
+    printf("Style edit: %u widgets share %u styles (%u forks, %u merges, %u in place)\n", stat.refs, stat.cnt,
+           stat.forks, stat.merges, stat.in_place);
+    return done;
+}
+
+static void style_edit_cb(lv_style_t * style, void * user_data)
+{
+    style->body.radius = *(lv_coord_t *)user_data;
+}
+
+//Delete the widgets of the screen. Return the number of deleted widgets.
+static uint32_t project_clear(void)
+{
+    uint32_t cnt = doc_get_count();
+    doc_node_t * screen = doc_get(doc_get_screen());
+    while(screen != NULL && screen->first_child != DOC_NONE)
+    {
+        layerview_del(screen->first_child);
+    }
+    return cnt - doc_get_count();
+}
+
+static void meas_start(uint64_t * t_start)
+{
+    lv_mem_reset_max_used();
+    *t_start = SDL_GetPerformanceCounter();
+}
+
+//Store the time since `t_start` and the memory usage
+static void meas_end(stress_meas_t * meas, uint64_t t_start, uint32_t cnt)
+{
+    meas->ms = time_ms(t_start);
+    meas->cnt = cnt;
+    meas_mem(meas);
+}
+
+static void meas_mem(stress_meas_t * meas)
+{
+    lv_mem_monitor_t mon;
+    lv_mem_monitor(&mon);
+    meas->mem_max = mon.max_used;
+    meas->rss_kb = rss_peak_kb();
+}
+
+static double time_ms(uint64_t t_start)
+{
+    return (double)(SDL_GetPerformanceCounter() - t_start) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+}
+
+static long rss_peak_kb(void)
+{
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return usage.ru_maxrss;     //kB on Linux
+}
+
+static void res_print(const stress_res_t * res)
+{
+    if(res->created < res->size)
+    {
+        printf("%-6u %-9s only %u widgets fit into lv_mem (LV_MEM_SIZE, LV_MEM_GROW in lv_conf.h)\n",
+               res->size, res->shape->name, res->created);
+    }
+
+    uint32_t op;
+    for(op = 0; op < _STRESS_OP_NUM; op++)
+    {
+        const stress_meas_t * m = &res->ops[op];
+        if(m->cnt == 0) continue;
+        printf("%-6u %-9s %-18s %10.2f %7u %12u %10ld\n", res->size, res->shape->name, op_names[op],
+               m->ms, m->cnt, m->mem_max, m->rss_kb);
+    }
+}
+
+//{"runs": [{"size": ..., "shape": ..., "fanout": ..., "created": ..., "depth": ...,
+//           "ops": {"layerview_add": {"ms": ..., "cnt": ..., "lv_mem_max": ..., "rss_kb": ...}, ...}}, ...]}
+static bool json_write(const char * path, const stress_res_t * res, uint32_t cnt)
+{
+    FILE * fp = fopen(path, "w");
+    if(!fp)
+    {
+        printf("Can't create %s\n", path);
+        return false;
+    }
+
+    fprintf(fp, "{\"runs\": [");
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        const stress_res_t * r = &res[i];
+        fprintf(fp, "%s\n  {\"size\": %u, \"shape\": \"%s\", \"fanout\": %u, \"created\": %u, \"depth\": %u, \"ops\": {",
+                i ? "," : "", r->size, r->shape->name, r->shape->fanout, r->created, r->depth);
+        bool first = true;
+        uint32_t op;
+        for(op = 0; op < _STRESS_OP_NUM; op++)
+        {
+            const stress_meas_t * m = &r->ops[op];
+            if(m->cnt == 0) continue;
+            fprintf(fp, "%s\n    \"%s\": {\"ms\": %.3f, \"cnt\": %u, \"lv_mem_max\": %u, \"rss_kb\": %ld}",
+                    first ? "" : ",", op_names[op], m->ms, m->cnt, m->mem_max, m->rss_kb);
+            first = false;
+        }
+        fprintf(fp, "}}");
+    }
+    fprintf(fp, "\n]}\n");
+
+    bool ok = !ferror(fp);
+    if(fclose(fp) != 0) ok = false;
+    if(!ok) printf("Can't write %s\n", path);
+    return ok;
+}
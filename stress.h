@@ -0,0 +1,56 @@
+/**
+ * @file stress.h
+ *
+ */
+
+#ifndef _STRESS_H_
+#define _STRESS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STRESS_SIZE_MAX         8           //Project sizes in one run
+#define STRESS_SEL_CNT          100         //Widgets selected in every project
+#define STRESS_MEM_RESERVE      (160U * 1024U)   //Stop creating widgets when less `lv_mem` is free, loading the saved project needs room too
+#define STRESS_MEM_CHECK        64          //Check the free memory after this many widgets
+#define STRESS_STYLE_RADIUS     7           //The radius the style edit gives every widget
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool stress_run(const char * dir, const uint32_t * sizes, uint32_t size_cnt, const char * json_path);
+uint32_t stress_sizes_parse(const char * text, uint32_t * sizes);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
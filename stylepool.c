@@ -0,0 +1,265 @@
+/**
+ * @file stylepool.c
+ * Interned, reference counted styles of the widgets edited in the designer. Equal styles are stored once,
+ * so giving 500 buttons the same radius makes one style, not 500. The interned styles are never changed
+ * while others use them: an edit copies the widget's style, changes the copy and interns it (copy-on-write).
+ * A style only the edited widget uses is changed in place. The snapshots and so the code generation
+ * see the shared styles once.
+ * Used only on the UI thread.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "stylepool.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct _stylepool_ent_t_
+{
+    lv_style_t style;           //Keep it first, the entry is found from the style
+    uint32_t hash;
+    uint32_t ref_cnt;
+    struct _stylepool_ent_t_ * next;
+}stylepool_ent_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t style_hash(const lv_style_t * style);
+static stylepool_ent_t * ent_find(const lv_style_t * style, uint32_t hash);
+static stylepool_ent_t * ent_find_ptr(const lv_style_t * style);
+static stylepool_ent_t * ent_create(const lv_style_t * style, uint32_t hash);
+static void ent_link(stylepool_ent_t * ent);
+static void ent_unlink(stylepool_ent_t * ent);
+static void ent_release(stylepool_ent_t * ent);
+static bool buckets_grow(void);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static stylepool_ent_t ** buckets = NULL;
+static uint32_t bucket_cnt = 0;
+static stylepool_stat_t pool_stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//The interned style equal to `style` with a new reference. NULL if out of memory.
+const lv_style_t * stylepool_intern(const lv_style_t * style)
+{
+    stylepool_ent_t * ent = ent_find_ptr(style);
+    if(ent == NULL)
+    {
+        uint32_t hash = style_hash(style);
+        ent = ent_find(style, hash);
+        if(ent == NULL) ent = ent_create(style, hash);
+        if(ent == NULL) return NULL;
+    }
+    ent->ref_cnt++;
+    pool_stat.refs++;
+    return &ent->style;
+}
+
+//A new user of a style, e.g. a copied widget. Nothing happens if it's not interned.
+void stylepool_retain(const lv_style_t * style)
+{
+    stylepool_ent_t * ent = ent_find_ptr(style);
+    if(ent == NULL) return;
+    ent->ref_cnt++;
+    pool_stat.refs++;
+}
+
+//The last release frees the style, nothing may use it after that. Nothing happens if it's not interned.
+void stylepool_release(const lv_style_t * style)
+{
+    stylepool_ent_t * ent = ent_find_ptr(style);
+    if(ent != NULL) ent_release(ent);
+}
+
+bool stylepool_is_interned(const lv_style_t * style)
+{
+    return ent_find_ptr(style) != NULL;
+}
+
+//Change the main style of a widget by `cb`. Its old style isn't changed if others use it too,
+//and it gets the style of the other widgets which already look like that.
+bool stylepool_edit(lv_obj_t * obj, stylepool_edit_cb_t cb, void * user_data)
+{
+    const lv_style_t * old = lv_obj_get_style(obj);
+    lv_style_t edited;
+    lv_style_copy(&edited, old);
+    cb(&edited, user_data);
+    if(memcmp(&edited, old, sizeof(lv_style_t)) == 0) return true;     //Nothing changed
+
+    stylepool_ent_t * old_ent = obj->style_p == old ? ent_find_ptr(old) : NULL;   //Not an inherited one
+    uint32_t hash = style_hash(&edited);
+    stylepool_ent_t * ent = ent_find(&edited, hash);
+    if(ent == NULL && old_ent != NULL && old_ent->ref_cnt == 1)
+    {
+        ent_unlink(old_ent);
+        memcpy(&old_ent->style, &edited, sizeof(lv_style_t));
+        old_ent->hash = hash;
+        ent_link(old_ent);
+        lv_obj_report_style_mod(&old_ent->style);
+        pool_stat.in_place++;
+        return true;
+    }
+
+    if(ent == NULL)
+    {
+        ent = ent_create(&edited, hash);
+        if(ent == NULL) return false;
+        pool_stat.forks++;
+    }else
+    {
+        pool_stat.merges++;
+    }
+    ent->ref_cnt++;
+    pool_stat.refs++;
+    lv_obj_set_style(obj, &ent->style);
+    if(old_ent != NULL) ent_release(old_ent);
+    return true;
+}
+
+//Give a widget a style it had before, e.g. by undo. The interned ones get a new reference.
+void stylepool_set(lv_obj_t * obj, const lv_style_t * style)
+{
+    const lv_style_t * old = obj->style_p;
+    if(old == style) return;
+    stylepool_retain(style);
+    lv_obj_set_style(obj, style);
+    stylepool_release(old);
+}
+
+//Edit more widgets the same way, e.g. the selected ones. Returns how many were changed.
+uint32_t stylepool_edit_objs(lv_obj_t * const * objs, uint32_t cnt, stylepool_edit_cb_t cb, void * user_data)
+{
+    uint32_t done = 0;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        if(stylepool_edit(objs[i], cb, user_data)) done++;
+    }
+    return done;
+}
+
+void stylepool_get_stat(stylepool_stat_t * s)
+{
+    *s = pool_stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//FNV-1a of the bytes, the styles are always copied whole so the padding matches too
+static uint32_t style_hash(const lv_style_t * style)
+{
+    const uint8_t * p = (const uint8_t *)style;
+    uint32_t h = FNV_OFFSET;
+    uint32_t i;
+    for(i = 0; i < sizeof(lv_style_t); i++)
+    {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static stylepool_ent_t * ent_find(const lv_style_t * style, uint32_t hash)
+{
+    if(bucket_cnt == 0) return NULL;
+    stylepool_ent_t * ent = buckets[hash & (bucket_cnt - 1)];
+    while(ent != NULL && (ent->hash != hash || memcmp(&ent->style, style, sizeof(lv_style_t)) != 0)) ent = ent->next;
+    return ent;
+}
+
+//Only the interned style itself, not an equal one
+static stylepool_ent_t * ent_find_ptr(const lv_style_t * style)
+{
+    if(style == NULL || bucket_cnt == 0) return NULL;
+    stylepool_ent_t * ent = buckets[style_hash(style) & (bucket_cnt - 1)];
+    while(ent != NULL && &ent->style != style) ent = ent->next;
+    return ent;
+}
+
+//With no references
+static stylepool_ent_t * ent_create(const lv_style_t * style, uint32_t hash)
+{
+    if(pool_stat.cnt >= bucket_cnt && !buckets_grow() && bucket_cnt == 0) return NULL;
+
+    stylepool_ent_t * ent = malloc(sizeof(stylepool_ent_t));
+    if(ent == NULL) return NULL;
+    memcpy(&ent->style, style, sizeof(lv_style_t));
+    ent->hash = hash;
+    ent->ref_cnt = 0;
+    ent_link(ent);
+    pool_stat.cnt++;
+    return ent;
+}
+
+static void ent_link(stylepool_ent_t * ent)
+{
+    stylepool_ent_t ** head = &buckets[ent->hash & (bucket_cnt - 1)];
+    ent->next = *head;
+    *head = ent;
+}
+
+static void ent_unlink(stylepool_ent_t * ent)
+{
+    stylepool_ent_t ** p = &buckets[ent->hash & (bucket_cnt - 1)];
+    while(*p != ent) p = &(*p)->next;
+    *p = ent->next;
+}
+
+static void ent_release(stylepool_ent_t * ent)
+{
+    pool_stat.refs--;
+    if(--ent->ref_cnt > 0) return;
+    ent_unlink(ent);
+    free(ent);
+    pool_stat.cnt--;
+}
+
+//The chains just get longer if there is no memory for more buckets
+static bool buckets_grow(void)
+{
+    uint32_t new_cnt = bucket_cnt == 0 ? STYLEPOOL_INIT_BUCKETS : bucket_cnt * 2;
+    stylepool_ent_t ** new_buckets = calloc(new_cnt, sizeof(stylepool_ent_t *));
+    if(new_buckets == NULL) return false;
+
+    uint32_t i;
+    for(i = 0; i < bucket_cnt; i++)
+    {
+        stylepool_ent_t * ent = buckets[i];
+        while(ent != NULL)
+        {
+            stylepool_ent_t * next = ent->next;
+            stylepool_ent_t ** head = &new_buckets[ent->hash & (new_cnt - 1)];
+            ent->next = *head;
+            *head = ent;
+            ent = next;
+        }
+    }
+    free(buckets);
+    buckets = new_buckets;
+    bucket_cnt = new_cnt;
+    return true;
+}
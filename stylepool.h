@@ -0,0 +1,69 @@
+/**
+ * @file stylepool.h
+ *
+ */
+
+#ifndef _STYLEPOOL_H_
+#define _STYLEPOOL_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STYLEPOOL_INIT_BUCKETS  64      //Must be a power of 2, doubled when there are more styles than buckets
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//Change the attributes of a copy of the widget's style
+typedef void (*stylepool_edit_cb_t)(lv_style_t * style, void * user_data);
+
+typedef struct
+{
+    uint32_t cnt;               //Interned styles
+    uint32_t refs;              //Their users, mostly widgets
+    uint32_t forks;             //Edits which needed a new style
+    uint32_t merges;            //Edits which ended up in an existing style
+    uint32_t in_place;          //Edits of a style only the edited widget used
+}stylepool_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+const lv_style_t * stylepool_intern(const lv_style_t * style);
+void stylepool_retain(const lv_style_t * style);
+void stylepool_release(const lv_style_t * style);
+bool stylepool_is_interned(const lv_style_t * style);
+bool stylepool_edit(lv_obj_t * obj, stylepool_edit_cb_t cb, void * user_data);
+void stylepool_set(lv_obj_t * obj, const lv_style_t * style);
+uint32_t stylepool_edit_objs(lv_obj_t * const * objs, uint32_t cnt, stylepool_edit_cb_t cb, void * user_data);
+void stylepool_get_stat(stylepool_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
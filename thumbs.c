@@ -0,0 +1,412 @@
+/**
+ * @file thumbs.c
+ * Thumbnails of the screens for a navigator. A low priority task checks one screen at a time: the content of
+ * its snapshot is hashed and only a changed screen is drawn again. The widgets are created from the snapshot
+ * on an own display, so the designer's widgets are never touched, and the flushed areas are averaged into
+ * a 1/THUMBS_SCALE thumbnail right away, only a few lines of the screen are kept at full resolution.
+ * With LV_USE_CONTEXT the display is in an own context on an idle priority worker thread,
+ * else it's drawn by the task on the UI thread.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#define _GNU_SOURCE         //SCHED_IDLE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <SDL2/SDL.h>
+#include "thumbs.h"
+#include "screens.h"
+#include "widgetreg.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define HASH_SEED           2166136261u     //FNV-1a
+#define HASH_PRIME          16777619u
+#define POST_RETRY_DELAY    1000            //[us] to wait for free space in the full lv_async queue
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    lv_img_dsc_t dsc;           //`data` is NULL until the first thumbnail
+    uint32_t hash;              //Of the screen's content it shows
+}thumb_t;
+
+//A screen to draw. The worker owns it until it's posted back to the UI thread.
+typedef struct
+{
+    uint32_t screen;
+    uint32_t hash;
+    projsnap_t snap;            //The widgets are created from it, they use its styles
+    lv_coord_t hres, vres;      //Of the screen
+    uint32_t w, h;              //Of the thumbnail
+    uint32_t * sum;             //Red, green and blue sums of every thumbnail pixel
+    lv_color_t * px;            //The thumbnail, NULL if it couldn't be drawn
+    uint32_t render_us;
+}thumb_job_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void thumbs_task(lv_task_t * task);
+static bool thumb_reserve(uint32_t screen);
+static uint32_t snap_hash(const projsnap_t * snap);
+static uint32_t hash_add(uint32_t hash, const void * data, size_t len);
+static void job_start(uint32_t screen, uint32_t hash, projsnap_t * snap);
+static void job_render(thumb_job_t * job);
+static void job_draw(thumb_job_t * job, lv_color_t * buf);
+static void job_done_cb(void * user_data);
+#if LV_USE_CONTEXT
+static void * worker_main(void * param);
+#endif
+static void snap_build(const projsnap_t * snap, lv_obj_t * scr);
+static void thumb_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static lv_task_t * thumbs_task_p = NULL;
+static thumb_t * thumbs = NULL;             //Indexed by the screens
+static uint32_t thumb_cnt = 0;
+static uint32_t cursor = 0;                 //The screen to check next
+static thumb_job_t * job_act = NULL;        //One screen is drawn at a time. Used only on the UI thread
+static thumbs_ready_cb_t ready_cb = NULL;
+static thumbs_stat_t stat;
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void thumbs_init(void)
+{
+    if(thumbs_task_p != NULL) return;
+
+    thumbs_task_p = lv_task_create(thumbs_task, THUMBS_PERIOD, LV_TASK_PRIO_LOWEST, NULL);
+}
+
+void thumbs_set_ready_cb(thumbs_ready_cb_t cb)
+{
+    ready_cb = cb;
+}
+
+//The last thumbnail of a screen, NULL if it's not drawn yet. A new one replaces it in place: set it again as
+//the source of the images showing it when the ready callback tells it.
+const lv_img_dsc_t * thumbs_get(uint32_t screen)
+{
+    if(screen >= thumb_cnt || thumbs[screen].dsc.data == NULL) return NULL;
+    return &thumbs[screen].dsc;
+}
+
+void thumbs_get_stat(thumbs_stat_t * stat_p)
+{
+    *stat_p = stat;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Check the next screen and draw it if it changed since its thumbnail
+static void thumbs_task(lv_task_t * task)
+{
+    (void)task;
+    if(job_act != NULL) return;
+
+    uint32_t cnt = screens_get_cnt();
+    if(cnt == 0) return;
+    if(cursor >= cnt) cursor = 0;
+    uint32_t idx = cursor++;
+
+    //A stored screen is hashed in place, a live one from a snapshot which the job gets if it's drawn
+    projsnap_t snap;
+    const projsnap_t * stored = screens_get_stored(idx);
+    if(stored == NULL && !screens_snap_take_one(idx, &snap)) return;
+
+    uint32_t hash = snap_hash(stored != NULL ? stored : &snap);
+    if(idx < thumb_cnt && thumbs[idx].dsc.data != NULL && thumbs[idx].hash == hash)
+    {
+        stat.same_cnt++;
+        if(stored == NULL) projsnap_free(&snap);
+        return;
+    }
+
+    if(stored != NULL && !screens_snap_take_one(idx, &snap)) return;
+    job_start(idx, hash, &snap);
+}
+
+//Make room for the thumbnails up to `screen`
+static bool thumb_reserve(uint32_t screen)
+{
+    if(screen < thumb_cnt) return true;
+
+    thumb_t * new_thumbs = realloc(thumbs, (screen + 1) * sizeof(thumb_t));
+    if(new_thumbs == NULL) return false;
+    memset(&new_thumbs[thumb_cnt], 0, (screen + 1 - thumb_cnt) * sizeof(thumb_t));
+    thumbs = new_thumbs;
+    thumb_cnt = screen + 1;
+    return true;
+}
+
+//What the screen looks like: everything the builder uses, not the IDs. Styles and texts by their content,
+//so a screen stored and opened again has the same hash.
+static uint32_t snap_hash(const projsnap_t * snap)
+{
+    uint32_t hash = HASH_SEED;
+    uint32_t i;
+    for(i = 0; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        hash = hash_add(hash, &n->type, sizeof(n->type));
+        hash = hash_add(hash, &n->parent, sizeof(n->parent));
+        hash = hash_add(hash, &n->x, sizeof(n->x));
+        hash = hash_add(hash, &n->y, sizeof(n->y));
+        hash = hash_add(hash, &n->w, sizeof(n->w));
+        hash = hash_add(hash, &n->h, sizeof(n->h));
+        hash = hash_add(hash, &n->font, sizeof(n->font));
+        if(n->style != PROJSNAP_NO_STYLE) hash = hash_add(hash, &snap->styles[n->style], sizeof(lv_style_t));
+        if(n->text != NULL) hash = hash_add(hash, n->text, strlen(n->text) + 1);
+        else hash = hash_add(hash, "", 1);
+
+        uint8_t v;
+        for(v = 0; v < n->val_cnt; v++)
+        {
+            hash = hash_add(hash, &n->vals[v].attr, sizeof(n->vals[v].attr));
+            hash = hash_add(hash, &n->vals[v].value, sizeof(n->vals[v].value));
+        }
+    }
+    return hash;
+}
+
+static uint32_t hash_add(uint32_t hash, const void * data, size_t len)
+{
+    const uint8_t * p = data;
+    size_t i;
+    for(i = 0; i < len; i++) hash = (hash ^ p[i]) * HASH_PRIME;
+    return hash;
+}
+
+//Draw a screen, `snap` goes to the job
+static void job_start(uint32_t screen, uint32_t hash, projsnap_t * snap)
+{
+    thumb_job_t * job = snap->cnt > 0 ? calloc(1, sizeof(thumb_job_t)) : NULL;
+    if(job == NULL)
+    {
+        projsnap_free(snap);
+        return;
+    }
+    job->screen = screen;
+    job->hash = hash;
+    job->snap = *snap;
+    job->hres = LV_MATH_MIN(LV_MATH_MAX(snap->nodes[0].w, THUMBS_SCALE), LV_HOR_RES_MAX);
+    job->vres = LV_MATH_MIN(LV_MATH_MAX(snap->nodes[0].h, THUMBS_SCALE), LV_VER_RES_MAX);
+    job->w = job->hres / THUMBS_SCALE;
+    job->h = job->vres / THUMBS_SCALE;
+    job_act = job;
+
+#if LV_USE_CONTEXT
+    pthread_t thread;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int res = pthread_create(&thread, &attr, worker_main, job);
+    pthread_attr_destroy(&attr);
+    if(res == 0) return;
+#endif
+
+    //Without a thread draw it here
+    job_render(job);
+    job_done_cb(job);
+}
+
+//Draw the thumbnail of a job into `job->px`. On the worker in an own context, else on the UI thread.
+static void job_render(thumb_job_t * job)
+{
+    uint64_t t_start = SDL_GetPerformanceCounter();
+
+    uint32_t buf_px = (uint32_t)job->hres * THUMBS_BUF_LINES;
+    lv_color_t * buf = malloc(buf_px * sizeof(lv_color_t));
+    job->sum = calloc(job->w * job->h * 3, sizeof(uint32_t));
+    job->px = malloc(job->w * job->h * sizeof(lv_color_t));
+    if(buf == NULL || job->sum == NULL || job->px == NULL)
+    {
+        free(job->px);
+        job->px = NULL;
+    }else
+    {
+#if LV_USE_CONTEXT
+        lv_context_t * ctx = lv_context_create();
+        if(ctx != NULL)
+        {
+            lv_context_t * ctx_ori = lv_context_get_act();
+            lv_context_set_act(ctx);
+            job_draw(job, buf);
+            lv_context_set_act(ctx_ori);
+            lv_context_del(ctx);
+        }else
+        {
+            free(job->px);
+            job->px = NULL;
+        }
+#else
+        job_draw(job, buf);
+#endif
+    }
+    free(buf);
+    free(job->sum);
+    job->sum = NULL;
+
+    job->render_us = (uint32_t)((SDL_GetPerformanceCounter() - t_start) * 1000000 / SDL_GetPerformanceFrequency());
+}
+
+//Create the widgets on a new display, draw them once and average the sums into the thumbnail
+static void job_draw(thumb_job_t * job, lv_color_t * buf)
+{
+    lv_disp_buf_t disp_buf;
+    lv_disp_buf_init(&disp_buf, buf, NULL, (uint32_t)job->hres * THUMBS_BUF_LINES);
+
+    lv_disp_drv_t disp_drv;
+    lv_disp_drv_init(&disp_drv);
+    disp_drv.hor_res = job->hres;
+    disp_drv.ver_res = job->vres;
+    disp_drv.buffer = &disp_buf;
+    disp_drv.flush_cb = thumb_flush;
+    disp_drv.user_data = job;
+    lv_disp_t * disp = lv_disp_drv_register(&disp_drv);
+    if(disp == NULL)
+    {
+        free(job->px);
+        job->px = NULL;
+        return;
+    }
+
+    snap_build(&job->snap, lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+
+    uint32_t n = THUMBS_SCALE * THUMBS_SCALE;
+    uint32_t i;
+    for(i = 0; i < job->w * job->h; i++)
+    {
+        const uint32_t * s = &job->sum[i * 3];
+        job->px[i] = lv_color_make(s[0] / n, s[1] / n, s[2] / n);
+    }
+
+    //Nothing may point to the buffers on the stack
+    lv_obj_del(lv_disp_get_scr_act(disp));
+    lv_obj_del(lv_disp_get_layer_top(disp));
+    lv_obj_del(lv_disp_get_layer_sys(disp));
+    if(disp->refr_task != NULL) lv_task_del(disp->refr_task);
+    lv_disp_remove(disp);
+}
+
+//Back on the UI thread: replace the thumbnail
+static void job_done_cb(void * user_data)
+{
+    thumb_job_t * job = user_data;
+    job_act = NULL;
+
+    if(job->px != NULL && thumb_reserve(job->screen))
+    {
+        thumb_t * t = &thumbs[job->screen];
+        if(t->dsc.data != NULL)
+        {
+            lv_img_cache_invalidate_src(&t->dsc);
+            free((void *)t->dsc.data);
+        }
+        t->dsc.header.always_zero = 0;
+        t->dsc.header.cf = LV_IMG_CF_TRUE_COLOR;
+        t->dsc.header.w = job->w;
+        t->dsc.header.h = job->h;
+        t->dsc.data_size = job->w * job->h * sizeof(lv_color_t);
+        t->dsc.data = (const uint8_t *)job->px;
+        t->hash = job->hash;
+        stat.render_cnt++;
+        stat.render_us = job->render_us;
+        if(ready_cb != NULL) ready_cb(job->screen);
+    }else
+    {
+        free(job->px);
+    }
+
+    projsnap_free(&job->snap);
+    free(job);
+}
+
+#if LV_USE_CONTEXT
+static void * worker_main(void * param)
+{
+#ifdef SCHED_IDLE
+    //Only the idle time of the CPU, the UI thread goes first. Stays normal if it's not allowed.
+    struct sched_param sp;
+    memset(&sp, 0, sizeof(sp));
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp);
+#endif
+
+    thumb_job_t * job = param;
+    job_render(job);
+    while(lv_async_post(job_done_cb, job) != LV_RES_OK) usleep(POST_RETRY_DELAY);
+    return NULL;
+}
+#endif
+
+//Create the widgets of a screen's snapshot on `scr` as the generated code does: the root is the screen itself.
+//Only lv_ calls and the widget registry, the document, the IDs and the style pool aren't touched.
+static void snap_build(const projsnap_t * snap, lv_obj_t * scr)
+{
+    lv_obj_t ** made = malloc(snap->cnt * sizeof(lv_obj_t *));
+    if(made == NULL) return;
+    made[0] = scr;
+
+    uint32_t i;
+    for(i = 1; i < snap->cnt; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        const widget_desc_t * desc = widgetreg_get(n->type);
+        lv_obj_t * par = made[n->parent];
+        made[i] = desc != NULL ? desc->create_cb(par, NULL) : NULL;
+        if(made[i] == NULL)
+        {
+            made[i] = par;      //Its children go to the parent
+            continue;
+        }
+        if(n->style != PROJSNAP_NO_STYLE) lv_obj_set_style(made[i], &snap->styles[n->style]);
+        if(n->text != NULL) widgetreg_text_apply(made[i], n->type, n->text);
+        widgetreg_vals_apply(made[i], n->type, n->vals, n->val_cnt);
+        lv_obj_set_size(made[i], n->w, n->h);
+        lv_obj_set_pos(made[i], n->x, n->y);
+    }
+    free(made);
+}
+
+//Add the flushed pixels to the sums of the thumbnail pixels they fall in
+static void thumb_flush(lv_disp_drv_t * drv, const lv_area_t * area, lv_color_t * color_p)
+{
+    thumb_job_t * job = drv->user_data;
+    lv_coord_t x, y;
+    for(y = area->y1; y <= area->y2; y++)
+    {
+        uint32_t ty = y / THUMBS_SCALE;
+        for(x = area->x1; x <= area->x2; x++, color_p++)
+        {
+            uint32_t tx = x / THUMBS_SCALE;
+            if(tx >= job->w || ty >= job->h) continue;      //The remainder of the size
+            lv_color32_t c;
+            c.full = lv_color_to32(*color_p);
+            uint32_t * s = &job->sum[(ty * job->w + tx) * 3];
+            s[0] += c.ch.red;
+            s[1] += c.ch.green;
+            s[2] += c.ch.blue;
+        }
+    }
+    lv_disp_flush_ready(drv);
+}
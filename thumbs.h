@@ -0,0 +1,65 @@
+/**
+ * @file thumbs.h
+ *
+ */
+
+#ifndef _THUMBS_H_
+#define _THUMBS_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define THUMBS_SCALE            4       //A thumbnail pixel is the average of THUMBS_SCALE x THUMBS_SCALE pixels
+#define THUMBS_PERIOD           500     //[ms] between two checks, one screen is checked at a time
+#define THUMBS_BUF_LINES        20      //The display buffer of the renderer is this many lines of the screen
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//Called on the UI thread when the thumbnail of a screen is new or changed, e.g. to refresh a navigator
+typedef void (*thumbs_ready_cb_t)(uint32_t screen);
+
+typedef struct
+{
+    uint32_t render_cnt;        //Thumbnails drawn
+    uint32_t same_cnt;          //Checks which found the screen unchanged
+    uint32_t render_us;         //[us] the last thumbnail took to draw on the worker
+}thumbs_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void thumbs_init(void);
+void thumbs_set_ready_cb(thumbs_ready_cb_t cb);
+const lv_img_dsc_t * thumbs_get(uint32_t screen);
+void thumbs_get_stat(thumbs_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
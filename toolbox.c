@@ -13,47 +13,85 @@
 #include "setting.h"
 #include "dataset.h"
 #include "custom_widget.h"
+#include "autosave.h"
+#include "doctree.h"
+#include "widgetreg.h"
+#include "undo.h"
+#include "propbind.h"
+#include "bulkedit.h"
+#include "snapguide.h"
 /*********************
  *      DEFINES
  *********************/
+#define THEME_HUE_STEP      30      //Options of the hue roller
+#define THEME_HUE_NUM       12
 
 /**********************
  *      EXTERN
  **********************/
 extern lv_obj_t * toolbox_win;
-extern lv_obj_t * tft_win;
 /**********************
  *      TYPEDEFS
  **********************/
+typedef lv_theme_t * (*theme_init_cb_t)(uint16_t hue, lv_font_t * font);
 
+//A widget of the copied subtree
+typedef struct
+{
+    doc_id_t node;
+    uint32_t depth;             //0: the root
+}clone_src_t;
+
+typedef struct
+{
+    clone_src_t * src;          //Preorder
+    uint32_t cnt;
+    uint32_t depth;
+}clone_ctx_t;
 
+//A theme's styles for one hue. The `*_init` functions build them into the same static styles for every hue.
+typedef struct
+{
+    lv_theme_t th;              //Points to `styles`
+    lv_style_t styles[sizeof(((lv_theme_t *)0)->style) / sizeof(lv_style_t *)];
+}theme_copy_t;
 
 /**********************
  *  STATIC PROTOTYPES
  **********************/
-static void create_label_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_btn_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_cb_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_ddlist_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_bar_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_gauge_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_led_cb(lv_obj_t * obj, lv_event_t ev);
-// static void create_line_cb(lv_obj_t * obj, lv_event_t ev);
-static void create_slider_cb(lv_obj_t * obj, lv_event_t ev);
+static void create_widget_cb(lv_obj_t * list_btn, lv_event_t ev);
+static void create_copy(lv_obj_t * obj, lv_event_t ev);
+static void paste_cb(lv_obj_t * obj, lv_event_t ev);
+static void reparent_cb(lv_obj_t * obj, lv_event_t ev);
+static lv_obj_t * widget_create(const widget_desc_t * desc, doc_id_t par, const lv_obj_t * copy);
+static void widget_setup(const widget_desc_t * desc, doc_id_t par, lv_obj_t * new);
+static bool clone_enter_cb(doc_id_t id, void * user_data);
+static bool clone_leave_cb(doc_id_t id, void * user_data);
+static bool obj_is_cont(lv_obj_t * obj);
 
 static void update_setting(lv_obj_t * obj, lv_event_t ev);
 static void create_undo(lv_obj_t * obj, lv_event_t ev);
+static void undo_cb(lv_obj_t * obj, lv_event_t ev);
+static void redo_cb(lv_obj_t * obj, lv_event_t ev);
 
 static void theme_select_event_handler(lv_obj_t * roller, lv_event_t event);
 static void hue_select_event_cb(lv_obj_t * roller, lv_event_t event);
-static void init_all_themes(uint16_t hue);
+static lv_theme_t * theme_get(uint16_t th_id, uint16_t hue_id);
+static void theme_apply(void);
 /**********************
  *  STATIC VARIABLES
  **********************/
 // static int widget_count = 0;
 static lv_theme_t * th_act;
 
-static lv_obj_t * last_widget = NULL;   //Use by set position.There may got a error, if we delete this.
+//The last created widget, the next one is placed next to it. Kept by its node and UID, so a deleted one
+//(e.g. by the Layer View) isn't used.
+static doc_id_t last_node = DOC_NONE;
+static uint32_t last_uid;
+
+//The copied widget, pasted with its children. Kept the same way as the last created one.
+static doc_id_t clip_node = DOC_NONE;
+static uint32_t clip_uid;
 
 static const char * th_options =
 {
@@ -88,7 +126,37 @@ static const char * th_options =
         ""
 };
 
-static lv_theme_t * themes[8];
+//In the order of `th_options`
+static const theme_init_cb_t theme_inits[] = {
+#if LV_USE_THEME_NIGHT
+    lv_theme_night_init,
+#endif
+#if LV_USE_THEME_MATERIAL
+    lv_theme_material_init,
+#endif
+#if LV_USE_THEME_ALIEN
+    lv_theme_alien_init,
+#endif
+#if LV_USE_THEME_ZEN
+    lv_theme_zen_init,
+#endif
+#if LV_USE_THEME_NEMO
+    lv_theme_nemo_init,
+#endif
+#if LV_USE_THEME_MONO
+    lv_theme_mono_init,
+#endif
+#if LV_USE_THEME_DEFAULT
+    lv_theme_default_init,
+#endif
+};
+
+#define THEME_NUM (sizeof(theme_inits) / sizeof(theme_inits[0]))
+
+//Built when first selected, NULL until then
+static lv_theme_t * themes[THEME_NUM][THEME_HUE_NUM];
+static uint16_t th_sel = 0;
+static uint16_t hue_sel = 0;
 
 /**********************
  *      MACROS
@@ -101,9 +169,7 @@ static lv_theme_t * themes[8];
 
 void toolbox_win_init(lv_obj_t * parent)
 {
-    init_all_themes(0);
-    th_act = themes[0];
-    lv_theme_set_current(th_act);
+    theme_apply();
 
 
     toolbox_win = lv_win_create(parent, NULL);
@@ -111,45 +177,41 @@ void toolbox_win_init(lv_obj_t * parent)
     lv_obj_set_size(toolbox_win, lv_obj_get_width_fit(parent) / 5, lv_obj_get_height_fit(parent));
 
     lv_obj_align(toolbox_win, NULL, LV_ALIGN_IN_LEFT_MID, 0, 0);
+#if LV_USE_LAYER_CACHE
+    lv_obj_set_layer_cache(toolbox_win, true);     //Static while the widgets are dragged over the TFT
+#endif
 
     lv_obj_t * win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_TRASH);
     lv_obj_set_event_cb(win_btn, create_undo);
 
-    lv_obj_t * list = lv_list_create(toolbox_win, NULL);
-    lv_obj_set_size(list, lv_obj_get_width_fit(toolbox_win) + 5, lv_obj_get_height_fit(toolbox_win) * 0.7);
-    lv_list_set_sb_mode(list, LV_SB_MODE_AUTO);
-    
-    lv_obj_t * list_btn;
-
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_EDIT,  "Label");
-    lv_obj_set_event_cb(list_btn, create_label_cb);
+    win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_COPY);
+    lv_obj_set_event_cb(win_btn, create_copy);
 
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_OK,  "Button");
-    lv_obj_set_event_cb(list_btn, create_btn_cb);
-    
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_OK, "CheckBox");
-    lv_obj_set_event_cb(list_btn, create_cb_cb);
-    
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_LIST, "DDList");
-    lv_obj_set_event_cb(list_btn, create_ddlist_cb);
+    win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_EDIT);     //Paste, there is no paste symbol
+    lv_obj_set_event_cb(win_btn, paste_cb);
 
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_MINUS, "Bar");
-    lv_obj_set_event_cb(list_btn, create_bar_cb);
+    win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_DIRECTORY);
+    lv_obj_set_event_cb(win_btn, reparent_cb);
 
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_DRIVE, "Gauge");
-    lv_obj_set_event_cb(list_btn, create_gauge_cb);
-    
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_POWER, "Led");
-    lv_obj_set_event_cb(list_btn, create_led_cb);
+    win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_RIGHT);
+    lv_obj_set_event_cb(win_btn, redo_cb);
 
-    // list_btn = lv_list_add_btn(list, LV_SYMBOL_PLUS, "Line");
-    // lv_obj_set_event_cb(list_btn, create_line_cb);
+    win_btn = lv_win_add_btn(toolbox_win, LV_SYMBOL_LEFT);
+    lv_obj_set_event_cb(win_btn, undo_cb);
 
-    list_btn = lv_list_add_btn(list, LV_SYMBOL_PLAY, "Slider");
-    lv_obj_set_event_cb(list_btn, create_slider_cb);
-    // lv_list_add_btn(list, LV_SYMBOL_CHARGE, "Edit");
-    // lv_list_add_btn(list, LV_SYMBOL_DIRECTORY,  "Cut");
-    // lv_list_add_btn(list, LV_SYMBOL_COPY, "Copy");
+    lv_obj_t * list = lv_list_create(toolbox_win, NULL);
+    lv_obj_set_size(list, lv_obj_get_width_fit(toolbox_win) + 5, lv_obj_get_height_fit(toolbox_win) * 0.7);
+    lv_list_set_sb_mode(list, LV_SB_MODE_AUTO);
+    
+    uint32_t t;
+    for(t = 0; t < WIDGET_TYPE_NUM; t++)        //One button for every registered widget with a tool_name
+    {
+        const widget_desc_t * desc = widgetreg_get(t);
+        if(desc == NULL || desc->tool_name == NULL) continue;
+        lv_obj_t * list_btn = lv_list_add_btn(list, desc->tool_symbol, desc->tool_name);
+        lv_obj_set_user_data(list_btn, (void *)desc);
+        lv_obj_set_event_cb(list_btn, create_widget_cb);
+    }
 
 
     lv_obj_t * th_cont = lv_cont_create(toolbox_win, NULL);
@@ -170,265 +232,347 @@ void toolbox_win_init(lv_obj_t * parent)
 }
 
 
-/**********************
- *   STATIC FUNCTIONS
- **********************/
-// static void widgetview_init(lv_obj_t * toolbox_win)
+//Create a widget of `type` in the document as the child of `par`
+lv_obj_t * toolbox_create(widget_type_t type, doc_id_t par)
+{
+    lv_obj_t * new = NULL;
+    toolbox_batch_t batch = {.cnt = 1};
+    toolbox_create_batch(type, par, &batch, &new);
+    return new;
+}
+
+/**
+ * Create `batch->cnt` widgets on a grid, or copies of `batch->copy`, with one relayout and one redraw
+ * of the parent instead of one per widget.
+ * @param type type of the widgets, ignored when `batch->copy` is set
+ * @param par the parent in the document
+ * @param batch the count and the placement of the new widgets
+ * @param out if not NULL, the first `batch->cnt` elements receive the new widgets
+ * @return the number of created widgets
+ */
+uint32_t toolbox_create_batch(widget_type_t type, doc_id_t par, const toolbox_batch_t * batch, lv_obj_t ** out)
+{
+    doc_node_t * par_node = doc_get(par);
+    if(par_node == NULL || par_node->obj == NULL || batch->cnt == 0) return 0;
+    lv_obj_t * par_obj = par_node->obj;
 
+    if(batch->copy != NULL)
+    {
+        widget_info_t * info = widget_get_info(batch->copy);
+        if(info == NULL) return 0;
+        type = info->type;
+    }
+    const widget_desc_t * desc = widgetreg_get(type);
+    if(desc == NULL) return 0;
+
+    lv_obj_t * first = widget_create(desc, par, batch->copy);
+    if(first == NULL) return 0;
+    if(out != NULL) out[0] = first;
+
+    //The children can go to an inner object (e.g. the scrollable of a window), suspend that one
+    lv_obj_t * holder = lv_obj_get_parent(first);
+    bool hidden = lv_obj_get_hidden(par_obj);
+    lv_layout_t layout = LV_LAYOUT_OFF;
+    lv_fit_t fit[4] = {LV_FIT_NONE, LV_FIT_NONE, LV_FIT_NONE, LV_FIT_NONE};
+    bool suspend = batch->cnt > 1 && obj_is_cont(holder);
+    if(batch->cnt > 1)
+    {
+        lv_obj_set_hidden(par_obj, true);       //Hidden parents don't invalidate when the children are added
+    }
+    if(suspend)
+    {
+        layout = lv_cont_get_layout(holder);
+        fit[0] = lv_cont_get_fit_left(holder);
+        fit[1] = lv_cont_get_fit_right(holder);
+        fit[2] = lv_cont_get_fit_top(holder);
+        fit[3] = lv_cont_get_fit_bottom(holder);
+        lv_cont_set_layout(holder, LV_LAYOUT_OFF);
+        lv_cont_set_fit(holder, LV_FIT_NONE);
+    }
 
+    lv_obj_layout_flush();      //`first` can be a container fitting its children
+    lv_coord_t x0 = lv_obj_get_x(first);
+    lv_coord_t y0 = lv_obj_get_y(first);
+    lv_coord_t dx = batch->dx ? batch->dx : lv_obj_get_width(first) + TOOLBOX_BATCH_GAP;
+    lv_coord_t dy = batch->dy ? batch->dy : lv_obj_get_height(first) + TOOLBOX_BATCH_GAP;
+    uint16_t cols = batch->cols ? batch->cols : batch->cnt;
 
-static void create_label_cb(lv_obj_t * obj, lv_event_t ev)
-{
-    (void)obj;
-    if(ev == LV_EVENT_CLICKED)
+    uint32_t i;
+    for(i = 1; i < batch->cnt; i++)
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_label_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        lv_obj_set_drag(new, true);
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
-        
-        widget_set_info(new, WIDGET_TYPE_LABEL);
-        layerview_add(layerview_get_sel_layer(), new);
+        lv_obj_t * new = widget_create(desc, par, batch->copy);
+        if(new == NULL) break;
+        lv_obj_set_pos(new, x0 + (i % cols) * dx, y0 + (i / cols) * dy);
+        if(out != NULL) out[i] = new;
     }
-}
 
+    if(suspend)
+    {
+        lv_cont_set_fit4(holder, fit[0], fit[1], fit[2], fit[3]);
+        lv_cont_set_layout(holder, layout);     //The only relayout
+    }
+    if(batch->cnt > 1)
+    {
+        lv_obj_set_hidden(par_obj, hidden);     //The only redraw
+        autosave_mark(par);                     //Journal the parent's subtree once, not every new widget
+    }
+    undo_record_create(widget_get_info(first)->node, i);     //The whole batch is one step
+    return i;
+}
 
-static void create_btn_cb(lv_obj_t * obj, lv_event_t ev)
+/**
+ * Copy a widget with its descendants by the copy constructors of the widgets (`lv_..._create(par, copy)`).
+ * The copies are created in one batch, so the layouts and the redraw run once, and they are added to the
+ * document and the autosave journal together. The widgets keep their place in their parent; a copy next to
+ * the original (`par` is its parent) is moved by 10 px.
+ * @param root the copied widget, not the screen
+ * @param par the parent of the copy, can be in the copied subtree
+ * @return the copy of `root`, NULL if it couldn't be created
+ */
+lv_obj_t * toolbox_clone(doc_id_t root, doc_id_t par)
 {
-    (void)obj;
-    if(ev == LV_EVENT_CLICKED)
+    doc_node_t * root_n = doc_get(root);
+    if(root_n == NULL || root_n->parent == DOC_ROOT || doc_get(par) == NULL || doc_get(par)->obj == NULL) return NULL;
+    bool beside = root_n->parent == par;
+
+    //Take the sources first, a copy pasted into the copied subtree would be copied too
+    clone_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    uint32_t cnt = doc_traverse(root, NULL, NULL, NULL);
+    ctx.src = malloc(cnt * sizeof(clone_src_t));
+    doc_id_t * at_depth = malloc(cnt * sizeof(doc_id_t));      //The last copy on every level
+    if(ctx.src == NULL || at_depth == NULL)
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_btn_create(par, NULL);
-        // lv_label_set_text(lv_label_create(new, NULL), "Button");
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        if (par != tft_win)
-        {
-            lv_obj_set_drag_parent(new, true);
-        }else
+        free(ctx.src);
+        free(at_depth);
+        return NULL;
+    }
+    doc_traverse(root, clone_enter_cb, clone_leave_cb, &ctx);
+
+    lv_obj_batch_begin();
+    lv_obj_t * new_root = NULL;
+    uint32_t i;
+    for(i = 0; i < ctx.cnt; i++)
+    {
+        const clone_src_t * src = &ctx.src[i];
+        lv_obj_t * copy = doc_get(src->node)->obj;     //doc_add() may move the nodes
+        const widget_desc_t * desc = widgetreg_get(widget_get_info(copy)->type);
+        doc_id_t new_par = src->depth == 0 ? par : at_depth[src->depth - 1];
+        lv_obj_t * new = desc != NULL ? desc->create_cb(doc_get(new_par)->obj, copy) : NULL;
+        if(new == NULL) break;
+
+        lv_coord_t ofs = src->depth == 0 && beside ? 10 : 0;
+        lv_obj_set_pos(new, lv_obj_get_x(copy) + ofs, lv_obj_get_y(copy) + ofs);
+        widget_setup(desc, new_par, new);
+        doc_id_t node = doc_add(new_par, new);
+        if(node == DOC_NONE)
         {
-            lv_obj_set_drag(new, true);
+            lv_obj_del(new);
+            break;
         }
-        last_widget = new;
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
-        
-        // widget_info_t * info = (widget_info_t *)malloc(sizeof(widget_info_t));
-        // info->type = WIDGET_TYPE_BTN;
-        // sprintf(info->id, "%s_%d", "btn", widget_count++);
-        // lv_obj_set_user_data(new, info);
-        widget_set_info(new, WIDGET_TYPE_BTN);
-        layerview_add(layerview_get_sel_layer(), new);
+        widget_get_info(new)->node = node;
+        at_depth[src->depth] = node;
+        if(src->depth == 0) new_root = new;
     }
+    lv_obj_batch_commit();
+    free(ctx.src);
+    free(at_depth);
+    if(new_root == NULL) return NULL;
+
+    doc_id_t new_node = widget_get_info(new_root)->node;
+    last_node = new_node;
+    last_uid = doc_get(new_node)->uid;
+    autosave_mark(new_node);        //The subtree is journaled at once
+    layerview_refr_request();
+    undo_record_create(new_node, 1);
+    return new_root;
+}
 
+//Create a widget as the ToolBox does, without an undo step. Undo and redo recreate the widgets with it.
+lv_obj_t * toolbox_restore(widget_type_t type, doc_id_t par)
+{
+    const widget_desc_t * desc = widgetreg_get(type);
+    if(desc == NULL || doc_get(par) == NULL) return NULL;
+    return widget_create(desc, par, NULL);
 }
 
-static void create_cb_cb(lv_obj_t * obj, lv_event_t ev)
+//Make a widget created by a loader editable as the ToolBox's ones and add it to the document under `par`
+doc_id_t toolbox_adopt(lv_obj_t * obj, doc_id_t par)
 {
-    (void)obj;
-    if(ev == LV_EVENT_CLICKED)
-    {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_cb_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        lv_obj_set_drag(new, true);
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
+    widget_info_t * info = widget_get_info(obj);
+    const widget_desc_t * desc = info != NULL ? widgetreg_get(info->type) : NULL;
+    if(desc == NULL || par == DOC_NONE || doc_get(par) == NULL) return DOC_NONE;
+    widget_setup(desc, par, obj);
+    return layerview_add(par, obj);
+}
 
-        widget_set_info(new, WIDGET_TYPE_CB);
-        layerview_add(layerview_get_sel_layer(), new);   
-    }
+//Select a theme and a hue as the rollers do. false: no such theme or hue.
+bool toolbox_set_theme(uint16_t th_id, uint16_t hue_id)
+{
+    if(th_id >= THEME_NUM || hue_id >= THEME_HUE_NUM) return false;
+    th_sel = th_id;
+    hue_sel = hue_id;
+    theme_apply();
+    return true;
 }
 
-static void create_ddlist_cb(lv_obj_t * obj, lv_event_t ev)
+uint16_t toolbox_get_theme_cnt(void)
 {
-    (void)obj;
-    if(ev == LV_EVENT_CLICKED)
-    {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_ddlist_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        if (par != tft_win)
-        {
-            lv_obj_set_drag_parent(new, true);
-        }else
-        {
-            lv_obj_set_drag(new, true);
-        }
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
+    return THEME_NUM;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+// static void widgetview_init(lv_obj_t * toolbox_win)
 
-        lv_obj_t * scrl = lv_page_get_scrl(new);
-        lv_obj_set_drag_parent(scrl, true);
 
-        widget_set_info(new, WIDGET_TYPE_DDLIST);
-        layerview_add(layerview_get_sel_layer(), new);          
+
+static void create_widget_cb(lv_obj_t * list_btn, lv_event_t ev)
+{
+    if(ev == LV_EVENT_CLICKED)
+    {
+        const widget_desc_t * desc = lv_obj_get_user_data(list_btn);
+        toolbox_create(desc->type, layerview_get_sel_node());
     }
 }
 
-static void create_bar_cb(lv_obj_t * obj, lv_event_t ev)
+static void create_copy(lv_obj_t * obj, lv_event_t ev)    //Copy-paste the selected widget and its children next to it
 {
     (void)obj;
     if(ev == LV_EVENT_CLICKED)
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_bar_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-
-        lv_bar_set_anim_time(new, 10000);
-        lv_bar_set_value(new, 100, LV_ANIM_ON);
-        last_widget = new;
-        lv_obj_set_drag(new, true);
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
-
-        widget_set_info(new, WIDGET_TYPE_BAR);
-        layerview_add(layerview_get_sel_layer(), new);     
+        doc_id_t sel_node = layerview_get_sel_node();
+        doc_node_t * sel = doc_get(sel_node);
+        if(sel == NULL || sel->obj == NULL || sel->parent == DOC_ROOT) return;
+        clip_node = sel_node;       //The Paste button makes more copies
+        clip_uid = sel->uid;
+        toolbox_clone(sel_node, sel->parent);
     }
 }
 
-static void create_led_cb(lv_obj_t * obj, lv_event_t ev)
+static void paste_cb(lv_obj_t * obj, lv_event_t ev)     //Paste the copied widget into the selected one
 {
     (void)obj;
     if(ev == LV_EVENT_CLICKED)
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_led_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        if (par != tft_win)
-        {
-            lv_obj_set_drag_parent(new, true);
-        }else
-        {
-            lv_obj_set_drag(new, true);
-        }
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
-
-        widget_set_info(new, WIDGET_TYPE_LED);
-        layerview_add(layerview_get_sel_layer(), new);         
+        doc_node_t * clip = clip_node != DOC_NONE ? doc_get(clip_node) : NULL;
+        if(clip == NULL || clip->uid != clip_uid) return;       //Deleted since
+        toolbox_clone(clip_node, layerview_get_sel_node());
     }
 }
 
-static void create_gauge_cb(lv_obj_t * obj, lv_event_t ev)
+//Move the other selected widgets into the primary selected one, e.g. the last Shift-clicked
+static void reparent_cb(lv_obj_t * obj, lv_event_t ev)
 {
     (void)obj;
-    if(ev == LV_EVENT_CLICKED)
+    if(ev == LV_EVENT_CLICKED) bulkedit_reparent(layerview_get_sel_node());
+}
+
+//The common part of creating a widget in the designer
+static lv_obj_t * widget_create(const widget_desc_t * desc, doc_id_t par, const lv_obj_t * copy)
+{
+    doc_node_t * par_node = doc_get(par);
+    lv_obj_t * new = desc->create_cb(par_node->obj, copy);
+    if(new == NULL) return NULL;
+
+    if(copy != NULL)
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_gauge_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        if (par != tft_win)
-        {
-            lv_obj_set_drag_parent(new, true);
-        }else
+        lv_obj_set_pos(new, lv_obj_get_x(copy) + 10, lv_obj_get_y(copy) + 10);
+    }else
+    {
+        if(desc->def_w != 0 && desc->def_h != 0) lv_obj_set_size(new, desc->def_w, desc->def_h);
+        if(desc->init_cb != NULL) desc->init_cb(new);
+        doc_node_t * last = last_node != DOC_NONE ? doc_get(last_node) : NULL;
+        if(last != NULL && last->uid == last_uid)
         {
-            lv_obj_set_drag(new, true);
+            lv_obj_set_pos(new, lv_obj_get_x(last->obj) + 10, lv_obj_get_y(last->obj) + 10);
         }
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
+    }
 
-        lv_obj_set_drag(new, true);
-        lv_obj_set_event_cb(new, update_setting);
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        
-        widget_set_info(new, WIDGET_TYPE_GAUGE);
-        layerview_add(layerview_get_sel_layer(), new);       
+    widget_setup(desc, par, new);
+    doc_id_t node = layerview_add(par, new);
+    if(node == DOC_NONE)
+    {
+        lv_obj_del(new);
+        return NULL;
     }
+    last_node = node;
+    last_uid = doc_get(node)->uid;
+    return new;
 }
 
-// static void create_line_cb(lv_obj_t * obj, lv_event_t ev)
-// {
-//     (void)obj;
-//     if(ev == LV_EVENT_CLICKED)
-//     {
-//         lv_obj_t * new = lv_line_create(tft_win, NULL);
-//         if(last_widget != NULL)
-//         {
-//             lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-//             lv_point_t p[2] = {{LV_DPI, LV_DPI}, {LV_DPI + 10, LV_DPI + 10}};
-//             lv_line_set_points(new, p, 2);
-//         }
-//      last_widget = new;     
-//         lv_obj_set_drag(new, true);
-//         lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-//         lv_obj_set_event_cb(new, update_setting);
-//     }
-// }
-
-static void create_slider_cb(lv_obj_t * obj, lv_event_t ev)
+//Make a new widget editable in the designer, before it's added to the document
+static void widget_setup(const widget_desc_t * desc, doc_id_t par, lv_obj_t * new)
 {
-    (void)obj;
-    if(ev == LV_EVENT_CLICKED)
+    bool nested = doc_get(par)->parent != DOC_ROOT;     //Not on the screen (TFT Simulator)
+    if(nested && desc->drag_parent)
+    {
+        lv_obj_set_drag_parent(new, true);
+    }else
     {
-        lv_obj_t * par = layerview_get_sel_obj();
-        if(par == NULL) return;
-        lv_obj_t * new = lv_slider_create(par, NULL);
-        if(last_widget != NULL)
-        {
-            lv_obj_set_pos(new, lv_obj_get_x(last_widget) + 10, lv_obj_get_y(last_widget) + 10);
-        }
-        last_widget = new;
-        if (par != tft_win)
-        {
-            lv_obj_set_drag_parent(new, true);
-        }else
-        {
-            lv_obj_set_drag(new, true);
-        }
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        lv_obj_set_event_cb(new, update_setting);
-
         lv_obj_set_drag(new, true);
-        lv_obj_set_event_cb(new, update_setting);
-        lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
-        
-        widget_set_info(new, WIDGET_TYPE_SLIDER);
-        layerview_add(layerview_get_sel_layer(), new);
     }
+    lv_obj_set_protect(new, LV_PROTECT_PRESS_LOST);
+    lv_obj_set_event_cb(new, update_setting);
+
+    widget_set_info(new, desc->type);
 }
 
+static bool clone_enter_cb(doc_id_t id, void * user_data)
+{
+    clone_ctx_t * ctx = user_data;
+    ctx->src[ctx->cnt].node = id;
+    ctx->src[ctx->cnt].depth = ctx->depth;
+    ctx->cnt++;
+    ctx->depth++;
+    return true;
+}
+
+static bool clone_leave_cb(doc_id_t id, void * user_data)
+{
+    (void)id;
+    clone_ctx_t * ctx = user_data;
+    ctx->depth--;
+    return true;
+}
+
+static bool obj_is_cont(lv_obj_t * obj)    //lv_cont or derived from it
+{
+    lv_obj_type_t types;
+    lv_obj_get_type(obj, &types);
+    uint8_t i;
+    for(i = 0; i < LV_MAX_ANCESTOR_NUM && types.type[i] != NULL; i++)
+    {
+        if(!strcmp(types.type[i], "lv_cont")) return true;
+    }
+    return false;
+}
 
 static void update_setting(lv_obj_t * obj, lv_event_t ev)
 {
-    if(ev == LV_EVENT_DRAG_END)
+    if(ev == LV_EVENT_CLICKED)
+    {
+        layerview_click_sel(widget_get_info(obj)->node);
+    }else if(ev == LV_EVENT_DRAG_BEGIN)
     {
-        setting_attr_mod(obj);
+        snapguide_drag_begin(obj);
+        bulkedit_drag_begin(obj);       //The other selected widgets move with a selected one
+    }else if(ev == LV_EVENT_PRESSING)
+    {
+        snapguide_drag(obj);            //Before the others follow it
+        bulkedit_drag(obj);
+        //The position fields follow the drag, they are updated once a frame however often it moves
+        propbind_changed(obj, PROP_X);
+        propbind_changed(obj, PROP_Y);
+    }else if(ev == LV_EVENT_DRAG_END)
+    {
+        widget_info_t * info = widget_get_info(obj);
+        snapguide_drag_end(obj);
+        bulkedit_drag_end(obj);         //A drag is one step however far it went
+        autosave_mark(info->node);
+        propbind_changed(obj, PROP_X);
+        propbind_changed(obj, PROP_Y);
     }
 }
 
@@ -436,11 +580,22 @@ static void create_undo(lv_obj_t * obj, lv_event_t ev)
 {
     if(ev == LV_EVENT_CLICKED)
     {
-        layerview_del_sel();
-        last_widget = NULL;
+        bulkedit_delete();
     }
 }
 
+static void undo_cb(lv_obj_t * obj, lv_event_t ev)
+{
+    (void)obj;
+    if(ev == LV_EVENT_CLICKED) undo_undo();
+}
+
+static void redo_cb(lv_obj_t * obj, lv_event_t ev)
+{
+    (void)obj;
+    if(ev == LV_EVENT_CLICKED) undo_redo();
+}
+
 
 
 
@@ -459,9 +614,8 @@ static void theme_select_event_handler(lv_obj_t * roller, lv_event_t event)
         // lv_coord_t hres = lv_disp_get_hor_res(NULL);
         // lv_coord_t vres = lv_disp_get_ver_res(NULL);
 
-        uint16_t opt = lv_roller_get_selected(roller);
-        th_act = themes[opt];
-        lv_theme_set_current(th_act);
+        th_sel = lv_roller_get_selected(roller);
+        theme_apply();
 
         // lv_obj_align(header, NULL, LV_ALIGN_IN_TOP_MID, 0, 0);
         // lv_obj_align(sb, header, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 0);
@@ -483,48 +637,48 @@ static void hue_select_event_cb(lv_obj_t * roller, lv_event_t event)
 {
 
     if(event == LV_EVENT_VALUE_CHANGED) {
-        uint16_t hue = lv_roller_get_selected(roller) * 30;
-
-        init_all_themes(hue);
-
-        lv_theme_set_current(th_act);
+        hue_sel = lv_roller_get_selected(roller);
+        theme_apply();
 
         // lv_page_focus(sb, roller, LV_ANIM_ON);
     }
 }
 
 
-static void init_all_themes(uint16_t hue)
+//Only the selected theme is built and only once for a hue
+static lv_theme_t * theme_get(uint16_t th_id, uint16_t hue_id)
 {
-    /* NOTE: This must be adjusted if more themes are added. */
-    int i = 0;
-#if LV_USE_THEME_NIGHT
-    themes[i++] = lv_theme_night_init(hue, NULL);
-#endif
-
-#if LV_USE_THEME_MATERIAL
-    themes[i++] = lv_theme_material_init(hue, NULL);
-#endif
-
-#if LV_USE_THEME_ALIEN
-    themes[i++] = lv_theme_alien_init(hue, NULL);
-#endif
-
-#if LV_USE_THEME_ZEN
-    themes[i++] = lv_theme_zen_init(hue, NULL);
-#endif
+    if(themes[th_id][hue_id] != NULL) return themes[th_id][hue_id];
+
+    lv_theme_t * th = theme_inits[th_id](hue_id * THEME_HUE_STEP, NULL);
+
+    //Keep a copy, the next hue of this theme overwrites its styles
+    theme_copy_t * copy = malloc(sizeof(theme_copy_t));
+    if(copy == NULL) return th;         //Used as it is, built again next time
+    copy->th = *th;
+    lv_style_t ** src_p = (lv_style_t **)&th->style;
+    lv_style_t ** dst_p = (lv_style_t **)&copy->th.style;
+    uint32_t i;
+    for(i = 0; i < sizeof(copy->styles) / sizeof(copy->styles[0]); i++)
+    {
+        if(src_p[i] == NULL) continue;
+        copy->styles[i] = *src_p[i];
+        dst_p[i] = &copy->styles[i];
+    }
 
-#if LV_USE_THEME_NEMO
-    themes[i++] = lv_theme_nemo_init(hue, NULL);
-#endif
+    themes[th_id][hue_id] = &copy->th;
+    return &copy->th;
+}
 
-#if LV_USE_THEME_MONO
-    themes[i++] = lv_theme_mono_init(hue, NULL);
-#endif
+//Setting the theme compares all of its styles and redraws the screens, don't do it for nothing
+static void theme_apply(void)
+{
+    if(th_sel >= THEME_NUM || hue_sel >= THEME_HUE_NUM) return;
 
-#if LV_USE_THEME_DEFAULT
-    themes[i++] = lv_theme_default_init(hue, NULL);
-#endif
+    lv_theme_t * th = theme_get(th_sel, hue_sel);
+    if(th == th_act && themes[th_sel][hue_sel] == th) return;
+    th_act = th;
+    lv_theme_set_current(th_act);
 }
 
 
@@ -22,21 +22,38 @@ extern "C" {
 #include "./lv_ex_conf.h"
 #endif
 
+#include "dataset.h"
+#include "doctree.h"
 
 
 /*********************
  *      DEFINES
  *********************/
+#define TOOLBOX_BATCH_GAP   10      //Default distance of the cells in a batch
 
 /**********************
  *      TYPEDEFS
  **********************/
+typedef struct
+{
+    uint16_t cnt;               //Number of widgets to create
+    uint16_t cols;              //Columns of the grid, 0: one row
+    lv_coord_t dx, dy;          //Distance of the columns/rows, 0: size of the widget + TOOLBOX_BATCH_GAP
+    const lv_obj_t * copy;      //Create copies of this widget instead of new ones, can be NULL
+}toolbox_batch_t;
 
 /**********************
  * GLOBAL PROTOTYPES
  **********************/
 
 void toolbox_win_init(lv_obj_t * parent);
+lv_obj_t * toolbox_create(widget_type_t type, doc_id_t par);
+uint32_t toolbox_create_batch(widget_type_t type, doc_id_t par, const toolbox_batch_t * batch, lv_obj_t ** out);
+lv_obj_t * toolbox_clone(doc_id_t root, doc_id_t par);
+lv_obj_t * toolbox_restore(widget_type_t type, doc_id_t par);
+doc_id_t toolbox_adopt(lv_obj_t * obj, doc_id_t par);
+bool toolbox_set_theme(uint16_t th_id, uint16_t hue_id);
+uint16_t toolbox_get_theme_cnt(void);
 
 /**********************
  *      MACROS
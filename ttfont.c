@@ -0,0 +1,616 @@
+/**
+ * @file ttfont.c
+ * TrueType and OpenType fonts in the designer at any size, without converting them to C first.
+ * FreeType rasterizes a glyph when it's drawn or measured first, into the bit-per-pixel of the built-in fonts.
+ * The glyphs of a face at a size are kept in the asset store, so the next session (or another project) has
+ * them at once. The code generation gets the drawn letters as an `lv_font_fmt_txt` font to write its subset.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <ctype.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include "ttfont.h"
+#include "assetstore.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FACE_SIZE_MAX       (64 * 1024 * 1024)  //Bytes of a font file
+#define STORE_VERSION       1                   //Change it with the rasterization, the stored glyphs won't be used then
+#define STORE_KIND          "ttf"
+#define SLOTS_MIN           64                  //Power of 2
+#define BITMAP_INDEX_MAX    (1 << 20)           //`bitmap_index` of `lv_font_fmt_txt_glyph_dsc_t` is 20 bit
+#define CMAP_RANGE_MAX      0xFFFF              //`range_length` and the offsets of `unicode_list` are 16 bit
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    char name[TTFONT_NAME_MAX];     //Of the file, a C identifier
+    uint8_t * data;                 //The whole file, FreeType reads it from here
+    size_t size;
+    uint64_t hash;
+}ttf_face_t;
+
+typedef struct
+{
+    uint32_t letter;
+    const uint8_t * bitmap;         //TTFONT_BPP packed, rows aren't padded. Allocated or in the mapped store.
+    uint16_t adv_w;                 //12.4 format, like `lv_font_fmt_txt`
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;                   //The bottom of the box above the base line
+    uint8_t missing : 1;            //The face doesn't have it
+    uint8_t own : 1;                //`bitmap` is allocated
+}glyph_t;
+
+//A face at a size. `font.dsc` points to it.
+typedef struct
+{
+    lv_font_t font;
+    uint32_t face;
+    uint16_t px;
+    uint64_t key;                   //In the asset store
+    FT_Face ft;
+    glyph_t * glyphs;
+    uint32_t glyph_cnt;
+    uint32_t glyph_cap;
+    uint32_t * slots;               //Open addressing by letter, index + 1 of `glyphs`, 0: empty
+    uint32_t slot_cnt;
+    assetstore_blob_t blob;         //The glyphs of an earlier session
+    bool dirty;                     //Rasterized glyphs which aren't in the store yet
+    char name[TTFONT_NAME_MAX];
+    char ref[TTFONT_NAME_MAX + 1];
+}ttf_font_t;
+
+//A glyph in the store, the bitmaps follow the records
+typedef struct
+{
+    uint32_t letter;
+    uint32_t bitmap_ofs;
+    uint16_t adv_w;
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x;
+    int8_t ofs_y;
+    uint8_t missing;
+    uint8_t reserved;
+}store_glyph_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_t * dsc, uint32_t letter, uint32_t letter_next);
+static const uint8_t * glyph_bitmap_cb(const lv_font_t * font, uint32_t letter);
+static const glyph_t * glyph_get(ttf_font_t * f, uint32_t letter);
+static bool glyph_add(ttf_font_t * f, const glyph_t * g);
+static bool glyph_render(ttf_font_t * f, uint32_t letter, glyph_t * g);
+static uint32_t bitmap_size_get(uint8_t box_w, uint8_t box_h);
+static void store_load(ttf_font_t * f);
+static void store_save(ttf_font_t * f);
+static void store_task(lv_task_t * task);
+static bool file_read(const char * path, uint8_t ** buf, size_t * len);
+static void name_get(char * name, const char * path);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+//The fonts are drawn on the drawing threads and the workers (e.g. the thumbnails) too
+static pthread_mutex_t ttf_mutex = PTHREAD_MUTEX_INITIALIZER;
+static FT_Library ft_lib;
+static ttf_face_t faces[TTFONT_FACE_MAX];
+static uint32_t face_cnt;
+static ttf_font_t * fonts[TTFONT_FONT_MAX];
+static uint32_t font_cnt;
+static const uint8_t empty_bitmap[1];      //Of the glyphs without pixels (e.g. the space)
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Load a TrueType or OpenType file. Returns the index of the face, -1 on error.
+int32_t ttfont_add_face(const char * path)
+{
+    int32_t res = -1;
+    pthread_mutex_lock(&ttf_mutex);
+    if(ft_lib == NULL && FT_Init_FreeType(&ft_lib) != 0) ft_lib = NULL;
+
+    ttf_face_t * face = &faces[face_cnt];
+    if(ft_lib != NULL && face_cnt < TTFONT_FACE_MAX && file_read(path, &face->data, &face->size))
+    {
+        //Only to check it, every size opens its own face
+        FT_Face ft = NULL;
+        if(FT_New_Memory_Face(ft_lib, face->data, face->size, 0, &ft) == 0 && FT_IS_SCALABLE(ft))
+        {
+            name_get(face->name, path);
+            face->hash = assetstore_hash(ASSETSTORE_HASH_INIT, face->data, face->size);
+            res = face_cnt++;
+            if(res == 0) lv_task_create(store_task, TTFONT_STORE_PERIOD, LV_TASK_PRIO_LOWEST, NULL);
+        }else
+        {
+            printf("Not a scalable TrueType or OpenType font: %s\n", path);
+        }
+        if(res < 0) free(face->data);
+        if(ft != NULL) FT_Done_Face(ft);
+    }
+    pthread_mutex_unlock(&ttf_mutex);
+    return res;
+}
+
+uint32_t ttfont_get_face_count(void)
+{
+    pthread_mutex_lock(&ttf_mutex);
+    uint32_t cnt = face_cnt;
+    pthread_mutex_unlock(&ttf_mutex);
+    return cnt;
+}
+
+//The font of a face at a size, opened with the glyphs stored earlier. NULL on error.
+const lv_font_t * ttfont_get(uint32_t face, uint16_t px)
+{
+    if(px < TTFONT_PX_MIN || px > TTFONT_PX_MAX) return NULL;
+
+    pthread_mutex_lock(&ttf_mutex);
+    ttf_font_t * f = NULL;
+    uint32_t i;
+    for(i = 0; i < font_cnt; i++)
+    {
+        if(fonts[i]->face == face && fonts[i]->px == px)
+        {
+            f = fonts[i];
+            break;
+        }
+    }
+
+    if(f == NULL && face < face_cnt && font_cnt < TTFONT_FONT_MAX)
+    {
+        f = calloc(1, sizeof(ttf_font_t));
+        if(f != NULL && (FT_New_Memory_Face(ft_lib, faces[face].data, faces[face].size, 0, &f->ft) != 0 ||
+                         FT_Set_Pixel_Sizes(f->ft, 0, px) != 0))
+        {
+            if(f->ft != NULL) FT_Done_Face(f->ft);
+            free(f);
+            f = NULL;
+        }
+        if(f != NULL)
+        {
+            const FT_Size_Metrics * m = &f->ft->size->metrics;
+            int32_t ascender = (m->ascender + 63) >> 6;
+            int32_t descender = -m->descender >> 6;     //Below the base line, positive
+            if(descender < 0) descender = 0;
+            f->face = face;
+            f->px = px;
+            f->font.get_glyph_dsc = glyph_dsc_cb;
+            f->font.get_glyph_bitmap = glyph_bitmap_cb;
+            f->font.line_height = LV_MATH_MIN(ascender + descender, UINT8_MAX);
+            f->font.base_line = LV_MATH_MIN(descender, f->font.line_height);
+            f->font.dsc = f;
+            snprintf(f->name, sizeof(f->name), "lv_font_%.*s_%u", TTFONT_NAME_MAX - 14, faces[face].name, px);
+            snprintf(f->ref, sizeof(f->ref), "&%s", f->name);
+
+            uint32_t params[3] = {px, TTFONT_BPP, STORE_VERSION};
+            f->key = assetstore_hash(faces[face].hash, params, sizeof(params));
+            store_load(f);
+            fonts[font_cnt++] = f;
+        }
+    }
+    pthread_mutex_unlock(&ttf_mutex);
+    return f != NULL ? &f->font : NULL;
+}
+
+bool ttfont_is(const lv_font_t * font)
+{
+    return font != NULL && font->get_glyph_dsc == glyph_dsc_cb;
+}
+
+bool ttfont_get_info(const lv_font_t * font, uint32_t * face, uint16_t * px)
+{
+    if(!ttfont_is(font)) return false;
+    const ttf_font_t * f = font->dsc;
+    if(face != NULL) *face = f->face;
+    if(px != NULL) *px = f->px;
+    return true;
+}
+
+//The variable of the font in the generated code, e.g. `lv_font_opensans_22`. NULL if it isn't a TrueType font.
+const char * ttfont_get_name(const lv_font_t * font)
+{
+    return ttfont_is(font) ? ((const ttf_font_t *)font->dsc)->name : NULL;
+}
+
+//The same with a `&` in front of it, for the styles
+const char * ttfont_get_ref(const lv_font_t * font)
+{
+    return ttfont_is(font) ? ((const ttf_font_t *)font->dsc)->ref : NULL;
+}
+
+//Changes with the file, the size and the rasterization
+uint64_t ttfont_get_hash(const lv_font_t * font)
+{
+    return ttfont_is(font) ? ((const ttf_font_t *)font->dsc)->key : 0;
+}
+
+/* Build an `lv_font_fmt_txt` font with the glyphs of `letters` (sorted, unique), the ones the face doesn't have
+ * are left out. It's plain, without kerning, like the font is drawn in the designer. Can run on any thread.
+ * Free it with `ttfont_build_free`. */
+bool ttfont_build(const lv_font_t * font, const uint32_t * letters, uint32_t cnt, lv_font_t * out)
+{
+    memset(out, 0, sizeof(lv_font_t));
+    if(!ttfont_is(font)) return false;
+    ttf_font_t * f = font->dsc;
+
+    lv_font_fmt_txt_dsc_t * fdsc = calloc(1, sizeof(lv_font_fmt_txt_dsc_t));
+    lv_font_fmt_txt_glyph_dsc_t * gdsc = calloc(cnt + 1, sizeof(lv_font_fmt_txt_glyph_dsc_t));
+    lv_font_fmt_txt_cmap_t * cmaps = calloc(cnt + 1, sizeof(lv_font_fmt_txt_cmap_t));
+    uint16_t * lists = malloc((cnt + 1) * sizeof(uint16_t));    //The `unicode_list`s after each other
+    uint8_t * bitmap = NULL;
+    uint32_t bitmap_size = 0;
+    bool res = fdsc != NULL && gdsc != NULL && cmaps != NULL && lists != NULL;
+
+    pthread_mutex_lock(&ttf_mutex);
+    uint32_t gid = 1;           //0 is reserved
+    uint32_t cmap_cnt = 0;
+    uint32_t i;
+    for(i = 0; i < cnt && res; i++)
+    {
+        const glyph_t * g = glyph_get(f, letters[i]);
+        if(g == NULL || g->missing) continue;
+
+        uint32_t size = bitmap_size_get(g->box_w, g->box_h);
+        if(bitmap_size + size > BITMAP_INDEX_MAX)
+        {
+            res = false;
+            break;
+        }
+        uint8_t * b = realloc(bitmap, bitmap_size + size + 1);
+        if(b == NULL)
+        {
+            res = false;
+            break;
+        }
+        bitmap = b;
+        memcpy(&bitmap[bitmap_size], g->bitmap, size);
+        gdsc[gid].bitmap_index = bitmap_size;
+        gdsc[gid].adv_w = g->adv_w;
+        gdsc[gid].box_w = g->box_w;
+        gdsc[gid].box_h = g->box_h;
+        gdsc[gid].ofs_x = g->ofs_x;
+        gdsc[gid].ofs_y = g->ofs_y;
+        bitmap_size += size;
+
+        //Sparse maps of the letters, a new one when the offsets don't fit into 16 bit
+        lv_font_fmt_txt_cmap_t * cm = cmap_cnt > 0 ? &cmaps[cmap_cnt - 1] : NULL;
+        if(cm == NULL || letters[i] - cm->range_start >= CMAP_RANGE_MAX)
+        {
+            cm = &cmaps[cmap_cnt++];
+            cm->range_start = letters[i];
+            cm->glyph_id_start = gid;
+            cm->unicode_list = &lists[gid - 1];
+            cm->type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY;
+        }
+        cm->unicode_list[cm->list_length++] = letters[i] - cm->range_start;
+        cm->range_length = letters[i] - cm->range_start + 1;
+        gid++;
+    }
+    pthread_mutex_unlock(&ttf_mutex);
+
+    if(!res)
+    {
+        free(fdsc);
+        free(gdsc);
+        free(cmaps);
+        free(lists);
+        free(bitmap);
+        return false;
+    }
+
+    fdsc->glyph_bitmap = bitmap != NULL ? bitmap : calloc(1, 1);
+    fdsc->glyph_dsc = gdsc;
+    fdsc->cmaps = cmaps;
+    fdsc->cmap_num = cmap_cnt;
+    fdsc->bpp = TTFONT_BPP;
+    fdsc->bitmap_format = LV_FONT_FMT_TXT_PLAIN;
+    out->get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt;
+    out->get_glyph_bitmap = lv_font_get_bitmap_fmt_txt;
+    out->line_height = font->line_height;
+    out->base_line = font->base_line;
+    out->dsc = fdsc;
+    return true;
+}
+
+void ttfont_build_free(lv_font_t * out)
+{
+    lv_font_fmt_txt_dsc_t * fdsc = out->dsc;
+    if(fdsc != NULL)
+    {
+        free((void *)fdsc->glyph_bitmap);
+        free((void *)fdsc->glyph_dsc);
+        if(fdsc->cmap_num > 0) free(fdsc->cmaps[0].unicode_list);     //The start of every list
+        free((void *)fdsc->cmaps);
+        free(fdsc);
+    }
+    memset(out, 0, sizeof(lv_font_t));
+}
+
+//Save the new glyphs of every font into the asset store now (e.g. before exiting)
+void ttfont_store(void)
+{
+    pthread_mutex_lock(&ttf_mutex);
+    uint32_t i;
+    for(i = 0; i < font_cnt; i++)
+    {
+        if(fonts[i]->dirty) store_save(fonts[i]);
+    }
+    pthread_mutex_unlock(&ttf_mutex);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool glyph_dsc_cb(const lv_font_t * font, lv_font_glyph_dsc_t * dsc, uint32_t letter, uint32_t letter_next)
+{
+    (void)letter_next;      //No kerning, the generated subset has none either
+    pthread_mutex_lock(&ttf_mutex);
+    const glyph_t * g = glyph_get(font->dsc, letter);
+    bool res = g != NULL && !g->missing;
+    if(res)
+    {
+        dsc->adv_w = (g->adv_w + (1 << 3)) >> 4;
+        dsc->box_w = g->box_w;
+        dsc->box_h = g->box_h;
+        dsc->ofs_x = g->ofs_x;
+        dsc->ofs_y = g->ofs_y;
+        dsc->bpp = TTFONT_BPP;
+    }
+    pthread_mutex_unlock(&ttf_mutex);
+    return res;
+}
+
+//The bitmaps stay till the designer exits, they can be used after unlocking
+static const uint8_t * glyph_bitmap_cb(const lv_font_t * font, uint32_t letter)
+{
+    pthread_mutex_lock(&ttf_mutex);
+    const glyph_t * g = glyph_get(font->dsc, letter);
+    const uint8_t * bitmap = g != NULL && !g->missing ? g->bitmap : NULL;
+    pthread_mutex_unlock(&ttf_mutex);
+    return bitmap;
+}
+
+//The glyph of a letter, rasterized if it's new. NULL: out of memory. Needs `ttf_mutex`.
+static const glyph_t * glyph_get(ttf_font_t * f, uint32_t letter)
+{
+    uint32_t mask = f->slot_cnt - 1;
+    uint32_t s;
+    for(s = (letter * 2654435761u) & mask; f->slot_cnt > 0 && f->slots[s] != 0; s = (s + 1) & mask)
+    {
+        const glyph_t * g = &f->glyphs[f->slots[s] - 1];
+        if(g->letter == letter) return g;
+    }
+
+    glyph_t g;
+    if(!glyph_render(f, letter, &g)) return NULL;
+    if(!glyph_add(f, &g))
+    {
+        if(g.own) free((void *)g.bitmap);
+        return NULL;
+    }
+    f->dirty = true;
+    return &f->glyphs[f->glyph_cnt - 1];
+}
+
+static bool glyph_add(ttf_font_t * f, const glyph_t * g)
+{
+    if(f->glyph_cnt == f->glyph_cap)
+    {
+        uint32_t cap = f->glyph_cap > 0 ? f->glyph_cap * 2 : SLOTS_MIN / 2;
+        glyph_t * glyphs = realloc(f->glyphs, cap * sizeof(glyph_t));
+        if(glyphs == NULL) return false;
+        f->glyphs = glyphs;
+        f->glyph_cap = cap;
+    }
+
+    //At most half full, rehashed when it grows
+    if((f->glyph_cnt + 1) * 2 > f->slot_cnt)
+    {
+        uint32_t slot_cnt = f->slot_cnt > 0 ? f->slot_cnt * 2 : SLOTS_MIN;
+        uint32_t * slots = calloc(slot_cnt, sizeof(uint32_t));
+        if(slots == NULL) return false;
+        uint32_t i;
+        for(i = 0; i < f->glyph_cnt; i++)
+        {
+            uint32_t s = (f->glyphs[i].letter * 2654435761u) & (slot_cnt - 1);
+            while(slots[s] != 0) s = (s + 1) & (slot_cnt - 1);
+            slots[s] = i + 1;
+        }
+        free(f->slots);
+        f->slots = slots;
+        f->slot_cnt = slot_cnt;
+    }
+
+    uint32_t mask = f->slot_cnt - 1;
+    uint32_t s = (g->letter * 2654435761u) & mask;
+    while(f->slots[s] != 0) s = (s + 1) & mask;
+    f->glyphs[f->glyph_cnt++] = *g;
+    f->slots[s] = f->glyph_cnt;
+    return true;
+}
+
+//Rasterize a glyph with FreeType and pack its coverage into TTFONT_BPP. A letter the face doesn't have is kept as
+//missing, it isn't looked up again.
+static bool glyph_render(ttf_font_t * f, uint32_t letter, glyph_t * g)
+{
+    memset(g, 0, sizeof(glyph_t));
+    g->letter = letter;
+    g->bitmap = empty_bitmap;
+
+    FT_UInt index = FT_Get_Char_Index(f->ft, letter);
+    if(index == 0 || FT_Load_Glyph(f->ft, index, FT_LOAD_RENDER) != 0)
+    {
+        g->missing = 1;
+        return true;
+    }
+
+    const FT_GlyphSlot slot = f->ft->glyph;
+    const FT_Bitmap * bmp = &slot->bitmap;
+    int32_t adv = (slot->advance.x + 2) >> 2;       //26.6 -> 12.4
+    g->adv_w = LV_MATH_MIN(adv, 0xFFF);
+    g->box_w = LV_MATH_MIN(bmp->width, UINT8_MAX);
+    g->box_h = LV_MATH_MIN(bmp->rows, UINT8_MAX);
+    g->ofs_x = LV_MATH_MAX(LV_MATH_MIN(slot->bitmap_left, INT8_MAX), INT8_MIN);
+    g->ofs_y = LV_MATH_MAX(LV_MATH_MIN(slot->bitmap_top - (int32_t)g->box_h, INT8_MAX), INT8_MIN);
+    if(g->box_w == 0 || g->box_h == 0)
+    {
+        g->box_w = 0;
+        g->box_h = 0;
+        return true;
+    }
+
+    uint8_t * out = calloc(1, bitmap_size_get(g->box_w, g->box_h));
+    if(out == NULL) return false;
+    uint32_t bit = 0;
+    uint32_t y;
+    for(y = 0; y < g->box_h; y++)
+    {
+        const uint8_t * row = bmp->buffer + (int32_t)y * bmp->pitch;
+        uint32_t x;
+        for(x = 0; x < g->box_w; x++, bit += TTFONT_BPP)
+        {
+            uint8_t v;
+            if(bmp->pixel_mode == FT_PIXEL_MODE_MONO) v = (row[x >> 3] >> (7 - (x & 0x7))) & 0x1 ? 0xFF : 0;
+            else v = row[x];
+            v >>= 8 - TTFONT_BPP;
+            out[bit >> 3] |= v << (8 - TTFONT_BPP - (bit & 0x7));
+        }
+    }
+    g->bitmap = out;
+    g->own = 1;
+    return true;
+}
+
+static uint32_t bitmap_size_get(uint8_t box_w, uint8_t box_h)
+{
+    return ((uint32_t)box_w * box_h * TTFONT_BPP + 7) >> 3;
+}
+
+//Take the glyphs of an earlier session, their bitmaps stay in the mapped file. Needs `ttf_mutex`.
+static void store_load(ttf_font_t * f)
+{
+    if(!assetstore_get(f->key, STORE_KIND, &f->blob)) return;
+
+    uint32_t cnt = 0;
+    if(f->blob.size >= sizeof(uint32_t)) memcpy(&cnt, f->blob.data, sizeof(uint32_t));
+    uint32_t head = sizeof(uint32_t) + cnt * sizeof(store_glyph_t);
+    if(cnt > (f->blob.size - sizeof(uint32_t)) / sizeof(store_glyph_t))
+    {
+        assetstore_release(&f->blob);
+        return;
+    }
+
+    const uint8_t * bitmaps = f->blob.data + head;
+    uint32_t bitmaps_size = f->blob.size - head;
+    uint32_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        store_glyph_t r;
+        memcpy(&r, f->blob.data + sizeof(uint32_t) + i * sizeof(store_glyph_t), sizeof(r));
+        uint32_t size = bitmap_size_get(r.box_w, r.box_h);
+        if(r.bitmap_ofs > bitmaps_size || size > bitmaps_size - r.bitmap_ofs) break;    //Damaged
+
+        glyph_t g = {.letter = r.letter, .bitmap = size > 0 ? bitmaps + r.bitmap_ofs : empty_bitmap,
+                     .adv_w = r.adv_w, .box_w = r.box_w, .box_h = r.box_h, .ofs_x = r.ofs_x, .ofs_y = r.ofs_y,
+                     .missing = r.missing != 0};
+        if(!glyph_add(f, &g)) break;
+    }
+}
+
+//Every glyph of the font into the store, the earlier file is replaced. Needs `ttf_mutex`.
+static void store_save(ttf_font_t * f)
+{
+    uint32_t head_size = sizeof(uint32_t) + f->glyph_cnt * sizeof(store_glyph_t);
+    uint32_t bitmaps_size = 0;
+    uint32_t i;
+    for(i = 0; i < f->glyph_cnt; i++) bitmaps_size += bitmap_size_get(f->glyphs[i].box_w, f->glyphs[i].box_h);
+
+    uint8_t * head = malloc(head_size);
+    uint8_t * bitmaps = malloc(bitmaps_size + 1);
+    if(head != NULL && bitmaps != NULL)
+    {
+        memcpy(head, &f->glyph_cnt, sizeof(uint32_t));
+        uint32_t ofs = 0;
+        for(i = 0; i < f->glyph_cnt; i++)
+        {
+            const glyph_t * g = &f->glyphs[i];
+            uint32_t size = bitmap_size_get(g->box_w, g->box_h);
+            store_glyph_t r = {.letter = g->letter, .bitmap_ofs = ofs, .adv_w = g->adv_w, .box_w = g->box_w,
+                               .box_h = g->box_h, .ofs_x = g->ofs_x, .ofs_y = g->ofs_y, .missing = g->missing};
+            memcpy(head + sizeof(uint32_t) + i * sizeof(store_glyph_t), &r, sizeof(r));
+            memcpy(bitmaps + ofs, g->bitmap, size);
+            ofs += size;
+        }
+        if(assetstore_put(f->key, STORE_KIND, head, head_size, bitmaps, bitmaps_size)) f->dirty = false;
+    }
+    free(head);
+    free(bitmaps);
+}
+
+static void store_task(lv_task_t * task)
+{
+    (void)task;
+    ttfont_store();
+}
+
+static bool file_read(const char * path, uint8_t ** buf, size_t * len)
+{
+    FILE * fp = fopen(path, "rb");
+    if(fp == NULL) return false;
+
+    bool res = false;
+    *buf = NULL;
+    if(fseek(fp, 0, SEEK_END) == 0)
+    {
+        long size = ftell(fp);
+        if(size > 0 && size <= FACE_SIZE_MAX && fseek(fp, 0, SEEK_SET) == 0)
+        {
+            *len = size;
+            *buf = malloc(*len);
+            res = *buf != NULL && fread(*buf, 1, *len, fp) == *len;
+        }
+    }
+    fclose(fp);
+    if(!res)
+    {
+        free(*buf);
+        *buf = NULL;
+    }
+    return res;
+}
+
+//The name of the file without its directory and extension, in lower case with `_` instead of the other characters
+static void name_get(char * name, const char * path)
+{
+    const char * base = strrchr(path, '/');
+    base = base != NULL ? base + 1 : path;
+    const char * ext = strrchr(base, '.');
+    size_t len = ext != NULL && ext != base ? (size_t)(ext - base) : strlen(base);
+    if(len > TTFONT_NAME_MAX - 16) len = TTFONT_NAME_MAX - 16;       //Room for `lv_font_` and the size
+
+    size_t i;
+    for(i = 0; i < len; i++) name[i] = isalnum((unsigned char)base[i]) ? tolower((unsigned char)base[i]) : '_';
+    name[len] = '\0';
+    if(len == 0) strcpy(name, "ttf");
+}
@@ -0,0 +1,67 @@
+/**
+ * @file ttfont.h
+ *
+ */
+
+#ifndef _TTFONT_H_
+#define _TTFONT_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define TTFONT_FACE_MAX         8       //TrueType/OpenType files loaded at once
+#define TTFONT_FONT_MAX         32      //Sizes of the faces, they are kept till the designer exits
+#define TTFONT_PX_MIN           6
+#define TTFONT_PX_MAX           96      //The glyphs have to fit into the 8 bit boxes of `lv_font_fmt_txt`
+#define TTFONT_BPP              4       //Of the rasterized glyphs, like the built-in fonts
+#define TTFONT_NAME_MAX         48      //Of the variable in the generated code, with the terminating zero
+#define TTFONT_STORE_PERIOD     2000    //[ms] between two saves of the new glyphs into the asset store
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+int32_t ttfont_add_face(const char * path);
+uint32_t ttfont_get_face_count(void);
+const lv_font_t * ttfont_get(uint32_t face, uint16_t px);
+bool ttfont_is(const lv_font_t * font);
+bool ttfont_get_info(const lv_font_t * font, uint32_t * face, uint16_t * px);
+const char * ttfont_get_name(const lv_font_t * font);
+const char * ttfont_get_ref(const lv_font_t * font);
+uint64_t ttfont_get_hash(const lv_font_t * font);
+bool ttfont_build(const lv_font_t * font, const uint32_t * letters, uint32_t cnt, lv_font_t * out);
+void ttfont_build_free(lv_font_t * out);
+void ttfont_store(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+/**
+ * @file uiblob.c
+ * The export of a screen as a binary blob for `runtime/lv_gui_blob.c`, so the target can get a new UI
+ * without being reflashed. The blob is position independent (indices and offsets only) and laid out
+ * to be read in place from the flash: a node table, the unique styles in a form free of the target's
+ * colour depth, the fonts referred to by name and a string pool of the IDs and texts, each once.
+ * Doesn't touch the widgets, so it can run on any thread.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include "uiblob.h"
+#include "fontsub.h"
+#include "runtime/lv_gui_blob.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define STR_INIT_SIZE       256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+//Every string once, found by a hash of open addressing
+typedef struct
+{
+    char * buf;
+    uint32_t len;
+    uint32_t size;
+    uint32_t * slots;           //Offset + 1 of a string, 0: empty
+    uint32_t slot_cnt;          //Power of 2, at least twice the strings
+}str_pool_t;
+
+typedef struct
+{
+    lv_gui_blob_node_t * nodes;
+    uint32_t node_cnt;
+    lv_gui_blob_style_t * styles;
+    uint32_t style_cnt;
+    lv_gui_blob_asset_t * assets;
+    uint32_t asset_cnt;
+    const lv_font_t ** fonts;   //Of the assets
+    int32_t * style_map;        //Per style of the snapshot: its index in `styles` or -1
+    str_pool_t str;
+}blob_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static bool blob_build(blob_t * b, const projsnap_t * snap, uint32_t root, uint32_t end);
+static void blob_free(blob_t * b);
+static int32_t style_add(blob_t * b, const lv_style_t * style);
+static uint16_t font_add(blob_t * b, const lv_font_t * font);
+static uint32_t color_get(lv_color_t color);
+static bool str_init(str_pool_t * pool, uint32_t max_cnt);
+static uint32_t str_add(str_pool_t * pool, const char * str);
+static uint32_t hash_get(const void * data, size_t len, uint32_t hash);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+
+/**********************
+ *      MACROS
+ **********************/
+#define ALIGN4(x) (((x) + 3) & ~3u)
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+/**
+ * Write the blob of a screen
+ * @param fp the blob goes here
+ * @param snap the project
+ * @param root the screen in `snap`, its descendants until `end` are written
+ * @param end the first node after the screen's subtree
+ * @return false if the screen has too many widgets or out of memory
+ */
+bool uiblob_write(FILE * fp, const projsnap_t * snap, uint32_t root, uint32_t end)
+{
+    if(end - root - 1 > UIBLOB_NODE_MAX)
+    {
+        printf("UI blob: %s has too many widgets (%u, at most %u)\n", snap->nodes[root].id, end - root - 1,
+               UIBLOB_NODE_MAX);
+        return false;
+    }
+
+    blob_t b;
+    if(!blob_build(&b, snap, root, end))
+    {
+        printf("UI blob: out of memory\n");
+        blob_free(&b);
+        return false;
+    }
+
+    lv_gui_blob_header_t h;
+    memset(&h, 0, sizeof(h));
+    h.magic = LV_GUI_BLOB_MAGIC;
+    h.version = LV_GUI_BLOB_VERSION;
+    h.header_size = sizeof(h);
+    h.node_cnt = b.node_cnt;
+    h.style_cnt = b.style_cnt;
+    h.asset_cnt = b.asset_cnt;
+    h.node_ofs = sizeof(h);
+    h.style_ofs = h.node_ofs + b.node_cnt * sizeof(lv_gui_blob_node_t);
+    h.asset_ofs = h.style_ofs + b.style_cnt * sizeof(lv_gui_blob_style_t);
+    h.str_ofs = h.asset_ofs + b.asset_cnt * sizeof(lv_gui_blob_asset_t);
+    h.str_size = b.str.len > 0 ? ALIGN4(b.str.len) : 4;  //Padded with '\0', the next blob in a flash image stays aligned
+    h.size = h.str_ofs + h.str_size;
+
+    static const char pad[4];
+    uint32_t hash = 2166136261u;
+    hash = hash_get(b.nodes, b.node_cnt * sizeof(lv_gui_blob_node_t), hash);
+    hash = hash_get(b.styles, b.style_cnt * sizeof(lv_gui_blob_style_t), hash);
+    hash = hash_get(b.assets, b.asset_cnt * sizeof(lv_gui_blob_asset_t), hash);
+    hash = hash_get(b.str.buf, b.str.len, hash);
+    hash = hash_get(pad, h.str_size - b.str.len, hash);
+    h.hash = hash;
+
+    bool res = fwrite(&h, sizeof(h), 1, fp) == 1;
+    if(res && b.node_cnt) res = fwrite(b.nodes, sizeof(lv_gui_blob_node_t), b.node_cnt, fp) == b.node_cnt;
+    if(res && b.style_cnt) res = fwrite(b.styles, sizeof(lv_gui_blob_style_t), b.style_cnt, fp) == b.style_cnt;
+    if(res && b.asset_cnt) res = fwrite(b.assets, sizeof(lv_gui_blob_asset_t), b.asset_cnt, fp) == b.asset_cnt;
+    if(res) res = fwrite(b.str.buf, 1, b.str.len, fp) == b.str.len;
+    if(res && h.str_size > b.str.len) res = fwrite(pad, 1, h.str_size - b.str.len, fp) == h.str_size - b.str.len;
+
+    blob_free(&b);
+    return res;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+static bool blob_build(blob_t * b, const projsnap_t * snap, uint32_t root, uint32_t end)
+{
+    memset(b, 0, sizeof(blob_t));
+    uint32_t cnt = end - root - 1;
+    b->nodes = calloc(cnt ? cnt : 1, sizeof(lv_gui_blob_node_t));
+    //At most one style and one font per node, fewer after the deduplication
+    b->styles = malloc((cnt ? cnt : 1) * sizeof(lv_gui_blob_style_t));
+    b->assets = malloc((cnt ? cnt : 1) * sizeof(lv_gui_blob_asset_t));
+    b->fonts = malloc((cnt ? cnt : 1) * sizeof(lv_font_t *));
+    b->style_map = malloc((snap->style_cnt ? snap->style_cnt : 1) * sizeof(int32_t));
+    if(b->nodes == NULL || b->styles == NULL || b->assets == NULL || b->fonts == NULL || b->style_map == NULL ||
+       !str_init(&b->str, cnt * 2 + 8))      //The IDs, the texts and the fonts
+    {
+        return false;
+    }
+    uint32_t s;
+    for(s = 0; s < snap->style_cnt; s++) b->style_map[s] = -1;
+
+    uint32_t i;
+    for(i = root + 1; i < end; i++)
+    {
+        const projsnap_node_t * n = &snap->nodes[i];
+        lv_gui_blob_node_t * bn = &b->nodes[b->node_cnt++];
+        bn->parent = n->parent == root ? LV_GUI_BLOB_NONE : n->parent - root - 1;
+        bn->type = n->type;
+        bn->x = n->x;
+        bn->y = n->y;
+        bn->w = n->w;
+        bn->h = n->h;
+        bn->style = LV_GUI_BLOB_NONE;
+        if(n->style != PROJSNAP_NO_STYLE)
+        {
+            if(b->style_map[n->style] < 0) b->style_map[n->style] = style_add(b, &snap->styles[n->style]);
+            bn->style = b->style_map[n->style];
+        }
+        bn->id = str_add(&b->str, n->id);
+        bn->text = n->text != NULL ? str_add(&b->str, n->text) : LV_GUI_BLOB_NO_STR;
+        if(bn->id == LV_GUI_BLOB_NO_STR || (n->text != NULL && bn->text == LV_GUI_BLOB_NO_STR)) return false;
+    }
+    return true;
+}
+
+static void blob_free(blob_t * b)
+{
+    free(b->nodes);
+    free(b->styles);
+    free(b->assets);
+    free(b->fonts);
+    free(b->style_map);
+    free(b->str.buf);
+    free(b->str.slots);
+    memset(b, 0, sizeof(blob_t));
+}
+
+//The index of the style in the blob, equal ones are stored once
+static int32_t style_add(blob_t * b, const lv_style_t * style)
+{
+    lv_gui_blob_style_t s;
+    memset(&s, 0, sizeof(s));       //Compared by bytes, the reserved fields too
+    s.main_color = color_get(style->body.main_color);
+    s.grad_color = color_get(style->body.grad_color);
+    s.border_color = color_get(style->body.border.color);
+    s.shadow_color = color_get(style->body.shadow.color);
+    s.text_color = color_get(style->text.color);
+    s.sel_color = color_get(style->text.sel_color);
+    s.image_color = color_get(style->image.color);
+    s.line_color = color_get(style->line.color);
+    s.radius = style->body.radius;
+    s.border_width = style->body.border.width;
+    s.shadow_width = style->body.shadow.width;
+    s.pad_top = style->body.padding.top;
+    s.pad_bottom = style->body.padding.bottom;
+    s.pad_left = style->body.padding.left;
+    s.pad_right = style->body.padding.right;
+    s.pad_inner = style->body.padding.inner;
+    s.letter_space = style->text.letter_space;
+    s.line_space = style->text.line_space;
+    s.line_width = style->line.width;
+    s.font = font_add(b, style->text.font);
+    s.glass = style->glass;
+    s.body_opa = style->body.opa;
+    s.border_part = style->body.border.part;
+    s.border_opa = style->body.border.opa;
+    s.shadow_type = style->body.shadow.type;
+    s.text_opa = style->text.opa;
+    s.image_intense = style->image.intense;
+    s.image_opa = style->image.opa;
+    s.line_opa = style->line.opa;
+    s.line_rounded = style->line.rounded;
+
+    uint32_t i;
+    for(i = 0; i < b->style_cnt; i++)
+    {
+        if(memcmp(&b->styles[i], &s, sizeof(s)) == 0) return i;
+    }
+    b->styles[b->style_cnt] = s;
+    return b->style_cnt++;
+}
+
+//A custom font of the designer isn't known by the target, it gets LV_FONT_DEFAULT
+static uint16_t font_add(blob_t * b, const lv_font_t * font)
+{
+    const char * name = fontsub_get_name(font);
+    if(name == NULL) return LV_GUI_BLOB_NONE;
+
+    uint32_t i;
+    for(i = 0; i < b->asset_cnt; i++)
+    {
+        if(b->fonts[i] == font) return i;
+    }
+    uint32_t ofs = str_add(&b->str, name);
+    if(ofs == LV_GUI_BLOB_NO_STR) return LV_GUI_BLOB_NONE;
+    b->fonts[b->asset_cnt] = font;
+    b->assets[b->asset_cnt].name = ofs;
+    b->assets[b->asset_cnt].kind = LV_GUI_BLOB_ASSET_FONT;
+    b->assets[b->asset_cnt].reserved = 0;
+    return b->asset_cnt++;
+}
+
+//Rebuilt from RGB by the loader, so the blob fits any LV_COLOR_DEPTH
+static uint32_t color_get(lv_color_t color)
+{
+    lv_color32_t c32;
+    c32.full = lv_color_to32(color);
+    return ((uint32_t)c32.ch.red << 16) | ((uint32_t)c32.ch.green << 8) | c32.ch.blue;
+}
+
+//`max_cnt`: the most strings which will be added
+static bool str_init(str_pool_t * pool, uint32_t max_cnt)
+{
+    pool->slot_cnt = 16;
+    while(pool->slot_cnt < max_cnt * 2) pool->slot_cnt *= 2;
+    pool->slots = calloc(pool->slot_cnt, sizeof(uint32_t));
+    pool->size = STR_INIT_SIZE;
+    pool->buf = malloc(pool->size);
+    pool->len = 0;
+    return pool->slots != NULL && pool->buf != NULL;
+}
+
+//The offset of the string in the pool, LV_GUI_BLOB_NO_STR if out of memory
+static uint32_t str_add(str_pool_t * pool, const char * str)
+{
+    size_t len = strlen(str) + 1;
+    uint32_t mask = pool->slot_cnt - 1;
+    uint32_t slot = hash_get(str, len, 2166136261u) & mask;
+    while(pool->slots[slot] != 0)
+    {
+        uint32_t ofs = pool->slots[slot] - 1;
+        if(strcmp(pool->buf + ofs, str) == 0) return ofs;
+        slot = (slot + 1) & mask;
+    }
+
+    if(pool->len + len > pool->size)
+    {
+        uint32_t new_size = pool->size;
+        while(pool->len + len > new_size) new_size *= 2;
+        char * new_buf = realloc(pool->buf, new_size);
+        if(new_buf == NULL) return LV_GUI_BLOB_NO_STR;
+        pool->buf = new_buf;
+        pool->size = new_size;
+    }
+    uint32_t ofs = pool->len;
+    memcpy(pool->buf + ofs, str, len);
+    pool->len += len;
+    pool->slots[slot] = ofs + 1;
+    return ofs;
+}
+
+//FNV-1a continued from `hash`, the same as the loader's check
+static uint32_t hash_get(const void * data, size_t len, uint32_t hash)
+{
+    const uint8_t * p = data;
+    size_t i;
+    for(i = 0; i < len; i++)
+    {
+        hash ^= p[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
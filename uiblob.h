@@ -0,0 +1,53 @@
+/**
+ * @file uiblob.h
+ *
+ */
+
+#ifndef _UIBLOB_H_
+#define _UIBLOB_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdio.h>
+#include "projjob.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UIBLOB_NODE_MAX     0xFFFE      //The node indices are 16 bit, 0xFFFF is "no parent"
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool uiblob_write(FILE * fp, const projsnap_t * snap, uint32_t root, uint32_t end);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
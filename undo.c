@@ -0,0 +1,780 @@
+/**
+ * @file undo.c
+ * Undo/redo journal of the designer's edits. A step is a small delta with what reverting it needs: the old and the
+ * new position of a moved widget, the two styles of a restyled one, compact records of the created or deleted
+ * widgets. The tree is never snapshotted, undoing a step costs as much as the change did.
+ * The steps are kept in one ring buffer arena of UNDO_ARENA_SIZE bytes, the oldest ones are dropped to make room.
+ * Widgets are referred by their IDs, which a deleted and recreated widget gets back. Renames are steps too.
+ * The entries recorded between undo_group_begin() and undo_group_end() are one step, e.g. a bulk edit of the selection.
+ * Used only on the UI thread.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "undo.h"
+#include "dataset.h"
+#include "widgetid.h"
+#include "widgetreg.h"
+#include "stylepool.h"
+#include "toolbox.h"
+#include "setting.h"
+#include "autosave.h"
+#include "custom_widget.h"
+#include "propbind.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UNDO_NONE       0xFFFFFFFF
+#define UNDO_ALIGN      8
+#define ID_MAX          sizeof(((widget_info_t *)0)->id)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef enum
+{
+    UNDO_CREATE,                //undo_tree_t, the entry's widget is the parent
+    UNDO_DELETE,                //undo_tree_t, the entry's widget is the parent
+    UNDO_MOVE,                  //undo_geom_t of x and y
+    UNDO_RESIZE,                //undo_geom_t of w and h
+    UNDO_RESTYLE,               //undo_style_t
+    UNDO_REPARENT,              //undo_reparent_t
+    UNDO_RENAME,                //undo_rename_t, the entry's ID is the new one
+}undo_kind_t;
+
+typedef struct
+{
+    uint32_t size;              //With the payload, a multiple of UNDO_ALIGN
+    uint32_t prev;              //Offset of the previous entry, not valid in the oldest one
+    uint32_t time;              //lv_tick_get() of the last edit coalesced into it
+    uint8_t kind;
+    uint8_t joined : 1;         //Undone and redone with the previous entry, they are one step
+    uint8_t grouped : 1;        //Part of a group, later edits are not coalesced into it
+    char id[ID_MAX];            //The edited widget
+}undo_entry_t;
+
+typedef struct
+{
+    lv_coord_t from[2];
+    lv_coord_t to[2];
+}undo_geom_t;
+
+typedef struct
+{
+    const lv_style_t * from;    //Both have a reference if they are interned
+    const lv_style_t * to;
+}undo_style_t;
+
+typedef struct
+{
+    char from_par[ID_MAX];
+    char from_next[ID_MAX];     //The sibling it was before, "": it was the last child
+    char to_par[ID_MAX];
+    char to_next[ID_MAX];
+}undo_reparent_t;
+
+typedef struct
+{
+    char from[ID_MAX];
+}undo_rename_t;
+
+typedef struct
+{
+    char next[ID_MAX];          //The roots are before this sibling, "": they are the last children
+    uint32_t cnt;               //Records, undo_node_t-s follow
+}undo_tree_t;
+
+//A widget of the created or deleted subtrees, in preorder
+typedef struct
+{
+    const lv_style_t * style;   //Has a reference if it's interned
+    uint32_t size;              //With the text, a multiple of UNDO_ALIGN
+    uint32_t depth;             //0: a root, a child of the entry's widget
+    lv_coord_t x, y, w, h;
+    widgetreg_val_t vals[WIDGETREG_VAL_MAX];    //Its numeric attributes
+    uint16_t type;
+    uint8_t has_text;
+    uint8_t val_cnt;
+    char id[ID_MAX];
+    char text[];                //What it shows, if `has_text`
+}undo_node_t;
+
+//The widget before the edit between undo_edit_begin() and undo_edit_end()
+typedef struct
+{
+    char id[ID_MAX];
+    lv_coord_t x, y, w, h;
+    const lv_style_t * style;   //Has a reference, so an edit copies it instead of changing it in place
+    bool active;
+}undo_pending_t;
+
+typedef struct
+{
+    uint8_t * buf;              //NULL: only measure
+    uint32_t size;
+    uint32_t cnt;
+    uint32_t depth;
+}tree_ctx_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t entry_alloc(undo_kind_t kind, const char * id, uint32_t payload_size);
+static uint32_t entry_next(uint32_t off);
+static void entry_release(undo_entry_t * e);
+static bool entry_apply(undo_entry_t * e, bool undo);
+static void drop_oldest(void);
+static void drop_newest(void);
+static undo_entry_t * coalesce_target(undo_kind_t kind, const char * id);
+static void tree_record(undo_kind_t kind, doc_id_t first, uint32_t root_cnt);
+static bool tree_enter_cb(doc_id_t id, void * user_data);
+static bool tree_leave_cb(doc_id_t id, void * user_data);
+static bool tree_build(undo_entry_t * e);
+static bool tree_delete(undo_entry_t * e);
+static void geom_record(undo_kind_t kind, const char * id, lv_coord_t from_0, lv_coord_t from_1, lv_coord_t to_0,
+                        lv_coord_t to_1);
+static void style_record(const char * id, const lv_style_t * from, const lv_style_t * to);
+static void pending_release(void);
+static doc_id_t node_find(const char * id);
+static void id_get(doc_id_t node, char * id);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static uint8_t * arena = NULL;
+static uint32_t first = UNDO_NONE;      //Oldest entry
+static uint32_t last = UNDO_NONE;       //Newest entry, the redo steps end here
+static uint32_t top = UNDO_NONE;        //Newest applied entry, the next undo reverts it
+static uint32_t wrap_end = 0;           //While `last < first` the entries continue from 0 after this
+static uint32_t entry_cnt = 0;
+static uint32_t done_cnt = 0;           //Applied entries, the others were undone
+static undo_stat_t stat;
+static undo_pending_t pending;
+static uint32_t step_cnt = 0;           //Entries without `joined`
+static uint32_t done_step_cnt = 0;
+static uint16_t group_nest = 0;         //Open undo_group_begin() calls
+static uint32_t group_entry_cnt = 0;    //Entries recorded in the open group
+static bool replaying = false;          //Undoing or redoing, the changes made by it are not recorded
+
+/**********************
+ *      MACROS
+ **********************/
+#define ALIGN_UP(s)         (((s) + UNDO_ALIGN - 1) & ~(uint32_t)(UNDO_ALIGN - 1))
+#define ENTRY(off)          ((undo_entry_t *)(arena + (off)))
+#define PAYLOAD(e)          ((void *)((uint8_t *)(e) + ALIGN_UP(sizeof(undo_entry_t))))
+#define TREE_NODES(t)       ((uint8_t *)(t) + ALIGN_UP(sizeof(undo_tree_t)))
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+
+//Forget every step, e.g. when a project is loaded
+void undo_clear(void)
+{
+    pending_release();
+    done_cnt = 0;
+    done_step_cnt = 0;
+    while(entry_cnt > 0) drop_newest();
+    group_entry_cnt = 0;        //An open group continues with a new step
+}
+
+//Record the edits until the matching undo_group_end() as one step. Can be nested, the outermost one counts.
+void undo_group_begin(void)
+{
+    if(group_nest == 0) group_entry_cnt = 0;
+    group_nest++;
+}
+
+void undo_group_end(void)
+{
+    if(group_nest == 0) return;
+    group_nest--;
+
+    //A group of one entry is a usual step, the next edit of the widget can be merged into it again
+    if(group_nest == 0 && group_entry_cnt == 1 && done_cnt > 0) ENTRY(top)->grouped = 0;
+}
+
+//`cnt` siblings from `first` were created
+void undo_record_create(doc_id_t first_node, uint32_t cnt)
+{
+    if(replaying || cnt == 0) return;
+    tree_record(UNDO_CREATE, first_node, cnt);
+}
+
+//Call it before the subtree is deleted
+void undo_record_delete(doc_id_t root)
+{
+    if(replaying) return;
+    tree_record(UNDO_DELETE, root, 1);
+}
+
+//Call it after the node was moved from the place before `old_next` of `old_par`
+void undo_record_reparent(doc_id_t node, doc_id_t old_par, doc_id_t old_next)
+{
+    doc_node_t * n = doc_get(node);
+    if(replaying || n == NULL) return;
+
+    char id[ID_MAX];
+    id_get(node, id);
+    uint32_t off = entry_alloc(UNDO_REPARENT, id, sizeof(undo_reparent_t));
+    if(off == UNDO_NONE) return;
+    undo_reparent_t * r = PAYLOAD(ENTRY(off));
+    id_get(old_par, r->from_par);
+    id_get(old_next, r->from_next);
+    id_get(n->parent, r->to_par);
+    id_get(n->next, r->to_next);
+}
+
+//Call it after the widget was moved from (x;y) without undo_edit_begin(), e.g. along with an other dragged one
+void undo_record_move(doc_id_t node, lv_coord_t x, lv_coord_t y)
+{
+    doc_node_t * n = doc_get(node);
+    widget_info_t * info = n != NULL ? widget_get_info(n->obj) : NULL;
+    if(replaying || info == NULL) return;
+
+    lv_coord_t new_x = lv_obj_get_x(n->obj);
+    lv_coord_t new_y = lv_obj_get_y(n->obj);
+    if(new_x != x || new_y != y) geom_record(UNDO_MOVE, info->id, x, y, new_x, new_y);
+}
+
+//Call it after the widget got its new ID
+void undo_record_rename(doc_id_t node, const char * old_id)
+{
+    char id[ID_MAX];
+    id_get(node, id);
+    if(replaying || id[0] == '\0' || strcmp(id, old_id) == 0) return;
+
+    uint32_t off = entry_alloc(UNDO_RENAME, id, sizeof(undo_rename_t));
+    if(off == UNDO_NONE) return;
+    undo_rename_t * r = PAYLOAD(ENTRY(off));
+    strncpy(r->from, old_id, ID_MAX - 1);
+    r->from[ID_MAX - 1] = '\0';
+}
+
+//Remember the position, the size and the style of a widget before an edit, e.g. when a drag begins
+void undo_edit_begin(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    widget_info_t * info = n != NULL ? widget_get_info(n->obj) : NULL;
+    if(replaying || info == NULL) return;
+
+    pending_release();
+    memcpy(pending.id, info->id, ID_MAX);
+    pending.x = lv_obj_get_x(n->obj);
+    pending.y = lv_obj_get_y(n->obj);
+    pending.w = lv_obj_get_width(n->obj);
+    pending.h = lv_obj_get_height(n->obj);
+    pending.style = n->obj->style_p;
+    stylepool_retain(pending.style);
+    pending.active = true;
+}
+
+//Record what the edit started by undo_edit_begin() changed. However long a drag was, it's one step.
+void undo_edit_end(doc_id_t node)
+{
+    doc_node_t * n = doc_get(node);
+    widget_info_t * info = n != NULL ? widget_get_info(n->obj) : NULL;
+    if(!pending.active || info == NULL || strcmp(info->id, pending.id) != 0)
+    {
+        pending_release();
+        return;
+    }
+
+    lv_coord_t x = lv_obj_get_x(n->obj);
+    lv_coord_t y = lv_obj_get_y(n->obj);
+    lv_coord_t w = lv_obj_get_width(n->obj);
+    lv_coord_t h = lv_obj_get_height(n->obj);
+    if(x != pending.x || y != pending.y) geom_record(UNDO_MOVE, info->id, pending.x, pending.y, x, y);
+    if(w != pending.w || h != pending.h) geom_record(UNDO_RESIZE, info->id, pending.w, pending.h, w, h);
+    if(n->obj->style_p != pending.style) style_record(info->id, pending.style, n->obj->style_p);
+    pending_release();
+}
+
+//Revert the newest applied step. false: there is none or it couldn't be reverted (then the journal is cleared).
+bool undo_undo(void)
+{
+    pending_release();
+    if(done_cnt == 0) return false;
+
+    lv_obj_batch_begin();       //A group is redrawn once
+    bool joined;
+    do
+    {
+        undo_entry_t * e = ENTRY(top);
+        joined = e->joined;
+        if(!entry_apply(e, true))
+        {
+            lv_obj_batch_commit();
+            return false;
+        }
+        done_cnt--;
+        top = done_cnt > 0 ? e->prev : UNDO_NONE;
+    }while(joined && done_cnt > 0);
+    lv_obj_batch_commit();
+    done_step_cnt--;
+    return true;
+}
+
+//Apply the oldest undone step again
+bool undo_redo(void)
+{
+    pending_release();
+    if(done_cnt == entry_cnt) return false;
+
+    lv_obj_batch_begin();
+    do
+    {
+        uint32_t off = done_cnt > 0 ? entry_next(top) : first;
+        if(!entry_apply(ENTRY(off), false))
+        {
+            lv_obj_batch_commit();
+            return false;
+        }
+        done_cnt++;
+        top = off;
+    }while(done_cnt < entry_cnt && ENTRY(entry_next(top))->joined);
+    lv_obj_batch_commit();
+    done_step_cnt++;
+    return true;
+}
+
+void undo_get_stat(undo_stat_t * s)
+{
+    *s = stat;
+    s->undo_cnt = done_step_cnt;
+    s->redo_cnt = step_cnt - done_step_cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+
+//Append an entry after `top`, the undone steps can't be redone after a new one. Returns its offset or UNDO_NONE.
+static uint32_t entry_alloc(undo_kind_t kind, const char * id, uint32_t payload_size)
+{
+    while(entry_cnt > done_cnt) drop_newest();
+
+    uint32_t size = ALIGN_UP(ALIGN_UP(sizeof(undo_entry_t)) + payload_size);
+    if(size > UNDO_ARENA_SIZE)
+    {
+        //Without the step the older ones would refer to widgets which may not be there any more
+        printf("Undo: a step of %u bytes doesn't fit into the journal, it's cleared\n", size);
+        undo_clear();
+        return UNDO_NONE;
+    }
+    if(arena == NULL)
+    {
+        arena = malloc(UNDO_ARENA_SIZE);
+        if(arena == NULL)
+        {
+            printf("Undo: out of memory\n");
+            return UNDO_NONE;
+        }
+    }
+
+    uint32_t off;
+    while(1)
+    {
+        if(entry_cnt == 0)
+        {
+            off = 0;
+            break;
+        }
+        uint32_t tail = last + ENTRY(last)->size;
+        if(last >= first)
+        {
+            if(tail + size <= UNDO_ARENA_SIZE)
+            {
+                off = tail;
+                break;
+            }
+            if(size <= first)       //Continue from the beginning
+            {
+                wrap_end = tail;
+                off = 0;
+                break;
+            }
+        }else if(tail + size <= first)
+        {
+            off = tail;
+            break;
+        }
+        drop_oldest();
+    }
+
+    undo_entry_t * e = ENTRY(off);
+    e->size = size;
+    e->prev = entry_cnt > 0 ? last : UNDO_NONE;
+    e->time = lv_tick_get();
+    e->kind = kind;
+    e->joined = group_nest > 0 && group_entry_cnt > 0 && entry_cnt > 0;   //Not if the group's start was dropped
+    e->grouped = group_nest > 0;
+    strncpy(e->id, id, ID_MAX - 1);
+    e->id[ID_MAX - 1] = '\0';
+
+    if(entry_cnt == 0) first = off;
+    last = off;
+    top = off;
+    entry_cnt++;
+    done_cnt++;
+    if(group_nest > 0) group_entry_cnt++;
+    if(!e->joined)
+    {
+        step_cnt++;
+        done_step_cnt++;
+    }
+    stat.used += size;
+    return off;
+}
+
+static uint32_t entry_next(uint32_t off)
+{
+    uint32_t next = off + ENTRY(off)->size;
+    if(last < first && off >= first && next == wrap_end) next = 0;
+    return next;
+}
+
+//Drop the references the entry holds
+static void entry_release(undo_entry_t * e)
+{
+    if(e->kind == UNDO_CREATE || e->kind == UNDO_DELETE)
+    {
+        undo_tree_t * t = PAYLOAD(e);
+        uint8_t * p = TREE_NODES(t);
+        uint32_t i;
+        for(i = 0; i < t->cnt; i++)
+        {
+            undo_node_t * r = (undo_node_t *)p;
+            stylepool_release(r->style);
+            p += r->size;
+        }
+    }else if(e->kind == UNDO_RESTYLE)
+    {
+        undo_style_t * s = PAYLOAD(e);
+        stylepool_release(s->from);
+        stylepool_release(s->to);
+    }
+}
+
+static bool entry_apply(undo_entry_t * e, bool undo)
+{
+    replaying = true;
+    bool res = true;
+    doc_id_t node = e->kind == UNDO_RENAME && !undo ? DOC_NONE : node_find(e->id);
+    switch(e->kind)
+    {
+        case UNDO_CREATE:
+            res = undo ? tree_delete(e) : tree_build(e);
+            break;
+        case UNDO_DELETE:
+            res = undo ? tree_build(e) : tree_delete(e);
+            break;
+        case UNDO_MOVE:
+        case UNDO_RESIZE:
+        {
+            res = node != DOC_NONE;
+            if(!res) break;
+            undo_geom_t * g = PAYLOAD(e);
+            const lv_coord_t * v = undo ? g->from : g->to;
+            if(e->kind == UNDO_MOVE) lv_obj_set_pos(doc_get(node)->obj, v[0], v[1]);
+            else lv_obj_set_size(doc_get(node)->obj, v[0], v[1]);
+            autosave_mark(node);
+            break;
+        }
+        case UNDO_RESTYLE:
+        {
+            res = node != DOC_NONE;
+            if(!res) break;
+            undo_style_t * s = PAYLOAD(e);
+            stylepool_set(doc_get(node)->obj, undo ? s->from : s->to);
+            break;
+        }
+        case UNDO_REPARENT:
+        {
+            undo_reparent_t * r = PAYLOAD(e);
+            const char * next_id = undo ? r->from_next : r->to_next;
+            doc_id_t par = node_find(undo ? r->from_par : r->to_par);
+            doc_id_t next = node_find(next_id);
+            res = node != DOC_NONE && par != DOC_NONE && (next_id[0] == '\0' || next != DOC_NONE);
+            if(res) res = layerview_move(node, par, next);
+            break;
+        }
+        case UNDO_RENAME:
+        {
+            undo_rename_t * r = PAYLOAD(e);
+            if(!undo) node = node_find(r->from);
+            res = node != DOC_NONE && widgetid_rename(doc_get(node)->obj, undo ? r->from : e->id);
+            layerview_refr_request();
+            break;
+        }
+    }
+    replaying = false;
+
+    if(!res)
+    {
+        printf("Undo: a widget of the step is missing or its ID is taken, the journal is cleared\n");
+        undo_clear();
+        return false;
+    }
+
+    propbind_changed(layerview_get_sel_obj(), PROP_ALL);   //Show the attributes of the selected widget as they are now
+    return true;
+}
+
+//Drop the oldest step, all the entries of it
+static void drop_oldest(void)
+{
+    stat.dropped++;
+    step_cnt--;
+    done_step_cnt--;
+    do
+    {
+        undo_entry_t * e = ENTRY(first);
+        entry_release(e);
+        stat.used -= e->size;
+        entry_cnt--;
+        done_cnt--;
+        if(entry_cnt == 0)
+        {
+            first = last = top = UNDO_NONE;
+            return;
+        }
+        first = entry_next(first);
+    }while(ENTRY(first)->joined);
+}
+
+//Drop an undone step or, while clearing, any step
+static void drop_newest(void)
+{
+    undo_entry_t * e = ENTRY(last);
+    entry_release(e);
+    stat.used -= e->size;
+    entry_cnt--;
+    if(!e->joined) step_cnt--;
+    if(entry_cnt == 0)
+    {
+        first = last = top = UNDO_NONE;
+        return;
+    }
+    last = e->prev;
+}
+
+//The newest step if an other edit of the same widget and kind can be merged into it
+static undo_entry_t * coalesce_target(undo_kind_t kind, const char * id)
+{
+    while(entry_cnt > done_cnt) drop_newest();
+    if(done_cnt == 0 || group_nest > 0) return NULL;
+
+    undo_entry_t * e = ENTRY(top);
+    if(e->grouped || e->kind != kind || strcmp(e->id, id) != 0 || lv_tick_elaps(e->time) >= UNDO_COALESCE_TIME) return NULL;
+    e->time = lv_tick_get();
+    return e;
+}
+
+//One entry of `root_cnt` siblings from `first_node` with their descendants
+static void tree_record(undo_kind_t kind, doc_id_t first_node, uint32_t root_cnt)
+{
+    doc_node_t * n = doc_get(first_node);
+    if(n == NULL || n->parent == DOC_ROOT) return;
+
+    char par_id[ID_MAX];
+    id_get(n->parent, par_id);
+    tree_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    doc_id_t id = first_node;
+    doc_id_t next = DOC_NONE;
+    uint32_t i;
+    for(i = 0; i < root_cnt && id != DOC_NONE; i++)
+    {
+        doc_traverse(id, tree_enter_cb, tree_leave_cb, &ctx);
+        next = doc_get(id)->next;
+        id = next;
+    }
+    root_cnt = i;
+
+    uint32_t off = entry_alloc(kind, par_id, ALIGN_UP(sizeof(undo_tree_t)) + ctx.size);
+    if(off == UNDO_NONE) return;
+    undo_tree_t * t = PAYLOAD(ENTRY(off));
+    id_get(next, t->next);
+    t->cnt = ctx.cnt;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.buf = TREE_NODES(t);
+    id = first_node;
+    for(i = 0; i < root_cnt; i++)
+    {
+        doc_traverse(id, tree_enter_cb, tree_leave_cb, &ctx);
+        id = doc_get(id)->next;
+    }
+}
+
+static bool tree_enter_cb(doc_id_t id, void * user_data)
+{
+    tree_ctx_t * ctx = user_data;
+    lv_obj_t * obj = doc_get(id)->obj;
+    widget_info_t * info = widget_get_info(obj);
+    const char * text = widgetreg_text_get(obj, info->type);
+    uint32_t size = ALIGN_UP(offsetof(undo_node_t, text) + (text != NULL ? strlen(text) + 1 : 0));
+
+    if(ctx->buf != NULL)
+    {
+        undo_node_t * r = (undo_node_t *)(ctx->buf + ctx->size);
+        r->style = obj->style_p;
+        stylepool_retain(r->style);
+        r->size = size;
+        r->depth = ctx->depth;
+        r->x = lv_obj_get_x(obj);
+        r->y = lv_obj_get_y(obj);
+        r->w = lv_obj_get_width(obj);
+        r->h = lv_obj_get_height(obj);
+        r->val_cnt = widgetreg_vals_get(obj, info->type, r->vals);
+        r->type = info->type;
+        r->has_text = text != NULL;
+        memcpy(r->id, info->id, ID_MAX);
+        if(text != NULL) strcpy(r->text, text);
+    }
+    ctx->size += size;
+    ctx->cnt++;
+    ctx->depth++;
+    return true;
+}
+
+static bool tree_leave_cb(doc_id_t id, void * user_data)
+{
+    (void)id;
+    tree_ctx_t * ctx = user_data;
+    ctx->depth--;
+    return true;
+}
+
+//Create the widgets of the records again, with their IDs and at their old place among the siblings
+static bool tree_build(undo_entry_t * e)
+{
+    undo_tree_t * t = PAYLOAD(e);
+    doc_id_t par = node_find(e->id);
+    doc_id_t next = node_find(t->next);
+    if(par == DOC_NONE || (t->next[0] != '\0' && next == DOC_NONE)) return false;
+
+    doc_id_t * at_depth = malloc(t->cnt * sizeof(doc_id_t));    //The last created node on every level
+    if(at_depth == NULL) return false;
+
+    lv_obj_batch_begin();
+    bool res = true;
+    uint8_t * p = TREE_NODES(t);
+    uint32_t i;
+    for(i = 0; i < t->cnt; i++)
+    {
+        undo_node_t * r = (undo_node_t *)p;
+        p += r->size;
+        lv_obj_t * obj = toolbox_restore(r->type, r->depth == 0 ? par : at_depth[r->depth - 1]);
+        if(obj == NULL || !widgetid_rename(obj, r->id))
+        {
+            res = false;
+            break;
+        }
+        stylepool_set(obj, r->style);
+        if(r->has_text) widgetreg_text_apply(obj, r->type, r->text);
+        widgetreg_vals_apply(obj, r->type, r->vals, r->val_cnt);
+        lv_obj_set_size(obj, r->w, r->h);
+        lv_obj_set_pos(obj, r->x, r->y);
+
+        doc_id_t node = widget_get_info(obj)->node;
+        at_depth[r->depth] = node;
+        if(r->depth == 0 && next != DOC_NONE) layerview_move(node, par, next);
+    }
+    lv_obj_batch_commit();
+    free(at_depth);
+    return res;
+}
+
+static bool tree_delete(undo_entry_t * e)
+{
+    undo_tree_t * t = PAYLOAD(e);
+    lv_obj_batch_begin();
+    bool res = true;
+    uint8_t * p = TREE_NODES(t);
+    uint32_t i;
+    for(i = 0; i < t->cnt; i++)
+    {
+        undo_node_t * r = (undo_node_t *)p;
+        p += r->size;
+        if(r->depth != 0) continue;         //Deleted with the root
+        doc_id_t node = node_find(r->id);
+        if(node == DOC_NONE)
+        {
+            res = false;
+            break;
+        }
+        layerview_del(node);
+    }
+    lv_obj_batch_commit();
+    return res;
+}
+
+static void geom_record(undo_kind_t kind, const char * id, lv_coord_t from_0, lv_coord_t from_1, lv_coord_t to_0,
+                        lv_coord_t to_1)
+{
+    undo_entry_t * e = coalesce_target(kind, id);
+    if(e == NULL)
+    {
+        uint32_t off = entry_alloc(kind, id, sizeof(undo_geom_t));
+        if(off == UNDO_NONE) return;
+        e = ENTRY(off);
+        undo_geom_t * g = PAYLOAD(e);
+        g->from[0] = from_0;
+        g->from[1] = from_1;
+    }
+    undo_geom_t * g = PAYLOAD(e);
+    g->to[0] = to_0;
+    g->to[1] = to_1;
+}
+
+static void style_record(const char * id, const lv_style_t * from, const lv_style_t * to)
+{
+    undo_entry_t * e = coalesce_target(UNDO_RESTYLE, id);
+    undo_style_t * s;
+    if(e == NULL)
+    {
+        uint32_t off = entry_alloc(UNDO_RESTYLE, id, sizeof(undo_style_t));
+        if(off == UNDO_NONE) return;
+        s = PAYLOAD(ENTRY(off));
+        s->from = from;
+        stylepool_retain(from);
+    }else
+    {
+        s = PAYLOAD(e);
+        stylepool_release(s->to);
+    }
+    s->to = to;
+    stylepool_retain(to);
+}
+
+static void pending_release(void)
+{
+    if(!pending.active) return;
+    stylepool_release(pending.style);
+    pending.active = false;
+}
+
+//DOC_NONE if there is no such widget or `id` is ""
+static doc_id_t node_find(const char * id)
+{
+    if(id[0] == '\0') return DOC_NONE;
+    widget_info_t * info = widget_get_info(widgetid_find(id));
+    return info != NULL ? info->node : DOC_NONE;
+}
+
+//"" for DOC_NONE
+static void id_get(doc_id_t node, char * id)
+{
+    doc_node_t * n = node != DOC_NONE ? doc_get(node) : NULL;
+    widget_info_t * info = n != NULL ? widget_get_info(n->obj) : NULL;
+    if(info != NULL) memcpy(id, info->id, ID_MAX);
+    else id[0] = '\0';
+}
@@ -0,0 +1,72 @@
+/**
+ * @file undo.h
+ *
+ */
+
+#ifndef _UNDO_H_
+#define _UNDO_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "doctree.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define UNDO_ARENA_SIZE         (1024 * 1024)   //Memory cap of the journal, the oldest steps are dropped above it
+#define UNDO_COALESCE_TIME      500             //[ms] Edits of the same kind on a widget within it are one step
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t undo_cnt;          //Steps which can be undone
+    uint32_t redo_cnt;          //Undone steps which can be redone
+    uint32_t used;              //Bytes of the arena used by the steps
+    uint32_t dropped;           //Oldest steps dropped to stay in UNDO_ARENA_SIZE
+}undo_stat_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void undo_clear(void);
+void undo_record_create(doc_id_t first, uint32_t cnt);
+void undo_record_delete(doc_id_t root);
+void undo_record_reparent(doc_id_t node, doc_id_t old_par, doc_id_t old_next);
+void undo_record_move(doc_id_t node, lv_coord_t x, lv_coord_t y);
+void undo_record_rename(doc_id_t node, const char * old_id);
+void undo_edit_begin(doc_id_t node);
+void undo_edit_end(doc_id_t node);
+void undo_group_begin(void);
+void undo_group_end(void);
+bool undo_undo(void);
+bool undo_redo(void);
+void undo_get_stat(undo_stat_t * stat);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
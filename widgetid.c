@@ -0,0 +1,195 @@
+/**
+ * @widgetid .c
+ * Unique IDs of the widgets. An ID is the widget's name in the saved project and the variable
+ * name in the generated code, so it must be a C identifier. The index is an open addressing hash
+ * table from ID to widget, lookups and renames are O(1) on any project size.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "widgetid.h"
+#include "dataset.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+#define SLOT_NONE   UINT32_MAX
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t hash;
+    lv_obj_t * obj;             //NULL: empty or removed slot
+    uint8_t removed;            //Tombstone, keeps the probe chains after it intact
+}id_slot_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t id_hash(const char * id);
+static uint32_t id_lookup(const char * id, uint32_t hash);
+static bool id_insert(lv_obj_t * obj, uint32_t hash);
+static bool id_table_resize(uint32_t new_cap);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static id_slot_t * id_table = NULL;
+static uint32_t id_cap = 0;
+static uint32_t id_used = 0;            //Live and removed slots
+static uint32_t id_cnt = 0;             //Live slots
+static uint32_t auto_cnt[WIDGET_TYPE_NUM];
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+//Give a new widget the first free "<type>_<n>" ID
+bool widgetid_assign(lv_obj_t * obj)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return false;
+
+    char id[sizeof(info->id)];
+    uint32_t hash;
+    do
+    {
+        snprintf(id, sizeof(id), "%s_%u", widget_get_type_name(info->type), (unsigned)++auto_cnt[info->type]);
+        hash = id_hash(id);
+    }while(id_lookup(id, hash) != SLOT_NONE);
+
+    strcpy(info->id, id);
+    return id_insert(obj, hash);
+}
+
+//Returns false if `id` isn't a valid identifier or an other widget has it
+bool widgetid_rename(lv_obj_t * obj, const char * id)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL || !widgetid_is_valid(id) || strlen(id) >= sizeof(info->id)) return false;
+
+    uint32_t hash = id_hash(id);
+    uint32_t i = id_lookup(id, hash);
+    if(i != SLOT_NONE) return id_table[i].obj == obj;
+
+    widgetid_remove(obj);
+    strcpy(info->id, id);
+    return id_insert(obj, hash);
+}
+
+lv_obj_t * widgetid_find(const char * id)
+{
+    uint32_t i = id_lookup(id, id_hash(id));
+    return i != SLOT_NONE ? id_table[i].obj : NULL;
+}
+
+void widgetid_remove(lv_obj_t * obj)
+{
+    widget_info_t * info = widget_get_info(obj);
+    if(info == NULL) return;
+
+    uint32_t i = id_lookup(info->id, id_hash(info->id));
+    if(i == SLOT_NONE || id_table[i].obj != obj) return;
+    id_table[i].obj = NULL;
+    id_table[i].removed = 1;
+    id_cnt--;
+}
+
+bool widgetid_is_valid(const char * id)     //A C identifier
+{
+    if(id == NULL || !(isalpha((unsigned char)id[0]) || id[0] == '_')) return false;
+    for(id++; *id; id++)
+    {
+        if(!(isalnum((unsigned char)*id) || *id == '_')) return false;
+    }
+    return true;
+}
+
+uint32_t widgetid_get_count(void)
+{
+    return id_cnt;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static uint32_t id_hash(const char * id)     //FNV-1a
+{
+    uint32_t h = FNV_OFFSET;
+    while(*id)
+    {
+        h ^= (uint8_t)*id++;
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint32_t id_lookup(const char * id, uint32_t hash)
+{
+    if(id_table == NULL) return SLOT_NONE;
+
+    uint32_t i = hash & (id_cap - 1);
+    uint32_t probes;
+    for(probes = 0; probes < id_cap; probes++)
+    {
+        id_slot_t * slot = &id_table[i];
+        if(slot->obj == NULL && !slot->removed) break;      //End of the chain
+        if(slot->obj != NULL && slot->hash == hash && !strcmp(widget_get_info(slot->obj)->id, id)) return i;
+        i = (i + 1) & (id_cap - 1);
+    }
+    return SLOT_NONE;
+}
+
+static bool id_insert(lv_obj_t * obj, uint32_t hash)
+{
+    if((id_used + 1) * 4 > id_cap * 3)
+    {
+        uint32_t new_cap = id_cap ? id_cap : WIDGETID_INIT_SLOTS;
+        if((id_cnt + 1) * 2 > new_cap) new_cap *= 2;    //Else dropping the tombstones is enough
+        if(!id_table_resize(new_cap)) return false;
+    }
+
+    uint32_t i = hash & (id_cap - 1);
+    while(id_table[i].obj != NULL) i = (i + 1) & (id_cap - 1);     //Reuse the first tombstone too
+
+    if(!id_table[i].removed) id_used++;
+    id_table[i].hash = hash;
+    id_table[i].obj = obj;
+    id_table[i].removed = 0;
+    id_cnt++;
+    return true;
+}
+
+static bool id_table_resize(uint32_t new_cap)
+{
+    id_slot_t * new_table = calloc(new_cap, sizeof(id_slot_t));
+    if(new_table == NULL) return false;
+
+    uint32_t i;
+    for(i = 0; i < id_cap; i++)
+    {
+        if(id_table[i].obj == NULL) continue;
+        uint32_t j = id_table[i].hash & (new_cap - 1);
+        while(new_table[j].obj != NULL) j = (j + 1) & (new_cap - 1);
+        new_table[j] = id_table[i];
+    }
+
+    free(id_table);
+    id_table = new_table;
+    id_cap = new_cap;
+    id_used = id_cnt;
+    return true;
+}
@@ -0,0 +1,55 @@
+/**
+ * @file widgetid.h
+ *
+ */
+
+#ifndef _WIDGETID_H_
+#define _WIDGETID_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define WIDGETID_INIT_SLOTS     256     //Must be a power of 2, the table doubles when it's 3/4 full
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool widgetid_assign(lv_obj_t * obj);
+bool widgetid_rename(lv_obj_t * obj, const char * id);
+lv_obj_t * widgetid_find(const char * id);
+void widgetid_remove(lv_obj_t * obj);
+bool widgetid_is_valid(const char * id);
+uint32_t widgetid_get_count(void);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,758 @@
+/**
+ * @widgetreg .c
+ * Registry of the widget types the designer knows: XML tag -> create function -> attribute setters.
+ * Tags and attributes are kept in open addressing hash tables, so the loader resolves an element
+ * with one hash and (usually) one string compare instead of a strcmp chain.
+ * The attribute tables are the property schema: getters, defaults and code templates of every type,
+ * so the default values can be left out of the saved files and the generated code.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include "widgetreg.h"
+#include "widgetid.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define FNV_OFFSET  2166136261u
+#define FNV_PRIME   16777619u
+#define TH_OFS(m)   offsetof(lv_theme_t, style.m)
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    uint32_t hash;
+    const char * key;           //NULL: empty slot
+    const widget_desc_t * desc;
+}tag_slot_t;
+
+typedef struct
+{
+    uint32_t hash;
+    const char * key;           //NULL: empty slot
+    const widget_desc_t * owner;    //NULL: common attribute of all widgets
+    const widget_attr_desc_t * attr;
+}attr_slot_t;
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static uint32_t key_hash(const char * key, uint32_t seed);
+static uint32_t attr_seed(const widget_desc_t * owner);
+static bool tag_insert(const char * key, const widget_desc_t * desc);
+static bool attr_insert(const widget_desc_t * owner, const widget_attr_desc_t * attr);
+static const widget_attr_desc_t * attr_lookup(const widget_desc_t * owner, const char * name);
+
+static lv_obj_t * cont_create(lv_obj_t * par, const lv_obj_t * copy);
+
+static void attr_id_set(lv_obj_t * obj, const char * value);
+static void attr_x_set(lv_obj_t * obj, int32_t value);
+static void attr_y_set(lv_obj_t * obj, int32_t value);
+static void attr_w_set(lv_obj_t * obj, int32_t value);
+static void attr_h_set(lv_obj_t * obj, int32_t value);
+static void attr_click_set(lv_obj_t * obj, int32_t value);
+static void attr_drag_set(lv_obj_t * obj, int32_t value);
+static void attr_hidden_set(lv_obj_t * obj, int32_t value);
+static void label_text_set(lv_obj_t * obj, const char * value);
+static void btn_toggle_set(lv_obj_t * obj, int32_t value);
+static void cb_text_set(lv_obj_t * obj, const char * value);
+static void ddlist_options_set(lv_obj_t * obj, const char * value);
+static void bar_value_set(lv_obj_t * obj, int32_t value);
+static void led_bright_set(lv_obj_t * obj, int32_t value);
+static void gauge_value_set(lv_obj_t * obj, int32_t value);
+static void roller_options_set(lv_obj_t * obj, const char * value);
+static void arc_start_set(lv_obj_t * obj, int32_t value);
+static void arc_end_set(lv_obj_t * obj, int32_t value);
+static void cont_layout_set(lv_obj_t * obj, int32_t value);
+static void cont_fit_set(lv_obj_t * obj, int32_t value);
+static void img_src_set(lv_obj_t * obj, const char * value);
+
+static void ddlist_init(lv_obj_t * obj);
+static void bar_init(lv_obj_t * obj);
+static void cont_init(lv_obj_t * obj);
+
+static int32_t attr_hidden_get(const lv_obj_t * obj);
+static const char * label_text_get(const lv_obj_t * obj);
+static int32_t btn_toggle_get(const lv_obj_t * obj);
+static const char * cb_text_get(const lv_obj_t * obj);
+static const char * ddlist_options_get(const lv_obj_t * obj);
+static int32_t bar_value_get(const lv_obj_t * obj);
+static int32_t led_bright_get(const lv_obj_t * obj);
+static int32_t gauge_value_get(const lv_obj_t * obj);
+static const char * roller_options_get(const lv_obj_t * obj);
+static int32_t arc_start_get(const lv_obj_t * obj);
+static int32_t arc_end_get(const lv_obj_t * obj);
+static int32_t cont_layout_get(const lv_obj_t * obj);
+static int32_t cont_fit_get(const lv_obj_t * obj);
+static const char * img_src_get(const lv_obj_t * obj);
+
+/**********************
+ *  STATIC VARIABLES
+ **********************/
+static tag_slot_t tag_table[WIDGETREG_TAG_SLOTS];
+static attr_slot_t attr_table[WIDGETREG_ATTR_SLOTS];
+static const widget_desc_t * type_table[WIDGET_TYPE_NUM];
+static bool reg_ready = false;
+
+static const widget_attr_desc_t common_attrs[] = {
+    {.name = "id", .set_cb = attr_id_set},
+    {.name = "x", .set_int_cb = attr_x_set},
+    {.name = "y", .set_int_cb = attr_y_set},
+    {.name = "w", .set_int_cb = attr_w_set},
+    {.name = "h", .set_int_cb = attr_h_set},
+    {.name = "click", .set_int_cb = attr_click_set},     //The designer makes every widget clickable and draggable
+    {.name = "drag", .set_int_cb = attr_drag_set},
+    {.name = "hidden", .set_int_cb = attr_hidden_set, .get_int_cb = attr_hidden_get, .def = 0,
+     .code = "lv_obj_set_hidden(%o, %v);",
+     .code_py = "%o.set_hidden(%v)"},
+    {NULL}
+};
+
+static const widget_attr_desc_t label_attrs[] = {
+    {.name = "text", .set_cb = label_text_set, .get_cb = label_text_get, .def_text = "Text",
+     .code = "lv_label_set_static_text(%o, %v);", .code_static = 1,
+     .code_py = "%o.set_text(%v)"},
+    {NULL}
+};
+static const widget_attr_desc_t btn_attrs[] = {
+    {.name = "toggle", .set_int_cb = btn_toggle_set, .get_int_cb = btn_toggle_get, .def = 0,
+     .code = "lv_btn_set_toggle(%o, %v);",
+     .code_py = "%o.set_toggle(%v)"},
+    {NULL}
+};
+static const widget_attr_desc_t cb_attrs[] = {
+    {.name = "text", .set_cb = cb_text_set, .get_cb = cb_text_get, .def_text = "Check box",
+     .code = "lv_cb_set_static_text(%o, %v);", .code_static = 1,
+     .code_py = "%o.set_text(%v)"},
+    {NULL}
+};
+static const widget_attr_desc_t ddlist_attrs[] = {
+    {.name = "options", .set_cb = ddlist_options_set, .get_cb = ddlist_options_get,
+     .def_text = "Option 1\nOption 2\nOption 3", .code = "lv_ddlist_set_options(%o, %v);",
+     .code_py = "%o.set_options(%v)"},
+    {NULL}
+};
+static const widget_attr_desc_t bar_attrs[] = {     //Slider is a bar too
+    {.name = "value", .set_int_cb = bar_value_set, .get_int_cb = bar_value_get, .def = 0,
+     .code = "lv_bar_set_value(%o, %v, LV_ANIM_OFF);",
+     .code_py = "%o.set_value(%v, lv.ANIM.OFF)"},
+    {NULL}
+};
+static const widget_attr_desc_t led_attrs[] = {
+    {.name = "bright", .set_int_cb = led_bright_set, .get_int_cb = led_bright_get, .def = 255,
+     .code = "lv_led_set_bright(%o, %v);",
+     .code_py = "%o.set_bright(%v)"},
+    {NULL}
+};
+static const widget_attr_desc_t gauge_attrs[] = {
+    {.name = "value", .set_int_cb = gauge_value_set, .get_int_cb = gauge_value_get, .def = 0,
+     .code = "lv_gauge_set_value(%o, 0, %v);",
+     .code_py = "%o.set_value(0, %v)"},
+    {NULL}
+};
+static const widget_attr_desc_t roller_attrs[] = {
+    {.name = "options", .set_cb = roller_options_set, .get_cb = roller_options_get,
+     .def_text = "Option 1\nOption 2\nOption 3", .code = "lv_roller_set_options(%o, %v, LV_ROLLER_MODE_NORMAL);",
+     .code_py = "%o.set_options(%v, lv.roller.MODE.NORMAL)"},
+    {NULL}
+};
+static const widget_attr_desc_t arc_attrs[] = {
+    {.name = "start", .set_int_cb = arc_start_set, .get_int_cb = arc_start_get, .def = 45,
+     .code = "lv_arc_set_angles(%o, %v, lv_arc_get_angle_end(%o));",
+     .code_py = "%o.set_angles(%v, %o.get_angle_end())"},
+    {.name = "end", .set_int_cb = arc_end_set, .get_int_cb = arc_end_get, .def = 315,
+     .code = "lv_arc_set_angles(%o, lv_arc_get_angle_start(%o), %v);",
+     .code_py = "%o.set_angles(%o.get_angle_start(), %v)"},
+    {NULL}
+};
+static const widget_attr_desc_t cont_attrs[] = {    //The defaults of `cont_create`, `lv_cont_create` has others
+    {.name = "layout", .set_int_cb = cont_layout_set, .get_int_cb = cont_layout_get, .def = LV_LAYOUT_PRETTY,
+     .code = "lv_cont_set_layout(%o, %v);",
+     .code_py = "%o.set_layout(%v)", .code_always = 1},
+    {.name = "fit", .set_int_cb = cont_fit_set, .get_int_cb = cont_fit_get, .def = LV_FIT_FLOOD,
+     .code = "lv_cont_set_fit(%o, %v);",
+     .code_py = "%o.set_fit(%v)", .code_always = 1},
+    {NULL}
+};
+static const widget_attr_desc_t img_attrs[] = {     //The name of an `lv_img_dsc_t` of the generated code
+    {.name = "src", .set_cb = img_src_set, .get_cb = img_src_get, .def_text = "",
+     .code = "lv_img_set_src(%o, &%v);", .code_static = 1, .code_ident = 1},
+    {NULL}
+};
+
+//The styles of the themes: the last setter of a part wins, e.g. the check box' bullet is a button restyled by it
+static const widget_theme_style_t obj_theme[] = {
+    {"lv_obj_set_style(%o, %v);", TH_OFS(panel)},
+    {NULL}
+};
+static const widget_theme_style_t btn_theme[] = {
+    {"lv_btn_set_style(%o, LV_BTN_STYLE_REL, %v);", TH_OFS(btn.rel)},
+    {"lv_btn_set_style(%o, LV_BTN_STYLE_PR, %v);", TH_OFS(btn.pr)},
+    {"lv_btn_set_style(%o, LV_BTN_STYLE_TGL_REL, %v);", TH_OFS(btn.tgl_rel)},
+    {"lv_btn_set_style(%o, LV_BTN_STYLE_TGL_PR, %v);", TH_OFS(btn.tgl_pr)},
+    {"lv_btn_set_style(%o, LV_BTN_STYLE_INA, %v);", TH_OFS(btn.ina)},
+    {NULL}
+};
+static const widget_theme_style_t cb_theme[] = {
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BG, %v);", TH_OFS(cb.bg)},
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BOX_REL, %v);", TH_OFS(cb.box.rel)},
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BOX_PR, %v);", TH_OFS(cb.box.pr)},
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BOX_TGL_REL, %v);", TH_OFS(cb.box.tgl_rel)},
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BOX_TGL_PR, %v);", TH_OFS(cb.box.tgl_pr)},
+    {"lv_cb_set_style(%o, LV_CB_STYLE_BOX_INA, %v);", TH_OFS(cb.box.ina)},
+    {NULL}
+};
+static const widget_theme_style_t ddlist_theme[] = {
+    {"lv_ddlist_set_style(%o, LV_DDLIST_STYLE_BG, %v);", TH_OFS(ddlist.bg)},
+    {"lv_ddlist_set_style(%o, LV_DDLIST_STYLE_SEL, %v);", TH_OFS(ddlist.sel)},
+    {"lv_ddlist_set_style(%o, LV_DDLIST_STYLE_SB, %v);", TH_OFS(ddlist.sb)},
+    {NULL}
+};
+static const widget_theme_style_t bar_theme[] = {
+    {"lv_bar_set_style(%o, LV_BAR_STYLE_BG, %v);", TH_OFS(bar.bg)},
+    {"lv_bar_set_style(%o, LV_BAR_STYLE_INDIC, %v);", TH_OFS(bar.indic)},
+    {NULL}
+};
+static const widget_theme_style_t led_theme[] = {
+    {"lv_led_set_style(%o, LV_LED_STYLE_MAIN, %v);", TH_OFS(led)},
+    {NULL}
+};
+static const widget_theme_style_t gauge_theme[] = {
+    {"lv_gauge_set_style(%o, LV_GAUGE_STYLE_MAIN, %v);", TH_OFS(gauge)},
+    {NULL}
+};
+static const widget_theme_style_t slider_theme[] = {
+    {"lv_slider_set_style(%o, LV_SLIDER_STYLE_BG, %v);", TH_OFS(slider.bg)},
+    {"lv_slider_set_style(%o, LV_SLIDER_STYLE_INDIC, %v);", TH_OFS(slider.indic)},
+    {"lv_slider_set_style(%o, LV_SLIDER_STYLE_KNOB, %v);", TH_OFS(slider.knob)},
+    {NULL}
+};
+static const widget_theme_style_t roller_theme[] = {
+    {"lv_ddlist_set_style(%o, LV_DDLIST_STYLE_SB, %v);", TH_OFS(ddlist.sb)},     //Kept from the list
+    {"lv_roller_set_style(%o, LV_ROLLER_STYLE_BG, %v);", TH_OFS(roller.bg)},
+    {"lv_roller_set_style(%o, LV_ROLLER_STYLE_SEL, %v);", TH_OFS(roller.sel)},
+    {NULL}
+};
+static const widget_theme_style_t arc_theme[] = {
+    {"lv_arc_set_style(%o, LV_ARC_STYLE_MAIN, %v);", TH_OFS(arc)},
+    {NULL}
+};
+static const widget_theme_style_t cont_theme[] = {
+    {"lv_cont_set_style(%o, LV_CONT_STYLE_MAIN, %v);", TH_OFS(cont)},
+    {NULL}
+};
+
+static const widget_desc_t builtin_widgets[] = {    //Every WIDGET_TYPE_X should be here. The ToolBox lists them in this order
+    {.type = WIDGET_TYPE_OBJ, .tag = "OBJ", .create_cb = lv_obj_create, .attrs = NULL,
+     .code_create = "lv_obj_create", .theme_styles = obj_theme},
+    {.type = WIDGET_TYPE_LABEL, .tag = "LABEL", .create_cb = lv_label_create, .attrs = label_attrs,
+     .code_create = "lv_label_create", .code_conf = "LV_USE_LABEL",
+     .tool_name = "Label", .tool_symbol = LV_SYMBOL_EDIT},
+    {.type = WIDGET_TYPE_BTN, .tag = "BTN", .create_cb = lv_btn_create, .attrs = btn_attrs,
+     .code_create = "lv_btn_create", .code_conf = "LV_USE_BTN LV_USE_CONT", .theme_styles = btn_theme,
+     .tool_name = "Button", .tool_symbol = LV_SYMBOL_OK, .drag_parent = 1},
+    {.type = WIDGET_TYPE_CB, .tag = "CHECKBOX", .create_cb = lv_cb_create, .attrs = cb_attrs,
+     .code_create = "lv_cb_create", .code_conf = "LV_USE_CB LV_USE_BTN LV_USE_CONT LV_USE_LABEL",
+     .theme_styles = cb_theme,
+     .tool_name = "CheckBox", .tool_symbol = LV_SYMBOL_OK},
+    {.type = WIDGET_TYPE_DDLIST, .tag = "DDLIST", .create_cb = lv_ddlist_create, .attrs = ddlist_attrs,
+     .code_create = "lv_ddlist_create", .code_conf = "LV_USE_DDLIST LV_USE_PAGE LV_USE_CONT LV_USE_LABEL",
+     .theme_styles = ddlist_theme,
+     .tool_name = "DDList", .tool_symbol = LV_SYMBOL_LIST, .init_cb = ddlist_init, .drag_parent = 1},
+    {.type = WIDGET_TYPE_BAR, .tag = "BAR", .create_cb = lv_bar_create, .attrs = bar_attrs,
+     .code_create = "lv_bar_create", .code_conf = "LV_USE_BAR", .theme_styles = bar_theme,
+     .tool_name = "Bar", .tool_symbol = LV_SYMBOL_MINUS, .init_cb = bar_init},
+    {.type = WIDGET_TYPE_LED, .tag = "LED", .create_cb = lv_led_create, .attrs = led_attrs,
+     .code_create = "lv_led_create", .code_conf = "LV_USE_LED", .theme_styles = led_theme,
+     .tool_name = "Led", .tool_symbol = LV_SYMBOL_POWER, .drag_parent = 1},
+    {.type = WIDGET_TYPE_GAUGE, .tag = "GAUGE", .create_cb = lv_gauge_create, .attrs = gauge_attrs,
+     .code_create = "lv_gauge_create", .code_conf = "LV_USE_GAUGE LV_USE_LMETER LV_USE_BAR",
+     .theme_styles = gauge_theme,
+     .tool_name = "Gauge", .tool_symbol = LV_SYMBOL_DRIVE, .drag_parent = 1},
+    {.type = WIDGET_TYPE_SLIDER, .tag = "SLIDER", .create_cb = lv_slider_create, .attrs = bar_attrs,
+     .code_create = "lv_slider_create", .code_conf = "LV_USE_SLIDER LV_USE_BAR", .theme_styles = slider_theme,
+     .tool_name = "Slider", .tool_symbol = LV_SYMBOL_PLAY, .drag_parent = 1},
+    {.type = WIDGET_TYPE_ROLLER, .tag = "ROLLER", .create_cb = lv_roller_create, .attrs = roller_attrs,
+     .code_create = "lv_roller_create", .code_conf = "LV_USE_ROLLER LV_USE_DDLIST LV_USE_PAGE LV_USE_CONT LV_USE_LABEL",
+     .theme_styles = roller_theme,
+     .tool_name = "Roller", .tool_symbol = LV_SYMBOL_SHUFFLE, .drag_parent = 1},
+    {.type = WIDGET_TYPE_ARC, .tag = "ARC", .create_cb = lv_arc_create, .attrs = arc_attrs,
+     .code_create = "lv_arc_create", .code_conf = "LV_USE_ARC", .theme_styles = arc_theme,
+     .tool_name = "Arc", .tool_symbol = LV_SYMBOL_REFRESH, .drag_parent = 1},
+    {.type = WIDGET_TYPE_CONT, .tag = "CONTAINER", .create_cb = cont_create, .attrs = cont_attrs,
+     .code_create = "lv_cont_create", .code_conf = "LV_USE_CONT", .theme_styles = cont_theme,
+     .tool_name = "Container", .tool_symbol = LV_SYMBOL_DIRECTORY,
+     .def_w = LV_DPI * 3 / 2, .def_h = LV_DPI, .init_cb = cont_init, .drag_parent = 1},
+    {.type = WIDGET_TYPE_IMG, .tag = "IMG", .create_cb = lv_img_create, .attrs = img_attrs,
+     .code_create = "lv_img_create", .code_conf = "LV_USE_IMG"},
+};
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+void widgetreg_init(void)
+{
+    if(reg_ready) return;
+    reg_ready = true;
+
+    const widget_attr_desc_t * attr;
+    for(attr = common_attrs; attr->name != NULL; attr++)
+    {
+        attr_insert(NULL, attr);
+    }
+
+    uint32_t i;
+    for(i = 0; i < sizeof(builtin_widgets) / sizeof(builtin_widgets[0]); i++)
+    {
+        widgetreg_add(&builtin_widgets[i]);
+    }
+}
+
+//Register a widget type. A new type only has to call this, the loader needs no change.
+//Registering a tag or type again overrides the old descriptor. `desc` must stay valid.
+bool widgetreg_add(const widget_desc_t * desc)
+{
+    if(desc == NULL || desc->tag == NULL || desc->create_cb == NULL) return false;
+    if(!reg_ready) widgetreg_init();
+
+    if(!tag_insert(desc->tag, desc)) return false;
+
+    if(desc->type < WIDGET_TYPE_NUM)
+    {
+        type_table[desc->type] = desc;
+        tag_insert(widget_get_type_name(desc->type), desc);   //Also accept the type name, e.g. <btn>
+    }
+
+    const widget_attr_desc_t * attr;
+    for(attr = desc->attrs; attr != NULL && attr->name != NULL; attr++)
+    {
+        if(!attr_insert(desc, attr)) return false;
+    }
+    return true;
+}
+
+const widget_desc_t * widgetreg_get(widget_type_t type)
+{
+    if(!reg_ready) widgetreg_init();
+    if(type >= WIDGET_TYPE_NUM) return NULL;
+    return type_table[type];
+}
+
+const widget_desc_t * widgetreg_find_tag(const char * tag)
+{
+    if(tag == NULL) return NULL;
+    if(!reg_ready) widgetreg_init();
+
+    uint32_t hash = key_hash(tag, FNV_OFFSET);
+    uint32_t i = hash & (WIDGETREG_TAG_SLOTS - 1);
+    uint32_t probes;
+    for(probes = 0; probes < WIDGETREG_TAG_SLOTS && tag_table[i].key != NULL; probes++)
+    {
+        if(tag_table[i].hash == hash && !strcasecmp(tag_table[i].key, tag)) return tag_table[i].desc;
+        i = (i + 1) & (WIDGETREG_TAG_SLOTS - 1);
+    }
+    return NULL;
+}
+
+//Type specific attributes are searched first, then the common ones
+const widget_attr_desc_t * widgetreg_find_attr(const widget_desc_t * desc, const char * name)
+{
+    if(name == NULL) return NULL;
+    if(!reg_ready) widgetreg_init();
+
+    const widget_attr_desc_t * attr = NULL;
+    if(desc != NULL) attr = attr_lookup(desc, name);
+    if(attr == NULL) attr = attr_lookup(NULL, name);
+    return attr;
+}
+
+//Set an attribute from its text form, numeric attributes are parsed here
+void widgetreg_attr_apply(const widget_attr_desc_t * attr, lv_obj_t * obj, const char * value)
+{
+    if(attr == NULL || obj == NULL || value == NULL) return;
+
+    if(attr->set_int_cb != NULL)
+    {
+        int32_t v;
+        if(widgetreg_parse_int(value, &v)) attr->set_int_cb(obj, v);
+    }else if(attr->set_cb != NULL)
+    {
+        attr->set_cb(obj, value);
+    }
+}
+
+//The common attributes first, then the type specific ones. NULL after the last one.
+const widget_attr_desc_t * widgetreg_attr_at(const widget_desc_t * desc, uint8_t i)
+{
+    uint8_t common_cnt = sizeof(common_attrs) / sizeof(common_attrs[0]) - 1;
+    if(i < common_cnt) return &common_attrs[i];
+    i -= common_cnt;
+
+    const widget_attr_desc_t * attr = desc != NULL ? desc->attrs : NULL;
+    for(; attr != NULL && attr->name != NULL; attr++)
+    {
+        if(i-- == 0) return attr;
+    }
+    return NULL;
+}
+
+//The only text attribute of a type (e.g. `text` or `options`), NULL if it has none
+const widget_attr_desc_t * widgetreg_text_attr(widget_type_t type)
+{
+    const widget_desc_t * desc = widgetreg_get(type);
+    const widget_attr_desc_t * attr = desc != NULL ? desc->attrs : NULL;
+    while(attr != NULL && attr->name != NULL && attr->get_cb == NULL) attr++;
+    return attr != NULL && attr->name != NULL ? attr : NULL;
+}
+
+//The text the widget shows, by its text attribute. NULL if it has none.
+const char * widgetreg_text_get(const lv_obj_t * obj, widget_type_t type)
+{
+    const widget_attr_desc_t * attr = widgetreg_text_attr(type);
+    return attr != NULL ? attr->get_cb(obj) : NULL;
+}
+
+//Set the text `widgetreg_text_get` returns
+void widgetreg_text_apply(lv_obj_t * obj, widget_type_t type, const char * text)
+{
+    widgetreg_attr_apply(widgetreg_text_attr(type), obj, text);
+}
+
+//Read every numeric attribute of a widget which has a getter, `vals` has WIDGETREG_VAL_MAX elements.
+//The defaults too (the writers skip them), so the generated code can set what its widgets lack.
+uint8_t widgetreg_vals_get(const lv_obj_t * obj, widget_type_t type, widgetreg_val_t * vals)
+{
+    const widget_desc_t * desc = widgetreg_get(type);
+    const widget_attr_desc_t * attr;
+    uint8_t cnt = 0;
+    uint8_t i;
+    for(i = 0; cnt < WIDGETREG_VAL_MAX && (attr = widgetreg_attr_at(desc, i)) != NULL; i++)
+    {
+        if(attr->get_int_cb == NULL) continue;
+        vals[cnt].attr = i;
+        vals[cnt].value = attr->get_int_cb(obj);
+        cnt++;
+    }
+    return cnt;
+}
+
+void widgetreg_vals_apply(lv_obj_t * obj, widget_type_t type, const widgetreg_val_t * vals, uint8_t cnt)
+{
+    const widget_desc_t * desc = widgetreg_get(type);
+    uint8_t i;
+    for(i = 0; i < cnt; i++)
+    {
+        const widget_attr_desc_t * attr = widgetreg_attr_at(desc, vals[i].attr);
+        if(attr != NULL && attr->set_int_cb != NULL) attr->set_int_cb(obj, vals[i].value);
+    }
+}
+
+//Parse a decimal number or "true"/"false". Returns false if `value` isn't a number.
+bool widgetreg_parse_int(const char * value, int32_t * res)
+{
+    if(!strcasecmp(value, "true"))
+    {
+        *res = 1;
+        return true;
+    }
+    if(!strcasecmp(value, "false"))
+    {
+        *res = 0;
+        return true;
+    }
+
+    char * end;
+    long v = strtol(value, &end, 10);
+    if(end == value || *end != '\0') return false;
+    *res = (int32_t)v;
+    return true;
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static uint32_t key_hash(const char * key, uint32_t seed)   //FNV-1a, case-insensitive
+{
+    uint32_t h = seed;
+    while(*key)
+    {
+        h ^= (uint8_t)toupper((unsigned char)*key++);
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static uint32_t attr_seed(const widget_desc_t * owner)
+{
+    uint32_t seed = FNV_OFFSET;
+    if(owner != NULL) seed = (seed ^ (owner->type + 1)) * FNV_PRIME;
+    return seed;
+}
+
+static bool tag_insert(const char * key, const widget_desc_t * desc)
+{
+    uint32_t hash = key_hash(key, FNV_OFFSET);
+    uint32_t i = hash & (WIDGETREG_TAG_SLOTS - 1);
+    uint32_t probes;
+    for(probes = 0; probes < WIDGETREG_TAG_SLOTS; probes++)
+    {
+        if(tag_table[i].key == NULL || (tag_table[i].hash == hash && !strcasecmp(tag_table[i].key, key)))
+        {
+            tag_table[i].hash = hash;
+            tag_table[i].key = key;
+            tag_table[i].desc = desc;
+            return true;
+        }
+        i = (i + 1) & (WIDGETREG_TAG_SLOTS - 1);
+    }
+    return false;   //Table is full
+}
+
+static bool attr_insert(const widget_desc_t * owner, const widget_attr_desc_t * attr)
+{
+    uint32_t hash = key_hash(attr->name, attr_seed(owner));
+    uint32_t i = hash & (WIDGETREG_ATTR_SLOTS - 1);
+    uint32_t probes;
+    for(probes = 0; probes < WIDGETREG_ATTR_SLOTS; probes++)
+    {
+        attr_slot_t * slot = &attr_table[i];
+        if(slot->key == NULL || (slot->owner == owner && slot->hash == hash && !strcasecmp(slot->key, attr->name)))
+        {
+            slot->hash = hash;
+            slot->key = attr->name;
+            slot->owner = owner;
+            slot->attr = attr;
+            return true;
+        }
+        i = (i + 1) & (WIDGETREG_ATTR_SLOTS - 1);
+    }
+    return false;   //Table is full
+}
+
+static const widget_attr_desc_t * attr_lookup(const widget_desc_t * owner, const char * name)
+{
+    uint32_t hash = key_hash(name, attr_seed(owner));
+    uint32_t i = hash & (WIDGETREG_ATTR_SLOTS - 1);
+    uint32_t probes;
+    for(probes = 0; probes < WIDGETREG_ATTR_SLOTS && attr_table[i].key != NULL; probes++)
+    {
+        attr_slot_t * slot = &attr_table[i];
+        if(slot->owner == owner && slot->hash == hash && !strcasecmp(slot->key, name)) return slot->attr;
+        i = (i + 1) & (WIDGETREG_ATTR_SLOTS - 1);
+    }
+    return NULL;
+}
+
+static lv_obj_t * cont_create(lv_obj_t * par, const lv_obj_t * copy)
+{
+    lv_obj_t * obj = lv_cont_create(par, copy);
+    lv_cont_set_fit(obj, LV_FIT_FLOOD);
+    lv_cont_set_layout(obj, LV_LAYOUT_PRETTY);  //Default of a loaded container, "fit" & "layout" can override it
+    return obj;
+}
+
+static void attr_id_set(lv_obj_t * obj, const char * value)
+{
+    widgetid_rename(obj, value);    //A duplicate keeps the generated ID
+}
+
+static void attr_x_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_x(obj, value);
+}
+
+static void attr_y_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_y(obj, value);
+}
+
+static void attr_w_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_width(obj, value);
+}
+
+static void attr_h_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_height(obj, value);
+}
+
+static void attr_click_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_click(obj, value != 0);
+}
+
+static void attr_drag_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_drag(obj, value != 0);
+}
+
+static void attr_hidden_set(lv_obj_t * obj, int32_t value)
+{
+    lv_obj_set_hidden(obj, value != 0);
+}
+
+static void label_text_set(lv_obj_t * obj, const char * value)
+{
+    lv_label_set_text(obj, value);
+}
+
+static void btn_toggle_set(lv_obj_t * obj, int32_t value)
+{
+    lv_btn_set_toggle(obj, value != 0);
+}
+
+static void cb_text_set(lv_obj_t * obj, const char * value)
+{
+    lv_cb_set_text(obj, value);
+}
+
+static void ddlist_options_set(lv_obj_t * obj, const char * value)
+{
+    lv_ddlist_set_options(obj, value);
+}
+
+static void bar_value_set(lv_obj_t * obj, int32_t value)     //Slider is a bar too
+{
+    lv_bar_set_value(obj, value, LV_ANIM_OFF);
+}
+
+static void led_bright_set(lv_obj_t * obj, int32_t value)
+{
+    lv_led_set_bright(obj, value);
+}
+
+static void gauge_value_set(lv_obj_t * obj, int32_t value)
+{
+    lv_gauge_set_value(obj, 0, value);
+}
+
+static void roller_options_set(lv_obj_t * obj, const char * value)
+{
+    lv_roller_set_options(obj, value, LV_ROLLER_MODE_NORMAL);
+}
+
+static void arc_start_set(lv_obj_t * obj, int32_t value)
+{
+    lv_arc_set_angles(obj, value, lv_arc_get_angle_end(obj));
+}
+
+static void arc_end_set(lv_obj_t * obj, int32_t value)
+{
+    lv_arc_set_angles(obj, lv_arc_get_angle_start(obj), value);
+}
+
+static void cont_layout_set(lv_obj_t * obj, int32_t value)
+{
+    lv_cont_set_layout(obj, value);
+}
+
+static void cont_fit_set(lv_obj_t * obj, int32_t value)
+{
+    lv_cont_set_fit(obj, value);
+}
+
+static void img_src_set(lv_obj_t * obj, const char * value)
+{
+    lv_img_set_src(obj, value);     //A file of the designer's file system, if it has one by that name
+}
+
+static void ddlist_init(lv_obj_t * obj)
+{
+    lv_obj_set_drag_parent(lv_page_get_scrl(obj), true);    //Drag the list, not its options
+}
+
+static void bar_init(lv_obj_t * obj)
+{
+    lv_bar_set_anim_time(obj, 10000);
+    lv_bar_set_value(obj, 100, LV_ANIM_ON);
+}
+
+static void cont_init(lv_obj_t * obj)
+{
+    lv_cont_set_fit(obj, LV_FIT_NONE);      //The loader's default would flood the parent
+    lv_cont_set_layout(obj, LV_LAYOUT_OFF);
+}
+
+static int32_t attr_hidden_get(const lv_obj_t * obj)
+{
+    return lv_obj_get_hidden(obj);
+}
+
+static const char * label_text_get(const lv_obj_t * obj)
+{
+    return lv_label_get_text(obj);
+}
+
+static int32_t btn_toggle_get(const lv_obj_t * obj)
+{
+    return lv_btn_get_toggle(obj);
+}
+
+static const char * cb_text_get(const lv_obj_t * obj)
+{
+    return lv_cb_get_text(obj);
+}
+
+static const char * ddlist_options_get(const lv_obj_t * obj)
+{
+    return lv_ddlist_get_options(obj);
+}
+
+static int32_t bar_value_get(const lv_obj_t * obj)
+{
+    return lv_bar_get_value(obj);
+}
+
+static int32_t led_bright_get(const lv_obj_t * obj)
+{
+    return lv_led_get_bright(obj);
+}
+
+static int32_t gauge_value_get(const lv_obj_t * obj)
+{
+    return lv_gauge_get_value(obj, 0);
+}
+
+static const char * roller_options_get(const lv_obj_t * obj)
+{
+    return lv_roller_get_options(obj);
+}
+
+static int32_t arc_start_get(const lv_obj_t * obj)
+{
+    return lv_arc_get_angle_start((lv_obj_t *)obj);      //It only reads the arc
+}
+
+static int32_t arc_end_get(const lv_obj_t * obj)
+{
+    return lv_arc_get_angle_end((lv_obj_t *)obj);
+}
+
+static int32_t cont_layout_get(const lv_obj_t * obj)
+{
+    return lv_cont_get_layout(obj);
+}
+
+static int32_t cont_fit_get(const lv_obj_t * obj)
+{
+    return lv_cont_get_fit_left(obj);       //"fit" sets all four sides
+}
+
+static const char * img_src_get(const lv_obj_t * obj)
+{
+    return lv_img_get_file_name(obj);       //"": the designer couldn't open it
+}
@@ -0,0 +1,120 @@
+/**
+ * @file widgetreg.h
+ *
+ */
+
+#ifndef _WIDGETREG_H_
+#define _WIDGETREG_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+
+#ifdef LV_CONF_INCLUDE_SIMPLE
+#include "lvgl.h"
+#include "lv_ex_conf.h"
+#else
+#include "./lvgl/lvgl.h"
+#include "./lv_ex_conf.h"
+#endif
+
+#include <stdbool.h>
+#include "dataset.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define WIDGETREG_TAG_SLOTS     64      //Must be a power of 2
+#define WIDGETREG_ATTR_SLOTS    256     //Must be a power of 2
+#define WIDGETREG_VAL_MAX       4       //Numeric attributes of a widget with a getter, the common ones too
+#define WIDGETREG_THEME_MAX     6       //Styles a theme gives to a widget when it's created
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef lv_obj_t * (*widget_create_cb_t)(lv_obj_t * par, const lv_obj_t * copy);
+typedef void (*widget_attr_set_cb_t)(lv_obj_t * obj, const char * value);
+typedef void (*widget_attr_int_cb_t)(lv_obj_t * obj, int32_t value);
+typedef int32_t (*widget_attr_get_int_cb_t)(const lv_obj_t * obj);
+typedef void (*widget_init_cb_t)(lv_obj_t * obj);
+typedef const char * (*widget_text_get_cb_t)(const lv_obj_t * obj);
+
+//The schema of a property: load, save, code generation, undo and the previews are driven by it.
+//Only the attributes with a getter are saved, the others (e.g. `id`, `x`) are fields of the snapshots.
+typedef struct
+{
+    const char * name;              //Attribute name in XML
+    widget_attr_set_cb_t set_cb;    //Text attributes, a type has at most one
+    widget_attr_int_cb_t set_int_cb;    //Numeric (and bool) attributes, set only one of the callbacks
+    widget_text_get_cb_t get_cb;    //The text, e.g. the options of a list
+    widget_attr_get_int_cb_t get_int_cb;
+    int32_t def;                    //Value of a loaded widget, it isn't saved or generated
+    const char * def_text;
+    const char * code;              //Setter in the generated code, `%o`: the widget, `%v`: the value. NULL: none
+    const char * code_py;           //The same in the generated MicroPython, an expression. NULL: none
+    uint8_t code_always : 1;        //The created widget of the generated code may have an other default
+    uint8_t code_static : 1;        //`code` keeps only a pointer to the text literal, it's not copied into `lv_mem`
+    uint8_t code_ident : 1;         //`%v` of `code` is the text itself, a C identifier, not a string literal
+}widget_attr_desc_t;
+
+//A numeric attribute of a widget, `attr` is its index for `widgetreg_attr_at`
+typedef struct
+{
+    uint8_t attr;
+    int32_t value;
+}widgetreg_val_t;
+
+//A style given by the theme in `lv_<class>_create()`. Code generation binds the widget to it without the theme.
+typedef struct
+{
+    const char * code;              //Setter in the generated code, `%o`: the widget, `%v`: the style
+    uint16_t th_ofs;                //Offset of the style's pointer in `lv_theme_t`
+}widget_theme_style_t;
+
+typedef struct
+{
+    widget_type_t type;
+    const char * tag;               //XML element name, matched case-insensitively
+    widget_create_cb_t create_cb;
+    const widget_attr_desc_t * attrs;   //Type specific attributes, ends with {NULL}. Can be NULL
+    const char * code_create;       //Create function in the generated code, `lv_<class>_create` in the MicroPython too
+    const char * code_conf;         //`LV_USE_...` of lv_conf.h it needs on the target with its dependencies, space separated
+    const widget_theme_style_t * theme_styles;  //In the order the create function sets them, ends with {NULL}. Can be NULL
+    const char * tool_name;         //Button text in the ToolBox, NULL: not offered there
+    const char * tool_symbol;
+    lv_coord_t def_w, def_h;        //Size of a widget created in the designer, 0: keep the widget's own
+    widget_init_cb_t init_cb;       //Defaults of a widget created in the designer (not of a loaded one). Can be NULL
+    uint8_t drag_parent : 1;        //Dragging a nested widget moves its parent
+}widget_desc_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+void widgetreg_init(void);
+bool widgetreg_add(const widget_desc_t * desc);
+const widget_desc_t * widgetreg_get(widget_type_t type);
+const widget_desc_t * widgetreg_find_tag(const char * tag);
+const widget_attr_desc_t * widgetreg_find_attr(const widget_desc_t * desc, const char * name);
+void widgetreg_attr_apply(const widget_attr_desc_t * attr, lv_obj_t * obj, const char * value);
+const widget_attr_desc_t * widgetreg_attr_at(const widget_desc_t * desc, uint8_t i);
+const widget_attr_desc_t * widgetreg_text_attr(widget_type_t type);
+const char * widgetreg_text_get(const lv_obj_t * obj, widget_type_t type);
+void widgetreg_text_apply(lv_obj_t * obj, widget_type_t type, const char * text);
+uint8_t widgetreg_vals_get(const lv_obj_t * obj, widget_type_t type, widgetreg_val_t * vals);
+void widgetreg_vals_apply(lv_obj_t * obj, widget_type_t type, const widgetreg_val_t * vals, uint8_t cnt);
+bool widgetreg_parse_int(const char * value, int32_t * res);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @xmlstream .c
+ * Streaming XML writer. Elements are written to a buffered temporary file as they come,
+ * xmlstream_close() renames it over the target, so a crash never leaves a half written project.
+ */
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "xmlstream.h"
+
+/*********************
+ *      DEFINES
+ *********************/
+#define XMLSTREAM_INIT_DEPTH    16
+
+/**********************
+ *  STATIC PROTOTYPES
+ **********************/
+static void start_tag_close(xmlstream_t * xs);
+static void indent_write(xmlstream_t * xs);
+static void escaped_write(xmlstream_t * xs, const char * str);
+static void xmlstream_free(xmlstream_t * xs);
+
+/**********************
+ *   GLOBAL FUNCTIONS
+ **********************/
+bool xmlstream_open(xmlstream_t * xs, const char * path)
+{
+    memset(xs, 0, sizeof(xmlstream_t));
+    if(strlen(path) >= XMLSTREAM_PATH_MAX) return false;
+
+    strcpy(xs->path, path);
+    snprintf(xs->tmp_path, sizeof(xs->tmp_path), "%s.tmp", path);
+
+    xs->fp = fopen(xs->tmp_path, "w");
+    if(xs->fp == NULL) return false;
+
+    xs->buf = malloc(XMLSTREAM_BUF_SIZE);
+    if(xs->buf != NULL) setvbuf(xs->fp, xs->buf, _IOFBF, XMLSTREAM_BUF_SIZE);
+
+    fputs("<?xml version=\"1.0\" encoding=\"utf-8\"?>\n", xs->fp);
+    return true;
+}
+
+void xmlstream_begin(xmlstream_t * xs, const char * tag)
+{
+    if(xs->error) return;
+
+    if(xs->depth == xs->tags_cap)
+    {
+        uint32_t new_cap = xs->tags_cap ? xs->tags_cap * 2 : XMLSTREAM_INIT_DEPTH;
+        const char ** new_tags = realloc(xs->tags, new_cap * sizeof(const char *));
+        if(new_tags == NULL)
+        {
+            xs->error = true;
+            return;
+        }
+        xs->tags = new_tags;
+        xs->tags_cap = new_cap;
+    }
+
+    start_tag_close(xs);
+    indent_write(xs);
+    fputc('<', xs->fp);
+    fputs(tag, xs->fp);
+    xs->tags[xs->depth++] = tag;
+    xs->tag_open = true;
+}
+
+//Only valid right after xmlstream_begin() or an other attribute
+void xmlstream_attr(xmlstream_t * xs, const char * name, const char * value)
+{
+    if(xs->error || !xs->tag_open) return;
+
+    fputc(' ', xs->fp);
+    fputs(name, xs->fp);
+    fputs("=\"", xs->fp);
+    escaped_write(xs, value);
+    fputc('"', xs->fp);
+}
+
+void xmlstream_attr_int(xmlstream_t * xs, const char * name, int32_t value)
+{
+    if(xs->error || !xs->tag_open) return;
+
+    fprintf(xs->fp, " %s=\"%d\"", name, (int)value);
+}
+
+void xmlstream_end(xmlstream_t * xs)
+{
+    if(xs->error || xs->depth == 0) return;
+
+    xs->depth--;
+    if(xs->tag_open)        //No children: <TAG ... />
+    {
+        fputs(" />\n", xs->fp);
+        xs->tag_open = false;
+        return;
+    }
+    indent_write(xs);
+    fputs("</", xs->fp);
+    fputs(xs->tags[xs->depth], xs->fp);
+    fputs(">\n", xs->fp);
+}
+
+//End the open elements, flush to disk and replace the target file. Returns false if nothing was replaced.
+bool xmlstream_close(xmlstream_t * xs)
+{
+    if(xs->fp == NULL) return false;
+
+    while(xs->depth && !xs->error) xmlstream_end(xs);
+
+    bool res = !xs->error;
+    if(fflush(xs->fp) != 0 || ferror(xs->fp)) res = false;
+    if(res && fsync(fileno(xs->fp)) != 0) res = false;
+    if(fclose(xs->fp) != 0) res = false;
+    xs->fp = NULL;
+
+    if(res && rename(xs->tmp_path, xs->path) != 0) res = false;
+    if(!res) remove(xs->tmp_path);
+
+    xmlstream_free(xs);
+    return res;
+}
+
+//Drop everything written so far, the target file is not touched
+void xmlstream_abort(xmlstream_t * xs)
+{
+    if(xs->fp != NULL)
+    {
+        fclose(xs->fp);
+        xs->fp = NULL;
+        remove(xs->tmp_path);
+    }
+    xmlstream_free(xs);
+}
+
+/**********************
+ *   STATIC FUNCTIONS
+ **********************/
+static void start_tag_close(xmlstream_t * xs)
+{
+    if(xs->tag_open)
+    {
+        fputs(">\n", xs->fp);
+        xs->tag_open = false;
+    }
+}
+
+static void indent_write(xmlstream_t * xs)
+{
+    uint32_t i;
+    for(i = 0; i < xs->depth; i++) fputs("  ", xs->fp);
+}
+
+static void escaped_write(xmlstream_t * xs, const char * str)
+{
+    const char * run = str;     //Write the unescaped runs in one call
+    for(; *str; str++)
+    {
+        const char * esc;
+        switch(*str)
+        {
+            case '&':  esc = "&amp;";   break;
+            case '<':  esc = "&lt;";    break;
+            case '>':  esc = "&gt;";    break;
+            case '"':  esc = "&quot;";  break;
+            case '\n': esc = "&#10;";   break;
+            default:   continue;
+        }
+        fwrite(run, 1, str - run, xs->fp);
+        fputs(esc, xs->fp);
+        run = str + 1;
+    }
+    fwrite(run, 1, str - run, xs->fp);
+}
+
+static void xmlstream_free(xmlstream_t * xs)
+{
+    free(xs->tags);
+    free(xs->buf);
+    xs->tags = NULL;
+    xs->buf = NULL;
+    xs->tags_cap = 0;
+    xs->depth = 0;
+}
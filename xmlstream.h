@@ -0,0 +1,62 @@
+/**
+ * @file xmlstream.h
+ *
+ */
+
+#ifndef _XMLSTREAM_H_
+#define _XMLSTREAM_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*********************
+ *      INCLUDES
+ *********************/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/*********************
+ *      DEFINES
+ *********************/
+#define XMLSTREAM_BUF_SIZE      (64 * 1024)
+#define XMLSTREAM_PATH_MAX      256
+
+/**********************
+ *      TYPEDEFS
+ **********************/
+typedef struct
+{
+    FILE * fp;
+    char path[XMLSTREAM_PATH_MAX];
+    char tmp_path[XMLSTREAM_PATH_MAX + 4];
+    char * buf;
+    const char ** tags;         //Open elements, the tag strings have to stay valid until they are ended
+    uint32_t depth;
+    uint32_t tags_cap;
+    bool tag_open;              //The start tag of the top element still takes attributes
+    bool error;
+}xmlstream_t;
+
+/**********************
+ * GLOBAL PROTOTYPES
+ **********************/
+bool xmlstream_open(xmlstream_t * xs, const char * path);
+void xmlstream_begin(xmlstream_t * xs, const char * tag);
+void xmlstream_attr(xmlstream_t * xs, const char * name, const char * value);
+void xmlstream_attr_int(xmlstream_t * xs, const char * name, int32_t value);
+void xmlstream_end(xmlstream_t * xs);
+bool xmlstream_close(xmlstream_t * xs);
+void xmlstream_abort(xmlstream_t * xs);
+
+/**********************
+ *      MACROS
+ **********************/
+
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
+
+#endif